@@ -0,0 +1,52 @@
+# /*******************************************************************
+#
+# Part of the Fritzing project - http://fritzing.org
+# Copyright (c) 2026 Fritzing
+#
+# Fritzing is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Fritzing is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+#
+# ********************************************************************
+
+# Builds the widget-free part of Fritzing (sketch files, parts.db, netlists, svg and
+# gerber geometry, drc geometry, the schematic router) as a static library, so that a
+# server can read sketches and produce netlists without a display or a main window.
+# QtWidgets is linked only for DebugDialog and FMessageBox; no views are created.
+
+lessThan(QT_MAJOR_VERSION, 5) {
+    error(Fritzing does not build with Qt 4 or earlier. 5.15 is recommended.)
+}
+
+TEMPLATE = lib
+TARGET = fritzingcore
+CONFIG += staticlib c++17
+
+unix {
+    QMAKE_CXXFLAGS += -O3 -fno-omit-frame-pointer
+}
+
+unix:!macx {
+    CONFIG += link_pkgconfig
+}
+
+QT += core gui sql svg widgets xml
+equals(QT_MAJOR_VERSION, 6) {
+  QT += core5compat
+}
+
+INCLUDEPATH += src
+
+include(pri/boostdetect.pri)
+include(pri/quazipdetect.pri)
+include(pri/svgppdetect.pri)
+include(pri/core.pri)
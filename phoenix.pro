@@ -164,7 +164,7 @@ macx {
 
 QT += concurrent core gui network printsupport serialport sql svg widgets xml
 equals(QT_MAJOR_VERSION, 6) {
-  QT += core5compat svgwidgets
+  QT += core5compat svgwidgets openglwidgets
 }
 
 RC_FILE = fritzing.rc
@@ -177,6 +177,7 @@ include(pri/boostdetect.pri)
 include(pri/spicedetect.pri)
 include(pri/quazipdetect.pri)
 include(pri/svgppdetect.pri)
+include(pri/core.pri)
 include(pri/kitchensink.pri)
 include(pri/mainwindow.pri)
 include(pri/partsbinpalette.pri)
@@ -18,19 +18,23 @@ src/autoroute/autorouter.h \
 src/autoroute/autorouteprogressdialog.h \
 src/autoroute/autoroutersettingsdialog.h \
 src/autoroute/checker.h  \
-src/autoroute/binpacking/Rect.h  \
-src/autoroute/binpacking/GuillotineBinPack.h  \
 src/autoroute/mazerouter/mazerouter.h  \
+src/autoroute/schematicrouter/schematicrouter.h \
 src/autoroute/zoomcontrols.h \
 src/autoroute/drc.h \
+src/autoroute/drcpixels.h \
+src/autoroute/livedrc.h \
+src/autoroute/boardmaskcache.h \
 
 SOURCES += \
 src/autoroute/autorouter.cpp \
 src/autoroute/autorouteprogressdialog.cpp \
 src/autoroute/autoroutersettingsdialog.cpp \
 src/autoroute/checker.cpp  \
-src/autoroute/binpacking/Rect.cpp  \
-src/autoroute/binpacking/GuillotineBinPack.cpp  \
 src/autoroute/mazerouter/mazerouter.cpp  \
+src/autoroute/schematicrouter/schematicrouter.cpp \
 src/autoroute/zoomcontrols.cpp \
 src/autoroute/drc.cpp \
+src/autoroute/drcpixels.cpp \
+src/autoroute/livedrc.cpp \
+src/autoroute/boardmaskcache.cpp \
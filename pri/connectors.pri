@@ -16,19 +16,25 @@
 HEADERS += \
 src/connectors/bus.h \
 src/connectors/busshared.h \
+src/connectors/connectivityindex.h \
+src/connectors/connectorgrid.h \
 src/connectors/connector.h \
 src/connectors/connectoritem.h \
 src/connectors/nonconnectoritem.h \
 src/connectors/connectorshared.h \
 src/connectors/ercdata.h \
+src/connectors/ercengine.h \
 src/connectors/svgidlayer.h
 
 SOURCES += \
 src/connectors/bus.cpp \
 src/connectors/busshared.cpp \
+src/connectors/connectivityindex.cpp \
+src/connectors/connectorgrid.cpp \
 src/connectors/connector.cpp \
 src/connectors/connectoritem.cpp \
 src/connectors/nonconnectoritem.cpp \
 src/connectors/connectorshared.cpp \
 src/connectors/ercdata.cpp \
+src/connectors/ercengine.cpp \
 src/connectors/svgidlayer.cpp
@@ -0,0 +1,73 @@
+# /*******************************************************************
+# Part of the Fritzing project - http://fritzing.org
+# Copyright (c) 2026 Fritzing
+# Fritzing is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# Fritzing is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+# You should have received a copy of the GNU General Public License
+# along with Fritzing. If not, see <http://www.gnu.org/licenses/>.
+# ********************************************************************/
+
+# the model, svg, gerber, drc geometry and router code that needs no sketch widgets,
+# shared by the application (phoenix.pro) and the headless core library (core.pro)
+
+HEADERS += \
+    src/debugdialog.h \
+    src/autoroute/binpacking/Rect.h \
+    src/autoroute/binpacking/GuillotineBinPack.h \
+    src/autoroute/binpacking/MaxRectsBinPack.h \
+    src/autoroute/drcgeometry.h \
+    src/autoroute/schematicrouter/orthogonalrouter.h \
+    src/items/moduleidnames.h \
+    src/model/binarysketch.h \
+    src/model/headlesssketch.h \
+    src/model/sketchdiff.h \
+    src/svg/svgfilesplitter.h \
+    src/svg/svgpathparser.h \
+    src/svg/svgpathgrammar_p.h \
+    src/svg/svgpathlexer.h \
+    src/svg/svgpathrunner.h \
+    src/svg/svgpathscanner.h \
+    src/svg/svg2gerber.h \
+    src/svg/svgflattener.h \
+    src/svg/svgtext.h \
+    src/utils/euclideanmst.h \
+    src/utils/fmessagebox.h \
+    src/utils/folderutils.h \
+    src/utils/graphicsutils.h \
+    src/utils/lockmanager.h \
+    src/utils/misc.h \
+    src/utils/textutils.h
+
+SOURCES += \
+    src/debugdialog.cpp \
+    src/autoroute/binpacking/Rect.cpp \
+    src/autoroute/binpacking/GuillotineBinPack.cpp \
+    src/autoroute/binpacking/MaxRectsBinPack.cpp \
+    src/autoroute/drcgeometry.cpp \
+    src/autoroute/schematicrouter/orthogonalrouter.cpp \
+    src/items/moduleidnames.cpp \
+    src/model/binarysketch.cpp \
+    src/model/headlesssketch.cpp \
+    src/model/sketchdiff.cpp \
+    src/svg/svgfilesplitter.cpp \
+    src/svg/svgpathparser.cpp \
+    src/svg/svgpathgrammar.cpp \
+    src/svg/svgpathlexer.cpp \
+    src/svg/svgpathrunner.cpp \
+    src/svg/svgpathscanner.cpp \
+    src/svg/svg2gerber.cpp \
+    src/svg/svgflattener.cpp \
+    src/svg/svgtext.cpp \
+    src/utils/euclideanmst.cpp \
+    src/utils/fmessagebox.cpp \
+    src/utils/folderutils.cpp \
+    src/utils/graphicsutils.cpp \
+    src/utils/lockmanager.cpp \
+    src/utils/misc.cpp \
+    src/utils/textutils.cpp
@@ -25,7 +25,6 @@ HEADERS += \
     src/items/layerkinpaletteitem.h \
     src/items/led.h \
     src/items/logoitem.h \
-    src/items/moduleidnames.h \
     src/items/mysterypart.h \
     src/items/note.h \
     src/items/pad.h \
@@ -43,6 +42,7 @@ HEADERS += \
     src/items/schematicsubpart.h \
     src/items/screwterminal.h \
     src/items/stripboard.h \
+    src/items/svgprefetcher.h \
     src/items/symbolpaletteitem.h \
     src/items/tracewire.h \
     src/items/via.h \
@@ -65,7 +65,6 @@ SOURCES += \
     src/items/layerkinpaletteitem.cpp \
     src/items/led.cpp \
     src/items/logoitem.cpp \
-    src/items/moduleidnames.cpp \
     src/items/mysterypart.cpp \
     src/items/note.cpp \
     src/items/pad.cpp \
@@ -83,6 +82,7 @@ SOURCES += \
     src/items/schematicsubpart.cpp \
     src/items/screwterminal.cpp \
     src/items/stripboard.cpp \
+    src/items/svgprefetcher.cpp \
     src/items/symbolpaletteitem.cpp \
     src/items/tracewire.cpp \
     src/items/via.cpp \
@@ -14,7 +14,7 @@
 # ********************************************************************/
 HEADERS += \
     src/commands.h \
-    src/debugdialog.h \
+    src/cookedsvgcache.h \
     src/fapplication.h \
     src/fsplashscreen.h \
     src/fsvgrenderer.h \
@@ -32,10 +32,11 @@ HEADERS += \
 
 SOURCES += \
     src/commands.cpp \
-    src/debugdialog.cpp \
+    src/cookedsvgcache.cpp \
     src/fapplication.cpp \
     src/fsplashscreen.cpp \
     src/fsvgrenderer.cpp \
+    src/installedfonts.cpp \
     src/itemdrag.cpp \
     src/layerattributes.cpp \
     src/main.cpp \
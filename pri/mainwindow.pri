@@ -19,6 +19,7 @@ HEADERS += \
     src/mainwindow/sketchareawidget.h \
     src/mainwindow/FProbeDropByModuleID.h \
     src/mainwindow/FProbeKeyPressEvents.h \
+    src/mainwindow/FProbeInteractionProfile.h \
     src/mainwindow/getspice.h \
 
 SOURCES += \
@@ -31,4 +32,5 @@ SOURCES += \
     src/mainwindow/sketchareawidget.cpp \
     src/mainwindow/FProbeDropByModuleID.cpp \
     src/mainwindow/FProbeKeyPressEvents.cpp \
+    src/mainwindow/FProbeInteractionProfile.cpp \
     src/mainwindow/getspice.cpp \
@@ -13,15 +13,19 @@
 # along with Fritzing. If not, see <http://www.gnu.org/licenses/>.
 # ********************************************************************/
 HEADERS += \
+    src/model/backupjournal.h \
     src/model/modelbase.h \
     src/model/modelpart.h \
     src/model/modelpartshared.h \
     src/model/palettemodel.h \
+    src/model/partssearchindex.h \
     src/model/sketchmodel.h
 
 SOURCES += \
+    src/model/backupjournal.cpp \
     src/model/modelbase.cpp \
     src/model/modelpart.cpp \
     src/model/modelpartshared.cpp \
     src/model/palettemodel.cpp \
+    src/model/partssearchindex.cpp \
     src/model/sketchmodel.cpp
@@ -19,8 +19,12 @@
 #********************************************************************/
 
 HEADERS += \
+    src/referencemodel/partsindex.h \
+    src/referencemodel/propertyindex.h \
     src/referencemodel/sqlitereferencemodel.h \
     src/referencemodel/referencemodel.h \
 
 SOURCES += \
+    src/referencemodel/partsindex.cpp \
+    src/referencemodel/propertyindex.cpp \
     src/referencemodel/sqlitereferencemodel.cpp \
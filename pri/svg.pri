@@ -12,15 +12,10 @@
 # You should have received a copy of the GNU General Public License
 # along with Fritzing. If not, see <http://www.gnu.org/licenses/>.
 # ********************************************************************/
-HEADERS += src/svg/svgfilesplitter.h \
-    src/svg/svgpathparser.h \
-    src/svg/svgpathgrammar_p.h \
-    src/svg/svgpathlexer.h \
-    src/svg/svgpathrunner.h \
-    src/svg/svg2gerber.h \
-    src/svg/svgflattener.h \
+HEADERS += \
     src/svg/gerbergenerator.h \
     src/svg/groundplanegenerator.h \
+    src/svg/outlinetracer.h \
     src/svg/x2svg.h \
     src/svg/kicad2svg.h \
     src/svg/kicadmodule2svg.h \
@@ -28,18 +23,12 @@ HEADERS += src/svg/svgfilesplitter.h \
     src/svg/gedaelement2svg.h \
     src/svg/gedaelementparser.h \
     src/svg/gedaelementgrammar_p.h \
-    src/svg/gedaelementlexer.h \
-    $$PWD/../src/svg/svgtext.h
+    src/svg/gedaelementlexer.h
 
-SOURCES += src/svg/svgfilesplitter.cpp \
-    src/svg/svgpathparser.cpp \
-    src/svg/svgpathgrammar.cpp \
-    src/svg/svgpathlexer.cpp \
-    src/svg/svgpathrunner.cpp \
-    src/svg/svg2gerber.cpp \
-    src/svg/svgflattener.cpp \
+SOURCES += \
     src/svg/gerbergenerator.cpp \
     src/svg/groundplanegenerator.cpp \
+    src/svg/outlinetracer.cpp \
     src/svg/x2svg.cpp \
     src/svg/kicad2svg.cpp \
     src/svg/kicadmodule2svg.cpp \
@@ -47,5 +36,4 @@ SOURCES += src/svg/svgfilesplitter.cpp \
     src/svg/gedaelement2svg.cpp \
     src/svg/gedaelementparser.cpp \
     src/svg/gedaelementgrammar.cpp \
-    src/svg/gedaelementlexer.cpp \
-    $$PWD/../src/svg/svgtext.cpp
+    src/svg/gedaelementlexer.cpp
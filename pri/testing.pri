@@ -15,12 +15,14 @@
 HEADERS += \
     src/testing/FTesting.h \
     src/testing/FProbe.h \
+    src/testing/FTimingProbe.h \
     src/testing/FTestingServer.h
 
 
 SOURCES += \
     src/testing/FTesting.cpp \
     src/testing/FProbe.cpp \
+    src/testing/FTimingProbe.cpp \
     src/testing/FTestingServer.cpp
 
 
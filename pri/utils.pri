@@ -21,25 +21,30 @@ src/utils/bezier.h \
 src/utils/bezierdisplay.h \
 src/utils/boundedregexpvalidator.h \
 src/utils/bundler.h \
+src/utils/cachecounters.h \
 src/utils/clickablelabel.h \
 src/utils/cursormaster.h \
 src/utils/expandinglabel.h \
+src/utils/exportmanifest.h \
 src/utils/familypropertycombobox.h \
 src/utils/fileprogressdialog.h \
 src/utils/flineedit.h \
-src/utils/fmessagebox.h \
 src/utils/focusoutcombobox.h \
 src/utils/fsizegrip.h \
-src/utils/lockmanager.h \
-src/utils/misc.h \
+src/utils/pngbandwriter.h \
 src/utils/resizehandle.h \
-src/utils/folderutils.h \
-src/utils/graphicsutils.h \
+src/utils/glyphcache.h \
 src/utils/graphutils.h \
 src/utils/ratsnestcolors.h \
 src/utils/schematicrectconstants.h \
 src/utils/s2s.h \
-src/utils/textutils.h \
+src/utils/settingscache.h \
+src/utils/startupprofiler.h \
+src/utils/interactionprofiler.h \
+src/utils/tracer.h \
+src/utils/memoryreport.h \
+src/utils/stringpool.h \
+src/utils/zipwriter.h \
 src/utils/zoomslider.h
 
 SOURCES += \
@@ -47,22 +52,27 @@ src/utils/autoclosemessagebox.cpp \
 src/utils/bendpointaction.cpp \
 src/utils/bezier.cpp \
 src/utils/bezierdisplay.cpp \
+src/utils/cachecounters.cpp \
 src/utils/clickablelabel.cpp \
 src/utils/cursormaster.cpp \
 src/utils/expandinglabel.cpp \
+src/utils/exportmanifest.cpp \
 src/utils/fileprogressdialog.cpp \
 src/utils/flineedit.cpp \
-src/utils/fmessagebox.cpp \
 src/utils/focusoutcombobox.cpp \
 src/utils/fsizegrip.cpp \
-src/utils/lockmanager.cpp \
-src/utils/misc.cpp \
+src/utils/pngbandwriter.cpp \
 src/utils/resizehandle.cpp \
-src/utils/folderutils.cpp \
-src/utils/graphicsutils.cpp \
+src/utils/glyphcache.cpp \
 src/utils/graphutils.cpp \
 src/utils/ratsnestcolors.cpp \
 src/utils/schematicrectconstants.cpp \
 src/utils/s2s.cpp \
-src/utils/textutils.cpp \
+src/utils/settingscache.cpp \
+src/utils/startupprofiler.cpp \
+src/utils/interactionprofiler.cpp \
+src/utils/tracer.cpp \
+src/utils/memoryreport.cpp \
+src/utils/stringpool.cpp \
+src/utils/zipwriter.cpp \
 src/utils/zoomslider.cpp
@@ -86,6 +86,9 @@ AutorouteProgressDialog::AutorouteProgressDialog(const QString & title, bool zoo
 	vLayout->addWidget(m_message);
 	m_message2 = new QLabel(this);
 	vLayout->addWidget(m_message2);
+	m_stats = new QLabel(this);
+	m_stats->setVisible(false);
+	vLayout->addWidget(m_stats);
 
 	if (zoomAndPan) {
 		auto * groupBox = new QGroupBox(tr("zoom and pan controls"));
@@ -193,6 +196,12 @@ void AutorouteProgressDialog::setMessage2(const QString & text)
 	m_message2->setText(text);
 }
 
+void AutorouteProgressDialog::setStats(const QString & text)
+{
+	m_stats->setText(text);
+	m_stats->setVisible(!text.isEmpty());
+}
+
 void AutorouteProgressDialog::setSpinLabel(const QString & text)
 {
 	m_spinLabel->setText(text);
@@ -48,6 +48,7 @@ public Q_SLOTS:
 	void setSpinLabel(const QString &);
 	void setMessage(const QString &);
 	void setMessage2(const QString &);
+	void setStats(const QString &);
 	void setSpinValue(int);
 	void disableButtons();
 	void sendBest();
@@ -67,6 +68,7 @@ protected:
 	QLabel * m_spinLabel;
 	QLabel * m_message;
 	QLabel * m_message2;
+	QLabel * m_stats;                   // router counters, hidden until the first report
 	QSpinBox * m_spinBox;
 	QDialogButtonBox * m_buttonBox;
 };
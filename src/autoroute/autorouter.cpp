@@ -30,10 +30,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/moduleidnames.h"
 #include "../processeventblocker.h"
 #include "../referencemodel/referencemodel.h"
+#include "../utils/settingscache.h"
 
 #include <qmath.h>
 #include <QApplication>
-#include <QSettings>
 
 const QString Autorouter::MaxCyclesName("cmrouter/maxcycles");
 
@@ -41,6 +41,105 @@ Autorouter::Autorouter(PCBSketchWidget * sketchWidget) : m_sketchWidget(sketchWi
 {
 }
 
+const QRectF & Autorouter::routedRegion() const {
+	return m_routedRegion;
+}
+
+void Autorouter::setRipUpRegion(const QList<QRectF> & region) {
+	// for an incremental autoroute, only autoroutable traces, vias, jumpers and net labels touching the region are ripped up;
+	// the rest stay in place and are rendered as obstacles like any non-autoroutable trace
+
+	m_ripUpRegion = region;
+	m_ripUp.clear();
+	if (m_ripUpRegion.isEmpty()) return;
+
+	QList<QGraphicsItem *> items = (m_board == nullptr) ? m_sketchWidget->scene()->items() : m_sketchWidget->scene()->collidingItems(m_board);
+	QList< QList<Wire *> > chains;
+	QList< QList<ConnectorItem *> > chainEnds;
+	QSet<Wire *> visited;
+	Q_FOREACH (QGraphicsItem * item, items) {
+		auto *itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr) continue;
+
+		auto *traceWire = qobject_cast<TraceWire *>(itemBase);
+		if (traceWire != nullptr) {
+			if (!traceWire->isTraceType(m_sketchWidget->getTraceFlag())) continue;
+			if (!traceWire->getAutoroutable()) continue;
+			if (visited.contains(traceWire)) continue;
+
+			QList<Wire *> wires;
+			QList<ConnectorItem *> ends;
+			traceWire->collectChained(wires, ends);
+			Q_FOREACH (Wire * wire, wires) visited.insert(wire);
+			chains << wires;
+			chainEnds << ends;
+			continue;
+		}
+
+		itemBase = itemBase->layerKinChief();
+		if (isAutoroutedItem(itemBase) && inRipUpRegion(itemBase->sceneBoundingRect())) {
+			m_ripUp.insert(itemBase);
+		}
+	}
+
+	// a chain goes if it touches the region or ends on a via, jumper or net label that goes,
+	// and takes its autoroutable vias, jumpers and net labels with it
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 0; i < chains.count(); i++) {
+			if (m_ripUp.contains(chains.at(i).first())) continue;
+
+			QRectF r;
+			Q_FOREACH (Wire * wire, chains.at(i)) r |= wire->sceneBoundingRect();
+			bool ripUp = inRipUpRegion(r);
+			Q_FOREACH (ConnectorItem * end, chainEnds.at(i)) {
+				if (m_ripUp.contains(end->attachedTo()->layerKinChief())) ripUp = true;
+			}
+			if (!ripUp) continue;
+
+			changed = true;
+			Q_FOREACH (Wire * wire, chains.at(i)) m_ripUp.insert(wire);
+			Q_FOREACH (ConnectorItem * end, chainEnds.at(i)) {
+				ItemBase * chief = end->attachedTo()->layerKinChief();
+				if (isAutoroutedItem(chief)) {
+					m_ripUp.insert(chief);
+				}
+			}
+		}
+	}
+
+	DebugDialog::debug(QString("incremental autoroute: ripping up %1 items").arg(m_ripUp.count()));
+}
+
+bool Autorouter::isAutoroutedItem(ItemBase * itemBase) {
+	// an autoroutable via, jumper or net label, as opposed to a part
+	auto *via = qobject_cast<Via *>(itemBase);
+	if (via != nullptr) return via->getAutoroutable();
+
+	auto *jumperItem = qobject_cast<JumperItem *>(itemBase);
+	if (jumperItem != nullptr) return jumperItem->getAutoroutable();
+
+	auto *netLabel = qobject_cast<SymbolPaletteItem *>(itemBase);
+	if (netLabel != nullptr) return netLabel->isOnlyNetLabel() && netLabel->getAutoroutable();
+
+	return false;
+}
+
+bool Autorouter::inRipUpRegion(const QRectF & r) {
+	Q_FOREACH (QRectF region, m_ripUpRegion) {
+		if (region.intersects(r)) return true;
+	}
+
+	return false;
+}
+
+bool Autorouter::willRipUp(ItemBase * itemBase) {
+	if (m_ripUpRegion.isEmpty()) return true;
+
+	return m_ripUp.contains(itemBase->layerKinChief());
+}
+
 void Autorouter::cleanUpNets() {
 	Q_FOREACH (QList<ConnectorItem *> * connectorItems, m_allPartConnectorItems) {
 		delete connectorItems;
@@ -125,6 +224,8 @@ void Autorouter::initUndo(QUndoCommand * parentCommand)
 			if (jumperItem == nullptr) continue;
 
 			if (jumperItem->getAutoroutable()) {
+				if (!willRipUp(jumperItem)) continue;
+
 				addUndoConnection(false, jumperItem, parentCommand);
 				toDelete.append(jumperItem);
 				continue;
@@ -153,6 +254,8 @@ void Autorouter::initUndo(QUndoCommand * parentCommand)
 			if (via == nullptr) continue;
 
 			if (via->getAutoroutable()) {
+				if (!willRipUp(via)) continue;
+
 				addUndoConnection(false, via, parentCommand);
 				toDelete.append(via);
 				continue;
@@ -185,6 +288,8 @@ void Autorouter::initUndo(QUndoCommand * parentCommand)
 			if (!netLabel->isOnlyNetLabel()) continue;
 
 			if (netLabel->getAutoroutable()) {
+				if (!willRipUp(netLabel)) continue;
+
 				addUndoConnection(false, netLabel, parentCommand);
 				toDelete.append(netLabel);
 				continue;
@@ -231,6 +336,7 @@ void Autorouter::initUndo(QUndoCommand * parentCommand)
 		if (traceWire == nullptr) continue;
 		if (!traceWire->isTraceType(m_sketchWidget->getTraceFlag())) continue;
 		if (!traceWire->getAutoroutable()) continue;
+		if (!willRipUp(traceWire)) continue;
 
 		toDelete.append(traceWire);
 		addUndoConnection(false, traceWire, parentCommand);
@@ -279,6 +385,18 @@ void Autorouter::addUndoConnection(bool connect, ConnectorItem * connectorItem,
 	}
 }
 
+void Autorouter::addConnectionToUndo(ConnectorItem * from, ConnectorItem * to, QUndoCommand * parentCommand)
+{
+	if (from == nullptr || to == nullptr) return;
+
+	auto * ccc = new ChangeConnectionCommand(m_sketchWidget, BaseCommand::CrossView,
+	        from->attachedToID(), from->connectorSharedID(),
+	        to->attachedToID(), to->connectorSharedID(),
+	        ViewLayer::specFromID(from->attachedToViewLayerID()),
+	        true, parentCommand);
+	ccc->setUpdateConnections(false);
+}
+
 void Autorouter::restoreOriginalState(QUndoCommand * parentCommand) {
 	QUndoStack undoStack;
 	undoStack.push(parentCommand);
@@ -433,6 +551,54 @@ void Autorouter::addWireToUndo(Wire * wire, QUndoCommand * parentCommand)
 void Autorouter::setMaxCycles(int maxCycles)
 {
 	m_maxCycles = maxCycles;
-	QSettings settings;
-	settings.setValue(MaxCyclesName, maxCycles);
+	SettingsCache::setValue(MaxCyclesName, maxCycles);
+}
+
+void Autorouter::removeOffBoardAnd(bool isPCBType, bool removeSingletons, bool bothSides) {
+	QRectF boardRect;
+	if (m_board) boardRect = m_board->sceneBoundingRect();
+	// remove any vias or jumperItems that will be deleted, also remove off-board items
+	for (int i = m_allPartConnectorItems.count() - 1; i >= 0; i--) {
+		QList<ConnectorItem *> * connectorItems = m_allPartConnectorItems.at(i);
+		if (removeSingletons) {
+			if (connectorItems->count() < 2) {
+				connectorItems->clear();
+			}
+			else if (connectorItems->count() == 2) {
+				if (connectorItems->at(0) == connectorItems->at(1)->getCrossLayerConnectorItem()) {
+					connectorItems->clear();
+				}
+			}
+		}
+		for (int j = connectorItems->count() - 1; j >= 0; j--) {
+			ConnectorItem * connectorItem = connectorItems->at(j);
+			//connectorItem->debugInfo("pci");
+			bool doRemove = false;
+			if (connectorItem->attachedToItemType() == ModelPart::Via) {
+				Via * via = qobject_cast<Via *>(connectorItem->attachedTo()->layerKinChief());
+				doRemove = via->getAutoroutable() && willRipUp(via);
+			}
+			else if (connectorItem->attachedToItemType() == ModelPart::Jumper) {
+				auto * jumperItem = qobject_cast<JumperItem *>(connectorItem->attachedTo()->layerKinChief());
+				doRemove = jumperItem->getAutoroutable() && willRipUp(jumperItem);
+			}
+			else if (connectorItem->attachedToItemType() == ModelPart::Symbol) {
+				auto * netLabel = qobject_cast<SymbolPaletteItem *>(connectorItem->attachedTo()->layerKinChief());
+				doRemove = netLabel->getAutoroutable() && netLabel->isOnlyNetLabel() && willRipUp(netLabel);
+			}
+			if (!bothSides && connectorItem->attachedToViewLayerID() == ViewLayer::Copper1) doRemove = true;
+			if (!doRemove && isPCBType) {
+				if (!boardRect.contains(connectorItem->sceneBoundingRect())) {
+					doRemove = true;
+				}
+			}
+			if (doRemove) {
+				connectorItems->removeAt(j);
+			}
+		}
+		if (connectorItems->count() == 0) {
+			m_allPartConnectorItems.removeAt(i);
+			delete connectorItems;
+		}
+	}
 }
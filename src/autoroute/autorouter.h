@@ -23,6 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QAction>
 #include <QHash>
+#include <QSet>
 #include <QVector>
 #include <QList>
 #include <QPointF>
@@ -31,6 +32,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QProgressDialog>
 #include <QUndoCommand>
 
+#include <atomic>
+
 #include "../viewgeometry.h"
 #include "../viewlayer.h"
 #include "../connectors/connectoritem.h"
@@ -49,6 +52,8 @@ public:
 	virtual ~Autorouter() = default;
 
 	virtual void start() = 0;
+	void setRipUpRegion(const QList<QRectF> &);
+	const QRectF & routedRegion() const;
 
 public:
 	static const QString MaxCyclesName;
@@ -64,11 +69,16 @@ protected:
 	void addUndoConnection(bool connect, Via *, QUndoCommand * parentCommand);
 	void addUndoConnection(bool connect, TraceWire *, QUndoCommand * parentCommand);
 	void addUndoConnection(bool connect, ConnectorItem *, BaseCommand::CrossViewType, QUndoCommand * parentCommand);
+	void addConnectionToUndo(ConnectorItem * from, ConnectorItem * to, QUndoCommand * parentCommand);
 	void restoreOriginalState(QUndoCommand * parentCommand);
 	void doCancel(QUndoCommand * parentCommand);
 	void clearTracesAndJumpers();
 	void addToUndo(QUndoCommand * parentCommand);
 	void addWireToUndo(Wire * wire, QUndoCommand * parentCommand);
+	bool willRipUp(ItemBase *);
+	bool inRipUpRegion(const QRectF &);
+	bool isAutoroutedItem(ItemBase *);
+	void removeOffBoardAnd(bool isPCBType, bool removeSingletons, bool bothSides);
 
 public Q_SLOTS:
 	virtual void cancel();
@@ -85,6 +95,7 @@ Q_SIGNALS:
 	void wantBothVisible();
 	void setProgressMessage(const QString &);
 	void setProgressMessage2(const QString &);
+	void setProgressStats(const QString &);
 	void setCycleMessage(const QString &);
 	void setCycleCount(int);
 	void disableButtons();
@@ -92,18 +103,22 @@ Q_SIGNALS:
 protected:
 	PCBSketchWidget * m_sketchWidget = nullptr;
 	QList< QList<ConnectorItem*>* > m_allPartConnectorItems;
-	bool m_cancelled = false;
-	bool m_cancelTrace = false;
-	bool m_stopTracing = false;
-	bool m_useBest = false;
+	// set from the progress dialog while the search runs on another thread
+	std::atomic<bool> m_cancelled { false };
+	std::atomic<bool> m_cancelTrace { false };
+	std::atomic<bool> m_stopTracing { false };
+	std::atomic<bool> m_useBest { false };
 	bool m_bothSidesNow = false;
 	int m_maximumProgressPart = 0;
 	int m_currentProgressPart = 0;
 	QGraphicsItem * m_board = nullptr;
-	int m_maxCycles = 0;
+	std::atomic<int> m_maxCycles { 0 };
 	double m_keepoutPixels = 0.0;
 	QRectF m_maxRect;
 	bool m_pcbType = false;
+	QList<QRectF> m_ripUpRegion;            // empty means reroute everything
+	QSet<ItemBase *> m_ripUp;
+	QRectF m_routedRegion;                  // scene rect of the copper the route added; null if it added none
 };
 
 #endif
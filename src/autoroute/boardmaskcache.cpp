@@ -0,0 +1,87 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "boardmaskcache.h"
+#include "drc.h"
+#include "../svg/svgfilesplitter.h"
+#include "../utils/cachecounters.h"
+
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QSvgRenderer>
+
+const int BoardMaskCache::MaxKilobytes = 256 * 1024;
+
+static QCache<QByteArray, QImage> Masks(BoardMaskCache::MaxKilobytes);
+static QMutex MasksMutex;
+static CacheCounters Counters("board_raster");
+
+bool BoardMaskCache::mask(const QString & boardSvg, const QStringList & exceptions, const QSize & imageSize, const QRectF & renderRect, double extendBorder, QImage & image) {
+	// the board in white on black, as a Format_Mono image of imageSize with the svg drawn into renderRect,
+	// then with black grown inwards by extendBorder pixels; image shares the cached pixels until it is written to
+	QByteArray boardByteArray;
+	QString tempColor("#ffffff");
+	QStringList colorExceptions = exceptions;
+	if (!SvgFileSplitter::changeColors(boardSvg, tempColor, colorExceptions, boardByteArray)) {
+		return false;
+	}
+
+	QByteArray key = QCryptographicHash::hash(boardByteArray, QCryptographicHash::Sha1).toHex();
+	key += QString(" %1 %2 %3 %4 %5 %6 %7")
+	       .arg(imageSize.width()).arg(imageSize.height())
+	       .arg(renderRect.x()).arg(renderRect.y()).arg(renderRect.width()).arg(renderRect.height())
+	       .arg(extendBorder).toUtf8();
+
+	{
+		QMutexLocker locker(&MasksMutex);
+		QImage * cached = Masks.object(key);
+		Counters.count(cached != nullptr);
+		if (cached != nullptr) {
+			image = *cached;
+			return true;
+		}
+	}
+
+	// render outside the lock so the two copper fill layers don't wait for each other
+	QImage fresh(imageSize, QImage::Format_Mono);
+	fresh.fill(0);
+	QSvgRenderer renderer(boardByteArray);
+	QPainter painter;
+	painter.begin(&fresh);
+	painter.setRenderHint(QPainter::Antialiasing, false);
+	renderer.render(&painter, renderRect);
+	painter.end();
+	if (extendBorder > 0) {
+		DRC::extendBorder(extendBorder, &fresh);
+	}
+
+	image = fresh;
+	QMutexLocker locker(&MasksMutex);
+	Masks.insert(key, new QImage(fresh), qMax(1, (int) (fresh.sizeInBytes() / 1024)));
+	return true;
+}
+
+void BoardMaskCache::clear() {
+	QMutexLocker locker(&MasksMutex);
+	Masks.clear();
+}
@@ -0,0 +1,43 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef BOARDMASKCACHE_H
+#define BOARDMASKCACHE_H
+
+#include <QImage>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+class BoardMaskCache
+{
+	// board outlines rasterized for the DRC, the autorouter and copper fill, kept from one run to the next;
+	// keyed on the recolored board svg itself, so resizing or reshaping the board misses rather than goes stale
+
+public:
+	static bool mask(const QString & boardSvg, const QStringList & exceptions, const QSize & imageSize, const QRectF & renderRect, double extendBorder, QImage & image);
+	static void clear();
+
+public:
+	static const int MaxKilobytes;
+};
+
+#endif
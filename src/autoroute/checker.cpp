@@ -20,6 +20,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "checker.h"
 #include "../debugdialog.h"
+#include "../mainwindow/mainwindow.h"
 #include "../sketch/pcbsketchwidget.h"
 #include "../utils/graphicsutils.h"
 #include "../connectors/connectoritem.h"
@@ -28,6 +29,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDir>
+#include <QRegularExpression>
 #include <qmath.h>
 #include <limits>
 
@@ -36,7 +38,8 @@ static QSet<QString> CheckerFileNames;
 
 int Checker::checkText(MainWindow * mainWindow, bool displayMessage) {
 	QHash<QString, QString> svgHash;
-	QList<ItemBase *> missing;
+	QList<QPair<long, QString>> fragments;
+	QHash<long, ItemBase *> itemBases;
 
 	Q_FOREACH (QGraphicsItem * item, mainWindow->pcbView()->scene()->items()) {
 		ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
@@ -47,24 +50,13 @@ int Checker::checkText(MainWindow * mainWindow, bool displayMessage) {
 		QString itemSvg = itemBase->retrieveSvg(itemBase->viewLayerID(), svgHash, false, GraphicsUtils::StandardFritzingDPI, factor);
 		if (itemSvg.isEmpty()) continue;
 
-		QDomDocument doc;
-		QString errorStr;
-		int errorLine;
-		int errorColumn;
-		if (!doc.setContent(itemSvg, &errorStr, &errorLine, &errorColumn)) {
-			DebugDialog::debug(QString("itembase svg failure %1").arg(itemBase->id()));
-			continue;
-		}
+		fragments.append(qMakePair(itemBase->id(), itemSvg));
+		itemBases.insert(itemBase->id(), itemBase);
+	}
 
-		QDomElement root = doc.documentElement();
-		QDomNodeList domNodeList = root.elementsByTagName("path");
-		for (int i = 0; i < domNodeList.count(); i++) {
-			QDomElement textElement = domNodeList.at(i).toElement();
-			if (textElement.attribute("fill").isEmpty() && textElement.attribute("stroke").isEmpty() && textElement.attribute("stroke-width").isEmpty()) {
-				missing.append(itemBase);
-				break;
-			}
-		}
+	QList<ItemBase *> missing;
+	Q_FOREACH (long id, missingPaint(fragments)) {
+		missing.append(itemBases.value(id));
 	}
 
 	if (displayMessage && missing.count() > 0) {
@@ -89,9 +81,8 @@ int Checker::checkDonuts(MainWindow * mainWindow, bool displayMessage) {
 	Q_FOREACH (QGraphicsItem * item, mainWindow->pcbView()->scene()->items()) {
 		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(item);
 		if (connectorItem == NULL) continue;
-		if (!connectorItem->attachedTo()->isEverVisible()) continue;
 
-		if (connectorItem->isPath() && (connectorItem->getCrossLayerConnectorItem() != nullptr)) {  // && connectorItem->radius() == 0
+		if (isDonut(connectorItem)) {
 			connectorItem->debugInfo("possible donut");
 			connectorItem->attachedTo()->debugInfo("\t");
 			donuts << connectorItem;
@@ -117,6 +108,42 @@ int Checker::checkDonuts(MainWindow * mainWindow, bool displayMessage) {
 	return donuts.count() / 2;
 }
 
+QList<long> Checker::missingPaint(const QList<QPair<long, QString>> & fragments) {
+	// ids whose svg has a <path> with none of stroke, fill or stroke-width; the tags are scanned rather
+	// than parsed, since this runs over every fragment of an export; safe to run off the gui thread
+	static const QRegularExpression PathTag("<path\\b([^>]*)>");
+	static const QRegularExpression Paint("(^|\\s)(fill|stroke|stroke-width)\\s*=");
+
+	QList<long> ids;
+	for (const auto & fragment : fragments) {
+		QRegularExpressionMatchIterator it = PathTag.globalMatch(fragment.second);
+		while (it.hasNext()) {
+			if (!Paint.match(it.next().captured(1)).hasMatch()) {
+				ids.append(fragment.first);
+				break;
+			}
+		}
+	}
+	return ids;
+}
+
+QList<ConnectorItem *> Checker::donuts(ItemBase * board, SketchWidget * sketchWidget) {
+	QList<ConnectorItem *> donuts;
+	Q_FOREACH (QGraphicsItem * item, sketchWidget->scene()->collidingItems(board)) {
+		auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
+		if (connectorItem == nullptr) continue;
+
+		if (isDonut(connectorItem)) donuts << connectorItem;
+	}
+	return donuts;
+}
+
+bool Checker::isDonut(ConnectorItem * connectorItem) {
+	if (!connectorItem->attachedTo()->isEverVisible()) return false;
+
+	return connectorItem->isPath() && (connectorItem->getCrossLayerConnectorItem() != nullptr);  // && connectorItem->radius() == 0
+}
+
 void Checker::writeCheckerOutput(const QString & message) {
 	DebugDialog::debug(message);
 	if (CheckerOutputPath.length() > 0) {
@@ -21,15 +21,20 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef CHECKER_H
 #define CHECKER_H
 
+#include <QList>
+#include <QPair>
 #include <QString>
 
-#include "../mainwindow/mainwindow.h"
-
 class Checker
 {
 public:
-	static int checkDonuts(MainWindow *, bool displayMessage);
-	static int checkText(MainWindow *, bool displayMessage);
+	static int checkDonuts(class MainWindow *, bool displayMessage);
+	static int checkText(class MainWindow *, bool displayMessage);
+
+	// the same checks, for the export pipeline, which has the items' svg fragments already
+	static QList<long> missingPaint(const QList<QPair<long, QString>> & fragments);
+	static QList<class ConnectorItem *> donuts(class ItemBase * board, class SketchWidget *);
+	static bool isDonut(ConnectorItem *);
 
 protected:
 	static void writeCheckerOutput(const QString & message);
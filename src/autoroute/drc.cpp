@@ -19,6 +19,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 ********************************************************************/
 
 #include "drc.h"
+#include "boardmaskcache.h"
+#include "drcgeometry.h"
+#include "drcpixels.h"
 #include "../connectors/svgidlayer.h"
 #include "../sketch/pcbsketchwidget.h"
 #include "../debugdialog.h"
@@ -29,15 +32,18 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../processeventblocker.h"
 #include "../fsvgrenderer.h"
 #include "../viewlayer.h"
+#include "../utils/tracer.h"
+#include "../utils/settingscache.h"
 #include "../processeventblocker.h"
 #include "src/items/wire.h"
 
 #include <qmath.h>
 #include <QApplication>
+#include <QThread>
+#include <QtConcurrentMap>
 #include <QMessageBox>
 #include <QPixmap>
 #include <QSet>
-#include <QSettings>
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -45,6 +51,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QListWidget>
 #include <QRadioButton>
 
+#include <algorithm>
+
 ///////////////////////////////////////////
 //
 //
@@ -61,36 +69,38 @@ const QString DRC::Net = "net";
 
 const uchar DRC::BitTable[] = { 128, 64, 32, 16, 8, 4, 2, 1 };
 
-bool pixelsCollide(QImage * image1, QImage * image2, QImage * image3, int x1, int y1, int x2, int y2, uint clr, QList<QPointF> & points) {
-	bool result = false;
-	const uchar * bits1 = image1->constScanLine(0);
-	const uchar * bits2 = image2->constScanLine(0);
-	int bytesPerLine = image1->bytesPerLine();
-	for (int y = y1; y < y2; y++) {
-		int offset = y * bytesPerLine;
-		for (int x = x1; x < x2; x++) {
-			//QRgb p1 = image1->pixel(x, y);
-			//if (p1 == 0xffffffff) continue;
-
-			//QRgb p2 = image2->pixel(x, y);
-			//if (p2 == 0xffffffff) continue;
-
-			int byteOffset = (x >> 3) + offset;
-			uchar mask = DRC::BitTable[x & 7];
-
-			if ((*(bits1 + byteOffset) & mask) != 0) continue;
-			if ((*(bits2 + byteOffset) & mask) != 0) continue;
-
-			image3->setPixel(x, y, clr);
-			//DebugDialog::debug(QString("p1:%1 p2:%2").arg(p1, 0, 16).arg(p2, 0, 16));
-			result = true;
+ConnectorItem * nearestConnector(const QList<ConnectorItem *> & equi, const LayerList & viewLayerIDs, const QPointF & scenePoint) {
+	ConnectorItem * nearest = nullptr;
+	double nearestDistance = 0;
+	Q_FOREACH (ConnectorItem * equ, equi) {
+		if (!viewLayerIDs.contains(equ->attachedToViewLayerID())) continue;
+
+		QRectF r = (equ->attachedToItemType() == ModelPart::Wire) ? equ->attachedTo()->sceneBoundingRect() : equ->sceneBoundingRect();
+		double dx = qMax(0.0, qMax(r.left() - scenePoint.x(), scenePoint.x() - r.right()));
+		double dy = qMax(0.0, qMax(r.top() - scenePoint.y(), scenePoint.y() - r.bottom()));
+		double distance = dx * dx + dy * dy;
+		if (nearest == nullptr || distance < nearestDistance) {
+			nearest = equ;
+			nearestDistance = distance;
+		}
+	}
+
+	return nearest;
+}
+
+void markGeometryPixels(QImage * image, const QPointF & atMils, double radiusMils, double dpi, QList<QPointF> & points) {
+	// a square around a geometry mode violation, at the display image's resolution
+	int cx = qFloor(atMils.x() * dpi / GraphicsUtils::StandardFritzingDPI);
+	int cy = qFloor(atMils.y() * dpi / GraphicsUtils::StandardFritzingDPI);
+	int r = qMax(1, qCeil(radiusMils * dpi / GraphicsUtils::StandardFritzingDPI));
+	for (int y = qMax(0, cy - r); y <= qMin(image->height() - 1, cy + r); y++) {
+		for (int x = qMax(0, cx - r); x <= qMin(image->width() - 1, cx + r); x++) {
+			image->setPixel(x, y, 1 /* 0x80ff0000 */);
 			if (points.count() < 1000) {
 				points.append(QPointF(x, y));
 			}
 		}
 	}
-
-	return result;
 }
 
 QStringList getNames(CollidingThing * collidingThing) {
@@ -195,6 +205,7 @@ void DRCResultsDialog::pressedSlot(QListWidgetItem * item) {
 	m_displayItem->setPixmap(pixmap);
 	if (collidingThing->nonConnectorItem != nullptr) {
 		m_sketchWidget->selectItem(collidingThing->nonConnectorItem->attachedTo());
+		m_sketchWidget->ensureVisible(collidingThing->nonConnectorItem->attachedTo());
 	}
 }
 
@@ -214,6 +225,16 @@ void DRCResultsDialog::releasedSlot(QListWidgetItem * item) {
 
 const QString DRC::KeepoutSettingName("DRC_Keepout");
 const double DRC::KeepoutDefaultMils = 10;
+const QString DRC::GeometrySettingName("DRC_Geometry");
+const QString DRC::TiledSettingName("DRC_Tiled");
+
+// above this many board pixels the raster check is tiled
+static const qint64 MaxUntiledPixels = 4096 * 4096;
+static const int TileSize = 2048;
+static const double TiledDisplayDPI = 100;
+
+// only for highlighting: geometry mode checks the shapes themselves
+static const double GeometryDisplayDPI = 100;
 
 ///////////////////////////////////////////////
 
@@ -230,9 +251,13 @@ DRC::DRC(PCBSketchWidget * sketchWidget, ItemBase * board) :
     m_displayImage(nullptr),
     m_displayItem(nullptr),
     m_cancelled(false),
-    m_maxProgress(0)
+    m_maxProgress(0),
+    m_displayScale(1),
+    m_itemIndexBuilt(false)
 {
 	CancelledMessage = tr("DRC was cancelled.");
+
+	m_geometry = SettingsCache::boolValue(GeometrySettingName);
 }
 
 DRC::~DRC()
@@ -255,11 +280,14 @@ DRC::~DRC()
 }
 
 QStringList DRC::start(bool showOkMessage, double keepoutMils) {
+	Tracer::Scope tracing("drc");
 	QString message;
 	QStringList messages;
 	QList<CollidingThing *> collidingThings;
 
-	bool result = startAux(message, messages, collidingThings, keepoutMils);
+	bool result = m_geometry
+				  ? startGeometry(message, messages, collidingThings, keepoutMils)
+				  : startAux(message, messages, collidingThings, keepoutMils);
 	if (result) {
 		if (messages.count() == 0) {
 			message = tr("Your sketch is ready for production: there are no connectors or traces that overlap or are too close together.");
@@ -274,6 +302,8 @@ QStringList DRC::start(bool showOkMessage, double keepoutMils) {
 	m_displayImage->save(FolderUtils::getTopLevelUserDataStorePath() + "/testDRCDisplay.png");
 #endif
 
+	collectViolations(messages, collidingThings);
+
 	Q_EMIT wantBothVisible();
 	Q_EMIT setProgressValue(m_maxProgress);
 	Q_EMIT hideProgress();
@@ -286,70 +316,183 @@ QStringList DRC::start(bool showOkMessage, double keepoutMils) {
 		else {
 			auto * dialog = new DRCResultsDialog(message, messages, collidingThings, m_displayItem, m_displayImage, m_sketchWidget, m_sketchWidget->window());
 			dialog->show();
+
+			// the dialog owns these now
+			m_displayItem = nullptr;
+			m_displayImage = nullptr;
+			return messages;
 		}
 	}
-	else {}
-
-	m_displayItem = nullptr;
-	m_displayImage = nullptr;
 
+	// no dialog: the destructor takes the display with it, which matters to a batch check
+	qDeleteAll(collidingThings);
 	return messages;
 }
 
-bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThing *> & collidingThings, double keepoutMils) {
-	bool bothSidesNow = m_sketchWidget->boardLayers() == 2;
+const QList<DRCViolation> & DRC::violations() const {
+	// what the last start() found, for reports that can't show the display image
+	return m_violations;
+}
+
+void DRC::collectViolations(const QStringList & messages, const QList<CollidingThing *> & collidingThings) {
+	// messages and collidingThings are parallel; the colliding pixels are in display image pixels
+	m_violations.clear();
+	double milsPerPixel = 0;
+	if (m_displayImage != nullptr && m_displayImage->width() > 0) {
+		milsPerPixel = m_board->sceneBoundingRect().width() * 1000 / GraphicsUtils::SVGDPI / m_displayImage->width();
+	}
+
+	for (int i = 0; i < messages.count(); i++) {
+		DRCViolation violation;
+		violation.message = messages.at(i);
+		CollidingThing * collidingThing = i < collidingThings.count() ? collidingThings.at(i) : nullptr;
+		if (collidingThing != nullptr) {
+			QList< QPointer<NonConnectorItem> > items = collidingThing->others;
+			items.prepend(collidingThing->nonConnectorItem);
+			Q_FOREACH (NonConnectorItem * nci, items) {
+				if (nci == nullptr || nci->attachedTo() == nullptr) continue;
+				QString title = nci->attachedTo()->layerKinChief()->instanceTitle();
+				if (!violation.parts.contains(title)) violation.parts << title;
+			}
+			if (!collidingThing->atPixels.isEmpty() && milsPerPixel > 0) {
+				QPointF p0 = collidingThing->atPixels.first();
+				double l = p0.x(), t = p0.y(), r = p0.x(), b = p0.y();
+				Q_FOREACH (QPointF p, collidingThing->atPixels) {
+					l = qMin(l, p.x());
+					t = qMin(t, p.y());
+					r = qMax(r, p.x());
+					b = qMax(b, p.y());
+				}
+				violation.area = QRectF(l * milsPerPixel, t * milsPerPixel, (r - l + 1) * milsPerPixel, (b - t + 1) * milsPerPixel);
+			}
+		}
+		m_violations << violation;
+	}
+}
+
+double DRC::rasterDPI(double keepoutMils) {
+	return qMax((double) 250, 1000 / keepoutMils);  // turns out making a variable dpi doesn't work due to vector-to-raster issues
+}
+
+int DRC::checkRegion(const QRectF & sceneRegion, double keepoutMils, double dpi, QImage * displayImage) {
+	// re-checks only the nets with copper near sceneRegion, rasterizing only that part of the board;
+	// displayImage covers the board at dpi, and its pixels near sceneRegion are replaced by the new overlaps.
+	// Returns the number of overlapping connectors found
+	QRectF boardRect = m_board->sceneBoundingRect();
+	double keepout = keepoutMils * GraphicsUtils::SVGDPI / GraphicsUtils::StandardFritzingDPI;
+	QRectF crop = sceneRegion.adjusted(-keepout, -keepout, keepout, keepout).intersected(boardRect);
+	if (crop.isEmpty()) return 0;
+
+	QRectF renderRect(0, 0, boardRect.width() * dpi / GraphicsUtils::SVGDPI, boardRect.height() * dpi / GraphicsUtils::SVGDPI);
+	int x0 = qMax(0, qFloor((crop.left() - boardRect.left()) * dpi / GraphicsUtils::SVGDPI));
+	int y0 = qMax(0, qFloor((crop.top() - boardRect.top()) * dpi / GraphicsUtils::SVGDPI));
+	int x1 = qMin(displayImage->width(), qCeil((crop.right() - boardRect.left()) * dpi / GraphicsUtils::SVGDPI));
+	int y1 = qMin(displayImage->height(), qCeil((crop.bottom() - boardRect.top()) * dpi / GraphicsUtils::SVGDPI));
+	if (x1 <= x0 || y1 <= y0) return 0;
+
+	// the whole board is rendered, offset so that only the crop lands in the images
+	QSize cropSize(x1 - x0, y1 - y0);
+	renderRect.translate(-x0, -y0);
+
+	QImage plusImage(cropSize, QImage::Format_Mono);
+	QImage minusImage(cropSize, QImage::Format_Mono);
+	QImage hitImage(cropSize, QImage::Format_Indexed8);
+	hitImage.setColor(0, 0);
+	hitImage.setColor(1, 0x80ff0000);
+	hitImage.fill(0);
 
-	QList<ConnectorItem *> visited;
 	QList< QList<ConnectorItem *> > equis;
 	QList< QList<ConnectorItem *> > singletons;
-	Q_FOREACH (QGraphicsItem * item, m_sketchWidget->scene()->items()) {
-		auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
-		if (connectorItem == nullptr) continue;
-		if (!connectorItem->attachedTo()->isEverVisible()) continue;
-		if (connectorItem->attachedTo()->getRatsnest()) continue;
-		if (visited.contains(connectorItem)) continue;
+	collectEquis(equis, singletons);
+	mergeSingletons(singletons, equis);
 
-		QList<ConnectorItem *> equi;
-		equi.append(connectorItem);
-		ConnectorItem::collectEqualPotential(
-					equi,
-					bothSidesNow,
-					(ViewGeometry::RatsnestFlag |
-					 ViewGeometry::NormalFlag |
-					 ViewGeometry::PCBTraceFlag |
-					 ViewGeometry::SchematicTraceFlag) ^ m_sketchWidget->getTraceFlag());
-		visited.append(equi);
+	QList<ViewLayer::ViewLayerPlacement> layerSpecs;
+	layerSpecs << ViewLayer::NewBottom;
+	if (m_sketchWidget->boardLayers() == 2) layerSpecs << ViewLayer::NewTop;
 
-		if (equi.count() == 1) {
-			singletons.append(equi);
-			continue;
-		}
+	int hitCount = 0;
+	int index = 0;
+	Q_FOREACH (ViewLayer::ViewLayerPlacement viewLayerPlacement, layerSpecs) {
+		LayerList viewLayerIDs = ViewLayer::copperLayers(viewLayerPlacement);
+		viewLayerIDs.removeOne(ViewLayer::GroundPlane0);
+		viewLayerIDs.removeOne(ViewLayer::GroundPlane1);
+		QString master = renderLayers(viewLayerIDs);
+		if (master.isEmpty()) continue;
 
-		ItemBase * firstPart = connectorItem->attachedTo()->layerKinChief();
-		bool gotTwo = false;
-		Q_FOREACH (ConnectorItem * equ, equi) {
-			if (equ->attachedTo()->layerKinChief() != firstPart) {
-				gotTwo = true;
-				break;
+		QDomDocument masterDoc;
+		if (!masterDoc.setContent(master)) continue;
+
+		QDomElement root = masterDoc.documentElement();
+		SvgFileSplitter::forceStrokeWidth(root, 2 * keepoutMils, "#000000", true, false);
+
+		Q_FOREACH (QList<ConnectorItem *> equi, equis) {
+			QList< QPair<ConnectorItem *, QRectF> > rects;
+			QList<Wire *> wires;
+			QRectF netRect;
+			Q_FOREACH (ConnectorItem * equ, equi) {
+				if (!viewLayerIDs.contains(equ->attachedToViewLayerID())) continue;
+
+				QRectF rect;
+				if (equ->attachedToItemType() == ModelPart::Wire) {
+					Wire * wire = qobject_cast<Wire *>(equ->attachedTo());
+					if (wires.contains(wire)) continue;
+
+					wires.append(wire);
+					rect = wire->sceneBoundingRect();
+				}
+				else rect = equ->sceneBoundingRect();
+				rects.append(qMakePair(equ, rect));
+				netRect |= rect;
+			}
+			if (rects.isEmpty() || !netRect.intersects(crop)) continue;
+
+			plusImage.fill(0xffffffff);
+			minusImage.fill(0xffffffff);
+			splitNet(&masterDoc, equi, &minusImage, &plusImage, renderRect, viewLayerPlacement, index++, keepoutMils);
+
+			for (int i = 0; i < rects.count(); i++) {
+				QRectF rect = rects.at(i).second.intersected(crop);
+				if (rect.isEmpty()) continue;
+
+				int l = qMax(0, qFloor((rect.left() - boardRect.left()) * dpi / GraphicsUtils::SVGDPI) - x0);
+				int t = qMax(0, qFloor((rect.top() - boardRect.top()) * dpi / GraphicsUtils::SVGDPI) - y0);
+				int r = qMin(cropSize.width(), qCeil((rect.right() - boardRect.left()) * dpi / GraphicsUtils::SVGDPI) - x0);
+				int b = qMin(cropSize.height(), qCeil((rect.bottom() - boardRect.top()) * dpi / GraphicsUtils::SVGDPI) - y0);
+				QList<QPointF> atPixels;
+				if (DRCPixels::pixelsCollide(&plusImage, &minusImage, &hitImage, l, t, r, b, 1 /* 0x80ff0000 */, atPixels)) {
+					hitCount++;
+				}
 			}
 		}
-		if (!gotTwo) {
-			singletons.append(equi);
-			continue;
-		}
+	}
 
-		equis.append(equi);
+	for (int y = 0; y < cropSize.height(); y++) {
+		memcpy(displayImage->scanLine(y + y0) + x0, hitImage.constScanLine(y), cropSize.width());
 	}
 
-	m_maxProgress = equis.count() + singletons.count() + 1;
-	if (bothSidesNow) m_maxProgress *= 2;
-	Q_EMIT setMaximumProgress(m_maxProgress);
-	int progress = 1;
-	Q_EMIT setProgressValue(progress);
+	return hitCount;
+}
 
-	ProcessEventBlocker::processEvents();
+int DRC::verifyRoute(const QRectF & routedRegion, double keepoutMils) {
+	// after an autoroute only the copper the router added can make new overlaps, so only
+	// the nets near it are rendered again; returns the number of overlapping connectors
+	if (routedRegion.isNull()) return 0;
 
-	double dpi = qMax((double) 250, 1000 / keepoutMils);  // turns out making a variable dpi doesn't work due to vector-to-raster issues
+	double dpi = rasterDPI(keepoutMils);
+	QRectF boardRect = m_board->sceneBoundingRect();
+	initDisplayImage(QSize(qCeil(boardRect.width() * dpi / GraphicsUtils::SVGDPI), qCeil(boardRect.height() * dpi / GraphicsUtils::SVGDPI)));
+	return checkRegion(routedRegion, keepoutMils, dpi, m_displayImage);
+}
+
+bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThing *> & collidingThings, double keepoutMils) {
+	bool bothSidesNow = m_sketchWidget->boardLayers() == 2;
+
+	QList< QList<ConnectorItem *> > equis;
+	QList< QList<ConnectorItem *> > singletons;
+	collectEquis(equis, singletons);
+	mergeSingletons(singletons, equis);
+
+	double dpi = rasterDPI(keepoutMils);
 	QRectF boardRect = m_board->sceneBoundingRect();
 	QRectF sourceRes(0, 0,
 					 boardRect.width() * dpi / GraphicsUtils::SVGDPI,
@@ -357,53 +500,51 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 
 	QSize imgSize(qCeil(sourceRes.width()), qCeil(sourceRes.height()));
 
-	m_plusImage = new QImage(imgSize, QImage::Format_Mono);
-	m_plusImage->fill(0xffffffff);
-
-	m_minusImage = new QImage(imgSize, QImage::Format_Mono);
-	m_minusImage->fill(0);
-
-	m_displayImage = new QImage(imgSize, QImage::Format_Indexed8);
-	m_displayImage->setColor(0, 0);
-	m_displayImage->setColor(1, 0x80ff0000);
-	m_displayImage->setColor(2, 0xffffff00);
-	m_displayImage->fill(0);
-
-	if (!makeBoard(m_minusImage, sourceRes)) {
-		message = tr("Fritzing error: unable to render board svg.");
-		return false;
+	// a large board is rasterized one tile at a time, so only one tile's images are in memory;
+	// then the display image is kept at a lower resolution
+	bool tiled = SettingsCache::boolValue(TiledSettingName) || (qint64) imgSize.width() * imgSize.height() > MaxUntiledPixels;
+	QList<DRCTile> tiles = makeTiles(imgSize, tiled ? TileSize : qMax(imgSize.width(), imgSize.height()), qCeil(keepoutMils * dpi / GraphicsUtils::StandardFritzingDPI) + 1);
+	QSize tileSize;
+	Q_FOREACH (DRCTile tile, tiles) {
+		tileSize = tileSize.expandedTo(tile.rect.size());
 	}
 
-	extendBorder(1, m_minusImage);   // since the resolution = keepout, extend by 1
+	double displayDPI = tiled ? qMin(dpi, TiledDisplayDPI) : dpi;
+	m_displayScale = displayDPI / dpi;
 
 	QList<ViewLayer::ViewLayerPlacement> layerSpecs;
 	layerSpecs << ViewLayer::NewBottom;
 	if (bothSidesNow) layerSpecs << ViewLayer::NewTop;
 
+	m_maxProgress = (equis.count() + 1) * layerSpecs.count() * tiles.count();
+	Q_EMIT setMaximumProgress(m_maxProgress);
+	int progress = 1;
+	Q_EMIT setProgressValue(progress);
+
+	ProcessEventBlocker::processEvents();
+
+	m_plusImage = new QImage(tileSize, QImage::Format_Mono);
+	m_plusImage->fill(0xffffffff);
+
+	m_minusImage = new QImage(tileSize, QImage::Format_Mono);
+	m_minusImage->fill(0);
+
+	initDisplayImage(QSize(qCeil(imgSize.width() * m_displayScale), qCeil(imgSize.height() * m_displayScale)));
+
+	QImage hitImage(tileSize, QImage::Format_Mono);
+
 	int emptyMasterCount = 0;
 	Q_FOREACH (ViewLayer::ViewLayerPlacement viewLayerPlacement, layerSpecs) {
-		if (viewLayerPlacement == ViewLayer::NewTop) {
-			Q_EMIT wantTopVisible();
-			m_plusImage->fill(0xffffffff);
-		}
-		else Q_EMIT wantBottomVisible();
-
 		LayerList viewLayerIDs = ViewLayer::copperLayers(viewLayerPlacement);
 		viewLayerIDs.removeOne(ViewLayer::GroundPlane0);
 		viewLayerIDs.removeOne(ViewLayer::GroundPlane1);
-		RenderThing renderThing;
-		renderThing.printerScale = GraphicsUtils::SVGDPI;
-		renderThing.blackOnly = true;
-		renderThing.dpi = GraphicsUtils::StandardFritzingDPI;
-		renderThing.hideTerminalPoints = renderThing.selectedItems = renderThing.renderBlocker = false;
-		QString master = m_sketchWidget->renderToSVG(renderThing, m_board, viewLayerIDs);
+		QString master = renderLayers(viewLayerIDs);
 		if (master.isEmpty()) {
 			if (++emptyMasterCount == layerSpecs.count()) {
 				message = tr("No traces or connectors to check");
 				return false;
 			}
 
-			progress++;
 			continue;
 		}
 
@@ -418,26 +559,62 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 			return false;
 		}
 
-		ProcessEventBlocker::processEvents();
-		if (m_cancelled) {
-			message = CancelledMessage;
-			return false;
-		}
-
 		QDomElement root = masterDoc->documentElement();
 		SvgFileSplitter::forceStrokeWidth(root, 2 * keepoutMils, "#000000", true, false);
+	}
 
-		ItemBase::renderOne(masterDoc, m_plusImage, sourceRes);
+	bool boardReady = false;
+	Q_FOREACH (ViewLayer::ViewLayerPlacement viewLayerPlacement, layerSpecs) {
+		if (viewLayerPlacement == ViewLayer::NewTop) Q_EMIT wantTopVisible();
+		else Q_EMIT wantBottomVisible();
 
-		ProcessEventBlocker::processEvents();
-		if (m_cancelled) {
-			message = CancelledMessage;
-			return false;
+		QDomDocument * masterDoc = m_masterDocs.value(viewLayerPlacement, nullptr);
+		if (masterDoc == nullptr) {
+			progress += tiles.count();
+			continue;
 		}
 
+		LayerList viewLayerIDs = ViewLayer::copperLayers(viewLayerPlacement);
+		viewLayerIDs.removeOne(ViewLayer::GroundPlane0);
+		viewLayerIDs.removeOne(ViewLayer::GroundPlane1);
+
 		QList<QPointF> atPixels;
-		if (pixelsCollide(m_plusImage, m_minusImage, m_displayImage, 0, 0, imgSize.width(), imgSize.height(), 1 /* 0x80ff0000 */, atPixels)) {
-			CollidingThing * collidingThing = findItemsAt(atPixels, m_board, viewLayerIDs, keepoutMils, dpi, true, nullptr);
+		Q_FOREACH (DRCTile tile, tiles) {
+			QPoint origin = tile.rect.topLeft();
+			QRect core = tile.core.translated(-origin);
+
+			if (tiles.count() > 1 || !boardReady) {
+				m_minusImage->fill(0);
+				QRectF boardRes(-origin.x(), -origin.y(), imgSize.width(), imgSize.height());
+				if (!makeBoard(m_minusImage, boardRes, 1)) {       // since the resolution = keepout, extend by 1
+					message = tr("Fritzing error: unable to render board svg.");
+					return false;
+				}
+
+				boardReady = true;
+			}
+
+			m_plusImage->fill(0xffffffff);
+			ItemBase::renderOne(masterDoc, m_plusImage, sourceRes.translated(-origin));
+
+			ProcessEventBlocker::processEvents();
+			if (m_cancelled) {
+				message = CancelledMessage;
+				return false;
+			}
+
+			QList<QPointF> tilePixels;
+			hitImage.fill(0);
+			if (DRCPixels::pixelsCollide(m_plusImage, m_minusImage, &hitImage, core.left(), core.top(), core.right() + 1, core.bottom() + 1, 1, tilePixels)) {
+				markDisplay(hitImage, origin);
+				appendDisplayPixels(tilePixels, origin, atPixels);
+			}
+
+			Q_EMIT setProgressValue(progress++);
+		}
+
+		if (atPixels.count() > 0) {
+			CollidingThing * collidingThing = findItemsAt(atPixels, m_board, viewLayerIDs, keepoutMils, displayDPI, true, nullptr);
 			QString msg = tr("Too close to a border (%1 layer)")
 						  .arg(viewLayerPlacement == ViewLayer::NewTop ? ItemBase::TranslatedPropertyNames.value("top") : ItemBase::TranslatedPropertyNames.value("bottom"))
 						  ;
@@ -447,33 +624,11 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 			updateDisplay();
 		}
 
-		Q_EMIT setProgressValue(progress++);
-
 		ProcessEventBlocker::processEvents();
 		if (m_cancelled) {
 			message = CancelledMessage;
 			return false;
 		}
-
-	}
-
-	// we are checking all the singletons at once
-	// but the DRC will miss it if any of them overlap each other
-
-	while (singletons.count() > 0) {
-		QList<ConnectorItem *> combined;
-		QList<ConnectorItem *> singleton = singletons.takeFirst();
-		ItemBase * chief = singleton.at(0)->attachedTo()->layerKinChief();
-		combined.append(singleton);
-		for (int ix = singletons.count() - 1; ix >= 0; ix--) {
-			QList<ConnectorItem *> candidate = singletons.at(ix);
-			if (candidate.at(0)->attachedTo()->layerKinChief() == chief) {
-				combined.append(candidate);
-				singletons.removeAt(ix);
-			}
-		}
-
-		equis.append(combined);
 	}
 
 	int index = 0;
@@ -482,12 +637,16 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 		else Q_EMIT wantBottomVisible();
 
 		QDomDocument * masterDoc = m_masterDocs.value(viewLayerPlacement, nullptr);
-		if (masterDoc == nullptr) continue;
+		if (masterDoc == nullptr) {
+			progress += equis.count() * tiles.count();
+			continue;
+		}
 
 		LayerList viewLayerIDs = ViewLayer::copperLayers(viewLayerPlacement);
 		viewLayerIDs.removeOne(ViewLayer::GroundPlane0);
 		viewLayerIDs.removeOne(ViewLayer::GroundPlane1);
 
+		QVector<NetCheck> netChecks;
 		Q_FOREACH (QList<ConnectorItem *> equi, equis) {
 			bool inLayer = false;
 			Q_FOREACH (ConnectorItem * equ, equi) {
@@ -497,16 +656,14 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 				}
 			}
 			if (!inLayer) {
-				progress++;
+				progress += tiles.count();
 				continue;
 			}
 
 			// we have a net;
-			m_plusImage->fill(0xffffffff);
-			m_minusImage->fill(0xffffffff);
-			splitNet(masterDoc, equi, m_minusImage, m_plusImage, sourceRes, viewLayerPlacement, index++, keepoutMils);
-
-			QHash<ConnectorItem *, QRectF> rects;
+			NetCheck netCheck;
+			netCheck.equi = equi;
+			netCheck.index = index++;
 			QList<Wire *> wires;
 			Q_FOREACH (ConnectorItem * equ, equi) {
 				if (viewLayerIDs.contains(equ->attachedToViewLayerID())) {
@@ -515,49 +672,309 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 						if (!wires.contains(wire)) {
 							wires.append(wire);
 							// could break diagonal wires into a series of rects
-							rects.insert(equ, wire->sceneBoundingRect());
+							netCheck.rects.append(qMakePair(equ, wire->sceneBoundingRect()));
 						}
 					}
 					else {
-						rects.insert(equ, equ->sceneBoundingRect());
+						netCheck.rects.append(qMakePair(equ, equ->sceneBoundingRect()));
 					}
 				}
 			}
 
-			ProcessEventBlocker::processEvents();
-			if (m_cancelled) {
-				message = CancelledMessage;
-				return false;
-			}
-
-			Q_FOREACH (ConnectorItem * equ, rects.keys()) {
-				QRectF rect = rects.value(equ).intersected(boardRect);
+			for (int i = 0; i < netCheck.rects.count(); i++) {
+				QRectF rect = netCheck.rects.at(i).second.intersected(boardRect);
 				double l = (rect.left() - boardRect.left()) * dpi / GraphicsUtils::SVGDPI;
 				double t = (rect.top() - boardRect.top()) * dpi / GraphicsUtils::SVGDPI;
 				double r = (rect.right() - boardRect.left()) * dpi / GraphicsUtils::SVGDPI;
 				double b = (rect.bottom() - boardRect.top()) * dpi / GraphicsUtils::SVGDPI;
 				//DebugDialog::debug(QString("l:%1 t:%2 r:%3 b:%4").arg(l).arg(t).arg(r).arg(b));
-				QList<QPointF> atPixels;
-				if (pixelsCollide(m_plusImage, m_minusImage, m_displayImage, l, t, r, b, 1 /* 0x80ff0000 */, atPixels)) {
+				netCheck.rects[i].second = QRectF(QPointF(l, t), QPointF(r, b));
+			}
+			netChecks.append(netCheck);
+		}
+
+		// hits per net and connector, gathered over the tiles
+		QVector< QList< QPair<ConnectorItem *, QList<QPointF> > > > hits(netChecks.count());
+		Q_FOREACH (DRCTile tile, tiles) {
+			// only the nets with a connector in the tile, with their rects clipped to the tile's core
+			QPoint origin = tile.rect.topLeft();
+			QRectF core(tile.core);
+			QVector<NetCheck> tileChecks;
+			QList<int> tileNets;
+			for (int ix = 0; ix < netChecks.count(); ix++) {
+				NetCheck tileCheck = netChecks.at(ix);
+				tileCheck.rects.clear();
+				for (int i = 0; i < netChecks.at(ix).rects.count(); i++) {
+					QRectF rect = netChecks.at(ix).rects.at(i).second.intersected(core);
+					if (rect.isEmpty()) continue;
+
+					tileCheck.rects.append(qMakePair(netChecks.at(ix).rects.at(i).first, rect.translated(-origin)));
+				}
+				if (tileCheck.rects.isEmpty()) {
+					progress++;
+					continue;
+				}
+
+				tileChecks.append(tileCheck);
+				tileNets.append(ix);
+			}
+
+			if (!checkNets(masterDoc, tileChecks, sourceRes.translated(-origin), origin, viewLayerPlacement, keepoutMils, progress)) {
+				message = CancelledMessage;
+				return false;
+			}
+
+			for (int t = 0; t < tileChecks.count(); t++) {
+				QList< QPair<ConnectorItem *, QList<QPointF> > > & netHits = hits[tileNets.at(t)];
+				Q_FOREACH (auto hit, tileChecks.at(t).hits) {
+					int h = 0;
+					while (h < netHits.count() && netHits.at(h).first != hit.first) h++;
+					if (h == netHits.count()) netHits.append(qMakePair(hit.first, QList<QPointF>()));
+					appendDisplayPixels(hit.second, origin, netHits[h].second);
+				}
+			}
+		}
+
+		for (int ix = 0; ix < netChecks.count(); ix++) {
+			for (int i = 0; i < hits.at(ix).count(); i++) {
+				CollidingThing * collidingThing = findItemsAt(hits[ix][i].second, m_board, viewLayerIDs, keepoutMils, displayDPI, false, hits.at(ix).at(i).first);
+				QStringList names = getNames(collidingThing);
+				QString name0 = names.at(0);
+				QString msg = tr("%1 is overlapping (%2 layer)")
+							  .arg(name0)
+							  .arg(viewLayerPlacement == ViewLayer::NewTop ? ItemBase::TranslatedPropertyNames.value("top") : ItemBase::TranslatedPropertyNames.value("bottom"))
+							  ;
+				messages << msg;
+				collidingThings << collidingThing;
+				Q_EMIT setProgressMessage(msg);
+			}
+		}
+		updateDisplay();
+
+		ProcessEventBlocker::processEvents();
+		if (m_cancelled) {
+			message = CancelledMessage;
+			return false;
+		}
+	}
+	checkHoles(messages, collidingThings, displayDPI);
+	checkCopperBoth(messages, collidingThings, displayDPI);
+
+	return true;
+}
+
+QList<DRCTile> DRC::makeTiles(const QSize & imageSize, int tileSize, int margin) {
+	// cores cover the image without overlap; each tile adds a margin around its core, clipped to the image
+	QList<DRCTile> tiles;
+	QRect image(QPoint(0, 0), imageSize);
+	for (int y = 0; y < imageSize.height(); y += tileSize) {
+		for (int x = 0; x < imageSize.width(); x += tileSize) {
+			DRCTile tile;
+			tile.core = QRect(x, y, tileSize, tileSize).intersected(image);
+			tile.rect = tile.core.adjusted(-margin, -margin, margin, margin).intersected(image);
+			tiles.append(tile);
+		}
+	}
+	return tiles;
+}
+
+void DRC::markDisplay(const QImage & hitImage, const QPoint & origin) {
+	// hitImage is a mono tile whose set pixels go into the display image, scaled to its resolution
+	int width = hitImage.width();
+	for (int y = 0; y < hitImage.height(); y++) {
+		const uchar * bits = hitImage.constScanLine(y);
+		for (int x = 0; x < width; x += 8) {
+			uchar byte = bits[x >> 3];
+			if (byte == 0) continue;
+
+			for (int bit = 0; bit < 8 && x + bit < width; bit++) {
+				if ((byte & BitTable[bit]) == 0) continue;
+
+				int dx = qFloor((x + bit + origin.x()) * m_displayScale);
+				int dy = qFloor((y + origin.y()) * m_displayScale);
+				if (dx < m_displayImage->width() && dy < m_displayImage->height()) {
+					m_displayImage->setPixel(dx, dy, 1 /* 0x80ff0000 */);
+				}
+			}
+		}
+	}
+}
+
+void DRC::appendDisplayPixels(const QList<QPointF> & tilePixels, const QPoint & origin, QList<QPointF> & displayPixels) {
+	Q_FOREACH (QPointF p, tilePixels) {
+		if (displayPixels.count() >= 1000) return;
+
+		QPointF d(qFloor((p.x() + origin.x()) * m_displayScale), qFloor((p.y() + origin.y()) * m_displayScale));
+		if (m_displayScale == 1 || !displayPixels.contains(d)) displayPixels.append(d);
+	}
+}
+
+bool DRC::checkNets(QDomDocument * masterDoc, QVector<NetCheck> & netChecks, const QRectF & sourceRes, const QPoint & origin, ViewLayer::ViewLayerPlacement viewLayerPlacement, double keepoutMils, int & progress) {
+	// the nets are split in parallel: each worker has its own copy of the master and its own images,
+	// and takes every workerCount-th net; the sketch is only read, and it doesn't change while the DRC runs
+	int base = progress;
+	progress += netChecks.count();
+	if (netChecks.isEmpty()) return !m_cancelled;
+
+	int workerCount = qBound(1, QThread::idealThreadCount(), netChecks.count());
+	QSize imgSize = m_plusImage->size();
+	QVector<NetScratch> scratches(workerCount);
+	for (int worker = 0; worker < workerCount; worker++) {
+		NetScratch & scratch = scratches[worker];
+		scratch.worker = worker;
+		scratch.doc = masterDoc->cloneNode(true).toDocument();
+		scratch.plusImage = QImage(imgSize, QImage::Format_Mono);
+		scratch.minusImage = QImage(imgSize, QImage::Format_Mono);
+		scratch.hitImage = QImage(imgSize, QImage::Format_Mono);
+		scratch.hitImage.fill(0);
+	}
+
+	std::atomic<int> done { 0 };
+	NetCheck * checks = netChecks.data();
+	int checkCount = netChecks.count();
+	QFuture<void> future = QtConcurrent::map(scratches, [&](NetScratch & scratch) {
+		for (int ix = scratch.worker; ix < checkCount; ix += workerCount) {
+			if (m_cancelled) return;
+
+			checkNet(scratch, checks[ix], sourceRes, viewLayerPlacement, keepoutMils);
+			done++;
+		}
+	});
+
+	while (!future.isFinished()) {
+		ProcessEventBlocker::processEvents(200);
+		Q_EMIT setProgressValue(base + done);
+	}
+	future.waitForFinished();
+	if (m_cancelled) return false;
+
+	// the workers only marked their own hit images
+	Q_FOREACH (NetScratch scratch, scratches) {
+		markDisplay(scratch.hitImage, origin);
+	}
+
+	Q_EMIT setProgressValue(progress);
+	return true;
+}
+
+void DRC::checkNet(NetScratch & scratch, NetCheck & netCheck, const QRectF & sourceRes, ViewLayer::ViewLayerPlacement viewLayerPlacement, double keepoutMils) {
+	// runs on a worker thread
+	Tracer::Scope tracing("drc.net", QString::number(netCheck.index));
+	QRectF renderRect = sourceRes;
+	scratch.plusImage.fill(0xffffffff);
+	scratch.minusImage.fill(0xffffffff);
+	splitNet(&scratch.doc, netCheck.equi, &scratch.minusImage, &scratch.plusImage, renderRect, viewLayerPlacement, netCheck.index, keepoutMils);
+
+	for (int i = 0; i < netCheck.rects.count(); i++) {
+		QRectF rect = netCheck.rects.at(i).second;
+		QList<QPointF> atPixels;
+		if (DRCPixels::pixelsCollide(&scratch.plusImage, &scratch.minusImage, &scratch.hitImage, rect.left(), rect.top(), rect.right(), rect.bottom(), 1, atPixels)) {
 
 #ifndef QT_NO_DEBUG
-					m_plusImage->save(FolderUtils::getTopLevelUserDataStorePath() + QString("/collidePlus%1_%2.png").arg(viewLayerPlacement).arg(index));
-					m_minusImage->save(FolderUtils::getTopLevelUserDataStorePath() + QString("/collideMinus%1_%2.png").arg(viewLayerPlacement).arg(index));
+			scratch.plusImage.save(FolderUtils::getTopLevelUserDataStorePath() + QString("/collidePlus%1_%2.png").arg(viewLayerPlacement).arg(netCheck.index));
+			scratch.minusImage.save(FolderUtils::getTopLevelUserDataStorePath() + QString("/collideMinus%1_%2.png").arg(viewLayerPlacement).arg(netCheck.index));
 #endif
 
-					CollidingThing * collidingThing = findItemsAt(atPixels, m_board, viewLayerIDs, keepoutMils, dpi, false, equ);
-					QStringList names = getNames(collidingThing);
-					QString name0 = names.at(0);
-					QString msg = tr("%1 is overlapping (%2 layer)")
-								  .arg(name0)
-								  .arg(viewLayerPlacement == ViewLayer::NewTop ? ItemBase::TranslatedPropertyNames.value("top") : ItemBase::TranslatedPropertyNames.value("bottom"))
-								  ;
-					messages << msg;
-					collidingThings << collidingThing;
-					Q_EMIT setProgressMessage(msg);
-					updateDisplay();
+			netCheck.hits.append(qMakePair(netCheck.rects.at(i).first, atPixels));
+		}
+	}
+}
+
+bool DRC::startGeometry(QString & message, QStringList & messages, QList<CollidingThing *> & collidingThings, double keepoutMils) {
+	// the masters are rendered in mils from the board's top left, so the copper shapes are checked against keepoutMils directly;
+	// copper text is not outlined in this mode
+	bool bothSidesNow = m_sketchWidget->boardLayers() == 2;
+
+	QList< QList<ConnectorItem *> > equis;
+	QList< QList<ConnectorItem *> > singletons;
+	collectEquis(equis, singletons);
+	mergeSingletons(singletons, equis);
+
+	m_maxProgress = equis.count() + 1;
+	if (bothSidesNow) m_maxProgress *= 2;
+	Q_EMIT setMaximumProgress(m_maxProgress);
+	int progress = 1;
+	Q_EMIT setProgressValue(progress);
+
+	ProcessEventBlocker::processEvents();
+
+	double dpi = GeometryDisplayDPI;
+	QRectF boardRect = m_board->sceneBoundingRect();
+	initDisplayImage(QSize(qCeil(boardRect.width() * dpi / GraphicsUtils::SVGDPI), qCeil(boardRect.height() * dpi / GraphicsUtils::SVGDPI)));
+
+	QPainterPath boardArea;
+	if (!makeBoardArea(boardArea)) {
+		message = tr("Fritzing error: unable to render board svg.");
+		return false;
+	}
+
+	QList<ViewLayer::ViewLayerPlacement> layerSpecs;
+	layerSpecs << ViewLayer::NewBottom;
+	if (bothSidesNow) layerSpecs << ViewLayer::NewTop;
+
+	int emptyMasterCount = 0;
+	Q_FOREACH (ViewLayer::ViewLayerPlacement viewLayerPlacement, layerSpecs) {
+		if (viewLayerPlacement == ViewLayer::NewTop) Q_EMIT wantTopVisible();
+		else Q_EMIT wantBottomVisible();
+
+		QString layerName = viewLayerPlacement == ViewLayer::NewTop ? ItemBase::TranslatedPropertyNames.value("top") : ItemBase::TranslatedPropertyNames.value("bottom");
+		LayerList viewLayerIDs = ViewLayer::copperLayers(viewLayerPlacement);
+		viewLayerIDs.removeOne(ViewLayer::GroundPlane0);
+		viewLayerIDs.removeOne(ViewLayer::GroundPlane1);
+		QString master = renderLayers(viewLayerIDs);
+		if (master.isEmpty()) {
+			if (++emptyMasterCount == layerSpecs.count()) {
+				message = tr("No traces or connectors to check");
+				return false;
+			}
+
+			progress += equis.count() + 1;
+			continue;
+		}
+
+		auto * masterDoc = new QDomDocument();
+		m_masterDocs.insert(viewLayerPlacement, masterDoc);
+
+		QString errorStr;
+		int errorLine;
+		int errorColumn;
+		if (!masterDoc->setContent(master, &errorStr, &errorLine, &errorColumn)) {
+			message = tr("Unexpected SVG rendering failure--contact fritzing.org");
+			return false;
+		}
+
+		CopperGeometry geometry;
+		QDomElement root = masterDoc->documentElement();
+		geometry.addShapes(root);
+
+		// the net index of a shape is its equi's index
+		for (int ix = 0; ix < equis.count(); ix++) {
+			QList<ConnectorItem *> equi = equis.at(ix);
+			bool inLayer = false;
+			Q_FOREACH (ConnectorItem * equ, equi) {
+				if (viewLayerIDs.contains(equ->attachedToViewLayerID())) {
+					inLayer = true;
+					break;
 				}
 			}
+			if (!inLayer) {
+				progress++;
+				continue;
+			}
+
+			QList<QDomElement> net;
+			QList<QDomElement> alsoNet;
+			QList<QDomElement> notNet;
+			Markers markers;
+			markers.outID = AlsoNet;
+			markers.inTerminalID = markers.inSvgID = markers.inSvgAndID = markers.inNoID = Net;
+			splitNetPrep(masterDoc, equi, markers, net, alsoNet, notNet, true);
+			Q_FOREACH (QDomElement element, net) {
+				geometry.setNet(CopperGeometry::shapeIndex(element), ix);
+				element.removeAttribute("net");
+			}
+			Q_FOREACH (QDomElement element, alsoNet) element.removeAttribute("net");
+			Q_FOREACH (QDomElement element, notNet) element.removeAttribute("net");
 
 			Q_EMIT setProgressValue(progress++);
 
@@ -567,41 +984,186 @@ bool DRC::startAux(QString & message, QStringList & messages, QList<CollidingThi
 				return false;
 			}
 		}
+
+		geometry.buildIndex();
+
+		// one message per connector, nearest to where its net's copper is too close to other copper
+		QList<ConnectorItem *> overlapping;
+		QHash<ConnectorItem *, QList<QPointF> > overlapPixels;
+		Q_FOREACH (CopperViolation violation, geometry.violations(keepoutMils)) {
+			int net = geometry.shapes().at(violation.shape1).net;
+			QPointF scenePoint = boardRect.topLeft() + violation.at * GraphicsUtils::SVGDPI / GraphicsUtils::StandardFritzingDPI;
+			ConnectorItem * equ = nearestConnector(equis.at(net), viewLayerIDs, scenePoint);
+			if (equ == nullptr) continue;
+
+			if (!overlapPixels.contains(equ)) overlapping << equ;
+			markGeometryPixels(m_displayImage, violation.at, keepoutMils, dpi, overlapPixels[equ]);
+		}
+
+		Q_FOREACH (ConnectorItem * equ, overlapping) {
+			CollidingThing * collidingThing = findItemsAt(overlapPixels[equ], m_board, viewLayerIDs, keepoutMils, dpi, false, equ);
+			QStringList names = getNames(collidingThing);
+			QString name0 = names.at(0);
+			QString msg = tr("%1 is overlapping (%2 layer)")
+						  .arg(name0)
+						  .arg(layerName)
+						  ;
+			messages << msg;
+			collidingThings << collidingThing;
+			Q_EMIT setProgressMessage(msg);
+			updateDisplay();
+		}
+
+		QList<QPointF> borderPixels;
+		Q_FOREACH (CopperViolation violation, geometry.outside(boardArea, keepoutMils)) {
+			markGeometryPixels(m_displayImage, violation.at, keepoutMils, dpi, borderPixels);
+		}
+		if (!borderPixels.isEmpty()) {
+			CollidingThing * collidingThing = findItemsAt(borderPixels, m_board, viewLayerIDs, keepoutMils, dpi, true, nullptr);
+			QString msg = tr("Too close to a border (%1 layer)")
+						  .arg(layerName)
+						  ;
+			Q_EMIT setProgressMessage(msg);
+			messages << msg;
+			collidingThings << collidingThing;
+			updateDisplay();
+		}
+
+		Q_EMIT setProgressValue(progress++);
+
+		ProcessEventBlocker::processEvents();
+		if (m_cancelled) {
+			message = CancelledMessage;
+			return false;
+		}
 	}
-	checkHoles(messages, collidingThings,  dpi);
+
+	checkHoles(messages, collidingThings, dpi);
 	checkCopperBoth(messages, collidingThings, dpi);
 
 	return true;
 }
 
-bool DRC::makeBoard(QImage * image, QRectF & sourceRes) {
-	LayerList viewLayerIDs;
-	viewLayerIDs << ViewLayer::Board;
+void DRC::collectEquis(QList< QList<ConnectorItem *> > & equis, QList< QList<ConnectorItem *> > & singletons) {
+	bool bothSidesNow = m_sketchWidget->boardLayers() == 2;
+
+	QList<ConnectorItem *> visited;
+	Q_FOREACH (QGraphicsItem * item, m_sketchWidget->scene()->items()) {
+		auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
+		if (connectorItem == nullptr) continue;
+		if (!connectorItem->attachedTo()->isEverVisible()) continue;
+		if (connectorItem->attachedTo()->getRatsnest()) continue;
+		if (visited.contains(connectorItem)) continue;
+
+		QList<ConnectorItem *> equi;
+		equi.append(connectorItem);
+		ConnectorItem::collectEqualPotential(
+					equi,
+					bothSidesNow,
+					(ViewGeometry::RatsnestFlag |
+					 ViewGeometry::NormalFlag |
+					 ViewGeometry::PCBTraceFlag |
+					 ViewGeometry::SchematicTraceFlag) ^ m_sketchWidget->getTraceFlag());
+		visited.append(equi);
+
+		if (equi.count() == 1) {
+			singletons.append(equi);
+			continue;
+		}
+
+		ItemBase * firstPart = connectorItem->attachedTo()->layerKinChief();
+		bool gotTwo = false;
+		Q_FOREACH (ConnectorItem * equ, equi) {
+			if (equ->attachedTo()->layerKinChief() != firstPart) {
+				gotTwo = true;
+				break;
+			}
+		}
+		if (!gotTwo) {
+			singletons.append(equi);
+			continue;
+		}
+
+		equis.append(equi);
+	}
+}
+
+void DRC::mergeSingletons(QList< QList<ConnectorItem *> > & singletons, QList< QList<ConnectorItem *> > & equis) {
+	// we are checking all the singletons at once
+	// but the DRC will miss it if any of them overlap each other
+
+	while (singletons.count() > 0) {
+		QList<ConnectorItem *> combined;
+		QList<ConnectorItem *> singleton = singletons.takeFirst();
+		ItemBase * chief = singleton.at(0)->attachedTo()->layerKinChief();
+		combined.append(singleton);
+		for (int ix = singletons.count() - 1; ix >= 0; ix--) {
+			QList<ConnectorItem *> candidate = singletons.at(ix);
+			if (candidate.at(0)->attachedTo()->layerKinChief() == chief) {
+				combined.append(candidate);
+				singletons.removeAt(ix);
+			}
+		}
+
+		equis.append(combined);
+	}
+}
+
+void DRC::initDisplayImage(const QSize & size) {
+	m_displayImage = new QImage(size, QImage::Format_Indexed8);
+	m_displayImage->setColor(0, 0);
+	m_displayImage->setColor(1, 0x80ff0000);
+	m_displayImage->setColor(2, 0xffffff00);
+	m_displayImage->fill(0);
+}
+
+QString DRC::renderLayers(const LayerList & viewLayerIDs) {
 	RenderThing renderThing;
 	renderThing.printerScale = GraphicsUtils::SVGDPI;
 	renderThing.blackOnly = true;
 	renderThing.dpi = GraphicsUtils::StandardFritzingDPI;
 	renderThing.hideTerminalPoints = renderThing.selectedItems = renderThing.renderBlocker = false;
-	QString boardSvg = m_sketchWidget->renderToSVG(renderThing, m_board, viewLayerIDs);
+	return m_sketchWidget->renderToSVG(renderThing, m_board, viewLayerIDs);
+}
+
+bool DRC::makeBoardArea(QPainterPath & area) {
+	// everything drawn in the board layer is board, as in makeBoard
+	LayerList viewLayerIDs;
+	viewLayerIDs << ViewLayer::Board;
+	QString boardSvg = renderLayers(viewLayerIDs);
 	if (boardSvg.isEmpty()) {
 		return false;
 	}
 
-	QByteArray boardByteArray;
-	QString tempColor("#ffffff");
-	QStringList exceptions;
-	exceptions << "none" << "";
-	if (!SvgFileSplitter::changeColors(boardSvg, tempColor, exceptions, boardByteArray)) {
+	QDomDocument doc;
+	if (!doc.setContent(boardSvg)) {
+		return false;
+	}
+
+	CopperGeometry boardGeometry;
+	QDomElement root = doc.documentElement();
+	if (boardGeometry.addShapes(root) == 0) {
 		return false;
 	}
 
-	QSvgRenderer renderer(boardByteArray);
-	QPainter painter;
-	painter.begin(image);
-	painter.setRenderHint(QPainter::Antialiasing, false);
+	area = boardGeometry.area();
+	return true;
+}
+
+bool DRC::makeBoard(QImage * image, const QRectF & sourceRes, double extendBy) {
+	LayerList viewLayerIDs;
+	viewLayerIDs << ViewLayer::Board;
+	QString boardSvg = renderLayers(viewLayerIDs);
+	if (boardSvg.isEmpty()) {
+		return false;
+	}
+
+	QStringList exceptions;
+	exceptions << "none" << "";
 	DebugDialog::debug("boardbounds", sourceRes);
-	renderer.render(&painter  /*, sourceRes */);
-	painter.end();
+	if (!BoardMaskCache::mask(boardSvg, exceptions, image->size(), sourceRes, extendBy, *image)) {
+		return false;
+	}
 
 	// board should be white, borders should be black
 
@@ -933,19 +1495,89 @@ void DRC::cancel() {
 }
 
 CollidingThing * DRC::findItemsAt(QList<QPointF> & atPixels, ItemBase * board, const LayerList & viewLayerIDs, double keepoutMils, double dpi, bool skipHoles, ConnectorItem * already) {
-	Q_UNUSED(board);
-	Q_UNUSED(viewLayerIDs);
-	Q_UNUSED(keepoutMils);
-	Q_UNUSED(dpi);
-	Q_UNUSED(skipHoles);
-
+	// attribute display image pixels to the copper under them: already, if known, and whatever else is within keepout,
+	// nearest first; the item index is built once per run however many collisions there are
 	auto * collidingThing = new CollidingThing;
 	collidingThing->nonConnectorItem = already;
 	collidingThing->atPixels = atPixels;
+	if (atPixels.isEmpty()) return collidingThing;
+
+	buildItemIndex();
+	if (m_itemIndex.isEmpty()) return collidingThing;
+
+	QPointF p0 = atPixels.first();
+	double l = p0.x(), t = p0.y(), r = p0.x(), b = p0.y();
+	Q_FOREACH (QPointF p, atPixels) {
+		l = qMin(l, p.x());
+		t = qMin(t, p.y());
+		r = qMax(r, p.x());
+		b = qMax(b, p.y());
+	}
+	QPointF boardOrigin = board->sceneBoundingRect().topLeft();
+	double scale = GraphicsUtils::SVGDPI / dpi;                 // display pixels to scene pixels
+	double keepout = keepoutMils * GraphicsUtils::SVGDPI / 1000;
+	QRectF sceneRect(boardOrigin.x() + l * scale, boardOrigin.y() + t * scale, (r - l + 1) * scale, (b - t + 1) * scale);
+	QPointF center = sceneRect.center();
+	sceneRect.adjust(-keepout, -keepout, keepout, keepout);
+
+	QVector<int> found;
+	m_itemIndex.intersecting(sceneRect, found);
+	QList< QPair<double, NonConnectorItem *> > candidates;
+	Q_FOREACH (int ix, found) {
+		NonConnectorItem * nci = m_indexedItems.at(ix);
+		if (nci == already) continue;
+		if (!viewLayerIDs.contains(nci->attachedToViewLayerID())) continue;
+		if (skipHoles && nci->attachedToItemType() == ModelPart::Hole) continue;
+		if (already != nullptr && nci->attachedTo() == already->attachedTo() && nci->attachedToItemType() == ModelPart::Wire) continue;
+
+		QRectF ir = (nci->attachedToItemType() == ModelPart::Wire) ? nci->attachedTo()->sceneBoundingRect() : nci->sceneBoundingRect();
+		double dx = qMax(0.0, qMax(ir.left() - center.x(), center.x() - ir.right()));
+		double dy = qMax(0.0, qMax(ir.top() - center.y(), center.y() - ir.bottom()));
+		candidates.append(qMakePair(dx * dx + dy * dy, nci));
+	}
+	std::stable_sort(candidates.begin(), candidates.end(),
+	                 [](const QPair<double, NonConnectorItem *> & a, const QPair<double, NonConnectorItem *> & b) { return a.first < b.first; });
+
+	for (int i = 0; i < candidates.count(); i++) {
+		if (collidingThing->nonConnectorItem == nullptr) collidingThing->nonConnectorItem = candidates.at(i).second;
+		else collidingThing->others.append(candidates.at(i).second);
+	}
 
 	return collidingThing;
 }
 
+void DRC::buildItemIndex() {
+	// one entry per connector, and one per trace, which is looked up by its whole extent as in nearestConnector
+	if (m_itemIndexBuilt) return;
+
+	m_itemIndexBuilt = true;
+	QVector<QRectF> rects;
+	QSet<ItemBase *> wires;
+	Q_FOREACH (QGraphicsItem * item, m_sketchWidget->scene()->collidingItems(m_board)) {
+		NonConnectorItem * nci = dynamic_cast<NonConnectorItem *>(item);
+		if (nci == nullptr) {
+			auto * wire = dynamic_cast<Wire *>(item);
+			if (wire == nullptr || !wire->getTrace()) continue;
+			nci = wire->connector0();
+			if (nci == nullptr) continue;
+		}
+		if (nci->attachedTo() == nullptr || !nci->attachedTo()->isEverVisible()) continue;
+
+		QRectF r;
+		if (nci->attachedToItemType() == ModelPart::Wire) {
+			if (wires.contains(nci->attachedTo())) continue;
+			wires.insert(nci->attachedTo());
+			r = nci->attachedTo()->sceneBoundingRect();
+		}
+		else r = nci->sceneBoundingRect();
+
+		m_indexedItems.append(nci);
+		rects.append(r);
+	}
+
+	m_itemIndex.build(rects);
+}
+
 void DRC::extendBorder(const double keepout, QImage * image) {
 	Q_ASSERT(image->format() == QImage::Format_Mono);
 	// keepout in terms of the board grid size
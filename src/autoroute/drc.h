@@ -24,6 +24,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QList>
 #include <QObject>
 #include <QImage>
+#include <QPainterPath>
 #include <QDomDocument>
 #include <QGraphicsPixmapItem>
 #include <QDialog>
@@ -31,15 +32,47 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QRadioButton>
 #include <QListWidgetItem>
 #include <QPointer>
+#include <QVector>
 
+#include <atomic>
+
+#include "drcgeometry.h"
 #include "../svg/svgfilesplitter.h"
 #include "../viewlayer.h"
 
 struct CollidingThing {
 	QPointer<class NonConnectorItem> nonConnectorItem;
+	QList< QPointer<class NonConnectorItem> > others;        // copper of other parts under the pixels
 	QList<QPointF> atPixels;
 };
 
+struct DRCViolation {
+	QString message;
+	QStringList parts;          // instance titles
+	QRectF area;                // in mils from the board's top left; null when there is nothing to point at
+};
+
+struct NetCheck {
+	QList<class ConnectorItem *> equi;
+	int index = 0;
+	QList< QPair<class ConnectorItem *, QRectF> > rects;          // where to look for collisions, in image pixels
+	QList< QPair<class ConnectorItem *, QList<QPointF> > > hits;
+};
+
+struct NetScratch {
+	// one worker's copy of the master and its images
+	int worker = 0;
+	QDomDocument doc;
+	QImage plusImage;
+	QImage minusImage;
+	QImage hitImage;
+};
+
+struct DRCTile {
+	QRect rect;                 // the pixels rendered, in board image pixels
+	QRect core;                 // the pixels checked; cores don't overlap
+};
+
 struct Markers {
 	QString inSvgID;
 	QString inSvgAndID;
@@ -60,10 +93,14 @@ public:
 	virtual ~DRC();
 
 	QStringList start(bool showOkMessage, double keepoutMils);
+	int checkRegion(const QRectF & sceneRegion, double keepoutMils, double dpi, QImage * displayImage);
+	int verifyRoute(const QRectF & routedRegion, double keepoutMils);
+	const QList<DRCViolation> & violations() const;
 
 public:
 	static void splitNetPrep(QDomDocument * masterDoc, QList<ConnectorItem *> & equi, const Markers &, QList<QDomElement> & net, QList<QDomElement> & alsoNet, QList<QDomElement> & notNet, bool checkIntersection);
 	static void extendBorder(double keepoutImagePixels, QImage * image);
+	static double rasterDPI(double keepoutMils);
 
 public Q_SLOTS:
 	void cancel();
@@ -84,20 +121,35 @@ public:
 	static const uchar BitTable[];
 	static const QString KeepoutSettingName;
 	static const double KeepoutDefaultMils;
+	static const QString GeometrySettingName;
+	static const QString TiledSettingName;
 
 protected:
-	bool makeBoard(QImage *, QRectF & sourceRes);
+	bool makeBoard(QImage *, const QRectF & renderRect, double extendBy);
+	bool makeBoardArea(QPainterPath &);
 	void splitNet(QDomDocument *, QList<ConnectorItem *> &, QImage * minusImage, QImage * plusImage, QRectF & sourceRes, ViewLayer::ViewLayerPlacement viewLayerPlacement, int index, double keepoutMils);
+	bool checkNets(QDomDocument *, QVector<NetCheck> &, const QRectF & sourceRes, const QPoint & origin, ViewLayer::ViewLayerPlacement, double keepoutMils, int & progress);
+	void markDisplay(const QImage & hitImage, const QPoint & origin);
+	void appendDisplayPixels(const QList<QPointF> & tilePixels, const QPoint & origin, QList<QPointF> & displayPixels);
+	void checkNet(NetScratch &, NetCheck &, const QRectF & sourceRes, ViewLayer::ViewLayerPlacement, double keepoutMils);
 	void updateDisplay();
 	bool startAux(QString & message, QStringList & messages, QList<CollidingThing *> &, double keepoutMils);
+	bool startGeometry(QString & message, QStringList & messages, QList<CollidingThing *> &, double keepoutMils);
+	void collectEquis(QList< QList<ConnectorItem *> > & equis, QList< QList<ConnectorItem *> > & singletons);
+	void initDisplayImage(const QSize &);
+	QString renderLayers(const LayerList & viewLayerIDs);
 	CollidingThing * findItemsAt(QList<QPointF> &, ItemBase * board, const LayerList & viewLayerIDs, double keepout, double dpi, bool skipHoles, ConnectorItem * already);
 	void checkHoles(QStringList & messages, QList<CollidingThing *> & collidingThings, double dpi);
 	void checkCopperBoth(QStringList & messages, QList<CollidingThing *> & collidingThings, double dpi);
+	void buildItemIndex();
+	void collectViolations(const QStringList & messages, const QList<CollidingThing *> &);
 	QList<ConnectorItem *> missingCopper(const QString & layerName, ViewLayer::ViewLayerID, ItemBase *, const QDomElement & svgRoot);
 
 protected:
 	static void markSubs(QDomElement & root, const QString & mark);
 	static void splitSubs(QDomDocument *, QDomElement & root, const QString & partID, const Markers &, const QStringList & svgIDs,  const QStringList & terminalIDs, const QList<ItemBase *> &, QHash<QString, QString> & both, bool checkIntersection);
+	static QList<DRCTile> makeTiles(const QSize & imageSize, int tileSize, int margin);
+	static void mergeSingletons(QList< QList<ConnectorItem *> > & singletons, QList< QList<ConnectorItem *> > & equis);
 
 protected:
 	PCBSketchWidget * m_sketchWidget;
@@ -108,8 +160,14 @@ protected:
 	QImage * m_displayImage;
 	QGraphicsPixmapItem * m_displayItem;
 	QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> m_masterDocs;
-	bool m_cancelled;
+	std::atomic<bool> m_cancelled;
 	int m_maxProgress;
+	bool m_geometry;
+	double m_displayScale;
+	QList<DRCViolation> m_violations;
+	RTree m_itemIndex;                          // copper on the board, in scene coordinates; built by the first findItemsAt
+	QList<class NonConnectorItem *> m_indexedItems;
+	bool m_itemIndexBuilt;
 };
 
 class DRCResultsDialog : public QDialog
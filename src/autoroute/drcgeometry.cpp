@@ -0,0 +1,537 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "drcgeometry.h"
+#include "../svg/svgfilesplitter.h"
+#include "../svg/svgpathscanner.h"
+#include "../utils/textutils.h"
+
+#include <QPainterPathStroker>
+#include <QRegularExpression>
+#include <QStringList>
+#include <qmath.h>
+
+#include <algorithm>
+
+const QString CopperGeometry::ShapeAttribute("drcshape");
+
+static bool overlaps(const QRectF & r1, const QRectF & r2) {
+	// unlike QRectF::intersects, keeps rects with no width or height
+	return r1.left() <= r2.right() && r2.left() <= r1.right() && r1.top() <= r2.bottom() && r2.top() <= r1.bottom();
+}
+
+static QRectF grow(const QRectF & r, double by) {
+	return r.adjusted(-by, -by, by, by);
+}
+
+///////////////////////////////////////////////
+
+void RTree::build(const QVector<QRectF> & rects) {
+	m_rects = rects;
+	m_nodes.clear();
+	m_entries.clear();
+	m_root = -1;
+	if (rects.isEmpty()) return;
+
+	std::vector<int> level(rects.count());
+	for (int i = 0; i < rects.count(); i++) level[i] = i;
+
+	level = pack(level, true);
+	while (level.size() > 1) {
+		level = pack(level, false);
+	}
+	m_root = level.front();
+}
+
+std::vector<int> RTree::pack(std::vector<int> & entries, bool leaf) {
+	// sort-tile-recursive: cut the entries into vertical slices by center x, then cut each slice into nodes by center y
+	auto byX = [this, leaf](int e1, int e2) { return entryBounds(e1, leaf).center().x() < entryBounds(e2, leaf).center().x(); };
+	auto byY = [this, leaf](int e1, int e2) { return entryBounds(e1, leaf).center().y() < entryBounds(e2, leaf).center().y(); };
+
+	int count = (int) entries.size();
+	int nodeCount = (count + MaxEntries - 1) / MaxEntries;
+	int sliceSize = qCeil(qSqrt(nodeCount)) * MaxEntries;
+	std::sort(entries.begin(), entries.end(), byX);
+
+	std::vector<int> nodes;
+	for (int slice = 0; slice < count; slice += sliceSize) {
+		int sliceEnd = qMin(count, slice + sliceSize);
+		std::sort(entries.begin() + slice, entries.begin() + sliceEnd, byY);
+		for (int first = slice; first < sliceEnd; first += MaxEntries) {
+			Node node;
+			node.leaf = leaf;
+			node.first = (int) m_entries.size();
+			node.count = qMin(MaxEntries, sliceEnd - first);
+			node.bounds = entryBounds(entries[first], leaf);
+			for (int i = first; i < first + node.count; i++) {
+				m_entries.push_back(entries[i]);
+				node.bounds = node.bounds.united(entryBounds(entries[i], leaf));
+			}
+			nodes.push_back((int) m_nodes.size());
+			m_nodes.push_back(node);
+		}
+	}
+
+	return nodes;
+}
+
+QRectF RTree::entryBounds(int entry, bool leaf) const {
+	return leaf ? m_rects.at(entry) : m_nodes[entry].bounds;
+}
+
+void RTree::intersecting(const QRectF & rect, QVector<int> & result) const {
+	result.clear();
+	if (m_root < 0) return;
+
+	QVector<int> todo;
+	todo.append(m_root);
+	while (!todo.isEmpty()) {
+		const Node & node = m_nodes[todo.takeLast()];
+		if (!overlaps(node.bounds, rect)) continue;
+
+		for (int i = node.first; i < node.first + node.count; i++) {
+			int entry = m_entries[i];
+			if (node.leaf) {
+				if (overlaps(m_rects.at(entry), rect)) result.append(entry);
+			}
+			else todo.append(entry);
+		}
+	}
+}
+
+bool RTree::isEmpty() const {
+	return m_root < 0;
+}
+
+///////////////////////////////////////////////
+
+int CopperGeometry::addShapes(QDomElement & root) {
+	// each drawing element under root becomes a shape and is marked with the shape's index
+	int before = m_shapes.count();
+	SvgFileSplitter::fixStyleAttributeRecurse(root);
+	addShapesAux(root, QTransform(), Style());
+	return m_shapes.count() - before;
+}
+
+void CopperGeometry::addShapesAux(QDomElement & element, const QTransform & parentTransform, Style style) {
+	static const QStringList NotDrawn = {
+		"defs", "title", "desc", "metadata", "clipPath", "mask", "pattern", "marker", "symbol", "image",
+		"text", "tspan"  // text outlines would need the fonts; the raster check still covers copper text
+	};
+
+	static const QStringList NoOutline = { "image", "text", "tspan", "use" };
+
+	if (element.attribute("display") == "none") return;
+	if (NoOutline.contains(element.tagName()) || element.hasAttribute("clip-path") || element.hasAttribute("mask")) {
+		m_allVector = false;
+	}
+	if (NotDrawn.contains(element.tagName())) return;
+
+	QTransform transform = TextUtils::elementToTransform(element) * parentTransform;
+	if (element.tagName() == "svg" && !element.parentNode().isDocument()) {
+		// nested svg: take its offset; any viewBox scaling on it is ignored
+		transform = QTransform::fromTranslate(element.attribute("x").toDouble(), element.attribute("y").toDouble()) * transform;
+	}
+
+	inheritStyle(element, style);
+
+	QPainterPath path;
+	bool fillable = true;
+	if (elementPath(element, path, fillable)) {
+		path.setFillRule(style.fillRule);
+		QPainterPath outline;
+		if (fillable && style.fill) outline = path;
+		if (style.stroke && style.strokeWidth > 0) {
+			QPainterPathStroker stroker;
+			stroker.setWidth(style.strokeWidth);
+			stroker.setCapStyle(style.cap);
+			stroker.setJoinStyle(style.join);
+			QPainterPath stroke = stroker.createStroke(path);
+			outline = outline.isEmpty() ? stroke : outline.united(stroke);
+		}
+		if (outline.isEmpty()) return;
+
+		CopperShape shape;
+		shape.color = (fillable && style.fill) ? style.fillColor : style.strokeColor;
+		shape.outline = transform.map(outline);
+		shape.bounds = shape.outline.boundingRect();
+		element.setAttribute(ShapeAttribute, m_shapes.count());
+		m_shapes.append(shape);
+		return;
+	}
+
+	QDomElement child = element.firstChildElement();
+	while (!child.isNull()) {
+		addShapesAux(child, transform, style);
+		child = child.nextSiblingElement();
+	}
+}
+
+void CopperGeometry::inheritStyle(const QDomElement & element, Style & style) {
+	QString fill = element.attribute("fill");
+	if (!fill.isEmpty()) {
+		style.fill = (fill != "none");
+		if (style.fill) style.fillColor = fill.toLower();
+	}
+	QString stroke = element.attribute("stroke");
+	if (!stroke.isEmpty()) {
+		style.stroke = (stroke != "none");
+		if (style.stroke) style.strokeColor = stroke.toLower();
+	}
+
+	bool ok;
+	double strokeWidth = element.attribute("stroke-width").toDouble(&ok);
+	if (ok) style.strokeWidth = strokeWidth;
+	double opacity = element.attribute("fill-opacity").toDouble(&ok);
+	if (ok && opacity <= 0) style.fill = false;
+	opacity = element.attribute("stroke-opacity").toDouble(&ok);
+	if (ok && opacity <= 0) style.stroke = false;
+
+	QString cap = element.attribute("stroke-linecap");
+	if (cap == "round") style.cap = Qt::RoundCap;
+	else if (cap == "square") style.cap = Qt::SquareCap;
+	else if (cap == "butt") style.cap = Qt::FlatCap;
+
+	QString join = element.attribute("stroke-linejoin");
+	if (join == "round") style.join = Qt::RoundJoin;
+	else if (join == "bevel") style.join = Qt::BevelJoin;
+	else if (join == "miter") style.join = Qt::MiterJoin;
+
+	QString fillRule = element.attribute("fill-rule");
+	if (fillRule == "evenodd") style.fillRule = Qt::OddEvenFill;
+	else if (fillRule == "nonzero") style.fillRule = Qt::WindingFill;
+}
+
+bool CopperGeometry::elementPath(const QDomElement & element, QPainterPath & path, bool & fillable) {
+	// returns false if element is not a drawing element
+	fillable = true;
+	QString tagName = element.tagName();
+	if (tagName == "circle") {
+		double r = element.attribute("r").toDouble();
+		if (r > 0) path.addEllipse(QPointF(element.attribute("cx").toDouble(), element.attribute("cy").toDouble()), r, r);
+		return true;
+	}
+
+	if (tagName == "ellipse") {
+		double rx = element.attribute("rx").toDouble();
+		double ry = element.attribute("ry").toDouble();
+		if (rx > 0 && ry > 0) path.addEllipse(QPointF(element.attribute("cx").toDouble(), element.attribute("cy").toDouble()), rx, ry);
+		return true;
+	}
+
+	if (tagName == "rect") {
+		QRectF r(element.attribute("x").toDouble(), element.attribute("y").toDouble(), element.attribute("width").toDouble(), element.attribute("height").toDouble());
+		if (r.width() <= 0 || r.height() <= 0) return true;
+
+		bool rxOK, ryOK;
+		double rx = element.attribute("rx").toDouble(&rxOK);
+		double ry = element.attribute("ry").toDouble(&ryOK);
+		if (rxOK && !ryOK) ry = rx;
+		else if (ryOK && !rxOK) rx = ry;
+		rx = qMin(rx, r.width() / 2);
+		ry = qMin(ry, r.height() / 2);
+		if (rx > 0 && ry > 0) path.addRoundedRect(r, rx, ry);
+		else path.addRect(r);
+		return true;
+	}
+
+	if (tagName == "line") {
+		fillable = false;
+		path.moveTo(element.attribute("x1").toDouble(), element.attribute("y1").toDouble());
+		path.lineTo(element.attribute("x2").toDouble(), element.attribute("y2").toDouble());
+		return true;
+	}
+
+	if (tagName == "polyline" || tagName == "polygon") {
+		QStringList coords = element.attribute("points").replace(',', ' ').split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+		for (int i = 0; i + 1 < coords.count(); i += 2) {
+			QPointF p(coords.at(i).toDouble(), coords.at(i + 1).toDouble());
+			if (i == 0) path.moveTo(p);
+			else path.lineTo(p);
+		}
+		if (tagName == "polygon") path.closeSubpath();
+		return true;
+	}
+
+	if (tagName == "path") {
+		QString d = element.attribute("d").trimmed();
+		if (d.isEmpty()) return true;
+
+		OutlineData outlineData;
+		SVGPathScanner::scan(QStringView(d), [this, &outlineData](QChar command, bool relative, QList<double> & args) {
+			outlineCommandSlot(command, relative, args, &outlineData);
+		});
+		path = outlineData.path;
+		return true;
+	}
+
+	return false;
+}
+
+void CopperGeometry::outlineCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+	auto * data = (OutlineData *) userData;
+	QChar upper = command.toUpper();
+
+	if (upper == 'M' || upper == 'L') {
+		for (int i = 0; i + 1 < args.count(); i += 2) {
+			QPointF p(args.at(i), args.at(i + 1));
+			if (relative) p += data->current;
+			if (upper == 'M' && i == 0) {
+				data->path.moveTo(p);
+				data->start = p;
+			}
+			else data->path.lineTo(p);
+			data->current = p;
+		}
+	}
+	else if (upper == 'H' || upper == 'V') {
+		Q_FOREACH (double arg, args) {
+			QPointF p = data->current;
+			if (upper == 'H') p.setX(relative ? p.x() + arg : arg);
+			else p.setY(relative ? p.y() + arg : arg);
+			data->path.lineTo(p);
+			data->current = p;
+		}
+	}
+	else if (upper == 'C' || upper == 'S') {
+		int argCount = (upper == 'C') ? 6 : 4;
+		for (int i = 0; i + argCount - 1 < args.count(); i += argCount) {
+			QPointF origin = relative ? data->current : QPointF();
+			QPointF c1;
+			int ix = i;
+			if (upper == 'C') {
+				c1 = origin + QPointF(args.at(ix), args.at(ix + 1));
+				ix += 2;
+			}
+			else {
+				// reflect the previous control point
+				bool cubic = (data->previous == 'C' || data->previous == 'S');
+				c1 = cubic ? 2 * data->current - data->control : data->current;
+			}
+			QPointF c2 = origin + QPointF(args.at(ix), args.at(ix + 1));
+			QPointF p = origin + QPointF(args.at(ix + 2), args.at(ix + 3));
+			data->path.cubicTo(c1, c2, p);
+			data->control = c2;
+			data->current = p;
+			data->previous = upper;
+		}
+	}
+	else if (upper == 'Q' || upper == 'T') {
+		int argCount = (upper == 'Q') ? 4 : 2;
+		for (int i = 0; i + argCount - 1 < args.count(); i += argCount) {
+			QPointF origin = relative ? data->current : QPointF();
+			QPointF c;
+			int ix = i;
+			if (upper == 'Q') {
+				c = origin + QPointF(args.at(ix), args.at(ix + 1));
+				ix += 2;
+			}
+			else {
+				bool quad = (data->previous == 'Q' || data->previous == 'T');
+				c = quad ? 2 * data->current - data->control : data->current;
+			}
+			QPointF p = origin + QPointF(args.at(ix), args.at(ix + 1));
+			data->path.quadTo(c, p);
+			data->control = c;
+			data->current = p;
+			data->previous = upper;
+		}
+	}
+	else if (upper == 'A') {
+		for (int i = 0; i + 6 < args.count(); i += 7) {
+			QPointF p(args.at(i + 5), args.at(i + 6));
+			if (relative) p += data->current;
+			arcTo(*data, args.at(i), args.at(i + 1), args.at(i + 2), args.at(i + 3) != 0, args.at(i + 4) != 0, p);
+			data->current = p;
+		}
+	}
+	else if (upper == 'Z') {
+		data->path.closeSubpath();
+		data->current = data->start;
+	}
+
+	data->previous = upper;
+}
+
+void CopperGeometry::arcTo(OutlineData & data, double rx, double ry, double rotation, bool largeArc, bool sweep, const QPointF & to) {
+	// endpoint to center parameterization as in the svg implementation notes, then flattened to lines
+	QPointF from = data.current;
+	rx = qAbs(rx);
+	ry = qAbs(ry);
+	if (rx == 0 || ry == 0 || from == to) {
+		data.path.lineTo(to);
+		return;
+	}
+
+	double phi = qDegreesToRadians(rotation);
+	double cosPhi = qCos(phi);
+	double sinPhi = qSin(phi);
+	double dx = (from.x() - to.x()) / 2;
+	double dy = (from.y() - to.y()) / 2;
+	double x1 = cosPhi * dx + sinPhi * dy;
+	double y1 = -sinPhi * dx + cosPhi * dy;
+
+	double lambda = (x1 * x1) / (rx * rx) + (y1 * y1) / (ry * ry);
+	if (lambda > 1) {
+		// radii too small to reach: scale them up
+		rx *= qSqrt(lambda);
+		ry *= qSqrt(lambda);
+	}
+
+	double numerator = rx * rx * ry * ry - rx * rx * y1 * y1 - ry * ry * x1 * x1;
+	double denominator = rx * rx * y1 * y1 + ry * ry * x1 * x1;
+	double coefficient = qSqrt(qMax(0.0, numerator / denominator));
+	if (largeArc == sweep) coefficient = -coefficient;
+	double cx1 = coefficient * rx * y1 / ry;
+	double cy1 = -coefficient * ry * x1 / rx;
+	double cx = cosPhi * cx1 - sinPhi * cy1 + (from.x() + to.x()) / 2;
+	double cy = sinPhi * cx1 + cosPhi * cy1 + (from.y() + to.y()) / 2;
+
+	double theta1 = qAtan2((y1 - cy1) / ry, (x1 - cx1) / rx);
+	double theta2 = qAtan2((-y1 - cy1) / ry, (-x1 - cx1) / rx);
+	double delta = theta2 - theta1;
+	if (sweep && delta < 0) delta += 2 * M_PI;
+	else if (!sweep && delta > 0) delta -= 2 * M_PI;
+
+	int steps = qMax(4, qCeil(qAbs(delta) / (M_PI / 32)));
+	for (int i = 1; i < steps; i++) {
+		double t = theta1 + delta * i / steps;
+		double ex = rx * qCos(t);
+		double ey = ry * qSin(t);
+		data.path.lineTo(cosPhi * ex - sinPhi * ey + cx, sinPhi * ex + cosPhi * ey + cy);
+	}
+	data.path.lineTo(to);
+}
+
+void CopperGeometry::setNet(int shape, int net) {
+	if (shape < 0 || shape >= m_shapes.count()) return;
+
+	m_shapes[shape].net = net;
+}
+
+const QVector<CopperShape> & CopperGeometry::shapes() const {
+	return m_shapes;
+}
+
+QPainterPath CopperGeometry::area() const {
+	QPainterPath area;
+	area.setFillRule(Qt::WindingFill);
+	Q_FOREACH (CopperShape shape, m_shapes) {
+		area = area.united(shape.outline);
+	}
+	return area;
+}
+
+void CopperGeometry::buildIndex() {
+	QVector<QRectF> rects;
+	rects.reserve(m_shapes.count());
+	Q_FOREACH (CopperShape shape, m_shapes) {
+		rects.append(shape.bounds);
+	}
+	m_index.build(rects);
+}
+
+QPainterPath CopperGeometry::band(const CopperShape & shape, double keepout) const {
+	// everything within keepout of the shape's edge
+	if (keepout <= 0) return QPainterPath();
+
+	QPainterPathStroker stroker;
+	stroker.setWidth(2 * keepout);
+	stroker.setCapStyle(Qt::RoundCap);
+	stroker.setJoinStyle(Qt::RoundJoin);
+	return stroker.createStroke(shape.outline);
+}
+
+QList<CopperViolation> CopperGeometry::violations(double keepout) const {
+	// a net's shape is in violation when another net's shape, or copper on no net, overlaps it or comes within keepout of it
+	QList<CopperViolation> result;
+	QVector<int> candidates;
+	for (int i = 0; i < m_shapes.count(); i++) {
+		const CopperShape & shape = m_shapes.at(i);
+		if (shape.net < 0) continue;
+
+		m_index.intersecting(grow(shape.bounds, keepout), candidates);
+		QPainterPath shapeBand;
+		bool gotBand = false;
+		Q_FOREACH (int j, candidates) {
+			if (j == i) continue;
+
+			const CopperShape & other = m_shapes.at(j);
+			if (other.net == shape.net) continue;
+			if (other.net >= 0 && j < i) continue;             // the pair was already checked from j
+
+			if (!gotBand) {
+				shapeBand = band(shape, keepout);
+				gotBand = true;
+			}
+
+			QPainterPath overlap = shapeBand.intersected(other.outline);
+			if (overlap.isEmpty()) {
+				// one inside the other
+				overlap = shape.outline.intersected(other.outline);
+				if (overlap.isEmpty()) continue;
+			}
+
+			CopperViolation violation;
+			violation.shape1 = i;
+			violation.shape2 = j;
+			violation.at = overlap.boundingRect().center();
+			result.append(violation);
+		}
+	}
+
+	return result;
+}
+
+QList<CopperViolation> CopperGeometry::outside(const QPainterPath & area, double keepout) const {
+	// shapes which extend past area, or come within keepout of its edge
+	QList<CopperViolation> result;
+	for (int i = 0; i < m_shapes.count(); i++) {
+		const CopperShape & shape = m_shapes.at(i);
+		QPainterPath beyond;
+		if (!area.contains(shape.outline)) {
+			beyond = shape.outline.subtracted(area);
+		}
+		else {
+			QPainterPath shapeBand = band(shape, keepout);
+			if (shapeBand.isEmpty() || area.contains(shapeBand)) continue;
+
+			beyond = shapeBand.subtracted(area);
+		}
+
+		CopperViolation violation;
+		violation.shape1 = i;
+		violation.at = beyond.isEmpty() ? shape.bounds.center() : beyond.boundingRect().center();
+		result.append(violation);
+	}
+
+	return result;
+}
+
+bool CopperGeometry::allVector() const {
+	// false once addShapes has passed over something drawn that has no outline here, such as text or an image
+	return m_allVector;
+}
+
+int CopperGeometry::shapeIndex(const QDomElement & element) {
+	bool ok;
+	int index = element.attribute(ShapeAttribute).toInt(&ok);
+	return ok ? index : -1;
+}
@@ -0,0 +1,138 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef DRCGEOMETRY_H
+#define DRCGEOMETRY_H
+
+#include <QDomElement>
+#include <QList>
+#include <QObject>
+#include <QPainterPath>
+#include <QRectF>
+#include <QTransform>
+#include <QVector>
+
+#include <vector>
+
+struct CopperShape {
+	QPainterPath outline;                   // filled, in the units of the svg root (mils for a DRC master)
+	QRectF bounds;
+	int net = -1;                           // the caller's net index; -1 for copper on no net being checked
+	QString color;                          // fill color, or stroke color when only stroked; empty when not given
+};
+
+struct CopperViolation {
+	int shape1 = -1;                        // on a net, except when outside an area
+	int shape2 = -1;                        // -1 when outside an area
+	QPointF at;                             // middle of the overlap
+};
+
+class RTree
+{
+	// static R-tree over rectangles, bulk loaded with sort-tile-recursive packing
+
+public:
+	RTree() = default;
+
+	void build(const QVector<QRectF> &);
+	void intersecting(const QRectF &, QVector<int> & result) const;
+	bool isEmpty() const;
+
+protected:
+	struct Node {
+		QRectF bounds;
+		int first = 0;                      // into m_entries
+		int count = 0;
+		bool leaf = true;                   // a leaf's entries are rect indices, otherwise node indices
+	};
+
+	std::vector<int> pack(std::vector<int> & entries, bool leaf);
+	QRectF entryBounds(int entry, bool leaf) const;
+
+protected:
+	static const int MaxEntries = 16;
+
+	QVector<QRectF> m_rects;
+	std::vector<Node> m_nodes;
+	std::vector<int> m_entries;
+	int m_root = -1;
+};
+
+class CopperGeometry : public QObject
+{
+	// copper shapes extracted from an svg as filled outlines, for buffered-distance checks
+	// between nets; memory goes with the number of shapes rather than with the board area
+
+	Q_OBJECT
+
+public:
+	CopperGeometry() = default;
+
+	int addShapes(QDomElement & root);
+	void setNet(int shape, int net);
+	const QVector<CopperShape> & shapes() const;
+	QPainterPath area() const;
+	void buildIndex();
+	QList<CopperViolation> violations(double keepout) const;
+	QList<CopperViolation> outside(const QPainterPath & area, double keepout) const;
+	bool allVector() const;
+
+public:
+	static int shapeIndex(const QDomElement &);
+
+public:
+	static const QString ShapeAttribute;
+
+protected:
+	struct Style {
+		bool fill = true;
+		bool stroke = false;
+		double strokeWidth = 1;
+		Qt::PenCapStyle cap = Qt::FlatCap;
+		Qt::PenJoinStyle join = Qt::MiterJoin;
+		Qt::FillRule fillRule = Qt::WindingFill;
+		QString fillColor;
+		QString strokeColor;
+	};
+
+	struct OutlineData {
+		QPainterPath path;
+		QPointF current;
+		QPointF start;
+		QPointF control;                    // reflected by S and T
+		QChar previous;
+	};
+
+	void addShapesAux(QDomElement & element, const QTransform &, Style);
+	bool elementPath(const QDomElement &, QPainterPath &, bool & fillable);
+	QPainterPath band(const CopperShape &, double keepout) const;
+	static void inheritStyle(const QDomElement &, Style &);
+	static void arcTo(OutlineData &, double rx, double ry, double rotation, bool largeArc, bool sweep, const QPointF & to);
+
+protected Q_SLOTS:
+	void outlineCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
+
+protected:
+	QVector<CopperShape> m_shapes;
+	RTree m_index;
+	bool m_allVector = true;
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "drcpixels.h"
+
+#include <QtEndian>
+#include <qalgorithms.h>
+
+static const uchar BitTable[] = { 128, 64, 32, 16, 8, 4, 2, 1 };
+
+bool DRCPixels::pixelsCollide(const QImage * image1, const QImage * image2, QImage * image3, int x1, int y1, int x2, int y2, uint clr, QList<QPointF> & points) {
+	// mono scanlines are most significant bit first, so a big-endian word holds 64 pixels left to right;
+	// a word with no pixel black in both images is skipped whole
+	if (x2 <= x1) return false;
+
+	bool result = false;
+	const uchar * bits1 = image1->constScanLine(0);
+	const uchar * bits2 = image2->constScanLine(0);
+	int bytesPerLine = image1->bytesPerLine();
+	int firstByte = x1 >> 3;
+	int endByte = ((x2 - 1) >> 3) + 1;
+	for (int y = y1; y < y2; y++) {
+		const uchar * row1 = bits1 + y * bytesPerLine;
+		const uchar * row2 = bits2 + y * bytesPerLine;
+		for (int byteIndex = firstByte; byteIndex < endByte; byteIndex += 8) {
+			quint64 word1;
+			quint64 word2;
+			if (byteIndex + 8 <= endByte) {
+				word1 = qFromBigEndian<quint64>(row1 + byteIndex);
+				word2 = qFromBigEndian<quint64>(row2 + byteIndex);
+			}
+			else {
+				// don't read past the row; the missing pixels count as white
+				word1 = word2 = 0;
+				for (int i = 0; i < 8; i++) {
+					bool inRow = byteIndex + i < endByte;
+					word1 = (word1 << 8) | (inRow ? row1[byteIndex + i] : 0xff);
+					word2 = (word2 << 8) | (inRow ? row2[byteIndex + i] : 0xff);
+				}
+			}
+
+			quint64 hits = ~(word1 | word2);
+			if (hits == 0) continue;
+
+			int firstX = byteIndex << 3;
+			if (firstX < x1) hits &= ~quint64(0) >> (x1 - firstX);
+			if (firstX + 64 > x2) hits &= ~(~quint64(0) >> (x2 - firstX));
+
+			while (hits != 0) {
+				int bit = qCountLeadingZeroBits(hits);
+				hits ^= quint64(1) << (63 - bit);
+				image3->setPixel(firstX + bit, y, clr);
+				result = true;
+				if (points.count() < MaxPoints) {
+					points.append(QPointF(firstX + bit, y));
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+bool DRCPixels::pixelsCollideBytes(const QImage * image1, const QImage * image2, QImage * image3, int x1, int y1, int x2, int y2, uint clr, QList<QPointF> & points) {
+	bool result = false;
+	const uchar * bits1 = image1->constScanLine(0);
+	const uchar * bits2 = image2->constScanLine(0);
+	int bytesPerLine = image1->bytesPerLine();
+	for (int y = y1; y < y2; y++) {
+		int offset = y * bytesPerLine;
+		for (int x = x1; x < x2; x++) {
+			int byteOffset = (x >> 3) + offset;
+			uchar mask = BitTable[x & 7];
+
+			if ((*(bits1 + byteOffset) & mask) != 0) continue;
+			if ((*(bits2 + byteOffset) & mask) != 0) continue;
+
+			image3->setPixel(x, y, clr);
+			result = true;
+			if (points.count() < MaxPoints) {
+				points.append(QPointF(x, y));
+			}
+		}
+	}
+
+	return result;
+}
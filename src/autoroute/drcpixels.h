@@ -0,0 +1,43 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef DRCPIXELS_H
+#define DRCPIXELS_H
+
+#include <QImage>
+#include <QList>
+#include <QPointF>
+
+class DRCPixels
+{
+	// intersection of two Format_Mono images of the same size: a pixel collides where both are black
+
+public:
+	// marks each colliding pixel in [x1, x2) x [y1, y2) with clr in image3 and keeps the first 1000 in points
+	static bool pixelsCollide(const QImage * image1, const QImage * image2, QImage * image3, int x1, int y1, int x2, int y2, uint clr, QList<QPointF> & points);
+
+	// the same, a pixel at a time; for comparison
+	static bool pixelsCollideBytes(const QImage * image1, const QImage * image2, QImage * image3, int x1, int y1, int x2, int y2, uint clr, QList<QPointF> & points);
+
+public:
+	static const int MaxPoints = 1000;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "livedrc.h"
+#include "drc.h"
+#include "../sketch/pcbsketchwidget.h"
+#include "../items/itembase.h"
+#include "../utils/graphicsutils.h"
+#include "../waitpushundostack.h"
+
+#include <QPixmap>
+#include <QSet>
+#include <qmath.h>
+
+const int LiveDRC::CheckDelayMs = 500;
+
+LiveDRC::LiveDRC(PCBSketchWidget * sketchWidget, QObject * parent) : QObject(parent),
+	m_sketchWidget(sketchWidget)
+{
+	m_timer.setSingleShot(true);
+	m_timer.setInterval(CheckDelayMs);
+	connect(&m_timer, SIGNAL(timeout()), this, SLOT(checkSlot()));
+	connect(sketchWidget->undoStack(), SIGNAL(indexChanged(int)), this, SLOT(changedSlot()));
+}
+
+LiveDRC::~LiveDRC()
+{
+	// the displays went with the scene if the sketch is already gone
+	if (m_sketchWidget != nullptr) clear();
+}
+
+void LiveDRC::setEnabled(bool enabled) {
+	if (enabled == m_enabled) return;
+
+	m_enabled = enabled;
+	m_timer.stop();
+	clear();
+	if (enabled) {
+		// the first check covers every board
+		checkSlot();
+	}
+}
+
+bool LiveDRC::isEnabled() const {
+	return m_enabled;
+}
+
+void LiveDRC::changedSlot() {
+	// wait for a pause in a burst of edits
+	if (m_enabled) m_timer.start();
+}
+
+void LiveDRC::checkSlot() {
+	if (!m_enabled || m_sketchWidget == nullptr) return;
+
+	// the changed region is wherever copper was added, removed or moved since the last check
+	QHash<QGraphicsItem *, QRectF> copper = copperRects();
+	QRectF changed;
+	for (auto it = copper.constBegin(); it != copper.constEnd(); ++it) {
+		auto old = m_copperRects.constFind(it.key());
+		if (old == m_copperRects.constEnd()) changed |= it.value();
+		else if (old.value() != it.value()) changed |= it.value() | old.value();
+	}
+	for (auto it = m_copperRects.constBegin(); it != m_copperRects.constEnd(); ++it) {
+		if (!copper.contains(it.key())) changed |= it.value();
+	}
+	m_copperRects = copper;
+
+	double keepoutMils = m_sketchWidget->getKeepout() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI;     // pixels to mils
+	double dpi = DRC::rasterDPI(keepoutMils);
+	QList<ItemBase *> boards = m_sketchWidget->findBoard();
+	QSet<long> boardIDs;
+	Q_FOREACH (ItemBase * board, boards) {
+		boardIDs << board->id();
+	}
+	Q_FOREACH (long id, m_displays.keys()) {
+		if (!boardIDs.contains(id)) removeDisplay(m_displays.take(id));
+	}
+
+	Q_FOREACH (ItemBase * board, boards) {
+		QRectF boardRect = board->sceneBoundingRect();
+		QRectF region = changed;
+		BoardDisplay * display = m_displays.value(board->id(), nullptr);
+		if (display == nullptr || display->boardRect != boardRect || display->dpi != dpi) {
+			// a new, moved or resized board, or a new keepout: check all of it
+			removeDisplay(display);
+			display = new BoardDisplay;
+			display->boardRect = boardRect;
+			display->dpi = dpi;
+			display->image = QImage(qCeil(boardRect.width() * dpi / GraphicsUtils::SVGDPI), qCeil(boardRect.height() * dpi / GraphicsUtils::SVGDPI), QImage::Format_Indexed8);
+			display->image.setColor(0, 0);
+			display->image.setColor(1, 0x80ff0000);
+			display->image.fill(0);
+			m_displays.insert(board->id(), display);
+			region = boardRect;
+		}
+		if (!region.intersects(boardRect)) continue;
+
+		DRC drc(m_sketchWidget, board);
+		drc.checkRegion(region, keepoutMils, dpi, &display->image);
+
+		QPixmap pixmap = QPixmap::fromImage(display->image);
+		if (display->item == nullptr) {
+			display->item = new QGraphicsPixmapItem(pixmap);
+			display->item->setPos(boardRect.topLeft());
+			display->item->setZValue(5000);
+			display->item->setScale(boardRect.width() / display->image.width());
+			display->item->setAcceptedMouseButtons(Qt::NoButton);
+			display->item->setAcceptHoverEvents(false);
+			m_sketchWidget->scene()->addItem(display->item);
+		}
+		else {
+			display->item->setPixmap(pixmap);
+		}
+	}
+}
+
+QHash<QGraphicsItem *, QRectF> LiveDRC::copperRects() const {
+	QHash<QGraphicsItem *, QRectF> rects;
+	LayerList copperLayers = ViewLayer::copperLayers(ViewLayer::NewBottom) + ViewLayer::copperLayers(ViewLayer::NewTop);
+	Q_FOREACH (QGraphicsItem * item, m_sketchWidget->scene()->items()) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr) continue;
+		if (!copperLayers.contains(itemBase->viewLayerID())) continue;
+
+		rects.insert(item, item->sceneBoundingRect());
+	}
+	return rects;
+}
+
+void LiveDRC::clear() {
+	Q_FOREACH (BoardDisplay * display, m_displays) {
+		removeDisplay(display);
+	}
+	m_displays.clear();
+	m_copperRects.clear();
+}
+
+void LiveDRC::removeDisplay(BoardDisplay * display) {
+	if (display == nullptr) return;
+
+	delete display->item;
+	delete display;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef LIVEDRC_H
+#define LIVEDRC_H
+
+#include <QGraphicsPixmapItem>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPointer>
+#include <QRectF>
+#include <QTimer>
+
+class LiveDRC : public QObject
+{
+	// checks the board in the background after each edit, only around the copper the edit changed,
+	// and highlights overlaps on top of each board
+
+	Q_OBJECT
+
+public:
+	LiveDRC(class PCBSketchWidget *, QObject * parent);
+	~LiveDRC();
+
+	void setEnabled(bool);
+	bool isEnabled() const;
+
+protected Q_SLOTS:
+	void changedSlot();
+	void checkSlot();
+
+protected:
+	struct BoardDisplay {
+		QRectF boardRect;
+		double dpi = 0;
+		QImage image;
+		QGraphicsPixmapItem * item = nullptr;
+	};
+
+	QHash<QGraphicsItem *, QRectF> copperRects() const;
+	void clear();
+	void removeDisplay(BoardDisplay *);
+
+protected:
+	static const int CheckDelayMs;
+
+	QPointer<class PCBSketchWidget> m_sketchWidget;
+	QTimer m_timer;
+	bool m_enabled = false;
+	QHash<QGraphicsItem *, QRectF> m_copperRects;   // as of the last check
+	QHash<long, BoardDisplay *> m_displays;         // by board id
+};
+
+#endif
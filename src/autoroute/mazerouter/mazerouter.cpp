@@ -69,14 +69,25 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../../svg/svgfilesplitter.h"
 #include "../../fsvgrenderer.h"
 #include "../drc.h"
+#include "../boardmaskcache.h"
 #include "../../connectors/svgidlayer.h"
+#include "../../testing/FTimingProbe.h"
+#include "../../utils/tracer.h"
+#include "../../utils/settingscache.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QtEndian>
 #include <QMessageBox>
-#include <QSettings>
+#include <QThread>
+#include <QtConcurrentRun>
 
 #include <qmath.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <limits>
+#include <new>
 
 //////////////////////////////////////
 
@@ -101,6 +112,17 @@ static constexpr uint CrossLayerCost = 100;
 static constexpr uint ViaCost = 2000;
 static constexpr uint AvoidCost = 7;
 
+static constexpr int CoarseGridFactor = 8;              // grid points per coarse cell side
+static constexpr int CoarseMinimumCells = 64;
+static constexpr int CorridorMargin = 1;                // coarse cells on either side of the global path
+static constexpr double CoarseCongestionCost = 4;       // extra step cost of a fully blocked coarse cell
+
+static constexpr int WorkerPollMs = 20;                 // how often a busy worker passes on the stop buttons
+
+static constexpr uint NegotiatedPresentCost = 8;        // first-round step cost of a cell another net's trace uses
+static constexpr int NegotiatedPresentGrowth = 10;      // that cost doubles each round, at most this many times
+static constexpr uint NegotiatedHistoryCost = 16;       // added to a cell for each round it is still shared
+
 static constexpr uchar GridPointDone = 1;
 static constexpr uchar GridPointStepYPlus = 2;
 static constexpr uchar GridPointStepYMinus = 4;
@@ -224,6 +246,28 @@ bool byOrder(Trace & t1, Trace & t2) {
 	return (t1.order < t2.order);
 }
 
+bool betterScore(const Score & candidate, const Score & best) {
+	if (best.ordering.order.count() == 0) return true;
+	if (candidate.totalRoutedCount > best.totalRoutedCount) return true;
+
+	return candidate.totalRoutedCount == best.totalRoutedCount && candidate.totalViaCount < best.totalViaCount;
+}
+
+bool containsOrdering(const QList<NetOrdering> & allOrderings, const QList<int> & order) {
+	Q_FOREACH (NetOrdering ordering, allOrderings) {
+		bool gotOne = true;
+		for (int j = 0; j < order.count(); j++) {
+			if (order.at(j) != ordering.order.at(j)) {
+				gotOne = false;
+				break;
+			}
+		}
+		if (gotOne) return true;
+	}
+
+	return false;
+}
+
 /*
 inline double initialCost(QPoint p1, QPoint p2) {
     //return qAbs(p1.x() - p2.x()) + qAbs(p1.y() - p2.y());
@@ -243,6 +287,16 @@ inline int gridPointInt(Grid * grid, GridPoint & gp) {
 	return (gp.z * grid->x * grid->y) + (gp.y * grid->x) + gp.x;
 }
 
+inline bool visitCell(std::vector<quint64> & visited, int cell) {
+	// false if the cell was already visited
+	quint64 & word = visited[cell >> 6];
+	quint64 bit = quint64(1) << (cell & 63);
+	if (word & bit) return false;
+
+	word |= bit;
+	return true;
+}
+
 bool jumperWillFit(GridPoint & gridPoint, const Grid * grid, int halfSize) {
 	for (int z = 0; z < grid->z; z++) {
 		for (int y = -halfSize; y <= halfSize; y++) {
@@ -318,22 +372,104 @@ bool GridPoint::operator<(const GridPoint& other) const {
 }
 ////////////////////////////////////////////////////////////////////
 
-Grid::Grid(int sx, int sy, int sz) : 
-	data(new GridValue[sx * sy * sz]()), // initialize to zero
-	x(sx), y(sy), z(sz) { }
+static constexpr int GridTileShift = 6;               // cost tiles are 64 x 64 cells
+static constexpr int GridTileSize = 1 << GridTileShift;
+static constexpr int GridTileMask = GridTileSize - 1;
+static constexpr int GridTileCells = GridTileSize * GridTileSize;
+static constexpr GridCost CostMax = std::numeric_limits<GridCost>::max();
+static constexpr GridCost CostSourceFlag = (CostMax / 2) + 1;
+static constexpr GridCost CostSentinels = CostMax - (GridCost) (GridBoardObstacle - GridTempObstacle);   // GridTempObstacle through GridBoardObstacle
+static constexpr GridCost CostLimit = (CostSentinels & ~CostSourceFlag) - 1;
+
+inline GridCost encodeCost(GridValue value) {
+	if (value >= GridTempObstacle) {
+		return CostMax - (GridCost) (GridBoardObstacle - value);
+	}
+
+	GridCost flag = (value & GridSourceFlag) ? CostSourceFlag : 0;
+	GridValue cost = value & ~GridSourceFlag;
+	Q_ASSERT(cost <= CostLimit);
+	return flag | (GridCost) qMin(cost, (GridValue) CostLimit);
+}
+
+inline GridValue decodeCost(GridCost cost) {
+	if (cost >= CostSentinels) return GridBoardObstacle - (CostMax - cost);
+	if (cost & CostSourceFlag) return GridSourceFlag | (cost & ~CostSourceFlag);
+	return cost;
+}
+
+Grid::Grid(int sx, int sy, int sz) :
+	x(sx), y(sy), z(sz)
+{
+	m_wordsPerLayer = ((sx * sy) + 63) / 64;
+	m_tilesX = (sx + GridTileMask) >> GridTileShift;
+	m_tilesY = (sy + GridTileMask) >> GridTileShift;
+	m_boardObstacles.resize(m_wordsPerLayer * sz, 0);
+	m_partObstacles.resize(m_wordsPerLayer * sz, 0);
+	m_tiles.resize(m_tilesX * m_tilesY * sz);
+}
+
+GridCost * Grid::tile(int sx, int sy, int sz) const {
+	return m_tiles[(((sz * m_tilesY) + (sy >> GridTileShift)) * m_tilesX) + (sx >> GridTileShift)].get();
+}
+
+GridCost * Grid::makeTile(int sx, int sy, int sz) {
+	auto & t = m_tiles[(((sz * m_tilesY) + (sy >> GridTileShift)) * m_tilesX) + (sx >> GridTileShift)];
+	t.reset(new GridCost[GridTileCells]());
+	return t.get();
+}
 
 GridValue Grid::at(int sx, int sy, int sz) const {
     Q_ASSERT (sx < x);
     Q_ASSERT (sy < y);
     Q_ASSERT (sz < z);
-	return *(data + (sz * y * x) + (sy * x) + sx);
+	int cell = (sy * x) + sx;
+	int word = (sz * m_wordsPerLayer) + (cell >> 6);
+	quint64 bit = quint64(1) << (cell & 63);
+	if (m_boardObstacles[word] & bit) return GridBoardObstacle;
+	if (m_partObstacles[word] & bit) return GridPartObstacle;
+
+	const GridCost * t = tile(sx, sy, sz);
+	if (t == nullptr) return 0;
+
+	return decodeCost(t[((sy & GridTileMask) << GridTileShift) + (sx & GridTileMask)]);
+}
+
+bool Grid::isObstacle(int sx, int sy, int sz) const {
+	int cell = (sy * x) + sx;
+	int word = (sz * m_wordsPerLayer) + (cell >> 6);
+	return ((m_boardObstacles[word] | m_partObstacles[word]) >> (cell & 63)) & 1;
 }
 
 void Grid::setAt(int sx, int sy, int sz, GridValue value) {
     Q_ASSERT (sx < x);
     Q_ASSERT (sy < y);
     Q_ASSERT (sz < z);
-	*(data + (sz * y * x) + (sy * x) + sx) = value;
+	int cell = (sy * x) + sx;
+	int word = (sz * m_wordsPerLayer) + (cell >> 6);
+	quint64 bit = quint64(1) << (cell & 63);
+	if (value == GridBoardObstacle) {
+		m_boardObstacles[word] |= bit;
+		m_partObstacles[word] &= ~bit;
+	}
+	else if (value == GridPartObstacle) {
+		m_boardObstacles[word] &= ~bit;
+		m_partObstacles[word] |= bit;
+	}
+	else {
+		m_boardObstacles[word] &= ~bit;
+		m_partObstacles[word] &= ~bit;
+	}
+
+	GridCost * t = tile(sx, sy, sz);
+	if (value == 0 || value == GridBoardObstacle || value == GridPartObstacle) {
+		// nothing to store in the cost plane
+		if (t) t[((sy & GridTileMask) << GridTileShift) + (sx & GridTileMask)] = 0;
+		return;
+	}
+
+	if (t == nullptr) t = makeTile(sx, sy, sz);
+	t[((sy & GridTileMask) << GridTileShift) + (sx & GridTileMask)] = encodeCost(value);
 }
 
 QList<QPoint> Grid::init(int sx, int sy, int sz, int width, int height, const QImage & image, GridValue value, bool collectPoints) {
@@ -369,48 +505,289 @@ QList<QPoint> Grid::init(int sx, int sy, int sz, int width, int height, const QI
 
 
 QList<QPoint> Grid::init4(int sx, int sy, int sz, int width, int height, const QImage * image, GridValue value, bool collectPoints) {
-	// pixels are 4 x 4 bits
+	// pixels are 4 x 4 bits: a grid point is marked unless its 4 x 4 block is all white.
+	// The four scanlines are ANDed 64 bits (16 grid points) at a time so white runs are skipped a word at a time,
+	// and obstacles are ORed into the bitplanes a word at a time
 	QList<QPoint> points;
 	const uchar * bits1 = image->constScanLine(0);
 	int bytesPerLine = image->bytesPerLine();
+	bool obstacle = !collectPoints && (value == GridBoardObstacle || value == GridPartObstacle);
+	std::vector<quint64> & plane = (value == GridBoardObstacle) ? m_boardObstacles : m_partObstacles;
+	std::vector<quint64> & otherPlane = (value == GridBoardObstacle) ? m_partObstacles : m_boardObstacles;
+	int firstByte = sx >> 1;
+	int lastByte = qMin((sx + width + 1) >> 1, bytesPerLine);
 	for (int iy = sy; iy < sy + height; iy++) {
-		int offset = iy * bytesPerLine * 4;
-		for (int ix = sx; ix < sx + width; ix++) {
-			int byteOffset = (ix >> 1) + offset;
-			uchar mask = ix & 1 ? 0x0f : 0xf0;
+		const uchar * line = bits1 + (iy * bytesPerLine * 4);
+		bool costs = obstacle && hasCosts(iy, sz);
+		int rowCell = (sz * m_wordsPerLayer * 64) + (iy * x);
+		int pendingWord = -1;
+		quint64 pendingMask = 0;
+		for (int byte = firstByte; byte < lastByte; byte += 8) {
+			int count = qMin(8, lastByte - byte);
+			quint64 w = ~quint64(0);
+			if (count == 8) {
+				quint64 w0, w1, w2, w3;
+				memcpy(&w0, line + byte, 8);
+				memcpy(&w1, line + byte + bytesPerLine, 8);
+				memcpy(&w2, line + byte + bytesPerLine + bytesPerLine, 8);
+				memcpy(&w3, line + byte + bytesPerLine + bytesPerLine + bytesPerLine, 8);
+				w = qFromBigEndian(w0 & w1 & w2 & w3);
+			}
+			else {
+				for (int b = 0; b < count; b++) {
+					quint64 c = line[byte + b] & line[byte + b + bytesPerLine] & line[byte + b + bytesPerLine + bytesPerLine] & line[byte + b + bytesPerLine + bytesPerLine + bytesPerLine];
+					w &= ~(quint64(0xff & ~c) << (56 - (8 * b)));
+				}
+			}
+			if (w == ~quint64(0)) continue;             // 16 white grid points
 
-			if ((*(bits1 + byteOffset) & mask) != mask) ;
-			else if ((*(bits1 + byteOffset + bytesPerLine) & mask) != mask) ;
-			else if ((*(bits1 + byteOffset + bytesPerLine + bytesPerLine) & mask) != mask) ;
-			else if ((*(bits1 + byteOffset + bytesPerLine + bytesPerLine + bytesPerLine) & mask) != mask) ;
-			else continue;  // "pixel" is all white
+			// the top bit of nibble j survives iff the whole nibble is white
+			quint64 white = w & (w << 1);
+			white &= white << 2;
+			for (int j = 0; j < 16; j++) {
+				if (white & (quint64(1) << (63 - (4 * j)))) continue;
 
-			setAt(ix, iy, sz, value);
-			if (collectPoints) {
-				points.append(QPoint(ix, iy));
+				int ix = (byte * 2) + j;
+				if (ix < sx || ix >= sx + width) continue;
+
+				if (!obstacle) {
+					setAt(ix, iy, sz, value);
+					if (collectPoints) {
+						points.append(QPoint(ix, iy));
+					}
+					continue;
+				}
+
+				int cell = rowCell + ix;
+				if ((cell >> 6) != pendingWord) {
+					if (pendingWord >= 0) {
+						plane[pendingWord] |= pendingMask;
+						otherPlane[pendingWord] &= ~pendingMask;
+					}
+					pendingWord = cell >> 6;
+					pendingMask = 0;
+				}
+				pendingMask |= quint64(1) << (cell & 63);
+				if (costs) {
+					GridCost * t = tile(ix, iy, sz);
+					if (t) t[((iy & GridTileMask) << GridTileShift) + (ix & GridTileMask)] = 0;
+				}
 			}
 		}
+		if (pendingWord >= 0) {
+			plane[pendingWord] |= pendingMask;
+			otherPlane[pendingWord] &= ~pendingMask;
+		}
 	}
 
 	return points;
 }
 
+bool Grid::hasCosts(int sy, int sz) const {
+	// is any cost tile allocated in the band of tiles holding row sy?
+	int first = ((sz * m_tilesY) + (sy >> GridTileShift)) * m_tilesX;
+	for (int i = first; i < first + m_tilesX; i++) {
+		if (m_tiles[i]) return true;
+	}
+
+	return false;
+}
+
 void Grid::copy(int fromIndex, int toIndex) {
-	memcpy(((uchar *) data) + toIndex * x * y * sizeof(GridValue), ((uchar *) data) + fromIndex * x * y * sizeof(GridValue), x * y * sizeof(GridValue));
+	std::copy_n(m_boardObstacles.begin() + (fromIndex * m_wordsPerLayer), m_wordsPerLayer, m_boardObstacles.begin() + (toIndex * m_wordsPerLayer));
+	std::copy_n(m_partObstacles.begin() + (fromIndex * m_wordsPerLayer), m_wordsPerLayer, m_partObstacles.begin() + (toIndex * m_wordsPerLayer));
+
+	int tilesPerLayer = m_tilesX * m_tilesY;
+	for (int i = 0; i < tilesPerLayer; i++) {
+		const auto & from = m_tiles[(fromIndex * tilesPerLayer) + i];
+		auto & to = m_tiles[(toIndex * tilesPerLayer) + i];
+		if (!from) {
+			if (to) std::fill_n(to.get(), GridTileCells, 0);
+			continue;
+		}
+
+		if (!to) to.reset(new GridCost[GridTileCells]);
+		std::copy_n(from.get(), GridTileCells, to.get());
+	}
 }
 
 void Grid::clear() {
-	// memset can be very dangerous, clear out memory this way
-	std::fill_n(data, x * y * z, 0);
+	std::fill(m_boardObstacles.begin(), m_boardObstacles.end(), 0);
+	std::fill(m_partObstacles.begin(), m_partObstacles.end(), 0);
+	clearCosts();
+}
+
+void Grid::clearCosts() {
+	// tiles stay allocated: the next net will most likely touch them again
+	for (auto & t : m_tiles) {
+		if (t) std::fill_n(t.get(), GridTileCells, 0);
+	}
+}
+
+qint64 Grid::allocatedBytes() const {
+	qint64 bytes = (m_boardObstacles.size() + m_partObstacles.size()) * sizeof(quint64);
+	for (const auto & t : m_tiles) {
+		if (t) bytes += GridTileCells * sizeof(GridCost);
+	}
+	return bytes;
 }
 
 Grid::~Grid() {
-	if (data) {
-		delete [] data;
-		data = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////
+
+static constexpr int BucketWindow = 1 << 14;
+
+void GridQueue::setStrategy(Strategy strategy, int gridX, int gridY) {
+	clear();
+	m_strategy = strategy;
+	m_gridX = gridX;
+	m_gridY = gridY;
+	if (m_strategy == BucketStrategy && m_buckets.empty()) {
+		m_buckets.resize(BucketWindow);
 	}
 }
 
+void GridQueue::push(const GridPoint & gridPoint) {
+	if (m_strategy == HeapStrategy) {
+		m_heap.push(gridPoint);
+		return;
+	}
+
+	// qCost is always integral: baseCost plus a squared-distance or manhattan estimate
+	auto priority = (quint64) qMax(0.0, gridPoint.qCost);
+	Q_ASSERT(gridPoint.baseCost <= CostLimit);
+	Entry entry;
+	entry.cell = (quint32) ((((gridPoint.z * m_gridY) + gridPoint.y) * m_gridX) + gridPoint.x);
+	entry.baseCost = (GridCost) gridPoint.baseCost;
+	entry.flags = gridPoint.flags;
+
+	if (m_count++ == 0) {
+		m_base = priority;
+		m_cursor = 0;
+	}
+
+	if (priority < m_base || priority >= m_base + BucketWindow) {
+		Outside outside;
+		outside.priority = priority;
+		outside.entry = entry;
+		m_outside.push(outside);
+		return;
+	}
+
+	int index = (int) (priority - m_base);
+	m_buckets[index].push_back(entry);
+	if (index < m_cursor) m_cursor = index;
+}
+
+GridPoint GridQueue::top() {
+	if (m_strategy == HeapStrategy) return m_heap.top();
+
+	locateTop();
+	if (m_topOutside) return toGridPoint(m_outside.top().entry, m_outside.top().priority);
+
+	return toGridPoint(m_buckets[m_cursor].back(), m_base + m_cursor);
+}
+
+void GridQueue::pop() {
+	if (m_strategy == HeapStrategy) {
+		m_heap.pop();
+		return;
+	}
+
+	locateTop();
+	if (m_topOutside) m_outside.pop();
+	else m_buckets[m_cursor].pop_back();
+	m_count--;
+}
+
+bool GridQueue::empty() const {
+	if (m_strategy == HeapStrategy) return m_heap.empty();
+
+	return m_count == 0;
+}
+
+size_t GridQueue::size() const {
+	if (m_strategy == HeapStrategy) return m_heap.size();
+
+	return m_count;
+}
+
+void GridQueue::clear() {
+	m_heap = std::priority_queue<GridPoint>();
+	m_outside = std::priority_queue<Outside>();
+	for (auto & bucket : m_buckets) {
+		bucket.clear();         // keeps the capacity for the next route
+	}
+	m_count = 0;
+	m_cursor = 0;
+	m_topOutside = false;
+}
+
+void GridQueue::locateTop() {
+	while (m_cursor < BucketWindow && m_buckets[m_cursor].empty()) m_cursor++;
+	if (m_cursor == BucketWindow) {
+		rebase();
+	}
+
+	m_topOutside = !m_outside.empty() && m_outside.top().priority < m_base + m_cursor;
+}
+
+void GridQueue::rebase() {
+	// the window is empty: slide it to the cheapest entry left outside
+	m_base = m_outside.top().priority;
+	m_cursor = 0;
+	while (!m_outside.empty() && m_outside.top().priority < m_base + BucketWindow) {
+		m_buckets[m_outside.top().priority - m_base].push_back(m_outside.top().entry);
+		m_outside.pop();
+	}
+}
+
+GridPoint GridQueue::toGridPoint(const Entry & entry, quint64 priority) const {
+	GridPoint gridPoint;
+	int layerSize = m_gridX * m_gridY;
+	gridPoint.z = entry.cell / layerSize;
+	int cell = entry.cell % layerSize;
+	gridPoint.y = cell / m_gridX;
+	gridPoint.x = cell % m_gridX;
+	gridPoint.baseCost = entry.baseCost;
+	gridPoint.qCost = priority;
+	gridPoint.flags = entry.flags;
+	return gridPoint;
+}
+
+////////////////////////////////////////////////////////////////////
+
+void RouterMetrics::add(const RouterMetrics & other) {
+	makeMastersNs += other.makeMastersNs;
+	routeNs += other.routeNs;
+	traceBackNs += other.traceBackNs;
+	optimizeTracesNs += other.optimizeTracesNs;
+	createTracesNs += other.createTracesNs;
+	expansions += other.expansions;
+	queueHighWater = qMax(queueHighWater, other.queueHighWater);
+	traceBackPoints += other.traceBackPoints;
+	roundNs.append(other.roundNs);
+}
+
+double RouterMetrics::cellsPerSecond() const {
+	if (routeNs <= 0) return 0;
+
+	return expansions * 1.0e9 / routeNs;
+}
+
+QString RouterMetrics::summary() const {
+	qint64 allRoundsNs = 0;
+	Q_FOREACH (qint64 ns, roundNs) allRoundsNs += ns;
+	double msPerRound = roundNs.isEmpty() ? 0 : allRoundsNs / 1.0e6 / roundNs.count();
+	return QObject::tr("%1 cells/s, queue peak %2, %3 traceBack points, %4 ms per round")
+		.arg(cellsPerSecond(), 0, 'f', 0)
+		.arg(queueHighWater)
+		.arg(traceBackPoints)
+		.arg(msPerRound, 0, 'f', 0);
+}
+
 ////////////////////////////////////////////////////////////////////
 
 
@@ -489,6 +866,13 @@ QList<ConnectorItem *> ConnectionThing::values(ConnectorItem * s) {
 
 ////////////////////////////////////////////////////////////////////
 
+const QString MazeRouter::ParallelOrderingsName("cmrouter/parallelorderings");
+const QString MazeRouter::QueueStrategyName("cmrouter/queuestrategy");
+const QString MazeRouter::CoarseRoutingName("cmrouter/coarserouting");
+const QString MazeRouter::OptimizeThreadsName("cmrouter/optimizethreads");
+const QString MazeRouter::NegotiatedRoutingName("cmrouter/negotiated");
+const QString MazeRouter::JumperRadiusName("cmrouter/jumperradius");
+
 MazeRouter::MazeRouter(PCBSketchWidget * sketchWidget, QGraphicsItem * board, bool adjustIf) : 
     Autorouter(sketchWidget),
     m_keepoutMils(0.0),
@@ -500,20 +884,39 @@ MazeRouter::MazeRouter(PCBSketchWidget * sketchWidget, QGraphicsItem * board, bo
     m_standardWireWidth(0.0),
     m_boardImage(nullptr),
     m_spareImage(nullptr),
-    m_spareImage2(nullptr),
     m_temporaryBoard(false),
     m_costFunction(nullptr),
     m_jumperWillFitFunction(nullptr),
     m_grid(nullptr),
     m_cleanupCount(0),
     m_netLabelIndex(-1),
-    m_commandCount(0)
+    m_commandCount(0),
+    m_parallelOrderings(1),
+    m_worker(false),
+    m_queueStrategy(GridQueue::HeapStrategy),
+    m_coarseRouting(false),
+    m_optimizeThreads(1),
+    m_negotiatedRouting(false),
+    m_negotiating(false),
+    m_presentCost(0),
+    m_jumperRadius(0)
 {
 
 	CancelledMessage = tr("Autorouter was cancelled.");
 
-	QSettings settings;
-	m_maxCycles = settings.value(MaxCyclesName, DefaultMaxCycles).toInt();
+	m_maxCycles = SettingsCache::intValue(MaxCyclesName, DefaultMaxCycles);
+	// number of net orderings routed at once on worker threads; 1 keeps the serial search
+	m_parallelOrderings = qBound(1, SettingsCache::intValue(ParallelOrderingsName, 1), qMax(1, QThread::idealThreadCount()));
+	// "heap" (default) or "bucket"
+	if (SettingsCache::stringValue(QueueStrategyName).compare("bucket", Qt::CaseInsensitive) == 0) {
+		m_queueStrategy = GridQueue::BucketStrategy;
+	}
+	m_coarseRouting = SettingsCache::boolValue(CoarseRoutingName, false);
+	// threads searching for trace shortcuts once routing is done; the traces are the same for any count
+	m_optimizeThreads = qBound(1, SettingsCache::intValue(OptimizeThreadsName, QThread::idealThreadCount()), qMax(1, QThread::idealThreadCount()));
+	// pcb only: route all nets with shared cells priced instead of searching net orderings
+	m_negotiatedRouting = SettingsCache::boolValue(NegotiatedRoutingName, false);
+	m_jumperRadius = qMax(0, SettingsCache::intValue(JumperRadiusName, 0));
 
 	m_bothSidesNow = sketchWidget->routeBothSides();
 	m_pcbType = sketchWidget->autorouteTypePCB();
@@ -563,10 +966,87 @@ MazeRouter::MazeRouter(PCBSketchWidget * sketchWidget, QGraphicsItem * board, bo
 	}
 }
 
+MazeRouter::MazeRouter(const MazeRouter * prototype) :
+    Autorouter(prototype->m_sketchWidget),
+    m_viewLayerIDs(prototype->m_viewLayerIDs),
+    m_keepoutMils(prototype->m_keepoutMils),
+    m_keepoutGrid(prototype->m_keepoutGrid),
+    m_keepoutGridInt(prototype->m_keepoutGridInt),
+    m_halfGridViaSize(prototype->m_halfGridViaSize),
+    m_halfGridJumperSize(prototype->m_halfGridJumperSize),
+    m_gridPixels(prototype->m_gridPixels),
+    m_standardWireWidth(prototype->m_standardWireWidth),
+    m_boardImage(prototype->m_boardImage),          // shared and only read by Grid::init4
+    m_spareImage(new QImage(prototype->m_spareImage->size(), QImage::Format_Mono)),
+    m_temporaryBoard(false),
+    m_costFunction(prototype->m_costFunction),
+    m_jumperWillFitFunction(prototype->m_jumperWillFitFunction),
+    m_grid(new Grid(prototype->m_grid->x, prototype->m_grid->y, prototype->m_grid->z)),
+    m_cleanupCount(0),
+    m_netLabelIndex(-1),
+    m_commandCount(0),
+    m_parallelOrderings(prototype->m_parallelOrderings),
+    m_worker(true),
+    m_queueStrategy(prototype->m_queueStrategy),
+    m_coarseRouting(prototype->m_coarseRouting),
+    m_optimizeThreads(prototype->m_optimizeThreads),
+    m_negotiatedRouting(prototype->m_negotiatedRouting),
+    m_negotiating(false),
+    m_presentCost(0),
+    m_jumperRadius(prototype->m_jumperRadius),
+    m_obstacleCache(prototype->m_obstacleCache)
+{
+	// a worker has no display and never touches the scene: it only routes one ordering
+	// against its own grid and its own copy of the master documents
+	m_bothSidesNow = prototype->m_bothSidesNow;
+	m_pcbType = prototype->m_pcbType;
+	m_board = prototype->m_board;
+	m_maxRect = prototype->m_maxRect;
+	m_keepoutPixels = prototype->m_keepoutPixels;
+	m_maxCycles = prototype->m_maxCycles.load();
+	m_traceColors[0] = prototype->m_traceColors[0];
+	m_traceColors[1] = prototype->m_traceColors[1];
+
+	for (auto it = prototype->m_masterDocs.constBegin(); it != prototype->m_masterDocs.constEnd(); ++it) {
+		m_masterDocs.insert(it.key(), new QDomDocument(it.value()->cloneNode(true).toDocument()));
+	}
+}
+
+void MazeRouter::overrideSettings(const QHash<QString, QVariant> & settings) {
+	// same keys as QSettings, for running without touching the user's preferences
+	if (settings.contains(MaxCyclesName)) m_maxCycles = qMax(1, settings.value(MaxCyclesName).toInt());
+	if (settings.contains(ParallelOrderingsName)) {
+		m_parallelOrderings = qBound(1, settings.value(ParallelOrderingsName).toInt(), qMax(1, QThread::idealThreadCount()));
+	}
+	if (settings.contains(QueueStrategyName)) {
+		m_queueStrategy = (settings.value(QueueStrategyName).toString().compare("bucket", Qt::CaseInsensitive) == 0) ? GridQueue::BucketStrategy : GridQueue::HeapStrategy;
+	}
+	if (settings.contains(CoarseRoutingName)) m_coarseRouting = settings.value(CoarseRoutingName).toBool();
+	if (settings.contains(OptimizeThreadsName)) {
+		m_optimizeThreads = qBound(1, settings.value(OptimizeThreadsName).toInt(), qMax(1, QThread::idealThreadCount()));
+	}
+	if (settings.contains(NegotiatedRoutingName)) m_negotiatedRouting = settings.value(NegotiatedRoutingName).toBool();
+	if (settings.contains(JumperRadiusName)) m_jumperRadius = qMax(0, settings.value(JumperRadiusName).toInt());
+}
+
+const RouterMetrics & MazeRouter::metrics() const {
+	return m_metrics;
+}
+
 MazeRouter::~MazeRouter()
 {
     /// @todo replace explicit deletes with std::shared_ptr and std::unique_ptr
     /// where it makes sense. 
+	if (m_worker) {
+		// the board image belongs to the prototype
+		m_boardImage = nullptr;
+	}
+	if (m_searcher) {
+		// beginRouting without finishRouting
+		m_searcher->m_cancelled = true;
+		m_search.waitForFinished();
+		delete m_searcher;
+	}
 	Q_FOREACH (QDomDocument * doc, m_masterDocs) {
 		delete doc;
 	}
@@ -594,17 +1074,25 @@ MazeRouter::~MazeRouter()
 	if (m_spareImage) {
 		delete m_spareImage;
 	}
-	if (m_spareImage2) {
-		delete m_spareImage2;
-	}
 }
 
 void MazeRouter::start()
 {
+	if (!beginRouting()) return;
+
+	while (!searchFinished()) {
+		ProcessEventBlocker::processEvents(200);
+	}
+	finishRouting();
+}
+
+bool MazeRouter::beginRouting()
+{
+	// everything up to launching the search worker; returns false if there is nothing to finish
 	if (m_pcbType) {
 		if (!m_board) {
 			QMessageBox::warning(nullptr, QObject::tr("Fritzing"), QObject::tr("Cannot autoroute: no board (or multiple boards) found"));
-			return;
+			return false;
 		}
 		m_jumperWillFitFunction = jumperWillFit;
 		m_costFunction = distanceCost;
@@ -648,17 +1136,16 @@ void MazeRouter::start()
 		QString message = m_pcbType ?  QObject::tr("No connections (on the PCB) to route.") : QObject::tr("No connections to route.");
 		QMessageBox::information(nullptr, QObject::tr("Fritzing"), message);
 		Autorouter::cleanUpNets();
-		return;
+		return false;
 	}
 
-	auto *parentCommand = new QUndoCommand("Autoroute");
+	m_parentCommand = new QUndoCommand("Autoroute");
     /// @todo can have leaks if ctors of these commands changes
-	new CleanUpWiresCommand(m_sketchWidget, CleanUpWiresCommand::UndoOnly, parentCommand);
-	new CleanUpRatsnestsCommand(m_sketchWidget, CleanUpWiresCommand::UndoOnly, parentCommand);
+	new CleanUpWiresCommand(m_sketchWidget, CleanUpWiresCommand::UndoOnly, m_parentCommand);
+	new CleanUpRatsnestsCommand(m_sketchWidget, CleanUpWiresCommand::UndoOnly, m_parentCommand);
 
-	initUndo(parentCommand);
+	initUndo(m_parentCommand);
 
-	NetList netList;
 	auto totalToRoute = 0;
 	for (auto i = 0; i < m_allPartConnectorItems.count(); i++) {
 		auto *net = new Net;
@@ -688,14 +1175,14 @@ void MazeRouter::start()
 		}
 
 		net->pinsWithin = findPinsWithin(net->net);
-		netList.nets << net;
+		m_netList.nets << net;
 		totalToRoute += net->net->count() - 1;
 	}
 
-    std::sort(netList.nets.begin(), netList.nets.end(), byPinsWithin);
+    std::sort(m_netList.nets.begin(), m_netList.nets.end(), byPinsWithin);
 	NetOrdering initialOrdering;
 	auto ix = 0;
-	Q_FOREACH (Net * net, netList.nets) {
+	Q_FOREACH (Net * net, m_netList.nets) {
 		// id is the same as the order in netList
 		initialOrdering.order << ix;
 		net->id = ix++;
@@ -707,19 +1194,26 @@ void MazeRouter::start()
 
 	ProcessEventBlocker::processEvents(); // to keep the app  from freezing
 	if (m_cancelled || m_stopTracing) {
-		restoreOriginalState(parentCommand);
-		cleanUpNets(netList);
-		return;
+		restoreOriginalState(m_parentCommand);
+		m_parentCommand = nullptr;
+		cleanUpNets(m_netList);
+		return false;
 	}
 
-	QSizeF gridSize(m_maxRect.width() / m_gridPixels, m_maxRect.height() / m_gridPixels);
-	QSize boardImageSize(qCeil(gridSize.width()), qCeil(gridSize.height()));
-	m_grid = new Grid(boardImageSize.width(), boardImageSize.height(), m_bothSidesNow ? 2 : 1);
-	if (!m_grid->data) {
+	m_gridSize = QSizeF(m_maxRect.width() / m_gridPixels, m_maxRect.height() / m_gridPixels);
+	QSize boardImageSize(qCeil(m_gridSize.width()), qCeil(m_gridSize.height()));
+	try {
+		m_grid = new Grid(boardImageSize.width(), boardImageSize.height(), m_bothSidesNow ? 2 : 1);
+	}
+	catch (const std::bad_alloc &) {
+		m_grid = nullptr;
+	}
+	if (m_grid == nullptr) {
 		QMessageBox::information(nullptr, QObject::tr("Fritzing"), "Out of memory--unable to proceed");
-		restoreOriginalState(parentCommand);
-		cleanUpNets(netList);
-		return;
+		restoreOriginalState(m_parentCommand);
+		m_parentCommand = nullptr;
+		cleanUpNets(m_netList);
+		return false;
 	}
 
 	m_boardImage = new QImage(boardImageSize.width() * 4, boardImageSize.height() * 4, QImage::Format_Mono);
@@ -729,16 +1223,17 @@ void MazeRouter::start()
 	}
 	else {
 		m_boardImage->fill(0);
-		QRectF r4(QPointF(0, 0), gridSize * 4);
+		QRectF r4(QPointF(0, 0), m_gridSize * 4);
 		makeBoard(m_boardImage, m_keepoutGrid * 4, r4);
 	}
 	GraphicsUtils::drawBorder(m_boardImage, 4);
 
 	ProcessEventBlocker::processEvents(); // to keep the app  from freezing
 	if (m_cancelled || m_stopTracing) {
-		restoreOriginalState(parentCommand);
-		cleanUpNets(netList);
-		return;
+		restoreOriginalState(m_parentCommand);
+		m_parentCommand = nullptr;
+		cleanUpNets(m_netList);
+		return false;
 	}
     /// @todo perfect candidate for std::unique_ptr<QImage[]>
 	m_displayImage[0] = new QImage(boardImageSize, QImage::Format_ARGB32);
@@ -747,43 +1242,75 @@ void MazeRouter::start()
 	m_displayImage[1]->fill(0);
 
 	QString message;
+	QElapsedTimer phaseTimer;
+	phaseTimer.start();
+	Tracer::begin("autoroute.masters");
 	auto gotMasters = makeMasters(message);
+	if (gotMasters && !m_cancelled && !m_stopTracing) {
+		makeObstacleCache(m_netList, QRectF(QPointF(0, 0), m_gridSize * 4));
+	}
+	Tracer::end();
+	m_metrics.makeMastersNs += phaseTimer.nsecsElapsed();
+	m_metrics.totalToRoute = totalToRoute;
 	if (m_cancelled || m_stopTracing || !gotMasters) {
-		restoreOriginalState(parentCommand);
-		cleanUpNets(netList);
-		return;
+		restoreOriginalState(m_parentCommand);
+		m_parentCommand = nullptr;
+		cleanUpNets(m_netList);
+		return false;
 	}
 
-	QList<NetOrdering> allOrderings;
-	allOrderings << initialOrdering;
-	Score bestScore;
-	Score currentScore;
-	auto run = 0;
-	for (; run < m_maxCycles && run < allOrderings.count(); run++) {
-		QString msg= tr("best so far: %1 of %2 routed").arg(bestScore.totalRoutedCount).arg(totalToRoute);
-		if (m_pcbType) {
-			msg +=  tr(" with %n vias", "", bestScore.totalViaCount);
-		}
-		Q_EMIT setProgressMessage(msg);
-		Q_EMIT setCycleMessage(tr("round %1 of:").arg(run + 1));
-		Q_EMIT setProgressValue(run);
-		ProcessEventBlocker::processEvents();
-		currentScore.setOrdering(allOrderings.at(run));
-		currentScore.anyUnrouted = false;
-		routeNets(netList, false, currentScore, gridSize, allOrderings);
-		if (bestScore.ordering.order.count() == 0) {
-			bestScore = currentScore;
-		}
-		else {
-			if (currentScore.totalRoutedCount > bestScore.totalRoutedCount) {
-				bestScore = currentScore;
-			}
-			else if (currentScore.totalRoutedCount == bestScore.totalRoutedCount && currentScore.totalViaCount < bestScore.totalViaCount) {
-				bestScore = currentScore;
-			}
-		}
-		if (m_cancelled || bestScore.anyUnrouted == false || m_stopTracing) break;
-	}
+	m_allOrderings.clear();
+	m_allOrderings << initialOrdering;
+	m_bestScore = Score();
+
+	// the search runs on a worker with its own grid and master documents; this thread only relays
+	// progress, the preview and the dialog's buttons, then routes what is left and applies the traces
+	qRegisterMetaType< QList<Trace> >("QList<Trace>");
+	m_searcher = new MazeRouter(this);
+	m_searcher->m_metrics.totalToRoute = totalToRoute;
+	connect(m_searcher, &MazeRouter::setProgressMessage, this, &MazeRouter::setProgressMessage);
+	connect(m_searcher, &MazeRouter::setCycleMessage, this, &MazeRouter::setCycleMessage);
+	connect(m_searcher, &MazeRouter::setProgressValue, this, &MazeRouter::setProgressValue);
+	connect(m_searcher, &MazeRouter::setProgressStats, this, &MazeRouter::setProgressStats);
+	connect(m_searcher, &MazeRouter::bestTraces, this, &MazeRouter::showTraces);
+	MazeRouter * searcher = m_searcher;
+	m_search = QtConcurrent::run([this, searcher, initialOrdering]() {
+		return searcher->searchOrderings(m_netList, m_bestScore, m_gridSize, m_allOrderings, initialOrdering);
+	});
+	return true;
+}
+
+bool MazeRouter::searchFinished()
+{
+	// call from the GUI thread while processing events; relays the dialog's buttons to the search worker
+	if (m_searcher == nullptr) return true;
+
+	m_searcher->m_cancelled = m_cancelled.load();
+	m_searcher->m_stopTracing = m_stopTracing.load();
+	m_searcher->m_maxCycles = m_maxCycles.load();
+	return m_search.isFinished();
+}
+
+void MazeRouter::finishRouting()
+{
+	// routes what the search left with jumpers, then creates the traces and pushes the undo command
+	if (m_searcher == nullptr) return;
+
+	m_search.waitForFinished();
+	int run = m_search.result();
+	ProcessEventBlocker::processEvents();      // deliver the last queued progress
+	m_metrics.add(m_searcher->m_metrics);
+	m_metrics.rounds += m_searcher->m_metrics.rounds;
+	m_metrics.peakGridBytes = qMax(m_metrics.peakGridBytes, m_searcher->m_metrics.peakGridBytes + m_grid->allocatedBytes());
+	delete m_searcher;
+	m_searcher = nullptr;
+
+	QUndoCommand * parentCommand = m_parentCommand;
+	m_parentCommand = nullptr;
+	NetList & netList = m_netList;
+	Score & bestScore = m_bestScore;
+	QSizeF gridSize = m_gridSize;
+	QList<NetOrdering> & allOrderings = m_allOrderings;
 
 	Q_EMIT disableButtons();
 
@@ -812,7 +1339,7 @@ void MazeRouter::start()
 		Q_EMIT setCycleMessage(tr("round %1 of:").arg(run));
 		QString msg;
 		if (run < m_maxCycles) msg = tr("Routing unsuccessful; stopping at round %1.").arg(run);
-		else msg = tr("Routing reached maximum round %1.").arg(m_maxCycles);
+		else msg = tr("Routing reached maximum round %1.").arg(m_maxCycles.load());
 		msg += " ";
 		msg += tr("Use best so far...");
 		Q_EMIT setProgressMessage(msg);
@@ -837,7 +1364,6 @@ void MazeRouter::start()
 
 	m_boardImage = new QImage(m_maxRect.width() * OptimizeFactor, m_maxRect.height() * OptimizeFactor, QImage::Format_Mono);
 	m_spareImage = new QImage(m_maxRect.width() * OptimizeFactor, m_maxRect.height() * OptimizeFactor, QImage::Format_Mono);
-	m_spareImage2 = new QImage(m_maxRect.width() * OptimizeFactor, m_maxRect.height() * OptimizeFactor, QImage::Format_Mono);
 
 	if (m_temporaryBoard) {
 		m_boardImage->fill(0xffffffff);
@@ -849,6 +1375,12 @@ void MazeRouter::start()
 	}
 	GraphicsUtils::drawBorder(m_boardImage, 2);
 
+	m_metrics.routedCount = bestScore.totalRoutedCount;
+	m_metrics.viaCount = bestScore.totalViaCount;
+	m_metrics.completed = !bestScore.anyUnrouted;
+	Q_EMIT setProgressStats(m_metrics.summary());
+	logNetStats(netList, bestScore);
+
 	createTraces(netList, bestScore, parentCommand);
 
 	cleanUpNets(netList);
@@ -908,30 +1440,13 @@ bool MazeRouter::makeBoard(QImage * boardImage, double keepoutGrid, const QRectF
 		return false;
 	}
 
-	QByteArray boardByteArray;
-	QString tempColor("#ffffff");
+	// board should be white, borders should be black; the border is extended given that the board image is * 4
 	QStringList exceptions;
 	exceptions << "none" << "";
-	if (!SvgFileSplitter::changeColors(boardSvg, tempColor, exceptions, boardByteArray)) {
+	if (!BoardMaskCache::mask(boardSvg, exceptions, boardImage->size(), renderRect, keepoutGrid, *boardImage)) {
 		return false;
 	}
 
-	QSvgRenderer renderer(boardByteArray);
-	QPainter painter;
-	painter.begin(boardImage);
-	painter.setRenderHint(QPainter::Antialiasing, false);
-	renderer.render(&painter, renderRect);
-	painter.end();
-
-	// board should be white, borders should be black
-
-#ifndef QT_NO_DEBUG
-	//boardImage->save(FolderUtils::getUserDataStorePath("") + "/mazeMakeBoard.png");
-#endif
-
-	// extend it given that the board image is * 4
-	DRC::extendBorder(keepoutGrid, boardImage);
-
 #ifndef QT_NO_DEBUG
 	//boardImage->save(FolderUtils::getUserDataStorePath("") + "/mazeMakeBoard2.png");
 #endif
@@ -982,6 +1497,117 @@ bool MazeRouter::makeMasters(QString & message) {
 	return true;
 }
 
+void MazeRouter::makeObstacleCache(NetList & netList, const QRectF & r4) {
+	// one render per net per layer for the whole autoroute, instead of one per net per layer per ordering
+
+	auto cache = std::make_shared<ObstacleCache>();
+	for (auto it = m_masterDocs.constBegin(); it != m_masterDocs.constEnd(); ++it) {
+		int z = it.key() == ViewLayer::NewBottom ? 0 : 1;
+		QDomDocument * masterDoc = it.value();
+		ObstacleLayer & layer = cache->layers[z];
+		QList< QList<QDomElement> > netElements;
+		for (int netIndex = 0; netIndex < netList.nets.count(); netIndex++) {
+			QList<QDomElement> net, alsoNet, notNet;
+			Markers markers;
+			initMarkers(markers, m_pcbType);
+			DRC::splitNetPrep(masterDoc, *(netList.nets.at(netIndex)->net), markers, net, alsoNet, notNet, true);
+			Q_FOREACH (QDomElement element, notNet) {
+				element.setTagName("g");
+			}
+
+			m_spareImage->fill(0xffffffff);
+			ItemBase::renderOne(masterDoc, m_spareImage, r4);
+
+			Q_FOREACH (QDomElement element, net + alsoNet + notNet) {
+				element.setTagName(element.attribute("former"));
+				element.removeAttribute("net");
+			}
+			Q_FOREACH (QDomElement element, net + alsoNet) {
+				element.setAttribute("mznets", element.attribute("mznets").toInt() + 1);
+			}
+			netElements << net + alsoNet;
+
+			// crop to the rows and 32-pixel columns holding anything black
+			int bytesPerLine = m_spareImage->bytesPerLine();
+			int top = -1, bottom = -1, left = bytesPerLine, right = -1;
+			for (int y = 0; y < m_spareImage->height(); y++) {
+				const uchar * line = m_spareImage->constScanLine(y);
+				for (int b = 0; b < bytesPerLine; b++) {
+					if (line[b] == 0xff) continue;
+
+					if (top < 0) top = y;
+					bottom = y;
+					left = qMin(left, b);
+					right = qMax(right, b);
+				}
+			}
+			if (top < 0) continue;
+
+			left &= ~3;
+			right = qMin((right | 3) + 1, bytesPerLine);
+			layer.nets.insert(netIndex, m_spareImage->copy(left * 8, top, (right - left) * 8, bottom - top + 1));
+			layer.offsets.insert(netIndex, QPoint(left * 8, top));
+		}
+
+		for (int netIndex = 0; netIndex < netElements.count(); netIndex++) {
+			Q_FOREACH (QDomElement element, netElements.at(netIndex)) {
+				if (element.attribute("mznets").toInt() > 1) {
+					layer.uncached.insert(netIndex);
+					break;
+				}
+			}
+		}
+
+		// the static layer hides every element that belongs to any routed net
+		Q_FOREACH (QList<QDomElement> elements, netElements) {
+			Q_FOREACH (QDomElement element, elements) {
+				element.removeAttribute("mznets");
+				element.setTagName("g");
+			}
+		}
+		m_spareImage->fill(0xffffffff);
+		ItemBase::renderOne(masterDoc, m_spareImage, r4);
+		layer.staticObstacles = m_spareImage->copy();
+		Q_FOREACH (QList<QDomElement> elements, netElements) {
+			Q_FOREACH (QDomElement element, elements) {
+				element.setTagName(element.attribute("former"));
+			}
+		}
+
+		ProcessEventBlocker::processEvents();
+		if (m_cancelled) return;
+	}
+
+	m_obstacleCache = cache;
+}
+
+bool MazeRouter::compositeObstacles(int z, int netIndex, QImage * image) {
+	// black (0) is obstacle, so stacking obstacles is an AND
+	if (!m_obstacleCache) return false;
+
+	const ObstacleLayer & layer = m_obstacleCache->layers[z];
+	if (layer.staticObstacles.isNull() || layer.uncached.contains(netIndex)) return false;
+	if (layer.staticObstacles.size() != image->size()) return false;
+
+	memcpy(image->bits(), layer.staticObstacles.constBits(), image->sizeInBytes());
+	for (auto it = layer.nets.constBegin(); it != layer.nets.constEnd(); ++it) {
+		if (it.key() == netIndex) continue;
+
+		const QImage & crop = it.value();
+		QPoint offset = layer.offsets.value(it.key());
+		int bytes = crop.width() / 8;
+		for (int y = 0; y < crop.height(); y++) {
+			const uchar * from = crop.constScanLine(y);
+			uchar * to = image->scanLine(offset.y() + y) + (offset.x() / 8);
+			for (int b = 0; b < bytes; b++) {
+				to[b] &= from[b];
+			}
+		}
+	}
+
+	return true;
+}
+
 bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings)
 {
 	RouteThing routeThing;
@@ -991,6 +1617,8 @@ bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentSc
 	routeThing.r4 = QRectF(QPointF(0, 0), gridSize * 4);
 	routeThing.layerSpecs << ViewLayer::NewBottom;
 	if (m_bothSidesNow) routeThing.layerSpecs << ViewLayer::NewTop;
+	routeThing.sourceQ.setStrategy(m_queueStrategy, m_grid->x, m_grid->y);
+	routeThing.targetQ.setStrategy(m_queueStrategy, m_grid->x, m_grid->y);
 
 	auto result = true;
 
@@ -1029,11 +1657,7 @@ bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentSc
 			// should only be here when makeJumpers = true
 			// remove the set of routed traces for this net--the net was not completely routed
 			// we didn't get all the way through before
-			currentScore.totalRoutedCount -= currentScore.routedCount.value(netIndex);
-			currentScore.routedCount.insert(netIndex, 0);
-			currentScore.totalViaCount -= currentScore.viaCount.value(netIndex);
-			currentScore.viaCount.insert(netIndex, 0);
-			currentScore.traces.remove(netIndex);
+			removeNetTraces(currentScore, netIndex);
 		}
 
 		//foreach (ConnectorItem * connectorItem, *(net->net)) {
@@ -1043,6 +1667,13 @@ bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentSc
 		//    }
 		//}
 
+		Tracer::Scope tracing("autoroute.net", QString::number(netIndex));
+		QElapsedTimer netTimer;
+		netTimer.start();
+		qint64 netExpansions = m_metrics.expansions;
+		routeThing.queuePeak = 0;
+		routeThing.traceBackPoints = 0;
+
 		QList< QList<ConnectorItem *> > subnets;
 		Q_FOREACH (QList<ConnectorItem *> subnet, net->subnets) {
 			QList<ConnectorItem *> copy(subnet);
@@ -1064,7 +1695,10 @@ bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentSc
 		}
 
 		QList<Trace> traces = currentScore.traces.values();
-		if (m_pcbType) {
+		if (m_negotiating) {
+			traceCongestion(traces, netIndex, routeThing);
+		}
+		else if (m_pcbType) {
 			traceObstacles(traces, netIndex, m_grid, m_keepoutGridInt);
 		}
 		else {
@@ -1091,8 +1725,10 @@ bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentSc
 			//QString after = masterDoc->toString();
 
 			//DebugDialog::debug("obstacles from board");
-			m_spareImage->fill(0xffffffff);
-			ItemBase::renderOne(masterDoc, m_spareImage, routeThing.r4);
+			if (!compositeObstacles(z, netIndex, m_spareImage)) {
+				m_spareImage->fill(0xffffffff);
+				ItemBase::renderOne(masterDoc, m_spareImage, routeThing.r4);
+			}
 #ifndef QT_NO_DEBUG
 			//m_spareImage->save(FolderUtils::getUserDataStorePath("") + QString("/obstacles%1_%2.png").arg(netIndex, 2, 10, QChar('0')).arg(viewLayerPlacement));
 #endif
@@ -1131,14 +1767,23 @@ bool MazeRouter::routeNets(NetList & netList, bool makeJumper, Score & currentSc
 			result = routeNext(makeJumper, routeThing, subnets, currentScore, netIndex, allOrderings);
 		}
 
+		NetStats & netStats = currentScore.netStats[netIndex];
+		netStats.expansions = m_metrics.expansions - netExpansions;
+		netStats.ns = netTimer.nsecsElapsed();
+		netStats.queuePeak = routeThing.queuePeak;
+		netStats.traceBackPoints = routeThing.traceBackPoints;
+		m_metrics.queueHighWater = qMax(m_metrics.queueHighWater, qint64(routeThing.queuePeak));
+		m_metrics.traceBackPoints += routeThing.traceBackPoints;
+
 		routeThing.netElements[0].net.clear();
 		routeThing.netElements[0].notNet.clear();
 		routeThing.netElements[0].alsoNet.clear();
 		routeThing.netElements[1].net.clear();
 		routeThing.netElements[1].notNet.clear();
 		routeThing.netElements[1].alsoNet.clear();
-		routeThing.sourceQ = std::priority_queue<GridPoint>();
-		routeThing.targetQ = std::priority_queue<GridPoint>();
+		routeThing.sourceQ.clear();
+		routeThing.targetQ.clear();
+		routeThing.congestion.clear();
 
 		if (!result) break;
 	}
@@ -1154,7 +1799,11 @@ bool MazeRouter::routeOne(bool makeJumper, Score & currentScore, int netIndex, R
 	routeThing.bestDistanceToSource = routeThing.bestDistanceToTarget = std::numeric_limits<double>::max();
 	//DebugDialog::debug(QString("jumper d %1, %2").arg(routeThing.bestDistanceToSource).arg(routeThing.bestDistanceToTarget));
 
+	routeThing.useCorridor = m_coarseRouting && makeCorridor(routeThing);
 	newTrace.gridPoints = route(routeThing, viaCount);
+	routeThing.useCorridor = false;
+	routeThing.sourceDeferred.clear();
+	routeThing.targetDeferred.clear();
 	if (m_cancelled || m_stopTracing) {
 		return false;
 	}
@@ -1168,7 +1817,7 @@ bool MazeRouter::routeOne(bool makeJumper, Score & currentScore, int netIndex, R
 		}
 		else {
 			routeThing.unrouted = true;
-			if (currentScore.reorderNet < 0) {
+			if (currentScore.reorderNet < 0 && !m_negotiating) {
 				for (int i = 0; i < currentScore.ordering.order.count(); i++) {
 					if (currentScore.ordering.order.at(i) == netIndex) {
 						if (moveBack(currentScore, i, allOrderings)) {
@@ -1236,8 +1885,8 @@ bool MazeRouter::routeNext(bool makeJumper, RouteThing & routeThing, QList< QLis
 	auto jp = routeThing.nearest.jc->sceneAdjustedTerminalPoint(nullptr) - m_maxRect.topLeft();
 	routeThing.gridTargetPoint = QPoint(jp.x() / m_gridPixels, jp.y() / m_gridPixels);
 
-	routeThing.sourceQ = std::priority_queue<GridPoint>();
-	routeThing.targetQ = std::priority_queue<GridPoint>();
+	routeThing.sourceQ.clear();
+	routeThing.targetQ.clear();
 
 	if (!m_pcbType) {
 		QList<Trace> traces = currentScore.traces.values();
@@ -1275,54 +1924,259 @@ bool MazeRouter::moveBack(Score & currentScore, int index, QList<NetOrdering> &
 		return false;  // nowhere to move back to
 	}
 
+	// in parallel mode, queue up several candidate orderings so the workers have something to do
+	int added = 0;
 	QList<int> order(currentScore.ordering.order);
 	//printOrder("start", order);
 	int netIndex = order.takeAt(index);
 	//printOrder("minus", order);
 	for (int i = index - 1; i >= 0; i--) {
-		bool done = true;
 		order.insert(i, netIndex);
 		//printOrder("plus ", order);
-		Q_FOREACH (NetOrdering ordering, allOrderings) {
-			bool gotOne = true;
-			for (int j = 0; j < order.count(); j++) {
-				if (order.at(j) != ordering.order.at(j)) {
-					gotOne = false;
-					break;
-				}
-			}
-			if (gotOne) {
-				done = false;
-				break;
-			}
-		}
-		if (done == true) {
+		if (!containsOrdering(allOrderings, order)) {
 			NetOrdering newOrdering;
 			newOrdering.order = order;
 			allOrderings.append(newOrdering);
 			//printOrder("done ", newOrdering.order);
 
-			/*
-			const static int watch[] = { 0, 1, 2, 3, 6, 12, 14, 4, 5, 7, 8, 9, 10, 11, 13, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64 };
-			// {0, 1, 2, 4, 3, 12, 6, 14, 5, 7, 8, 9, 10, 11, 13, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64};
+			/*
+			const static int watch[] = { 0, 1, 2, 3, 6, 12, 14, 4, 5, 7, 8, 9, 10, 11, 13, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64 };
+			// {0, 1, 2, 4, 3, 12, 6, 14, 5, 7, 8, 9, 10, 11, 13, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64};
+
+			bool matches = true;
+			for (int i = 0; i < order.count(); i++) {
+			    if (order.at(i) != watch[i]) {
+			        matches = false;
+			        break;
+			    }
+			}
+			if (matches) {
+			    DebugDialog::debug("order matches");
+			}
+			*/
+			if (++added >= m_parallelOrderings) return true;
+		}
+		order.removeAt(i);
+	}
+
+	return added > 0;
+}
+
+int MazeRouter::searchOrderings(NetList & netList, Score & bestScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings, const NetOrdering & initialOrdering)
+{
+	// runs on a worker thread: nothing here touches the scene
+	Score currentScore;
+	auto run = 0;
+	if (m_negotiatedRouting && m_pcbType) {
+		run = negotiateNets(netList, bestScore, gridSize, allOrderings, initialOrdering);
+	}
+	else {
+		for (; run < m_maxCycles && run < allOrderings.count(); run++) {
+			QString msg= tr("best so far: %1 of %2 routed").arg(bestScore.totalRoutedCount).arg(m_metrics.totalToRoute);
+			if (m_pcbType) {
+				msg +=  tr(" with %n vias", "", bestScore.totalViaCount);
+			}
+			Q_EMIT setProgressMessage(msg);
+			Q_EMIT setCycleMessage(tr("round %1 of:").arg(run + 1));
+			Q_EMIT setProgressValue(run);
+			int runCount = qMin(m_parallelOrderings, qMin(m_maxCycles.load(), allOrderings.count()) - run);
+			m_metrics.rounds += qMax(1, runCount);
+			Tracer::Scope tracing("autoroute.round", QString::number(run + 1));
+			QElapsedTimer roundTimer;
+			roundTimer.start();
+			if (runCount > 1) {
+				routeOrderings(netList, currentScore, bestScore, gridSize, allOrderings, run, runCount);
+				run += runCount - 1;
+			}
+			else {
+				currentScore.setOrdering(allOrderings.at(run));
+				currentScore.anyUnrouted = false;
+				routeNets(netList, false, currentScore, gridSize, allOrderings);
+				if (betterScore(currentScore, bestScore)) {
+					bestScore = currentScore;
+				}
+			}
+			// a batch of parallel orderings is split evenly over its rounds
+			for (int i = 0; i < qMax(1, runCount); i++) m_metrics.roundNs << roundTimer.nsecsElapsed() / qMax(1, runCount);
+			Q_EMIT setProgressStats(m_metrics.summary());
+			Q_EMIT bestTraces(bestScore.traces.values());
+			if (m_cancelled || bestScore.anyUnrouted == false || m_stopTracing) break;
+		}
+	}
+
+	m_metrics.peakGridBytes = qMax(m_metrics.peakGridBytes, m_grid->allocatedBytes());
+	return run;
+}
+
+void MazeRouter::showTraces(const QList<Trace> & traces) {
+	initTraceDisplay();
+	Q_FOREACH (Trace trace, traces) {
+		displayTrace(trace);
+	}
+	updateDisplay(0);
+	if (m_bothSidesNow) updateDisplay(1);
+}
+
+void MazeRouter::routeOrderings(NetList & netList, Score & currentScore, Score & bestScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings, int firstRun, int runCount)
+{
+	// route runCount orderings at once, each on a worker with its own Grid and Score;
+	// the GUI thread only waits, so nothing in the scene changes underneath the workers
+	QVector<MazeRouter *> workers;
+	QVector<Score> scores(runCount);
+	QVector< QList<NetOrdering> > orderings(runCount);
+	for (int i = 0; i < runCount; i++) {
+		workers << new MazeRouter(this);
+		scores[i] = currentScore;
+		scores[i].setOrdering(allOrderings.at(firstRun + i));
+		scores[i].anyUnrouted = false;
+		orderings[i] = allOrderings;
+	}
+
+	QList< QFuture<bool> > futures;
+	for (int i = 0; i < runCount; i++) {
+		MazeRouter * worker = workers.at(i);
+		Score * score = &scores[i];
+		QList<NetOrdering> * workerOrderings = &orderings[i];
+		futures << QtConcurrent::run([worker, &netList, score, gridSize, workerOrderings]() {
+			return worker->routeNets(netList, false, *score, gridSize, *workerOrderings);
+		});
+	}
+
+	Q_FOREACH (QFuture<bool> future, futures) {
+		while (!future.isFinished()) {
+			QThread::msleep(WorkerPollMs);
+			if (m_cancelled || m_stopTracing) {
+				Q_FOREACH (MazeRouter * worker, workers) {
+					worker->m_cancelled = m_cancelled.load();
+					worker->m_stopTracing = m_stopTracing.load();
+				}
+			}
+		}
+	}
+
+	int bestIndex = 0;
+	int originalCount = allOrderings.count();
+	for (int i = 0; i < runCount; i++) {
+		// keep the new orderings in worker order so the search stays deterministic
+		for (int j = originalCount; j < orderings.at(i).count(); j++) {
+			if (!containsOrdering(allOrderings, orderings.at(i).at(j).order)) {
+				allOrderings.append(orderings.at(i).at(j));
+			}
+		}
+		if (betterScore(scores.at(i), bestScore)) {
+			bestScore = scores.at(i);
+		}
+		if (betterScore(scores.at(i), scores.at(bestIndex))) {
+			bestIndex = i;
+		}
+	}
+	qint64 gridBytes = m_grid->allocatedBytes();
+	Q_FOREACH (MazeRouter * worker, workers) {
+		m_metrics.add(worker->m_metrics);
+		gridBytes += worker->m_grid->allocatedBytes();
+	}
+	m_metrics.peakGridBytes = qMax(m_metrics.peakGridBytes, gridBytes);
+	qDeleteAll(workers);
+
+	// continue from the best of this batch, so its traces can be reused by the next orderings
+	currentScore = scores.at(bestIndex);
+
+	initTraceDisplay();
+	Q_FOREACH (Trace trace, bestScore.traces) {
+		displayTrace(trace);
+	}
+	updateDisplay(0);
+	if (m_bothSidesNow) updateDisplay(1);
+}
+
+int MazeRouter::negotiateNets(NetList & netList, Score & bestScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings, const NetOrdering & initialOrdering)
+{
+	// negotiated congestion (PathFinder): the traces of other nets are priced rather than blocked, every round
+	// a shared cell gets dearer, and the nets that still share cells are ripped up and routed again.
+	// Whatever still overlaps at the end is left to the usual serial pass, with hard obstacles
+	m_negotiating = true;
+	m_congestionHistory.assign(size_t(m_grid->x) * m_grid->y * m_grid->z, 0);
+
+	Score score;
+	score.setOrdering(initialOrdering);
+	QSet<int> again;
+	int round = 0;
+	while (round < m_maxCycles) {
+		QString msg = tr("negotiating: %1 of %2 routed, %n nets in conflict", "", again.count()).arg(score.totalRoutedCount).arg(m_metrics.totalToRoute);
+		Q_EMIT setProgressMessage(msg);
+		Q_EMIT setCycleMessage(tr("round %1 of:").arg(round + 1));
+		Q_EMIT setProgressValue(round);
+		m_metrics.rounds++;
+		m_presentCost = NegotiatedPresentCost << qMin(round, NegotiatedPresentGrowth);
+		round++;
+		Tracer::Scope tracing("autoroute.round", QString::number(round));
+		QElapsedTimer roundTimer;
+		roundTimer.start();
+
+		Q_FOREACH (int netIndex, again) {
+			removeNetTraces(score, netIndex);
+		}
+		score.anyUnrouted = false;
+		score.reorderNet = -1;
+		routeNets(netList, false, score, gridSize, allOrderings);
+		m_metrics.roundNs << roundTimer.nsecsElapsed();
+		Q_EMIT setProgressStats(m_metrics.summary());
+		Q_EMIT bestTraces(score.traces.values());
+		if (m_cancelled || m_stopTracing) break;
+
+		again = congestedNets(score, true);
+		Q_FOREACH (int netIndex, score.ordering.order) {
+			if (score.routedCount.value(netIndex) < netList.nets.at(netIndex)->subnets.count() - 1) again.insert(netIndex);
+		}
+		if (again.isEmpty()) break;
+	}
+
+	m_negotiating = false;
+	again = congestedNets(score, false);
+	Q_FOREACH (int netIndex, score.ordering.order) {
+		if (score.routedCount.value(netIndex) < netList.nets.at(netIndex)->subnets.count() - 1) again.insert(netIndex);
+	}
+	Q_FOREACH (int netIndex, again) {
+		removeNetTraces(score, netIndex);
+	}
+	score.anyUnrouted = !again.isEmpty();
+	score.reorderNet = -1;
+	bestScore = score;
+
+	std::vector<GridCost>().swap(m_congestionHistory);
+	return round;
+}
+
+QSet<int> MazeRouter::congestedNets(Score & score, bool raiseHistory) {
+	// a net is congested when one of its trace points is in another net's footprint
+	std::vector<int> owner(size_t(m_grid->x) * m_grid->y * m_grid->z, -1);         // -2 for more than one net
+	Q_FOREACH (Trace trace, score.traces) {
+		Q_FOREACH (int cell, footprint(trace)) {
+			if (owner[cell] == -1) owner[cell] = trace.netIndex;
+			else if (owner[cell] != trace.netIndex) owner[cell] = -2;
+		}
+	}
+
+	QSet<int> congested;
+	Q_FOREACH (Trace trace, score.traces) {
+		Q_FOREACH (GridPoint gridPoint, trace.gridPoints) {
+			int cell = (((gridPoint.z * m_grid->y) + gridPoint.y) * m_grid->x) + gridPoint.x;
+			if (owner[cell] != -2) continue;
 
-			bool matches = true;
-			for (int i = 0; i < order.count(); i++) {
-			    if (order.at(i) != watch[i]) {
-			        matches = false;
-			        break;
-			    }
-			}
-			if (matches) {
-			    DebugDialog::debug("order matches");
-			}
-			*/
-			return true;
+			congested.insert(trace.netIndex);
+			if (raiseHistory) m_congestionHistory[cell] += NegotiatedHistoryCost;
 		}
-		order.removeAt(i);
 	}
 
-	return false;
+	return congested;
+}
+
+void MazeRouter::removeNetTraces(Score & score, int netIndex) {
+	score.totalRoutedCount -= score.routedCount.value(netIndex);
+	score.routedCount.insert(netIndex, 0);
+	score.totalViaCount -= score.viaCount.value(netIndex);
+	score.viaCount.insert(netIndex, 0);
+	score.traces.remove(netIndex);
 }
 
 void MazeRouter::prepSourceAndTarget(QDomDocument * masterDoc, RouteThing & routeThing, QList< QList<ConnectorItem *> > & subnets, int z, ViewLayer::ViewLayerPlacement viewLayerPlacement)
@@ -1572,11 +2426,22 @@ QList<QPoint> MazeRouter::renderSource(QDomDocument * masterDoc, int z, ViewLaye
 
 QList<GridPoint> MazeRouter::route(RouteThing & routeThing, int & viaCount)
 {
+	static FTimingProbe probe("MazeRouter.route");
+	FTimingProbe::Scope timing(probe);
+
 	//DebugDialog::debug(QString("start route() %1").arg(routeNumber++));
 	viaCount = 0;
 	GridPoint done;
 	bool result = false;
-	while (!routeThing.sourceQ.empty() && !routeThing.targetQ.empty()) {
+	QElapsedTimer routeTimer;
+	routeTimer.start();
+	while (true) {
+		if (routeThing.sourceQ.empty() || routeThing.targetQ.empty()) {
+			// the corridor was too tight: carry on from where it stopped, over the whole grid
+			if (!releaseCorridor(routeThing)) break;
+			if (routeThing.sourceQ.empty() || routeThing.targetQ.empty()) break;
+		}
+
 		GridPoint gp = routeThing.sourceQ.top();
 		GridPoint gpt = routeThing.targetQ.top();
 		if (gpt.qCost < gp.qCost) {
@@ -1598,6 +2463,7 @@ QList<GridPoint> MazeRouter::route(RouteThing & routeThing, int & viaCount)
 		}
 
 		expand(gp, routeThing);
+		routeThing.queuePeak = qMax(routeThing.queuePeak, int(routeThing.sourceQ.size() + routeThing.targetQ.size()));
 		if (m_cancelled || m_stopTracing) {
 			break;
 		}
@@ -1605,15 +2471,19 @@ QList<GridPoint> MazeRouter::route(RouteThing & routeThing, int & viaCount)
 
 	//DebugDialog::debug(QString("routing result %1").arg(result));
 
+	m_metrics.routeNs += routeTimer.nsecsElapsed();
+
 	QList<GridPoint> points;
 	if (!result) {
 		//updateDisplay(m_grid, 0);
 		//DebugDialog::debug(QString("done routing no points"));
 		return points;
 	}
+	routeTimer.restart();
 	done.baseCost = std::numeric_limits<GridValue>::max();  // make sure this is the largest value for either traceback
 	QList<GridPoint> sourcePoints = traceBack(done, m_grid, viaCount, GridTarget, GridSource);      // trace back to source
 	QList<GridPoint> targetPoints = traceBack(done, m_grid, viaCount, GridSource, GridTarget);      // trace back to target
+	m_metrics.traceBackNs += routeTimer.nsecsElapsed();
 	if (sourcePoints.count() == 0 || targetPoints.count() == 0) {
 		DebugDialog::debug("traceback zero points");
 		return points;
@@ -1622,6 +2492,7 @@ QList<GridPoint> MazeRouter::route(RouteThing & routeThing, int & viaCount)
 		targetPoints.takeFirst();           // redundant point
 		Q_FOREACH (GridPoint gp, targetPoints) points.prepend(gp);
 		points.append(sourcePoints);
+		routeThing.traceBackPoints += points.count();
 	}
 
 	clearExpansion(m_grid);
@@ -1727,6 +2598,7 @@ GridPoint MazeRouter::traceBackOne(GridPoint & gridPoint, Grid * grid, int dx, i
 
 void MazeRouter::expand(GridPoint & gridPoint, RouteThing & routeThing)
 {
+	m_metrics.expansions++;
 	//static bool debugit = false;
 	//if (routeNumber > 41 && routeThing.pq.size() > 8200) debugit = true;
 
@@ -1741,6 +2613,12 @@ void MazeRouter::expand(GridPoint & gridPoint, RouteThing & routeThing)
 		if (gridPoint.z > 0) expandOne(gridPoint, routeThing, 0, 0, -1, true);
 		if (gridPoint.z < m_grid->z - 1) expandOne(gridPoint, routeThing, 0, 0, 1, true);
 	}
+	if (routeThing.deferPoint) {
+		// expand it again, without the corridor, if the corridor fails
+		routeThing.deferPoint = false;
+		if (routeThing.sourceValue == GridSource) routeThing.sourceDeferred << gridPoint;
+		else routeThing.targetDeferred << gridPoint;
+	}
 	//if (debugit) {
 	//    DebugDialog::debug("expand done");
 	//}
@@ -1762,6 +2640,13 @@ void MazeRouter::expandOne(GridPoint & gridPoint, RouteThing & routeThing, int d
 		return;
 	}
 
+	if (routeThing.useCorridor && (nextval == 0 || nextval == GridAvoid)) {
+		if (!routeThing.corridor[((next.y / CoarseGridFactor) * routeThing.corridorX) + (next.x / CoarseGridFactor)]) {
+			routeThing.deferPoint = true;
+			return;
+		}
+	}
+
 	if (nextval == routeThing.targetValue) {
 		//DebugDialog::debug("found grid target");
 		next.flags |= GridPointDone;
@@ -1831,6 +2716,9 @@ void MazeRouter::expandOne(GridPoint & gridPoint, RouteThing & routeThing, int d
 		next.baseCost += AvoidCost;
 	}
 	next.baseCost++;
+	if (!routeThing.congestion.empty()) {
+		next.baseCost += routeThing.congestion[(((next.z * m_grid->y) + next.y) * m_grid->x) + next.x];
+	}
 
 
 	/*
@@ -1912,6 +2800,104 @@ void MazeRouter::expandOne(GridPoint & gridPoint, RouteThing & routeThing, int d
 	//}
 }
 
+bool MazeRouter::makeCorridor(RouteThing & routeThing) {
+	// global pass: A* over coarse cells of CoarseGridFactor x CoarseGridFactor grid points (all layers together),
+	// where a cell's step cost grows with how much of it is obstacle; the corridor is the path plus a margin
+
+	int cx = (m_grid->x + CoarseGridFactor - 1) / CoarseGridFactor;
+	int cy = (m_grid->y + CoarseGridFactor - 1) / CoarseGridFactor;
+	if (cx * cy < CoarseMinimumCells) return false;        // small board: the fine search is cheap anyway
+
+	std::vector<int> blocked(cx * cy, 0);
+	std::vector<int> total(cx * cy, 0);
+	for (int z = 0; z < m_grid->z; z++) {
+		for (int y = 0; y < m_grid->y; y++) {
+			int row = (y / CoarseGridFactor) * cx;
+			for (int x = 0; x < m_grid->x; x++) {
+				int cell = row + (x / CoarseGridFactor);
+				total[cell]++;
+				if (m_grid->isObstacle(x, y, z)) blocked[cell]++;
+			}
+		}
+	}
+
+	auto coarseCell = [cx, cy](const QPoint & p) {
+		int x = qBound(0, p.x() / CoarseGridFactor, cx - 1);
+		int y = qBound(0, p.y() / CoarseGridFactor, cy - 1);
+		return (y * cx) + x;
+	};
+	int sourceCell = coarseCell(routeThing.gridSourcePoint);
+	int targetCell = coarseCell(routeThing.gridTargetPoint);
+	int tx = targetCell % cx;
+	int ty = targetCell / cx;
+
+	std::vector<double> cost(cx * cy, std::numeric_limits<double>::max());
+	std::vector<int> from(cx * cy, -1);
+	typedef std::pair<double, int> CoarsePoint;
+	std::priority_queue<CoarsePoint, std::vector<CoarsePoint>, std::greater<CoarsePoint> > pq;
+	cost[sourceCell] = 0;
+	pq.push(CoarsePoint(qAbs(sourceCell % cx - tx) + qAbs(sourceCell / cx - ty), sourceCell));
+	bool found = false;
+	while (!pq.empty()) {
+		int cell = pq.top().second;
+		pq.pop();
+		if (cell == targetCell) {
+			found = true;
+			break;
+		}
+
+		int x = cell % cx;
+		int y = cell / cx;
+		const int neighbors[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+		for (const auto & neighbor : neighbors) {
+			int nx = x + neighbor[0];
+			int ny = y + neighbor[1];
+			if (nx < 0 || nx >= cx || ny < 0 || ny >= cy) continue;
+
+			int next = (ny * cx) + nx;
+			if (blocked[next] == total[next] && next != targetCell) continue;
+
+			double c = cost[cell] + 1 + (CoarseCongestionCost * blocked[next] / total[next]);
+			if (c >= cost[next]) continue;
+
+			cost[next] = c;
+			from[next] = cell;
+			pq.push(CoarsePoint(c + qAbs(nx - tx) + qAbs(ny - ty), next));
+		}
+	}
+
+	if (!found) return false;
+
+	routeThing.corridorX = cx;
+	routeThing.corridor.assign(cx * cy, 0);
+	for (int cell = targetCell; cell >= 0; cell = from[cell]) {
+		int x = cell % cx;
+		int y = cell / cx;
+		for (int iy = qMax(0, y - CorridorMargin); iy <= qMin(cy - 1, y + CorridorMargin); iy++) {
+			for (int ix = qMax(0, x - CorridorMargin); ix <= qMin(cx - 1, x + CorridorMargin); ix++) {
+				routeThing.corridor[(iy * cx) + ix] = 1;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool MazeRouter::releaseCorridor(RouteThing & routeThing) {
+	if (!routeThing.useCorridor) return false;
+
+	routeThing.useCorridor = false;
+	Q_FOREACH (GridPoint gridPoint, routeThing.sourceDeferred) {
+		routeThing.sourceQ.push(gridPoint);
+	}
+	Q_FOREACH (GridPoint gridPoint, routeThing.targetDeferred) {
+		routeThing.targetQ.push(gridPoint);
+	}
+	routeThing.sourceDeferred.clear();
+	routeThing.targetDeferred.clear();
+	return true;
+}
+
 bool MazeRouter::viaWillFit(GridPoint & gridPoint, Grid * grid) {
 	for (int y = -m_halfGridViaSize; y <= m_halfGridViaSize; y++) {
 		int py = y + gridPoint.y;
@@ -1933,6 +2919,8 @@ bool MazeRouter::viaWillFit(GridPoint & gridPoint, Grid * grid) {
 }
 
 void MazeRouter::updateDisplay(int iz) {
+	if (m_displayImage[iz] == nullptr) return;
+
 	QPixmap pixmap = QPixmap::fromImage(*m_displayImage[iz]);
 	if (m_displayItem[iz] == nullptr) {
 		m_displayItem[iz] = new QGraphicsPixmapItem(pixmap);
@@ -1953,6 +2941,8 @@ void MazeRouter::updateDisplay(int iz) {
 }
 
 void MazeRouter::updateDisplay(Grid * grid, int iz) {
+	if (m_displayImage[iz] == nullptr) return;
+
 	m_displayImage[iz]->fill(0);
 	for (int y = 0; y < grid->y; y++) {
 		for (int x = 0; x < grid->x; x++) {
@@ -1965,6 +2955,8 @@ void MazeRouter::updateDisplay(Grid * grid, int iz) {
 }
 
 void MazeRouter::updateDisplay(GridPoint & gridPoint) {
+	if (m_displayImage[gridPoint.z] == nullptr) return;
+
 	//static int counter = 0;
 	//if (counter++ % 2 == 0) {
 	uint color = getColor(m_grid->at(gridPoint.x, gridPoint.y, gridPoint.z));
@@ -1976,25 +2968,20 @@ void MazeRouter::updateDisplay(GridPoint & gridPoint) {
 }
 
 void MazeRouter::clearExpansion(Grid * grid) {
-	// TODO: keep a list of expansion points instead?
-
-	for (int z = 0; z < grid->z; z++) {
-		for (int y = 0; y < grid->y; y++) {
-			for (int x = 0; x < grid->x; x++) {
-				GridValue val = grid->at(x, y, z);
-				if (val == 0 || val == GridPartObstacle || val == GridBoardObstacle) ;
-				else grid->setAt(x, y, z, 0);
-			}
-		}
-	}
+	// everything except obstacles lives in the cost plane
+	grid->clearCosts();
 }
 
 void MazeRouter::initTraceDisplay() {
+	if (m_displayImage[0] == nullptr) return;
+
 	m_displayImage[0]->fill(0);
 	m_displayImage[1]->fill(0);
 }
 
 void MazeRouter::displayTrace(Trace & trace) {
+	if (m_displayImage[0] == nullptr) return;
+
 	if (trace.gridPoints.count() == 0) {
 		DebugDialog::debug("trace with no points");
 		return;
@@ -2118,6 +3105,72 @@ void MazeRouter::traceAvoids(QList<Trace> & traces, int netIndex, RouteThing & r
 	}
 }
 
+void MazeRouter::traceCongestion(QList<Trace> & traces, int netIndex, RouteThing & routeThing) {
+	// negotiated mode: traces from other nets cost extra to cross, once per net, on top of the congestion history
+	routeThing.congestion = m_congestionHistory;
+	std::vector<int> counted(routeThing.congestion.size(), -1);
+	Q_FOREACH (Trace trace, traces) {
+		if (trace.netIndex == netIndex) continue;
+
+		Q_FOREACH (int cell, footprint(trace)) {
+			if (counted[cell] == trace.netIndex) continue;
+
+			counted[cell] = trace.netIndex;
+			routeThing.congestion[cell] += m_presentCost;
+		}
+	}
+}
+
+QVector<int> MazeRouter::footprint(const Trace & trace) const {
+	// the cells traceObstacles blocks for a trace, as indexes into a grid-sized array covering all layers
+	QVector<int> cells;
+	auto add = [this, &cells](int x, int y, int z) {
+		if (x < 0 || y < 0 || x >= m_grid->x || y >= m_grid->y || z >= m_grid->z) return;
+		cells << (((z * m_grid->y) + y) * m_grid->x) + x;
+	};
+
+	int lastZ = trace.gridPoints.at(0).z;
+	Q_FOREACH (GridPoint gridPoint, trace.gridPoints) {
+		if (gridPoint.z != lastZ) {
+			for (int y = -m_halfGridViaSize; y <= m_halfGridViaSize; y++) {
+				for (int x = -m_halfGridViaSize; x <= m_halfGridViaSize; x++) {
+					add(gridPoint.x + x, gridPoint.y + y, 0);
+					add(gridPoint.x + x, gridPoint.y + y, 1);
+				}
+			}
+			lastZ = gridPoint.z;
+		}
+		else {
+			for (int y = -m_keepoutGridInt; y <= m_keepoutGridInt; y++) {
+				for (int x = -m_keepoutGridInt; x <= m_keepoutGridInt; x++) {
+					add(gridPoint.x + x, gridPoint.y + y, gridPoint.z);
+				}
+			}
+		}
+	}
+
+	return cells;
+}
+
+void MazeRouter::logNetStats(const NetList & netList, const Score & score) {
+	// one line per net of the routes that are about to be created
+	Q_FOREACH (int netIndex, score.ordering.order) {
+		if (!score.netStats.contains(netIndex)) continue;
+
+		const NetStats & netStats = score.netStats.value(netIndex);
+		double ms = netStats.ns / 1.0e6;
+		DebugDialog::debug(QString("autoroute net %1 (%2 connectors): %3 expansions, %4 cells/s, queue peak %5, %6 traceBack points, %7 vias, %8 ms")
+			.arg(netIndex)
+			.arg(netList.nets.at(netIndex)->net->count())
+			.arg(netStats.expansions)
+			.arg(ms > 0 ? netStats.expansions / ms * 1000 : 0, 0, 'f', 0)
+			.arg(netStats.queuePeak)
+			.arg(netStats.traceBackPoints)
+			.arg(score.viaCount.value(netIndex))
+			.arg(ms, 0, 'f', 1));
+	}
+}
+
 void MazeRouter::cleanUpNets(NetList & netList) {
 	Q_FOREACH(Net * net, netList.nets) {
 		delete net;
@@ -2133,7 +3186,11 @@ void MazeRouter::createTraces(NetList & netList, Score & bestScore, QUndoCommand
 	QMultiHash<int, QList< QPointer<TraceWire> > > allBundles;
 
 	ConnectionThing connectionThing;
+	m_routedRegion = QRectF();
 
+	Tracer::Scope tracing("autoroute.createTraces");
+	QElapsedTimer phaseTimer;
+	phaseTimer.start();
 	Q_EMIT setMaximumProgress(bestScore.ordering.order.count() * 2);
 	Q_EMIT setProgressMessage2(tr("Optimizing traces..."));
 
@@ -2194,23 +3251,32 @@ void MazeRouter::createTraces(NetList & netList, Score & bestScore, QUndoCommand
 		}
 	}
 
+	m_metrics.createTracesNs += phaseTimer.nsecsElapsed();
+	phaseTimer.restart();
 	//DebugDialog::debug("before optimize");
+	Tracer::begin("autoroute.optimizeTraces");
 	optimizeTraces(bestScore.ordering.order, allBundles, allVias, allJumperItems, allNetLabels, netList, connectionThing);
+	Tracer::end();
 	//DebugDialog::debug("after optimize");
+	m_metrics.optimizeTracesNs += phaseTimer.nsecsElapsed();
+	phaseTimer.restart();
 
 	Q_FOREACH (SymbolPaletteItem * netLabel, allNetLabels) {
 		addNetLabelToUndo(netLabel, parentCommand);
 	}
 	Q_FOREACH (Via * via, allVias) {
 		addViaToUndo(via, parentCommand);
+		m_routedRegion |= via->sceneBoundingRect();
 	}
 	Q_FOREACH (JumperItem * jumperItem, allJumperItems) {
 		addJumperToUndo(jumperItem, parentCommand);
+		m_routedRegion |= jumperItem->sceneBoundingRect();
 	}
 
 	Q_FOREACH (QList< QPointer<TraceWire> > bundle, allBundles) {
 		Q_FOREACH (TraceWire * traceWire, bundle) {
 			addWireToUndo(traceWire, parentCommand);
+			if (traceWire) m_routedRegion |= traceWire->sceneBoundingRect();
 		}
 	}
 
@@ -2248,6 +3314,7 @@ void MazeRouter::createTraces(NetList & netList, Score & bestScore, QUndoCommand
 		modelPart->setParent(nullptr);
 		delete modelPart;
 	}
+	m_metrics.createTracesNs += phaseTimer.nsecsElapsed();
 
 	DebugDialog::debug("create traces complete");
 }
@@ -2692,18 +3759,6 @@ void MazeRouter::removeStep(int ix, QList<GridPoint> & gridPoints) {
 
 }
 
-void MazeRouter::addConnectionToUndo(ConnectorItem * from, ConnectorItem * to, QUndoCommand * parentCommand)
-{
-	if (from == nullptr || to == nullptr) return;
-
-	auto * ccc = new ChangeConnectionCommand(m_sketchWidget, BaseCommand::CrossView,
-	        from->attachedToID(), from->connectorSharedID(),
-	        to->attachedToID(), to->connectorSharedID(),
-	        ViewLayer::specFromID(from->attachedToViewLayerID()),
-	        true, parentCommand);
-	ccc->setUpdateConnections(false);
-}
-
 void MazeRouter::addViaToUndo(Via * via, QUndoCommand * parentCommand) {
 	new AddItemCommand(m_sketchWidget, BaseCommand::CrossView, ModuleIDNames::ViaModuleIDName, via->viewLayerPlacement(), via->getViewGeometry(), via->id(), false, -1, parentCommand);
 	new SetPropCommand(m_sketchWidget, via->id(), "hole size", via->holeSize(), via->holeSize(), true, parentCommand);
@@ -2866,11 +3921,11 @@ void MazeRouter::routeJumper(int netIndex, RouteThing & routeThing, Score & curr
 }
 
 GridPoint MazeRouter::lookForJumper(GridPoint initial, GridValue targetValue, QPoint targetLocation) {
-	QSet<int> already;
+	m_jumperVisited.assign(((size_t(m_grid->x) * m_grid->y * m_grid->z) + 63) / 64, 0);
 	std::priority_queue<GridPoint> pq;
 	initial.qCost = 0;
 	pq.push(initial);
-	already.insert(gridPointInt(m_grid, initial));
+	visitCell(m_jumperVisited, gridPointInt(m_grid, initial));
 	while (!pq.empty()) {
 		GridPoint gp = pq.top();
 		pq.pop();
@@ -2899,13 +3954,13 @@ GridPoint MazeRouter::lookForJumper(GridPoint initial, GridValue targetValue, QP
 			return gp;
 		}
 
-		if (gp.x > 0) expandOneJ(gp, pq, -1, 0, 0, targetValue, targetLocation, already);
-		if (gp.x < m_grid->x - 1) expandOneJ(gp, pq, 1, 0, 0, targetValue, targetLocation, already);
-		if (gp.y > 0) expandOneJ(gp, pq, 0, -1, 0, targetValue, targetLocation, already);
-		if (gp.y < m_grid->y - 1) expandOneJ(gp, pq, 0, 1, 0, targetValue, targetLocation, already);
+		if (gp.x > 0) expandOneJ(gp, pq, -1, 0, 0, targetValue, targetLocation, initial);
+		if (gp.x < m_grid->x - 1) expandOneJ(gp, pq, 1, 0, 0, targetValue, targetLocation, initial);
+		if (gp.y > 0) expandOneJ(gp, pq, 0, -1, 0, targetValue, targetLocation, initial);
+		if (gp.y < m_grid->y - 1) expandOneJ(gp, pq, 0, 1, 0, targetValue, targetLocation, initial);
 		if (m_bothSidesNow) {
-			if (gp.z > 0) expandOneJ(gp, pq, 0, 0, -1, targetValue, targetLocation, already);
-			if (gp.z < m_grid->z - 1) expandOneJ(gp, pq, 0, 0, 1, targetValue, targetLocation, already);
+			if (gp.z > 0) expandOneJ(gp, pq, 0, 0, -1, targetValue, targetLocation, initial);
+			if (gp.z < m_grid->z - 1) expandOneJ(gp, pq, 0, 0, 1, targetValue, targetLocation, initial);
 		}
 	}
 
@@ -2914,16 +3969,15 @@ GridPoint MazeRouter::lookForJumper(GridPoint initial, GridValue targetValue, QP
 	return failed;
 }
 
-void MazeRouter::expandOneJ(GridPoint & gridPoint, std::priority_queue<GridPoint> & pq, int dx, int dy, int dz, GridValue targetValue, QPoint targetLocation, QSet<int> & already)
+void MazeRouter::expandOneJ(GridPoint & gridPoint, std::priority_queue<GridPoint> & pq, int dx, int dy, int dz, GridValue targetValue, QPoint targetLocation, const GridPoint & initial)
 {
 	GridPoint next;
 	next.x = gridPoint.x + dx;
 	next.y = gridPoint.y + dy;
 	next.z = gridPoint.z + dz;
-	int gpi = gridPointInt(m_grid, next);
-	if (already.contains(gpi)) return;
+	if (m_jumperRadius > 0 && (qAbs(next.x - initial.x) > m_jumperRadius || qAbs(next.y - initial.y) > m_jumperRadius)) return;
+	if (!visitCell(m_jumperVisited, gridPointInt(m_grid, next))) return;
 
-	already.insert(gpi);
 	GridValue nextval = m_grid->at(next.x, next.y, next.z);
 	if (nextval == GridPartObstacle || nextval == GridBoardObstacle || nextval == GridSource || nextval == GridTempObstacle || nextval == GridTarget || nextval == GridAvoid) return;
 	else if (nextval == 0) return;
@@ -2945,251 +3999,306 @@ void MazeRouter::expandOneJ(GridPoint & gridPoint, std::priority_queue<GridPoint
 	pq.push(next);
 }
 
-void MazeRouter::removeOffBoardAnd(bool isPCBType, bool removeSingletons, bool bothSides) {
-	QRectF boardRect;
-	if (m_board) boardRect = m_board->sceneBoundingRect();
-	// remove any vias or jumperItems that will be deleted, also remove off-board items
-	for (int i = m_allPartConnectorItems.count() - 1; i >= 0; i--) {
-		QList<ConnectorItem *> * connectorItems = m_allPartConnectorItems.at(i);
-		if (removeSingletons) {
-			if (connectorItems->count() < 2) {
-				connectorItems->clear();
-			}
-			else if (connectorItems->count() == 2) {
-				if (connectorItems->at(0) == connectorItems->at(1)->getCrossLayerConnectorItem()) {
-					connectorItems->clear();
+void MazeRouter::optimizeTraces(QList<int> & order, QMultiHash<int, QList< QPointer<TraceWire> > > & bundles,
+                                QMultiHash<int, Via *> & vias, QMultiHash<int, JumperItem *> & jumperItems, QMultiHash<int, SymbolPaletteItem *> & netLabels,
+                                NetList & netList, ConnectionThing & connectionThing)
+{
+	// nets are optimized in order, each against the current traces of all the others.  Shortcuts never leave
+	// the bounds of a net's own traces, so two nets whose bounds are apart cannot see each other's changes:
+	// such nets are searched at the same time on worker threads, then their wires are edited here in order.
+	// The result is the same as optimizing one net at a time.
+	QList<ViewLayer::ViewLayerPlacement> layerSpecs;
+	layerSpecs << ViewLayer::NewBottom;
+	if (m_bothSidesNow) layerSpecs << ViewLayer::NewTop;
+	QPointF topLeft = m_maxRect.topLeft();
+
+	QVector<OptimizeNet> optimizeNets(order.count());
+	for (int i = 0; i < order.count(); i++) {
+		OptimizeNet & optimizeNet = optimizeNets[i];
+		int netIndex = order.at(i);
+		optimizeNet.netIndex = netIndex;
+		optimizeNet.net = netList.nets.at(netIndex);
+		snapshotTraces(optimizeNet, bundles, layerSpecs);
+
+		Q_FOREACH (Via * via, vias.values(netIndex)) {
+			optimizeNet.circleCenters << (via->connectorItem()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
+			optimizeNet.circleRadii << ((via->connectorItem()->sceneBoundingRect().width() / 2) + m_keepoutPixels) * OptimizeFactor;
+		}
+		Q_FOREACH (JumperItem * jumperItem, jumperItems.values(netIndex)) {
+			double rad = ((jumperItem->connector0()->sceneBoundingRect().width() / 2) + m_keepoutPixels) * OptimizeFactor;
+			optimizeNet.circleCenters << (jumperItem->connector0()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
+			optimizeNet.circleRadii << rad;
+			optimizeNet.circleCenters << (jumperItem->connector1()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
+			optimizeNet.circleRadii << rad;
+		}
+		Q_FOREACH (SymbolPaletteItem * netLabel, netLabels.values(netIndex)) {
+			QRectF r = netLabel->sceneBoundingRect();
+			optimizeNet.rects << QRectF((r.left() - topLeft.x() - m_keepoutPixels) * OptimizeFactor,
+			                            (r.top() - topLeft.y() - m_keepoutPixels) * OptimizeFactor,
+			                            (r.width() + m_keepoutPixels) * OptimizeFactor,
+			                            (r.height() + m_keepoutPixels) * OptimizeFactor);
+		}
+	}
+
+	// each thread renders obstacles into its own image from its own copy of the master documents
+	QList< QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> > threadDocs;
+	QList<QImage *> threadImages;
+	threadDocs << m_masterDocs;
+	threadImages << m_spareImage;
+
+	int progress = order.count();
+	QList<int> pending;
+	for (int i = 0; i < order.count(); i++) pending << i;
+
+	while (!pending.isEmpty()) {
+		// a net may only go ahead of the nets before it when its bounds are apart from all of theirs
+		QList<int> wave;
+		QList<QRectF> earlier;
+		for (int i = 0; i < pending.count() && wave.count() < m_optimizeThreads; i++) {
+			QRectF bounds = optimizeNets.at(pending.at(i)).bounds;
+			bool apart = true;
+			Q_FOREACH (QRectF r, earlier) {
+				if (r.intersects(bounds)) {
+					apart = false;
+					break;
 				}
 			}
+			earlier << bounds;
+			if (apart) wave << pending.at(i);
 		}
-		for (int j = connectorItems->count() - 1; j >= 0; j--) {
-			ConnectorItem * connectorItem = connectorItems->at(j);
-			//connectorItem->debugInfo("pci");
-			bool doRemove = false;
-			if (connectorItem->attachedToItemType() == ModelPart::Via) {
-				Via * via = qobject_cast<Via *>(connectorItem->attachedTo()->layerKinChief());
-				doRemove = via->getAutoroutable();
-			}
-			else if (connectorItem->attachedToItemType() == ModelPart::Jumper) {
-				auto * jumperItem = qobject_cast<JumperItem *>(connectorItem->attachedTo()->layerKinChief());
-				doRemove = jumperItem->getAutoroutable();
+		Q_FOREACH (int i, wave) {
+			pending.removeOne(i);
+		}
+
+		while (threadDocs.count() < wave.count()) {
+			QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> docs;
+			for (auto it = m_masterDocs.constBegin(); it != m_masterDocs.constEnd(); ++it) {
+				docs.insert(it.key(), new QDomDocument(it.value()->cloneNode(true).toDocument()));
 			}
-			else if (connectorItem->attachedToItemType() == ModelPart::Symbol) {
-				auto * netLabel = qobject_cast<SymbolPaletteItem *>(connectorItem->attachedTo()->layerKinChief());
-				doRemove = netLabel->getAutoroutable() && netLabel->isOnlyNetLabel();
+			threadDocs << docs;
+			threadImages << new QImage(m_boardImage->size(), QImage::Format_Mono);
+		}
+
+		Q_FOREACH (int i, wave) {
+			prepareSegments(optimizeNets[i], bundles, layerSpecs, connectionThing);
+		}
+
+		if (wave.count() == 1) {
+			findShortcuts(optimizeNets[wave.first()], optimizeNets, threadDocs.first(), threadImages.first(), layerSpecs);
+		}
+		else {
+			QList< QFuture<void> > futures;
+			const QVector<OptimizeNet> & snapshot = optimizeNets;
+			for (int t = 0; t < wave.count(); t++) {
+				OptimizeNet * optimizeNet = &optimizeNets[wave.at(t)];
+				const QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> * docs = &threadDocs.at(t);
+				QImage * image = threadImages.at(t);
+				futures << QtConcurrent::run([this, optimizeNet, &snapshot, docs, image, &layerSpecs]() {
+					findShortcuts(*optimizeNet, snapshot, *docs, image, layerSpecs);
+				});
 			}
-			if (!bothSides && connectorItem->attachedToViewLayerID() == ViewLayer::Copper1) doRemove = true;
-			if (!doRemove && isPCBType) {
-				if (!boardRect.contains(connectorItem->sceneBoundingRect())) {
-					doRemove = true;
+			Q_FOREACH (QFuture<void> future, futures) {
+				while (!future.isFinished()) {
+					ProcessEventBlocker::processEvents(200);
 				}
 			}
-			if (doRemove) {
-				connectorItems->removeAt(j);
+		}
+
+		Q_FOREACH (int i, wave) {
+			Q_EMIT setProgressValue(progress++);
+			OptimizeNet & optimizeNet = optimizeNets[i];
+			for (int s = 0; s < optimizeNet.segments.count(); s++) {
+				applyShortcuts(optimizeNet.segments[s], connectionThing);
 			}
+			optimizeNet.segments.clear();
+			snapshotTraces(optimizeNet, bundles, layerSpecs);
 		}
-		if (connectorItems->count() == 0) {
-			m_allPartConnectorItems.removeAt(i);
-			delete connectorItems;
+	}
+
+	for (int t = 1; t < threadDocs.count(); t++) {
+		Q_FOREACH (QDomDocument * doc, threadDocs.at(t)) {
+			delete doc;
 		}
+		delete threadImages.at(t);
 	}
 }
 
-void MazeRouter::optimizeTraces(QList<int> & order, QMultiHash<int, QList< QPointer<TraceWire> > > & bundles,
-                                QMultiHash<int, Via *> & vias, QMultiHash<int, JumperItem *> & jumperItems, QMultiHash<int, SymbolPaletteItem *> & netLabels,
-                                NetList & netList, ConnectionThing & connectionThing)
+void MazeRouter::snapshotTraces(OptimizeNet & optimizeNet, QMultiHash<int, QList< QPointer<TraceWire> > > & bundles, const QList<ViewLayer::ViewLayerPlacement> & layerSpecs)
 {
-	QList<ViewLayer::ViewLayerPlacement> layerSpecs;
-	layerSpecs << ViewLayer::NewBottom;
-	if (m_bothSidesNow) layerSpecs << ViewLayer::NewTop;
-	QRectF r2(0, 0, m_boardImage->width(), m_boardImage->height());
 	QPointF topLeft = m_maxRect.topLeft();
+	optimizeNet.bounds = QRectF();
+	for (int layer = 0; layer < layerSpecs.count(); layer++) {
+		optimizeNet.traces[layer].clear();
+		optimizeNet.traceWidths[layer].clear();
+	}
 
-	//QList<int> order2(order);
-	//order2.append(order);
+	Q_FOREACH(QList< QPointer<TraceWire> > bundle, bundles.values(optimizeNet.netIndex)) {
+		Q_FOREACH (TraceWire * traceWire, bundle) {
+			if (traceWire == nullptr) continue;
 
-	int progress = order.count();
+			int layer = layerSpecs.indexOf(ViewLayer::specFromID(traceWire->viewLayerID()));
+			if (layer < 0) continue;
 
-	Q_FOREACH (int netIndex, order) {
-		Q_EMIT setProgressValue(progress++);
-		Net * net = netList.nets.at(netIndex);
-		Q_FOREACH (ViewLayer::ViewLayerPlacement layerSpec, layerSpecs) {
-			fastCopy(m_boardImage, m_spareImage);
+			QPointF p1 = traceWire->connector0()->sceneAdjustedTerminalPoint(nullptr);
+			QPointF p2 = traceWire->connector1()->sceneAdjustedTerminalPoint(nullptr);
+			double width = traceWire->width() + m_keepoutPixels + m_keepoutPixels;
+			optimizeNet.traces[layer] << QLineF((p1 - topLeft) * OptimizeFactor, (p2 - topLeft) * OptimizeFactor);
+			optimizeNet.traceWidths[layer] << width * OptimizeFactor;
 
-			QDomDocument * masterDoc = m_masterDocs.value(layerSpec);
-			//QString before = masterDoc->toString();
-			Markers markers;
-			initMarkers(markers, m_pcbType);
-			NetElements netElements;
-			DRC::splitNetPrep(masterDoc, *(net->net), markers, netElements.net, netElements.alsoNet, netElements.notNet, true);
-			Q_FOREACH (QDomElement element, netElements.net) {
-				element.setTagName("g");
+			// wide enough to cover both this net's candidate lines and its pen when others render it
+			QRectF r = QRectF(p1, p2).normalized().adjusted(-width - 1, -width - 1, width + 1, width + 1);
+			optimizeNet.bounds |= r;
+		}
+	}
+}
+
+void MazeRouter::prepareSegments(OptimizeNet & optimizeNet, QMultiHash<int, QList< QPointer<TraceWire> > > & bundles, const QList<ViewLayer::ViewLayerPlacement> & layerSpecs, ConnectionThing & connectionThing)
+{
+	// identify traces in bundles with source and dest that cannot be deleted
+	optimizeNet.segments.clear();
+	for (int layer = 0; layer < layerSpecs.count(); layer++) {
+		Q_FOREACH(QList< QPointer<TraceWire> > bundle, bundles.values(optimizeNet.netIndex)) {
+			for (int i = bundle.count() - 1; i >= 0; i--) {
+				TraceWire * traceWire = bundle.at(i);
+				if (traceWire == nullptr) bundle.removeAt(i);
 			}
-			Q_FOREACH (QDomElement element, netElements.alsoNet) {
-				element.setTagName("g");
+			if (bundle.count() == 0) continue;
+
+			if (ViewLayer::specFromID(bundle.at(0)->viewLayerID()) != layerSpecs.at(layer)) {
+				// all wires in a single bundle are in the same layer
+				continue;
 			}
 
-			ItemBase::renderOne(masterDoc, m_spareImage, r2);
+			QVector<QPointF> points(bundle.count() + 1, QPointF(0, 0));
+			QVector<bool> splits(bundle.count() + 1, false);
+			int index = 0;
+			Q_FOREACH (TraceWire * traceWire, bundle) {
+				if (connectionThing.multi(traceWire->connector0())) splits.replace(index, true);
+				points.replace(index, traceWire->connector0()->sceneAdjustedTerminalPoint(nullptr));
+				index++;
+				if (connectionThing.multi(traceWire->connector1())) splits.replace(index, true);
+				points.replace(index, traceWire->connector1()->sceneAdjustedTerminalPoint(nullptr));
+			}
 
-			//QString after = masterDoc->toString();
+			splits.replace(0, false);
+			splits.replace(splits.count() - 1, true);
 
-			Q_FOREACH (QDomElement element, netElements.net) {
-				element.setTagName(element.attribute("former"));
-				element.removeAttribute("net");
-			}
-			Q_FOREACH (QDomElement element, netElements.alsoNet) {
-				element.setTagName(element.attribute("former"));
-				element.removeAttribute("net");
-			}
-			Q_FOREACH (QDomElement element, netElements.notNet) {
-				element.removeAttribute("net");
+			OptimizeSegment segment;
+			segment.layer = layer;
+			for (int pix = 0; pix < points.count(); pix++) {
+				segment.points << points.at(pix);
+				if (pix < points.count() - 1) {
+					segment.wires << bundle.at(pix);
+				}
+				if (splits.at(pix)) {
+					// nothing to shorten with fewer than two wires
+					if (segment.points.count() > 2) {
+						segment.width = segment.wires.at(0)->width();
+						optimizeNet.segments << segment;
+					}
+					segment.points.clear();
+					segment.wires.clear();
+					segment.points << points.at(pix);
+					if (pix < points.count() - 1) segment.wires << bundle.at(pix);
+				}
 			}
+		}
+	}
+}
+
+void MazeRouter::findShortcuts(OptimizeNet & optimizeNet, const QVector<OptimizeNet> & optimizeNets, const QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> & masterDocs, QImage * obstacles, const QList<ViewLayer::ViewLayerPlacement> & layerSpecs) const
+{
+	// runs on a worker thread: only reads the snapshot, the master documents of this thread, and the board image
+	QRectF r2(0, 0, m_boardImage->width(), m_boardImage->height());
+	for (int layer = 0; layer < layerSpecs.count(); layer++) {
+		bool any = false;
+		for (int s = 0; s < optimizeNet.segments.count() && !any; s++) {
+			any = (optimizeNet.segments.at(s).layer == layer);
+		}
+		if (!any) continue;
 
-			QPainter painter;
-			painter.begin(m_spareImage);
-			QPen pen = painter.pen();
-			pen.setColor(0xff000000);
+		fastCopy(m_boardImage, obstacles);
 
-			QBrush brush(QColor(0xff000000));
-			painter.setBrush(brush);
-			Q_FOREACH (int otherIndex, order) {
-				if (otherIndex == netIndex) continue;
+		QDomDocument * masterDoc = masterDocs.value(layerSpecs.at(layer));
+		Markers markers;
+		initMarkers(markers, m_pcbType);
+		NetElements netElements;
+		DRC::splitNetPrep(masterDoc, *(optimizeNet.net->net), markers, netElements.net, netElements.alsoNet, netElements.notNet, true);
+		Q_FOREACH (QDomElement element, netElements.net) {
+			element.setTagName("g");
+		}
+		Q_FOREACH (QDomElement element, netElements.alsoNet) {
+			element.setTagName("g");
+		}
 
-				Q_FOREACH(QList< QPointer<TraceWire> > bundle, bundles.values(otherIndex)) {
-					if (bundle.count() == 0) continue;
-					if (ViewLayer::specFromID(bundle.at(0)->viewLayerID()) != layerSpec) continue;
+		ItemBase::renderOne(masterDoc, obstacles, r2);
 
-					pen.setWidthF((bundle.at(0)->width() + m_keepoutPixels + m_keepoutPixels) * OptimizeFactor);
-					painter.setPen(pen);
-					Q_FOREACH (TraceWire * traceWire, bundle) {
-						if (traceWire == nullptr) continue;
+		Q_FOREACH (QDomElement element, netElements.net) {
+			element.setTagName(element.attribute("former"));
+			element.removeAttribute("net");
+		}
+		Q_FOREACH (QDomElement element, netElements.alsoNet) {
+			element.setTagName(element.attribute("former"));
+			element.removeAttribute("net");
+		}
+		Q_FOREACH (QDomElement element, netElements.notNet) {
+			element.removeAttribute("net");
+		}
 
-						QPointF p1 = (traceWire->connector0()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
-						QPointF p2 = (traceWire->connector1()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
-						painter.drawLine(p1, p2);
-					}
-				}
+		QPainter painter;
+		painter.begin(obstacles);
+		QPen pen = painter.pen();
+		pen.setColor(0xff000000);
 
-				painter.setPen(Qt::NoPen);
+		QBrush brush(QColor(0xff000000));
+		painter.setBrush(brush);
+		// other threads are writing the segments of their own nets, so read the snapshot in place
+		for (int n = 0; n < optimizeNets.count(); n++) {
+			const OptimizeNet & other = optimizeNets.at(n);
+			if (other.netIndex == optimizeNet.netIndex) continue;
 
-				Q_FOREACH (Via * via, vias.values(otherIndex)) {
-					QPointF p = (via->connectorItem()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
-					double rad = ((via->connectorItem()->sceneBoundingRect().width() / 2) + m_keepoutPixels) * OptimizeFactor;
-					painter.drawEllipse(p, rad, rad);
-				}
-				Q_FOREACH (JumperItem * jumperItem, jumperItems.values(otherIndex)) {
-					QPointF p = (jumperItem->connector0()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
-					double rad = ((jumperItem->connector0()->sceneBoundingRect().width() / 2) + m_keepoutPixels) * OptimizeFactor;
-					painter.drawEllipse(p, rad, rad);
-					p = (jumperItem->connector1()->sceneAdjustedTerminalPoint(nullptr) - topLeft) * OptimizeFactor;
-					painter.drawEllipse(p, rad, rad);
-				}
-				Q_FOREACH (SymbolPaletteItem * netLabel, netLabels.values(otherIndex)) {
-					QRectF r = netLabel->sceneBoundingRect();
-					painter.drawRect((r.left() - topLeft.x() - m_keepoutPixels) * OptimizeFactor,
-					                 (r.top() - topLeft.y() - m_keepoutPixels) * OptimizeFactor,
-					                 (r.width() + m_keepoutPixels) * OptimizeFactor,
-					                 (r.height() + m_keepoutPixels) * OptimizeFactor);
-				}
+			for (int i = 0; i < other.traces[layer].count(); i++) {
+				pen.setWidthF(other.traceWidths[layer].at(i));
+				painter.setPen(pen);
+				painter.drawLine(other.traces[layer].at(i));
 			}
 
-			Q_FOREACH (SymbolPaletteItem * netLabel, netLabels.values(netIndex)) {
-				QRectF r = netLabel->sceneBoundingRect();
-				painter.drawRect((r.left() - topLeft.x() - m_keepoutPixels) * OptimizeFactor,
-				                 (r.top() - topLeft.y() - m_keepoutPixels) * OptimizeFactor,
-				                 (r.width() + m_keepoutPixels) * OptimizeFactor,
-				                 (r.height() + m_keepoutPixels) * OptimizeFactor);
+			painter.setPen(Qt::NoPen);
+			for (int i = 0; i < other.circleCenters.count(); i++) {
+				painter.drawEllipse(other.circleCenters.at(i), other.circleRadii.at(i), other.circleRadii.at(i));
 			}
+			for (int i = 0; i < other.rects.count(); i++) {
+				painter.drawRect(other.rects.at(i));
+			}
+		}
+
+		Q_FOREACH (QRectF r, optimizeNet.rects) {
+			painter.drawRect(r);
+		}
 
-			painter.end();
+		painter.end();
 
 #ifndef QT_NO_DEBUG
-			//m_spareImage->save(FolderUtils::getUserDataStorePath("") + QString("/optimizeObstacles%1_%2.png").arg(netIndex, 2, 10, QChar('0')).arg(layerSpec));
+		//obstacles->save(FolderUtils::getUserDataStorePath("") + QString("/optimizeObstacles%1_%2.png").arg(optimizeNet.netIndex, 2, 10, QChar('0')).arg(layerSpecs.at(layer)));
 #endif
 
-			// finally test all combinations of each bundle
-			//      identify traces in bundles with source and dest that cannot be deleted
-			//      remove source/dest (delete and keep QPointers?)
-			//          schematic view must replace with two 90-degree lines
-
-			Q_FOREACH(QList< QPointer<TraceWire> > bundle, bundles.values(netIndex)) {
-				if (bundle.count() == 0) continue;
-
-				for (int i = bundle.count() - 1; i >= 0; i--) {
-					TraceWire * traceWire = bundle.at(i);
-					if (traceWire == nullptr) bundle.removeAt(i);
-				}
-
-				if (ViewLayer::specFromID(bundle.at(0)->viewLayerID()) != layerSpec) {
-					// all wires in a single bundle are in the same layer
-					continue;
-				}
-
-				/*
-				QList<ConnectorItem *> tos = connectionThing.values(bundle.first()->connector0());
-				foreach (ConnectorItem * to, tos) {
-				    if (to->attachedToItemType() == ModelPart::Via) {
-				        to->debugInfo("start hooked to via");
-				    }
-				}
-				tos = connectionThing.values(bundle.last()->connector1());
-				foreach (ConnectorItem * to, tos) {
-				    if (to->attachedToItemType() == ModelPart::Via) {
-				        to->debugInfo("end hooked to via");
-				    }
-				}
-				*/
-
-				QVector<QPointF> points(bundle.count() + 1, QPointF(0, 0));
-				QVector<bool> splits(bundle.count() + 1, false);
-				int index = 0;
-				Q_FOREACH (TraceWire * traceWire, bundle) {
-					if (connectionThing.multi(traceWire->connector0())) splits.replace(index, true);
-					points.replace(index, traceWire->connector0()->sceneAdjustedTerminalPoint(nullptr));
-					index++;
-					if (connectionThing.multi(traceWire->connector1())) splits.replace(index, true);
-					points.replace(index, traceWire->connector1()->sceneAdjustedTerminalPoint(nullptr));
-				}
-
-				splits.replace(0, false);
-				splits.replace(splits.count() - 1, true);
-
-				QList<QPointF> pointsSoFar;
-				QList<TraceWire *> bundleSoFar;
-				int startIndex = 0;
-				for (int pix = 0; pix < points.count(); pix++) {
-					pointsSoFar << points.at(pix);
-					if (pix < points.count() - 1) {
-						bundleSoFar << bundle.at(pix);
-					}
-					if (splits.at(pix)) {
-						reducePoints(pointsSoFar, topLeft, bundleSoFar, startIndex, pix, connectionThing, netIndex, layerSpec);
-						pointsSoFar.clear();
-						bundleSoFar.clear();
-						pointsSoFar << points.at(pix);
-						if (pix < points.count() - 1) bundleSoFar << bundle.at(pix);
-						startIndex = pix;
-					}
-				}
-			}
+		// finally test all combinations of each bundle
+		for (int s = 0; s < optimizeNet.segments.count(); s++) {
+			OptimizeSegment & segment = optimizeNet.segments[s];
+			if (segment.layer == layer) reducePoints(segment, *obstacles);
 		}
 	}
 }
 
-void MazeRouter::reducePoints(QList<QPointF> & points, QPointF topLeft, QList<TraceWire *> & bundle, int startIndex, int endIndex, ConnectionThing & connectionThing, int netIndex, ViewLayer::ViewLayerPlacement layerSpec) {
-	Q_UNUSED(netIndex);
-	Q_UNUSED(layerSpec);
-#ifndef QT_NO_DEBUG
-	//int inc = 0;
-#endif
-	double width = bundle.at(0)->width() * OptimizeFactor;
-	for (int separation = endIndex - startIndex; separation > 1; separation--) {
+void MazeRouter::reducePoints(OptimizeSegment & segment, const QImage & obstacles) const {
+	// only records the shortcuts; points is kept in step with the wires applyShortcuts will edit
+	QPointF topLeft = m_maxRect.topLeft();
+	QList<QPointF> points = segment.points;
+	double width = segment.width * OptimizeFactor;
+	for (int separation = points.count() - 1; separation > 1; separation--) {
 		for (int ix = 0; ix < points.count() - separation; ix++) {
 			QPointF p1 = (points.at(ix) - topLeft) * OptimizeFactor;
 			QPointF p2 = (points.at(ix + separation) - topLeft) * OptimizeFactor;
-			double minX = qMax(0.0, qMin(p1.x(), p2.x()) - width);
-			double minY = qMax(0.0, qMin(p1.y(), p2.y()) - width);
-			double maxX = qMin(m_spareImage2->width() - 1.0, qMax(p1.x(), p2.x()) + width);
-			double maxY = qMin(m_spareImage2->height() - 1.0, qMax(p1.y(), p2.y()) + width);
 			int corners = 1;
 			if (!m_pcbType) {
 				if (qAbs(p1.x() - p2.x()) >= 1 && qAbs(p1.y() - p2.y()) >= 1) {
@@ -3198,51 +4307,14 @@ void MazeRouter::reducePoints(QList<QPointF> & points, QPointF topLeft, QList<Tr
 				}
 			}
 			for (int corner = 0; corner < corners; corner++) {
-				m_spareImage2->fill(0xffffffff);
-				QPainter painter;
-				painter.begin(m_spareImage2);
-				QPen pen = painter.pen();
-				pen.setColor(0xff000000);
-				pen.setWidthF(width);
-				painter.setPen(pen);
-				if (corners == 1) {
-					painter.drawLine(p1, p2);
-				}
-				else {
-					if (corner == 0) {
-						// vertical then horizontal
-						painter.drawLine(p1.x(), p1.y(), p1.x(), p2.y());
-						painter.drawLine(p1.x(), p2.y(), p2.x(), p2.y());
-					}
-					else {
-						// horizontal then vertical
-						painter.drawLine(p1.x(), p1.y(), p2.x(), p1.y());
-						painter.drawLine(p2.x(), p1.y(), p2.x(), p2.y());
-					}
-				}
-				painter.end();
-#ifndef QT_NO_DEBUG
-				//m_spareImage2->save(FolderUtils::getUserDataStorePath("") + QString("/optimizeTrace%1_%2_%3.png").arg(netIndex,2,10,QChar('0')).arg(layerSpec).arg(inc++,3,10,QChar('0')));
-#endif
-
-				bool overlaps = false;
-				for (int y = minY; y <= maxY && !overlaps; y++) {
-					for (int x = minX; x <= maxX && !overlaps; x++) {
-						if (m_spareImage->pixel(x, y) == 0xffffffff) continue;
-						if (m_spareImage2->pixel(x, y) == 0xffffffff) continue;
-						overlaps = true;
-					}
-				}
+				if (!shortcutFits(p1, p2, corners, corner, width, obstacles)) continue;
 
-				if (overlaps) continue;
-
-				TraceWire * traceWire = bundle.at(ix);
-				TraceWire * last = bundle.at(ix + separation - 1);
-				TraceWire * next = bundle.at(ix + 1);
-				QList<ConnectorItem *> newDests = connectionThing.values(last->connector1());
-				QPointF unop_p2 = (p2 / OptimizeFactor) + topLeft;
+				ReduceStep step;
+				step.ix = ix;
+				step.separation = separation;
+				step.corners = corners;
+				step.p2 = (p2 / OptimizeFactor) + topLeft;
 				if (corners == 2) {
-					TraceWire * afterNext = bundle.at(ix + 2);
 					QPointF middle;
 					if (corner == 0) {
 						middle.setX(p1.x());
@@ -3252,50 +4324,132 @@ void MazeRouter::reducePoints(QList<QPointF> & points, QPointF topLeft, QList<Tr
 						middle.setX(p2.x());
 						middle.setY(p1.y());
 					}
-					middle = (middle / OptimizeFactor) + topLeft;
-					traceWire->setLineAnd(QLineF(QPointF(0, 0), middle - traceWire->pos()), traceWire->pos(), true);
-					traceWire->saveGeometry();
-					traceWire->update();
-					next->setLineAnd(QLineF(QPointF(0, 0), unop_p2 - middle), middle, true);
-					next->saveGeometry();
-					next->update();
-					Q_FOREACH (ConnectorItem * newDest, newDests) {
-						connectionThing.add(next->connector1(), newDest);
-					}
-					connectionThing.remove(next->connector1(), afterNext->connector0());
+					step.middle = (middle / OptimizeFactor) + topLeft;
 					for (int i = 1; i < separation - 1; i++) {
-						TraceWire * tw = bundle.takeAt(ix + 2);
-						connectionThing.remove(tw->connector0());
-						connectionThing.remove(tw->connector1());
-						ModelPart * modelPart = tw->modelPart();
-						delete tw;
-						modelPart->setParent(nullptr);
-						delete modelPart;
 						points.removeAt(ix + 2);
 					}
-					points.replace(ix + 1, middle);
+					points.replace(ix + 1, step.middle);
 				}
 				else {
-					traceWire->setLineAnd(QLineF(QPointF(0, 0), unop_p2 - traceWire->pos()), traceWire->pos(), true);
-					traceWire->saveGeometry();
-					traceWire->update();
-					Q_FOREACH (ConnectorItem * newDest, newDests) {
-						connectionThing.add(traceWire->connector1(), newDest);
-					}
-					connectionThing.remove(traceWire->connector1(), next->connector0());
 					for (int i = 0; i < separation - 1; i++) {
-						auto *tw = bundle.takeAt(ix + 1);
-						connectionThing.remove(tw->connector0());
-						connectionThing.remove(tw->connector1());
-						auto *modelPart = tw->modelPart();
-						delete tw;
-						modelPart->setParent(nullptr);
-						delete modelPart;
 						points.removeAt(ix + 1);
 					}
 				}
+				segment.steps << step;
 				break;
 			}
 		}
 	}
 }
+
+bool MazeRouter::shortcutFits(const QPointF & p1, const QPointF & p2, int corners, int corner, double width, const QImage & obstacles) const {
+	double minX = qMax(0.0, qMin(p1.x(), p2.x()) - width);
+	double minY = qMax(0.0, qMin(p1.y(), p2.y()) - width);
+	double maxX = qMin(obstacles.width() - 1.0, qMax(p1.x(), p2.x()) + width);
+	double maxY = qMin(obstacles.height() - 1.0, qMax(p1.y(), p2.y()) + width);
+	int x1 = minX;
+	int y1 = minY;
+	int x2 = maxX;
+	int y2 = maxY;
+	if (x2 < x1 || y2 < y1) return true;
+
+	// draw into an image covering just the test area; starting on a byte keeps its bits in line with the obstacles'
+	int left = x1 & ~7;
+	QImage trace(x2 - left + 1, y2 - y1 + 1, QImage::Format_Mono);
+	trace.fill(0xffffffff);
+	QPainter painter;
+	painter.begin(&trace);
+	painter.translate(-left, -y1);
+	QPen pen = painter.pen();
+	pen.setColor(0xff000000);
+	pen.setWidthF(width);
+	painter.setPen(pen);
+	if (corners == 1) {
+		painter.drawLine(p1, p2);
+	}
+	else {
+		if (corner == 0) {
+			// vertical then horizontal
+			painter.drawLine(p1.x(), p1.y(), p1.x(), p2.y());
+			painter.drawLine(p1.x(), p2.y(), p2.x(), p2.y());
+		}
+		else {
+			// horizontal then vertical
+			painter.drawLine(p1.x(), p1.y(), p2.x(), p1.y());
+			painter.drawLine(p2.x(), p1.y(), p2.x(), p2.y());
+		}
+	}
+	painter.end();
+
+	// a set bit is white when color 1 is white; flip the bytes so that set bits are black in both images
+	uchar obstacleFlip = (obstacles.color(1) == 0xffffffff) ? 0xff : 0;
+	uchar traceFlip = (trace.color(1) == 0xffffffff) ? 0xff : 0;
+	int firstByte = x1 >> 3;
+	int lastByte = x2 >> 3;
+	uchar firstMask = 0xff >> (x1 & 7);
+	uchar lastMask = 0xff << (7 - (x2 & 7));
+	for (int y = y1; y <= y2; y++) {
+		const uchar * obstacleLine = obstacles.constScanLine(y);
+		const uchar * traceLine = trace.constScanLine(y - y1) - (left >> 3);
+		for (int b = firstByte; b <= lastByte; b++) {
+			uchar mask = 0xff;
+			if (b == firstByte) mask &= firstMask;
+			if (b == lastByte) mask &= lastMask;
+			if ((obstacleLine[b] ^ obstacleFlip) & (traceLine[b] ^ traceFlip) & mask) return false;
+		}
+	}
+
+	return true;
+}
+
+void MazeRouter::applyShortcuts(OptimizeSegment & segment, ConnectionThing & connectionThing) {
+	QList<TraceWire *> & bundle = segment.wires;
+	Q_FOREACH (ReduceStep step, segment.steps) {
+		int ix = step.ix;
+		int separation = step.separation;
+		TraceWire * traceWire = bundle.at(ix);
+		TraceWire * last = bundle.at(ix + separation - 1);
+		TraceWire * next = bundle.at(ix + 1);
+		QList<ConnectorItem *> newDests = connectionThing.values(last->connector1());
+		if (step.corners == 2) {
+			TraceWire * afterNext = bundle.at(ix + 2);
+			traceWire->setLineAnd(QLineF(QPointF(0, 0), step.middle - traceWire->pos()), traceWire->pos(), true);
+			traceWire->saveGeometry();
+			traceWire->update();
+			next->setLineAnd(QLineF(QPointF(0, 0), step.p2 - step.middle), step.middle, true);
+			next->saveGeometry();
+			next->update();
+			Q_FOREACH (ConnectorItem * newDest, newDests) {
+				connectionThing.add(next->connector1(), newDest);
+			}
+			connectionThing.remove(next->connector1(), afterNext->connector0());
+			for (int i = 1; i < separation - 1; i++) {
+				TraceWire * tw = bundle.takeAt(ix + 2);
+				connectionThing.remove(tw->connector0());
+				connectionThing.remove(tw->connector1());
+				ModelPart * modelPart = tw->modelPart();
+				delete tw;
+				modelPart->setParent(nullptr);
+				delete modelPart;
+			}
+		}
+		else {
+			traceWire->setLineAnd(QLineF(QPointF(0, 0), step.p2 - traceWire->pos()), traceWire->pos(), true);
+			traceWire->saveGeometry();
+			traceWire->update();
+			Q_FOREACH (ConnectorItem * newDest, newDests) {
+				connectionThing.add(traceWire->connector1(), newDest);
+			}
+			connectionThing.remove(traceWire->connector1(), next->connector0());
+			for (int i = 0; i < separation - 1; i++) {
+				auto *tw = bundle.takeAt(ix + 1);
+				connectionThing.remove(tw->connector0());
+				connectionThing.remove(tw->connector1());
+				auto *modelPart = tw->modelPart();
+				delete tw;
+				modelPart->setParent(nullptr);
+				delete modelPart;
+			}
+		}
+	}
+}
@@ -32,9 +32,13 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QProgressDialog>
 #include <QUndoCommand>
 #include <QPointer>
+#include <QFuture>
+#include <QVariant>
 
 #include <limits>
+#include <memory>
 #include <queue>
+#include <vector>
 
 #include "../../viewgeometry.h"
 #include "../../viewlayer.h"
@@ -81,15 +85,26 @@ struct Trace {
 	Trace() = default;
 };
 
+Q_DECLARE_METATYPE(Trace)
+
 struct NetOrdering {
 	QList<int> order;
 };
 
+struct NetStats {
+	// counters for the last time a net was routed, logged for the best ordering
+	qint64 expansions = 0;
+	qint64 ns = 0;
+	int queuePeak = 0;                  // source plus target queue
+	int traceBackPoints = 0;
+};
+
 struct Score {
 	NetOrdering ordering;
 	QMultiHash<int, Trace> traces;
 	QHash<int, int> routedCount;
 	QHash<int, int> viaCount;
+	QHash<int, NetStats> netStats;
 	int totalRoutedCount = 0;
 	int totalViaCount = 0;
 	int reorderNet = -1;
@@ -106,25 +121,98 @@ struct Nearest {
 	ConnectorItem * jc = nullptr;
 };
 
+typedef quint32 GridCost;
+
 struct Grid {
-	/// @todo replace this with std::unique_ptr<GridValue[]>
-	GridValue * data = nullptr;
 	int x = 0;
 	int y = 0;
 	int z = 0;
 
 	Grid(int x, int y, int layers);
-    ~Grid();
+	~Grid();
 
 	GridValue at(int x, int y, int z) const;
+	bool isObstacle(int x, int y, int z) const;
 	void setAt(int x, int y, int z, GridValue value);
 	QList<QPoint> init(int x, int y, int z, int width, int height, const QImage &, GridValue value, bool collectPoints);
 	QList<QPoint> init4(int x, int y, int z, int width, int height, const QImage *, GridValue value, bool collectPoints);
 	void clear();
+	void clearCosts();
 	void copy(int fromIndex, int toIndex);
+	qint64 allocatedBytes() const;
+
+protected:
+	GridCost * tile(int x, int y, int z) const;
+	GridCost * makeTile(int x, int y, int z);
+	bool hasCosts(int y, int z) const;
+
+protected:
+	// board and part obstacles are packed into two bitplanes; everything else (expansion costs,
+	// source, target, avoid) lives in a 32-bit cost plane that is allocated a tile at a time
+	int m_wordsPerLayer = 0;
+	int m_tilesX = 0;
+	int m_tilesY = 0;
+	std::vector<quint64> m_boardObstacles;
+	std::vector<quint64> m_partObstacles;
+	std::vector< std::unique_ptr<GridCost[]> > m_tiles;
 };
 
 
+class GridQueue {
+	// priority queue of grid points waiting to be expanded: either the original binary heap,
+	// or a bucket queue over the integer qCost of a compact cell index (selectable for benchmarking)
+
+public:
+	enum Strategy {
+		HeapStrategy,
+		BucketStrategy
+	};
+
+public:
+	GridQueue() = default;
+
+	void setStrategy(Strategy, int gridX, int gridY);
+	void push(const GridPoint &);
+	GridPoint top();
+	void pop();
+	bool empty() const;
+	size_t size() const;
+	void clear();
+
+protected:
+	struct Entry {
+		quint32 cell;
+		GridCost baseCost;
+		uchar flags;
+	};
+
+	struct Outside {
+		quint64 priority;
+		Entry entry;
+
+		bool operator<(const Outside & other) const {
+			// make sure lower cost is first
+			return priority > other.priority;
+		}
+	};
+
+	void locateTop();
+	void rebase();
+	GridPoint toGridPoint(const Entry &, quint64 priority) const;
+
+protected:
+	Strategy m_strategy = HeapStrategy;
+	std::priority_queue<GridPoint> m_heap;
+	int m_gridX = 0;
+	int m_gridY = 0;
+	size_t m_count = 0;
+	quint64 m_base = 0;
+	int m_cursor = 0;
+	bool m_topOutside = false;
+	std::vector< std::vector<Entry> > m_buckets;            // a window of one bucket per integer cost, starting at m_base
+	std::priority_queue<Outside> m_outside;                 // entries below or above the window
+};
+
 struct NetElements {
 	QList<QDomElement> net;
 	QList<QDomElement> alsoNet;
@@ -136,8 +224,8 @@ struct RouteThing {
 	QRectF r4;
 	QList<ViewLayer::ViewLayerPlacement> layerSpecs;
 	Nearest nearest;
-	std::priority_queue<GridPoint> sourceQ;
-	std::priority_queue<GridPoint> targetQ;
+	GridQueue sourceQ;
+	GridQueue targetQ;
 	QPoint gridSourcePoint;
 	QPoint gridTargetPoint;
 	GridValue sourceValue;
@@ -149,6 +237,18 @@ struct RouteThing {
 	bool unrouted;
 	NetElements netElements[2];
 	QSet<int> avoids;
+	// two-level mode: fine expansion is held to a corridor of coarse cells found by a global pass;
+	// points that want to leave it are parked until the corridor turns out to be too tight
+	bool useCorridor = false;
+	bool deferPoint = false;
+	int corridorX = 0;
+	std::vector<uchar> corridor;
+	QList<GridPoint> sourceDeferred;
+	QList<GridPoint> targetDeferred;
+	// negotiated mode: extra step cost per cell (all layers), for other nets' traces and past congestion
+	std::vector<GridCost> congestion;
+	int queuePeak = 0;
+	int traceBackPoints = 0;
 };
 
 struct TraceThing {
@@ -172,6 +272,72 @@ struct ConnectionThing {
 	QList<ConnectorItem *> values(ConnectorItem * s);
 };
 
+struct ObstacleLayer {
+	// rasterized once per autoroute: a net's obstacle image is the static layer ANDed with every other net's crop
+	QImage staticObstacles;                 // everything that does not belong to a net being routed
+	QHash<int, QImage> nets;                // each routed net's own elements, cropped to their bounds
+	QHash<int, QPoint> offsets;             // top left of each crop in image pixels; x is a multiple of 32
+	QSet<int> uncached;                     // nets sharing elements with another net are rendered as before
+};
+
+struct ObstacleCache {
+	ObstacleLayer layers[2];
+};
+
+struct ReduceStep {
+	// one shortcut accepted by reducePoints, replayed on the wires by applyShortcuts
+	int ix;
+	int separation;
+	int corners;
+	QPointF middle;                         // scene coordinates; only when corners == 2
+	QPointF p2;                             // scene coordinates
+};
+
+struct OptimizeSegment {
+	// the wires of a bundle between two splits
+	int layer = 0;                          // index into the optimized layer specs
+	double width = 0;
+	QList<QPointF> points;                  // scene coordinates
+	QList<TraceWire *> wires;               // only touched on the GUI thread
+	QList<ReduceStep> steps;
+};
+
+struct OptimizeNet {
+	// geometry copied on the GUI thread, so the shortcut search can run on another one
+	int netIndex = -1;
+	Net * net = nullptr;
+	QRectF bounds;                          // scene bounds of the net's traces, plus keepout
+	QList<QLineF> traces[2];                // image pixels, per layer
+	QList<double> traceWidths[2];           // pen widths including keepout
+	QList<QPointF> circleCenters;           // vias and jumper ends
+	QList<double> circleRadii;
+	QList<QRectF> rects;                    // net labels
+	QList<OptimizeSegment> segments;
+};
+
+struct RouterMetrics {
+	// wall-clock nanoseconds per phase; makeMasters and route include time spent on worker threads
+	qint64 makeMastersNs = 0;
+	qint64 routeNs = 0;                 // excluding traceBack
+	qint64 traceBackNs = 0;
+	qint64 optimizeTracesNs = 0;
+	qint64 createTracesNs = 0;          // excluding optimizeTraces
+	qint64 expansions = 0;
+	qint64 peakGridBytes = 0;           // routing grids alive at once, including workers'
+	qint64 queueHighWater = 0;          // largest source plus target queue of any one route
+	qint64 traceBackPoints = 0;
+	QList<qint64> roundNs;              // wall clock per round of the ordering search
+	int rounds = 0;
+	int totalToRoute = 0;
+	int routedCount = 0;
+	int viaCount = 0;
+	bool completed = false;
+
+	void add(const RouterMetrics &);
+	double cellsPerSecond() const;
+	QString summary() const;
+};
+
 typedef bool (*JumperWillFitFunction)(GridPoint &, const Grid *, int halfSize);
 typedef double (*CostFunction)(const QPoint & p1, const QPoint & p2);
 
@@ -186,12 +352,31 @@ public:
 	~MazeRouter();
 
 	void start();
+	// start() in three steps, so the searches of several routers can run at once:
+	// a true beginRouting() must be followed by polling searchFinished() and one finishRouting()
+	bool beginRouting();
+	bool searchFinished();
+	void finishRouting();
+	void overrideSettings(const QHash<QString, QVariant> &);
+	const RouterMetrics & metrics() const;
+
+public:
+	static const QString ParallelOrderingsName;
+	static const QString QueueStrategyName;
+	static const QString CoarseRoutingName;
+	static const QString OptimizeThreadsName;
+	static const QString NegotiatedRoutingName;
+	static const QString JumperRadiusName;
 
 protected:
+	explicit MazeRouter(const MazeRouter * prototype);   // worker for parallel orderings
+
 	void setUpWidths(double width);
 	int findPinsWithin(QList<ConnectorItem *> * net);
 	bool makeBoard(QImage *, double keepout, const QRectF & r);
 	bool makeMasters(QString &);
+	void makeObstacleCache(NetList &, const QRectF & r4);
+	bool compositeObstacles(int z, int netIndex, QImage *);
 	bool routeNets(NetList &, bool makeJumper, Score & currentScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings);
 	bool routeOne(bool makeJumper, Score & currentScore, int netIndex, RouteThing &, QList<NetOrdering> & allOrderings);
 	void findNearestPair(QList< QList<ConnectorItem *> > & subnets, Nearest &);
@@ -200,6 +385,8 @@ protected:
 	QList<GridPoint> route(RouteThing &, int & viaCount);
 	void expand(GridPoint &, RouteThing &);
 	void expandOne(GridPoint &, RouteThing &, int dx, int dy, int dz, bool crossLayer);
+	bool makeCorridor(RouteThing &);
+	bool releaseCorridor(RouteThing &);
 	bool viaWillFit(GridPoint &, Grid * grid);
 	QList<GridPoint> traceBack(GridPoint, Grid *, int & viaCount, GridValue sourceValue, GridValue targetValue);
 	GridPoint traceBackOne(GridPoint &, Grid *, int dx, int dy, int dz, GridValue sourceValue, GridValue targetValue);
@@ -209,10 +396,17 @@ protected:
 	void clearExpansion(Grid * grid);
 	void prepSourceAndTarget(QDomDocument * masterdoc, RouteThing &, QList< QList<ConnectorItem *> > & subnets, int z, ViewLayer::ViewLayerPlacement);
 	bool moveBack(Score & currentScore, int index, QList<NetOrdering> & allOrderings);
+	void routeOrderings(NetList &, Score & currentScore, Score & bestScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings, int firstRun, int runCount);
+	int searchOrderings(NetList &, Score & bestScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings, const NetOrdering & initialOrdering);
+	int negotiateNets(NetList &, Score & bestScore, const QSizeF gridSize, QList<NetOrdering> & allOrderings, const NetOrdering & initialOrdering);
+	QSet<int> congestedNets(Score &, bool raiseHistory);
+	QVector<int> footprint(const Trace &) const;
+	void removeNetTraces(Score &, int netIndex);
 	void displayTrace(Trace &);
 	void initTraceDisplay();
 	void traceObstacles(QList<Trace> & traces, int netIndex, Grid * grid, int ikeepout);
 	void traceAvoids(QList<Trace> & traces, int netIndex, RouteThing & routeThing);
+	void traceCongestion(QList<Trace> & traces, int netIndex, RouteThing & routeThing);
 	bool routeNext(bool makeJumper, RouteThing &, QList< QList<ConnectorItem *> > & subnets, Score & currentScore, int netIndex, QList<NetOrdering> & allOrderings);
 	void cleanUpNets(NetList &);
 	void createTraces(NetList & netList, Score & bestScore, QUndoCommand * parentCommand);
@@ -222,7 +416,6 @@ protected:
 	void removeStep(int ix, QList<GridPoint> & gridPoints);
 	ConnectorItem * findAnchor(GridPoint gp, TraceThing &, Net * net, QPointF & p, bool & onTrace, ConnectorItem * already);
 	ConnectorItem * findAnchor(GridPoint gp, const QRectF &, TraceThing &, Net * net, QPointF & p, bool & onTrace, ConnectorItem * already);
-	void addConnectionToUndo(ConnectorItem * from, ConnectorItem * to, QUndoCommand * parentCommand);
 	void addViaToUndo(Via *, QUndoCommand * parentCommand);
 	void addJumperToUndo(JumperItem *, QUndoCommand * parentCommand);
 	void routeJumper(int netIndex, RouteThing &, Score & currentScore);
@@ -230,15 +423,26 @@ protected:
 	SymbolPaletteItem * makeNetLabel(GridPoint & center, SymbolPaletteItem * pairedNetLabel, uchar traceFlags);
 	void addNetLabelToUndo(SymbolPaletteItem * netLabel, QUndoCommand * parentCommand);
 	GridPoint lookForJumper(GridPoint initial, GridValue targetValue, QPoint targetLocation);
-	void expandOneJ(GridPoint & gridPoint, std::priority_queue<GridPoint> & pq, int dx, int dy, int dz, GridValue targetValue, QPoint targetLocation, QSet<int> & already);
-	void removeOffBoardAnd(bool isPCBType, bool removeSingletons, bool bothSides);
+	void expandOneJ(GridPoint & gridPoint, std::priority_queue<GridPoint> & pq, int dx, int dy, int dz, GridValue targetValue, QPoint targetLocation, const GridPoint & initial);
 	void optimizeTraces(QList<int> & order, QMultiHash<int, QList< QPointer<TraceWire> > > &, QMultiHash<int, Via *> &, QMultiHash<int, JumperItem *> &, QMultiHash<int, SymbolPaletteItem *> &, NetList &, ConnectionThing &);
-	void reducePoints(QList<QPointF> & points, QPointF topLeft, QList<TraceWire *> & bundle, int startIndex, int endIndex, ConnectionThing &, int netIndex, ViewLayer::ViewLayerPlacement);
+	void snapshotTraces(OptimizeNet &, QMultiHash<int, QList< QPointer<TraceWire> > > &, const QList<ViewLayer::ViewLayerPlacement> &);
+	void prepareSegments(OptimizeNet &, QMultiHash<int, QList< QPointer<TraceWire> > > &, const QList<ViewLayer::ViewLayerPlacement> &, ConnectionThing &);
+	void findShortcuts(OptimizeNet &, const QVector<OptimizeNet> &, const QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> & masterDocs, QImage * obstacles, const QList<ViewLayer::ViewLayerPlacement> &) const;
+	void reducePoints(OptimizeSegment &, const QImage & obstacles) const;
+	bool shortcutFits(const QPointF & p1, const QPointF & p2, int corners, int corner, double width, const QImage & obstacles) const;
+	void applyShortcuts(OptimizeSegment &, ConnectionThing &);
+	void logNetStats(const NetList &, const Score &);
 
 public Q_SLOTS:
 	void incCommandProgress();
 	void setMaxCycles(int);
 
+protected Q_SLOTS:
+	void showTraces(const QList<Trace> &);
+
+Q_SIGNALS:
+	void bestTraces(const QList<Trace> &);      // from the search worker, for the preview
+
 protected:
 	LayerList m_viewLayerIDs;
 	QHash<ViewLayer::ViewLayerPlacement, QDomDocument *> m_masterDocs;
@@ -252,7 +456,6 @@ protected:
 	QImage * m_displayImage[2] = { nullptr, nullptr };
 	QImage * m_boardImage;
 	QImage * m_spareImage;
-	QImage * m_spareImage2;
 	QGraphicsPixmapItem * m_displayItem[2] = { nullptr, nullptr };
 	bool m_temporaryBoard;
 	CostFunction m_costFunction;
@@ -262,6 +465,27 @@ protected:
 	int m_cleanupCount;
 	int m_netLabelIndex;
 	int m_commandCount;
+	int m_parallelOrderings;
+	bool m_worker;
+	GridQueue::Strategy m_queueStrategy;
+	bool m_coarseRouting;
+	int m_optimizeThreads;
+	bool m_negotiatedRouting;
+	bool m_negotiating;
+	GridCost m_presentCost;
+	int m_jumperRadius;                                       // grid cells around the start of a jumper search; 0 for no limit
+	std::vector<quint64> m_jumperVisited;                     // one bit per grid cell, reused by every lookForJumper
+	std::vector<GridCost> m_congestionHistory;              // negotiated mode: per cell, grows each round the cell stays shared
+	RouterMetrics m_metrics;
+	std::shared_ptr<ObstacleCache> m_obstacleCache;            // shared read-only with workers
+	// carried from beginRouting to finishRouting
+	QUndoCommand * m_parentCommand = nullptr;
+	NetList m_netList;
+	Score m_bestScore;
+	QSizeF m_gridSize;
+	QList<NetOrdering> m_allOrderings;
+	MazeRouter * m_searcher = nullptr;
+	QFuture<int> m_search;
 };
 
 #endif
@@ -0,0 +1,273 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "orthogonalrouter.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const double Epsilon = 0.001;
+
+// steps in the four directions; a direction's opposite is direction ^ 1
+const int DX[4] = { 1, -1, 0, 0 };
+const int DY[4] = { 0, 0, 1, -1 };
+
+void snap(QPointF & p, const QPointF & to)
+{
+	if (qAbs(p.x() - to.x()) < Epsilon) p.rx() = to.x();
+	if (qAbs(p.y() - to.y()) < Epsilon) p.ry() = to.y();
+}
+
+bool collinear(const QPointF & p1, const QPointF & p2, const QPointF & p3)
+{
+	if (qAbs(p1.x() - p2.x()) < Epsilon && qAbs(p2.x() - p3.x()) < Epsilon) return true;
+	if (qAbs(p1.y() - p2.y()) < Epsilon && qAbs(p2.y() - p3.y()) < Epsilon) return true;
+	return false;
+}
+
+}
+
+OrthogonalRouter::OrthogonalRouter(const QRectF & bounds, double keepout, double bendCost)
+	: m_bounds(bounds)
+	, m_keepout(keepout)
+	, m_bendCost(bendCost)
+{
+}
+
+void OrthogonalRouter::addBlock(const QRectF & rect, int net)
+{
+	// a part: nothing from another net comes within the keepout of it
+	Obstacle obstacle;
+	obstacle.rect = rect.normalized().adjusted(-m_keepout, -m_keepout, m_keepout, m_keepout);
+	obstacle.kind = Block;
+	obstacle.net = net;
+	m_obstacles << obstacle;
+}
+
+void OrthogonalRouter::addPath(const QList<QPointF> & points, int net)
+{
+	// another net may cross a wire at right angles, but may not run along it or turn on it
+	for (int i = 1; i < points.count(); i++) {
+		QPointF p1 = points.at(i - 1);
+		QPointF p2 = points.at(i);
+		bool horizontal = qAbs(p1.y() - p2.y()) < Epsilon;
+		bool vertical = qAbs(p1.x() - p2.x()) < Epsilon;
+		if (horizontal && vertical) continue;
+
+		Obstacle obstacle;
+		obstacle.rect = QRectF(p1, p2).normalized().adjusted(-m_keepout, -m_keepout, m_keepout, m_keepout);
+		obstacle.kind = horizontal ? HorizontalWire : (vertical ? VerticalWire : Block);
+		obstacle.net = net;
+		m_obstacles << obstacle;
+	}
+
+	// ends and corners are where wires join, so nothing else goes through them
+	Q_FOREACH (QPointF p, points) {
+		Obstacle obstacle;
+		obstacle.rect = QRectF(p.x() - m_keepout, p.y() - m_keepout, m_keepout * 2, m_keepout * 2);
+		obstacle.kind = Block;
+		obstacle.net = net;
+		m_obstacles << obstacle;
+	}
+}
+
+int OrthogonalRouter::obstacleCount() const
+{
+	return m_obstacles.count();
+}
+
+QList<QPointF> OrthogonalRouter::route(const QPointF & from, const QPointF & to, int net) const
+{
+	// returns the corners from 'from' to 'to', both included; empty when there is no way through.
+	// Obstacles of the same net (when net >= 0) are ignored.  The search starts in a window around
+	// the two points, which keeps the grid small, and widens it until it covers the bounds
+	QList<QPointF> path;
+	if (qAbs(from.x() - to.x()) < Epsilon && qAbs(from.y() - to.y()) < Epsilon) {
+		path << from;
+		return path;
+	}
+
+	QRectF span = QRectF(from, to).normalized().adjusted(-Epsilon, -Epsilon, Epsilon, Epsilon);
+	QRectF bounds = m_bounds;
+	bounds |= span;
+	double margin = qMax(qMax(span.width(), span.height()) / 2, m_keepout * 20);
+	while (true) {
+		QRectF window = span.adjusted(-margin, -margin, margin, margin);
+		window &= bounds;
+		path = routeWithin(window, from, to, net);
+		if (!path.isEmpty() || window.contains(bounds)) return path;
+
+		margin *= 2;
+	}
+}
+
+QList<QPointF> OrthogonalRouter::routeWithin(const QRectF & bounds, const QPointF & from, const QPointF & to, int net) const
+{
+	// every obstacle edge is a grid line, so a cell between neighboring lines is either wholly inside
+	// an obstacle or wholly outside, and a step between neighboring grid points is blocked when the
+	// cells on both sides of it forbid it
+	QList<QPointF> path;
+	QVector<double> xs;
+	QVector<double> ys;
+	xs << bounds.left() << bounds.right() << from.x() << to.x();
+	ys << bounds.top() << bounds.bottom() << from.y() << to.y();
+	QVector<Obstacle> obstacles;
+	Q_FOREACH (Obstacle obstacle, m_obstacles) {
+		if (net >= 0 && obstacle.net == net) continue;
+		if (!obstacle.rect.intersects(bounds)) continue;
+
+		obstacle.rect &= bounds;
+		obstacles << obstacle;
+		xs << obstacle.rect.left() << obstacle.rect.right();
+		ys << obstacle.rect.top() << obstacle.rect.bottom();
+	}
+	sortUnique(xs);
+	sortUnique(ys);
+
+	// what each cell forbids: HorizontalWire bit for running across it horizontally, VerticalWire bit vertically
+	int nx = xs.count();
+	int ny = ys.count();
+	QVector<uchar> cells((nx - 1) * (ny - 1), 0);
+	Q_FOREACH (Obstacle obstacle, obstacles) {
+		int x0 = indexOf(xs, obstacle.rect.left());
+		int x1 = indexOf(xs, obstacle.rect.right());
+		int y0 = indexOf(ys, obstacle.rect.top());
+		int y1 = indexOf(ys, obstacle.rect.bottom());
+		for (int j = y0; j < y1; j++) {
+			for (int i = x0; i < x1; i++) {
+				cells[(j * (nx - 1)) + i] |= obstacle.kind;
+			}
+		}
+	}
+	auto cell = [&cells, nx, ny](int i, int j) -> uchar {
+		// beyond the window is taken to be like the inside, so an obstacle the window cuts
+		// through does not leave a way along the window's edge
+		i = qBound(0, i, nx - 2);
+		j = qBound(0, j, ny - 2);
+		return cells.at((j * (nx - 1)) + i);
+	};
+
+	// A* over (grid point, direction of arrival) so that bends can be priced
+	int start = indexOf(xs, from.x()) + (indexOf(ys, from.y()) * nx);
+	int goal = indexOf(xs, to.x()) + (indexOf(ys, to.y()) * nx);
+	auto estimate = [&xs, &ys, &to, nx](int node) {
+		return qAbs(xs.at(node % nx) - to.x()) + qAbs(ys.at(node / nx) - to.y());
+	};
+
+	typedef std::pair<double, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+	QVector<double> costs(nx * ny * 4, std::numeric_limits<double>::max());
+	QVector<int> previous(nx * ny * 4, -1);
+	for (int d = 0; d < 4; d++) {
+		costs[(start * 4) + d] = 0;
+		queue.push(Entry(estimate(start), (start * 4) + d));
+	}
+
+	int found = -1;
+	while (!queue.empty()) {
+		Entry entry = queue.top();
+		queue.pop();
+		int state = entry.second;
+		int node = state / 4;
+		int d = state % 4;
+		double cost = costs.at(state);
+		if (entry.first > cost + estimate(node) + Epsilon) continue;         // superseded
+		if (node == goal) {
+			found = state;
+			break;
+		}
+
+		int i = node % nx;
+		int j = node / nx;
+		for (int d2 = 0; d2 < 4; d2++) {
+			if (d2 == (d ^ 1)) continue;
+
+			int i2 = i + DX[d2];
+			int j2 = j + DY[d2];
+			if (i2 < 0 || j2 < 0 || i2 >= nx || j2 >= ny) continue;
+
+			double length;
+			if (d2 < 2) {
+				// along line j, between the cells above and below it
+				if ((cell(qMin(i, i2), j - 1) & cell(qMin(i, i2), j) & HorizontalWire) != 0) continue;
+				length = qAbs(xs.at(i2) - xs.at(i));
+			}
+			else {
+				if ((cell(i - 1, qMin(j, j2)) & cell(i, qMin(j, j2)) & VerticalWire) != 0) continue;
+				length = qAbs(ys.at(j2) - ys.at(j));
+			}
+
+			int next = ((i2 + (j2 * nx)) * 4) + d2;
+			double nextCost = cost + length + (d2 == d ? 0 : m_bendCost);
+			if (nextCost + Epsilon >= costs.at(next)) continue;
+
+			costs[next] = nextCost;
+			previous[next] = state;
+			queue.push(Entry(nextCost + estimate(next / 4), next));
+		}
+	}
+
+	if (found < 0) return path;
+
+	for (int state = found; state >= 0; state = previous.at(state)) {
+		int node = state / 4;
+		QPointF p(xs.at(node % nx), ys.at(node / nx));
+		if (path.count() >= 2 && collinear(p, path.first(), path.at(1))) {
+			path.removeFirst();
+		}
+		path.prepend(p);
+	}
+	// the grid may have merged an end point with a line a hair away from it
+	path.first() = from;
+	path.last() = to;
+	if (path.count() > 2) {
+		snap(path[1], from);
+		snap(path[path.count() - 2], to);
+	}
+	return path;
+}
+
+void OrthogonalRouter::sortUnique(QVector<double> & values)
+{
+	std::sort(values.begin(), values.end());
+	int count = 0;
+	for (int i = 0; i < values.count(); i++) {
+		if (count > 0 && values.at(i) - values.at(count - 1) < Epsilon) continue;
+
+		values[count++] = values.at(i);
+	}
+	values.resize(count);
+}
+
+int OrthogonalRouter::indexOf(const QVector<double> & values, double value)
+{
+	auto it = std::lower_bound(values.begin(), values.end(), value - Epsilon);
+	if (it == values.end()) return values.count() - 1;
+
+	return int(it - values.begin());
+}
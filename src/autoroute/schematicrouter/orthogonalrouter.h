@@ -0,0 +1,67 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef ORTHOGONALROUTER_H
+#define ORTHOGONALROUTER_H
+
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+class OrthogonalRouter
+{
+	// shortest orthogonal paths with the fewest bends between rectangular obstacles, searched over
+	// the sparse grid of lines through the obstacle edges and the end points instead of a raster
+
+public:
+	OrthogonalRouter(const QRectF & bounds, double keepout, double bendCost);
+
+	void addBlock(const QRectF &, int net);
+	void addPath(const QList<QPointF> &, int net);
+	QList<QPointF> route(const QPointF & from, const QPointF & to, int net) const;
+	int obstacleCount() const;
+
+protected:
+	enum Kind {
+		Block = 3,                          // neither crossed nor run along
+		HorizontalWire = 1,                 // crossed vertically, never run along or bent inside
+		VerticalWire = 2
+	};
+
+	struct Obstacle {
+		QRectF rect;                        // with the keepout
+		int kind = Block;
+		int net = -1;                       // -1 is in the way of every net
+	};
+
+	QList<QPointF> routeWithin(const QRectF & bounds, const QPointF & from, const QPointF & to, int net) const;
+
+	static void sortUnique(QVector<double> &);
+	static int indexOf(const QVector<double> &, double);
+
+protected:
+	QRectF m_bounds;
+	double m_keepout = 0;
+	double m_bendCost = 0;
+	QVector<Obstacle> m_obstacles;
+};
+
+#endif
@@ -0,0 +1,377 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "schematicrouter.h"
+#include "orthogonalrouter.h"
+#include "../mazerouter/mazerouter.h"
+#include "../../sketch/pcbsketchwidget.h"
+#include "../../debugdialog.h"
+#include "../../items/tracewire.h"
+#include "../../connectors/connectoritem.h"
+#include "../../processeventblocker.h"
+#include "../../utils/euclideanmst.h"
+#include "../../utils/settingscache.h"
+
+#include <QElapsedTimer>
+#include <QMessageBox>
+
+#include <qmath.h>
+
+const QString SchematicRouter::FastRoutingName("cmrouter/schematicfast");
+
+static void appendCorner(QList<QPointF> & points, const QPointF & p)
+{
+	// drops repeated and collinear points, which the stubs leave at either end of a path
+	if (!points.isEmpty() && points.last() == p) return;
+
+	if (points.count() >= 2) {
+		QPointF p1 = points.at(points.count() - 2);
+		QPointF p2 = points.last();
+		if ((p1.x() == p2.x() && p2.x() == p.x()) || (p1.y() == p2.y() && p2.y() == p.y())) {
+			points.removeLast();
+		}
+	}
+	points << p;
+}
+
+SchematicRouter::SchematicRouter(PCBSketchWidget * sketchWidget) : Autorouter(sketchWidget)
+{
+	m_pcbType = false;
+	m_bothSidesNow = false;
+	m_keepoutPixels = m_sketchWidget->getKeepout();             // in schematic view the 0.1 inch pin pitch
+	m_standardWireWidth = m_sketchWidget->getAutorouterTraceWidth();
+
+	// the same room to go around everything that the maze router gives a schematic
+	QRectF itemsBoundingRect;
+	Q_FOREACH (QGraphicsItem * item, m_sketchWidget->scene()->items()) {
+		if (!item->isVisible()) continue;
+
+		itemsBoundingRect |= item->sceneBoundingRect();
+	}
+	m_maxRect = itemsBoundingRect.adjusted(-itemsBoundingRect.width() / 2, -itemsBoundingRect.height() / 2, itemsBoundingRect.width() / 2, itemsBoundingRect.height() / 2);
+}
+
+void SchematicRouter::start()
+{
+	Outcome outcome = SettingsCache::boolValue(FastRoutingName, true) ? routeFast() : Unrouted;
+	if (outcome == Unrouted) {
+		routeMaze();
+	}
+}
+
+SchematicRouter::Outcome SchematicRouter::routeFast()
+{
+	// all or nothing: a connection that cannot be made leaves the sketch as it was for the maze router
+	QElapsedTimer timer;
+	timer.start();
+
+	Q_EMIT setMaximumProgress(0);
+	Q_EMIT setProgressMessage(tr("Routing..."));
+
+	m_sketchWidget->ensureTraceLayersVisible();
+
+	QHash<ConnectorItem *, int> indexer;
+	m_sketchWidget->collectAllNets(indexer, m_allPartConnectorItems, false, m_bothSidesNow);
+
+	removeOffBoardAnd(m_pcbType, true, m_bothSidesNow);
+
+	if (m_allPartConnectorItems.count() == 0) {
+		QMessageBox::information(nullptr, QObject::tr("Fritzing"), QObject::tr("No connections to route."));
+		Autorouter::cleanUpNets();
+		return NothingToRoute;
+	}
+
+	auto * parentCommand = new QUndoCommand("Autoroute");
+	new CleanUpWiresCommand(m_sketchWidget, CleanUpWiresCommand::UndoOnly, parentCommand);
+	new CleanUpRatsnestsCommand(m_sketchWidget, CleanUpWiresCommand::UndoOnly, parentCommand);
+
+	initUndo(parentCommand);
+
+	// each net's pins, split into the groups that are already wired together
+	QHash<ConnectorItem *, int> netIndexes;
+	QList< QList< QList<ConnectorItem *> > > nets;
+	for (int i = 0; i < m_allPartConnectorItems.count(); i++) {
+		QList< QList<ConnectorItem *> > subnets;
+		QList<ConnectorItem *> todo(*m_allPartConnectorItems.at(i));
+		while (todo.count() > 0) {
+			QList<ConnectorItem *> equi;
+			equi.append(todo.takeFirst());
+			ConnectorItem::collectEqualPotential(equi, m_bothSidesNow, (ViewGeometry::RatsnestFlag | ViewGeometry::NormalFlag | ViewGeometry::PCBTraceFlag | ViewGeometry::SchematicTraceFlag) ^ m_sketchWidget->getTraceFlag());
+			QList<ConnectorItem *> pins;
+			Q_FOREACH (ConnectorItem * equ, equi) {
+				todo.removeOne(equ);
+				netIndexes.insert(equ, i);
+				if (equ->attachedToItemType() != ModelPart::Wire) pins << equ;
+			}
+			if (pins.count() > 0) subnets << pins;
+		}
+		nets << subnets;
+	}
+
+	// parts are kept clear of; parts without connectors (frames, notes, text) are drawn over
+	OrthogonalRouter router(m_maxRect, m_keepoutPixels, m_keepoutPixels * 2);
+	QSet<ItemBase *> parts;
+	QSet<Wire *> visited;
+	Q_FOREACH (QGraphicsItem * item, m_sketchWidget->scene()->items()) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr || !itemBase->isVisible()) continue;
+
+		auto * traceWire = qobject_cast<TraceWire *>(itemBase);
+		if (traceWire != nullptr) {
+			// the wires left after the rip-up keep their net
+			if (!traceWire->isTraceType(m_sketchWidget->getTraceFlag())) continue;
+			if (visited.contains(traceWire)) continue;
+
+			QList<Wire *> wires;
+			QList<ConnectorItem *> ends;
+			traceWire->collectChained(wires, ends);
+			int netIndex = -1;
+			Q_FOREACH (ConnectorItem * end, ends) {
+				netIndex = netIndexes.value(end, netIndex);
+			}
+			Q_FOREACH (Wire * wire, wires) {
+				visited.insert(wire);
+				QList<QPointF> points;
+				points << wire->connector0()->sceneAdjustedTerminalPoint(nullptr) << wire->connector1()->sceneAdjustedTerminalPoint(nullptr);
+				router.addPath(points, netIndex);
+			}
+			continue;
+		}
+		if (qobject_cast<Wire *>(itemBase) != nullptr) continue;
+
+		ItemBase * chief = itemBase->layerKinChief();
+		if (parts.contains(chief)) continue;
+		if (chief->cachedConnectorItems().isEmpty()) continue;
+
+		parts.insert(chief);
+		router.addBlock(chief->sceneBoundingRect(), -1);
+	}
+
+	// every pin leaves its part straight out from the nearest side; the stubs are reserved
+	// up front so that no net routed earlier closes off a pin of one routed later
+	QHash<ConnectorItem *, QPointF> escapes;
+	for (int i = 0; i < nets.count(); i++) {
+		if (nets.at(i).count() < 2) continue;
+
+		Q_FOREACH (QList<ConnectorItem *> pins, nets.at(i)) {
+			Q_FOREACH (ConnectorItem * pin, pins) {
+				QPointF escape = escapePoint(pin);
+				escapes.insert(pin, escape);
+				QList<QPointF> stub;
+				stub << pin->sceneAdjustedTerminalPoint(nullptr) << escape;
+				router.addPath(stub, i);
+			}
+		}
+	}
+
+	Q_EMIT setMaximumProgress(nets.count());
+	QList<Connection> connections;
+	bool unrouted = false;
+	for (int i = 0; i < nets.count() && !unrouted; i++) {
+		Q_EMIT setProgressValue(i);
+		if (nets.at(i).count() < 2) continue;
+
+		// join the groups along a spanning tree of the pins' escape points
+		QList<ConnectorItem *> pins;
+		QVector<QPointF> points;
+		QVector<int> groups;
+		for (int s = 0; s < nets.at(i).count(); s++) {
+			Q_FOREACH (ConnectorItem * pin, nets.at(i).at(s)) {
+				pins << pin;
+				points << escapes.value(pin);
+				groups << s;
+			}
+		}
+
+		typedef QPair<int, int> Edge;
+		Q_FOREACH (Edge edge, EuclideanMST::spanningTree(points, groups)) {
+			QList<QPointF> path = router.route(points.at(edge.first), points.at(edge.second), i);
+			if (path.isEmpty()) {
+				unrouted = true;
+				break;
+			}
+
+			router.addPath(path, i);
+			Connection connection;
+			connection.from = pins.at(edge.first);
+			connection.to = pins.at(edge.second);
+			appendCorner(connection.points, connection.from->sceneAdjustedTerminalPoint(nullptr));
+			Q_FOREACH (QPointF p, path) appendCorner(connection.points, p);
+			appendCorner(connection.points, connection.to->sceneAdjustedTerminalPoint(nullptr));
+			connections << connection;
+		}
+
+		ProcessEventBlocker::processEvents();
+		if (m_cancelled) {
+			doCancel(parentCommand);
+			return Cancelled;
+		}
+	}
+
+	if (unrouted) {
+		DebugDialog::debug(QString("schematic autoroute: %1 connections routed before one could not be, %2 ms").arg(connections.count()).arg(timer.elapsed()));
+		Q_EMIT setProgressMessage(tr("Some connections need the full autorouter..."));
+		ProcessEventBlocker::processEvents();
+		restoreOriginalState(parentCommand);
+		Autorouter::cleanUpNets();
+		return Unrouted;
+	}
+
+	Q_EMIT disableButtons();
+	Q_EMIT setProgressValue(nets.count());
+	Q_EMIT setProgressMessage(tr("Routing complete!"));
+	Q_EMIT setProgressStats(tr("%n connection(s) in %1 ms", "", connections.count()).arg(timer.elapsed()));
+	DebugDialog::debug(QString("schematic autoroute: %1 connections, %2 ms").arg(connections.count()).arg(timer.elapsed()));
+
+	createTraces(connections, parentCommand);
+
+	Autorouter::cleanUpNets();
+	new CleanUpRatsnestsCommand(m_sketchWidget, CleanUpWiresCommand::RedoOnly, parentCommand);
+	new CleanUpWiresCommand(m_sketchWidget, CleanUpWiresCommand::RedoOnly, parentCommand);
+
+	m_sketchWidget->blockUI(true);
+	m_commandCount = BaseCommand::totalChildCount(parentCommand);
+	Q_EMIT setMaximumProgress(m_commandCount);
+	Q_EMIT setProgressMessage2(tr("Preparing undo..."));
+	ProcessEventBlocker::processEvents();
+	m_cleanupCount = 0;
+	m_sketchWidget->pushCommand(parentCommand, this);
+	m_sketchWidget->blockUI(false);
+	m_sketchWidget->repaint();
+	return Routed;
+}
+
+QPointF SchematicRouter::escapePoint(ConnectorItem * pin)
+{
+	// a whole number of pin pitches out from the nearest side of the part, clear of its keepout
+	QPointF p = pin->sceneAdjustedTerminalPoint(nullptr);
+	QRectF r = pin->attachedTo()->layerKinChief()->sceneBoundingRect();
+	double left = p.x() - r.left();
+	double right = r.right() - p.x();
+	double top = p.y() - r.top();
+	double bottom = r.bottom() - p.y();
+	double nearest = qMin(qMin(left, right), qMin(top, bottom));
+	double distance = qCeil((qMax(nearest, 0.0) + m_keepoutPixels) / m_keepoutPixels) * m_keepoutPixels;
+
+	if (nearest == left) return QPointF(p.x() - distance, p.y());
+	if (nearest == right) return QPointF(p.x() + distance, p.y());
+	if (nearest == top) return QPointF(p.x(), p.y() - distance);
+	return QPointF(p.x(), p.y() + distance);
+}
+
+void SchematicRouter::createTraces(const QList<Connection> & connections, QUndoCommand * parentCommand)
+{
+	// the traces only exist long enough to be recorded on the undo command, like the maze router's
+	m_routedRegion = QRectF();
+	QList<TraceWire *> traceWires;
+	QList< QPair<ConnectorItem *, ConnectorItem *> > joins;
+	Q_FOREACH (Connection connection, connections) {
+		ConnectorItem * previous = connection.from;
+		for (int i = 1; i < connection.points.count(); i++) {
+			TraceWire * traceWire = drawOneTrace(connection.points.at(i - 1), connection.points.at(i), m_standardWireWidth, ViewLayer::NewBottom);
+			if (traceWire == nullptr) continue;
+
+			joins << qMakePair(previous, traceWire->connector0());
+			previous = traceWire->connector1();
+			traceWires << traceWire;
+		}
+		joins << qMakePair(previous, connection.to);
+	}
+
+	Q_FOREACH (TraceWire * traceWire, traceWires) {
+		addWireToUndo(traceWire, parentCommand);
+		m_routedRegion |= traceWire->sceneBoundingRect();
+	}
+	for (int i = 0; i < joins.count(); i++) {
+		addConnectionToUndo(joins.at(i).first, joins.at(i).second, parentCommand);
+	}
+
+	QList<ModelPart *> modelParts;
+	Q_FOREACH (TraceWire * traceWire, traceWires) {
+		modelParts << traceWire->modelPart();
+		delete traceWire;
+	}
+	Q_FOREACH (ModelPart * modelPart, modelParts) {
+		modelPart->setParent(nullptr);
+		delete modelPart;
+	}
+}
+
+void SchematicRouter::routeMaze()
+{
+	// the maze router reports through this router, and the dialog's buttons reach it the same way
+	auto * mazeRouter = new MazeRouter(m_sketchWidget, nullptr, true);
+	if (!m_ripUpRegion.isEmpty()) {
+		mazeRouter->setRipUpRegion(m_ripUpRegion);
+	}
+
+	connect(mazeRouter, SIGNAL(wantTopVisible()), this, SIGNAL(wantTopVisible()), Qt::DirectConnection);
+	connect(mazeRouter, SIGNAL(wantBottomVisible()), this, SIGNAL(wantBottomVisible()), Qt::DirectConnection);
+	connect(mazeRouter, SIGNAL(wantBothVisible()), this, SIGNAL(wantBothVisible()), Qt::DirectConnection);
+	connect(mazeRouter, SIGNAL(setMaximumProgress(int)), this, SIGNAL(setMaximumProgress(int)), Qt::DirectConnection);
+	connect(mazeRouter, SIGNAL(setProgressValue(int)), this, SIGNAL(setProgressValue(int)), Qt::DirectConnection);
+	connect(mazeRouter, SIGNAL(setProgressMessage(const QString &)), this, SIGNAL(setProgressMessage(const QString &)));
+	connect(mazeRouter, SIGNAL(setProgressMessage2(const QString &)), this, SIGNAL(setProgressMessage2(const QString &)));
+	connect(mazeRouter, SIGNAL(setProgressStats(const QString &)), this, SIGNAL(setProgressStats(const QString &)));
+	connect(mazeRouter, SIGNAL(setCycleMessage(const QString &)), this, SIGNAL(setCycleMessage(const QString &)));
+	connect(mazeRouter, SIGNAL(setCycleCount(int)), this, SIGNAL(setCycleCount(int)));
+	connect(mazeRouter, SIGNAL(disableButtons()), this, SIGNAL(disableButtons()));
+
+	m_fallback = mazeRouter;
+	mazeRouter->start();
+	m_routedRegion = mazeRouter->routedRegion();
+	m_fallback = nullptr;
+	delete mazeRouter;
+}
+
+void SchematicRouter::cancel() {
+	Autorouter::cancel();
+	if (m_fallback) m_fallback->cancel();
+}
+
+void SchematicRouter::cancelTrace() {
+	Autorouter::cancelTrace();
+	if (m_fallback) m_fallback->cancelTrace();
+}
+
+void SchematicRouter::stopTracing() {
+	Autorouter::stopTracing();
+	if (m_fallback) m_fallback->stopTracing();
+}
+
+void SchematicRouter::useBest() {
+	Autorouter::useBest();
+	if (m_fallback) m_fallback->useBest();
+}
+
+void SchematicRouter::setMaxCycles(int maxCycles)
+{
+	Autorouter::setMaxCycles(maxCycles);
+	if (m_fallback) m_fallback->setMaxCycles(maxCycles);
+}
+
+void SchematicRouter::incCommandProgress() {
+	Q_EMIT setProgressValue(m_cleanupCount++);
+
+	int modulo = m_commandCount / 100;
+	if (modulo > 0 && m_cleanupCount % modulo == 0) {
+		ProcessEventBlocker::processEvents();
+	}
+}
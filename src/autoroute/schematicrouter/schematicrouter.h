@@ -0,0 +1,81 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef SCHEMATICROUTER_H
+#define SCHEMATICROUTER_H
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QPointF>
+#include <QUndoCommand>
+
+#include "../autorouter.h"
+
+class SchematicRouter : public Autorouter
+{
+	// routes a schematic with orthogonal wires searched between the parts' bounding boxes;
+	// only when some connection cannot be made that way does the maze router take over
+
+	Q_OBJECT
+
+public:
+	SchematicRouter(class PCBSketchWidget *);
+
+	void start();
+
+public:
+	static const QString FastRoutingName;
+
+protected:
+	struct Connection {
+		ConnectorItem * from = nullptr;
+		ConnectorItem * to = nullptr;
+		QList<QPointF> points;              // from's terminal point to to's, corners in between
+	};
+
+	enum Outcome {
+		Routed,
+		NothingToRoute,
+		Cancelled,
+		Unrouted
+	};
+
+	Outcome routeFast();
+	void routeMaze();
+	QPointF escapePoint(ConnectorItem *);
+	void createTraces(const QList<Connection> &, QUndoCommand * parentCommand);
+
+public Q_SLOTS:
+	void cancel();
+	void cancelTrace();
+	void stopTracing();
+	void useBest();
+	void setMaxCycles(int);
+	void incCommandProgress();
+
+protected:
+	double m_standardWireWidth = 0;
+	int m_commandCount = 0;
+	int m_cleanupCount = 0;
+	QPointer<Autorouter> m_fallback;        // the maze router, while it runs
+};
+
+#endif
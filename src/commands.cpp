@@ -25,6 +25,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "connectors/connectoritem.h"
 #include "items/moduleidnames.h"
 #include "utils/bezier.h"
+#include "utils/stringpool.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -45,6 +53,88 @@ void CommandProgress::emitRedo() {
 
 int SelectItemCommand::selectItemCommandID = 3;
 int ChangeNoteTextCommand::changeNoteTextCommandID = 5;
+namespace {
+
+class CommandArena
+{
+	// commands come and go by the thousand with each paste, autoroute and cleared undo history;
+	// they are carved out of large slabs, freed blocks are kept per size for reuse,
+	// and the slabs themselves go back in one go whenever the last command is deleted
+
+public:
+	void * allocate(std::size_t size) {
+		if (size > MaxPooled) return ::operator new(size);
+
+		std::size_t sizeClass = (size + Granularity - 1) / Granularity;
+		QMutexLocker locker(&m_mutex);
+		m_live++;
+		FreeBlock * block = m_free[sizeClass - 1];
+		if (block != nullptr) {
+			m_free[sizeClass - 1] = block->next;
+			return block;
+		}
+
+		std::size_t bytes = sizeClass * Granularity;
+		if (m_bumpLeft < bytes) {
+			m_bump = static_cast<char *>(::operator new(SlabSize));
+			m_bumpLeft = SlabSize;
+			m_slabs.push_back(m_bump);
+		}
+		void * result = m_bump;
+		m_bump += bytes;
+		m_bumpLeft -= bytes;
+		return result;
+	}
+
+	void deallocate(void * p, std::size_t size) {
+		if (p == nullptr) return;
+
+		if (size > MaxPooled) {
+			::operator delete(p);
+			return;
+		}
+
+		std::size_t sizeClass = (size + Granularity - 1) / Granularity;
+		QMutexLocker locker(&m_mutex);
+		auto * block = static_cast<FreeBlock *>(p);
+		block->next = m_free[sizeClass - 1];
+		m_free[sizeClass - 1] = block;
+		if (--m_live > 0) return;
+
+		for (char * slab : m_slabs) {
+			::operator delete(slab);
+		}
+		m_slabs.clear();
+		std::fill(std::begin(m_free), std::end(m_free), nullptr);
+		m_bump = nullptr;
+		m_bumpLeft = 0;
+	}
+
+protected:
+	struct FreeBlock {
+		FreeBlock * next;
+	};
+
+	static const std::size_t Granularity = 16;
+	static const std::size_t MaxPooled = 1024;
+	static const std::size_t SlabSize = 256 * 1024;
+
+	QMutex m_mutex;
+	FreeBlock * m_free[MaxPooled / Granularity] = {};
+	std::vector<char *> m_slabs;
+	char * m_bump = nullptr;
+	std::size_t m_bumpLeft = 0;
+	qint64 m_live = 0;
+};
+
+CommandArena * commandArena() {
+	// never destroyed, since undo stacks can outlive static destruction at exit
+	static auto * arena = new CommandArena;
+	return arena;
+}
+
+}
+
 int BaseCommand::nextIndex = 0;
 CommandProgress BaseCommand::m_commandProgress;
 
@@ -162,6 +252,30 @@ void BaseCommand::redo() {
 	if (m_commandProgress.active()) m_commandProgress.emitRedo();
 }
 
+void BaseCommand::compact() {
+	// called once the command is finished and about to go on the undo stack
+	Q_FOREACH (BaseCommand * command, m_commands) {
+		command->compact();
+	}
+}
+
+qint64 BaseCommand::memoryCost() const {
+	// a rough estimate, for WaitPushUndoStack's memory limit
+	qint64 cost = 128 + (text().size() * (qint64) sizeof(QChar));
+	Q_FOREACH (BaseCommand * command, m_commands) {
+		cost += command->memoryCost();
+	}
+	return cost;
+}
+
+void BaseCommand::releaseSubCommands() {
+	// only for a command that will never be undone or redone again
+	Q_FOREACH (BaseCommand * command, m_commands) {
+		delete command;
+	}
+	m_commands.clear();
+}
+
 CommandProgress * BaseCommand::initProgress() {
 	m_commandProgress.setActive(true);
 	return &m_commandProgress;
@@ -171,6 +285,14 @@ void BaseCommand::clearProgress() {
 	m_commandProgress.setActive(false);
 }
 
+void * BaseCommand::operator new(std::size_t size) {
+	return commandArena()->allocate(size);
+}
+
+void BaseCommand::operator delete(void * p, std::size_t size) {
+	commandArena()->deallocate(p, size);
+}
+
 int BaseCommand::totalChildCount(const QUndoCommand * command) {
 	int cc = command->childCount();
 	int tcc = cc;
@@ -201,6 +323,27 @@ AddDeleteItemCommand::~AddDeleteItemCommand()
 	}
 }
 
+void AddDeleteItemCommand::compact() {
+	// the same module ids and connector names repeat across a paste or an autoroute
+	m_moduleID = StringPool::intern(m_moduleID);
+	if (m_localConnectors != nullptr) {
+		QHash<QString, QString> localConnectors;
+		for (auto it = m_localConnectors->constBegin(); it != m_localConnectors->constEnd(); ++it) {
+			localConnectors.insert(StringPool::intern(it.key()), StringPool::intern(it.value()));
+		}
+		m_localConnectors->swap(localConnectors);
+	}
+	BaseCommand::compact();
+}
+
+qint64 AddDeleteItemCommand::memoryCost() const {
+	qint64 cost = BaseCommand::memoryCost() + sizeof(ViewGeometry);
+	if (m_localConnectors != nullptr) {
+		cost += m_localConnectors->count() * 64;
+	}
+	return cost;
+}
+
 QString AddDeleteItemCommand::getParamString() const {
 	return BaseCommand::getParamString() +
 	       QString(" moduleid:%1 id:%2 modelindex:%3 flags:%4")
@@ -449,6 +592,43 @@ QString MoveItemsCommand::getParamString() const {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+RotateItemsCommand::RotateItemsCommand(SketchWidget* sketchWidget, double degrees, QUndoCommand *parent)
+	: SimulationCommand(BaseCommand::SingleView, sketchWidget, parent),
+	m_degrees(degrees)
+{
+}
+
+void RotateItemsCommand::undo()
+{
+	m_sketchWidget->rotateItemsForCommand(m_items, -m_degrees, false);
+	SimulationCommand::undo();
+}
+
+void RotateItemsCommand::redo()
+{
+	m_sketchWidget->rotateItemsForCommand(m_items, m_degrees, true);
+	SimulationCommand::redo();
+}
+
+void RotateItemsCommand::addItem(long id, const ViewGeometry & oldGeometry, const ViewGeometry & newGeometry)
+{
+	RotateItemThing rotateItemThing;
+	rotateItemThing.id = id;
+	rotateItemThing.oldGeometry = oldGeometry;
+	rotateItemThing.newGeometry = newGeometry;
+	m_items.append(rotateItemThing);
+}
+
+QString RotateItemsCommand::getParamString() const {
+	return QString("RotateItemsCommand ")
+	       + BaseCommand::getParamString() +
+	       QString(" items:%1 by:%2")
+	       .arg(m_items.count())
+	       .arg(m_degrees);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 RotateItemCommand::RotateItemCommand(SketchWidget* sketchWidget, long itemID, double degrees, QUndoCommand *parent)
 	: SimulationCommand(BaseCommand::SingleView, sketchWidget, parent),
 	m_itemID(itemID),
@@ -508,6 +688,39 @@ QString FlipItemCommand::getParamString() const {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+FlipItemsCommand::FlipItemsCommand(SketchWidget* sketchWidget, Qt::Orientations orientation, QUndoCommand *parent)
+	: BaseCommand(BaseCommand::SingleView, sketchWidget, parent),
+	m_orientation(orientation)
+{
+}
+
+void FlipItemsCommand::undo()
+{
+	redo();
+	BaseCommand::undo();
+}
+
+void FlipItemsCommand::redo()
+{
+	m_sketchWidget->flipItemsForCommand(m_itemIDs, m_orientation);
+	BaseCommand::redo();
+}
+
+void FlipItemsCommand::addItem(long id)
+{
+	m_itemIDs.append(id);
+}
+
+QString FlipItemsCommand::getParamString() const {
+	return QString("FlipItemsCommand ")
+	       + BaseCommand::getParamString() +
+	       QString(" items:%1 by:%2")
+	       .arg(m_itemIDs.count())
+	       .arg(m_orientation);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ChangeConnectionCommand::ChangeConnectionCommand(SketchWidget * sketchWidget, BaseCommand::CrossViewType crossView,
         long fromID, const QString & fromConnectorID,
         long toID, const QString & toConnectorID,
@@ -550,6 +763,16 @@ void ChangeConnectionCommand::disable() {
 	m_enabled = false;
 }
 
+void ChangeConnectionCommand::compact() {
+	m_fromConnectorID = StringPool::intern(m_fromConnectorID);
+	m_toConnectorID = StringPool::intern(m_toConnectorID);
+	BaseCommand::compact();
+}
+
+qint64 ChangeConnectionCommand::memoryCost() const {
+	return BaseCommand::memoryCost() + 64;
+}
+
 QString ChangeConnectionCommand::getParamString() const {
 	return QString("ChangeConnectionCommand ")
 	       + BaseCommand::getParamString() +
@@ -1196,6 +1419,10 @@ void CheckStickyCommand::redo()
 	BaseCommand::redo();
 }
 
+qint64 CheckStickyCommand::memoryCost() const {
+	return BaseCommand::memoryCost() + (m_stickyList.count() * (qint64) (sizeof(StickyThing) + 16));
+}
+
 QString CheckStickyCommand::getParamString() const {
 	return QString("CheckStickyCommand ")
 	       + BaseCommand::getParamString()
@@ -1315,6 +1542,17 @@ bool CleanUpWiresCommand::hasTraces(SketchWidget * sketchWidget) {
 	return m_sketchWidgets.contains(sketchWidget);
 }
 
+void CleanUpWiresCommand::compact() {
+	for (int i = 0; i < m_ratsnestConnectThings.count(); i++) {
+		m_ratsnestConnectThings[i].connectorID = StringPool::intern(m_ratsnestConnectThings.at(i).connectorID);
+	}
+	BaseCommand::compact();
+}
+
+qint64 CleanUpWiresCommand::memoryCost() const {
+	return BaseCommand::memoryCost() + (m_ratsnestConnectThings.count() * (qint64) (sizeof(RatsnestConnectThing) + 16));
+}
+
 QString CleanUpWiresCommand::getParamString() const {
 	return QString("CleanUpWiresCommand ")
 	       + BaseCommand::getParamString()
@@ -1912,6 +2150,41 @@ QString SetPropCommand::getParamString() const {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+SwapInPlaceCommand::SwapInPlaceCommand(SketchWidget * sketchWidget, long itemID, const QString & oldModuleID, const QString & newModuleID, QUndoCommand * parent)
+	: SimulationCommand(BaseCommand::CrossView, sketchWidget, parent),
+	m_itemID(itemID),
+	m_oldModuleID(oldModuleID),
+	m_newModuleID(newModuleID)
+{
+}
+
+void SwapInPlaceCommand::undo() {
+	m_sketchWidget->swapInPlace(m_itemID, m_oldModuleID);
+	SimulationCommand::undo();
+}
+
+void SwapInPlaceCommand::redo() {
+	if (m_skipFirstRedo) {
+		m_skipFirstRedo = false;
+	}
+	else {
+		m_sketchWidget->swapInPlace(m_itemID, m_newModuleID);
+	}
+	SimulationCommand::redo();
+}
+
+QString SwapInPlaceCommand::getParamString() const {
+
+	return QString("SwapInPlaceCommand ")
+	       + BaseCommand::getParamString() +
+	       QString(" id:%1 o:%2 n:%3")
+	       .arg(m_itemID)
+	       .arg(m_oldModuleID)
+	       .arg(m_newModuleID);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 ResizeJumperItemCommand::ResizeJumperItemCommand(SketchWidget * sketchWidget, long itemID, QPointF oldPos, QPointF oldC0, QPointF oldC1, QPointF newPos, QPointF newC0, QPointF newC1, QUndoCommand * parent)
 	: BaseCommand(BaseCommand::SingleView, sketchWidget, parent),
 	m_oldPos(oldPos),
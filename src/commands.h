@@ -25,6 +25,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QHash>
 #include <QPainterPath>
 
+#include <cstddef>
+
 #include "viewgeometry.h"
 #include "viewlayer.h"
 #include "routingstatus.h"
@@ -85,8 +87,13 @@ public:
 	void setSkipFirstRedo();
 	void undo();
 	void redo();
+	virtual void compact();
+	virtual qint64 memoryCost() const;
+	void releaseSubCommands();
 
 	static int totalChildCount(const QUndoCommand *);
+	static void * operator new(std::size_t);
+	static void operator delete(void *, std::size_t);
 	static CommandProgress * initProgress();
 	static void clearProgress();
 
@@ -131,6 +138,8 @@ public:
 	long itemID() const;
 	void setDropOrigin(SketchWidget *);
 	SketchWidget * dropOrigin();
+	void compact();
+	qint64 memoryCost() const;
 
 protected:
 	QString getParamString() const;
@@ -243,6 +252,31 @@ protected:
 
 /////////////////////////////////////////////
 
+struct RotateItemThing {
+	long id = 0;
+	ViewGeometry oldGeometry;
+	ViewGeometry newGeometry;
+};
+
+class RotateItemsCommand : public SimulationCommand
+{
+	// rotates a whole selection as one step; connections are updated once, after every item has moved
+public:
+	RotateItemsCommand(SketchWidget *sketchWidget, double degrees, QUndoCommand *parent);
+	void undo();
+	void redo();
+	void addItem(long id, const ViewGeometry & oldGeometry, const ViewGeometry & newGeometry);
+
+protected:
+	QString getParamString() const;
+
+protected:
+	double m_degrees;
+	QList<RotateItemThing> m_items;
+};
+
+/////////////////////////////////////////////
+
 class RotateItemCommand : public SimulationCommand
 {
 public:
@@ -276,6 +310,25 @@ protected:
 	Qt::Orientations m_orientation;
 };
 
+/////////////////////////////////////////////
+
+class FlipItemsCommand : public BaseCommand
+{
+	// flips a whole selection as one step; connections are updated once, after every item has flipped
+public:
+	FlipItemsCommand(SketchWidget *sketchWidget, Qt::Orientations orientation, QUndoCommand *parent);
+	void undo();
+	void redo();
+	void addItem(long id);
+
+protected:
+	QString getParamString() const;
+
+protected:
+	QList<long> m_itemIDs;
+	Qt::Orientations m_orientation;
+};
+
 /////////////////////////////////////////////
 class QTransform;
 class TransformItemCommand : public SimulationCommand
@@ -309,6 +362,8 @@ public:
 	void redo();
 	void setUpdateConnections(bool updatem);
 	void disable();
+	void compact();
+	qint64 memoryCost() const;
 
 protected:
 	QString getParamString() const;
@@ -598,7 +653,7 @@ public:
 	void undo();
 	void redo();
 	void stick(SketchWidget *, long fromID, long toID, bool stickem);
-
+	qint64 memoryCost() const;
 
 protected:
 	QString getParamString() const;
@@ -701,6 +756,8 @@ public:
 	bool hasTraces(SketchWidget *);
 	void addRatsnestConnect(long id, const QString & connectorID, bool connect);
 	CleanUpWiresCommand::Direction direction();
+	void compact();
+	qint64 memoryCost() const;
 
 protected:
 	QString getParamString() const;
@@ -971,6 +1028,25 @@ protected:
 
 /////////////////////////////////////////////
 
+class SwapInPlaceCommand : public SimulationCommand
+{
+	// swaps a part for a connector-compatible one without replacing its items
+public:
+	SwapInPlaceCommand(class SketchWidget *, long itemID, const QString & oldModuleID, const QString & newModuleID, QUndoCommand * parent);
+	void undo();
+	void redo();
+
+protected:
+	QString getParamString() const;
+
+protected:
+	long m_itemID;
+	QString m_oldModuleID;
+	QString m_newModuleID;
+};
+
+/////////////////////////////////////////////
+
 class ResizeJumperItemCommand : public BaseCommand
 {
 public:
@@ -0,0 +1,254 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "connectivityindex.h"
+#include "connectoritem.h"
+#include "../items/wire.h"
+#include "../model/modelpart.h"
+
+#include <QGraphicsScene>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
+QHash<QGraphicsScene *, ConnectivityIndex *> ConnectivityIndex::Indexes;
+
+static QMutex IndexesMutex;
+
+ConnectivityIndex::ConnectivityIndex(QGraphicsScene * scene) : QObject(scene), m_scene(scene)
+{
+	Indexes.insert(scene, this);
+}
+
+ConnectivityIndex::~ConnectivityIndex()
+{
+	QMutexLocker locker(&IndexesMutex);
+	Indexes.remove(m_scene);
+}
+
+bool ConnectivityIndex::collect(QList<ConnectorItem *> & connectorItems, bool crossLayers, ViewGeometry::WireFlags skipFlags, bool skipBuses)
+{
+	// answers collectEqualPotential from the index; false means the caller has to traverse
+	if (connectorItems.isEmpty()) return false;
+
+	QGraphicsScene * scene = connectorItems.first()->scene();
+	if (scene == nullptr) return false;
+
+	QMutexLocker locker(&IndexesMutex);
+	ConnectivityIndex * index = Indexes.value(scene, nullptr);
+	if (index == nullptr) {
+		index = new ConnectivityIndex(scene);
+	}
+	return index->lookup(connectorItems, crossLayers, skipFlags, skipBuses);
+}
+
+void ConnectivityIndex::connected(ConnectorItem * connectorItem1, ConnectorItem * connectorItem2)
+{
+	if (connectorItem1 == nullptr || connectorItem2 == nullptr) return;
+
+	// a connection to an item in no scene or another scene is not followed by the index
+	QGraphicsScene * scene = connectorItem1->scene();
+	if (scene == nullptr || scene != connectorItem2->scene()) return;
+
+	QMutexLocker locker(&IndexesMutex);
+	ConnectivityIndex * index = Indexes.value(scene, nullptr);
+	if (index != nullptr) {
+		index->unite(connectorItem1, connectorItem2);
+	}
+}
+
+void ConnectivityIndex::invalidate(QGraphicsItem * item)
+{
+	if (item != nullptr) {
+		invalidate(item->scene());
+	}
+}
+
+void ConnectivityIndex::invalidate(QGraphicsScene * scene)
+{
+	if (scene == nullptr) return;
+
+	QMutexLocker locker(&IndexesMutex);
+	ConnectivityIndex * index = Indexes.value(scene, nullptr);
+	if (index != nullptr) {
+		index->m_generation++;
+	}
+}
+
+bool ConnectivityIndex::lookup(QList<ConnectorItem *> & connectorItems, bool crossLayers, ViewGeometry::WireFlags skipFlags, bool skipBuses)
+{
+	quint64 key = (((quint64) skipFlags) << 2) | (crossLayers ? 2 : 0) | (skipBuses ? 1 : 0);
+	Partition & partition = m_partitions[key];
+	if (partition.generation != m_generation) {
+		// while connections keep coming and going (dragging, say) a traversal is cheaper than a rebuild
+		if (partition.staleGeneration != m_generation) {
+			partition.staleGeneration = m_generation;
+			partition.staleQueries = 0;
+		}
+		if (++partition.staleQueries < QueriesBeforeRebuild) return false;
+
+		partition.crossLayers = crossLayers;
+		partition.skipFlags = skipFlags;
+		partition.skipBuses = skipBuses;
+		rebuild(partition);
+	}
+
+	QList<ConnectorItem *> result;
+	QSet<int> roots;
+	Q_FOREACH (ConnectorItem * connectorItem, connectorItems) {
+		if (skipped(partition, connectorItem)) continue;
+
+		int node = partition.nodes.value(connectorItem, -1);
+		if (node < 0) return false;
+
+		if (roots.contains(find(partition, node))) continue;
+
+		roots.insert(find(partition, node));
+		result.append(connectorItem);
+		for (int member = partition.next.at(node); member != node; member = partition.next.at(member)) {
+			result.append(partition.items.at(member));
+		}
+	}
+
+	connectorItems = result;
+	return true;
+}
+
+void ConnectivityIndex::unite(ConnectorItem * connectorItem1, ConnectorItem * connectorItem2)
+{
+	for (auto it = m_partitions.begin(); it != m_partitions.end(); ++it) {
+		Partition & partition = it.value();
+		if (partition.generation != m_generation) continue;
+		if (skipped(partition, connectorItem1) || skipped(partition, connectorItem2)) continue;
+		if (!directAllowed(partition, connectorItem1, connectorItem2)) continue;
+
+		int node1 = partition.nodes.value(connectorItem1, -1);
+		int node2 = partition.nodes.value(connectorItem2, -1);
+		if (node1 < 0 || node2 < 0) {
+			// arrived after the last rebuild
+			partition.generation = -1;
+			continue;
+		}
+
+		join(partition, node1, node2);
+	}
+}
+
+void ConnectivityIndex::rebuild(Partition & partition)
+{
+	partition.nodes.clear();
+	partition.items.clear();
+	partition.parents.clear();
+	partition.next.clear();
+
+	Q_FOREACH (QGraphicsItem * item, m_scene->items()) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr) continue;
+
+		Q_FOREACH (ConnectorItem * connectorItem, itemBase->cachedConnectorItems()) {
+			if (skipped(partition, connectorItem)) continue;
+			if (partition.nodes.contains(connectorItem)) continue;
+
+			int node = partition.items.count();
+			partition.nodes.insert(connectorItem, node);
+			partition.items.append(connectorItem);
+			partition.parents.append(node);
+			partition.next.append(node);
+		}
+	}
+
+	// the same edges collectEqualPotential follows
+	for (int i = 0; i < partition.items.count(); i++) {
+		ConnectorItem * connectorItem = partition.items.at(i);
+		bool isWire = connectorItem->attachedToItemType() == ModelPart::Wire;
+
+		Q_FOREACH (ConnectorItem * toConnectorItem, connectorItem->connectedToItems()) {
+			if (directAllowed(partition, connectorItem, toConnectorItem)) {
+				link(partition, i, toConnectorItem);
+			}
+		}
+
+		if (partition.crossLayers && !isWire) {
+			link(partition, i, connectorItem->getCrossLayerConnectorItem());
+		}
+
+		Bus * bus = connectorItem->bus();
+		if (bus != nullptr && (isWire || !partition.skipBuses)) {
+			QList<ConnectorItem *> busConnectedItems;
+			connectorItem->attachedTo()->busConnectorItems(bus, connectorItem, busConnectedItems);
+			Q_FOREACH (ConnectorItem * busConnectedItem, busConnectedItems) {
+				link(partition, i, busConnectedItem);
+			}
+		}
+	}
+
+	partition.generation = m_generation;
+	partition.staleQueries = 0;
+}
+
+void ConnectivityIndex::link(Partition & partition, int node, ConnectorItem * to)
+{
+	if (to == nullptr) return;
+
+	// skipped wires and connectors outside the scene are not nodes
+	int toNode = partition.nodes.value(to, -1);
+	if (toNode >= 0) {
+		join(partition, node, toNode);
+	}
+}
+
+int ConnectivityIndex::find(Partition & partition, int node)
+{
+	while (partition.parents.at(node) != node) {
+		int parent = partition.parents.at(node);
+		partition.parents[node] = partition.parents.at(parent);     // path halving
+		node = parent;
+	}
+	return node;
+}
+
+void ConnectivityIndex::join(Partition & partition, int node1, int node2)
+{
+	int root1 = find(partition, node1);
+	int root2 = find(partition, node2);
+	if (root1 == root2) return;
+
+	partition.parents[root2] = root1;
+
+	// splice the two member rings together
+	int next1 = partition.next.at(node1);
+	partition.next[node1] = partition.next.at(node2);
+	partition.next[node2] = next1;
+}
+
+bool ConnectivityIndex::skipped(const Partition & partition, ConnectorItem * connectorItem)
+{
+	if (connectorItem->attachedToItemType() != ModelPart::Wire) return false;
+
+	auto * wire = qobject_cast<Wire *>(connectorItem->attachedTo());
+	return wire != nullptr && wire->hasAnyFlag(partition.skipFlags);
+}
+
+bool ConnectivityIndex::directAllowed(const Partition & partition, ConnectorItem * from, ConnectorItem * to)
+{
+	// direct (part-to-part) connections are not followed when normal wires are skipped
+	if (!(partition.skipFlags & ViewGeometry::NormalFlag)) return true;
+
+	return from->attachedToItemType() == ModelPart::Wire || to->attachedToItemType() == ModelPart::Wire;
+}
@@ -0,0 +1,80 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef CONNECTIVITYINDEX_H
+#define CONNECTIVITYINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QVector>
+
+#include "../viewgeometry.h"
+
+class ConnectivityIndex : public QObject
+{
+	// equal-potential components of one scene, kept as a union-find per (crossLayers, skipFlags, skipBuses)
+	// combination; new connections are merged in place, anything else marks the partitions for a rebuild
+
+	Q_OBJECT
+
+public:
+	static bool collect(QList<class ConnectorItem *> & connectorItems, bool crossLayers, ViewGeometry::WireFlags skipFlags, bool skipBuses);
+	static void connected(class ConnectorItem *, class ConnectorItem *);
+	static void invalidate(class QGraphicsItem *);
+	static void invalidate(class QGraphicsScene *);
+
+protected:
+	struct Partition {
+		bool crossLayers = false;
+		ViewGeometry::WireFlags skipFlags = ViewGeometry::NoFlag;
+		bool skipBuses = false;
+		int generation = -1;
+		int staleGeneration = -1;
+		int staleQueries = 0;            // lookups that fell back at staleGeneration
+		QHash<ConnectorItem *, int> nodes;
+		QVector<ConnectorItem *> items;
+		QVector<int> parents;
+		QVector<int> next;               // members of a component form a ring
+	};
+
+	ConnectivityIndex(class QGraphicsScene *);
+	~ConnectivityIndex();
+
+	bool lookup(QList<ConnectorItem *> & connectorItems, bool crossLayers, ViewGeometry::WireFlags skipFlags, bool skipBuses);
+	void unite(ConnectorItem *, ConnectorItem *);
+	void rebuild(Partition &);
+	void link(Partition &, int node, ConnectorItem * to);
+
+	static int find(Partition &, int node);
+	static void join(Partition &, int node1, int node2);
+	static bool skipped(const Partition &, ConnectorItem *);
+	static bool directAllowed(const Partition &, ConnectorItem * from, ConnectorItem * to);
+
+protected:
+	static const int QueriesBeforeRebuild = 8;
+
+	class QGraphicsScene * m_scene = nullptr;
+	int m_generation = 0;
+	QHash<quint64, Partition> m_partitions;
+
+	static QHash<class QGraphicsScene *, ConnectivityIndex *> Indexes;
+};
+
+#endif
@@ -85,6 +85,10 @@ ConnectorShared * Connector::connectorShared() {
 	return m_connectorShared;
 }
 
+void Connector::setConnectorShared(ConnectorShared * connectorShared) {
+	m_connectorShared = connectorShared;
+}
+
 void Connector::addViewItem(ConnectorItem * item) {
 	//item->debugInfo(QString("add view item c:%1 ci:%2 b:%3").arg((long) this, 0, 16).arg((long) item, 0, 16).arg((long) m_bus.data(), 0, 16));
 	m_connectorItems.insert(QuickHash(item->attachedToViewID(), item->attachedToViewLayerID()), item);
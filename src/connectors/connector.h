@@ -51,6 +51,7 @@ public:
 	void addViewItem(class ConnectorItem *);
 	void removeViewItem(class ConnectorItem *);
 	class ConnectorShared * connectorShared();
+	void setConnectorShared(class ConnectorShared *);
 	void connectTo(Connector *);
 	void disconnectFrom(Connector *);
 	void saveAsPart(QXmlStreamWriter & writer);
@@ -0,0 +1,142 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "connectorgrid.h"
+#include "connectoritem.h"
+#include "../items/itembase.h"
+
+#include <QGraphicsScene>
+#include <QPainterPath>
+
+#include <algorithm>
+#include <cmath>
+
+ConnectorGrid::ConnectorGrid(QGraphicsScene * scene, const QSet<ItemBase *> & moving, const QSet<ConnectorItem *> & live)
+{
+	double totalSize = 0;
+	Q_FOREACH (QGraphicsItem * item, scene->items()) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr) continue;
+
+		bool isMoving = moving.contains(itemBase);
+		Q_FOREACH (ConnectorItem * connectorItem, itemBase->cachedConnectorItems()) {
+			if (isMoving || live.contains(connectorItem) || connectorItem->hasRubberBandLeg()) {
+				m_live.append(connectorItem);
+				continue;
+			}
+
+			Entry entry;
+			entry.connectorItem = connectorItem;
+			entry.rect = connectorItem->sceneBoundingRect();
+			m_entries.append(entry);
+			totalSize += qMax(entry.rect.width(), entry.rect.height());
+		}
+	}
+
+	// a few connectors to a cell
+	if (!m_entries.isEmpty()) {
+		m_cellSize = qMax(1.0, 4 * totalSize / m_entries.count());
+	}
+
+	for (int i = 0; i < m_entries.count(); i++) {
+		const QRectF & rect = m_entries.at(i).rect;
+		int left = (int) std::floor(rect.left() / m_cellSize);
+		int right = (int) std::floor(rect.right() / m_cellSize);
+		int top = (int) std::floor(rect.top() / m_cellSize);
+		int bottom = (int) std::floor(rect.bottom() / m_cellSize);
+		for (int x = left; x <= right; x++) {
+			for (int y = top; y <= bottom; y++) {
+				m_cells[cellKey(x, y)].append(i);
+			}
+		}
+	}
+}
+
+QList<ConnectorItem *> ConnectorGrid::connectorsAt(const QPointF & point) const
+{
+	// the same hits as QGraphicsScene::items(point), topmost first
+	QList<ConnectorItem *> result;
+	Q_FOREACH (ConnectorItem * connectorItem, candidates(QRectF(point, QSizeF(0, 0)))) {
+		if (connectorItem->contains(connectorItem->mapFromScene(point))) {
+			result.append(connectorItem);
+		}
+	}
+	return result;
+}
+
+QList<ConnectorItem *> ConnectorGrid::connectorsIn(const QPolygonF & polygon) const
+{
+	QPainterPath path;
+	path.addPolygon(polygon);
+	path.closeSubpath();
+
+	QList<ConnectorItem *> result;
+	Q_FOREACH (ConnectorItem * connectorItem, candidates(polygon.boundingRect())) {
+		if (connectorItem->collidesWithPath(connectorItem->mapFromScene(path))) {
+			result.append(connectorItem);
+		}
+	}
+	return result;
+}
+
+QList<ConnectorItem *> ConnectorGrid::candidates(const QRectF & rect) const
+{
+	QList<ConnectorItem *> result;
+	QSet<int> seen;
+	int left = (int) std::floor(rect.left() / m_cellSize);
+	int right = (int) std::floor(rect.right() / m_cellSize);
+	int top = (int) std::floor(rect.top() / m_cellSize);
+	int bottom = (int) std::floor(rect.bottom() / m_cellSize);
+	for (int x = left; x <= right; x++) {
+		for (int y = top; y <= bottom; y++) {
+			auto cell = m_cells.constFind(cellKey(x, y));
+			if (cell == m_cells.constEnd()) continue;
+
+			Q_FOREACH (int i, cell.value()) {
+				if (seen.contains(i)) continue;
+
+				seen.insert(i);
+				const Entry & entry = m_entries.at(i);
+				if (entry.connectorItem.isNull() || !entry.connectorItem->isVisible()) continue;
+				if (!entry.rect.intersects(rect) && !entry.rect.contains(rect.topLeft())) continue;
+
+				result.append(entry.connectorItem.data());
+			}
+		}
+	}
+
+	Q_FOREACH (ConnectorItem * connectorItem, m_live) {
+		if (connectorItem == nullptr || !connectorItem->isVisible()) continue;
+
+		QRectF bounds = connectorItem->sceneBoundingRect();
+		if (!bounds.intersects(rect) && !bounds.contains(rect.topLeft())) continue;
+
+		result.append(connectorItem);
+	}
+
+	std::stable_sort(result.begin(), result.end(), [](ConnectorItem * c1, ConnectorItem * c2) {
+		return c1->zValue() > c2->zValue();
+	});
+	return result;
+}
+
+quint64 ConnectorGrid::cellKey(int x, int y) const
+{
+	return (((quint64) (quint32) x) << 32) | (quint32) y;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef CONNECTORGRID_H
+#define CONNECTORGRID_H
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QPolygonF>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+class ConnectorItem;
+
+class ConnectorGrid
+{
+	// uniform grid over the scene rects of the connectors that stay put during a drag;
+	// connectors that move with the drag are checked where they are at each query
+
+public:
+	ConnectorGrid(class QGraphicsScene *, const QSet<class ItemBase *> & moving, const QSet<ConnectorItem *> & live);
+
+	QList<ConnectorItem *> connectorsAt(const QPointF &) const;
+	QList<ConnectorItem *> connectorsIn(const QPolygonF &) const;
+
+protected:
+	QList<ConnectorItem *> candidates(const QRectF &) const;
+	quint64 cellKey(int x, int y) const;
+
+protected:
+	struct Entry {
+		QPointer<ConnectorItem> connectorItem;
+		QRectF rect;
+	};
+
+	double m_cellSize = 1;
+	QVector<Entry> m_entries;
+	QHash<quint64, QVector<int> > m_cells;
+	QVector<QPointer<ConnectorItem> > m_live;
+};
+
+#endif
@@ -225,6 +225,9 @@ parts editor support
 #include "../utils/bezierdisplay.h"
 #include "../utils/cursormaster.h"
 #include "ercdata.h"
+#include "connectivityindex.h"
+#include "connectorgrid.h"
+#include "../testing/FTimingProbe.h"
 
 /////////////////////////////////////////////////////////
 
@@ -329,6 +332,7 @@ ConnectorItem::ConnectorItem( Connector * connector, ItemBase * attachedTo )
 
 ConnectorItem::~ConnectorItem() {
 	m_equalPotentialDisplayItems.removeOne(this);
+	ConnectivityIndex::invalidate(this);
 	//DebugDialog::debug(QString("deleting connectorItem %1").arg((long) this, 0, 16));
 	Q_FOREACH (ConnectorItem * connectorItem, m_connectedTo) {
 		if (connectorItem) {
@@ -458,6 +462,7 @@ void ConnectorItem::connectTo(ConnectorItem * connected) {
 	if (m_connectedTo.contains(connected)) return;
 
 	m_connectedTo.append(connected);
+	ConnectivityIndex::connected(this, connected);
 	//DebugDialog::debug(QString("connect to cc:%4 this:%1 to:%2 %3").arg((long) this, 0, 16).arg((long) connected, 0, 16).arg(connected->attachedTo()->modelPartShared()->title()).arg(m_connectedTo.count()) );
 	QList<ConnectorItem *> visited;
 	restoreColor(visited);
@@ -472,6 +477,7 @@ ConnectorItem * ConnectorItem::removeConnection(ItemBase * itemBase) {
 		if (m_connectedTo[i]->attachedTo() == itemBase) {
 			ConnectorItem * removed = m_connectedTo[i];
 			m_connectedTo.removeAt(i);
+			ConnectivityIndex::invalidate(this);
 			if (m_attachedTo) {
 				m_attachedTo->connectionChange(this, removed, false);
 			}
@@ -493,6 +499,7 @@ void ConnectorItem::removeConnection(ConnectorItem * connectedItem, bool emitCha
 	if (!connectedItem) return;
 
 	m_connectedTo.removeOne(connectedItem);
+	ConnectivityIndex::invalidate(this);
 	QList<ConnectorItem *> visited;
 	restoreColor(visited);
 	if (emitChange) {
@@ -501,7 +508,10 @@ void ConnectorItem::removeConnection(ConnectorItem * connectedItem, bool emitCha
 }
 
 void ConnectorItem::tempConnectTo(ConnectorItem * item, bool applyColor) {
-	if (!m_connectedTo.contains(item)) m_connectedTo.append(item);
+	if (!m_connectedTo.contains(item)) {
+		m_connectedTo.append(item);
+		ConnectivityIndex::connected(this, item);
+	}
 
 	if(applyColor) {
 		QList<ConnectorItem *> visited;
@@ -511,6 +521,7 @@ void ConnectorItem::tempConnectTo(ConnectorItem * item, bool applyColor) {
 
 void ConnectorItem::tempRemove(ConnectorItem * item, bool applyColor) {
 	m_connectedTo.removeOne(item);
+	ConnectivityIndex::invalidate(this);
 
 	if(applyColor) {
 		QList<ConnectorItem *> visited;
@@ -1336,6 +1347,13 @@ void ConnectorItem::collectEqualPotential(
 		ViewGeometry::WireFlags skipFlags,
 		bool skipBuses)
 {
+	static FTimingProbe probe("collectEqualPotential");
+	FTimingProbe::Scope timing(probe);
+
+	// answered from the scene's index when it is current, otherwise by the traversal below;
+	// the index keeps the seeds first, but the order of the rest differs from the traversal's
+	if (ConnectivityIndex::collect(connectorItems, crossLayers, skipFlags, skipBuses)) return;
+
 	// take a local (temporary working) copy of the supplied list, and wipe the original
 	QList<ConnectorItem *> tempItems = connectorItems;
 	connectorItems.clear();
@@ -1668,11 +1686,20 @@ void ConnectorItem::paint(QPainter * painter, const QStyleOptionGraphicsItem * o
 	if (m_hybrid) return;
 	if (doNotPaint()) return;
 
+	ItemBase::DetailLevel detail = ItemBase::detailLevel(painter, widget);
 	if (m_legPolygon.count() > 1) {
-		paintLeg(painter);
+		if (detail == ItemBase::OutlineOnly) {
+			painter->setPen(legPen());
+			painter->drawPolyline(m_legPolygon);
+		}
+		else {
+			paintLeg(painter);
+		}
 		return;
 	}
 
+	if (detail != ItemBase::FullDetail) return;
+
 	if (m_effectively == EffectivelyUnknown) {
 		if (!m_circular && m_shape.isEmpty()) {
 			if (this->attachedTo()->viewID() == ViewLayer::PCBView) {
@@ -1828,7 +1855,18 @@ bool ConnectorItem::connectedToWires() {
 	return false;
 }
 
+ViewGeometry::WireFlags ConnectorItem::ratsnestSkipFlags(ViewGeometry::WireFlags myFlag) {
+	// wires of the other views' kinds, and ratsnest lines, don't join connectors when choosing a ratsnest
+	return (ViewGeometry::RatsnestFlag | ViewGeometry::NormalFlag | ViewGeometry::PCBTraceFlag | ViewGeometry::SchematicTraceFlag) ^ myFlag;
+}
+
 void ConnectorItem::displayRatsnest(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags myFlag) {
+	ConnectorPairHash result;
+	GraphUtils::chooseRatsnestGraph(&partConnectorItems, ratsnestSkipFlags(myFlag), result);
+	displayRatsnest(partConnectorItems, result);
+}
+
+void ConnectorItem::displayRatsnest(QList<ConnectorItem *> & partConnectorItems, const ConnectorPairHash & result) {
 	bool formerColorWasNamed = false;
 	bool gotFormerColor = false;
 	QColor formerColor;
@@ -1867,9 +1905,6 @@ void ConnectorItem::displayRatsnest(QList<ConnectorItem *> & partConnectorItems,
 		}
 	}
 
-	ConnectorPairHash result;
-	GraphUtils::chooseRatsnestGraph(&partConnectorItems, (ViewGeometry::RatsnestFlag | ViewGeometry::NormalFlag | ViewGeometry::PCBTraceFlag | ViewGeometry::SchematicTraceFlag) ^ myFlag, result);
-
 	Q_FOREACH (ConnectorItem * key, result.uniqueKeys()) {
 		Q_FOREACH (ConnectorItem * value, result.values(key)) {
 			VirtualWire * vw = infoGraphicsView->makeOneRatsnestWire(key, value, false, color, false);
@@ -1979,14 +2014,28 @@ double ConnectorItem::minDimension() {
 
 ConnectorItem * ConnectorItem::findConnectorUnder(bool useTerminalPoint, bool allowAlready, const QList<ConnectorItem *> & exclude, bool displayDragTooltip, ConnectorItem * other)
 {
-	QList<QGraphicsItem *> items = useTerminalPoint
-	                               ? this->scene()->items(this->sceneAdjustedTerminalPoint(nullptr))
-	                               : this->scene()->items(mapToScene(this->rect()));  // only wires use rect
+	QList<ConnectorItem *> unders;
+	InfoGraphicsView * infoGraphicsView = InfoGraphicsView::getInfoGraphicsView(this);
+	ConnectorGrid * connectorGrid = infoGraphicsView ? infoGraphicsView->connectorGrid() : nullptr;
+	if (connectorGrid) {
+		// a drag in progress keeps the connectors that stay put in a grid
+		unders = useTerminalPoint
+		         ? connectorGrid->connectorsAt(this->sceneAdjustedTerminalPoint(nullptr))
+		         : connectorGrid->connectorsIn(mapToScene(this->rect()));
+	}
+	else {
+		QList<QGraphicsItem *> items = useTerminalPoint
+		                               ? this->scene()->items(this->sceneAdjustedTerminalPoint(nullptr))
+		                               : this->scene()->items(mapToScene(this->rect()));  // only wires use rect
+		Q_FOREACH (QGraphicsItem * item, items) {
+			auto * connectorItemUnder = dynamic_cast<ConnectorItem *>(item);
+			if (connectorItemUnder) unders.append(connectorItemUnder);
+		}
+	}
+
 	QList<ConnectorItem *> candidates;
 	// for the moment, take the topmost ConnectorItem that doesn't belong to me
-	Q_FOREACH (QGraphicsItem * item, items) {
-		auto * connectorItemUnder = dynamic_cast<ConnectorItem *>(item);
-		if (!connectorItemUnder) continue;
+	Q_FOREACH (ConnectorItem * connectorItemUnder, unders) {
 		if (!connectorItemUnder->connector()) continue;  // shouldn't happen
 		if (attachedTo()->childItems().contains(connectorItemUnder)) continue;  // don't use own connectors
 		if (!this->connectionIsAllowed(connectorItemUnder)) {
@@ -2397,7 +2446,7 @@ void ConnectorItem::calcConnectorEnd()
 
 	bezier->set_endpoints(p0, p1);
 	m_connectorDetectT = m_connectorDrawT = 0;
-	double blen = bezier->computeCubicCurveLength(1.0, 24);
+	double blen = bezier->length();
 	if (blen < StandardLegConnectorDetectLength) {
 		return;
 	}
@@ -2408,28 +2457,8 @@ void ConnectorItem::calcConnectorEnd()
 
 double ConnectorItem::findT(Bezier * bezier, double blen, double length)
 {
-	// use binary search to find a value for t
-	double tmax = 1.0;
-	double tmin = 0;
-	double t = 1.0 - (length / blen);
-	while (true) {
-		double l = bezier->computeCubicCurveLength(t, 24);
-		if (qAbs(blen - length - l) < .0001) {
-			return t;
-		}
-
-		if (blen - length - l > 0) {
-			// too short
-			tmin = t;
-			t = (t + tmax) / 2;
-		}
-		else {
-			// too long
-			tmax = t;
-			t = (t + tmin) / 2;
-		}
-	}
-	return t;
+	// t for the point length back from the end, from the bezier's arc length table
+	return bezier->tAtLength(blen - length);
 }
 
 const QString & ConnectorItem::legID(ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID) {
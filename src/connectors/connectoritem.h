@@ -105,6 +105,7 @@ public:
 	bool isInLayers(ViewLayer::ViewLayerPlacement);
 	ConnectorItem * getCrossLayerConnectorItem();
 	void displayRatsnest(QList<ConnectorItem *> & partsConnectorItems, ViewGeometry::WireFlags myFlag);
+	void displayRatsnest(QList<ConnectorItem *> & partsConnectorItems, const ConnectorPairHash & chosen);
 	void clearRatsnestDisplay(QList<ConnectorItem *> & connectorItems);
 	double calcClipRadius();
 	bool isEffectivelyCircular();
@@ -245,6 +246,7 @@ public:
 	static bool isGrounded(ConnectorItem * c1, ConnectorItem * c2);
 	static void collectConnectorNames(QList<ConnectorItem *> & connectorItems, QStringList & connectorNames);
 	static class Wire * directlyWiredTo(ConnectorItem * source, ConnectorItem * target, ViewGeometry::WireFlags flags);
+	static ViewGeometry::WireFlags ratsnestSkipFlags(ViewGeometry::WireFlags myFlag);
 
 public:
 	static const QList<ConnectorItem *> emptyConnectorItemList;
@@ -23,6 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "busshared.h"
 #include "ercdata.h"
 #include "src/utils/misc.h"
+#include "src/utils/stringpool.h"
 
 #include <QTextStream>
 
@@ -41,13 +42,13 @@ ConnectorShared::ConnectorShared()
 ConnectorShared::ConnectorShared( const QDomElement & domElement )
 {
 	m_ercData = nullptr;
-	m_id = domElement.attribute("id", "");
-	m_name = domElement.attribute("name", "");
+	m_id = StringPool::intern(domElement.attribute("id", ""));
+	m_name = StringPool::intern(domElement.attribute("name", ""));
 	m_replacedby = domElement.attribute("replacedby", "");
 	//DebugDialog::debug(QString("\tname:%1 id:%2").arg(m_name).arg(m_id));
-	m_typeString = domElement.attribute("type", "");
+	m_typeString = StringPool::intern(domElement.attribute("type", ""));
 	m_type = Connector::connectorTypeFromName(m_typeString);
-	m_description = domElement.firstChildElement("description").text();
+	m_description = StringPool::intern(domElement.firstChildElement("description").text());
 	QDomElement erc = domElement.firstChildElement("erc");
 	if (!erc.isNull()) {
 		m_ercData = new ErcData(erc);
@@ -85,7 +86,7 @@ const QString & ConnectorShared::id() const {
 }
 
 void ConnectorShared::setId(QString id) {
-	m_id = id;
+	m_id = StringPool::intern(id);
 }
 
 const QString & ConnectorShared::description() {
@@ -93,7 +94,7 @@ const QString & ConnectorShared::description() {
 }
 
 void ConnectorShared::setDescription(QString description) {
-	m_description = description;
+	m_description = StringPool::intern(description);
 }
 
 const QString & ConnectorShared::sharedName() {
@@ -101,7 +102,7 @@ const QString & ConnectorShared::sharedName() {
 }
 
 void ConnectorShared::setSharedName(QString name) {
-	m_name = name;
+	m_name = StringPool::intern(name);
 }
 
 Connector::ConnectorType ConnectorShared::connectorType() {
@@ -141,10 +142,10 @@ void ConnectorShared::insertPin(ViewLayer::ViewID layer, SvgIdLayer * svgIdLayer
 void ConnectorShared::addPin(ViewLayer::ViewID viewID, const QString & svgId, ViewLayer::ViewLayerID viewLayerID, const QString & terminalId, const QString & legId, bool hybrid) {
 	auto * svgIdLayer = new SvgIdLayer(viewID);
 	svgIdLayer->m_svgViewLayerID = viewLayerID;
-	svgIdLayer->m_svgId = svgId;
-	svgIdLayer->m_terminalId = terminalId;
+	svgIdLayer->m_svgId = StringPool::intern(svgId);
+	svgIdLayer->m_terminalId = StringPool::intern(terminalId);
 	svgIdLayer->m_hybrid = hybrid;
-	svgIdLayer->m_legId = legId;
+	svgIdLayer->m_legId = StringPool::intern(legId);
 	m_pins.insert(viewID, svgIdLayer);
 	// DebugDialog::debug(QString("insert a %1 %2 %3").arg(layer).arg(connectorId).arg(viewLayerID));
 }
@@ -204,12 +205,12 @@ void ConnectorShared::loadPin(QDomElement elem, ViewLayer::ViewID viewID) {
 		QString layer = pinElem.attribute("layer");
 		auto * svgIdLayer = new SvgIdLayer(viewID);
 		svgIdLayer->m_hybrid = (pinElem.attribute("hybrid").compare("yes") == 0);
-		svgIdLayer->m_legId = pinElem.attribute("legId");
-		svgIdLayer->m_svgId = svgId;
+		svgIdLayer->m_legId = StringPool::intern(pinElem.attribute("legId"));
+		svgIdLayer->m_svgId = StringPool::intern(svgId);
 		svgIdLayer->m_svgViewLayerID = ViewLayer::viewLayerIDFromXmlString(layer);
 
 		//DebugDialog::debug(QString("svg id view layer id %1, %2").arg(svgIdLayer->m_viewLayerID).arg(layer));
-		svgIdLayer->m_terminalId = pinElem.attribute("terminalId");
+		svgIdLayer->m_terminalId = StringPool::intern(pinElem.attribute("terminalId"));
 		//if (!svgIdLayer->m_terminalId.isEmpty()) {
 		//	DebugDialog::debug("terminalid " + svgIdLayer->m_terminalId);
 		//}
@@ -23,6 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QString>
 #include <QDomElement>
+#include <QXmlStreamWriter>
 #include <QHash>
 #include <QList>
 
@@ -66,14 +67,24 @@ public:
 	ErcData(const QDomElement & ercElement);
 
 	bool writeToElement(QDomElement & ercElement, QDomDocument & doc);
+	bool writeToStream(QXmlStreamWriter &);
 	constexpr EType eType() const noexcept { return m_eType; }
 	constexpr Ignore ignore() const noexcept { return m_ignore; }
+	constexpr CurrentFlow currentFlow() const noexcept { return m_currentFlow; }
+	constexpr ValidReal voltage() const noexcept { return m_voltage; }
+	constexpr ValidReal voltageMin() const noexcept { return m_voltageMin; }
+	constexpr ValidReal voltageMax() const noexcept { return m_voltageMax; }
+	constexpr ValidReal current() const noexcept { return m_current; }
+	constexpr ValidReal currentMin() const noexcept { return m_currentMin; }
+	constexpr ValidReal currentMax() const noexcept { return m_currentMax; }
 
 protected:
 	void readVoltage(QDomElement &);
 	void readCurrent(QDomElement &);
 	void writeVoltage(QDomElement &, QDomDocument &);
 	void writeCurrent(QDomElement &, QDomDocument &);
+	void writeVoltage(QXmlStreamWriter &);
+	void writeCurrent(QXmlStreamWriter &);
 
 protected:
 	EType m_eType;
@@ -0,0 +1,213 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "ercengine.h"
+
+#include <algorithm>
+#include <cmath>
+
+const double ErcEngine::VoltageTolerance = 0.001;
+
+static QString volts(double v)
+{
+	return QString("%1V").arg(v);
+}
+
+static QString pinName(const ErcPin & pin)
+{
+	return QString("%1 %2").arg(pin.part, pin.connector);
+}
+
+QList<ErcViolation> ErcEngine::check(const QList<ErcNet> & nets)
+{
+	QHash<QString, QList<ErcViolation> > results;
+	QList<ErcViolation> violations;
+	m_evaluated = 0;
+	for (int i = 0; i < nets.count(); i++) {
+		const ErcNet & net = nets.at(i);
+		if (net.pins.isEmpty()) continue;
+
+		QString key = signature(net);
+		QList<ErcViolation> netViolations;
+		if (m_results.contains(key)) {
+			netViolations = m_results.value(key);
+		}
+		else {
+			netViolations = checkNet(net);
+			m_evaluated++;
+		}
+		results.insert(key, netViolations);
+
+		Q_FOREACH (ErcViolation violation, netViolations) {
+			violation.net = i;
+			violations.append(violation);
+		}
+	}
+
+	// nets that are gone don't stay in the cache
+	m_results = results;
+	return violations;
+}
+
+int ErcEngine::evaluated() const
+{
+	return m_evaluated;
+}
+
+void ErcEngine::clear()
+{
+	m_results.clear();
+	m_evaluated = 0;
+}
+
+QString ErcEngine::signature(const ErcNet & net)
+{
+	// the same pins with the same data give the same result, in whatever order they were collected
+	auto number = [](const ValidReal & value) {
+		return value ? QString::number(value.value()) : QString();
+	};
+
+	QStringList pins;
+	for (const ErcPin & pin : net.pins) {
+		QStringList fields;
+		fields << pin.part << pin.connector << QString::number(pin.eType) << QString::number(pin.currentFlow)
+			<< number(pin.voltage) << number(pin.voltageMin) << number(pin.voltageMax)
+			<< number(pin.current) << number(pin.currentMax);
+		pins << fields.join("\t");
+	}
+	std::sort(pins.begin(), pins.end());
+	return pins.join("\n");
+}
+
+QList<ErcViolation> ErcEngine::checkNet(const ErcNet & net)
+{
+	QList<ErcViolation> violations;
+
+	QList<const ErcPin *> supplies;
+	QList<const ErcPin *> inputs;
+	QList<const ErcPin *> grounds;
+	for (const ErcPin & pin : net.pins) {
+		if (pin.eType == ErcData::Ground) {
+			grounds << &pin;
+		}
+		else if (pin.eType == ErcData::VCC) {
+			if (pin.currentFlow == ErcData::Sink) inputs << &pin;
+			else if (pin.voltage) supplies << &pin;
+		}
+	}
+
+	if (supplies.count() > 1) {
+		QList<double> voltages;
+		QStringList parts;
+		Q_FOREACH (const ErcPin * supply, supplies) {
+			parts << supply->part;
+			bool found = false;
+			Q_FOREACH (double v, voltages) {
+				if (std::fabs(v - supply->voltage.value()) < VoltageTolerance) found = true;
+			}
+			if (!found) voltages << supply->voltage.value();
+		}
+		if (voltages.count() > 1) {
+			std::sort(voltages.begin(), voltages.end());
+			QStringList text;
+			Q_FOREACH (double v, voltages) text << volts(v);
+			ErcViolation violation;
+			violation.kind = ErcViolation::SupplyConflict;
+			violation.message = tr("Supplies of %1 are connected together").arg(text.join(", "));
+			violation.parts = parts;
+			violations << violation;
+		}
+	}
+
+	if (!grounds.isEmpty()) {
+		Q_FOREACH (const ErcPin * supply, supplies) {
+			if (std::fabs(supply->voltage.value()) < VoltageTolerance) continue;
+
+			ErcViolation violation;
+			violation.kind = ErcViolation::SupplyShort;
+			violation.message = tr("The %1 supply of %2 is connected to ground").arg(volts(supply->voltage.value()), supply->part);
+			violation.parts << supply->part;
+			Q_FOREACH (const ErcPin * ground, grounds) violation.parts << ground->part;
+			violations << violation;
+		}
+	}
+
+	if (inputs.isEmpty()) return violations;
+
+	if (supplies.isEmpty()) {
+		Q_FOREACH (const ErcPin * input, inputs) {
+			ErcViolation violation;
+			violation.kind = ErcViolation::Unpowered;
+			violation.message = tr("Power input %1 has no supply on its net").arg(pinName(*input));
+			violation.parts << input->part;
+			violations << violation;
+		}
+		return violations;
+	}
+
+	double supplied = supplies.first()->voltage.value();
+	Q_FOREACH (const ErcPin * input, inputs) {
+		bool under = input->voltageMin && supplied < input->voltageMin.value() - VoltageTolerance;
+		bool over = input->voltageMax && supplied > input->voltageMax.value() + VoltageTolerance;
+		if (!under && !over) continue;
+
+		QString range;
+		if (input->voltageMin && input->voltageMax) {
+			range = tr("%1 to %2").arg(volts(input->voltageMin.value()), volts(input->voltageMax.value()));
+		}
+		else if (input->voltageMin) {
+			range = tr("at least %1").arg(volts(input->voltageMin.value()));
+		}
+		else {
+			range = tr("at most %1").arg(volts(input->voltageMax.value()));
+		}
+
+		ErcViolation violation;
+		violation.kind = ErcViolation::VoltageRange;
+		violation.message = tr("Power input %1 takes %2 but is supplied %3").arg(pinName(*input), range, volts(supplied));
+		violation.parts << input->part << supplies.first()->part;
+		violations << violation;
+	}
+
+	// a supply without a rating (power symbols give 0) can't be overloaded
+	double capacity = 0;
+	Q_FOREACH (const ErcPin * supply, supplies) {
+		if (!supply->currentMax || supply->currentMax.value() <= 0) return violations;
+
+		capacity += supply->currentMax.value();
+	}
+
+	double drawn = 0;
+	Q_FOREACH (const ErcPin * input, inputs) {
+		if (input->current) drawn += input->current.value();
+		else if (input->currentMax) drawn += input->currentMax.value();
+	}
+
+	if (drawn > capacity) {
+		ErcViolation violation;
+		violation.kind = ErcViolation::OverCurrent;
+		violation.message = tr("The power inputs draw %1A from supplies rated for %2A").arg(drawn).arg(capacity);
+		Q_FOREACH (const ErcPin * input, inputs) violation.parts << input->part;
+		Q_FOREACH (const ErcPin * supply, supplies) violation.parts << supply->part;
+		violations << violation;
+	}
+
+	return violations;
+}
@@ -0,0 +1,87 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef ERCENGINE_H
+#define ERCENGINE_H
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "ercdata.h"
+
+struct ErcPin {
+	QString part;                           // instance title
+	QString connector;                      // connector name
+	ErcData::EType eType = ErcData::UnknownEType;
+	ErcData::CurrentFlow currentFlow = ErcData::UnknownFlow;
+	ValidReal voltage;                      // a power symbol's own voltage rather than its part's
+	ValidReal voltageMin;
+	ValidReal voltageMax;
+	ValidReal current;
+	ValidReal currentMax;
+};
+
+struct ErcNet {
+	QList<ErcPin> pins;                     // the connectors with erc data, less the ones to ignore
+};
+
+struct ErcViolation {
+	enum Kind {
+		SupplyConflict,                     // supplies of different voltages on one net
+		SupplyShort,                        // a supply on a ground net
+		VoltageRange,                       // a supply outside what a power input takes
+		OverCurrent,                        // the inputs draw more than the supplies give
+		Unpowered                           // a power input with no supply on its net
+	};
+
+	Kind kind = SupplyConflict;
+	int net = -1;                           // into the nets given to check()
+	QString message;
+	QStringList parts;                      // instance titles
+};
+
+class ErcEngine
+{
+	// electrical rule checks over every net of a sketch in one sweep; each net's result is kept
+	// by what the net holds, so checking again after an edit only evaluates the nets it changed
+
+	Q_DECLARE_TR_FUNCTIONS(ErcEngine)
+
+public:
+	QList<ErcViolation> check(const QList<ErcNet> &);
+	int evaluated() const;                  // nets the last check() didn't find in the cache
+	void clear();
+
+public:
+	static QList<ErcViolation> checkNet(const ErcNet &);
+	static QString signature(const ErcNet &);
+
+public:
+	static const double VoltageTolerance;
+
+protected:
+	QHash<QString, QList<ErcViolation> > m_results;
+	int m_evaluated = 0;
+};
+
+#endif
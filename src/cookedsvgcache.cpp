@@ -0,0 +1,164 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "cookedsvgcache.h"
+#include "debugdialog.h"
+#include "utils/cachecounters.h"
+#include "utils/folderutils.h"
+#include "version/version.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+const quint32 CookedSvgCache::FormatVersion = 1;
+
+static const quint32 Magic = 0x465a4353;        // "FZCS"
+static const QString StampFileName("stamp");
+static const QString Suffix(".fzcs");
+
+static QString Folder;                           // empty until setPartsSha, which leaves the cache off
+static QByteArray Stamp;
+static CacheCounters Counters("svg_disk");
+
+static QString cookedPath(const QByteArray & key)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(Stamp);
+	hash.addData(key);
+	return QDir(Folder).absoluteFilePath(QString::fromLatin1(hash.result().toHex()) + Suffix);
+}
+
+static void writeInfos(QDataStream & stream, const QHash<QString, ConnectorInfo> & infos)
+{
+	stream << (qint32) infos.count();
+	for (auto it = infos.constBegin(); it != infos.constEnd(); ++it) {
+		const ConnectorInfo & info = it.value();
+		stream << it.key() << info.gotCircle << info.radius << info.strokeWidth << info.matrix
+		       << info.terminalMatrix << info.legMatrix << info.legColor << info.legLine
+		       << info.legStrokeWidth << info.gotPath;
+	}
+}
+
+static bool readInfos(QDataStream & stream, QHash<QString, ConnectorInfo> & infos)
+{
+	qint32 count;
+	stream >> count;
+	if (count < 0) return false;
+
+	for (int i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+		QString id;
+		ConnectorInfo info;
+		stream >> id >> info.gotCircle >> info.radius >> info.strokeWidth >> info.matrix
+		       >> info.terminalMatrix >> info.legMatrix >> info.legColor >> info.legLine
+		       >> info.legStrokeWidth >> info.gotPath;
+		infos.insert(id, info);
+	}
+	return stream.status() == QDataStream::Ok;
+}
+
+void CookedSvgCache::setPartsSha(const QString & sha)
+{
+	// turns the cache on; cooked files from another Fritzing version or parts sha are thrown away
+
+	QDir dir(FolderUtils::getTopLevelUserDataStorePath());
+	if (!dir.mkpath("svgcache")) {
+		DebugDialog::debug("unable to create svg cache folder");
+		return;
+	}
+
+	Folder = dir.absoluteFilePath("svgcache");
+	Stamp = QString("%1 %2 %3").arg(FormatVersion).arg(Version::versionString(), sha).toUtf8();
+
+	QFile stampFile(QDir(Folder).absoluteFilePath(StampFileName));
+	if (stampFile.open(QFile::ReadOnly)) {
+		QByteArray oldStamp = stampFile.readAll();
+		stampFile.close();
+		if (oldStamp == Stamp) return;
+	}
+
+	clear();
+	if (stampFile.open(QFile::WriteOnly)) {
+		stampFile.write(Stamp);
+		stampFile.close();
+	}
+}
+
+static bool readCooked(const QByteArray & key, CookedSvg & cooked)
+{
+	QFile file(cookedPath(key));
+	if (!file.open(QFile::ReadOnly)) return false;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+	quint32 magic, version;
+	stream >> magic >> version;
+	if (magic != Magic || version != CookedSvgCache::FormatVersion) return false;
+
+	CookedSvg fresh;
+	stream >> fresh.cleanContents;
+	if (!readInfos(stream, fresh.connectorInfos)) return false;
+	if (!readInfos(stream, fresh.nonConnectorInfos)) return false;
+	if (fresh.cleanContents.isEmpty()) return false;
+
+	cooked = fresh;
+	return true;
+}
+
+bool CookedSvgCache::find(const QByteArray & key, CookedSvg & cooked)
+{
+	if (Folder.isEmpty()) return false;
+
+	bool found = readCooked(key, cooked);
+	Counters.count(found);
+	return found;
+}
+
+void CookedSvgCache::insert(const QByteArray & key, const CookedSvg & cooked)
+{
+	if (Folder.isEmpty()) return;
+
+	// QSaveFile so a crash or a second Fritzing never leaves a half-written file behind
+	QSaveFile file(cookedPath(key));
+	if (!file.open(QFile::WriteOnly)) return;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_15);
+	stream << Magic << FormatVersion << cooked.cleanContents;
+	writeInfos(stream, cooked.connectorInfos);
+	writeInfos(stream, cooked.nonConnectorInfos);
+	if (stream.status() != QDataStream::Ok) {
+		file.cancelWriting();
+		return;
+	}
+	file.commit();
+}
+
+void CookedSvgCache::clear()
+{
+	if (Folder.isEmpty()) return;
+
+	QDir dir(Folder);
+	Q_FOREACH (QString name, dir.entryList(QStringList("*" + Suffix), QDir::Files)) {
+		dir.remove(name);
+	}
+}
@@ -0,0 +1,52 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef COOKEDSVGCACHE_H
+#define COOKEDSVGCACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include "fsvgrenderer.h"
+
+// a part svg as the renderer loads it, after unit fixes, coloring and connector discovery
+struct CookedSvg {
+	QByteArray cleanContents;
+	QHash<QString, ConnectorInfo> connectorInfos;
+	QHash<QString, ConnectorInfo> nonConnectorInfos;
+};
+
+class CookedSvgCache
+{
+	// cooked part svgs kept on disk from one launch to the next, one file per svg under the user data folder;
+	// keyed on the svg bytes and the load flags, and wiped whenever the Fritzing version or the parts sha changes
+
+public:
+	static void setPartsSha(const QString & sha);
+	static bool find(const QByteArray & key, CookedSvg &);
+	static void insert(const QByteArray & key, const CookedSvg &);
+	static void clear();
+
+public:
+	static const quint32 FormatVersion;
+};
+
+#endif
@@ -32,9 +32,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDir>
 #include <QtDebug>
 #include <QIcon>
+#include <QHash>
+#include <QSemaphore>
+#include <QThread>
 
 DebugDialog* DebugDialog::singleton = nullptr;
-QFile DebugDialog::m_file;
+std::atomic<int> DebugDialog::m_debugLevel(DebugDialog::Debug);
 
 #ifdef QT_NO_DEBUG
 bool DebugDialog::m_enabled = false;
@@ -58,6 +61,87 @@ public:
 	}
 };
 
+class DebugLogWriter : public QThread
+{
+	// appends to debug.txt on its own thread, keeping the file open; debug() only pushes
+	// the message onto a lock-free stack, which the writer takes whole and reverses
+
+public:
+	explicit DebugLogWriter(const QString & path) {
+		m_file.setFileName(path);
+	}
+
+	void push(const QString & message) {
+		auto * node = new Node { message, nullptr };
+		Node * head = m_head.load(std::memory_order_relaxed);
+		do {
+			node->next = head;
+		} while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+		// a batch is drained all at once, so only its first message needs to wake the writer
+		if (head == nullptr) {
+			m_wake.release();
+		}
+	}
+
+	void stop() {
+		m_stopping.store(true);
+		m_wake.release();
+		wait();
+		drain();                                        // whatever was pushed after the last batch
+		m_file.close();
+	}
+
+protected:
+	struct Node {
+		QString message;
+		Node * next;
+	};
+
+	void run() override {
+		while (!m_stopping.load()) {
+			m_wake.acquire();
+			drain();
+		}
+	}
+
+	void drain() {
+		Node * node = m_head.exchange(nullptr, std::memory_order_acquire);
+		Node * ordered = nullptr;
+		while (node != nullptr) {
+			Node * next = node->next;
+			node->next = ordered;
+			ordered = node;
+			node = next;
+		}
+		if (ordered == nullptr) return;
+
+		bool ok = m_file.isOpen() || m_file.open(QIODevice::Append | QIODevice::Text);
+		QTextStream out(&m_file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+		out.setCodec("UTF-8");
+#endif
+		while (ordered != nullptr) {
+			if (ok) {
+				out << ordered->message << "\n";
+			}
+			Node * next = ordered->next;
+			delete ordered;
+			ordered = next;
+		}
+		if (ok) {
+			out.flush();
+			m_file.flush();
+		}
+	}
+
+protected:
+	QFile m_file;
+	std::atomic<Node *> m_head { nullptr };
+	std::atomic<bool> m_stopping { false };
+	QSemaphore m_wake;
+};
+
 DebugDialog::DebugDialog(QWidget *parent)
 	: QDialog(parent)
 {
@@ -65,7 +149,6 @@ DebugDialog::DebugDialog(QWidget *parent)
 	this->setWindowIcon(QIcon(QPixmap(":resources/images/fritzing_icon.png")));
 
 	singleton = this;
-	m_debugLevel = DebugDialog::Debug;
 	setWindowTitle(tr("for debugging"));
 	resize(400, 300);
 	m_textEdit = new QTextEdit(this);
@@ -77,12 +160,15 @@ DebugDialog::DebugDialog(QWidget *parent)
 #endif
 	path += "/debug.txt";
 
-	m_file.setFileName(path);
-	m_file.remove();
+	QFile::remove(path);
+	m_writer = new DebugLogWriter(path);
+	m_writer->start(QThread::LowPriority);
 }
 
 DebugDialog::~DebugDialog()
 {
+	m_writer->stop();
+	delete m_writer;
 	if (m_textEdit != nullptr) {
 		delete m_textEdit;
 	}
@@ -113,22 +199,30 @@ void DebugDialog::resizeEvent(QResizeEvent *e) {
 }
 
 void DebugDialog::debug(QString prefix, const QPointF &point, DebugLevel debug, QObject *ancestor) {
+	if (!enabled(debug)) return;
+
 	QString msg = prefix+QString(" point: x=%1 y=%2").arg(point.x()).arg(point.y());
 	DebugDialog::debug(msg,debug,ancestor);
 }
 
 void DebugDialog::debug(QString prefix, const QRectF &rect, DebugLevel debug, QObject *ancestor) {
+	if (!enabled(debug)) return;
+
 	QString msg = prefix+QString(" rect: x=%1 y=%2 w=%3 h=%4")
 	              .arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height());
 	DebugDialog::debug(msg,debug,ancestor);
 }
 
 void DebugDialog::debug(QString prefix, const QPoint &point, DebugLevel debug, QObject *ancestor) {
+	if (!enabled(debug)) return;
+
 	QString msg = prefix+QString(" point: x=%1 y=%2").arg(point.x()).arg(point.y());
 	DebugDialog::debug(msg,debug,ancestor);
 }
 
 void DebugDialog::debug(QString prefix, const QRect &rect, DebugLevel debug, QObject *ancestor) {
+	if (!enabled(debug)) return;
+
 	QString msg = prefix+QString(" rect: x=%1 y=%2 w=%3 h=%4")
 	              .arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height());
 	DebugDialog::debug(msg,debug,ancestor);
@@ -136,7 +230,7 @@ void DebugDialog::debug(QString prefix, const QRect &rect, DebugLevel debug, QOb
 
 void DebugDialog::debug(QString message, DebugLevel debugLevel, QObject * ancestor) {
 
-	if (!m_enabled) return;
+	if (!enabled(debugLevel)) return;
 
 
 	if (singleton == nullptr) {
@@ -144,20 +238,9 @@ void DebugDialog::debug(QString message, DebugLevel debugLevel, QObject * ancest
 		//singleton->show();
 	}
 
-	if (debugLevel < singleton->m_debugLevel) {
-		return;
-	}
-
 	qDebug() << message;
 
-	if (m_file.open(QIODevice::Append | QIODevice::Text)) {
-		QTextStream out(&m_file);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-		out.setCodec("UTF-8");
-#endif
-		out << message << "\n";
-		m_file.close();
-	}
+	singleton->m_writer->push(message);
 	auto* de = new DebugEvent(message, debugLevel, ancestor);
 	QCoreApplication::postEvent(singleton, de);
 }
@@ -198,12 +281,22 @@ bool DebugDialog::connectToBroadcast(QObject * receiver, const char* slot) {
 }
 
 void DebugDialog::setDebugLevel(DebugLevel debugLevel) {
-	if (singleton == nullptr) {
-		new DebugDialog();
+	m_debugLevel.store(debugLevel);
+}
 
-	}
+bool DebugDialog::setDebugLevel(const QString & name) {
+	static const QHash<QString, DebugLevel> Levels = {
+		{ "debug", Debug },
+		{ "info", Info },
+		{ "warning", Warning },
+		{ "error", Error }
+	};
+
+	auto it = Levels.constFind(name.toLower());
+	if (it == Levels.constEnd()) return false;
 
-	singleton->m_debugLevel = debugLevel;
+	setDebugLevel(it.value());
+	return true;
 }
 
 void DebugDialog::cleanup() {
@@ -217,6 +310,10 @@ bool DebugDialog::enabled() {
 	return m_enabled;
 }
 
+bool DebugDialog::enabled(DebugLevel debugLevel) {
+	return m_enabled && debugLevel >= m_debugLevel.load(std::memory_order_relaxed);
+}
+
 void DebugDialog::setEnabled(bool enabled) {
 	m_enabled = enabled;
 }
@@ -28,6 +28,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFile>
 #include <QPointer>
 
+#include <atomic>
+
 #include "utils/misc.h"
 
 class DebugDialog : public QDialog
@@ -58,9 +60,11 @@ public:
 	static bool visible();
 	static bool connectToBroadcast(QObject * receiver, const char* slot);
 	static void setDebugLevel(DebugLevel);
+	static bool setDebugLevel(const QString &);
 	static void cleanup();
 	static void setEnabled(bool);
 	static bool enabled();
+	static bool enabled(DebugLevel);
 
 	static QString createKeyTag(const QKeyEvent *event);
 protected:
@@ -69,11 +73,11 @@ protected:
 
 protected:
 	static DebugDialog* singleton;
-	static QFile m_file;
 	static bool m_enabled;
+	static std::atomic<int> m_debugLevel;
 
 	QPointer<QTextEdit> m_textEdit;
-	DebugLevel m_debugLevel;
+	class DebugLogWriter * m_writer = nullptr;
 
 Q_SIGNALS:
 	void debugBroadcast(const QString & message, DebugDialog::DebugLevel, QObject * ancestor);
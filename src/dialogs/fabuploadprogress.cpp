@@ -1,11 +1,11 @@
 #include "fabuploadprogress.h"
 #include "networkhelper.h"
+#include "multipartupload.h"
 
 #include <QTextStream>
 #include <QUrl>
 #include <QNetworkRequest>
 #include <QNetworkReply>
-#include <QHttpMultiPart>
 #include <QFile>
 #include <QFileInfo>
 #include <QTimer>
@@ -100,39 +100,76 @@ void FabUploadProgress::onRequestUploadFinished()
 }
 
 
+static constexpr int MaxUploadAttempts = 5;
+static constexpr int UploadStallMs = 30000;			// no bytes either way for this long and the post is given up on
+
 void FabUploadProgress::uploadMultipart(const QUrl &url, const QString &file_path)
 {
-//	qDebug() << url.toString() << Qt::endl << Qt::flush;
-
-	auto *httpMultiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
-	auto *file = new QFile(file_path);
-	QHttpPart imagePart;
-	imagePart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"upload[file]\"; filename=\"" + QFileInfo(*file).fileName() + "\""));
-	imagePart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant("application/octet-stream"));
-//	qDebug() << httpMultiPart->boundary();
+	auto *file = new QFile(file_path, this);
+	if (!file->open(QIODevice::ReadOnly)) {
+		FMessageBox::critical(this, tr("Fritzing"), tr("Unable to read %1").arg(file_path));
+		delete file;
+		Q_EMIT closeUploadError();
+		return;
+	}
 
-	file->open(QIODevice::ReadOnly);
-	imagePart.setBodyDevice(file);
-	file->setParent(httpMultiPart); // we cannot delete the file object now, so delete it with the multiPart
+	uploadMultipart(url, file, QFileInfo(file_path).fileName());
+}
 
-	httpMultiPart->append(imagePart);
+void FabUploadProgress::uploadMultipart(const QUrl &url, QIODevice *source, const QString &file_name)
+{
+	// the body streams from source, which is deleted with it; any open device of known size will do,
+	// such as the saved sketch or an export written to a buffer
+	source->setParent(nullptr);
+	delete mBody;
+	mBody = new MultipartUploadDevice(source, "upload[file]", file_name, this);
+	source->setParent(mBody);
+	mUploadUrl = url;
+	mAttempt = 0;
+	postBody();
+}
 
-	QNetworkRequest request(url);
-	QNetworkReply *reply = mManager->post(request, httpMultiPart);
+void FabUploadProgress::postBody()
+{
+	// each attempt sends the whole body again: the upload url takes a single post and has no way to pick up part way
+	mAttempt++;
+	mBody->seek(0);
 
-	httpMultiPart->setParent(reply); // delete the multiPart with the reply
+	QNetworkRequest request(mUploadUrl);
+	request.setHeader(QNetworkRequest::ContentTypeHeader, mBody->contentType());
+	request.setHeader(QNetworkRequest::ContentLengthHeader, mBody->size());
+	request.setTransferTimeout(UploadStallMs);
+	QNetworkReply *reply = mManager->post(request, mBody);
 
 	connect(reply, SIGNAL(finished()), this, SLOT(uploadDone()));
 	connect(reply, SIGNAL(uploadProgress(qint64, qint64)), this, SLOT  (uploadProgress(qint64, qint64)));
+}
+
+bool FabUploadProgress::isTransient(QNetworkReply *reply) const
+{
+	// worth another go on a flaky connection; anything the server meant to say is not
+	switch (reply->error()) {
+	case QNetworkReply::RemoteHostClosedError:
+	case QNetworkReply::TimeoutError:
+	case QNetworkReply::OperationCanceledError:			// the transfer timeout
+	case QNetworkReply::TemporaryNetworkFailureError:
+	case QNetworkReply::NetworkSessionFailedError:
+	case QNetworkReply::ProxyTimeoutError:
+	case QNetworkReply::UnknownNetworkError:
+	case QNetworkReply::ServiceUnavailableError:
+		return true;
+	default:
+		break;
+	}
 
-	auto r = reply->request();
-//	qDebug() << NetworkHelper::debugRequest(r);
+	int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	return statusCode == 502 || statusCode == 503 || statusCode == 504;
 }
 
 void FabUploadProgress::uploadProgress(qint64 bytesSent, qint64 bytesTotal) {
-	qDebug() << "---------Uploaded--------------" << bytesSent<< "of" <<bytesTotal;
-	if (bytesSent > 0) {
-		Q_EMIT uploadProgressChanged(100 * bytesTotal / bytesSent);
+	// bytes handed to the socket for this attempt
+	if (bytesTotal > 0) {
+		Q_EMIT uploadProgressChanged(int(100 * bytesSent / bytesTotal));
 	}
 }
 
@@ -166,6 +203,19 @@ void FabUploadProgress::apiError(QString message)
 void FabUploadProgress::uploadDone() {
 	auto *reply = qobject_cast<QNetworkReply*>(sender());
 	qDebug() << "----------Finished--------------" << Qt::endl;
+	if (reply->error() != QNetworkReply::NoError && isTransient(reply) && mAttempt < MaxUploadAttempts && !mBody->isSequential()) {
+		int delayMs = 1000 << (mAttempt - 1);
+		qDebug() << "upload attempt" << mAttempt << "failed:" << reply->errorString() << "retrying in" << delayMs << "ms";
+		auto *message = findChild<QLabel*>("message");
+		if (message != nullptr) {
+			message->setText(tr("Connection lost, trying again (%1 of %2)...").arg(mAttempt + 1).arg(MaxUploadAttempts));
+		}
+		Q_EMIT uploadProgressChanged(0);
+		QTimer::singleShot(delayMs, this, &FabUploadProgress::postBody);
+		reply->deleteLater();
+		return;
+	}
+
 	if (reply->error() == QNetworkReply::NoError) {
 		auto d = reply->readAll();
 //		qDebug() << d << Qt::endl << Qt::flush;
@@ -34,7 +34,14 @@ private:
 	int mActivity;
 	QString mRedirect_url;
 
+	QUrl mUploadUrl;
+	int mAttempt = 0;
+	class MultipartUploadDevice *mBody = nullptr;
+
 	void uploadMultipart(const QUrl &url, const QString &file_path);
+	void uploadMultipart(const QUrl &url, QIODevice *source, const QString &file_name);
+	void postBody();
+	bool isTransient(QNetworkReply *reply) const;
 	void checkProcessingStatus(QUrl url);
 	void httpError(QNetworkReply *reply);
 	void apiError(QString message);
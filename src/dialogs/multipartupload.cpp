@@ -0,0 +1,106 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "multipartupload.h"
+
+#include <QRandomGenerator>
+
+MultipartUploadDevice::MultipartUploadDevice(QIODevice * source, const QString & fieldName, const QString & fileName, QObject * parent)
+	: QIODevice(parent),
+	  m_source(source)
+{
+	m_boundary = "fritzing-" + QByteArray::number(QRandomGenerator::global()->generate64(), 16);
+	m_head = "--" + m_boundary + "\r\n"
+		"Content-Disposition: form-data; name=\"" + fieldName.toUtf8() + "\"; filename=\"" + fileName.toUtf8() + "\"\r\n"
+		"Content-Type: application/octet-stream\r\n\r\n";
+	m_tail = "\r\n--" + m_boundary + "--\r\n";
+	if (m_source != nullptr) {
+		m_sourceStart = m_source->pos();
+		m_sourceSize = m_source->size() - m_sourceStart;
+	}
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QByteArray MultipartUploadDevice::contentType() const {
+	return "multipart/form-data; boundary=" + m_boundary;
+}
+
+bool MultipartUploadDevice::isSequential() const {
+	return m_source == nullptr || m_source->isSequential();
+}
+
+qint64 MultipartUploadDevice::size() const {
+	return m_head.size() + m_sourceSize + m_tail.size();
+}
+
+bool MultipartUploadDevice::seek(qint64 pos) {
+	if (pos < 0 || pos > size()) return false;
+	if (m_source == nullptr || m_source->isSequential()) {
+		return pos == m_position;
+	}
+
+	if (pos >= m_head.size() && pos < m_head.size() + m_sourceSize) {
+		if (!m_source->seek(m_sourceStart + pos - m_head.size())) return false;
+	}
+	else if (pos < m_head.size()) {
+		if (!m_source->seek(m_sourceStart)) return false;
+	}
+
+	m_position = pos;
+	return QIODevice::seek(pos);
+}
+
+bool MultipartUploadDevice::atEnd() const {
+	return m_position >= size();
+}
+
+qint64 MultipartUploadDevice::bytesAvailable() const {
+	return size() - m_position + QIODevice::bytesAvailable();
+}
+
+qint64 MultipartUploadDevice::readData(char * data, qint64 maxSize) {
+	// head, then as much of the source as fits, then tail; the source is read in the network stack's own chunks
+	qint64 done = 0;
+	while (done < maxSize && m_position < size()) {
+		qint64 got = 0;
+		if (m_position < m_head.size()) {
+			got = qMin(maxSize - done, m_head.size() - m_position);
+			memcpy(data + done, m_head.constData() + m_position, got);
+		}
+		else if (m_position < m_head.size() + m_sourceSize) {
+			if (m_source == nullptr) return -1;
+
+			got = m_source->read(data + done, qMin(maxSize - done, m_head.size() + m_sourceSize - m_position));
+			if (got < 0) return -1;
+			if (got == 0) break;            // a sequential source with nothing more yet
+		}
+		else {
+			qint64 offset = m_position - m_head.size() - m_sourceSize;
+			got = qMin(maxSize - done, m_tail.size() - offset);
+			memcpy(data + done, m_tail.constData() + offset, got);
+		}
+		done += got;
+		m_position += got;
+	}
+	return done;
+}
+
+qint64 MultipartUploadDevice::writeData(const char *, qint64) {
+	return -1;
+}
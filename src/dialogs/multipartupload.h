@@ -0,0 +1,60 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef MULTIPARTUPLOAD_H
+#define MULTIPARTUPLOAD_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QPointer>
+#include <QString>
+
+class MultipartUploadDevice : public QIODevice
+{
+	// a multipart/form-data body with one file part, read straight from the source device as the network
+	// stack asks for it, so the file is never held in memory; the source's size must be known up front,
+	// and the body is seekable when the source is, so that a failed post can be sent again
+
+	Q_OBJECT
+
+public:
+	MultipartUploadDevice(QIODevice * source, const QString & fieldName, const QString & fileName, QObject * parent = nullptr);
+
+	QByteArray contentType() const;
+	bool isSequential() const override;
+	qint64 size() const override;
+	bool seek(qint64 pos) override;
+	bool atEnd() const override;
+	qint64 bytesAvailable() const override;
+
+protected:
+	qint64 readData(char * data, qint64 maxSize) override;
+	qint64 writeData(const char * data, qint64 maxSize) override;
+
+protected:
+	QPointer<QIODevice> m_source;
+	qint64 m_sourceStart = 0;
+	qint64 m_sourceSize = 0;
+	QByteArray m_boundary;
+	QByteArray m_head;
+	QByteArray m_tail;
+	qint64 m_position = 0;
+};
+
+#endif
@@ -166,6 +166,8 @@ void PrefsDialog::initBetaFeatures(QWidget * widget)
 	QVBoxLayout * vLayout = new QVBoxLayout();
 	vLayout->addWidget(createSimulatorBetaFeaturesForm());
 	vLayout->addWidget(createGerberBetaFeaturesForm());
+	vLayout->addWidget(createLoadingBetaFeaturesForm());
+	vLayout->addWidget(createDrawingBetaFeaturesForm());
 	vLayout->addSpacerItem(new QSpacerItem(1, 1, QSizePolicy::Preferred, QSizePolicy::Expanding));
 	widget->setLayout(vLayout);
 }
@@ -453,6 +455,18 @@ QWidget * PrefsDialog::createGerberBetaFeaturesForm() {
 	box->setFixedWidth(FORMLABELWIDTH * 2);
 	box->setChecked(settings.value("gerberExportImprovementsEnabled", false).toBool()); // Initialize the value of box2 using m_settings
 	layout->addWidget(box);
+	layout->addSpacing(10);
+
+	QLabel * drillLabel = new QLabel(tr("Drill hits of each tool are ordered to shorten the travel between them, "
+										"and a coordinate that repeats the previous hit's is left out."
+										));
+	drillLabel->setWordWrap(true);
+	layout->addWidget(drillLabel);
+
+	QCheckBox * drillBox = new QCheckBox(tr("Optimize drill order"));
+	drillBox->setFixedWidth(FORMLABELWIDTH * 2);
+	drillBox->setChecked(settings.value("gerberDrillOrderOptimized", false).toBool());
+	layout->addWidget(drillBox);
 
 
 	gerberGroup->setLayout(layout);
@@ -461,9 +475,96 @@ QWidget * PrefsDialog::createGerberBetaFeaturesForm() {
 		m_settings.insert("gerberExportImprovementsEnabled", QString::number(checked));
 	});
 
+	connect(drillBox, &QCheckBox::clicked, this, [this](bool checked) {
+		m_settings.insert("gerberDrillOrderOptimized", QString::number(checked));
+	});
+
 	return gerberGroup;
 }
 
+QWidget * PrefsDialog::createLoadingBetaFeaturesForm() {
+	QSettings settings;
+	QGroupBox * loadingGroup = new QGroupBox(tr("Loading"), this);
+
+	QVBoxLayout * layout = new QVBoxLayout();
+
+	QLabel * label = new QLabel(tr("When a sketch is opened, only the view on show is built. "
+								   "The other views are built the first time they are shown, "
+								   "and before the sketch is changed, saved or exported."
+								   ));
+	label->setWordWrap(true);
+	layout->addWidget(label);
+	layout->addSpacing(10);
+
+	QCheckBox * box = new QCheckBox(tr("Load other views on first use"));
+	box->setFixedWidth(FORMLABELWIDTH * 2);
+	box->setChecked(settings.value("lazyViewLoading", false).toBool());
+	layout->addWidget(box);
+
+	layout->addSpacing(10);
+
+	QLabel * partsLabel = new QLabel(tr("At startup, only what the parts bins and search need is read from the parts database. "
+										"The rest of a part is read the first time it is used. "
+										"Takes effect the next time Fritzing starts."
+										));
+	partsLabel->setWordWrap(true);
+	layout->addWidget(partsLabel);
+	layout->addSpacing(10);
+
+	QCheckBox * partsBox = new QCheckBox(tr("Load part details on first use"));
+	partsBox->setFixedWidth(FORMLABELWIDTH * 2);
+	partsBox->setChecked(settings.value("lazyPartLoading", false).toBool());
+	layout->addWidget(partsBox);
+
+	QCheckBox * indexBox = new QCheckBox(tr("Read parts from a prebuilt index"));
+	indexBox->setFixedWidth(FORMLABELWIDTH * 2);
+	indexBox->setChecked(settings.value("partsIndex", false).toBool());
+	indexBox->setToolTip(tr("Keeps a binary copy of the parts database in the user folder, rebuilt whenever the parts change. "
+							"Not used when part details are loaded on first use."));
+	layout->addWidget(indexBox);
+
+	loadingGroup->setLayout(layout);
+
+	connect(box, &QCheckBox::clicked, this, [this](bool checked) {
+		m_settings.insert("lazyViewLoading", QString::number(checked));
+	});
+	connect(partsBox, &QCheckBox::clicked, this, [this](bool checked) {
+		m_settings.insert("lazyPartLoading", QString::number(checked));
+	});
+	connect(indexBox, &QCheckBox::clicked, this, [this](bool checked) {
+		m_settings.insert("partsIndex", QString::number(checked));
+	});
+
+	return loadingGroup;
+}
+
+QWidget * PrefsDialog::createDrawingBetaFeaturesForm() {
+	QSettings settings;
+	QGroupBox * drawingGroup = new QGroupBox(tr("Drawing"), this);
+
+	QVBoxLayout * layout = new QVBoxLayout();
+
+	QLabel * label = new QLabel(tr("Sketch views are drawn with OpenGL, so panning and zooming are composited by the graphics card. "
+								   "Takes effect the next time Fritzing starts."
+								   ));
+	label->setWordWrap(true);
+	layout->addWidget(label);
+	layout->addSpacing(10);
+
+	QCheckBox * box = new QCheckBox(tr("Draw views with the graphics card"));
+	box->setFixedWidth(FORMLABELWIDTH * 2);
+	box->setChecked(settings.value("acceleratedViewport", false).toBool());
+	layout->addWidget(box);
+
+	drawingGroup->setLayout(layout);
+
+	connect(box, &QCheckBox::clicked, this, [this](bool checked) {
+		m_settings.insert("acceleratedViewport", QString::number(checked));
+	});
+
+	return drawingGroup;
+}
+
 QWidget * PrefsDialog::createSimulatorBetaFeaturesForm() {
 	QSettings settings;
 	QGroupBox * simulator = new QGroupBox(tr("Simulator"), this);
@@ -66,6 +66,8 @@ protected:
 	QWidget *createProgrammerForm(QList<Platform *> platforms);
 	QWidget *createSimulatorBetaFeaturesForm();
 	QWidget *createGerberBetaFeaturesForm();
+	QWidget *createLoadingBetaFeaturesForm();
+	QWidget *createDrawingBetaFeaturesForm();
 	void updateWheelText();
 	void initGeneral(QWidget * general, QFileInfoList & languages);
 	void initBreadboard(QWidget *, ViewInfoThing *);
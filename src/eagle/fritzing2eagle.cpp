@@ -19,39 +19,334 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 ********************************************************************/
 
 
-#include <QLabel>
-#include <QScrollArea>
-#include <QFont>
-#include <QChar>
-#include <QTime>
-#include <QKeyEvent>
-#include <QScrollBar>
-#include <QMessageBox>
+#include <QIODevice>
+#include <QSet>
+#include <QRegularExpression>
+#include <QXmlStreamWriter>
+#include <qmath.h>
 
+#include <algorithm>
 
 #include "../items/itembase.h"
+#include "../items/groundplane.h"
+#include "../items/resizableboard.h"
+#include "../items/via.h"
+#include "../items/wire.h"
+#include "../connectors/connectoritem.h"
 #include "../sketch/pcbsketchwidget.h"
+#include "../utils/graphicsutils.h"
+#include "../utils/textutils.h"
 #include "fritzing2eagle.h"
 
+static const int EagleTop = 1;
+static const int EagleBottom = 16;
+static const int EagleDimension = 20;
 
+static void writeLayer(QXmlStreamWriter & streamWriter, int number, const QString & name, int color)
+{
+	streamWriter.writeStartElement("layer");
+	streamWriter.writeAttribute("number", QString::number(number));
+	streamWriter.writeAttribute("name", name);
+	streamWriter.writeAttribute("color", QString::number(color));
+	streamWriter.writeAttribute("fill", "1");
+	streamWriter.writeAttribute("visible", "yes");
+	streamWriter.writeAttribute("active", "yes");
+	streamWriter.writeEndElement();
+}
+
+static void writeWire(QXmlStreamWriter & streamWriter, const QPointF & p1, const QPointF & p2, double width, int layer)
+{
+	streamWriter.writeStartElement("wire");
+	streamWriter.writeAttribute("x1", QString::number(p1.x()));
+	streamWriter.writeAttribute("y1", QString::number(p1.y()));
+	streamWriter.writeAttribute("x2", QString::number(p2.x()));
+	streamWriter.writeAttribute("y2", QString::number(p2.y()));
+	streamWriter.writeAttribute("width", QString::number(width));
+	streamWriter.writeAttribute("layer", QString::number(layer));
+	streamWriter.writeEndElement();
+}
 
-Fritzing2Eagle* Fritzing2Eagle::singleton = nullptr;
+Fritzing2Eagle::Fritzing2Eagle(PCBSketchWidget * pcbGraphicsView) : m_pcbGraphicsView(pcbGraphicsView)
+{
+}
 
-Fritzing2Eagle::Fritzing2Eagle(PCBSketchWidget *m_pcbGraphicsView)
+bool Fritzing2Eagle::write(ItemBase * board, QIODevice * device)
 {
-	QList <ItemBase*> partList;
+	if (board == nullptr || device == nullptr) return false;
+
+	m_origin = board->sceneBoundingRect().bottomLeft();
+	m_packages.clear();
+	m_packageOrder.clear();
+
+	// the packages have to be written ahead of the elements, so gather the parts first
+	QList<ItemBase *> partList;
+	QList<ItemBase *> everything;
+	m_pcbGraphicsView->collectParts(everything);
+	Q_FOREACH (ItemBase * itemBase, everything) {
+		if (!itemBase->isEverVisible()) continue;
+		if (Board::isBoard(itemBase)) continue;
+		if (qobject_cast<GroundPlane *>(itemBase) != nullptr) continue;
+
+		if (qobject_cast<Via *>(itemBase) != nullptr) continue;		// written with their signals
+		if (itemBase->cachedConnectorItems().isEmpty()) continue;
+
+		package(itemBase);
+		partList << itemBase;
+	}
+
+	QXmlStreamWriter streamWriter(device);
+	streamWriter.setAutoFormatting(true);
+	streamWriter.setAutoFormattingIndent(1);
+	streamWriter.writeStartDocument();
+	streamWriter.writeDTD("<!DOCTYPE eagle SYSTEM \"eagle.dtd\">");
+	streamWriter.writeComment(" " + TextUtils::CreatedWithFritzingString + " ");
+	streamWriter.writeStartElement("eagle");
+	streamWriter.writeAttribute("version", "7.7.0");
+	streamWriter.writeStartElement("drawing");
+
+	streamWriter.writeStartElement("grid");
+	streamWriter.writeAttribute("distance", "0.05");
+	streamWriter.writeAttribute("unitdist", "inch");
+	streamWriter.writeAttribute("unit", "inch");
+	streamWriter.writeEndElement();
+
+	streamWriter.writeStartElement("layers");
+	writeLayer(streamWriter, EagleTop, "Top", 4);
+	writeLayer(streamWriter, EagleBottom, "Bottom", 1);
+	writeLayer(streamWriter, 17, "Pads", 2);
+	writeLayer(streamWriter, 18, "Vias", 2);
+	writeLayer(streamWriter, EagleDimension, "Dimension", 15);
+	writeLayer(streamWriter, 21, "tPlace", 7);
+	writeLayer(streamWriter, 25, "tNames", 7);
+	writeLayer(streamWriter, 29, "tStop", 7);
+	writeLayer(streamWriter, 30, "bStop", 7);
+	writeLayer(streamWriter, 44, "Drills", 7);
+	writeLayer(streamWriter, 45, "Holes", 7);
+	streamWriter.writeEndElement();
+
+	streamWriter.writeStartElement("board");
+
+	// only the bounding rectangle of a custom shaped board is written
+	streamWriter.writeStartElement("plain");
+	QRectF boardRect = board->sceneBoundingRect();
+	QPointF corners[4] = { toEagle(boardRect.bottomLeft()), toEagle(boardRect.bottomRight()), toEagle(boardRect.topRight()), toEagle(boardRect.topLeft()) };
+	for (int i = 0; i < 4; i++) {
+		writeWire(streamWriter, corners[i], corners[(i + 1) % 4], 0, EagleDimension);
+	}
+	streamWriter.writeEndElement();
+
+	streamWriter.writeStartElement("libraries");
+	streamWriter.writeStartElement("library");
+	streamWriter.writeAttribute("name", "fritzing");
+	streamWriter.writeStartElement("packages");
+	Q_FOREACH (QString key, m_packageOrder) {
+		const EaglePackage & eaglePackage = m_packages[key];
+		streamWriter.writeStartElement("package");
+		streamWriter.writeAttribute("name", eaglePackage.name);
+		Q_FOREACH (EaglePad pad, eaglePackage.pads) {
+			if (pad.drill > 0) {
+				streamWriter.writeStartElement("pad");
+				streamWriter.writeAttribute("name", pad.name);
+				streamWriter.writeAttribute("x", QString::number(pad.center.x()));
+				streamWriter.writeAttribute("y", QString::number(pad.center.y()));
+				streamWriter.writeAttribute("drill", QString::number(pad.drill));
+				streamWriter.writeAttribute("diameter", QString::number(qMax(pad.size.width(), pad.size.height())));
+				streamWriter.writeAttribute("shape", pad.round ? "round" : "square");
+			}
+			else {
+				streamWriter.writeStartElement("smd");
+				streamWriter.writeAttribute("name", pad.name);
+				streamWriter.writeAttribute("x", QString::number(pad.center.x()));
+				streamWriter.writeAttribute("y", QString::number(pad.center.y()));
+				streamWriter.writeAttribute("dx", QString::number(pad.size.width()));
+				streamWriter.writeAttribute("dy", QString::number(pad.size.height()));
+				streamWriter.writeAttribute("layer", QString::number(pad.layer));
+				if (pad.round) streamWriter.writeAttribute("roundness", "100");
+			}
+			streamWriter.writeEndElement();
+		}
+		streamWriter.writeEndElement();
+	}
+	streamWriter.writeEndElement();
+	streamWriter.writeEndElement();
+	streamWriter.writeEndElement();
+
+	streamWriter.writeStartElement("elements");
+	Q_FOREACH (ItemBase * itemBase, partList) {
+		QPointF center = toEagle(itemBase->mapToScene(itemBase->boundingRect().center()));
+		streamWriter.writeStartElement("element");
+		streamWriter.writeAttribute("name", eagleName(itemBase->instanceTitle()));
+		streamWriter.writeAttribute("library", "fritzing");
+		streamWriter.writeAttribute("package", package(itemBase).name);
+		streamWriter.writeAttribute("value", itemBase->title());
+		streamWriter.writeAttribute("x", QString::number(center.x()));
+		streamWriter.writeAttribute("y", QString::number(center.y()));
+		QString rot = rotation(itemBase);
+		if (!rot.isEmpty()) streamWriter.writeAttribute("rot", rot);
+		streamWriter.writeEndElement();
+	}
+	streamWriter.writeEndElement();
+
+	// a signal per net: the part connectors it touches, plus its traces and vias
+	QSet<ItemBase *> parts(partList.begin(), partList.end());
+	QSet<ConnectorItem *> visited;
+	int netIndex = 0;
+	streamWriter.writeStartElement("signals");
+	Q_FOREACH (ItemBase * itemBase, partList) {
+		Q_FOREACH (ConnectorItem * start, itemBase->cachedConnectorItems()) {
+			if (visited.contains(start)) continue;
 
-	m_pcbGraphicsView->collectParts(partList);
+			QList<ConnectorItem *> connectorItems;
+			connectorItems.append(start);
+			ConnectorItem::collectEqualPotential(connectorItems, true, ViewGeometry::RatsnestFlag);
+			visited.insert(start);
 
-	singleton = this;
+			QSet<QString> contacts;
+			QSet<Wire *> traces;
+			QSet<Via *> netVias;
+			QList<QPair<QString, QString>> contactRefs;
+			Q_FOREACH (ConnectorItem * connectorItem, connectorItems) {
+				visited.insert(connectorItem);
+				ItemBase * attachedTo = connectorItem->attachedTo()->layerKinChief();
+				auto * wire = qobject_cast<Wire *>(attachedTo);
+				if (wire != nullptr) {
+					if (wire->getTrace() && wire->isEverVisible()) traces.insert(wire);
+					continue;
+				}
+				auto * via = qobject_cast<Via *>(attachedTo);
+				if (via != nullptr) {
+					netVias.insert(via);
+					continue;
+				}
+				if (!parts.contains(attachedTo)) continue;
+
+				QString element = eagleName(attachedTo->instanceTitle());
+				QString pad = eagleName(connectorItem->connectorSharedID());
+				QString contact = element + "\n" + pad;
+				if (contacts.contains(contact)) continue;
+
+				contacts.insert(contact);
+				contactRefs.append(qMakePair(element, pad));
+			}
+			if (contactRefs.count() + traces.count() < 2) continue;
+
+			streamWriter.writeStartElement("signal");
+			streamWriter.writeAttribute("name", QString("N$%1").arg(++netIndex));
+			for (const auto & contactRef : contactRefs) {
+				streamWriter.writeStartElement("contactref");
+				streamWriter.writeAttribute("element", contactRef.first);
+				streamWriter.writeAttribute("pad", contactRef.second);
+				streamWriter.writeEndElement();
+			}
+			Q_FOREACH (Wire * wire, traces) {
+				QLineF line = wire->line();
+				int layer = wire->viewLayerID() == ViewLayer::Copper0Trace ? EagleBottom : EagleTop;
+				writeWire(streamWriter, toEagle(wire->mapToScene(line.p1())), toEagle(wire->mapToScene(line.p2())), toMM(wire->width()), layer);
+			}
+			Q_FOREACH (Via * via, netVias) {
+				if (via->cachedConnectorItems().isEmpty()) continue;
+
+				ConnectorItem * connectorItem = via->cachedConnectorItems().first();
+				QPointF center = toEagle(connectorItem->sceneAdjustedTerminalPoint(nullptr));
+				streamWriter.writeStartElement("via");
+				streamWriter.writeAttribute("x", QString::number(center.x()));
+				streamWriter.writeAttribute("y", QString::number(center.y()));
+				streamWriter.writeAttribute("extent", "1-16");
+				streamWriter.writeAttribute("drill", QString::number(toMM(2 * connectorItem->radius() - connectorItem->strokeWidth())));
+				streamWriter.writeAttribute("diameter", QString::number(toMM(2 * connectorItem->radius() + connectorItem->strokeWidth())));
+				streamWriter.writeEndElement();
+			}
+			streamWriter.writeEndElement();
+		}
+	}
+	streamWriter.writeEndElement();
+
+	streamWriter.writeEndElement();			// board
+	streamWriter.writeEndElement();			// drawing
+	streamWriter.writeEndElement();			// eagle
+	streamWriter.writeEndDocument();
+	return !streamWriter.hasError();
 }
 
-/*
-void Fritzing2Eagle::showOutputInfo(PCBSketchWidget m_pcbGraphicsView)
+const Fritzing2Eagle::EaglePackage & Fritzing2Eagle::package(ItemBase * itemBase)
 {
-	if (singleton == NULL) {
-		new Fritzing2Eagle();
+	// parts sharing a footprint share a package; the pads are read off the connector items,
+	// which already hold the parsed svg geometry, so no part svg is read again here
+	bool bottom = itemBase->viewLayerPlacement() == ViewLayer::NewBottom;
+	QString key = itemBase->moduleID() + "|" + itemBase->filename() + (bottom ? "|bottom" : "");
+	auto it = m_packages.find(key);
+	if (it != m_packages.end()) return it.value();
+
+	EaglePackage eaglePackage;
+	eaglePackage.name = eagleName(itemBase->moduleID());
+	if (bottom) eaglePackage.name += "_BOTTOM";
+	QString name = eaglePackage.name;
+	for (int i = 2; std::any_of(m_packages.cbegin(), m_packages.cend(), [&name](const EaglePackage & other) { return other.name == name; }); i++) {
+		name = QString("%1_%2").arg(eaglePackage.name).arg(i);
+	}
+	eaglePackage.name = name;
+
+	QPointF origin = itemBase->boundingRect().center();
+	QSet<QString> seen;
+	Q_FOREACH (ConnectorItem * connectorItem, itemBase->cachedConnectorItems()) {
+		QString id = connectorItem->connectorSharedID();
+		if (seen.contains(id)) continue;
+
+		seen.insert(id);
+		EaglePad pad;
+		pad.name = eagleName(id);
+		QPointF center = itemBase->mapFromItem(connectorItem, connectorItem->rect().center()) - origin;
+		pad.center = QPointF(toMM(center.x()), -toMM(center.y()));
+		pad.size = QSizeF(toMM(connectorItem->rect().width()), toMM(connectorItem->rect().height()));
+		pad.round = connectorItem->isEffectivelyCircular();
+		if (connectorItem->getCrossLayerConnectorItem() != nullptr) {
+			if (connectorItem->radius() > 0) {
+				pad.drill = toMM(2 * connectorItem->radius() - connectorItem->strokeWidth());
+				double diameter = toMM(2 * connectorItem->radius() + connectorItem->strokeWidth());
+				pad.size = QSizeF(diameter, diameter);
+			}
+			else {
+				pad.drill = qMin(pad.size.width(), pad.size.height()) / 2;
+			}
+		}
+		else {
+			pad.layer = bottom ? EagleBottom : EagleTop;
+		}
+		eaglePackage.pads << pad;
 	}
 
+	m_packageOrder << key;
+	return m_packages.insert(key, eaglePackage).value();
+}
+
+QPointF Fritzing2Eagle::toEagle(const QPointF & scenePos) const
+{
+	// eagle's y axis points up
+	return QPointF(toMM(scenePos.x() - m_origin.x()), toMM(m_origin.y() - scenePos.y()));
+}
+
+double Fritzing2Eagle::toMM(double pixels)
+{
+	return qRound(pixels * 25.4 / GraphicsUtils::SVGDPI * 10000) / 10000.0;
+}
+
+QString Fritzing2Eagle::eagleName(const QString & name)
+{
+	static const QRegularExpression Invalid("[^A-Za-z0-9_.\\-$]");
+	QString result = name;
+	result.replace(Invalid, "_");
+	return result.toUpper();
+}
+
+QString Fritzing2Eagle::rotation(ItemBase * itemBase)
+{
+	// with y flipped, a clockwise rotation on screen is a counter-clockwise one in eagle
+	QTransform transform = itemBase->transform();
+	double angle = -qRadiansToDegrees(atan2(transform.m12(), transform.m11()));
+	angle = qRound(angle * 10) / 10.0;
+	while (angle < 0) angle += 360;
+	while (angle >= 360) angle -= 360;
+	if (angle == 0) return QString();
+
+	return QString("R%1").arg(angle);
 }
-*/
@@ -21,22 +21,47 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef FRITZING2EAGLE_H
 #define FRITZING2EAGLE_H
 
-#include <QWidget>
-#include <QTime>
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QSizeF>
+#include <QString>
 
 class Fritzing2Eagle {
-//	Q_OBJECT
+	// writes the pcb view as an eagle board file; the xml is streamed out as it is produced,
+	// and pad geometry comes from the connector items already in the scene, once per package
 
 public:
-	Fritzing2Eagle(PCBSketchWidget *m_pcbGraphicsView);
+	Fritzing2Eagle(class PCBSketchWidget *);
 
-	/*
-	public:
-		static void showOutputInfo(PCBSketchWidget m_pcbGraphicsView);
-	*/
+	bool write(class ItemBase * board, class QIODevice *);
 
 protected:
-	static Fritzing2Eagle* singleton;
+	struct EaglePad {
+		QString name;
+		QPointF center;                 // mm, relative to the package origin, y up
+		QSizeF size;                    // mm
+		double drill = 0;               // mm; zero for an smd
+		int layer = 1;                  // smd copper layer
+		bool round = true;
+	};
+
+	struct EaglePackage {
+		QString name;
+		QList<EaglePad> pads;
+	};
+
+	const EaglePackage & package(ItemBase *);
+	QPointF toEagle(const QPointF & scenePos) const;
+	static double toMM(double pixels);
+	static QString eagleName(const QString &);
+	static QString rotation(ItemBase *);
+
+protected:
+	PCBSketchWidget * m_pcbGraphicsView = nullptr;
+	QPointF m_origin;                   // scene position of the board's bottom left corner
+	QHash<QString, EaglePackage> m_packages;
+	QList<QString> m_packageOrder;
 };
 
 #endif
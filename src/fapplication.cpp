@@ -26,6 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "version/version.h"
 #include "dialogs/prefsdialog.h"
 #include "fsvgrenderer.h"
+#include "cookedsvgcache.h"
 #include "version/versionchecker.h"
 #include "version/updatedialog.h"
 #include "itemdrag.h"
@@ -42,7 +43,18 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "utils/ratsnestcolors.h"
 #include "utils/cursormaster.h"
 #include "utils/textutils.h"
+#include "utils/s2s.h"
+#include "utils/exportmanifest.h"
+#include "utils/cachecounters.h"
+#include "utils/settingscache.h"
+#include "utils/tracer.h"
+#include "utils/memoryreport.h"
 #include "utils/graphicsutils.h"
+#include "utils/startupprofiler.h"
+#include "utils/stringpool.h"
+#include "model/backupjournal.h"
+#include "model/headlesssketch.h"
+#include "model/sketchdiff.h"
 #include "infoview/htmlinfoview.h"
 #include "svg/gedaelement2svg.h"
 #include "svg/kicadmodule2svg.h"
@@ -55,6 +67,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "dialogs/recoverydialog.h"
 #include "processeventblocker.h"
 #include "autoroute/checker.h"
+#include "autoroute/drc.h"
+#include "connectors/ercengine.h"
+#include "autoroute/mazerouter/mazerouter.h"
+#include "simulation/simulator.h"
 #include "sketch/sketchwidget.h"
 #include "sketch/pcbsketchwidget.h"
 #include "help/firsttimehelpdialog.h"
@@ -81,8 +97,28 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QNetworkRequest>
 #include <QMultiHash>
 #include <QTemporaryFile>
+#include <QCryptographicHash>
 #include <QDir>
+#include <QDirIterator>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrentMap>
 #include <time.h>
+#include <functional>
+#include <iterator>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 #ifdef LINUX_32
 #define PLATFORM_NAME "linux-32bit"
@@ -109,7 +145,32 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 static constexpr double LoadProgressStart = 0.085;
 static constexpr double LoadProgressEnd = 0.6;
+static constexpr int ExportAllBatchSize = 8;			// most sketches an -alljobs worker is given at once
+
+
+static qint64 peakResidentBytes() {
+	// high-water mark of the whole process so far, or -1 where we don't know how to ask
+#if defined(Q_OS_MACOS)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss;            // bytes
+#elif defined(Q_OS_UNIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) return qint64(usage.ru_maxrss) * 1024;     // kilobytes
+#endif
+	return -1;
+}
 
+static qint64 residentBytes() {
+	// resident set size right now, or -1 where we don't know how to ask
+#if defined(Q_OS_LINUX)
+	QFile statm("/proc/self/statm");
+	if (statm.open(QIODevice::ReadOnly)) {
+		QList<QByteArray> fields = statm.readAll().split(' ');
+		if (fields.count() > 1) return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+	}
+#endif
+	return -1;
+}
 
 ////////////////////////////////////////////////////
 
@@ -126,14 +187,227 @@ void FServer::incomingConnection(qintptr socketDescriptor)
 
 ////////////////////////////////////////////////////
 
-QMutex FServerThread::m_busy;
+const double FServerJobs::LatencyBuckets[] = { 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60, 120 };
+
+FServerJobs::FServerJobs(QObject * parent) : QObject(parent)
+{
+	m_clock.start();
+}
+
+void FServerJobs::Histogram::add(double seconds)
+{
+	if (counts.isEmpty()) counts.fill(0, std::size(LatencyBuckets));
+	for (int i = 0; i < counts.count(); i++) {
+		if (seconds <= LatencyBuckets[i]) counts[i]++;
+	}
+	count++;
+	sum += seconds;
+}
+
+QString FServerJobs::submit(const QString & command, const QString & params, bool waited)
+{
+	Job job;
+	job.id = TextUtils::getRandText();
+	job.command = command;
+	job.params = params;
+	job.waited = waited;
+	{
+		QMutexLocker locker(&m_mutex);
+		job.submittedNs = m_clock.nsecsElapsed();
+		m_jobs.insert(job.id, job);
+		m_queue.append(job.id);
+	}
+
+	Q_EMIT queued();
+	return job.id;
+}
+
+FServerJobs::Job FServerJobs::wait(const QString & id)
+{
+	QMutexLocker locker(&m_mutex);
+	while (true) {
+		Job job = m_jobs.value(id);
+		if (job.state != State::Queued && job.state != State::Running) return job;
+
+		m_finished.wait(&m_mutex);
+	}
+}
+
+bool FServerJobs::find(const QString & id, Job & job, int & position)
+{
+	QMutexLocker locker(&m_mutex);
+	if (!m_jobs.contains(id)) return false;
+
+	job = m_jobs.value(id);
+	position = m_queue.indexOf(id);
+	return true;
+}
+
+bool FServerJobs::take(Job & job)
+{
+	// the oldest waiting job, which is now running
+	QMutexLocker locker(&m_mutex);
+	if (m_queue.isEmpty()) return false;
+
+	QString id = m_queue.takeFirst();
+	Job & taken = m_jobs[id];
+	taken.state = State::Running;
+	taken.startedNs = m_clock.nsecsElapsed();
+	m_metrics[taken.command].queueWait.add((taken.startedNs - taken.submittedNs) / 1.0e9);
+	job = taken;
+	return true;
+}
+
+void FServerJobs::finish(const QString & id, int status, const QString & result)
+{
+	QMutexLocker locker(&m_mutex);
+	Job & job = m_jobs[id];
+	job.state = (status == 200) ? State::Done : State::Failed;
+	job.status = status;
+	job.result = result;
+	CommandMetrics & metrics = m_metrics[job.command];
+	metrics.statuses[status]++;
+	metrics.latency.add((m_clock.nsecsElapsed() - job.submittedNs) / 1.0e9);
+	if (!job.waited) {
+		m_done.append(id);
+		dropFinished();
+	}
+	m_finished.wakeAll();
+}
+
+void FServerJobs::forget(const QString & id)
+{
+	QMutexLocker locker(&m_mutex);
+	m_jobs.remove(id);
+}
+
+void FServerJobs::dropFinished()
+{
+	// called with the mutex held
+	while (m_done.count() > MaxFinished) {
+		Job job = m_jobs.take(m_done.takeFirst());
+		if (job.state == State::Done && job.command.endsWith("tcp")) {
+			QDir dir = QFileInfo(job.result).dir();
+			FolderUtils::rmdir(dir);
+		}
+	}
+}
+
+QString FServerJobs::metrics()
+{
+	// Prometheus text format; rates and hit ratios are for the scraper to work out from the counters
+	QString text;
+	QTextStream stream(&text);
+	QStringList commands;
+	commands << "svg" << "gerber" << "svg-tcp" << "gerber-tcp";
+
+	QMutexLocker locker(&m_mutex);
+
+	stream << "# HELP fritzing_requests_total Export requests finished, by command and HTTP status.\n";
+	stream << "# TYPE fritzing_requests_total counter\n";
+	Q_FOREACH (QString command, commands) {
+		const CommandMetrics & metrics = m_metrics[command];
+		for (auto it = metrics.statuses.constBegin(); it != metrics.statuses.constEnd(); ++it) {
+			stream << "fritzing_requests_total{command=\"" << command << "\",status=\"" << it.key() << "\"} " << it.value() << "\n";
+		}
+	}
+
+	stream << "# HELP fritzing_request_duration_seconds Time from an export request arriving to its result being ready.\n";
+	stream << "# TYPE fritzing_request_duration_seconds histogram\n";
+	Q_FOREACH (QString command, commands) {
+		writeHistogram(stream, "fritzing_request_duration_seconds", command, m_metrics[command].latency);
+	}
+
+	stream << "# HELP fritzing_queue_wait_seconds Time an export request waited for the exports running before it.\n";
+	stream << "# TYPE fritzing_queue_wait_seconds histogram\n";
+	Q_FOREACH (QString command, commands) {
+		writeHistogram(stream, "fritzing_queue_wait_seconds", command, m_metrics[command].queueWait);
+	}
+
+	int running = 0;
+	for (auto it = m_jobs.constBegin(); it != m_jobs.constEnd(); ++it) {
+		if (it->state == State::Running) running++;
+	}
+	stream << "# HELP fritzing_queue_depth Export requests waiting to run.\n";
+	stream << "# TYPE fritzing_queue_depth gauge\n";
+	stream << "fritzing_queue_depth " << m_queue.count() << "\n";
+	stream << "# HELP fritzing_requests_running Export requests running; exports run one at a time.\n";
+	stream << "# TYPE fritzing_requests_running gauge\n";
+	stream << "fritzing_requests_running " << running << "\n";
+	locker.unlock();
+
+	QList<const CacheCounters *> caches = CacheCounters::all();
+	stream << "# HELP fritzing_cache_hits_total Lookups answered by a cache.\n";
+	stream << "# TYPE fritzing_cache_hits_total counter\n";
+	Q_FOREACH (const CacheCounters * cache, caches) {
+		stream << "fritzing_cache_hits_total{cache=\"" << cache->name() << "\"} " << cache->hits() << "\n";
+	}
+	stream << "# HELP fritzing_cache_misses_total Lookups a cache could not answer.\n";
+	stream << "# TYPE fritzing_cache_misses_total counter\n";
+	Q_FOREACH (const CacheCounters * cache, caches) {
+		stream << "fritzing_cache_misses_total{cache=\"" << cache->name() << "\"} " << cache->misses() << "\n";
+	}
+
+	qint64 resident = residentBytes();
+	if (resident >= 0) {
+		stream << "# HELP fritzing_resident_memory_bytes Resident memory of the process.\n";
+		stream << "# TYPE fritzing_resident_memory_bytes gauge\n";
+		stream << "fritzing_resident_memory_bytes " << resident << "\n";
+	}
+	qint64 peak = peakResidentBytes();
+	if (peak >= 0) {
+		stream << "# HELP fritzing_peak_resident_memory_bytes Highest resident memory of the process so far.\n";
+		stream << "# TYPE fritzing_peak_resident_memory_bytes gauge\n";
+		stream << "fritzing_peak_resident_memory_bytes " << peak << "\n";
+	}
+
+	stream.flush();
+	return text;
+}
+
+void FServerJobs::writeHistogram(QTextStream & stream, const char * name, const QString & command, const Histogram & histogram)
+{
+	QString labels = QString("command=\"%1\"").arg(command);
+	for (size_t i = 0; i < std::size(LatencyBuckets); i++) {
+		quint64 count = histogram.counts.isEmpty() ? 0 : histogram.counts.at(i);
+		stream << name << "_bucket{" << labels << ",le=\"" << LatencyBuckets[i] << "\"} " << count << "\n";
+	}
+	stream << name << "_bucket{" << labels << ",le=\"+Inf\"} " << histogram.count << "\n";
+	stream << name << "_sum{" << labels << "} " << histogram.sum << "\n";
+	stream << name << "_count{" << labels << "} " << histogram.count << "\n";
+}
+
+QString FServerJobs::stateName(State state)
+{
+	switch (state) {
+	case State::Queued:
+		return "queued";
+	case State::Running:
+		return "running";
+	case State::Done:
+		return "done";
+	case State::Failed:
+	default:
+		return "failed";
+	}
+}
+
+bool FServerJobs::isExportCommand(const QString & command)
+{
+	return command == "svg" || command == "gerber" || command == "svg-tcp" || command == "gerber-tcp";
+}
+
+////////////////////////////////////////////////////
 
-FServerThread::FServerThread(qintptr socketDescriptor, QObject *parent) : QThread(parent), m_socketDescriptor(socketDescriptor)
+FServerThread::FServerThread(qintptr socketDescriptor, FServerJobs * jobs, QObject *parent) : QThread(parent), m_socketDescriptor(socketDescriptor), m_jobs(jobs)
 {
 }
 
 void FServerThread::run()
 {
+	// GET /svg/FOLDER, /gerber/FOLDER, /svg-tcp/URL and /gerber-tcp/URL answer when the export is done;
+	// GET /queue/COMMAND/... answers with a job id right away, for /status/ID and later /result/ID;
+	// GET /metrics answers with request, queue, cache and memory metrics in Prometheus text format
 	auto * socket = new QTcpSocket();
 	if (!socket->setSocketDescriptor(m_socketDescriptor)) {
 		Q_EMIT error(socket->error());
@@ -167,32 +441,59 @@ void FServerThread::run()
 	}
 
 	QStringList params = tokens.at(1).split("/", Qt::SplitBehaviorFlags::SkipEmptyParts);
-	QString command = params.takeFirst();
 	if (params.count() == 0) {
 		writeResponse(socket, 400, "Bad Request", "", "");
 		return;
 	}
 
-	QString subFolder = params.join("/");
-	bool fixSubFolder = false;
-	QString mimeType;
-	if (command == "svg") {
-		mimeType = "image/svg+xml";
+	QString command = params.takeFirst();
+	if (command == "metrics") {
+		writeResponse(socket, 200, "Ok", "text/plain; version=0.0.4", m_jobs->metrics());
+		return;
 	}
-	else if (command == "gerber") {
+
+	if (params.count() == 0) {
+		writeResponse(socket, 400, "Bad Request", "", "");
+		return;
 	}
-	else if (command == "svg-tcp") {
-		fixSubFolder = true;
+
+	if (command == "status") {
+		writeStatus(socket, params.at(0));
+		return;
 	}
-	else if (command == "gerber-tcp") {
-		fixSubFolder = true;
+
+	if (command == "result") {
+		FServerJobs::Job job;
+		int position;
+		if (!m_jobs->find(params.at(0), job, position)) {
+			writeResponse(socket, 404, "Not Found", "", "No such job.");
+		}
+		else if (job.state == FServerJobs::State::Queued || job.state == FServerJobs::State::Running) {
+			writeResponse(socket, 202, "Accepted", "", FServerJobs::stateName(job.state));
+		}
+		else {
+			writeResult(socket, job, false);
+		}
+		return;
 	}
-	else {
+
+	bool queue = false;
+	if (command == "queue") {
+		queue = true;
+		command = params.takeFirst();
+		if (params.count() == 0) {
+			writeResponse(socket, 400, "Bad Request", "", "");
+			return;
+		}
+	}
+
+	if (!FServerJobs::isExportCommand(command)) {
 		writeResponse(socket, 400, "Bad Request", "", "");
 		return;
 	}
 
-	if (fixSubFolder) {
+	QString subFolder = params.join("/");
+	if (command.endsWith("tcp")) {
 		// replace "/" that was removed from "http:/blah" above
 		int ix = subFolder.indexOf(":/");
 		if (ix >= 0) {
@@ -200,35 +501,49 @@ void FServerThread::run()
 		}
 	}
 
-	int waitInterval = 100;     // 100ms to wait
-	int timeoutSeconds = 2 * 60;    // timeout after 2 minutes
-	int attempts = timeoutSeconds * 1000 / waitInterval;  // timeout a
-	bool gotLock = false;
-	for (int i = 0; i < attempts; i++) {
-		if (m_busy.tryLock()) {
-			gotLock = true;
-			break;
-		}
+	DebugDialog::debug(QString("queueing command %1 %2").arg(command).arg(subFolder));
+	QString id = m_jobs->submit(command, subFolder, !queue);
+	if (queue) {
+		writeResponse(socket, 202, "Accepted", "", id);
+		return;
 	}
 
-	if (!gotLock) {
-		writeResponse(socket, 503, "Service Unavailable", "", "Server busy.");
+	FServerJobs::Job job = m_jobs->wait(id);
+	m_jobs->forget(id);
+	writeResult(socket, job, true);
+}
+
+void FServerThread::writeStatus(QTcpSocket * socket, const QString & id)
+{
+	FServerJobs::Job job;
+	int position;
+	if (!m_jobs->find(id, job, position)) {
+		writeResponse(socket, 404, "Not Found", "", "No such job.");
 		return;
 	}
 
-	DebugDialog::debug(QString("emitting do command %1 %2").arg(command).arg(subFolder));
-	QString result;
-	int status;
-	Q_EMIT doCommand(command, subFolder, result, status);
-
-	m_busy.unlock();
+	QJsonObject status;
+	status.insert("id", job.id);
+	status.insert("command", job.command);
+	status.insert("state", FServerJobs::stateName(job.state));
+	if (job.state == FServerJobs::State::Queued) {
+		status.insert("position", position);
+	}
+	else if (job.state == FServerJobs::State::Failed) {
+		status.insert("status", job.status);
+		status.insert("error", job.result);
+	}
+	writeResponse(socket, 200, "Ok", "application/json", QString::fromUtf8(QJsonDocument(status).toJson()));
+}
 
-	if (status != 200) {
-		writeResponse(socket, status, "failed", "", result);
+void FServerThread::writeResult(QTcpSocket * socket, const FServerJobs::Job & job, bool removeZip)
+{
+	if (job.status != 200) {
+		writeResponse(socket, job.status, "failed", "", job.result);
 	}
-	else if (command.endsWith("tcp")) {
-		QString filename = result;
-		mimeType = "application/zip";
+	else if (job.command.endsWith("tcp")) {
+		QString filename = job.result;
+		QString mimeType = "application/zip";
 		QFile file(filename);
 		if (file.open(QFile::ReadOnly)) {
 			QString response = QString("HTTP/1.0 %1 %2\r\n").arg(200).arg("ok");
@@ -256,12 +571,14 @@ void FServerThread::run()
 			writeResponse(socket, 500, "failed", "", "local zip failure (2)");
 		}
 
-		QFileInfo info(filename);
-		QDir dir = info.dir();
-		FolderUtils::rmdir(dir);
+		if (removeZip) {
+			QFileInfo info(filename);
+			QDir dir = info.dir();
+			FolderUtils::rmdir(dir);
+		}
 	}
 	else {
-		writeResponse(socket, 200, "Ok", mimeType, result);
+		writeResponse(socket, 200, "Ok", job.command == "svg" ? "image/svg+xml" : "", job.result);
 	}
 }
 
@@ -282,10 +599,11 @@ void FServerThread::writeResponse(QTcpSocket * socket, int code, const QString &
 
 ////////////////////////////////////////////////////
 
-RegenerateDatabaseThread::RegenerateDatabaseThread(const QString & dbFileName, QDialog * progressDialog, ReferenceModel * referenceModel) {
+RegenerateDatabaseThread::RegenerateDatabaseThread(const QString & dbFileName, QDialog * progressDialog, ReferenceModel * referenceModel, bool incremental) {
 	m_dbFileName = dbFileName;
 	m_referenceModel = referenceModel;
 	m_progressDialog = progressDialog;
+	m_incremental = incremental;
 }
 
 const QString RegenerateDatabaseThread::error() const {
@@ -312,7 +630,12 @@ void RegenerateDatabaseThread::run() {
 		return;
 	}
 
-	bool ok = ((FApplication *) qApp)->loadReferenceModel(fileName, true, m_referenceModel);
+	bool ok = m_incremental && update(fileName);
+	if (!ok) {
+		// a database from before file records were kept can't be updated, so build it from scratch
+		QFile::remove(fileName);
+		ok = ((FApplication *) qApp)->loadReferenceModel(fileName, true, m_referenceModel);
+	}
 	if (!ok) {
 		m_error = tr("Database failure") + "\n" + m_referenceModel->error();
 		return;
@@ -333,6 +656,20 @@ void RegenerateDatabaseThread::run() {
 	}
 }
 
+bool RegenerateDatabaseThread::update(const QString & fileName) {
+	// updates a copy of the current database, so a failure leaves the original alone
+	if (!QFile::exists(m_dbFileName)) return false;
+
+	QFile::remove(fileName);
+	if (!QFile::copy(m_dbFileName, fileName)) return false;
+
+	QFile::setPermissions(fileName, QFile::permissions(fileName) | QFileDevice::WriteOwner);
+	QString sha = PartsChecker::getSha(FolderUtils::getAppPartsSubFolder("").absolutePath());
+	if (sha.isEmpty()) return false;
+
+	return m_referenceModel->updateDatabase(fileName, sha);
+}
+
 ////////////////////////////////////////////////////
 
 FApplication::FApplication( int & argc, char ** argv) : QApplication(argc, argv)
@@ -388,6 +725,27 @@ int FApplication::init() {
 			toRemove << i;
 		}
 
+		if ((m_arguments[i].compare("-profile-startup", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--profile-startup", Qt::CaseInsensitive) == 0)) {
+			// an optional FILE.json follows; anything else is left for the sketch arguments
+			DebugDialog::setEnabled(true);
+			QString reportPath;
+			if (i + 1 < m_arguments.length() && m_arguments[i + 1].endsWith(".json", Qt::CaseInsensitive)) {
+				reportPath = m_arguments[i + 1];
+				toRemove << i + 1;
+			}
+			StartupProfiler::enable(reportPath);
+			StartupProfiler::begin("init");
+			toRemove << i;
+		}
+
+		if ((m_arguments[i].compare("-s2sdryrun", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--s2sdryrun", Qt::CaseInsensitive) == 0)) {
+			// with -s2s, write nothing but s2s.json and an s2s.diff of what would change
+			m_s2sDryRun = true;
+			toRemove << i;
+		}
+
 		if (i + 1 >= m_arguments.length()) continue;
 
 		if ((m_arguments[i].compare("-f", Qt::CaseInsensitive) == 0) ||
@@ -399,6 +757,15 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-loglevel", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--loglevel", Qt::CaseInsensitive) == 0)) {
+			// messages below the level are dropped before they are formatted or queued for debug.txt
+			if (!DebugDialog::setDebugLevel(m_arguments[i + 1])) {
+				DebugDialog::debug(QString("unknown log level %1").arg(m_arguments[i + 1]), DebugDialog::Warning);
+			}
+			toRemove << i << i + 1;
+		}
+
 		if ((m_arguments[i].compare("-pp", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("-pa", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("-parts", Qt::CaseInsensitive) == 0) ||
@@ -431,12 +798,21 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
-		//if ((m_arguments[i].compare("-drc", Qt::CaseInsensitive) == 0) ||
-		//	(m_arguments[i].compare("--drc", Qt::CaseInsensitive) == 0)) {
-		//	m_serviceType = ServiceType::DRCService;
-		//	m_outputFolder = m_arguments[i + 1];
-		//	toRemove << i << i + 1;
-		//}
+		if ((m_arguments[i].compare("-drc", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--drc", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::DRCService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-erc", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--erc", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::ERCService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
 
 		if ((m_arguments[i].compare("-db", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("-database", Qt::CaseInsensitive) == 0) ||
@@ -446,6 +822,23 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-s2s", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--s2s", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::S2SService;
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-s2sthreads", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--s2sthreads", Qt::CaseInsensitive) == 0)) {
+			bool ok;
+			int count = m_arguments[i + 1].toInt(&ok);
+			if (ok) {
+				m_s2sThreads = qMax(1, count);
+			}
+			toRemove << i << i + 1;
+		}
+
 		if ((m_arguments[i].compare("-kicad", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("--kicad", Qt::CaseInsensitive) == 0)) {
 			m_serviceType = ServiceType::KicadFootprintService;
@@ -468,6 +861,25 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-netlist", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--netlist", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::NetlistService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-diff", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--diff", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::DiffService;
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+			if (i + 2 < m_arguments.count()) {
+				m_diffSketch = m_arguments[i + 2];
+				toRemove << i + 2;
+			}
+		}
+
 		if ((m_arguments[i].compare("-port", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("--port", Qt::CaseInsensitive) == 0)) {
 			DebugDialog::setEnabled(true);
@@ -492,6 +904,28 @@ int FApplication::init() {
 
 
 
+		if ((m_arguments[i].compare("-portwindows", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--portwindows", Qt::CaseInsensitive) == 0)) {
+			// how many sketches the port service keeps loaded between requests
+			bool ok;
+			int count = m_arguments[i + 1].toInt(&ok);
+			if (ok) {
+				m_serviceWindowCount = qMax(0, count);
+			}
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-portspare", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--portspare", Qt::CaseInsensitive) == 0)) {
+			// how many empty windows the port service builds ahead of the requests
+			bool ok;
+			int count = m_arguments[i + 1].toInt(&ok);
+			if (ok) {
+				m_spareWindowCount = qMax(0, count);
+			}
+			toRemove << i << i + 1;
+		}
+
 		if ((m_arguments[i].compare("-g", Qt::CaseInsensitive) == 0) ||
 		        (m_arguments[i].compare("-gerber", Qt::CaseInsensitive) == 0)||
 		        (m_arguments[i].compare("--gerber", Qt::CaseInsensitive) == 0)) {
@@ -501,6 +935,19 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-gerberfill", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--gerberfill", Qt::CaseInsensitive) == 0)) {
+			// copper fill each sketch before its gerber export
+			m_gerberCopperFill = true;
+			toRemove << i;
+		}
+
+		if ((m_arguments[i].compare("-svgshared", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--svgshared", Qt::CaseInsensitive) == 0)) {
+			m_svgShareParts = true;
+			toRemove << i;
+		}
+
 		if ((m_arguments[i].compare("-a", Qt::CaseInsensitive) == 0) ||
 			(m_arguments[i].compare("-all", Qt::CaseInsensitive) == 0)||
 			(m_arguments[i].compare("--all", Qt::CaseInsensitive) == 0)) {
@@ -510,6 +957,80 @@ int FApplication::init() {
 			toRemove << i << i + 1;
 		}
 
+		if ((m_arguments[i].compare("-alljobs", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--alljobs", Qt::CaseInsensitive) == 0)) {
+			// how many worker processes -all spreads the sketches across
+			bool ok;
+			int count = m_arguments[i + 1].toInt(&ok);
+			if (ok) {
+				m_exportAllJobs = qMax(1, count);
+			}
+			toRemove << i << i + 1;
+		}
+
+		if (m_arguments[i].compare("-allsketch", Qt::CaseInsensitive) == 0) {
+			// passed to a worker by -alljobs, once per sketch it should export
+			m_exportAllSketches << m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if (m_arguments[i].compare("-allreport", Qt::CaseInsensitive) == 0) {
+			// passed to a worker by -alljobs: where to write its report instead of exportall.json
+			m_exportAllReport = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-autoroute", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--autoroute", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::AutorouteService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-simulate", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--simulate", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::SimulateService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-memory", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--memory", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::MemoryService;
+			DebugDialog::setEnabled(true);
+			m_outputFolder = m_arguments[i + 1];
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-perfexamples", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--perfexamples", Qt::CaseInsensitive) == 0)) {
+			m_serviceType = ServiceType::PerformanceService;
+			DebugDialog::setEnabled(true);
+			m_performanceReport = m_arguments[i + 1];
+			m_outputFolder = " ";					// otherwise program will bail out
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-autorouteset", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--autorouteset", Qt::CaseInsensitive) == 0)) {
+			// NAME=VALUE, where NAME is an autorouter setting such as maxcycles or parallelorderings
+			int eq = m_arguments[i + 1].indexOf('=');
+			if (eq > 0) {
+				m_autorouteSettings.insert("cmrouter/" + m_arguments[i + 1].left(eq), m_arguments[i + 1].mid(eq + 1));
+			}
+			toRemove << i << i + 1;
+		}
+
+		if ((m_arguments[i].compare("-trace", Qt::CaseInsensitive) == 0) ||
+			(m_arguments[i].compare("--trace", Qt::CaseInsensitive) == 0)) {
+			if (!Tracer::start(m_arguments[i + 1])) {
+				DebugDialog::debug(QString("unable to write trace to %1").arg(m_arguments[i + 1]));
+			}
+			toRemove << i << i + 1;
+		}
+
 		if (m_arguments[i].compare("-ep", Qt::CaseInsensitive) == 0) {
 			m_externalProcessPath = m_arguments[i + 1];
 			toRemove << i << i + 1;
@@ -559,11 +1080,15 @@ int FApplication::init() {
 	// !!! translator must be installed before any widgets are created !!!
 	m_translationPath = FolderUtils::getApplicationSubFolderPath("translations");
 
+	StartupProfiler::begin("translations");
 	bool loaded = findTranslator(m_translationPath);
 	Q_UNUSED(loaded);
+	StartupProfiler::end();
 
 	Q_INIT_RESOURCE(phoenixresources);
 
+	StartupProfiler::begin("names");
+
 	MainWindow::initNames();
 	FSvgRenderer::initNames();
 	ViewLayer::initNames();
@@ -579,6 +1104,7 @@ int FApplication::init() {
 	if (m_serviceType == ServiceType::NoService) {
 		CursorMaster::initCursors();
 	}
+	StartupProfiler::end();
 
 #ifdef Q_OS_MAC
 	m_buildType = " Cocoa";
@@ -587,12 +1113,14 @@ int FApplication::init() {
 #endif
 	AboutBox::initBuildType(m_buildType);
 	DebugDialog::debug(QString("Starting Fritzing %1").arg(Version::versionString()));
+	StartupProfiler::end();
 
 	return FInitResultNormal;
 }
 
 FApplication::~FApplication(void)
 {
+	SettingsCache::sync();
 	cleanupBackups();
 
 	clearModels();
@@ -622,6 +1150,7 @@ FApplication::~FApplication(void)
 	CursorMaster::cleanup();
 	LockManager::cleanup();
 	PartsBinPaletteWidget::cleanup();
+	Tracer::finish();
 }
 
 void FApplication::clearModels() {
@@ -754,7 +1283,25 @@ bool FApplication::findTranslator(const QString & translationsPath) {
 		QLocale::setDefault(QLocale(suffix));
 	}
 
-	bool loaded = m_translator.load(QString("fritzing_") + suffix.toLower(), translationsPath);
+	// the same names QTranslator::load would try, dropping a "_" section at a time, but only as .qm
+	// files, and the one found is mapped rather than read in
+	QString name = QString("fritzing_") + suffix.toLower();
+	bool loaded = false;
+	while (true) {
+		m_translationFile.setFileName(QDir(translationsPath).absoluteFilePath(name + ".qm"));
+		if (m_translationFile.open(QFile::ReadOnly)) {
+			uchar * data = m_translationFile.map(0, m_translationFile.size());
+			loaded = (data != nullptr)
+			         ? m_translator.load(data, (int) m_translationFile.size(), translationsPath)
+			         : m_translator.load(m_translationFile.fileName());
+			if (!loaded) m_translationFile.close();
+		}
+
+		int underscore = name.lastIndexOf('_');
+		if (loaded || underscore < 0) break;
+
+		name.truncate(underscore);
+	}
 	DebugDialog::debug(QString("translation %1 loaded %2 from %3").arg(suffix).arg(static_cast<int>(loaded)).arg(translationsPath));
 	if (loaded) {
 		QApplication::installTranslator(&m_translator);
@@ -763,29 +1310,6 @@ bool FApplication::findTranslator(const QString & translationsPath) {
 	return loaded;
 }
 
-void FApplication::registerFonts() {
-	registerFont(":/resources/fonts/DroidSans.ttf", true);
-	registerFont(":/resources/fonts/DroidSans-Bold.ttf", false);
-	registerFont(":/resources/fonts/DroidSansMono.ttf", false);
-	registerFont(":/resources/fonts/OCRA.ttf", true);
-	registerFont(":/resources/fonts/Segment16/Segment16C Bold.ttf", true);
-	registerFont(":/resources/fonts/OCR-Fritzing-mono.otf", true);
-
-	// "Droid Sans"
-	// "Droid Sans Mono"
-
-	/*
-		QFontDatabase database;
-		QStringList families = database.families (  );
-		foreach (QString string, families) {
-			DebugDialog::debug(string);			// should print out the name of the fonts you loaded
-		}
-	*/
-
-
-	QFont::insertSubstitution(OCRAFontName, OCRFFontName);
-}
-
 bool FApplication::loadReferenceModel(const QString & databaseName, bool fullLoad) {
 	m_referenceModel = new CurrentReferenceModel();
 	ItemBase::setReferenceModel(m_referenceModel);
@@ -819,10 +1343,17 @@ bool FApplication::loadReferenceModel(const QString &  databaseName, bool fullLo
 	if (databaseName.isEmpty() && !dbExists) {
 		db = dbPath;
 	}
+	StartupProfiler::begin("part files");
 	bool ok = referenceModel->loadAll(db, !dbExists, dbExists);
+	StartupProfiler::end();
 	if (ok && dbExists) {
+		StartupProfiler::Phase phase("parts database");
 		referenceModel->loadFromDB(dbPath);
 	}
+	if (ok) {
+		CookedSvgCache::setPartsSha(referenceModel->sha());
+	}
+	DebugDialog::debug(QString("string pool: %1 strings").arg(StringPool::count()));
 	return ok;
 }
 
@@ -852,285 +1383,1673 @@ int FApplication::serviceStartup() {
 				sketch->clearFileProgressDialog();
 			}
 		}
-		return 1;
-
-	case ServiceType::GedaService:
-		runGedaService();
-		return 0;
+		QTimer::singleShot(0, this, &FApplication::warmServiceWindows);
+		return 1;
+
+	case ServiceType::GedaService:
+		runGedaService();
+		return 0;
+
+	case ServiceType::DRCService:
+		return runDRCService() ? 0 : 2;
+
+	case ServiceType::ERCService:
+		return runERCService() ? 0 : 2;
+
+	case ServiceType::AutorouteService:
+		runAutorouteService();
+		return 0;
+
+	case ServiceType::SimulateService:
+		return runSimulateService() ? 0 : 2;
+
+	case ServiceType::MemoryService:
+		return runMemoryService() ? 0 : 2;
+
+	case ServiceType::PerformanceService:
+		return runPerformanceService() ? 0 : 2;
+
+	case ServiceType::DatabaseService:
+		runDatabaseService();
+		return 0;
+
+	case ServiceType::S2SService:
+		runS2SService();
+		return 0;
+
+	case ServiceType::KicadFootprintService:
+		runKicadFootprintService();
+		return 0;
+
+	case ServiceType::KicadSchematicService:
+		runKicadSchematicService();
+		return 0;
+
+	case ServiceType::GerberService:
+		runGerberService();
+		return 0;
+
+	case ServiceType::ExportAllService:
+		if (m_exportAllJobs > 1 && m_exportAllSketches.isEmpty()) {
+			return runExportAllWorkers() ? 0 : 2;
+		}
+		return runExportAllService() ? 0 : 2;
+
+	case ServiceType::SvgService:
+		runSvgService();
+		return 0;
+
+	case ServiceType::NetlistService:
+		return runNetlistService() ? 0 : 2;
+
+	case ServiceType::DiffService:
+		return runDiffService() ? 0 : 2;
+
+	case ServiceType::ExampleService:
+		runExampleService();
+		return 0;
+
+	default:
+		DebugDialog::debug("unknown service");
+		return -1;
+	}
+}
+
+void FApplication::runGerberService()
+{
+	initService();
+	runGerberServiceAux();
+}
+
+void FApplication::runGerberServiceAux()
+{
+	QDir dir(m_outputFolder);
+	QString s = dir.absolutePath();
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = dir.entryList(filters, QDir::Files);
+	QJsonArray reports;
+	Q_FOREACH (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		FolderUtils::setOpenSaveFolderAux(m_outputFolder);
+		MainWindow * mainWindow = loadForService(filepath, 3);
+		if (mainWindow != nullptr) {
+			QFileInfo info(filepath);
+			QJsonObject report;
+			report.insert("sketch", filename);
+			if (m_gerberCopperFill) {
+				QElapsedTimer fillTimer;
+				fillTimer.start();
+				mainWindow->showPCBView();
+				mainWindow->copperFill();
+				report.insert("fillMs", fillTimer.nsecsElapsed() / 1.0e6);
+			}
+
+			GerberMetrics metrics;
+			QElapsedTimer timer;
+			timer.start();
+			GerberGenerator::exportToGerber(info.completeBaseName(), m_outputFolder, nullptr, mainWindow->pcbView(), false, &metrics);
+			report.insert("totalMs", timer.nsecsElapsed() / 1.0e6);
+			report.insert("renderMs", metrics.renderNs / 1.0e6);
+			report.insert("convertMs", metrics.convertNs / 1.0e6);
+			QJsonArray layers;
+			qint64 bytes = 0;
+			Q_FOREACH (GerberLayerMetrics layerMetrics, metrics.layers) {
+				QJsonObject layer;
+				layer.insert("layer", layerMetrics.layerName);
+				layer.insert("renderMs", layerMetrics.renderNs / 1.0e6);
+				layer.insert("convertMs", layerMetrics.convertNs / 1.0e6);
+				layer.insert("bytes", layerMetrics.bytes);
+				layers.append(layer);
+				bytes += layerMetrics.bytes;
+			}
+			report.insert("layers", layers);
+			report.insert("bytes", bytes);
+			if (metrics.missingPaintIDs.count() > 0 || metrics.donuts > 0) {
+				QJsonObject checks;
+				QJsonArray missingPaint, donuts;
+				Q_FOREACH (long id, metrics.missingPaintIDs) missingPaint.append(QString::number(id));
+				Q_FOREACH (long id, metrics.donutIDs) donuts.append(QString::number(id));
+				checks.insert("missingPaint", missingPaint);
+				checks.insert("donuts", metrics.donuts);
+				checks.insert("donutParts", donuts);
+				report.insert("checks", checks);
+			}
+			report.insert("peakResidentBytes", peakResidentBytes());
+			reports.append(report);
+			releaseForService(mainWindow);
+		}
+	}
+
+	if (m_serviceType == ServiceType::GerberService) {
+		// per-layer timings and output sizes, so exports can be compared from one build to the next
+		QJsonObject summary;
+		summary.insert("sketches", reports);
+		TextUtils::writeUtf8(dir.absoluteFilePath("gerber.json"), QJsonDocument(summary).toJson());
+	}
+}
+
+
+bool FApplication::runExportAllService()
+{
+	initService();
+	return runExportAllServiceAux();
+}
+
+bool FApplication::runExportAllServiceAux()
+{
+	// outputs whose inputs are unchanged since the last export, going by each sketch's manifest, are skipped
+	QDir dir(m_outputFolder);
+	QString s = dir.absolutePath();
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = m_exportAllSketches.isEmpty() ? dir.entryList(filters, QDir::Files) : m_exportAllSketches;
+	QJsonArray reports;
+	bool allExported = true;
+	Q_FOREACH (QString filename, filenames) {
+		QElapsedTimer timer;
+		timer.start();
+		QJsonObject report;
+		report.insert("sketch", filename);
+
+		QString filepath = dir.absoluteFilePath(filename);
+		QFileInfo info(filepath);
+		QString manifestPath = ExportManifest::manifestPath(filepath);
+		ExportManifest manifest;
+		manifest.load(manifestPath);
+		bool hashed = manifest.hashInputs(filepath, m_referenceModel);
+		bool gerber = !hashed || !manifest.isCurrent(ExportManifest::GerberOutput, dir);
+		bool bom = !hashed || !manifest.isCurrent(ExportManifest::BomOutput, dir);
+		bool ipc = !hashed || !manifest.isCurrent(ExportManifest::IpcOutput, dir);
+		if (!gerber && !bom && !ipc) {
+			DebugDialog::debug(QString("%1 is unchanged since its last export").arg(filename));
+			report.insert("unchanged", true);
+			reports.append(report);
+			continue;
+		}
+
+		MainWindow * mainWindow = openWindowForService(false, 3);
+		m_started = true;
+
+		FolderUtils::setOpenSaveFolderAux(m_outputFolder);
+		QJsonArray exported;
+		if (mainWindow->loadWhich(filepath, false, false, false, "")) {
+			if (gerber) {
+				GerberMetrics metrics;
+				GerberGenerator::exportToGerber(info.completeBaseName(), m_outputFolder, nullptr, mainWindow->pcbView(), false, &metrics);
+				QStringList files;
+				Q_FOREACH (GerberLayerMetrics layerMetrics, metrics.layers) {
+					files << layerMetrics.fileName;
+				}
+				QString pickAndPlace = info.completeBaseName() + GerberGenerator::PickAndPlaceSuffix;
+				if (dir.exists(pickAndPlace)) {
+					files << pickAndPlace;
+				}
+				manifest.setExported(ExportManifest::GerberOutput, files);
+				exported.append(QString("gerber"));
+			}
+
+			if (bom) {
+				QString filepathCsv = filepath;
+				TextUtils::writeUtf8(filepathCsv.replace(".fzz", "_bom.csv"), mainWindow->getExportBOM_CSV());
+				manifest.setExported(ExportManifest::BomOutput, QStringList(QFileInfo(filepathCsv).fileName()));
+				exported.append(QString("bom"));
+			}
+
+			if (ipc) {
+				QString filepathIPC = filepath;
+				mainWindow->exportIPC_D_356A(filepathIPC.replace(".fzz", ".ipc"));
+				manifest.setExported(ExportManifest::IpcOutput, QStringList(QFileInfo(filepathIPC).fileName()));
+				exported.append(QString("ipc"));
+			}
+
+			if (hashed) {
+				manifest.save(manifestPath);
+			}
+		}
+		else {
+			report.insert("error", QString("unable to load"));
+			allExported = false;
+		}
+		report.insert("exported", exported);
+		report.insert("ms", timer.elapsed());
+		reports.append(report);
+
+		mainWindow->setCloseSilently(true);
+		mainWindow->close();
+	}
+
+	QJsonObject summary;
+	summary.insert("sketches", reports);
+	TextUtils::writeUtf8(m_exportAllReport.isEmpty() ? dir.absoluteFilePath("exportall.json") : m_exportAllReport, QJsonDocument(summary).toJson());
+	return allExported;
+}
+
+bool FApplication::runExportAllWorkers()
+{
+	// hands the sketches out a few at a time to -all processes of our own, so that a crash costs at most
+	// one batch and the reference model is loaded once per batch rather than once per sketch;
+	// exportall.json is rewritten as each batch finishes, so it also shows the progress
+	QDir dir(m_outputFolder);
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList pending = dir.entryList(filters, QDir::Files);
+	int total = pending.count();
+
+	QTemporaryDir reportDir;
+	if (!reportDir.isValid()) {
+		DebugDialog::debug("unable to create a folder for the worker reports");
+		return false;
+	}
+
+	// the worker gets our own arguments, less -alljobs
+	QStringList baseArgs = QCoreApplication::arguments().mid(1);
+	for (int i = 0; i + 1 < baseArgs.count(); i++) {
+		if (baseArgs.at(i).compare("-alljobs", Qt::CaseInsensitive) == 0 || baseArgs.at(i).compare("--alljobs", Qt::CaseInsensitive) == 0) {
+			baseArgs.removeAt(i);
+			baseArgs.removeAt(i);
+			break;
+		}
+	}
+
+	QJsonArray reports;
+	int failed = 0;
+	int running = 0;
+	int workerIndex = 0;
+	QElapsedTimer timer;
+	timer.start();
+	QEventLoop loop;
+
+	auto writeSummary = [&]() {
+		QJsonObject summary;
+		summary.insert("workers", m_exportAllJobs);
+		summary.insert("total", total);
+		summary.insert("done", reports.count());
+		summary.insert("failed", failed);
+		summary.insert("ms", timer.elapsed());
+		summary.insert("sketches", reports);
+		TextUtils::writeUtf8(dir.absoluteFilePath("exportall.json"), QJsonDocument(summary).toJson());
+	};
+
+	auto finishBatch = [&](const QStringList & batch, const QString & reportPath, const QString & error) {
+		QFile reportFile(reportPath);
+		QSet<QString> reported;
+		if (reportFile.open(QIODevice::ReadOnly)) {
+			Q_FOREACH (QJsonValue value, QJsonDocument::fromJson(reportFile.readAll()).object().value("sketches").toArray()) {
+				QJsonObject report = value.toObject();
+				reported.insert(report.value("sketch").toString());
+				if (report.contains("error")) failed++;
+				reports.append(report);
+			}
+		}
+		Q_FOREACH (QString filename, batch) {
+			if (reported.contains(filename)) continue;
+
+			// the worker died before it got to this one
+			QJsonObject report;
+			report.insert("sketch", filename);
+			report.insert("error", error);
+			failed++;
+			reports.append(report);
+		}
+		writeSummary();
+		DebugDialog::debug(QString("exported %1 of %2 sketches, %3 failed").arg(reports.count()).arg(total).arg(failed));
+	};
+
+	std::function<void()> startWorker = [&]() {
+		// small batches while there is plenty left, down to single sketches at the end, so the workers finish together
+		int batchSize = qBound(1, pending.count() / (m_exportAllJobs * 4), ExportAllBatchSize);
+		QStringList batch = pending.mid(0, batchSize);
+		pending = pending.mid(batchSize);
+		QString reportPath = reportDir.filePath(QString("worker%1.json").arg(workerIndex++));
+
+		QStringList args = baseArgs;
+		Q_FOREACH (QString filename, batch) {
+			args << "-allsketch" << filename;
+		}
+		args << "-allreport" << reportPath;
+
+		QProcess * process = new QProcess(this);
+		process->setProcessChannelMode(QProcess::ForwardedChannels);
+		connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+				[&, process, batch, reportPath](int exitCode, QProcess::ExitStatus exitStatus) {
+			QString error = exitStatus == QProcess::CrashExit
+				? QString("worker crashed")
+				: QString("worker exited with %1").arg(exitCode);
+			finishBatch(batch, reportPath, error);
+			process->deleteLater();
+			running--;
+			if (!pending.isEmpty()) {
+				startWorker();
+			}
+			else if (running == 0) {
+				loop.quit();
+			}
+		});
+		running++;
+		process->start(QCoreApplication::applicationFilePath(), args);
+		if (!process->waitForStarted()) {
+			// finished() never comes for a process that did not start
+			process->disconnect(this);
+			finishBatch(batch, reportPath, QString("worker did not start: %1").arg(process->errorString()));
+			process->deleteLater();
+			running--;
+			if (running == 0) {
+				loop.quit();
+			}
+		}
+	};
+
+	for (int i = 0; i < m_exportAllJobs && !pending.isEmpty(); i++) {
+		startWorker();
+	}
+	if (running > 0) {
+		loop.exec();
+	}
+
+	// only left when workers stopped starting
+	Q_FOREACH (QString filename, pending) {
+		QJsonObject report;
+		report.insert("sketch", filename);
+		report.insert("error", QString("no worker"));
+		failed++;
+		reports.append(report);
+	}
+	writeSummary();
+	return failed == 0;
+}
+
+void FApplication::initService()
+{
+	createUserDataStoreFolderStructures();
+	InstalledFonts::registerFonts();
+	loadReferenceModel("", false);
+}
+
+void FApplication::runSvgService()
+{
+	initService();
+	runSvgServiceAux();
+}
+
+void FApplication::runSvgServiceAux()
+{
+	QDir dir(m_outputFolder);
+	QString s = dir.absolutePath();
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = dir.entryList(filters, QDir::Files);
+	Q_FOREACH (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		FolderUtils::setOpenSaveFolderAux(m_outputFolder);
+		MainWindow * mainWindow = loadForService(filepath, -1);
+		if (mainWindow != nullptr) {
+			QFileInfo info(filepath);
+			QList<ViewLayer::ViewID> ids;
+			ids << ViewLayer::BreadboardView << ViewLayer::SchematicView << ViewLayer::PCBView;
+			Q_FOREACH (ViewLayer::ViewID id, ids) {
+				QString fn = QString("%1_%2.svg").arg(info.completeBaseName()).arg(ViewLayer::viewIDNaturalName(id));
+				QString svgPath = dir.absoluteFilePath(fn);
+				mainWindow->setCurrentView(id);
+				mainWindow->exportSvg(GraphicsUtils::StandardFritzingDPI, false, false, svgPath, m_svgShareParts);
+			}
+			releaseForService(mainWindow);
+		}
+	}
+}
+
+bool FApplication::runNetlistService()
+{
+	// reads each sketch with HeadlessSketch rather than a MainWindow: the reference model
+	// isn't loaded and no views are built, the parts database and the bundled fzps are enough
+	// to trace the schematic nets; writes NAME_netlist.xml next to each .fzz
+	QDir dir(m_outputFolder);
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = dir.entryList(filters, QDir::Files);
+	bool result = true;
+	Q_FOREACH (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		HeadlessSketch sketch;
+		QString error;
+		if (!loadHeadlessSketch(filepath, sketch, error)) {
+			DebugDialog::debug(QString("netlist: unable to load %1: %2").arg(filepath, error));
+			result = false;
+			continue;
+		}
+
+		QFileInfo info(filepath);
+		QString netlistPath = dir.absoluteFilePath(QString("%1_netlist.xml").arg(info.completeBaseName()));
+		if (!TextUtils::writeUtf8(netlistPath, sketch.netlist(info.fileName(), "schematicView"))) {
+			DebugDialog::debug(QString("netlist: unable to write %1").arg(netlistPath));
+			result = false;
+		}
+	}
+
+	return result;
+}
+
+bool FApplication::runDiffService()
+{
+	// compares two sketches read with HeadlessSketch, and prints the added, removed, swapped
+	// and moved parts and the changed nets to stdout as json, for reviewing a change in CI
+	QElapsedTimer timer;
+	timer.start();
+
+	HeadlessSketch before;
+	HeadlessSketch after;
+	QString error;
+	if (m_diffSketch.isEmpty()) {
+		error = "-diff needs two sketches";
+	}
+	else if (!loadHeadlessSketch(m_outputFolder, before, error)) {
+		error = QString("%1: %2").arg(m_outputFolder, error);
+	}
+	else if (!loadHeadlessSketch(m_diffSketch, after, error)) {
+		error = QString("%1: %2").arg(m_diffSketch, error);
+	}
+
+	QJsonObject report;
+	if (error.isEmpty()) {
+		SketchDiff diff;
+		diff.compare(before, after);
+		report = diff.toJson();
+	}
+	else {
+		report.insert("error", error);
+	}
+	report.insert("before", m_outputFolder);
+	report.insert("after", m_diffSketch);
+	report.insert("totalMs", timer.nsecsElapsed() / 1.0e6);
+
+	QTextStream cout(stdout);
+	cout << QJsonDocument(report).toJson();
+	cout.flush();
+
+	return error.isEmpty();
+}
+
+bool FApplication::loadHeadlessSketch(const QString & filepath, HeadlessSketch & sketch, QString & error)
+{
+	// an .fzz with its bundled parts, or a bare .fz against the parts database alone
+	QString dbPath = FolderUtils::getAppPartsSubFolder("").absoluteFilePath("parts.db");
+	if (!sketch.setPartsDatabase(dbPath)) {
+		DebugDialog::debug(QString("unable to open %1").arg(dbPath));
+	}
+
+	if (filepath.endsWith(FritzingBundleExtension, Qt::CaseInsensitive)) {
+		QList<QPair<QString, QByteArray> > entries;
+		if (!FolderUtils::unzipToMemory(filepath, entries, error)) return false;
+
+		return sketch.loadBundle(entries, &error);
+	}
+
+	QFile file(filepath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		error = file.errorString();
+		return false;
+	}
+
+	return sketch.load(file.readAll(), &error);
+}
+
+MainWindow * FApplication::loadForService(const QString & filepath, int initialTab)
+{
+	// the port service keeps its last few sketches loaded, keyed by content,
+	// so a repeated request skips the load; returns nullptr if the sketch doesn't load
+	QByteArray key;
+	if (m_serviceType == ServiceType::PortService && m_serviceWindowCount > 0) {
+		QFile file(filepath);
+		if (file.open(QFile::ReadOnly)) {
+			QCryptographicHash hash(QCryptographicHash::Md5);
+			hash.addData(&file);
+			key = hash.result();
+		}
+
+		for (int i = m_serviceWindows.count() - 1; i >= 0; i--) {
+			if (m_serviceWindows.at(i).window.isNull()) {
+				m_serviceWindows.removeAt(i);
+			}
+		}
+		for (int i = 0; i < m_serviceWindows.count(); i++) {
+			if (!key.isEmpty() && m_serviceWindows.at(i).key == key) {
+				m_serviceWindows.move(i, 0);
+				return m_serviceWindows.first().window;
+			}
+		}
+	}
+
+	MainWindow * mainWindow = takeServiceWindow(initialTab);
+	m_started = true;
+	if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+		mainWindow->setCloseSilently(true);
+		mainWindow->close();
+		return nullptr;
+	}
+
+	if (!key.isEmpty()) {
+		ServiceWindow serviceWindow;
+		serviceWindow.key = key;
+		serviceWindow.window = mainWindow;
+		m_serviceWindows.prepend(serviceWindow);
+		while (m_serviceWindows.count() > m_serviceWindowCount) {
+			ServiceWindow oldest = m_serviceWindows.takeLast();
+			if (!oldest.window.isNull()) {
+				oldest.window->setCloseSilently(true);
+				oldest.window->close();
+			}
+		}
+	}
+
+	return mainWindow;
+}
+
+MainWindow * FApplication::takeServiceWindow(int initialTab)
+{
+	// the port service builds its empty windows ahead of time, between requests, since building
+	// one costs more than most requests; a window that has had a sketch is closed rather than
+	// reused, as the undo stack, model and views have no reset of their own
+	if (m_serviceType != ServiceType::PortService || m_spareWindowCount == 0) {
+		return openWindowForService(false, initialTab);
+	}
+
+	MainWindow * mainWindow = nullptr;
+	if (initialTab == m_spareWindowTab) {
+		while (mainWindow == nullptr && !m_spareWindows.isEmpty()) {
+			mainWindow = m_spareWindows.takeFirst();
+		}
+	}
+	else {
+		// spares for the other tab won't do, and won't be asked for again soon
+		Q_FOREACH (QPointer<MainWindow> spare, m_spareWindows) {
+			if (!spare.isNull()) {
+				spare->setCloseSilently(true);
+				spare->close();
+			}
+		}
+		m_spareWindows.clear();
+		m_spareWindowTab = initialTab;
+	}
+
+	if (mainWindow == nullptr) {
+		mainWindow = openWindowForService(false, initialTab);
+	}
+	QTimer::singleShot(0, this, &FApplication::warmServiceWindows);
+	return mainWindow;
+}
+
+void FApplication::warmServiceWindows()
+{
+	// runs from the event loop; the exports process events, so wait for the job to finish
+	if (m_runningServerJob) return;
+
+	for (int i = m_spareWindows.count() - 1; i >= 0; i--) {
+		if (m_spareWindows.at(i).isNull()) {
+			m_spareWindows.removeAt(i);
+		}
+	}
+	while (m_spareWindows.count() < m_spareWindowCount) {
+		m_spareWindows.append(openWindowForService(false, m_spareWindowTab));
+	}
+}
+
+void FApplication::releaseForService(MainWindow * mainWindow)
+{
+	// closes the window unless it is one the port service keeps loaded
+	Q_FOREACH (ServiceWindow serviceWindow, m_serviceWindows) {
+		if (serviceWindow.window == mainWindow) return;
+	}
+
+	mainWindow->setCloseSilently(true);
+	mainWindow->close();
+}
+
+void FApplication::runDatabaseService()
+{
+	createUserDataStoreFolderStructures();
+
+	DebugDialog::setEnabled(true);
+
+	QString partsDB = m_outputFolder;  // m_outputFolder is actually a full path ending in ".db"
+	QFile::remove(partsDB);
+	if (loadReferenceModel(partsDB, true)) {
+		PartFactory::pregenerate();
+	}
+}
+
+struct GedaElementJob {
+	QString filepath;
+	QString svgpath;
+	QString text;
+	QString error;
+	qint64 ms = 0;
+};
+
+static void convertGedaElement(GedaElementJob & job)
+{
+	// runs on the thread pool; each job has its own converter and writes its own svg
+	QElapsedTimer timer;
+	timer.start();
+	GedaElement2Svg geda;
+	try {
+		QString svg = geda.convertText(job.text, job.filepath, false);
+		if (!TextUtils::writeUtf8(job.svgpath, svg)) {
+			job.error = "unable to open file " + job.svgpath;
+		}
+	}
+	catch (const QString & msg) {
+		job.error = msg;
+	}
+	catch (...) {
+		job.error = "runGedaService: discarding exception";
+	}
+	job.text.clear();
+	job.ms = timer.elapsed();
+}
+
+void FApplication::runGedaService() {
+	// elements are read from each .fp file one at a time, so a large concatenated dump is never held
+	// in memory whole, and converted in parallel batches; a file's second and later elements
+	// go to name_2.svg, name_3.svg...; failures and timings are written to geda.json
+	QElapsedTimer timer;
+	timer.start();
+
+	QDir dir(m_outputFolder);
+	QStringList filters;
+	filters << "*.fp";
+	QStringList filenames = dir.entryList(filters, QDir::Files);
+
+	int batchSize = qMax(1, QThread::idealThreadCount()) * 16;
+	QVector<GedaElementJob> jobs;
+	QJsonArray failures;
+	int elements = 0;
+	qint64 workMs = 0;
+	auto flush = [&]() {
+		QtConcurrent::blockingMap(jobs, convertGedaElement);
+		Q_FOREACH (GedaElementJob job, jobs) {
+			workMs += job.ms;
+			if (job.error.isEmpty()) continue;
+
+			DebugDialog::debug(QString("%1: %2").arg(QFileInfo(job.svgpath).fileName()).arg(job.error));
+			QJsonObject failure;
+			failure.insert("file", QFileInfo(job.filepath).fileName());
+			failure.insert("svg", QFileInfo(job.svgpath).fileName());
+			failure.insert("error", job.error);
+			failures.append(failure);
+		}
+		jobs.clear();
+	};
+
+	Q_FOREACH (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		QFile file(filepath);
+		if (!file.open(QFile::ReadOnly)) {
+			QJsonObject failure;
+			failure.insert("file", filename);
+			failure.insert("error", QObject::tr("unable to open %1").arg(filepath));
+			failures.append(failure);
+			continue;
+		}
+
+		QTextStream textStream(&file);
+		QString text;
+		int count = 0;
+		while (GedaElement2Svg::readElement(textStream, text)) {
+			GedaElementJob job;
+			job.filepath = filepath;
+			job.svgpath = filepath;
+			job.svgpath.replace(".fp", ++count == 1 ? QString(".svg") : QString("_%1.svg").arg(count));
+			job.text = text;
+			jobs.append(job);
+			elements++;
+			if (jobs.count() >= batchSize) flush();
+		}
+		if (count == 0) {
+			QJsonObject failure;
+			failure.insert("file", filename);
+			failure.insert("error", QObject::tr("unable to parse %1").arg(filepath));
+			failures.append(failure);
+		}
+	}
+	flush();
+
+	DebugDialog::debug(QString("geda: %1 files, %2 elements, %3 failed; %4 ms of work, total %5 ms")
+		.arg(filenames.count()).arg(elements).arg(failures.count()).arg(workMs).arg(timer.elapsed()));
+
+	QJsonObject summary;
+	summary.insert("files", filenames.count());
+	summary.insert("elements", elements);
+	summary.insert("workMs", workMs);
+	summary.insert("threads", QThreadPool::globalInstance()->maxThreadCount());
+	summary.insert("totalMs", timer.elapsed());
+	summary.insert("failures", failures);
+	TextUtils::writeUtf8(dir.absoluteFilePath("geda.json"), QJsonDocument(summary).toJson());
+}
+
+
+struct S2SJob {
+	QString fzpPath;
+	QDir svgDir;
+	bool fzpzStyle = false;
+	bool dryRun = false;
+	bool converted = false;
+	QStringList messages;
+	QMap<QString, QString> outputs;
+	qint64 ms = 0;
+};
+
+static void convertS2S(S2SJob & job)
+{
+	// runs on the thread pool; each job has its own converter, which keeps per-file state
+	QElapsedTimer timer;
+	timer.start();
+	S2S s2s(job.fzpzStyle);
+	s2s.setSvgDirs(job.svgDir, job.svgDir);
+	s2s.setDryRun(job.dryRun);
+	QObject::connect(&s2s, &S2S::messageSignal, [&job](const QString & message) {
+		job.messages << message;
+	});
+	QString schematicPath;
+	job.converted = s2s.onefzp(job.fzpPath, schematicPath);
+	job.outputs = s2s.outputs();
+	job.ms = timer.elapsed();
+}
+
+static QString s2sDiff(const QString & path, const QString & after)
+{
+	// a unified diff with a single hunk from the first to the last changed line
+	QString before;
+	QFile file(path);
+	if (file.open(QIODevice::ReadOnly)) {
+		before = QString::fromUtf8(file.readAll());
+	}
+
+	QStringList oldLines = before.split('\n');
+	QStringList newLines = after.split('\n');
+	int prefix = 0;
+	while (prefix < oldLines.count() && prefix < newLines.count() && oldLines.at(prefix) == newLines.at(prefix)) prefix++;
+	int suffix = 0;
+	while (suffix < oldLines.count() - prefix && suffix < newLines.count() - prefix &&
+	        oldLines.at(oldLines.count() - 1 - suffix) == newLines.at(newLines.count() - 1 - suffix)) suffix++;
+	if (prefix == oldLines.count() && prefix == newLines.count()) return QString();
+
+	const int Context = 3;
+	int start = qMax(0, prefix - Context);
+	int oldEnd = qMin(oldLines.count(), oldLines.count() - suffix + Context);
+	int newEnd = qMin(newLines.count(), newLines.count() - suffix + Context);
+
+	QString diff;
+	QTextStream stream(&diff);
+	stream << "--- " << path << "\n" << "+++ " << path << "\n";
+	stream << QString("@@ -%1,%2 +%3,%4 @@\n").arg(start + 1).arg(oldEnd - start).arg(start + 1).arg(newEnd - start);
+	for (int ix = start; ix < prefix; ix++) stream << " " << oldLines.at(ix) << "\n";
+	for (int ix = prefix; ix < oldLines.count() - suffix; ix++) stream << "-" << oldLines.at(ix) << "\n";
+	for (int ix = prefix; ix < newLines.count() - suffix; ix++) stream << "+" << newLines.at(ix) << "\n";
+	for (int ix = oldLines.count() - suffix; ix < oldEnd; ix++) stream << " " << oldLines.at(ix) << "\n";
+	stream.flush();
+	return diff;
+}
+
+void FApplication::runS2SService() {
+	// convert the schematics of all .fzp files in the folder to the 0.1 inch standard, in parallel;
+	// svgs are looked for in ../svg/FOLDERNAME as in the parts repository, otherwise next to the
+	// fzps as in an unzipped fzpz; timings and messages go to s2s.json
+	QElapsedTimer timer;
+	timer.start();
+
+	if (m_s2sThreads > 0) {
+		QThreadPool::globalInstance()->setMaxThreadCount(m_s2sThreads);
+	}
+
+	QDir dir(m_outputFolder);
+	QDir svgDir(dir);
+	bool fzpzStyle = !svgDir.cd(QString("../svg/%1").arg(dir.dirName()));
+	if (fzpzStyle) svgDir = dir;
+
+	QStringList filenames = dir.entryList(QStringList("*.fzp"), QDir::Files, QDir::Name);
+
+	int batchSize = qMax(1, QThread::idealThreadCount()) * 16;
+	QVector<S2SJob> jobs;
+	QJsonArray files;
+	QFile diffFile(dir.absoluteFilePath("s2s.diff"));
+	if (m_s2sDryRun && !diffFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		DebugDialog::debug(QString("unable to write %1").arg(diffFile.fileName()));
+	}
+	int converted = 0;
+	qint64 workMs = 0;
+	auto flush = [&]() {
+		QtConcurrent::blockingMap(jobs, convertS2S);
+		Q_FOREACH (S2SJob job, jobs) {
+			workMs += job.ms;
+			if (job.converted) converted++;
+
+			QJsonObject report;
+			report.insert("file", QFileInfo(job.fzpPath).fileName());
+			report.insert("converted", job.converted);
+			report.insert("ms", job.ms);
+			if (!job.messages.isEmpty()) report.insert("messages", QJsonArray::fromStringList(job.messages));
+			if (m_s2sDryRun) report.insert("changes", QJsonArray::fromStringList(job.outputs.keys()));
+			files.append(report);
+
+			if (diffFile.isOpen()) {
+				for (auto it = job.outputs.constBegin(); it != job.outputs.constEnd(); ++it) {
+					diffFile.write(s2sDiff(it.key(), it.value()).toUtf8());
+				}
+			}
+		}
+		jobs.clear();
+	};
 
-	case ServiceType::DRCService:
-		runDRCService();
-		return 0;
+	Q_FOREACH (QString filename, filenames) {
+		S2SJob job;
+		job.fzpPath = dir.absoluteFilePath(filename);
+		job.svgDir = svgDir;
+		job.fzpzStyle = fzpzStyle;
+		job.dryRun = m_s2sDryRun;
+		jobs.append(job);
+		if (jobs.count() >= batchSize) flush();
+	}
+	flush();
+
+	DebugDialog::debug(QString("s2s: %1 files, %2 converted; %3 ms of work, total %4 ms")
+		.arg(filenames.count()).arg(converted).arg(workMs).arg(timer.elapsed()));
+
+	QJsonObject summary;
+	summary.insert("files", filenames.count());
+	summary.insert("converted", converted);
+	summary.insert("dryRun", m_s2sDryRun);
+	summary.insert("workMs", workMs);
+	summary.insert("threads", QThreadPool::globalInstance()->maxThreadCount());
+	summary.insert("totalMs", timer.elapsed());
+	summary.insert("results", files);
+	TextUtils::writeUtf8(dir.absoluteFilePath("s2s.json"), QJsonDocument(summary).toJson());
+}
+
+
+bool FApplication::runDRCService() {
+	// check every board of every sketch in the folder with one loaded reference model,
+	// and write drc.json and a JUnit drc.xml there; false if any sketch failed or has violations
+	m_started = true;
+	initService();
 
-	case ServiceType::DatabaseService:
-		runDatabaseService();
-		return 0;
+	QDir dir(m_outputFolder);
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = dir.entryList(filters, QDir::Files, QDir::Name);
+
+	QDomDocument junit;
+	QDomElement testsuites = junit.createElement("testsuites");
+	junit.appendChild(testsuites);
+	QDomElement testsuite = junit.createElement("testsuite");
+	testsuite.setAttribute("name", "drc");
+	testsuites.appendChild(testsuite);
+	int failures = 0;
+	int errors = 0;
+	int tests = 0;
+	double suiteSeconds = 0;
+
+	QJsonArray reports;
+	Q_FOREACH (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		QJsonObject report;
+		report.insert("sketch", filename);
+		QString error;
+		int violationCount = 0;
+		QStringList failureLines;
+
+		QElapsedTimer timer;
+		timer.start();
+		MainWindow * mainWindow = openWindowForService(false, 3);
+		if (mainWindow == nullptr) {
+			error = "no window";
+		}
+		else {
+			mainWindow->setCloseSilently(true);
+			if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+				DebugDialog::debug(QString("failed to load '%1'").arg(filepath));
+				error = "load failed";
+			}
+		}
+		report.insert("loadMs", timer.nsecsElapsed() / 1.0e6);
 
-	case ServiceType::KicadFootprintService:
-		runKicadFootprintService();
-		return 0;
+		if (error.isEmpty()) {
+			mainWindow->showPCBView();
+			PCBSketchWidget * pcbView = mainWindow->pcbView();
+
+			int moved = pcbView->checkLoadedTraces();
+			report.insert("movedWires", moved);
+
+			QList<ItemBase *> boards = pcbView->findBoard();
+			if (boards.isEmpty()) error = "no board";
+
+			double keepoutMils = pcbView->getKeepout() * 1000 / GraphicsUtils::SVGDPI;     // pixels to mils
+			report.insert("keepoutMils", keepoutMils);
+			QJsonArray boardReports;
+			Q_FOREACH (ItemBase * board, boards) {
+				QElapsedTimer boardTimer;
+				boardTimer.start();
+				DRC drc(pcbView, board);
+				drc.start(false, keepoutMils);
+
+				QJsonObject boardReport;
+				boardReport.insert("board", board->instanceTitle());
+				boardReport.insert("checkMs", boardTimer.nsecsElapsed() / 1.0e6);
+				QJsonArray violations;
+				Q_FOREACH (DRCViolation violation, drc.violations()) {
+					QJsonObject v;
+					v.insert("message", violation.message);
+					v.insert("parts", QJsonArray::fromStringList(violation.parts));
+					if (!violation.area.isNull()) {
+						QJsonObject area;
+						area.insert("x", violation.area.x());
+						area.insert("y", violation.area.y());
+						area.insert("width", violation.area.width());
+						area.insert("height", violation.area.height());
+						v.insert("areaMils", area);
+					}
+					violations.append(v);
+					failureLines << QString("%1: %2").arg(board->instanceTitle(), violation.message);
+				}
+				violationCount += violations.count();
+				boardReport.insert("violations", violations);
+				boardReports.append(boardReport);
+			}
+			report.insert("boards", boardReports);
+		}
 
-	case ServiceType::KicadSchematicService:
-		runKicadSchematicService();
-		return 0;
+		if (mainWindow != nullptr) {
+			mainWindow->close();
+			delete mainWindow;
+		}
 
-	case ServiceType::GerberService:
-		runGerberService();
-		return 0;
+		double seconds = timer.nsecsElapsed() / 1.0e9;
+		report.insert("totalMs", seconds * 1000);
+		report.insert("violationCount", violationCount);
+		if (!error.isEmpty()) report.insert("error", error);
+		reports.append(report);
+
+		QDomElement testcase = junit.createElement("testcase");
+		testcase.setAttribute("classname", "drc");
+		testcase.setAttribute("name", filename);
+		testcase.setAttribute("time", QString::number(seconds, 'f', 3));
+		testsuite.appendChild(testcase);
+		if (!error.isEmpty()) {
+			QDomElement element = junit.createElement("error");
+			element.setAttribute("message", error);
+			testcase.appendChild(element);
+			errors++;
+		}
+		else if (violationCount > 0) {
+			QDomElement element = junit.createElement("failure");
+			element.setAttribute("message", QString("%1 DRC violations").arg(violationCount));
+			element.appendChild(junit.createTextNode(failureLines.join("\n")));
+			testcase.appendChild(element);
+			failures++;
+		}
+		tests++;
+		suiteSeconds += seconds;
+	}
+
+	testsuite.setAttribute("tests", tests);
+	testsuite.setAttribute("failures", failures);
+	testsuite.setAttribute("errors", errors);
+	testsuite.setAttribute("time", QString::number(suiteSeconds, 'f', 3));
+	TextUtils::writeUtf8(dir.absoluteFilePath("drc.xml"), junit.toString(2));
+
+	QJsonObject summary;
+	summary.insert("sketches", reports);
+	summary.insert("failures", failures);
+	summary.insert("errors", errors);
+	TextUtils::writeUtf8(dir.absoluteFilePath("drc.json"), QJsonDocument(summary).toJson());
+
+	return failures == 0 && errors == 0;
+}
+
+bool FApplication::runERCService() {
+	// check the schematic nets of every sketch in the folder against the parts' erc data,
+	// and write erc.json and a JUnit erc.xml there; false if any sketch failed or has violations
+	m_started = true;
+	initService();
 
-	case ServiceType::ExportAllService:
-		runExportAllService();
-		return 0;
+	QDir dir(m_outputFolder);
+	QStringList filters;
+	filters << "*" + FritzingBundleExtension;
+	QStringList filenames = dir.entryList(filters, QDir::Files, QDir::Name);
+
+	QDomDocument junit;
+	QDomElement testsuites = junit.createElement("testsuites");
+	junit.appendChild(testsuites);
+	QDomElement testsuite = junit.createElement("testsuite");
+	testsuite.setAttribute("name", "erc");
+	testsuites.appendChild(testsuite);
+	int failures = 0;
+	int errors = 0;
+	int tests = 0;
+	double suiteSeconds = 0;
+
+	static const QStringList KindNames = QStringList() << "supplyConflict" << "supplyShort" << "voltageRange" << "overCurrent" << "unpowered";
+
+	QJsonArray reports;
+	Q_FOREACH (QString filename, filenames) {
+		QString filepath = dir.absoluteFilePath(filename);
+		QJsonObject report;
+		report.insert("sketch", filename);
+		QString error;
+		QStringList failureLines;
+		QList<ErcViolation> violations;
+
+		QElapsedTimer timer;
+		timer.start();
+		MainWindow * mainWindow = openWindowForService(false, 2);
+		if (mainWindow == nullptr) {
+			error = "no window";
+		}
+		else {
+			mainWindow->setCloseSilently(true);
+			if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+				DebugDialog::debug(QString("failed to load '%1'").arg(filepath));
+				error = "load failed";
+			}
+		}
+		report.insert("loadMs", timer.nsecsElapsed() / 1.0e6);
 
-	case ServiceType::SvgService:
-		runSvgService();
-		return 0;
+		if (error.isEmpty()) {
+			SketchWidget * schematicView = nullptr;
+			Q_FOREACH (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+				if (sketchWidget->viewID() == ViewLayer::SchematicView) schematicView = sketchWidget;
+			}
+			if (schematicView == nullptr) error = "no schematic view";
+			else {
+				QElapsedTimer checkTimer;
+				checkTimer.start();
+				QList<ErcNet> nets;
+				schematicView->collectErcNets(nets);
+				ErcEngine engine;
+				violations = engine.check(nets);
+				report.insert("checkMs", checkTimer.nsecsElapsed() / 1.0e6);
+				report.insert("nets", nets.count());
+			}
+		}
 
-	case ServiceType::ExampleService:
-		runExampleService();
-		return 0;
+		QJsonArray violationReports;
+		Q_FOREACH (ErcViolation violation, violations) {
+			QJsonObject v;
+			v.insert("kind", KindNames.value(violation.kind));
+			v.insert("message", violation.message);
+			v.insert("parts", QJsonArray::fromStringList(violation.parts));
+			violationReports.append(v);
+			failureLines << violation.message;
+		}
+		report.insert("violations", violationReports);
 
-	default:
-		DebugDialog::debug("unknown service");
-		return -1;
-	}
-}
+		if (mainWindow != nullptr) {
+			mainWindow->close();
+			delete mainWindow;
+		}
 
-void FApplication::runGerberService()
-{
+		double seconds = timer.nsecsElapsed() / 1.0e9;
+		report.insert("totalMs", seconds * 1000);
+		report.insert("violationCount", violations.count());
+		if (!error.isEmpty()) report.insert("error", error);
+		reports.append(report);
+
+		QDomElement testcase = junit.createElement("testcase");
+		testcase.setAttribute("classname", "erc");
+		testcase.setAttribute("name", filename);
+		testcase.setAttribute("time", QString::number(seconds, 'f', 3));
+		testsuite.appendChild(testcase);
+		if (!error.isEmpty()) {
+			QDomElement element = junit.createElement("error");
+			element.setAttribute("message", error);
+			testcase.appendChild(element);
+			errors++;
+		}
+		else if (!violations.isEmpty()) {
+			QDomElement element = junit.createElement("failure");
+			element.setAttribute("message", QString("%1 ERC violations").arg(violations.count()));
+			element.appendChild(junit.createTextNode(failureLines.join("\n")));
+			testcase.appendChild(element);
+			failures++;
+		}
+		tests++;
+		suiteSeconds += seconds;
+	}
+
+	testsuite.setAttribute("tests", tests);
+	testsuite.setAttribute("failures", failures);
+	testsuite.setAttribute("errors", errors);
+	testsuite.setAttribute("time", QString::number(suiteSeconds, 'f', 3));
+	TextUtils::writeUtf8(dir.absoluteFilePath("erc.xml"), junit.toString(2));
+
+	QJsonObject summary;
+	summary.insert("sketches", reports);
+	summary.insert("failures", failures);
+	summary.insert("errors", errors);
+	TextUtils::writeUtf8(dir.absoluteFilePath("erc.json"), QJsonDocument(summary).toJson());
+
+	return failures == 0 && errors == 0;
+}
+
+void FApplication::runAutorouteService() {
+	// autoroute the pcb view of every sketch in the folder, save it next to the original,
+	// and report per-phase timings so the runs can be compared from one build to the next
+	m_started = true;
 	initService();
-	runGerberServiceAux();
-}
 
-void FApplication::runGerberServiceAux()
-{
 	QDir dir(m_outputFolder);
-	QString s = dir.absolutePath();
 	QStringList filters;
 	filters << "*" + FritzingBundleExtension;
 	QStringList filenames = dir.entryList(filters, QDir::Files);
+	QJsonArray reports;
 	Q_FOREACH (QString filename, filenames) {
+		if (filename.endsWith("_autorouted" + FritzingBundleExtension)) continue;
+
 		QString filepath = dir.absoluteFilePath(filename);
+		QFileInfo info(filepath);
+		QJsonObject report;
+		report.insert("sketch", filename);
+
 		MainWindow * mainWindow = openWindowForService(false, 3);
-		m_started = true;
+		if (mainWindow == nullptr) continue;
 
+		mainWindow->setCloseSilently(true);
 		FolderUtils::setOpenSaveFolderAux(m_outputFolder);
-		if (mainWindow->loadWhich(filepath, false, false, false, "")) {
-			QFileInfo info(filepath);
-			GerberGenerator::exportToGerber(info.completeBaseName(), m_outputFolder, nullptr, mainWindow->pcbView(), false);
+		if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+			DebugDialog::debug(QString("failed to load '%1'").arg(filepath));
+			report.insert("error", QString("load failed"));
+			reports.append(report);
+			mainWindow->close();
+			delete mainWindow;
+			continue;
 		}
 
-		mainWindow->setCloseSilently(true);
+		mainWindow->showPCBView();
+		PCBSketchWidget * pcbView = mainWindow->pcbView();
+		QList<ItemBase *> boards = pcbView->findBoard();
+		if (boards.count() != 1) {
+			report.insert("error", QString("sketch needs exactly one board, has %1").arg(boards.count()));
+			reports.append(report);
+			mainWindow->close();
+			delete mainWindow;
+			continue;
+		}
+
+		QElapsedTimer timer;
+		timer.start();
+		pcbView->setIgnoreSelectionChangeEvents(true);
+		auto * mazeRouter = new MazeRouter(pcbView, boards.first(), true);
+		mazeRouter->overrideSettings(m_autorouteSettings);
+		mazeRouter->start();
+		pcbView->setIgnoreSelectionChangeEvents(false);
+		qint64 totalNs = timer.nsecsElapsed();
+
+		const RouterMetrics & metrics = mazeRouter->metrics();
+		QJsonObject phases;
+		phases.insert("makeMasters", metrics.makeMastersNs / 1.0e6);
+		phases.insert("route", metrics.routeNs / 1.0e6);
+		phases.insert("traceBack", metrics.traceBackNs / 1.0e6);
+		phases.insert("optimizeTraces", metrics.optimizeTracesNs / 1.0e6);
+		phases.insert("createTraces", metrics.createTracesNs / 1.0e6);
+
+		// the check that follows a route, over the nets near the new copper only
+		QElapsedTimer verifyTimer;
+		verifyTimer.start();
+		DRC drc(pcbView, boards.first());
+		int overlaps = drc.verifyRoute(mazeRouter->routedRegion(), pcbView->getKeepout() * 1000 / GraphicsUtils::SVGDPI);     // pixels to mils
+		phases.insert("verify", verifyTimer.nsecsElapsed() / 1.0e6);
+		report.insert("verifyOverlaps", overlaps);
+		report.insert("phasesMs", phases);
+		report.insert("totalMs", totalNs / 1.0e6);
+		report.insert("expansions", metrics.expansions);
+		report.insert("cellsPerSecond", metrics.cellsPerSecond());
+		report.insert("queueHighWater", metrics.queueHighWater);
+		report.insert("traceBackPoints", metrics.traceBackPoints);
+		QJsonArray roundsMs;
+		Q_FOREACH (qint64 ns, metrics.roundNs) roundsMs.append(ns / 1.0e6);
+		report.insert("roundsMs", roundsMs);
+		report.insert("peakGridBytes", metrics.peakGridBytes);
+		report.insert("peakResidentBytes", peakResidentBytes());
+		report.insert("rounds", metrics.rounds);
+		report.insert("connections", metrics.totalToRoute);
+		report.insert("routed", metrics.routedCount);
+		report.insert("unrouted", metrics.totalToRoute - metrics.routedCount);
+		report.insert("vias", metrics.viaCount);
+		report.insert("completed", metrics.completed);
+		delete mazeRouter;
+
+		QString routedPath = dir.absoluteFilePath(info.completeBaseName() + "_autorouted" + FritzingBundleExtension);
+		if (!mainWindow->saveAsAux(routedPath)) {
+			report.insert("error", QString("save failed"));
+		}
+		reports.append(report);
+		TextUtils::writeUtf8(dir.absoluteFilePath(info.completeBaseName() + "_autoroute.json"), QJsonDocument(report).toJson());
+
 		mainWindow->close();
+		delete mainWindow;
 	}
-}
 
+	QJsonObject summary;
+	summary.insert("sketches", reports);
+	TextUtils::writeUtf8(dir.absoluteFilePath("autoroute.json"), QJsonDocument(summary).toJson());
+}
 
-void FApplication::runExportAllService()
-{
+bool FApplication::runSimulateService() {
+	// run the simulator on every sketch in the folder and write the net voltages, part currents and
+	// smoking parts of each to simulate.json there; false if any sketch could not be simulated
+	m_started = true;
 	initService();
-	runExportAllServiceAux();
-}
+	FMessageBox::BlockMessages = true;
 
-void FApplication::runExportAllServiceAux()
-{
 	QDir dir(m_outputFolder);
-	QString s = dir.absolutePath();
 	QStringList filters;
 	filters << "*" + FritzingBundleExtension;
-	QStringList filenames = dir.entryList(filters, QDir::Files);
+	QStringList filenames = dir.entryList(filters, QDir::Files, QDir::Name);
+	QJsonArray reports;
+	int errors = 0;
 	Q_FOREACH (QString filename, filenames) {
 		QString filepath = dir.absoluteFilePath(filename);
-		MainWindow * mainWindow = openWindowForService(false, 3);
-		m_started = true;
+		QJsonObject report;
+		report.insert("sketch", filename);
 
-		FolderUtils::setOpenSaveFolderAux(m_outputFolder);
-		if (mainWindow->loadWhich(filepath, false, false, false, "")) {
-			QFileInfo info(filepath);
-			GerberGenerator::exportToGerber(info.completeBaseName(), m_outputFolder, nullptr, mainWindow->pcbView(), false);
+		QElapsedTimer timer;
+		timer.start();
+		MainWindow * mainWindow = openWindowForService(false, 1);
+		if (mainWindow == nullptr) {
+			report.insert("error", QString("no window"));
+			reports.append(report);
+			errors++;
+			continue;
+		}
+
+		mainWindow->setCloseSilently(true);
+		if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+			DebugDialog::debug(QString("failed to load '%1'").arg(filepath));
+			report.insert("error", QString("load failed"));
+			reports.append(report);
+			errors++;
+			mainWindow->close();
+			delete mainWindow;
+			continue;
+		}
+		report.insert("loadMs", timer.nsecsElapsed() / 1.0e6);
 
-			QString filepathCsv = filepath;
-			TextUtils::writeUtf8(filepathCsv.replace(".fzz", "_bom.csv"), mainWindow->getExportBOM_CSV());
+		QElapsedTimer simTimer;
+		simTimer.start();
+		Simulator * simulator = mainWindow->simulator();
+		simulator->enable(true);
+		QEventLoop loop;
+		connect(simulator, &Simulator::simulationFinished, &loop, &QEventLoop::quit);
+		simulator->startSimulation();
+		if (simulator->isRunning()) {
+			// the simulator times itself out, so this returns
+			loop.exec();
+		}
+		simulator->stopSimulation();
+		report.insert("simulateMs", simTimer.nsecsElapsed() / 1.0e6);
+
+		const SimulationResults & results = simulator->results();
+		if (results.completed) {
+			QJsonObject phases;
+			phases.insert("netlist", results.netlistMs);
+			phases.insert("load", results.loadMs);
+			phases.insert("run", results.runMs);
+			phases.insert("fetch", results.fetchMs);
+			phases.insert("update", results.updateMs);
+			report.insert("phasesMs", phases);
+			report.insert("parts", results.partCount);
+			report.insert("reused", results.reused);
+			report.insert("cached", results.cached);
+			QJsonArray nets;
+			for (int i = 0; i < results.netVoltages.count(); i++) {
+				if (results.netConnectors.at(i).isEmpty()) continue;
+
+				QJsonObject net;
+				net.insert("net", i);
+				net.insert("voltage", results.netVoltages.at(i));
+				net.insert("connectors", QJsonArray::fromStringList(results.netConnectors.at(i)));
+				nets.append(net);
+			}
+			report.insert("nets", nets);
 
-			QString filepathIPC = filepath;
-			TextUtils::writeUtf8(filepathIPC.replace(".fzz", ".ipc"), mainWindow->exportIPC_D_356A());
+			QJsonObject currents;
+			Q_FOREACH (QString title, results.partCurrents.keys()) {
+				currents.insert(title, results.partCurrents.value(title));
+			}
+			report.insert("currents", currents);
+			report.insert("smoke", QJsonArray::fromStringList(results.smokedParts));
+		}
+		else {
+			report.insert("error", results.error.isEmpty() ? QString("nothing to simulate") : results.error);
+			errors++;
 		}
+		report.insert("totalMs", timer.nsecsElapsed() / 1.0e6);
+		reports.append(report);
 
-		mainWindow->setCloseSilently(true);
 		mainWindow->close();
+		delete mainWindow;
 	}
-}
 
-void FApplication::initService()
-{
-	createUserDataStoreFolderStructures();
-	registerFonts();
-	loadReferenceModel("", false);
+	QJsonObject summary;
+	summary.insert("sketches", reports);
+	summary.insert("errors", errors);
+	TextUtils::writeUtf8(dir.absoluteFilePath("simulate.json"), QJsonDocument(summary).toJson());
+
+	return errors == 0;
 }
 
-void FApplication::runSvgService()
-{
+bool FApplication::runMemoryService() {
+	// load every sketch in the folder and write the approximate memory of each, by subsystem, to memory.json
+	// there; each sketch is loaded into a fresh window, which is closed before the next; false if any fails to load
+	m_started = true;
 	initService();
-	runSvgServiceAux();
-}
+	FMessageBox::BlockMessages = true;
 
-void FApplication::runSvgServiceAux()
-{
 	QDir dir(m_outputFolder);
-	QString s = dir.absolutePath();
 	QStringList filters;
 	filters << "*" + FritzingBundleExtension;
-	QStringList filenames = dir.entryList(filters, QDir::Files);
+	QStringList filenames = dir.entryList(filters, QDir::Files, QDir::Name);
+	QJsonArray reports;
+	int errors = 0;
 	Q_FOREACH (QString filename, filenames) {
 		QString filepath = dir.absoluteFilePath(filename);
-		MainWindow * mainWindow = openWindowForService(false, -1);
-		m_started = true;
+		QJsonObject report;
+		qint64 residentBefore = residentBytes();
 
-		FolderUtils::setOpenSaveFolderAux(m_outputFolder);
-		if (mainWindow->loadWhich(filepath, false, false, false, "")) {
-			QFileInfo info(filepath);
-			QList<ViewLayer::ViewID> ids;
-			ids << ViewLayer::BreadboardView << ViewLayer::SchematicView << ViewLayer::PCBView;
-			Q_FOREACH (ViewLayer::ViewID id, ids) {
-				QString fn = QString("%1_%2.svg").arg(info.completeBaseName()).arg(ViewLayer::viewIDNaturalName(id));
-				QString svgPath = dir.absoluteFilePath(fn);
-				mainWindow->setCurrentView(id);
-				mainWindow->exportSvg(GraphicsUtils::StandardFritzingDPI, false, false, svgPath);
-			}
+		MainWindow * mainWindow = openWindowForService(false, 1);
+		if (mainWindow == nullptr) {
+			report.insert("sketch", filename);
+			report.insert("error", QString("no window"));
+			reports.append(report);
+			errors++;
+			continue;
 		}
 
 		mainWindow->setCloseSilently(true);
+		if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
+			DebugDialog::debug(QString("failed to load '%1'").arg(filepath));
+			report.insert("sketch", filename);
+			report.insert("error", QString("load failed"));
+			reports.append(report);
+			errors++;
+			mainWindow->close();
+			delete mainWindow;
+			continue;
+		}
+
+		report = mainWindow->memoryReport();
+		report.insert("sketch", filename);
+		if (residentBefore >= 0) {
+			// what the process grew by while loading, to set against the estimate
+			report.insert("residentGrowthBytes", residentBytes() - residentBefore);
+		}
+		DebugDialog::debug(QString("%1\n%2").arg(filename, MemoryReport::summary(report)));
+		reports.append(report);
+
 		mainWindow->close();
+		delete mainWindow;
 	}
-}
 
-void FApplication::runDatabaseService()
-{
-	createUserDataStoreFolderStructures();
-
-	DebugDialog::setEnabled(true);
+	QJsonObject summary;
+	summary.insert("sketches", reports);
+	summary.insert("errors", errors);
+	summary.insert("peakResidentBytes", peakResidentBytes());
+	TextUtils::writeUtf8(dir.absoluteFilePath("memory.json"), QJsonDocument(summary).toJson());
 
-	QString partsDB = m_outputFolder;  // m_outputFolder is actually a full path ending in ".db"
-	QFile::remove(partsDB);
-	loadReferenceModel(partsDB, true);
+	return errors == 0;
 }
 
-void FApplication::runGedaService() {
-	try {
-		QDir dir(m_outputFolder);
-		QStringList filters;
-		filters << "*.fp";
-		QStringList filenames = dir.entryList(filters, QDir::Files);
-		Q_FOREACH (QString filename, filenames) {
-			QString filepath = dir.absoluteFilePath(filename);
-			QString newfilepath = filepath;
-			newfilepath.replace(".fp", ".svg");
-			GedaElement2Svg geda;
-			QString svg = geda.convert(filepath, false);
-			TextUtils::writeUtf8(newfilepath, svg);
-		}
-	}
-	catch (const QString & msg) {
-		DebugDialog::debug(msg);
-	}
-	catch (...) {
-		// Not sure why this was originally added.
-		DebugDialog::debug("runGedaService: discarding exception");
-	}
-}
+static QString csvField(const QString & field)
+{
+	if (!field.contains(',') && !field.contains('"') && !field.contains('\n')) return field;
 
+	QString quoted = field;
+	return "\"" + quoted.replace("\"", "\"\"") + "\"";
+}
 
-void FApplication::runDRCService() {
+bool FApplication::runPerformanceService() {
+	// open every bundled example sketch in turn and write one csv row per sketch: open time, a render of each
+	// view, routing status, DRC and Gerber export times and memory, so that releases can be compared on a
+	// realistic corpus; fields that don't apply (no board, say) are left empty; false if any sketch fails to load
 	m_started = true;
 	initService();
-	DebugDialog::setEnabled(true);
-
-	try {
-		QDir dir(m_outputFolder);
-		QStringList filters;
-		filters << "*.fzz";
-		QStringList filenames = dir.entryList(filters, QDir::Files);
-		Q_FOREACH (QString filename, filenames) {
-			QString filepath = dir.absoluteFilePath(filename);
-			MainWindow * mainWindow = openWindowForService(false, 3);
-			if (mainWindow == nullptr) continue;
+	FMessageBox::BlockMessages = true;
 
+	QDir sketchesDir(FolderUtils::getApplicationSubFolderPath("sketches"));
+	QStringList sketches;
+	QDirIterator iterator(sketchesDir.absolutePath(), QStringList("*" + FritzingBundleExtension), QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+	while (iterator.hasNext()) {
+		sketches << sketchesDir.relativeFilePath(iterator.next());
+	}
+	sketches.sort();
+
+	QTemporaryDir gerberDir;
+	if (!gerberDir.isValid()) {
+		DebugDialog::debug("unable to create a folder for the gerber output");
+		return false;
+	}
+
+	QStringList columns;
+	columns << "sketch" << "openMs"
+			<< "breadboardRenderMs" << "schematicRenderMs" << "pcbRenderMs"
+			<< "routingMs" << "breadboardNets" << "breadboardRouted" << "schematicNets" << "schematicRouted"
+			<< "pcbNets" << "pcbRouted" << "pcbConnectorsLeft" << "pcbJumpers"
+			<< "boards" << "drcMs" << "drcViolations" << "gerberMs" << "gerberBytes"
+			<< "residentBytes" << "peakResidentBytes" << "error";
+	QStringList lines;
+	lines << columns.join(',');
+
+	int errors = 0;
+	Q_FOREACH (QString sketch, sketches) {
+		QString filepath = sketchesDir.absoluteFilePath(sketch);
+		QHash<QString, QString> row;
+		row.insert("sketch", sketch);
+		DebugDialog::debug(QString("performance run: %1").arg(sketch));
+
+		QElapsedTimer timer;
+		timer.start();
+		MainWindow * mainWindow = openWindowForService(false, 3);
+		if (mainWindow == nullptr) {
+			row.insert("error", "no window");
+		}
+		else {
 			mainWindow->setCloseSilently(true);
-
 			if (!mainWindow->loadWhich(filepath, false, false, false, "")) {
-				DebugDialog::debug(QString("failed to load '%1'").arg(filepath));
-				mainWindow->close();
-				delete mainWindow;
-				continue;
+				row.insert("error", "load failed");
 			}
+		}
+		row.insert("openMs", QString::number(timer.nsecsElapsed() / 1.0e6, 'f', 1));
+
+		if (!row.contains("error")) {
+			QJsonObject renders = mainWindow->renderTimings();
+			row.insert("breadboardRenderMs", QString::number(renders.value(ViewLayer::viewIDXmlName(ViewLayer::BreadboardView)).toObject().value("ms").toDouble(), 'f', 1));
+			row.insert("schematicRenderMs", QString::number(renders.value(ViewLayer::viewIDXmlName(ViewLayer::SchematicView)).toObject().value("ms").toDouble(), 'f', 1));
+			row.insert("pcbRenderMs", QString::number(renders.value(ViewLayer::viewIDXmlName(ViewLayer::PCBView)).toObject().value("ms").toDouble(), 'f', 1));
+
+			timer.restart();
+			QList<RoutingStatus> statuses;
+			Q_FOREACH (SketchWidget * sketchWidget, mainWindow->sketchWidgets()) {
+				RoutingStatus routingStatus;
+				routingStatus.zero();
+				sketchWidget->updateRoutingStatus(nullptr, routingStatus, true);
+				statuses << routingStatus;
+			}
+			row.insert("routingMs", QString::number(timer.nsecsElapsed() / 1.0e6, 'f', 1));
+			row.insert("breadboardNets", QString::number(statuses.at(0).m_netCount));
+			row.insert("breadboardRouted", QString::number(statuses.at(0).m_netRoutedCount));
+			row.insert("schematicNets", QString::number(statuses.at(1).m_netCount));
+			row.insert("schematicRouted", QString::number(statuses.at(1).m_netRoutedCount));
+			row.insert("pcbNets", QString::number(statuses.at(2).m_netCount));
+			row.insert("pcbRouted", QString::number(statuses.at(2).m_netRoutedCount));
+			row.insert("pcbConnectorsLeft", QString::number(statuses.at(2).m_connectorsLeftToRoute));
+			row.insert("pcbJumpers", QString::number(statuses.at(2).m_jumperItemCount));
 
 			mainWindow->showPCBView();
-
-			int moved = mainWindow->pcbView()->checkLoadedTraces();
-			if (moved > 0) {
-				QMessageBox::warning(nullptr, QObject::tr("Fritzing"), QObject::tr("%1 wires moved from their saved position in %2.").arg(moved).arg(filepath));
-				DebugDialog::debug(QString("\ncheckloadedtraces %1\n").arg(filepath));
+			PCBSketchWidget * pcbView = mainWindow->pcbView();
+			QList<ItemBase *> boards = pcbView->findBoard();
+			row.insert("boards", QString::number(boards.count()));
+			if (boards.count() > 0) {
+				double keepoutMils = pcbView->getKeepout() * 1000 / GraphicsUtils::SVGDPI;     // pixels to mils
+				int violations = 0;
+				timer.restart();
+				Q_FOREACH (ItemBase * board, boards) {
+					DRC drc(pcbView, board);
+					drc.start(false, keepoutMils);
+					violations += drc.violations().count();
+				}
+				row.insert("drcMs", QString::number(timer.nsecsElapsed() / 1.0e6, 'f', 1));
+				row.insert("drcViolations", QString::number(violations));
+
+				GerberMetrics metrics;
+				timer.restart();
+				GerberGenerator::exportToGerber(QFileInfo(filepath).completeBaseName(), gerberDir.path(), nullptr, pcbView, false, &metrics);
+				row.insert("gerberMs", QString::number(timer.nsecsElapsed() / 1.0e6, 'f', 1));
+				qint64 bytes = 0;
+				Q_FOREACH (GerberLayerMetrics layerMetrics, metrics.layers) bytes += layerMetrics.bytes;
+				row.insert("gerberBytes", QString::number(bytes));
 			}
+		}
 
+		// the peak is the whole run's so far, so it only tells which sketch pushed it up
+		row.insert("residentBytes", QString::number(residentBytes()));
+		row.insert("peakResidentBytes", QString::number(peakResidentBytes()));
 
-			Checker::checkDonuts(mainWindow, true);
-			Checker::checkText(mainWindow, true);
+		if (row.contains("error")) {
+			DebugDialog::debug(QString("%1: %2").arg(sketch, row.value("error")));
+			errors++;
+		}
 
-			QList<ItemBase *> boards = mainWindow->pcbView()->findBoard();
-			Q_FOREACH (ItemBase * boardItem, boards) {
-				mainWindow->pcbView()->selectAllItems(false, false);
-				boardItem->setSelected(true);
-				mainWindow->newDesignRulesCheck(false);
-			}
+		QStringList fields;
+		Q_FOREACH (QString column, columns) fields << csvField(row.value(column));
+		lines << fields.join(',');
 
+		if (mainWindow != nullptr) {
 			mainWindow->close();
 			delete mainWindow;
 		}
 	}
+
+	if (!TextUtils::writeUtf8(m_performanceReport, lines.join('\n') + '\n')) {
+		DebugDialog::debug(QString("unable to write %1").arg(m_performanceReport));
+		return false;
+	}
+
+	return errors == 0;
+}
+
+struct KicadFootprintJob {
+	QString filepath;
+	QString moduleName;
+	QString moduleText;
+	QString error;
+	qint64 ms = 0;
+};
+
+static void convertKicadFootprint(KicadFootprintJob & job)
+{
+	// runs on the thread pool; each job has its own converter and writes its own svg
+	QElapsedTimer timer;
+	timer.start();
+	KicadModule2Svg kicad;
+	try {
+		QString svg = job.moduleText.isEmpty()
+			? kicad.convert(job.filepath, job.moduleName, false)
+			: kicad.convertText(job.filepath, job.moduleName, job.moduleText, false);
+		if (svg.isEmpty()) {
+			job.error = "svg is empty";
+		}
+		else {
+			QString moduleName = job.moduleName;
+			Q_FOREACH (QChar c, QString("<>:\"/\\|?*")) {
+				moduleName.remove(c);
+			}
+
+			QFileInfo info(job.filepath);
+			QString newFilePath = info.dir().absoluteFilePath(moduleName + "_" + info.fileName());
+			newFilePath.replace(".mod", ".svg");
+
+			if (!TextUtils::writeUtf8(newFilePath, svg)) {
+				job.error = "unable to open file " + newFilePath;
+			}
+		}
+	}
 	catch (const QString & msg) {
-		DebugDialog::debug(msg);
+		job.error = msg;
 	}
 	catch (...) {
-		// Not sure why this was originally added.
-		DebugDialog::debug("runDRCService: discarding exception");
+		job.error = "who knows";
 	}
+	job.moduleText.clear();
+	job.ms = timer.elapsed();
 }
 
 void FApplication::runKicadFootprintService() {
+	// each library is read once and its modules are converted in parallel;
+	// failures and timings are reported at the end, and written to kicadfootprints.json
+	QElapsedTimer timer;
+	timer.start();
+
 	QDir dir(m_outputFolder);
 	QStringList filters;
 	filters << "*.mod";
 	QStringList filenames = dir.entryList(filters, QDir::Files);
+	QVector<KicadFootprintJob> jobs;
+	qint64 readMs = 0;
 	Q_FOREACH (QString filename, filenames) {
+		QElapsedTimer readTimer;
+		readTimer.start();
 		QString filepath = dir.absoluteFilePath(filename);
-		QStringList moduleNames = KicadModule2Svg::listModules(filepath);
+		QStringList moduleNames;
+		QHash<QString, QString> moduleTexts = KicadModule2Svg::splitModules(filepath, moduleNames);
 		Q_FOREACH (QString moduleName, moduleNames) {
-			KicadModule2Svg kicad;
-			try {
-				QString svg = kicad.convert(filepath, moduleName, false);
-				if (svg.isEmpty()) {
-					DebugDialog::debug("svg is empty " + filepath + " " + moduleName);
-					continue;
-				}
-				Q_FOREACH (QChar c, QString("<>:\"/\\|?*")) {
-					moduleName.remove(c);
-				}
-
-				QString newFilePath = dir.absoluteFilePath(moduleName + "_" + filename);
-				newFilePath.replace(".mod", ".svg");
-
-				if (!TextUtils::writeUtf8(newFilePath, svg)) {
-					DebugDialog::debug("unable to open file " + newFilePath);
-				}
-			}
-			catch (const QString & msg) {
-				DebugDialog::debug(msg);
-			}
-			catch (...) {
-				DebugDialog::debug("who knows");
-			}
-		}
-	}
+			KicadFootprintJob job;
+			job.filepath = filepath;
+			job.moduleName = moduleName;
+			// an index entry without a matching $MODULE line goes through the file-based lookup
+			job.moduleText = moduleTexts.value(moduleName);
+			jobs.append(job);
+		}
+		readMs += readTimer.elapsed();
+	}
+
+	QElapsedTimer convertTimer;
+	convertTimer.start();
+	QtConcurrent::blockingMap(jobs, convertKicadFootprint);
+	qint64 convertMs = convertTimer.elapsed();
+
+	QJsonArray failures;
+	qint64 totalJobMs = 0;
+	qint64 slowestMs = 0;
+	QString slowest;
+	Q_FOREACH (KicadFootprintJob job, jobs) {
+		totalJobMs += job.ms;
+		if (job.ms > slowestMs) {
+			slowestMs = job.ms;
+			slowest = job.moduleName;
+		}
+		if (job.error.isEmpty()) continue;
+
+		DebugDialog::debug(QString("%1 %2: %3").arg(QFileInfo(job.filepath).fileName()).arg(job.moduleName).arg(job.error));
+		QJsonObject failure;
+		failure.insert("library", QFileInfo(job.filepath).fileName());
+		failure.insert("module", job.moduleName);
+		failure.insert("error", job.error);
+		failures.append(failure);
+	}
+
+	DebugDialog::debug(QString("kicad footprints: %1 libraries, %2 modules, %3 failed; read %4 ms, convert %5 ms (%6 ms of work, slowest %7 %8 ms), total %9 ms")
+		.arg(filenames.count()).arg(jobs.count()).arg(failures.count())
+		.arg(readMs).arg(convertMs).arg(totalJobMs).arg(slowest).arg(slowestMs).arg(timer.elapsed()));
+
+	QJsonObject summary;
+	summary.insert("libraries", filenames.count());
+	summary.insert("modules", jobs.count());
+	summary.insert("readMs", readMs);
+	summary.insert("convertMs", convertMs);
+	summary.insert("workMs", totalJobMs);
+	summary.insert("threads", QThreadPool::globalInstance()->maxThreadCount());
+	summary.insert("totalMs", timer.elapsed());
+	summary.insert("failures", failures);
+	TextUtils::writeUtf8(dir.absoluteFilePath("kicadfootprints.json"), QJsonDocument(summary).toJson());
 }
 
 void FApplication::runKicadSchematicService() {
@@ -1186,6 +3105,7 @@ int FApplication::startup()
 		}
 	}
 
+	StartupProfiler::begin("splash");
 	QPixmap pixmap(splashName);
 	FSplashScreen splash(pixmap);
 	m_splash = &splash;
@@ -1193,10 +3113,13 @@ int FApplication::startup()
 
 	initSplash(splash);
 	ProcessEventBlocker::processEvents();
+	StartupProfiler::end();
 
 	// DebugDialog::debug("Data Location: "+QDesktopServices::storageLocation(QDesktopServices::DataLocation));
 
-	registerFonts();
+	StartupProfiler::begin("fonts");
+	InstalledFonts::registerUIFonts();
+	StartupProfiler::end();
 
 	if (m_progressIndex >= 0) splash.showProgress(m_progressIndex, LoadProgressStart);
 	ProcessEventBlocker::processEvents();
@@ -1217,16 +3140,21 @@ int FApplication::startup()
 	                   .arg("%1") );
 #endif
 
+	StartupProfiler::begin("user folders");
 	createUserDataStoreFolderStructures();
 
 	cleanFzzs();
+	StartupProfiler::end();
 
 	ProcessEventBlocker::processEvents();
 
+	StartupProfiler::begin("reference model");
 	loadReferenceModel("", false);
+	StartupProfiler::end();
 
 	ProcessEventBlocker::processEvents();
 
+	StartupProfiler::begin("settings");
 	QString prevVersion;
 	{
 		// put this in a block so that QSettings is closed
@@ -1254,14 +3182,19 @@ int FApplication::startup()
 			}
 		}
 	}
+	SettingsCache::reload();
+
+	StartupProfiler::end();
 
 	//bool fabEnabled = settings.value(ORDERFABENABLED, QVariant(false)).toBool();
 	//if (!fabEnabled) {
+	StartupProfiler::begin("network");
 	auto * manager = new QNetworkAccessManager(this);
 	connect(manager, SIGNAL(finished(QNetworkReply *)), this, SLOT(gotOrderFab(QNetworkReply *)));
 	manager->get(QNetworkRequest(QUrl(QString("http%2://fab.fritzing.org/launched%1")
 									  .arg(Version::makeRequestParamsString(true))
 									  .arg(QSslSocket::supportsSsl() ? "s" : ""))));
+	StartupProfiler::end();
 	//}
 
 	if (m_progressIndex >= 0) splash.showProgress(m_progressIndex, LoadProgressEnd);
@@ -1271,7 +3204,9 @@ int FApplication::startup()
 	if (m_progressIndex >= 0) splash.showProgress(m_progressIndex, 0.65);
 	ProcessEventBlocker::processEvents();
 
+	StartupProfiler::begin("sketches");
 	loadSomething(prevVersion);
+	StartupProfiler::end();
 	m_started = true;
 
 	if (m_progressIndex >= 0) splash.showProgress(m_progressIndex, 0.99);
@@ -1280,28 +3215,18 @@ int FApplication::startup()
 	splash.hide();
 	m_splash = nullptr;
 
+	StartupProfiler::begin("update check");
 	m_updateDialog = new UpdateDialog();
 	m_updateDialog->setRepoPath(FolderUtils::getAppPartsSubFolderPath(""), m_referenceModel->sha());
 	connect(m_updateDialog, SIGNAL(enableAgainSignal(bool)), this, SLOT(enableCheckUpdates(bool)));
 	connect(m_updateDialog, SIGNAL(installNewParts()), this, SLOT(installNewParts()));
 	checkForUpdates(false);
+	StartupProfiler::end();
 
+	StartupProfiler::finish();
 	return 0;
 }
 
-void FApplication::registerFont(const QString &fontFile, bool reallyRegister) {
-	int id = QFontDatabase::addApplicationFont(fontFile);
-	if(id > -1 && reallyRegister) {
-		QStringList familyNames = QFontDatabase::applicationFontFamilies(id);
-		QFileInfo finfo(fontFile);
-		Q_FOREACH (QString family, familyNames) {
-			InstalledFonts::InstalledFontsNameMapper.insert(family, finfo.completeBaseName());
-			InstalledFonts::InstalledFontsList << family;
-			DebugDialog::debug(QString("registering font family: %1 %2").arg(family).arg(finfo.completeBaseName()));
-		}
-	}
-}
-
 void FApplication::finish()
 {
 	QString currVersion = Version::versionString();
@@ -1373,7 +3298,7 @@ void FApplication::updatePrefs(PrefsDialog & prefsDialog)
 	QSettings settings;
 
 	if (prefsDialog.cleared()) {
-		settings.clear();
+		SettingsCache::clear();
 		return;
 	}
 
@@ -1698,10 +3623,12 @@ void FApplication::loadSomething(const QString & prevVersion) {
 
 	initFilesToLoad();   // sets up m_filesToLoad from the command line on PC and Linux; mac uses a FileOpen event instead
 
+	StartupProfiler::begin("backups");
 	initBackups();
 
 	DebugDialog::debug("checking for backups");
 	QList<MainWindow*> sketchesToLoad = recoverBackups();
+	StartupProfiler::end();
 
 
 	if (sketchesToLoad.isEmpty()) {
@@ -1733,6 +3660,7 @@ void FApplication::loadSomething(const QString & prevVersion) {
 
 	MainWindow * newBlankSketch = nullptr;
 	if (sketchesToLoad.isEmpty()) {
+		StartupProfiler::Phase phase("blank sketch");
 		DebugDialog::debug(QString("create empty sketch"));
 		newBlankSketch = MainWindow::newMainWindow(m_referenceModel, "", true, true, -1);
 		if (newBlankSketch != nullptr) {
@@ -1752,6 +3680,7 @@ void FApplication::loadSomething(const QString & prevVersion) {
 	}
 
 	if (newBlankSketch != nullptr) {
+		StartupProfiler::Phase phase("welcome view");
 		newBlankSketch->hideTempPartsBin();
 		// new empty sketch defaults to welcome view
 		newBlankSketch->showWelcomeView();
@@ -1786,7 +3715,12 @@ QList<MainWindow *> FApplication::recoverBackups()
 		QFileInfo fileInfo = backupList.at(i);
 		if (!fileInfo.fileName().endsWith(FritzingSketchExtension)) {
 			backupList.removeAt(i);
+			continue;
 		}
+
+		// bring the backup up to date with its journal before it is listed or loaded
+		BackupJournal::replay(fileInfo.absoluteFilePath());
+		backupList[i].refresh();
 	}
 
 	QList<MainWindow*> recoveredSketches;
@@ -1815,6 +3749,7 @@ QList<MainWindow *> FApplication::recoverBackups()
 		}
 
 		QFile::remove(backupName);
+		QFile::remove(BackupJournal::journalPath(backupName));
 	}
 
 	return recoveredSketches;
@@ -1914,18 +3849,40 @@ void FApplication::initServer() {
 	FMessageBox::BlockMessages = true;
 	m_fServer = new FServer(this);
 	connect(m_fServer, SIGNAL(newConnection(qintptr)), this, SLOT(newConnection(qintptr)));
+	m_serverJobs = new FServerJobs(this);
+	connect(m_serverJobs, SIGNAL(queued()), this, SLOT(runServerJobs()), Qt::QueuedConnection);
 	DebugDialog::debug("Server active");
 	m_fServer->listen(QHostAddress::Any, m_portNumber);
 }
 
 void FApplication::newConnection(qintptr socketDescription) {
-	auto *thread = new FServerThread(socketDescription, this);
+	auto *thread = new FServerThread(socketDescription, m_serverJobs, this);
 	connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-	connect(thread, SIGNAL(doCommand(const QString &, const QString &, QString &, int &)),
-	        this, SLOT(doCommand(const QString &, const QString &, QString &, int &)), Qt::BlockingQueuedConnection);
 	thread->start();
 }
 
+void FApplication::runServerJobs() {
+	// one job per call, so the event loop gets a turn in between;
+	// the exports process events, so a call made meanwhile just returns
+	if (m_runningServerJob) return;
+
+	FServerJobs::Job job;
+	if (!m_serverJobs->take(job)) return;
+
+	m_runningServerJob = true;
+	QString result;
+	int status = 500;
+	{
+		Tracer::Scope tracing("service.request", job.command + " " + job.params);
+		doCommand(job.command, job.params, result, status);
+	}
+	m_runningServerJob = false;
+	m_serverJobs->finish(job.id, status, result);
+	QTimer::singleShot(0, this, &FApplication::warmServiceWindows);
+
+	QMetaObject::invokeMethod(this, "runServerJobs", Qt::QueuedConnection);
+}
+
 
 void FApplication::doCommand(const QString & command, const QString & params, QString & result, int & status) {
 	status = 200;
@@ -2049,12 +4006,13 @@ void FApplication::regeneratePartsDatabase() {
 									 ));
 	messageBox.setIcon(QMessageBox::Question);
 	messageBox.setWindowModality(Qt::WindowModal);
+	QPushButton *updateButton = messageBox.addButton(tr("Update changed parts"), QMessageBox::YesRole);
 	QPushButton *regenerateButton = messageBox.addButton(tr("Regenerate"), QMessageBox::YesRole);
 	messageBox.addButton(QMessageBox::Cancel);
-	messageBox.setDefaultButton(regenerateButton);
+	messageBox.setDefaultButton(updateButton);
 
 	messageBox.exec();
-	if (messageBox.clickedButton() != regenerateButton) {
+	if (messageBox.clickedButton() != regenerateButton && messageBox.clickedButton() != updateButton) {
 		return;
 	}
 
@@ -2064,14 +4022,14 @@ void FApplication::regeneratePartsDatabase() {
 	//connect(m_referenceModel, SIGNAL(partsToLoad(int)), fileProgressDialog, SLOT(setMaximum(int)));
 	//connect(m_referenceModel, SIGNAL(loadedPart(int,int)), fileProgressDialog, SLOT(setValue(int)));
 
-	regeneratePartsDatabaseAux(fileProgressDialog);
+	regeneratePartsDatabaseAux(fileProgressDialog, messageBox.clickedButton() == updateButton);
 }
 
-void FApplication::regeneratePartsDatabaseAux(QDialog * progressDialog) {
+void FApplication::regeneratePartsDatabaseAux(QDialog * progressDialog, bool incremental) {
 	ReferenceModel * referenceModel = new CurrentReferenceModel();
 	QDir dir = FolderUtils::getAppPartsSubFolder("");
 	QString dbPath = dir.absoluteFilePath("parts.db");
-	auto *thread = new RegenerateDatabaseThread(dbPath, progressDialog, referenceModel);
+	auto *thread = new RegenerateDatabaseThread(dbPath, progressDialog, referenceModel, incremental);
 	connect(thread, SIGNAL(finished()), this, SLOT(regenerateDatabaseFinished()));
 	FMessageBox::BlockMessages = true;
 	thread->start();
@@ -2104,5 +4062,5 @@ void FApplication::regenerateDatabaseFinished() {
 }
 
 void FApplication::installNewParts() {
-	regeneratePartsDatabaseAux(m_updateDialog);
+	regeneratePartsDatabaseAux(m_updateDialog, true);
 }
@@ -23,6 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QApplication>
 #include <QTranslator>
+#include <QFile>
 #include <QPixmap>
 #include <QFileDialog>
 #include <QPointer>
@@ -30,8 +31,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QTimer>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QMap>
 #include <QMutex>
+#include <QVector>
+#include <QStringList>
 #include <QThread>
+#include <QWaitCondition>
 #include <QNetworkReply>
 #include <QNetworkAccessManager>
 
@@ -53,29 +60,106 @@ protected:
 	void incomingConnection(qintptr socketDescriptor);
 };
 
+class FServerJobs : public QObject
+{
+	// export requests from the server threads, run in turn on the gui thread;
+	// finished jobs are kept for a while so their results can be fetched later
+
+	Q_OBJECT
+
+public:
+	enum class State {
+		Queued,
+		Running,
+		Done,
+		Failed
+	};
+
+	struct Job {
+		QString id;
+		QString command;
+		QString params;
+		State state = State::Queued;
+		int status = 0;
+		QString result;                     // file contents, a zip file path for the tcp commands, or an error message
+		bool waited = false;                // a server thread is blocked on it and drops it once answered
+		qint64 submittedNs = 0;
+		qint64 startedNs = 0;
+	};
+
+public:
+	FServerJobs(QObject * parent = nullptr);
+
+	QString submit(const QString & command, const QString & params, bool waited);
+	Job wait(const QString & id);
+	bool find(const QString & id, Job & job, int & position);
+	bool take(Job & job);
+	void finish(const QString & id, int status, const QString & result);
+	void forget(const QString & id);
+	QString metrics();
+
+public:
+	static QString stateName(State);
+	static bool isExportCommand(const QString & command);
+
+Q_SIGNALS:
+	void queued();
+
+protected:
+	struct Histogram {
+		QVector<quint64> counts;            // per bucket of LatencyBuckets, including the smaller ones
+		quint64 count = 0;
+		double sum = 0;
+
+		void add(double seconds);
+	};
+
+	struct CommandMetrics {
+		QMap<int, quint64> statuses;
+		Histogram latency;
+		Histogram queueWait;
+	};
+
+protected:
+	void dropFinished();
+	static void writeHistogram(class QTextStream &, const char * name, const QString & command, const Histogram &);
+
+protected:
+	QMutex m_mutex;
+	QWaitCondition m_finished;
+	QHash<QString, Job> m_jobs;
+	QStringList m_queue;                    // waiting ids, oldest first
+	QStringList m_done;                     // finished ids that can still be fetched, oldest first
+	QElapsedTimer m_clock;
+	QHash<QString, CommandMetrics> m_metrics;   // by command
+
+protected:
+	static const int MaxFinished = 100;
+	static const double LatencyBuckets[];   // upper bounds in seconds
+};
+
 class FServerThread : public QThread
 {
 	Q_OBJECT
 
 public:
-	FServerThread(qintptr socketDescriptor, QObject *parent);
+	FServerThread(qintptr socketDescriptor, FServerJobs *, QObject *parent);
 
 	void run();
 	void setDone();
 
 Q_SIGNALS:
 	void error(QTcpSocket::SocketError socketError);
-	void doCommand(const QString & command, const QString & params, QString & result, int & status);
 
 protected:
 	void writeResponse(QTcpSocket *, int code, const QString & codeString, const QString & mimeType, const QString & message);
+	void writeResult(QTcpSocket *, const FServerJobs::Job &, bool removeZip);
+	void writeStatus(QTcpSocket *, const QString & id);
 
 protected:
 	int m_socketDescriptor = 0;
 	bool m_done = false;
-
-protected:
-	static QMutex m_busy;
+	FServerJobs * m_jobs = nullptr;
 
 };
 
@@ -85,19 +169,21 @@ class RegenerateDatabaseThread : public QThread
 {
 	Q_OBJECT
 public:
-	RegenerateDatabaseThread(const QString & dbFileName, QDialog *progressDialog, ReferenceModel *referenceModel);
+	RegenerateDatabaseThread(const QString & dbFileName, QDialog *progressDialog, ReferenceModel *referenceModel, bool incremental);
 	const QString error() const;
 	QDialog * progressDialog() const;
 	ReferenceModel * referenceModel() const;
 
 protected:
 	void run() Q_DECL_OVERRIDE;
+	bool update(const QString & fileName);
 
 protected:
 	QString m_dbFileName;
 	QString m_error;
 	QDialog * m_progressDialog = nullptr;
 	ReferenceModel * m_referenceModel = nullptr;
+	bool m_incremental = false;
 };
 
 ////////////////////////////////////////////////////
@@ -118,7 +204,6 @@ public:
 	void finish();
 	bool loadReferenceModel(const QString & databaseName, bool fullLoad);
 	bool loadReferenceModel(const QString & databaseName, bool fullLoad, ReferenceModel * referenceModel);
-	void registerFonts();
 	class MainWindow * openWindowForService(bool lockFiles, int initialTab);
 	bool runAsService();
 
@@ -144,6 +229,7 @@ public Q_SLOTS:
 	void gotOrderFab(QNetworkReply *);
 	void newConnection(qintptr socketDescriptor);
 	void doCommand(const QString & command, const QString & params, QString & result, int & status);
+	void runServerJobs();
 	void regeneratePartsDatabase();
 	void regenerateDatabaseFinished();
 	void installNewParts();
@@ -156,21 +242,34 @@ protected:
 	void loadNew(QString path);
 	void loadOne(class MainWindow *, QString path, int loaded);
 	void initSplash(class FSplashScreen & splash);
-	void registerFont(const QString &fontFile, bool reallyRegister);
 	void clearModels();
 	bool notify(QObject *receiver, QEvent *e);
 	void initService();
-	void runDRCService();
+	bool runDRCService();
+	bool runERCService();
+	void runAutorouteService();
+	bool runSimulateService();
+	bool runMemoryService();
+	bool runPerformanceService();
 	void runGedaService();
+	void runS2SService();
 	void runDatabaseService();
 	void runKicadFootprintService();
 	void runKicadSchematicService();
 	void runGerberService();
 	void runGerberServiceAux();
-	void runExportAllService();
-	void runExportAllServiceAux();
+	bool runExportAllService();
+	bool runExportAllServiceAux();
+	bool runExportAllWorkers();
 	void runSvgService();
 	void runSvgServiceAux();
+	bool runNetlistService();
+	bool runDiffService();
+	bool loadHeadlessSketch(const QString & filepath, class HeadlessSketch &, QString & error);
+	class MainWindow * loadForService(const QString & filepath, int initialTab);
+	void releaseForService(class MainWindow *);
+	class MainWindow * takeServiceWindow(int initialTab);
+	void warmServiceWindows();
 	void runExampleService();
 	void runExampleService(QDir &);
 	QList<class MainWindow *> recoverBackups();
@@ -184,7 +283,7 @@ protected:
 	QList<MainWindow *> orderedTopLevelMainWindows();
 	void cleanFzzs();
 	void initServer();
-	void regeneratePartsDatabaseAux(QDialog * progressDialog);
+	void regeneratePartsDatabaseAux(QDialog * progressDialog, bool incremental);
 
 
 	enum class ServiceType {
@@ -198,12 +297,21 @@ protected:
 		PortService,
 		DRCService,
 		ExportAllService,
+		AutorouteService,
+		SimulateService,
+		MemoryService,
+		PerformanceService,
+		S2SService,
+		ERCService,
+		NetlistService,
+		DiffService,
 		NoService
 	};
 
 protected:
 	bool m_spaceBarIsPressed = false;
 	bool m_mousePressed = false;
+	QFile m_translationFile;            // declared first so it outlives m_translator, which reads its mapping
 	QTranslator m_translator;
 	ReferenceModel * m_referenceModel = nullptr;
 	bool m_started = false;
@@ -222,11 +330,32 @@ protected:
 	int m_progressIndex = 0;
 	class FSplashScreen * m_splash = nullptr;
 	QString m_outputFolder;
+	QString m_diffSketch;				// with -diff, the sketch compared against m_outputFolder
+	QHash<QString, QVariant> m_autorouteSettings;
+	bool m_gerberCopperFill = false;
+	bool m_svgShareParts = false;
+	int m_exportAllJobs = 1;
+	QStringList m_exportAllSketches;			// a worker's share of the folder; empty for all of it
+	QString m_exportAllReport;
+	QString m_performanceReport;				// csv written by -perfexamples
+	int m_s2sThreads = 0;						// 0 for the thread pool's default
+	bool m_s2sDryRun = false;
 	QString m_portRootFolder;
 	QString m_panelFilename;
 	QHash<QString, struct LockedFile *> m_lockedFiles;
 	int m_portNumber = 0;
 	FServer * m_fServer = nullptr;
+	FServerJobs * m_serverJobs = nullptr;
+	bool m_runningServerJob = false;
+	int m_serviceWindowCount = 2;
+	struct ServiceWindow {
+		QByteArray key;                     // hash of the sketch file
+		QPointer<class MainWindow> window;
+	};
+	QList<ServiceWindow> m_serviceWindows;  // most recently used first
+	int m_spareWindowCount = 1;
+	int m_spareWindowTab = 3;				// initial tab of the spare windows, the last one asked for
+	QList< QPointer<class MainWindow> > m_spareWindows;		// built but empty, for the next requests
 	QString m_buildType;
 };
 
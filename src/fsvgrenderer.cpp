@@ -19,14 +19,27 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 ********************************************************************/
 
 #include "fsvgrenderer.h"
+#include "cookedsvgcache.h"
 #include "debugdialog.h"
+#include "installedfonts.h"
 #include "svg/svgfilesplitter.h"
 #include "utils/textutils.h"
 #include "utils/graphicsutils.h"
+#include "utils/cachecounters.h"
 #include "connectors/svgidlayer.h"
 
 #include <QTextStream>
 #include <QPainter>
+#include <QPixmap>
+#include <QImage>
+#include <QtMath>
+#include <cmath>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QCoreApplication>
 #include <QtGlobal>
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -36,19 +49,92 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 #include <qnumeric.h>
 
+#include <atomic>
+
 /////////////////////////////////////////////
 
 QString FSvgRenderer::NonConnectorName("nonconn");
 
 static ConnectorInfo VanillaConnectorInfo;
 
+// cleaned part svgs with what was learned about their connectors, so identical parts load without file or DOM work;
+// keyed on the file's path, time and size and the load flags, so an edited file misses rather than goes stale
+static const int SvgCacheKilobytes = 64 * 1024;
+static QCache<QString, CookedSvg> SvgCache(SvgCacheKilobytes);
+static QMutex SvgCacheMutex;
+
+// whether a path connector is a donut, which takes rendering the whole document; keyed on the
+// document and the connector id, so the same footprint in another part, view or layer is a lookup
+struct PathFit {
+	bool circle = false;
+	double radius = 0;
+	double strokeWidth = 0;
+};
+
+static QCache<QByteArray, PathFit> PathFits(16 * 1024);
+static QMutex PathFitsMutex;
+
+static QString svgCacheKey(const LoadInfo & loadInfo, const QFileInfo & fileInfo)
+{
+	static const QChar Separator(0x1f);
+	QStringList parts;
+	parts << fileInfo.absoluteFilePath()
+	      << QString::number(fileInfo.lastModified().toMSecsSinceEpoch())
+	      << QString::number(fileInfo.size())
+	      << loadInfo.connectorIDs.join(Separator)
+	      << loadInfo.terminalIDs.join(Separator)
+	      << loadInfo.legIDs.join(Separator)
+	      << loadInfo.setColor
+	      << loadInfo.colorElementID
+	      << QString("%1%2").arg(loadInfo.findNonConnectors).arg(loadInfo.parsePaths);
+	return parts.join(QChar(0x1e));
+}
+
+// renderers handed to every item loading the same bytes the same way, counted so the last item out deletes it
+struct SharedRenderer {
+	FSvgRenderer * renderer = nullptr;
+	QByteArray loaded;
+	int references = 0;
+};
+
+static QHash<QByteArray, SharedRenderer> SharedRenderers;
+static QHash<const FSvgRenderer *, QByteArray> SharedRendererKeys;
+
+// the shared renderers of the parts most recently dragged from a bin, each holding one extra reference,
+// so dragging the part again, into another view, or dropping it finds them loaded; most recent first
+struct Prototype {
+	QString key;
+	QList<FSvgRenderer *> renderers;
+};
+
+static const int MaxPrototypes = 8;
+static QList<Prototype> Prototypes;
+
+// rasters of drawings for painting while a view pans or zooms, keyed by drawing, size, scale step and quarter turn;
+// only touched from the GUI thread
+static const int RasterCacheKilobytes = 64 * 1024;
+static const int RasterMaxPixels = 2048 * 2048;
+static const int RasterStepsPerDoubling = 4;
+static QCache<QString, QPixmap> RasterCache(RasterCacheKilobytes);
+
+static CacheCounters SvgCacheCounters("svg");
+static CacheCounters SharedRendererCounters("renderer");
+static CacheCounters RasterCacheCounters("raster");
+static std::atomic<qint64> NextDrawingSerial(1);        // renderers are also loaded on the thread pool
+static std::atomic<int> RendererCount(0);
+static std::atomic<qint64> RendererLoadedBytes(0);
+
 FSvgRenderer::FSvgRenderer(QObject * parent) : QSvgRenderer(parent)
 {
 	m_defaultSizeF = QSizeF(0,0);
+	m_drawingSerial = NextDrawingSerial++;
+	RendererCount++;
 }
 
 FSvgRenderer::~FSvgRenderer()
 {
+	RendererCount--;
+	RendererLoadedBytes -= m_loadedBytes;
 	clearConnectorInfoHash(m_connectorInfoHash);
 	clearConnectorInfoHash(m_nonConnectorInfoHash);
 }
@@ -66,7 +152,156 @@ void FSvgRenderer::clearConnectorInfoHash(QHash<QString, ConnectorInfo *> & hash
 }
 
 void FSvgRenderer::cleanup() {
+	releasePrototypes();
+	RasterCache.clear();
+	{
+		QMutexLocker locker(&PathFitsMutex);
+		PathFits.clear();
+	}
+	QMutexLocker locker(&SvgCacheMutex);
+	SvgCache.clear();
+}
+
+QByteArray FSvgRenderer::shareKey(const QByteArray & contents, const LoadInfo & loadInfo)
+{
+	// everything loadAux looks at, so equal keys give renderers that draw and set up connectors the same
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(contents);
+	QStringList parts;
+	parts << loadInfo.filename
+	      << loadInfo.connectorIDs.join(QChar(0x1f))
+	      << loadInfo.terminalIDs.join(QChar(0x1f))
+	      << loadInfo.legIDs.join(QChar(0x1f))
+	      << loadInfo.setColor
+	      << loadInfo.colorElementID
+	      << QString("%1%2").arg(loadInfo.findNonConnectors).arg(loadInfo.parsePaths);
+	hash.addData(parts.join(QChar(0x1e)).toUtf8());
+	return hash.result();
+}
+
+QByteArray FSvgRenderer::variantKey(const QByteArray & contents, bool fastLoad) const
+{
+	// for loading contents into a copy of this renderer: its result depends on the bytes, how they are
+	// loaded, and the filename and connector info the copy starts with
+	QStringList connectorIDs = m_connectorInfoHash.keys();
+	connectorIDs.sort();
+	QStringList nonConnectorIDs = m_nonConnectorInfoHash.keys();
+	nonConnectorIDs.sort();
+
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(contents);
+	QStringList parts;
+	parts << "variant"
+	      << m_filename
+	      << connectorIDs.join(QChar(0x1f))
+	      << nonConnectorIDs.join(QChar(0x1f))
+	      << QString::number(fastLoad);
+	hash.addData(parts.join(QChar(0x1e)).toUtf8());
+	return hash.result();
+}
 
+FSvgRenderer * FSvgRenderer::sharedRenderer(const QByteArray & key, QByteArray & loaded)
+{
+	// the caller gets a reference, to be given back through releaseRenderer
+	auto it = SharedRenderers.find(key);
+	SharedRendererCounters.count(it != SharedRenderers.end());
+	if (it == SharedRenderers.end()) return nullptr;
+
+	it->references++;
+	loaded = it->loaded;
+	return it->renderer;
+}
+
+void FSvgRenderer::shareRenderer(const QByteArray & key, FSvgRenderer * renderer, const QByteArray & loaded)
+{
+	// the caller's reference becomes the first one
+	if (renderer == nullptr || SharedRenderers.contains(key) || SharedRendererKeys.contains(renderer)) return;
+
+	SharedRenderer shared;
+	shared.renderer = renderer;
+	shared.loaded = loaded;
+	shared.references = 1;
+	SharedRenderers.insert(key, shared);
+	SharedRendererKeys.insert(renderer, key);
+}
+
+void FSvgRenderer::releaseRenderer(FSvgRenderer * renderer)
+{
+	if (renderer == nullptr) return;
+
+	auto keyIt = SharedRendererKeys.find(renderer);
+	if (keyIt == SharedRendererKeys.end()) {
+		delete renderer;
+		return;
+	}
+
+	auto it = SharedRenderers.find(keyIt.value());
+	if (--it->references > 0) return;
+
+	SharedRenderers.erase(it);
+	SharedRendererKeys.erase(keyIt);
+	delete renderer;
+}
+
+void FSvgRenderer::keepPrototype(const QString & key, const QList<FSvgRenderer *> & renderers)
+{
+	// take the new references before dropping the old ones, in case they are the same renderers
+	Prototype prototype;
+	prototype.key = key;
+	Q_FOREACH (FSvgRenderer * renderer, renderers) {
+		auto keyIt = SharedRendererKeys.find(renderer);
+		if (keyIt == SharedRendererKeys.end() || prototype.renderers.contains(renderer)) continue;
+
+		SharedRenderers[keyIt.value()].references++;
+		prototype.renderers.append(renderer);
+	}
+
+	for (int i = 0; i < Prototypes.count(); i++) {
+		if (Prototypes.at(i).key != key) continue;
+
+		Q_FOREACH (FSvgRenderer * renderer, Prototypes.takeAt(i).renderers) {
+			releaseRenderer(renderer);
+		}
+		break;
+	}
+
+	if (prototype.renderers.isEmpty()) return;
+
+	Prototypes.prepend(prototype);
+	while (Prototypes.count() > MaxPrototypes) {
+		Q_FOREACH (FSvgRenderer * renderer, Prototypes.takeLast().renderers) {
+			releaseRenderer(renderer);
+		}
+	}
+}
+
+void FSvgRenderer::releasePrototypes()
+{
+	while (!Prototypes.isEmpty()) {
+		Q_FOREACH (FSvgRenderer * renderer, Prototypes.takeFirst().renderers) {
+			releaseRenderer(renderer);
+		}
+	}
+}
+
+bool FSvgRenderer::isShared() const
+{
+	return SharedRendererKeys.contains(this);
+}
+
+FSvgRenderer * FSvgRenderer::unsharedCopy() const
+{
+	// size and connector info but not the drawing, for an item about to load its own variant of a shared svg
+	auto * renderer = new FSvgRenderer();
+	renderer->m_filename = m_filename;
+	renderer->m_defaultSizeF = m_defaultSizeF;
+	for (auto it = m_connectorInfoHash.constBegin(); it != m_connectorInfoHash.constEnd(); ++it) {
+		renderer->m_connectorInfoHash.insert(it.key(), new ConnectorInfo(*it.value()));
+	}
+	for (auto it = m_nonConnectorInfoHash.constBegin(); it != m_nonConnectorInfoHash.constEnd(); ++it) {
+		renderer->m_nonConnectorInfoHash.insert(it.key(), new ConnectorInfo(*it.value()));
+	}
+	return renderer;
 }
 
 QByteArray FSvgRenderer::loadSvg(const QString & filename) {
@@ -75,10 +310,28 @@ QByteArray FSvgRenderer::loadSvg(const QString & filename) {
 }
 
 QByteArray FSvgRenderer::loadSvg(const LoadInfo & loadInfo) {
-	if (!QFileInfo(loadInfo.filename).exists() || !QFileInfo(loadInfo.filename).isFile()) {
+	QFileInfo fileInfo(loadInfo.filename);
+	if (!fileInfo.exists() || !fileInfo.isFile()) {
 		return QByteArray();
 	}
 
+	QString key = svgCacheKey(loadInfo, fileInfo);
+	CookedSvg cached;
+	bool hit = false;
+	{
+		QMutexLocker locker(&SvgCacheMutex);
+		CookedSvg * entry = SvgCache.object(key);
+		if (entry != nullptr) {
+			cached = *entry;
+			hit = true;
+		}
+	}
+	SvgCacheCounters.count(hit);
+	if (hit) {
+		restoreCooked(cached, loadInfo);
+		return finalLoad(cached.cleanContents, loadInfo.filename);
+	}
+
 	QFile file(loadInfo.filename);
 	if (!file.open(QFile::ReadOnly | QFile::Text)) {
 		return QByteArray();
@@ -89,8 +342,67 @@ QByteArray FSvgRenderer::loadSvg(const LoadInfo & loadInfo) {
 
 	if (contents.length() <= 0) return QByteArray();
 
-	return loadAux(contents, loadInfo);
+	QByteArray result = loadCooked(contents, loadInfo);
+	if (!result.isEmpty()) {
+		auto * entry = new CookedSvg;
+		cook(*entry, result, loadInfo);
+		QMutexLocker locker(&SvgCacheMutex);
+		SvgCache.insert(key, entry, qMax(1, (int) (result.size() / 1024)));
+	}
+	return result;
+}
+
+QByteArray FSvgRenderer::loadCooked(const QByteArray & contents, const LoadInfo & loadInfo)
+{
+	// loadAux, skipped when an earlier launch already cooked the same bytes the same way
+	QByteArray key = shareKey(contents, loadInfo);
+	CookedSvg cooked;
+	if (CookedSvgCache::find(key, cooked)) {
+		restoreCooked(cooked, loadInfo);
+		QByteArray result = finalLoad(cooked.cleanContents, loadInfo.filename);
+		if (!result.isEmpty()) return result;
+	}
+
+	QByteArray result = loadAux(contents, loadInfo);
+	if (!result.isEmpty()) {
+		cook(cooked, result, loadInfo);
+		CookedSvgCache::insert(key, cooked);
+	}
+	return result;
+}
 
+void FSvgRenderer::cook(CookedSvg & cooked, const QByteArray & cleanContents, const LoadInfo & loadInfo) const
+{
+	cooked.cleanContents = cleanContents;
+	cooked.connectorInfos.clear();
+	cooked.nonConnectorInfos.clear();
+	if (loadInfo.connectorIDs.count() > 0) {
+		for (auto it = m_connectorInfoHash.constBegin(); it != m_connectorInfoHash.constEnd(); ++it) {
+			cooked.connectorInfos.insert(it.key(), *it.value());
+		}
+	}
+	if (loadInfo.findNonConnectors) {
+		for (auto it = m_nonConnectorInfoHash.constBegin(); it != m_nonConnectorInfoHash.constEnd(); ++it) {
+			cooked.nonConnectorInfos.insert(it.key(), *it.value());
+		}
+	}
+}
+
+void FSvgRenderer::restoreCooked(const CookedSvg & cooked, const LoadInfo & loadInfo)
+{
+	// the same connector info a fresh load would have set up
+	if (loadInfo.connectorIDs.count() > 0) {
+		clearConnectorInfoHash(m_connectorInfoHash);
+		for (auto it = cooked.connectorInfos.constBegin(); it != cooked.connectorInfos.constEnd(); ++it) {
+			m_connectorInfoHash.insert(it.key(), new ConnectorInfo(it.value()));
+		}
+	}
+	if (loadInfo.findNonConnectors) {
+		clearConnectorInfoHash(m_nonConnectorInfoHash);
+		for (auto it = cooked.nonConnectorInfos.constBegin(); it != cooked.nonConnectorInfos.constEnd(); ++it) {
+			m_nonConnectorInfoHash.insert(it.key(), new ConnectorInfo(it.value()));
+		}
+	}
 }
 
 bool FSvgRenderer::loadSvgString(const QString & svg) {
@@ -112,26 +424,23 @@ QByteArray FSvgRenderer::loadSvg(const QByteArray & contents, const QString & fi
 }
 
 QByteArray FSvgRenderer::loadSvg(const QByteArray & contents, const LoadInfo & loadInfo) {
-	return loadAux(contents, loadInfo);
+	return loadCooked(contents, loadInfo);
 }
 
 QByteArray FSvgRenderer::loadAux(const QByteArray & theContents, const LoadInfo & loadInfo)
 {
 	QByteArray cleanContents(theContents);
-	bool cleaned = false;
-
 	QString string(cleanContents);
-	if (TextUtils::fixMuch(string, false)) {
-		cleaned = true;
-	}
-	if (TextUtils::fixPixelDimensionsIn(string)) {
-		cleaned = true;
-	}
-	if (cleaned) {
+	if (TextUtils::fixSvg(string, TextUtils::FixMuch | TextUtils::FixPixelDimensions) != TextUtils::NoSvgFix) {
 		cleanContents = string.toUtf8();
 	}
 
-	if (loadInfo.connectorIDs.count() > 0 || !loadInfo.setColor.isEmpty() || loadInfo.findNonConnectors) {
+	bool streamed = false;
+	if (loadInfo.setColor.isEmpty() && (loadInfo.connectorIDs.count() > 0 || loadInfo.findNonConnectors)) {
+		streamed = initConnectorInfoStream(cleanContents, loadInfo);
+	}
+
+	if (!streamed && (loadInfo.connectorIDs.count() > 0 || !loadInfo.setColor.isEmpty() || loadInfo.findNonConnectors)) {
 		QString errorStr;
 		int errorLine;
 		int errorColumn;
@@ -191,7 +500,11 @@ QByteArray FSvgRenderer::finalLoad(QByteArray & cleanContents, const QString & f
 		return QByteArray();
 	}
 
+	InstalledFonts::registerFonts();
 	result = QSvgRenderer::load(cleanContents);
+	m_drawingSerial = NextDrawingSerial++;
+	m_elementGeometry.clear();
+	setLoadedBytes(result ? cleanContents.size() : 0);
 	if (result) {
 		m_filename = filename;
 		return cleanContents;
@@ -201,7 +514,108 @@ QByteArray FSvgRenderer::finalLoad(QByteArray & cleanContents, const QString & f
 }
 
 bool FSvgRenderer::fastLoad(const QByteArray & contents) {
-	return QSvgRenderer::load(contents);
+	m_drawingSerial = NextDrawingSerial++;
+	m_elementGeometry.clear();
+	InstalledFonts::registerFonts();
+	bool result = QSvgRenderer::load(contents);
+	setLoadedBytes(result ? contents.size() : 0);
+	return result;
+}
+
+void FSvgRenderer::setLoadedBytes(qint64 bytes) {
+	RendererLoadedBytes += bytes - m_loadedBytes;
+	m_loadedBytes = bytes;
+}
+
+qint64 FSvgRenderer::loadedBytes() const {
+	return m_loadedBytes;
+}
+
+qint64 FSvgRenderer::drawingSerial() const {
+	return m_drawingSerial;
+}
+
+FSvgRenderer::Memory FSvgRenderer::memory() {
+	// the caches are charged at their QCache cost, which is in kilobytes
+	Memory memory;
+	memory.renderers = RendererCount;
+	memory.loadedBytes = RendererLoadedBytes;
+	memory.sharedRenderers = SharedRenderers.count();
+	memory.rasterCacheBytes = RasterCache.totalCost() * (qint64) 1024;
+	{
+		QMutexLocker locker(&SvgCacheMutex);
+		memory.svgCacheBytes = SvgCache.totalCost() * (qint64) 1024;
+	}
+	{
+		QMutexLocker locker(&PathFitsMutex);
+		memory.pathFits = PathFits.count();
+	}
+	return memory;
+}
+
+void FSvgRenderer::renderCached(QPainter * painter, const QRectF & bounds)
+{
+	// draws a raster made at about the painter's scale, for interactive panning and zooming;
+	// skewed or odd-angle transforms, and rasters too big to be worth keeping, are rendered as vectors
+
+	QTransform transform = painter->deviceTransform();
+	double scale = qSqrt(qAbs(transform.determinant()));
+	if (scale <= 0 || bounds.isEmpty()) {
+		render(painter, bounds);
+		return;
+	}
+
+	// the transform without its scale and translation must be a quarter turn, possibly mirrored
+	double turn[4] = { transform.m11() / scale, transform.m12() / scale, transform.m21() / scale, transform.m22() / scale };
+	int signs[4];
+	for (int i = 0; i < 4; i++) {
+		if (qAbs(turn[i]) < 1e-3) signs[i] = 0;
+		else if (qAbs(qAbs(turn[i]) - 1) < 1e-3) signs[i] = turn[i] > 0 ? 1 : -1;
+		else {
+			render(painter, bounds);
+			return;
+		}
+	}
+
+	// round the scale up to a step so a zoom reuses rasters and they are drawn slightly reduced rather than enlarged
+	int step = qCeil(RasterStepsPerDoubling * std::log2(scale));
+	double stepScale = qPow(2, double(step) / RasterStepsPerDoubling);
+	QTransform rasterTransform(signs[0] * stepScale, signs[1] * stepScale, signs[2] * stepScale, signs[3] * stepScale, 0, 0);
+	QRectF rasterBounds = rasterTransform.mapRect(bounds);
+	QSize size(qCeil(rasterBounds.width()), qCeil(rasterBounds.height()));
+	if ((qint64) size.width() * size.height() > RasterMaxPixels) {
+		render(painter, bounds);
+		return;
+	}
+
+	QString key = QString("%1 %2 %3 %4 %5 %6").arg(m_drawingSerial).arg(bounds.x()).arg(bounds.y()).arg(bounds.width()).arg(bounds.height()).arg(step)
+		+ QString(" %1 %2 %3 %4").arg(signs[0]).arg(signs[1]).arg(signs[2]).arg(signs[3]);
+	QPixmap * pixmap = RasterCache.object(key);
+	RasterCacheCounters.count(pixmap != nullptr);
+	if (pixmap == nullptr) {
+		QImage image(size, QImage::Format_ARGB32_Premultiplied);
+		image.fill(Qt::transparent);
+		QPainter imagePainter(&image);
+		imagePainter.setRenderHint(QPainter::Antialiasing);
+		imagePainter.setTransform(rasterTransform * QTransform::fromTranslate(-rasterBounds.left(), -rasterBounds.top()));
+		render(&imagePainter, bounds);
+		imagePainter.end();
+		pixmap = new QPixmap(QPixmap::fromImage(image));
+		RasterCache.insert(key, pixmap, qMax(1, (int) ((qint64) size.width() * size.height() * 4 / 1024)));
+		pixmap = RasterCache.object(key);
+		if (pixmap == nullptr) {
+			render(painter, bounds);
+			return;
+		}
+	}
+
+	// the raster is already in device orientation, so it is drawn with no transform other than where it goes
+	QRectF target = transform.mapRect(bounds);
+	painter->save();
+	painter->setRenderHint(QPainter::SmoothPixmapTransform);
+	painter->setTransform(QTransform());
+	painter->drawPixmap(target, *pixmap, QRectF(QPointF(0, 0), pixmap->size()));
+	painter->restore();
 }
 
 QPixmap * FSvgRenderer::getPixmap(QSvgRenderer * renderer, QSize size)
@@ -288,6 +702,7 @@ bool FSvgRenderer::initConnectorInfo(QDomDocument & domDocument, const LoadInfo
 {
 	bool result = false;
 	clearConnectorInfoHash(m_connectorInfoHash);
+	m_documentKey.clear();
 	QDomElement root = domDocument.documentElement();
 	initConnectorInfoAux(root, loadInfo);
 	if (loadInfo.terminalIDs.count() > 0) {
@@ -300,6 +715,167 @@ bool FSvgRenderer::initConnectorInfo(QDomDocument & domDocument, const LoadInfo
 	return result;
 }
 
+struct ConnectorSearch {
+	QString id;
+	ConnectorInfo * connectorInfo = nullptr;
+	int depth = 0;                  // of the connector element
+	int skipDepth = -1;             // inside a circle or path that was not the one
+	bool parsePaths = false;
+	bool nonConnector = false;
+	bool done = false;
+};
+
+static bool streamConnectorCircle(const QXmlStreamAttributes & attributes, double strokeWidth, ConnectorInfo * connectorInfo)
+{
+	// same as initConnectorInfoCircle, from the attributes of a circle being read
+	bool ok;
+	attributes.value("cx").toString().toDouble(&ok);
+	if (!ok) return false;
+
+	attributes.value("cy").toString().toDouble(&ok);
+	if (!ok) return false;
+
+	double r = attributes.value("r").toString().toDouble(&ok);
+	if (!ok) return false;
+
+	double sw = strokeWidth;
+	QString transform = attributes.value("transform").toString();
+	if (!transform.isEmpty()) {
+		QTransform matrix = TextUtils::transformStringToTransform(transform);
+		if (!matrix.isIdentity()) {
+			QRectF r1(0,0,r,r);
+			QRectF r2 = matrix.mapRect(r1);
+			if (r2.width() != r1.width()) {
+				r = r2.width();
+				sw = sw * r2.width() / r1.width();
+			}
+		}
+	}
+
+	connectorInfo->gotCircle = true;
+	connectorInfo->radius = r;
+	connectorInfo->strokeWidth = sw;
+	return true;
+}
+
+bool FSvgRenderer::initConnectorInfoStream(const QByteArray & contents, const LoadInfo & loadInfo)
+{
+	// connector, terminal and non-connector info in one pass over the svg without building a DOM;
+	// returns false when the DOM walk is needed after all: legs are retagged in the document,
+	// and a path connector is rendered on its own to see whether it is a donut
+
+	bool connectors = loadInfo.connectorIDs.count() > 0;
+	if (connectors && loadInfo.legIDs.count() > 0) return false;
+
+	QList<ConnectorSearch> searches;         // in document order, so a repeated id ends up as the last one, as in the DOM walk
+	QList<int> open;                         // searches whose element has not ended
+	QHash<int, QTransform> terminalMatrices; // by index into terminalIDs
+	QVector<double> strokeWidths;            // inherited stroke width of each open element
+	bool needDom = false;
+
+	QXmlStreamReader xml(contents);
+	while (!xml.atEnd() && !needDom) {
+		QXmlStreamReader::TokenType tokenType = xml.readNext();
+		if (tokenType == QXmlStreamReader::StartElement) {
+			QXmlStreamAttributes attributes = xml.attributes();
+			double strokeWidth = strokeWidths.isEmpty() ? 1 : strokeWidths.last();
+			if (auto sw = TextUtils::optToDouble(attributes.value("stroke-width"))) {
+				strokeWidth = *sw;
+			}
+			else if (attributes.value("stroke") == QLatin1String("none")) {
+				strokeWidth = 0;
+			}
+			strokeWidths.append(strokeWidth);
+			int depth = strokeWidths.count();
+
+			QString id = attributes.value("id").toString();
+			if (!id.isEmpty()) {
+				bool isConnector = connectors && loadInfo.connectorIDs.contains(id);
+				bool isNonConnector = loadInfo.findNonConnectors && id.startsWith(NonConnectorName, Qt::CaseInsensitive);
+				if (isConnector || isNonConnector) {
+					QString transform = attributes.value("transform").toString();
+					QTransform matrix = transform.isEmpty() ? QTransform() : TextUtils::transformStringToTransform(transform);
+					for (int pass = 0; pass < 2; pass++) {
+						if (pass == 0 ? !isConnector : !isNonConnector) continue;
+
+						ConnectorSearch search;
+						search.id = id;
+						search.connectorInfo = new ConnectorInfo();
+						search.connectorInfo->matrix = matrix;
+						search.depth = depth;
+						search.nonConnector = (pass == 1);
+						search.parsePaths = !search.nonConnector && loadInfo.parsePaths;
+						open.append(searches.count());
+						searches.append(search);
+					}
+				}
+				if (connectors) {
+					int ix = loadInfo.terminalIDs.indexOf(id);
+					if (ix >= 0) {
+						QString transform = attributes.value("transform").toString();
+						terminalMatrices.insert(ix, transform.isEmpty() ? QTransform() : TextUtils::transformStringToTransform(transform));
+					}
+				}
+			}
+
+			QString name = xml.qualifiedName().toString();
+			bool circle = (name == "circle");
+			bool path = (name == "path");
+			if (circle || path) {
+				Q_FOREACH (int ix, open) {
+					ConnectorSearch & search = searches[ix];
+					if (search.done || search.skipDepth >= 0) continue;
+
+					if (path && search.parsePaths) {
+						needDom = true;
+						break;
+					}
+					if (circle && streamConnectorCircle(attributes, strokeWidth, search.connectorInfo)) {
+						search.done = true;
+					}
+					else {
+						search.skipDepth = depth;
+					}
+				}
+			}
+		}
+		else if (tokenType == QXmlStreamReader::EndElement) {
+			int depth = strokeWidths.count();
+			for (int i = open.count() - 1; i >= 0; i--) {
+				ConnectorSearch & search = searches[open.at(i)];
+				if (search.skipDepth == depth) search.skipDepth = -1;
+				if (search.depth == depth) open.removeAt(i);
+			}
+			strokeWidths.removeLast();
+		}
+	}
+
+	if (needDom || xml.hasError()) {
+		Q_FOREACH (ConnectorSearch search, searches) {
+			delete search.connectorInfo;
+		}
+		return false;
+	}
+
+	if (connectors) clearConnectorInfoHash(m_connectorInfoHash);
+	if (loadInfo.findNonConnectors) clearConnectorInfoHash(m_nonConnectorInfoHash);
+	Q_FOREACH (ConnectorSearch search, searches) {
+		QHash<QString, ConnectorInfo *> & hash = search.nonConnector ? m_nonConnectorInfoHash : m_connectorInfoHash;
+		delete hash.value(search.id, nullptr);
+		hash.insert(search.id, search.connectorInfo);
+	}
+	for (auto it = terminalMatrices.constBegin(); it != terminalMatrices.constEnd(); ++it) {
+		if (it.key() >= loadInfo.connectorIDs.count()) continue;
+
+		ConnectorInfo * connectorInfo = m_connectorInfoHash.value(loadInfo.connectorIDs.at(it.key()), nullptr);
+		if (connectorInfo != nullptr) {
+			connectorInfo->terminalMatrix = it.value();
+		}
+	}
+
+	return true;
+}
+
 void FSvgRenderer::initLegInfoAux(QDomElement & element, const LoadInfo & loadInfo, bool & gotOne)
 {
 	QString id = element.attribute("id");
@@ -445,6 +1021,39 @@ bool FSvgRenderer::initConnectorInfoPath(QDomElement & element, ConnectorInfo *
 	if (stroke == "none") return false;     // cannot be a circle with a hole in the center
 
 	connectorInfo->gotPath = true;
+
+	if (m_documentKey.isEmpty()) {
+		// before any connector is recolored for the donut check
+		m_documentKey = QCryptographicHash::hash(element.ownerDocument().toByteArray(), QCryptographicHash::Sha1);
+	}
+	QByteArray key = m_documentKey + id.toUtf8();
+	{
+		QMutexLocker locker(&PathFitsMutex);
+		PathFit * fit = PathFits.object(key);
+		if (fit != nullptr) {
+			if (fit->circle) {
+				connectorInfo->radius = fit->radius;
+				connectorInfo->strokeWidth = fit->strokeWidth;
+				connectorInfo->gotCircle = true;
+			}
+			return fit->circle;
+		}
+	}
+
+	auto * fit = new PathFit;
+	fit->circle = initConnectorInfoPathAux(element, connectorInfo, filename);
+	fit->radius = connectorInfo->radius;
+	fit->strokeWidth = connectorInfo->strokeWidth;
+	QMutexLocker locker(&PathFitsMutex);
+	PathFits.insert(key, fit);
+	return fit->circle;
+}
+
+bool FSvgRenderer::initConnectorInfoPathAux(QDomElement & element, ConnectorInfo * connectorInfo, const QString & filename)
+{
+	// renders the document with this connector in black to see whether it is a donut
+	QString id = element.attribute("id");
+	QString stroke = element.attribute("stroke");
 	double sw = TextUtils::getStrokeWidth(element, 1);
 
 	if (!stroke.isEmpty()) element.setAttribute("stroke", "black");
@@ -629,7 +1238,8 @@ bool FSvgRenderer::setUpConnector(SvgIdLayer * svgIdLayer, bool ignoreTerminalPo
 
 	// boundsOnElement seems to include any matrix on the element itself.
 	// I would swear this wasn't true before Qt4.7, but maybe I am crazy
-	QRectF bounds = this->boundsOnElement(connectorID);
+	ElementGeometry geometry = elementGeometry(connectorID);
+	QRectF bounds = geometry.bounds;
 
 	if (bounds.isNull() && !svgIdLayer->m_hybrid) {		// hybrids can have zero size
 		svgIdLayer->setInvisible(viewLayerPlacement);
@@ -668,7 +1278,7 @@ bool FSvgRenderer::setUpConnector(SvgIdLayer * svgIdLayer, bool ignoreTerminalPo
 	//QTransform matrix0 = connectorInfo->matrix * this->transformForElement(connectorID);
 	//QRectF r1 = matrix0.mapRect(bounds);
 
-	QTransform elementMatrix = this->transformForElement(connectorID);
+	QTransform elementMatrix = geometry.matrix;
 	QRectF r1 = elementMatrix.mapRect(bounds);
 
 	if (connectorInfo != nullptr) {
@@ -729,7 +1339,7 @@ void FSvgRenderer::calcLeg(SvgIdLayer * svgIdLayer, const QRectF & viewBox, Conn
 		);
 	*/
 
-	QTransform matrix = this->transformForElement(svgIdLayer->m_legId) * connectorInfo->legMatrix;
+	QTransform matrix = elementGeometry(svgIdLayer->m_legId).matrix * connectorInfo->legMatrix;
 	QPointF p1 = matrix.map(connectorInfo->legLine.p1());
 	QPointF p2 = matrix.map(connectorInfo->legLine.p2());
 
@@ -761,12 +1371,13 @@ QPointF FSvgRenderer::calcTerminalPoint(const QString & terminalId, const QRectF
 		return terminalPoint;
 	}
 
-	if (!this->elementExists(terminalId)) {
+	ElementGeometry geometry = elementGeometry(terminalId);
+	if (!geometry.exists) {
 		DebugDialog::debug(QString("missing expected terminal point element %1").arg(terminalId));
 		return terminalPoint;
 	}
 
-	QRectF tBounds = this->boundsOnElement(terminalId);
+	QRectF tBounds = geometry.bounds;
 	if (tBounds.isNull()) {
 		return terminalPoint;
 	}
@@ -782,7 +1393,7 @@ QPointF FSvgRenderer::calcTerminalPoint(const QString & terminalId, const QRectF
 	// transformForElement only grabs parent matrices, not any transforms in the element itself
 	//QTransform tMatrix = this->transformForElement(terminalId) ; //* terminalMatrix;
 	//QRectF terminalRect = tMatrix.mapRect(tBounds);
-	QRectF terminalRect = this->transformForElement(terminalId).mapRect(tBounds);
+	QRectF terminalRect = geometry.matrix.mapRect(tBounds);
 	QPointF c = terminalRect.center();
 	QPointF q(c.x() * defaultSizeF.width() / viewBox.width(), c.y() * defaultSizeF.height() / viewBox.height());
 	terminalPoint = q - connectorRect.topLeft();
@@ -801,7 +1412,8 @@ QList<SvgIdLayer *> FSvgRenderer::setUpNonConnectors(ViewLayer::ViewLayerPlaceme
 	Q_FOREACH (QString nonConnectorID, m_nonConnectorInfoHash.keys()) {
 		auto * svgIdLayer = new SvgIdLayer(ViewLayer::PCBView);
 		svgIdLayer->m_svgId = nonConnectorID;
-		QRectF bounds = this->boundsOnElement(nonConnectorID);
+		ElementGeometry geometry = elementGeometry(nonConnectorID);
+		QRectF bounds = geometry.bounds;
 		if (bounds.isNull()) {
 			delete svgIdLayer;
 			continue;
@@ -826,7 +1438,7 @@ QList<SvgIdLayer *> FSvgRenderer::setUpNonConnectors(ViewLayer::ViewLayerPlaceme
 		// transformForElement only grabs parent matrices, not any transforms in the element itself
 		//QTransform matrix0 = connectorInfo->matrix * this->transformForElement(nonConnectorID);
 		//QRectF r1 = matrix0.mapRect(bounds);
-		QRectF r1 = this->transformForElement(nonConnectorID).mapRect(bounds);
+		QRectF r1 = geometry.matrix.mapRect(bounds);
 		QRectF svgRect(r1.x() * defaultSize.width() / viewBox.width(), r1.y() * defaultSize.height() / viewBox.height(), r1.width() * defaultSize.width() / viewBox.width(), r1.height() * defaultSize.height() / viewBox.height());
 		QPointF center = svgRect.center() - svgRect.topLeft();
 		svgIdLayer->setPointRect(viewLayerPlacement, center, svgRect, true);
@@ -836,3 +1448,33 @@ QList<SvgIdLayer *> FSvgRenderer::setUpNonConnectors(ViewLayer::ViewLayerPlaceme
 	return list;
 
 }
+
+ElementGeometry FSvgRenderer::elementGeometry(const QString & id)
+{
+	// every instance of a part shares this renderer, so each connector, terminal, leg and
+	// nonconnector element is only looked up in the drawing once
+	auto it = m_elementGeometry.constFind(id);
+	if (it != m_elementGeometry.constEnd()) return it.value();
+
+	ElementGeometry geometry;
+	geometry.exists = this->elementExists(id);
+	if (geometry.exists) {
+		geometry.bounds = this->boundsOnElement(id);
+		geometry.matrix = this->transformForElement(id);
+	}
+	m_elementGeometry.insert(id, geometry);
+	return geometry;
+}
+
+void FSvgRenderer::prepareElements(const LoadInfo & loadInfo)
+{
+	// for a renderer loaded on the thread pool, before it is handed to the gui thread,
+	// so that setting up the connectors of the first instance doesn't walk the drawing
+	QStringList ids;
+	ids << loadInfo.connectorIDs << loadInfo.terminalIDs << loadInfo.legIDs << m_nonConnectorInfoHash.keys();
+	Q_FOREACH (const QString & id, ids) {
+		if (id.isEmpty()) continue;
+
+		elementGeometry(id);
+	}
+}
@@ -44,8 +44,16 @@ struct ConnectorInfo {
 	bool gotPath;
 };
 
+struct ElementGeometry {
+	bool exists = false;
+	QRectF bounds;                      // boundsOnElement
+	QTransform matrix;                  // transformForElement
+};
+
 typedef QHash<ViewLayer::ViewLayerID, class FSvgRenderer *> RendererHash;
 
+struct CookedSvg;
+
 struct LoadInfo {
 	QString filename;
 	QStringList connectorIDs;
@@ -79,21 +87,50 @@ public:
 	QSizeF defaultSizeF();
 	bool setUpConnector(class SvgIdLayer * svgIdLayer, bool ignoreTerminalPoint, ViewLayer::ViewLayerPlacement);
 	QList<SvgIdLayer *> setUpNonConnectors(ViewLayer::ViewLayerPlacement);
+	void prepareElements(const LoadInfo &);
+	bool isShared() const;
+	void renderCached(QPainter *, const QRectF & bounds);
+	FSvgRenderer * unsharedCopy() const;
+	QByteArray variantKey(const QByteArray & contents, bool fastLoad) const;
+	qint64 loadedBytes() const;
+	qint64 drawingSerial() const;
+
+public:
+	struct Memory {
+		int renderers = 0;              // alive
+		qint64 loadedBytes = 0;         // of the svgs the live renderers were loaded from
+		int sharedRenderers = 0;
+		qint64 svgCacheBytes = 0;
+		qint64 rasterCacheBytes = 0;
+		int pathFits = 0;
+	};
 
 public:
 	static void cleanup();
+	static Memory memory();
 	static QSizeF parseForWidthAndHeight(QXmlStreamReader &);
 	static QPixmap * getPixmap(QSvgRenderer * renderer, QSize size);
 	static void initNames();
+	static QByteArray shareKey(const QByteArray & contents, const LoadInfo &);
+	static FSvgRenderer * sharedRenderer(const QByteArray & key, QByteArray & loaded);
+	static void shareRenderer(const QByteArray & key, FSvgRenderer *, const QByteArray & loaded);
+	static void releaseRenderer(FSvgRenderer *);
+	static void keepPrototype(const QString & key, const QList<FSvgRenderer *> &);
+	static void releasePrototypes();
 
 protected:
 	bool determineDefaultSize(QXmlStreamReader &);
 	QByteArray loadAux (const QByteArray & contents, const LoadInfo &);
+	QByteArray loadCooked(const QByteArray & contents, const LoadInfo &);
+	void cook(CookedSvg &, const QByteArray & cleanContents, const LoadInfo &) const;
+	void restoreCooked(const CookedSvg &, const LoadInfo &);
 	bool initConnectorInfo(QDomDocument &, const LoadInfo &);
+	bool initConnectorInfoStream(const QByteArray & contents, const LoadInfo &);
 	ConnectorInfo * initConnectorInfoStruct(QDomElement & connectorElement, const QString & filename, bool parsePaths);
 	bool initConnectorInfoStructAux(QDomElement &, ConnectorInfo * connectorInfo, const QString & filename, bool parsePaths);
 	bool initConnectorInfoCircle(QDomElement & element, ConnectorInfo * connectorInfo, const QString & filename);
 	bool initConnectorInfoPath(QDomElement & element, ConnectorInfo * connectorInfo, const QString & filename);
+	bool initConnectorInfoPathAux(QDomElement & element, ConnectorInfo * connectorInfo, const QString & filename);
 	void initNonConnectorInfo(QDomDocument & domDocument, const QString & filename);
 	void initNonConnectorInfoAux(QDomElement & element, const QString & filename);
 	void initTerminalInfoAux(QDomElement & element, const LoadInfo &);
@@ -103,13 +140,19 @@ protected:
 	bool initLegInfoAux(QDomElement & element, ConnectorInfo * connectorInfo);
 	void calcLeg(SvgIdLayer *, const QRectF & viewBox, ConnectorInfo * connectorInfo);
 	ConnectorInfo * getConnectorInfo(const QString & connectorID);
+	ElementGeometry elementGeometry(const QString & id);
 	void clearConnectorInfoHash(QHash<QString, ConnectorInfo *> & hash);
+	void setLoadedBytes(qint64);
 
 protected:
 	QString m_filename;
 	QSizeF m_defaultSizeF;
 	QHash<QString, ConnectorInfo *> m_connectorInfoHash;
 	QHash<QString, ConnectorInfo *> m_nonConnectorInfoHash;
+	qint64 m_drawingSerial = 0;          // changes with every load, so cached rasters of an old drawing are never used
+	QByteArray m_documentKey;            // hash of the document whose connectors are being read, once a path connector needs it
+	qint64 m_loadedBytes = 0;
+	QHash<QString, ElementGeometry> m_elementGeometry;     // by element id, for the drawing last loaded
 
 public:
 	static QString NonConnectorName;
@@ -39,6 +39,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #define HTML_EOF "</body>\n</html>"
 
+static const int IconDelay = 30;
+
 static constexpr int MaxSpinBoxWidth = 60;
 static constexpr int AfterSpinBoxWidth = 5;
 
@@ -107,6 +109,14 @@ HtmlInfoView::HtmlInfoView(QWidget * parent) : QScrollArea(parent)
 	m_setContentTimer.setSingleShot(true);
 	m_setContentTimer.setInterval(10);
 	connect(&m_setContentTimer, SIGNAL(timeout()), this, SLOT(setContent()));
+	m_contentDeferred = false;
+
+	// icons are three svg renders, so they come after the rest of the inspector has been painted,
+	// and not at all for an item that is only passed over on the way to another selection
+	m_pendingIconSwappingEnabled = false;
+	m_setIconsTimer.setSingleShot(true);
+	m_setIconsTimer.setInterval(IconDelay);
+	connect(&m_setIconsTimer, SIGNAL(timeout()), this, SLOT(setIcons()));
 
 	m_currentItem = nullptr;
 	m_currentSwappingEnabled = false;
@@ -338,6 +348,15 @@ void HtmlInfoView::resizeEvent(QResizeEvent *event)
 	QScrollArea::resizeEvent(event);
 }
 
+void HtmlInfoView::showEvent(QShowEvent *event)
+{
+	QScrollArea::showEvent(event);
+	if (m_contentDeferred) {
+		m_contentDeferred = false;
+		m_setContentTimer.start();
+	}
+}
+
 
 void HtmlInfoView::viewItemInfo(InfoGraphicsView *, ItemBase* item, bool swappingEnabled)
 {
@@ -518,6 +537,13 @@ void HtmlInfoView::setContent()
 	//DebugDialog::debug(QString("pending %1").arg(m_pendingItemBase->title()));
 	m_currentSwappingEnabled = m_pendingSwappingEnabled;
 
+	if (!isVisible()) {
+		// the inspector dock is closed or behind another tab; rebuild when it is shown
+		setCurrentItem(m_pendingItemBase);
+		m_contentDeferred = true;
+		return;
+	}
+
 	appendStuff(m_pendingItemBase, m_pendingSwappingEnabled);
 	setCurrentItem(m_pendingItemBase);
 
@@ -660,6 +686,18 @@ void HtmlInfoView::setUpIcons(ItemBase * itemBase, bool swappingEnabled) {
 	if (m_lastIconItemBase == itemBase) return;
 
 	m_lastIconItemBase = itemBase;
+	m_pendingIconItemBase = itemBase;
+	m_pendingIconSwappingEnabled = swappingEnabled;
+	if (itemBase == nullptr) {
+		setIcons();
+		return;
+	}
+
+	m_setIconsTimer.start();
+}
+
+void HtmlInfoView::setIcons() {
+	m_setIconsTimer.stop();
 
 	QPixmap *pixmap1 = nullptr;
 	QPixmap *pixmap2 = nullptr;
@@ -667,8 +705,8 @@ void HtmlInfoView::setUpIcons(ItemBase * itemBase, bool swappingEnabled) {
 
 	QSize size = QSize(ScaledIconFrame::STANDARD_ICON_IMG_WIDTH, ScaledIconFrame::STANDARD_ICON_IMG_HEIGHT);
 
-	if (itemBase != nullptr) {
-		itemBase->getPixmaps(pixmap1, pixmap2, pixmap3, swappingEnabled, size);
+	if (m_pendingIconItemBase != nullptr) {
+		m_pendingIconItemBase->getPixmaps(pixmap1, pixmap2, pixmap3, m_pendingIconSwappingEnabled, size);
 	}
 
 	QPixmap* use1 = pixmap1;
@@ -67,6 +67,7 @@ public:
 	~HtmlInfoView();
 
 	void resizeEvent(QResizeEvent *event) override;
+	void showEvent(QShowEvent *event) override;
 
 	QSize sizeHint() const override;
 	void setContent(const QString& html);
@@ -97,6 +98,7 @@ Q_SIGNALS:
 
 protected Q_SLOTS:
 	void setContent();
+	void setIcons();
 	void setInstanceTitle();
 	void instanceTitleEnter();
 	void instanceTitleLeave();
@@ -139,6 +141,8 @@ protected:
 	bool m_currentSwappingEnabled;					// previous item (possibly hovered over)
 
 	QTimer m_setContentTimer;
+	QTimer m_setIconsTimer;
+	bool m_contentDeferred;							// selection changed while the inspector was hidden
 	QPointer<ItemBase> m_lastItemBase;
 	bool m_lastSwappingEnabled;						// previous item (selected)
 	class FLineEdit * m_titleEdit;
@@ -174,6 +178,8 @@ protected:
 	QList <PropThing *> m_propThings;
 	QPointer<ItemBase> m_pendingItemBase;
 	bool m_pendingSwappingEnabled;
+	QPointer<ItemBase> m_pendingIconItemBase;
+	bool m_pendingIconSwappingEnabled;
 	QWidget * m_layerWidget;
 	QDoubleSpinBox * m_xEdit;
 	QDoubleSpinBox * m_yEdit;
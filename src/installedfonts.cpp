@@ -0,0 +1,73 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include <QFileInfo>
+#include <QFont>
+#include <QFontDatabase>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "installedfonts.h"
+#include "debugdialog.h"
+#include "utils/misc.h"
+
+static QMutex FontsMutex;
+static bool UIFontsRegistered = false;
+static bool FontsRegistered = false;
+
+void InstalledFonts::registerUIFonts() {
+	// the style sheet uses Droid Sans, so these go in before any widget is made
+	QMutexLocker locker(&FontsMutex);
+	if (UIFontsRegistered) return;
+
+	UIFontsRegistered = true;
+	registerFont(":/resources/fonts/DroidSans.ttf", true);
+	registerFont(":/resources/fonts/DroidSans-Bold.ttf", false);
+}
+
+void InstalledFonts::registerFonts() {
+	// the mono, OCR and segment fonts are registered the first time an svg is loaded, a label or the
+	// parts editor asks, or an export starts, rather than on the way to the first window
+	registerUIFonts();
+
+	QMutexLocker locker(&FontsMutex);
+	if (FontsRegistered) return;
+
+	FontsRegistered = true;
+	registerFont(":/resources/fonts/DroidSansMono.ttf", false);
+	registerFont(":/resources/fonts/OCRA.ttf", true);
+	registerFont(":/resources/fonts/Segment16/Segment16C Bold.ttf", true);
+	registerFont(":/resources/fonts/OCR-Fritzing-mono.otf", true);
+
+	QFont::insertSubstitution(OCRAFontName, OCRFFontName);
+}
+
+void InstalledFonts::registerFont(const QString &fontFile, bool reallyRegister) {
+	int id = QFontDatabase::addApplicationFont(fontFile);
+	if(id > -1 && reallyRegister) {
+		QStringList familyNames = QFontDatabase::applicationFontFamilies(id);
+		QFileInfo finfo(fontFile);
+		Q_FOREACH (QString family, familyNames) {
+			InstalledFontsNameMapper.insert(family, finfo.completeBaseName());
+			InstalledFontsList << family;
+			DebugDialog::debug(QString("registering font family: %1 %2").arg(family).arg(finfo.completeBaseName()));
+		}
+	}
+}
@@ -28,10 +28,17 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 class InstalledFonts
 {
 
+public:
+	static void registerUIFonts();
+	static void registerFonts();
+
 public:
 	static QSet<QString> InstalledFontsList;
 	static QMultiHash<QString, QString> InstalledFontsNameMapper;   // family name to filename; SVG files seem to have to use filename
-	// note: these static variables are initialized in fapplication.cpp
+	// note: these static variables are initialized in textutils.cpp, and only list every font once registerFonts has run
+
+protected:
+	static void registerFont(const QString &fontFile, bool reallyRegister);
 };
 
 #endif
@@ -12,7 +12,9 @@
 #include "src/connectors/connectoritem.h"
 #include "version/version.h"
 
+#include <QHash>
 #include <QString>
+#include <QTextStream>
 #include <QMessageBox>
 #include <qmath.h>
 
@@ -130,7 +132,7 @@ int s2ipc(double valueInSvgResolution) {
 	return std::round(valueInIpc);
 }
 
-QString connectorToRecord(int cmd, ConnectorItem * connectorItem, ItemBase * itemBase, QPointF origin, QString netLabel)
+QString connectorToRecord(int cmd, ConnectorItem * connectorItem, ItemBase * itemBase, QPointF origin, QString netLabel, int ccw_angle)
 {
 	ViewLayer::ViewLayerID layer = connectorItem->attachedToViewLayerID();
 	QString title = itemBase->instanceTitle();
@@ -139,7 +141,6 @@ QString connectorToRecord(int cmd, ConnectorItem * connectorItem, ItemBase * ite
 	QPointF loc = connectorItem->mapToScene(connectorItem->rect().center());
 	double width = connectorItem->rect().width();
 	double height = connectorItem->rect().height();
-	QTransform transform = itemBase->transform();
 
 	bool isMiddle = connectorItem->connectionsCount() > 1;
 
@@ -159,57 +160,82 @@ QString connectorToRecord(int cmd, ConnectorItem * connectorItem, ItemBase * ite
 	int widthOrDiameter = isDrilled ? diameter : s2ipc(width);
 	int heightOrZero = connectorItem->isEffectivelyCircular() ? 0 : s2ipc(height);
 
-	int ccw_angle = round(atan2(transform.m12(), transform.m11()) * 180.0 / M_PI);  // doesn't account for scaling. from GerberGenerator::exportPickAndPlace.
-
 	QString ipc = electricalTestRecord(cmd, netLabel, title, connectorName, connectorId, isTHT, isMiddle, isPlated, isDrilled, holeDiameter, x, y, widthOrDiameter, heightOrZero, layer, ccw_angle);
 	return ipc;
 }
 
 
-QString getExportIPC_D_356A(ItemBase * board, QString basename, QList< QList<ConnectorItem *>* > netList) {
+void writeExportIPC_D_356A(QTextStream & ipc, ItemBase * board, const QString & basename, QList< QList<ConnectorItem *>* > netList) {
 
 	QPointF origin = board->sceneBoundingRect().bottomLeft();
 
-	QString ipc; // IPC D 356A
-
 	const char comment[]{"C  %.66s\n"};
 	const char header3[]{"P  %.3s   %.62s\n"};
 	const char header4[]{"P  %.4s  %.62s\n"};
 	const char header5[]{"P  %.5s %.62s\n"};
 	const char ende[]{"999\n"};
 
-	ipc += QString::asprintf(comment, TextUtils::CreatedWithFritzingString.toStdString().c_str());
-	ipc += QString::asprintf(comment, Version::versionString().toStdString().c_str());
-//	ipc += QString::asprintf(header, "JOB", "TEST");
-	ipc += QString::asprintf(header4, "CODE", "00");
+	ipc << QString::asprintf(comment, TextUtils::CreatedWithFritzingString.toStdString().c_str());
+	ipc << QString::asprintf(comment, Version::versionString().toStdString().c_str());
+//	ipc << QString::asprintf(header, "JOB", "TEST");
+	ipc << QString::asprintf(header4, "CODE", "00");
 
 	//	 SI Metric
 	//	 CUST 0 or CUST Inches and degrees
 	//	 CUST 1 Millimeters and degrees
 	//	 CUST 2 Inches and radians
-	ipc += QString::asprintf(header5, "UNITS", "CUST 1");
-	ipc += QString::asprintf(header5, "TITLE", basename.toStdString().c_str());
-	//ipc += QString::asprintf(header3, "NUM", NA);
-	//ipc += QString::asprintf(header3, "REV", NA);
-	ipc += QString::asprintf(header3, "VER", "IPC-D-356A");
-
+	ipc << QString::asprintf(header5, "UNITS", "CUST 1");
+	ipc << QString::asprintf(header5, "TITLE", basename.toStdString().c_str());
+	//ipc << QString::asprintf(header3, "NUM", NA);
+	//ipc << QString::asprintf(header3, "REV", NA);
+	ipc << QString::asprintf(header3, "VER", "IPC-D-356A");
+
+	// the sort keys are worked out once per connector instead of once per comparison
+	auto centerKey = [](ConnectorItem * connectorItem) {
+		QPointF center = connectorItem->rect().center();
+		return center.x() + center.y();
+	};
+	QHash<QList<ConnectorItem *> *, QPair<QString, double>> netKeys;
 	Q_FOREACH (QList<ConnectorItem *> * net, netList) {
 		// Sorting so we get consistend export data, avoid random order
-		std::sort(net->begin(), net->end(), [](ConnectorItem * a, ConnectorItem * b){
-			return a->rect().center().x() + a->rect().center().y() > b->rect().center().x() + b->rect().center().y();
+		QList<QPair<double, ConnectorItem *>> keyed;
+		keyed.reserve(net->count());
+		Q_FOREACH (ConnectorItem * connectorItem, *net) {
+			keyed.append(qMakePair(centerKey(connectorItem), connectorItem));
+		}
+		std::sort(keyed.begin(), keyed.end(), [](const QPair<double, ConnectorItem *> & a, const QPair<double, ConnectorItem *> & b){
+			return a.first > b.first;
 		});
+		for (int i = 0; i < keyed.count(); i++) {
+			(*net)[i] = keyed.at(i).second;
+		}
+		netKeys.insert(net, qMakePair(net->constFirst()->attachedToInstanceTitle(), net->constFirst()->rect().center().x()));
 	}
 
 	int countNets = 0;
 
 	// Sorting so we get consistend export data, avoid random order
-	std::sort(netList.begin(), netList.end(), [](QList<ConnectorItem *> * a, QList<ConnectorItem *> * b){
-		if (a->constFirst()->attachedToInstanceTitle() == b->constFirst()->attachedToInstanceTitle()) {
-			return a->constFirst()->rect().center().x() > b->constFirst()->rect().center().x();
+	std::sort(netList.begin(), netList.end(), [&netKeys](QList<ConnectorItem *> * a, QList<ConnectorItem *> * b){
+		const QPair<QString, double> & keyA = netKeys[a];
+		const QPair<QString, double> & keyB = netKeys[b];
+		if (keyA.first == keyB.first) {
+			return keyA.second > keyB.second;
 		}
-		return a->constFirst()->attachedToInstanceTitle() > b->constFirst()->attachedToInstanceTitle();
+		return keyA.first > keyB.first;
 	});
 
+	// parts carry many connectors; their rotation is computed once
+	QHash<ItemBase *, int> angles;
+	auto ccwAngle = [&angles](ItemBase * itemBase) {
+		auto it = angles.find(itemBase);
+		if (it != angles.end()) return it.value();
+
+		QTransform transform = itemBase->transform();
+		int ccw_angle = round(atan2(transform.m12(), transform.m11()) * 180.0 / M_PI);  // doesn't account for scaling. from GerberGenerator::exportPickAndPlace.
+		angles.insert(itemBase, ccw_angle);
+		return ccw_angle;
+	};
+
 	Q_FOREACH (QList<ConnectorItem *> * net, netList) {
 		countNets += 1;
 
@@ -246,10 +272,11 @@ QString getExportIPC_D_356A(ItemBase * board, QString basename, QList< QList<Con
 				bool isCrossLayer = ViewLayer::copperLayers(placement).contains(layer);
 				if (isCrossLayer) continue;
 
-				ipc += connectorToRecord(IPCD356A::ThroughHole, crossLayerConnectorItem, itemBase, origin, netLabel);
-				ipc += connectorToRecord(IPCD356A::ThroughHoleContinuation, connectorItem, itemBase, origin, netLabel);
+				int ccw_angle = ccwAngle(itemBase);
+				ipc << connectorToRecord(IPCD356A::ThroughHole, crossLayerConnectorItem, itemBase, origin, netLabel, ccw_angle);
+				ipc << connectorToRecord(IPCD356A::ThroughHoleContinuation, connectorItem, itemBase, origin, netLabel, ccw_angle);
 			} else {
-				ipc += connectorToRecord(IPCD356A::SurfaceMount, connectorItem, itemBase, origin, netLabel);
+				ipc << connectorToRecord(IPCD356A::SurfaceMount, connectorItem, itemBase, origin, netLabel, ccwAngle(itemBase));
 			}
 		}
 	}
@@ -258,6 +285,13 @@ QString getExportIPC_D_356A(ItemBase * board, QString basename, QList< QList<Con
 		delete net;
 	}
 
-	ipc += ende;
+	ipc << ende;
+}
+
+QString getExportIPC_D_356A(ItemBase * board, QString basename, QList< QList<ConnectorItem *>* > netList) {
+	QString ipc; // IPC D 356A
+	QTextStream stream(&ipc);
+	writeExportIPC_D_356A(stream, board, basename, netList);
+	stream.flush();
 	return ipc;
 }
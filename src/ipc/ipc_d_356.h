@@ -3,8 +3,10 @@
 
 class ItemBase;
 class ConnectorItem;
+class QTextStream;
 
 QString getExportIPC_D_356A(ItemBase * board, QString basename, QList< QList<ConnectorItem *>* > netList);
+void writeExportIPC_D_356A(QTextStream &, ItemBase * board, const QString & basename, QList< QList<ConnectorItem *>* > netList);
 
 
 
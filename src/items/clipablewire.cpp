@@ -150,11 +150,6 @@ const QLineF & ClipableWire::getPaintLine() {
 	}
 
 	QLineF originalLine = this->line();
-	//qDebug() << "line" << originalLine.p1() + pos() << originalLine.p2() + pos() << pos();
-	if (m_cachedOriginalLine == originalLine) {
-		// qDebug() << "  cachedline a" << m_cachedLine.p1() + pos() << m_cachedLine.p2() + pos() << pos();
-		return m_cachedLine;
-	}
 
 	int t0c = 0;
 	ConnectorItem* to0 = nullptr;
@@ -184,6 +179,17 @@ const QLineF & ClipableWire::getPaintLine() {
 		return Wire::getPaintLine();
 	}
 
+	// reuse the clipped line until the wire or a connector at either end moves or changes shape;
+	// the local line alone misses a pad that turns or moves under an end the wire hasn't moved
+	//qDebug() << "line" << originalLine.p1() + pos() << originalLine.p2() + pos() << pos();
+	ClipEnd end0 = clipEnd(to0);
+	ClipEnd end1 = clipEnd(to1);
+	QTransform sceneTransform = this->sceneTransform();
+	if (m_cachedOriginalLine == originalLine && m_cachedSceneTransform == sceneTransform && m_cachedEnd0 == end0 && m_cachedEnd1 == end1) {
+		// qDebug() << "  cachedline a" << m_cachedLine.p1() + pos() << m_cachedLine.p2() + pos() << pos();
+		return m_cachedLine;
+	}
+
 	QPointF p1 = originalLine.p1();
 	QPointF p2 = originalLine.p2();
 
@@ -204,12 +210,32 @@ const QLineF & ClipableWire::getPaintLine() {
 	//}
 
 	m_cachedOriginalLine = originalLine;
+	m_cachedSceneTransform = sceneTransform;
+	m_cachedEnd0 = end0;
+	m_cachedEnd1 = end1;
 	m_cachedLine.setPoints(p1, p2);
 	//qDebug() << "  cachedline b" << m_cachedLine.p1() + pos() << m_cachedLine.p2() + pos() << pos();
 	return m_cachedLine;
 
 }
 
+ClipableWire::ClipEnd ClipableWire::clipEnd(ConnectorItem * connectorItem) {
+	ClipEnd end;
+	if (connectorItem == nullptr) return end;
+
+	end.connected = true;
+	end.circular = connectorItem->isEffectivelyCircular();
+	end.clipRadius = connectorItem->calcClipRadius();
+	end.rect = connectorItem->rect();
+	end.sceneTransform = connectorItem->sceneTransform();
+	return end;
+}
+
+bool ClipableWire::ClipEnd::operator==(const ClipEnd & other) const {
+	return connected == other.connected && circular == other.circular && clipRadius == other.clipRadius &&
+	       rect == other.rect && sceneTransform == other.sceneTransform;
+}
+
 void ClipableWire::setClipEnds(bool clipEnds ) {
 	if (m_clipEnds != clipEnds) {
 		prepareGeometryChange();
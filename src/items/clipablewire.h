@@ -24,6 +24,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "wire.h"
 
 #include <QPointer>
+#include <QTransform>
 
 class ClipableWire : public Wire
 {
@@ -41,6 +42,18 @@ public:
 	void hoverMoveConnectorItem(QGraphicsSceneHoverEvent * event, class ConnectorItem * item);
 
 protected:
+	struct ClipEnd {
+		// everything calcClip reads from the connector a wire end is clipped against
+		bool connected = false;
+		bool circular = false;
+		double clipRadius = 0;
+		QRectF rect;
+		QTransform sceneTransform;
+
+		bool operator==(const ClipEnd &) const;
+	};
+
+	static ClipEnd clipEnd(ConnectorItem *);
 	bool insideInnerCircle(ConnectorItem * connectorItem, QPointF localPos);
 	bool insideSpoke(ClipableWire * wire, QPointF scenePos);
 	void dispatchHover(QPointF scenePos);
@@ -52,6 +65,9 @@ protected:
 	bool m_clipEnds;
 	QLineF m_cachedLine;
 	QLineF m_cachedOriginalLine;
+	QTransform m_cachedSceneTransform;
+	ClipEnd m_cachedEnd0;
+	ClipEnd m_cachedEnd1;
 	QGraphicsSceneMouseEvent * m_justFilteredEvent;
 	QPointer<ConnectorItem> m_trackHoverItem;
 	QPointer<ConnectorItem> m_trackHoverLastItem;
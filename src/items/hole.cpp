@@ -38,10 +38,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QSpacerItem>
 #include <QGroupBox>
 #include <QSettings>
+#include <QHash>
 
 const double Hole::OffsetPixels = 2;
 
 static HoleClassThing TheHoleThing;
+static QHash<QString, QString> HoleSvgs;
 
 //////////////////////////////////////////////////
 
@@ -119,7 +121,7 @@ void Hole::setBoth(const QString & holeDiameter, const QString & ringThickness)
 ItemBase * Hole::setBothSvg(const QString & holeDiameter, const QString & ringThickness)
 {
 	QString svg = makeSvg(holeDiameter, ringThickness, m_viewLayerID, true, false);
-	resetRenderer(svg);
+	resetSharedRenderer(svg);
 	//DebugDialog::debug("both");
 	//DebugDialog::debug(svg);
 
@@ -137,7 +139,7 @@ ItemBase * Hole::setBothSvg(const QString & holeDiameter, const QString & ringTh
 	if (otherLayer != nullptr) {
 		osvg = makeSvg(holeDiameter, ringThickness, otherLayer->viewLayerID(), true, false);
 		//DebugDialog::debug(osvg);
-		otherLayer->resetRenderer(osvg);
+		otherLayer->resetSharedRenderer(osvg);
 	}
 
 	//DebugDialog::debug("other");
@@ -159,6 +161,18 @@ void Hole::setBothNonConnectors(ItemBase * itemBase, SvgIdLayer * svgIdLayer) {
 
 
 QString Hole::makeSvg(const QString & holeDiameter, const QString & ringThickness, ViewLayer::ViewLayerID viewLayerID, bool includeHole, bool blackOnly)
+{
+	// a board's holes and vias mostly come in a few sizes, so the svgs are made once per size, layer and id
+	QString key = QString("%1|%2|%3|%4|%5|%6").arg(holeDiameter, ringThickness).arg(viewLayerID).arg(includeHole).arg(blackOnly).arg(makeID());
+	auto it = HoleSvgs.constFind(key);
+	if (it != HoleSvgs.constEnd()) return it.value();
+
+	QString svg = makeSvgAux(holeDiameter, ringThickness, viewLayerID, includeHole, blackOnly);
+	HoleSvgs.insert(key, svg);
+	return svg;
+}
+
+QString Hole::makeSvgAux(const QString & holeDiameter, const QString & ringThickness, ViewLayer::ViewLayerID viewLayerID, bool includeHole, bool blackOnly)
 {
 	double offsetDPI = OffsetPixels / GraphicsUtils::SVGDPI;
 	double hd = TextUtils::convertToInches(holeDiameter);
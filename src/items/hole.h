@@ -62,6 +62,7 @@ protected Q_SLOTS:
 
 protected:
 	QString makeSvg(const QString & holeDiameter, const QString & ringThickness, ViewLayer::ViewLayerID, bool includeHole, bool blackOnly);
+	QString makeSvgAux(const QString & holeDiameter, const QString & ringThickness, ViewLayer::ViewLayerID, bool includeHole, bool blackOnly);
 	virtual QString makeID();
 	ItemBase * setBothSvg(const QString & holeDiameter, const QString & ringThickness);
 	void setBothNonConnectors(ItemBase * itemBase, SvgIdLayer * svgIdLayer);
@@ -27,14 +27,17 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../sketch/infographicsview.h"
 #include "../connectors/connector.h"
 #include "../connectors/bus.h"
+#include "../connectors/connectivityindex.h"
 #include "partlabel.h"
 #include "../layerattributes.h"
 #include "../fsvgrenderer.h"
 #include "../svg/svgfilesplitter.h"
 #include "../svg/svgflattener.h"
+#include "svgprefetcher.h"
 #include "../utils/folderutils.h"
 #include "../utils/textutils.h"
 #include "../utils/graphicsutils.h"
+#include "../utils/interactionprofiler.h"
 #include "../utils/cursormaster.h"
 #include "../utils/clickablelabel.h"
 #include "../utils/familypropertycombobox.h"
@@ -50,6 +53,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QBitmap>
 #include <QApplication>
 #include <QClipboard>
+#include <QStyleOptionGraphicsItem>
 #include <qmath.h>
 
 /////////////////////////////////
@@ -75,6 +79,7 @@ const QString ItemBase::ITEMBASE_FONT_SUFFIX = "</font>";
 QHash<QString, QString> ItemBase::TranslatedPropertyNames;
 
 QPointer<ReferenceModel> ItemBase::TheReferenceModel = nullptr;
+int ItemBase::ConnectionUpdatesHeld = 0;
 
 QString ItemBase::PartInstanceDefaultTitle;
 const QList<ItemBase *> ItemBase::EmptyList;
@@ -83,6 +88,10 @@ const QColor ItemBase::HoverColor(0,0,0);
 const double ItemBase::HoverOpacity = .20;
 const QColor ItemBase::ConnectorHoverColor(0,0,255);
 const double ItemBase::ConnectorHoverOpacity = .40;
+const QColor ItemBase::OutlineColor(96, 96, 96);
+
+double ItemBase::SmallDetailZoom = 0.25;
+double ItemBase::OutlineZoom = 0.08;
 
 const QColor StandardConnectedColor(0, 255, 0);
 const QColor StandardUnconnectedColor(255, 0, 0);
@@ -144,7 +153,7 @@ ItemBase::~ItemBase() {
 	}
 
 	if (m_fsvgRenderer != nullptr) {
-		delete m_fsvgRenderer;
+		FSvgRenderer::releaseRenderer(m_fsvgRenderer);
 	}
 
 	//m_simItem is a child of this object, it gets delated by the destructor
@@ -190,6 +199,10 @@ qint64 ItemBase::getNextID(qint64 index) {
 
 void ItemBase::resetID() {
 	m_id = m_modelPart->modelIndex() * ModelPart::indexMultiplier;
+	InfoGraphicsView * infoGraphicsView = InfoGraphicsView::getInfoGraphicsView(this);
+	if (infoGraphicsView != nullptr) {
+		infoGraphicsView->indexItem(this, true);
+	}
 }
 
 double ItemBase::z() {
@@ -283,6 +296,9 @@ void ItemBase::initNames() {
 		setUnconnectedColor(color);
 	}
 
+	// zoom percentages below which a view leaves out detail
+	SmallDetailZoom = settings.value("smallDetailZoom", SmallDetailZoom * 100).toDouble() / 100;
+	OutlineZoom = settings.value("outlineZoom", OutlineZoom * 100).toDouble() / 100;
 }
 
 void ItemBase::saveInstance(QXmlStreamWriter & streamWriter, bool flipAware) {
@@ -711,6 +727,7 @@ bool ItemBase::inHover() {
 }
 
 void ItemBase::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+	InteractionProfiler::itemPainted();
 	if (inHover()) {
 		//DebugDialog::debug(QString("chc:%1 hc:%2 chc2:%3").arg(m_connectorHoverCount).arg(m_hoverCount).arg(m_connectorHoverCount2));
 		layerKinChief()->paintHover(painter, option, widget);
@@ -735,9 +752,46 @@ void ItemBase::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 	}
 }
 
-void ItemBase::paintBody(QPainter *painter, const QStyleOptionGraphicsItem * /* option */, QWidget * /* widget */)
+ItemBase::DetailLevel ItemBase::detailLevel(const QPainter * painter, const QWidget * widget)
+{
+	// printing and exporting have no widget and always get full detail
+	if (widget == nullptr) return FullDetail;
+
+	double lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+	if (lod < OutlineZoom) return OutlineOnly;
+	if (lod < SmallDetailZoom) return NoSmallDetail;
+	return FullDetail;
+}
+
+void ItemBase::paintOutline(QPainter *painter)
+{
+	QPen pen(OutlineColor);
+	pen.setCosmetic(true);
+	QColor fill(OutlineColor);
+	fill.setAlpha(64);
+
+	painter->save();
+	painter->setPen(pen);
+	painter->setBrush(fill);
+	painter->drawRect(boundingRectWithoutLegs());
+	painter->restore();
+}
+
+void ItemBase::paintBody(QPainter *painter, const QStyleOptionGraphicsItem * /* option */, QWidget * widget)
 {
+	if (detailLevel(painter, widget) == OutlineOnly) {
+		paintOutline(painter);
+		return;
+	}
+
 	// Qt's SVG renderer's defaultSize is not correct when the svg has a fractional pixel size
+	// while a view pans or zooms, draw from rasters; printing and exporting have no widget and always get vectors
+	auto * view = (widget == nullptr) ? nullptr : qobject_cast<ZoomableGraphicsView *>(widget->parentWidget());
+	if (view != nullptr && view->interacting()) {
+		fsvgRenderer()->renderCached(painter, boundingRectWithoutLegs());
+		return;
+	}
+
 	fsvgRenderer()->render(painter, boundingRectWithoutLegs());
 }
 
@@ -1207,6 +1261,16 @@ QVariant ItemBase::itemChange(QGraphicsItem::GraphicsItemChange change, const QV
 		}
 
 		break;
+	case QGraphicsItem::ItemSceneChange:
+	case QGraphicsItem::ItemSceneHasChanged: {
+		// keep the view's id index and the scene's connectivity in step with the scene
+		ConnectivityIndex::invalidate(scene());
+		InfoGraphicsView * infoGraphicsView = InfoGraphicsView::getInfoGraphicsView(this);
+		if (infoGraphicsView != nullptr) {
+			infoGraphicsView->indexItem(this, change == QGraphicsItem::ItemSceneHasChanged);
+		}
+		break;
+	}
 	default:
 		break;
 	}
@@ -1266,7 +1330,7 @@ void ItemBase::transformItem(const QTransform & currTransf, bool includeRatsnest
 	QTransform transf = QTransform().translate(-x, -y) * currTransf * QTransform().translate(x, y);
 	getViewGeometry().setTransform(getViewGeometry().transform()*transf);
 	this->setTransform(getViewGeometry().transform());
-	if (!m_hasRubberBandLeg) {
+	if (!m_hasRubberBandLeg && !connectionUpdatesHeld()) {
 		QList<ConnectorItem *> already;
 		updateConnections(includeRatsnest, already);
 	}
@@ -1282,6 +1346,16 @@ void ItemBase::transformItem2(const QTransform & matrix) {
 	transformItem(transform, false);
 }
 
+void ItemBase::holdConnectionUpdates(bool hold) {
+	// while held, moving or transforming an item leaves its attached wires for the caller to update once at the end
+	if (hold) ConnectionUpdatesHeld++;
+	else if (ConnectionUpdatesHeld > 0) ConnectionUpdatesHeld--;
+}
+
+bool ItemBase::connectionUpdatesHeld() {
+	return ConnectionUpdatesHeld > 0;
+}
+
 void ItemBase::collectWireConnectees(QSet<Wire *> & /* wires */) { } 
 
 bool ItemBase::collectFemaleConnectees(QSet<ItemBase *> & /* items */) {
@@ -1337,78 +1411,31 @@ FSvgRenderer * ItemBase::setUpImage(ModelPart * modelPart, LayerAttributes & lay
 	}
 
 	LoadInfo loadInfo;
-	switch (layerAttributes.viewID) {
-	case ViewLayer::PCBView:
-		loadInfo.colorElementID = ViewLayer::viewLayerXmlNameFromID(layerAttributes.viewLayerID);
-		switch (layerAttributes.viewLayerID) {
-		case ViewLayer::Copper0:
-			modelPartShared->connectorIDs(layerAttributes.viewID, layerAttributes.viewLayerID, loadInfo.connectorIDs, loadInfo.terminalIDs, loadInfo.legIDs);
-			loadInfo.setColor = ViewLayer::Copper0Color;
-			loadInfo.findNonConnectors = loadInfo.parsePaths = true;
-			break;
-		case ViewLayer::Copper1:
-			modelPartShared->connectorIDs(layerAttributes.viewID, layerAttributes.viewLayerID, loadInfo.connectorIDs, loadInfo.terminalIDs, loadInfo.legIDs);
-			loadInfo.setColor = ViewLayer::Copper1Color;
-			loadInfo.findNonConnectors = loadInfo.parsePaths = true;
-			break;
-		case ViewLayer::Silkscreen1:
-			loadInfo.setColor = ViewLayer::Silkscreen1Color;
-			break;
-		case ViewLayer::Silkscreen0:
-			loadInfo.setColor = ViewLayer::Silkscreen0Color;
-			break;
-		default:
-			break;
-		}
-		break;
-	case ViewLayer::BreadboardView:
-		modelPartShared->connectorIDs(layerAttributes.viewID, layerAttributes.viewLayerID, loadInfo.connectorIDs, loadInfo.terminalIDs, loadInfo.legIDs);
-		break;
-	default:
-		// don't need connectorIDs() for schematic view since these parts do not have bendable legs or connectors with drill holes
-		break;
-	}
+	initLoadInfo(modelPartShared, layerAttributes.viewID, layerAttributes.viewLayerID, loadInfo);
 
-	auto * newRenderer = new FSvgRenderer();
+	FSvgRenderer * newRenderer = nullptr;
 	QDomDocument flipDoc;
 	getFlipDoc(modelPart, filename, layerAttributes.viewLayerID, layerAttributes.viewLayerPlacement, flipDoc, layerAttributes.orientation);
 	QByteArray bytesToLoad;
-	if (layerAttributes.viewLayerID == ViewLayer::Schematic) {
-		bytesToLoad = SvgFileSplitter::hideText(filename);
-	}
-	else if (layerAttributes.viewLayerID == ViewLayer::SchematicText) {
-		bool hasText = false;
-		bytesToLoad = SvgFileSplitter::showText(filename, hasText);
-		if (!hasText) {
+	SvgPrefetcher::Source source = SvgPrefetcher::source(modelPartShared, layerAttributes.viewID, layerAttributes.viewLayerID);
+	if (flipDoc.isNull() || source == SvgPrefetcher::HideTextSvg || source == SvgPrefetcher::ShowTextSvg) {
+		// a sketch load may already have read these on the thread pool
+		bytesToLoad = SvgPrefetcher::bytes(modelPartShared, filename, layerAttributes.viewID, layerAttributes.viewLayerID);
+		if (bytesToLoad.isEmpty() && source == SvgPrefetcher::ShowTextSvg) {
 			return nullptr;
 		}
 	}
-	else if ((layerAttributes.viewID != ViewLayer::IconView) && modelPartShared->hasMultipleLayers(layerAttributes.viewID)) {
+	else if (source == SvgPrefetcher::SplitSvg) {
 		QString layerName = ViewLayer::viewLayerXmlNameFromID(layerAttributes.viewLayerID);
 		// need to treat create "virtual" svg file for each layer
 		SvgFileSplitter svgFileSplitter;
-		bool result;
-		if (flipDoc.isNull()) {
-			result = svgFileSplitter.split(filename, layerName);
-		}
-		else {
-			QString f = flipDoc.toString();
-			result = svgFileSplitter.splitString(f, layerName);
-		}
-		if (result) {
+		QString f = flipDoc.toString();
+		if (svgFileSplitter.splitString(f, layerName)) {
 			bytesToLoad = svgFileSplitter.byteArray();
 		}
 	}
 	else {
-		// only one layer, just load it directly
-		if (flipDoc.isNull()) {
-			QFile file(filename);
-			file.open(QFile::ReadOnly);
-			bytesToLoad = file.readAll();
-		}
-		else {
-			bytesToLoad = flipDoc.toByteArray();
-		}
+		bytesToLoad = flipDoc.toByteArray();
 	}
 
 	QByteArray resultBytes;
@@ -1424,7 +1451,19 @@ FSvgRenderer * ItemBase::setUpImage(ModelPart * modelPart, LayerAttributes & lay
 		}
 
 		loadInfo.filename = filename;
-		resultBytes = newRenderer->loadSvg(bytesToLoad, loadInfo);
+		// instances of a part loading identical bytes draw with one renderer; property-specific svgs differ in their bytes
+		QByteArray shareKey = FSvgRenderer::shareKey(bytesToLoad, loadInfo);
+		newRenderer = FSvgRenderer::sharedRenderer(shareKey, resultBytes);
+		if (newRenderer == nullptr) {
+			newRenderer = SvgPrefetcher::takeRenderer(modelPartShared, filename, layerAttributes.viewID, layerAttributes.viewLayerID, shareKey, resultBytes);
+			if (newRenderer == nullptr) {
+				newRenderer = new FSvgRenderer();
+				resultBytes = newRenderer->loadSvg(bytesToLoad, loadInfo);
+			}
+			if (!resultBytes.isEmpty()) {
+				FSvgRenderer::shareRenderer(shareKey, newRenderer, resultBytes);
+			}
+		}
 	}
 
 	layerAttributes.setLoaded(resultBytes);
@@ -1450,6 +1489,42 @@ FSvgRenderer * ItemBase::setUpImage(ModelPart * modelPart, LayerAttributes & lay
 	return newRenderer;
 }
 
+void ItemBase::initLoadInfo(ModelPartShared * modelPartShared, ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID, LoadInfo & loadInfo)
+{
+	// what the renderer needs to find connectors and recolor layers; filename is left to the caller
+	switch (viewID) {
+	case ViewLayer::PCBView:
+		loadInfo.colorElementID = ViewLayer::viewLayerXmlNameFromID(viewLayerID);
+		switch (viewLayerID) {
+		case ViewLayer::Copper0:
+			modelPartShared->connectorIDs(viewID, viewLayerID, loadInfo.connectorIDs, loadInfo.terminalIDs, loadInfo.legIDs);
+			loadInfo.setColor = ViewLayer::Copper0Color;
+			loadInfo.findNonConnectors = loadInfo.parsePaths = true;
+			break;
+		case ViewLayer::Copper1:
+			modelPartShared->connectorIDs(viewID, viewLayerID, loadInfo.connectorIDs, loadInfo.terminalIDs, loadInfo.legIDs);
+			loadInfo.setColor = ViewLayer::Copper1Color;
+			loadInfo.findNonConnectors = loadInfo.parsePaths = true;
+			break;
+		case ViewLayer::Silkscreen1:
+			loadInfo.setColor = ViewLayer::Silkscreen1Color;
+			break;
+		case ViewLayer::Silkscreen0:
+			loadInfo.setColor = ViewLayer::Silkscreen0Color;
+			break;
+		default:
+			break;
+		}
+		break;
+	case ViewLayer::BreadboardView:
+		modelPartShared->connectorIDs(viewID, viewLayerID, loadInfo.connectorIDs, loadInfo.terminalIDs, loadInfo.legIDs);
+		break;
+	default:
+		// don't need connectorIDs() for schematic view since these parts do not have bendable legs or connectors with drill holes
+		break;
+	}
+}
+
 void ItemBase::updateConnectionsAux(bool includeRatsnest, QList<ConnectorItem *> & already) {
 	//DebugDialog::debug("update connections");
 	Q_FOREACH (ConnectorItem * connectorItem, cachedConnectorItems()) {
@@ -2048,10 +2123,12 @@ FSvgRenderer * ItemBase::fsvgRenderer() const {
 void ItemBase::setSharedRendererEx(FSvgRenderer * newRenderer) {
 	if (newRenderer != m_fsvgRenderer) {
 		setSharedRenderer(newRenderer);  // original renderer is deleted if it is not shared
-		if (m_fsvgRenderer != nullptr) delete m_fsvgRenderer;
+		if (m_fsvgRenderer != nullptr) FSvgRenderer::releaseRenderer(m_fsvgRenderer);
 		m_fsvgRenderer = newRenderer;
 	}
 	else {
+		// already holding a reference to a pooled renderer, so drop the one that came with it
+		if (newRenderer->isShared()) FSvgRenderer::releaseRenderer(newRenderer);
 		update();
 	}
 	m_size = newRenderer->defaultSizeF();
@@ -2062,12 +2139,32 @@ bool ItemBase::reloadRenderer(const QString & svg, bool fastLoad) {
 	if (!svg.isEmpty()) {
 		//DebugDialog::debug(svg);
 		prepareGeometryChange();
-		bool result = fastLoad ? fsvgRenderer()->fastLoad(svg.toUtf8()) : fsvgRenderer()->loadSvgString(svg.toUtf8());
-		if (result) {
-			update();
+		FSvgRenderer * current = fsvgRenderer();
+		QByteArray contents = svg.toUtf8();
+		// items of one kind that generate the same variant (resistors of one value, say) draw with one renderer
+		QByteArray key = current->variantKey(contents, fastLoad);
+		QByteArray loaded;
+		FSvgRenderer * renderer = FSvgRenderer::sharedRenderer(key, loaded);
+		if (renderer == current) {
+			FSvgRenderer::releaseRenderer(renderer);
+			return true;
+		}
+
+		if (renderer == nullptr) {
+			renderer = current->unsharedCopy();
+			bool result = fastLoad ? renderer->fastLoad(contents) : renderer->loadSvgString(svg);
+			if (!result) {
+				delete renderer;
+				return false;
+			}
+			FSvgRenderer::shareRenderer(key, renderer, contents);
 		}
 
-		return result;
+		setSharedRenderer(renderer);
+		FSvgRenderer::releaseRenderer(m_fsvgRenderer);
+		m_fsvgRenderer = renderer;
+		update();
+		return true;
 	}
 
 	return false;
@@ -2098,6 +2195,27 @@ bool ItemBase::resetRenderer(const QString & svg, QString & newSvg) {
 	return result;
 }
 
+bool ItemBase::resetSharedRenderer(const QString & svg) {
+	// for generated svgs that many items repeat, like a board's stitching vias: equal svgs draw with one pooled renderer,
+	// so the renderer must be left as loaded
+	QByteArray contents = svg.toUtf8();
+	QByteArray key = FSvgRenderer::shareKey(contents, LoadInfo("", true));
+	QByteArray loaded;
+	FSvgRenderer * renderer = FSvgRenderer::sharedRenderer(key, loaded);
+	if (renderer == nullptr) {
+		renderer = new FSvgRenderer();
+		loaded = renderer->loadSvg(contents, "", true);
+		if (loaded.isEmpty()) {
+			delete renderer;
+			return false;
+		}
+		FSvgRenderer::shareRenderer(key, renderer, loaded);
+	}
+
+	setSharedRendererEx(renderer);
+	return true;
+}
+
 void ItemBase::getPixmaps(QPixmap * & pixmap1, QPixmap * & pixmap2, QPixmap * & pixmap3, bool swappingEnabled, QSize size)
 {
 	pixmap1 = getPixmap(ViewLayer::BreadboardView, swappingEnabled, size);
@@ -2408,11 +2526,15 @@ void ItemBase::setInspectorTitle(const QString & oldText, const QString & newTex
 }
 
 void ItemBase::addSimulationGraphicsItem(QGraphicsObject * item) {
-	if (m_simItem)
+	if (m_simItem && m_simItem != item)
 		delete m_simItem;
 	m_simItem = item;
 }
 
+QGraphicsObject * ItemBase::simulationGraphicsItem() const {
+	return m_simItem;
+}
+
 void ItemBase::removeSimulationGraphicsItem() {
 	if (m_simItem) {
 		delete m_simItem;
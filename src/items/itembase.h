@@ -234,6 +234,7 @@ public:
 	bool reloadRenderer(const QString & svg, bool fastload);
 	bool resetRenderer(const QString & svg);
 	bool resetRenderer(const QString & svg, QString & newSvg);
+	bool resetSharedRenderer(const QString & svg);
 	void getPixmaps(QPixmap * &, QPixmap * &, QPixmap * &, bool swappingEnabled, QSize);
 	FSvgRenderer * setUpImage(ModelPart * modelPart, LayerAttributes &);
 	void showConnectors(const QStringList &);
@@ -254,6 +255,7 @@ public:
 	virtual QString getInspectorTitle();
 	virtual void setInspectorTitle(const QString & oldText, const QString & newText);
 	void addSimulationGraphicsItem(QGraphicsObject *);
+	QGraphicsObject * simulationGraphicsItem() const;
 	void removeSimulationGraphicsItem();
 
 public:
@@ -330,6 +332,9 @@ public:
 	static bool zLessThan(ItemBase * & p1, ItemBase * & p2);
 	static qint64 getNextID();
 	static qint64 getNextID(qint64 fromIndex);
+	static void initLoadInfo(class ModelPartShared *, ViewLayer::ViewID, ViewLayer::ViewLayerID, struct LoadInfo &);
+	static void holdConnectionUpdates(bool hold);
+	static bool connectionUpdatesHeld();
 
 protected:
 	void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
@@ -338,6 +343,7 @@ protected:
 	virtual void paintHover(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget, const QPainterPath & shape);
 	virtual void paintSelected(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 	virtual void paintBody(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+	void paintOutline(QPainter *painter);
 
 	QVariant itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant & value);
 
@@ -402,6 +408,7 @@ protected:
 protected:
 	static long nextID;
 	static QPointer<ReferenceModel> TheReferenceModel;
+	static int ConnectionUpdatesHeld;
 
 public:
 	static const QString ITEMBASE_FONT_PREFIX;
@@ -413,6 +420,18 @@ public:
 	const static double HoverOpacity;
 	const static QColor ConnectorHoverColor;
 	const static double ConnectorHoverOpacity;
+	const static QColor OutlineColor;
+
+public:
+	enum DetailLevel {
+		FullDetail,
+		NoSmallDetail,			// connectors and part labels are left out
+		OutlineOnly				// parts are drawn as outlines, wires without shadows or bands
+	};
+
+	static DetailLevel detailLevel(const QPainter *, const QWidget *);
+	static double SmallDetailZoom;
+	static double OutlineZoom;
 
 public:
 	static void initNames();
@@ -29,6 +29,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "moduleidnames.h"
 #include "../svg/groundplanegenerator.h"
 #include "../utils/cursormaster.h"
+#include "../utils/fileprogressdialog.h"
+#include "../processeventblocker.h"
 #include "../debugdialog.h"
 
 #include <QHBoxLayout>
@@ -44,6 +46,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QColor>
 #include <QColorDialog>
 #include <QBuffer>
+#include <QElapsedTimer>
+#include <QScopedPointer>
 
 static QStringList LogoImageNames;
 static QStringList Logo0ImageNames;
@@ -366,8 +370,7 @@ void LogoItem::loadImage(const QString & fileName, bool addName)
 			return;
 		}
 
-		TextUtils::fixMuch(svg, true);
-		TextUtils::fixPixelDimensionsIn(svg);
+		TextUtils::fixSvg(svg, TextUtils::FixMuch | TextUtils::FixStrokeWidth | TextUtils::FixPixelDimensions);
 
 		QString errorStr;
 		int errorLine;
@@ -435,7 +438,8 @@ void LogoItem::loadImage(const QString & fileName, bool addName)
 			GroundPlaneGenerator gpg;
 			gpg.setLayerName(layerName());
 			gpg.setMinRunSize(1, 1);
-			gpg.scanImage(image, image.width(), image.height(), 1, res, colorString(), false, false, QSizeF(0, 0), 0, QPointF(0, 0));
+			if (!traceImage(gpg, image, res)) return;
+
 			if (gpg.newSVGs().count() < 1) {
 				FMessageBox::information(
 				    nullptr,
@@ -487,6 +491,32 @@ void LogoItem::loadImage(const QString & fileName, bool addName)
 	reloadImage(svg, QSizeF(0, 0), fileName, addName);
 }
 
+bool LogoItem::traceImage(GroundPlaneGenerator & gpg, const QImage & image, double res)
+{
+	// the trace runs on the thread pool; a progress dialog comes up if it takes a while. Points
+	// within half a pixel of the staircase outline are dropped, which mostly leaves the corners
+	QFuture<void> future = gpg.startTrace(image, res, colorString(), 0.5);
+	QElapsedTimer timer;
+	timer.start();
+	QScopedPointer<FileProgressDialog> progress;
+	while (!future.isFinished()) {
+		ProcessEventBlocker::processEvents(100);
+		if (progress.isNull() && timer.elapsed() > 500) {
+			progress.reset(new FileProgressDialog(tr("Tracing image..."), future.progressMaximum(), nullptr));
+			progress->addCancelButton();
+			connect(progress.data(), &FileProgressDialog::cancel, [&future]() { future.cancel(); });
+		}
+		if (!progress.isNull()) {
+			progress->setValue(future.progressValue());
+		}
+	}
+	future.waitForFinished();
+	if (future.isCanceled()) return false;
+
+	gpg.finishTrace();
+	return true;
+}
+
 bool LogoItem::resizeMM(double mmW, double mmH, const LayerHash & viewLayers)
 {
 	Q_UNUSED(viewLayers);
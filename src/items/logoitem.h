@@ -69,6 +69,7 @@ protected:
 	virtual QString hackSvg(const QString & svg, const QString & logo);
 	void initImage();
 	void prepLoadImageAux(const QString & fileName, bool addName);
+	bool traceImage(class GroundPlaneGenerator &, const QImage &, double res);
 	virtual ViewLayer::ViewLayerID layer();
 	virtual QString colorString();
 	virtual QString layerName();
@@ -29,6 +29,11 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../connectors/connectoritem.h"
 #include "../connectors/connector.h"
 #include "../connectors/svgidlayer.h"
+#include "../connectors/connectorshared.h"
+#include "../connectors/busshared.h"
+#include "../model/modelpart.h"
+#include "moduleidnames.h"
+#include "propertydef.h"
 #include "../items/dip.h"
 #include "../items/mysterypart.h"
 #include "../layerattributes.h"
@@ -289,6 +294,8 @@ void PaletteItem::rotateItem(double degrees, bool includeRatsnest) {
 		m_layerKin[i]->rotateItem(degrees, includeRatsnest);
 	}
 
+	if (connectionUpdatesHeld()) return;
+
 	QList<ConnectorItem *> already;
 	updateConnections(true, already);
 }
@@ -491,6 +498,165 @@ void PaletteItem::resetKinImage(ItemBase * layerKin, InfoGraphicsView * infoGrap
 	qobject_cast<PaletteItemBase *>(layerKin)->setUpImage(modelPart(), infoGraphicsView->viewLayers(), layerAttributes);
 }
 
+ConnectorItem* PaletteItem::newConnectorItem(Connector *connector) {
+	if (m_reuseConnectorItems) {
+		return connector->connectorItemByViewLayerID(viewID(), viewLayerID());
+	}
+
+	return PaletteItemBase::newConnectorItem(connector);
+}
+
+ConnectorItem* PaletteItem::newConnectorItem(ItemBase * layerKin, Connector *connector) {
+	if (m_reuseConnectorItems) {
+		return connector->connectorItemByViewLayerID(viewID(), layerKin->viewLayerID());
+	}
+
+	return PaletteItemBase::newConnectorItem(layerKin, connector);
+}
+
+bool PaletteItem::canSwapInPlace(ModelPart * modelPart, ModelPart * newModelPart)
+{
+	// an in-place swap keeps the items, connector items and connections, so it only works
+	// when the new part would be built the same way and has the same connectors on the same layers
+
+	if (modelPart == nullptr || newModelPart == nullptr) return false;
+	if (modelPart->modelPartShared() == nullptr || newModelPart->modelPartShared() == nullptr) return false;
+	if (modelPart->modelPartShared() == newModelPart->modelPartShared()) return false;
+	if (modelPart->itemType() != ModelPart::Part || newModelPart->itemType() != ModelPart::Part) return false;
+	if (modelPart->flippedSMD() != newModelPart->flippedSMD()) return false;
+
+	// anything the part factory turns into a PaletteItem subclass gets the full swap
+	QString moduleID = newModelPart->moduleID();
+	if (moduleID.endsWith(ModuleIDNames::ModuleIDNameSuffix)) return false;
+	if (PropertyDefMaster::partPropertiesCanBeModified(moduleID)) return false;
+	QString family = newModelPart->properties().value("family", "");
+	Q_FOREACH (QString special, QStringList() << "mystery part" << "screw terminal" << "pin header" << "generic IC") {
+		if (family.compare(special, Qt::CaseInsensitive) == 0) return false;
+	}
+
+	// the full swap replaces these local values with the new part's
+	for (auto&& propertyName : {ModelPartShared::MNPropertyName, ModelPartShared::MPNPropertyName, ModelPartShared::PartNumberPropertyName}) {
+		if (!modelPart->localProp(propertyName).toString().isEmpty()) return false;
+	}
+
+	QList<ViewLayer::ViewID> viewIDs;
+	viewIDs << ViewLayer::BreadboardView << ViewLayer::SchematicView << ViewLayer::PCBView;
+	Q_FOREACH (ViewLayer::ViewID viewID, viewIDs) {
+		if (modelPart->viewLayers(viewID) != newModelPart->viewLayers(viewID)) return false;
+
+		ItemBase * itemBase = modelPart->viewItem(viewID);
+		if (itemBase == nullptr) continue;
+		if (itemBase->layerKinChief()->metaObject() != &PaletteItem::staticMetaObject) return false;
+		if (itemBase->layerKinChief()->hasRubberBandLeg()) return false;
+	}
+
+	ModelPartShared * newModelPartShared = newModelPart->modelPartShared();
+	newModelPartShared->initConnectors();
+	if (newModelPartShared->connectorsShared().count() != modelPart->connectors().count()) return false;
+
+	Q_FOREACH (Connector * connector, modelPart->connectors()) {
+		if (connector == nullptr) return false;
+
+		ConnectorShared * connectorShared = connector->connectorShared();
+		ConnectorShared * newConnectorShared = newModelPartShared->getConnectorShared(connector->connectorSharedID());
+		if (connectorShared == nullptr || newConnectorShared == nullptr) return false;
+		if (connectorShared->connectorType() != newConnectorShared->connectorType()) return false;
+
+		BusShared * busShared = connectorShared->bus();
+		BusShared * newBusShared = newConnectorShared->bus();
+		if ((busShared == nullptr) != (newBusShared == nullptr)) return false;
+		if (busShared != nullptr && busShared->id() != newBusShared->id()) return false;
+
+		Q_FOREACH (ViewLayer::ViewID viewID, viewIDs) {
+			Q_FOREACH (ViewLayer::ViewLayerID viewLayerID, modelPart->viewLayers(viewID)) {
+				SvgIdLayer * svgIdLayer = connectorShared->fullPinInfo(viewID, viewLayerID);
+				SvgIdLayer * newSvgIdLayer = newConnectorShared->fullPinInfo(viewID, viewLayerID);
+				if ((svgIdLayer == nullptr) != (newSvgIdLayer == nullptr)) return false;
+				if (newSvgIdLayer != nullptr && !newSvgIdLayer->m_legId.isEmpty()) return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool PaletteItem::swapInPlace(ModelPart * modelPart, ModelPartShared * newModelPartShared)
+{
+	// points the model part at new shared data and reloads the images of every view item,
+	// reusing the connector items; returns false if any connector ended up somewhere else,
+	// in which case the caller is expected to swap back
+
+	static const double SameGeometry = 0.001;		// pixels
+
+	QList<PaletteItem *> paletteItems;
+	QList<ViewLayer::ViewID> viewIDs;
+	viewIDs << ViewLayer::BreadboardView << ViewLayer::SchematicView << ViewLayer::PCBView;
+	Q_FOREACH (ViewLayer::ViewID viewID, viewIDs) {
+		ItemBase * itemBase = modelPart->viewItem(viewID);
+		if (itemBase == nullptr) continue;
+
+		auto * paletteItem = qobject_cast<PaletteItem *>(itemBase->layerKinChief());
+		if (paletteItem == nullptr) continue;
+		if (InfoGraphicsView::getInfoGraphicsView(paletteItem) == nullptr) continue;
+
+		paletteItems.append(paletteItem);
+	}
+
+	QHash<ConnectorItem *, QPair<QRectF, QPointF> > geometry;
+	Q_FOREACH (PaletteItem * paletteItem, paletteItems) {
+		QList<ItemBase *> itemBases;
+		itemBases << paletteItem << paletteItem->layerKin();
+		Q_FOREACH (ItemBase * itemBase, itemBases) {
+			Q_FOREACH (ConnectorItem * connectorItem, itemBase->cachedConnectorItems()) {
+				geometry.insert(connectorItem, QPair<QRectF, QPointF>(connectorItem->rect(), connectorItem->terminalPoint()));
+			}
+
+			// non-connectors are not reused, so clear them before they are set up again
+			Q_FOREACH (QGraphicsItem * childItem, itemBase->childItems()) {
+				if (dynamic_cast<NonConnectorItem *>(childItem) == nullptr) continue;
+				if (dynamic_cast<ConnectorItem *>(childItem) != nullptr) continue;
+
+				delete childItem;
+			}
+		}
+	}
+
+	modelPart->swapModelPartShared(newModelPartShared);
+
+	bool same = true;
+	Q_FOREACH (PaletteItem * paletteItem, paletteItems) {
+		paletteItem->m_reuseConnectorItems = true;
+		paletteItem->resetImage(InfoGraphicsView::getInfoGraphicsView(paletteItem));
+		paletteItem->m_reuseConnectorItems = false;
+
+		QList<ItemBase *> itemBases;
+		itemBases << paletteItem << paletteItem->layerKin();
+		Q_FOREACH (ItemBase * itemBase, itemBases) {
+			Q_FOREACH (ConnectorItem * connectorItem, itemBase->cachedConnectorItems()) {
+				if (!geometry.contains(connectorItem)) {
+					same = false;
+					continue;
+				}
+
+				QPair<QRectF, QPointF> before = geometry.take(connectorItem);
+				QRectF r = connectorItem->rect();
+				QPointF d = before.second - connectorItem->terminalPoint();
+				if (qAbs(before.first.left() - r.left()) > SameGeometry || qAbs(before.first.top() - r.top()) > SameGeometry ||
+				    qAbs(before.first.width() - r.width()) > SameGeometry || qAbs(before.first.height() - r.height()) > SameGeometry ||
+				    qAbs(d.x()) > SameGeometry || qAbs(d.y()) > SameGeometry)
+				{
+					same = false;
+				}
+			}
+		}
+
+		if (paletteItem->m_partLabel != nullptr) paletteItem->m_partLabel->displayTextsIf();
+		paletteItem->update();
+	}
+
+	return same && geometry.isEmpty();
+}
+
 QString PaletteItem::genFZP(const QString & moduleid, const QString & templateName, int minPins, int maxPins, int steps, bool smd)
 {
 	QString FzpTemplate = "";
@@ -1381,7 +1547,7 @@ void PaletteItem::generateSwapFzpSvg(QString newModuleID, GenFzp genFzp, GenSvg
 	QString path;
 	if (!PartFactory::fzpFileExists(newModuleID, path)) {
 		QString fzp = genFzp(newModuleID);
-		TextUtils::writeUtf8(path, fzp);
+		PartFactory::writeGenerated(path, fzp);
 
 		QDomDocument doc;
 		doc.setContent(fzp);
@@ -1399,19 +1565,19 @@ void PaletteItem::generateSwapFzpSvg(QString newModuleID, GenFzp genFzp, GenSvg
 		QString name = viewNames.value("breadboardView", "");
 		if (!PartFactory::svgFileExists(name, path)) {
 			QString svg = makeBreadboardSvg(name);
-			TextUtils::writeUtf8(path, svg);
+			PartFactory::writeGenerated(path, svg);
 		}
 
 		name = viewNames.value("schematicView", "");
 		if (!PartFactory::svgFileExists(name, path)) {
 			QString svg = makeSchematicSvg(name);
-			TextUtils::writeUtf8(path, svg);
+			PartFactory::writeGenerated(path, svg);
 		}
 
 		name = viewNames.value("pcbView", "");
 		if (!PartFactory::svgFileExists(name, path)) {
 			QString svg = makePcbSvg(name);
-			TextUtils::writeUtf8(path, svg);
+			PartFactory::writeGenerated(path, svg);
 		}
 	}
 }
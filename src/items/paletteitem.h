@@ -116,6 +116,8 @@ public:
 	void resetLayerKin(const QString & svg);
 	QTransform untransform();
 	void retransform(const QTransform &);
+	ConnectorItem* newConnectorItem(class Connector *connector);
+	ConnectorItem* newConnectorItem(ItemBase * layerkin, Connector *connector);
 
 public:
 	static QString genFZP(const QString & moduleid, const QString & templateName, int minPins, int maxPins, int steps, bool smd);
@@ -131,6 +133,8 @@ public:
 	static bool changeThickness(HoleSettings & holeSettings, QObject * sender);
 	static QList<Connector *> sortConnectors(ModelPart * modelPart);
 	static bool isSingleRow(const QList<ConnectorItem *> & connectorItems);
+	static bool canSwapInPlace(ModelPart * modelPart, ModelPart * newModelPart);
+	static bool swapInPlace(ModelPart * modelPart, class ModelPartShared * newModelPartShared);
 
 Q_SIGNALS:
 	void pinLabelSwap(ItemBase *, const QString & moduleID);
@@ -178,6 +182,7 @@ protected:
 	QList<class ItemBase *> m_layerKin;
 	HoleSettings m_holeSettings;
 	int m_flipCount;
+	bool m_reuseConnectorItems = false;		// set while swapping in place
 
 };
 
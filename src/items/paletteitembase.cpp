@@ -143,6 +143,8 @@ bool PaletteItemBase::itemMoved() {
 
 void PaletteItemBase::moveItem(ViewGeometry & viewGeometry) {
 	this->setPos(viewGeometry.loc());
+	if (connectionUpdatesHeld()) return;
+
 	QList<ConnectorItem *> already;
 	updateConnections(false, already);
 }
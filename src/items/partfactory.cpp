@@ -55,10 +55,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 #include "../utils/graphicsutils.h"
 #include "../svg/svgtext.h"
+#include "../version/version.h"
 
+#include <QCryptographicHash>
+#include <QSaveFile>
 #include <qmath.h>
 
 static QString PartFactoryFolderPath;
+static QString PartCacheFolderPath;				// generated parts kept across sessions, one folder per build
 static QHash<QString, LockedFile *> LockedFiles;
 static QString SvgFilesDir = "svg";
 static QHash<QString, QPointF> SubpartOffsets;
@@ -427,8 +431,9 @@ bool PartFactory::svgFileExists(const QString & expectedFileName, QString & path
 	}
 
 	path = partPath() + expectedFileName;
-	QFileInfo info(path);
-	return info.exists();
+	if (QFileInfo(path).exists()) return true;
+
+	return cachedFileExists("/" + SvgFilesDir + "/core/" + expectedFileName, path);
 }
 
 QString PartFactory::getSvgFilenameAux(const QString & expectedFileName, GenSvg genSvg)
@@ -437,7 +442,7 @@ QString PartFactory::getSvgFilenameAux(const QString & expectedFileName, GenSvg
 	if (svgFileExists(expectedFileName, path)) return path;
 
 	QString svg = (*genSvg)(expectedFileName);
-	if (TextUtils::writeUtf8(path, svg)) {
+	if (writeGenerated(path, svg)) {
 		return path;
 	}
 
@@ -454,8 +459,29 @@ bool PartFactory::fzpFileExists(const QString & moduleID, QString & path) {
 	}
 
 	path = fzpPath() + expectedFileName;
-	QFileInfo info(path);
-	return info.exists();
+	if (QFileInfo(path).exists()) return true;
+
+	return cachedFileExists("/core/" + expectedFileName, path);
+}
+
+bool PartFactory::cachedFileExists(const QString & relativePath, QString & path)
+{
+	// a generated file depends only on its name and on the generator code, so the cache is keyed
+	// by build and filled once; otherwise path is left pointing into the session folder
+	if (PartCacheFolderPath.isEmpty()) return false;
+
+	path = PartCacheFolderPath + relativePath;
+	return QFileInfo(path).exists();
+}
+
+bool PartFactory::writeGenerated(const QString & path, const QString & text)
+{
+	// another Fritzing may be reading the same cached file, so it only ever appears whole
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) return false;
+
+	file.write(text.toUtf8());
+	return file.commit();
 }
 
 QString PartFactory::getFzpFilenameAux(const QString & moduleID, QString (*getFzp)(const QString &))
@@ -464,7 +490,7 @@ QString PartFactory::getFzpFilenameAux(const QString & moduleID, QString (*getFz
 	if (fzpFileExists(moduleID, path)) return path;
 
 	QString fzp = (*getFzp)(moduleID);
-	if (TextUtils::writeUtf8(path, fzp)) {
+	if (writeGenerated(path, fzp)) {
 		return path;
 	}
 
@@ -525,6 +551,56 @@ void PartFactory::initFolder()
 	LockManager::checkLockedFiles("partfactory", backupList, LockedFiles, true, LockManager::SlowTime);
 	FolderUtils::makePartFolderHierarchy(PartFactoryFolderPath, "core");
 	FolderUtils::makePartFolderHierarchy(PartFactoryFolderPath, "contrib");
+
+	// outside the "partfactory" folder, whose unlocked subfolders are cleaned up as stale
+	QByteArray build = (Version::versionString() + " " + Version::gitVersion()).toUtf8();
+	QString relative = QString("partcache/%1").arg(QString(QCryptographicHash::hash(build, QCryptographicHash::Sha1).toHex().left(16)));
+	QDir dir(FolderUtils::getTopLevelUserDataStorePath());
+	if (dir.mkpath(relative)) {
+		PartCacheFolderPath = dir.absoluteFilePath(relative);
+		FolderUtils::makePartFolderHierarchy(PartCacheFolderPath, "core");
+	}
+}
+
+int PartFactory::pregenerate()
+{
+	// generates the common sizes of the generated parts, fzp and svgs, into the cache
+	QStringList moduleIDs;
+	for (int pins = 1; pins <= 40; pins++) {
+		moduleIDs << QString("generic_female_pin_header_%1_100mil").arg(pins);
+		moduleIDs << QString("generic_male_pin_header_%1_100mil").arg(pins);
+		moduleIDs << QString("mystery_part_sip_%1_100mil").arg(pins);
+	}
+	for (int pins = 4; pins <= 40; pins += 2) {
+		moduleIDs << QString("generic_ic_dip_%1_300mil").arg(pins);
+		moduleIDs << QString("mystery_part_dip_%1_300mil").arg(pins);
+	}
+
+	int count = 0;
+	Q_FOREACH (QString moduleID, moduleIDs) {
+		QString path = getFzpFilename(moduleID);
+		if (path.isEmpty()) continue;
+
+		if (!QFileInfo(path).isAbsolute()) {
+			path = FolderUtils::getAppPartsSubFolderPath("") + "/core/" + path;
+		}
+		QFile file(path);
+		QDomDocument doc;
+		if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file)) continue;
+
+		count++;
+		QDomElement view = doc.documentElement().firstChildElement("views").firstChildElement();
+		while (!view.isNull()) {
+			QString image = view.firstChildElement("layers").attribute("image");
+			if (!image.isEmpty() && !image.startsWith("icon/")) {
+				getSvgFilename(image);
+			}
+			view = view.nextSiblingElement();
+		}
+	}
+
+	DebugDialog::debug(QString("pregenerated %1 parts in %2").arg(count).arg(PartCacheFolderPath));
+	return count;
 }
 
 void PartFactory::cleanup()
@@ -44,10 +44,13 @@ public:
 	static bool fzpFileExists(const QString & moduleID, QString & path);
 	static QString makeSchematicSipOrDipOr(const QStringList & labels, bool hasLayout, bool sip);
 	static QString getSvgFilename(const QString & filename);
+	static bool writeGenerated(const QString & path, const QString & text);
+	static int pregenerate();
 
 protected:
 	static QString getFzpFilenameAux(const QString & moduleID, GenFzp);
 	static QString getSvgFilenameAux(const QString & expectedFileName, GenSvg);
+	static bool cachedFileExists(const QString & relativePath, QString & path);
 	static class ItemBase * createPartAux(class ModelPart *, ViewLayer::ViewID, const class ViewGeometry & viewGeometry, long id, QMenu * itemMenu, QMenu * wireMenu, bool doLabel);
 	static QDomElement showSubpart(QDomElement & root, const QString & subpart);
 	static void fixSubpartBounds(QDomElement &, ModelPartShared *);
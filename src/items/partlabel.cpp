@@ -24,7 +24,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../model/modelpart.h"
 #include "../utils/graphicsutils.h"
 #include "../utils/textutils.h"
+#include "../utils/glyphcache.h"
 #include "../installedfonts.h"
+#include "../fsvgrenderer.h"
 
 #include <QGraphicsScene>
 #include <QMenu>
@@ -32,7 +34,6 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QInputDialog>
 #include <QStringList>
 #include <QFont>
-#include <QSvgRenderer>
 
 // TODO:
 //		** selection: coordinate with part selection: it's a layerkin
@@ -129,6 +130,7 @@ PartLabel::~PartLabel()
 	if (m_owner != nullptr) {
 		m_owner->clearPartLabel();
 	}
+	FSvgRenderer::releaseRenderer(m_renderer);
 }
 
 void PartLabel::showLabel(bool showIt, ViewLayer * viewLayer) {
@@ -764,6 +766,7 @@ void PartLabel::partLabelEdit()
 void PartLabel::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
 	if (m_hidden) return;
+	if (ItemBase::detailLevel(painter, widget) != ItemBase::FullDetail) return;
 
 	if (m_inactive) {
 		painter->save();
@@ -774,7 +777,13 @@ void PartLabel::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
 		GraphicsUtils::qt_graphicsItem_highlightSelected(painter, option, boundingRect(), shape());
 	}
 
-	QGraphicsSvgItem::paint(painter, option, widget);
+	if (widget != nullptr && m_renderer != nullptr) {
+		// on screen, labels are drawn from rasters shared by every label with the same text and font
+		if (m_renderer->isValid()) m_renderer->renderCached(painter, boundingRect());
+	}
+	else {
+		QGraphicsSvgItem::paint(painter, option, widget);
+	}
 
 	if (m_inactive) {
 		painter->restore();
@@ -858,7 +867,7 @@ QString mapToSVGStyle(QFont::Style style) {
 
 QString PartLabel::makeSvg(bool blackOnly, double dpi, double printerScale, bool includeTransform) {
 	double w, h;
-	QString svg = makeSvgAux(blackOnly, dpi, printerScale, w, h);
+	QString svg = makeSvgAux(blackOnly, dpi, printerScale, false, w, h);
 	if (includeTransform) {
 		QTransform t = transform();
 		if (!t.isIdentity()) {
@@ -885,10 +894,13 @@ bool PartLabel::migrateLabelOffset()
 
 
 
-QString PartLabel::makeSvgAux(bool blackOnly, double dpi, double printerScale, double & w, double & h)
+QString PartLabel::makeSvgAux(bool blackOnly, double dpi, double printerScale, bool outlines, double & w, double & h)
 {
+	// with outlines, each line is drawn from cached glyph outlines rather than as <text>,
+	// so the renderer doesn't lay the text out again; exported svg keeps <text>
 	if (m_displayText.isEmpty()) return "";
 
+	InstalledFonts::registerFonts();
 	double pixels = m_font.pointSizeF() * printerScale / 72;
 	double y = pixels;
 
@@ -904,10 +916,22 @@ QString PartLabel::makeSvgAux(bool blackOnly, double dpi, double printerScale, d
 
 	w = 0;
 	QStringList texts = m_displayText.split("\n");
+	double fontSize = m_font.pointSizeF() * dpi / 72.0;
 	for (const QString& t : texts) {
-		QString t1 = TextUtils::convertExtendedChars(TextUtils::escapeAnd(t));
-		svg += QString("<text x='0' y='%1'>%2</text>")
-				.arg(QString::number(y * dpi / printerScale, 'f', 3), t1);
+		QPainterPath path;
+		if (outlines && GlyphCache::outline(m_font, fontSize, t, path)) {
+			svg += QString("<path transform='translate(0,%1)' d='%2'/>")
+					.arg(QString::number(y * dpi / printerScale, 'f', 3), GlyphCache::svgPathData(path));
+			double advance;
+			if (GlyphCache::advance(m_font, fontSize, t, advance)) {
+				w = qMax(w, advance * printerScale / dpi);
+			}
+		}
+		else {
+			QString t1 = TextUtils::convertExtendedChars(TextUtils::escapeAnd(t));
+			svg += QString("<text x='0' y='%1'>%2</text>")
+					.arg(QString::number(y * dpi / printerScale, 'f', 3), t1);
+		}
 		y += pixels;
 		w = qMax(w, t.length() * pixels * 0.75);
 		//DebugDialog::debug(QString("\t%1, %2").arg(w).arg(y));
@@ -939,18 +963,32 @@ void PartLabel::resetSvg()
 {
 
 	double w, h;
-	QString innerSvg = makeSvgAux(false, GraphicsUtils::StandardFritzingDPI, GraphicsUtils::SVGDPI, w, h);
+	QString innerSvg = makeSvgAux(false, GraphicsUtils::StandardFritzingDPI, GraphicsUtils::SVGDPI, true, w, h);
 	if (innerSvg.isEmpty()) return;
 
 	QString svg = TextUtils::makeSVGHeader(GraphicsUtils::SVGDPI, GraphicsUtils::StandardFritzingDPI, w, h) + innerSvg + "\n</svg>";
 
-	if (m_renderer == nullptr) {
-		m_renderer = new QSvgRenderer(this);
+	// identical labels (the same text in the same font) share one renderer
+	QByteArray contents = svg.toUtf8();
+	QByteArray key = FSvgRenderer::shareKey(contents, LoadInfo());
+	QByteArray loaded;
+	FSvgRenderer * renderer = FSvgRenderer::sharedRenderer(key, loaded);
+	if (renderer == nullptr) {
+		renderer = new FSvgRenderer();
+		if (!renderer->fastLoad(contents)) {
+			delete renderer;
+			return;
+		}
+		FSvgRenderer::shareRenderer(key, renderer, contents);
 	}
 
-	// using renderer()->load() doesn't seem to work, so keep a separate shared renderer as a workaround
-	bool loaded = m_renderer->load(svg.toUtf8());
-	if (loaded) {
-		setSharedRenderer(m_renderer);
+	if (renderer == m_renderer) {
+		FSvgRenderer::releaseRenderer(renderer);
+		return;
 	}
+
+	// using renderer()->load() doesn't seem to work, so keep a separate shared renderer as a workaround
+	setSharedRenderer(renderer);
+	FSvgRenderer::releaseRenderer(m_renderer);
+	m_renderer = renderer;
 }
@@ -91,7 +91,7 @@ protected:
 	void setHiddenOrInactive();
 	void partLabelHide();
 	void resetSvg();
-	QString makeSvgAux(bool blackOnly, double dpi, double printerScale, double & w, double & h);
+	QString makeSvgAux(bool blackOnly, double dpi, double printerScale, bool outlines, double & w, double & h);
 
 protected:
 	QPointer<ItemBase> m_owner;
@@ -118,7 +118,7 @@ protected:
 	QList<QAction *> m_displayActs;
 	QColor m_color;
 	QFont m_font;
-	QSvgRenderer * m_renderer = nullptr;
+	class FSvgRenderer * m_renderer = nullptr;			// from the shared renderer pool
 };
 
 #endif
@@ -28,6 +28,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../debugdialog.h"
 
 #include <qmath.h>
+#include <QCache>
 #include <QRegularExpressionValidator>
 
 static QStringList Resistances;
@@ -37,6 +38,10 @@ static QString OhmSymbol(QChar(0x03A9));
 static QString PlusMinusSymbol(QChar(0x0B1));
 static QHash<QString, QColor> Tolerances;
 
+// band-colored svgs by template and bands, so resistors of the same value share the svg and, through
+// the renderer pool, the renderer that draws it
+static QCache<QString, QString> BandedSvgs(256);
+
 // TODO
 //	save into parts bin
 //	other manifestations of "220"?
@@ -195,12 +200,16 @@ QString Resistor::makeSvg(const QString & resistance, ViewLayer::ViewLayerID vie
 	int multiplier = (temp == 0) ? 0 : log10(ohms / temp);
 
 	QString tolerance = prop("tolerance");
+	QString fn = (viewLayerID == ViewLayer::Breadboard) ? m_breadboardSvgFile : m_iconSvgFile;
+
+	QString key = QString("%1 %2 %3 %4 %5 %6").arg(fn).arg(firstband).arg(secondband).arg(thirdband).arg(multiplier).arg(tolerance);
+	QString * cached = BandedSvgs.object(key);
+	if (cached != nullptr) return *cached;
 
 	QString errorStr;
 	int errorLine;
 	int errorColumn;
 	QDomDocument domDocument;
-	QString fn = (viewLayerID == ViewLayer::Breadboard) ? m_breadboardSvgFile : m_iconSvgFile;
 	QFile file(fn);
 	if (!file.open(QIODevice::ReadOnly)) {
 		DebugDialog::debug(QString("Unable to open :%1").arg(fn));
@@ -212,7 +221,9 @@ QString Resistor::makeSvg(const QString & resistance, ViewLayer::ViewLayerID vie
 
 	QDomElement root = domDocument.documentElement();
 	setBands(root, firstband, secondband, thirdband, multiplier, tolerance);
-	return domDocument.toString();
+	QString svg = domDocument.toString();
+	BandedSvgs.insert(key, new QString(svg));
+	return svg;
 
 }
 
@@ -31,6 +31,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QCursor>
 #include <QBitmap>
+#include <QSet>
 
 
 //////////////////////////////////////////////////
@@ -560,15 +561,13 @@ void Stripboard::reinitBuses(bool triggerUndo)
 		}
 	}
 
-	QList<ConnectorItem *> visited;
+	QVector<bool> visited(m_strips.count(), false);
 	for (int iy = 0; iy < m_y; iy++) {
 		for (int ix = 0; ix < m_x; ix++) {
-			StripConnector * sc = getStripConnector(ix, iy);
-			if (visited.contains(sc->connectorItem)) continue;
+			if (visited.at((iy * m_x) + ix)) continue;
 
 			QList<ConnectorItem *> connected;
-			collectConnected(ix, iy, connected);
-			visited.append(connected);
+			collectConnected(ix, iy, connected, visited);
 			nextBus(connected);
 		}
 	}
@@ -587,28 +586,35 @@ void Stripboard::reinitBuses(bool triggerUndo)
 	update();
 }
 
-void Stripboard::collectConnected(int ix, int iy, QList<ConnectorItem *> & connected) {
-	StripConnector * sc = getStripConnector(ix, iy);
-	if (connected.contains(sc->connectorItem)) return;
+void Stripboard::collectConnected(int ix, int iy, QList<ConnectorItem *> & connected, QVector<bool> & visited) {
+	// flood fill across uncut strips, over the hole grid rather than the scene;
+	// a board with no cuts is one strip of m_x * m_y holes, too deep to recurse
+	QVector<int> stack;
+	stack.append((iy * m_x) + ix);
+	visited[stack.last()] = true;
+	while (!stack.isEmpty()) {
+		int index = stack.takeLast();
+		int x = index % m_x;
+		int y = index / m_x;
+		StripConnector * sc = m_strips.at(index);
+		if (sc->connectorItem != nullptr) connected << sc->connectorItem;
 
-	connected << sc->connectorItem;
+		QVector<int> next;
+		if ((sc->right != nullptr) && !sc->right->removed()) next << index + 1;
+		if ((sc->down != nullptr) && !sc->down->removed()) next << index + m_x;
 
-	if ((sc->right != nullptr) && !sc->right->removed()) {
-		collectConnected(ix + 1, iy, connected);
+		StripConnector * left = x > 0 ? m_strips.at(index - 1) : nullptr;
+		if ((left != nullptr) && (left->right != nullptr) && !left->right->removed()) next << index - 1;
 
-	}
-	if ((sc->down != nullptr) && !sc->down->removed()) {
-		collectConnected(ix, iy + 1, connected);
-	}
+		StripConnector * up = y > 0 ? m_strips.at(index - m_x) : nullptr;
+		if ((up != nullptr) && (up->down != nullptr) && !up->down->removed()) next << index - m_x;
 
-	StripConnector * left = ix > 0 ? getStripConnector(ix - 1, iy) : nullptr;
-	if ((left != nullptr) && (left->right != nullptr) && !left->right->removed()) {
-		collectConnected(ix - 1, iy, connected);
-	}
+		Q_FOREACH (int n, next) {
+			if (visited.at(n)) continue;
 
-	StripConnector * up = iy > 0 ? getStripConnector(ix, iy - 1) : nullptr;
-	if ((up != nullptr) && (up->down != nullptr) && !up->down->removed()) {
-		collectConnected(ix, iy - 1, connected);
+			visited[n] = true;
+			stack.append(n);
+		}
 	}
 }
 
@@ -627,18 +633,15 @@ void Stripboard::nextBus(QList<ConnectorItem *> & soFar)
 void Stripboard::setProp(const QString & prop, const QString & value)
 {
 	if (prop.compare("buses") == 0) {
-		QStringList removed = value.split(" ", Qt::SkipEmptyParts);
+		QSet<QString> removed;
+		Q_FOREACH (QString name, value.split(" ", Qt::SkipEmptyParts)) removed.insert(name);
 		Q_FOREACH (QGraphicsItem * item, childItems()) {
 			auto * stripbit = dynamic_cast<Stripbit *>(item);
 			if (stripbit == nullptr) continue;
 
 			QString removedString = stripbit->makeRemovedString();
 			removedString.chop(1);          // remove trailing space
-			bool remove = removed.contains(removedString);
-			stripbit->setRemoved(remove);
-			if (remove) {
-				removed.removeOne(removedString);
-			}
+			stripbit->setRemoved(removed.contains(removedString));
 		}
 
 		reinitBuses(false);
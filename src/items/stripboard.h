@@ -24,6 +24,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QRectF>
 #include <QPainterPath>
 #include <QGraphicsPathItem>
+#include <QVector>
 
 #include "perfboard.h"
 
@@ -96,7 +97,7 @@ protected:
 	QString getRowLabel();
 	QString getColumnLabel();
 	void makeInitialPath();
-	void collectConnected(int x, int y, QList<ConnectorItem *> & connected);
+	void collectConnected(int x, int y, QList<ConnectorItem *> & connected, QVector<bool> & visited);
 	StripConnector * getStripConnector(int x, int y);
 	void collectTo(QSet<ConnectorItem *> &);
 	void initStripLayouts();
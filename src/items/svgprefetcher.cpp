@@ -0,0 +1,196 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "svgprefetcher.h"
+#include "itembase.h"
+#include "partfactory.h"
+#include "../debugdialog.h"
+#include "../fsvgrenderer.h"
+#include "../model/modelpart.h"
+#include "../model/modelpartshared.h"
+#include "../svg/svgfilesplitter.h"
+
+#include <QFile>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent>
+
+struct SvgPrefetcher::Job {
+	QString filename;
+	Source source = RawSvg;
+	ViewLayer::ViewLayerID viewLayerID = ViewLayer::UnknownLayer;
+	LoadInfo loadInfo;
+
+	// set by the worker
+	QByteArray bytes;
+	QByteArray shareKey;
+	FSvgRenderer * renderer = nullptr;
+	QByteArray loaded;
+};
+
+QHash<QString, SvgPrefetcher::Prefetch> SvgPrefetcher::Prefetches;
+
+/////////////////////////////////////////////
+
+void SvgPrefetcher::prefetch(const QList<ModelPart *> & modelParts, ViewLayer::ViewID viewID, const QList<ViewLayer::ViewLayerID> & viewLayerIDs)
+{
+	// file names are resolved here on the gui thread, since resolving one may generate an svg;
+	// each distinct part and layer then becomes one job
+	QThread * guiThread = QThread::currentThread();
+	QSet<ModelPartShared *> already;
+	Q_FOREACH (ModelPart * modelPart, modelParts) {
+		if (modelPart->itemType() != ModelPart::Part) continue;
+
+		ModelPartShared * modelPartShared = modelPart->modelPartShared();
+		if (modelPartShared == nullptr || already.contains(modelPartShared)) continue;
+
+		already.insert(modelPartShared);
+		Q_FOREACH (ViewLayer::ViewLayerID viewLayerID, viewLayerIDs) {
+			if (!modelPart->hasViewFor(viewID, viewLayerID)) continue;
+
+			QString imageFilename = modelPartShared->imageFileName(viewID, viewLayerID);
+			if (imageFilename.isEmpty()) continue;
+
+			QString filename = PartFactory::getSvgFilename(modelPart, imageFilename, true, true);
+			if (filename.isEmpty()) continue;
+
+			QString key = jobKey(modelPartShared, filename, viewID, viewLayerID);
+			if (Prefetches.contains(key)) continue;
+
+			QSharedPointer<Job> job(new Job);
+			job->filename = filename;
+			job->source = source(modelPartShared, viewID, viewLayerID);
+			job->viewLayerID = viewLayerID;
+			ItemBase::initLoadInfo(modelPartShared, viewID, viewLayerID, job->loadInfo);
+			job->loadInfo.filename = filename;
+
+			Prefetch prefetch;
+			prefetch.job = job;
+			prefetch.future = QtConcurrent::run([job, guiThread]() {
+				run(job.data(), guiThread);
+			});
+			Prefetches.insert(key, prefetch);
+		}
+	}
+
+	if (Prefetches.count() > 0) {
+		DebugDialog::debug(QString("prefetching %1 svgs").arg(Prefetches.count()));
+	}
+}
+
+void SvgPrefetcher::run(Job * job, QThread * guiThread)
+{
+	// the same steps ItemBase::setUpImage takes, up to a loaded renderer with its connector
+	// geometry looked up, which is handed to the gui thread
+	job->bytes = read(job->filename, job->source, job->viewLayerID);
+	if (job->bytes.isEmpty()) return;
+
+	job->shareKey = FSvgRenderer::shareKey(job->bytes, job->loadInfo);
+	auto * renderer = new FSvgRenderer();
+	job->loaded = renderer->loadSvg(job->bytes, job->loadInfo);
+	if (job->loaded.isEmpty()) {
+		delete renderer;
+		return;
+	}
+
+	renderer->prepareElements(job->loadInfo);
+	renderer->moveToThread(guiThread);
+	job->renderer = renderer;
+}
+
+QByteArray SvgPrefetcher::bytes(ModelPartShared * modelPartShared, const QString & filename, ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID)
+{
+	// waits for a prefetch of this file and layer, otherwise reads it here
+	auto it = Prefetches.find(jobKey(modelPartShared, filename, viewID, viewLayerID));
+	if (it != Prefetches.end()) {
+		it->future.waitForFinished();
+		return it->job->bytes;
+	}
+
+	return read(filename, source(modelPartShared, viewID, viewLayerID), viewLayerID);
+}
+
+FSvgRenderer * SvgPrefetcher::takeRenderer(ModelPartShared * modelPartShared, const QString & filename, ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID, const QByteArray & shareKey, QByteArray & loaded)
+{
+	// the caller owns the renderer; it is only handed out once, later items find it in the shared pool
+	auto it = Prefetches.find(jobKey(modelPartShared, filename, viewID, viewLayerID));
+	if (it == Prefetches.end()) return nullptr;
+
+	it->future.waitForFinished();
+	Job * job = it->job.data();
+	if (job->renderer == nullptr || job->shareKey != shareKey) return nullptr;
+
+	FSvgRenderer * renderer = job->renderer;
+	job->renderer = nullptr;
+	loaded = job->loaded;
+	return renderer;
+}
+
+void SvgPrefetcher::finish()
+{
+	// renderers no item asked for are dropped
+	for (auto it = Prefetches.begin(); it != Prefetches.end(); ++it) {
+		it->future.waitForFinished();
+		delete it->job->renderer;
+		it->job->renderer = nullptr;
+	}
+	Prefetches.clear();
+}
+
+SvgPrefetcher::Source SvgPrefetcher::source(ModelPartShared * modelPartShared, ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID)
+{
+	if (viewLayerID == ViewLayer::Schematic) return HideTextSvg;
+	if (viewLayerID == ViewLayer::SchematicText) return ShowTextSvg;
+	if ((viewID != ViewLayer::IconView) && modelPartShared->hasMultipleLayers(viewID)) return SplitSvg;
+	return RawSvg;
+}
+
+QByteArray SvgPrefetcher::read(const QString & filename, Source source, ViewLayer::ViewLayerID viewLayerID)
+{
+	// an empty result for ShowTextSvg means there is no text to show
+	switch (source) {
+	case HideTextSvg:
+		return SvgFileSplitter::hideText(filename);
+	case ShowTextSvg: {
+		bool hasText = false;
+		QByteArray bytes = SvgFileSplitter::showText(filename, hasText);
+		if (!hasText) return QByteArray();
+		return bytes;
+	}
+	case SplitSvg: {
+		// need to treat create "virtual" svg file for each layer
+		SvgFileSplitter svgFileSplitter;
+		if (svgFileSplitter.split(filename, ViewLayer::viewLayerXmlNameFromID(viewLayerID))) {
+			return svgFileSplitter.byteArray();
+		}
+		return QByteArray();
+	}
+	default: {
+		QFile file(filename);
+		file.open(QFile::ReadOnly);
+		return file.readAll();
+	}
+	}
+}
+
+QString SvgPrefetcher::jobKey(ModelPartShared * modelPartShared, const QString & filename, ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID)
+{
+	// the load info depends on the part's connectors as well as on the view and layer
+	return QString("%1\n%2\n%3\n%4").arg(modelPartShared->moduleID(), filename).arg(viewID).arg(viewLayerID);
+}
@@ -0,0 +1,69 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef SVGPREFETCHER_H
+#define SVGPREFETCHER_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+#include "../viewlayer.h"
+
+class SvgPrefetcher
+{
+	// reads and cooks the distinct svgs of a sketch's parts on the thread pool while the gui thread
+	// creates their items; an item waits only for the svg it needs, and takes a ready renderer when
+	// its bytes came out the same as the prefetched ones
+
+public:
+	enum Source {
+		RawSvg,
+		SplitSvg,                       // one layer split out of a multi-layer svg
+		HideTextSvg,
+		ShowTextSvg
+	};
+
+public:
+	static void prefetch(const QList<class ModelPart *> &, ViewLayer::ViewID, const QList<ViewLayer::ViewLayerID> &);
+	static QByteArray bytes(class ModelPartShared *, const QString & filename, ViewLayer::ViewID, ViewLayer::ViewLayerID);
+	static class FSvgRenderer * takeRenderer(class ModelPartShared *, const QString & filename, ViewLayer::ViewID, ViewLayer::ViewLayerID, const QByteArray & shareKey, QByteArray & loaded);
+	static void finish();
+	static Source source(class ModelPartShared *, ViewLayer::ViewID, ViewLayer::ViewLayerID);
+	static QByteArray read(const QString & filename, Source, ViewLayer::ViewLayerID);
+
+protected:
+	struct Job;
+
+	struct Prefetch {
+		QSharedPointer<Job> job;
+		QFuture<void> future;
+	};
+
+	static QString jobKey(class ModelPartShared *, const QString & filename, ViewLayer::ViewID, ViewLayer::ViewLayerID);
+	static void run(Job *, class QThread * guiThread);
+
+protected:
+	static QHash<QString, Prefetch> Prefetches;
+};
+
+#endif
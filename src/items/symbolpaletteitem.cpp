@@ -22,6 +22,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../debugdialog.h"
 #include "../connectors/connectoritem.h"
 #include "../connectors/bus.h"
+#include "../connectors/connectivityindex.h"
 #include "moduleidnames.h"
 #include "../fsvgrenderer.h"
 #include "../utils/textutils.h"
@@ -34,17 +35,64 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../svg/svgfilesplitter.h"
 
 #include <QLineEdit>
-#include <QMultiHash>
+#include <QHash>
 #include <QMessageBox>
 
 #include <cmath>
+#include <limits>
 
 #define VOLTAGE_HASH_CONVERSION 1000000
 #define FROMVOLTAGE(v) ((long) (v * VOLTAGE_HASH_CONVERSION))
 
-static QMultiHash<long, QPointer<ConnectorItem> > LocalVoltages;			// Qt doesn't do Hash keys with double
-static QMultiHash<QString, QPointer<ConnectorItem> > LocalNetLabels;
-static QList< QPointer<ConnectorItem> > LocalGrounds;
+template <class Key> class SymbolBus
+{
+	// the connectors of one kind of symbol, by the name that puts them on one bus; each connector
+	// remembers its name, so taking one out doesn't look through every name. Any change joins or
+	// splits nets without a connection changing, so the scene's connectivity index is told
+
+public:
+	void insert(const Key & key, ConnectorItem * connectorItem) {
+		remove(connectorItem);
+		m_buses[key].insert(connectorItem, connectorItem);
+		m_keys.insert(connectorItem, key);
+		ConnectivityIndex::invalidate(connectorItem);
+	}
+
+	bool remove(ConnectorItem * connectorItem) {
+		auto it = m_keys.find(connectorItem);
+		if (it == m_keys.end()) return false;
+
+		auto bus = m_buses.find(it.value());
+		bus->remove(connectorItem);
+		if (bus->isEmpty()) m_buses.erase(bus);
+		m_keys.erase(it);
+		ConnectivityIndex::invalidate(connectorItem);
+		return true;
+	}
+
+	void collect(const Key & key, QGraphicsScene * scene, QList<ConnectorItem *> & items) const {
+		// labels with the same name in other sketches, or in other views, are left out
+		auto bus = m_buses.constFind(key);
+		if (bus == m_buses.constEnd()) return;
+
+		Q_FOREACH (const QPointer<ConnectorItem> & connectorItem, bus.value()) {
+			if (connectorItem == nullptr) continue;
+
+			if (connectorItem->scene() == scene) {
+				items.append(connectorItem);
+			}
+		}
+	}
+
+protected:
+	QHash<Key, QHash<ConnectorItem *, QPointer<ConnectorItem> > > m_buses;
+	QHash<ConnectorItem *, Key> m_keys;
+};
+
+static const long GroundBus = std::numeric_limits<long>::min();				// no voltage converts to this
+
+static SymbolBus<long> LocalVoltages;			// Qt doesn't do Hash keys with double; grounds are under GroundBus
+static SymbolBus<QString> LocalNetLabels;
 static QList<double> Voltages;
 double SymbolPaletteItem::DefaultVoltage = 5;
 
@@ -114,54 +162,25 @@ SymbolPaletteItem::SymbolPaletteItem( ModelPart * modelPart, ViewLayer::ViewID v
 }
 
 SymbolPaletteItem::~SymbolPaletteItem() {
-	if (m_isNetLabel) {
-		Q_FOREACH (QString key, LocalNetLabels.uniqueKeys()) {
-			if (m_connector0 != nullptr) {
-				LocalNetLabels.remove(key, m_connector0);
-			}
-			if (m_connector1 != nullptr) {
-				LocalNetLabels.remove(key, m_connector1);
-			}
-			LocalNetLabels.remove(key, nullptr);		// cleans null QPointers
-		}
-	}
-	else {
-		if (m_connector0 != nullptr) LocalGrounds.removeOne(m_connector0);
-		if (m_connector1 != nullptr) LocalGrounds.removeOne(m_connector1);
-		LocalGrounds.removeOne(QPointer<ConnectorItem>(nullptr));   // cleans null QPointers
+	Q_FOREACH (ConnectorItem * connectorItem, QList<ConnectorItem *>() << m_connector0 << m_connector1) {
+		if (connectorItem == nullptr) continue;
 
-		Q_FOREACH (long key, LocalVoltages.uniqueKeys()) {
-			if (m_connector0 != nullptr) {
-				LocalVoltages.remove(key, m_connector0);
-			}
-			if (m_connector1 != nullptr) {
-				LocalVoltages.remove(key, m_connector1);
-			}
-			LocalVoltages.remove(key, nullptr);		// cleans null QPointers
-		}
+		if (m_isNetLabel) LocalNetLabels.remove(connectorItem);
+		else LocalVoltages.remove(connectorItem);
 	}
 }
 
 void SymbolPaletteItem::removeMeFromBus(double v) {
 	Q_FOREACH (ConnectorItem * connectorItem, cachedConnectorItems()) {
 		if (m_isNetLabel) {
-			if (m_voltageReference) {
-				LocalNetLabels.remove(getLabel(), connectorItem);
-			} else {
-				LocalNetLabels.remove(m_label, connectorItem);
-			}
+			LocalNetLabels.remove(connectorItem);
 		}
 		else {
 			double nv = useVoltage(connectorItem);
 			if (std::fabs(nv - v) < 0.00001 ) {
 				//connectorItem->debugInfo(QString("remove %1").arg(useVoltage(connectorItem)));
 
-				bool gotOne = LocalGrounds.removeOne(connectorItem);
-				int count = LocalVoltages.remove(FROMVOLTAGE(v), connectorItem);
-				LocalVoltages.remove(FROMVOLTAGE(v), nullptr);
-
-
-				if (count == 0 && !gotOne) {
+				if (!LocalVoltages.remove(connectorItem)) {
 					DebugDialog::debug(QString("removeMeFromBus failed %1 %2 %3 %4")
 					                   .arg(this->id())
 					                   .arg(connectorItem->connectorSharedID())
@@ -170,7 +189,6 @@ void SymbolPaletteItem::removeMeFromBus(double v) {
 			}
 		}
 	}
-	LocalGrounds.removeOne(QPointer<ConnectorItem>(nullptr));  // keep cleaning these out
 }
 
 ConnectorItem* SymbolPaletteItem::newConnectorItem(Connector *connector)
@@ -191,7 +209,7 @@ ConnectorItem* SymbolPaletteItem::newConnectorItem(Connector *connector)
 		LocalNetLabels.insert(getLabel(), connectorItem);
 	}
 	else if (connectorItem->isGrounded()) {
-		LocalGrounds.append(connectorItem);
+		LocalVoltages.insert(GroundBus, connectorItem);
 		//connectorItem->debugInfo("new ground insert");
 	}
 	else {
@@ -210,23 +228,14 @@ void SymbolPaletteItem::busConnectorItems(Bus * bus, ConnectorItem * fromConnect
 	//bc->debugInfo(QString("bc %1").arg(bus->id()));
 	//}
 
-	QList< QPointer<ConnectorItem> > mitems;
 	if (m_isNetLabel) {
-		mitems.append(LocalNetLabels.values(getLabel()));
+		LocalNetLabels.collect(getLabel(), this->scene(), items);
 	}
 	else if (bus->id().compare("groundbus", Qt::CaseInsensitive) == 0) {
-		mitems.append(LocalGrounds);
+		LocalVoltages.collect(GroundBus, this->scene(), items);
 	}
 	else {
-		mitems.append(LocalVoltages.values(FROMVOLTAGE(m_voltage)));
-	}
-	Q_FOREACH (ConnectorItem * connectorItem, mitems) {
-		if (connectorItem == nullptr) continue;
-
-		if (connectorItem->scene() == this->scene()) {
-			items.append(connectorItem);
-			//connectorItem->debugInfo(QString("symbol bus %1").arg(bus->id()));
-		}
+		LocalVoltages.collect(FROMVOLTAGE(m_voltage), this->scene(), items);
 	}
 }
 
@@ -284,7 +293,7 @@ void SymbolPaletteItem::setVoltage(double v) {
 	else {
 		Q_FOREACH (ConnectorItem * connectorItem, cachedConnectorItems()) {
 			if (connectorItem->isGrounded()) {
-				LocalGrounds.append(connectorItem);
+				LocalVoltages.insert(GroundBus, connectorItem);
 				//connectorItem->debugInfo("ground insert");
 
 			}
@@ -24,8 +24,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 #include "../viewlayer.h"
 #include "../connectors/connectoritem.h"
-
-#include <QSettings>
+#include "../utils/settingscache.h"
 
 static HoleClassThing TheHoleThing;
 
@@ -37,9 +36,8 @@ QString Via::DefaultAutorouteViaRingThickness;
 Via::Via( ModelPart * modelPart, ViewLayer::ViewID viewID, const ViewGeometry & viewGeometry, long id, QMenu * itemMenu, bool doLabel)
 	: Hole(modelPart, viewID, viewGeometry, id, itemMenu, doLabel)
 {
-	QSettings settings;
-	QString ringThickness = settings.value(AutorouteViaRingThickness, "").toString();
-	QString holeSize = settings.value(AutorouteViaHoleSize, "").toString();
+	QString ringThickness = SettingsCache::stringValue(AutorouteViaRingThickness);
+	QString holeSize = SettingsCache::stringValue(AutorouteViaHoleSize);
 
 	bool holeSizeWasEmpty = holeSize.isEmpty();
 	bool ringThicknessWasEmpty = holeSize.isEmpty();
@@ -47,12 +45,12 @@ Via::Via( ModelPart * modelPart, ViewLayer::ViewID viewID, const ViewGeometry &
 	PaletteItem::setUpHoleSizes("via", TheHoleThing);
 
 	if (ringThicknessWasEmpty) {
-		settings.setValue(AutorouteViaRingThickness, TheHoleThing.ringThickness);
+		SettingsCache::setValue(AutorouteViaRingThickness, TheHoleThing.ringThickness);
 		DefaultAutorouteViaRingThickness = TheHoleThing.ringThickness;
 	}
 
 	if (holeSizeWasEmpty) {
-		settings.setValue(AutorouteViaHoleSize, TheHoleThing.holeSize);
+		SettingsCache::setValue(AutorouteViaHoleSize, TheHoleThing.holeSize);
 		DefaultAutorouteViaHoleSize = TheHoleThing.holeSize;
 	}
 
@@ -64,6 +64,7 @@ later:
 #include "../debugdialog.h"
 #include "../sketch/infographicsview.h"
 #include "../connectors/connectoritem.h"
+#include "../connectors/connectivityindex.h"
 #include "../connectors/svgidlayer.h"
 #include "../fsvgrenderer.h"
 #include "partlabel.h"
@@ -76,6 +77,7 @@ later:
 #include "../layerattributes.h"
 
 #include <stdlib.h>
+#include <algorithm>
 
 QVector<qreal> Wire::TheDash;
 QVector<qreal> RatDash;
@@ -264,7 +266,10 @@ void Wire::paint(QPainter * painter, const QStyleOptionGraphicsItem * option, QW
 void Wire::paintBody(QPainter * painter, const QStyleOptionGraphicsItem * option, QWidget * widget )
 {
 	Q_UNUSED(option);
-	Q_UNUSED(widget);
+
+	// zoomed far out, shadows and bands are too thin to see
+	bool simplified = detailLevel(painter, widget) == OutlineOnly;
+	bool banded = m_banded && !simplified;
 
 	QPainterPath painterPath;
 	if ((m_bezier != nullptr) && !m_bezier->isEmpty()) {
@@ -291,7 +296,7 @@ void Wire::paintBody(QPainter * painter, const QStyleOptionGraphicsItem * option
 
 
 	painter->setOpacity(m_inactive ? m_opacity  / 2 : m_opacity);
-	if (hasShadow()) {
+	if (hasShadow() && !simplified) {
 		painter->save();
 		painter->setPen(m_shadowPen);
 		if (painterPath.isEmpty()) {
@@ -306,7 +311,7 @@ void Wire::paintBody(QPainter * painter, const QStyleOptionGraphicsItem * option
 
 	// DebugDialog::debug(QString("pen width %1 %2").arg(m_pen.widthF()).arg(m_viewID));
 
-	if (m_banded) {
+	if (banded) {
 		QBrush brush = m_pen.brush();
 		m_pen.setStyle(Qt::SolidLine);
 		m_pen.setBrush(BandedBrush);
@@ -339,7 +344,7 @@ void Wire::paintBody(QPainter * painter, const QStyleOptionGraphicsItem * option
 		painter->drawPath(painterPath);
 	}
 
-	if (m_banded) {
+	if (banded) {
 		m_pen.setStyle(Qt::SolidLine);
 		m_pen.setCapStyle(Qt::RoundCap);
 	}
@@ -377,20 +382,39 @@ QPainterPath Wire::shape() const
 
 QPainterPath Wire::shapeAux(double width) const
 {
-	QPainterPath path;
+	// the scene asks for shapes and bounds over and over while hit testing, and stroking a curve is slow
+	ShapeCache & cache = (width == m_hoverStrokeWidth) ? m_hoverShapeCache : m_shapeCache;
+	bool curved = m_bezier != nullptr && !m_bezier->isEmpty();
+	if (cache.line == m_line && cache.curved == curved && cache.width == width
+	        && cache.cap == m_pen.capStyle() && cache.join == m_pen.joinStyle()
+	        && (!curved || (cache.cp0 == m_bezier->cp0() && cache.cp1 == m_bezier->cp1())))
+	{
+		return cache.path;
+	}
+
+	cache.line = m_line;
+	cache.curved = curved;
+	cache.cp0 = curved ? m_bezier->cp0() : QPointF();
+	cache.cp1 = curved ? m_bezier->cp1() : QPointF();
+	cache.width = width;
+	cache.cap = m_pen.capStyle();
+	cache.join = m_pen.joinStyle();
+	cache.path = QPainterPath();
 	if (m_line == QLineF()) {
-		return path;
+		return cache.path;
 	}
 
+	QPainterPath path;
 	path.moveTo(m_line.p1());
-	if (m_bezier == nullptr || m_bezier->isEmpty()) {
-		path.lineTo(m_line.p2());
+	if (curved) {
+		path.cubicTo(m_bezier->cp0(), m_bezier->cp1(), m_line.p2());
 	}
 	else {
-		path.cubicTo(m_bezier->cp0(), m_bezier->cp1(), m_line.p2());
+		path.lineTo(m_line.p2());
 	}
 	//DebugDialog::debug(QString("using hoverstrokewidth %1 %2").arg(m_id).arg(m_hoverStrokeWidth));
-	return GraphicsUtils::shapeFromPath(path, m_pen, width, false);
+	cache.path = GraphicsUtils::shapeFromPath(path, m_pen, width, false);
+	return cache.path;
 }
 
 QRectF Wire::boundingRect() const
@@ -1093,44 +1117,64 @@ void Wire::findConnectorsUnder() {
 }
 
 void Wire::collectChained(QList<Wire *> & chained, QList<ConnectorItem *> & ends ) {
-	chained.append(this);
+	// the sets mirror the lists, so a long chain isn't quadratic
+	QSet<Wire *> chainedSet(chained.begin(), chained.end());
+	QSet<ConnectorItem *> endSet(ends.begin(), ends.end());
+	if (!chainedSet.contains(this)) {
+		chained.append(this);
+		chainedSet.insert(this);
+	}
 	for (int i = 0; i < chained.count(); i++) {
 		Wire * wire = chained[i];
-		collectChained(wire->m_connector1, chained, ends);
-		collectChained(wire->m_connector0, chained, ends);
+		collectChained(wire->m_connector1, chained, chainedSet, ends, endSet);
+		collectChained(wire->m_connector0, chained, chainedSet, ends, endSet);
 	}
 }
 
-void Wire::collectChained(ConnectorItem * connectorItem, QList<Wire *> & chained, QList<ConnectorItem *> & ends) {
+void Wire::collectChained(ConnectorItem * connectorItem, QList<Wire *> & chained, QSet<Wire *> & chainedSet, QList<ConnectorItem *> & ends, QSet<ConnectorItem *> & endSet) {
 	if (connectorItem == nullptr) return;
 
 	Q_FOREACH (ConnectorItem * connectedToItem, connectorItem->connectedToItems()) {
 		Wire * wire = qobject_cast<Wire *>(connectedToItem->attachedTo());
 		if (wire == nullptr) {
-			if (!ends.contains(connectedToItem)) {
+			if (!endSet.contains(connectedToItem)) {
 				ends.append(connectedToItem);
+				endSet.insert(connectedToItem);
 			}
 			continue;
 		}
 
-		if (chained.contains(wire)) continue;
+		if (chainedSet.contains(wire)) continue;
 		chained.append(wire);
+		chainedSet.insert(wire);
 	}
 }
 
 void Wire::collectWires(QList<Wire *> & wires) {
-	if (wires.contains(this)) return;
+	// depth first, in the order the recursive walk used, but with an explicit stack so a long chain can't overflow
+	QSet<Wire *> visited(wires.begin(), wires.end());
+	if (visited.contains(this)) return;
 
-	wires.append(this);
-	//DebugDialog::debug(QString("collecting wire %1").arg(this->id()) );
-	collectWiresAux(wires, m_connector0);
-	collectWiresAux(wires, m_connector1);
+	QList<Wire *> stack;
+	stack.append(this);
+	while (!stack.isEmpty()) {
+		Wire * wire = stack.takeLast();
+		if (visited.contains(wire)) continue;
+
+		visited.insert(wire);
+		wires.append(wire);
+		//DebugDialog::debug(QString("collecting wire %1").arg(wire->id()) );
+		int top = stack.count();
+		collectWiresAux(stack, wire->m_connector0);
+		collectWiresAux(stack, wire->m_connector1);
+		std::reverse(stack.begin() + top, stack.end());
+	}
 }
 
 void Wire::collectWiresAux(QList<Wire *> & wires, ConnectorItem * start) {
 	Q_FOREACH (ConnectorItem * toConnectorItem, start->connectedToItems()) {
 		if (toConnectorItem->attachedToItemType() == ModelPart::Wire) {
-			qobject_cast<Wire *>(toConnectorItem->attachedTo())->collectWires(wires);
+			wires.append(qobject_cast<Wire *>(toConnectorItem->attachedTo()));
 		}
 	}
 
@@ -1160,14 +1204,17 @@ bool Wire::getRouted() {
 
 void Wire::setRouted(bool routed) {
 	m_viewGeometry.setRouted(routed);
+	ConnectivityIndex::invalidate(this);
 }
 
 void Wire::setRatsnest(bool ratsnest) {
 	m_viewGeometry.setRatsnest(ratsnest);
+	ConnectivityIndex::invalidate(this);
 }
 
 void Wire::setAutoroutable(bool ar) {
 	m_viewGeometry.setAutoroutable(ar);
+	ConnectivityIndex::invalidate(this);
 }
 
 bool Wire::getAutoroutable() {
@@ -1176,6 +1223,7 @@ bool Wire::getAutoroutable() {
 
 void Wire::setNormal(bool normal) {
 	m_viewGeometry.setNormal(normal);
+	ConnectivityIndex::invalidate(this);
 }
 
 bool Wire::getNormal() {
@@ -1359,6 +1407,7 @@ Wire * Wire::findTraced(ViewGeometry::WireFlags flags, QList<ConnectorItem *>  &
 
 void Wire::setWireFlags(ViewGeometry::WireFlags wireFlags) {
 	m_viewGeometry.setWireFlags(wireFlags);
+	ConnectivityIndex::invalidate(this);
 }
 
 double Wire::opacity() {
@@ -1386,17 +1435,20 @@ bool Wire::canChangeColor() {
 }
 
 void Wire::collectDirectWires(QList<Wire *> & wires) {
+	QSet<Wire *> wireSet(wires.begin(), wires.end());
 	bool firstRound = false;
-	if (!wires.contains(this)) {
+	if (!wireSet.contains(this)) {
 		wires.append(this);
+		wireSet.insert(this);
 		firstRound = true;
 	}
 
 	QList<ConnectorItem *> junctions;
+	QSet<ConnectorItem *> junctionSet;
 	if (firstRound) {
 		// collect up to any junction
-		collectDirectWires(m_connector0, wires, junctions);
-		collectDirectWires(m_connector1, wires, junctions);
+		collectDirectWires(m_connector0, wires, wireSet, junctions, junctionSet);
+		collectDirectWires(m_connector1, wires, wireSet, junctions, junctionSet);
 		return;
 	}
 
@@ -1404,6 +1456,7 @@ void Wire::collectDirectWires(QList<Wire *> & wires) {
 	Q_FOREACH (Wire * wire, wires) {
 		junctions << wire->connector0() << wire->connector1();
 	}
+	junctionSet = QSet<ConnectorItem *>(junctions.begin(), junctions.end());
 
 	int ix = 0;
 	while (ix < junctions.count()) {
@@ -1414,7 +1467,7 @@ void Wire::collectDirectWires(QList<Wire *> & wires) {
 			if (toConnectorItem->attachedToItemType() != ModelPart::Wire) break;
 
 			Wire * w = qobject_cast<Wire *>(toConnectorItem->attachedTo());
-			if (!wires.contains(w)) jwires << w;
+			if (!wireSet.contains(w)) jwires << w;
 
 			bool onlyWiresConnected = true;
 			Q_FOREACH (ConnectorItem * toToConnectorItem, toConnectorItem->connectedToItems()) {
@@ -1424,7 +1477,7 @@ void Wire::collectDirectWires(QList<Wire *> & wires) {
 				}
 
 				w = qobject_cast<Wire *>(toToConnectorItem->attachedTo());
-				if (!wires.contains(w)) jwires << w;
+				if (!wireSet.contains(w)) jwires << w;
 			}
 			if (!onlyWiresConnected) break;
 		}
@@ -1433,33 +1486,43 @@ void Wire::collectDirectWires(QList<Wire *> & wires) {
 			// there is a junction of > 2 wires and all wires leading to it except one are already on the delete list
 			Wire * w = jwires.values().at(0);
 			wires << w;
-			w->collectDirectWires(w->connector0(), wires, junctions);
-			w->collectDirectWires(w->connector1(), wires, junctions);
+			wireSet.insert(w);
+			w->collectDirectWires(w->connector0(), wires, wireSet, junctions, junctionSet);
+			w->collectDirectWires(w->connector1(), wires, wireSet, junctions, junctionSet);
 		}
 	}
 }
 
 
-void Wire::collectDirectWires(ConnectorItem * connectorItem, QList<Wire *> & wires, QList<ConnectorItem *> & junctions) {
-	if (connectorItem->connectionsCount() == 0) return;
-	if (connectorItem->connectionsCount() > 1) {
-		if (!junctions.contains(connectorItem)) junctions.append(connectorItem);
-		return;
-	}
+void Wire::collectDirectWires(ConnectorItem * connectorItem, QList<Wire *> & wires, QSet<Wire *> & wireSet, QList<ConnectorItem *> & junctions, QSet<ConnectorItem *> & junctionSet) {
+	// follows the chain until it branches or ends; a loop rather than a recursion, since chains can be long
+	while (connectorItem->connectionsCount() > 0) {
+		if (connectorItem->connectionsCount() > 1) {
+			if (!junctionSet.contains(connectorItem)) {
+				junctions.append(connectorItem);
+				junctionSet.insert(connectorItem);
+			}
+			return;
+		}
 
-	ConnectorItem * toConnectorItem = connectorItem->connectedToItems().at(0);
-	if (toConnectorItem->attachedToItemType() != ModelPart::Wire) return;
+		ConnectorItem * toConnectorItem = connectorItem->connectedToItems().at(0);
+		if (toConnectorItem->attachedToItemType() != ModelPart::Wire) return;
 
-	if (toConnectorItem->connectionsCount() != 1) {
-		if (!junctions.contains(connectorItem)) junctions.append(connectorItem);
-		return;
-	}
+		if (toConnectorItem->connectionsCount() != 1) {
+			if (!junctionSet.contains(connectorItem)) {
+				junctions.append(connectorItem);
+				junctionSet.insert(connectorItem);
+			}
+			return;
+		}
 
-	Wire * nextWire = qobject_cast<Wire *>(toConnectorItem->attachedTo());
-	if (wires.contains(nextWire)) return;
+		Wire * nextWire = qobject_cast<Wire *>(toConnectorItem->attachedTo());
+		if (wireSet.contains(nextWire)) return;
 
-	wires.append(nextWire);
-	nextWire->collectDirectWires(nextWire->otherConnector(toConnectorItem), wires, junctions);
+		wires.append(nextWire);
+		wireSet.insert(nextWire);
+		connectorItem = nextWire->otherConnector(toConnectorItem);
+	}
 }
 
 QVariant Wire::itemChange(GraphicsItemChange change, const QVariant &value)
@@ -30,6 +30,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStyleOptionGraphicsItem>
 #include <QWidget>
 #include <QHash>
+#include <QSet>
 #include <QMenu>
 
 #include "itembase.h"
@@ -195,11 +196,11 @@ protected:
 	bool acceptsMouseMoveConnectorEvent(ConnectorItem *, QGraphicsSceneMouseEvent *);
 	bool acceptsMouseReleaseConnectorEvent(ConnectorItem *, QGraphicsSceneMouseEvent *);
 	virtual class FSvgRenderer * setUpConnectors(class ModelPart *, ViewLayer::ViewID);
-	void collectChained(ConnectorItem * connectorItem, QList<Wire *> & chained, QList<ConnectorItem *> & ends);
+	void collectChained(ConnectorItem * connectorItem, QList<Wire *> & chained, QSet<Wire *> & chainedSet, QList<ConnectorItem *> & ends, QSet<ConnectorItem *> & endSet);
 	void collectWiresAux(QList<Wire *> & wires, ConnectorItem * start);
 	void setShadowColor(QColor &, bool restore);
 	void calcNewLine(ConnectorItem * from, ConnectorItem * to, QPointF & p1, QPointF & p2);
-	void collectDirectWires(ConnectorItem * connectorItem, QList<Wire *> & wires, QList<ConnectorItem *> & junctions);
+	void collectDirectWires(ConnectorItem * connectorItem, QList<Wire *> & wires, QSet<Wire *> & wireSet, QList<ConnectorItem *> & junctions, QSet<ConnectorItem *> & junctionSet);
 	QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 	void getConnectedColor(ConnectorItem *, QBrush &, QPen &, double & opacity, double & negativePenWidth, bool & negativeOffsetRect);
 	bool connectionIsAllowed(ConnectorItem *);
@@ -248,6 +249,20 @@ protected:
 	bool m_banded;
 	bool m_colorByLength;
 
+	struct ShapeCache {
+		// the stroked path and what it was stroked from; checked on every use, so nothing has to invalidate it
+		QLineF line;
+		bool curved = false;
+		QPointF cp0;
+		QPointF cp1;
+		double width = -1;
+		Qt::PenCapStyle cap = Qt::RoundCap;
+		Qt::PenJoinStyle join = Qt::BevelJoin;
+		QPainterPath path;
+	};
+	mutable ShapeCache m_shapeCache;
+	mutable ShapeCache m_hoverShapeCache;
+
 public:
 	static QStringList colorNames;
 	static QHash<QString, QString> colorTrans;
@@ -127,27 +127,60 @@ int main(int argc, char *argv[])
 			     "Options:\n"
 			     "\n"
 			     "User options:\n"
+			     "  -a, -all FOLDER               export Gerber, BOM and IPC-D-356 files for all changed sketches in FOLDER,\n"
+			     "                                writing exportall.json; exits with 2 if any sketch fails to load\n"
+			     "  -alljobs N                    with -all, spread the sketches across N worker processes\n"
+			     "  -autoroute FOLDER             autoroute the PCB view of all sketches in FOLDER, saving NAME_autorouted.fzz and a JSON timing report\n"
+			     "  -autorouteset NAME=VALUE      with -autoroute, override an autorouter setting (maxcycles, parallelorderings, queuestrategy, coarserouting)\n"
 			     "  -d, -debug                    run Fritzing in debug mode, providing additional debug information\n"
-			     //" drc filename : runs a design rule check on the given sketch file\n"
+			     "  -diff A.fzz B.fzz             print the parts added, removed, swapped and moved from sketch A to sketch B, and the nets\n"
+			     "                                that changed, to stdout as json; reads the sketch files without loading the parts\n"
+			     "  -drc FOLDER                   design rules check every board of all sketches in FOLDER, writing drc.json and a JUnit drc.xml;\n"
+			     "                                exits with 2 if any sketch has violations or fails to load\n"
+			     "  -erc FOLDER                   electrical rules check the schematic nets of all sketches in FOLDER against the parts'\n"
+			     "                                voltage and current data, writing erc.json and a JUnit erc.xml; exits with 2 as -drc does\n"
 			     "  -f, -folder FOLDER            use Fritzing parts, sketches, bins and translations in folders under FOLDER\n"
 			     "  -geda FOLDER                  convert all gEDA footprint (.fp) files in FOLDER to Fritzing SVGs\n"
-			     "  -g, -gerber FOLDER            export all sketches in FOLDER to Gerber, in the same folder\n"
+			     "  -g, -gerber FOLDER            export all sketches in FOLDER to Gerber, in the same folder, with a JSON timing report\n"
+			     "  -gerberfill                   with -gerber, copper fill each sketch before exporting it\n"
 			     "  -h, -help                     print this help message\n"
 			     "  -kicad FOLDER                 convert all Kicad footprint (.mod) files in FOLDER to Fritzing SVGs\n"
 			     "  -kicadschematic FOLDER        convert all Kicad schematic (.lib) files in FOLDER to Fritzing SVGs\n"
-			     "  -port NUMBER                  run Fritzing as a server process on port NUMBER\n"
+			     "  -loglevel LEVEL               with debugging on, log only messages at LEVEL (debug, info, warning, error) and above\n"
+			     "  -memory FOLDER                load all sketches in FOLDER and write the approximate memory of each by subsystem\n"
+			     "                                (views, svg renderers, undo stack, part definitions) to memory.json\n"
+			     "  -netlist FOLDER               write the schematic netlist of all sketches in FOLDER to NAME_netlist.xml, reading\n"
+			     "                                the sketch files and the parts database without loading the parts or opening windows\n"
+			     "  -port NUMBER FOLDER           run Fritzing as a server process on port NUMBER, exporting sketches under FOLDER;\n"
+			     "                                GET /queue/COMMAND/... returns a job id for /status/ID and /result/ID,\n"
+			     "                                GET /metrics returns Prometheus metrics\n"
+			     "  -portwindows N                with -port, keep the last N sketches loaded between requests (default 2)\n"
+			     "  -portspare N                  with -port, build N empty windows ahead of the requests (default 1)\n"
+			     "  -simulate FOLDER              simulate all sketches in FOLDER, writing node voltages, part currents and smoking parts\n"
+			     "                                to simulate.json; exits with 2 if any sketch fails to load or simulate\n"
+			     "  -s2s FOLDER                   convert the schematics of all parts (.fzp) in FOLDER to the 0.1 inch standard,\n"
+			     "                                writing per-file timings to s2s.json; svgs are in ../svg/FOLDERNAME or next to the fzps\n"
+			     "  -s2sdryrun                    with -s2s, write only s2s.json and an s2s.diff of the changes\n"
+			     "  -s2sthreads N                 with -s2s, convert N files at a time\n"
 			     "  -svg FOLDER                   export all sketches in FOLDER to SVGs of all views, in the same folder\n"
+			     "  -svgshared                    with -svg, draw each repeated part once in defs and place it with use\n"
 			     "\n"
 			     "Administrator option:\n"
-			     "  -db, -database FILE           rebuild the internal parts database FILE\n"
+			     "  -db, -database FILE           rebuild the internal parts database FILE and pre-generate\n"
+			     "                                the common header and IC sizes\n"
 			     "\n"
 			     "Developer options:\n"
 			     "  -e, -examples FOLDER          prepare all sketches in FOLDER to be included as examples\n"
 			     "  -ep FILE                      add menu item for external process using executable FILE\n"
 			     "  -eparg ARGS                   with -ep, external process arguments ARGS\n"
 			     "  -epname NAME                  with -ep, external process menu item NAME\n"
+			     "  -perfexamples FILE.csv        open every bundled example sketch and write its open, render, routing status, DRC\n"
+			     "                                and Gerber export times and memory to FILE.csv\n"
+			     "  -profile-startup [FILE.json]  log wall time and allocations for each startup phase, and write them to FILE.json\n"
+			     "  -trace FILE.json              record loading, editing, autorouting, DRC, export and simulation to FILE.json\n"
+			     "                                in the Chrome trace event format\n"
 			     "\n"
-			     "The -geda, -kicad, -kicadschematic, -gerber SVG options all exit Fritzing after the conversion process is complete;\n"
+			     "The -geda, -kicad, -kicadschematic, -gerber, -drc, -erc, -simulate, -memory, -netlist, -diff, -s2s and SVG options all exit Fritzing after the conversion process is complete;\n"
 			     "these options are mutually exclusive.\n"
 			     "\n"
 #ifndef PKGDATADIR
@@ -0,0 +1,36 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "FProbeInteractionProfile.h"
+#include "../utils/interactionprofiler.h"
+
+FProbeInteractionProfile::FProbeInteractionProfile() :
+	FProbe("InteractionProfile")
+{
+}
+
+QVariant FProbeInteractionProfile::read() {
+	// the timings of the last frame painted
+	return InteractionProfiler::lastFrameMap();
+}
+
+void FProbeInteractionProfile::write(QVariant data) {
+	Q_EMIT showProfile(data.toBool());
+}
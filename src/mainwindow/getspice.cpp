@@ -26,8 +26,21 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/textutils.h"
 
 QString GetSpice::getSpice(ItemBase * itemBase, const QList< QList<class ConnectorItem *>* >& netList) {
+	QHash<ConnectorItem *, int> netIndex;
+	for (int i = 0; i < netList.count(); i++) {
+		Q_FOREACH (ConnectorItem * ci, *netList.at(i)) {
+			netIndex.insert(ci, i);
+		}
+	}
+	return getSpice(itemBase, netIndex);
+}
+
+QString GetSpice::getSpice(ItemBase * itemBase, const QHash<class ConnectorItem *, int>& netIndex) {
+	// netIndex maps each connector to the number of its net
 	static QRegularExpression curlies("\\{([^\\{\\}]*)\\}");
 	QString spice = itemBase->spice();
+	QHash<PropertyDef *, QString> propertyDefs;
+	bool gotPropertyDefs = false;
 	int pos = 0;
 	while (true) {
 		QRegularExpressionMatch match;
@@ -48,12 +61,11 @@ QString GetSpice::getSpice(ItemBase * itemBase, const QList< QList<class Connect
 			QString cname = token.mid(4).trimmed();
 			Q_FOREACH (ConnectorItem * ci, itemBase->cachedConnectorItems()) {
 				if (ci->connectorSharedID().toLower() == cname) {
-					int ix = -1;
-					Q_FOREACH (QList<ConnectorItem *> * net, netList) {
-						ix++;
-						if (net->contains(ci)) break;
+					int ix = netIndex.value(ci, -1);
+					if (ix < 0) {
+						// not on any net; as before, use the last one
+						Q_FOREACH (int net, netIndex) ix = qMax(ix, net);
 					}
-
 					replacement = QString::number(ix);
 					break;
 				}
@@ -62,8 +74,10 @@ QString GetSpice::getSpice(ItemBase * itemBase, const QList< QList<class Connect
 		else {
 			//Find the symbol of this property
 			QString symbol;
-			QHash<PropertyDef *, QString> propertyDefs;
-			PropertyDefMaster::initPropertyDefs(itemBase->modelPart(), propertyDefs);
+			if (!gotPropertyDefs) {
+				PropertyDefMaster::initPropertyDefs(itemBase->modelPart(), propertyDefs);
+				gotPropertyDefs = true;
+			}
 			foreach (PropertyDef * propertyDef, propertyDefs.keys()) {
 				if (token.compare(propertyDef->name, Qt::CaseInsensitive) == 0) {
 					symbol = propertyDef->symbol;
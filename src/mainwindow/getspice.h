@@ -23,6 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QString>
 #include <QList>
+#include <QHash>
 
 #include "../items/itembase.h"
 
@@ -30,6 +31,7 @@ class GetSpice
 {
 public:
 	static QString getSpice(ItemBase * itemBase, const QList< QList<class ConnectorItem *>* >& netList);
+	static QString getSpice(ItemBase * itemBase, const QHash<class ConnectorItem *, int>& netIndex);
 };
 
 #endif
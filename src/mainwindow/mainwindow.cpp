@@ -53,6 +53,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/fmessagebox.h"
 #include "../utils/lockmanager.h"
 #include "../utils/textutils.h"
+#include "../model/backupjournal.h"
 #include "../utils/graphicsutils.h"
 #include "../items/perfboard.h"
 #include "../items/stripboard.h"
@@ -70,12 +71,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/resizableboard.h"
 #include "../items/resistor.h"
 #include "../utils/zoomslider.h"
+#include "../utils/tracer.h"
 #include "../partseditor/pemainwindow.h"
 #include "../help/firsttimehelpdialog.h"
 #include "../simulation/simulator.h"
 #include "../simulation/FProbeStartSimulator.h"
 #include "../mainwindow/FProbeDropByModuleID.h"
 #include "../mainwindow/FProbeKeyPressEvents.h"
+#include "../mainwindow/FProbeInteractionProfile.h"
 
 FTabWidget::FTabWidget(QWidget * parent) : QTabWidget(parent)
 {
@@ -291,9 +294,12 @@ MainWindow::MainWindow(ReferenceModel *referenceModel, QWidget * parent) :
 	resize(MainWindowDefaultWidth, MainWindowDefaultHeight);
 
 	m_backupFileNameAndPath = MainWindow::BackupFolder + "/" + TextUtils::getRandText() + FritzingSketchExtension;
+	m_backupJournal.reset(new BackupJournal(m_backupFileNameAndPath));
 	// Connect the undoStack to our autosave stuff
 	connect(m_undoStack, SIGNAL(indexChanged(int)), this, SLOT(autosaveNeeded(int)));
 	connect(m_undoStack, SIGNAL(cleanChanged(bool)), this, SLOT(undoStackCleanChanged(bool)));
+	connect(&m_backgroundSave, SIGNAL(finished()), this, SLOT(backgroundSaveFinished()));
+	connect(m_undoStack, SIGNAL(aboutToPush()), this, SLOT(loadDeferredViews()));
 
 	// Create dot icons
 	m_dotIcon = QIcon(":/resources/images/dot.png");
@@ -513,6 +519,9 @@ void MainWindow::init(ReferenceModel *referenceModel, bool lockFiles) {
 
 	connect(fProbeKey, &FProbeKeyPressEvents::postKeyEvent, this, &MainWindow::postKeyEvent);
 
+	auto fProbeProfile = new FProbeInteractionProfile();
+	connect(fProbeProfile, &FProbeInteractionProfile::showProfile, this, &MainWindow::showProfile);
+
 	m_projectProperties = QSharedPointer<ProjectProperties>(new ProjectProperties());
 //	m_breadboardGraphicsView->setProjectProperties(m_projectProperties);
 //	m_schematicGraphicsView->setProjectProperties(m_projectProperties);
@@ -521,8 +530,11 @@ void MainWindow::init(ReferenceModel *referenceModel, bool lockFiles) {
 
 MainWindow::~MainWindow()
 {
+	// an unfinished save still reads from the bundle folder
+	m_backgroundSave.waitForFinished();
+
 	// Delete backup of this sketch if one exists.
-	QFile::remove(m_backupFileNameAndPath);
+	m_backupJournal->remove();
 
 	delete m_sketchModel;
 
@@ -1152,6 +1164,9 @@ void MainWindow::tabWidget_currentChanged(int index) {
 	if (m_pcbGraphicsView != nullptr) m_pcbGraphicsView->setCurrent(false);
 
 	auto *widget = qobject_cast<SketchWidget *>(widgetParent->contentView());
+	if (widget != nullptr) {
+		loadDeferredView(widget);
+	}
 
 	if(m_currentGraphicsView != nullptr) {
 		m_currentGraphicsView->saveZoom(m_zoomSlider->value());
@@ -1243,6 +1258,9 @@ void MainWindow::closeEvent(QCloseEvent *event) {
 		return;
 	}
 
+	// if it fails, the sketch is modified again and asks to be saved below
+	waitForBackgroundSave();
+
 	if (m_programWindow != nullptr) {
 		m_programWindow->close();
 		if (m_programWindow->isVisible()) {
@@ -1420,7 +1438,10 @@ void MainWindow::setInfoViewOnHover(bool infoViewOnHover) {
 void MainWindow::loadBundledSketch(const QString &fileName, bool addToRecent, bool setAsLastOpened, bool checkObsolete) {
 
 	QString error;
-	if(!FolderUtils::unzipTo(fileName, m_fzzFolder, error)) {
+	Tracer::begin("load.unzip");
+	bool unzipped = FolderUtils::unzipTo(fileName, m_fzzFolder, error);
+	Tracer::end();
+	if(!unzipped) {
 		FMessageBox::warning(
 		    this,
 		    tr("Fritzing"),
@@ -1465,6 +1486,7 @@ void MainWindow::loadBundledSketch(const QString &fileName, bool addToRecent, bo
 	QList<MissingSvgInfo> missing;
 	QList<ModelPart *> missingModelParts;
 
+	Tracer::begin("load.parts");
 	Q_FOREACH (QFileInfo fzpInfo, entryInfoList) {
 		QFile file(dir.absoluteFilePath(fzpInfo.fileName()));
 		if (!file.open(QFile::ReadOnly)) {
@@ -1546,6 +1568,7 @@ void MainWindow::loadBundledSketch(const QString &fileName, bool addToRecent, bo
 			m_addedToTemp = true;
 		}
 	}
+	Tracer::end();
 
 	std::sort(missing.begin(), missing.end(), byConnectorCount);
 	Q_FOREACH (MissingSvgInfo msi, missing) {
@@ -1931,11 +1954,37 @@ void MainWindow::saveBundledPart(const QString &moduleId) {
 
 QStringList MainWindow::saveBundledAux(ModelPart *mp, const QDir &destFolder) {
 	QStringList names;
+	QList<QPair<QString, QString>> files = bundledPartFiles(mp);
+	for (const QPair<QString, QString> & entry : files) {
+		QFile file(entry.second);
+		names << entry.first;
+		FolderUtils::slamCopy(file, destFolder.path()+"/"+entry.first);
+	}
+
+	return names;
+}
+
+QStringList MainWindow::saveBundledAux(ModelPart *mp, QList<BundleFile> & bundleFiles) {
+	// the part's files go into the archive from where they are, without a copy in the bundle folder
+	QStringList names;
+	QList<QPair<QString, QString>> files = bundledPartFiles(mp);
+	for (const QPair<QString, QString> & entry : files) {
+		names << entry.first;
+		BundleFile bundleFile;
+		bundleFile.name = entry.first;
+		bundleFile.path = entry.second;
+		bundleFile.required = false;
+		bundleFiles.append(bundleFile);
+	}
+
+	return names;
+}
+
+QList<QPair<QString, QString>> MainWindow::bundledPartFiles(ModelPart *mp) {
+	// name in the bundle and path on disk of the part's fzp and svgs
+	QList<QPair<QString, QString>> files;
 	QString partPath = mp->path();
-	QFile file(partPath);
-	QString fn = ZIP_PART + QFileInfo(partPath).fileName();
-	names << fn;
-	FolderUtils::slamCopy(file, destFolder.path()+"/"+fn);
+	files.append(qMakePair(ZIP_PART + QFileInfo(partPath).fileName(), partPath));
 
 	QList<ViewLayer::ViewID> viewIDs;
 	viewIDs << ViewLayer::IconView << ViewLayer::BreadboardView << ViewLayer::SchematicView << ViewLayer::PCBView;
@@ -1946,14 +1995,11 @@ QStringList MainWindow::saveBundledAux(ModelPart *mp, const QDir &destFolder) {
 		QString filename = PartFactory::getSvgFilename(mp, basename, true, true);
 		if (filename.isEmpty()) continue;
 
-		QFile file(filename);
 		basename.replace("/", ".");
-		QString fn = ZIP_SVG + basename;
-		names << fn;
-		FolderUtils::slamCopy(file, destFolder.path()+"/"+fn);
+		files.append(qMakePair(ZIP_SVG + basename, filename));
 	}
 
-	return names;
+	return files;
 }
 
 QList<ModelPart*> MainWindow::moveToPartsFolder(QDir &unzipDir, MainWindow* mw, bool addToBin, bool addToAlien, const QString & prefixFolder, const QString &destFolder, bool importingSinglePart) {
@@ -1999,15 +2045,23 @@ QList<ModelPart*> MainWindow::moveToPartsFolder(QDir &unzipDir, MainWindow* mw,
 	return retval;
 }
 
-QString MainWindow::copyToSvgFolder(const QFileInfo& file, bool addToAlien, const QString & prefixFolder, const QString &destFolder) {
-	QFile svgfile(file.filePath());
+QString MainWindow::svgFolderPath(const QString & zipName, const QString & prefixFolder, const QString &destFolder) {
 	// let's make sure that we remove just the suffix
-	QString fileName = file.fileName().remove(QRegularExpression("^"+ZIP_SVG));
+	QString fileName = QString(zipName).remove(QRegularExpression("^"+ZIP_SVG));
 	QString viewFolder = fileName.left(fileName.indexOf("."));
 	fileName.remove(0, viewFolder.length() + 1);
 
-	QString destFilePath =
-	    prefixFolder+"/svg/"+destFolder+"/"+viewFolder+"/"+fileName;
+	return prefixFolder+"/svg/"+destFolder+"/"+viewFolder+"/"+fileName;
+}
+
+QString MainWindow::partsFolderPath(const QString & zipName, const QString & prefixFolder, const QString &destFolder) {
+	// let's make sure that we remove just the suffix
+	return prefixFolder+"/"+destFolder+"/"+QString(zipName).remove(QRegularExpression("^"+ZIP_PART));
+}
+
+QString MainWindow::copyToSvgFolder(const QFileInfo& file, bool addToAlien, const QString & prefixFolder, const QString &destFolder) {
+	QFile svgfile(file.filePath());
+	QString destFilePath = svgFolderPath(file.fileName(), prefixFolder, destFolder);
 
 	backupExistingFileIfExists(destFilePath);
 	if(FolderUtils::slamCopy(svgfile, destFilePath)) {
@@ -2022,9 +2076,7 @@ QString MainWindow::copyToSvgFolder(const QFileInfo& file, bool addToAlien, cons
 
 ModelPart* MainWindow::copyToPartsFolder(const QFileInfo& file, bool addToAlien, const QString & prefixFolder, const QString &destFolder) {
 	QFile partfile(file.filePath());
-	// let's make sure that we remove just the suffix
-	QString destFilePath =
-	    prefixFolder+"/"+destFolder+"/"+file.fileName().remove(QRegularExpression("^"+ZIP_PART));
+	QString destFilePath = partsFolderPath(file.fileName(), prefixFolder, destFolder);
 
 	backupExistingFileIfExists(destFilePath);
 	if(FolderUtils::slamCopy(partfile, destFilePath)) {
@@ -2049,6 +2101,132 @@ ModelPart* MainWindow::copyToPartsFolder(const QFileInfo& file, bool addToAlien,
 	return mp;
 }
 
+bool MainWindow::writeToPartsFolder(const QString & destFilePath, const QByteArray & data) {
+	backupExistingFileIfExists(destFilePath);
+	QFile file(destFilePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	bool result = file.write(data) == data.size();
+	file.close();
+	if (result) {
+		m_alienFiles << destFilePath;
+	}
+	return result;
+}
+
+QList<ModelPart*> MainWindow::loadBundledParts(const QStringList &fileNames, bool addToBin) {
+	// for importing a library of parts: each bundle is unzipped in memory and written straight
+	// to the parts folder, the parts go into the database in one transaction, and the bin is
+	// updated once at the end, rather than a temp folder, a commit and a bin refresh per part
+	QList<ModelPart*> retval;
+	QStringList problems;
+	QSet<QString> moduleIDs;
+	QString prefixFolder = FolderUtils::getUserPartsPath();
+
+	struct Bundle {
+		QString fileName;
+		QStringList partPaths;
+		QStringList written;
+	};
+	QList<Bundle> bundles;
+
+	Q_FOREACH (QString fileName, fileNames) {
+		QList<QPair<QString, QByteArray>> entries;
+		QString error;
+		if (!FolderUtils::unzipToMemory(fileName, entries, error)) {
+			problems << tr("Unable to open shareable part '%1': %2").arg(fileName).arg(error);
+			continue;
+		}
+
+		QString duplicate;
+		int partCount = 0;
+		for (const auto & entry : entries) {
+			if (!entry.first.startsWith(ZIP_PART)) continue;
+
+			partCount++;
+			QString moduleID = TextUtils::parseForModuleID(QString::fromUtf8(entry.second));
+			if (moduleID.isEmpty()) continue;
+			if (moduleIDs.contains(moduleID) || (m_referenceModel->retrieveModelPart(moduleID) != nullptr)) {
+				duplicate = moduleID;
+				break;
+			}
+		}
+		if (!duplicate.isEmpty()) {
+			problems << tr("There is already a part with id '%1' loaded into Fritzing.").arg(duplicate);
+			continue;
+		}
+		if (partCount == 0) {
+			problems << tr("Unable to load part from '%1'").arg(fileName);
+			continue;
+		}
+
+		Bundle bundle;
+		bundle.fileName = fileName;
+		bool ok = true;
+		for (const auto & entry : entries) {
+			QString destFilePath;
+			if (entry.first.startsWith(ZIP_SVG)) {
+				destFilePath = svgFolderPath(entry.first, prefixFolder, "user");
+			}
+			else if (entry.first.startsWith(ZIP_PART)) {
+				destFilePath = partsFolderPath(entry.first, prefixFolder, "user");
+				bundle.partPaths << destFilePath;
+				moduleIDs.insert(TextUtils::parseForModuleID(QString::fromUtf8(entry.second)));
+			}
+			else continue;
+
+			if (!writeToPartsFolder(destFilePath, entry.second)) {
+				ok = false;
+				break;
+			}
+			bundle.written << destFilePath;
+		}
+		if (!ok) {
+			problems << tr("Unable to load part from '%1'").arg(fileName);
+			Q_FOREACH (QString path, bundle.written) {
+				QFile::remove(path);
+				m_alienFiles.removeOne(path);
+			}
+			continue;
+		}
+		bundles << bundle;
+	}
+
+	m_referenceModel->beginBatch();
+	for (const Bundle & bundle : bundles) {
+		Q_FOREACH (QString partPath, bundle.partPaths) {
+			ModelPart * mp = m_referenceModel->loadPart(partPath, true);
+			if (mp == nullptr) {
+				problems << tr("Unable to load part from '%1'").arg(bundle.fileName);
+				QFile::remove(partPath);
+				m_alienFiles.removeOne(partPath);
+				continue;
+			}
+
+			mp->setAlien(true);
+			retval << mp;
+		}
+	}
+	m_referenceModel->endBatch();
+
+	if (retval.count() > 0) {
+		m_alienPartsMsg = tr("Do you want to keep the imported parts?");
+		if (addToBin) {
+			m_binManager->addToMyParts(retval);
+		}
+	}
+
+	if (problems.count() > 0) {
+		FMessageBox::warning(
+		    this,
+		    tr("Fritzing"),
+		    problems.join("\n")
+		);
+	}
+
+	return retval;
+}
+
 void MainWindow::binSaved(bool hasPartsFromBundled) {
 	if(hasPartsFromBundled) {
 		// the bin will need those parts, so just keep them
@@ -2403,6 +2581,8 @@ void MainWindow::swapLayers(ItemBase * itemBase, int layers, const QString & msg
 
 void MainWindow::swapSelectedAux(ItemBase * itemBase, const QString & moduleID, bool useViewLayerPlacement, ViewLayer::ViewLayerPlacement overrideViewLayerPlacement,  QMap<QString, QString> & propsMap) {
 
+	if (!useViewLayerPlacement && swapInPlace(itemBase, moduleID)) return;
+
 	auto* parentCommand = new QUndoCommand(tr("Swapped %1 with module %2").arg(itemBase->instanceTitle()).arg(moduleID));
 	new CleanUpWiresCommand(m_breadboardGraphicsView, CleanUpWiresCommand::UndoOnly, parentCommand);
 	new CleanUpRatsnestsCommand(m_breadboardGraphicsView, CleanUpWiresCommand::UndoOnly, parentCommand);
@@ -2434,6 +2614,25 @@ void MainWindow::swapSelectedAux(ItemBase * itemBase, const QString & moduleID,
 	m_undoStack->push(parentCommand);
 }
 
+bool MainWindow::swapInPlace(ItemBase * itemBase, const QString & moduleID) {
+	// a variant with the same connectors in the same places (a different color or label, say)
+	// keeps its items and wires, so there is nothing to delete, reconnect or re-ratsnest
+	auto * sketchWidget = qobject_cast<SketchWidget *>(InfoGraphicsView::getInfoGraphicsView(itemBase));
+	if (sketchWidget == nullptr) return false;
+
+	QString oldModuleID = itemBase->moduleID();
+	if (!sketchWidget->swapInPlace(itemBase->id(), moduleID)) return false;
+
+	auto * command = new SwapInPlaceCommand(sketchWidget, itemBase->id(), oldModuleID, moduleID, nullptr);
+	command->setText(tr("Swapped %1 with module %2").arg(itemBase->instanceTitle()).arg(moduleID));
+	command->setSkipFirstRedo();
+	m_undoStack->push(command);
+
+	// Otherwise focus will be on the zoom slider and ctrl-z won't work.
+	this->setFocus();
+	return true;
+}
+
 void MainWindow::swapBoardImageSlot(SketchWidget * sketchWidget, ItemBase * itemBase, const QString & filename, const QString & moduleID, bool addName) {
 
 	auto* parentCommand = new QUndoCommand(tr("Change image to %2").arg(filename));
@@ -2720,7 +2919,9 @@ void  MainWindow::backupSketch() {
 		ProcessEventBlocker::processEvents();
 		m_backingUp = true;
 		connectStartSave(true);
-		m_sketchModel->save(m_backupFileNameAndPath, false);
+		if (!m_backupJournal->save(m_sketchModel)) {
+			m_autosaveNeeded = true;		// the previous backup is still being written
+		}
 		connectStartSave(false);
 		m_backingUp = false;
 	}
@@ -2745,7 +2946,7 @@ void MainWindow::autosaveNeeded(int index) {
 void MainWindow::undoStackCleanChanged(bool isClean) {
 	// DebugDialog::debug(QString("Clean status changed to %1").arg(isClean));
 	if (isClean) {
-		QFile::remove(m_backupFileNameAndPath);
+		m_backupJournal->remove();
 	}
 }
 
@@ -3339,6 +3540,10 @@ void MainWindow::triggerSimulator() {
 	m_simulator->triggerSimulation();
 }
 
+Simulator * MainWindow::simulator() {
+	return m_simulator;
+}
+
 bool MainWindow::isSimulatorEnabled() {
 	return m_simulator->isEnabled();
 }
@@ -39,6 +39,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStylePainter>
 #include <QPrinter>
 #include <QNetworkAccessManager>
+#include <QFutureWatcher>
+#include <QJsonObject>
+
+#include <functional>
 
 #include "fritzingwindow.h"
 #include "sketchareawidget.h"
@@ -180,9 +184,9 @@ public:
 	// if we consider a part as the smallest ("atomic") entity inside
 	// fritzing, then this functions may help with the bundle tasks
 	// on the complex entities: sketches, bins, modules (?)
-	void saveBundledNonAtomicEntity(QString &filename, const QString &extension, Bundler *bundler, const QList<ModelPart*> &partsToSave, bool askForFilename, const QString & destFolderPath, bool saveModel, bool deleteLeftovers);
+	void saveBundledNonAtomicEntity(QString &filename, const QString &extension, Bundler *bundler, const QList<ModelPart*> &partsToSave, bool askForFilename, const QString & destFolderPath, bool saveModel, bool deleteLeftovers, const QHash<QString, QByteArray> & entries = QHash<QString, QByteArray>(), bool background = false);
 	bool loadBundledNonAtomicEntity(const QString &filename, Bundler *bundler, bool addToBin, bool dontAsk);
-	void saveAsShareable(const QString & path, bool saveModel);
+	void saveAsShareable(const QString & path, bool saveModel, const QHash<QString, QByteArray> & entries = QHash<QString, QByteArray>(), bool background = false);
 
 
 	void setCurrentFile(const QString &fileName, bool addToRecent, bool setAsLastOpened);
@@ -193,6 +197,7 @@ public:
 	class PCBSketchWidget * pcbView();
 	void noBackup();
 	void swapSelectedAux(ItemBase * itemBase, const QString & moduleID, bool useViewLayerPlacement, ViewLayer::ViewLayerPlacement, QMap<QString, QString> & propsMap);
+	bool swapInPlace(ItemBase * itemBase, const QString & moduleID);
 	void swapLayers(ItemBase * itemBase, int layers, const QString & msg);
 	bool saveAsAux(const QString & fileName);
 	void swapObsolete(bool displayFeedback, QList<ItemBase *> &);
@@ -203,7 +208,7 @@ public:
 	void groundFill(ViewLayer::ViewLayerID);
 	void copperFill(ViewLayer::ViewLayerID);
 	bool hasAnyAlien();
-	void exportSvg(double res, bool selectedItems, bool flatten, const QString & filename);
+	void exportSvg(double res, bool selectedItems, bool flatten, const QString & filename, bool shareParts = false);
 	void setCurrentView(ViewLayer::ViewID);
 	bool usesPart(const QString & moduleID);
 	bool anyUsePart(const QString & moduleID);
@@ -218,10 +223,13 @@ public:
 	void setInitialTab(int);
 	void noSchematicConversion();
 	QString getExportBOM_CSV();
-	QString getSpiceNetlist(QString, QList< QList<class ConnectorItem *>* >&, QSet<class ItemBase *>& );
+	QString getSpiceNetlist(QString, QList< QList<class ConnectorItem *>* >&, QSet<class ItemBase *>&, const QString & analysis = ".OP");
 	bool isSimulatorEnabled();
 	void enableSimulator(bool);
 	void triggerSimulator();
+	class Simulator * simulator();
+	QJsonObject memoryReport();
+	QJsonObject renderTimings();
 
 public:
 	static void initNames();
@@ -238,6 +246,7 @@ Q_SIGNALS:
 public Q_SLOTS:
 	void ensureClosable();
 	QList<ModelPart*> loadBundledPart(const QString &fileName, bool addToBin);
+	QList<ModelPart*> loadBundledParts(const QStringList &fileNames, bool addToBin);
 	QList<ModelPart *> loadPart(const QString &fileName, bool addToBin);
 	void acceptAlienFiles();
 	void statusMessage(QString message, int timeout);
@@ -245,6 +254,7 @@ public Q_SLOTS:
 	void groundFill();
 	void removeGroundFill();
 	void copperFill();
+	void copperRefill();
 	void setOneGroundFillSeed();
 	void setGroundFillSeeds();
 	void clearGroundFillSeeds();
@@ -312,6 +322,8 @@ protected Q_SLOTS:
 	void togglePartLibrary(bool toggle);
 	void toggleInfo(bool toggle);
 	void toggleUndoHistory(bool toggle);
+	void undo();
+	void redo();
 	void toggleDebuggerOutput(bool toggle);
 	void openHelp();
 	void openExamples();
@@ -360,6 +372,8 @@ protected Q_SLOTS:
 	void updateItemMenu();
 
 	void newAutoroute();
+	void incrementalAutoroute();
+	void autorouteAllBoards();
 	void orderFab();
 	void activeLayerTop();
 	void activeLayerBottom();
@@ -379,6 +393,7 @@ protected Q_SLOTS:
 	void shareOnline();
 	void saveBundledPart(const QString &moduleId=___emptyString___);
 	QStringList saveBundledAux(ModelPart *mp, const QDir &destFolder);
+	QList<QPair<QString, QString>> bundledPartFiles(ModelPart *mp);
 
 	void binSaved(bool hasAlienParts);
 	void routingStatusSlot(class SketchWidget *, const RoutingStatus &);
@@ -391,6 +406,10 @@ protected Q_SLOTS:
 	void addNote();
 	void reportBug();
 	void enableDebug();
+	void toggleProfileOverlay();
+	void showProfile(bool);
+	void saveProfileTrace();
+	void showMemoryReport();
 	void tidyWires();
 	void changeWireColor(bool checked);
 
@@ -401,6 +420,7 @@ protected Q_SLOTS:
 	void obsoleteSMDOrientationSlot();
 	void exportNormalizedSVG();
 	void exportNormalizedFlattenedSVG();
+	void exportSharedSvg();
 	void dumpAllParts();
 	void testConnectors();
 
@@ -417,12 +437,14 @@ protected Q_SLOTS:
 	void openProgramWindow();
 	void linkToProgramFile(const QString & filename, Platform * platform, bool addLink, bool strong);
 	QStringList newDesignRulesCheck();
+	void liveDesignRulesCheck(bool);
 	void subSwapSlot(SketchWidget *, ItemBase *, const QString & newModuleID, ViewLayer::ViewLayerPlacement, long & newID, QUndoCommand * parentCommand);
 	void updateLayerMenuSlot();
 	bool save();
 	bool saveAs();
 	virtual void backupSketch();
 	void undoStackCleanChanged(bool isClean);
+	void backgroundSaveFinished();
 	void autosaveNeeded(int index = 0);
 	void changeTraceLayer();
 	void routingStatusLabelMousePress(QMouseEvent*);
@@ -456,9 +478,20 @@ protected Q_SLOTS:
 	void updateWelcomeViewRecentList(bool doEmit = true);
 	virtual void initZoom();
 	void onShareOnlineFinished();
+	void loadDeferredViews();
+	void flushDeferredRoutingStatus();
+
+protected:
+	struct BundleFile {
+		QString name;					// in the archive
+		QString path;					// on disk
+		bool required = true;			// a missing linked program or part file doesn't fail the save
+	};
 
 protected:
 	void initSketchWidget(SketchWidget *);
+	bool deferViewLoading(const QList<ModelPart *> &, bool checkObsolete, bool migratePartLabelOffset);
+	void loadDeferredView(SketchWidget *);
 	virtual void initProgrammingWidget();
 
 	virtual void createActions();
@@ -483,9 +516,14 @@ protected:
 	virtual void connectPairs();
 	void connectPair(SketchWidget * signaller, SketchWidget * slotter);
 	void closeEvent(QCloseEvent * event);
-	void saveAsAuxAux(const QString & fileName);
+	bool saveAsAuxAux(const QString & fileName);
+	QStringList saveBundledAux(ModelPart *mp, QList<BundleFile> &);
+	static bool writeBundle(const QString & path, const QHash<QString, QByteArray> & entries, const QList<BundleFile> & files, const std::function<void(int)> & progress);
+	void startBackgroundSave(const QString & path, const QHash<QString, QByteArray> & entries, const QList<BundleFile> & files);
+	void waitForBackgroundSave();
 	void printAux(QPrinter &printer, bool removeBackground, bool paginate);
 	void exportAux(QString fileName, QImage::Format format, int quality, bool removeBackground);
+	bool exportBands(const QString & fileName, const QRectF & source, const QSize & imgSize, int dpi, int quality, bool removeBackground);
 	QRectF prepareExport(bool removeBackground);
 	void transformPainter(QPainter &painter, qreal width);
 	void afterExport(bool removeBackground);
@@ -493,12 +531,12 @@ protected:
 	bool eventFilter(QObject *obj, QEvent *event);
 	void setActionsIcons(int index, QList<QAction *> &);
 	void exportToEagle();
-	void exportToGerber();
+	void exportToGerber(bool toZip = false);
 	void exportBOM();
 	void exportBOM_CSV();	
 	void exportNetlist();
 	void exportSpiceNetlist();
-	void exportSvg(double res, bool selectedItems, bool flatten);
+	void exportSvg(double res, bool selectedItems, bool flatten, bool shareParts = false);
 	void exportSvgWatermark(QString & svg, double res);
 	void exportEtchable(bool wantPDF, bool wantSVG);
 
@@ -515,6 +553,9 @@ protected:
 	bool undoStackIsEmpty();
 
 	void createTraceMenuActions();
+	void autoroute(bool incremental);
+	int verifyRoute(class PCBSketchWidget *, ItemBase * board, const QRectF & routedRegion);
+	void reportRouteCheck(int overlaps);
 	void hideShowTraceMenu();
 	void hideShowProgramMenu();
 	void updatePCBTraceMenu(QGraphicsItem *, TraceMenuThing &);
@@ -522,6 +563,9 @@ protected:
 	QList<ModelPart*> moveToPartsFolder(QDir &unzipDir, MainWindow* mw, bool addToBin, bool addToAlien, const QString & prefixFolder, const QString &destFolder, bool importingSinglePart);
 	QString copyToSvgFolder(const QFileInfo& file, bool addToAlien, const QString & prefixFolder, const QString &destFolder);
 	ModelPart* copyToPartsFolder(const QFileInfo& file, bool addToAlien, const QString & prefixFolder, const QString &destFolder);
+	static QString svgFolderPath(const QString & zipName, const QString & prefixFolder, const QString &destFolder);
+	static QString partsFolderPath(const QString & zipName, const QString & prefixFolder, const QString &destFolder);
+	bool writeToPartsFolder(const QString & destFilePath, const QByteArray & data);
 
 	void closeIfEmptySketch(MainWindow* mw);
 	bool whatToDoWithAlienFiles();
@@ -588,6 +632,7 @@ protected:
 	ModelPart * findReplacedby(ModelPart * originalModelPart);
 	void groundFillAux(bool fillGroundTraces, ViewLayer::ViewLayerID viewLayerID);
 	void groundFillAux2(bool fillGroundTraces);
+	ViewLayer::ViewLayerID activeFillLayer();
 	void connectStartSave(bool connect);
 	void loadBundledSketch(const QString &fileName, bool addToRecent, bool setAsLastOpened, bool checkObsolete);
 	void dropEvent(QDropEvent *event);
@@ -739,6 +784,7 @@ protected:
 	QAction *m_exportPdfAct = nullptr;
 	QAction *m_exportEagleAct = nullptr;
 	QAction *m_exportGerberAct = nullptr;
+	QAction *m_exportGerberZipAct = nullptr;
 	QAction *m_exportEtchablePdfAct = nullptr;
 	QAction *m_exportEtchableSvgAct = nullptr;
 	QAction *m_exportBomAct = nullptr;
@@ -747,6 +793,7 @@ protected:
 	QAction *m_exportNetlistAct = nullptr;
 	QAction *m_exportSpiceNetlistAct = nullptr;
 	QAction *m_exportSvgAct = nullptr;
+	QAction *m_exportSharedSvgAct = nullptr;
 
 	// Edit Menu
 	QMenu *m_editMenu = nullptr;
@@ -847,6 +894,8 @@ protected:
 	QMenu *m_schematicTraceMenu = nullptr;
 	QMenu *m_breadboardTraceMenu = nullptr;
 	QAction *m_newAutorouteAct = nullptr;
+	QAction *m_incrementalAutorouteAct = nullptr;
+	QAction *m_autorouteAllBoardsAct = nullptr;
 	QAction *m_orderFabAct = nullptr;
 	QAction *m_activeLayerTopAct = nullptr;
 	QAction *m_activeLayerBottomAct = nullptr;
@@ -873,11 +922,14 @@ protected:
 	QAction *m_groundFillAct = nullptr;
 	QAction *m_removeGroundFillAct = nullptr;
 	QAction *m_copperFillAct = nullptr;
+	QAction *m_copperRefillAct = nullptr;
 	class ConnectorItemAction *m_setOneGroundFillSeedAct = nullptr;
 	QAction *m_setGroundFillSeedsAct = nullptr;
 	QAction *m_clearGroundFillSeedsAct = nullptr;
 	QAction *m_setGroundFillKeepoutAct = nullptr;
 	QAction *m_newDesignRulesCheckAct = nullptr;
+	QAction *m_liveDesignRulesCheckAct = nullptr;
+	class LiveDRC * m_liveDRC = nullptr;
 	QAction *m_autorouterSettingsAct = nullptr;
 	QAction *m_fabQuoteAct = nullptr;
 	QAction *m_tidyWiresAct = nullptr;
@@ -892,6 +944,9 @@ protected:
 	QAction *m_aboutQtAct = nullptr;
 	QAction *m_reportBugAct = nullptr;
 	QAction *m_enableDebugAct = nullptr;
+	QAction *m_profileOverlayAct = nullptr;
+	QAction *m_saveProfileTraceAct = nullptr;
+	QAction *m_memoryReportAct = nullptr;
 	QAction *m_partsEditorHelpAct = nullptr;
 	QAction *m_tipsAndTricksAct = nullptr;
 	QAction *m_firstTimeHelpAct = nullptr;
@@ -933,6 +988,9 @@ protected:
 	QPointer<class ProgramWindow> m_programView;
 	QList<LinkedFile *>  m_linkedProgramFiles;
 	QString m_backupFileNameAndPath;
+	QScopedPointer<class BackupJournal> m_backupJournal;
+	QFutureWatcher<bool> m_backgroundSave;
+	QString m_backgroundSavePath;			// the .fzz still being written on a worker thread
 	QTimer m_autosaveTimer;
 	QTimer m_fireQuoteTimer;
 	bool m_autosaveNeeded = false;
@@ -961,6 +1019,8 @@ protected:
 	bool m_dontKeepMargins = false;
 	QPointer<QDialog> m_rolloverQuoteDialog;
 	bool m_obsoleteSMDOrientation = false;
+	QList<SketchWidget *> m_deferredViews;          // not built yet, see deferViewLoading
+	QList<ModelPart *> m_deferredModelParts;
 	QWidget * m_orderFabButton = nullptr;
 	int m_fireQuoteDelay = 0;
 
@@ -978,6 +1038,7 @@ public:
 	static const int DockMinHeight;
 
 	QString exportIPC_D_356A();
+	bool exportIPC_D_356A(const QString & fileName);
 protected:
 	static const QString UntitledSketchName;
 	static int UntitledSketchIndex;
@@ -985,6 +1046,7 @@ protected:
 	static int CascadeFactorY;
 	static QRegularExpression GuidMatcher;
 	void exportIPC_D_356A_interactive();
+	void collectIPCNets(QList< QList<class ConnectorItem *>* > &);
 };
 
 #endif
@@ -29,6 +29,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QPrintDialog>
 #include <QClipboard>
 #include <QApplication>
+#include <QtConcurrentRun>
+#include <QtConcurrentMap>
+#include <QPdfWriter>
 
 #include "mainwindow.h"
 #include "../debugdialog.h"
@@ -45,6 +48,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/folderutils.h"
 #include "../utils/graphicsutils.h"
 #include "../utils/textutils.h"
+#include "../utils/zipwriter.h"
+#include "../utils/pngbandwriter.h"
+#include "../utils/lockmanager.h"
 #include "../connectors/ercdata.h"
 #include "../program/programwindow.h"
 #include "../svg/gerbergenerator.h"
@@ -52,8 +58,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/propertydef.h"
 #include "src/ipc/ipc_d_356.h"
 
-static QString eagleActionType = ".eagle";
+static QString eagleActionType = ".brd";
 static QString gerberActionType = ".gerber";
+static QString gerberZipActionType = ".gerberzip";
 static QString jpgActionType = ".jpg";
 static QString pdfActionType = ".pdf";
 static QString pngActionType = ".png";
@@ -72,6 +79,7 @@ static QRegularExpression AaCc("[aAcC]");
 static QRegularExpression LabelNumber("([^\\d]+)(.*)");
 
 static constexpr double InchesPerMeter = 39.3700787;
+static constexpr qint64 ExportBandBytes = 64 * 1024 * 1024;		// larger PNG exports are rendered a band at a time
 
 ////////////////////////////////////////////////////////
 
@@ -119,6 +127,7 @@ void MainWindow::initNames()
 	fileExtFormats[bomActionType] = tr("BoM Text File (*.html)");
 	fileExtFormats[bomCsvActionType] = tr("BoM CSV File (*.csv)");
 	fileExtFormats[ipcActionType] = tr("IPC-D-356 File (*.ipc)");
+	fileExtFormats[eagleActionType] = tr("Eagle Board File (*.brd)");
 
 	QSettings settings;
 	AutosaveEnabled = settings.value("autosaveEnabled", QString("%1").arg(AutosaveEnabled)).toBool();
@@ -126,6 +135,8 @@ void MainWindow::initNames()
 }
 
 void MainWindow::print() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	if (m_currentWidget->contentView() == m_programView) {
 		m_programView->print();
 	}
@@ -154,8 +165,35 @@ void MainWindow::exportEtchable() {
 }
 
 
+struct EtchablePage {
+	QString fileName;
+	QString svg;
+	QRectF target;
+	int res;
+};
+
+static bool renderEtchablePage(const EtchablePage & page)
+{
+	QSvgRenderer svgRenderer;
+	svgRenderer.load(page.svg.toLatin1());
+
+	// QPrinter asks the platform for a default printer, so write the pdf directly on this thread
+	QPdfWriter pdfWriter(page.fileName);
+	pdfWriter.setResolution(page.res);
+	pdfWriter.setPageMargins(QMarginsF(0, 0, 0, 0));
+	pdfWriter.setPageSize(QPageSize(page.target.size() / page.res, QPageSize::Inch));
+
+	QPainter painter;
+	if (!painter.begin(&pdfWriter)) return false;
+
+	svgRenderer.render(&painter, page.target);
+	return painter.end();
+}
+
 void MainWindow::exportEtchable(bool wantPDF, bool wantSVG)
 {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	int boardCount;
 	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
 	if (boardCount == 0) {
@@ -219,6 +257,21 @@ void MainWindow::exportEtchable(bool wantPDF, bool wantSVG)
 	fileNames.append(exportDir + "/" + constructFileName(prefix + "etch_silk_top%1", suffix));
 	fileNames.append(exportDir + "/" + constructFileName(prefix + "etch_silk_bottom%1", suffix));
 
+	int res = GraphicsUtils::IllustratorDPI;
+	QRectF target;
+	QList<EtchablePage> pages;
+	if (wantPDF) {
+		QPrinter printer(QPrinter::HighResolution);
+		printer.setOutputFormat(filePrintFormats[fileExt]);
+		res = printer.resolution();
+		double trueWidth = boardImageSize.width() / GraphicsUtils::SVGDPI;
+		double trueHeight = boardImageSize.height() / GraphicsUtils::SVGDPI;
+		target = QRectF(0, 0, trueWidth * res, trueHeight * res);
+	}
+
+	// copper shows up again in the masks, and most items are unchanged between exports, so their
+	// fragments are kept; svg and pdf renders differ in dpi, so each has its own cache
+	QString cacheName = QString("etchable %1").arg(wantSVG ? GraphicsUtils::IllustratorDPI : res);
 	QString maskTop, maskBottom;
 	QList<ItemBase *> copperLogoItems, holes;
 	for (int ix = 0; ix < fileNames.count(); ix++) {
@@ -266,6 +319,7 @@ void MainWindow::exportEtchable(bool wantPDF, bool wantSVG)
 			renderThing.dpi = GraphicsUtils::IllustratorDPI;
 			renderThing.hideTerminalPoints = true;
 			renderThing.selectedItems = renderThing.renderBlocker = false;
+			renderThing.cache = m_pcbGraphicsView->renderCache(cacheName);
 			QString svg = m_pcbGraphicsView->renderToSVG(renderThing, board, viewLayerIDs);
 			massageOutput(svg, doMask, doSilk, doPaste, maskTop, maskBottom, fileName, board, GraphicsUtils::IllustratorDPI, viewLayerIDs);
 			QString merged = mergeBoardSvg(svg, board, GraphicsUtils::IllustratorDPI, false, viewLayerIDs);
@@ -278,48 +332,26 @@ void MainWindow::exportEtchable(bool wantPDF, bool wantSVG)
 			}
 		}
 		else {
-			QString svg;
+			// the scene is read here, one layer at a time; the pages are rasterized together below
+			RenderThing renderThing;
+			renderThing.printerScale = GraphicsUtils::SVGDPI;
+			renderThing.blackOnly = true;
+			renderThing.dpi = res;
+			renderThing.hideTerminalPoints = true;
+			renderThing.selectedItems = renderThing.renderBlocker = false;
+			renderThing.cache = m_pcbGraphicsView->renderCache(cacheName);
+			QString svg = m_pcbGraphicsView->renderToSVG(renderThing, board, viewLayerIDs);
+			massageOutput(svg, doMask, doSilk, doPaste, maskTop, maskBottom, fileName, board, res, viewLayerIDs);
+
 			QList<bool> flips;
 			flips << false << true;
 			Q_FOREACH (bool flip, flips) {
-				QString mirror = flip ? "_mirror" : "";
-				QPrinter printer(QPrinter::HighResolution);
-				printer.setOutputFormat(filePrintFormats[fileExt]);
-				printer.setOutputFileName(fileName.arg(mirror));
-				int res = printer.resolution();
-
-				if (svg.isEmpty()) {
-					RenderThing renderThing;
-					renderThing.printerScale = GraphicsUtils::SVGDPI;
-					renderThing.blackOnly = true;
-					renderThing.dpi = res;
-					renderThing.hideTerminalPoints = true;
-					renderThing.selectedItems = renderThing.renderBlocker = false;
-					svg = m_pcbGraphicsView->renderToSVG(renderThing, board, viewLayerIDs);
-					massageOutput(svg, doMask, doSilk, doPaste, maskTop, maskBottom, fileName, board, res, viewLayerIDs);
-				}
-
-				QString merged = mergeBoardSvg(svg, board, res, flip, viewLayerIDs);
-
-				// now convert to pdf
-				QSvgRenderer svgRenderer;
-				svgRenderer.load(merged.toLatin1());
-				double trueWidth = boardImageSize.width() / GraphicsUtils::SVGDPI;
-				double trueHeight = boardImageSize.height() / GraphicsUtils::SVGDPI;
-				QRectF target(0, 0, trueWidth * res, trueHeight * res);
-
-				QSizeF psize((target.width() + printer.pageLayout().fullRectPixels(printer.resolution()).width() - printer.width()) / res,
-				             (target.height() + printer.pageLayout().fullRectPixels(printer.resolution()).height() - printer.height()) / res);
-				QPageSize pageSize(psize, QPageSize::Inch);
-				printer.setPageSize(pageSize);
-
-				QPainter painter;
-				if (painter.begin(&printer))
-				{
-					svgRenderer.render(&painter, target);
-				}
-
-				painter.end();
+				EtchablePage page;
+				page.fileName = fileName.arg(flip ? "_mirror" : "");
+				page.svg = mergeBoardSvg(svg, board, res, flip, viewLayerIDs);
+				page.target = target;
+				page.res = res;
+				pages.append(page);
 			}
 		}
 		if (doMask) {
@@ -331,6 +363,19 @@ void MainWindow::exportEtchable(bool wantPDF, bool wantSVG)
 
 	}
 
+	int reused = 0;
+	int fresh = 0;
+	QHash<int, QRectF> dirty = m_pcbGraphicsView->takeRenderCacheDirt(cacheName, reused, fresh);
+	DebugDialog::debug(QString("etchable render cache: %1 fragments kept, %2 rendered, %3 layers changed").arg(reused).arg(fresh).arg(dirty.count()));
+
+	// each page has its own renderer and pdf writer, so they are rasterized in parallel
+	QList<bool> rendered = QtConcurrent::blockingMapped(pages, renderEtchablePage);
+	for (int ix = 0; ix < rendered.count(); ix++) {
+		if (!rendered.at(ix)) {
+			DebugDialog::debug(QString("unable to export %1").arg(pages.at(ix).fileName));
+		}
+	}
+
 	m_statusBar->showMessage(tr("Sketch exported"), 2000);
 	delete fileProgressDialog;
 
@@ -473,6 +518,8 @@ QString MainWindow::getBoardSvg(ItemBase * board, int res,  LayerList & viewLaye
 
 
 void MainWindow::doExport() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	auto * action = qobject_cast<QAction *>(sender());
 	if (action == nullptr) return;
 
@@ -489,6 +536,11 @@ void MainWindow::doExport() {
 		return;
 	}
 
+	if (actionType.compare(gerberZipActionType) == 0) {
+		exportToGerber(true);
+		return;
+	}
+
 	if (actionType.compare(bomActionType) == 0) {
 		exportBOM();
 		return;
@@ -577,7 +629,22 @@ void MainWindow::exportAux(QString fileName, QImage::Format format, int quality,
 	double resMultiplier = dpi / GraphicsUtils::SVGDPI;
 
 	QSize imgSize(source.width() * resMultiplier, source.height() * resMultiplier);
+	if (format == QImage::Format_ARGB32 && (qint64) imgSize.width() * imgSize.height() * 4 > ExportBandBytes) {
+		// too big to hold whole: render and write the PNG a band at a time
+		bool result = exportBands(fileName, source, imgSize, dpi, quality, removeBackground);
+		afterExport(removeBackground);
+		if (!result) {
+			QMessageBox::warning(this, tr("Fritzing"), tr("Unable to save %1").arg(fileName) );
+		}
+		return;
+	}
+
 	QImage image(imgSize, format);
+	if (image.isNull()) {
+		afterExport(removeBackground);
+		QMessageBox::warning(this, tr("Fritzing"), tr("Unable to save %1: the image is too large at %2 dpi").arg(fileName).arg(dpi) );
+		return;
+	}
 	image.setDotsPerMeterX(InchesPerMeter * dpi);
 	image.setDotsPerMeterY(InchesPerMeter * dpi);
 	if (removeBackground) {
@@ -606,6 +673,56 @@ void MainWindow::exportAux(QString fileName, QImage::Format format, int quality,
 	}
 }
 
+bool MainWindow::exportBands(const QString & fileName, const QRectF & source, const QSize & imgSize, int dpi, int quality, bool removeBackground)
+{
+	// the same mapping from source to image as a single render, so bands meet without seams
+	int bandHeight = qMax(1, (int) (ExportBandBytes / (imgSize.width() * 4)));
+	double sourcePerPixel = source.height() / imgSize.height();
+
+	// the way QImageWriter maps quality to a PNG compression level
+	int compression = (100 - qBound(0, quality, 100)) * 9 / 91;
+	PngBandWriter writer;
+	if (!writer.open(fileName, imgSize, true, qRound(InchesPerMeter * dpi), TextUtils::CreatedWithFritzingString, compression)) {
+		DebugDialog::debug(QString("unable to export %1: %2").arg(fileName, writer.errorString()));
+		return false;
+	}
+
+	QImage band(imgSize.width(), bandHeight, QImage::Format_ARGB32);
+	if (band.isNull()) return false;
+
+	for (int top = 0; top < imgSize.height(); top += bandHeight) {
+		int height = qMin(bandHeight, imgSize.height() - top);
+		if (height < band.height()) {
+			band = QImage(imgSize.width(), height, QImage::Format_ARGB32);
+		}
+		if (removeBackground) {
+			band.fill(QColor::fromRgb(255,255,255,255));
+		} else {
+			band.fill(m_currentGraphicsView->background());
+		}
+
+		QPainter painter;
+		painter.begin(&band);
+		QRectF target(0, 0, imgSize.width(), height);
+		QRectF bandSource(source.x(), source.y() + top * sourcePerPixel, source.width(), height * sourcePerPixel);
+		transformPainter(painter, target.width());
+		m_currentGraphicsView->scene()->render(&painter, target, bandSource, Qt::IgnoreAspectRatio);
+		painter.end();
+
+		if (!writer.writeBand(band)) {
+			DebugDialog::debug(QString("unable to export %1: %2").arg(fileName, writer.errorString()));
+			writer.close();
+			return false;
+		}
+	}
+
+	if (!writer.close()) {
+		DebugDialog::debug(QString("unable to export %1: %2").arg(fileName, writer.errorString()));
+		return false;
+	}
+	return true;
+}
+
 void MainWindow::printAux(QPrinter &printer, bool removeBackground, bool paginate) {
 	if (m_currentGraphicsView == nullptr) return;
 
@@ -768,6 +885,8 @@ void MainWindow::afterExport(bool removeBackground)
 
 
 bool MainWindow::saveAsAux(const QString & fileName) {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	QFile file(fileName);
 	if (!file.open(QFile::WriteOnly | QFile::Text)) {
 		QMessageBox::warning(this, tr("Fritzing"),
@@ -781,11 +900,13 @@ bool MainWindow::saveAsAux(const QString & fileName) {
 	setReadOnly(false);
 	//FritzingWindow::saveAsAux(fileName);
 
-	saveAsAuxAux(fileName);
+	bool background = saveAsAuxAux(fileName);
 	m_autosaveNeeded = false;
 	undoStackCleanChanged(true);
 
-	m_statusBar->showMessage(tr("Saved '%1'").arg(fileName), 2000);
+	if (!background) {
+		m_statusBar->showMessage(tr("Saved '%1'").arg(fileName), 2000);
+	}
 	setCurrentFile(fileName, true, true);
 
 	if(m_restarting && !m_fwFilename.isEmpty()) {
@@ -804,7 +925,9 @@ bool MainWindow::saveAsAux(const QString & fileName) {
 	return true;
 }
 
-void MainWindow::saveAsAuxAux(const QString & fileName) {
+bool MainWindow::saveAsAuxAux(const QString & fileName) {
+	// returns true when the archive is still being written on a worker thread
+	waitForBackgroundSave();
 	QApplication::setOverrideCursor(Qt::WaitCursor);
 
 	connectStartSave(true);
@@ -820,19 +943,37 @@ void MainWindow::saveAsAuxAux(const QString & fileName) {
 	}
 
 	QString fzName = dir.absoluteFilePath(QFileInfo(fileName).completeBaseName() + FritzingSketchExtension);
-	m_sketchModel->save(fzName, false);
+	QHash<QString, QByteArray> entries;
+	bool bundle = alreadyHasExtension(fileName, FritzingBundleExtension);
+	if (bundle) {
+		// the sketch goes from memory straight into the archive
+		QByteArray contents;
+		QBuffer buffer(&contents);
+		buffer.open(QIODevice::WriteOnly);
+		QXmlStreamWriter streamWriter(&buffer);
+		m_sketchModel->save(fzName, streamWriter, false);
+		buffer.close();
+		entries.insert(QFileInfo(fzName).fileName(), contents);
+	}
+	else {
+		m_sketchModel->save(fzName, false);
+	}
 
 	saveLastTabList();
 
-	saveAsShareable(fileName, false);
+	// an interactive .fzz save only snapshots the sketch here; the user can go on editing while
+	// the archive is compressed and written
+	saveAsShareable(fileName, false, entries, bundle && isVisible());
 
 	connectStartSave(false);
 
 	QApplication::restoreOverrideCursor();
+
+	return !m_backgroundSavePath.isEmpty();
 }
 
 
-void MainWindow::saveAsShareable(const QString & path, bool saveModel)
+void MainWindow::saveAsShareable(const QString & path, bool saveModel, const QHash<QString, QByteArray> & entries, bool background)
 {
 	QString filename = path;
 	QHash<QString, ModelPart *> saveParts;
@@ -848,15 +989,15 @@ void MainWindow::saveAsShareable(const QString & path, bool saveModel)
 		saveParts.insert(itemBase->moduleID(), itemBase->modelPart());
 	}
 	if(alreadyHasExtension(filename, FritzingSketchExtension)) {
-		saveBundledNonAtomicEntity(filename, FritzingSketchExtension, this, saveParts.values(), false, m_fzzFolder, saveModel, true);
+		saveBundledNonAtomicEntity(filename, FritzingSketchExtension, this, saveParts.values(), false, m_fzzFolder, saveModel, true, entries, background);
 	} else {
-		saveBundledNonAtomicEntity(filename, FritzingBundleExtension, this, saveParts.values(), false, m_fzzFolder, saveModel, true);
+		saveBundledNonAtomicEntity(filename, FritzingBundleExtension, this, saveParts.values(), false, m_fzzFolder, saveModel, true, entries, background);
 	}
 
 }
 
-void MainWindow::saveBundledNonAtomicEntity(QString &filename, const QString &extension, Bundler *bundler, const QList<ModelPart*> &partsToSave, bool askForFilename, const QString & destFolderPath, bool saveModel, bool deleteLeftovers) {
-	bool result;
+void MainWindow::saveBundledNonAtomicEntity(QString &filename, const QString &extension, Bundler *bundler, const QList<ModelPart*> &partsToSave, bool askForFilename, const QString & destFolderPath, bool saveModel, bool deleteLeftovers, const QHash<QString, QByteArray> & entries, bool background) {
+	bool result = true;
 	QStringList names;
 
 	QString fileExt;
@@ -867,7 +1008,11 @@ void MainWindow::saveBundledNonAtomicEntity(QString &filename, const QString &ex
 
 	if (bundledFileName.isEmpty()) return; // Cancel pressed
 
-	FileProgressDialog progress("Saving...", 0, this);
+	background = background && !destFolderPath.isEmpty();
+	QScopedPointer<FileProgressDialog> progress;
+	if (!background) {
+		progress.reset(new FileProgressDialog("Saving...", 0, this));
+	}
 
 	if(!alreadyHasExtension(bundledFileName, extension)) {
 		bundledFileName += extension;
@@ -897,46 +1042,136 @@ void MainWindow::saveBundledNonAtomicEntity(QString &filename, const QString &ex
 	DebugDialog::debug("saving entity temporarily to "+destSketchPath);
 
 	QStringList skipSuffixes;
-
-	if (extension.compare(FritzingBundleExtension) == 0 || \
-	        extension.compare(FritzingSketchExtension) == 0 ) {
-		for (int i = 0; i < m_linkedProgramFiles.count(); i++) {
-			LinkedFile * linkedFile = m_linkedProgramFiles.at(i);
-			QFileInfo fileInfo(linkedFile->linkedFilename);
-			QFile file(linkedFile->linkedFilename);
-			FolderUtils::slamCopy(file, destFolder.absoluteFilePath(fileInfo.fileName()));
-		}
+	bool bundle = fritzingBundleExtensions().contains(extension);
+	bool linkPrograms = extension.compare(FritzingBundleExtension) == 0 || extension.compare(FritzingSketchExtension) == 0;
+	if (linkPrograms) {
 		skipSuffixes << FritzingBinExtension << FritzingBundleExtension;
 	}
 
-	if (saveModel) {
-		QString prevFileName = filename;
+	if (bundle) {
+		// the archive's contents are gathered first: the entries made in memory, then linked programs
+		// and parts from where they are, then whatever else is in the folder
+		QList<BundleFile> files;
+		QSet<QString> fileNames;
+		for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+			fileNames.insert(it.key());
+		}
+
+		if (linkPrograms) {
+			for (int i = 0; i < m_linkedProgramFiles.count(); i++) {
+				LinkedFile * linkedFile = m_linkedProgramFiles.at(i);
+				BundleFile file;
+				file.name = QFileInfo(linkedFile->linkedFilename).fileName();
+				file.path = linkedFile->linkedFilename;
+				file.required = false;
+				if (fileNames.contains(file.name)) continue;
+
+				fileNames.insert(file.name);
+				files.append(file);
+			}
+		}
+
+		if (saveModel) {
+			QString prevFileName = filename;
+			ProcessEventBlocker::processEvents();
+			bundler->saveAsAux(destSketchPath);
+			filename = prevFileName;
+		}
+
+		QList<BundleFile> partFiles;
+		Q_FOREACH(ModelPart* mp, partsToSave) {
+			names.append(saveBundledAux(mp, partFiles));
+		}
+		Q_FOREACH (const BundleFile & file, partFiles) {
+			if (fileNames.contains(file.name)) continue;
+
+			fileNames.insert(file.name);
+			files.append(file);
+		}
+
 		ProcessEventBlocker::processEvents();
-		bundler->saveAsAux(destSketchPath);
-		filename = prevFileName;
-	}
 
-	Q_FOREACH(ModelPart* mp, partsToSave) {
-		names.append(saveBundledAux(mp, destFolder));
-	}
+		QStringList partSuffixes;
+		partSuffixes << FritzingPartExtension << ".svg";
+		QFileInfoList folderFiles = destFolder.entryInfoList(QDir::Files | QDir::NoSymLinks);
+		Q_FOREACH (QFileInfo file, folderFiles) {
+			QString name = file.fileName();
+			if (fileNames.contains(name)) continue;
+			if (name.contains(LockManager::LockedFileName)) continue;
+			if (file.absoluteFilePath().startsWith(QFileInfo(bundledFileName).absoluteFilePath())) continue;     // the archive and its temporary file
+
+			bool skip = false;
+			Q_FOREACH (QString suffix, skipSuffixes) {
+				if (name.endsWith(suffix)) {
+					skip = true;
+					break;
+				}
+			}
+			if (skip) continue;
 
-	if (deleteLeftovers) {
-		QStringList nameFilters;
-		nameFilters << ("*" + FritzingPartExtension) << "*.svg";
-		QDir dir(destFolder);
-		QStringList fileList = dir.entryList(nameFilters, QDir::Files | QDir::NoSymLinks);
-		Q_FOREACH (QString fileName, fileList) {
-			if (!names.contains(fileName)) {
-				QFile::remove(dir.absoluteFilePath(fileName));
+			if (deleteLeftovers && !names.contains(name)) {
+				bool leftover = false;
+				Q_FOREACH (QString suffix, partSuffixes) {
+					if (name.endsWith(suffix)) {
+						leftover = true;
+						break;
+					}
+				}
+				if (leftover) {
+					QFile::remove(file.absoluteFilePath());
+					continue;
+				}
 			}
+
+			BundleFile bundleFile;
+			bundleFile.name = name;
+			bundleFile.path = file.absoluteFilePath();
+			fileNames.insert(name);
+			files.append(bundleFile);
+		}
+
+		if (background) {
+			startBackgroundSave(bundledFileName, entries, files);
+			return;
 		}
+
+		result = writeBundle(bundledFileName, entries, files, std::function<void(int)>());
 	}
+	else {
+		if (linkPrograms) {
+			for (int i = 0; i < m_linkedProgramFiles.count(); i++) {
+				LinkedFile * linkedFile = m_linkedProgramFiles.at(i);
+				QFileInfo fileInfo(linkedFile->linkedFilename);
+				QFile file(linkedFile->linkedFilename);
+				FolderUtils::slamCopy(file, destFolder.absoluteFilePath(fileInfo.fileName()));
+			}
+		}
 
-	ProcessEventBlocker::processEvents();
+		if (saveModel) {
+			QString prevFileName = filename;
+			ProcessEventBlocker::processEvents();
+			bundler->saveAsAux(destSketchPath);
+			filename = prevFileName;
+		}
+
+		Q_FOREACH(ModelPart* mp, partsToSave) {
+			names.append(saveBundledAux(mp, destFolder));
+		}
+
+		if (deleteLeftovers) {
+			QStringList nameFilters;
+			nameFilters << ("*" + FritzingPartExtension) << "*.svg";
+			QDir dir(destFolder);
+			QStringList fileList = dir.entryList(nameFilters, QDir::Files | QDir::NoSymLinks);
+			Q_FOREACH (QString fileName, fileList) {
+				if (!names.contains(fileName)) {
+					QFile::remove(dir.absoluteFilePath(fileName));
+				}
+			}
+		}
+
+		ProcessEventBlocker::processEvents();
 
-	if (fritzingBundleExtensions().contains(extension)) {
-		result = FolderUtils::createZipAndSaveTo(destFolder, bundledFileName, skipSuffixes);
-	} else {
 		result = FolderUtils::createFZAndSaveTo(destFolder, bundledFileName, skipSuffixes);
 	}
 
@@ -954,6 +1189,85 @@ void MainWindow::saveBundledNonAtomicEntity(QString &filename, const QString &ex
 }
 
 
+bool MainWindow::writeBundle(const QString & path, const QHash<QString, QByteArray> & entries, const QList<BundleFile> & files, const std::function<void(int)> & progress) {
+	// touches no model or scene state, so it may run on a worker thread; progress gets a percentage
+	ZipWriter zipWriter(path);
+	if (!zipWriter.open()) return false;
+
+	int total = entries.count() + files.count();
+	int done = 0;
+	int percent = -1;
+	auto step = [&]() {
+		done++;
+		int now = done * 100 / qMax(1, total);
+		if (progress && now != percent) {
+			percent = now;
+			progress(percent);
+		}
+	};
+
+	for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+		if (!zipWriter.addEntry(it.key(), it.value())) return false;
+		step();
+	}
+
+	Q_FOREACH (const BundleFile & file, files) {
+		if (!zipWriter.addFile(file.name, file.path) && file.required) {
+			DebugDialog::debug(QString("unable to bundle %1: %2").arg(file.path, zipWriter.errorString()));
+			return false;
+		}
+		step();
+	}
+
+	return zipWriter.commit();
+}
+
+void MainWindow::startBackgroundSave(const QString & path, const QHash<QString, QByteArray> & entries, const QList<BundleFile> & files) {
+	m_backgroundSavePath = path;
+	QString name = QFileInfo(path).fileName();
+	m_statusBar->showMessage(tr("Saving '%1'...").arg(name));
+	m_backgroundSave.setFuture(QtConcurrent::run([this, path, name, entries, files]() {
+		return writeBundle(path, entries, files, [this, name](int percent) {
+			QMetaObject::invokeMethod(this, [this, name, percent]() {
+				if (m_backgroundSavePath.isEmpty()) return;
+
+				m_statusBar->showMessage(tr("Saving '%1'... %2%").arg(name).arg(percent));
+			}, Qt::QueuedConnection);
+		});
+	}));
+}
+
+void MainWindow::waitForBackgroundSave() {
+	if (m_backgroundSavePath.isEmpty()) return;
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	m_backgroundSave.waitForFinished();
+	QApplication::restoreOverrideCursor();
+	backgroundSaveFinished();
+}
+
+void MainWindow::backgroundSaveFinished() {
+	// called by the watcher, or directly by waitForBackgroundSave, whichever comes first
+	if (m_backgroundSavePath.isEmpty()) return;
+
+	QString path = m_backgroundSavePath;
+	m_backgroundSavePath.clear();
+	if (m_backgroundSave.future().result()) {
+		m_statusBar->showMessage(tr("Saved '%1'").arg(path), 2000);
+		return;
+	}
+
+	// the sketch was marked clean, and its backup dropped, when the save started
+	m_undoStack->resetClean();
+	m_autosaveNeeded = true;
+	m_statusBar->clearMessage();
+	QMessageBox::warning(
+	    this,
+	    tr("Fritzing"),
+	    tr("Unable to export %1 as shareable").arg(path)
+	);
+}
+
 void MainWindow::createExportActions() {
 
 	m_saveAct = new QAction(tr("&Save"), this);
@@ -990,6 +1304,10 @@ void MainWindow::createExportActions() {
 	m_exportSvgAct->setStatusTip(tr("Export the current sketch as an SVG image"));
 	connect(m_exportSvgAct, SIGNAL(triggered()), this, SLOT(doExport()));
 
+	m_exportSharedSvgAct = new QAction(tr("SVG with Shared Parts..."), this);
+	m_exportSharedSvgAct->setStatusTip(tr("Export the current sketch as an SVG image that draws each repeated part once and reuses it"));
+	connect(m_exportSharedSvgAct, SIGNAL(triggered()), this, SLOT(exportSharedSvg()));
+
 	m_exportBomAct = new QAction(tr("List of parts (&Bill of Materials)..."), this);
 	m_exportBomAct->setData(bomActionType);
 	m_exportBomAct->setStatusTip(tr("Save a Bill of Materials (BoM)/Shopping List as html"));
@@ -1025,6 +1343,11 @@ void MainWindow::createExportActions() {
 	m_exportGerberAct->setStatusTip(tr("Export the current sketch to Extended Gerber format (RS-274X) for professional PCB production"));
 	connect(m_exportGerberAct, SIGNAL(triggered()), this, SLOT(doExport()));
 
+	m_exportGerberZipAct = new QAction(tr("Extended Gerber (RS-274X) as zip..."), this);
+	m_exportGerberZipAct->setData(gerberZipActionType);
+	m_exportGerberZipAct->setStatusTip(tr("Export the current sketch to Extended Gerber format (RS-274X), all files in one zip ready for upload to a fab"));
+	connect(m_exportGerberZipAct, SIGNAL(triggered()), this, SLOT(doExport()));
+
 	m_exportEtchablePdfAct = new QAction(tr("Etchable (PDF)..."), this);
 	m_exportEtchablePdfAct->setStatusTip(tr("Export the current sketch to PDF for DIY PCB production (photoresist)"));
 	m_exportEtchablePdfAct->setProperty("svg", false);
@@ -1048,70 +1371,55 @@ void MainWindow::createExportActions() {
 }
 
 void MainWindow::exportToEagle() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 
-	QString text =
-	    tr("This will soon provide an export of your Fritzing sketch to the EAGLE layout "
-	       "software. If you'd like to have more exports to your favourite EDA tool, please let "
-	       "us know, or contribute.");
-	/*
-		QString text =
-			tr("The Eagle export module is very experimental.  If anything breaks or behaves "
-			"strangely, please let us know.");
-	*/
-
-	QMessageBox::information(this, tr("Fritzing"), text);
-
-	auto eagle = Fritzing2Eagle(m_pcbGraphicsView);
-	(void) eagle;
-
-	/*
-	QList <ItemBase*> partList;
-
-	// bail out if something is wrong
-	// TODO: show an error in QMessageBox
-	if(m_currentWidget == NULL) {
+	int boardCount;
+	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
+	if (boardCount == 0) {
+		QMessageBox::critical(this, tr("Fritzing"),
+		                      tr("Your sketch does not have a board yet!  Please add a PCB in order to export to Eagle."));
+		return;
+	}
+	if (board == nullptr) {
+		QMessageBox::critical(this, tr("Fritzing"),
+		                      tr("Eagle export can only handle one board at a time--please select the board you want to export."));
 		return;
 	}
 
-	m_pcbGraphicsView->collectParts(partList);
-
-	QString exportInfoString = tr("parts include:\n");
-	QString exportString = tr("GRID INCH 0.005\n");
-
-
-	for(int i=0; i < partList.size(); i++){
-		QString label = partList.at(i)->instanceTitle();
-		QString desc = partList.at(i)->title();
-
-		QHash<QString,QString> properties = partList.at(i)->modelPartShared()->properties();
-		QString package = properties["package"];
-		if (package == NULL) {
-			package = tr("*** package not specified ***");
-		}
+	QString fileExt;
+	QString fileName = FolderUtils::getSaveFileName(this,
+	                   tr("Export Eagle board..."),
+	                   defaultSaveFolder() + "/" + constructFileName("", eagleActionType),
+	                   fileExtFormats[eagleActionType],
+	                   &fileExt
+	                                               );
+	if (fileName.isEmpty()) return;
 
-		exportInfoString += label + tr(" which is a ") + desc + tr(" in a ") + package + tr(" package.\n");
+	if (!alreadyHasExtension(fileName, eagleActionType)) {
+		fileName += eagleActionType;
 	}
-	QMessageBox::information(this, tr("Fritzing"), exportInfoString);
-	*/
 
-	/*
-	QFile fp( fileName );
-	fp.open(QIODevice::WriteOnly);
-	fp.write(bom.toUtf8(),bom.length());
-	fp.close();
-	*/
+	// written straight to the file rather than assembled in memory first
+	FileProgressDialog * fileProgressDialog = exportProgress();
+	QFile file(fileName);
+	bool ok = file.open(QIODevice::WriteOnly);
+	if (ok) {
+		Fritzing2Eagle eagle(m_pcbGraphicsView);
+		ok = eagle.write(board, &file);
+		file.close();
+	}
+	delete fileProgressDialog;
 
+	if (!ok) {
+		QMessageBox::warning(this, tr("Fritzing"), tr("Unable to save the Eagle board file %1.").arg(fileName));
+		return;
+	}
 
-	/*
-	GRID INCH 0.005
-	USE '/Applications/eclipse/eagle/lbr/fritzing.lbr';
-	ADD RESISTOR@fritzing 'R_1' R0.000 (2.3055117 2.1307087);
-	ADD LED@fritzing 'L_2' R0.000 (5.423622 2.425197);
-	GRID LAST;
-	*/
+	m_statusBar->showMessage(tr("Sketch exported"), 2000);
 }
 
-void MainWindow::exportSvg(double res, bool selectedItems, bool flatten) {
+void MainWindow::exportSvg(double res, bool selectedItems, bool flatten, bool shareParts) {
 	QString path = defaultSaveFolder();
 	QString fileExt;
 	QString fileName = FolderUtils::getSaveFileName(this,
@@ -1123,11 +1431,13 @@ void MainWindow::exportSvg(double res, bool selectedItems, bool flatten) {
 
 	if (fileName.isEmpty()) return;
 
-	exportSvg(res, selectedItems, flatten, fileName);
+	exportSvg(res, selectedItems, flatten, fileName, shareParts);
 }
 
-void MainWindow::exportSvg(double res, bool selectedItems, bool flatten, const QString & fileName)
+void MainWindow::exportSvg(double res, bool selectedItems, bool flatten, const QString & fileName, bool shareParts)
 {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	FileProgressDialog * fileProgressDialog = exportProgress();
 	LayerList viewLayerIDs;
 	Q_FOREACH (ViewLayer * viewLayer, m_currentGraphicsView->viewLayers()) {
@@ -1144,6 +1454,7 @@ void MainWindow::exportSvg(double res, bool selectedItems, bool flatten, const Q
 	renderThing.selectedItems = selectedItems;
 	renderThing.hideTerminalPoints = true;
 	renderThing.renderBlocker = false;
+	renderThing.shareParts = shareParts;
 	QString svg = m_currentGraphicsView->renderToSVG(renderThing, nullptr, viewLayerIDs, true);
 	if (svg.isEmpty()) {
 		// tell the user something reasonable
@@ -1159,6 +1470,44 @@ void MainWindow::exportSvg(double res, bool selectedItems, bool flatten, const Q
 	delete fileProgressDialog;
 }
 
+QJsonObject MainWindow::renderTimings()
+{
+	// renders every view to svg the way Export as SVG does, without writing anything, and returns the
+	// milliseconds each took by view, along with the size of the svg; views put off by lazy loading are built first
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
+
+	QJsonObject timings;
+	Q_FOREACH (SketchWidget * sketchWidget, sketchWidgets()) {
+		if (sketchWidget == nullptr) continue;
+
+		LayerList viewLayerIDs;
+		Q_FOREACH (ViewLayer * viewLayer, sketchWidget->viewLayers()) {
+			if (viewLayer == nullptr) continue;
+			if (!viewLayer->visible()) continue;
+
+			viewLayerIDs << viewLayer->viewLayerID();
+		}
+
+		RenderThing renderThing;
+		renderThing.printerScale = GraphicsUtils::SVGDPI;
+		renderThing.blackOnly = false;
+		renderThing.dpi = GraphicsUtils::StandardFritzingDPI;
+		renderThing.selectedItems = false;
+		renderThing.hideTerminalPoints = true;
+		renderThing.renderBlocker = false;
+
+		QElapsedTimer timer;
+		timer.start();
+		QString svg = sketchWidget->renderToSVG(renderThing, nullptr, viewLayerIDs, true);
+		QJsonObject timing;
+		timing.insert("ms", timer.nsecsElapsed() / 1.0e6);
+		timing.insert("bytes", svg.length());
+		timings.insert(ViewLayer::viewIDXmlName(sketchWidget->viewID()), timing);
+	}
+	return timings;
+}
+
 void MainWindow::exportSvgWatermark(QString & svg, double res)
 {
 	QFile file(":/resources/images/watermark_fritzing_outline.svg");
@@ -1177,15 +1526,16 @@ void MainWindow::exportSvgWatermark(QString & svg, double res)
 	if (!result) return;
 
 	double factor;
-	result = splitter.normalize(res, "watermark", false, factor);
-	if (!result) return;
+	QString transWatermark = splitter.normalizeAndShift(res, "watermark", false, (svgSize.width() - watermarkSize.width()) * res, svgSize.height() * res, true, factor);
+	if (transWatermark.isEmpty()) return;
 
-	QString transWatermark = splitter.shift((svgSize.width() - watermarkSize.width()) * res, svgSize.height() * res, "watermark", true);
 	QString newSvg = TextUtils::makeSVGHeader(1, res, svgSize.width(), svgSize.height() + watermarkSize.height()) + transWatermark + "</svg>";
 	svg = TextUtils::mergeSvg(newSvg, svg, "", false);
 }
 
 QString MainWindow::getExportBOM_CSV() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 
 	QList <ItemBase*> partList;
 	std::map<QString, int> descrs;
@@ -1202,27 +1552,28 @@ QString MainWindow::getExportBOM_CSV() {
 	}
 	propertiess += "\n";
 
-	QString assembly = "Label" + separator + "Part Type" + separator + propertiess;
+	QString bom;
+	QTextStream stream(&bom);
+	stream << "Label" << separator << "Part Type" << separator << propertiess;
 
 	for (auto&& itemBase: partList) {
 		if (itemBase->itemType() != ModelPart::Part) continue;
-		QStringList keys;
 		QString desc = itemBase->title() + separator;
 		for ( const QString & property: properties) {
 			QString prop = itemBase->prop(property);
 			desc += prop.replace('\t', ' ') + separator;
 		}
 		++descrs[desc];
-		assembly += itemBase->instanceTitle() + separator + desc + "\n";
+		stream << itemBase->instanceTitle() << separator << desc << "\n";
 	}
 
-	QString shopping = "Amount" + separator + "Part Type" + separator + propertiess;
+	stream << "\n" << "Amount" << separator << "Part Type" << separator << propertiess;
 
 	for(const auto & [key, value] : descrs) {
-		shopping += QString::number(value) + separator + key + "\n";
+		stream << value << separator << key << "\n";
 	}
 
-	QString bom = assembly + "\n" + shopping;
+	stream.flush();
 	return bom;
 }
 
@@ -1239,6 +1590,8 @@ void MainWindow::exportBOM_CSV() {
 }
 
 void MainWindow::exportBOM() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 
 	// bail out if something is wrong
 	// TODO: show an error in QMessageBox
@@ -1267,37 +1620,31 @@ void MainWindow::exportBOM() {
 	}
 
 	QList <ItemBase*> partList;
-	QList<QString> descrList;
-	QMultiHash<QString, ItemBase *> descrs;
+	QList<QString> descrList;					// in order of first appearance
+	QHash<QString, int> descrCounts;
 
 	m_currentGraphicsView->collectParts(partList);
 
 	std::sort(partList.begin(), partList.end(), sortPartList);
 
+	// getBomProps goes through every property's widget, so call it once per part
+	QString assemblyString;
 	Q_FOREACH (ItemBase * itemBase, partList) {
 		if (itemBase->itemType() != ModelPart::Part) continue;
-		QStringList keys;
 //		QHash<QString, QString> properties = HtmlInfoView::getPartProperties(itemBase->modelPart(), itemBase, false, keys);
-		QString desc = itemBase->prop("mn") + "%%%%%" + itemBase->prop("mpn") + "%%%%%" + itemBase->title() + "%%%%%" + getBomProps(itemBase);  // keeps different parts separate if there are no properties
-		descrs.insert(desc, itemBase);
-		if (!descrList.contains(desc)) {
+		QString bomProps = getBomProps(itemBase);
+		QString desc = itemBase->prop("mn") + "%%%%%" + itemBase->prop("mpn") + "%%%%%" + itemBase->title() + "%%%%%" + bomProps;  // keeps different parts separate if there are no properties
+		int & count = descrCounts[desc];
+		if (count++ == 0) {
 			descrList.append(desc);
 		}
-	}
-
-	QString assemblyString;
-	Q_FOREACH (ItemBase * itemBase, partList) {
-		if (itemBase->itemType() != ModelPart::Part) continue;
-		QStringList keys;
-//		QHash<QString, QString> properties = HtmlInfoView::getPartProperties(itemBase->modelPart(), itemBase, false, keys);
-		assemblyString += bomRowTemplate.arg(itemBase->instanceTitle()).arg(itemBase->prop("mn")).arg(itemBase->prop("mpn")).arg(itemBase->title()).arg(getBomProps(itemBase));
+		assemblyString += bomRowTemplate.arg(itemBase->instanceTitle()).arg(itemBase->prop("mn")).arg(itemBase->prop("mpn")).arg(itemBase->title()).arg(bomProps);
 	}
 
 	QString shoppingListString;
 	Q_FOREACH (QString descr, descrList) {
-		QList<ItemBase *> itemBases = descrs.values(descr);
 		QStringList split = descr.split("%%%%%");
-		shoppingListString += bomRowTemplate.arg(itemBases.count()).arg(split.at(0)).arg(split.at(1)).arg(split.at(2)).arg(split.at(3));
+		shoppingListString += bomRowTemplate.arg(descrCounts.value(descr)).arg(split.at(0)).arg(split.at(1)).arg(split.at(2)).arg(split.at(3));
 	}
 
 	QString bom = bomTemplate.arg(
@@ -1364,6 +1711,8 @@ void MainWindow::save_text_file(QString text, QString actionType, QString dialog
 
 
 void MainWindow::exportSpiceNetlist() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	if (m_schematicGraphicsView == nullptr) return;
 
 	// examples:
@@ -1425,9 +1774,10 @@ QString MainWindow::getSpiceNetlist(QString simulationName) {
  * @param[in] simulationName Name of the simulation to be included in the first line of output
  * @param[out] netList A list with all the nets of the circuit that are going to be simulated and each net is a list of the connectors that belong to that net
  * @param[out] itemBases A set with the parts that are going to be simulated
+ * @param[in] analysis The analysis line, an operating point analysis unless given
  * @return A string that is a circuit description in spice
  */
-QString MainWindow::getSpiceNetlist(QString simulationName, QList< QList<class ConnectorItem *>* >& netList, QSet<class ItemBase *>& itemBases) {
+QString MainWindow::getSpiceNetlist(QString simulationName, QList< QList<class ConnectorItem *>* >& netList, QSet<class ItemBase *>& itemBases, const QString & analysis) {
 	QString output = simulationName + "\n";
 	QHash<ConnectorItem *, int> indexer;
 	this->m_schematicGraphicsView->collectAllNets(indexer, netList, true, false);
@@ -1492,9 +1842,17 @@ QString MainWindow::getSpiceNetlist(QString simulationName, QList< QList<class C
 	//DebugDialog::debug("_______________");
 	//DebugDialog::debug("_______________");
 
+	// net numbers, now that ground is net zero
+	QHash<ConnectorItem *, int> netIndex;
+	for (int i = 0; i < netList.count(); i++) {
+		Q_FOREACH (ConnectorItem * ci, *netList.at(i)) {
+			netIndex.insert(ci, i);
+		}
+	}
+
 	Q_FOREACH (ItemBase * itemBase, itemBases) {
 		if (itemBase->spice().isEmpty()) continue;
-		output += GetSpice::getSpice(itemBase, netList);
+		output += GetSpice::getSpice(itemBase, netIndex);
 	}
 
 	output += "\n";
@@ -1558,7 +1916,7 @@ QString MainWindow::getSpiceNetlist(QString simulationName, QList< QList<class C
 	}
 
 	output += ".options savecurrents\n";
-	output += ".OP\n";
+	output += analysis + "\n";
 	output += "*.TRAN 1ms 100ms\n";
 	output += "* .AC DEC 100 100 1MEG\n";
 	output += ".END";
@@ -1566,24 +1924,52 @@ QString MainWindow::getSpiceNetlist(QString simulationName, QList< QList<class C
 	return output;
 }
 
+void MainWindow::collectIPCNets(QList< QList<ConnectorItem *>* > & netList) {
+	ViewGeometry::WireFlags skipFlags = ViewGeometry::NoFlag;
+	const bool skipBuses = true;
+
+	QHash<ConnectorItem *, int> indexer;
+	this->m_pcbGraphicsView->collectAllNets(indexer, netList, true, m_pcbGraphicsView->boardLayers() > 1, skipFlags, skipBuses);
+}
+
 QString MainWindow::exportIPC_D_356A() {
 	int boardCount;
 	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
 
 	QString basename = QFileInfo(m_fwFilename).fileName();
 
-	ViewGeometry::WireFlags skipFlags = ViewGeometry::NoFlag;
-	const bool skipBuses = true;
-
-	QHash<ConnectorItem *, int> indexer;
 	QList< QList<ConnectorItem *>* > netList;
-	this->m_pcbGraphicsView->collectAllNets(indexer, netList, true, m_pcbGraphicsView->boardLayers() > 1, skipFlags, skipBuses);
+	collectIPCNets(netList);
 
 	QString ipc = getExportIPC_D_356A(board, basename, netList);
 	return ipc;
 }
 
+bool MainWindow::exportIPC_D_356A(const QString & fileName) {
+	// the records go straight to the file, for boards with many thousands of test points
+	int boardCount;
+	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
+	if (board == nullptr) return false;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	QList< QList<ConnectorItem *>* > netList;
+	collectIPCNets(netList);
+
+	QTextStream out(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+	out.setCodec("UTF-8");
+#endif
+	writeExportIPC_D_356A(out, board, QFileInfo(m_fwFilename).fileName(), netList);
+	out.flush();
+	file.close();
+	return out.status() == QTextStream::Ok;
+}
+
 void MainWindow::exportIPC_D_356A_interactive() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	int boardCount;
 	ItemBase * board = m_pcbGraphicsView->findSelectedBoard(boardCount);
 
@@ -1614,77 +2000,64 @@ void MainWindow::exportIPC_D_356A_interactive() {
 
 
 void MainWindow::exportNetlist() {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 	QHash<ConnectorItem *, int> indexer;
 	QList< QList<ConnectorItem *>* > netList;
 	this->m_currentGraphicsView->collectAllNets(indexer, netList, true, m_currentGraphicsView->boardLayers() > 1);
 
-	QDomDocument doc;
-	doc.setContent(QString("<?xml version='1.0' encoding='UTF-8'?>\n") + TextUtils::CreatedWithFritzingXmlComment);
-	QDomElement netlist = doc.createElement("netlist");
-	doc.appendChild(netlist);
-	netlist.setAttribute("sketch", QFileInfo(m_fwFilename).fileName());
-	netlist.setAttribute("date", QDateTime::currentDateTime().toString());
+	QString text("<?xml version='1.0' encoding='UTF-8'?>\n");
+	QXmlStreamWriter streamWriter(&text);
+	streamWriter.setAutoFormatting(true);
+	streamWriter.setAutoFormattingIndent(1);
+	streamWriter.writeComment(" " + TextUtils::CreatedWithFritzingString + " ");
+	streamWriter.writeStartElement("netlist");
+	streamWriter.writeAttribute("sketch", QFileInfo(m_fwFilename).fileName());
+	streamWriter.writeAttribute("date", QDateTime::currentDateTime().toString());
 
-	// TODO: filter out 'ignore' connectors
-
-	QList< QList<ConnectorItem *>* > deleteNets;
 	Q_FOREACH (QList<ConnectorItem *> * net, netList) {
-		QList<ConnectorItem *> deleteItems;
+		// leave out the connectors marked to be ignored, and the nets left empty by that
+		bool started = false;
 		Q_FOREACH (ConnectorItem * connectorItem, *net) {
 			ErcData * ercData = connectorItem->connectorSharedErcData();
-			if (ercData == nullptr) continue;
-
-			if (ercData->ignore() == ErcData::Always) {
-				deleteItems.append(connectorItem);
-			}
-			else if ((ercData->ignore() == ErcData::IfUnconnected) && (net->count() == 1)) {
-				deleteItems.append(connectorItem);
+			if (ercData) {
+				if (ercData->ignore() == ErcData::Always) continue;
+				if ((ercData->ignore() == ErcData::IfUnconnected) && (net->count() == 1)) continue;
 			}
-		}
-
-		Q_FOREACH (ConnectorItem * connectorItem, deleteItems) {
-			net->removeOne(connectorItem);
-		}
-		if (net->count() == 0) {
-			deleteNets.append(net);
-		}
-	}
-
-	Q_FOREACH (QList<ConnectorItem *> * net, deleteNets) {
-		netList.removeOne(net);
-	}
 
-	Q_FOREACH (QList<ConnectorItem *> * net, netList) {
-		QDomElement netElement = doc.createElement("net");
-		netlist.appendChild(netElement);
-		Q_FOREACH (ConnectorItem * connectorItem, *net) {
-			QDomElement connector = doc.createElement("connector");
-			netElement.appendChild(connector);
-			connector.setAttribute("id", connectorItem->connectorSharedID());
-			connector.setAttribute("name", connectorItem->connectorSharedName());
-			QDomElement part = doc.createElement("part");
-			connector.appendChild(part);
+			if (!started) {
+				streamWriter.writeStartElement("net");
+				started = true;
+			}
+			streamWriter.writeStartElement("connector");
+			streamWriter.writeAttribute("id", connectorItem->connectorSharedID());
+			streamWriter.writeAttribute("name", connectorItem->connectorSharedName());
 			ItemBase * itemBase = connectorItem->attachedTo();
-			part.setAttribute("id", itemBase->id());
-			part.setAttribute("label", itemBase->instanceTitle());
-			part.setAttribute("title", itemBase->title());
-			ErcData * ercData = connectorItem->connectorSharedErcData();
+			streamWriter.writeStartElement("part");
+			streamWriter.writeAttribute("id", QString::number(itemBase->id()));
+			streamWriter.writeAttribute("label", itemBase->instanceTitle());
+			streamWriter.writeAttribute("title", itemBase->title());
+			streamWriter.writeEndElement();
 			if (ercData) {
-				QDomElement erc = doc.createElement("erc");
-				if (ercData->writeToElement(erc, doc)) {
-					connector.appendChild(erc);
-				}
+				ercData->writeToStream(streamWriter);
 			}
+			streamWriter.writeEndElement();
+		}
+		if (started) {
+			streamWriter.writeEndElement();
 		}
 	}
 
+	streamWriter.writeEndElement();
+	streamWriter.writeEndDocument();
+
 	Q_FOREACH (QList<ConnectorItem *> * net, netList) {
 		delete net;
 	}
 	netList.clear();
 
 	save_text_file(
-				doc.toString(),
+				text,
 				netlistActionType,
 				tr("Export Netlist..."),
 				"netlist",
@@ -1706,6 +2079,10 @@ void MainWindow::exportNormalizedFlattenedSVG() {
 	exportSvg(GraphicsUtils::StandardFritzingDPI, true, true);
 }
 
+void MainWindow::exportSharedSvg() {
+	exportSvg(GraphicsUtils::IllustratorDPI, false, false, true);
+}
+
 QString MainWindow::getBomProps(ItemBase * itemBase)
 {
 	if (itemBase == nullptr) return "";
@@ -1733,7 +2110,9 @@ QString MainWindow::getBomProps(ItemBase * itemBase)
 	return pString;
 }
 
-void MainWindow::exportToGerber() {
+void MainWindow::exportToGerber(bool toZip) {
+	loadDeferredViews();
+	flushDeferredRoutingStatus();
 
 	//NOTE: this assumes just one board per sketch
 
@@ -1752,28 +2131,51 @@ void MainWindow::exportToGerber() {
 		return;
 	}
 
-	QString exportDir = QFileDialog::getExistingDirectory(this, tr("Choose a folder for exporting"),
-	                    defaultSaveFolder(),
-	                    QFileDialog::ShowDirsOnly
-	                    | QFileDialog::DontResolveSymlinks);
+	QFileInfo info(m_fwFilename);
+	QString prefix = info.completeBaseName();
+	if (boardCount > 1) {
+		prefix += QString("_%1_%2").arg(board->instanceTitle()).arg(board->id());
+	}
 
-	if (exportDir.isEmpty()) return;
+	QString exportDir;
+	QString zipPath;
+	if (toZip) {
+		zipPath = QFileDialog::getSaveFileName(this, tr("Export Gerber zip"),
+		                                       defaultSaveFolder() + "/" + prefix + "_gerber.zip",
+		                                       tr("Zip file (*.zip)"));
+		if (zipPath.isEmpty()) return;
+
+		if (!zipPath.endsWith(".zip", Qt::CaseInsensitive)) zipPath += ".zip";
+		FolderUtils::setOpenSaveFolder(zipPath);
+	}
+	else {
+		exportDir = QFileDialog::getExistingDirectory(this, tr("Choose a folder for exporting"),
+		            defaultSaveFolder(),
+		            QFileDialog::ShowDirsOnly
+		            | QFileDialog::DontResolveSymlinks);
+
+		if (exportDir.isEmpty()) return;
+
+		FolderUtils::setOpenSaveFolder(exportDir);
+	}
 
 	FileProgressDialog * fileProgressDialog = exportProgress();
 
-	FolderUtils::setOpenSaveFolder(exportDir);
 	m_pcbGraphicsView->saveLayerVisibility();
 	m_pcbGraphicsView->setAllLayersVisible(true);
 
-	QFileInfo info(m_fwFilename);
-	QString prefix = info.completeBaseName();
-	if (boardCount > 1) {
-		prefix += QString("_%1_%2").arg(board->instanceTitle()).arg(board->id());
+	bool exported = true;
+	if (toZip) {
+		exported = GerberGenerator::exportToGerberZip(prefix, zipPath, board, m_pcbGraphicsView, true);
+	}
+	else {
+		GerberGenerator::exportToGerber(prefix, exportDir, board, m_pcbGraphicsView, true);
 	}
-	GerberGenerator::exportToGerber(prefix, exportDir, board, m_pcbGraphicsView, true);
 
 	m_pcbGraphicsView->restoreLayerVisibility();
-	m_statusBar->showMessage(tr("Sketch exported to Gerber"), 2000);
+	if (exported) {
+		m_statusBar->showMessage(tr("Sketch exported to Gerber"), 2000);
+	}
 
 	delete fileProgressDialog;
 }
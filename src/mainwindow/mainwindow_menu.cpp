@@ -28,6 +28,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDebug>
 #include <QSettings>
 #include <QDesktopServices>
+#include <QJsonDocument>
 #include <QMimeData>
 
 #include "mainwindow.h"
@@ -36,8 +37,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../partseditor/pemainwindow.h"
 #include "../help/aboutbox.h"
 #include "../autoroute/mazerouter/mazerouter.h"
+#include "../autoroute/schematicrouter/schematicrouter.h"
 #include "../autoroute/autorouteprogressdialog.h"
 #include "../autoroute/drc.h"
+#include "../autoroute/livedrc.h"
 #include "../items/resizableboard.h"
 #include "../items/jumperitem.h"
 #include "../items/via.h"
@@ -51,6 +54,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../infoview/htmlinfoview.h"
 #include "../utils/bendpointaction.h"
 #include "../sketch/fgraphicsscene.h"
+#include "../utils/interactionprofiler.h"
 #include "../utils/fmessagebox.h"
 #include "../utils/fileprogressdialog.h"
 #include "../help/tipsandtricks.h"
@@ -64,6 +68,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../dock/layerpalette.h"
 #include "../program/programwindow.h"
 #include "../utils/autoclosemessagebox.h"
+#include "../utils/tracer.h"
+#include "../utils/memoryreport.h"
 #include "../processeventblocker.h"
 #include "../sketchtoolbutton.h"
 #include "../help/firsttimehelpdialog.h"
@@ -153,7 +159,7 @@ void MainWindow::mainLoad() {
 		path = "";
 	}
 
-	QString fileName = FolderUtils::getOpenFileName(
+	QStringList fileNames = FolderUtils::getOpenFileNames(
 	                       this,
 						   tr("Select a Fritzing file to open"),
 	                       path,
@@ -178,19 +184,30 @@ void MainWindow::mainLoad() {
 #endif
 					   );
 
-	if (fileName.isEmpty()) return;
+	if (fileNames.isEmpty()) return;
 
-	if (fileName.endsWith(FritzingBundledPartExtension)) {
-		m_binManager->importPartToMineBin(fileName);
-		return;
+	// several shareable parts picked at once are imported as one batch
+	QStringList bundledParts;
+	Q_FOREACH (QString fileName, fileNames) {
+		if (fileName.endsWith(FritzingBundledPartExtension)) bundledParts << fileName;
 	}
-
-	if (fileName.endsWith(FritzingBinExtension) || fileName.endsWith(FritzingBundledBinExtension)) {
-		m_binManager->openBinIn(fileName, false);
-		return;
+	if (bundledParts.count() > 1) {
+		m_binManager->importPartsToMineBin(bundledParts);
 	}
 
-	mainLoadAux(fileName);
+	Q_FOREACH (QString fileName, fileNames) {
+		if (fileName.endsWith(FritzingBundledPartExtension)) {
+			if (bundledParts.count() == 1) m_binManager->importPartToMineBin(fileName);
+			continue;
+		}
+
+		if (fileName.endsWith(FritzingBinExtension) || fileName.endsWith(FritzingBundledBinExtension)) {
+			m_binManager->openBinIn(fileName, false);
+			continue;
+		}
+
+		mainLoadAux(fileName);
+	}
 }
 
 void MainWindow::mainLoadAux(const QString & fileName)
@@ -277,6 +294,7 @@ void MainWindow::revert() {
 
 MainWindow * MainWindow::revertAux()
 {
+	waitForBackgroundSave();
 	MainWindow* mw = newMainWindow( m_referenceModel, fileName(), true, true, this->currentTabIndex());
 	mw->setGeometry(this->geometry());
 
@@ -303,6 +321,8 @@ MainWindow * MainWindow::revertAux()
 
 bool MainWindow::loadWhich(const QString & fileName, bool setAsLastOpened, bool addToRecent, bool checkObsolete, const QString & displayName)
 {
+	Tracer::Scope tracing("load", fileName);
+
 	if (!QFileInfo(fileName).exists()) {
 		FMessageBox::warning(nullptr, tr("Fritzing"), tr("File '%1' not found").arg(fileName));
 		return false;
@@ -392,7 +412,9 @@ void MainWindow::mainLoad(const QString & fileName, const QString & displayName,
 
 	m_obsoleteSMDOrientation = false;
 
+	Tracer::begin("load.model");
 	m_sketchModel->loadFromFile(fileName, m_referenceModel, modelParts, true);
+	Tracer::end();
 
 	//DebugDialog::debug("core loaded");
 	disconnect(m_sketchModel, &SketchModel::loadedProjectProperties,
@@ -404,36 +426,66 @@ void MainWindow::mainLoad(const QString & fileName, const QString & displayName,
 	disconnect(m_sketchModel, SIGNAL(obsoleteSMDOrientationSignal()),
 	           this, SLOT(obsoleteSMDOrientationSlot()));
 
-	ProcessEventBlocker::processEvents();
-	if (m_fileProgressDialog) {
-		m_fileProgressDialog->setValue(155);
-		m_fileProgressDialog->setMessage(tr("loading %1 (breadboard)").arg(displayName2));
+	// with lazy view loading only the view on show is built here; the others are built from the same
+	// model parts when first shown, or before anything can change the sketch or read all of it
+	m_deferredViews.clear();
+	m_deferredModelParts.clear();
+	SketchWidget * firstView = nullptr;
+	if (deferViewLoading(modelParts, checkObsolete, doMigratePartLabelOffset)) {
+		firstView = m_breadboardGraphicsView;
+		if (m_currentGraphicsView == m_schematicGraphicsView || m_currentGraphicsView == m_pcbGraphicsView) {
+			firstView = m_currentGraphicsView;
+		}
+		m_deferredModelParts = modelParts;
 	}
 
 	QList<long> newIDs;
-	m_breadboardGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
+	if (firstView != nullptr && firstView != m_breadboardGraphicsView) {
+		m_deferredViews << m_breadboardGraphicsView;
+	}
+	else {
+		ProcessEventBlocker::processEvents();
+		if (m_fileProgressDialog) {
+			m_fileProgressDialog->setValue(155);
+			m_fileProgressDialog->setMessage(tr("loading %1 (breadboard)").arg(displayName2));
+		}
 
-	ProcessEventBlocker::processEvents();
-	if (m_fileProgressDialog) {
-		m_fileProgressDialog->setValue(170);
-		m_fileProgressDialog->setMessage(tr("loading %1 (pcb)").arg(displayName2));
+		Tracer::Scope tracing("load.breadboard");
+		m_breadboardGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
 	}
 
-	newIDs.clear();
-	m_pcbGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
+	if (firstView != nullptr && firstView != m_pcbGraphicsView) {
+		m_deferredViews << m_pcbGraphicsView;
+	}
+	else {
+		ProcessEventBlocker::processEvents();
+		if (m_fileProgressDialog) {
+			m_fileProgressDialog->setValue(170);
+			m_fileProgressDialog->setMessage(tr("loading %1 (pcb)").arg(displayName2));
+		}
 
+		newIDs.clear();
+		Tracer::Scope tracing("load.pcb");
+		m_pcbGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
+	}
 
-	ProcessEventBlocker::processEvents();
-	if (m_fileProgressDialog) {
-		m_fileProgressDialog->setValue(185);
-		m_fileProgressDialog->setMessage(tr("loading %1 (schematic)").arg(displayName2));
+	if (firstView != nullptr && firstView != m_schematicGraphicsView) {
+		m_deferredViews << m_schematicGraphicsView;
 	}
+	else {
+		ProcessEventBlocker::processEvents();
+		if (m_fileProgressDialog) {
+			m_fileProgressDialog->setValue(185);
+			m_fileProgressDialog->setMessage(tr("loading %1 (schematic)").arg(displayName2));
+		}
 
-	newIDs.clear();
-	m_schematicGraphicsView->setConvertSchematic(m_convertedSchematic);
-	m_schematicGraphicsView->setOldSchematic(this->m_useOldSchematic);
-	m_schematicGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
-	m_schematicGraphicsView->setConvertSchematic(false);
+		newIDs.clear();
+		Tracer::Scope tracing("load.schematic");
+		m_schematicGraphicsView->setConvertSchematic(m_convertedSchematic);
+		m_schematicGraphicsView->setOldSchematic(this->m_useOldSchematic);
+		m_schematicGraphicsView->loadFromModelParts(modelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
+		m_schematicGraphicsView->setConvertSchematic(false);
+	}
 
 	if (m_sketchModel->checkForReversedWires()) {
 		m_pcbGraphicsView->checkForReversedWires();
@@ -489,6 +541,54 @@ void MainWindow::mainLoad(const QString & fileName, const QString & displayName,
 	initZoom();
 }
 
+bool MainWindow::deferViewLoading(const QList<ModelPart *> & modelParts, bool checkObsolete, bool migratePartLabelOffset)
+{
+	// only when asked for in the preferences, and when no load-time fix-up needs the items of every view
+	if (!QSettings().value("lazyViewLoading", false).toBool()) return false;
+	if (m_obsoleteSMDOrientation || migratePartLabelOffset) return false;
+	if (m_convertedSchematic || m_useOldSchematic) return false;
+	if (m_sketchModel->checkForReversedWires()) return false;
+
+	if (checkObsolete) {
+		Q_FOREACH (ModelPart * modelPart, modelParts) {
+			if (modelPart->isObsolete()) return false;
+		}
+	}
+
+	return true;
+}
+
+void MainWindow::loadDeferredView(SketchWidget * sketchWidget)
+{
+	if (!m_deferredViews.removeOne(sketchWidget)) return;
+
+	DebugDialog::debug(QString("loading deferred view %1").arg(ViewLayer::viewIDName(sketchWidget->viewID())));
+	Tracer::Scope tracing("load.deferred", ViewLayer::viewIDName(sketchWidget->viewID()));
+	QList<long> newIDs;
+	sketchWidget->loadFromModelParts(m_deferredModelParts, BaseCommand::SingleView, nullptr, false, nullptr, false, newIDs);
+	if (m_deferredViews.isEmpty()) {
+		m_deferredModelParts.clear();
+	}
+}
+
+void MainWindow::loadDeferredViews()
+{
+	// the model hasn't changed since the sketch was loaded, so every view is built as it would have been then
+	Q_FOREACH (SketchWidget * sketchWidget, QList<SketchWidget *>(m_deferredViews)) {
+		loadDeferredView(sketchWidget);
+	}
+}
+
+void MainWindow::flushDeferredRoutingStatus()
+{
+	// views that weren't current put off scoring their ratsnests; anything written out wants them up to date
+	QList<SketchWidget *> views;
+	views << m_breadboardGraphicsView << m_schematicGraphicsView << m_pcbGraphicsView;
+	Q_FOREACH (SketchWidget * sketchWidget, views) {
+		if (sketchWidget != nullptr) sketchWidget->flushDeferredRoutingStatus();
+	}
+}
+
 void MainWindow::copy() {
 	if (m_currentGraphicsView == nullptr) return;
 	m_currentGraphicsView->copy();
@@ -522,10 +622,18 @@ void MainWindow::pasteAux(bool pasteInPlace)
 
 	if (!mimeData->hasFormat("application/x-dnditemsdata")) return;
 
-	QByteArray itemData = mimeData->data("application/x-dnditemsdata");
 	QList<ModelPart *> modelParts;
 	QHash<QString, QRectF> boundingRects;
-	if (m_sketchModel->paste(m_referenceModel, itemData, modelParts, boundingRects, false)) {
+	bool pasted;
+	QDomDocument domDocument;
+	if (SketchWidget::clipboardDocument(mimeData, domDocument)) {
+		pasted = m_sketchModel->paste(m_referenceModel, domDocument, modelParts, boundingRects, false);
+	}
+	else {
+		QByteArray itemData = mimeData->data("application/x-dnditemsdata");
+		pasted = m_sketchModel->paste(m_referenceModel, itemData, modelParts, boundingRects, false);
+	}
+	if (pasted) {
 		auto * parentCommand = new QUndoCommand("Paste"); // if you translate "Paste", you must also do so for the check in sketchwidget.cpp.
 
 		QList<SketchWidget *> sketchWidgets;
@@ -549,6 +657,8 @@ void MainWindow::pasteAux(bool pasteInPlace)
 			new IncLabelTextCommand(m_breadboardGraphicsView, id, parentCommand);
 		}
 
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		m_sketchModel->beginPaste();
 		m_breadboardGraphicsView->setPasting(true);
 		m_pcbGraphicsView->setPasting(true);
 		m_schematicGraphicsView->setPasting(true);
@@ -556,6 +666,8 @@ void MainWindow::pasteAux(bool pasteInPlace)
 		m_breadboardGraphicsView->setPasting(false);
 		m_pcbGraphicsView->setPasting(false);
 		m_schematicGraphicsView->setPasting(false);
+		m_sketchModel->endPaste();
+		QApplication::restoreOverrideCursor();
 	}
 
 	m_currentGraphicsView->updateInfoView();
@@ -867,13 +979,18 @@ void MainWindow::updateRecentFileActions() {
 }
 
 void MainWindow::createEditMenuActions() {
+	// the group keeps the actions' text and enabled state; triggering goes through undo() and redo() to be traced
 	m_undoAct = m_undoGroup->createUndoAction(this, tr("Undo"));
 	m_undoAct->setShortcuts(QKeySequence::Undo);
 	m_undoAct->setText(tr("Undo"));
+	disconnect(m_undoAct, &QAction::triggered, m_undoGroup, &QUndoGroup::undo);
+	connect(m_undoAct, &QAction::triggered, this, &MainWindow::undo);
 
 	m_redoAct = m_undoGroup->createRedoAction(this, tr("Redo"));
 	m_redoAct->setShortcuts(QKeySequence::Redo);
 	m_redoAct->setText(tr("Redo"));
+	disconnect(m_redoAct, &QAction::triggered, m_undoGroup, &QUndoGroup::redo);
+	connect(m_redoAct, &QAction::triggered, this, &MainWindow::redo);
 
 	m_cutAct = new QAction(tr("&Cut"), this);
 	m_cutAct->setShortcut(QKeySequence::Cut);
@@ -1320,6 +1437,20 @@ void MainWindow::createHelpMenuActions() {
 	m_enableDebugAct->setChecked(DebugDialog::enabled());
 	connect(m_enableDebugAct, SIGNAL(triggered()), this, SLOT(enableDebug()));
 
+	m_profileOverlayAct = new QAction(tr("Show performance overlay"), this);
+	m_profileOverlayAct->setStatusTip(tr("Show paint and mouse handling times in the sketch views"));
+	m_profileOverlayAct->setCheckable(true);
+	m_profileOverlayAct->setChecked(InteractionProfiler::enabled());
+	connect(m_profileOverlayAct, SIGNAL(triggered()), this, SLOT(toggleProfileOverlay()));
+
+	m_saveProfileTraceAct = new QAction(tr("Save performance trace..."), this);
+	m_saveProfileTraceAct->setStatusTip(tr("Save the times recorded since the performance overlay was turned on, for chrome://tracing or Perfetto"));
+	connect(m_saveProfileTraceAct, SIGNAL(triggered()), this, SLOT(saveProfileTrace()));
+
+	m_memoryReportAct = new QAction(tr("Memory report..."), this);
+	m_memoryReportAct->setStatusTip(tr("Show roughly how much memory this sketch's views, svgs, undo stack and parts take"));
+	connect(m_memoryReportAct, SIGNAL(triggered()), this, SLOT(showMemoryReport()));
+
 	m_partsEditorHelpAct = new QAction(tr("Parts Editor Help"), this);
 	m_partsEditorHelpAct->setStatusTip(tr("Display Parts Editor help in a browser"));
 	connect(m_partsEditorHelpAct, SIGNAL(triggered(bool)), this, SLOT(partsEditorHelp()));
@@ -1439,7 +1570,7 @@ void MainWindow::createFileMenu() {
 	m_exportMenu->addAction(m_exportNetlistAct);
 	m_exportMenu->addAction(m_exportSpiceNetlistAct);
 
-	//m_exportMenu->addAction(m_exportEagleAct);
+	m_exportMenu->addAction(m_exportEagleAct);
 }
 
 void MainWindow::populateExportMenu() {
@@ -1448,6 +1579,7 @@ void MainWindow::populateExportMenu() {
 	imageMenu->addAction(m_exportJpgAct);
 	imageMenu->addSeparator();
 	imageMenu->addAction(m_exportSvgAct);
+	imageMenu->addAction(m_exportSharedSvgAct);
 	imageMenu->addAction(m_exportPdfAct);
 
 	QMenu * productionMenu = m_exportMenu->addMenu(tr("for Production"));
@@ -1455,6 +1587,7 @@ void MainWindow::populateExportMenu() {
 	productionMenu->addAction(m_exportEtchableSvgAct);
 	productionMenu->addSeparator();
 	productionMenu->addAction(m_exportGerberAct);
+	productionMenu->addAction(m_exportGerberZipAct);
 }
 
 
@@ -1569,13 +1702,17 @@ void MainWindow::createTraceMenus()
 {
 	m_pcbTraceMenu = menuBar()->addMenu(tr("&Routing"));
 	m_pcbTraceMenu->addAction(m_newAutorouteAct);
+	m_pcbTraceMenu->addAction(m_incrementalAutorouteAct);
+	m_pcbTraceMenu->addAction(m_autorouteAllBoardsAct);
 	m_pcbTraceMenu->addAction(m_newDesignRulesCheckAct);
+	m_pcbTraceMenu->addAction(m_liveDesignRulesCheckAct);
 	m_pcbTraceMenu->addAction(m_autorouterSettingsAct);
 	m_pcbTraceMenu->addAction(m_fabQuoteAct);
 
 	QMenu * groundFillMenu = m_pcbTraceMenu->addMenu(tr("Ground Fill"));
 
 	groundFillMenu->addAction(m_copperFillAct);
+	groundFillMenu->addAction(m_copperRefillAct);
 	groundFillMenu->addAction(m_groundFillAct);
 	groundFillMenu->addAction(m_removeGroundFillAct);
 	groundFillMenu->addAction(m_setGroundFillSeedsAct);
@@ -1607,6 +1744,7 @@ void MainWindow::createTraceMenus()
 
 	m_schematicTraceMenu = menuBar()->addMenu(tr("&Routing"));
 	m_schematicTraceMenu->addAction(m_newAutorouteAct);
+	m_schematicTraceMenu->addAction(m_incrementalAutorouteAct);
 	m_schematicTraceMenu->addAction(m_excludeFromAutorouteAct);
 	m_schematicTraceMenu->addAction(m_showUnroutedAct);
 	m_schematicTraceMenu->addAction(m_selectAllTracesAct);
@@ -1643,6 +1781,9 @@ void MainWindow::createHelpMenu()
 	m_helpMenu->addSeparator();
 	m_helpMenu->addAction(m_reportBugAct);
 	m_helpMenu->addAction(m_enableDebugAct);
+	m_helpMenu->addAction(m_profileOverlayAct);
+	m_helpMenu->addAction(m_saveProfileTraceAct);
+	m_helpMenu->addAction(m_memoryReportAct);
 	m_helpMenu->addSeparator();
 	m_helpMenu->addAction(m_aboutAct);
 	m_helpMenu->addAction(m_tipsAndTricksAct);
@@ -2183,6 +2324,8 @@ void MainWindow::updateTraceMenu() {
 	m_selectAllJumperItemsAct->setEnabled(traceMenuThing.jiEnabled && traceMenuThing.boardCount >= 1);
 	m_selectAllViasAct->setEnabled(traceMenuThing.viaEnabled && traceMenuThing.boardCount >= 1);
 	m_tidyWiresAct->setEnabled(twEnabled);
+	m_incrementalAutorouteAct->setEnabled(m_currentGraphicsView != nullptr && m_currentGraphicsView->scene()->selectedItems().count() > 0);
+	m_autorouteAllBoardsAct->setEnabled(traceMenuThing.boardCount >= 1);
 
 	QString sides;
 	if (m_pcbGraphicsView->layerIsActive(ViewLayer::Copper0) && m_pcbGraphicsView->layerIsActive(ViewLayer::Copper1)) {
@@ -2200,6 +2343,7 @@ void MainWindow::updateTraceMenu() {
 	m_groundFillAct->setText(groundFillString);
 	m_copperFillAct->setEnabled(traceMenuThing.boardCount >= 1);
 	m_copperFillAct->setText(copperFillString);
+	m_copperRefillAct->setEnabled(traceMenuThing.boardCount >= 1);
 	m_removeGroundFillAct->setEnabled(traceMenuThing.gfrEnabled && traceMenuThing.boardCount >= 1);
 
 	// TODO: set and clear enabler logic
@@ -2207,6 +2351,7 @@ void MainWindow::updateTraceMenu() {
 	m_clearGroundFillSeedsAct->setEnabled(traceMenuThing.gfsEnabled && traceMenuThing.boardCount >= 1);
 
 	m_newDesignRulesCheckAct->setEnabled(traceMenuThing.boardCount >= 1);
+	m_liveDesignRulesCheckAct->setEnabled(traceMenuThing.boardCount >= 1 || m_liveDesignRulesCheckAct->isChecked());
 	m_autorouterSettingsAct->setEnabled(m_currentGraphicsView == m_pcbGraphicsView);
 	m_updateRoutingStatusAct->setEnabled(true);
 
@@ -2374,6 +2519,45 @@ void MainWindow::enableDebug() {
 }
 
 
+void MainWindow::toggleProfileOverlay() {
+	bool enabled = m_profileOverlayAct->isChecked();
+	InteractionProfiler::setEnabled(enabled);
+	Q_FOREACH (SketchWidget * sketchWidget, sketchWidgets()) {
+		if (sketchWidget != nullptr) sketchWidget->setProfileOverlay(enabled);
+	}
+}
+
+void MainWindow::showProfile(bool show) {
+	m_profileOverlayAct->setChecked(show);
+	toggleProfileOverlay();
+}
+
+void MainWindow::saveProfileTrace() {
+	QString path = FolderUtils::getSaveFileName(this, tr("Save performance trace"),
+	               defaultSaveFolder() + "/trace.json",
+	               tr("Trace files (*.json)"));
+	if (path.isEmpty()) return;
+
+	if (!InteractionProfiler::writeTrace(path)) {
+		QMessageBox::warning(this, tr("Fritzing"), tr("Unable to write %1").arg(path));
+	}
+}
+
+QJsonObject MainWindow::memoryReport() {
+	return MemoryReport::sketch(sketchWidgets(), m_undoStack);
+}
+
+void MainWindow::showMemoryReport() {
+	QJsonObject report = memoryReport();
+	DebugDialog::debug(QString("memory report\n%1").arg(QString(QJsonDocument(report).toJson())));
+
+	QMessageBox messageBox(this);
+	messageBox.setWindowTitle(tr("Memory report"));
+	messageBox.setText(MemoryReport::summary(report));
+	messageBox.setDetailedText(QJsonDocument(report).toJson());
+	messageBox.exec();
+}
+
 void MainWindow::openNewPartsEditor(PaletteItem * paletteItem)
 {
 	Q_FOREACH (QWidget *widget, QApplication::topLevelWidgets()) {
@@ -2468,6 +2652,16 @@ void MainWindow::toggleUndoHistory(bool toggle) {
 	}
 }
 
+void MainWindow::undo() {
+	Tracer::Scope tracing("command.undo", m_undoGroup->undoText());
+	m_undoGroup->undo();
+}
+
+void MainWindow::redo() {
+	Tracer::Scope tracing("command.redo", m_undoGroup->redoText());
+	m_undoGroup->redo();
+}
+
 void MainWindow::toggleDebuggerOutput(bool toggle) {
 	if (toggle) {
 		DebugDialog::showDebug();
@@ -2772,6 +2966,14 @@ void MainWindow::createTraceMenuActions() {
 	m_newAutorouteAct->setShortcut(tr("Shift+Ctrl+A"));
 	connect(m_newAutorouteAct, SIGNAL(triggered()), this, SLOT(newAutoroute()));
 
+	m_incrementalAutorouteAct = new QAction(tr("Autoroute Around Selection"), this);
+	m_incrementalAutorouteAct->setStatusTip(tr("Rip up only the autorouted traces touching the selected parts and reroute those connections..."));
+	connect(m_incrementalAutorouteAct, SIGNAL(triggered()), this, SLOT(incrementalAutoroute()));
+
+	m_autorouteAllBoardsAct = new QAction(tr("Autoroute All Boards"), this);
+	m_autorouteAllBoardsAct->setStatusTip(tr("Autoroute the connections on every board in the sketch..."));
+	connect(m_autorouteAllBoardsAct, SIGNAL(triggered()), this, SLOT(autorouteAllBoards()));
+
 	createOrderFabAct();
 	createActiveLayerActions();
 
@@ -2845,6 +3047,10 @@ void MainWindow::createTraceMenuActions() {
 	m_copperFillAct->setStatusTip(tr("Fill empty regions of the copper layer--not including traces connected to a GROUND"));
 	connect(m_copperFillAct, SIGNAL(triggered()), this, SLOT(copperFill()));
 
+	m_copperRefillAct = new QAction(tr("Refill Copper Near Changes"), this);
+	m_copperRefillAct->setStatusTip(tr("Redo the copper fill only around the copper changed since the last copper fill"));
+	connect(m_copperRefillAct, SIGNAL(triggered()), this, SLOT(copperRefill()));
+
 	m_removeGroundFillAct = new QAction(tr("Remove Copper Fill"), this);
 	m_removeGroundFillAct->setStatusTip(tr("Remove the copper fill"));
 	connect(m_removeGroundFillAct, SIGNAL(triggered()), this, SLOT(removeGroundFill()));
@@ -2871,6 +3077,11 @@ void MainWindow::createTraceMenuActions() {
 	m_newDesignRulesCheckAct->setShortcut(tr("Shift+Ctrl+D"));
 	connect(m_newDesignRulesCheckAct, SIGNAL(triggered()), this, SLOT(newDesignRulesCheck()));
 
+	m_liveDesignRulesCheckAct = new QAction(tr("Live DRC"), this);
+	m_liveDesignRulesCheckAct->setStatusTip(tr("Highlight overlapping connectors and traces while editing"));
+	m_liveDesignRulesCheckAct->setCheckable(true);
+	connect(m_liveDesignRulesCheckAct, SIGNAL(toggled(bool)), this, SLOT(liveDesignRulesCheck(bool)));
+
 	m_autorouterSettingsAct = new QAction(tr("Autorouter/DRC settings..."), this);
 	m_autorouterSettingsAct->setStatusTip(tr("Set autorouting parameters including keepout..."));
 	connect(m_autorouterSettingsAct, SIGNAL(triggered()), this, SLOT(autorouterSettings()));
@@ -2986,9 +3197,33 @@ void MainWindow::createOrderFabAct() {
 
 
 void MainWindow::newAutoroute() {
+	autoroute(false);
+}
+
+void MainWindow::incrementalAutoroute() {
+	autoroute(true);
+}
+
+void MainWindow::autoroute(bool incremental) {
 	auto * pcbSketchWidget = qobject_cast<PCBSketchWidget *>(m_currentGraphicsView);
 	if (pcbSketchWidget == nullptr) return;
 
+	QList<QRectF> ripUpRegion;
+	if (incremental) {
+		// the region is whatever the selected (typically just moved) parts cover, plus keepout
+		double keepout = pcbSketchWidget->getKeepout();
+		Q_FOREACH (QGraphicsItem * item, pcbSketchWidget->scene()->selectedItems()) {
+			auto * itemBase = dynamic_cast<ItemBase *>(item);
+			if (itemBase == nullptr) continue;
+
+			ripUpRegion << itemBase->layerKinChief()->sceneBoundingRect().adjusted(-keepout, -keepout, keepout, keepout);
+		}
+		if (ripUpRegion.isEmpty()) {
+			QMessageBox::information(this, tr("Fritzing"), tr("Please select the parts whose connections you want to reroute."));
+			return;
+		}
+	}
+
 	ItemBase * board = nullptr;
 	if (pcbSketchWidget->autorouteTypePCB()) {
 		int boardCount;
@@ -3021,7 +3256,15 @@ void MainWindow::newAutoroute() {
 	pcbSketchWidget->scene()->clearSelection();
 	pcbSketchWidget->setIgnoreSelectionChangeEvents(true);
 	Autorouter * autorouter = nullptr;
-	autorouter = new MazeRouter(pcbSketchWidget, board, true);
+	if (pcbSketchWidget->autorouteTypePCB()) {
+		autorouter = new MazeRouter(pcbSketchWidget, board, true);
+	}
+	else {
+		autorouter = new SchematicRouter(pcbSketchWidget);
+	}
+	if (incremental) {
+		autorouter->setRipUpRegion(ripUpRegion);
+	}
 
 	connect(autorouter, SIGNAL(wantTopVisible()), this, SLOT(activeLayerTop()), Qt::DirectConnection);
 	connect(autorouter, SIGNAL(wantBottomVisible()), this, SLOT(activeLayerBottom()), Qt::DirectConnection);
@@ -3037,6 +3280,7 @@ void MainWindow::newAutoroute() {
 	connect(autorouter, SIGNAL(setProgressValue(int)), &progress, SLOT(setValue(int)), Qt::DirectConnection);
 	connect(autorouter, SIGNAL(setProgressMessage(const QString &)), &progress, SLOT(setMessage(const QString &)));
 	connect(autorouter, SIGNAL(setProgressMessage2(const QString &)), &progress, SLOT(setMessage2(const QString &)));
+	connect(autorouter, SIGNAL(setProgressStats(const QString &)), &progress, SLOT(setStats(const QString &)));
 	connect(autorouter, SIGNAL(setCycleMessage(const QString &)), &progress, SLOT(setSpinLabel(const QString &)));
 	connect(autorouter, SIGNAL(setCycleCount(int)), &progress, SLOT(setSpinValue(int)));
 	connect(autorouter, SIGNAL(disableButtons()), &progress, SLOT(disableButtons()));
@@ -3046,6 +3290,7 @@ void MainWindow::newAutoroute() {
 
 	autorouter->start();
 	pcbSketchWidget->setIgnoreSelectionChangeEvents(false);
+	QRectF routedRegion = autorouter->routedRegion();
 
 	delete autorouter;
 
@@ -3058,6 +3303,136 @@ void MainWindow::newAutoroute() {
 	RoutingStatus routingStatus;
 	routingStatus.zero();
 	Q_EMIT pcbSketchWidget->routingStatusSignal(pcbSketchWidget, routingStatus);
+
+	if (!routedRegion.isNull()) {
+		reportRouteCheck(verifyRoute(pcbSketchWidget, board, routedRegion));
+	}
+}
+
+int MainWindow::verifyRoute(PCBSketchWidget * pcbSketchWidget, ItemBase * board, const QRectF & routedRegion) {
+	// the DRC that follows an autoroute, limited to the nets near the new copper
+	if (board == nullptr || routedRegion.isNull()) return 0;
+
+	DRC drc(pcbSketchWidget, board);
+	return drc.verifyRoute(routedRegion, pcbSketchWidget->getKeepout() * 1000 / GraphicsUtils::SVGDPI);     // pixels to mils
+}
+
+void MainWindow::reportRouteCheck(int overlaps) {
+	if (overlaps == 0) {
+		statusMessage(tr("The new traces pass the design rules check."), 5000);
+	}
+	else {
+		statusMessage(tr("%n connector(s) near the new traces overlap or are too close together; run the design rules check for details.", "", overlaps), 10000);
+	}
+}
+
+void MainWindow::autorouteAllBoards() {
+	// one router per board: the searches run at the same time, each on its own grid, then the
+	// routers apply their traces one after another on this thread, inside a single undo macro
+	auto * pcbSketchWidget = qobject_cast<PCBSketchWidget *>(m_currentGraphicsView);
+	if (pcbSketchWidget == nullptr) return;
+	if (!pcbSketchWidget->autorouteTypePCB()) return;
+
+	QList<ItemBase *> boards = pcbSketchWidget->findBoard();
+	if (boards.count() == 0) {
+		QMessageBox::critical(this, tr("Fritzing"),
+		                      tr("Your sketch does not have a board yet!  Please add a PCB in order to use the autorouter."));
+		return;
+	}
+
+	dynamic_cast<SketchAreaWidget *>(pcbSketchWidget->parent())->routingStatusLabel()->setText(tr("Autorouting..."));
+
+	bool copper0Active = pcbSketchWidget->layerIsActive(ViewLayer::Copper0);
+	bool copper1Active = pcbSketchWidget->layerIsActive(ViewLayer::Copper1);
+
+	AutorouteProgressDialog progress(tr("Autorouting Progress..."), true, true, true, true, pcbSketchWidget, this);
+	progress.setModal(true);
+	progress.show();
+	QRect pr = progress.frameGeometry();
+	QRect wr = this->frameGeometry();
+	progress.move(wr.right() - pr.width(), pr.top());
+
+	pcbSketchWidget->scene()->clearSelection();
+	pcbSketchWidget->setIgnoreSelectionChangeEvents(true);
+
+	QList<MazeRouter *> routers;
+	Q_FOREACH (ItemBase * board, boards) {
+		auto * router = new MazeRouter(pcbSketchWidget, board, true);
+		routers << router;
+
+		connect(router, SIGNAL(wantTopVisible()), this, SLOT(activeLayerTop()), Qt::DirectConnection);
+		connect(router, SIGNAL(wantBottomVisible()), this, SLOT(activeLayerBottom()), Qt::DirectConnection);
+		connect(router, SIGNAL(wantBothVisible()), this, SLOT(activeLayerBoth()), Qt::DirectConnection);
+
+		// the dialog's buttons go to every router; its progress shows whichever router reported last
+		connect(&progress, SIGNAL(cancel()), router, SLOT(cancel()), Qt::DirectConnection);
+		connect(&progress, SIGNAL(skip()), router, SLOT(cancelTrace()), Qt::DirectConnection);
+		connect(&progress, SIGNAL(stop()), router, SLOT(stopTracing()), Qt::DirectConnection);
+		connect(&progress, SIGNAL(best()), router, SLOT(useBest()), Qt::DirectConnection);
+		connect(&progress, SIGNAL(spinChange(int)), router, SLOT(setMaxCycles(int)), Qt::DirectConnection);
+
+		connect(router, SIGNAL(setMaximumProgress(int)), &progress, SLOT(setMaximum(int)), Qt::DirectConnection);
+		connect(router, SIGNAL(setProgressValue(int)), &progress, SLOT(setValue(int)), Qt::DirectConnection);
+		connect(router, SIGNAL(setProgressMessage(const QString &)), &progress, SLOT(setMessage(const QString &)));
+		connect(router, SIGNAL(setProgressMessage2(const QString &)), &progress, SLOT(setMessage2(const QString &)));
+		connect(router, SIGNAL(setProgressStats(const QString &)), &progress, SLOT(setStats(const QString &)));
+		connect(router, SIGNAL(setCycleMessage(const QString &)), &progress, SLOT(setSpinLabel(const QString &)));
+		connect(router, SIGNAL(setCycleCount(int)), &progress, SLOT(setSpinValue(int)));
+		connect(router, SIGNAL(disableButtons()), &progress, SLOT(disableButtons()));
+	}
+
+	ProcessEventBlocker::processEvents();
+	ProcessEventBlocker::block();
+
+	// each router only rips up and renders what collides with its own board
+	QList<MazeRouter *> searching;
+	Q_FOREACH (MazeRouter * router, routers) {
+		if (router->beginRouting()) {
+			searching << router;
+		}
+	}
+
+	bool allFinished = false;
+	while (!allFinished) {
+		allFinished = true;
+		Q_FOREACH (MazeRouter * router, searching) {
+			if (!router->searchFinished()) allFinished = false;
+		}
+		if (!allFinished) ProcessEventBlocker::processEvents(200);
+	}
+
+	QHash<ItemBase *, QRectF> routedRegions;
+	if (searching.count() > 0) {
+		pcbSketchWidget->undoStack()->beginMacro(tr("Autoroute all boards"));
+		for (int i = 0; i < routers.count(); i++) {
+			if (!searching.contains(routers.at(i))) continue;
+
+			routers.at(i)->finishRouting();
+			if (!routers.at(i)->routedRegion().isNull()) routedRegions.insert(boards.at(i), routers.at(i)->routedRegion());
+		}
+		pcbSketchWidget->undoStack()->endMacro();
+	}
+	pcbSketchWidget->setIgnoreSelectionChangeEvents(false);
+
+	qDeleteAll(routers);
+
+	pcbSketchWidget->setLayerActive(ViewLayer::Copper1, copper1Active);
+	pcbSketchWidget->setLayerActive(ViewLayer::Silkscreen1, copper1Active);
+	pcbSketchWidget->setLayerActive(ViewLayer::Copper0, copper0Active);
+	pcbSketchWidget->setLayerActive(ViewLayer::Silkscreen0, copper0Active);
+	updateActiveLayerButtons();
+	ProcessEventBlocker::unblock();
+	RoutingStatus routingStatus;
+	routingStatus.zero();
+	Q_EMIT pcbSketchWidget->routingStatusSignal(pcbSketchWidget, routingStatus);
+
+	if (!routedRegions.isEmpty()) {
+		int overlaps = 0;
+		for (auto it = routedRegions.constBegin(); it != routedRegions.constEnd(); ++it) {
+			overlaps += verifyRoute(pcbSketchWidget, it.key(), it.value());
+		}
+		reportRouteCheck(overlaps);
+	}
 }
 
 void MainWindow::createTrace() {
@@ -3250,15 +3625,41 @@ void MainWindow::groundFill()
 }
 
 void MainWindow::groundFillAux2(bool fillGroundTraces) {
+	groundFillAux(fillGroundTraces, activeFillLayer());
+}
 
+ViewLayer::ViewLayerID MainWindow::activeFillLayer() {
 	if (m_pcbGraphicsView->layerIsActive(ViewLayer::Copper0) && m_pcbGraphicsView->layerIsActive(ViewLayer::Copper1)) {
-		groundFillAux(fillGroundTraces, ViewLayer::UnknownLayer);
+		return ViewLayer::UnknownLayer;
 	}
-	else if (m_pcbGraphicsView->layerIsActive(ViewLayer::Copper0)) {
-		groundFillAux(fillGroundTraces, ViewLayer::GroundPlane0);
+	if (m_pcbGraphicsView->layerIsActive(ViewLayer::Copper0)) {
+		return ViewLayer::GroundPlane0;
 	}
-	else {
-		groundFillAux(fillGroundTraces, ViewLayer::GroundPlane1);
+	return ViewLayer::GroundPlane1;
+}
+
+void MainWindow::copperRefill() {
+	// only where copper changed since the last copper fill, as long as that fill is untouched; otherwise a full copper fill
+	if (m_pcbGraphicsView == nullptr) return;
+
+	ViewLayer::ViewLayerID viewLayerID = activeFillLayer();
+	bool fullFill = true;
+	{
+		FileProgressDialog fileProgress(tr("Refilling copper..."), 0, this);
+		fileProgress.setIndeterminate();
+		auto * parentCommand = new QUndoCommand(tr("Copper Refill"));
+		m_pcbGraphicsView->blockUI(true);
+		if (m_pcbGraphicsView->copperRefill(viewLayerID, parentCommand, fullFill) && parentCommand->childCount() > 0) {
+			m_undoStack->push(parentCommand);
+		}
+		else {
+			delete parentCommand;
+		}
+		m_pcbGraphicsView->blockUI(false);
+	}
+
+	if (fullFill) {
+		groundFillAux(false, viewLayerID);
 	}
 }
 
@@ -4317,6 +4718,18 @@ QStringList MainWindow::newDesignRulesCheck(bool showOkMessage)
 	return results;
 }
 
+void MainWindow::liveDesignRulesCheck(bool on) {
+	// checks again after each edit, and only near what changed; see LiveDRC
+	if (m_pcbGraphicsView == nullptr) return;
+
+	if (m_liveDRC == nullptr) {
+		if (!on) return;
+
+		m_liveDRC = new LiveDRC(m_pcbGraphicsView, this);
+	}
+	m_liveDRC->setEnabled(on);
+}
+
 void MainWindow::changeTraceLayer() {
 	if (m_currentGraphicsView == nullptr) return;
 	if (m_currentGraphicsView != m_pcbGraphicsView) return;
@@ -0,0 +1,354 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "backupjournal.h"
+#include "modelbase.h"
+#include "binarysketch.h"
+#include "../debugdialog.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDomDocument>
+#include <QFile>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QtConcurrentRun>
+
+const int BackupJournal::MaxRecords = 2000;
+const int BackupJournal::CompactPercent = 50;
+
+static const QDataStream::Version JournalStreamVersion = QDataStream::Qt_5_12;
+
+static void indexInstances(QDomElement & instances, QHash<qint64, QDomElement> & byIndex)
+{
+	byIndex.clear();
+	QDomElement instance = instances.firstChildElement("instance");
+	while (!instance.isNull()) {
+		byIndex.insert(instance.attribute("modelIndex").toLongLong(), instance);
+		instance = instance.nextSiblingElement("instance");
+	}
+}
+
+BackupJournal::BackupJournal(const QString & path) : m_path(path), m_failed(false)
+{
+}
+
+BackupJournal::~BackupJournal()
+{
+	m_writing.waitForFinished();
+}
+
+const QString & BackupJournal::path() const
+{
+	return m_path;
+}
+
+QString BackupJournal::journalPath(const QString & path)
+{
+	return path + ".journal";
+}
+
+bool BackupJournal::save(ModelBase * modelBase)
+{
+	// returns false when the previous backup is still being written, so the caller can try again later
+
+	if (m_writing.isRunning()) return false;
+
+	QBuffer buffer;
+	buffer.open(QIODevice::WriteOnly);
+	QXmlStreamWriter streamWriter(&buffer);
+	modelBase->save(m_path, streamWriter, false);
+	buffer.close();
+	QByteArray snapshot = buffer.data();
+
+	Fragments fragments;
+	bool splitOK = split(QString::fromUtf8(snapshot), fragments);
+	bool compact = !splitOK || !m_hasSnapshot || m_failed || m_journalRecords >= MaxRecords;
+
+	QList<Record> records;
+	qint64 recordBytes = 0;
+	if (!compact) {
+		QByteArray headerDigest = digest(fragments.header);
+		if (headerDigest != m_header) {
+			Record record;
+			record.op = Header;
+			record.data = fragments.header;
+			records.append(record);
+		}
+		Q_FOREACH (qint64 modelIndex, fragments.order) {
+			const QByteArray & instance = fragments.instances[modelIndex];
+			if (m_digests.value(modelIndex) == digest(instance)) continue;
+
+			Record record;
+			record.op = Upsert;
+			record.modelIndex = modelIndex;
+			record.data = instance;
+			records.append(record);
+		}
+		for (auto it = m_digests.constBegin(); it != m_digests.constEnd(); ++it) {
+			if (fragments.instances.contains(it.key())) continue;
+
+			Record record;
+			record.op = Remove;
+			record.modelIndex = it.key();
+			records.append(record);
+		}
+		Q_FOREACH (const Record & record, records) {
+			recordBytes += record.data.size() + 16;
+		}
+		compact = (m_journalBytes + recordBytes) * 100 > m_snapshotBytes * CompactPercent;
+	}
+
+	m_header.clear();
+	m_digests.clear();
+	if (splitOK) {
+		m_header = digest(fragments.header);
+		for (auto it = fragments.instances.constBegin(); it != fragments.instances.constEnd(); ++it) {
+			m_digests.insert(it.key(), digest(it.value()));
+		}
+	}
+
+	if (compact) {
+		m_failed = false;
+		m_hasSnapshot = splitOK;			// an unsplittable document is only ever backed up whole
+		m_snapshotBytes = snapshot.size();
+		m_journalBytes = 0;
+		m_journalRecords = 0;
+		QString path = m_path;
+		std::atomic<bool> * failed = &m_failed;
+		m_writing = QtConcurrent::run([path, snapshot, failed]() {
+			writeSnapshot(path, snapshot, *failed);
+		});
+		return true;
+	}
+
+	if (records.isEmpty()) return true;
+
+	DebugDialog::debug(QString("backup journal: %1 records, %2 bytes").arg(records.count()).arg(recordBytes));
+	m_journalBytes += recordBytes;
+	m_journalRecords += records.count();
+	QString path = journalPath(m_path);
+	std::atomic<bool> * failed = &m_failed;
+	m_writing = QtConcurrent::run([path, records, failed]() {
+		appendRecords(path, records, *failed);
+	});
+	return true;
+}
+
+void BackupJournal::remove()
+{
+	m_writing.waitForFinished();
+	QFile::remove(journalPath(m_path));
+	QFile::remove(m_path);
+	m_hasSnapshot = false;
+	m_failed = false;
+	m_header.clear();
+	m_digests.clear();
+	m_snapshotBytes = m_journalBytes = 0;
+	m_journalRecords = 0;
+}
+
+bool BackupJournal::split(const QString & text, Fragments & fragments)
+{
+	// cuts each top-level <instance> out of the serialized sketch; what remains is the header
+
+	QXmlStreamReader reader(text);
+	QString header;
+	qint64 copied = 0;
+	qint64 previous = 0;
+	int depth = 0;
+	while (!reader.atEnd()) {
+		QXmlStreamReader::TokenType token = reader.readNext();
+		if (token == QXmlStreamReader::EndElement) {
+			depth--;
+		}
+		else if (token == QXmlStreamReader::StartElement) {
+			depth++;
+			if (depth == 3 && reader.name() == QLatin1String("instance")) {
+				bool ok;
+				qint64 modelIndex = reader.attributes().value("modelIndex").toString().toLongLong(&ok);
+				if (!ok || fragments.instances.contains(modelIndex)) return false;
+
+				reader.skipCurrentElement();
+				depth--;
+				qint64 end = reader.characterOffset();
+				header += text.mid(copied, previous - copied);
+				fragments.instances.insert(modelIndex, text.mid(previous, end - previous).toUtf8());
+				fragments.order.append(modelIndex);
+				copied = end;
+			}
+		}
+		previous = reader.characterOffset();
+	}
+
+	if (reader.hasError()) {
+		DebugDialog::debug(QString("backup journal: unable to split sketch: %1").arg(reader.errorString()));
+		return false;
+	}
+
+	header += text.mid(copied);
+	fragments.header = header.toUtf8();
+	return true;
+}
+
+QByteArray BackupJournal::digest(const QByteArray & bytes)
+{
+	return QCryptographicHash::hash(bytes, QCryptographicHash::Md5);
+}
+
+void BackupJournal::writeSnapshot(const QString & path, const QByteArray & snapshot, std::atomic<bool> & failed)
+{
+	// snapshots are kept binary encoded; replay turns them back into a .fz
+	QByteArray binary = BinarySketch::encode(snapshot);
+	const QByteArray & bytes = binary.isEmpty() ? snapshot : binary;
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size()) {
+		failed = true;
+		return;
+	}
+
+	// the journal belongs to the snapshot being replaced
+	QFile::remove(journalPath(path));
+	if (!file.commit()) {
+		DebugDialog::debug(QString("backup journal: unable to write %1").arg(path));
+		failed = true;
+	}
+}
+
+void BackupJournal::appendRecords(const QString & path, const QList<Record> & records, std::atomic<bool> & failed)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		failed = true;
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(JournalStreamVersion);
+	Q_FOREACH (const Record & record, records) {
+		stream << record.op << record.modelIndex << record.data;
+	}
+	if (stream.status() != QDataStream::Ok || !file.flush()) {
+		failed = true;
+	}
+}
+
+bool BackupJournal::replay(const QString & path)
+{
+	// folds the journal beside a backup into the backup itself and leaves it as a plain .fz; a record
+	// cut short by a crash ends the replay, so the result is the sketch as of the last complete backup
+
+	QFile journal(journalPath(path));
+	QFile snapshot(path);
+	if (!snapshot.open(QIODevice::ReadOnly)) return false;
+
+	bool binary = BinarySketch::isBinary(snapshot);
+	if (!binary && !journal.exists()) return true;
+
+	QDomDocument document;
+	bool parsed = binary
+	              ? BinarySketch::toDocument(snapshot.readAll(), document)
+	              : document.setContent(&snapshot);
+	snapshot.close();
+	if (!parsed) {
+		DebugDialog::debug(QString("backup journal: unable to read %1").arg(path));
+		return false;
+	}
+
+	QDomElement instances = document.documentElement().firstChildElement("instances");
+	if (instances.isNull()) return false;
+
+	if (journal.exists() && !journal.open(QIODevice::ReadOnly)) return false;
+
+	QHash<qint64, QDomElement> byIndex;
+	indexInstances(instances, byIndex);
+
+	QDataStream stream(&journal);
+	stream.setVersion(JournalStreamVersion);
+	int applied = 0;
+	bool ok = journal.isOpen();
+	while (ok && !stream.atEnd()) {
+		Record record;
+		stream >> record.op >> record.modelIndex >> record.data;
+		if (stream.status() != QDataStream::Ok) break;
+
+		switch (record.op) {
+		case Header: {
+			QDomDocument header;
+			QDomElement headerInstances;
+			if (header.setContent(record.data)) {
+				headerInstances = header.documentElement().firstChildElement("instances");
+			}
+			if (headerInstances.isNull()) {
+				ok = false;
+				break;
+			}
+			QDomNode moved = header.importNode(instances, true);
+			header.documentElement().replaceChild(moved, headerInstances);
+			document = header;
+			instances = moved.toElement();
+			indexInstances(instances, byIndex);
+			break;
+		}
+		case Upsert: {
+			QDomDocument fragment;
+			if (!fragment.setContent(record.data)) {
+				ok = false;
+				break;
+			}
+			QDomElement instance = document.importNode(fragment.documentElement(), true).toElement();
+			QDomElement old = byIndex.value(record.modelIndex);
+			if (old.isNull()) {
+				instances.appendChild(instance);
+			}
+			else {
+				instances.replaceChild(instance, old);
+			}
+			byIndex.insert(record.modelIndex, instance);
+			break;
+		}
+		case Remove: {
+			QDomElement old = byIndex.take(record.modelIndex);
+			if (!old.isNull()) {
+				instances.removeChild(old);
+			}
+			break;
+		}
+		default:
+			ok = false;
+			break;
+		}
+
+		if (ok) applied++;
+	}
+	journal.close();
+
+	DebugDialog::debug(QString("backup journal: replayed %1 records into %2").arg(applied).arg(path));
+
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) return false;
+
+	file.write(document.toByteArray(4));
+	if (!file.commit()) return false;
+
+	QFile::remove(journalPath(path));
+	return true;
+}
@@ -0,0 +1,89 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef BACKUPJOURNAL_H
+#define BACKUPJOURNAL_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <atomic>
+
+class BackupJournal
+{
+	// an autosave as a full snapshot plus an append-only journal of the instances that changed
+	// since; each backup writes only the difference, on a worker thread, and the journal is folded
+	// back into a new snapshot once it grows past a fraction of it; replay() rebuilds the .fz
+
+public:
+	explicit BackupJournal(const QString & path);
+	~BackupJournal();
+
+	bool save(class ModelBase *);
+	void remove();
+	const QString & path() const;
+
+public:
+	static bool replay(const QString & path);
+	static QString journalPath(const QString & path);
+
+protected:
+	enum Op {
+		Header = 0,
+		Upsert,
+		Remove
+	};
+
+	struct Record {
+		quint8 op = Header;
+		qint64 modelIndex = -1;
+		QByteArray data;
+	};
+
+	struct Fragments {
+		QByteArray header;							// the document with its instances left out
+		QList<qint64> order;
+		QHash<qint64, QByteArray> instances;
+	};
+
+	static bool split(const QString & text, Fragments &);
+	static QByteArray digest(const QByteArray &);
+	static void writeSnapshot(const QString & path, const QByteArray & snapshot, std::atomic<bool> & failed);
+	static void appendRecords(const QString & path, const QList<Record> &, std::atomic<bool> & failed);
+
+protected:
+	QString m_path;
+	QFuture<void> m_writing;
+	std::atomic<bool> m_failed;
+	bool m_hasSnapshot = false;
+	qint64 m_snapshotBytes = 0;
+	qint64 m_journalBytes = 0;
+	int m_journalRecords = 0;
+	QByteArray m_header;
+	QHash<qint64, QByteArray> m_digests;			// modelIndex -> digest of the instance as last handed to the writer
+
+protected:
+	static const int MaxRecords;
+	static const int CompactPercent;
+};
+
+#endif
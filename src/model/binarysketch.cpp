@@ -0,0 +1,418 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "binarysketch.h"
+
+#include <QDomDocument>
+#include <QHash>
+#include <QIODevice>
+#include <QVector>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include <cstring>
+
+const QByteArray BinarySketch::Magic("FZB\x01", 4);
+
+namespace {
+
+enum Token : quint8 {
+	End = 0,
+	StartElement,
+	EndElement,
+	Characters,
+	CData,
+	Comment,
+	ProcessingInstruction
+};
+
+void writeVarint(QByteArray & bytes, quint64 value)
+{
+	while (value >= 0x80) {
+		bytes.append(char((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	bytes.append(char(value));
+}
+
+class StringTable
+{
+public:
+	int id(const QString & string) {
+		auto it = m_ids.constFind(string);
+		if (it != m_ids.constEnd()) return it.value();
+
+		int id = m_strings.count();
+		m_ids.insert(string, id);
+		m_strings.append(string);
+		return id;
+	}
+
+	void write(QByteArray & bytes) const {
+		writeVarint(bytes, m_strings.count());
+		Q_FOREACH (const QString & string, m_strings) {
+			QByteArray utf8 = string.toUtf8();
+			writeVarint(bytes, utf8.size());
+			bytes.append(utf8);
+		}
+	}
+
+protected:
+	QHash<QString, int> m_ids;
+	QVector<QString> m_strings;
+};
+
+class Reader
+{
+	// walks an encoded document and hands each token to a sink; every read is bounds checked,
+	// so a truncated or corrupt encoding fails instead of reading past the end
+
+public:
+	Reader(const QByteArray & bytes) : m_data(reinterpret_cast<const uchar *>(bytes.constData())), m_size(bytes.size()) {
+	}
+
+	template <class Sink>
+	bool read(Sink & sink, QString * errorString) {
+		if (m_size < BinarySketch::Magic.size() || memcmp(m_data, BinarySketch::Magic.constData(), BinarySketch::Magic.size()) != 0) {
+			return fail(errorString, "not a binary sketch");
+		}
+		m_pos = BinarySketch::Magic.size();
+
+		quint64 count;
+		if (!varint(count) || count > quint64(m_size)) return fail(errorString, "bad string table");
+
+		m_strings.reserve(int(count));
+		for (quint64 i = 0; i < count; i++) {
+			quint64 length;
+			if (!varint(length) || length > quint64(m_size - m_pos)) return fail(errorString, "bad string table");
+
+			m_strings.append(QString::fromUtf8(reinterpret_cast<const char *>(m_data + m_pos), int(length)));
+			m_pos += int(length);
+		}
+
+		int depth = 0;
+		while (true) {
+			if (m_pos >= m_size) return fail(errorString, "truncated");
+
+			quint8 token = m_data[m_pos++];
+			switch (token) {
+			case End:
+				if (depth != 0) return fail(errorString, "unbalanced elements");
+				return true;
+			case StartElement: {
+				const QString * name;
+				quint64 attributeCount;
+				if (!string(name) || !varint(attributeCount)) return fail(errorString, "truncated");
+
+				sink.startElement(*name);
+				for (quint64 i = 0; i < attributeCount; i++) {
+					const QString * attributeName;
+					const QString * value;
+					if (!string(attributeName) || !string(value)) return fail(errorString, "truncated");
+
+					sink.attribute(*attributeName, *value);
+				}
+				depth++;
+				break;
+			}
+			case EndElement:
+				if (--depth < 0) return fail(errorString, "unbalanced elements");
+				sink.endElement();
+				break;
+			case Characters:
+			case CData:
+			case Comment: {
+				const QString * text;
+				if (!string(text)) return fail(errorString, "truncated");
+
+				sink.text(Token(token), *text);
+				break;
+			}
+			case ProcessingInstruction: {
+				const QString * target;
+				const QString * data;
+				if (!string(target) || !string(data)) return fail(errorString, "truncated");
+
+				sink.processingInstruction(*target, *data);
+				break;
+			}
+			default:
+				return fail(errorString, "unknown token");
+			}
+		}
+	}
+
+protected:
+	bool varint(quint64 & value) {
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (m_pos >= m_size) return false;
+
+			uchar byte = m_data[m_pos++];
+			value |= quint64(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) return true;
+		}
+		return false;
+	}
+
+	bool string(const QString * & string) {
+		quint64 id;
+		if (!varint(id) || id >= quint64(m_strings.count())) return false;
+
+		string = &m_strings.at(int(id));
+		return true;
+	}
+
+	static bool fail(QString * errorString, const char * message) {
+		if (errorString) *errorString = QString("binary sketch: %1").arg(message);
+		return false;
+	}
+
+protected:
+	const uchar * m_data;
+	int m_size;
+	int m_pos = 0;
+	QVector<QString> m_strings;
+};
+
+class XmlSink
+{
+public:
+	XmlSink(QByteArray * bytes) : m_writer(bytes) {
+		m_writer.writeStartDocument();
+	}
+
+	void startElement(const QString & name) {
+		m_writer.writeStartElement(name);
+	}
+
+	void attribute(const QString & name, const QString & value) {
+		m_writer.writeAttribute(name, value);
+	}
+
+	void endElement() {
+		m_writer.writeEndElement();
+	}
+
+	void text(Token token, const QString & text) {
+		if (token == CData) m_writer.writeCDATA(text);
+		else if (token == Comment) m_writer.writeComment(text);
+		else m_writer.writeCharacters(text);
+	}
+
+	void processingInstruction(const QString & target, const QString & data) {
+		m_writer.writeProcessingInstruction(target, data);
+	}
+
+	void finish() {
+		m_writer.writeEndDocument();
+	}
+
+protected:
+	QXmlStreamWriter m_writer;
+};
+
+class DomSink
+{
+	// builds the same tree QDomDocument::setContent would, which leaves out whitespace-only text
+
+public:
+	DomSink(QDomDocument & document) : m_document(document), m_parent(document) {
+	}
+
+	void startElement(const QString & name) {
+		QDomElement element = m_document.createElement(name);
+		m_parent.appendChild(element);
+		m_parent = element;
+		m_element = element;
+	}
+
+	void attribute(const QString & name, const QString & value) {
+		m_element.setAttribute(name, value);
+	}
+
+	void endElement() {
+		m_parent = m_parent.parentNode();
+	}
+
+	void text(Token token, const QString & text) {
+		if (token == CData) m_parent.appendChild(m_document.createCDATASection(text));
+		else if (token == Comment) m_parent.appendChild(m_document.createComment(text));
+		else if (!text.trimmed().isEmpty()) m_parent.appendChild(m_document.createTextNode(text));
+	}
+
+	void processingInstruction(const QString & target, const QString & data) {
+		m_parent.appendChild(m_document.createProcessingInstruction(target, data));
+	}
+
+protected:
+	QDomDocument & m_document;
+	QDomNode m_parent;
+	QDomElement m_element;
+};
+
+}
+
+bool BinarySketch::isBinary(const QByteArray & bytes)
+{
+	return bytes.startsWith(Magic);
+}
+
+bool BinarySketch::isBinary(QIODevice & device)
+{
+	return device.peek(Magic.size()) == Magic;
+}
+
+QByteArray BinarySketch::encode(const QByteArray & xml, QString * errorString)
+{
+	// returns an empty array if the xml doesn't parse; the xml declaration and any doctype are not kept
+
+	QXmlStreamReader reader(xml);
+	reader.setNamespaceProcessing(false);		// namespace declarations stay ordinary attributes
+
+	StringTable strings;
+	QByteArray tokens;
+	while (!reader.atEnd()) {
+		switch (reader.readNext()) {
+		case QXmlStreamReader::StartElement: {
+			tokens.append(char(StartElement));
+			writeVarint(tokens, strings.id(reader.qualifiedName().toString()));
+			QXmlStreamAttributes attributes = reader.attributes();
+			writeVarint(tokens, attributes.count());
+			for (const QXmlStreamAttribute & attribute : attributes) {
+				writeVarint(tokens, strings.id(attribute.qualifiedName().toString()));
+				writeVarint(tokens, strings.id(attribute.value().toString()));
+			}
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			tokens.append(char(EndElement));
+			break;
+		case QXmlStreamReader::Characters:
+			tokens.append(char(reader.isCDATA() ? CData : Characters));
+			writeVarint(tokens, strings.id(reader.text().toString()));
+			break;
+		case QXmlStreamReader::Comment:
+			tokens.append(char(Comment));
+			writeVarint(tokens, strings.id(reader.text().toString()));
+			break;
+		case QXmlStreamReader::ProcessingInstruction:
+			tokens.append(char(ProcessingInstruction));
+			writeVarint(tokens, strings.id(reader.processingInstructionTarget().toString()));
+			writeVarint(tokens, strings.id(reader.processingInstructionData().toString()));
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (reader.hasError()) {
+		if (errorString) *errorString = QString("binary sketch: %1 at line %2").arg(reader.errorString()).arg(reader.lineNumber());
+		return QByteArray();
+	}
+
+	tokens.append(char(End));
+
+	QByteArray result = Magic;
+	strings.write(result);
+	result.append(tokens);
+	return result;
+}
+
+static void encodeNode(const QDomNode & node, StringTable & strings, QByteArray & tokens)
+{
+	if (node.isElement()) {
+		tokens.append(char(StartElement));
+		writeVarint(tokens, strings.id(node.nodeName()));
+		QDomNamedNodeMap attributes = node.attributes();
+		writeVarint(tokens, attributes.count());
+		for (int i = 0; i < attributes.count(); i++) {
+			QDomNode attribute = attributes.item(i);
+			writeVarint(tokens, strings.id(attribute.nodeName()));
+			writeVarint(tokens, strings.id(attribute.nodeValue()));
+		}
+		for (QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling()) {
+			encodeNode(child, strings, tokens);
+		}
+		tokens.append(char(EndElement));
+	}
+	else if (node.isCDATASection()) {
+		tokens.append(char(CData));
+		writeVarint(tokens, strings.id(node.nodeValue()));
+	}
+	else if (node.isText()) {
+		tokens.append(char(Characters));
+		writeVarint(tokens, strings.id(node.nodeValue()));
+	}
+	else if (node.isComment()) {
+		tokens.append(char(Comment));
+		writeVarint(tokens, strings.id(node.nodeValue()));
+	}
+	else if (node.isProcessingInstruction()) {
+		QDomProcessingInstruction instruction = node.toProcessingInstruction();
+		tokens.append(char(ProcessingInstruction));
+		writeVarint(tokens, strings.id(instruction.target()));
+		writeVarint(tokens, strings.id(instruction.data()));
+	}
+}
+
+QByteArray BinarySketch::encode(const QDomDocument & document)
+{
+	// straight from a document already in memory, without writing and re-reading the xml
+
+	StringTable strings;
+	QByteArray tokens;
+	for (QDomNode child = document.firstChild(); !child.isNull(); child = child.nextSibling()) {
+		if (child.isProcessingInstruction() && child.toProcessingInstruction().target() == "xml") continue;
+
+		encodeNode(child, strings, tokens);
+	}
+	tokens.append(char(End));
+
+	QByteArray result = Magic;
+	strings.write(result);
+	result.append(tokens);
+	return result;
+}
+
+QByteArray BinarySketch::decode(const QByteArray & binary, QString * errorString)
+{
+	// returns the xml, or an empty array if the encoding is corrupt
+
+	QByteArray xml;
+	XmlSink sink(&xml);
+	Reader reader(binary);
+	if (!reader.read(sink, errorString)) return QByteArray();
+
+	sink.finish();
+	return xml;
+}
+
+bool BinarySketch::toDocument(const QByteArray & binary, QDomDocument & document, QString * errorString)
+{
+	document.clear();
+	DomSink sink(document);
+	Reader reader(binary);
+	if (!reader.read(sink, errorString)) {
+		document.clear();
+		return false;
+	}
+
+	return true;
+}
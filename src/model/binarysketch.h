@@ -0,0 +1,48 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef BINARYSKETCH_H
+#define BINARYSKETCH_H
+
+#include <QByteArray>
+#include <QString>
+
+class QDomDocument;
+class QIODevice;
+
+class BinarySketch
+{
+	// a compact, lossless encoding of a .fz (or any other fritzing xml): every element name, attribute
+	// name, attribute value and text is stored once in a string table and referred to by varint ids,
+	// so the many repeated module ids, layer names and coordinates cost a byte or two each; decoding
+	// needs no xml tokenizing and shares each distinct string between all its uses
+
+public:
+	static bool isBinary(const QByteArray &);
+	static bool isBinary(QIODevice &);
+	static QByteArray encode(const QByteArray & xml, QString * errorString = nullptr);
+	static QByteArray encode(const QDomDocument &);
+	static QByteArray decode(const QByteArray & binary, QString * errorString = nullptr);
+	static bool toDocument(const QByteArray & binary, QDomDocument &, QString * errorString = nullptr);
+
+public:
+	static const QByteArray Magic;
+};
+
+#endif
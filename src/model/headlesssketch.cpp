@@ -0,0 +1,458 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "headlesssketch.h"
+#include "binarysketch.h"
+#include "../items/moduleidnames.h"
+#include "../utils/textutils.h"
+
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVector>
+#include <QVariant>
+#include <QXmlStreamWriter>
+
+static QAtomicInt ConnectionCount;
+static const int IndexMultiplier = 10;				// ModelPart::indexMultiplier, as item ids are written to netlists
+static const double DefaultVoltage = 5;				// SymbolPaletteItem::DefaultVoltage
+
+HeadlessSketch::~HeadlessSketch()
+{
+	closeDatabase();
+}
+
+bool HeadlessSketch::setPartsDatabase(const QString & path)
+{
+	// parts.db, as written by the -db service, for the connectors and buses of the core parts
+	closeDatabase();
+
+	QString connection = QString("headlesssketch%1").arg(ConnectionCount.fetchAndAddRelaxed(1));
+	{
+		QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connection);
+		database.setDatabaseName(path);
+		database.setConnectOptions("QSQLITE_OPEN_READONLY");
+		if (database.open()) {
+			m_databaseConnection = connection;
+			m_parts.clear();
+			return true;
+		}
+	}
+
+	QSqlDatabase::removeDatabase(connection);
+	return false;
+}
+
+void HeadlessSketch::closeDatabase()
+{
+	if (m_databaseConnection.isEmpty()) return;
+
+	{
+		QSqlDatabase database = QSqlDatabase::database(m_databaseConnection, false);
+		database.close();
+	}
+	QSqlDatabase::removeDatabase(m_databaseConnection);
+	m_databaseConnection.clear();
+}
+
+bool HeadlessSketch::load(const QByteArray & fz, QString * errorString)
+{
+	QDomDocument document;
+	if (BinarySketch::isBinary(fz)) {
+		if (!BinarySketch::toDocument(fz, document, errorString)) return false;
+	}
+	else {
+		QString message;
+		int line = 0;
+		int column = 0;
+		if (!document.setContent(fz, &message, &line, &column)) {
+			if (errorString != nullptr) {
+				*errorString = QString("%1 at line %2 column %3").arg(message).arg(line).arg(column);
+			}
+			return false;
+		}
+	}
+
+	return loadDocument(document, errorString);
+}
+
+bool HeadlessSketch::loadBundle(const QList<QPair<QString, QByteArray> > & entries, QString * errorString)
+{
+	// the entries of an .fzz, as FolderUtils::unzipToMemory returns them; parts that came
+	// with the bundle take precedence over the database
+	const QByteArray * fz = nullptr;
+	for (int i = 0; i < entries.count(); i++) {
+		const QPair<QString, QByteArray> & entry = entries.at(i);
+		if (entry.first.endsWith(".fzp", Qt::CaseInsensitive)) {
+			addPart(entry.second);
+		}
+		else if (fz == nullptr && entry.first.endsWith(".fz", Qt::CaseInsensitive)) {
+			fz = &entry.second;
+		}
+	}
+
+	if (fz == nullptr) {
+		if (errorString != nullptr) *errorString = "no .fz in the bundle";
+		return false;
+	}
+
+	return load(*fz, errorString);
+}
+
+bool HeadlessSketch::loadDocument(const QDomDocument & document, QString * errorString)
+{
+	m_instances.clear();
+	m_instanceIndexes.clear();
+	m_connects.clear();
+
+	QDomElement root = document.documentElement();
+	if (root.tagName() != "module") {
+		if (errorString != nullptr) *errorString = "not a sketch";
+		return false;
+	}
+
+	QDomElement instanceElement = root.firstChildElement("instances").firstChildElement("instance");
+	for (; !instanceElement.isNull(); instanceElement = instanceElement.nextSiblingElement("instance")) {
+		Instance instance;
+		bool ok;
+		instance.modelIndex = instanceElement.attribute("modelIndex").toLong(&ok);
+		if (!ok) continue;
+
+		instance.moduleIdRef = instanceElement.attribute("moduleIdRef");
+		instance.title = instanceElement.firstChildElement("title").text();
+		QDomElement property = instanceElement.firstChildElement("property");
+		for (; !property.isNull(); property = property.nextSiblingElement("property")) {
+			instance.properties.insert(property.attribute("name"), property.attribute("value"));
+		}
+
+		QDomElement view = instanceElement.firstChildElement("views").firstChildElement();
+		for (; !view.isNull(); view = view.nextSiblingElement()) {
+			QString viewName = view.tagName();
+			instance.views.append(viewName);
+			QDomElement geometry = view.firstChildElement("geometry");
+			if (!geometry.isNull()) {
+				instance.locations.insert(viewName, QPointF(geometry.attribute("x").toDouble(), geometry.attribute("y").toDouble()));
+			}
+			QList<Connect> & connects = m_connects[viewName];
+			QDomElement connector = view.firstChildElement("connectors").firstChildElement("connector");
+			for (; !connector.isNull(); connector = connector.nextSiblingElement("connector")) {
+				Connect connect;
+				connect.from.modelIndex = instance.modelIndex;
+				connect.from.connectorID = connector.attribute("connectorId");
+				QDomElement to = connector.firstChildElement("connects").firstChildElement("connect");
+				for (; !to.isNull(); to = to.nextSiblingElement("connect")) {
+					connect.to.modelIndex = to.attribute("modelIndex").toLong(&ok);
+					if (!ok) continue;
+
+					connect.to.connectorID = to.attribute("connectorId");
+					connects.append(connect);
+				}
+			}
+		}
+
+		m_instanceIndexes.insert(instance.modelIndex, m_instances.count());
+		m_instances.append(instance);
+	}
+
+	return true;
+}
+
+bool HeadlessSketch::addPart(const QByteArray & fzp)
+{
+	QDomDocument document;
+	if (!document.setContent(fzp)) return false;
+
+	QDomElement root = document.documentElement();
+	QString moduleID = root.attribute("moduleId");
+	if (moduleID.isEmpty()) return false;
+
+	PartInfo part;
+	part.title = root.firstChildElement("title").text();
+	QDomElement connector = root.firstChildElement("connectors").firstChildElement("connector");
+	for (; !connector.isNull(); connector = connector.nextSiblingElement("connector")) {
+		QString id = connector.attribute("id");
+		part.connectorIDs.append(id);
+		part.connectorNames.insert(id, connector.attribute("name"));
+	}
+
+	QDomElement bus = root.firstChildElement("buses").firstChildElement("bus");
+	for (; !bus.isNull(); bus = bus.nextSiblingElement("bus")) {
+		QStringList members;
+		QDomElement member = bus.firstChildElement("nodeMember");
+		for (; !member.isNull(); member = member.nextSiblingElement("nodeMember")) {
+			members.append(member.attribute("connectorId"));
+		}
+		if (members.count() > 1) part.buses.append(members);
+	}
+
+	m_parts.insert(moduleID, part);
+	return true;
+}
+
+const QList<HeadlessSketch::Instance> & HeadlessSketch::instances() const
+{
+	return m_instances;
+}
+
+const HeadlessSketch::Instance * HeadlessSketch::instance(long modelIndex) const
+{
+	auto it = m_instanceIndexes.constFind(modelIndex);
+	if (it == m_instanceIndexes.constEnd()) return nullptr;
+
+	return &m_instances.at(it.value());
+}
+
+const HeadlessSketch::PartInfo & HeadlessSketch::partInfo(const QString & moduleID)
+{
+	auto it = m_parts.constFind(moduleID);
+	if (it != m_parts.constEnd()) return it.value();
+
+	// parts found in neither place keep an empty entry, and only their connected connectors show up
+	PartInfo & part = m_parts[moduleID];
+	if (m_databaseConnection.isEmpty()) return part;
+
+	QSqlDatabase database = QSqlDatabase::database(m_databaseConnection, false);
+	QSqlQuery query(database);
+	query.prepare("SELECT id FROM parts WHERE moduleID = :moduleID");
+	query.bindValue(":moduleID", moduleID);
+	if (!query.exec() || !query.next()) return part;
+
+	QVariant partID = query.value(0);
+
+	// the title column is only there in a fully loaded database
+	query.prepare("SELECT title FROM parts WHERE id = :id");
+	query.bindValue(":id", partID);
+	if (query.exec() && query.next()) {
+		part.title = query.value(0).toString();
+	}
+
+	query.prepare("SELECT connectorid, name FROM connectors WHERE part_id = :id ORDER BY id");
+	query.bindValue(":id", partID);
+	if (query.exec()) {
+		while (query.next()) {
+			QString id = query.value(0).toString();
+			part.connectorIDs.append(id);
+			part.connectorNames.insert(id, query.value(1).toString());
+		}
+	}
+
+	query.prepare("SELECT buses.id, busmembers.connectorid FROM buses JOIN busmembers ON busmembers.bus_id = buses.id WHERE buses.part_id = :id ORDER BY buses.id");
+	query.bindValue(":id", partID);
+	if (query.exec()) {
+		QVariant busID;
+		QStringList members;
+		while (query.next()) {
+			if (query.value(0) != busID) {
+				if (members.count() > 1) part.buses.append(members);
+				members.clear();
+				busID = query.value(0);
+			}
+			members.append(query.value(1).toString());
+		}
+		if (members.count() > 1) part.buses.append(members);
+	}
+
+	return part;
+}
+
+bool HeadlessSketch::isWire(const Instance & instance)
+{
+	return instance.moduleIdRef == ModuleIDNames::WireModuleIDName;
+}
+
+QString HeadlessSketch::symbolNet(const Instance & instance)
+{
+	// symbols join their nets across the sketch as SymbolPaletteItem does: net labels by label,
+	// grounds all together, and power symbols by voltage
+	const QString & moduleID = instance.moduleIdRef;
+	if (moduleID.endsWith(ModuleIDNames::NetLabelModuleIDName) ||
+	    moduleID.endsWith(ModuleIDNames::LeftNetLabelModuleIDName) ||
+	    moduleID.endsWith(ModuleIDNames::PowerLabelModuleIDName))
+	{
+		return "label:" + instance.properties.value("label");
+	}
+
+	if (moduleID.endsWith(ModuleIDNames::GroundModuleIDName)) {
+		return "ground";
+	}
+
+	if (moduleID.endsWith(ModuleIDNames::JustPowerModuleIDName) ||
+	    (moduleID.endsWith(ModuleIDNames::PowerModuleIDName) && !moduleID.endsWith(ModuleIDNames::TwoPowerModuleIDName)))
+	{
+		bool ok;
+		double voltage = instance.properties.value("voltage").toDouble(&ok);
+		if (!ok) voltage = DefaultVoltage;
+		return "voltage:" + QString::number(voltage);
+	}
+
+	return QString();
+}
+
+QList< QList<HeadlessSketch::PartConnector> > HeadlessSketch::nets(const QString & viewName)
+{
+	// union-find over (instance, connector) nodes, numbered in the order they are met
+	QList<PartConnector> nodes;
+	QHash<QPair<long, QString>, int> nodeIndexes;
+	QVector<int> parents;
+
+	auto node = [&](long modelIndex, const QString & connectorID) {
+		QPair<long, QString> key(modelIndex, connectorID);
+		auto it = nodeIndexes.constFind(key);
+		if (it != nodeIndexes.constEnd()) return it.value();
+
+		int index = nodes.count();
+		PartConnector partConnector;
+		partConnector.modelIndex = modelIndex;
+		partConnector.connectorID = connectorID;
+		nodes.append(partConnector);
+		nodeIndexes.insert(key, index);
+		parents.append(index);
+		return index;
+	};
+
+	auto find = [&](int index) {
+		while (parents[index] != index) {
+			parents[index] = parents[parents[index]];
+			index = parents[index];
+		}
+		return index;
+	};
+
+	auto unite = [&](int a, int b) {
+		a = find(a);
+		b = find(b);
+		if (a == b) return;
+
+		if (a < b) parents[b] = a;
+		else parents[a] = b;
+	};
+
+	QHash<long, QList<int> > instanceNodes;
+	Q_FOREACH (const Instance & instance, m_instances) {
+		if (!instance.views.contains(viewName)) continue;
+
+		if (isWire(instance)) {
+			unite(node(instance.modelIndex, "connector0"), node(instance.modelIndex, "connector1"));
+			continue;
+		}
+
+		// every connector of a known part, so that unconnected ones come out as single nets
+		const PartInfo & part = partInfo(instance.moduleIdRef);
+		QList<int> & indexes = instanceNodes[instance.modelIndex];
+		Q_FOREACH (const QString & connectorID, part.connectorIDs) {
+			indexes.append(node(instance.modelIndex, connectorID));
+		}
+		Q_FOREACH (const QStringList & bus, part.buses) {
+			int first = node(instance.modelIndex, bus.first());
+			for (int i = 1; i < bus.count(); i++) {
+				unite(first, node(instance.modelIndex, bus.at(i)));
+			}
+		}
+	}
+
+	Q_FOREACH (const Connect & connect, m_connects.value(viewName)) {
+		const Instance * from = instance(connect.from.modelIndex);
+		const Instance * to = instance(connect.to.modelIndex);
+		if (from == nullptr || to == nullptr || !to->views.contains(viewName)) continue;
+
+		int a = node(connect.from.modelIndex, connect.from.connectorID);
+		int b = node(connect.to.modelIndex, connect.to.connectorID);
+		unite(a, b);
+		if (!isWire(*from)) instanceNodes[from->modelIndex].append(a);
+		if (!isWire(*to)) instanceNodes[to->modelIndex].append(b);
+	}
+
+	QHash<QString, int> symbolNodes;
+	Q_FOREACH (const Instance & instance, m_instances) {
+		if (!instance.views.contains(viewName)) continue;
+
+		QString net = symbolNet(instance);
+		if (net.isEmpty()) continue;
+
+		Q_FOREACH (int index, instanceNodes.value(instance.modelIndex)) {
+			auto it = symbolNodes.constFind(net);
+			if (it == symbolNodes.constEnd()) symbolNodes.insert(net, index);
+			else unite(it.value(), index);
+		}
+	}
+
+	QList< QList<PartConnector> > nets;
+	QHash<int, int> netIndexes;						// by root node
+	for (int i = 0; i < nodes.count(); i++) {
+		const Instance * owner = instance(nodes.at(i).modelIndex);
+		if (owner == nullptr || isWire(*owner)) continue;
+
+		int root = find(i);
+		auto it = netIndexes.constFind(root);
+		if (it == netIndexes.constEnd()) {
+			it = netIndexes.insert(root, nets.count());
+			nets.append(QList<PartConnector>());
+		}
+		nets[it.value()].append(nodes.at(i));
+	}
+
+	return nets;
+}
+
+QString HeadlessSketch::netlist(const QString & sketchName, const QString & viewName)
+{
+	// the same xml as File > Export > XML Netlist, less the erc data that would need the parts loaded
+	QString text("<?xml version='1.0' encoding='UTF-8'?>\n");
+	QXmlStreamWriter streamWriter(&text);
+	streamWriter.setAutoFormatting(true);
+	streamWriter.setAutoFormattingIndent(1);
+	streamWriter.writeComment(" " + TextUtils::CreatedWithFritzingString + " ");
+	streamWriter.writeStartElement("netlist");
+	streamWriter.writeAttribute("sketch", sketchName);
+	streamWriter.writeAttribute("date", QDateTime::currentDateTime().toString());
+
+	Q_FOREACH (const QList<PartConnector> & net, nets(viewName)) {
+		streamWriter.writeStartElement("net");
+		Q_FOREACH (const PartConnector & partConnector, net) {
+			const Instance * owner = instance(partConnector.modelIndex);
+			const PartInfo & part = partInfo(owner->moduleIdRef);
+			streamWriter.writeStartElement("connector");
+			streamWriter.writeAttribute("id", partConnector.connectorID);
+			streamWriter.writeAttribute("name", part.connectorNames.value(partConnector.connectorID, partConnector.connectorID));
+			streamWriter.writeStartElement("part");
+			streamWriter.writeAttribute("id", QString::number(partConnector.modelIndex * IndexMultiplier));
+			streamWriter.writeAttribute("label", owner->title);
+			streamWriter.writeAttribute("title", part.title.isEmpty() ? owner->moduleIdRef : part.title);
+			streamWriter.writeEndElement();
+			streamWriter.writeEndElement();
+		}
+		streamWriter.writeEndElement();
+	}
+
+	streamWriter.writeEndElement();
+	streamWriter.writeEndDocument();
+	return text;
+}
+
+QString HeadlessSketch::connectorName(long modelIndex, const QString & connectorID)
+{
+	const Instance * owner = instance(modelIndex);
+	if (owner == nullptr) return connectorID;
+
+	return partInfo(owner->moduleIdRef).connectorNames.value(connectorID, connectorID);
+}
@@ -0,0 +1,99 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef HEADLESSSKETCH_H
+#define HEADLESSSKETCH_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+
+class QDomDocument;
+
+class HeadlessSketch
+{
+	// a sketch read straight from its .fz, with no reference model, items or views: the instances
+	// and their connections, plus what the parts database or the bundled fzps say about each part's
+	// connectors and buses; enough to trace nets and export a netlist from a service worker
+
+public:
+	struct Instance {
+		long modelIndex = 0;
+		QString moduleIdRef;
+		QString title;
+		QHash<QString, QString> properties;			// local properties saved with the instance
+		QStringList views;							// element names, such as "schematicView"
+		QHash<QString, QPointF> locations;			// by view name, from each view's geometry
+	};
+
+	struct PartConnector {
+		long modelIndex = 0;
+		QString connectorID;
+	};
+
+public:
+	HeadlessSketch() = default;
+	~HeadlessSketch();
+
+	bool setPartsDatabase(const QString & path);
+	bool load(const QByteArray & fz, QString * errorString = nullptr);
+	bool loadBundle(const QList<QPair<QString, QByteArray> > & entries, QString * errorString = nullptr);
+	bool loadDocument(const QDomDocument &, QString * errorString = nullptr);
+	bool addPart(const QByteArray & fzp);
+	const QList<Instance> & instances() const;
+	QList< QList<PartConnector> > nets(const QString & viewName);
+	QString netlist(const QString & sketchName, const QString & viewName);
+	QString connectorName(long modelIndex, const QString & connectorID);
+
+public:
+	static bool isWire(const Instance &);
+
+protected:
+	struct PartInfo {
+		QString title;
+		QStringList connectorIDs;
+		QHash<QString, QString> connectorNames;
+		QList<QStringList> buses;
+	};
+
+	struct Connect {
+		PartConnector from;
+		PartConnector to;
+	};
+
+	const PartInfo & partInfo(const QString & moduleID);
+	const Instance * instance(long modelIndex) const;
+	void closeDatabase();
+
+	static QString symbolNet(const Instance &);
+
+protected:
+	QList<Instance> m_instances;
+	QHash<long, int> m_instanceIndexes;
+	QHash<QString, QList<Connect> > m_connects;		// by view name
+	QHash<QString, PartInfo> m_parts;				// by module id
+	QString m_databaseConnection;
+};
+
+#endif
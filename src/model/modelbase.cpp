@@ -19,6 +19,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 ********************************************************************/
 
 #include "modelbase.h"
+#include "binarysketch.h"
 #include "../debugdialog.h"
 #include "../items/partfactory.h"
 #include "../items/moduleidnames.h"
@@ -29,6 +30,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../viewgeometry.h"
 
 #include <QMessageBox>
+#include <QXmlStreamReader>
 
 QList<QString> ModelBase::CoreList;
 
@@ -65,6 +67,107 @@ ModelPart * ModelBase::retrieveModelPart(const QString & /* moduleID */)  {
 	return nullptr;
 }
 
+/////////////////////////////////////////////////
+
+namespace {
+
+QDomElement createDomElement(QXmlStreamReader & reader, QDomDocument & domDocument)
+{
+	QDomElement element = reader.namespaceUri().isEmpty()
+	                      ? domDocument.createElement(reader.name().toString())
+	                      : domDocument.createElementNS(reader.namespaceUri().toString(), reader.qualifiedName().toString());
+	for (const QXmlStreamAttribute & attribute : reader.attributes()) {
+		if (attribute.namespaceUri().isEmpty()) {
+			element.setAttribute(attribute.name().toString(), attribute.value().toString());
+		}
+		else {
+			element.setAttributeNS(attribute.namespaceUri().toString(), attribute.qualifiedName().toString(), attribute.value().toString());
+		}
+	}
+	return element;
+}
+
+QDomElement readDomElement(QXmlStreamReader & reader, QDomDocument & domDocument, QDomNode parent)
+{
+	// the reader is on a start element: builds the element and its content under parent, the way
+	// QDomDocument::setContent would, and leaves the reader on the matching end element
+	QDomElement element = createDomElement(reader, domDocument);
+	parent.appendChild(element);
+	QDomNode current = element;
+	int depth = 1;
+	while (depth > 0 && !reader.atEnd()) {
+		switch (reader.readNext()) {
+		case QXmlStreamReader::StartElement: {
+			QDomElement child = createDomElement(reader, domDocument);
+			current.appendChild(child);
+			current = child;
+			depth++;
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			current = current.parentNode();
+			depth--;
+			break;
+		case QXmlStreamReader::Characters:
+			if (reader.isCDATA()) {
+				current.appendChild(domDocument.createCDATASection(reader.text().toString()));
+			}
+			else if (!reader.isWhitespace()) {
+				current.appendChild(domDocument.createTextNode(reader.text().toString()));
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	return element;
+}
+
+}
+
+/////////////////////////////////////////////////
+
+void ModelBase::versionChecks(const QString & fritzingVersion, VersionChecks & checks) {
+	checks = VersionChecks();
+	if (fritzingVersion.isEmpty()) return;
+
+	// with version 0.4.3 ratsnests in fz files are obsolete
+	VersionThing versionThingRats;
+	versionThingRats.majorVersion = 0;
+	versionThingRats.minorVersion = 4;
+	versionThingRats.minorSubVersion = 2;
+	versionThingRats.releaseModifier = "";
+	VersionThing versionThingFz;
+	Version::toVersionThing(fritzingVersion,versionThingFz);
+	checks.rats = !Version::greaterThan(versionThingRats, versionThingFz);
+	// with version 0.6.5 traces are copied to all views
+	versionThingRats.minorVersion = 6;
+	versionThingRats.minorSubVersion = 4;
+	checks.traces = !Version::greaterThan(versionThingRats, versionThingFz);
+	// with version 0.7.6 mystery part spacing implementation changes
+	versionThingRats.minorVersion = 7;
+	versionThingRats.minorSubVersion = 5;
+	checks.mysteryParts = !Version::greaterThan(versionThingRats, versionThingFz);
+	// with version 0.8.0 flipSMD is horizontal
+	versionThingRats.minorVersion = 7;
+	versionThingRats.minorSubVersion = 13;
+	checks.obsoleteSMDOrientation = !Version::greaterThan(versionThingRats, versionThingFz);
+	// with version 0.8.6 we get a new schematic template
+	versionThingRats.minorVersion = 8;
+	versionThingRats.minorSubVersion = 5;
+	checks.oldSchematics = !Version::greaterThan(versionThingRats, versionThingFz);
+	// with version 0.9.3 we don't have to worry about reversed wires
+	versionThingRats.minorVersion = 9;
+	versionThingRats.minorSubVersion = 2;
+	checks.reversedWires = !Version::greaterThan(versionThingRats, versionThingFz);
+
+	checks.partLabelOffset = Version::greaterThan(fritzingVersion, "1.0.0a");
+}
+
+bool ModelBase::VersionChecks::fixups() const {
+	return rats || traces || mysteryParts || obsoleteSMDOrientation || oldSchematics;
+}
+
 // loads a model from an fz file--assumes a reference model exists with all parts
 bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceModel, QList<ModelPart *> & modelParts, bool checkViews) {
 	m_referenceModel = referenceModel;
@@ -83,7 +186,23 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 	int errorColumn;
 	QDomDocument domDocument;
 
-	if (!domDocument.setContent(&file, true, &errorStr, &errorLine, &errorColumn)) {
+	if (BinarySketch::isBinary(file)) {
+		// the binary encoding goes straight to a dom, without an xml parse
+		file.close();
+		if (!file.open(QFile::ReadOnly) || !BinarySketch::toDocument(file.readAll(), domDocument, &errorStr)) {
+			FMessageBox::information(nullptr, QObject::tr("Fritzing"),
+			                         QObject::tr("Parse error (1):\n%1\n%2")
+			                         .arg(errorStr)
+			                         .arg(fileName));
+			return false;
+		}
+	}
+	// sketches that need none of the legacy fix-ups are streamed; parts bins stay on the dom path
+	// because their progress reporting counts the instances up front
+	else if (checkViews && streamable(file)) {
+		return loadFromStream(fileName, file, modelParts);
+	}
+	else if (!domDocument.setContent(&file, true, &errorStr, &errorLine, &errorColumn)) {
 		FMessageBox::information(nullptr, QObject::tr("Fritzing"),
 		                         QObject::tr("Parse error (1) at line %1, column %2:\n%3\n%4")
 		                         .arg(errorLine)
@@ -93,6 +212,13 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 		return false;
 	}
 
+	return loadFromDocument(fileName, domDocument, referenceModel, modelParts, checkViews);
+}
+
+bool ModelBase::loadFromDocument(const QString & fileName, QDomDocument & domDocument, ModelBase * referenceModel, QList<ModelPart *> & modelParts, bool checkViews) {
+	// everything loadFromFile does once the file is parsed, for a document parsed elsewhere
+	m_referenceModel = referenceModel;
+
 	QDomElement root = domDocument.documentElement();
 	if (root.isNull()) {
 		FMessageBox::information(nullptr, QObject::tr("Fritzing"), QObject::tr("The file %1 is not a Fritzing file (2).").arg(fileName));
@@ -107,83 +233,8 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 	}
 
 	// QUESTION: Do these version checks make any sense for part bins?
-	bool checkForOldSchematics = true;
-	bool checkForRats = true;
-	bool checkForTraces = true;
-	bool checkForMysteryParts = true;
-	bool checkForObsoleteSMDOrientation = true;
-	bool correctPartLabelOffset = false;
-	m_fritzingVersion = root.attribute("fritzingVersion");
-	if (checkViews) {
-		DebugDialog::debug(QString("Project %1 was created with Fritzing %2").arg(fileName, m_fritzingVersion), DebugDialog::Info);
-	} else {
-		DebugDialog::debug(QString("Parts Bin %1 was created with Fritzing %2").arg(fileName, m_fritzingVersion), DebugDialog::Info);
-	}
-	if (m_fritzingVersion.length() > 0) {
-		// with version 0.4.3 ratsnests in fz files are obsolete
-		VersionThing versionThingRats;
-		versionThingRats.majorVersion = 0;
-		versionThingRats.minorVersion = 4;
-		versionThingRats.minorSubVersion = 2;
-		versionThingRats.releaseModifier = "";
-		VersionThing versionThingFz;
-		Version::toVersionThing(m_fritzingVersion,versionThingFz);
-		checkForRats = !Version::greaterThan(versionThingRats, versionThingFz);
-		// with version 0.6.5 traces are copied to all views
-		versionThingRats.minorVersion = 6;
-		versionThingRats.minorSubVersion = 4;
-		checkForTraces = !Version::greaterThan(versionThingRats, versionThingFz);
-		// with version 0.7.6 mystery part spacing implementation changes
-		versionThingRats.minorVersion = 7;
-		versionThingRats.minorSubVersion = 5;
-		checkForMysteryParts = !Version::greaterThan(versionThingRats, versionThingFz);
-		// with version 0.8.0 flipSMD is horizontal
-		versionThingRats.minorVersion = 7;
-		versionThingRats.minorSubVersion = 13;
-		checkForObsoleteSMDOrientation = !Version::greaterThan(versionThingRats, versionThingFz);
-		// with version 0.8.6 we get a new schematic template
-		versionThingRats.minorVersion = 8;
-		versionThingRats.minorSubVersion = 5;
-		checkForOldSchematics = !Version::greaterThan(versionThingRats, versionThingFz);
-		// with version 0.9.3 we don't have to worry about reversed wires
-		versionThingRats.minorVersion = 9;
-		versionThingRats.minorSubVersion = 2;
-		m_checkForReversedWires = !Version::greaterThan(versionThingRats, versionThingFz);
-
-		correctPartLabelOffset = Version::greaterThan(m_fritzingVersion, "1.0.0a");
-		if (correctPartLabelOffset) {
-			Q_EMIT migratePartLabelOffset(m_fritzingVersion);
-		}
-	}
-	ModelPartSharedRoot * modelPartSharedRoot = this->rootModelPartShared();
-
-	QDomElement title = root.firstChildElement("title");
-	if (!title.isNull()) {
-		if (modelPartSharedRoot != nullptr) {
-			modelPartSharedRoot->setTitle(title.text());
-		}
-	}
-
-	// ensures changeBinIcon() is not available
-	// this may be a bug?
-	QString iconFilename = root.attribute("icon");
-	if (iconFilename.isEmpty()) {
-		iconFilename = title.text() + ".png";
-	}
-
-	if (!iconFilename.isEmpty()) {
-		if (modelPartSharedRoot != nullptr) {
-			modelPartSharedRoot->setIcon(iconFilename);
-		}
-	}
-
-	QString searchTerm = root.attribute("search");
-	if (!searchTerm.isEmpty() && (modelPartSharedRoot != nullptr)) {
-		modelPartSharedRoot->setSearchTerm(searchTerm);
-	}
-
-	QDomElement views = root.firstChildElement("views");
-	Q_EMIT loadedViews(this, views);
+	VersionChecks checks;
+	loadRoot(fileName, root, checkViews, checks);
 
 	QDomElement instances = root.firstChildElement("instances");
 	if (instances.isNull()) {
@@ -191,16 +242,11 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 		return false;
 	}
 
-	// delete any aready-existing model parts
-	for (int i = m_root->children().count() - 1; i >= 0; i--) {
-		QObject* child = m_root->children()[i];
-		child->setParent(nullptr);
-		delete child;
-	}
+	deleteModelParts();
 
 	Q_EMIT loadingInstances(this, instances);
 
-	if (checkForRats) {
+	if (checks.rats) {
 		QDomElement instance = instances.firstChildElement("instance");
 		while (!instance.isNull()) {
 			QDomElement nextInstance = instance.nextSiblingElement("instance");
@@ -212,7 +258,7 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 		}
 	}
 
-	if (checkForTraces) {
+	if (checks.traces) {
 		QDomElement instance = instances.firstChildElement("instance");
 		while (!instance.isNull()) {
 			checkTraces(instance);
@@ -220,7 +266,7 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 		}
 	}
 
-	if (checkForMysteryParts) {
+	if (checks.mysteryParts) {
 		QDomElement instance = instances.firstChildElement("instance");
 		while (!instance.isNull()) {
 			checkMystery(instance);
@@ -228,7 +274,7 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 		}
 	}
 
-	if (checkForObsoleteSMDOrientation) {
+	if (checks.obsoleteSMDOrientation) {
 		QDomElement instance = instances.firstChildElement("instance");
 		while (!instance.isNull()) {
 			if (checkObsoleteOrientation(instance)) {
@@ -240,7 +286,7 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 	}
 
 	m_useOldSchematics = false;
-	if (checkForOldSchematics) {
+	if (checks.oldSchematics) {
 		QDomElement instance = instances.firstChildElement("instance");
 		while (!instance.isNull()) {
 			if (checkOldSchematics(instance)) {
@@ -256,6 +302,171 @@ bool ModelBase::loadFromFile(const QString & fileName, ModelBase * referenceMode
 	return result;
 }
 
+QDomDocument ModelBase::parseFile(const QString & fileName) {
+	// the parse loadFromFile does, without its message boxes, so it can run off the GUI thread;
+	// a null document means loadFromFile should be used instead, to report the failure
+	QDomDocument domDocument;
+	QFile file(fileName);
+	if (!file.open(QFile::ReadOnly | QFile::Text)) return QDomDocument();
+
+	if (BinarySketch::isBinary(file)) {
+		file.close();
+		if (!file.open(QFile::ReadOnly) || !BinarySketch::toDocument(file.readAll(), domDocument)) {
+			return QDomDocument();
+		}
+		return domDocument;
+	}
+
+	if (!domDocument.setContent(&file, true)) return QDomDocument();
+
+	return domDocument;
+}
+
+bool ModelBase::streamable(QFile & file) {
+	// peeks at the root element: only a module whose version needs no whole-document fix-ups can be streamed
+	QXmlStreamReader reader(&file);
+	bool result = false;
+	if (reader.readNextStartElement() && reader.name() == QLatin1String("module")) {
+		VersionChecks checks;
+		versionChecks(reader.attributes().value("fritzingVersion").toString(), checks);
+		result = !checks.fixups();
+	}
+	file.seek(0);
+	return result;
+}
+
+bool ModelBase::loadFromStream(const QString & fileName, QFile & file, QList<ModelPart *> & modelParts) {
+	// builds the module's header elements as a small dom, then reads one instance at a time and creates
+	// its model part before reading the next; the instance elements are still kept as dom, since the
+	// views take each part's geometry from its instance element
+	QXmlStreamReader reader(&file);
+	QDomDocument domDocument;
+	QDomElement root;
+	QDomElement instances;
+	if (reader.readNextStartElement()) {
+		root = createDomElement(reader, domDocument);
+		domDocument.appendChild(root);
+		while (reader.readNextStartElement()) {
+			if (reader.name() == QLatin1String("instances")) {
+				instances = createDomElement(reader, domDocument);
+				root.appendChild(instances);
+				break;
+			}
+			readDomElement(reader, domDocument, root);
+		}
+	}
+
+	if (reader.hasError()) {
+		streamError(fileName, reader);
+		return false;
+	}
+
+	if (root.isNull()) {
+		FMessageBox::information(nullptr, QObject::tr("Fritzing"), QObject::tr("The file %1 is not a Fritzing file (2).").arg(fileName));
+		return false;
+	}
+
+	Q_EMIT loadedRoot(fileName, this, root);
+
+	VersionChecks checks;
+	loadRoot(fileName, root, true, checks);
+
+	if (instances.isNull()) {
+		FMessageBox::information(nullptr, QObject::tr("Fritzing"), QObject::tr("The file %1 is not a Fritzing file (3).").arg(fileName));
+		return false;
+	}
+
+	deleteModelParts();
+
+	Q_EMIT loadingInstances(this, instances);
+
+	m_useOldSchematics = false;
+	QHash<QString, QString> missingModules;
+	while (reader.readNextStartElement()) {
+		if (reader.name() != QLatin1String("instance")) {
+			reader.skipCurrentElement();
+			continue;
+		}
+
+		QDomElement instance = readDomElement(reader, domDocument, instances);
+		loadInstance(domDocument, instance, modelParts, true, missingModules);
+	}
+
+	if (reader.hasError()) {
+		// the dom path loads nothing from a broken file, so neither does this one
+		streamError(fileName, reader);
+		modelParts.clear();
+		deleteModelParts();
+		return false;
+	}
+
+	reportMissingModules(missingModules);
+	return true;
+}
+
+void ModelBase::streamError(const QString & fileName, QXmlStreamReader & reader) {
+	FMessageBox::information(nullptr, QObject::tr("Fritzing"),
+	                         QObject::tr("Parse error (1) at line %1, column %2:\n%3\n%4")
+	                         .arg(reader.lineNumber())
+	                         .arg(reader.columnNumber())
+	                         .arg(reader.errorString())
+	                         .arg(fileName));
+}
+
+void ModelBase::loadRoot(const QString & fileName, QDomElement & root, bool checkViews, VersionChecks & checks) {
+	// version checks and the module's header: title, icon, search term and views
+	m_fritzingVersion = root.attribute("fritzingVersion");
+	if (checkViews) {
+		DebugDialog::debug(QString("Project %1 was created with Fritzing %2").arg(fileName, m_fritzingVersion), DebugDialog::Info);
+	} else {
+		DebugDialog::debug(QString("Parts Bin %1 was created with Fritzing %2").arg(fileName, m_fritzingVersion), DebugDialog::Info);
+	}
+	versionChecks(m_fritzingVersion, checks);
+	m_checkForReversedWires = checks.reversedWires;
+	if (checks.partLabelOffset) {
+		Q_EMIT migratePartLabelOffset(m_fritzingVersion);
+	}
+
+	ModelPartSharedRoot * modelPartSharedRoot = this->rootModelPartShared();
+
+	QDomElement title = root.firstChildElement("title");
+	if (!title.isNull()) {
+		if (modelPartSharedRoot != nullptr) {
+			modelPartSharedRoot->setTitle(title.text());
+		}
+	}
+
+	// ensures changeBinIcon() is not available
+	// this may be a bug?
+	QString iconFilename = root.attribute("icon");
+	if (iconFilename.isEmpty()) {
+		iconFilename = title.text() + ".png";
+	}
+
+	if (!iconFilename.isEmpty()) {
+		if (modelPartSharedRoot != nullptr) {
+			modelPartSharedRoot->setIcon(iconFilename);
+		}
+	}
+
+	QString searchTerm = root.attribute("search");
+	if (!searchTerm.isEmpty() && (modelPartSharedRoot != nullptr)) {
+		modelPartSharedRoot->setSearchTerm(searchTerm);
+	}
+
+	QDomElement views = root.firstChildElement("views");
+	Q_EMIT loadedViews(this, views);
+}
+
+void ModelBase::deleteModelParts() {
+	// delete any aready-existing model parts
+	for (int i = m_root->children().count() - 1; i >= 0; i--) {
+		QObject* child = m_root->children()[i];
+		child->setParent(nullptr);
+		delete child;
+	}
+}
+
 ModelPart * ModelBase::fixObsoleteModuleID(QDomDocument & domDocument, QDomElement & instance, QString & moduleIDRef) {
 	return PartFactory::fixObsoleteModuleID(domDocument, instance, moduleIDRef, m_referenceModel);
 }
@@ -264,123 +475,130 @@ bool ModelBase::loadInstances(QDomDocument & domDocument, QDomElement & instance
 {
 	QHash<QString, QString> missingModules;
 	QDomElement instance = instances.firstChildElement("instance");
-	ModelPart* modelPart = nullptr;
 	while (!instance.isNull()) {
-		Q_EMIT loadingInstance(this, instance);
+		loadInstance(domDocument, instance, modelParts, checkViews, missingModules);
+		instance = instance.nextSiblingElement("instance");
+	}
 
-		if (checkViews) {
-			QDomElement views = instance.firstChildElement("views");
-			QDomElement view = views.firstChildElement();
-			if (views.isNull() || view.isNull()) {
-				// do not load a part with no views
-				//QString text;
-				//QTextStream stream(&text);
-				//instance.save(stream, 0);
-				//DebugDialog::debug(text);
-				instance = instance.nextSiblingElement("instance");
-				continue;
-			}
-		}
+	reportMissingModules(missingModules);
 
-		// for now assume all parts are in the palette
-		QString moduleIDRef = instance.attribute("moduleIdRef");
-
-		//DebugDialog::debug("loading " + moduleIDRef);
-		if (moduleIDRef.compare(ModuleIDNames::SpacerModuleIDName) == 0) {
-			auto * mp = new ModelPart(ModelPart::Space);
-			mp->setInstanceText(instance.attribute("path"));
-			mp->setParent(m_root);
-			mp->modelPartShared()->setModuleID(ModuleIDNames::SpacerModuleIDName);
-			mp->modelPartShared()->setPath(instance.attribute("path"));
-			modelParts.append(mp);
-			instance = instance.nextSiblingElement("instance");
-			continue;
-		}
+	return true;
+}
 
-		modelPart = m_referenceModel->retrieveModelPart(moduleIDRef);
-		if (modelPart == nullptr) {
-			DebugDialog::debug(QString("module id %1 not found in database").arg(moduleIDRef));
-			modelPart = fixObsoleteModuleID(domDocument, instance, moduleIDRef);
-		}
-		if (modelPart == nullptr) {
-			modelPart = genFZP(moduleIDRef, m_referenceModel);
-			if (modelPart != nullptr) {
-				instance.setAttribute("moduleIdRef", modelPart->moduleID());
-				moduleIDRef = modelPart->moduleID();
-			}
-		}
-		if (modelPart == nullptr) {
-			missingModules.insert(moduleIDRef, instance.attribute("path"));
-			instance = instance.nextSiblingElement("instance");
-			continue;
-		}
+void ModelBase::loadInstance(QDomDocument & domDocument, QDomElement & instance, QList<ModelPart *> & modelParts, bool checkViews, QHash<QString, QString> & missingModules)
+{
+	Q_EMIT loadingInstance(this, instance);
 
-		if (modelPart->isCore() && m_useOldSchematics) {
-			modelPart = createOldSchematicPart(modelPart, moduleIDRef);
+	if (checkViews) {
+		QDomElement views = instance.firstChildElement("views");
+		QDomElement view = views.firstChildElement();
+		if (views.isNull() || view.isNull()) {
+			// do not load a part with no views
+			//QString text;
+			//QTextStream stream(&text);
+			//instance.save(stream, 0);
+			//DebugDialog::debug(text);
+			return;
 		}
+	}
 
-		modelPart->setInBin(true);
-		modelPart = addModelPart(m_root, modelPart);
-		modelPart->setInstanceDomElement(instance);
-		modelParts.append(modelPart);
+	// for now assume all parts are in the palette
+	QString moduleIDRef = instance.attribute("moduleIdRef");
 
-		// TODO Mariano: i think this is not the way
-		QString instanceTitle = instance.firstChildElement("title").text();
-		if(!instanceTitle.isNull() && !instanceTitle.isEmpty()) {
-			modelPart->setInstanceTitle(instanceTitle, false);
-		}
+	//DebugDialog::debug("loading " + moduleIDRef);
+	if (moduleIDRef.compare(ModuleIDNames::SpacerModuleIDName) == 0) {
+		auto * mp = new ModelPart(ModelPart::Space);
+		mp->setInstanceText(instance.attribute("path"));
+		mp->setParent(m_root);
+		mp->modelPartShared()->setModuleID(ModuleIDNames::SpacerModuleIDName);
+		mp->modelPartShared()->setPath(instance.attribute("path"));
+		modelParts.append(mp);
+		return;
+	}
 
-		QDomElement localConnectors = instance.firstChildElement("localConnectors");
-		QDomElement localConnector = localConnectors.firstChildElement("localConnector");
-		while (!localConnector.isNull()) {
-			modelPart->setConnectorLocalName(localConnector.attribute("id"), localConnector.attribute("name"));
-			localConnector = localConnector.nextSiblingElement("localConnector");
+	ModelPart * modelPart = m_referenceModel->retrieveModelPart(moduleIDRef);
+	if (modelPart == nullptr) {
+		DebugDialog::debug(QString("module id %1 not found in database").arg(moduleIDRef));
+		modelPart = fixObsoleteModuleID(domDocument, instance, moduleIDRef);
+	}
+	if (modelPart == nullptr) {
+		modelPart = genFZP(moduleIDRef, m_referenceModel);
+		if (modelPart != nullptr) {
+			instance.setAttribute("moduleIdRef", modelPart->moduleID());
+			moduleIDRef = modelPart->moduleID();
 		}
+	}
+	if (modelPart == nullptr) {
+		missingModules.insert(moduleIDRef, instance.attribute("path"));
+		return;
+	}
 
-		QString instanceText = instance.firstChildElement("text").text();
-		if(!instanceText.isNull() && !instanceText.isEmpty()) {
-			modelPart->setInstanceText(instanceText);
-		}
+	if (modelPart->isCore() && m_useOldSchematics) {
+		modelPart = createOldSchematicPart(modelPart, moduleIDRef);
+	}
 
-		bool ok;
-		long index = instance.attribute("modelIndex").toLong(&ok);
-		if (ok) {
-			// set the index so we can find the same model part later, as we continue loading
-			modelPart->setModelIndex(index);
-		}
+	modelPart->setInBin(true);
+	modelPart = addModelPart(m_root, modelPart);
+	modelPart->setInstanceDomElement(instance);
+	modelParts.append(modelPart);
 
-		// note: this QDomNamedNodeMap loop is obsolete, but leaving it here so that old sketches don't get broken (jc, 22 Oct 2009)
-		QDomNamedNodeMap map = instance.attributes();
-		for (int m = 0; m < map.count(); m++) {
-			QDomNode node = map.item(m);
-			QString nodeName = node.nodeName();
+	// TODO Mariano: i think this is not the way
+	QString instanceTitle = instance.firstChildElement("title").text();
+	if(!instanceTitle.isNull() && !instanceTitle.isEmpty()) {
+		modelPart->setInstanceTitle(instanceTitle, false);
+	}
 
-			if (nodeName.isEmpty()) continue;
-			if (nodeName.compare("moduleIdRef") == 0) continue;
-			if (nodeName.compare("modelIndex") == 0) continue;
-			if (nodeName.compare("originalModelIndex") == 0) continue;
-			if (nodeName.compare("path") == 0) continue;
+	QDomElement localConnectors = instance.firstChildElement("localConnectors");
+	QDomElement localConnector = localConnectors.firstChildElement("localConnector");
+	while (!localConnector.isNull()) {
+		modelPart->setConnectorLocalName(localConnector.attribute("id"), localConnector.attribute("name"));
+		localConnector = localConnector.nextSiblingElement("localConnector");
+	}
 
-			modelPart->setLocalProp(nodeName, node.nodeValue());
-		}
+	QString instanceText = instance.firstChildElement("text").text();
+	if(!instanceText.isNull() && !instanceText.isEmpty()) {
+		modelPart->setInstanceText(instanceText);
+	}
 
-		// "property" loop replaces previous QDomNamedNodeMap loop (jc, 22 Oct 2009)
-		QDomElement prop = instance.firstChildElement("property");
-		while(!prop.isNull()) {
-			QString name = prop.attribute("name");
-			if (!name.isEmpty()) {
-				QString value = prop.attribute("value");
-				if (!value.isEmpty()) {
-					modelPart->setLocalProp(name, value);
-				}
-			}
+	bool ok;
+	long index = instance.attribute("modelIndex").toLong(&ok);
+	if (ok) {
+		// set the index so we can find the same model part later, as we continue loading
+		modelPart->setModelIndex(index);
+	}
+
+	// note: this QDomNamedNodeMap loop is obsolete, but leaving it here so that old sketches don't get broken (jc, 22 Oct 2009)
+	QDomNamedNodeMap map = instance.attributes();
+	for (int m = 0; m < map.count(); m++) {
+		QDomNode node = map.item(m);
+		QString nodeName = node.nodeName();
+
+		if (nodeName.isEmpty()) continue;
+		if (nodeName.compare("moduleIdRef") == 0) continue;
+		if (nodeName.compare("modelIndex") == 0) continue;
+		if (nodeName.compare("originalModelIndex") == 0) continue;
+		if (nodeName.compare("path") == 0) continue;
+
+		modelPart->setLocalProp(nodeName, node.nodeValue());
+	}
 
-			prop = prop.nextSiblingElement("property");
+	// "property" loop replaces previous QDomNamedNodeMap loop (jc, 22 Oct 2009)
+	QDomElement prop = instance.firstChildElement("property");
+	while(!prop.isNull()) {
+		QString name = prop.attribute("name");
+		if (!name.isEmpty()) {
+			QString value = prop.attribute("value");
+			if (!value.isEmpty()) {
+				modelPart->setLocalProp(name, value);
+			}
 		}
 
-		instance = instance.nextSiblingElement("instance");
+		prop = prop.nextSiblingElement("property");
 	}
+}
 
+void ModelBase::reportMissingModules(const QHash<QString, QString> & missingModules)
+{
 	if (m_reportMissingModules && missingModules.count() > 0) {
 		QString unableToFind = QString("<html><body><b>%1</b><br/><table style='border-spacing: 0px 12px;'>")
 		                       .arg(tr("Unable to find the following %n part(s):", "", missingModules.count()));
@@ -391,9 +609,6 @@ bool ModelBase::loadInstances(QDomDocument & domDocument, QDomElement & instance
 		unableToFind += "</table></body></html>";
 		FMessageBox::warning(nullptr, QObject::tr("Fritzing"), unableToFind);
 	}
-
-
-	return true;
 }
 
 ModelPart * ModelBase::addModelPart(ModelPart * parent, ModelPart * copyChild) {
@@ -487,9 +702,18 @@ bool ModelBase::paste(ModelBase * referenceModel, QByteArray & data, QList<Model
 	QString errorStr;
 	int errorLine;
 	int errorColumn;
-	bool result = domDocument.setContent(data, &errorStr, &errorLine, &errorColumn);
+	bool result = BinarySketch::isBinary(data)
+	              ? BinarySketch::toDocument(data, domDocument, &errorStr)
+	              : domDocument.setContent(data, &errorStr, &errorLine, &errorColumn);
 	if (!result) return false;
 
+	return paste(referenceModel, domDocument, modelParts, boundingRects, preserveIndex);
+}
+
+bool ModelBase::paste(ModelBase * referenceModel, QDomDocument & domDocument, QList<ModelPart *> & modelParts, QHash<QString, QRectF> & boundingRects, bool preserveIndex)
+{
+	m_referenceModel = referenceModel;
+
 	QDomElement module = domDocument.documentElement();
 	if (module.isNull()) {
 		return false;
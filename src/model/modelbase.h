@@ -37,12 +37,14 @@ public:
 	virtual ModelPart* retrieveModelPart(const QString & moduleID);
 	virtual ModelPart * addModelPart(ModelPart * parent, ModelPart * copyChild);
 	bool loadFromFile(const QString & fileName, ModelBase* referenceModel, QList<ModelPart *> & modelParts, bool checkInstances);
+	bool loadFromDocument(const QString & fileName, QDomDocument &, ModelBase* referenceModel, QList<ModelPart *> & modelParts, bool checkInstances);
 	void save(const QString & fileName, bool asPart);
 	void save(const QString & fileName, class QXmlStreamWriter &, bool asPart);
 	virtual ModelPart * addPart(QString newPartPath, bool addToReference);
 	virtual bool addPart(ModelPart * modelPart, bool update);
 	virtual ModelPart * addPart(QString newPartPath, bool addToReference, bool updateIdAlreadyExists);
 	bool paste(ModelBase * referenceModel, QByteArray & data, QList<ModelPart *> & modelParts, QHash<QString, QRectF> & boundingRects, bool preserveIndex);
+	bool paste(ModelBase * referenceModel, QDomDocument &, QList<ModelPart *> & modelParts, QHash<QString, QRectF> & boundingRects, bool preserveIndex);
 	void setReportMissingModules(bool);
 	ModelPart * genFZP(const QString & moduleID, ModelBase * referenceModel);
 	const QString & fritzingVersion();
@@ -51,6 +53,7 @@ public:
 
 public:
 	static bool onCoreList(const QString & moduleID);
+	static QDomDocument parseFile(const QString & fileName);
 
 Q_SIGNALS:
 	void loadedViews(ModelBase *, QDomElement & views);
@@ -63,8 +66,28 @@ Q_SIGNALS:
 	void oldSchematicsSignal(const QString & filename, bool & useOldSchematics);
 
 protected:
+	struct VersionChecks {
+		bool rats = true;
+		bool traces = true;
+		bool mysteryParts = true;
+		bool obsoleteSMDOrientation = true;
+		bool oldSchematics = true;
+		bool reversedWires = false;
+		bool partLabelOffset = false;
+
+		bool fixups() const;            // any check that walks the whole instance list before loading
+	};
+
 	void renewModelIndexes(QDomElement & root, const QString & childName, QHash<long, long> & oldToNew);
 	bool loadInstances(QDomDocument &, QDomElement & root, QList<ModelPart *> & modelParts, bool checkViews);
+	void loadInstance(QDomDocument &, QDomElement & instance, QList<ModelPart *> & modelParts, bool checkViews, QHash<QString, QString> & missingModules);
+	void reportMissingModules(const QHash<QString, QString> & missingModules);
+	bool loadFromStream(const QString & fileName, class QFile &, QList<ModelPart *> & modelParts);
+	void loadRoot(const QString & fileName, QDomElement & root, bool checkViews, VersionChecks &);
+	void deleteModelParts();
+	static bool streamable(class QFile &);
+	static void streamError(const QString & fileName, class QXmlStreamReader &);
+	static void versionChecks(const QString & fritzingVersion, VersionChecks &);
 	ModelPart * fixObsoleteModuleID(QDomDocument & domDocument, QDomElement & instance, QString & moduleIDRef);
 	static bool isRatsnest(QDomElement & instance);
 	static void checkTraces(QDomElement & instance);
@@ -164,6 +164,30 @@ void ModelPart::setModelPartShared(ModelPartShared * modelPartShared) {
 	if (modelPartShared) m_modelPartShared->addOwner(this);
 }
 
+void ModelPart::swapModelPartShared(ModelPartShared * modelPartShared) {
+	// keeps the connectors, along with their connections and connector items,
+	// and points them at the matching connectors of the new shared part
+
+	if (m_modelPartShared != nullptr) {
+		if (disconnect(this, SIGNAL(destroyed()), m_modelPartShared, SLOT(removeOwner()))) {
+			// the slot is protected, so go through the meta object as the signal would have
+			QMetaObject::invokeMethod(m_modelPartShared, "removeOwner", Qt::DirectConnection);
+		}
+	}
+	setModelPartShared(modelPartShared);
+	modelPartShared->initConnectors();
+
+	Q_FOREACH (QString id, m_connectorHash.keys()) {
+		Connector * connector = m_connectorHash.value(id);
+		if (connector == nullptr) continue;
+
+		connector->setConnectorShared(modelPartShared->getConnectorShared(id));
+	}
+
+	clearBuses();
+	initBuses();
+}
+
 void ModelPart::addViewItem(ItemBase * item) {
 	m_viewItems.append(item);
 }
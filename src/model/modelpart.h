@@ -86,6 +86,7 @@ public:
 	ModelPartShared * modelPartShared();
 	ModelPartSharedRoot * modelPartSharedRoot();
 	void setModelPartShared(ModelPartShared *modelPartShared);
+	void swapModelPartShared(ModelPartShared *modelPartShared);
 	void saveInstances(const QString & fileName, QXmlStreamWriter & streamWriter, bool startDocument, bool flipAware);
 	void saveAsPart(QXmlStreamWriter & streamWriter, bool startDocument);
 	void addViewItem(class ItemBase *);
@@ -22,6 +22,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../connectors/connectorshared.h"
 #include "../debugdialog.h"
 #include "../connectors/busshared.h"
+#include "../utils/stringpool.h"
 
 
 #include <QHash>
@@ -210,7 +211,7 @@ void ModelPartShared::populateTags(QDomElement parent, QStringList &list) {
 	QDomElement tags = parent.firstChildElement("tags");
 	QDomElement tag = tags.firstChildElement("tag");
 	while (!tag.isNull()) {
-		list << tag.text();
+		list << StringPool::intern(tag.text());
 		tag = tag.nextSiblingElement("tag");
 	}
 }
@@ -221,7 +222,7 @@ void ModelPartShared::populateProperties(QDomElement parent, QHash<QString,QStri
 	while (!prop.isNull()) {
 		QString name = prop.attribute("name");
 		QString value = prop.text();
-		hash.insert(name.toLower().trimmed(),value);
+		hash.insert(StringPool::intern(name.toLower().trimmed()), StringPool::intern(value));
 		if (prop.attribute("showInLabel", "").compare("yes", Qt::CaseInsensitive) == 0) {
 			displayKeys.append(name);
 		}
@@ -329,7 +330,7 @@ void ModelPartShared::setTags(const QStringList &tags) {
 }
 
 void ModelPartShared::setTag(const QString &tag) {
-	m_tags.append(tag);
+	m_tags.append(StringPool::intern(tag));
 }
 
 QString ModelPartShared::family() {
@@ -400,6 +401,11 @@ void ModelPartShared::initConnectors() {
 	QDomDocument doc;
 	doc.setContent(&file, &errorStr, &errorLine, &errorColumn);
 
+	initConnectors(doc);
+}
+
+void ModelPartShared::initConnectors(const QDomDocument & doc) {
+	// builds the connectors and buses from an fzp already parsed
 	m_connectorsInitialized = true;
 	QDomElement root = doc.documentElement();
 	if (root.isNull()) {
@@ -477,7 +483,7 @@ void ModelPartShared::copy(ModelPartShared* other) {
 }
 
 void ModelPartShared::setProperty(const QString & key, const QString & value, bool showInLabel) {
-	m_properties.insert(key, value);
+	m_properties.insert(StringPool::intern(key), StringPool::intern(value));
 	if (showInLabel) {
 		m_displayKeys.append(key);
 	}
@@ -503,6 +509,23 @@ bool ModelPartShared::needsCopper1() {
 	return m_needsCopper1;
 }
 
+qint64 ModelPartShared::memoryCost() const {
+	// a rough estimate, for the memory report; pooled strings are counted for every part using them
+	qint64 chars = m_uri.size() + m_moduleID.size() + m_fritzingVersion.size() + m_version.size() + m_author.size() +
+	               m_title.size() + m_label.size() + m_description.size() + m_spice.size() + m_spiceModel.size() +
+	               m_url.size() + m_date.size() + m_replacedby.size() + m_path.size() + m_taxonomy.size();
+	Q_FOREACH (QString tag, m_tags) {
+		chars += tag.size();
+	}
+	for (auto it = m_properties.cbegin(); it != m_properties.cend(); ++it) {
+		chars += it.key().size() + it.value().size();
+	}
+	qint64 cost = sizeof(ModelPartShared) + (chars * (qint64) sizeof(QChar)) + (m_properties.count() * 32);
+	cost += m_connectorSharedHash.count() * (qint64) (sizeof(ConnectorShared) + 256);
+	cost += m_viewImages.count() * (qint64) sizeof(ViewImage);
+	return cost;
+}
+
 void ModelPartShared::connectorIDs(ViewLayer::ViewID viewID, ViewLayer::ViewLayerID viewLayerID, QStringList & connectorIDs, QStringList & terminalIDs, QStringList & legIDs) {
 	Q_FOREACH (ConnectorShared * connectorShared, m_connectorSharedHash.values()) {
 		SvgIdLayer * svgIdLayer = connectorShared->fullPinInfo(viewID, viewLayerID);
@@ -125,6 +125,7 @@ public:
 
 
 	void initConnectors();
+	void initConnectors(const QDomDocument &);
 	void setConnectorsInitialized(bool);
 	ConnectorShared * getConnectorShared(const QString & id);
 	bool ignoreTerminalPoints();
@@ -138,6 +139,7 @@ public:
 	void setFlippedSMD(bool);
 	bool flippedSMD();
 	bool needsCopper1();
+	qint64 memoryCost() const;
 	bool hasViewFor(ViewLayer::ViewID);
 	bool hasViewFor(ViewLayer::ViewID, ViewLayer::ViewLayerID);
 	QString hasBaseNameFor(ViewLayer::ViewID);
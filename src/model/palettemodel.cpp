@@ -24,6 +24,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QApplication>
 #include <QDir>
 #include <QDomElement>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 
 #include "modelpart.h"
 #include "../utils/folderutils.h"
@@ -161,14 +163,32 @@ void PaletteModel::countParts(QDir & dir, QStringList & nameFilters, int & partC
 }
 
 void PaletteModel::loadPartsAux(QDir & dir, QStringList & nameFilters, int & loadingPart, int totalPartCount) {
-	//QString temp = dir.absolutePath();
+	// the fzp files are read and parsed on the thread pool a batch at a time, which bounds the
+	// documents held at once; ModelParts are QObjects, so they are still made here, in file order
+	QVector<FzpFile> fzpFiles;
+	collectParts(dir, nameFilters, fzpFiles);
+
+	int batchSize = qMax(1, QThreadPool::globalInstance()->maxThreadCount() * 16);
+	for (int start = 0; start < fzpFiles.count(); start += batchSize) {
+		QVector<FzpFile> batch = fzpFiles.mid(start, batchSize);
+		QtConcurrent::blockingMap(batch, parseFzpFile);
+		for (FzpFile & fzpFile : batch) {
+			//DebugDialog::debug(QString("part path:%1 core? %2").arg(path).arg(m_loadingCore? "true" : "false"));
+			m_loadingContrib = fzpFile.contrib;
+			loadParsedPart(fzpFile, false);
+			Q_EMIT loadedPart(++loadingPart, totalPartCount);
+		}
+	}
+}
+
+void PaletteModel::collectParts(QDir & dir, QStringList & nameFilters, QVector<FzpFile> & fzpFiles) {
+	// walks the folders in the order loadPartsAux loads them, noting which parts are contrib
 	QFileInfoList list = dir.entryInfoList(nameFilters, QDir::Files | QDir::NoSymLinks);
 	for (auto fileInfo : list) {
-			QString path = fileInfo.absoluteFilePath ();
-		//DebugDialog::debug(QString("part path:%1 core? %2").arg(path).arg(m_loadingCore? "true" : "false"));
-		PaletteModel::loadPart(path, false);
-		Q_EMIT loadedPart(++loadingPart, totalPartCount);
-		//DebugDialog::debug("loadedok");
+		FzpFile fzpFile;
+		fzpFile.path = fileInfo.absoluteFilePath();
+		fzpFile.contrib = m_loadingContrib;
+		fzpFiles.append(fzpFile);
 	}
 
 	QStringList dirs = dir.entryList(QDir::AllDirs | QDir::NoSymLinks | QDir::NoDotAndDotDot);
@@ -178,19 +198,37 @@ void PaletteModel::loadPartsAux(QDir & dir, QStringList & nameFilters, int & loa
 
 		m_loadingContrib = (temp2 == "contrib");
 
-		loadPartsAux(dir, nameFilters, loadingPart, totalPartCount);
+		collectParts(dir, nameFilters, fzpFiles);
 		dir.cdUp();
 	}
 }
 
+void PaletteModel::parseFzpFile(FzpFile & fzpFile) {
+	// thread pool safe: touches nothing but the one file
+	QFile file(fzpFile.path);
+	if (!file.open(QFile::ReadOnly | QFile::Text)) {
+		fzpFile.fileError = file.errorString();
+		return;
+	}
+
+	fzpFile.readable = true;
+	fzpFile.parsed = fzpFile.domDocument.setContent(&file, true, &fzpFile.errorStr, &fzpFile.errorLine, &fzpFile.errorColumn);
+}
+
 ModelPart * PaletteModel::loadPart(const QString & path, bool update) {
+	FzpFile fzpFile;
+	fzpFile.path = path;
+	parseFzpFile(fzpFile);
+	return loadParsedPart(fzpFile, update);
+}
 
-	QFile file(path);
-	if (!file.open(QFile::ReadOnly | QFile::Text)) {
+ModelPart * PaletteModel::loadParsedPart(FzpFile & fzpFile, bool update) {
+	const QString & path = fzpFile.path;
+	if (!fzpFile.readable) {
 		FMessageBox::warning(nullptr, QObject::tr("Fritzing"),
 		                     QObject::tr("Cannot read file %1:\n%2.")
 		                     .arg(path)
-		                     .arg(file.errorString()));
+		                     .arg(fzpFile.fileError));
 		return nullptr;
 	}
 
@@ -201,16 +239,13 @@ ModelPart * PaletteModel::loadPart(const QString & path, bool update) {
 	QString title;
 	QString propertiesText;
 
-	QString errorStr;
-	int errorLine;
-	int errorColumn;
-	QDomDocument domDocument;
-	if (!domDocument.setContent(&file, true, &errorStr, &errorLine, &errorColumn)) {
+	QDomDocument & domDocument = fzpFile.domDocument;
+	if (!fzpFile.parsed) {
 		FMessageBox::information(nullptr, QObject::tr("Fritzing"),
 		                         QObject::tr("Parse error (2) at line %1, column %2:\n%3\n%4")
-		                         .arg(errorLine)
-		                         .arg(errorColumn)
-		                         .arg(errorStr)
+		                         .arg(fzpFile.errorLine)
+		                         .arg(fzpFile.errorColumn)
+		                         .arg(fzpFile.errorStr)
 		                         .arg(path));
 		return nullptr;
 	}
@@ -308,6 +343,11 @@ ModelPart * PaletteModel::loadPart(const QString & path, bool update) {
 	auto * modelPart = new ModelPart(domDocument, path, type);
 	if (!modelPart) return nullptr;
 
+	if (m_fullLoad) {
+		// every connector goes into the database, so build them from this parse rather than reading the fzp again
+		modelPart->modelPartShared()->initConnectors(domDocument);
+	}
+
 	if (path.startsWith(ResourcePath)) {
 		modelPart->setCore(true);
 	}
@@ -347,6 +387,7 @@ ModelPart * PaletteModel::loadPart(const QString & path, bool update) {
 	else {
 		modelPart->setParent(m_root);
 	}
+	m_searchIndexDirty = true;
 
 	return modelPart;
 }
@@ -361,6 +402,16 @@ bool PaletteModel::loadFromFile(const QString & fileName, ModelBase * referenceM
 	return result;
 }
 
+bool PaletteModel::loadFromDocument(const QString & fileName, QDomDocument & domDocument, ModelBase * referenceModel, bool checkViews) {
+	QList<ModelPart *> modelParts;
+	bool result = ModelBase::loadFromDocument(fileName, domDocument, referenceModel, modelParts, checkViews);
+	if (result) {
+		m_loadedFromFile = true;
+		m_loadedFrom = fileName;
+	}
+	return result;
+}
+
 bool PaletteModel::loadedFromFile() {
 	return m_loadedFromFile;
 }
@@ -411,6 +462,7 @@ void PaletteModel::removePart(const QString &moduleID) {
 	//DebugDialog::debug(QString("part hash count %1").arg(m_partHash.count()));
 	m_partHash.remove(moduleID);
 	//DebugDialog::debug(QString("part hash count %1").arg(m_partHash.count()));
+	m_searchIndexDirty = true;
 }
 
 void PaletteModel::removeParts() {
@@ -427,6 +479,7 @@ void PaletteModel::removeParts() {
 		m_partHash.remove(modelPart->moduleID());
 		delete modelPart;
 	}
+	m_searchIndexDirty = true;
 }
 
 void PaletteModel::clearPartHash() {
@@ -440,17 +493,23 @@ void PaletteModel::clearPartHash() {
 		delete modelPart;
 	}
 	m_partHash.clear();
+	m_searchIndexDirty = true;
 }
 
 void PaletteModel::setOrdererChildren(QList<QObject*> children) {
 	m_root->setOrderedChildren(children);
 }
 
-QList<ModelPart *> PaletteModel::search(const QString & searchText, bool allowObsolete) {
-	QList<ModelPart *> modelParts;
+QList<ModelPart *> PaletteModel::search(const QString & searchText, bool allowObsolete, const QSet<ModelPart *> * within) {
+	// goes through the search index, which compares the same fields as the tree walk below
+	if (m_searchIndexDirty) {
+		m_searchIndex.build(m_root);
+		m_searchIndexDirty = false;
+		within = nullptr;               // parts came or went since within was found
+	}
 
-	QStringList strings = searchText.split(" ");
-	search(m_root, strings, modelParts, allowObsolete);
+	QList<ModelPart *> modelParts = m_searchIndex.search(searchText.split(" "), allowObsolete, within);
+	Q_EMIT addSearchMaximum(modelParts.count());
 	return modelParts;
 }
 
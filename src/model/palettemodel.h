@@ -23,11 +23,13 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "modelpart.h"
 #include "modelbase.h"
+#include "partssearchindex.h"
 
 #include <QDomDocument>
 #include <QList>
 #include <QDir>
 #include <QStringList>
+#include <QVector>
 #include <QHash>
 
 class PaletteModel : public ModelBase
@@ -44,10 +46,11 @@ public:
 	bool loadedFromFile();
 	QString loadedFrom();
 	bool loadFromFile(const QString & fileName, ModelBase* referenceModel, bool checkViews);
+	bool loadFromDocument(const QString & fileName, QDomDocument &, ModelBase* referenceModel, bool checkViews);
 	ModelPart * addPart(QString newPartPath, bool addToReference, bool updateIdAlreadyExists);
 	void removePart(const QString &moduleID);
 	void removeParts();
-	QList<ModelPart *> search(const QString & searchText, bool allowObsolete);
+	QList<ModelPart *> search(const QString & searchText, bool allowObsolete, const QSet<ModelPart *> * within = nullptr);
 
 	void clearPartHash();
 	void setOrdererChildren(QList<QObject*> children);
@@ -55,6 +58,19 @@ public:
 	QList<ModelPart *> findContribNoBin();
 	QList<ModelPart *> allParts();
 
+protected:
+	struct FzpFile {
+		QString path;
+		bool contrib = false;
+		bool readable = false;
+		bool parsed = false;
+		QString fileError;
+		QDomDocument domDocument;
+		QString errorStr;
+		int errorLine = 0;
+		int errorColumn = 0;
+	};
+
 protected:
 	QHash<QString, ModelPart *> m_partHash;
 	bool m_loadedFromFile;
@@ -62,6 +78,8 @@ protected:
 
 	bool m_loadingContrib;
 	bool m_fullLoad;
+	PartsSearchIndex m_searchIndex;
+	bool m_searchIndexDirty = true;                     // set whenever parts come or go
 
 Q_SIGNALS:
 	void loadedPart(int i, int total);
@@ -74,6 +92,9 @@ protected:
 	void loadParts(bool dbExists);
 	void loadPartsAux(QDir & dir, QStringList & nameFilters, int & loadedPart, int totalParts);
 	void countParts(QDir & dir, QStringList & nameFilters, int & partCount);
+	void collectParts(QDir & dir, QStringList & nameFilters, QVector<FzpFile> &);
+	ModelPart * loadParsedPart(FzpFile &, bool update);
+	static void parseFzpFile(FzpFile &);
 	ModelPart * makeSubpart(ModelPart * originalModelPart, const QDomElement & originalSubparth);
 
 public:
@@ -0,0 +1,215 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "partssearchindex.h"
+#include "modelpart.h"
+
+#include <algorithm>
+
+static const int FieldWeights[] = { 8, 4, 3, 2, 1, 1, 1, 1 };
+static const int WordStartBonus = 1;
+
+static void appendField(QString & text, const QString & field)
+{
+	text.append(field.toCaseFolded());
+	text.append(QChar(0));
+}
+
+static QVector<int> intersect(const QVector<int> & a, const QVector<int> & b)
+{
+	QVector<int> result;
+	result.reserve(qMin(a.count(), b.count()));
+	std::set_intersection(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(), std::back_inserter(result));
+	return result;
+}
+
+void PartsSearchIndex::clear()
+{
+	m_entries.clear();
+	m_postings.clear();
+}
+
+void PartsSearchIndex::build(ModelPart * root)
+{
+	clear();
+	if (root != nullptr) addTree(root);
+}
+
+void PartsSearchIndex::addTree(ModelPart * modelPart)
+{
+	// in the order the tree walk visits the parts
+	add(modelPart);
+	Q_FOREACH (QObject * child, modelPart->children()) {
+		auto * mp = qobject_cast<ModelPart *>(child);
+		if (mp != nullptr) addTree(mp);
+	}
+}
+
+void PartsSearchIndex::add(ModelPart * modelPart)
+{
+	Entry entry;
+	entry.modelPart = modelPart;
+
+	QHash<QString, QString> properties = modelPart->properties();
+	for (int field = 0; field < FieldCount; field++) {
+		switch ((Field) field) {
+		case Title:
+			appendField(entry.text, modelPart->title());
+			break;
+		case Tags:
+			appendField(entry.text, modelPart->tags().join(QChar(0)));
+			break;
+		case PropertyValues:
+			appendField(entry.text, QStringList(properties.values()).join(QChar(0)));
+			break;
+		case ModuleID:
+			appendField(entry.text, modelPart->moduleID());
+			break;
+		case PropertyNames:
+			appendField(entry.text, QStringList(properties.keys()).join(QChar(0)));
+			break;
+		case Author:
+			appendField(entry.text, modelPart->author());
+			break;
+		case Description:
+			appendField(entry.text, modelPart->description());
+			break;
+		case Url:
+			appendField(entry.text, modelPart->url());
+			break;
+		default:
+			break;
+		}
+		entry.fieldEnds[field] = entry.text.length();
+	}
+
+	int index = m_entries.count();
+	QSet<quint64> trigrams;
+	const QChar * data = entry.text.constData();
+	for (int i = 0; i + 3 <= entry.text.length(); i++) {
+		if (data[i].isNull() || data[i + 1].isNull() || data[i + 2].isNull()) continue;
+		trigrams.insert(trigram(data + i));
+	}
+	Q_FOREACH (quint64 key, trigrams) {
+		m_postings[key].append(index);        // entries are added in index order, so each list stays sorted
+	}
+
+	m_entries.append(entry);
+}
+
+quint64 PartsSearchIndex::trigram(const QChar * chars)
+{
+	return ((quint64) chars[0].unicode() << 32) | ((quint64) chars[1].unicode() << 16) | chars[2].unicode();
+}
+
+QVector<int> PartsSearchIndex::candidates(const QString & term) const
+{
+	// the entries holding every trigram of the term; terms too short for a trigram match anything
+
+	QVector<const QVector<int> *> lists;
+	for (int i = 0; i + 3 <= term.length(); i++) {
+		auto it = m_postings.constFind(trigram(term.constData() + i));
+		if (it == m_postings.constEnd()) return QVector<int>();
+
+		lists << &it.value();
+	}
+
+	if (lists.isEmpty()) {
+		QVector<int> all(m_entries.count());
+		for (int i = 0; i < all.count(); i++) all[i] = i;
+		return all;
+	}
+
+	std::sort(lists.begin(), lists.end(), [](const QVector<int> * a, const QVector<int> * b) { return a->count() < b->count(); });
+	QVector<int> result = *lists.first();
+	for (int i = 1; i < lists.count() && !result.isEmpty(); i++) {
+		result = intersect(result, *lists.at(i));
+	}
+	return result;
+}
+
+int PartsSearchIndex::score(const Entry & entry, const QString & term) const
+{
+	// 0 when the term is in no field
+
+	int at = entry.text.indexOf(term);
+	if (at < 0) return 0;
+
+	int field = 0;
+	while (entry.fieldEnds[field] <= at) field++;
+	int score = FieldWeights[field];
+	if (at == 0 || !entry.text.at(at - 1).isLetterOrNumber()) score += WordStartBonus;
+	return score;
+}
+
+QList<ModelPart *> PartsSearchIndex::search(const QStringList & searchStrings, bool allowObsolete, const QSet<ModelPart *> * within) const
+{
+	// every term must be in some field, as with the tree walk; best scores first, ties in tree order.
+	// within, when given, limits the hits to those parts
+
+	QStringList terms;
+	Q_FOREACH (QString searchString, searchStrings) {
+		if (!searchString.isEmpty()) terms << searchString.toCaseFolded();
+	}
+
+	QVector<int> found;
+	bool first = true;
+	Q_FOREACH (QString term, terms) {
+		QVector<int> termCandidates = candidates(term);
+		found = first ? termCandidates : intersect(found, termCandidates);
+		first = false;
+		if (found.isEmpty()) return QList<ModelPart *>();
+	}
+	if (first) found = candidates(QString());
+
+	QVector<QPair<int, int> > ranked;           // score, entry
+	Q_FOREACH (int index, found) {
+		const Entry & entry = m_entries.at(index);
+		if (entry.modelPart.isNull()) continue;
+		if (within != nullptr && !within->contains(entry.modelPart)) continue;
+		if (!allowObsolete && entry.modelPart->isObsolete()) continue;
+
+		int total = 0;
+		Q_FOREACH (QString term, terms) {
+			int termScore = score(entry, term);
+			if (termScore == 0) {
+				total = 0;
+				break;
+			}
+			total += termScore;
+		}
+		if (total == 0 && !terms.isEmpty()) continue;
+
+		ranked << qMakePair(total, index);
+	}
+
+	std::stable_sort(ranked.begin(), ranked.end(), [](const QPair<int, int> & a, const QPair<int, int> & b) { return a.first > b.first; });
+
+	QList<ModelPart *> modelParts;
+	QSet<ModelPart *> seen;
+	for (const QPair<int, int> & pair : ranked) {
+		ModelPart * modelPart = m_entries.at(pair.second).modelPart;
+		if (seen.contains(modelPart)) continue;
+
+		seen.insert(modelPart);
+		modelParts << modelPart;
+	}
+	return modelParts;
+}
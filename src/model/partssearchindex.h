@@ -0,0 +1,75 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef PARTSSEARCHINDEX_H
+#define PARTSSEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class PartsSearchIndex
+{
+	// an in-memory index for the parts search: each part's searchable fields are case folded into one
+	// text, and a trigram inverted index narrows each search to the parts that can contain every term.
+	// matching stays a substring match on the fields PaletteModel::search always compared; hits are ranked
+	// by the field a term is found in and whether it starts a word there
+
+public:
+	void clear();
+	void build(class ModelPart * root);
+	QList<class ModelPart *> search(const QStringList & searchStrings, bool allowObsolete, const QSet<class ModelPart *> * within = nullptr) const;
+
+protected:
+	enum Field {
+		Title,                          // ordered by weight; the first hit in the text is the best field
+		Tags,
+		PropertyValues,
+		ModuleID,
+		PropertyNames,
+		Author,
+		Description,
+		Url,
+		FieldCount
+	};
+
+	struct Entry {
+		QPointer<class ModelPart> modelPart;
+		QString text;                   // the fields in Field order, each ending in a null
+		int fieldEnds[FieldCount];
+	};
+
+	void addTree(class ModelPart *);
+	void add(class ModelPart *);
+	QVector<int> candidates(const QString & term) const;
+	int score(const Entry &, const QString & term) const;
+
+	static quint64 trigram(const QChar *);
+
+protected:
+	QVector<Entry> m_entries;
+	QHash<quint64, QVector<int> > m_postings;     // trigram -> ascending entry indices
+};
+
+#endif
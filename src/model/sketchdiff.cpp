@@ -0,0 +1,257 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "sketchdiff.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QSet>
+
+#include <algorithm>
+
+const double SketchDiff::MoveTolerance = 0.01;		// pixels; geometry is saved with more digits than that
+
+void SketchDiff::compare(HeadlessSketch & before, HeadlessSketch & after)
+{
+	m_added.clear();
+	m_removed.clear();
+	m_swapped.clear();
+	m_moved.clear();
+	m_addedNets.clear();
+	m_removedNets.clear();
+
+	QHash<long, const HeadlessSketch::Instance *> beforeInstances;
+	QSet<QString> viewNames;
+	Q_FOREACH (const HeadlessSketch::Instance & instance, before.instances()) {
+		Q_FOREACH (const QString & viewName, instance.views) viewNames.insert(viewName);
+		if (HeadlessSketch::isWire(instance)) continue;
+
+		beforeInstances.insert(instance.modelIndex, &instance);
+	}
+
+	Q_FOREACH (const HeadlessSketch::Instance & instance, after.instances()) {
+		Q_FOREACH (const QString & viewName, instance.views) viewNames.insert(viewName);
+		if (HeadlessSketch::isWire(instance)) continue;
+
+		const HeadlessSketch::Instance * previous = beforeInstances.take(instance.modelIndex);
+		if (previous == nullptr) {
+			m_added.append(part(instance));
+			continue;
+		}
+
+		if (previous->moduleIdRef != instance.moduleIdRef) {
+			Part swapped = part(instance);
+			swapped.previousModuleIdRef = previous->moduleIdRef;
+			m_swapped.append(swapped);
+		}
+
+		QStringList locationViews = instance.locations.keys();
+		locationViews.sort();
+		Q_FOREACH (const QString & viewName, locationViews) {
+			auto it = previous->locations.constFind(viewName);
+			if (it == previous->locations.constEnd()) continue;
+
+			QPointF to = instance.locations.value(viewName);
+			QPointF delta = to - it.value();
+			if (qAbs(delta.x()) <= MoveTolerance && qAbs(delta.y()) <= MoveTolerance) continue;
+
+			Move move;
+			move.part = part(instance);
+			move.viewName = viewName;
+			move.from = it.value();
+			move.to = to;
+			m_moved.append(move);
+		}
+	}
+
+	// what is left was removed; report it in the order of the first sketch
+	Q_FOREACH (const HeadlessSketch::Instance & instance, before.instances()) {
+		if (beforeInstances.contains(instance.modelIndex)) {
+			m_removed.append(part(instance));
+		}
+	}
+
+	QStringList sortedViewNames = viewNames.values();
+	sortedViewNames.sort();
+	Q_FOREACH (const QString & viewName, sortedViewNames) {
+		compareNets(before, after, viewName);
+	}
+}
+
+void SketchDiff::compareNets(HeadlessSketch & before, HeadlessSketch & after, const QString & viewName)
+{
+	// nets are compared by their sorted members, so a rerouted wire that joins the same connectors is no change
+	QHash<long, QString> beforeTitles = titles(before);
+	QHash<long, QString> afterTitles = titles(after);
+	QHash<QString, int> beforeKeys;
+	QList< QList<HeadlessSketch::PartConnector> > beforeNets = before.nets(viewName);
+	for (int i = 0; i < beforeNets.count(); i++) {
+		if (beforeNets.at(i).count() < 2) continue;
+
+		beforeKeys.insert(netKey(beforeNets.at(i)), i);
+	}
+
+	Q_FOREACH (const QList<HeadlessSketch::PartConnector> & connectors, after.nets(viewName)) {
+		if (connectors.count() < 2) continue;
+
+		if (beforeKeys.remove(netKey(connectors)) == 0) {
+			m_addedNets.append(net(after, afterTitles, viewName, connectors));
+		}
+	}
+
+	QList<int> removed = beforeKeys.values();
+	std::sort(removed.begin(), removed.end());
+	Q_FOREACH (int index, removed) {
+		m_removedNets.append(net(before, beforeTitles, viewName, beforeNets.at(index)));
+	}
+}
+
+bool SketchDiff::isEmpty() const
+{
+	return m_added.isEmpty() && m_removed.isEmpty() && m_swapped.isEmpty() && m_moved.isEmpty() &&
+	       m_addedNets.isEmpty() && m_removedNets.isEmpty();
+}
+
+const QList<SketchDiff::Part> & SketchDiff::added() const
+{
+	return m_added;
+}
+
+const QList<SketchDiff::Part> & SketchDiff::removed() const
+{
+	return m_removed;
+}
+
+const QList<SketchDiff::Part> & SketchDiff::swapped() const
+{
+	return m_swapped;
+}
+
+const QList<SketchDiff::Move> & SketchDiff::moved() const
+{
+	return m_moved;
+}
+
+const QList<SketchDiff::Net> & SketchDiff::addedNets() const
+{
+	return m_addedNets;
+}
+
+const QList<SketchDiff::Net> & SketchDiff::removedNets() const
+{
+	return m_removedNets;
+}
+
+SketchDiff::Part SketchDiff::part(const HeadlessSketch::Instance & instance)
+{
+	Part part;
+	part.modelIndex = instance.modelIndex;
+	part.title = instance.title;
+	part.moduleIdRef = instance.moduleIdRef;
+	return part;
+}
+
+QString SketchDiff::netKey(const QList<HeadlessSketch::PartConnector> & connectors)
+{
+	QStringList members;
+	Q_FOREACH (const HeadlessSketch::PartConnector & partConnector, connectors) {
+		members.append(QString("%1:%2").arg(partConnector.modelIndex).arg(partConnector.connectorID));
+	}
+	members.sort();
+	return members.join(' ');
+}
+
+QHash<long, QString> SketchDiff::titles(const HeadlessSketch & sketch)
+{
+	QHash<long, QString> titles;
+	Q_FOREACH (const HeadlessSketch::Instance & instance, sketch.instances()) {
+		titles.insert(instance.modelIndex, instance.title);
+	}
+	return titles;
+}
+
+SketchDiff::Net SketchDiff::net(HeadlessSketch & sketch, const QHash<long, QString> & titles, const QString & viewName, const QList<HeadlessSketch::PartConnector> & connectors)
+{
+	Net net;
+	net.viewName = viewName;
+	net.connectors = connectors;
+	Q_FOREACH (const HeadlessSketch::PartConnector & partConnector, connectors) {
+		net.labels.append(QString("%1.%2").arg(titles.value(partConnector.modelIndex), sketch.connectorName(partConnector.modelIndex, partConnector.connectorID)));
+	}
+	return net;
+}
+
+static QJsonObject partJson(const SketchDiff::Part & part)
+{
+	QJsonObject object;
+	object.insert("modelIndex", (qint64) part.modelIndex);
+	object.insert("title", part.title);
+	object.insert("moduleIdRef", part.moduleIdRef);
+	if (!part.previousModuleIdRef.isEmpty()) {
+		object.insert("previousModuleIdRef", part.previousModuleIdRef);
+	}
+	return object;
+}
+
+static QJsonArray netsJson(const QList<SketchDiff::Net> & nets)
+{
+	QJsonArray array;
+	Q_FOREACH (const SketchDiff::Net & net, nets) {
+		QJsonObject object;
+		object.insert("view", net.viewName);
+		object.insert("connectors", QJsonArray::fromStringList(net.labels));
+		array.append(object);
+	}
+	return array;
+}
+
+QJsonObject SketchDiff::toJson() const
+{
+	QJsonArray added;
+	Q_FOREACH (const Part & part, m_added) added.append(partJson(part));
+	QJsonArray removed;
+	Q_FOREACH (const Part & part, m_removed) removed.append(partJson(part));
+	QJsonArray swapped;
+	Q_FOREACH (const Part & part, m_swapped) swapped.append(partJson(part));
+
+	QJsonArray moved;
+	Q_FOREACH (const Move & move, m_moved) {
+		QJsonObject object = partJson(move.part);
+		object.insert("view", move.viewName);
+		QJsonObject from;
+		from.insert("x", move.from.x());
+		from.insert("y", move.from.y());
+		object.insert("from", from);
+		QJsonObject to;
+		to.insert("x", move.to.x());
+		to.insert("y", move.to.y());
+		object.insert("to", to);
+		moved.append(object);
+	}
+
+	QJsonObject object;
+	object.insert("identical", isEmpty());
+	object.insert("added", added);
+	object.insert("removed", removed);
+	object.insert("swapped", swapped);
+	object.insert("moved", moved);
+	object.insert("addedNets", netsJson(m_addedNets));
+	object.insert("removedNets", netsJson(m_removedNets));
+	return object;
+}
@@ -0,0 +1,92 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef SKETCHDIFF_H
+#define SKETCHDIFF_H
+
+#include "headlesssketch.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+
+class SketchDiff
+{
+	// what changed between two sketches read by HeadlessSketch, for reviewing a design change
+	// without loading either one: parts are matched by model index, wires are left to the nets,
+	// and a connection change is a net of two or more part connectors found in only one sketch
+
+public:
+	struct Part {
+		long modelIndex = 0;
+		QString title;
+		QString moduleIdRef;
+		QString previousModuleIdRef;				// set for a swapped part
+	};
+
+	struct Move {
+		Part part;
+		QString viewName;
+		QPointF from;
+		QPointF to;
+	};
+
+	struct Net {
+		QString viewName;
+		QList<HeadlessSketch::PartConnector> connectors;
+		QStringList labels;							// "title.connector name", in connector order
+	};
+
+public:
+	SketchDiff() = default;
+
+	void compare(HeadlessSketch & before, HeadlessSketch & after);
+	bool isEmpty() const;
+	const QList<Part> & added() const;
+	const QList<Part> & removed() const;
+	const QList<Part> & swapped() const;
+	const QList<Move> & moved() const;
+	const QList<Net> & addedNets() const;
+	const QList<Net> & removedNets() const;
+	QJsonObject toJson() const;
+
+public:
+	static const double MoveTolerance;
+
+protected:
+	void compareNets(HeadlessSketch & before, HeadlessSketch & after, const QString & viewName);
+
+	static Part part(const HeadlessSketch::Instance &);
+	static QString netKey(const QList<HeadlessSketch::PartConnector> &);
+	static QHash<long, QString> titles(const HeadlessSketch &);
+	static Net net(HeadlessSketch &, const QHash<long, QString> & titles, const QString & viewName, const QList<HeadlessSketch::PartConnector> &);
+
+protected:
+	QList<Part> m_added;
+	QList<Part> m_removed;
+	QList<Part> m_swapped;
+	QList<Move> m_moved;
+	QList<Net> m_addedNets;
+	QList<Net> m_removedNets;
+};
+
+#endif
@@ -42,9 +42,29 @@ void SketchModel::removeModelPart(ModelPart * modelPart) {
 ModelPart * SketchModel::findModelPart(const QString & moduleID, long id) {
 	if (m_root == nullptr) return nullptr;
 
+	if (m_pasting) {
+		// everything a paste makes has a fresh model index, so only parts made earlier in the same paste can match
+		ModelPart * modelPart = m_pasted.value(id / ModelPart::indexMultiplier);
+		return (modelPart != nullptr && modelPart->parent() != nullptr && modelPart->moduleID().compare(moduleID) == 0) ? modelPart : nullptr;
+	}
+
 	return findModelPartAux(m_root, moduleID, id);
 }
 
+void SketchModel::beginPaste() {
+	m_pasting = true;
+	m_pasted.clear();
+}
+
+void SketchModel::endPaste() {
+	m_pasting = false;
+	m_pasted.clear();
+}
+
+void SketchModel::notePasted(long id, ModelPart * modelPart) {
+	if (m_pasting) m_pasted.insert(id / ModelPart::indexMultiplier, modelPart);
+}
+
 ModelPart * SketchModel::findModelPartAux(ModelPart * modelPart, const QString & moduleID, long id)
 {
 	if (modelPart->moduleID().compare(moduleID) == 0) {
@@ -26,6 +26,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QTextStream>
 #include <QMultiHash>
+#include <QHash>
+#include <QPointer>
 
 class SketchModel : public ModelBase
 {
@@ -36,9 +38,16 @@ public:
 
 	void removeModelPart(ModelPart *);
 	ModelPart * findModelPart(const QString & moduleID, long id);
+	void beginPaste();
+	void endPaste();
+	void notePasted(long id, ModelPart *);
 
 protected:
 	ModelPart * findModelPartAux(ModelPart * modelPart, const QString & moduleID, long id);
+
+protected:
+	bool m_pasting = false;
+	QHash<long, QPointer<ModelPart> > m_pasted;		// model index -> part made by the paste under way
 };
 
 #endif
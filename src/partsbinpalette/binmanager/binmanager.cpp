@@ -27,6 +27,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QInputDialog>
 #include <QDropEvent>
 #include <QMimeData>
+#include <QSet>
 
 #include "binmanager.h"
 #include "stacktabwidget.h"
@@ -113,6 +114,7 @@ BinManager::BinManager(class ReferenceModel *referenceModel, class HtmlInfoView
 	m_defaultSaveFolder = FolderUtils::getUserBinsPath();
 	m_mainWindow = parent;
 	m_currentBin = nullptr;
+	m_searchShown = 0;
 
 	connect(this, SIGNAL(savePartAsBundled(const QString &)), m_mainWindow, SLOT(saveBundledPart(const QString &)));
 
@@ -315,6 +317,18 @@ void BinManager::addToMyParts(ModelPart *modelPart) {
 	}
 }
 
+void BinManager::addToMyParts(const QList<ModelPart *> & modelParts) {
+	PartsBinPaletteWidget *bin = getOrOpenMyPartsBin();
+	if (bin != nullptr) {
+		if (bin->fastLoaded()) {
+			bin->load(bin->fileName(), bin, false);
+		}
+		bin->addParts(modelParts);
+		setDirtyTab(bin);
+		setAsCurrentTab(bin);
+	}
+}
+
 void BinManager::addToTempPartsBin(ModelPart *modelPart) {
 	PartsBinPaletteWidget *bin = getOrOpenBin(m_tempPartsBinLocation, TempPartsBinTemplateLocation);
 	if (bin != nullptr) {
@@ -910,18 +924,25 @@ void BinManager::initNames() {
 }
 
 void BinManager::search(const QString & searchText) {
+	// a query extending the previous one can only narrow it, so only the previous results are searched;
+	// the bin gets a page of results at a time, so only those icons are made
 	PartsBinPaletteWidget * searchBin = getOrOpenSearchBin();
 	if (searchBin == nullptr) return;
 
-	FileProgressDialog progress(tr("Searching..."), 0, this);
-	progress.setIncValueMod(10);
-	connect(m_referenceModel, SIGNAL(addSearchMaximum(int)), &progress, SLOT(addMaximum(int)));
-	connect(m_referenceModel, SIGNAL(incSearch()), &progress, SLOT(incValue()));
+	QSet<ModelPart *> previous;
+	bool refine = !m_searchText.isEmpty() && searchText.startsWith(m_searchText);
+	if (refine) {
+		Q_FOREACH (QPointer<ModelPart> modelPart, m_searchResults) {
+			if (modelPart != nullptr) previous.insert(modelPart);
+		}
+		if (m_searchResults.count() >= SearchResultLimit) refine = false;   // the cap may have cut off parts that still match
+	}
 
-	QList<ModelPart *> modelParts = m_referenceModel->search(searchText, false);
+	QList<ModelPart *> modelParts = m_referenceModel->search(searchText, false, refine ? &previous : nullptr);
 
-	progress.setIncValueMod(1);
-	searchBin->removeParts();
+	m_searchText = searchText;
+	m_searchResults.clear();
+	m_searchShown = 0;
 	Q_FOREACH (ModelPart * modelPart, modelParts) {
 		//DebugDialog::debug(modelPart->title());
 		if (modelPart->itemType() == ModelPart::SchematicSubpart) {
@@ -929,11 +950,36 @@ void BinManager::search(const QString & searchText) {
 		else if (modelPart->moduleID().contains(PartFactory::OldSchematicPrefix)) {
 		}
 		else {
+			m_searchResults << modelPart;
+			if (m_searchResults.count() >= SearchResultLimit) break;
+		}
+	}
+
+	searchBin->removeParts();
+	showSearchPage(searchBin);
+}
+
+void BinManager::searchMore() {
+	PartsBinPaletteWidget * searchBin = getOrOpenSearchBin();
+	if (searchBin == nullptr) return;
+
+	showSearchPage(searchBin);
+}
+
+void BinManager::showSearchPage(PartsBinPaletteWidget * searchBin) {
+	int end = qMin(m_searchResults.count(), m_searchShown + SearchPageSize);
+	for (; m_searchShown < end; m_searchShown++) {
+		ModelPart * modelPart = m_searchResults.at(m_searchShown);
+		if (modelPart == nullptr) continue;
+
+		// retrieving fills in a part the reference model loaded lazily
+		modelPart = m_referenceModel->retrieveModelPart(modelPart->moduleID());
+		if (modelPart != nullptr) {
 			this->addPartTo(searchBin, modelPart, false);
 		}
-		progress.incValue();
 	}
 
+	searchBin->setMoreSearchResults(m_searchResults.count() - m_searchShown);
 	setDirtyTab(searchBin);
 }
 
@@ -1127,6 +1173,12 @@ void BinManager::importPartToMineBin(const QString & filename) {
 	}
 }
 
+void BinManager::importPartsToMineBin(const QStringList & filenames) {
+	if (filenames.isEmpty()) return;
+
+	m_mainWindow->loadBundledParts(filenames, true);
+}
+
 void BinManager::importPartToCurrentBin(const QString & filename) {
 
 	if (!filename.isEmpty() && !filename.isNull()) {
@@ -27,6 +27,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMenu>
 #include <QLabel>
 #include <QDir>
+#include <QPointer>
 
 class ModelPart;
 class PaletteModel;
@@ -63,6 +64,7 @@ public:
 	void insertBin(PartsBinPaletteWidget* bin, int index);
 	void addPartToBin(ModelPart *modelPart, int position = -1);
 	void addToMyParts(ModelPart *modelPart);
+	void addToMyParts(const QList<ModelPart *> & modelParts);
 	void addToTempPartsBin(ModelPart *modelPart);
 	void hideTempPartsBin();
 
@@ -94,6 +96,7 @@ public:
 
 	MainWindow* mainWindow();
 	void search(const QString & searchText);
+	void searchMore();
 	bool currentViewIsIconView();
 	void updateViewChecks(bool iconView);
 	QMenu * binContextMenu(PartsBinPaletteWidget *);
@@ -104,6 +107,7 @@ public:
 	void copyFilesToContrib(ModelPart *, QWidget * originator);
 	void importPartToCurrentBin(const QString & filename);
 	void importPartToMineBin(const QString & filename);
+	void importPartsToMineBin(const QStringList & filenames);
 	bool isTempPartsBin(PartsBinPaletteWidget * bin);
 	void setTempPartsBinLocation(const QString & filename);
 	void hideTabBar();
@@ -161,6 +165,7 @@ protected:
 	void updateBinCombinedMenu(PartsBinPaletteWidget * bin);
 	void importPart(const QString & filename, PartsBinPaletteWidget * bin);
 	void hackLocalContrib(QList<BinLocation *> &);
+	void showSearchPage(PartsBinPaletteWidget * searchBin);
 
 
 protected:
@@ -174,6 +179,9 @@ protected:
 	class StackTabWidget* m_stackTabWidget;
 
 	QHash<QString /*filename*/,PartsBinPaletteWidget*> m_openedBins;
+	QString m_searchText;
+	QList<QPointer<ModelPart> > m_searchResults;             // capped at SearchResultLimit
+	int m_searchShown;                                       // how many of m_searchResults are in the search bin
 	int m_unsavedBinsCount;
 	QString m_defaultSaveFolder;
 
@@ -217,6 +225,8 @@ public:
 	static QString ContribPartsBinLocation;
 	static QString TempPartsBinTemplateLocation;
 	static QHash<QString, QString> StandardBinIcons;
+	static const int SearchPageSize = 60;
+	static const int SearchResultLimit = 1000;
 
 	static bool isTabReorderingEvent(QDropEvent* event);
 	static void initNames();
@@ -40,43 +40,56 @@ void GraphicsFlowLayout::setGeometry(const QRectF &rect) {
 }
 
 int GraphicsFlowLayout::heightForWidth(int width) {
-	return doLayout(QRectF(0, 0, width, 0));
+	if (m_lastHeight >= 0 && width == m_lastWidth) return m_lastHeight;
+
+	return doLayout(QRectF(0, 0, width, 0), false);
 }
 
+void GraphicsFlowLayout::invalidate() {
+	m_lastHeight = -1;
+	QGraphicsLinearLayout::invalidate();
+}
 
-int GraphicsFlowLayout::doLayout(const QRectF &rect) {
+int GraphicsFlowLayout::doLayout(const QRectF &rect, bool apply) {
+	// each item's size is asked once; a bin's icons are all the same size, so measuring
+	// without moving anything is a walk over the items and no more
 	auto x = rect.x();
 	auto y = rect.y();
 	auto lineHeight = 0.0;
 
 	for(int i=0; i < count(); ++i) {
 		QGraphicsLayoutItem* item = itemAt(i);
-		auto nextX = x + item->preferredSize().width() + spacing();
+		QSizeF size = item->preferredSize();
+		auto nextX = x + size.width() + spacing();
 
 		if (item->sizePolicy().horizontalPolicy() == QSizePolicy::Expanding) {
 			auto myY = y + lineHeight + spacing() + SpaceBefore;
-			QRectF r(QPoint(rect.x(), myY), item->preferredSize());
-			item->setGeometry(r);
+			if (apply) {
+				item->setGeometry(QRectF(QPoint(rect.x(), myY), size));
+			}
 			x = rect.x();
-			y = myY + item->preferredSize().height() + spacing() + SpaceAfter;
+			y = myY + size.height() + spacing() + SpaceAfter;
 			continue;
 		}
 
 		if (nextX - spacing() > rect.right() && lineHeight > 0) {
 			x = rect.x();
 			y = y + lineHeight + spacing();
-			nextX = x + item->preferredSize().width() + spacing();
+			nextX = x + size.width() + spacing();
 			lineHeight = 0;
 		}
-		item->setGeometry(QRectF(QPoint(x, y), item->preferredSize()));
+		if (apply) {
+			item->setGeometry(QRectF(QPoint(x, y), size));
+		}
 
 		x = nextX;
-		// item->preferredSize().height() returns qreal, armel compiler complains
-		lineHeight = qMax(lineHeight, item->preferredSize().height());
+		// size.height() returns qreal, armel compiler complains
+		lineHeight = qMax(lineHeight, size.height());
 	}
 
 	m_lastWidth = rect.width();
-	return y + lineHeight - rect.y();
+	m_lastHeight = y + lineHeight - rect.y();
+	return m_lastHeight;
 }
 
 
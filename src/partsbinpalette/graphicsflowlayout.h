@@ -34,12 +34,14 @@ public:
 	int heightForWidth(int width);
 	void clear();
 	int indexOf(const QGraphicsLayoutItem *item);
+	void invalidate();
 
 protected:
 	void widgetEvent(QEvent * e);
-	int doLayout(const QRectF &rect);
+	int doLayout(const QRectF &rect, bool apply = true);
 
 	double m_lastWidth;
+	int m_lastHeight = -1;              // for m_lastWidth; -1 once items change
 };
 
 #endif /* GRAPHICSFLOWLAYOUT_H_ */
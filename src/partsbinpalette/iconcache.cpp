@@ -0,0 +1,179 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "iconcache.h"
+#include "../debugdialog.h"
+#include "../utils/folderutils.h"
+#include "../version/version.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QPainter>
+#include <QSaveFile>
+#include <QSvgRenderer>
+#include <QPointer>
+#include <QThreadPool>
+
+const quint32 IconCache::FormatVersion = 1;
+
+static const QString StampFileName("stamp");
+static const QString Suffix(".png");
+static const int MemoryCostKB = 8 * 1024;
+
+static IconCache * Singleton = nullptr;
+
+IconCache * IconCache::instance()
+{
+	if (Singleton == nullptr) {
+		Singleton = new IconCache();
+	}
+	return Singleton;
+}
+
+void IconCache::cleanup()
+{
+	delete Singleton;
+	Singleton = nullptr;
+}
+
+IconCache::IconCache() : m_images(MemoryCostKB)
+{
+	// pngs from another Fritzing version are thrown away, in case icon rendering has changed
+	QDir dir(FolderUtils::getTopLevelUserDataStorePath());
+	if (!dir.mkpath("iconcache")) {
+		DebugDialog::debug("unable to create icon cache folder");
+		return;
+	}
+
+	m_folder = dir.absoluteFilePath("iconcache");
+	QByteArray stamp = QString("%1 %2").arg(FormatVersion).arg(Version::versionString()).toUtf8();
+
+	QDir folder(m_folder);
+	QFile stampFile(folder.absoluteFilePath(StampFileName));
+	if (stampFile.open(QFile::ReadOnly)) {
+		QByteArray oldStamp = stampFile.readAll();
+		stampFile.close();
+		if (oldStamp == stamp) return;
+	}
+
+	Q_FOREACH (QString name, folder.entryList(QStringList("*" + Suffix), QDir::Files)) {
+		folder.remove(name);
+	}
+	if (stampFile.open(QFile::WriteOnly)) {
+		stampFile.write(stamp);
+		stampFile.close();
+	}
+}
+
+QByteArray IconCache::makeKey(const QString & moduleID, const QString & svgPath, QSize size, qreal scale)
+{
+	// the raw svg rather than the loaded one, so a hit needs neither the svg parser nor the renderer;
+	// the module id covers the part's own modifications, such as a chip label; empty when the svg can't be read
+	QFile file(svgPath);
+	if (!file.open(QFile::ReadOnly)) return QByteArray();
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(&file);
+	hash.addData(moduleID.toUtf8());
+	hash.addData(QString(" %1 %2 %3").arg(size.width()).arg(size.height()).arg(scale).toUtf8());
+	return hash.result().toHex();
+}
+
+QString IconCache::path(const QByteArray & key) const
+{
+	return QDir(m_folder).absoluteFilePath(QString::fromLatin1(key) + Suffix);
+}
+
+bool IconCache::find(const QByteArray & key, QImage & image)
+{
+	QImage * cached = m_images.object(key);
+	if (cached != nullptr) {
+		image = *cached;
+		return true;
+	}
+
+	if (m_folder.isEmpty()) return false;
+
+	QString filename = path(key);
+	if (!QFile::exists(filename)) return false;
+
+	QImage loaded(filename);
+	if (loaded.isNull()) return false;
+
+	image = loaded;
+	m_images.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+	return true;
+}
+
+void IconCache::render(const QByteArray & key, const QByteArray & svg, QSizeF defaultSize, QSize size, qreal scale)
+{
+	// renders on the thread pool; rendered() follows on the gui thread, once per key however often it was asked for
+	if (m_pending.contains(key)) return;
+
+	m_pending.insert(key);
+	QString filename = m_folder.isEmpty() ? QString() : path(key);
+	QPointer<IconCache> self(this);
+	QThreadPool::globalInstance()->start([self, key, svg, defaultSize, size, scale, filename]() {
+		QImage image = renderAux(svg, defaultSize, size, scale);
+		if (!image.isNull() && !filename.isEmpty()) {
+			// QSaveFile so a crash or a second Fritzing never leaves a half-written file behind
+			QSaveFile file(filename);
+			if (file.open(QFile::WriteOnly) && image.save(&file, "PNG")) {
+				file.commit();
+			}
+		}
+		if (self.isNull()) return;
+
+		QMetaObject::invokeMethod(self.data(), "renderedSlot", Qt::QueuedConnection, Q_ARG(QByteArray, key), Q_ARG(QImage, image));
+	});
+}
+
+QImage IconCache::renderAux(const QByteArray & svg, QSizeF defaultSize, QSize size, qreal scale)
+{
+	// thread pool safe; centered with its aspect ratio kept, as FSvgRenderer::getPixmap does
+	QSvgRenderer renderer(svg);
+	if (!renderer.isValid()) return QImage();
+
+	if (defaultSize.isEmpty()) defaultSize = renderer.defaultSize();
+	if (defaultSize.isEmpty()) return QImage();
+
+	QImage image(size * scale, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::transparent);
+	double newW = image.width();
+	double newH = newW * defaultSize.height() / defaultSize.width();
+	if (newH > image.height()) {
+		newH = image.height();
+		newW = newH * defaultSize.width() / defaultSize.height();
+	}
+
+	QPainter painter(&image);
+	renderer.render(&painter, QRectF((image.width() - newW) / 2.0, (image.height() - newH) / 2.0, newW, newH));
+	painter.end();
+	return image;
+}
+
+void IconCache::renderedSlot(const QByteArray & key, const QImage & image)
+{
+	m_pending.remove(key);
+	if (!image.isNull()) {
+		m_images.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+	}
+	Q_EMIT rendered(key, image);
+}
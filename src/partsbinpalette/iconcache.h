@@ -0,0 +1,68 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QSizeF>
+#include <QString>
+
+class IconCache : public QObject
+{
+	// parts bin icons rendered on the thread pool and kept as pngs under the user data folder,
+	// keyed on the icon svg's bytes, the part, and the icon size and device scale
+
+	Q_OBJECT
+
+public:
+	static IconCache * instance();
+	static void cleanup();
+	static QByteArray makeKey(const QString & moduleID, const QString & svgPath, QSize size, qreal scale);
+
+	bool find(const QByteArray & key, QImage &);
+	void render(const QByteArray & key, const QByteArray & svg, QSizeF defaultSize, QSize size, qreal scale);
+
+Q_SIGNALS:
+	void rendered(const QByteArray & key, const QImage &);
+
+protected:
+	IconCache();
+
+	QString path(const QByteArray & key) const;
+	static QImage renderAux(const QByteArray & svg, QSizeF defaultSize, QSize size, qreal scale);
+
+protected Q_SLOTS:
+	void renderedSlot(const QByteArray & key, const QImage &);
+
+protected:
+	QString m_folder;                               // empty when the cache folder can't be made; the memory cache still works
+	QCache<QByteArray, QImage> m_images;            // cost in kilobytes
+	QSet<QByteArray> m_pending;
+
+public:
+	static const quint32 FormatVersion;
+};
+
+#endif
@@ -57,6 +57,12 @@ PartsBinIconView::PartsBinIconView(ReferenceModel* referenceModel, PartsBinPalet
 
 	setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 
+	// a part's ItemBase and icon are only set up once its widget is first painted, so a bin of
+	// thousands of parts costs little more than the screenful that shows
+	m_materializeTimer.setSingleShot(true);
+	m_materializeTimer.setInterval(0);
+	connect(&m_materializeTimer, SIGNAL(timeout()), this, SLOT(materializeWanted()));
+
 	setContextMenuPolicy(Qt::CustomContextMenu);
 	connect(
 	    this, SIGNAL(customContextMenuRequested(const QPoint&)),
@@ -113,6 +119,8 @@ void PartsBinIconView::mousePressEvent(QMouseEvent *event) {
 			icon->setSelected(true);
 			icon->update();
 
+			materialize(icon);
+
 			QPointF mts = this->mapToScene(event->pos());
 			QString moduleID = icon->moduleID();
 			QPoint hotspot = (mts.toPoint()-icon->pos().toPoint());
@@ -130,6 +138,7 @@ void PartsBinIconView::mousePressEvent(QMouseEvent *event) {
 
 void PartsBinIconView::doClear() {
 	PartsBinView::doClear();
+	m_wanted.clear();
 	m_layout->clear();
 	delete m_layouter;			// deleting layouter deletes layout
 	delete scene();				// deleting scene deletes QGraphicsItems
@@ -200,9 +209,9 @@ int PartsBinIconView::setItemAux(ModelPart * modelPart, int position) {
 
 	SvgIconWidget* svgicon = nullptr;
 	if (modelPart->itemType() != ModelPart::Space) {
-		ItemBase::PluralType plural;
-		ItemBase * itemBase = loadItemBase(moduleID, plural);
-		svgicon = new SvgIconWidget(modelPart, ViewLayer::IconView, itemBase, plural == ItemBase::Plural);
+		m_itemBaseHash.insert(moduleID, nullptr);
+		svgicon = new SvgIconWidget(modelPart, ViewLayer::IconView, nullptr, false);
+		connect(svgicon, SIGNAL(itemBaseWanted(SvgIconWidget *)), this, SLOT(itemBaseWanted(SvgIconWidget *)));
 	}
 	else {
 		svgicon = new SvgIconWidget(modelPart, ViewLayer::IconView, nullptr, false);
@@ -252,6 +261,7 @@ void PartsBinIconView::loadFromModel(PaletteModel * model) {
 ModelPart *PartsBinIconView::selectedModelPart() {
 	auto *icon = dynamic_cast<SvgIconWidget *>(selectedAux());
 	if(icon != nullptr) {
+		materialize(icon);
 		return icon->modelPart();
 	} else {
 		return nullptr;
@@ -261,6 +271,7 @@ ModelPart *PartsBinIconView::selectedModelPart() {
 ItemBase *PartsBinIconView::selectedItemBase() {
 	auto *icon = dynamic_cast<SvgIconWidget *>(selectedAux());
 	if(icon != nullptr) {
+		materialize(icon);
 		return icon->itemBase();
 	} else {
 		return nullptr;
@@ -391,7 +402,14 @@ QList<QObject*> PartsBinIconView::orderedChildren() {
 
 	for(int i=0; i < m_layout->count(); i++) {
 		auto *it = dynamic_cast<SvgIconWidget*>(m_layout->itemAt(i));
-		if(it != nullptr) {
+		if(it == nullptr) continue;
+
+		if (it->needsItemBase()) {
+			// the same reference model part its ItemBase would be made from
+			ModelPart * modelPart = m_referenceModel->retrieveModelPart(it->moduleID());
+			if (modelPart != nullptr) result << modelPart;
+		}
+		else if (it->modelPart() != nullptr) {
 			result << it->modelPart();
 		}
 	}
@@ -438,7 +456,7 @@ void PartsBinIconView::reloadPart(const QString & moduleID) {
         if (it == nullptr) 
             continue;
 
-		if (it->itemBase()->moduleID().compare(moduleID) != 0) continue;
+		if (it->moduleID().compare(moduleID) != 0) continue;
 
 		ItemBase::PluralType plural;
 		ItemBase * itemBase = loadItemBase(moduleID, plural);
@@ -472,3 +490,25 @@ ItemBase * PartsBinIconView::loadItemBase(const QString & moduleID, ItemBase::Pl
 
 	return itemBase;
 }
+
+void PartsBinIconView::materialize(SvgIconWidget * icon) {
+	if (icon == nullptr || !icon->needsItemBase()) return;
+
+	ItemBase::PluralType plural;
+	ItemBase * itemBase = loadItemBase(icon->moduleID(), plural);
+	icon->setItemBase(itemBase, plural == ItemBase::Plural);
+}
+
+void PartsBinIconView::itemBaseWanted(SvgIconWidget * icon) {
+	// called from the icon's paint, so the set up waits for the event loop
+	m_wanted.append(icon);
+	m_materializeTimer.start();
+}
+
+void PartsBinIconView::materializeWanted() {
+	QList< QPointer<SvgIconWidget> > wanted = m_wanted;
+	m_wanted.clear();
+	Q_FOREACH (QPointer<SvgIconWidget> icon, wanted) {
+		materialize(icon);
+	}
+}
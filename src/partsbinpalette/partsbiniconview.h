@@ -24,6 +24,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QFrame>
 #include <QGraphicsView>
+#include <QPointer>
+#include <QTimer>
 
 #include "partsbinview.h"
 #include "../sketch/infographicsview.h"
@@ -81,6 +83,7 @@ protected:
 	SvgIconWidget * svgIconWidgetAt(const QPoint & pos);
 	SvgIconWidget * svgIconWidgetAt(int x, int y);
 	ItemBase * loadItemBase(const QString & moduleID, ItemBase::PluralType &);
+	void materialize(SvgIconWidget *);
 
 public Q_SLOTS:
 	void setSelected(int position, bool doEmit=false);
@@ -89,6 +92,8 @@ public Q_SLOTS:
 
 protected Q_SLOTS:
 	void showContextMenu(const QPoint& pos);
+	void itemBaseWanted(SvgIconWidget *);
+	void materializeWanted();
 
 Q_SIGNALS:
 	void informItemMoved(int fromIndex, int toIndex);
@@ -103,6 +108,9 @@ protected:
 
 	QMenu *m_itemMenu = nullptr;
 	bool m_noSelectionChangeEmition = false;
+
+	QList< QPointer<SvgIconWidget> > m_wanted;     // painted, but still without an ItemBase
+	QTimer m_materializeTimer;
 };
 
 #endif /* ICONVIEW_H_ */
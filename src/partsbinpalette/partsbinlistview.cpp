@@ -21,6 +21,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QMenu>
 #include <QMimeData>
+#include <QScrollBar>
 
 #include "../infoview/htmlinfoview.h"
 #include "../items/itembase.h"
@@ -28,13 +29,16 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../itemdrag.h"
 #include "../items/partfactory.h"
 #include "../layerattributes.h"
+#include "../debugdialog.h"
 #include "partsbinpalettewidget.h"
+#include "iconcache.h"
 
 #include "partsbinlistview.h"
 #include "partsbiniconview.h"
 
 static const QColor SectionHeaderBackgroundColor(128, 128, 128);
 static const QColor SectionHeaderForegroundColor(32, 32, 32);
+static const int ModuleIDRole = Qt::UserRole + 2;
 
 PartsBinListView::PartsBinListView(ReferenceModel* referenceModel, PartsBinPaletteWidget *parent)
 	: QListWidget((QWidget *) parent), PartsBinView(referenceModel, parent)
@@ -46,6 +50,17 @@ PartsBinListView::PartsBinListView(ReferenceModel* referenceModel, PartsBinPalet
 	setSpacing(2);
 	setIconSize(QSize(16,16));
 	setSortingEnabled(false);
+	setUniformItemSizes(true);
+
+	// a row's ItemBase and icon are set up when it first scrolls into view
+	QPixmap blank(iconSize());
+	blank.fill(Qt::transparent);
+	m_blankIcon = QIcon(blank);
+	m_loadTimer.setSingleShot(true);
+	m_loadTimer.setInterval(0);
+	connect(&m_loadTimer, SIGNAL(timeout()), this, SLOT(loadVisibleImages()));
+	connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(loadVisibleImagesLater()));
+	connect(verticalScrollBar(), SIGNAL(rangeChanged(int, int)), this, SLOT(loadVisibleImagesLater()));
 
 	setDragEnabled(true);
 	viewport()->setAcceptDrops(true);
@@ -65,6 +80,7 @@ PartsBinListView::~PartsBinListView() {
 
 void PartsBinListView::doClear() {
 	m_hoverItem = nullptr;
+	m_pendingIcons.clear();
 	PartsBinView::doClear();
 	clear();
 }
@@ -91,7 +107,10 @@ int PartsBinListView::setItemAux(ModelPart * modelPart, int position) {
 		lwi->setText("        " + TranslatedCategoryNames.value(modelPart->instanceText(), modelPart->instanceText()));
 	}
 	else {
-		loadImage(modelPart, lwi, moduleID);
+		lwi->setData(ModuleIDRole, moduleID);
+		lwi->setIcon(m_blankIcon);
+		m_itemBaseHash.insert(moduleID, nullptr);
+		loadVisibleImagesLater();
 	}
 
 	if(position > -1 && position < count()) {
@@ -138,7 +157,7 @@ void PartsBinListView::showInfo(QListWidgetItem * item) {
 
 	m_hoverItem = item;
 	if (m_infoView != nullptr) {
-		ItemBase * itemBase = itemItemBase(item);
+		ItemBase * itemBase = loadedItemBase(item);
 		if (itemBase != nullptr) {
 			m_infoView->hoverEnterItem(nullptr, nullptr, itemBase, swappingEnabled());
 		}
@@ -158,7 +177,7 @@ void PartsBinListView::mousePressEvent(QMouseEvent *event) {
 	}
 
 	showInfo(current);
-	if (m_infoView != nullptr) m_infoView->viewItemInfo(nullptr, itemItemBase(current), false);
+	if (m_infoView != nullptr) m_infoView->viewItemInfo(nullptr, loadedItemBase(current), false);
 }
 
 void PartsBinListView::setInfoView(HtmlInfoView * infoView) {
@@ -176,6 +195,7 @@ void PartsBinListView::removePart(const QString &moduleID) {
 
 void PartsBinListView::removeParts() {
 	m_hoverItem = nullptr;
+	m_pendingIcons.clear();
 	m_itemBaseHash.clear();
 	while (count() > 0) {
 		delete takeItem(0);
@@ -195,9 +215,29 @@ ItemBase * PartsBinListView::itemItemBase(const QListWidgetItem *item) const {
 	return item->data(Qt::UserRole).value<ItemBase *>();
 }
 
+ItemBase * PartsBinListView::loadedItemBase(QListWidgetItem *item) {
+	ItemBase * itemBase = itemItemBase(item);
+	if (itemBase != nullptr) return itemBase;
+
+	QString moduleID = item->data(ModuleIDRole).toString();
+	if (moduleID.isEmpty()) return nullptr;
+
+	ModelPart * modelPart = m_referenceModel->retrieveModelPart(moduleID);
+	if (modelPart == nullptr) return nullptr;
+
+	loadImage(modelPart, item, moduleID);
+	return itemItemBase(item);
+}
+
 ModelPart *PartsBinListView::itemModelPart(const QListWidgetItem *item) const {
 	ItemBase * itemBase = itemItemBase(item);
-	if (itemBase == nullptr) return nullptr;
+	if (itemBase == nullptr) {
+		// not scrolled into view yet
+		QString moduleID = item->data(ModuleIDRole).toString();
+		if (moduleID.isEmpty()) return nullptr;
+
+		return m_referenceModel->retrieveModelPart(moduleID);
+	}
 
 	return itemBase->modelPart();
 }
@@ -214,7 +254,7 @@ const QString &PartsBinListView::itemModuleID(const QListWidgetItem *item) {
 
 ItemBase *PartsBinListView::selectedItemBase() {
 	if(selectedItems().size()==1) {
-		return itemItemBase(selectedItems()[0]);
+		return loadedItemBase(selectedItems()[0]);
 	}
 	return nullptr;
 }
@@ -253,6 +293,11 @@ void PartsBinListView::startDrag(Qt::DropActions supportedActions) {
 	ItemDrag::dragIsDone();
 }
 
+void PartsBinListView::resizeEvent(QResizeEvent * event) {
+	QListWidget::resizeEvent(event);
+	loadVisibleImagesLater();
+}
+
 void PartsBinListView::moveItem(int fromIndex, int toIndex) {
 	itemMoved(fromIndex,toIndex);
 	Q_EMIT informItemMoved(fromIndex, toIndex);
@@ -360,19 +405,27 @@ void PartsBinListView::reloadPart(const QString & moduleID) {
 
 	for(int i = 0; i < count(); i++) {
 		QListWidgetItem * lwi = item(i);
-		ItemBase * itemBase = itemItemBase(lwi);
-		if (itemBase == nullptr) continue;
+		if (lwi->data(ModuleIDRole).toString().compare(moduleID) != 0) continue;
 
-		if (itemBase->moduleID().compare(moduleID) == 0) {
-			lwi->setText(itemBase->title());
-			loadImage(itemBase->modelPart(), lwi, moduleID);
+		ItemBase * itemBase = itemItemBase(lwi);
+		if (itemBase == nullptr) {
+			// not loaded yet: it picks up the new part when it is
+			ModelPart * modelPart = m_referenceModel->retrieveModelPart(moduleID);
+			if (modelPart != nullptr) lwi->setText(modelPart->title());
 			return;
 		}
+
+		lwi->setText(itemBase->title());
+		loadImage(itemBase->modelPart(), lwi, moduleID);
+		return;
 	}
 }
 
 void PartsBinListView::loadImage(ModelPart * modelPart, QListWidgetItem * lwi, const QString & moduleID)
 {
+	// a cached icon is used as is; otherwise a newly loaded svg is rendered on the thread pool
+	// while the row keeps its blank icon
+	QByteArray loaded;
 	ItemBase * itemBase = ItemBaseHash.value(moduleID);
 	if (itemBase == nullptr) {
 		itemBase = PartFactory::createPart(modelPart, ViewLayer::NewTop, ViewLayer::IconView, ViewGeometry(), ItemBase::getNextID(), nullptr, nullptr, false);
@@ -385,15 +438,67 @@ void PartsBinListView::loadImage(ModelPart * modelPart, QListWidgetItem * lwi, c
 				itemBase->setFilename(renderer->filename());
 			}
 			itemBase->setSharedRendererEx(renderer);
+			loaded = layerAttributes.loaded();
 		}
 	}
 	lwi->setData(Qt::UserRole, QVariant::fromValue( itemBase ) );
+	m_itemBaseHash.insert(moduleID, itemBase);
+
+	FSvgRenderer * renderer = itemBase->renderer();
+	if (renderer == nullptr) {
+		DebugDialog::debug(QString("missing renderer for list icon %1").arg(moduleID));
+		return;
+	}
+
+	lwi->setData(Qt::UserRole + 1, renderer->defaultSize());
 	QSize size(PartsBinIconView::PARTSBIN_ICON_IMG_WIDTH,
 			   PartsBinIconView::PARTSBIN_ICON_IMG_HEIGHT);
-	QPixmap * pixmap = FSvgRenderer::getPixmap(itemBase->renderer(), size);
+	QByteArray key = IconCache::makeKey(moduleID, renderer->filename(), size, 1);
+	QImage icon;
+	if (!key.isEmpty() && IconCache::instance()->find(key, icon)) {
+		lwi->setIcon(QIcon(QPixmap::fromImage(icon)));
+		return;
+	}
+
+	if (!key.isEmpty() && !loaded.isEmpty()) {
+		m_pendingIcons.insert(key, moduleID);
+		connect(IconCache::instance(), SIGNAL(rendered(const QByteArray &, const QImage &)),
+		        this, SLOT(iconRendered(const QByteArray &, const QImage &)), Qt::UniqueConnection);
+		IconCache::instance()->render(key, loaded, renderer->defaultSizeF(), size, 1);
+		return;
+	}
+
+	QPixmap * pixmap = FSvgRenderer::getPixmap(renderer, size);
 	lwi->setIcon(QIcon(*pixmap));
 	delete pixmap;
-	lwi->setData(Qt::UserRole + 1, itemBase->renderer()->defaultSize());
+}
 
-	m_itemBaseHash.insert(moduleID, itemBase);
+void PartsBinListView::loadVisibleImagesLater() {
+	m_loadTimer.start();
+}
+
+void PartsBinListView::loadVisibleImages() {
+	QRect visible = viewport()->rect();
+	QListWidgetItem * top = itemAt(visible.left() + spacing() + 1, visible.top() + spacing());
+	for (int i = (top == nullptr) ? 0 : row(top); i < count(); i++) {
+		QListWidgetItem * lwi = item(i);
+		QRect r = visualItemRect(lwi);
+		if (r.top() > visible.bottom()) break;
+		if (r.bottom() < visible.top()) continue;
+
+		if (itemItemBase(lwi) == nullptr) {
+			loadedItemBase(lwi);
+		}
+	}
+}
+
+void PartsBinListView::iconRendered(const QByteArray & key, const QImage & image)
+{
+	QString moduleID = m_pendingIcons.take(key);
+	if (moduleID.isEmpty() || image.isNull()) return;
+
+	int row = position(moduleID);
+	if (row < 0) return;
+
+	item(row)->setIcon(QIcon(QPixmap::fromImage(image)));
 }
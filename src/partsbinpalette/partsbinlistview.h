@@ -24,6 +24,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QListWidget>
 #include <QMouseEvent>
+#include <QTimer>
 
 #include "partsbinview.h"
 
@@ -51,6 +52,9 @@ public Q_SLOTS:
 
 protected Q_SLOTS:
 	void showContextMenu(const QPoint& pos);
+	void loadVisibleImages();
+	void loadVisibleImagesLater();
+	void iconRendered(const QByteArray & key, const QImage &);
 
 Q_SIGNALS:
 	void informItemMoved(int fromIndex, int toIndex);
@@ -66,11 +70,13 @@ protected:
 	//void dragEnterEvent(QDragEnterEvent* event);
 	void dropEvent(QDropEvent* event);
 	void startDrag(Qt::DropActions supportedActions);
+	void resizeEvent(QResizeEvent * event);
 
 	int setItemAux(ModelPart * modelPart, int position = -1);
 
 	ModelPart *itemModelPart(const QListWidgetItem *item) const;
 	ItemBase *itemItemBase(const QListWidgetItem *item) const;
+	ItemBase *loadedItemBase(QListWidgetItem *item);
 	const QString& itemModuleID(const QListWidgetItem *item);
 
 	void showInfo(QListWidgetItem * item);
@@ -84,5 +90,9 @@ protected:
 	class HtmlInfoView * m_infoView;
 	QListWidgetItem * m_hoverItem;
 
+	QTimer m_loadTimer;
+	QIcon m_blankIcon;                          // for rows not yet scrolled into view
+	QHash<QByteArray, QString> m_pendingIcons;  // icon cache key to module id
+
 };
 #endif /* LISTVIEW_H_ */
@@ -29,6 +29,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QColorDialog>
 #include <QBuffer>
 #include <QSvgGenerator>
+#include <QDateTime>
+#include <QFuture>
+#include <QtConcurrentRun>
 
 #include "partsbinpalettewidget.h"
 #include "partsbiniconview.h"
@@ -52,6 +55,15 @@ inline bool isCustomSvg(const QString & string) {
 
 static QHash<QString, PaletteModel *> PaletteBinModels;
 
+struct PreparsedBin {
+	QDateTime modified;                 // of the file when the parse started
+	QFuture<QDomDocument> document;
+};
+
+// bins fast loaded at startup get their xml parsed on the thread pool meanwhile,
+// so opening their tab later only has to build the model parts
+static QHash<QString, PreparsedBin> PreparsedBins;
+
 static QIcon EmptyIcon;
 
 //////////////////////////////////////////////
@@ -62,6 +74,7 @@ PartsBinPaletteWidget::PartsBinPaletteWidget(ReferenceModel *referenceModel, Htm
 	m_binLabel = nullptr;
 	m_monoIcon = m_icon = nullptr;
 	m_searchLineEdit = nullptr;
+	m_moreButton = nullptr;
 	m_saveQuietly = false;
 	m_fastLoaded = false;
 	m_model = nullptr;
@@ -148,6 +161,11 @@ PartsBinPaletteWidget::~PartsBinPaletteWidget() {
 }
 
 void PartsBinPaletteWidget::cleanup() {
+	Q_FOREACH (PreparsedBin preparsed, PreparsedBins) {
+		preparsed.document.waitForFinished();
+	}
+	PreparsedBins.clear();
+
 	Q_FOREACH (PaletteModel * paletteModel, PaletteBinModels) {
 		delete paletteModel;
 	}
@@ -196,6 +214,14 @@ void PartsBinPaletteWidget::setupHeader()
 	m_searchStackedWidget->addWidget(m_binLabel);
 	m_searchStackedWidget->addWidget(m_searchLineEdit);
 
+	// only shown in the search bin, while results are left to page in
+	m_moreButton = new QToolButton(this);
+	m_moreButton->setObjectName("partsBinMoreButton");
+	m_moreButton->setVisible(false);
+	connect(m_moreButton, &QToolButton::clicked, this, [this]() {
+		m_manager->searchMore();
+	});
+
 	m_header = new QFrame(this);
 	m_header->setObjectName("partsBinHeader");
 	auto * hbl = new QHBoxLayout();
@@ -203,6 +229,7 @@ void PartsBinPaletteWidget::setupHeader()
 	hbl->setContentsMargins(0, 0, 0, 0);
 
 	hbl->addWidget(m_searchStackedWidget);
+	hbl->addWidget(m_moreButton);
 	hbl->addWidget(m_combinedBinMenuButton);
 
 	m_header->setLayout(hbl);
@@ -377,6 +404,15 @@ void PartsBinPaletteWidget::addPart(ModelPart *modelPart, int position) {
 	}
 }
 
+void PartsBinPaletteWidget::addParts(const QList<ModelPart *> & modelParts) {
+	// the views are repainted once after the whole batch
+	setUpdatesEnabled(false);
+	Q_FOREACH (ModelPart * modelPart, modelParts) {
+		addPart(modelPart);
+	}
+	setUpdatesEnabled(true);
+}
+
 QToolButton* PartsBinPaletteWidget::newToolButton(const QString& btnObjName, const QString& imgPath, const QString &text) {
 	auto *toolBtn = new QToolButton(this);
 	toolBtn->setObjectName(btnObjName);
@@ -493,6 +529,12 @@ void PartsBinPaletteWidget::load(const QString &filename, QWidget * progressTarg
 			m_fileName = filename;
 			grabTitle(binName, iconName);
 			m_fastLoaded = true;
+			if (!PaletteBinModels.contains(filename) && !PreparsedBins.contains(filename)) {
+				PreparsedBin preparsed;
+				preparsed.modified = QFileInfo(filename).lastModified();
+				preparsed.document = QtConcurrent::run(&ModelBase::parseFile, filename);
+				PreparsedBins.insert(filename, preparsed);
+			}
 		}
 		return;
 	}
@@ -524,7 +566,17 @@ void PartsBinPaletteWidget::load(const QString &filename, QWidget * progressTarg
 			connect(m_listView, SIGNAL(settingItem()), progressTarget, SLOT(settingItemSlot()));
 		}
 		DebugDialog::debug(QString("loading bin '%1'").arg(name));
-		bool result = paletteBinModel->loadFromFile(filename, m_referenceModel, false);
+		QDomDocument domDocument;
+		if (PreparsedBins.contains(filename)) {
+			PreparsedBin preparsed = PreparsedBins.take(filename);
+			domDocument = preparsed.document.result();
+			if (preparsed.modified != QFileInfo(filename).lastModified()) {
+				domDocument = QDomDocument();
+			}
+		}
+		bool result = domDocument.isNull()
+		              ? paletteBinModel->loadFromFile(filename, m_referenceModel, false)
+		              : paletteBinModel->loadFromDocument(filename, domDocument, m_referenceModel, false);
 		//DebugDialog::debug(QString("done loading bin '%1'").arg(name));
 
 		if (!result) {
@@ -792,6 +844,14 @@ void PartsBinPaletteWidget::search(const QString& searchText) {
 	m_manager->search(searchText);
 }
 
+void PartsBinPaletteWidget::setMoreSearchResults(int count) {
+	if (m_moreButton == nullptr) return;
+
+	m_moreButton->setText(tr("%n more", "", count));
+	m_moreButton->setToolTip(tr("Show the next page of search results"));
+	m_moreButton->setVisible(count > 0);
+}
+
 bool PartsBinPaletteWidget::allowsChanges() {
 	return m_allowsChanges;
 }
@@ -49,6 +49,7 @@ public:
 	void setPaletteModel(PaletteModel *model, bool clear = false);
 
 	void addPart(ModelPart *modelPart, int position = -1);
+	void addParts(const QList<ModelPart *> & modelParts);
 
 	bool currentBinIsCore();
 	bool beforeClosing();
@@ -78,6 +79,7 @@ public:
 	void setAllowsChanges(bool);
 	void setReadOnly(bool);
 	void focusSearch();
+	void setMoreSearchResults(int count);
 	void setSaveQuietly(bool);
 	bool open(QString fileName, QWidget * progressTarget, bool fastLoad);
 
@@ -163,6 +165,7 @@ protected:
 	QLabel * m_binLabel;
 
 	class SearchLineEdit * m_searchLineEdit;
+	QToolButton * m_moreButton;
 
 	QToolButton * m_combinedBinMenuButton;
 
@@ -23,7 +23,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 SearchLineEdit::SearchLineEdit(QWidget * parent) : QLineEdit(parent)
 {
 	mTimer.setSingleShot(true);
-	mTimer.setInterval(2000);
+	// short enough to refine the results as the user types; each refinement only filters the last results
+	mTimer.setInterval(400);
 
 	connect(&mTimer, &QTimer::timeout,
 			this, [=]() {
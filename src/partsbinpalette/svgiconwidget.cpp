@@ -20,6 +20,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QPixmap>
 #include <QPainter>
+#include <QGuiApplication>
 
 #include "svgiconwidget.h"
 #include "../sketch/infographicsview.h"
@@ -27,8 +28,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../fsvgrenderer.h"
 #include "../items/moduleidnames.h"
 #include "../layerattributes.h"
+#include "../items/partfactory.h"
 
 #include "partsbinview.h"
+#include "iconcache.h"
 
 #define SELECTED_STYLE "background-color: white;"
 #define NON_SELECTED_STYLE "background-color: #C2C2C2;"
@@ -104,7 +107,9 @@ SvgIconWidget::SvgIconWidget(ModelPart * modelPart, ViewLayer::ViewID viewID, It
 		this->setMaximumSize(PluralImage->size());
 		setAcceptHoverEvents(true);
 		setFlags(QGraphicsItem::ItemIsSelectable);
-		setupImage(plural, viewID);
+		if (m_itemBase != nullptr) {
+			setupImage(plural, viewID);
+		}
 	}
 }
 
@@ -130,12 +135,20 @@ void SvgIconWidget::cleanup() {
 		delete SingularImage;
 		SingularImage = nullptr;
 	}
+	IconCache::cleanup();
 }
 
 ItemBase *SvgIconWidget::itemBase() const noexcept {
 	return m_itemBase;
 }
 
+bool SvgIconWidget::needsItemBase() const {
+	// a part's widget may be made without its ItemBase; the view supplies one once the widget is painted
+	if (m_moduleId.compare(ModuleIDNames::SpacerModuleIDName) == 0) return false;
+
+	return m_itemBase == nullptr;
+}
+
 ModelPart *SvgIconWidget::modelPart() const noexcept {
 	if (m_itemBase != nullptr) return m_itemBase->modelPart();
 	return nullptr;
@@ -145,7 +158,7 @@ ModelPart *SvgIconWidget::modelPart() const noexcept {
 void SvgIconWidget::hoverEnterEvent ( QGraphicsSceneHoverEvent * event ) {
 	QGraphicsWidget::hoverEnterEvent(event);
 	InfoGraphicsView * igv = InfoGraphicsView::getInfoGraphicsView(this);
-	if (igv != nullptr) {
+	if (igv != nullptr && m_itemBase != nullptr) {
 		igv->hoverEnterItem(event, m_itemBase);
 	}
 }
@@ -153,7 +166,7 @@ void SvgIconWidget::hoverEnterEvent ( QGraphicsSceneHoverEvent * event ) {
 void SvgIconWidget::hoverLeaveEvent ( QGraphicsSceneHoverEvent * event ) {
 	QGraphicsWidget::hoverLeaveEvent(event);
 	InfoGraphicsView * igv = InfoGraphicsView::getInfoGraphicsView(this);
-	if (igv != nullptr) {
+	if (igv != nullptr && m_itemBase != nullptr) {
 		igv->hoverLeaveItem(event, m_itemBase);
 	}
 }
@@ -182,20 +195,55 @@ void SvgIconWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *opt
 		return;
 	}
 
+	if (m_pixmapItem == nullptr) {
+		// the blank tile until the icon is set up; only widgets the view actually paints ask for theirs
+		painter->fillRect(QRectF(QPointF(0, 0), SingularImage->size()), QColorConstants::White);
+		if (needsItemBase() && !m_itemBaseWanted) {
+			m_itemBaseWanted = true;
+			Q_EMIT itemBaseWanted(this);
+		}
+	}
+
 	QGraphicsWidget::paint(painter, option, widget);
 }
 
 void SvgIconWidget::setItemBase(ItemBase * itemBase, bool plural)
 {
 	m_itemBase = itemBase;
+	m_itemBaseWanted = false;
 	setupImage(plural, itemBase->viewID());
 }
 
 void SvgIconWidget::setupImage(bool plural, ViewLayer::ViewID viewID)
 {
+	// a cached icon needs no svg parsing or rendering at all; otherwise the svg is loaded here as before,
+	// and rendered on the thread pool while a blank placeholder shows
+	m_plural = plural;
+	m_iconKey.clear();
 	LayerAttributes layerAttributes;
 	m_itemBase->initLayerAttributes(layerAttributes, viewID, ViewLayer::Icon, ViewLayer::NewTop, false, false);
 	ModelPart * modelPart = m_itemBase->modelPart();
+
+	QSize size(ICON_SIZE, ICON_SIZE);
+	qreal scale = qApp->devicePixelRatio();
+	QString svgFilename;
+	QByteArray key;
+	if (modelPart != nullptr && modelPart->modelPartShared() != nullptr) {
+		QString imageFilename = modelPart->modelPartShared()->imageFileName(layerAttributes.viewID, layerAttributes.viewLayerID);
+		svgFilename = PartFactory::getSvgFilename(modelPart, imageFilename, true, true);
+		if (!svgFilename.isEmpty()) {
+			key = IconCache::makeKey(modelPart->moduleID(), svgFilename, size, scale);
+		}
+	}
+
+	QImage icon;
+	if (!key.isEmpty() && IconCache::instance()->find(key, icon)) {
+		m_itemBase->setFilename(svgFilename);
+		icon.setDevicePixelRatio(scale);
+		setPixmap(iconPixmap(icon));
+		return;
+	}
+
 	FSvgRenderer * renderer = nullptr;
 	if (modelPart != nullptr) {
 			renderer = m_itemBase->setUpImage(modelPart, layerAttributes);
@@ -212,30 +260,67 @@ void SvgIconWidget::setupImage(bool plural, ViewLayer::ViewID viewID)
 		m_itemBase->setFilename(renderer->filename());
 	}
 
-	QPixmap pixmap(plural ? *PluralImage : *SingularImage);
-	QPixmap * icon = (renderer == nullptr) ? nullptr : FSvgRenderer::getPixmap(renderer, QSize(ICON_SIZE, ICON_SIZE));
-	if (icon != nullptr) {
+	if (renderer != nullptr && !key.isEmpty() && !layerAttributes.loaded().isEmpty()) {
+		m_iconKey = key;
+		connect(IconCache::instance(), SIGNAL(rendered(const QByteArray &, const QImage &)),
+		        this, SLOT(iconRendered(const QByteArray &, const QImage &)), Qt::UniqueConnection);
+		IconCache::instance()->render(key, layerAttributes.loaded(), renderer->defaultSizeF(), size, scale);
+		setPixmap(iconPixmap(QImage()));
+	}
+	else {
+		QPixmap * pixmap = (renderer == nullptr) ? nullptr : FSvgRenderer::getPixmap(renderer, size);
+		setPixmap(iconPixmap(pixmap == nullptr ? QImage() : pixmap->toImage()));
+		delete pixmap;
+	}
+
+	if (renderer != nullptr) {
+		m_itemBase->setSharedRendererEx(renderer);
+	}
+}
+
+QPixmap SvgIconWidget::iconPixmap(const QImage & icon) const
+{
+	// the icon over the white tile, at the icon's own device scale
+	qreal scale = icon.isNull() ? 1 : icon.devicePixelRatio();
+	QPixmap pixmap((m_plural ? PluralImage : SingularImage)->size() * scale);
+	pixmap.setDevicePixelRatio(scale);
+	pixmap.fill(QColorConstants::White);
+	if (!icon.isNull()) {
+		int offset = m_plural ? PLURAL_OFFSET : SINGULAR_OFFSET;
 		QPainter painter;
 		painter.begin(&pixmap);
-		if (plural) {
-			painter.drawPixmap(PLURAL_OFFSET, PLURAL_OFFSET, *icon);
-		}
-		else {
-			painter.drawPixmap(SINGULAR_OFFSET, SINGULAR_OFFSET, *icon);
-		}
+		painter.drawImage(QRectF(offset, offset, ICON_SIZE, ICON_SIZE), icon);
 		painter.end();
-		delete icon;
 	}
+	return pixmap;
+}
 
-    /// @todo make sure this doesn't leak if this function is called multiple times on the same object.
-	m_pixmapItem = new SvgIconPixmapItem(pixmap, this, plural);
+void SvgIconWidget::setPixmap(const QPixmap & pixmap)
+{
+	if (m_pixmapItem == nullptr) {
+		m_pixmapItem = new SvgIconPixmapItem(pixmap, this, m_plural);
+	}
+	else {
+		m_pixmapItem->setPixmap(pixmap);
+		m_pixmapItem->setPlural(m_plural);
+	}
 
 	if (m_itemBase != nullptr) {
 		m_itemBase->setTooltip();
 		setToolTip(m_itemBase->toolTip());
 	}
+}
 
-	if (renderer != nullptr) {
-		m_itemBase->setSharedRendererEx(renderer);
-	}
+void SvgIconWidget::iconRendered(const QByteArray & key, const QImage & image)
+{
+	if (key != m_iconKey) return;
+
+	m_iconKey.clear();
+	disconnect(IconCache::instance(), SIGNAL(rendered(const QByteArray &, const QImage &)),
+	           this, SLOT(iconRendered(const QByteArray &, const QImage &)));
+	if (image.isNull()) return;
+
+	QImage icon(image);
+	icon.setDevicePixelRatio(qApp->devicePixelRatio());
+	setPixmap(iconPixmap(icon));
 }
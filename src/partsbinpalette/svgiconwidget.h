@@ -42,6 +42,7 @@ public:
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 protected:
 	bool m_plural = false;
+	bool m_itemBaseWanted = false;      // asked for once its first paint shows it is on screen
 };
 
 class SvgIconWidget : public QGraphicsWidget
@@ -54,6 +55,7 @@ public:
 	ModelPart * modelPart() const noexcept;
 	constexpr const QString &moduleID() const noexcept { return m_moduleId; }
 	void setItemBase(ItemBase *, bool plural);
+	bool needsItemBase() const;
 
 	static void initNames();
 	static void cleanup();
@@ -63,11 +65,22 @@ protected:
 	void hoverLeaveEvent ( QGraphicsSceneHoverEvent * event );
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 	void setupImage(bool plural, ViewLayer::ViewID viewID);
+	QPixmap iconPixmap(const QImage & icon) const;
+	void setPixmap(const QPixmap &);
+
+protected Q_SLOTS:
+	void iconRendered(const QByteArray & key, const QImage &);
+
+Q_SIGNALS:
+	void itemBaseWanted(SvgIconWidget *);
 
 protected:
 	QPointer<ItemBase> m_itemBase;
 	SvgIconPixmapItem * m_pixmapItem = nullptr;
 	QString m_moduleId;
+	QByteArray m_iconKey;               // while waiting on the icon cache
+	bool m_plural = false;
+	bool m_itemBaseWanted = false;      // asked for once its first paint shows it is on screen
 };
 
 
@@ -26,6 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMessageBox>
 #include <QMutexLocker>
 #include <QApplication>
+#include <QScrollBar>
 
 #include "peconnectorsview.h"
 #include "peutils.h"
@@ -34,6 +35,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 //////////////////////////////////////
 
+static constexpr int RowsBuiltAhead = 5;			// beyond the visible rows, so scrolling a little doesn't show blanks
+static constexpr int RowsKept = 60;					// built rows further than this from the visible ones are let go
+
 PEConnectorsView::PEConnectorsView(QWidget * parent) : QFrame(parent)
 {
 	m_connectorCount = 0;
@@ -119,14 +123,19 @@ PEConnectorsView::PEConnectorsView(QWidget * parent) : QFrame(parent)
 	smdFrame->setLayout(smdLayout);
 	mainLayout->addWidget(smdFrame);
 
-	m_scrollArea = new QScrollArea;
-	m_scrollArea->setWidgetResizable(true);
-	m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+	m_list = new QListWidget;
+	m_list->setObjectName("NewPartsEditorConnectors");
+	m_list->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+	m_list->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+	m_list->setSelectionMode(QAbstractItemView::NoSelection);
+	m_list->setUniformItemSizes(true);
+	connect(m_list->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(schedulePopulate()));
 
-	m_scrollFrame = new QFrame;
-	m_scrollArea->setWidget(m_scrollFrame);
+	m_populateTimer.setSingleShot(true);
+	m_populateTimer.setInterval(0);
+	connect(&m_populateTimer, SIGNAL(timeout()), this, SLOT(populateVisibleRows()));
 
-	mainLayout->addWidget(m_scrollArea);
+	mainLayout->addWidget(m_list);
 	this->setLayout(mainLayout);
 
 }
@@ -138,36 +147,78 @@ PEConnectorsView::~PEConnectorsView() {
 void PEConnectorsView::initConnectors(QList<QDomElement> * connectorList)
 {
 	QWidget * widget = QApplication::focusWidget();
-	if (widget) {
-		QList<QWidget *> children = m_scrollFrame->findChildren<QWidget *>();
-		if (children.contains(widget)) {
-			widget->blockSignals(true);
-		}
+	if (widget && m_list->isAncestorOf(widget)) {
+		widget->blockSignals(true);
 	}
 
-	if (m_scrollFrame) {
-		m_scrollArea->setWidget(nullptr);
-		delete m_scrollFrame;
-		m_scrollFrame = nullptr;
-	}
+	m_list->clear();
+	m_connectors = *connectorList;
 
 	m_connectorCount = connectorList->size();
 	m_numberEdit->setText(QString::number(m_connectorCount));
+	if (m_connectors.isEmpty()) return;
+
+	// every form has the same layout, so the first one gives the height of all the rows
+	QWidget * first = PEUtils::makeConnectorForm(m_connectors.first(), 0, this, true);
+	QSize rowSize(1, first->sizeHint().height());
+	for (int ix = 0; ix < m_connectors.count(); ix++) {
+		auto * item = new QListWidgetItem(m_list);
+		item->setFlags(Qt::NoItemFlags);
+		item->setSizeHint(rowSize);
+	}
+	if (m_rowEventFilter != nullptr) {
+		Q_FOREACH (QLineEdit * lineEdit, first->findChildren<QLineEdit *>()) lineEdit->installEventFilter(m_rowEventFilter);
+	}
+	m_list->setItemWidget(m_list->item(0), first);
 
-	m_scrollFrame = new QFrame(this);
-	m_scrollFrame->setObjectName("NewPartsEditorConnectors");
-	auto *scrollLayout = new QVBoxLayout();
+	populateVisibleRows();
+}
 
-	int ix = 0;
-	Q_FOREACH (QDomElement connector, *connectorList) {
-		QWidget * widget = PEUtils::makeConnectorForm(connector, ix++, this, true);
-		scrollLayout->addWidget(widget);
-	}
+void PEConnectorsView::schedulePopulate() {
+	m_populateTimer.start();
+}
 
-	scrollLayout->addSpacerItem(new QSpacerItem(1, 1, QSizePolicy::Minimum, QSizePolicy::Expanding));
-	m_scrollFrame->setLayout(scrollLayout);
+void PEConnectorsView::resizeEvent(QResizeEvent * event) {
+	QFrame::resizeEvent(event);
+	schedulePopulate();
+}
+
+void PEConnectorsView::populateVisibleRows() {
+	// build the forms of the rows in view, and let go of those well out of it; a row holding the focus
+	// is kept, so an edit in progress still gets its editingFinished
+	if (m_list->count() == 0) return;
+
+	QRect viewport = m_list->viewport()->rect();
+	int first = m_list->row(m_list->itemAt(viewport.topLeft()));
+	int last = m_list->row(m_list->itemAt(viewport.bottomLeft()));
+	if (first < 0) first = 0;
+	if (last < 0) last = m_list->count() - 1;
+
+	QWidget * focus = QApplication::focusWidget();
+	for (int ix = 0; ix < m_list->count(); ix++) {
+		QListWidgetItem * item = m_list->item(ix);
+		QWidget * form = m_list->itemWidget(item);
+		if (ix >= first - RowsBuiltAhead && ix <= last + RowsBuiltAhead) {
+			if (form != nullptr) continue;
+
+			form = PEUtils::makeConnectorForm(m_connectors.at(ix), ix, this, true);
+			if (m_rowEventFilter != nullptr) {
+				Q_FOREACH (QLineEdit * lineEdit, form->findChildren<QLineEdit *>()) lineEdit->installEventFilter(m_rowEventFilter);
+			}
+			m_list->setItemWidget(item, form);
+		}
+		else if (form != nullptr && (ix < first - RowsKept || ix > last + RowsKept)) {
+			if (focus != nullptr && form->isAncestorOf(focus)) continue;
+
+			m_list->removeItemWidget(item);
+		}
+	}
+}
 
-	m_scrollArea->setWidget(m_scrollFrame);
+void PEConnectorsView::setRowEventFilter(QObject * filter) {
+	// rows built later get it too
+	m_rowEventFilter = filter;
+	Q_FOREACH (QLineEdit * lineEdit, m_list->findChildren<QLineEdit *>()) lineEdit->installEventFilter(filter);
 }
 
 void PEConnectorsView::nameEntry() {
@@ -212,7 +263,7 @@ void PEConnectorsView::removeConnector() {
 	if (!ok) return;
 
 	ConnectorMetadata cmd;
-	if (!PEUtils::fillInMetadata(senderIndex, m_scrollFrame, cmd)) return;
+	if (!PEUtils::fillInMetadata(senderIndex, m_list, cmd)) return;
 
 	QList<ConnectorMetadata *> cmdList;
 	cmdList.append(&cmd);
@@ -225,7 +276,7 @@ void PEConnectorsView::changeConnector() {
 	if (!ok) return;
 
 	ConnectorMetadata cmd;
-	if (!PEUtils::fillInMetadata(senderIndex, m_scrollFrame, cmd)) return;
+	if (!PEUtils::fillInMetadata(senderIndex, m_list, cmd)) return;
 
 	Q_EMIT connectorMetadataChanged(&cmd);
 }
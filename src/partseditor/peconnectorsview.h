@@ -26,7 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFrame>
 #include <QTimer>
 #include <QLabel>
-#include <QScrollArea>
+#include <QListWidget>
 #include <QGridLayout>
 #include <QFormLayout>
 #include <QVBoxLayout>
@@ -52,6 +52,7 @@ public:
 	void initConnectors(QList<QDomElement> * connectorList);
 	bool anyModified();
 	void setSMD(bool);
+	void setRowEventFilter(QObject *);
 
 Q_SIGNALS:
 	void connectorMetadataChanged(struct ConnectorMetadata *);
@@ -69,13 +70,19 @@ protected Q_SLOTS:
 	void allTypeEntry();
 	void smdEntry();
 	void uncheckRadios();
+	void populateVisibleRows();
+	void schedulePopulate();
 
 protected:
 	void changeConnector();
+	void resizeEvent(QResizeEvent *) override;
 
 protected:
-	QFrame * m_scrollFrame;
-	QScrollArea * m_scrollArea;
+	// one item per connector, but a row's form is only built while the row is on screen or nearly so
+	QListWidget * m_list = nullptr;
+	QList<QDomElement> m_connectors;
+	QTimer m_populateTimer;
+	QObject * m_rowEventFilter = nullptr;
 	QLineEdit * m_numberEdit;
 	int m_connectorCount;
 	QMutex m_mutex;
@@ -207,6 +207,9 @@ constexpr static int RatZ = 6000;
 
 static long FakeGornSiblingNumber = 0;
 
+// elements whose bounds a group can be built from
+static const QStringList BoundsTags = { "g", "rect", "circle", "ellipse", "path", "line", "polyline", "polygon", "text", "image" };
+
 void removeGornAux(QDomElement & element) {
 	bool hasGorn = element.hasAttribute("gorn");
 	bool hasOld = element.hasAttribute("oldid");
@@ -242,6 +245,46 @@ QString removeGorn(QString & svg) {
 	return doc.toString(4);
 }
 
+QList<QDomElement> pegiElements(QDomDocument & svgDocument) {
+	// the elements that get a PEGraphicsItem, depth first
+	QList<QDomElement> elements;
+	QList<QDomElement> traverse;
+	traverse << svgDocument.documentElement();
+	while (traverse.count() > 0) {
+		QDomElement element = traverse.takeFirst();
+
+		// depth first
+		QList<QDomElement> next;
+		QDomElement child = element.firstChildElement();
+		while (!child.isNull()) {
+			next << child;
+			child = child.nextSiblingElement();
+		}
+		while (next.count() > 0) {
+			traverse.push_front(next.takeLast());
+		}
+
+		QString tagName = element.tagName();
+		if      (tagName.compare("rect") == 0);
+		else if (tagName.compare("g") == 0) {
+		}
+		else if (tagName.compare("svg") == 0) {
+		}
+		else if (tagName.compare("circle") == 0);
+		else if (tagName.compare("ellipse") == 0);
+		else if (tagName.compare("path") == 0);
+		else if (tagName.compare("line") == 0);
+		else if (tagName.compare("polyline") == 0);
+		else if (tagName.compare("polygon") == 0);
+		else if (tagName.compare("text") == 0);
+		else continue;
+
+		elements << element;
+	}
+
+	return elements;
+}
+
 bool byID(QDomElement & c1, QDomElement & c2)
 {
 	int c1id = -1;
@@ -1325,8 +1368,6 @@ void PEMainWindow::initSvgTree(SketchWidget * sketchWidget, ItemBase * itemBase,
 		}
 	}
 
-	int z = PegiZ;
-
 	FSvgRenderer tempRenderer;
 	QByteArray rendered = tempRenderer.loadSvg(tempSvgDoc.toByteArray(), "", false);
 	// cleans up the svg
@@ -1336,55 +1377,54 @@ void PEMainWindow::initSvgTree(SketchWidget * sketchWidget, ItemBase * itemBase,
 	}
 
 	TextUtils::gornTree(svgDocument);
-	FSvgRenderer renderer;
-	renderer.loadSvg(svgDocument.toByteArray(), "", false);
+	QByteArray gorned = svgDocument.toByteArray();
 
-	QHash<QString, PEGraphicsItem *> pegiHash;
+	// the overlays are built when the view is first shown; put the ids they would have restored back now,
+	// so the document reads the same either way
+	Q_FOREACH (QDomElement element, pegiElements(svgDocument)) {
+		QString oldid = element.attribute("oldid");
+		if (!oldid.isEmpty()) {
+			element.setAttribute("id", oldid);
+			element.removeAttribute("oldid");
+		}
+	}
 
-	QList<QDomElement> traverse;
-	traverse << svgDocument.documentElement();
-	while (traverse.count() > 0) {
-		QDomElement element = traverse.takeFirst();
+	ViewThing * viewThing = m_viewThings.value(sketchWidget->viewID());
+	viewThing->gornSvg = gorned;
+	viewThing->pegisPending = true;
+}
 
-		// depth first
-		QList<QDomElement> next;
-		QDomElement child = element.firstChildElement();
-		while (!child.isNull()) {
-			next << child;
-			child = child.nextSiblingElement();
-		}
-		while (next.count() > 0) {
-			traverse.push_front(next.takeLast());
-		}
+void PEMainWindow::ensurePegis(SketchWidget * sketchWidget)
+{
+	if (sketchWidget == nullptr) return;
 
-		QString tagName = element.tagName();
-		if      (tagName.compare("rect") == 0);
-		else if (tagName.compare("g") == 0) {
-		}
-		else if (tagName.compare("svg") == 0) {
-		}
-		else if (tagName.compare("circle") == 0);
-		else if (tagName.compare("ellipse") == 0);
-		else if (tagName.compare("path") == 0);
-		else if (tagName.compare("line") == 0);
-		else if (tagName.compare("polyline") == 0);
-		else if (tagName.compare("polygon") == 0);
-		else if (tagName.compare("text") == 0);
-		else continue;
+	ViewThing * viewThing = m_viewThings.value(sketchWidget->viewID(), nullptr);
+	if (viewThing == nullptr || !viewThing->pegisPending) return;
+
+	viewThing->pegisPending = false;
+	QByteArray gorned = viewThing->gornSvg;
+	viewThing->gornSvg.clear();
+	if (viewThing->itemBase == nullptr || viewThing->document == nullptr) return;
 
-		QRectF bounds = getPixelBounds(renderer, element);
+	QList<QDomElement> elements = pegiElements(*viewThing->document);
+	if (viewThing->boundsSvg != gorned) {
+		// a reload that didn't change this view's svg keeps the bounds it had
+		FSvgRenderer renderer;
+		renderer.loadSvg(gorned, "", false);
+		viewThing->localBounds.clear();
+		viewThing->pixelBounds = getPixelBounds(renderer, elements, viewThing->localBounds);
+		viewThing->boundsSvg = gorned;
+	}
+
+	int z = PegiZ;
+	QHash<QString, PEGraphicsItem *> pegiHash;
+	Q_FOREACH (QDomElement element, elements) {
+		// the renderer had the gorned svg, so elements are looked up by gorn rather than by their current id
+		QRectF bounds = viewThing->pixelBounds.value(element.attribute("gorn"));
 		// known Qt bug: boundsOnElement returns zero width and height for text elements.
 		if (bounds.width() > 0 && bounds.height() > 0) {
-			PEGraphicsItem * pegi = makePegi(bounds.size(), bounds.topLeft(), itemBase, element, z++);
+			PEGraphicsItem * pegi = makePegi(bounds.size(), bounds.topLeft(), viewThing->itemBase, element, z++);
 			pegiHash.insert(element.attribute("id"), pegi);
-
-			/*
-			QString string;
-			QTextStream stream(&string);
-			element.save(stream, 0);
-			DebugDialog::debug("........");
-			DebugDialog::debug(string);
-			*/
 		}
 	}
 
@@ -1544,6 +1584,7 @@ void PEMainWindow::loadImage()
 			return;
 		}
 
+		InstalledFonts::registerFonts();
 		QStringList availFonts = InstalledFonts::InstalledFontsList.values();
 		if (availFonts.count() > 0) {
 			QString destFont = availFonts.at(0);
@@ -1752,7 +1793,20 @@ QString PEMainWindow::makeDirName() {
 	return "fritzing_pe_" + m_guid;
 }
 
+void PEMainWindow::writePendingSvgs() {
+	// terminal point and connector moves only touch the dom; write the svg files their fzp points to
+	Q_FOREACH (ViewThing * viewThing, m_viewThings.values()) {
+		if (viewThing->pendingSvgPath.isEmpty() || viewThing->document == nullptr) continue;
+
+		QString svg = TextUtils::svgNSOnly(viewThing->document->toString());
+		writeXml(viewThing->pendingSvgPath, removeGorn(svg), true);
+		viewThing->pendingSvgPath.clear();
+	}
+}
+
 QString PEMainWindow::saveFzp() {
+	writePendingSvgs();
+
 	QDir dir = QDir::temp();
 	QString dirName = makeDirName();
 	dir.mkdir(dirName);
@@ -1808,6 +1862,9 @@ void PEMainWindow::reload(bool firstTime)
 
 	m_metadataView->initMetadata(m_fzpDocument);
 
+	// connector rows are built as they scroll into view, so the filter goes on as they are made
+	m_connectorsView->setRowEventFilter(this);
+
 	QList<QWidget *> widgets;
 	widgets << m_metadataView << m_peToolView << m_connectorsView;
 	Q_FOREACH (QWidget * widget, widgets) {
@@ -2072,10 +2129,9 @@ void PEMainWindow::relocateConnectorSvg(SketchWidget * sketchWidget, const QStri
 		p.setAttribute("terminalId", terminalID);
 	}
 
-	// update svg in case there is a subsequent call to reload
+	// the svg file is written before a subsequent call to reload needs it
 	QString newPath = m_userPartsFolderSvgPath + makeSvgPath2(sketchWidget);
-	QString svg = TextUtils::svgNSOnly(svgDoc->toString());
-	writeXml(newPath, removeGorn(svg), true);
+	viewThing->pendingSvgPath = newPath;
 	setImageAttribute(fzpRoot, newPath, viewID);
 
 	Q_FOREACH (QGraphicsItem * item, sketchWidget->scene()->items()) {
@@ -2499,9 +2555,13 @@ void PEMainWindow::moveTerminalPoint(SketchWidget * sketchWidget, const QString
 			pElement.setAttribute("terminalId", terminalID);
 		}
 
-		FSvgRenderer renderer;
-		renderer.loadSvg(svgDoc->toByteArray(), "", false);
-		QRectF svgBounds = renderer.boundsOnElement(svgID);
+		// moving a terminal or a connector leaves the connector's geometry alone, so the bounds measured for the overlays still hold
+		QRectF svgBounds = viewThing->localBounds.value(svgConnectorElement.attribute("gorn"));
+		if (svgBounds.isNull()) {
+			FSvgRenderer renderer;
+			renderer.loadSvg(svgDoc->toByteArray(), "", false);
+			svgBounds = renderer.boundsOnElement(svgID);
+		}
 		double cx = p.x () * svgBounds.width() / size.width();
 		double cy = p.y() * svgBounds.height() / size.height();
 		double dx = svgBounds.width() / 1000;
@@ -2548,10 +2608,9 @@ void PEMainWindow::moveTerminalPoint(SketchWidget * sketchWidget, const QString
 			}
 		}
 
-		// update svg in case there is a subsequent call to reload
+		// the svg file is written before a subsequent call to reload needs it
 		QString newPath = m_userPartsFolderSvgPath + makeSvgPath2(sketchWidget);
-		QString svg = TextUtils::svgNSOnly(svgDoc->toString());
-		writeXml(newPath, removeGorn(svg), true);
+		viewThing->pendingSvgPath = newPath;
 		setImageAttribute(fzpRoot, newPath, sketchWidget->viewID());
 
 		double invdx = dx * size.width() / svgBounds.width();
@@ -2601,24 +2660,61 @@ PEGraphicsItem * PEMainWindow::makePegi(QSizeF size, QPointF topLeft, ItemBase *
 	return pegiItem;
 }
 
-QRectF PEMainWindow::getPixelBounds(FSvgRenderer & renderer, QDomElement & element)
+QHash<QString, QRectF> PEMainWindow::getPixelBounds(FSvgRenderer & renderer, const QList<QDomElement> & elements, QHash<QString, QRectF> & localBounds)
 {
 	QSizeF defaultSizeF = renderer.defaultSizeF();
 	QRectF viewBox = renderer.viewBoxF();
 
-	QString id = element.attribute("id");
-	QRectF r = renderer.boundsOnElement(id);
-	QTransform matrix = renderer.transformForElement(id);
-	QString oldid = element.attribute("oldid");
-	if (!oldid.isEmpty()) {
-		element.setAttribute("id", oldid);
-		element.removeAttribute("oldid");
+	// asking the renderer for a group's bounds walks the whole group, so nested groups made the
+	// per-element calls quadratic; groups are put together from their children's bounds instead
+	QHash<QString, QRectF> pixelBounds;
+	Q_FOREACH (QDomElement element, elements) {
+		QString id = element.attribute("gorn");
+		QRectF r = getLocalBounds(renderer, element, localBounds);
+		QTransform matrix = renderer.transformForElement(id);
+		QRectF bounds = matrix.mapRect(r);
+		bounds.setRect(bounds.x() * defaultSizeF.width() / viewBox.width(),
+		               bounds.y() * defaultSizeF.height() / viewBox.height(),
+		               bounds.width() * defaultSizeF.width() / viewBox.width(),
+		               bounds.height() * defaultSizeF.height() / viewBox.height());
+		pixelBounds.insert(id, bounds);
+	}
+
+	return pixelBounds;
+}
+
+QRectF PEMainWindow::getLocalBounds(FSvgRenderer & renderer, const QDomElement & element, QHash<QString, QRectF> & localBounds)
+{
+	// what renderer.boundsOnElement() returns: the element's bounds in its parent's coordinates
+
+	QString id = element.attribute("gorn");
+	if (localBounds.contains(id)) return localBounds.value(id);
+
+	bool fromChildren = (element.tagName().compare("g") == 0);
+	QTransform transform;
+	if (fromChildren) {
+		// a rotated group's box is not the box of its children's boxes, and anything but plain shapes
+		// (use, switch, unknown tags) is left to the renderer
+		QString transformString = element.attribute("transform");
+		if (!transformString.isEmpty()) transform = TextUtils::transformStringToTransform(transformString);
+		if (transform.m12() != 0 || transform.m21() != 0) fromChildren = false;
+		for (QDomElement child = element.firstChildElement(); fromChildren && !child.isNull(); child = child.nextSiblingElement()) {
+			if (!BoundsTags.contains(child.tagName())) fromChildren = false;
+		}
 	}
-	QRectF bounds = matrix.mapRect(r);
-	bounds.setRect(bounds.x() * defaultSizeF.width() / viewBox.width(),
-	               bounds.y() * defaultSizeF.height() / viewBox.height(),
-	               bounds.width() * defaultSizeF.width() / viewBox.width(),
-	               bounds.height() * defaultSizeF.height() / viewBox.height());
+
+	QRectF bounds;
+	if (fromChildren) {
+		for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+			bounds |= getLocalBounds(renderer, child, localBounds);
+		}
+		bounds = transform.mapRect(bounds);
+	}
+	else {
+		bounds = renderer.boundsOnElement(id);
+	}
+
+	localBounds.insert(id, bounds);
 	return bounds;
 }
 
@@ -2739,6 +2835,8 @@ QString PEMainWindow::getPartTitle() {
 
 void PEMainWindow::killPegi() {
 	Q_FOREACH (ViewThing * viewThing, m_viewThings.values()) {
+		viewThing->pegisPending = false;
+		viewThing->gornSvg.clear();
 		if (viewThing->sketchWidget == nullptr) continue;
 
 		Q_FOREACH (QGraphicsItem * item, viewThing->sketchWidget->scene()->items()) {
@@ -3336,6 +3434,8 @@ void PEMainWindow::clearPickMode() {
 QList<PEGraphicsItem *> PEMainWindow::getPegiList(SketchWidget * sketchWidget) {
 	// DebugDialog::debug("-----------------------------");
 
+	ensurePegis(sketchWidget);
+
 	QList<PEGraphicsItem *> pegiList;
 	Q_FOREACH (QGraphicsItem * item, sketchWidget->scene()->items()) {
 		auto * pegi = dynamic_cast<PEGraphicsItem *>(item);
@@ -3796,6 +3896,9 @@ void PEMainWindow::connectorWarning() {
 }
 
 void PEMainWindow::showing(SketchWidget * sketchWidget) {
+	// build before aligning, so the overlays get the same offset as the part
+	ensurePegis(sketchWidget);
+
 	ViewThing * viewThing = m_viewThings.value(sketchWidget->viewID());
 	if (viewThing->firstTime) {
 		viewThing->firstTime = false;
@@ -48,6 +48,12 @@ struct ViewThing {
 	QString originalSvgPath;
 	bool firstTime = false;
 	bool busMode = false;
+	bool pegisPending = false;          // initSvgTree has run, the PEGraphicsItems wait until the view is needed
+	QByteArray gornSvg;                 // the gorned svg those items are measured against
+	QByteArray boundsSvg;               // the gorned svg pixelBounds was measured on
+	QHash<QString, QRectF> pixelBounds; // by gorn
+	QHash<QString, QRectF> localBounds; // by gorn, in the parent's coordinates
+	QString pendingSvgPath;             // the fzp points here but the document hasn't been written yet
 };
 
 class ReferenceModel;
@@ -143,11 +149,13 @@ protected:
 	QDomElement findConnector(const QString & id, int & index);
 	void changeConnectorElement(QDomElement & connector, ConnectorMetadata *);
 	void initSvgTree(SketchWidget *, ItemBase *, QDomDocument &);
+	void ensurePegis(SketchWidget *);
 	void initConnectors(bool updateConnectorsView);
 	QString createSvgFromImage(const QString &origFilePath);
 	// QString makeSvgPath(const QString & referenceFile, SketchWidget * sketchWidget, bool useIndex);
 	QString makeSvgPath2(SketchWidget * sketchWidget);
 	QString saveFzp();
+	void writePendingSvgs();
 	void reload(bool firstTime);
 	void createFileMenu();
 	void updateChangeCount(SketchWidget * sketchWidget, int changeDirection);
@@ -156,7 +164,8 @@ protected:
 	void showInOS(QWidget *parent, const QString &pathIn);
 	void switchedConnector(int, SketchWidget *);
 	PEGraphicsItem * makePegi(QSizeF size, QPointF topLeft, ItemBase * itemBase, QDomElement & element, double z);
-	QRectF getPixelBounds(FSvgRenderer & renderer, QDomElement & element);
+	QHash<QString, QRectF> getPixelBounds(FSvgRenderer & renderer, const QList<QDomElement> & elements, QHash<QString, QRectF> & localBounds);
+	QRectF getLocalBounds(FSvgRenderer & renderer, const QDomElement & element, QHash<QString, QRectF> & localBounds);
 	bool canSave();
 	bool saveAs(bool overWrite);
 	void setBeforeClosingText(const QString & filename, QMessageBox & messageBox);
@@ -41,25 +41,83 @@
 ****************************************************************************/
 
 #include "console.h"
+#include "../installedfonts.h"
 
 #include <QScrollBar>
+#include <QStringList>
 
 #include <QtCore/QDebug>
 
+static constexpr int MaxBlocks = 1000;
+static constexpr int FlushMs = 16;          // about one frame
+
+static int incompleteUtf8Tail(const QByteArray & bytes)
+{
+	// how many bytes at the end start a character whose remaining bytes haven't arrived
+	for (int i = 1; i <= qMin(3, bytes.size()); i++) {
+		unsigned char c = bytes.at(bytes.size() - i);
+		if ((c & 0xC0) == 0x80) continue;                   // continuation byte
+		int length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+		return length > i ? i : 0;
+	}
+	return 0;
+}
+
 Console::Console(QWidget *parent)
 	: QPlainTextEdit(parent)
 	, localEchoEnabled(false)
+	, m_pendingLines(MaxBlocks)
 {
-	document()->setMaximumBlockCount(1000);
+	document()->setMaximumBlockCount(MaxBlocks);
+	// the undo stack would otherwise keep every chunk ever received
+	setUndoRedoEnabled(false);
+	InstalledFonts::registerFonts();
 	QFont font = document()->defaultFont();
 	font.setFamily("Droid Sans Mono");
 	document()->setDefaultFont(font);
 	//setCenterOnScroll(true);
+
+	m_flushTimer.setSingleShot(true);
+	m_flushTimer.setInterval(FlushMs);
+	connect(&m_flushTimer, SIGNAL(timeout()), this, SLOT(flushPending()));
 }
 
 void Console::putData(const QByteArray &data)
 {
-	insertPlainText(QString(data));
+	// fast senders deliver many small reads per frame; collect them and update the display once a frame
+	QByteArray bytes = m_utf8Tail + data;
+	int tail = incompleteUtf8Tail(bytes);
+	m_utf8Tail = bytes.right(tail);
+	bytes.chop(tail);
+
+	QStringList lines = QString::fromUtf8(bytes).split('\n');
+	lines.first().prepend(m_pendingPartial);
+	m_pendingPartial = lines.takeLast();
+	Q_FOREACH (QString line, lines) {
+		// the document would drop the oldest lines anyway
+		if (m_pendingLines.isFull()) m_pendingContinues = false;
+		m_pendingLines.append(line);
+	}
+
+	if (!m_flushTimer.isActive()) m_flushTimer.start();
+}
+
+void Console::flushPending()
+{
+	QString text;
+	if (!m_pendingContinues && !document()->isEmpty()) text += '\n';
+	for (int i = m_pendingLines.firstIndex(); i <= m_pendingLines.lastIndex(); i++) {
+		text += m_pendingLines.at(i);
+		text += '\n';
+	}
+	text += m_pendingPartial;
+	m_pendingLines.clear();
+	m_pendingPartial.clear();
+	m_pendingContinues = true;
+	if (text.isEmpty()) return;
+
+	moveCursor(QTextCursor::End);
+	insertPlainText(text);
 
 	QScrollBar *bar = verticalScrollBar();
 	bar->setValue(bar->maximum());
@@ -80,8 +138,10 @@ void Console::keyPressEvent(QKeyEvent *e)
 	case Qt::Key_Down:
 		break;
 	default:
-		if (localEchoEnabled)
+		if (localEchoEnabled) {
+			flushPending();
 			QPlainTextEdit::keyPressEvent(e);
+		}
 		Q_EMIT getData(e->text().toLocal8Bit());
 	}
 }
@@ -44,6 +44,8 @@
 #define CONSOLE_H
 
 #include <QPlainTextEdit>
+#include <QContiguousCache>
+#include <QTimer>
 
 class Console : public QPlainTextEdit
 {
@@ -65,9 +67,19 @@ protected:
 	virtual void mouseDoubleClickEvent(QMouseEvent *e);
 	virtual void contextMenuEvent(QContextMenuEvent *e);
 
+protected Q_SLOTS:
+	void flushPending();
+
 private:
 	bool localEchoEnabled;
 
+	// what arrived since the last frame; only the last lines that can still be displayed are kept
+	QContiguousCache<QString> m_pendingLines;
+	QString m_pendingPartial;           // after the last newline
+	bool m_pendingContinues = true;     // the first pending line goes on the document's last line
+	QByteArray m_utf8Tail;              // a character split across two reads
+	QTimer m_flushTimer;
+
 };
 
 #endif // CONSOLE_H
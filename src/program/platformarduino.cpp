@@ -1,10 +1,22 @@
 #include "platformarduino.h"
 #include "programtab.h"
+#include "../utils/folderutils.h"
 
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFileInfo>
 #include <QProcess>
 
+static bool sameContents(const QString & path1, const QString & path2)
+{
+	QFile file1(path1);
+	QFile file2(path2);
+	if (!file1.open(QIODevice::ReadOnly) || !file2.open(QIODevice::ReadOnly)) return false;
+	if (file1.size() != file2.size()) return false;
+
+	return file1.readAll() == file2.readAll();
+}
+
 PlatformArduino::PlatformArduino() : Platform(QString("Arduino"))
 {
 	setReferenceUrl(QUrl(QString("http://arduino.cc/en/Reference/")));
@@ -65,8 +77,11 @@ void PlatformArduino::upload(QWidget *source, const QString &port, const QString
 		fileInfo.dir().mkdir(tmpSketchName);
 		tmpFilePath = fileInfo.absolutePath().append("/").append(tmpSketchName).append("/")
 		              .append(fileInfo.baseName().append("_TMP.").append(fileInfo.suffix()));
-		if (QFile::exists(tmpFilePath)) QFile::remove(tmpFilePath);
-		QFile::copy(fileInfo.absoluteFilePath(), tmpFilePath);
+		// only copy changed text, so the builder sees an unchanged sketch as unchanged
+		if (!sameContents(fileInfo.absoluteFilePath(), tmpFilePath)) {
+			if (QFile::exists(tmpFilePath)) QFile::remove(tmpFilePath);
+			QFile::copy(fileInfo.absoluteFilePath(), tmpFilePath);
+		}
 	}
 
 	QStringList args;
@@ -76,6 +91,11 @@ void PlatformArduino::upload(QWidget *source, const QString &port, const QString
 	args.append(getBoards().value(board));
 	args.append(QString("--port"));
 	args.append(port);
+	QString buildPath = buildFolder(tmpFilePath, board);
+	if (!buildPath.isEmpty()) {
+		args.append(QString("--pref"));
+		args.append(QString("build.path=%1").arg(QDir::toNativeSeparators(buildPath)));
+	}
 	args.append(QString("--upload"));
 	args.append(QDir::toNativeSeparators(tmpFilePath));
 
@@ -84,3 +104,17 @@ void PlatformArduino::upload(QWidget *source, const QString &port, const QString
 		tab->appendToConsole(tr("Running %1 %2").arg(getCommandLocation()).arg(args.join(" ")));
 	process->start(getCommandLocation(), args);
 }
+
+QString PlatformArduino::buildFolder(const QString & sketchPath, const QString & board)
+{
+	// the builder skips whatever is up to date in its build folder, core included, so an unchanged
+	// sketch goes straight to the upload; the folder is kept per IDE, board and sketch
+	QByteArray key = QString("%1\n%2\n%3").arg(getCommandLocation(), getBoards().value(board), QFileInfo(sketchPath).absoluteFilePath()).toUtf8();
+	QString name = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex().left(16);
+
+	QDir dir(FolderUtils::getTopLevelUserDataStorePath());
+	QString relative = QString("arduinobuild/%1").arg(name);
+	if (!dir.mkpath(relative)) return QString();
+
+	return dir.absoluteFilePath(relative);
+}
@@ -12,6 +12,9 @@ public:
 	PlatformArduino();
 
 	void upload(QWidget *source, const QString &port, const QString &board, const QString &fileLocation);
+
+protected:
+	QString buildFolder(const QString & sketchPath, const QString & board);
 };
 
 #endif // PLATFORMARDUINO_H
@@ -22,6 +22,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "highlighter.h"
 #include "syntaxer.h"
 #include "consolewindow.h"
+#include "../installedfonts.h"
 #include "../debugdialog.h"
 #include "../utils/folderutils.h"
 #include "../sketchtoolbutton.h"
@@ -156,6 +157,7 @@ ProgramTab::ProgramTab(QString & filename, QWidget *parent) : QFrame(parent)
 
 	// m_textEdit needs to be initialized before createFooter so
 	// some signals get connected properly.
+	InstalledFonts::registerFonts();
 	m_textEdit = new QTextEdit;
 	m_textEdit->setObjectName("code");
 	m_textEdit->setFontFamily("Droid Sans Mono");
@@ -776,8 +778,11 @@ void ProgramTab::programProcessFinished(int exitCode, QProcess::ExitStatus exitS
 }
 
 void ProgramTab::programProcessReadyRead() {
+	// output arrives in arbitrary chunks; append them as they come rather than as a paragraph each
 	QByteArray byteArray = qobject_cast<QProcess *>(sender())->readAllStandardOutput();
-	m_console->appendPlainText(byteArray);
+	m_console->moveCursor(QTextCursor::End);
+	m_console->insertPlainText(QString::fromLocal8Bit(byteArray));
+	m_console->ensureCursorVisible();
 }
 
 /**
@@ -0,0 +1,423 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "partsindex.h"
+#include "../debugdialog.h"
+#include "../utils/folderutils.h"
+#include "../version/version.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <cstring>
+
+const quint32 PartsIndex::FormatVersion = 1;
+
+static const quint32 Magic = 0x465a5049;        // "FZPI"
+static const QString IndexFileName("partsindex.fzpi");
+
+struct Header {
+	quint32 magic;
+	quint32 version;
+	quint32 stamp;                               // string index
+	quint32 stringCount;
+	quint64 stringOffsets;                       // stringCount + 1 quint32 offsets into the string data, in utf-16 units
+	quint64 stringData;
+	quint64 sectionOffsets[PartsIndex::SectionCount];
+	quint32 sectionCounts[PartsIndex::SectionCount];
+	quint32 reserved;
+	quint64 size;
+};
+
+// the records are read straight out of the mapped file, so their layout is the file format
+static_assert(sizeof(Header) % 8 == 0, "parts index header must stay 8-byte aligned");
+static_assert(sizeof(PartsIndex::Part) == 64, "parts index format changed");
+static_assert(sizeof(PartsIndex::ViewImage) == 32, "parts index format changed");
+static_assert(sizeof(PartsIndex::Connector) == 28, "parts index format changed");
+static_assert(sizeof(PartsIndex::ConnectorLayer) == 28, "parts index format changed");
+
+static const size_t RecordSizes[PartsIndex::SectionCount] = {
+	sizeof(PartsIndex::Part),
+	sizeof(PartsIndex::Property),
+	sizeof(PartsIndex::Tag),
+	sizeof(PartsIndex::ViewImage),
+	sizeof(PartsIndex::Connector),
+	sizeof(PartsIndex::ConnectorLayer),
+	sizeof(PartsIndex::Bus),
+	sizeof(PartsIndex::BusMember),
+	sizeof(PartsIndex::Subpart),
+};
+
+static void align8(QByteArray & bytes)
+{
+	while (bytes.size() % 8 != 0) bytes.append('\0');
+}
+
+template <typename T> static void appendSection(QByteArray & bytes, const QVector<T> & records, Header & header, PartsIndex::Section section)
+{
+	align8(bytes);
+	header.sectionOffsets[section] = bytes.size();
+	header.sectionCounts[section] = records.count();
+	bytes.append(reinterpret_cast<const char *>(records.constData()), records.count() * sizeof(T));
+}
+
+static bool runQuery(QSqlQuery & query, const QString & sql)
+{
+	if (query.exec(sql)) return true;
+
+	DebugDialog::debug(QString("parts index: %1 %2").arg(sql, query.lastError().text()));
+	return false;
+}
+
+///////////////////////////////////////////////////
+
+PartsIndex::PartsIndex()
+{
+}
+
+PartsIndex::~PartsIndex()
+{
+	close();
+}
+
+QString PartsIndex::defaultPath()
+{
+	return QDir(FolderUtils::getTopLevelUserDataStorePath()).absoluteFilePath(IndexFileName);
+}
+
+QString PartsIndex::makeStamp(const QString & sha, const QString & databaseName)
+{
+	return QString("%1 %2 %3").arg(Version::versionString(), sha, QFileInfo(databaseName).absoluteFilePath());
+}
+
+bool PartsIndex::open(const QString & path, const QString & stamp)
+{
+	// maps the index; false when it is missing, damaged, from another format or stamped for another database
+
+	close();
+	m_file.setFileName(path);
+	if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+	m_size = m_file.size();
+	if (m_size < (qint64) sizeof(Header)) {
+		close();
+		return false;
+	}
+
+	m_data = m_file.map(0, m_size);
+	if (m_data == nullptr) {
+		close();
+		return false;
+	}
+
+	Header header;
+	memcpy(&header, m_data, sizeof(Header));
+	bool ok = header.magic == Magic && header.version == FormatVersion && header.size == (quint64) m_size;
+	for (int i = 0; ok && i < SectionCount; i++) {
+		ok = header.sectionOffsets[i] % 8 == 0 &&
+		     header.sectionOffsets[i] + header.sectionCounts[i] * (quint64) RecordSizes[i] <= header.size;
+	}
+	ok = ok && header.stringOffsets % 4 == 0 && header.stringData % 2 == 0 &&
+	     header.stringOffsets + (header.stringCount + 1) * (quint64) sizeof(quint32) <= header.size;
+	if (ok) {
+		m_stringCount = header.stringCount;
+		m_stringOffsets = reinterpret_cast<const quint32 *>(m_data + header.stringOffsets);
+		m_stringData = reinterpret_cast<const char16_t *>(m_data + header.stringData);
+		ok = m_stringOffsets[0] == 0 && header.stringData + m_stringOffsets[m_stringCount] * (quint64) sizeof(char16_t) <= header.size;
+		for (quint32 i = 0; ok && i < m_stringCount; i++) {
+			ok = m_stringOffsets[i] <= m_stringOffsets[i + 1];
+		}
+	}
+	if (ok) {
+		m_strings.resize(m_stringCount);
+		ok = header.stamp < m_stringCount && string(header.stamp) == stamp;
+	}
+
+	if (!ok) {
+		DebugDialog::debug(QString("parts index %1 is out of date").arg(path));
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void PartsIndex::close()
+{
+	if (m_data != nullptr) {
+		m_file.unmap(const_cast<uchar *>(m_data));
+	}
+	m_file.close();
+	m_data = nullptr;
+	m_size = 0;
+	m_stringOffsets = nullptr;
+	m_stringData = nullptr;
+	m_stringCount = 0;
+	m_strings.clear();
+}
+
+const QString & PartsIndex::string(quint32 index) const
+{
+	static const QString Empty;
+	if (index >= m_stringCount) return Empty;
+
+	QString & string = m_strings[index];
+	if (string.isNull()) {
+		quint32 start = m_stringOffsets[index];
+		string = QString(reinterpret_cast<const QChar *>(m_stringData + start), m_stringOffsets[index + 1] - start);
+	}
+	return string;
+}
+
+template <typename T> PartsIndex::Records<T> PartsIndex::records(Section section) const
+{
+	Records<T> records = { nullptr, 0 };
+	if (m_data == nullptr) return records;
+
+	Header header;
+	memcpy(&header, m_data, sizeof(Header));
+	records.data = reinterpret_cast<const T *>(m_data + header.sectionOffsets[section]);
+	records.count = header.sectionCounts[section];
+	return records;
+}
+
+PartsIndex::Records<PartsIndex::Part> PartsIndex::parts() const {
+	return records<Part>(Parts);
+}
+
+PartsIndex::Records<PartsIndex::Property> PartsIndex::properties() const {
+	return records<Property>(Properties);
+}
+
+PartsIndex::Records<PartsIndex::Tag> PartsIndex::tags() const {
+	return records<Tag>(Tags);
+}
+
+PartsIndex::Records<PartsIndex::ViewImage> PartsIndex::viewImages() const {
+	return records<ViewImage>(ViewImages);
+}
+
+PartsIndex::Records<PartsIndex::Connector> PartsIndex::connectors() const {
+	return records<Connector>(Connectors);
+}
+
+PartsIndex::Records<PartsIndex::ConnectorLayer> PartsIndex::connectorLayers() const {
+	return records<ConnectorLayer>(ConnectorLayers);
+}
+
+PartsIndex::Records<PartsIndex::Bus> PartsIndex::buses() const {
+	return records<Bus>(Buses);
+}
+
+PartsIndex::Records<PartsIndex::BusMember> PartsIndex::busMembers() const {
+	return records<BusMember>(BusMembers);
+}
+
+PartsIndex::Records<PartsIndex::Subpart> PartsIndex::subparts() const {
+	return records<Subpart>(Subparts);
+}
+
+bool PartsIndex::write(const QString & path, const QString & stamp, QSqlDatabase & db)
+{
+	// reads every table loadFromDB reads and writes them out as one index file
+
+	QHash<QString, quint32> ids;
+	QVector<QString> strings;
+	auto intern = [&ids, &strings](const QString & string) -> quint32 {
+		auto it = ids.constFind(string);
+		if (it != ids.constEnd()) return it.value();
+
+		quint32 id = strings.count();
+		ids.insert(string, id);
+		strings.append(string);
+		return id;
+	};
+
+	Header header;
+	memset(&header, 0, sizeof(Header));
+	header.magic = Magic;
+	header.version = FormatVersion;
+	header.stamp = intern(stamp);
+
+	QSqlQuery query(db);
+	QVector<Part> parts;
+	if (!runQuery(query, "SELECT id, path, moduleID, family, version, replacedby, fritzingversion, author, title, label, date, description, spice, spicemodel, taxonomy, itemtype FROM parts")) return false;
+	while (query.next()) {
+		int ix = 0;
+		Part part;
+		part.dbid = query.value(ix++).toUInt();
+		part.path = intern(query.value(ix++).toString());
+		part.moduleID = intern(query.value(ix++).toString());
+		part.family = intern(query.value(ix++).toString());
+		part.version = intern(query.value(ix++).toString());
+		part.replacedby = intern(query.value(ix++).toString());
+		part.fritzingVersion = intern(query.value(ix++).toString());
+		part.author = intern(query.value(ix++).toString());
+		part.title = intern(query.value(ix++).toString());
+		part.label = intern(query.value(ix++).toString());
+		part.date = intern(query.value(ix++).toString());
+		part.description = intern(query.value(ix++).toString());
+		part.spice = intern(query.value(ix++).toString());
+		part.spiceModel = intern(query.value(ix++).toString());
+		part.taxonomy = intern(query.value(ix++).toString());
+		part.itemType = query.value(ix++).toInt();
+		parts.append(part);
+	}
+
+	QVector<Property> properties;
+	if (!runQuery(query, "SELECT part_id, name, value, show_in_label FROM properties")) return false;
+	while (query.next()) {
+		Property property;
+		property.part = query.value(0).toUInt();
+		property.name = intern(query.value(1).toString());
+		property.value = intern(query.value(2).toString());
+		property.showInLabel = query.value(3).toUInt();
+		properties.append(property);
+	}
+
+	QVector<Tag> tags;
+	if (!runQuery(query, "SELECT part_id, tag FROM tags")) return false;
+	while (query.next()) {
+		Tag tag;
+		tag.part = query.value(0).toUInt();
+		tag.tag = intern(query.value(1).toString());
+		tags.append(tag);
+	}
+
+	QVector<ViewImage> viewImages;
+	if (!runQuery(query, "SELECT viewid, image, layers, sticky, flipvertical, fliphorizontal, part_id FROM viewimages")) return false;
+	while (query.next()) {
+		int ix = 0;
+		ViewImage viewImage;
+		viewImage.viewID = query.value(ix++).toUInt();
+		viewImage.image = intern(query.value(ix++).toString());
+		viewImage.layers = query.value(ix++).toULongLong();
+		viewImage.sticky = query.value(ix++).toULongLong();
+		viewImage.flags = 0;
+		if (query.value(ix++).toInt() != 0) viewImage.flags |= FlipVertical;
+		if (query.value(ix++).toInt() != 0) viewImage.flags |= FlipHorizontal;
+		viewImage.part = query.value(ix++).toUInt();
+		viewImages.append(viewImage);
+	}
+
+	QVector<Connector> connectors;
+	if (!runQuery(query, "SELECT id, connectorid, type, name, description, replacedby, part_id FROM connectors")) return false;
+	while (query.next()) {
+		int ix = 0;
+		Connector connector;
+		connector.id = query.value(ix++).toUInt();
+		connector.connectorID = intern(query.value(ix++).toString());
+		connector.type = query.value(ix++).toUInt();
+		connector.name = intern(query.value(ix++).toString());
+		connector.description = intern(query.value(ix++).toString());
+		connector.replacedby = intern(query.value(ix++).toString());
+		connector.part = query.value(ix++).toUInt();
+		connectors.append(connector);
+	}
+
+	QVector<ConnectorLayer> connectorLayers;
+	if (!runQuery(query, "SELECT view, layer, svgid, hybrid, terminalid, legid, connector_id FROM connectorlayers")) return false;
+	while (query.next()) {
+		int ix = 0;
+		ConnectorLayer connectorLayer;
+		connectorLayer.view = query.value(ix++).toUInt();
+		connectorLayer.layer = query.value(ix++).toUInt();
+		connectorLayer.svgID = intern(query.value(ix++).toString());
+		connectorLayer.hybrid = query.value(ix++).toUInt();
+		connectorLayer.terminalID = intern(query.value(ix++).toString());
+		connectorLayer.legID = intern(query.value(ix++).toString());
+		connectorLayer.connector = query.value(ix++).toUInt();
+		connectorLayers.append(connectorLayer);
+	}
+
+	QVector<Bus> buses;
+	if (!runQuery(query, "SELECT id, name, part_id FROM buses")) return false;
+	while (query.next()) {
+		Bus bus;
+		bus.id = query.value(0).toUInt();
+		bus.name = intern(query.value(1).toString());
+		bus.part = query.value(2).toUInt();
+		buses.append(bus);
+	}
+
+	QVector<BusMember> busMembers;
+	if (!runQuery(query, "SELECT connectorid, bus_id FROM busmembers")) return false;
+	while (query.next()) {
+		BusMember busMember;
+		busMember.connectorID = intern(query.value(0).toString());
+		busMember.bus = query.value(1).toUInt();
+		busMembers.append(busMember);
+	}
+
+	QVector<Subpart> subparts;
+	if (runQuery(query, "SELECT subpart_id, part_id FROM schematic_subparts")) {
+		while (query.next()) {
+			Subpart subpart;
+			subpart.subpartID = intern(query.value(0).toString());
+			subpart.part = query.value(1).toUInt();
+			subparts.append(subpart);
+		}
+	}
+
+	QByteArray bytes(sizeof(Header), '\0');
+	appendSection(bytes, parts, header, Parts);
+	appendSection(bytes, properties, header, Properties);
+	appendSection(bytes, tags, header, Tags);
+	appendSection(bytes, viewImages, header, ViewImages);
+	appendSection(bytes, connectors, header, Connectors);
+	appendSection(bytes, connectorLayers, header, ConnectorLayers);
+	appendSection(bytes, buses, header, Buses);
+	appendSection(bytes, busMembers, header, BusMembers);
+	appendSection(bytes, subparts, header, Subparts);
+
+	QVector<quint32> stringOffsets;
+	QVector<char16_t> stringData;
+	stringOffsets.append(0);
+	Q_FOREACH (QString string, strings) {
+		const char16_t * utf16 = reinterpret_cast<const char16_t *>(string.utf16());
+		for (int i = 0; i < string.length(); i++) stringData.append(utf16[i]);
+		stringOffsets.append(stringData.count());
+	}
+
+	align8(bytes);
+	header.stringCount = strings.count();
+	header.stringOffsets = bytes.size();
+	bytes.append(reinterpret_cast<const char *>(stringOffsets.constData()), stringOffsets.count() * sizeof(quint32));
+	header.stringData = bytes.size();
+	bytes.append(reinterpret_cast<const char *>(stringData.constData()), stringData.count() * sizeof(char16_t));
+	header.size = bytes.size();
+	memcpy(bytes.data(), &header, sizeof(Header));
+
+	// QSaveFile so a running Fritzing never maps a half-written index
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) return false;
+
+	if (file.write(bytes) != bytes.size()) {
+		file.cancelWriting();
+		return false;
+	}
+
+	DebugDialog::debug(QString("wrote parts index: %1 parts, %2 strings, %3 bytes").arg(parts.count()).arg(strings.count()).arg(bytes.size()));
+	return file.commit();
+}
@@ -0,0 +1,178 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef PARTSINDEX_H
+#define PARTSINDEX_H
+
+#include <QFile>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+class PartsIndex
+{
+	// a binary copy of parts.db, memory mapped at startup so ModelParts can be built without sql;
+	// one interned string table plus flat arrays of fixed-size records. parts.db stays the source
+	// of truth: the index is stamped with the database's sha and path and rewritten when either changes
+
+public:
+	enum Section {
+		Parts,
+		Properties,
+		Tags,
+		ViewImages,
+		Connectors,
+		ConnectorLayers,
+		Buses,
+		BusMembers,
+		Subparts,
+		SectionCount
+	};
+
+	// string fields are indices into the string table; part, connector and bus fields are parts.db ids
+	struct Part {
+		quint32 dbid;
+		quint32 path;
+		quint32 moduleID;
+		quint32 family;
+		quint32 version;
+		quint32 replacedby;
+		quint32 fritzingVersion;
+		quint32 author;
+		quint32 title;
+		quint32 label;
+		quint32 date;
+		quint32 description;
+		quint32 spice;
+		quint32 spiceModel;
+		quint32 taxonomy;
+		qint32 itemType;
+	};
+
+	struct Property {
+		quint32 part;
+		quint32 name;
+		quint32 value;
+		quint32 showInLabel;
+	};
+
+	struct Tag {
+		quint32 part;
+		quint32 tag;
+	};
+
+	struct ViewImage {
+		quint64 layers;
+		quint64 sticky;
+		quint32 part;
+		quint32 viewID;
+		quint32 image;
+		quint32 flags;                      // FlipVertical | FlipHorizontal
+	};
+
+	struct Connector {
+		quint32 id;
+		quint32 part;
+		quint32 connectorID;
+		quint32 type;
+		quint32 name;
+		quint32 description;
+		quint32 replacedby;
+	};
+
+	struct ConnectorLayer {
+		quint32 connector;
+		quint32 view;
+		quint32 layer;
+		quint32 svgID;
+		quint32 hybrid;
+		quint32 terminalID;
+		quint32 legID;
+	};
+
+	struct Bus {
+		quint32 id;
+		quint32 part;
+		quint32 name;
+	};
+
+	struct BusMember {
+		quint32 bus;
+		quint32 connectorID;
+	};
+
+	struct Subpart {
+		quint32 part;
+		quint32 subpartID;
+	};
+
+	template <typename T> struct Records {
+		const T * data;
+		int count;
+
+		const T * begin() const { return data; }
+		const T * end() const { return data + count; }
+	};
+
+	enum ViewImageFlag {
+		FlipVertical = 1,
+		FlipHorizontal = 2
+	};
+
+public:
+	PartsIndex();
+	~PartsIndex();
+
+	bool open(const QString & path, const QString & stamp);
+	void close();
+	const QString & string(quint32) const;
+
+	Records<Part> parts() const;
+	Records<Property> properties() const;
+	Records<Tag> tags() const;
+	Records<ViewImage> viewImages() const;
+	Records<Connector> connectors() const;
+	Records<ConnectorLayer> connectorLayers() const;
+	Records<Bus> buses() const;
+	Records<BusMember> busMembers() const;
+	Records<Subpart> subparts() const;
+
+public:
+	static bool write(const QString & path, const QString & stamp, QSqlDatabase & db);
+	static QString defaultPath();
+	static QString makeStamp(const QString & sha, const QString & databaseName);
+
+public:
+	static const quint32 FormatVersion;
+
+protected:
+	template <typename T> Records<T> records(Section) const;
+
+protected:
+	QFile m_file;
+	const uchar * m_data = nullptr;
+	qint64 m_size = 0;
+	const quint32 * m_stringOffsets = nullptr;
+	const char16_t * m_stringData = nullptr;
+	quint32 m_stringCount = 0;
+	mutable QVector<QString> m_strings;     // each string built once, so equal fields share one QString
+};
+
+#endif
@@ -0,0 +1,208 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "propertyindex.h"
+#include "../debugdialog.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtAlgorithms>
+
+PartBits::PartBits(int size, bool value) : m_words((size + 63) / 64, value ? ~quint64(0) : 0), m_size(size)
+{
+	if (value && (size % 64) != 0) {
+		m_words.last() &= (quint64(1) << (size % 64)) - 1;
+	}
+}
+
+int PartBits::size() const {
+	return m_size;
+}
+
+void PartBits::setBit(int i) {
+	m_words[i / 64] |= quint64(1) << (i % 64);
+}
+
+bool PartBits::testBit(int i) const {
+	return (m_words.at(i / 64) >> (i % 64)) & 1;
+}
+
+int PartBits::count() const {
+	int result = 0;
+	Q_FOREACH (quint64 word, m_words) {
+		result += qPopulationCount(word);
+	}
+	return result;
+}
+
+int PartBits::first() const {
+	return next(-1);
+}
+
+int PartBits::next(int after) const {
+	int i = after + 1;
+	if (i >= m_size) return -1;
+
+	int w = i / 64;
+	quint64 word = m_words.at(w) & (~quint64(0) << (i % 64));
+	while (true) {
+		if (word != 0) return (w * 64) + qCountTrailingZeroBits(word);
+		if (++w >= m_words.count()) return -1;
+		word = m_words.at(w);
+	}
+}
+
+PartBits & PartBits::operator&=(const PartBits & other) {
+	for (int i = 0; i < m_words.count(); i++) {
+		m_words[i] &= other.m_words.at(i);
+	}
+	return *this;
+}
+
+///////////////////////////////////////////////////
+
+void PropertyIndex::clear() {
+	m_families.clear();
+}
+
+void PropertyIndex::build(QSqlDatabase & db) {
+	clear();
+
+	// only the reference model's own database has a core column
+	QSqlQuery query(db);
+	if (!query.exec("SELECT id, moduleID, family FROM parts ORDER BY core DESC, id")) {
+		if (!query.exec("SELECT id, moduleID, family FROM parts ORDER BY id")) {
+			DebugDialog::debug(QString("property index: %1").arg(query.lastError().text()));
+			return;
+		}
+	}
+
+	QHash<qulonglong /*dbid*/, QPair<QString /*family*/, int /*bit*/>> parts;
+	while (query.next()) {
+		Family & family = m_families[query.value(2).toString()];
+		parts.insert(query.value(0).toULongLong(), qMakePair(query.value(2).toString(), family.moduleIDs.count()));
+		family.moduleIDs.append(query.value(1).toString());
+	}
+
+	// no more families get added, so their addresses hold from here on
+	QHash<qulonglong /*dbid*/, QPair<Family *, int /*bit*/>> bits;
+	for (auto it = parts.constBegin(); it != parts.constEnd(); ++it) {
+		bits.insert(it.key(), qMakePair(&m_families[it.value().first], it.value().second));
+	}
+	for (auto it = m_families.begin(); it != m_families.end(); ++it) {
+		it.value().withProperties = PartBits(it.value().moduleIDs.count());
+	}
+
+	if (!query.exec("SELECT part_id, name, value FROM properties")) {
+		DebugDialog::debug(QString("property index: %1").arg(query.lastError().text()));
+		clear();
+		return;
+	}
+
+	while (query.next()) {
+		auto part = bits.value(query.value(0).toULongLong(), qMakePair((Family *) nullptr, -1));
+		if (part.first == nullptr) continue;
+
+		PartBits & partBits = part.first->values[query.value(1).toString()][query.value(2).toString()];
+		if (partBits.size() == 0) {
+			partBits = PartBits(part.first->moduleIDs.count());
+		}
+		partBits.setBit(part.second);
+		part.first->withProperties.setBit(part.second);
+	}
+}
+
+const PartBits * PropertyIndex::valueBits(const Family & family, const QString & name, const QString & value) const {
+	auto names = family.values.constFind(name);
+	if (names == family.values.constEnd()) return nullptr;
+
+	auto values = names.value().constFind(value);
+	if (values == names.value().constEnd()) return nullptr;
+
+	return &values.value();
+}
+
+QString PropertyIndex::exactMatch(const QString & family, const QMultiHash<QString, QString> & properties) const {
+	// the first part having every name/value pair; values compare as the sql did, lowercased and trimmed
+	auto it = m_families.constFind(family.toLower().trimmed());
+	if (it == m_families.constEnd()) return QString();
+
+	const Family & fam = it.value();
+	PartBits result(fam.moduleIDs.count(), true);
+	for (auto prop = properties.constBegin(); prop != properties.constEnd(); ++prop) {
+		const PartBits * bits = valueBits(fam, prop.key().toLower().trimmed(), prop.value().toLower().trimmed());
+		if (bits == nullptr) return QString();
+
+		result &= *bits;
+	}
+
+	int bit = result.first();
+	return bit < 0 ? QString() : fam.moduleIDs.at(bit);
+}
+
+PartBits PropertyIndex::possibleBits(const Family & family, const QString & propertyName, const QString & propertyValue) const {
+	if (propertyName.isEmpty()) return family.withProperties;
+
+	const PartBits * bits = valueBits(family, propertyName.toLower().trimmed(), propertyValue);
+	return bits == nullptr ? PartBits(family.moduleIDs.count()) : *bits;
+}
+
+QStringList PropertyIndex::possibleMatches(const QString & family, const QString & propertyName, const QString & propertyValue) const {
+	QStringList result;
+	auto it = m_families.constFind(family.toLower().trimmed());
+	if (it == m_families.constEnd()) return result;
+
+	PartBits candidates = possibleBits(it.value(), propertyName, propertyValue);
+	for (int bit = candidates.first(); bit >= 0; bit = candidates.next(bit)) {
+		result << it.value().moduleIDs.at(bit);
+	}
+	return result;
+}
+
+QString PropertyIndex::closestMatch(const QString & family, const QMultiHash<QString, QString> & properties, const QString & propertyName, const QString & propertyValue) const {
+	// among the possible matches, the first with the most name/value pairs in common;
+	// each pair adds its intersection with the candidates to a per-part count
+	auto it = m_families.constFind(family.toLower().trimmed());
+	if (it == m_families.constEnd()) return QString();
+
+	const Family & fam = it.value();
+	PartBits candidates = possibleBits(fam, propertyName, propertyValue);
+	QVector<int> counts(fam.moduleIDs.count(), 0);
+	for (auto prop = properties.constBegin(); prop != properties.constEnd(); ++prop) {
+		const PartBits * bits = valueBits(fam, prop.key(), prop.value());
+		if (bits == nullptr) continue;
+
+		PartBits common = candidates;
+		common &= *bits;
+		for (int bit = common.first(); bit >= 0; bit = common.next(bit)) {
+			counts[bit]++;
+		}
+	}
+
+	int best = -1;
+	int bestCount = 0;
+	for (int bit = candidates.first(); bit >= 0; bit = candidates.next(bit)) {
+		if (counts.at(bit) > bestCount) {
+			best = bit;
+			bestCount = counts.at(bit);
+		}
+	}
+
+	return best < 0 ? QString() : fam.moduleIDs.at(best);
+}
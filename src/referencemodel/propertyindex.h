@@ -0,0 +1,79 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef PROPERTYINDEX_H
+#define PROPERTYINDEX_H
+
+#include <QHash>
+#include <QMultiHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class PartBits
+{
+	// fixed-size bitset over one family's parts, one bit per part
+
+public:
+	PartBits() = default;
+	explicit PartBits(int size, bool value = false);
+
+	int size() const;
+	void setBit(int);
+	bool testBit(int) const;
+	int count() const;
+	int first() const;                  // -1 when no bit is set
+	int next(int after) const;
+	PartBits & operator&=(const PartBits &);
+
+protected:
+	QVector<quint64> m_words;
+	int m_size = 0;
+};
+
+class PropertyIndex
+{
+	// the parts database's properties held per family as property -> value -> bitset of parts,
+	// so swap lookups are bitset intersections instead of one sql query per combination;
+	// within a family, core parts come first, matching the database's "order by core desc"
+
+public:
+	void build(QSqlDatabase &);
+	void clear();
+
+	QString exactMatch(const QString & family, const QMultiHash<QString, QString> & properties) const;
+	QStringList possibleMatches(const QString & family, const QString & propertyName, const QString & propertyValue) const;
+	QString closestMatch(const QString & family, const QMultiHash<QString, QString> & properties, const QString & propertyName, const QString & propertyValue) const;
+
+protected:
+	struct Family {
+		QVector<QString> moduleIDs;                                         // by bit
+		QHash<QString /*name*/, QHash<QString /*value*/, PartBits>> values;
+		PartBits withProperties;
+	};
+
+	PartBits possibleBits(const Family &, const QString & propertyName, const QString & propertyValue) const;
+	const PartBits * valueBits(const Family &, const QString & name, const QString & value) const;
+
+protected:
+	QHash<QString /*family*/, Family> m_families;
+};
+
+#endif
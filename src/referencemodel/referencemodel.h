@@ -29,6 +29,7 @@ class ReferenceModel : public PaletteModel {
 public:
 	virtual bool loadAll(const QString & databaseName, bool fullLoad, bool dbExists) = 0;
 	virtual bool loadFromDB(const QString & databaseName) = 0;
+	virtual bool updateDatabase(const QString & databaseName, const QString & sha) = 0;
 	virtual ModelPart *loadPart(const QString & path, bool update) = 0;
 	virtual ModelPart *reloadPart(const QString & path, const QString & moduleID) = 0;
 
@@ -37,6 +38,8 @@ public:
 	virtual bool addPart(ModelPart * newModel, bool update) = 0;
 	virtual ModelPart * addPart(QString newPartPath, bool addToReference, bool updateIdAlreadyExists) = 0;
 	virtual bool updatePart(ModelPart * newModel) = 0;
+	virtual bool beginBatch() = 0;
+	virtual bool endBatch() = 0;
 
 	virtual bool swapEnabled() const = 0;
 	virtual QString partTitle(const QString & moduleID) = 0;
@@ -27,10 +27,17 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QSqlResult>
 #include <QSqlDriver>
 #include <QDebug>
+#include <QSettings>
+#include <QSet>
 #include <QtGlobal>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtConcurrentMap>
 #include <limits>
 
 #include "sqlitereferencemodel.h"
+#include "partsindex.h"
 #include "../debugdialog.h"
 #include "../connectors/svgidlayer.h"
 #include "../connectors/connector.h"
@@ -70,6 +77,54 @@ void debugExec(const QString & msg, QSqlQuery & query) {
 #endif
 }
 
+static QString lastCommitSha(QSqlDatabase & db) {
+	QSqlQuery query = db.exec("SELECT sha FROM lastcommit where id=0");
+	debugError(query.isActive(), query);
+	if (query.isActive() && query.next()) {
+		return query.value(0).toString();
+	}
+
+	return "";
+}
+
+static bool usePartsIndex() {
+	return QSettings().value("partsIndex", false).toBool();
+}
+
+struct PartFile {
+	QString path;                   // as read from disk
+	QString storedPath;             // as the parts table stores it
+	QString moduleID;
+	qint64 mtime = 0;               // 0 for resources, so they are always hashed
+	QByteArray hash;
+};
+
+static qint64 modifiedTime(const QString & path) {
+	QDateTime modified = QFileInfo(path).lastModified();
+	return modified.isValid() ? modified.toMSecsSinceEpoch() : 0;
+}
+
+static void hashPartFile(PartFile & partFile) {
+	// thread pool safe: touches nothing but the one file
+	partFile.mtime = modifiedTime(partFile.path);
+	QFile file(partFile.path);
+	if (!file.open(QIODevice::ReadOnly)) return;
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(&file);
+	partFile.hash = hash.result().toHex();
+}
+
+static QString storedPartPath(const QString & path) {
+	// same relative form insertPart gives the parts table
+	QString prefix = FolderUtils::getAppPartsSubFolderPath("");
+	if (!path.startsWith(ResourcePath) && path.startsWith(prefix)) {
+		return path.mid(prefix.count() + 1);
+	}
+
+	return path;
+}
+
 void killConnectors(QVector<Connector *> & connectors) {
 	Q_FOREACH (Connector * connector, connectors) {
 		delete connector->connectorShared();
@@ -102,6 +157,8 @@ void noSwappingMessage(int n)
 SqliteReferenceModel::SqliteReferenceModel() {
 	m_swappingEnabled = false;
 	m_lastWasExactMatch = true;
+	m_lazyLoad = false;
+	m_propertyIndexDirty = true;
 }
 
 bool SqliteReferenceModel::loadAll(const QString & databaseName, bool fullLoad, bool dbExists)
@@ -124,6 +181,11 @@ bool SqliteReferenceModel::loadAll(const QString & databaseName, bool fullLoad,
 	 * the same family and providing exactly the same properties set
 	 */
 
+	if (m_swappingEnabled && fullLoad && !databaseName.isEmpty() && usePartsIndex()) {
+		// the database was just built, so build its index alongside
+		PartsIndex::write(PartsIndex::defaultPath(), PartsIndex::makeStamp(m_sha, databaseName), m_database);
+	}
+
 	DebugDialog::debug("referenceModel::loadAll completed");
 	if (!m_swappingEnabled) {
 		noSwappingMessage(1);
@@ -183,8 +245,30 @@ bool SqliteReferenceModel::loadFromDB(const QString & databaseName)
 	}
 	*/
 
-	m_swappingEnabled = loadFromDB(m_database, db);
-	if (db.isOpen()) db.close();
+	// a lazy load keeps the parts database open to fill in parts on first use;
+	// otherwise the parts index, when turned on, stands in for the database until its sha changes
+	m_lazyLoad = QSettings().value("lazyPartLoading", false).toBool();
+	bool useIndex = !m_lazyLoad && usePartsIndex();
+	bool loaded = false;
+	if (useIndex && db.open()) {
+		PartsIndex index;
+		QString sha = lastCommitSha(db);
+		if (index.open(PartsIndex::defaultPath(), PartsIndex::makeStamp(sha, databaseName))) {
+			m_sha = sha;
+			m_swappingEnabled = loadFromIndex(m_database, index, QFileInfo(databaseName).absoluteDir());
+			loaded = true;
+		}
+	}
+	if (!loaded) {
+		m_swappingEnabled = loadFromDB(m_database, db);
+		if (m_swappingEnabled && useIndex) {
+			PartsIndex::write(PartsIndex::defaultPath(), PartsIndex::makeStamp(m_sha, databaseName), db);
+		}
+	}
+	if (m_swappingEnabled && m_lazyLoad) {
+		m_partsDatabase = db;
+	}
+	else if (db.isOpen()) db.close();
 	if (!m_swappingEnabled) {
 		killParts();
 		noSwappingMessage(2);
@@ -207,16 +291,9 @@ bool SqliteReferenceModel::loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db)
 		return false;
 	}
 
-	m_sha = "";
-	QSqlQuery  query = db.exec("SELECT sha FROM lastcommit where id=0");
-	debugError(query.isActive(), query);
-	if (query.isActive()) {
-		if (query.next()) {
-			m_sha = query.value(0).toString();
-		}
-	}
+	m_sha = lastCommitSha(db);
 
-	query = db.exec("SELECT COUNT(*) FROM parts");
+	QSqlQuery query = db.exec("SELECT COUNT(*) FROM parts");
 	debugError(query.isActive(), query);
 	if (!query.isActive() || !query.next()) return false;
 
@@ -288,6 +365,9 @@ bool SqliteReferenceModel::loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db)
 
 		m_partHash.insert(modelPartShared->moduleID(), modelPart);
 		parts[dbid] = modelPart;
+		if (m_lazyLoad) {
+			m_unhydrated.insert(moduleID, dbid);
+		}
 
 		q2.bindValue(":moduleID", modelPartShared->moduleID());
 		q2.bindValue(":family", family);
@@ -299,7 +379,12 @@ bool SqliteReferenceModel::loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db)
 		oldToNew[dbid] = newid;
 	}
 
-	query = db.exec("SELECT viewid, image, layers, sticky, flipvertical, fliphorizontal, part_id FROM viewimages");
+	// bins only need the icon until a part is retrieved
+	QString viewImagesQuery("SELECT viewid, image, layers, sticky, flipvertical, fliphorizontal, part_id FROM viewimages");
+	if (m_lazyLoad) {
+		viewImagesQuery += QString(" WHERE viewid = %1").arg(ViewLayer::IconView);
+	}
+	query = db.exec(viewImagesQuery);
 	debugError(query.isActive(), query);
 	if (!query.isActive()) return false;
 
@@ -360,6 +445,10 @@ bool SqliteReferenceModel::loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db)
 		}
 	}
 
+	if (m_lazyLoad) {
+		return loadSubpartsFromDB(db, parts);
+	}
+
 	query = db.exec("SELECT COUNT(*) FROM connectors");
 	debugError(query.isActive(), query);
 	if (!query.isActive() || !query.next()) return false;
@@ -481,7 +570,12 @@ bool SqliteReferenceModel::loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db)
 		}
 	}
 
-	query = db.exec("SELECT subpart_id, part_id FROM schematic_subparts");
+	return loadSubpartsFromDB(db, parts);
+}
+
+bool SqliteReferenceModel::loadSubpartsFromDB(QSqlDatabase & db, QVector<ModelPart *> & parts)
+{
+	QSqlQuery query = db.exec("SELECT subpart_id, part_id FROM schematic_subparts");
 	debugError(query.isActive(), query);
 	if (query.isActive()) {
 		while (query.next()) {
@@ -490,36 +584,319 @@ bool SqliteReferenceModel::loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db)
 			qulonglong dbid = query.value(ix++).toULongLong();
 			ModelPart * modelPart = parts.at(dbid);
 			if (modelPart != nullptr) {
-				QString subModuleID = modelPart->moduleID() + "_" + subpartID;
-				ModelPart * subModelPart = m_partHash.value(subModuleID);
-				if (subModelPart != nullptr) {
-					subModelPart->setSubpartID(subpartID);
-					modelPart->modelPartShared()->addSubpart(subModelPart->modelPartShared());
-				}
+				addSubpart(modelPart, subpartID);
 			}
 		}
 	}
 
+	return finishLoad();
+}
+
+void SqliteReferenceModel::addSubpart(ModelPart * modelPart, const QString & subpartID)
+{
+	QString subModuleID = modelPart->moduleID() + "_" + subpartID;
+	ModelPart * subModelPart = m_partHash.value(subModuleID);
+	if (subModelPart != nullptr) {
+		subModelPart->setSubpartID(subpartID);
+		modelPart->modelPartShared()->addSubpart(subModelPart->modelPartShared());
+	}
+}
+
+bool SqliteReferenceModel::finishLoad()
+{
 	if (m_root == nullptr) {
 		m_root = new ModelPart();
 	}
 	Q_FOREACH (ModelPart * modelPart, m_partHash.values()) {
 		if (modelPart->dbid() != 0) {
-			// initConnectors is not redundant here
-			// there may be parts in m_partHash loaded from a file rather from the database
-			//
-			modelPart->initConnectors();
-			modelPart->flipSMDAnd();
-			modelPart->initBuses();
+			if (!m_unhydrated.contains(modelPart->moduleID())) {
+				// initConnectors is not redundant here
+				// there may be parts in m_partHash loaded from a file rather from the database
+				//
+				modelPart->initConnectors();
+				modelPart->flipSMDAnd();
+				modelPart->initBuses();
+			}
 			modelPart->setParent(m_root);
 		}
 	}
+	m_searchIndexDirty = true;
+	m_propertyIndexDirty = true;
 
 	return true;
 }
 
+bool SqliteReferenceModel::loadFromIndex(QSqlDatabase & keep_db, const PartsIndex & index, const QDir & partsDir)
+{
+	// loadFromDB reading from a mapped parts index instead of the parts database
+
+	quint32 maxPartID = 0;
+	for (const PartsIndex::Part & record : index.parts()) maxPartID = qMax(maxPartID, record.dbid);
+	if (index.parts().count == 0) return false;
+
+	DebugDialog::debug(QString("parts count %1 (index)").arg(index.parts().count));
+
+	QVector<ModelPart *> parts(maxPartID + 1, NULL);
+	QHash<quint32, qulonglong> oldToNew;
+
+	QSqlQuery q2(keep_db);
+	bool result = q2.prepare("INSERT INTO parts(moduleID, family, core) VALUES (:moduleID, :family, :core)");
+	debugError(result, q2);
+
+	for (const PartsIndex::Part & record : index.parts()) {
+		QString path = index.string(record.path);
+		const QString & moduleID = index.string(record.moduleID);
+		if (m_partHash.value(moduleID, NULL) != nullptr) {
+			// a part with this moduleID was already loaded--the file version overrides the db version
+			continue;
+		}
+
+		if (!path.startsWith(ResourcePath)) {        // not the resources path
+			path = partsDir.absoluteFilePath(path);
+			if (QFileInfo(path).exists()) {
+				CoreList << moduleID;
+			}
+		}
+
+		auto * modelPart = new ModelPart();
+		auto * modelPartShared = new ModelPartShared();
+		modelPart->setModelPartShared(modelPartShared);
+
+		modelPartShared->setModuleID(moduleID);
+		modelPartShared->setDBID(record.dbid);
+		modelPartShared->setFamily(index.string(record.family));
+		modelPartShared->setVersion(index.string(record.version));
+		modelPartShared->setReplacedby(index.string(record.replacedby));
+		modelPartShared->setFritzingVersion(index.string(record.fritzingVersion));
+		modelPartShared->setAuthor(index.string(record.author));
+		modelPartShared->setTitle(index.string(record.title));
+		modelPartShared->setLabel(index.string(record.label));
+		modelPartShared->setDate(index.string(record.date));
+		modelPartShared->setDescription(index.string(record.description));
+		modelPartShared->setSpice(index.string(record.spice));
+		modelPartShared->setSpiceModel(index.string(record.spiceModel));
+		modelPartShared->setTaxonomy(index.string(record.taxonomy));
+		modelPart->setItemType((ModelPart::ItemType) record.itemType);
+		modelPartShared->setPath(path);
+		modelPart->setCore(true);
+
+		modelPartShared->setConnectorsInitialized(true);
+
+		m_partHash.insert(moduleID, modelPart);
+		parts[record.dbid] = modelPart;
+
+		q2.bindValue(":moduleID", moduleID);
+		q2.bindValue(":family", index.string(record.family));
+		q2.bindValue(":core", "1");
+		bool result = q2.exec();
+		if (!result) debugExec("unable to add part to memory", q2);
+
+		oldToNew.insert(record.dbid, q2.lastInsertId().toULongLong());
+	}
+
+	for (const PartsIndex::ViewImage & record : index.viewImages()) {
+		ModelPart * modelPart = parts.value(record.part, nullptr);
+		if (modelPart == nullptr) continue;
+
+		auto * viewImage = new ViewImage(ViewLayer::BreadboardView);
+		viewImage->viewID = (ViewLayer::ViewID) record.viewID;
+		viewImage->image = index.string(record.image);
+		viewImage->layers = record.layers;
+		viewImage->sticky = record.sticky;
+		viewImage->canFlipVertical = (record.flags & PartsIndex::FlipVertical) != 0;
+		viewImage->canFlipHorizontal = (record.flags & PartsIndex::FlipHorizontal) != 0;
+		modelPart->setViewImage(viewImage);
+	}
+
+	for (const PartsIndex::Tag & record : index.tags()) {
+		ModelPart * modelPart = parts.value(record.part, nullptr);
+		if (modelPart != nullptr) {
+			modelPart->setTag(index.string(record.tag));
+		}
+	}
+
+	QSqlQuery q3(keep_db);
+	result = q3.prepare("INSERT INTO properties(name, value, part_id, show_in_label) VALUES (:name, :value, :part_id, :show_in_label)");
+	debugError(result, q3);
+
+	for (const PartsIndex::Property & record : index.properties()) {
+		ModelPart * modelPart = parts.value(record.part, nullptr);
+		if (modelPart == nullptr) continue;
+
+		const QString & name = index.string(record.name);
+		const QString & value = index.string(record.value);
+		modelPart->setProperty(name, value, record.showInLabel != 0);
+		q3.bindValue(":name", name.toLower().trimmed());
+		q3.bindValue(":value", value);
+		q3.bindValue(":part_id", oldToNew.value(record.part));
+		q3.bindValue(":show_in_label", record.showInLabel);
+		bool result = q3.exec();
+		if (!result) debugExec("unable to add property to memory", q3);
+	}
+
+	if (index.connectors().count == 0) return false;
+
+	QHash<quint32, Connector *> connectors;
+	connectors.reserve(index.connectors().count);
+	for (const PartsIndex::Connector & record : index.connectors()) {
+		ModelPart * modelPart = parts.value(record.part, nullptr);
+		if (modelPart == nullptr) continue;
+
+		auto * connectorShared = new ConnectorShared();
+		connectorShared->setConnectorType((Connector::ConnectorType) record.type);
+		connectorShared->setDescription(index.string(record.description));
+		connectorShared->setReplacedby(index.string(record.replacedby));
+		connectorShared->setSharedName(index.string(record.name));
+		connectorShared->setId(index.string(record.connectorID));
+
+		auto * connector = new Connector(connectorShared, modelPart);
+		modelPart->addConnector(connector);
+		connectors.insert(record.id, connector);
+	}
+
+	for (const PartsIndex::ConnectorLayer & record : index.connectorLayers()) {
+		Connector * connector = connectors.value(record.connector, nullptr);
+		if (connector != nullptr) {
+			connector->addPin((ViewLayer::ViewID) record.view, index.string(record.svgID), (ViewLayer::ViewLayerID) record.layer,
+			                  index.string(record.terminalID), index.string(record.legID), record.hybrid != 0);
+		}
+	}
+
+	if (index.buses().count == 0) return false;
+
+	QHash<quint32, QPair<BusShared *, ModelPart *> > buses;
+	for (const PartsIndex::Bus & record : index.buses()) {
+		ModelPart * modelPart = parts.value(record.part, nullptr);
+		if (modelPart == nullptr) continue;
+
+		auto * busShared = new BusShared(index.string(record.name));
+		modelPart->modelPartShared()->insertBus(busShared);
+		buses.insert(record.id, qMakePair(busShared, modelPart));
+	}
+
+	for (const PartsIndex::BusMember & record : index.busMembers()) {
+		auto it = buses.constFind(record.bus);
+		if (it == buses.constEnd()) continue;
+
+		ConnectorShared * connectorShared = it.value().second->modelPartShared()->getConnectorShared(index.string(record.connectorID));
+		it.value().first->addConnectorShared(connectorShared);
+	}
+
+	for (const PartsIndex::Subpart & record : index.subparts()) {
+		ModelPart * modelPart = parts.value(record.part, nullptr);
+		if (modelPart != nullptr) {
+			addSubpart(modelPart, index.string(record.subpartID));
+		}
+	}
+
+	return finishLoad();
+}
+
+void SqliteReferenceModel::hydrate(ModelPart * modelPart)
+{
+	// fills in the view images, connectors and buses left out by a lazy load, following loadFromDB
+	qulonglong dbid = m_unhydrated.take(modelPart->moduleID());
+	if (!m_partsDatabase.isOpen()) {
+		DebugDialog::debug(QString("parts database closed before hydrating %1").arg(modelPart->moduleID()));
+		return;
+	}
+
+	QSqlQuery query(m_partsDatabase);
+	query.prepare(QString("SELECT viewid, image, layers, sticky, flipvertical, fliphorizontal FROM viewimages WHERE part_id = :part_id AND viewid <> %1").arg(ViewLayer::IconView));
+	query.bindValue(":part_id", dbid);
+	bool result = query.exec();
+	debugError(result, query);
+	while (result && query.next()) {
+		int ix = 0;
+		auto * viewImage = new ViewImage(ViewLayer::BreadboardView);
+		viewImage->viewID = (ViewLayer::ViewID) query.value(ix++).toInt();
+		viewImage->image = query.value(ix++).toString();
+		viewImage->layers = query.value(ix++).toULongLong();
+		viewImage->sticky = query.value(ix++).toULongLong();
+		viewImage->canFlipVertical = query.value(ix++).toInt() == 0 ? false : true;
+		viewImage->canFlipHorizontal = query.value(ix++).toInt() == 0 ? false : true;
+		modelPart->setViewImage(viewImage);
+	}
+
+	QHash<qulonglong, Connector *> connectors;
+	query.prepare("SELECT id, connectorid, type, name, description, replacedby FROM connectors WHERE part_id = :part_id");
+	query.bindValue(":part_id", dbid);
+	result = query.exec();
+	debugError(result, query);
+	while (result && query.next()) {
+		int ix = 0;
+		qulonglong cid = query.value(ix++).toULongLong();
+		auto * connectorShared = new ConnectorShared();
+		connectorShared->setId(query.value(ix++).toString());
+		connectorShared->setConnectorType((Connector::ConnectorType) query.value(ix++).toInt());
+		connectorShared->setSharedName(query.value(ix++).toString());
+		connectorShared->setDescription(query.value(ix++).toString());
+		connectorShared->setReplacedby(query.value(ix++).toString());
+
+		auto * connector = new Connector(connectorShared, modelPart);
+		modelPart->addConnector(connector);
+		connectors.insert(cid, connector);
+	}
+
+	query.prepare("SELECT view, layer, svgid, hybrid, terminalid, legid, connector_id FROM connectorlayers "
+	              "WHERE connector_id IN (SELECT id FROM connectors WHERE part_id = :part_id)");
+	query.bindValue(":part_id", dbid);
+	result = query.exec();
+	debugError(result, query);
+	while (result && query.next()) {
+		int ix = 0;
+		ViewLayer::ViewID viewID = (ViewLayer::ViewID) query.value(ix++).toInt();
+		ViewLayer::ViewLayerID viewLayerID = (ViewLayer::ViewLayerID) query.value(ix++).toInt();
+		QString svgID = query.value(ix++).toString();
+		bool hybrid = query.value(ix++).toInt() == 0 ? false : true;
+		QString terminalID = query.value(ix++).toString();
+		QString legID = query.value(ix++).toString();
+		Connector * connector = connectors.value(query.value(ix++).toULongLong(), nullptr);
+		if (connector != nullptr) {
+			connector->addPin(viewID, svgID, viewLayerID, terminalID, legID, hybrid);
+		}
+	}
+
+	QHash<qulonglong, BusShared *> buses;
+	query.prepare("SELECT id, name FROM buses WHERE part_id = :part_id");
+	query.bindValue(":part_id", dbid);
+	result = query.exec();
+	debugError(result, query);
+	while (result && query.next()) {
+		auto * busShared = new BusShared(query.value(1).toString());
+		modelPart->modelPartShared()->insertBus(busShared);
+		buses.insert(query.value(0).toULongLong(), busShared);
+	}
+
+	if (buses.count() > 0) {
+		query.prepare("SELECT connectorid, bus_id FROM busmembers "
+		              "WHERE bus_id IN (SELECT id FROM buses WHERE part_id = :part_id)");
+		query.bindValue(":part_id", dbid);
+		result = query.exec();
+		debugError(result, query);
+		while (result && query.next()) {
+			BusShared * busShared = buses.value(query.value(1).toULongLong(), nullptr);
+			if (busShared != nullptr) {
+				busShared->addConnectorShared(modelPart->modelPartShared()->getConnectorShared(query.value(0).toString()));
+			}
+		}
+	}
+
+	modelPart->initConnectors();
+	modelPart->flipSMDAnd();
+	modelPart->initBuses();
+
+	Q_FOREACH (ModelPartShared * subpartShared, modelPart->modelPartShared()->subparts()) {
+		ModelPart * subModelPart = m_partHash.value(subpartShared->moduleID(), NULL);
+		if (subModelPart != nullptr && m_unhydrated.contains(subModelPart->moduleID())) {
+			hydrate(subModelPart);
+		}
+	}
+}
+
 
 SqliteReferenceModel::~SqliteReferenceModel() {
+	if (m_partsDatabase.isOpen()) m_partsDatabase.close();
 	deleteConnection();
 }
 
@@ -531,6 +908,8 @@ void SqliteReferenceModel::initParts(bool dbExists) {
 
 bool SqliteReferenceModel::createDatabase(const QString & databaseName, bool fullLoad) {
 	m_swappingEnabled = true;
+	m_propertyIndexDirty = true;
+	m_preparedQueries.clear();
 	m_database = QSqlDatabase::addDatabase("QSQLITE");
 	m_database.setDatabaseName(databaseName.isEmpty() ? ":memory:" : databaseName);
 	if (!m_database.open()) {
@@ -622,6 +1001,15 @@ bool SqliteReferenceModel::createDatabase(const QString & databaseName, bool ful
 		                    ")");
 		debugError(result, query);
 
+		result = query.exec("CREATE TABLE files (\n"
+		                    "id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,\n"
+		                    "path TEXT NOT NULL,\n"                        // relative to the parts folder, as in parts.path
+		                    "mtime INTEGER NOT NULL,\n"                    // msecs since epoch
+		                    "hash TEXT NOT NULL,\n"                        // sha1 of the fzp
+		                    "moduleID TEXT NOT NULL"
+		                    ")");
+		debugError(result, query);
+
 		result = createProperties(m_database);
 
 		if (!result) {
@@ -654,6 +1042,10 @@ bool SqliteReferenceModel::createDatabase(const QString & databaseName, bool ful
 			addPartAux(mp, fullLoad);
 		}
 
+		if (fullLoad) {
+			insertPartFiles();
+		}
+
 		createIndexes();
 		createMoreIndexes(m_database);
 
@@ -663,7 +1055,193 @@ bool SqliteReferenceModel::createDatabase(const QString & databaseName, bool ful
 	return m_swappingEnabled;
 }
 
+void SqliteReferenceModel::insertPartFiles() {
+	// records the fzp behind each part, so updateDatabase can tell which ones changed
+	QString prefix = FolderUtils::getAppPartsSubFolderPath("");
+	QVector<PartFile> partFiles;
+	Q_FOREACH (ModelPart * mp, m_partHash.values()) {
+		if (mp->itemType() == ModelPart::SchematicSubpart) continue;        // rides on its superpart's fzp
+		if (!mp->path().startsWith(ResourcePath) && !mp->path().startsWith(prefix)) continue;
+
+		PartFile partFile;
+		partFile.path = mp->path();
+		partFile.storedPath = storedPartPath(mp->path());
+		partFile.moduleID = mp->moduleID();
+		partFiles.append(partFile);
+	}
+
+	QtConcurrent::blockingMap(partFiles, hashPartFile);
+	Q_FOREACH (const PartFile & partFile, partFiles) {
+		insertPartFile(partFile.storedPath, partFile.mtime, partFile.hash, partFile.moduleID);
+	}
+}
+
+bool SqliteReferenceModel::insertPartFile(const QString & storedPath, qint64 mtime, const QByteArray & hash, const QString & moduleID) {
+	QSqlQuery & query = preparedQuery("INSERT INTO files(path, mtime, hash, moduleID) VALUES (:path, :mtime, :hash, :moduleID)");
+	query.bindValue(":path", storedPath);
+	query.bindValue(":mtime", mtime);
+	query.bindValue(":hash", QString(hash));
+	query.bindValue(":moduleID", moduleID);
+	bool result = query.exec();
+	debugError(result, query);
+	return result;
+}
+
+bool SqliteReferenceModel::updateDatabase(const QString & databaseName, const QString & sha) {
+	// brings an existing full parts database up to date, re-reading only the fzps which were added,
+	// removed, or whose hash changed since the last build; returns false when the database has no
+	// file records, in which case it has to be rebuilt from scratch
+	FailurePartMessages.clear();
+	FailurePropertyMessages.clear();
+	m_fullLoad = true;
+	m_swappingEnabled = true;
+	m_preparedQueries.clear();
+	m_database = QSqlDatabase::addDatabase("QSQLITE");
+	m_database.setDatabaseName(databaseName);
+	if (!m_database.open()) {
+		return m_swappingEnabled = false;
+	}
+
+	QHash<QString /*storedPath*/, PartFile> stored;
+	QSqlQuery query(m_database);
+	if (query.exec("SELECT path, mtime, hash, moduleID FROM files")) {
+		while (query.next()) {
+			PartFile partFile;
+			partFile.storedPath = query.value(0).toString();
+			partFile.mtime = query.value(1).toLongLong();
+			partFile.hash = query.value(2).toString().toUtf8();
+			partFile.moduleID = query.value(3).toString();
+			stored.insert(partFile.storedPath, partFile);
+		}
+	}
+	if (stored.isEmpty()) {
+		DebugDialog::debug("parts database has no file records");
+		return m_swappingEnabled = false;
+	}
+
+	QStringList nameFilters(QString("*") + FritzingPartExtension);
+	QDir partsDir = FolderUtils::getAppPartsSubFolder("");
+	QDir resourcesDir(":/resources/parts");
+	QVector<FzpFile> fzpFiles;
+	collectParts(partsDir, nameFilters, fzpFiles);
+	collectParts(resourcesDir, nameFilters, fzpFiles);
+
+	// only files whose mtime moved get hashed
+	QSet<QString> current;
+	QVector<PartFile> touched;
+	Q_FOREACH (const FzpFile & fzpFile, fzpFiles) {
+		PartFile partFile;
+		partFile.path = fzpFile.path;
+		partFile.storedPath = storedPartPath(fzpFile.path);
+		current.insert(partFile.storedPath);
+		auto it = stored.constFind(partFile.storedPath);
+		if (it != stored.constEnd() && it.value().mtime != 0 && it.value().mtime == modifiedTime(fzpFile.path)) continue;
+
+		touched.append(partFile);
+	}
+	QtConcurrent::blockingMap(touched, hashPartFile);
+
+	QList<PartFile> removed;
+	QList<PartFile> changed;
+	QList<PartFile> unchanged;
+	Q_FOREACH (PartFile partFile, touched) {
+		auto it = stored.constFind(partFile.storedPath);
+		if (it != stored.constEnd()) {
+			partFile.moduleID = it.value().moduleID;
+			if (it.value().hash == partFile.hash) {
+				unchanged.append(partFile);
+				continue;
+			}
+			removed.append(partFile);
+		}
+		changed.append(partFile);
+	}
+	Q_FOREACH (const PartFile & partFile, stored) {
+		if (!current.contains(partFile.storedPath)) removed.append(partFile);
+	}
+
+	DebugDialog::debug(QString("updating parts database: %1 new or changed, %2 removed or changed, %3 touched")
+	                   .arg(changed.count()).arg(removed.count()).arg(unchanged.count()));
+
+	m_database.transaction();
+
+	Q_FOREACH (const PartFile & partFile, removed) {
+		removePartAndSubpartsFromDataBase(partFile.moduleID);
+		QSqlQuery & remove = preparedQuery("DELETE FROM files WHERE path = :path");
+		remove.bindValue(":path", partFile.storedPath);
+		debugError(remove.exec(), remove);
+	}
+
+	Q_FOREACH (const PartFile & partFile, unchanged) {
+		QSqlQuery & update = preparedQuery("UPDATE files SET mtime = :mtime WHERE path = :path");
+		update.bindValue(":mtime", partFile.mtime);
+		update.bindValue(":path", partFile.storedPath);
+		debugError(update.exec(), update);
+	}
+
+	Q_FOREACH (const PartFile & partFile, changed) {
+		ModelPart * modelPart = PaletteModel::loadPart(partFile.path, false);
+		if (modelPart == nullptr) continue;
+
+		if (partId(modelPart->moduleID()) != NO_ID) {
+			// the trigger on parts would roll the whole update back
+			DebugDialog::debug(QString("duplicate module id %1 in %2").arg(modelPart->moduleID()).arg(partFile.path));
+			continue;
+		}
+
+		QList<ModelPart *> modelParts;
+		modelParts << modelPart;
+		Q_FOREACH (ModelPartShared * sub, modelPart->modelPartShared()->subparts()) {
+			ModelPart * subModelPart = m_partHash.value(sub->moduleID());
+			if (subModelPart != nullptr) modelParts << subModelPart;
+		}
+		Q_FOREACH (ModelPart * mp, modelParts) {
+			mp->initConnectors(false);
+			addPartAux(mp, true);
+		}
+
+		insertPartFile(partFile.storedPath, partFile.mtime, partFile.hash, modelPart->moduleID());
+	}
+
+	m_sha = sha;
+	QSqlQuery & commit = preparedQuery("UPDATE lastcommit SET sha = :sha WHERE id = 0");
+	commit.bindValue(":sha", sha);
+	debugError(commit.exec(), commit);
+
+	if (!m_database.commit()) {
+		m_swappingEnabled = false;
+	}
+
+	return m_swappingEnabled;
+}
+
+bool SqliteReferenceModel::removePartAndSubpartsFromDataBase(const QString & moduleID) {
+	qulonglong id = partId(moduleID);
+	if (id == NO_ID) return false;
+
+	QStringList subpartIDs;
+	QSqlQuery query;
+	query.prepare("SELECT subpart_id FROM schematic_subparts WHERE part_id = :id");
+	query.bindValue(":id", id);
+	if (query.exec()) {
+		while (query.next()) {
+			subpartIDs << query.value(0).toString();
+		}
+	}
+	else {
+		debugExec("couldn't retrieve subparts", query);
+	}
+
+	// subpart module ids are made the same way addSubpart looks them up
+	Q_FOREACH (QString subpartID, subpartIDs) {
+		removePartFromDataBase(moduleID + "_" + subpartID);
+	}
+
+	return removePartFromDataBase(moduleID);
+}
+
 void SqliteReferenceModel::deleteConnection() {
+	m_preparedQueries.clear();
 	QSqlDatabase::removeDatabase("SQLITE");
 }
 
@@ -679,7 +1257,11 @@ ModelPart *SqliteReferenceModel::retrieveModelPart(const QString &moduleID) {
 	if (moduleID.isEmpty()) {
 		return nullptr;
 	}
-	return m_partHash.value(moduleID, NULL);
+	ModelPart * modelPart = m_partHash.value(moduleID, NULL);
+	if (modelPart != nullptr && m_unhydrated.contains(moduleID)) {
+		hydrate(modelPart);
+	}
+	return modelPart;
 }
 
 QString SqliteReferenceModel::retrieveModuleIdWith(const QString &family, const QString &propertyName, bool closestMatch) {
@@ -693,42 +1275,11 @@ QString SqliteReferenceModel::retrieveModuleId(const QString &family, const QMul
 	QString propertyValue;
 
 	if(!properties.empty()) {
-		QString queryStr =
-		    "SELECT moduleID FROM parts part \n"
-		    "WHERE part.family = :family AND (1=1 ";
-		QHash<QString, QString> params;
-		int ix = 0;
-		Q_FOREACH (QString name, properties.uniqueKeys()) {
-			Q_FOREACH (QString value, properties.values(name)) {
-				QString propParam = QString(":prop%1").arg(ix++);
-				queryStr += QString(" AND EXISTS (SELECT * FROM properties prop WHERE prop.part_id = part.id AND prop.name = %1_name AND prop.value = %1_value)").arg(propParam);
-				params[propParam+"_name"] = name;
-				params[propParam+"_value"] = value;
-				if(name == propertyName) {
-					propertyValue = value;
-				}
-			}
-		}
-		queryStr += ") order by part.core desc";
-
-		QSqlQuery query;
-		query.prepare(queryStr);
-
-		query.bindValue(":family",family.toLower().trimmed());
-		Q_FOREACH(QString name, params.keys()) {
-			query.bindValue(name,params[name].toLower().trimmed());
-		}
-
-		QString moduleId;
-		if(query.exec()) {
-			if(query.next()) {
-				moduleId =  query.value(0).toString(); //grab the first
-			}
-			//DebugDialog::debug("SQLITE: found: "+moduleId);
-		} else {
-			debugExec("couldn't retrieve part", query);
+		Q_FOREACH (QString value, properties.values(propertyName)) {
+			propertyValue = value;
 		}
 
+		QString moduleId = propertyIndex().exactMatch(family, properties);
 		if(!moduleId.isEmpty()) {
 			m_lastWasExactMatch = true;
 			return moduleId;
@@ -744,78 +1295,16 @@ QString SqliteReferenceModel::retrieveModuleId(const QString &family, const QMul
 }
 
 QString SqliteReferenceModel::closestMatchId(const QString &family, const QMultiHash<QString, QString> &properties, const QString &propertyName, const QString &propertyValue) {
-	QStringList possibleMatches = getPossibleMatches(family, properties, propertyName, propertyValue);
-	return getClosestMatch(family, properties, possibleMatches);
+	return propertyIndex().closestMatch(family, properties, propertyName, propertyValue);
 }
 
-QStringList SqliteReferenceModel::getPossibleMatches(const QString &family, const QMultiHash<QString, QString> &properties, const QString &propertyName, const QString &propertyValue) {
-	Q_UNUSED(properties);
-
-	QStringList result;
-	QString queryStr =
-	    "SELECT moduleID FROM parts part \n"
-	    "WHERE part.family = :family AND EXISTS ( \n"
-	    "SELECT * FROM properties prop \n"
-	    "WHERE prop.part_id = part.id %1 \n"
-	    ") ";
-	queryStr = queryStr.arg((propertyName.isEmpty()) ? "" : "AND prop.name = :prop_name  AND prop.value = :prop_value ");
-	QSqlQuery query;
-	query.prepare(queryStr);
-
-	query.bindValue(":family", family.toLower().trimmed());
-	if (!propertyName.isEmpty()) {
-		query.bindValue(":prop_name", propertyName.toLower().trimmed());
-		query.bindValue(":prop_value", propertyValue);
+const PropertyIndex & SqliteReferenceModel::propertyIndex() {
+	// rebuilt from the database after parts are added or removed
+	if (m_propertyIndexDirty) {
+		m_propertyIndex.build(m_database);
+		m_propertyIndexDirty = false;
 	}
-
-
-	if(query.exec()) {
-		while(query.next()) {
-			result << query.value(0).toString();
-		}
-		//DebugDialog::debug(QString("SQLITE: %1 possible matches found").arg(result.size()));
-	} else {
-		debugExec("couldn't get possible match", query);
-	}
-
-	return result;
-}
-
-QString SqliteReferenceModel::getClosestMatch(const QString &family, const QMultiHash<QString, QString> &properties, QStringList possibleMatches) {
-	int propsInCommonCount = 0;
-	int propsInCommonCountAux = 0;
-	QString result;
-	Q_FOREACH(QString modId, possibleMatches) {
-		propsInCommonCountAux = countPropsInCommon(family, properties, retrieveModelPart(modId));
-		if(propsInCommonCountAux > propsInCommonCount) {
-			result = modId;
-			propsInCommonCount = propsInCommonCountAux;
-		}
-	}
-	return result;
-}
-
-int SqliteReferenceModel::countPropsInCommon(const QString &family, const QMultiHash<QString, QString> &properties, const ModelPart *part2) {
-	Q_UNUSED(family)
-
-	if (part2 == nullptr) {
-		DebugDialog::debug("countPropsInCommon failure");
-		return 0;
-	}
-
-	int result = 0;
-	QHash<QString,QString> props2 = part2->properties();
-	Q_FOREACH(QString prop, properties.uniqueKeys()) {
-		QStringList values1 = properties.values(prop);
-		QStringList values2;
-		values2.append(props2.value(prop));
-		Q_FOREACH (QString value1, values1) {
-			if (values2.contains(value1)) {
-				result++;
-			}
-		}
-	}
-	return result;
+	return m_propertyIndex;
 }
 
 bool SqliteReferenceModel::lastWasExactMatch() {
@@ -855,8 +1344,23 @@ ModelPart * SqliteReferenceModel::addPart(QString newPartPath, bool addToReferen
 	return PaletteModel::addPart(newPartPath, addToReference, updateIdAlreadyExists);
 }
 
+bool SqliteReferenceModel::beginBatch() {
+	// parts added until the matching endBatch share one transaction instead of committing one by one
+	if (m_batchDepth++ > 0) return true;
+
+	return m_database.transaction();
+}
+
+bool SqliteReferenceModel::endBatch() {
+	if (m_batchDepth <= 0) return false;
+	if (--m_batchDepth > 0) return true;
+
+	return m_database.commit();
+}
+
 bool SqliteReferenceModel::removePart(const QString &moduleId) {
 	m_partHash.remove(moduleId);
+	m_unhydrated.remove(moduleId);
 	return removePartFromDataBase(moduleId);
 }
 
@@ -864,6 +1368,7 @@ bool SqliteReferenceModel::removePartFromDataBase(const QString & moduleId) {
 	qulonglong partId = this->partId(moduleId);
 	if(partId == NO_ID) return false;
 
+	m_propertyIndexDirty = true;
 	removePart(partId);
 	removeProperties(partId);
 	removeViewImages(partId);
@@ -877,6 +1382,7 @@ bool SqliteReferenceModel::removePartFromDataBase(const QString & moduleId) {
 
 ModelPart * SqliteReferenceModel::reloadPart(const QString & path, const QString & moduleID) {
 	m_partHash.remove(moduleID);
+	m_unhydrated.remove(moduleID);
 	ModelPart *modelPart = PaletteModel::loadPart(path, false);
 	if (modelPart == nullptr) return modelPart;
 
@@ -898,9 +1404,9 @@ bool SqliteReferenceModel::updatePart(ModelPart * newModel) {
 
 bool SqliteReferenceModel::insertPart(ModelPart * modelPart, bool fullLoad) {
 	DebugModelPart = modelPart;
+	m_propertyIndexDirty = true;
 
 	QHash<QString, QString> properties = modelPart->properties();
-	QSqlQuery query;
 	QString fields;
 	QString values;
 	if (fullLoad) {
@@ -911,7 +1417,7 @@ bool SqliteReferenceModel::insertPart(ModelPart * modelPart, bool fullLoad) {
 		fields =  " core";
 		values = " :core";
 	}
-	query.prepare(QString("INSERT INTO parts(moduleID, family, %1) VALUES (:moduleID, :family, %2)").arg(fields).arg(values));
+	QSqlQuery & query = preparedQuery(QString("INSERT INTO parts(moduleID, family, %1) VALUES (:moduleID, :family, %2)").arg(fields).arg(values));
 	query.bindValue(":moduleID", modelPart->moduleID());
 	query.bindValue(":family", properties.value("family").toLower().trimmed());
 	if (fullLoad) {
@@ -1009,9 +1515,19 @@ bool SqliteReferenceModel::insertPart(ModelPart * modelPart, bool fullLoad) {
 	return true;
 }
 
+QSqlQuery & SqliteReferenceModel::preparedQuery(const QString & sql) {
+	// the inserts run once per part, property, connector and layer, so each statement is prepared once per database
+	auto it = m_preparedQueries.find(sql);
+	if (it == m_preparedQueries.end()) {
+		it = m_preparedQueries.insert(sql, QSqlQuery(m_database));
+		bool result = it.value().prepare(sql);
+		debugError(result, it.value());
+	}
+	return it.value();
+}
+
 bool SqliteReferenceModel::insertProperty(const QString & name, const QString & value, qulonglong id, bool showInLabel) {
-	QSqlQuery query;
-	query.prepare("INSERT INTO properties(name, value, part_id, show_in_label) VALUES (:name, :value, :part_id, :show_in_label)");
+	QSqlQuery & query = preparedQuery("INSERT INTO properties(name, value, part_id, show_in_label) VALUES (:name, :value, :part_id, :show_in_label)");
 	query.bindValue(":name", name.toLower().trimmed());
 	query.bindValue(":value", value);
 	query.bindValue(":part_id", id);
@@ -1028,8 +1544,7 @@ bool SqliteReferenceModel::insertProperty(const QString & name, const QString &
 
 bool SqliteReferenceModel::insertTag(const QString & tag, qulonglong id)
 {
-	QSqlQuery query;
-	query.prepare("INSERT INTO tags(tag, part_id) VALUES (:tag, :part_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO tags(tag, part_id) VALUES (:tag, :part_id)");
 	query.bindValue(":tag", tag.toLower().trimmed());
 	query.bindValue(":part_id", id);
 	if(!query.exec()) {
@@ -1046,9 +1561,8 @@ bool SqliteReferenceModel::insertViewImage(const ViewImage * viewImage, qulonglo
 {
 	if (viewImage->image.isEmpty() && viewImage->layers == 0) return true;
 
-	QSqlQuery query;
-	query.prepare("INSERT INTO viewimages(viewid, image, layers, sticky, flipvertical, fliphorizontal, part_id) "
-	              "VALUES (:viewid, :image, :layers, :sticky, :flipvertical, :fliphorizontal, :part_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO viewimages(viewid, image, layers, sticky, flipvertical, fliphorizontal, part_id) "
+	                                  "VALUES (:viewid, :image, :layers, :sticky, :flipvertical, :fliphorizontal, :part_id)");
 	query.bindValue(":viewid", viewImage->viewID);
 	query.bindValue(":image", viewImage->image);
 	query.bindValue(":layers", viewImage->layers);
@@ -1068,8 +1582,7 @@ bool SqliteReferenceModel::insertViewImage(const ViewImage * viewImage, qulonglo
 
 bool SqliteReferenceModel::insertBus(const Bus * bus, qulonglong id)
 {
-	QSqlQuery query;
-	query.prepare("INSERT INTO buses(name, part_id) VALUES (:name, :part_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO buses(name, part_id) VALUES (:name, :part_id)");
 	query.bindValue(":name", bus->id());
 	query.bindValue(":part_id", id);
 	if(!query.exec()) {
@@ -1087,8 +1600,7 @@ bool SqliteReferenceModel::insertBus(const Bus * bus, qulonglong id)
 
 bool SqliteReferenceModel::insertBusMember(const Connector * connector, qulonglong id)
 {
-	QSqlQuery query;
-	query.prepare("INSERT INTO busmembers(connectorid, bus_id) VALUES (:connectorid, :bus_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO busmembers(connectorid, bus_id) VALUES (:connectorid, :bus_id)");
 	query.bindValue(":connectorid", connector->connectorSharedID());
 	query.bindValue(":bus_id", id);
 	if(!query.exec()) {
@@ -1103,8 +1615,7 @@ bool SqliteReferenceModel::insertBusMember(const Connector * connector, qulonglo
 
 bool SqliteReferenceModel::insertConnector(const Connector * connector, qulonglong id)
 {
-	QSqlQuery query;
-	query.prepare("INSERT INTO connectors(connectorid, type, name, description, replacedby, part_id) VALUES (:connectorid, :type, :name, :description, :replacedby, :part_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO connectors(connectorid, type, name, description, replacedby, part_id) VALUES (:connectorid, :type, :name, :description, :replacedby, :part_id)");
 	query.bindValue(":connectorid", connector->connectorSharedID());
 	query.bindValue(":type", (int) connector->connectorType());
 	query.bindValue(":name", connector->connectorSharedName());
@@ -1128,9 +1639,8 @@ bool SqliteReferenceModel::insertConnector(const Connector * connector, qulonglo
 bool SqliteReferenceModel::insertConnectorLayer(const SvgIdLayer * svgIdLayer, qulonglong id)
 {
 
-	QSqlQuery query;
-	query.prepare("INSERT INTO connectorLayers(view, layer, svgid, hybrid, terminalid, legid, connector_id) VALUES "
-	              "(:view, :layer, :svgid, :hybrid, :terminalid, :legid, :connector_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO connectorLayers(view, layer, svgid, hybrid, terminalid, legid, connector_id) VALUES "
+	                                  "(:view, :layer, :svgid, :hybrid, :terminalid, :legid, :connector_id)");
 	query.bindValue(":view", svgIdLayer->m_viewID);
 	query.bindValue(":layer", svgIdLayer->m_svgViewLayerID);
 	query.bindValue(":svgid", svgIdLayer->m_svgId);
@@ -1247,7 +1757,8 @@ bool SqliteReferenceModel::removeProperties(qulonglong partId) {
 }
 
 QString SqliteReferenceModel::partTitle(const QString & moduleID) {
-	ModelPart *mp = retrieveModelPart(moduleID);
+	// the title is loaded up front, so no need to hydrate
+	ModelPart *mp = m_partHash.value(moduleID, NULL);
 	if(mp != nullptr) {
 		return mp->modelPartShared()->title();
 	} else {
@@ -1261,6 +1772,8 @@ void SqliteReferenceModel::killParts()
 		delete modelPart;
 	}
 	m_partHash.clear();
+	m_unhydrated.clear();
+	m_searchIndexDirty = true;
 }
 
 bool SqliteReferenceModel::createProperties(QSqlDatabase & db) {
@@ -1315,8 +1828,7 @@ bool SqliteReferenceModel::createParts(QSqlDatabase & db, bool fullLoad)
 
 bool SqliteReferenceModel::insertSubpart(ModelPartShared * mps, qulonglong id)
 {
-	QSqlQuery query;
-	query.prepare("INSERT INTO schematic_subparts(label, subpart_id, part_id) VALUES (:label, :subpart_id, :part_id)");
+	QSqlQuery & query = preparedQuery("INSERT INTO schematic_subparts(label, subpart_id, part_id) VALUES (:label, :subpart_id, :part_id)");
 	query.bindValue(":label", mps->label());
 	query.bindValue(":subpart_id", mps->subpartID());
 	query.bindValue(":part_id", id);
@@ -26,8 +26,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QApplication>
+#include <QDir>
+#include <QHash>
+#include <QVector>
 
 #include "referencemodel.h"
+#include "propertyindex.h"
 
 class SqliteReferenceModel : public ReferenceModel {
 	Q_OBJECT
@@ -37,6 +41,7 @@ public:
 
 	bool loadAll(const QString & databaseName, bool fullLoad, bool dbExists);
 	bool loadFromDB(const QString & databaseName);
+	bool updateDatabase(const QString & databaseName, const QString & sha);
 	ModelPart *loadPart(const QString & path, bool update);
 	ModelPart *reloadPart(const QString & path, const QString & moduleID);
 
@@ -45,6 +50,8 @@ public:
 	bool addPart(ModelPart * newModel, bool update);
 	bool updatePart(ModelPart * newModel);
 	ModelPart * addPart(QString newPartPath, bool addToReference, bool updateIdAlreadyExists);
+	bool beginBatch();
+	bool endBatch();
 
 	bool swapEnabled() const;
 	bool containsModelPart(const QString & moduleID);
@@ -67,13 +74,14 @@ protected:
 	bool addPartAux(ModelPart * newModel, bool fullLoad);
 
 	QString closestMatchId(const QString &family, const QMultiHash<QString, QString> &properties, const QString &propertyName, const QString &propertyValue);
-	QStringList getPossibleMatches(const QString &family, const QMultiHash<QString, QString> &properties, const QString &propertyName, const QString &propertyValue);
-	QString getClosestMatch(const QString &family, const QMultiHash<QString, QString> &properties, QStringList possibleMatches);
-	int countPropsInCommon(const QString &family, const QMultiHash<QString, QString> &properties, const ModelPart *part2);
+	const PropertyIndex & propertyIndex();
 
 	bool createDatabase(const QString & databaseName, bool fullLoad);
 	void deleteConnection();
+	void insertPartFiles();
+	bool insertPartFile(const QString & storedPath, qint64 mtime, const QByteArray & hash, const QString & moduleID);
 	bool insertPart(ModelPart *, bool fullLoad);
+	QSqlQuery & preparedQuery(const QString & sql);
 	bool insertProperty(const QString & name, const QString & value, qulonglong id, bool showInLabel);
 	bool insertTag(const QString & tag, qulonglong id);
 	bool insertViewImage(const struct ViewImage *, qulonglong id);
@@ -85,6 +93,11 @@ protected:
 	bool removePart(qulonglong partId);
 	bool removeProperties(qulonglong partId);
 	bool loadFromDB(QSqlDatabase & keep_db, QSqlDatabase & db);
+	bool loadSubpartsFromDB(QSqlDatabase & db, QVector<ModelPart *> & parts);
+	bool loadFromIndex(QSqlDatabase & keep_db, const class PartsIndex &, const QDir & partsDir);
+	void addSubpart(ModelPart *, const QString & subpartID);
+	bool finishLoad();
+	void hydrate(ModelPart *);
 	bool createProperties(QSqlDatabase &);
 	bool createParts(QSqlDatabase &, bool fullLoad);
 	bool insertSubpart(ModelPartShared *, qulonglong id);
@@ -99,15 +112,23 @@ protected:
 	bool removex(qulonglong id, const QString & tableName, const QString & idName);
 	bool removePart(const QString & moduleId);
 	bool removePartFromDataBase(const QString & moduleId);
+	bool removePartAndSubpartsFromDataBase(const QString & moduleID);
 
 protected:
 	volatile bool m_swappingEnabled;
 	volatile bool m_lastWasExactMatch;
 	volatile bool m_keepGoing;
 	bool m_init;
+	bool m_lazyLoad;
 	QSqlDatabase m_database;
+	QSqlDatabase m_partsDatabase;                       // stays open after a lazy load
+	QHash<QString /*moduleID*/, qulonglong /*dbid*/> m_unhydrated;
+	QHash<QString /*sql*/, QSqlQuery> m_preparedQueries;
+	PropertyIndex m_propertyIndex;
+	bool m_propertyIndexDirty;
 	QMultiHash<QString /*name*/, QString /*value*/> m_recordedProperties;
 	QString m_sha;
+	int m_batchDepth = 0;
 };
 
 #endif /* SQLITEREFERENCEMODEL_H_ */
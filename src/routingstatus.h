@@ -34,6 +34,13 @@ public:
 		m_netCount = m_netRoutedCount = m_connectorsLeftToRoute = m_jumperItemCount = 0;
 	}
 
+	void add(const RoutingStatus & other) {
+		m_netCount += other.m_netCount;
+		m_netRoutedCount += other.m_netRoutedCount;
+		m_connectorsLeftToRoute += other.m_connectorsLeftToRoute;
+		m_jumperItemCount += other.m_jumperItemCount;
+	}
+
 	bool operator!=(const RoutingStatus &other) const {
 		return
 		    (m_netCount != other.m_netCount) ||
@@ -25,6 +25,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <memory>
 #include <any>
 #include <stdexcept>
+#include <algorithm>
+#include <cctype>
 
 #include <QCoreApplication>
 #include <QStandardPaths>
@@ -101,13 +103,14 @@ void NgSpiceSimulator::init() {
 
 	setErrorTitle(std::nullopt);
 
-	std::vector<std::string> symbols{STRFY(ngSpice_Command), STRFY(ngSpice_Init), STRFY(ngSpice_Circ), STRFY(ngGet_Vec_Info)};
+	std::vector<std::string> symbols{STRFY(ngSpice_Command), STRFY(ngSpice_Init), STRFY(ngSpice_Circ), STRFY(ngGet_Vec_Info),
+									 STRFY(ngSpice_CurPlot), STRFY(ngSpice_AllVecs)};
 	for (auto & symbol: symbols) {
 		m_handles[symbol] = (void *) m_library.resolve(symbol.c_str());
 	}
 	std::string previousLocale = setlocale(LC_NUMERIC, nullptr);
 	setlocale(LC_NUMERIC, "C");
-	GET_FUNC(ngSpice_Init)(&SendCharFunc, &SendStatFunc, &ControlledExitFunc, nullptr, nullptr, &BGThreadRunningFunc, nullptr);
+	GET_FUNC(ngSpice_Init)(&SendCharFunc, &SendStatFunc, &ControlledExitFunc, &SendDataFunc, &SendInitDataFunc, &BGThreadRunningFunc, nullptr);
 	setlocale(LC_NUMERIC, previousLocale.c_str());
 
 	m_isBGThreadRunning = true;
@@ -122,6 +125,11 @@ bool NgSpiceSimulator::isBGThreadRunning() {
 	return m_isBGThreadRunning;
 }
 
+void NgSpiceSimulator::setBGThreadFinishedCallback(const std::function<void()>& finished) {
+	std::lock_guard<std::mutex> lock(m_callbackMutex);
+	m_bgThreadFinished = finished;
+}
+
 void NgSpiceSimulator::loadCircuit(const std::string& netList) {
 	std::stringstream stream(netList);
 	std::string component;
@@ -157,21 +165,74 @@ void NgSpiceSimulator::command(const std::string& command) {
 	setlocale(LC_NUMERIC, previousLocale.c_str());
 }
 
-std::vector<double> NgSpiceSimulator::getVecInfo(const std::string& vecName) {
+NgSpiceSimulator::VectorView NgSpiceSimulator::getVecView(const std::string& vecName) {
+	return getVecViews(std::vector<std::string>{ vecName }).front();
+}
+
+std::vector<NgSpiceSimulator::VectorView> NgSpiceSimulator::getVecViews(const std::vector<std::string>& vecNames) {
+	std::vector<VectorView> views(vecNames.size());
 	std::string previousLocale = setlocale(LC_NUMERIC, nullptr);
 	setlocale(LC_NUMERIC, "C");
-	vector_info* vecInfo = GET_FUNC(ngGet_Vec_Info)(UNIQ(vecName));
+	auto ngGetVecInfo = GET_FUNC(ngGet_Vec_Info);
+	for (size_t i = 0; i < vecNames.size(); i++) {
+		vector_info* vecInfo = ngGetVecInfo(UNIQ(vecNames[i]));
+		if (vecInfo && vecInfo->v_realdata && vecInfo->v_length > 0) {
+			views[i].data = vecInfo->v_realdata;
+			views[i].size = vecInfo->v_length;
+		}
+	}
 	setlocale(LC_NUMERIC, previousLocale.c_str());
+	return views;
+}
 
-	if (!vecInfo) return std::vector<double>();
+std::vector<std::string> NgSpiceSimulator::getAllVecNames() {
+	std::vector<std::string> vecNames;
+	char* plot = GET_FUNC(ngSpice_CurPlot)();
+	if (!plot) return vecNames;
 
-	std::vector<double> realValues;
-	if (vecInfo->v_realdata) {
-		realValues.push_back(vecInfo->v_realdata[0]);
-		return realValues;
+	char** vecs = GET_FUNC(ngSpice_AllVecs)(plot);
+	for (int i = 0; vecs && vecs[i]; i++) {
+		vecNames.push_back(vecs[i]);
 	}
+	return vecNames;
+}
+
+std::vector<double> NgSpiceSimulator::getVecInfo(const std::string& vecName) {
+	VectorView view = getVecView(vecName);
+	if (view.empty()) return std::vector<double>();
+
+	return std::vector<double>(1, view[0]);
+}
+
+std::vector<double> NgSpiceSimulator::getVecValues(const std::string& vecName) {
+	VectorView view = getVecView(vecName);
+	return std::vector<double>(view.begin(), view.end());
+}
 
-	return std::vector<double>();
+static std::string toLower(std::string name) {
+	std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+	return name;
+}
+
+void NgSpiceSimulator::setStreamedVectors(const std::vector<std::string>& vecNames, size_t capacity) {
+	m_streamedVectors.clear();
+	for (const auto& vecName : vecNames) {
+		// ngspice reports vector names in lower case
+		m_streamedVectors.push_back({ toLower(vecName), std::make_unique<SampleRingBuffer>(capacity), -1 });
+	}
+}
+
+size_t NgSpiceSimulator::readStreamedVectors(std::map<std::string, std::vector<double>>& samples, size_t decimation) {
+	if (m_streamedVectors.empty()) return 0;
+
+	size_t count = std::numeric_limits<size_t>::max();
+	for (const auto& streamed : m_streamedVectors) {
+		count = std::min(count, streamed.buffer->available());
+	}
+	for (const auto& streamed : m_streamedVectors) {
+		streamed.buffer->read(samples[streamed.name], decimation, count);
+	}
+	return count;
 }
 
 stdx::optional<std::string> NgSpiceSimulator::errorOccured() {
@@ -226,13 +287,29 @@ int NgSpiceSimulator::ControlledExitFunc(int exitStatus, bool, bool, int libId,
 	return 0;
 }
 
-int NgSpiceSimulator::SendDataFunc(pvecvaluesall, int numStructs, int libId, void*) {
-	std::cout << "SendDataFunc numStructs (libId:" << libId << "): " << numStructs << std::endl;
+int NgSpiceSimulator::SendDataFunc(pvecvaluesall allVecValues, int, int, void*) {
+	// called on the background thread for every simulated point, so no logging here
+	auto simulator = getInstance();
+	for (auto& streamed : simulator->m_streamedVectors) {
+		if (streamed.index < 0 || streamed.index >= allVecValues->veccount) continue;
+
+		streamed.buffer->push(allVecValues->vecsa[streamed.index]->creal);
+	}
 	return 0;
 }
 
-int NgSpiceSimulator::SendInitDataFunc(pvecinfoall, int libId, void*) {
+int NgSpiceSimulator::SendInitDataFunc(pvecinfoall allVecInitInfo, int libId, void*) {
 	std::cout << "SendInitDataFunc (libId:" << libId << "): " << std::endl;
+	auto simulator = getInstance();
+	for (auto& streamed : simulator->m_streamedVectors) {
+		streamed.index = -1;
+		for (int i = 0; i < allVecInitInfo->veccount; i++) {
+			if (toLower(allVecInitInfo->vecs[i]->vecname) == streamed.name) {
+				streamed.index = allVecInitInfo->vecs[i]->number;
+				break;
+			}
+		}
+	}
 	return 0;
 }
 
@@ -240,5 +317,9 @@ int NgSpiceSimulator::BGThreadRunningFunc(bool notRunning, int libId, void*) {
 	std::cout << "BGThreadRunningFunc (libId:" << libId << "): " << std::endl;
 	auto simulator = getInstance();
 	simulator->m_isBGThreadRunning = !notRunning;
+	if (notRunning) {
+		std::lock_guard<std::mutex> lock(simulator->m_callbackMutex);
+		if (simulator->m_bgThreadFinished) simulator->m_bgThreadFinished();
+	}
 	return 0;
 }
@@ -23,9 +23,15 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <ngspice/sharedspice.h>
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "sampleringbuffer.h"
 
 #pragma once
 
@@ -99,6 +105,14 @@ public:
 	 */
 	void resetIsBGThreadRunning();
 
+	/**
+	 * @brief Set a function to call when the ngspice library background thread finishes.
+	 *
+	 * The function is called on the background thread, so it should only post to the GUI thread.
+	 * @param[in] finished function to call, or an empty function to stop being called
+	 */
+	void setBGThreadFinishedCallback(const std::function<void()>& finished);
+
 	/**
 	 * @brief Load a circuit given as a netlist into the ngspice library.
 	 * @param[in] netList netlist that represents the circuit to be loaded into ngspice library
@@ -112,12 +126,75 @@ public:
 	void command(const std::string& command);
 
 	/**
+	/**
+	 * @brief Read-only view of the real values of an ngspice vector, pointing into ngspice's own memory.
+	 *
+	 * A view stays valid until the circuit is removed, reset or run again.
+	 */
+	struct VectorView {
+		const double* data = nullptr;
+		size_t size = 0;
+
+		bool empty() const { return size == 0; }
+		double operator[](size_t i) const { return data[i]; }
+		const double* begin() const { return data; }
+		const double* end() const { return data + size; }
+	};
+
+	/**
+	 * @brief Get a view of the real values of the given vector, without copying them.
+	 * @param[in] vecName name of vector to get the values of
+	 * @return view of the values, empty if there is no such real vector
+	 */
+	VectorView getVecView(const std::string& vecName);
+
+	/**
+	 * @brief Get the names of all the vectors of the current plot, that is, of the last analysis run.
+	 * @return names of the vectors, as ngspice gives them
+	 */
+	std::vector<std::string> getAllVecNames();
+
+	/**
+	 * @brief Get views of several vectors at once, one per name and in the same order.
+	 * @param[in] vecNames names of the vectors
+	 * @return views of the values, empty for names with no real vector
+	 */
+	std::vector<VectorView> getVecViews(const std::vector<std::string>& vecNames);
+
 	 * @brief Get vector information from the ngspice library ngGet_Vec_Info function for the given vector name.
 	 * @param[in] vecName name of vector to get information for
 	 * @return vector of values returned by ngspice library ngGet_Vec_Info function
 	 */
 	std::vector<double> getVecInfo(const std::string& vecName);
 
+	/**
+	 * @brief Get all the real values of a vector, such as the points of a sweep.
+	 * @param[in] vecName name of vector to get the values of
+	 * @return the values, or an empty vector if there is no such real vector
+	 */
+	std::vector<double> getVecValues(const std::string& vecName);
+
+	/**
+	 * @brief Choose the vectors whose values are streamed while ngspice runs, for example during a transient analysis.
+	 *
+	 * Call only while the background thread is not running. Each vector gets its own ring of capacity samples,
+	 * emptied by this call; an empty list stops streaming.
+	 * @param[in] vecNames names of the vectors to stream, such as "time" or "v(1)"
+	 * @param[in] capacity number of samples each ring holds before further samples are dropped
+	 */
+	void setStreamedVectors(const std::vector<std::string>& vecNames, size_t capacity);
+
+	/**
+	 * @brief Move the samples streamed so far out of the rings, appending every decimation-th one to samples.
+	 *
+	 * The same number of points is taken from every vector, so the vectors stay aligned.
+	 * Call from one thread only, while streaming is set up.
+	 * @param[in,out] samples map from vector name to its samples; missing names are added
+	 * @param[in] decimation keep one point in this many, to thin the data for display
+	 * @return number of points taken from each ring
+	 */
+	size_t readStreamedVectors(std::map<std::string, std::vector<double>>& samples, size_t decimation = 1);
+
 	/**
 	 * @brief Return optional error title if an error occurred.
 	 * @return optional error title if an error occurred
@@ -184,7 +261,23 @@ private:
 	/**
 	 * @brief Flag that indicates if the ngspice library background thread is running.
 	 */
-	bool m_isBGThreadRunning;
+	std::atomic<bool> m_isBGThreadRunning;
+
+	/**
+	 * @brief Function called when the background thread finishes, guarded by m_callbackMutex.
+	 */
+	std::function<void()> m_bgThreadFinished;
+	std::mutex m_callbackMutex;
+
+	/**
+	 * @brief A vector streamed from SendDataFunc; index is its position in ngspice's data, -1 until SendInitDataFunc finds it.
+	 */
+	struct StreamedVector {
+		std::string name;
+		std::unique_ptr<SampleRingBuffer> buffer;
+		int index;
+	};
+	std::vector<StreamedVector> m_streamedVectors;
 
 	/**
 	 * @brief Current error title if an error occurred and otherwise std::nullopt.
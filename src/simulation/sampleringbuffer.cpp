@@ -0,0 +1,69 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "sampleringbuffer.h"
+
+#include <algorithm>
+
+SampleRingBuffer::SampleRingBuffer(size_t capacity)
+	: m_head(0)
+	, m_tail(0)
+	, m_dropped(0) {
+	size_t size = 1;
+	while (size < capacity) size <<= 1;
+	m_samples.resize(size);
+	m_mask = size - 1;
+}
+
+bool SampleRingBuffer::push(double sample) {
+	size_t head = m_head.load(std::memory_order_relaxed);
+	if (head - m_tail.load(std::memory_order_acquire) >= m_samples.size()) {
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_samples[head & m_mask] = sample;
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+size_t SampleRingBuffer::read(std::vector<double>& samples, size_t decimation, size_t limit) {
+	decimation = std::max<size_t>(decimation, 1);
+	size_t tail = m_tail.load(std::memory_order_relaxed);
+	size_t count = std::min(m_head.load(std::memory_order_acquire) - tail, limit);
+	for (size_t i = 0; i < count; i++) {
+		if (m_phase == 0) samples.push_back(m_samples[(tail + i) & m_mask]);
+		if (++m_phase >= decimation) m_phase = 0;
+	}
+	m_tail.store(tail + count, std::memory_order_release);
+	return count;
+}
+
+size_t SampleRingBuffer::available() const {
+	return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+}
+
+size_t SampleRingBuffer::capacity() const {
+	return m_samples.size();
+}
+
+size_t SampleRingBuffer::dropped() const {
+	return m_dropped.load(std::memory_order_relaxed);
+}
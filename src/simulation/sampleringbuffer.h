@@ -0,0 +1,70 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef SAMPLERINGBUFFER_H
+#define SAMPLERINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Lock-free ring of samples for one producer and one consumer.
+ *
+ * Ngspice's background thread pushes the values of a streamed vector as they are computed;
+ * the GUI thread reads whatever has arrived so far. Samples that arrive while the ring is full
+ * are dropped and counted, so a slow reader never holds up the simulation.
+ */
+class SampleRingBuffer {
+public:
+	/**
+	 * @param[in] capacity number of samples held, rounded up to a power of two
+	 */
+	explicit SampleRingBuffer(size_t capacity);
+
+	/**
+	 * @brief Append a sample. Producer side only.
+	 * @return false if the ring was full and the sample was dropped
+	 */
+	bool push(double sample);
+
+	/**
+	 * @brief Take up to limit samples, appending every decimation-th one to samples. Consumer side only.
+	 *
+	 * The position within the decimation carries over from one read to the next.
+	 * @return number of samples taken from the ring, including the ones skipped by decimation
+	 */
+	size_t read(std::vector<double>& samples, size_t decimation = 1, size_t limit = std::numeric_limits<size_t>::max());
+
+	size_t available() const;
+	size_t capacity() const;
+	size_t dropped() const;
+
+private:
+	std::vector<double> m_samples;
+	size_t m_mask;
+	std::atomic<size_t> m_head;				// next slot to write; only the producer stores it
+	std::atomic<size_t> m_tail;				// next slot to read; only the consumer stores it
+	std::atomic<size_t> m_dropped;
+	size_t m_phase = 0;						// consumer's position within the decimation
+};
+
+#endif // SAMPLERINGBUFFER_H
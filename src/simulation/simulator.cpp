@@ -31,9 +31,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QClipboard>
 #include <QApplication>
 #include <QGraphicsColorizeEffect>
+#include <QSvgRenderer>
 #include <QRegularExpression>
 #include <QMessageBox>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+
+#include <cmath>
 
 #include "../mainwindow/mainwindow.h"
 #include "../items/note.h"
@@ -50,6 +55,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/symbolpaletteitem.h"
 #include "../items/perfboard.h"
 #include "../items/partlabel.h"
+#include "../testing/FTimingProbe.h"
+#include "../utils/tracer.h"
 
 #include <ngspice/sharedspice.h>
 
@@ -57,7 +64,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 
 /////////////////////////////////////////////////////////
-Simulator::Simulator(MainWindow *mainWindow) : QObject(mainWindow) {
+Simulator::Simulator(MainWindow *mainWindow) : QObject(mainWindow), m_resultCache(ResultCacheSize) {
 	m_mainWindow = mainWindow;
 	m_breadboardGraphicsView = dynamic_cast<BreadboardSketchWidget *>(mainWindow->sketchWidgets().at(0));
 	m_schematicGraphicsView = dynamic_cast<SchematicSketchWidget *>(mainWindow->sketchWidgets().at(1));
@@ -67,6 +74,10 @@ Simulator::Simulator(MainWindow *mainWindow) : QObject(mainWindow) {
 	m_simTimer->setSingleShot(true);
 	connect(m_simTimer, &QTimer::timeout, this, &Simulator::simulate);
 
+	m_simTimeoutTimer = new QTimer(this);
+	m_simTimeoutTimer->setSingleShot(true);
+	connect(m_simTimeoutTimer, &QTimer::timeout, this, &Simulator::simulationTimedOut);
+
 	QSettings settings;
 	int enabled = settings.value("simulatorEnabled", 0).toInt();
 	enable(enabled);
@@ -75,6 +86,11 @@ Simulator::Simulator(MainWindow *mainWindow) : QObject(mainWindow) {
 }
 
 Simulator::~Simulator() {
+	if (m_simulator) {
+		m_simulator->setBGThreadFinishedCallback(std::function<void()>());
+		if (m_running) m_simulator->command("bg_halt");
+	}
+	clearNetList();
 }
 
 /**
@@ -86,6 +102,11 @@ Simulator::~Simulator() {
 void Simulator::triggerSimulation()
 {
 	if(m_simulating) {
+		if (m_running && !m_stale) {
+			// the results would be for a circuit that no longer exists
+			m_stale = true;
+			m_simulator->command("bg_halt");
+		}
 		resetTimer();
 	}
 }
@@ -142,6 +163,10 @@ void Simulator::startSimulation()
  */
 void Simulator::stopSimulation() {
 	m_simulating = false;
+	if (m_running && !m_stale) {
+		m_stale = true;
+		m_simulator->command("bg_halt");
+	}
 	removeSimItems();
 	emit simulationStartedOrStopped(m_simulating);
 }
@@ -152,11 +177,11 @@ void Simulator::stopSimulation() {
  * The steps performed are:
  * - Creates an instance of the Ngspice simulator (if it was not created before)
  * - Gets the current spice netlist
- * - Loads the netlist in Ngspice
+ * - Loads the netlist in Ngspice, unless it is the one whose results Ngspice already holds
  * - Runs a operating point analysis in a background thread
  * - Remove all previous items placed by the simulator (smokes, messages in the multimeters, etc.)
  * - Grey out the parts that are not being simulated
- * - Wait until the simulation has finished (timeout of 3s)
+ * - Return to the event loop; finishSimulation() carries on when the background thread is done (timeout of 3s)
  * - Iterate for all parts being simulated to
  *     - Check if they work within specifications, add smoke if needed
  *     - Update display messages in the multimeters
@@ -166,11 +191,29 @@ void Simulator::stopSimulation() {
  * @brief Simulate the current circuit and check for components working out of specifications
  */
 void Simulator::simulate() {
+	// ngspice runs in the background, so this covers building and loading the netlist;
+	// reading the results back is timed in finishSimulation
+	static FTimingProbe probe("simulate");
+	FTimingProbe::Scope timing(probe);
+	Tracer::Scope tracing("simulate");
+
 	if (!m_enabled || !m_simulating) {
 		std::cout << "The simulator is not enabled or simulating" << std::endl;
 		return;
 	}
 
+	if (m_running) {
+		// ngspice is still stopping the previous run; try again once it has
+		std::cout << "The previous simulation is still running" << std::endl;
+		if (!m_stale) {
+			m_stale = true;
+			m_simulator->command("bg_halt");
+		}
+		resetTimer();
+		return;
+	}
+
+	m_results = SimulationResults();
 	m_simulator = NgSpiceSimulator::getInstance();
 	try {
 		m_simulator->init();
@@ -178,6 +221,7 @@ void Simulator::simulate() {
 	catch (std::exception& e) {
 		FMessageBox::warning(nullptr, tr("Simulator Error"), tr("An error occurred when starting the simulation."));
 		stopSimulation();
+		failSimulation(e.what());
 		return;
 	}
 
@@ -192,46 +236,81 @@ void Simulator::simulate() {
 
 	QList< QList<ConnectorItem *>* > netList;
 	QSet<ItemBase *> itemBases;
+	QElapsedTimer phaseTimer;
+	phaseTimer.start();
+	Tracer::begin("simulate.netlist");
 	QString spiceNetlist = m_mainWindow->getSpiceNetlist("Simulator Netlist", netList, itemBases);
+	Tracer::end();
+	m_results.netlistMs = phaseTimer.nsecsElapsed() / 1.0e6;
 
 	std::cout << "Netlist: " << spiceNetlist.toStdString() << std::endl;
 
-	//std::cout << "-----------------------------------" <<std::endl;
-	std::cout << "Running command(remcirc):" <<std::endl;
-	m_simulator->command("remcirc");
-	//std::cout << "-----------------------------------" <<std::endl;
-	std::cout << "Running m_simulator->command('reset'):" <<std::endl;
-	m_simulator->command("reset");
-	m_simulator->clearLog();
-
-	std::cout << "-----------------------------------" <<std::endl;
-	std::cout << "Running LoadNetlist:" <<std::endl;
-
-	m_simulator->loadCircuit(spiceNetlist.toStdString());
+	// most edits (moving a part, say) leave the circuit as it was, and ngspice still holds its results
+	QByteArray hash = netlistHash(spiceNetlist);
+	bool reuseResults = !m_loadedNetlistHash.isEmpty() && hash == m_loadedNetlistHash;
+	// toggling a switch or undoing an edit brings back a netlist that has been simulated before
+	VectorValues * cachedValues = reuseResults ? nullptr : m_resultCache.object(hash);
+	m_results.reused = reuseResults;
+	m_results.cached = cachedValues != nullptr;
+	if (reuseResults) {
+		std::cout << "The netlist has not changed; using the results ngspice already has" <<std::endl;
+	}
+	else if (cachedValues) {
+		std::cout << "This netlist has been simulated before; using its cached results" <<std::endl;
+		m_vectorValues = *cachedValues;
+	}
+	else {
+		m_loadedNetlistHash.clear();
+		m_vectorValues.clear();
+
+		//std::cout << "-----------------------------------" <<std::endl;
+		std::cout << "Running command(remcirc):" <<std::endl;
+		m_simulator->command("remcirc");
+		//std::cout << "-----------------------------------" <<std::endl;
+		std::cout << "Running m_simulator->command('reset'):" <<std::endl;
+		m_simulator->command("reset");
+		m_simulator->clearLog();
 
-	if (QString::fromStdString(m_simulator->getLog(false)).toLower().contains("error") || // "error on line"
-		QString::fromStdString(m_simulator->getLog(true)).toLower().contains("warning")) { // "warning, can't find model"
-		//Ngspice found an error, do not continue
-		std::cout << "Error loading the netlist. Probably some SPICE field is wrong, check them." <<std::endl;
-		//TODO: Create copy to clipboard button o make this selectable ans resizeable!
-		FMessageBox::warning(nullptr, tr("Simulator Error"),
-								 tr("The simulator gave an error when loading the netlist. "
-									"Probably some SPICE field is wrong, please, check them.\n"
-									"If the parts are from the simulation bin, report the bug in GitHub.\n\nErrors:\n") +
-								QString::fromStdString(m_simulator->getLog(false)) +
-								QString::fromStdString(m_simulator->getLog(true)) +
-								 "\n\nNetlist:\n" + spiceNetlist);
-		stopSimulation();
-		return;
+		std::cout << "-----------------------------------" <<std::endl;
+		std::cout << "Running LoadNetlist:" <<std::endl;
+
+		phaseTimer.restart();
+		Tracer::begin("simulate.load");
+		m_simulator->loadCircuit(spiceNetlist.toStdString());
+		Tracer::end();
+		m_results.loadMs = phaseTimer.nsecsElapsed() / 1.0e6;
+
+		if (QString::fromStdString(m_simulator->getLog(false)).toLower().contains("error") || // "error on line"
+			QString::fromStdString(m_simulator->getLog(true)).toLower().contains("warning")) { // "warning, can't find model"
+			//Ngspice found an error, do not continue
+			std::cout << "Error loading the netlist. Probably some SPICE field is wrong, check them." <<std::endl;
+			//TODO: Create copy to clipboard button o make this selectable ans resizeable!
+			FMessageBox::warning(nullptr, tr("Simulator Error"),
+									 tr("The simulator gave an error when loading the netlist. "
+										"Probably some SPICE field is wrong, please, check them.\n"
+										"If the parts are from the simulation bin, report the bug in GitHub.\n\nErrors:\n") +
+									QString::fromStdString(m_simulator->getLog(false)) +
+									QString::fromStdString(m_simulator->getLog(true)) +
+									 "\n\nNetlist:\n" + spiceNetlist);
+			stopSimulation();
+			failSimulation(QString::fromStdString(m_simulator->getLog(false)) + QString::fromStdString(m_simulator->getLog(true)));
+			return;
+		}
+		std::cout << "-----------------------------------" <<std::endl;
+		std::cout << "Running command(listing):" <<std::endl;
+		m_simulator->command("listing");
+		std::cout << "-----------------------------------" <<std::endl;
+		std::cout << "Running m_simulator->command(bg_run):" <<std::endl;
+		m_simulator->setBGThreadFinishedCallback([this]() {
+			QMetaObject::invokeMethod(this, "finishSimulation", Qt::QueuedConnection);
+		});
+		m_running = true;
+		m_stale = false;
+		m_simulator->resetIsBGThreadRunning();
+		m_runTimer.start();
+		m_simulator->command("bg_run");
 	}
 	std::cout << "-----------------------------------" <<std::endl;
-	std::cout << "Running command(listing):" <<std::endl;
-	m_simulator->command("listing");
-	std::cout << "-----------------------------------" <<std::endl;
-	std::cout << "Running m_simulator->command(bg_run):" <<std::endl;
-	m_simulator->resetIsBGThreadRunning();
-	m_simulator->command("bg_run");
-	std::cout << "-----------------------------------" <<std::endl;
 	std::cout << "Generating a hash table to find the net of specific connectors:" <<std::endl;
 	//While the spice simulator runs, we will perform some tasks:
 
@@ -252,20 +331,20 @@ void Simulator::simulate() {
 	m_sch2bbItemHash.clear();
 	foreach (ItemBase* schPart, itemBases) {
 		m_instanceTitleSim->append(schPart->instanceTitle());
-		foreach (QGraphicsItem * bbItem, m_breadboardGraphicsView->scene()->items()) {
-			ItemBase * bbPart = dynamic_cast<ItemBase *>(bbItem);
-			if (!bbPart) continue;
-			if (schPart->instanceTitle().compare(bbPart->instanceTitle()) == 0) {
-				m_sch2bbItemHash.insert(schPart, bbPart);
-			}
+		// both views' items share the part's ModelPart, so there is no need to search the breadboard scene
+		ItemBase * bbPart = schPart->modelPart() ? schPart->modelPart()->viewItem(m_breadboardGraphicsView->scene()) : nullptr;
+		if (bbPart) {
+			m_sch2bbItemHash.insert(schPart, bbPart);
 		}
 	}
 	std::cout << "-----------------------------------" <<std::endl;
-	std::cout << "Removing the items added by the simulator last time it run (smoke, displayed text in multimeters, etc.):" <<std::endl;
+	std::cout << "Hiding the items added by the simulator last time it run (smoke, displayed text in multimeters, etc.):" <<std::endl;
 
-	//Removes the items added by the simulator last time it run (smoke, displayed text in multimeters, etc.)
-	std::cout << "removeSimItems(itemBases);" <<std::endl;
-	removeSimItems();
+	//Hides the items added by the simulator last time it run (smoke, displayed text in multimeters, etc.);
+	//the parts that still need them show them again instead of creating new ones
+	std::cout << "hideSimItems(itemBases);" <<std::endl;
+	hideSimItems(m_schematicGraphicsView->scene()->items());
+	hideSimItems(m_breadboardGraphicsView->scene()->items());
 	std::cout << "-----------------------------------" <<std::endl;
 	std::cout << "If there are parts that are not being simulated, grey them out:" <<std::endl;
 
@@ -274,38 +353,71 @@ void Simulator::simulate() {
 	greyOutNonSimParts(itemBases);
 	std::cout << "-----------------------------------" <<std::endl;
 
-	std::cout << "Waiting for simulator thread to stop" <<std::endl;
-	int elapsedTime = 0, simTimeOut = 3000; // in ms
-	while (m_simulator->isBGThreadRunning() && elapsedTime < simTimeOut) {
-		QThread::usleep(1000);
-		elapsedTime++;
+	clearNetList();
+	m_netList = netList;
+	m_itemBases = itemBases;
+	m_spiceNetlist = spiceNetlist;
+	if (reuseResults || cachedValues) {
+		m_running = true;
+		m_stale = false;
+		finishSimulation();
+		return;
 	}
-	if (elapsedTime >= simTimeOut) {
-		m_simulator->command("bg_halt");
-		stopSimulation();
-		FMessageBox::warning(m_mainWindow, tr("Simulator Timeout"), tr("The spice simulator did not finish after %1 ms. Aborting simulation.").arg(simTimeOut));
+
+	m_simTimeoutTimer->start(SimTimeOut);
+	std::cout << "Waiting for simulator thread to stop" <<std::endl;
+}
+
+/**
+ * Called on the GUI thread once ngspice's background thread has stopped, whether it finished, was halted or
+ * failed. Results of a run whose circuit has changed since it began are dropped; a newer run is already queued.
+ */
+void Simulator::finishSimulation() {
+	static FTimingProbe probe("simulate.finish");
+	FTimingProbe::Scope timing(probe);
+	Tracer::Scope tracing("simulate.finish");
+
+	if (!m_running) return;			// timed out, and already reported
+
+	m_running = false;
+	m_simTimeoutTimer->stop();
+	if (!m_results.reused && !m_results.cached) m_results.runMs = m_runTimer.nsecsElapsed() / 1.0e6;
+	if (m_stale || !m_enabled || !m_simulating) {
+		std::cout << "Dropping the results of an outdated simulation." <<std::endl;
+		clearNetList();
 		return;
-	} else {
-		std::cout << "The spice simulator has finished." <<std::endl;
 	}
+
+	std::cout << "The spice simulator has finished." <<std::endl;
 	std::cout << "-----------------------------------" <<std::endl;
 
-	if (m_simulator->errorOccured() ||
-			QString::fromStdString(m_simulator->getLog(true)).toLower().contains("there aren't any circuits loaded")) {
+	QSet<ItemBase *> itemBases = m_itemBases;
+	QString spiceNetlist = m_spiceNetlist;
+
+	if (!m_results.cached && (m_simulator->errorOccured() ||
+			QString::fromStdString(m_simulator->getLog(true)).toLower().contains("there aren't any circuits loaded"))) {
 		//Ngspice found an error, do not continue
 		std::cout << "Fatal error found, stopping the simulation." <<std::endl;
 		removeSimItems();
-		QWidget * tempWidget = new QWidget();
-		QMessageBox::warning(tempWidget, tr("Simulator Error"),
+		FMessageBox::warning(nullptr, tr("Simulator Error"),
 								 tr("The simulator gave an error when trying to simulate this circuit. "
 									"Please, check the wiring and try again. \n\nErrors:\n") +
 								QString::fromStdString(m_simulator->getLog(false)) +
 								QString::fromStdString(m_simulator->getLog(true)) +
 								 "\n\nNetlist:\n" + spiceNetlist);
-		delete tempWidget;
+		clearNetList();
+		failSimulation(QString::fromStdString(m_simulator->getLog(false)) + QString::fromStdString(m_simulator->getLog(true)));
 		return;
 	}
 	std::cout << "No fatal error found, continuing..." <<std::endl;
+	QElapsedTimer phaseTimer;
+	phaseTimer.start();
+	if (!m_results.cached) {
+		m_loadedNetlistHash = netlistHash(spiceNetlist);
+		fetchResults();
+	}
+	m_results.fetchMs = phaseTimer.nsecsElapsed() / 1.0e6;
+	phaseTimer.restart();
 
 	//The spice simulation has finished, iterate over each part being simulated and update it (if it is necessary).
 	//This loops is in charge of:
@@ -362,11 +474,181 @@ void Simulator::simulate() {
 
 	}
 
+	m_results.updateMs = phaseTimer.nsecsElapsed() / 1.0e6;
+	collectResults();
+	if (!m_results.cached) {
+		// after the updates, so that it also has the vectors they looked up one by one
+		m_resultCache.insert(m_loadedNetlistHash, new VectorValues(m_vectorValues));
+	}
+	clearNetList();
+	emit simulationFinished();
+}
+
+/**
+ * Sweeps the value of a resistor or of a voltage or current source with a single ngspice .DC analysis,
+ * instead of editing the part and simulating once per value. Runs in the foreground; refuses while a
+ * simulation is running in the background.
+ * @param[in] part The schematic part to sweep; it has to be one of the parts being simulated
+ * @param[in] start The first value, in ohms, volts or amperes
+ * @param[in] stop The last value
+ * @param[in] points The number of values, at least two
+ * @param[in] voltageProbes Schematic connectors whose voltage, relative to ground, is returned for each value
+ * @param[in] currentProbes Schematic parts whose current is returned for each value
+ * @param[out] results The swept values and, for each of them, the probed voltages and currents
+ * @returns false if the sweep could not be run
+ */
+bool Simulator::sweep(ItemBase * part, double start, double stop, int points,
+					  const QList<ConnectorItem *> & voltageProbes, const QList<ItemBase *> & currentProbes, SweepResults & results) {
+	results = SweepResults();
+	if (!m_enabled || m_running || points < 2) return false;
+
+	QString deviceName;
+	QString sweepVector;				// the name ngspice gives the swept values
+	QStringList currentVectors;
+	try {
+		QChar deviceType = getDeviceType(part);
+		if (deviceType == 'r') sweepVector = "res-sweep";
+		else if (deviceType == 'v') sweepVector = "v-sweep";
+		else if (deviceType == 'i') sweepVector = "i-sweep";
+		else return false;
+
+		deviceName = spiceDeviceName(part);
+		Q_FOREACH (ItemBase * probe, currentProbes) {
+			currentVectors << currentVectorName(probe);
+		}
+	}
+	catch (...) {
+		return false;
+	}
+
+	m_simulator = NgSpiceSimulator::getInstance();
+	try {
+		m_simulator->init();
+	}
+	catch (std::exception& e) {
+		return false;
+	}
+
+	QString analysis = QString(".DC %1 %2 %3 %4").arg(deviceName).arg(start).arg(stop).arg((stop - start) / (points - 1));
+	QList< QList<ConnectorItem *>* > netList;
+	QSet<ItemBase *> itemBases;
+	QString spiceNetlist = m_mainWindow->getSpiceNetlist("Simulator Sweep", netList, itemBases, analysis);
+	QHash<ConnectorItem *, int> netIndex;
+	for (int i = 0; i < netList.count(); i++) {
+		Q_FOREACH (ConnectorItem * ci, *netList.at(i)) {
+			netIndex.insert(ci, i);
+		}
+		delete netList.at(i);
+	}
+	if (!itemBases.contains(part)) return false;
+
+	// ngspice is about to drop the circuit whose results the view shows
+	m_loadedNetlistHash.clear();
+	m_vectorValues.clear();
+	m_simulator->command("remcirc");
+	m_simulator->command("reset");
+	m_simulator->clearLog();
+	m_simulator->loadCircuit(spiceNetlist.toStdString());
+	if (QString::fromStdString(m_simulator->getLog(false)).toLower().contains("error") ||
+		QString::fromStdString(m_simulator->getLog(true)).toLower().contains("warning")) {
+		std::cout << "Error loading the sweep netlist." << std::endl;
+		return false;
+	}
+	m_simulator->command("run");
+	if (m_simulator->errorOccured()) {
+		std::cout << "Error running the sweep." << std::endl;
+		return false;
+	}
+
+	std::vector<double> values = m_simulator->getVecValues(sweepVector.toStdString());
+	results.values = QVector<double>(values.begin(), values.end());
+	Q_FOREACH (ConnectorItem * probe, voltageProbes) {
+		int net = netIndex.value(probe, 0);
+		if (net == 0) {
+			results.voltages.append(QVector<double>(results.values.count(), 0));
+			continue;
+		}
+		std::vector<double> voltages = m_simulator->getVecValues(QString("v(%1)").arg(net).toStdString());
+		results.voltages.append(QVector<double>(voltages.begin(), voltages.end()));
+	}
+	Q_FOREACH (QString currentVector, currentVectors) {
+		std::vector<double> currents = m_simulator->getVecValues(currentVector.toStdString());
+		results.currents.append(QVector<double>(currents.begin(), currents.end()));
+	}
+
+	return !results.values.isEmpty();
+}
+
+QByteArray Simulator::netlistHash(const QString & spiceNetlist) {
+	return QCryptographicHash::hash(spiceNetlist.toUtf8(), QCryptographicHash::Sha1);
+}
+
+void Simulator::simulationTimedOut() {
+	if (!m_running) return;
+
+	m_running = false;
+	m_simulator->command("bg_halt");
+	clearNetList();
+	if (m_stale) return;			// only a run that was already being halted; the next one is queued
+
+	stopSimulation();
+	FMessageBox::warning(m_mainWindow, tr("Simulator Timeout"), tr("The spice simulator did not finish after %1 ms. Aborting simulation.").arg(SimTimeOut));
+	failSimulation(QString("timed out after %1 ms").arg(SimTimeOut));
+}
+
+/**
+ * Records the net voltages and part currents of a finished run, for reports such as the one of the
+ * simulation service; smoke has been recorded as the parts were updated.
+ */
+void Simulator::collectResults() {
+	for (int i = 0; i < m_netList.count(); i++) {
+		QStringList connectors;
+		Q_FOREACH (ConnectorItem * ci, *m_netList.at(i)) {
+			if (!m_itemBases.contains(ci->attachedTo())) continue;
+
+			connectors << ci->attachedTo()->instanceTitle() + "." + ci->connectorSharedName();
+		}
+		double voltage = (i == 0) ? 0.0 : getVectorValueOrDefault(QString("v(%1)").arg(i).toStdString(), 0.0);
+		m_results.netVoltages.append(voltage);
+		m_results.netConnectors.append(connectors);
+	}
+
+	Q_FOREACH (ItemBase * part, m_itemBases) {
+		std::string vecName;
+		try {
+			vecName = currentVectorName(part).toStdString();
+		}
+		catch (...) {
+			continue;			// not a device whose current ngspice reports
+		}
+		double current = getVectorValueOrDefault(vecName, std::numeric_limits<double>::quiet_NaN());
+		if (!std::isnan(current)) m_results.partCurrents.insert(part->instanceTitle(), current);
+	}
+	m_results.partCount = m_itemBases.count();
+	m_results.completed = true;
+}
+
+void Simulator::failSimulation(const QString & error) {
+	m_results.error = error;
+	emit simulationFinished();
+}
+
+bool Simulator::isRunning() const {
+	return m_running;
+}
+
+const SimulationResults & Simulator::results() const {
+	return m_results;
+}
+
+void Simulator::clearNetList() {
 	//Delete the pointers
-	foreach (QList<ConnectorItem *> * net, netList) {
+	foreach (QList<ConnectorItem *> * net, m_netList) {
 		delete net;
 	}
-	netList.clear();
+	m_netList.clear();
+	m_itemBases.clear();
+	m_spiceNetlist.clear();
 }
 
 /**
@@ -374,17 +656,13 @@ void Simulator::simulate() {
  * @param[in] part Part where the smoke is going to be placed
  */
 void Simulator::drawSmoke(ItemBase* part) {
-	QGraphicsSvgItem * bbSmoke = new QGraphicsSvgItem(":resources/images/smoke.svg", m_sch2bbItemHash.value(part));
-	QGraphicsSvgItem * schSmoke = new QGraphicsSvgItem(":resources/images/smoke.svg", part);
-	if (!bbSmoke || !schSmoke) return;
-
-	schSmoke->setZValue(std::numeric_limits<double>::max());
-	bbSmoke->setZValue(std::numeric_limits<double>::max());
-	bbSmoke->setOpacity(0.7);
-	schSmoke->setOpacity(0.7);
+	m_results.smokedParts.append(part->instanceTitle());
+	ItemBase * bbPart = m_sch2bbItemHash.value(part);
+	QGraphicsSvgItem * bbSmoke = smokeItem(bbPart);
+	QGraphicsSvgItem * schSmoke = smokeItem(part);
 
 	//Scale the smoke images
-	QRectF bbPartBoundingBox = m_sch2bbItemHash.value(part)->boundingRectWithoutLegs();
+	QRectF bbPartBoundingBox = bbPart->boundingRectWithoutLegs();
 	QRectF schSmokeBoundingBox = schSmoke->boundingRect();
 	QRectF schPartBoundingBox = part->boundingRect();
 	QRectF bbSmokeBoundingBox = bbSmoke->boundingRect();
@@ -394,12 +672,10 @@ void Simulator::drawSmoke(ItemBase* part) {
 	double scaleHeight = bbPartBoundingBox.height()/schSmokeBoundingBox.height();
 	double scale;
 	(scaleWidth < scaleHeight) ? scale = scaleWidth : scale = scaleHeight;
-	if (scale > 1) {
-		//we can scale the smoke
-		bbSmoke->setScale(scale);
-	}else{
+	if (scale <= 1) {
 		scale = 1; //Do not scale down the smoke
 	}
+	bbSmoke->setScale(scale);
 
 	//Center the smoke in bb (bottom right corner of the smoke at the center of the part)
 	bbSmoke->setPos(QPointF(bbPartBoundingBox.width()/2-bbSmokeBoundingBox.width()*scale,
@@ -409,19 +685,37 @@ void Simulator::drawSmoke(ItemBase* part) {
 	scaleWidth = schPartBoundingBox.width()/schSmokeBoundingBox.width();
 	scaleHeight = schPartBoundingBox.height()/schSmokeBoundingBox.height();
 	(scaleWidth < scaleHeight) ? scale = scaleWidth : scale = scaleHeight;
-	if (scale > 1) {
-		//we can scale the smoke
-		schSmoke->setScale(scale);
-	}else{
+	if (scale <= 1) {
 		scale = 1; //Do not scale down the smoke
 	}
+	schSmoke->setScale(scale);
 
 	//Center the smoke in sch view (bottom right corner of the smoke at the center of the part)
 	schSmoke->setPos(QPointF(schPartBoundingBox.width()/2-schSmokeBoundingBox.width()*scale,
 							 schPartBoundingBox.height()/2-schSmokeBoundingBox.height()*scale));
+}
+
+/**
+ * Returns the smoke image of a part, showing the one left hidden by the previous simulation if there
+ * is one; otherwise adds a new one, which shares the parsed svg with the rest of the smoke images.
+ * @param[in] part Part where the smoke is going to be placed
+ */
+QGraphicsSvgItem * Simulator::smokeItem(ItemBase* part) {
+	QGraphicsSvgItem * smoke = qobject_cast<QGraphicsSvgItem *>(part->simulationGraphicsItem());
+	if (smoke && m_smokeRenderer && smoke->renderer() == m_smokeRenderer) {
+		smoke->setVisible(true);
+		return smoke;
+	}
 
-	part->addSimulationGraphicsItem(schSmoke);
-	m_sch2bbItemHash.value(part)->addSimulationGraphicsItem(bbSmoke);
+	if (!m_smokeRenderer) {
+		m_smokeRenderer = new QSvgRenderer(QString(":resources/images/smoke.svg"), this);
+	}
+	smoke = new QGraphicsSvgItem(part);
+	smoke->setSharedRenderer(m_smokeRenderer);
+	smoke->setZValue(std::numeric_limits<double>::max());
+	smoke->setOpacity(0.7);
+	part->addSimulationGraphicsItem(smoke);
+	return smoke;
 }
 
 /**
@@ -442,9 +736,8 @@ void Simulator::updateMultimeterScreen(ItemBase * multimeter, double number){
 }
 
 /**
- * Adds a message to the display of a multimeter. It does not update the message, it just adds
- * some text (the previous message is removed at the beginning of the simulation). The message
- * is displayed in a 7-segments font.
+ * Shows a message in the display of a multimeter, reusing the text left hidden by the previous
+ * simulation if there is one. The message is displayed in a 7-segments font.
  * @param[in] multimeter The part where the message is going to be displayed
  * @param[in] msg The message to be displayed
  */
@@ -459,15 +752,30 @@ void Simulator::updateMultimeterScreen(ItemBase * multimeter, QString msg){
 		msg.prepend(QString(5-aux.size(),' '));
 	}
 	std::cout << "msg is now: " << msg.toStdString() <<std::endl;
-	QGraphicsTextItem * bbScreen = new QGraphicsTextItem(msg, m_sch2bbItemHash.value(multimeter));
-	QGraphicsTextItem * schScreen = new QGraphicsTextItem(msg, multimeter);
-	schScreen->setPos(QPointF(10,10));
-	schScreen->setZValue(std::numeric_limits<double>::max());
-	QFont font("Segment16C", 10, QFont::Normal);
-	bbScreen->setFont(font);
+	ItemBase * bbMultimeter = m_sch2bbItemHash.value(multimeter);
+	QGraphicsTextItem * bbScreen = qobject_cast<QGraphicsTextItem *>(bbMultimeter->simulationGraphicsItem());
+	QGraphicsTextItem * schScreen = qobject_cast<QGraphicsTextItem *>(multimeter->simulationGraphicsItem());
+	if (bbScreen && schScreen) {
+		//Reuse the screens of the previous simulation
+		bbScreen->setPlainText(msg);
+		schScreen->setPlainText(msg);
+		bbScreen->setVisible(true);
+		schScreen->setVisible(true);
+	} else {
+		bbScreen = new QGraphicsTextItem(msg, bbMultimeter);
+		schScreen = new QGraphicsTextItem(msg, multimeter);
+		QFont font("Segment16C", 10, QFont::Normal);
+		bbScreen->setFont(font);
+		bbScreen->setDefaultTextColor(QColor(48, 48, 48));
+		schScreen->setDefaultTextColor(QColor(48, 48, 48));
+		bbScreen->setZValue(std::numeric_limits<double>::max());
+		schScreen->setZValue(std::numeric_limits<double>::max());
+		bbMultimeter->addSimulationGraphicsItem(bbScreen);
+		multimeter->addSimulationGraphicsItem(schScreen);
+	}
 	//There are issues as the size of the text changes depending on the display settings in windows
 	//This hack scales the text to match the appropiate value
-	QRectF bbMultBoundingBox = m_sch2bbItemHash.value(multimeter)->boundingRect();
+	QRectF bbMultBoundingBox = bbMultimeter->boundingRect();
 	QRectF bbBoundingBox = bbScreen->boundingRect();
 	QRectF schMultBoundingBox = multimeter->boundingRect();
 	QRectF schBoundingBox = schScreen->boundingRect();
@@ -485,14 +793,6 @@ void Simulator::updateMultimeterScreen(ItemBase * multimeter, QString msg){
 						 ,0.07*bbMultBoundingBox.height()));
 	schScreen->setPos(QPointF((schMultBoundingBox.width()-schBoundingBox.width())/2
 						 ,0.13*schMultBoundingBox.height()));
-
-	bbScreen->setDefaultTextColor(QColor(48, 48, 48));
-	schScreen->setDefaultTextColor(QColor(48, 48, 48));
-
-	bbScreen->setZValue(std::numeric_limits<double>::max());
-	schScreen->setZValue(std::numeric_limits<double>::max());
-	m_sch2bbItemHash.value(multimeter)->addSimulationGraphicsItem(bbScreen);
-	multimeter->addSimulationGraphicsItem(schScreen);
 }
 
 /**
@@ -524,6 +824,27 @@ void Simulator::removeSimItems(QList<QGraphicsItem *> items) {
 	}
 }
 
+/**
+ * Hides the items (images and texts) placed in previous simulations and resets the LEDs, but leaves
+ * the items and the grey out effects in place, so that the next results can reuse them.
+ */
+void Simulator::hideSimItems(const QList<QGraphicsItem *> & items) {
+	foreach (QGraphicsItem * item, items) {
+		ItemBase * itemBase = dynamic_cast<ItemBase *>(item);
+		if (!itemBase) continue;
+
+		if (itemBase->simulationGraphicsItem()) {
+			itemBase->simulationGraphicsItem()->setVisible(false);
+		}
+		if (itemBase->viewID() == ViewLayer::ViewID::BreadboardView) {
+			LED * led = dynamic_cast<LED *>(item);
+			if (led) {
+				led->resetBrightness();
+			}
+		}
+	}
+}
+
 /**
  * Returns the first element of ngspice vector or a default value.
  * @param[in] vecName name of ngspice vector to get value from
@@ -531,12 +852,43 @@ void Simulator::removeSimItems(QList<QGraphicsItem *> items) {
  * @returns the first vector element or the given default value
  */
 double Simulator::getVectorValueOrDefault(const std::string & vecName, double defaultValue) {
-	auto vecInfo = m_simulator->getVecInfo(vecName);
-	if (vecInfo.empty()) {
+	std::string name = canonicalVectorName(vecName);
+	auto it = m_vectorValues.find(name);
+	if (it != m_vectorValues.end()) return it->second;
+	if (m_results.cached) return defaultValue;			// ngspice holds another circuit
+
+	NgSpiceSimulator::VectorView view = m_simulator->getVecView(vecName);
+	if (view.empty()) {
 		return defaultValue;
-	} else {
-		return vecInfo[0];
 	}
+	m_vectorValues.emplace(name, view[0]);
+	return view[0];
+}
+
+/**
+ * Copies the values of all the vectors of the run that has just finished in one batch, as most parts
+ * being updated read some of them, and so that the results can be cached.
+ */
+void Simulator::fetchResults() {
+	m_vectorValues.clear();
+	std::vector<std::string> vecNames = m_simulator->getAllVecNames();
+	std::vector<NgSpiceSimulator::VectorView> views = m_simulator->getVecViews(vecNames);
+	for (size_t i = 0; i < vecNames.size(); i++) {
+		if (views[i].empty()) continue;
+
+		m_vectorValues.emplace(canonicalVectorName(vecNames[i]), views[i][0]);
+	}
+}
+
+/**
+ * Returns the name a vector is kept under: lower case, and a node voltage such as V(3) as just its node.
+ */
+std::string Simulator::canonicalVectorName(const std::string & vecName) {
+	QString name = QString::fromStdString(vecName).toLower();
+	if (name.startsWith("v(") && name.endsWith(")") && !name.contains(',')) {
+		name = name.mid(2, name.length() - 3);
+	}
+	return name.toStdString();
 }
 
 /**
@@ -656,17 +1008,36 @@ double Simulator::getPower(ItemBase* part, QString subpartName) {
  * @returns the current that a part is consuming/producing.
  */
 double Simulator::getCurrent(ItemBase* part, QString subpartName) {
+	return getVectorValueOrDefault(currentVectorName(part, subpartName).toStdString(), 0.0);
+}
+
+/**
+ * Returns the name ngspice gives a part's spice device, in lower case.
+ * @param[in] part The part
+ * @param[in] subpartName The suffix of the subpart, or empty if there is only one spice line for the device.
+ * @returns the name of the device, for example r1 or dled1
+ */
+QString Simulator::spiceDeviceName(ItemBase* part, QString subpartName) {
 	QString instanceStr = part->instanceTitle().toLower();
 	instanceStr.append(subpartName.toLower());
 
 	QChar deviceType = getDeviceType(part);
 	//std::cout << "deviceType: " << deviceType.toLatin1() <<std::endl;
-	if (deviceType == instanceStr.at(0)) {
-		instanceStr.prepend(QString("@"));
-	} else {
+	if (deviceType != instanceStr.at(0)) {
 		//f. ex. Leds are DLED1 in ngpice and LED1 in Fritzing
-		instanceStr.prepend(QString("@%1").arg(deviceType));
+		instanceStr.prepend(deviceType);
 	}
+	instanceStr.replace(" ", "_");
+	return instanceStr;
+}
+
+/**
+ * Returns the name of the ngspice vector holding the current that flows through a part.
+ * See getCurrent for the parts this works for.
+ */
+QString Simulator::currentVectorName(ItemBase* part, QString subpartName) {
+	QString instanceStr = "@" + spiceDeviceName(part, subpartName);
+	QChar deviceType = getDeviceType(part);
 	switch (deviceType.toLatin1()) {
 	case 'd':
 		instanceStr.append("[id]");
@@ -688,7 +1059,7 @@ double Simulator::getCurrent(ItemBase* part, QString subpartName) {
 		break;
 
 	}
-	return getVectorValueOrDefault(instanceStr.toStdString(), 0.0);
+	return instanceStr;
 }
 
 /**
@@ -720,62 +1091,62 @@ double Simulator::getTransistorCurrent(QString spicePartName, TransistorLeg leg)
 }
 
 /**
- * Greys out the parts that are not being simulated to inform the user.
+ * Greys out the parts that are not being simulated to inform the user, and removes the grey out
+ * from the rest. The parts that stay greyed out keep their effect from the previous simulation.
  * @param[in] simParts A set of parts that are being simulated.
  */
 void Simulator::greyOutNonSimParts(const QSet<ItemBase *>& simParts) {
 	//Find the parts that are not being simulated.
 	//First, get all the parts from the scenes...
-	QList<QGraphicsItem *> noSimSchParts = m_schematicGraphicsView->scene()->items();
-	QList<QGraphicsItem *> noSimBbParts = m_breadboardGraphicsView->scene()->items();
+	QList<QGraphicsItem *> schItems = m_schematicGraphicsView->scene()->items();
+	QList<QGraphicsItem *> bbItems = m_breadboardGraphicsView->scene()->items();
 
-	//Remove the parts that are going to be simulated and the wires connected to them
-	QList<ConnectorItem *> bbConnectors;
+	//Remove the parts that are going to be simulated
+	QSet<QString> simTitles;
+	QSet<QGraphicsItem *> simBbParts;
 	foreach (ItemBase * part, simParts) {
-		foreach (QGraphicsItem * schItem, noSimSchParts) {
-			ItemBase * schPart = dynamic_cast<ItemBase *>(schItem);
-			if (!schPart) continue;
-			if (part->instanceTitle().compare(schPart->instanceTitle()) == 0) {
-				noSimSchParts.removeAll(schItem);
-			}
-		}
+		simTitles.insert(part->instanceTitle());
+		simBbParts.insert(m_sch2bbItemHash.value(part));
+	}
+
+	QList<QGraphicsItem *> noSimSchParts;
+	foreach (QGraphicsItem * schItem, schItems) {
+		ItemBase * schPart = dynamic_cast<ItemBase *>(schItem);
+		if (schPart && simTitles.contains(schPart->instanceTitle())) continue;
 
-		noSimBbParts.removeAll(m_sch2bbItemHash.value(part));
-		bbConnectors.append(m_sch2bbItemHash.value(part)->cachedConnectorItems());
-
-//		foreach (ConnectorItem * connectorItem, part->cachedConnectorItems()) {
-//			QList<Wire *> wires;
-//			QList<ConnectorItem *> ends;
-//			Wire::collectChained(connectorItem, wires, ends);
-//			foreach (Wire * wire, wires) {
-//				noSimSchParts.removeAll(wire);
-//			}
-//		}
-//		foreach (ConnectorItem * connectorItem, m_sch2bbItemHash.value(part)->cachedConnectorItems()) {
-//			QList<Wire *> wires;
-//			QList<ConnectorItem *> ends;
-//			Wire::collectChained(connectorItem, wires, ends);
-//			foreach (Wire * wire, wires) {
-//				noSimBbParts.removeAll(wire);
-//			}
-//		}
+		noSimSchParts.append(schItem);
+	}
+	QList<QGraphicsItem *> noSimBbParts;
+	foreach (QGraphicsItem * bbItem, bbItems) {
+		if (simBbParts.contains(bbItem)) continue;
+
+		noSimBbParts.append(bbItem);
 	}
 
 	//TODO: grey out the wires that are not connected to parts to be simulated
 	removeItemsToBeSimulated(noSimSchParts);
 	removeItemsToBeSimulated(noSimBbParts);
 
-	//... and grey them out to indicate it
+	//... and grey them out to indicate it, ungreying the rest
+	QSet<QGraphicsItem *> greyed(noSimSchParts.begin(), noSimSchParts.end());
+	greyed.unite(QSet<QGraphicsItem *>(noSimBbParts.begin(), noSimBbParts.end()));
+	foreach (QGraphicsItem * item, schItems + bbItems) {
+		if (item->graphicsEffect() && !greyed.contains(item)) {
+			item->setGraphicsEffect(nullptr);
+		}
+	}
 	greyOutParts(noSimSchParts);
 	greyOutParts(noSimBbParts);
 }
 
 /**
- * Greys out the parts that are passed.
+ * Greys out the parts that are passed, unless they already are.
  * @param[in] parts A list of parts to grey out.
  */
 void Simulator::greyOutParts(const QList<QGraphicsItem*> & parts) {
 	foreach (QGraphicsItem * part, parts){
+		if (qobject_cast<QGraphicsColorizeEffect *>(part->graphicsEffect())) continue;
+
 		QGraphicsColorizeEffect * schEffect = new QGraphicsColorizeEffect();
 		schEffect->setColor(QColor(100,100,100));
 		part->setGraphicsEffect(schEffect);
@@ -790,89 +1161,40 @@ void Simulator::greyOutParts(const QList<QGraphicsItem*> & parts) {
  * are being simulated
  */
 void Simulator::removeItemsToBeSimulated(QList<QGraphicsItem*> & parts) {
+	QList<QGraphicsItem *> remaining;
+	remaining.reserve(parts.count());
 	foreach (QGraphicsItem * part, parts) {
-		ConnectorItem * connectorItem = dynamic_cast<ConnectorItem *>(part);
-		if (connectorItem) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		Wire* wire = dynamic_cast<Wire *>(part);
-		if (wire) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		PartLabel* label = dynamic_cast<PartLabel *>(part);
-		if (label) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		Note* note = dynamic_cast<Note *>(part);
-		if (note) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		LedLight* ledLight = dynamic_cast<LedLight *>(part);
-		if (ledLight) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		SymbolPaletteItem* symbol = dynamic_cast<SymbolPaletteItem *>(part);
-		if (symbol) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		ResizableBoard* board = dynamic_cast<ResizableBoard *>(part);
-		if (board) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		Perfboard* perfBoard = dynamic_cast<Perfboard *>(part);
-		if (perfBoard) {
-			parts.removeAll(part);
-			continue;
-		}
-
-		Breadboard* breadboard = dynamic_cast<Breadboard *>(part);
-		if (breadboard) {
-			parts.removeAll(part);
-			continue;
-//			if (bbConnectors.contains(wire->connector0()) ||
-//									bbConnectors.contains(wire->connector1())) {
-//				QList<Wire *> wires;
-//				QList<ConnectorItem *> ends;
-//				wire->collectChained(wires, ends);
-//				foreach (Wire * wireToRemove, wires) {
-//					noSimBbParts.removeAll(wireToRemove);
-//				}
-//			}
-		}
-
-		Ruler* ruler = dynamic_cast<Ruler *>(part);
-		if (ruler) {
-			parts.removeAll(part);
-			continue;
+		if (!isSimulatedWithoutSpice(part)) {
+			remaining.append(part);
 		}
+	}
+	parts = remaining;
+}
 
-		ItemBase* item = dynamic_cast<ItemBase *>(part);
-		if (!item) {
-			//We only remove the parts, we do not touch other elements of the scene (text of the net labels, etc.)
-			parts.removeAll(part);
-		} else {
-			if (item->family().compare("power label") == 0
-					|| item->family().compare("net label") == 0
-					|| item->family().compare("breadboard") == 0) //hack as half+ is not generated as breadboard object, see #3873
-			{
-				parts.removeAll(part);
-			}
-		}
+/**
+ * Whether an item is part of the simulation without having spice lines (wires, breadboards,
+ * power symbols, etc.), or is not a part at all.
+ */
+bool Simulator::isSimulatedWithoutSpice(QGraphicsItem * part) {
+	if (dynamic_cast<ConnectorItem *>(part)) return true;
+	if (dynamic_cast<Wire *>(part)) return true;
+	if (dynamic_cast<PartLabel *>(part)) return true;
+	if (dynamic_cast<Note *>(part)) return true;
+	if (dynamic_cast<LedLight *>(part)) return true;
+	if (dynamic_cast<SymbolPaletteItem *>(part)) return true;
+	if (dynamic_cast<ResizableBoard *>(part)) return true;
+	if (dynamic_cast<Perfboard *>(part)) return true;
+	if (dynamic_cast<Breadboard *>(part)) return true;
+	if (dynamic_cast<Ruler *>(part)) return true;
+
+	ItemBase* item = dynamic_cast<ItemBase *>(part);
+	if (!item) {
+		//We only remove the parts, we do not touch other elements of the scene (text of the net labels, etc.)
+		return true;
 	}
+	return item->family().compare("power label") == 0
+			|| item->family().compare("net label") == 0
+			|| item->family().compare("breadboard") == 0; //hack as half+ is not generated as breadboard object, see #3873
 }
 
 /*********************************************************************************************************************/
@@ -25,8 +25,36 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/itembase.h"
 #include "../simulation/ngspice_simulator.h"
 
+#include <QCache>
+#include <QElapsedTimer>
+
+#include <unordered_map>
+
 enum TransistorLeg { BASE, COLLECTOR, EMITER };
 
+struct SimulationResults {
+	bool completed = false;
+	int partCount = 0;						// parts simulated
+	QString error;							// with the simulator's log, when not completed
+	QList<double> netVoltages;				// by net number; net zero is ground
+	QList<QStringList> netConnectors;		// "part.connector" for the parts on each net
+	QHash<QString, double> partCurrents;	// by instance title, for the parts whose current ngspice reports
+	QStringList smokedParts;				// working outside their specifications
+	bool reused = false;					// ngspice already held the results of this netlist
+	bool cached = false;					// the results of this netlist came from the result cache
+	double netlistMs = 0;					// building the netlist
+	double loadMs = 0;						// loading it into ngspice
+	double runMs = 0;						// from bg_run to the results being back on the GUI thread
+	double fetchMs = 0;						// looking up the net voltages
+	double updateMs = 0;					// updating the parts with the results
+};
+
+struct SweepResults {
+	QVector<double> values;					// of the swept part
+	QList< QVector<double> > voltages;		// one list per voltage probe, a value per swept value
+	QList< QVector<double> > currents;		// one list per current probe
+};
+
 class Simulator : public QObject
 {
 	Q_OBJECT
@@ -38,33 +66,53 @@ public:
 	bool isSimulating();
 	void triggerSimulation();
 	void simulate();
+	bool isRunning() const;
+	const SimulationResults & results() const;
+	bool sweep(ItemBase * part, double start, double stop, int points,
+			   const QList<class ConnectorItem *> & voltageProbes, const QList<ItemBase *> & currentProbes, SweepResults &);
 
 private:
 	void resetTimer();
+	void clearNetList();
+	static QByteArray netlistHash(const QString &);
 
 public slots:
 	void enable(bool);
 	void stopSimulation();
 	void startSimulation();
 
+private slots:
+	void finishSimulation();
+	void simulationTimedOut();
+
 signals:
 	void simulationStartedOrStopped(bool running);
 	void simulationEnabled(bool enabled);
+	void simulationFinished();
 
 protected:	
 	void drawSmoke(ItemBase* part);
+	QGraphicsSvgItem * smokeItem(ItemBase* part);
 	void updateMultimeterScreen(ItemBase *, QString);
 	void updateMultimeterScreen(ItemBase *, double);
 	void removeSimItems();
 	void removeSimItems(QList<QGraphicsItem *>);
+	void hideSimItems(const QList<QGraphicsItem *> &);
 	void greyOutNonSimParts(const QSet<class ItemBase *>&);
 	void greyOutParts(const QList<QGraphicsItem *> &);
 	void removeItemsToBeSimulated(QList<QGraphicsItem*> &);
+	static bool isSimulatedWithoutSpice(QGraphicsItem *);
 
 	QChar getDeviceType (ItemBase*);
+	QString spiceDeviceName(ItemBase*, QString subpartName="");
+	QString currentVectorName(ItemBase*, QString subpartName="");
 	double getMaxPropValue(ItemBase*, QString);
 	QString getSymbol(ItemBase*, QString);
 	double getVectorValueOrDefault(const std::string & vecName, double defaultValue);
+	void fetchResults();
+	static std::string canonicalVectorName(const std::string &);
+	void collectResults();
+	void failSimulation(const QString & error);
 	double calculateVoltage(ConnectorItem *, ConnectorItem *);
 	double getCurrent(ItemBase*, QString subpartName="");
 	double getTransistorCurrent(QString spicePartName, TransistorLeg leg);
@@ -90,11 +138,28 @@ protected:
 	bool m_enabled;
 
 	QHash<ItemBase *, ItemBase *> m_sch2bbItemHash;
+	class QSvgRenderer * m_smokeRenderer = nullptr;	// shared by all the smoke images
 	QHash<ConnectorItem *, int> m_connector2netHash;
 
 	QList<QString>* m_instanceTitleSim;
 	QTimer *m_simTimer;
+	QTimer *m_simTimeoutTimer;
 	static constexpr int SimDelay = 200;
+	static constexpr int SimTimeOut = 3000;		// in ms
+
+	// the run ngspice is working on in the background
+	bool m_running = false;
+	bool m_stale = false;						// the circuit changed or the simulator stopped since the run began
+	QList< QList<ConnectorItem *>* > m_netList;
+	QSet<ItemBase *> m_itemBases;
+	QString m_spiceNetlist;
+	typedef std::unordered_map<std::string, double> VectorValues;		// by canonical vector name
+	VectorValues m_vectorValues;				// of the results being shown
+	QCache<QByteArray, VectorValues> m_resultCache;	// by netlist hash, least recently used first out
+	static constexpr int ResultCacheSize = 32;	// netlists
+	SimulationResults m_results;				// of the last run
+	QElapsedTimer m_runTimer;
+	QByteArray m_loadedNetlistHash;				// of the circuit whose results ngspice holds; empty when there are none
 	static constexpr double HarmfulNegativeVoltage = -0.5;
 
 };
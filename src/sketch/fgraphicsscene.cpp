@@ -22,6 +22,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../connectors/connectoritem.h"
 
 #include <QToolTip>
+#include <qmath.h>
+
+static constexpr int LargeSceneItemCount = 4096;
+static constexpr int ItemsPerLeaf = 16;
+static constexpr int MinBspDepth = 8;
+static constexpr int MaxBspDepth = 14;
 
 FGraphicsScene::FGraphicsScene( QObject * parent) : QGraphicsScene(parent)
 {
@@ -29,6 +35,20 @@ FGraphicsScene::FGraphicsScene( QObject * parent) : QGraphicsScene(parent)
 	//setItemIndexMethod(QGraphicsScene::NoIndex);
 }
 
+void FGraphicsScene::fitIndexToItems()
+{
+	// left at 0, Qt picks the BSP depth itself and regenerates the whole index whenever it changes its mind;
+	// a large scene gets a fixed depth with a handful of items in each leaf
+	int count = items().count();
+	int depth = 0;
+	if (count >= LargeSceneItemCount) {
+		depth = qBound(MinBspDepth, qCeil(qLn(double(count) / ItemsPerLeaf) / qLn(2.0)), MaxBspDepth);
+	}
+	if (depth != bspTreeDepth()) {
+		setBspTreeDepth(depth);
+	}
+}
+
 void FGraphicsScene::helpEvent(QGraphicsSceneHelpEvent *helpEvent)
 {
 	// TODO: how do we get a QTransform?
@@ -38,6 +38,7 @@ public:
 	void setDisplayHandles(bool);
 	bool displayHandles();
 	QList<ItemBase *> lockedSelectedItems();
+	void fitIndexToItems();
 
 protected:
 	QPointF m_lastContextMenuPos;
@@ -20,12 +20,18 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "infographicsview.h"
 #include "../debugdialog.h"
+#include "../installedfonts.h"
 #include "../infoview/htmlinfoview.h"
+#include "../utils/interactionprofiler.h"
 
 #include <QMessageBox>
+#include <QPaintEvent>
+#include <QPainter>
 
 static LayerHash ViewLayers;
 
+static const int ProfileOverlayRefreshMs = 250;
+
 InfoGraphicsView::InfoGraphicsView( QWidget * parent )
 	: ZoomableGraphicsView(parent)
 {
@@ -33,6 +39,80 @@ InfoGraphicsView::InfoGraphicsView( QWidget * parent )
 	m_boardLayers = 1;
 	m_hoverEnterMode = m_hoverEnterConnectorMode = false;
 	m_smdOrientation = Qt::Vertical;
+
+	m_profileOverlayTimer.setInterval(ProfileOverlayRefreshMs);
+	connect(&m_profileOverlayTimer, &QTimer::timeout, this, [this]() {
+		viewport()->update(m_profileOverlayRect);
+	});
+}
+
+void InfoGraphicsView::setProfileOverlay(bool show) {
+	if (show) {
+		m_profileOverlayTimer.start();
+	}
+	else {
+		m_profileOverlayTimer.stop();
+	}
+	viewport()->update();
+}
+
+void InfoGraphicsView::paintEvent(QPaintEvent * event) {
+	// the overlay refreshing itself isn't a frame worth counting
+	bool overlay = m_profileOverlayTimer.isActive();
+	if (!InteractionProfiler::enabled() || (overlay && m_profileOverlayRect.contains(event->rect()))) {
+		ZoomableGraphicsView::paintEvent(event);
+	}
+	else {
+		{
+			InteractionProfiler::Scope profile(InteractionProfiler::Paint);
+			ZoomableGraphicsView::paintEvent(event);
+		}
+		InteractionProfiler::frameDone();
+	}
+
+	if (overlay) {
+		paintProfileOverlay();
+	}
+}
+
+void InfoGraphicsView::paintProfileOverlay() {
+	const InteractionProfiler::Frame & frame = InteractionProfiler::lastFrame();
+	auto line = [&frame](InteractionProfiler::Span span, const QString & indent) {
+		return QString("%1%2 %3 ms (%4)")
+		       .arg(indent, InteractionProfiler::spanName(span))
+		       .arg(frame.ns[span] / 1.0e6, 0, 'f', 2)
+		       .arg(frame.calls[span]);
+	};
+
+	QStringList lines;
+	lines << line(InteractionProfiler::Paint, "") + QString(", %1 items").arg(frame.itemsPainted);
+	lines << line(InteractionProfiler::MouseMove, "");
+	lines << line(InteractionProfiler::PrepMove, "  ");
+	lines << line(InteractionProfiler::MoveItems, "  ");
+	lines << line(InteractionProfiler::FindConnectorsUnder, "    ");
+	lines << line(InteractionProfiler::Ratsnest, "");
+	lines << line(InteractionProfiler::CommandPush, "");
+
+	InstalledFonts::registerFonts();
+	QPainter painter(viewport());
+	QFont font("Droid Sans Mono");
+	font.setStyleHint(QFont::Monospace);
+	painter.setFont(font);
+	QFontMetrics metrics(font);
+	int width = 0;
+	Q_FOREACH (QString text, lines) {
+		width = qMax(width, metrics.horizontalAdvance(text));
+	}
+
+	static const int Margin = 6;
+	m_profileOverlayRect = QRect(Margin, Margin, width + Margin * 2, metrics.lineSpacing() * lines.count() + Margin * 2);
+	painter.fillRect(m_profileOverlayRect, QColor(0, 0, 0, 176));
+	painter.setPen(Qt::white);
+	int y = m_profileOverlayRect.top() + Margin + metrics.ascent();
+	Q_FOREACH (QString text, lines) {
+		painter.drawText(m_profileOverlayRect.left() + Margin, y, text);
+		y += metrics.lineSpacing();
+	}
 }
 
 void InfoGraphicsView::viewItemInfo(ItemBase * item) {
@@ -384,6 +464,16 @@ void InfoGraphicsView::setActiveConnectorItem(ConnectorItem * connectorItem)
 void InfoGraphicsView::resolveTemporary(bool, ItemBase *)
 {
 }
+
+void InfoGraphicsView::indexItem(ItemBase *, bool)
+{
+}
+
+ConnectorGrid * InfoGraphicsView::connectorGrid()
+{
+	return nullptr;
+}
+
 void InfoGraphicsView::newWire(Wire * wire)
 {
 	// Bool 'succeeded' was removed from this line because its result was overwritten in the next line.
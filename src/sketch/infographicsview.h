@@ -25,6 +25,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMenu>
 #include <QHash>
 #include <QList>
+#include <QTimer>
 
 #include "../items/itembase.h"
 #include "zoomablegraphicsview.h"
@@ -103,6 +104,8 @@ public:
 	virtual void changeWireColor(const QString newColor);
 	virtual void swap(const QString & family, const QString & prop, QMap<QString, QString> & propsMap, ItemBase *);
 	virtual void resolveTemporary(bool, ItemBase *);
+	virtual void indexItem(ItemBase *, bool inScene);
+	virtual class ConnectorGrid * connectorGrid();
 	virtual void newWire(Wire *);
 
 	void setActiveWire(Wire *);
@@ -111,6 +114,7 @@ public:
 	Qt::Orientations smdOrientation();
 	virtual void moveItem(ItemBase *, double x, double y);
 	virtual void rotateX(double degrees, bool rubberBandLegEnabled, ItemBase * originatingItem);
+	void setProfileOverlay(bool);
 
 public Q_SLOTS:
 	virtual void setVoltage(double, bool doEmit);
@@ -130,11 +134,17 @@ public:
 
 protected:
 	QGraphicsItem *selectedAux();
+	void paintEvent(QPaintEvent *) override;
+	void paintProfileOverlay();
+
+protected:
 	class HtmlInfoView *m_infoView;
 	int m_boardLayers;
 	bool m_hoverEnterMode;
 	bool m_hoverEnterConnectorMode;
 	Qt::Orientations m_smdOrientation;
+	QTimer m_profileOverlayTimer;
+	QRect m_profileOverlayRect;
 };
 
 #endif
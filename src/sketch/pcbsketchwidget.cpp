@@ -22,6 +22,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "pcbsketchwidget.h"
 #include "../debugdialog.h"
+#include "../installedfonts.h"
 #include "../items/tracewire.h"
 #include "../items/virtualwire.h"
 #include "../items/resizableboard.h"
@@ -32,6 +33,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/partlabel.h"
 #include "../autoroute/drc.h"
 #include "../autoroute/binpacking/GuillotineBinPack.h"
+#include "../autoroute/binpacking/MaxRectsBinPack.h"
 #include "../items/groundplane.h"
 #include "../items/jumperitem.h"
 #include "../utils/graphicsutils.h"
@@ -44,6 +46,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../version/version.h"
 #include "../items/FProbeR1PosPCB.h"
 #include "../items/FProbeRPartLabel.h"
+#include "../utils/tracer.h"
+#include "../utils/settingscache.h"
 
 #include <limits>
 #include <QApplication>
@@ -53,7 +57,6 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVBoxLayout>
 #include <QGroupBox>
 #include <QDialogButtonBox>
-#include <QSettings>
 #include <QPushButton>
 #include <QMessageBox>
 #include <QNetworkAccessManager>
@@ -67,8 +70,17 @@ static constexpr double StrokeWidthIncrement = 50;
 static QString PCBTraceColor1 = "trace1";
 static QString PCBTraceColor = "trace";
 
+static const QString PlacementPackerSettingName("PlacementPacker");      // "maxrects" packs denser than the default guillotine
+
 QSizeF PCBSketchWidget::m_jumperItemSize = QSizeF(0, 0);
 
+static QSize placementFootprint(QGraphicsItem * item, int keepout)
+{
+	// what a part takes in a board's placement pack
+	QRectF r = item->sceneBoundingRect();
+	return QSize(r.width() + keepout * 2, r.height() + keepout * 2);
+}
+
 //////////////////////////////////////////////////////
 
 const char * PCBSketchWidget::FakeTraceProperty = "FakeTrace";
@@ -540,6 +552,7 @@ void PCBSketchWidget::showGroundTraces(QList<ConnectorItem *> & connectorItems,
 }
 
 void PCBSketchWidget::getLabelFont(QFont & font, QColor & color, ItemBase * itemBase) {
+	InstalledFonts::registerFonts();
 	font.setFamily(OCRFFontName);
 	font.setPointSize(getLabelFontSizeSmall());
 	font.setBold(false);
@@ -1134,6 +1147,7 @@ ItemBase * PCBSketchWidget::addCopperLogoItem(ViewLayer::ViewLayerPlacement view
 }
 
 bool PCBSketchWidget::hasAnyNets() {
+	flushDeferredRoutingStatus();
 	return m_routingStatus.m_netCount > 0;
 }
 
@@ -1156,8 +1170,7 @@ QSizeF PCBSketchWidget::jumperItemSize() {
 double PCBSketchWidget::getKeepout() {
 	QString keepoutString = m_autorouterSettings.value(DRC::KeepoutSettingName);
 	if (keepoutString.isEmpty()) {
-		QSettings settings;
-		keepoutString = settings.value(DRC::KeepoutSettingName, "").toString();
+		keepoutString = SettingsCache::stringValue(DRC::KeepoutSettingName);
 	}
 	bool ok;
 	double inches = TextUtils::convertToInches(keepoutString, &ok, false);
@@ -1232,28 +1245,12 @@ ItemBase * PCBSketchWidget::placePartDroppedInOtherView(ModelPart * modelPart, V
 		auto boardRect = board->sceneBoundingRect();
 		int keepout = 10;
 		int boardKeepout = 5;
-		rbp::GuillotineBinPack binPack(boardRect.width() - boardKeepout * 2, boardRect.height() - boardKeepout * 2);
-
-		std::map<std::string, ItemBase *> items;
-
-		QList<QGraphicsItem *> onBoard = getCollidingItems(board, newItem);
-		Q_FOREACH (QGraphicsItem * item, onBoard) {
-			auto * itemBase = dynamic_cast<ItemBase *>(item);
-			QStringList keys;
-			auto properties = itemBase->prepareProps(itemBase->modelPart(), true, keys);
-			items[properties["id"].toStdString()] = itemBase;
-		}
-
-		// Sort by id to make sure parts are always added in correct order for bin packing algorithm.
-		// This might not yet work well if parts are manually moved in the PCB view.
-		for (auto& [id, itemBase]: items) {
-			QRectF r = itemBase->sceneBoundingRect();
-			binPack.Insert(r.width() + keepout * 2, r.height() + keepout * 2, true, rbp::GuillotineBinPack::RectBestAreaFit, rbp::GuillotineBinPack::SplitMinimizeArea);
-		}
+		PlacementPack & pack = placementPack(board, newItem, keepout, boardKeepout);
 
 		auto newWidth = newItem->sceneBoundingRect().width() + keepout * 2;
 		auto newHeight = newItem->sceneBoundingRect().height() + keepout * 2;
-		rbp::Rect rect = binPack.Insert(newWidth, newHeight, true, rbp::GuillotineBinPack::RectBestAreaFit, rbp::GuillotineBinPack::SplitMinimizeArea);
+		rbp::Rect rect = insertPlacement(pack, newWidth, newHeight);
+		bool inserted = rect.height != 0;
 		rect.x += boardRect.x() + boardKeepout + keepout;
 		rect.y += boardRect.y() + boardKeepout + keepout;
 		bool rotated = false;
@@ -1302,6 +1299,12 @@ ItemBase * PCBSketchWidget::placePartDroppedInOtherView(ModelPart * modelPart, V
 			}
 
 		}
+		if (inserted) {
+			pack.packed.insert(newItem->id(), placementFootprint(newItem, keepout));
+			if (rect.height == 0) {
+				pack.unplaced.insert(newItem->id());
+			}
+		}
 		if (rect.height != 0) {
 			break;
 		}
@@ -1310,6 +1313,76 @@ ItemBase * PCBSketchWidget::placePartDroppedInOtherView(ModelPart * modelPart, V
 	return newItem;
 }
 
+PCBSketchWidget::PlacementPack & PCBSketchWidget::placementPack(ItemBase * board, ItemBase * newItem, int keepout, int boardKeepout)
+{
+	// Parts dropped in another view arrive here one at a time, so keep the pack from one part to the next
+	// and only rebuild it when the parts on the board are no longer the ones it was built from.
+
+	QRectF boardRect = board->sceneBoundingRect();
+	QSize boardSize(boardRect.width() - boardKeepout * 2, boardRect.height() - boardKeepout * 2);
+	bool maxRects = SettingsCache::stringValue(PlacementPackerSettingName).compare("maxrects", Qt::CaseInsensitive) == 0;
+
+	QList<QGraphicsItem *> onBoard = getCollidingItems(board, newItem);
+	PlacementPack & pack = m_placementPacks[board->id()];
+	bool valid = pack.boardSize == boardSize && pack.maxRects == maxRects && (pack.guillotine || pack.maxRectsPack);
+	if (valid) {
+		QSet<long> found;
+		Q_FOREACH (QGraphicsItem * item, onBoard) {
+			auto * itemBase = dynamic_cast<ItemBase *>(item);
+			auto it = pack.packed.constFind(itemBase->id());
+			if (it == pack.packed.constEnd() || it.value() != placementFootprint(itemBase, keepout)) {
+				valid = false;
+				break;
+			}
+			found.insert(itemBase->id());
+		}
+		if (valid) {
+			for (auto it = pack.packed.constBegin(); it != pack.packed.constEnd(); ++it) {
+				if (!found.contains(it.key()) && !pack.unplaced.contains(it.key())) {
+					valid = false;
+					break;
+				}
+			}
+		}
+	}
+	if (valid) return pack;
+
+	pack = PlacementPack();
+	pack.boardSize = boardSize;
+	pack.maxRects = maxRects;
+	if (maxRects) {
+		pack.maxRectsPack.reset(new rbp::MaxRectsBinPack(boardSize.width(), boardSize.height()));
+	}
+	else {
+		pack.guillotine.reset(new rbp::GuillotineBinPack(boardSize.width(), boardSize.height()));
+	}
+
+	QMap<QString, ItemBase *> items;
+	Q_FOREACH (QGraphicsItem * item, onBoard) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		items.insert(QString("%1 %2 %3").arg(QString::number(itemBase->id()), itemBase->moduleID(), ViewLayer::viewLayerNameFromID(itemBase->viewLayerID())), itemBase);
+	}
+
+	// Sort by id to make sure parts are always added in correct order for bin packing algorithm.
+	// This might not yet work well if parts are manually moved in the PCB view.
+	Q_FOREACH (ItemBase * itemBase, items) {
+		QSize footprint = placementFootprint(itemBase, keepout);
+		insertPlacement(pack, footprint.width(), footprint.height());
+		pack.packed.insert(itemBase->id(), footprint);
+	}
+
+	return pack;
+}
+
+rbp::Rect PCBSketchWidget::insertPlacement(PlacementPack & pack, int width, int height)
+{
+	if (pack.maxRectsPack) {
+		return pack.maxRectsPack->Insert(width, height, rbp::MaxRectsBinPack::RectBestAreaFit);
+	}
+
+	return pack.guillotine->Insert(width, height, true, rbp::GuillotineBinPack::RectBestAreaFit, rbp::GuillotineBinPack::SplitMinimizeArea);
+}
+
 void PCBSketchWidget::autorouterSettings() {
 	// initialize settings values if they haven't already been initialized
 	getKeepout();
@@ -1320,9 +1393,8 @@ void PCBSketchWidget::autorouterSettings() {
 	AutorouterSettingsDialog dialog(m_autorouterSettings);
 	if (QDialog::Accepted == dialog.exec()) {
 		m_autorouterSettings = dialog.getSettings();
-		QSettings settings;
 		Q_FOREACH (QString key, m_autorouterSettings.keys()) {
-			settings.setValue(key, m_autorouterSettings.value(key));
+			SettingsCache::setValue(key, m_autorouterSettings.value(key));
 		}
 	}
 }
@@ -1341,12 +1413,11 @@ void PCBSketchWidget::getDefaultViaSize(QString & ringThickness, QString & holeS
 	ringThickness = m_autorouterSettings.value(Via::AutorouteViaRingThickness, "");
 	holeSize = m_autorouterSettings.value(Via::AutorouteViaHoleSize, "");
 
-	QSettings settings;
 	if (ringThickness.isEmpty()) {
-		ringThickness = settings.value(Via::AutorouteViaRingThickness, Via::DefaultAutorouteViaRingThickness).toString();
+		ringThickness = SettingsCache::stringValue(Via::AutorouteViaRingThickness, Via::DefaultAutorouteViaRingThickness);
 	}
 	if (holeSize.isEmpty()) {
-		holeSize = settings.value(Via::AutorouteViaHoleSize, Via::DefaultAutorouteViaHoleSize).toString();
+		holeSize = SettingsCache::stringValue(Via::AutorouteViaHoleSize, Via::DefaultAutorouteViaHoleSize);
 	}
 
 	m_autorouterSettings.insert(Via::AutorouteViaRingThickness, ringThickness);
@@ -1356,6 +1427,9 @@ void PCBSketchWidget::getDefaultViaSize(QString & ringThickness, QString & holeS
 void PCBSketchWidget::deleteItem(ItemBase * itemBase, bool deleteModelPart, bool doEmit, bool later)
 {
 	bool boardDeleted = Board::isBoard(itemBase);
+	if (boardDeleted) {
+		m_placementPacks.remove(itemBase->id());
+	}
 	SketchWidget::deleteItem(itemBase, deleteModelPart, doEmit, later);
 	if (boardDeleted) {
 		if (findBoard().count() == 0) {
@@ -1372,9 +1446,8 @@ double PCBSketchWidget::getTraceWidth() {
 double PCBSketchWidget::getAutorouterTraceWidth() {
 	QString traceWidthString = m_autorouterSettings.value(AutorouterSettingsDialog::AutorouteTraceWidth, "");
 	if (traceWidthString.isEmpty()) {
-		QSettings settings;
 		QString def = QString::number(GraphicsUtils::pixels2mils(getTraceWidth(), GraphicsUtils::SVGDPI));
-		traceWidthString = settings.value(AutorouterSettingsDialog::AutorouteTraceWidth, def).toString();
+		traceWidthString = SettingsCache::stringValue(AutorouterSettingsDialog::AutorouteTraceWidth, def);
 	}
 
 	m_autorouterSettings.insert(AutorouterSettingsDialog::AutorouteTraceWidth, traceWidthString);
@@ -1396,6 +1469,7 @@ double PCBSketchWidget::getSmallerTraceWidth(double minDim) {
 
 bool PCBSketchWidget::groundFill(bool fillGroundTraces, ViewLayer::ViewLayerID viewLayerID, QUndoCommand * parentCommand)
 {
+	Tracer::Scope tracing("groundfill", ViewLayer::viewLayerNameFromID(viewLayerID));
 	m_groundFillSeeds = nullptr;
 	int boardCount;
 	ItemBase * board = findSelectedBoard(boardCount);
@@ -1429,17 +1503,95 @@ bool PCBSketchWidget::groundFill(bool fillGroundTraces, ViewLayer::ViewLayerID v
 		m_groundFillSeeds = &seeds;
 	}
 
+	QString boardSvg, svg0, svg1;
+	QRectF boardImageRect, copperImageRect;
+	if (!renderFillSvgs(board, viewLayerID, fillGroundTraces ? &seeds : nullptr, boardSvg, boardImageRect, svg0, svg1, copperImageRect)) {
+		return false;
+	}
+
+	QStringList exceptions;
+	exceptions << "none" << "" << background().name();    // the color of holes in the board
+
+	// both layers fill at once; the undo commands are built once both are done
+	GroundPlaneGenerator gpg0;
+	QFuture<bool> future0;
+	if (!svg0.isEmpty()) {
+		gpg0.setLayerName("groundplane");
+		gpg0.setStrokeWidthIncrement(StrokeWidthIncrement);
+		gpg0.setMinRunSize(10, 10);
+		if (fillGroundTraces) {
+			connect(&gpg0, SIGNAL(postImageSignal(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
+			        this, SLOT(postImageSlot(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
+			        Qt::DirectConnection);
+		}
+
+		future0 = gpg0.startGroundPlane(boardSvg, boardImageRect.size(), svg0, copperImageRect.size(), exceptions, board, GraphicsUtils::StandardFritzingDPI / 2.0  /* 2 MIL */,
+		                                ViewLayer::Copper0Color, getKeepoutMils());
+	}
+
+	GroundPlaneGenerator gpg1;
+	QFuture<bool> future1;
+	if (boardLayers() > 1 && !svg1.isEmpty()) {
+		gpg1.setLayerName("groundplane1");
+		gpg1.setStrokeWidthIncrement(StrokeWidthIncrement);
+		gpg1.setMinRunSize(10, 10);
+		if (fillGroundTraces) {
+			connect(&gpg1, SIGNAL(postImageSignal(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
+			        this, SLOT(postImageSlot(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
+			        Qt::DirectConnection);
+		}
+		future1 = gpg1.startGroundPlane(boardSvg, boardImageRect.size(), svg1, copperImageRect.size(), exceptions, board, GraphicsUtils::StandardFritzingDPI / 2.0  /* 2 MIL */,
+		                                ViewLayer::Copper1Color, getKeepoutMils());
+	}
+
+	// a default QFuture counts as finished
+	while (!future0.isFinished() || !future1.isFinished()) {
+		ProcessEventBlocker::processEvents(200);
+	}
+
+	if (!svg0.isEmpty() && !future0.result()) {
+		QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to write copper fill (1)."));
+		return false;
+	}
+	if (boardLayers() > 1 && !svg1.isEmpty() && !future1.result()) {
+		QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to write copper fill (2)."));
+		return false;
+	}
+
+	QString fillType = (fillGroundTraces) ? GroundPlane::fillTypeGround : GroundPlane::fillTypePlain;
+	QSet<long> fillIDs;
+	addFillCommands(gpg0, ViewLayer::NewBottom, board, fillType, fillIDs, parentCommand);
+	addFillCommands(gpg1, ViewLayer::NewTop, board, fillType, fillIDs, parentCommand);
+
+	// a copper fill can be refilled later around whatever copper changes
+	m_copperFillSnapshot = CopperFillSnapshot();
+	if (!fillGroundTraces) {
+		m_copperFillSnapshot.boardID = board->id();
+		m_copperFillSnapshot.boardRect = board->sceneBoundingRect();
+		m_copperFillSnapshot.keepoutMils = getKeepoutMils();
+		m_copperFillSnapshot.viewLayerID = viewLayerID;
+		m_copperFillSnapshot.fillIDs = fillIDs;
+		m_copperFillSnapshot.copperRects = fillCopperRects(board);
+	}
+
+	return true;
+
+}
+
+bool PCBSketchWidget::renderFillSvgs(ItemBase * board, ViewLayer::ViewLayerID viewLayerID, QList<ConnectorItem *> * seeds, QString & boardSvg, QRectF & boardImageRect,
+                                     QString & svg0, QString & svg1, QRectF & copperImageRect)
+{
+	// the board and the copper on the sides being filled, as ground fill input; seeds' traces are left out
 	LayerList viewLayerIDs;
 	viewLayerIDs << ViewLayer::Board;
 
-	QRectF boardImageRect, copperImageRect;
 	RenderThing renderThing;
 	renderThing.printerScale = GraphicsUtils::SVGDPI;
 	renderThing.blackOnly = true;
 	renderThing.dpi = GraphicsUtils::StandardFritzingDPI;
 	renderThing.hideTerminalPoints = true;
 	renderThing.selectedItems = renderThing.renderBlocker = false;
-	QString boardSvg = renderToSVG(renderThing, board, viewLayerIDs);
+	boardSvg = renderToSVG(renderThing, board, viewLayerIDs);
 	if (boardSvg.isEmpty()) {
 		QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to render board svg (1)."));
 		return false;
@@ -1448,15 +1600,14 @@ bool PCBSketchWidget::groundFill(bool fillGroundTraces, ViewLayer::ViewLayerID v
 	boardImageRect = renderThing.imageRect;
 	renderThing.renderBlocker = true;
 
-	QString svg0;
 	if (viewLayerID == ViewLayer::UnknownLayer || viewLayerID == ViewLayer::GroundPlane0) {
 		viewLayerIDs.clear();
 		viewLayerIDs << ViewLayer::Copper0 << ViewLayer::Copper0Trace  << ViewLayer::GroundPlane0;
 
 		// hide ground traces so the ground plane will intersect them
-		if (fillGroundTraces) showGroundTraces(seeds, false);
+		if (seeds != nullptr) showGroundTraces(*seeds, false);
 		svg0 = renderToSVG(renderThing, board, viewLayerIDs);
-		if (fillGroundTraces) showGroundTraces(seeds, true);
+		if (seeds != nullptr) showGroundTraces(*seeds, true);
 		if (svg0.isEmpty()) {
 			QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to render copper svg (1)."));
 			return false;
@@ -1464,14 +1615,13 @@ bool PCBSketchWidget::groundFill(bool fillGroundTraces, ViewLayer::ViewLayerID v
 		copperImageRect = renderThing.imageRect;
 	}
 
-	QString svg1;
 	if (boardLayers() > 1 && (viewLayerID == ViewLayer::UnknownLayer || viewLayerID == ViewLayer::GroundPlane1)) {
 		viewLayerIDs.clear();
 		viewLayerIDs << ViewLayer::Copper1 << ViewLayer::Copper1Trace << ViewLayer::GroundPlane1;
 
-		if (fillGroundTraces) showGroundTraces(seeds, false);
+		if (seeds != nullptr) showGroundTraces(*seeds, false);
 		svg1 = renderToSVG(renderThing, board, viewLayerIDs);
-		if (fillGroundTraces) showGroundTraces(seeds, true);
+		if (seeds != nullptr) showGroundTraces(*seeds, true);
 		if (svg1.isEmpty()) {
 			QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to render copper svg (1)."));
 			return false;
@@ -1479,72 +1629,201 @@ bool PCBSketchWidget::groundFill(bool fillGroundTraces, ViewLayer::ViewLayerID v
 		copperImageRect = renderThing.imageRect;
 	}
 
+	return true;
+}
+
+void PCBSketchWidget::addFillCommands(GroundPlaneGenerator & gpg, ViewLayer::ViewLayerPlacement viewLayerPlacement, ItemBase * board, const QString & fillType,
+                                      QSet<long> & fillIDs, QUndoCommand * parentCommand)
+{
+	QRectF bsbr = board->sceneBoundingRect();
+	int ix = 0;
+	Q_FOREACH (QString svg, gpg.newSVGs()) {
+		ViewGeometry vg;
+		vg.setLoc(bsbr.topLeft() + gpg.newOffsets()[ix++]);
+		long newID = ItemBase::getNextID();
+		new AddItemCommand(this, BaseCommand::CrossView, ModuleIDNames::GroundPlaneModuleIDName, viewLayerPlacement, vg, newID, false, -1, parentCommand);
+		new SetPropCommand(this, newID, "svg", svg, svg, true, parentCommand);
+		new SetPropCommand(this, newID, "fillType", fillType, fillType, false, parentCommand);
+		fillIDs.insert(newID);
+	}
+}
+
+QList<ItemBase *> PCBSketchWidget::collectCopperFill(ItemBase * board, ViewLayer::ViewLayerID viewLayerID)
+{
+	// the fill a copper fill replaces: unlocked fill on the board, on one side or both
+	QList<ItemBase *> fill;
+	Q_FOREACH (QGraphicsItem * item, scene()->collidingItems(board)) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr) continue;
+		if (itemBase->moveLock()) continue;
+		if (itemBase->itemType() != ModelPart::CopperFill) continue;
+		if (viewLayerID != ViewLayer::UnknownLayer && itemBase->viewLayerID() != viewLayerID) continue;
+
+		itemBase = itemBase->layerKinChief();
+		if (!fill.contains(itemBase)) fill.append(itemBase);
+	}
+	return fill;
+}
+
+QHash<QGraphicsItem *, QRectF> PCBSketchWidget::fillCopperRects(ItemBase * board)
+{
+	// the copper a fill steers around, less the fill itself
+	QHash<QGraphicsItem *, QRectF> rects;
+	QRectF boardRect = board->sceneBoundingRect();
+	LayerList copperLayers = ViewLayer::copperLayers(ViewLayer::NewBottom) + ViewLayer::copperLayers(ViewLayer::NewTop);
+	Q_FOREACH (QGraphicsItem * item, scene()->items()) {
+		auto * itemBase = dynamic_cast<ItemBase *>(item);
+		if (itemBase == nullptr) continue;
+		if (itemBase->itemType() == ModelPart::CopperFill) continue;
+		if (!copperLayers.contains(itemBase->viewLayerID())) continue;
+
+		QRectF r = item->sceneBoundingRect();
+		if (r.intersects(boardRect)) rects.insert(item, r);
+	}
+	return rects;
+}
+
+bool PCBSketchWidget::copperRefill(ViewLayer::ViewLayerID viewLayerID, QUndoCommand * parentCommand, bool & fullFill)
+{
+	// redo the copper fill only around the copper changed since the last copper fill, replacing just the fill pieces there;
+	// fullFill comes back true when that can't be done: the last fill isn't known or has since changed, or the svgs aren't all vector
+	fullFill = true;
+	int boardCount;
+	ItemBase * board = findSelectedBoard(boardCount);
+	if (board == nullptr) return false;
+
+	double keepoutMils = getKeepoutMils();
+	QRectF bsbr = board->sceneBoundingRect();
+	if (m_copperFillSnapshot.boardID != board->id() || m_copperFillSnapshot.boardRect != bsbr) return false;
+	if (m_copperFillSnapshot.keepoutMils != keepoutMils || m_copperFillSnapshot.viewLayerID != viewLayerID) return false;
+
+	QList<ItemBase *> fill = collectCopperFill(board, viewLayerID);
+	QSet<long> fillIDs;
+	Q_FOREACH (ItemBase * itemBase, fill) {
+		fillIDs.insert(itemBase->id());
+	}
+	if (fillIDs != m_copperFillSnapshot.fillIDs) return false;
+
+	// the changed region is wherever copper was added, removed or moved since the fill, grown by the keepout
+	QHash<QGraphicsItem *, QRectF> copper = fillCopperRects(board);
+	const QHash<QGraphicsItem *, QRectF> & oldCopper = m_copperFillSnapshot.copperRects;
+	QRectF changed;
+	for (auto it = copper.constBegin(); it != copper.constEnd(); ++it) {
+		auto old = oldCopper.constFind(it.key());
+		if (old == oldCopper.constEnd()) changed |= it.value();
+		else if (old.value() != it.value()) changed |= it.value() | old.value();
+	}
+	for (auto it = oldCopper.constBegin(); it != oldCopper.constEnd(); ++it) {
+		if (!copper.contains(it.key())) changed |= it.value();
+	}
+	if (changed.isNull()) {
+		fullFill = false;
+		return true;
+	}
+
+	double milsPerPixel = GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI;
+	QRectF dirty((changed.left() - bsbr.left()) * milsPerPixel, (changed.top() - bsbr.top()) * milsPerPixel,
+	             changed.width() * milsPerPixel, changed.height() * milsPerPixel);
+	dirty.adjust(-keepoutMils - 1, -keepoutMils - 1, keepoutMils + 1, keepoutMils + 1);
+
+	// the fill being replaced would otherwise render as copper
+	Q_FOREACH (ItemBase * itemBase, fill) {
+		itemBase->setVisible(false);
+	}
+	QString boardSvg, svg0, svg1;
+	QRectF boardImageRect, copperImageRect;
+	bool rendered = renderFillSvgs(board, viewLayerID, nullptr, boardSvg, boardImageRect, svg0, svg1, copperImageRect);
+	Q_FOREACH (ItemBase * itemBase, fill) {
+		itemBase->setVisible(true);
+	}
+	if (!rendered) {
+		fullFill = false;
+		return false;
+	}
+
 	QStringList exceptions;
 	exceptions << "none" << "" << background().name();    // the color of holes in the board
 
-	GroundPlaneGenerator gpg0;
+	QList<ItemBase *> oldFill0, oldFill1;
+	Q_FOREACH (ItemBase * itemBase, fill) {
+		if (itemBase->viewLayerID() == ViewLayer::GroundPlane1) oldFill1.append(itemBase);
+		else oldFill0.append(itemBase);
+	}
+
+	GroundPlaneGenerator gpg0, gpg1;
+	QFuture<bool> future0, future1;
+	QList<GroundPlaneGenerator *> gpgs;
+	QList< QList<ItemBase *> * > oldFills;
 	if (!svg0.isEmpty()) {
 		gpg0.setLayerName("groundplane");
-		gpg0.setStrokeWidthIncrement(StrokeWidthIncrement);
-		gpg0.setMinRunSize(10, 10);
-		if (fillGroundTraces) {
-			connect(&gpg0, SIGNAL(postImageSignal(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
-			        this, SLOT(postImageSlot(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
-			        Qt::DirectConnection);
-		}
-
-		bool result = gpg0.generateGroundPlane(boardSvg, boardImageRect.size(), svg0, copperImageRect.size(), exceptions, board, GraphicsUtils::StandardFritzingDPI / 2.0  /* 2 MIL */,
-		                                       ViewLayer::Copper0Color, getKeepoutMils());
-		if (result == false) {
-			QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to write copper fill (1)."));
-			return false;
-		}
+		gpgs << &gpg0;
+		oldFills << &oldFill0;
 	}
-
-	GroundPlaneGenerator gpg1;
 	if (boardLayers() > 1 && !svg1.isEmpty()) {
 		gpg1.setLayerName("groundplane1");
-		gpg1.setStrokeWidthIncrement(StrokeWidthIncrement);
-		gpg1.setMinRunSize(10, 10);
-		if (fillGroundTraces) {
-			connect(&gpg1, SIGNAL(postImageSignal(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
-			        this, SLOT(postImageSlot(GroundPlaneGenerator *, QImage *, QImage *, QGraphicsItem *, QList<QRectF> *)),
-			        Qt::DirectConnection);
-		}
-		bool result = gpg1.generateGroundPlane(boardSvg, boardImageRect.size(), svg1, copperImageRect.size(), exceptions, board, GraphicsUtils::StandardFritzingDPI / 2.0  /* 2 MIL */,
-		                                       ViewLayer::Copper1Color, getKeepoutMils());
-		if (result == false) {
-			QMessageBox::critical(this, tr("Fritzing"), tr("Fritzing error: unable to write copper fill (2)."));
-			return false;
+		gpgs << &gpg1;
+		oldFills << &oldFill1;
+	}
+	for (int i = 0; i < gpgs.count(); i++) {
+		QStringList oldSVGs;
+		QList<QPointF> oldOffsets;
+		Q_FOREACH (ItemBase * itemBase, *oldFills.at(i)) {
+			auto * groundPlane = qobject_cast<GroundPlane *>(itemBase);
+			if (groundPlane == nullptr) return false;
+
+			oldSVGs << groundPlane->svg();
+			oldOffsets << itemBase->pos() - bsbr.topLeft();
 		}
+		gpgs.at(i)->setStrokeWidthIncrement(StrokeWidthIncrement);
+		gpgs.at(i)->setMinRunSize(10, 10);
+		gpgs.at(i)->setRefill(oldSVGs, oldOffsets, dirty);
 	}
 
+	if (gpgs.contains(&gpg0)) {
+		future0 = gpg0.startGroundPlane(boardSvg, boardImageRect.size(), svg0, copperImageRect.size(), exceptions, board, GraphicsUtils::StandardFritzingDPI / 2.0  /* 2 MIL */,
+		                                ViewLayer::Copper0Color, keepoutMils);
+	}
+	if (gpgs.contains(&gpg1)) {
+		future1 = gpg1.startGroundPlane(boardSvg, boardImageRect.size(), svg1, copperImageRect.size(), exceptions, board, GraphicsUtils::StandardFritzingDPI / 2.0  /* 2 MIL */,
+		                                ViewLayer::Copper1Color, keepoutMils);
+	}
 
-	QString fillType = (fillGroundTraces) ? GroundPlane::fillTypeGround : GroundPlane::fillTypePlain;
-	QRectF bsbr = board->sceneBoundingRect();
+	// a default QFuture counts as finished
+	while (!future0.isFinished() || !future1.isFinished()) {
+		ProcessEventBlocker::processEvents(200);
+	}
+	if (gpgs.contains(&gpg0) && !future0.result()) return false;
+	if (gpgs.contains(&gpg1) && !future1.result()) return false;
 
-	int ix = 0;
-	Q_FOREACH (QString svg, gpg0.newSVGs()) {
-		ViewGeometry vg;
-		vg.setLoc(bsbr.topLeft() + gpg0.newOffsets()[ix++]);
-		long newID = ItemBase::getNextID();
-		new AddItemCommand(this, BaseCommand::CrossView, ModuleIDNames::GroundPlaneModuleIDName, ViewLayer::NewBottom, vg, newID, false, -1, parentCommand);
-		new SetPropCommand(this, newID, "svg", svg, svg, true, parentCommand);
-		new SetPropCommand(this, newID, "fillType", fillType, fillType, false, parentCommand);
+	QSet<ItemBase *> toDelete;
+	for (int i = 0; i < gpgs.count(); i++) {
+		Q_FOREACH (int ix, gpgs.at(i)->replacedSVGs()) {
+			toDelete.insert(oldFills.at(i)->at(ix));
+		}
 	}
 
-	ix = 0;
-	Q_FOREACH (QString svg, gpg1.newSVGs()) {
-		ViewGeometry vg;
-		vg.setLoc(bsbr.topLeft() + gpg1.newOffsets()[ix++]);
-		long newID = ItemBase::getNextID();
-		new AddItemCommand(this, BaseCommand::CrossView, ModuleIDNames::GroundPlaneModuleIDName, ViewLayer::NewTop, vg, newID, false, -1, parentCommand);
-		new SetPropCommand(this, newID, "svg", svg, svg, true, parentCommand);
-		new SetPropCommand(this, newID, "fillType", fillType, fillType, false, parentCommand);
+	if (toDelete.count() > 0) {
+		new CleanUpWiresCommand(this, CleanUpWiresCommand::UndoOnly, parentCommand);
+		new CleanUpRatsnestsCommand(this, CleanUpWiresCommand::UndoOnly, parentCommand);
+
+		deleteMiddle(toDelete, parentCommand);
+		Q_FOREACH (ItemBase * itemBase, toDelete) {
+			itemBase->saveGeometry();
+			makeDeleteItemCommand(itemBase, BaseCommand::CrossView, parentCommand);
+			fillIDs.remove(itemBase->id());
+		}
+
+		new CleanUpRatsnestsCommand(this, CleanUpWiresCommand::RedoOnly, parentCommand);
+		new CleanUpWiresCommand(this, CleanUpWiresCommand::RedoOnly, parentCommand);
 	}
 
-	return true;
+	addFillCommands(gpg0, ViewLayer::NewBottom, board, GroundPlane::fillTypePlain, fillIDs, parentCommand);
+	addFillCommands(gpg1, ViewLayer::NewTop, board, GroundPlane::fillTypePlain, fillIDs, parentCommand);
 
+	m_copperFillSnapshot.fillIDs = fillIDs;
+	m_copperFillSnapshot.copperRects = copper;
+	fullFill = false;
+	return true;
 }
 
 QString PCBSketchWidget::generateCopperFillUnit(ItemBase * itemBase, QPointF whereToStart)
@@ -1833,6 +2112,9 @@ void PCBSketchWidget::postImageSlot(GroundPlaneGenerator * gpg, QImage * copperI
 
 	if (m_groundFillSeeds == nullptr) return;
 
+	// called from the generator's thread; both layers may be here at once, and the scene lookups shouldn't overlap
+	QMutexLocker locker(&m_postImageMutex);
+
 	ViewLayer::ViewLayerID viewLayerID = (gpg->layerName() == "groundplane") ? ViewLayer::Copper0 : ViewLayer::Copper1;
 
 	QRectF boardRect = board->sceneBoundingRect();
@@ -2766,10 +3048,9 @@ QDialog * PCBSketchWidget::quoteDialog(QWidget * parent) {
 }
 
 double PCBSketchWidget::getKeepoutMils() {
-	QSettings settings;
 	QString keepoutString = m_autorouterSettings.value(GroundPlaneGenerator::KeepoutSettingName);
 	if (keepoutString.isEmpty()) {
-		keepoutString = settings.value(GroundPlaneGenerator::KeepoutSettingName, "").toString();
+		keepoutString = SettingsCache::stringValue(GroundPlaneGenerator::KeepoutSettingName);
 	}
 
 	if (auto mils = TextUtils::convertToInches(keepoutString, false)) {
@@ -2796,8 +3077,7 @@ void PCBSketchWidget::setGroundFillKeepout() {
 	QString keepoutString = QString("%1in").arg(mils / 1000);
 	m_autorouterSettings.insert(GroundPlaneGenerator::KeepoutSettingName, keepoutString);
 
-	QSettings settings;
-	settings.setValue(GroundPlaneGenerator::KeepoutSettingName, keepoutString);
+	SettingsCache::setValue(GroundPlaneGenerator::KeepoutSettingName, keepoutString);
 }
 
 void PCBSketchWidget::setViewFromBelow(bool viewFromBelow) {
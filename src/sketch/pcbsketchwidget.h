@@ -26,6 +26,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVector>
 #include <QNetworkReply>
 #include <QDialog>
+#include <QMutex>
+#include <QSharedPointer>
+
+namespace rbp {
+	struct Rect;
+	class GuillotineBinPack;
+	class MaxRectsBinPack;
+}
 
 ///////////////////////////////////////////////
 
@@ -88,6 +96,7 @@ public:
 	void getBendpointWidths(class Wire *, double w, double & w1, double & w2, bool & negativeOffsetRect);
 	double getSmallerTraceWidth(double minDim);
 	bool groundFill(bool fillGroundTraces, ViewLayer::ViewLayerID, QUndoCommand * parentCommand);
+	bool copperRefill(ViewLayer::ViewLayerID, QUndoCommand * parentCommand, bool & fullFill);
 	void setGroundFillSeeds();
 	void clearGroundFillSeeds();
 	QString generateCopperFillUnit(ItemBase * itemBase, QPointF whereToStart);
@@ -138,6 +147,8 @@ public:
 	CleanType cleanType();
 
 protected:
+	struct PlacementPack;
+
 	void setWireVisible(Wire * wire);
 	// void checkAutorouted();
 	ViewLayer::ViewLayerID multiLayerGetViewLayerID(ModelPart * modelPart, ViewLayer::ViewID, ViewLayer::ViewLayerPlacement, LayerList &);
@@ -187,6 +198,13 @@ protected:
 	double getKeepoutMils();
 	bool updateOK(ConnectorItem *, ConnectorItem *);
 	QList<QGraphicsItem *> getCollidingItems(QGraphicsItem *target, QGraphicsItem *other);
+	bool renderFillSvgs(ItemBase * board, ViewLayer::ViewLayerID, QList<ConnectorItem *> * seeds, QString & boardSvg, QRectF & boardImageRect,
+	                    QString & svg0, QString & svg1, QRectF & copperImageRect);
+	void addFillCommands(class GroundPlaneGenerator &, ViewLayer::ViewLayerPlacement, ItemBase * board, const QString & fillType, QSet<long> & fillIDs, QUndoCommand * parentCommand);
+	QList<ItemBase *> collectCopperFill(ItemBase * board, ViewLayer::ViewLayerID);
+	QHash<QGraphicsItem *, QRectF> fillCopperRects(ItemBase * board);
+	PlacementPack & placementPack(ItemBase * board, ItemBase * newItem, int keepout, int boardKeepout);
+	static rbp::Rect insertPlacement(PlacementPack &, int width, int height);
 
 Q_SIGNALS:
 	void subSwapSignal(SketchWidget *, ItemBase *, const QString & newModuleID, ViewLayer::ViewLayerPlacement, long & newID, QUndoCommand * parentCommand);
@@ -208,6 +226,27 @@ protected:
 	QPointF m_jumperDragOffset;
 	QPointer<class JumperItem> m_resizingJumperItem;
 	QList<ConnectorItem *> * m_groundFillSeeds;
+	QMutex m_postImageMutex;
+
+	struct CopperFillSnapshot {
+		long boardID = -1;
+		QRectF boardRect;
+		double keepoutMils = 0;
+		ViewLayer::ViewLayerID viewLayerID = ViewLayer::UnknownLayer;
+		QSet<long> fillIDs;                             // the fill as made
+		QHash<QGraphicsItem *, QRectF> copperRects;     // the copper it was made around
+	};
+	CopperFillSnapshot m_copperFillSnapshot;           // as of the last copper fill or refill
+
+	struct PlacementPack {
+		QSize boardSize;
+		bool maxRects = false;
+		QHash<long, QSize> packed;                      // by item id, the footprint each part took in the pack
+		QSet<long> unplaced;                            // packed, but the part didn't end up on the board
+		QSharedPointer<rbp::GuillotineBinPack> guillotine;
+		QSharedPointer<rbp::MaxRectsBinPack> maxRectsPack;
+	};
+	QHash<long, PlacementPack> m_placementPacks;       // by board id, reused by each part dropped in another view
 	QHash<QString, QString> m_autorouterSettings;
 	QPointer<class QuoteDialog> m_quoteDialog;
 	QPointer<class QuoteDialog> m_rolloverQuoteDialog;
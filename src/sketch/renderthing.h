@@ -1,7 +1,50 @@
 #ifndef RENDERTHING_H
 #define RENDERTHING_H
 
+#include <QByteArray>
 #include <QGraphicsView>
+#include <QHash>
+#include <QStringList>
+#include <QTransform>
+
+// the svg each item added to a render, for later renders with the same settings, offset and unchanged items
+typedef QHash<QGraphicsItem *, QString> RenderFragments;
+
+// fragments kept from one export to the next; an item is only rendered again when its signature
+// changes, and the area it covered before and after is then marked dirty on its layer
+struct RenderCache {
+	struct Entry {
+		QByteArray signature;
+		QString fragment;
+		QRectF sceneRect;
+		int viewLayerID = 0;            // ViewLayer::ViewLayerID
+	};
+
+	QHash<QGraphicsItem *, Entry> entries;
+	QString settings;                   // of the renders the entries came from
+	QHash<int, QRectF> dirty;           // by ViewLayer::ViewLayerID, since takeRenderCacheDirt
+	int reused = 0;                     // since takeRenderCacheDirt
+	int rendered = 0;
+};
+
+// one item's share of a render: read off the item on the gui thread, then finished off it
+struct ItemSvgJob {
+	QGraphicsItem * item = nullptr;
+	QString fragment;                   // the part's own svg while unfinished
+	bool unfinished = false;
+	qint64 id = 0;
+	double factor = 1;
+	bool blocker = false;               // a copper blocker pad, whose rects are drawn opaque
+	QStringList terminalIDs;            // to hide
+	QStringList connectorIDs;           // to give a stroke width
+	QTransform transform;
+	QPointF loc;
+	QString legSvg;
+	QString extraSvg;
+	bool shared = false;                // placed by renderToSVG, which may move body into defs
+	QByteArray signature;               // to keep the fragment under in a RenderCache; empty when not kept
+	QString body;                       // a shared part's finished svg, before it is placed
+};
 
 struct RenderThing {
 	bool selectedItems;
@@ -14,6 +57,9 @@ struct RenderThing {
 	QRectF itemsBoundingRect;
 	bool empty;
 	bool hideTerminalPoints;
+	RenderFragments * fragments = nullptr;
+	RenderCache * cache = nullptr;      // only used for renders against a board, without shareParts
+	bool shareParts = false;            // parts drawing the same svg get it once in defs, placed with use
 
 	QList<QGraphicsItem *> getItems(QGraphicsScene * scene);
 	void setBoard(QGraphicsItem * board);
@@ -36,6 +36,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMainWindow>
 #include <QApplication>
 #include <QDomElement>
+#include <QVector>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <QSettings>
 #include <QClipboard>
 #include <QScrollBar>
@@ -52,11 +55,14 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/wire.h"
 #include "../commands.h"
 #include "../model/modelpart.h"
+#include "../model/binarysketch.h"
 #include "../debugdialog.h"
 #include "../items/layerkinpaletteitem.h"
 #include "sketchwidget.h"
 #include "../connectors/connectoritem.h"
 #include "../connectors/svgidlayer.h"
+#include "../connectors/connectorgrid.h"
+#include "../connectors/ercengine.h"
 #include "../items/jumperitem.h"
 #include "../items/stripboard.h"
 #include "../items/virtualwire.h"
@@ -79,6 +85,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/fmessagebox.h"
 #include "../fsvgrenderer.h"
 #include "../items/resistor.h"
+#include "../items/svgprefetcher.h"
 #include "../items/mysterypart.h"
 #include "../items/pinheader.h"
 #include "../items/dip.h"
@@ -89,6 +96,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../items/schematicframe.h"
 #include "../utils/graphutils.h"
 #include "../utils/ratsnestcolors.h"
+#include "../utils/interactionprofiler.h"
+#include "../testing/FTimingProbe.h"
 #include "../utils/cursormaster.h"
 
 /////////////////////////////////////////////////////////////////////
@@ -129,7 +138,16 @@ enum ConnectionStatus {
 static constexpr double CloseEnough = 0.5;  // in pixels, for swapping into the breadboard
 
 static constexpr int AutoRepeatDelay = 750;
+static constexpr int CoalescedMoveCount = 32;			// dragging at least this many items coalesces the follow-up work
+static constexpr int MoveFollowUpDelay = 16;			// about a frame
+static constexpr int UpdateInfoViewDelay = 50;
+static constexpr int DeferredRatsnestChanges = 4096;	// past this many queued connector changes a deferred update starts over
+static constexpr int BackgroundRoutingConnectors = 1000;	// a full rescore of at least this many connectors is scored on a worker
 bool SketchWidget::m_blockUI = false;
+QByteArray SketchWidget::ClipboardToken;
+QDomDocument SketchWidget::ClipboardDocument;
+
+static const QString ClipboardTokenFormat("application/x-fritzing-clipboard-token");
 
 /////////////////////////////////////////////////////////////////////
 
@@ -149,6 +167,17 @@ SketchWidget::SketchWidget(ViewLayer::ViewID viewID, QWidget *parent, int size,
 	m_arrowTimer.setTimerType(Qt::PreciseTimer);
 	m_autoScrollTimer.setTimerType(Qt::PreciseTimer);
 	connect(&m_arrowTimer, SIGNAL(timeout()), this, SLOT(arrowTimerTimeout()));
+	m_moveFollowUpTimer.setParent(this);
+	m_moveFollowUpTimer.setInterval(MoveFollowUpDelay);
+	m_moveFollowUpTimer.setSingleShot(true);
+	connect(&m_moveFollowUpTimer, SIGNAL(timeout()), this, SLOT(flushMoveFollowUp()));
+
+	// a rubber band or select-all asks for many updates; only the last selection is shown
+	m_updateInfoViewTimer.setParent(this);
+	m_updateInfoViewTimer.setInterval(UpdateInfoViewDelay);
+	m_updateInfoViewTimer.setSingleShot(true);
+	connect(&m_updateInfoViewTimer, SIGNAL(timeout()), this, SLOT(updateInfoViewSlot()));
+	connect(&m_routingWatcher, SIGNAL(finished()), this, SLOT(routingJobFinished()));
 	//setAlignment(Qt::AlignLeft | Qt::AlignTop);
 	setDragMode(QGraphicsView::RubberBandDrag);
 	setFrameStyle(QFrame::Sunken | QFrame::StyledPanel);
@@ -244,6 +273,10 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 	QHash<ItemBase *, long> superparts;
 	QHash<long, long> superparts2;
 	QList<ModelPart *> zeroLength;
+	if (!parentCommand) {
+		// items are created right below, so their svgs can be read and cooked meanwhile
+		SvgPrefetcher::prefetch(modelParts, m_viewID, viewLayers().keys());
+	}
 	// make parts
 	Q_FOREACH (ModelPart * mp, modelParts) {
 		QDomElement instance = mp->instanceDomElement();
@@ -419,6 +452,7 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 			}
 		}
 	}
+	SvgPrefetcher::finish();
 
 	Q_FOREACH (ModelPart * mp, zeroLength) {
 		modelParts.removeOne(mp);
@@ -456,7 +490,7 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 		}
 	}
 
-	QStringList alreadyConnected;
+	QSet<QString> alreadyConnected;
 
 	QHash<QString, QDomElement> legs;
 
@@ -580,11 +614,12 @@ void SketchWidget::loadFromModelParts(QList<ModelPart *> & modelParts, BaseComma
 		new CleanUpWiresCommand(this, CleanUpWiresCommand::RedoOnly, parentCommand);
 	}
 
+	qobject_cast<FGraphicsScene *>(scene())->fitIndexToItems();
 	setIgnoreSelectionChangeEvents(false);
 }
 
 void SketchWidget::handleConnect(QDomElement & connect, ModelPart * mp, const QString & fromConnectorID, ViewLayer::ViewLayerID fromViewLayerID,
-	                               QStringList & alreadyConnected, QHash<long, ItemBase *> & newItems, QUndoCommand * parentCommand,
+	                               QSet<QString> & alreadyConnected, QHash<long, ItemBase *> & newItems, QUndoCommand * parentCommand,
 	                               bool seekOutsideConnections)
 {
 	bool ok;
@@ -597,7 +632,7 @@ void SketchWidget::handleConnect(QDomElement & connect, ModelPart * mp, const QS
 	                  .arg(modelIndex).arg(toConnectorID).arg(toViewLayerID);
 	if (alreadyConnected.contains(already)) return;
 
-	alreadyConnected.append(already);
+	alreadyConnected.insert(already);
 
 	if (!parentCommand) {
 		ItemBase * fromBase = newItems.value(mp->modelIndex(), nullptr);
@@ -670,12 +705,14 @@ ItemBase * SketchWidget::addItemForCommand(const QString & moduleID, ViewLayer::
 	ModelPart * modelPart = m_referenceModel->retrieveModelPart(moduleID);
 
 	if (modelPart) {
-		if (!m_blockUI) {
+		// a paste shows its wait cursor once for all of its parts
+		bool feedback = !m_blockUI && !m_pasting;
+		if (feedback) {
 			QApplication::setOverrideCursor(Qt::WaitCursor);
 			statusMessage(tr("loading part"));
 		}
 		itemBase = addItem(modelPart, viewLayerPlacement, crossViewType, viewGeometry, id, modelIndex, originatingCommand);
-		if (!m_blockUI) {
+		if (feedback) {
 			statusMessage(tr("done loading"), 2000);
 			QApplication::restoreOverrideCursor();
 		}
@@ -703,6 +740,7 @@ ItemBase * SketchWidget::addItem(ModelPart * modelPart, ViewLayer::ViewLayerPlac
 		}
 		if (!mp) {
 			modelPart = m_sketchModel->addModelPart(m_sketchModel->root(), modelPart);
+			if (modelIndex >= 0) m_sketchModel->notePasted(id, modelPart);
 		}
 		else {
 			modelPart = mp;
@@ -807,6 +845,9 @@ void SketchWidget::checkStickyForCommand(long id, bool doEmit, bool checkCurrent
 	else if (itemBase->isBaseSticky()) {
 		stickyScoop(itemBase, checkCurrent, checkStickyCommand);
 	}
+	else if (stickyPlacementKept(itemBase, itemBase->stickingTo())) {
+		// moved along with its sticky base, so still sits on it
+	}
 	else {
 		ItemBase * stickyOne = overSticky(itemBase);
 		ItemBase * wasStickyOne = itemBase->stickingTo();
@@ -826,6 +867,7 @@ void SketchWidget::checkStickyForCommand(long id, bool doEmit, bool checkCurrent
 				}
 			}
 		}
+		rememberStickyPlacement(itemBase);
 	}
 
 	if (doEmit) {
@@ -912,33 +954,61 @@ void SketchWidget::addToScene(ItemBase * item, ViewLayer::ViewLayerID viewLayerI
 }
 
 ItemBase * SketchWidget::findItem(long id) {
-	// TODO:  this needs to be optimized: could make a hash table
-
 	long baseid = id / ModelPart::indexMultiplier;
 
-	Q_FOREACH (QGraphicsItem * item, this->scene()->items()) {
-		auto* base = dynamic_cast<ItemBase *>(item);
-		if (!base) continue;
+	ItemBase * found = nullptr;
+	auto it = m_itemIndex.find(baseid);
+	while (it != m_itemIndex.end() && it.key() == baseid) {
+		ItemBase * base = it.value().data();
+		if (base == nullptr || base->scene() != scene() || base->id() / ModelPart::indexMultiplier != baseid) {
+			// deleted, or its id was reset since it was indexed
+			it = m_itemIndex.erase(it);
+			continue;
+		}
 
 		if (base->id() == id) {
 			return base;
 		}
 
-		if (base->id() / ModelPart::indexMultiplier == baseid) {
-			// found chief or layerkin
-			ItemBase * chief = base->layerKinChief();
-			if (chief->id() == id) return chief;
+		if (found == nullptr) found = base;
+		++it;
+	}
 
-			Q_FOREACH (ItemBase * lk, chief->layerKin()) {
-				if (lk->id() == id) return lk;
-			}
+	if (found == nullptr) return nullptr;
 
-			return chief;
+	// found chief or layerkin
+	ItemBase * chief = found->layerKinChief();
+	if (chief->id() == id) return chief;
 
-		}
+	Q_FOREACH (ItemBase * lk, chief->layerKin()) {
+		if (lk->id() == id) return lk;
 	}
 
-	return nullptr;
+	return chief;
+}
+
+void SketchWidget::indexItem(ItemBase * itemBase, bool inScene) {
+	// items report joining and leaving the scene from itemChange, and report again when their id is reset;
+	// findItem drops entries that have gone stale in between
+	long baseid = itemBase->id() / ModelPart::indexMultiplier;
+	QPointer<ItemBase> pointer(itemBase);
+	if (qobject_cast<VirtualWire *>(itemBase) == nullptr) {
+		// ratsnest wires come and go with every update and never carry a connection
+		m_routingNetsValid = false;
+	}
+	if (!inScene) {
+		m_itemIndex.remove(baseid, pointer);
+	}
+	else if (!m_itemIndex.contains(baseid, pointer)) {
+		m_itemIndex.insert(baseid, pointer);
+	}
+}
+
+ConnectorGrid * SketchWidget::connectorGrid() {
+	// only while items are being dragged
+	if (m_savedItems.isEmpty()) return nullptr;
+
+	return m_connectorGrid.data();
 }
 
 void SketchWidget::deleteItemForCommand(long id, bool deleteModelPart, bool doEmit, bool later) {
@@ -1406,6 +1476,32 @@ void SketchWidget::rotateItemForCommand(long id, double degrees) {
 	}
 
 }
+void SketchWidget::rotateItemsForCommand(const QList<RotateItemThing> & rotateItemThings, double degrees, bool toNew) {
+	// rotate and place every item first, then update the wires attached to them once;
+	// a wire between two of the items is only moved for the first of them
+	QList<ItemBase *> itemBases;
+	ItemBase::holdConnectionUpdates(true);
+	Q_FOREACH (RotateItemThing rotateItemThing, rotateItemThings) {
+		ItemBase * itemBase = findItem(rotateItemThing.id);
+		if (!itemBase) continue;
+
+		ratsnestConnect(itemBase, true);
+		if (isVisible()) itemBase->rotateItem(degrees, false);
+		itemBase->moveItem(toNew ? rotateItemThing.newGeometry : rotateItemThing.oldGeometry);
+		itemBases.append(itemBase);
+	}
+	ItemBase::holdConnectionUpdates(false);
+
+	QList<ConnectorItem *> already;
+	Q_FOREACH (ItemBase * itemBase, itemBases) {
+		itemBase->updateConnections(true, already);
+		if (m_infoView) {
+			m_infoView->updateRotation(itemBase);
+			m_infoView->updateLocation(itemBase);
+		}
+	}
+}
+
 void SketchWidget::transformItemForCommand(long id, const QTransform & matrix) {
 	ItemBase * itemBase = findItem(id);
 	if (itemBase) {
@@ -1427,6 +1523,28 @@ void SketchWidget::flipItemForCommand(long id, Qt::Orientations orientation) {
 	}
 }
 
+void SketchWidget::flipItemsForCommand(const QList<long> & ids, Qt::Orientations orientation) {
+	if (!isVisible()) return;
+
+	QList<ItemBase *> itemBases;
+	ItemBase::holdConnectionUpdates(true);
+	Q_FOREACH (long id, ids) {
+		ItemBase * itemBase = findItem(id);
+		if (!itemBase) continue;
+
+		itemBase->flipItem(orientation);
+		itemBases.append(itemBase);
+	}
+	ItemBase::holdConnectionUpdates(false);
+
+	QList<ConnectorItem *> already;
+	Q_FOREACH (ItemBase * itemBase, itemBases) {
+		itemBase->updateConnections(false, already);
+		if (m_infoView) m_infoView->updateRotation(itemBase);
+		ratsnestConnect(itemBase, true);
+	}
+}
+
 void SketchWidget::changeWireForCommand(long fromID, QLineF line, QPointF pos, bool updateConnections, bool updateRatsnest)
 {
 	/*
@@ -1621,11 +1739,18 @@ void SketchWidget::copyAux(QList<ItemBase *> & bases, bool saveBoundingRects)
 	copyHeart(bases, saveBoundingRects, itemData, modelIndexes);
 
 	// only preserve connections for copied items that connect to each other
-	QByteArray newItemData = removeOutsideConnections(itemData, modelIndexes);
+	QDomDocument domDocument;
+	if (!domDocument.setContent(itemData)) return;
+	if (!removeOutsideConnections(domDocument, QSet<long>(modelIndexes.begin(), modelIndexes.end()))) return;
 
+	// the sketch's own copy is binary encoded, straight from the document; other applications still
+	// get the xml as text. A paste in this process picks the document itself up again by the token
 	auto *mimeData = new QMimeData;
-	mimeData->setData("application/x-dnditemsdata", newItemData);
-	mimeData->setData("text/plain", newItemData);
+	mimeData->setData("application/x-dnditemsdata", BinarySketch::encode(domDocument));
+	mimeData->setData("text/plain", domDocument.toByteArray());
+	ClipboardToken = QUuid::createUuid().toByteArray();
+	ClipboardDocument = domDocument;
+	mimeData->setData(ClipboardTokenFormat, ClipboardToken);
 
 	QClipboard *clipboard = QApplication::clipboard();
 	if (!clipboard) {
@@ -1693,23 +1818,25 @@ void SketchWidget::copyHeart(QList<ItemBase *> & bases, bool saveBoundingRects,
 	streamWriter.writeEndElement();
 }
 
-QByteArray SketchWidget::removeOutsideConnections(const QByteArray & itemData, QList<long> & modelIndexes) {
-	// now have to remove each connection that points to a part outside of the set of parts being copied
+bool SketchWidget::clipboardDocument(const QMimeData * mimeData, QDomDocument & document) {
+	// a copy made by this process: a deep copy of the document it kept, since the paste renumbers it
+	if (mimeData == nullptr || ClipboardToken.isEmpty() || ClipboardDocument.isNull()) return false;
+	if (mimeData->data(ClipboardTokenFormat) != ClipboardToken) return false;
 
-	QDomDocument domDocument;
-	QString errorStr;
-	int errorLine;
-	int errorColumn;
-	bool result = domDocument.setContent(itemData, &errorStr, &errorLine, &errorColumn);
-	if (!result) return ___emptyByteArray___;
+	document = ClipboardDocument.cloneNode(true).toDocument();
+	return !document.isNull();
+}
+
+bool SketchWidget::removeOutsideConnections(QDomDocument & domDocument, const QSet<long> & modelIndexes) {
+	// now have to remove each connection that points to a part outside of the set of parts being copied
 
 	QDomElement root = domDocument.documentElement();
 	if (root.isNull()) {
-		return ___emptyByteArray___;
+		return false;
 	}
 
 	QDomElement instances = root.firstChildElement("instances");
-	if (instances.isNull()) return ___emptyByteArray___;
+	if (instances.isNull()) return false;
 
 	QDomElement instance = instances.firstChildElement("instance");
 	while (!instance.isNull()) {
@@ -1752,7 +1879,7 @@ QByteArray SketchWidget::removeOutsideConnections(const QByteArray & itemData, Q
 		instance = instance.nextSiblingElement("instance");
 	}
 
-	return domDocument.toByteArray();
+	return true;
 }
 
 
@@ -1804,6 +1931,14 @@ bool SketchWidget::setDroppingItemAndOffset(const QPoint & pos, const QPointF &
 	QSizeF size = m_droppingItem->sceneBoundingRect().size();
 	m_droppingOffset = QPointF(size.width() / 2, size.height() / 2);
 
+	// keep the part's renderers loaded past this drag, for the next drag of it and for the drop
+	QList<FSvgRenderer *> renderers;
+	renderers << m_droppingItem->fsvgRenderer();
+	Q_FOREACH (ItemBase * lkpi, m_droppingItem->layerKin()) {
+		renderers << lkpi->fsvgRenderer();
+	}
+	FSvgRenderer::keepPrototype(QString("%1 %2").arg(modelPart->moduleID()).arg(m_viewID), renderers);
+
 	QHash<long, ItemBase *> savedItems;
 	QHash<Wire *, ConnectorItem *> savedWires;
 	findAlignmentAnchor(m_droppingItem, savedItems, savedWires);
@@ -2371,7 +2506,9 @@ void SketchWidget::mousePressEvent(QMouseEvent *event)
 }
 
 void SketchWidget::prepMove(ItemBase * originatingItem, bool rubberBandLegEnabled, bool includeRatsnest) {
+	InteractionProfiler::Scope profile(InteractionProfiler::PrepMove);
 	m_originatingItem = originatingItem;
+	m_connectorGrid.reset();
 	m_rubberBandLegWasEnabled = rubberBandLegEnabled;
 	m_checkUnder.clear();
 	//DebugDialog::debug("prep move check under = false");
@@ -2853,6 +2990,7 @@ void SketchWidget::clickBackground(QMouseEvent *)
 
 void SketchWidget::prepDragWire(Wire * wire)
 {
+	m_connectorGrid.reset();
 	bool drag = true;
 	Q_FOREACH (ConnectorItem * toConnectorItem, wire->connector0()->connectedToItems()) {
 		if (toConnectorItem->attachedToItemType() == ModelPart::Wire) {
@@ -2975,6 +3113,8 @@ void SketchWidget::mouseMoveEvent(QMouseEvent *event) {
 
 	if (m_movingByArrow) return;
 
+	InteractionProfiler::Scope profile(InteractionProfiler::MouseMove);
+
 	QPointF scenePos = mapToScene(event->pos());
 
 	double posx = scenePos.x() / GraphicsUtils::SVGDPI;
@@ -3112,6 +3252,8 @@ void SketchWidget::moveItemsScene(QPointF scenePos, bool checkAutoScrollFlag, bo
 
 void SketchWidget::moveItemsAux(QPointF scenePos, QPoint globalPos, bool checkAutoScrollFlag, bool rubberBandLegEnabled)
 {
+	InteractionProfiler::Scope profile(InteractionProfiler::MoveItems);
+
 	if (checkAutoScrollFlag) {
 		bool result = checkAutoscroll(globalPos);
 		if (!result) return;
@@ -3141,16 +3283,34 @@ void SketchWidget::moveItemsAux(QPointF scenePos, QPoint globalPos, bool checkAu
 		}
 	}
 
+	if (m_connectorGrid.isNull() && !m_checkUnder.isEmpty()) {
+		// everything outside the drag stays put until the next prepMove
+		QSet<ItemBase *> moving;
+		Q_FOREACH (ItemBase * itemBase, m_savedItems) {
+			ItemBase * chief = itemBase->layerKinChief();
+			moving.insert(chief);
+			Q_FOREACH (ItemBase * lk, chief->layerKin()) {
+				moving.insert(lk);
+			}
+		}
+		Q_FOREACH (Wire * wire, m_savedWires.keys()) {
+			moving.insert(wire);
+		}
+		QSet<ConnectorItem *> live;
+		Q_FOREACH (ConnectorItem * connectorItem, m_stretchingLegs.values()) {
+			live.insert(connectorItem);
+		}
+		m_connectorGrid.reset(new ConnectorGrid(scene(), moving, live));
+	}
+
+	// with a big selection, positions still follow every event but the rest waits for the next frame
+	bool coalesce = m_savedItems.count() >= CoalescedMoveCount;
 	Q_FOREACH (ItemBase * itemBase, m_savedItems) {
 		QPointF currentParentPos = itemBase->mapToParent(itemBase->mapFromScene(scenePos));
 		QPointF buttonDownParentPos = itemBase->mapToParent(itemBase->mapFromScene(m_mousePressScenePos));
 		itemBase->setPos(itemBase->getViewGeometry().loc() + currentParentPos - buttonDownParentPos);
-		Q_FOREACH (ConnectorItem * connectorItem, m_stretchingLegs.values(itemBase)) {
-			connectorItem->stretchBy(currentParentPos - buttonDownParentPos);
-		}
-
-		if (m_checkUnder.contains(itemBase)) {
-			findConnectorsUnder(itemBase);
+		if (!coalesce) {
+			moveItemFollowUp(itemBase, scenePos);
 		}
 
 		/*
@@ -3164,6 +3324,34 @@ void SketchWidget::moveItemsAux(QPointF scenePos, QPoint globalPos, bool checkAu
 
 	}
 
+	if (coalesce) {
+		m_moveFollowUpScenePos = scenePos;
+		if (!m_moveFollowUpPending) {
+			m_moveFollowUpPending = true;
+			m_moveFollowUpTimer.start();
+		}
+		return;
+	}
+
+	movedWiresFollowUp();
+}
+
+void SketchWidget::moveItemFollowUp(ItemBase * itemBase, QPointF scenePos)
+{
+	QPointF currentParentPos = itemBase->mapToParent(itemBase->mapFromScene(scenePos));
+	QPointF buttonDownParentPos = itemBase->mapToParent(itemBase->mapFromScene(m_mousePressScenePos));
+	Q_FOREACH (ConnectorItem * connectorItem, m_stretchingLegs.values(itemBase)) {
+		connectorItem->stretchBy(currentParentPos - buttonDownParentPos);
+	}
+
+	if (m_checkUnder.contains(itemBase)) {
+		InteractionProfiler::Scope profile(InteractionProfiler::FindConnectorsUnder);
+		findConnectorsUnder(itemBase);
+	}
+}
+
+void SketchWidget::movedWiresFollowUp()
+{
 	Q_FOREACH (Wire * wire, m_savedWires.keys()) {
 		wire->simpleConnectedMoved(m_savedWires.value(wire));
 	}
@@ -3182,6 +3370,19 @@ void SketchWidget::moveItemsAux(QPointF scenePos, QPoint globalPos, bool checkAu
 	}
 }
 
+void SketchWidget::flushMoveFollowUp()
+{
+	// legs, connectors under, attached wires and the info view for the latest position of a coalesced drag
+	if (!m_moveFollowUpPending) return;
+
+	m_moveFollowUpPending = false;
+	m_moveFollowUpTimer.stop();
+	Q_FOREACH (ItemBase * itemBase, m_savedItems) {
+		moveItemFollowUp(itemBase, m_moveFollowUpScenePos);
+	}
+	movedWiresFollowUp();
+}
+
 
 void SketchWidget::findConnectorsUnder(ItemBase * item) {
 	Q_UNUSED(item);
@@ -3234,6 +3435,7 @@ void SketchWidget::mouseReleaseEvent(QMouseEvent *event) {
 	}
 
 	turnOffAutoscroll();
+	flushMoveFollowUp();
 
 	QGraphicsView::mouseReleaseEvent(event);
 
@@ -3297,6 +3499,8 @@ void SketchWidget::mouseReleaseEvent(QMouseEvent *event) {
 
 bool SketchWidget::checkMoved(bool wait)
 {
+	flushMoveFollowUp();
+
 	if (m_moveEventCount == 0) {
 		return false;
 	}
@@ -4066,12 +4270,14 @@ void SketchWidget::addViewLayer(ViewLayer * viewLayer) {
 void SketchWidget::setAllLayersVisible(bool visible) {
 	LayerList keys = m_viewLayers.keys();
 
+	QList<ViewLayer *> viewLayers;
 	for (int i = 0; i < keys.count(); i++) {
 		ViewLayer * viewLayer = m_viewLayers.value(keys[i]);
 		if (viewLayer && viewLayer->action()->isEnabled()) {
-			setLayerVisible(viewLayer, visible, true);
+			viewLayers.append(viewLayer);
 		}
 	}
+	setLayersVisible(viewLayers, visible, true);
 }
 
 ItemCount SketchWidget::calcItemCount() {
@@ -4202,33 +4408,52 @@ void SketchWidget::toggleLayerVisibility() {
 }
 
 void SketchWidget::setLayerVisible(ViewLayer * viewLayer, bool visible, bool doChildLayers) {
+	QList<ViewLayer *> viewLayers;
+	viewLayers.append(viewLayer);
+	setLayersVisible(viewLayers, visible, doChildLayers);
+}
 
-	LayerList viewLayerIDs;
-	viewLayerIDs.append(viewLayer->viewLayerID());
+void SketchWidget::setLayersVisible(const QList<ViewLayer *> & viewLayers, bool visible, bool doChildLayers) {
+	// shows or hides several layers with one pass over the scene and one repaint
 
-	viewLayer->setVisible(visible);
-	if (doChildLayers) {
-		Q_FOREACH (ViewLayer * childLayer, viewLayer->childLayers()) {
-			childLayer->setVisible(visible);
-			viewLayerIDs.append(childLayer->viewLayerID());
+	QSet<ViewLayer::ViewLayerID> viewLayerIDs;
+	Q_FOREACH (ViewLayer * viewLayer, viewLayers) {
+		viewLayerIDs.insert(viewLayer->viewLayerID());
+		viewLayer->setVisible(visible);
+		if (doChildLayers) {
+			Q_FOREACH (ViewLayer * childLayer, viewLayer->childLayers()) {
+				childLayer->setVisible(visible);
+				viewLayerIDs.insert(childLayer->viewLayerID());
+			}
 		}
 	}
 
+	setLayerItemsState(viewLayerIDs, true, !visible);
+}
+
+void SketchWidget::setLayerItemsState(const QSet<ViewLayer::ViewLayerID> & viewLayerIDs, bool hidden, bool state) {
+	// sets hidden (or inactive) on every item and label in the given layers;
+	// the whole scene is marked for repainting first, so the items' own updates cost nothing
+	if (viewLayerIDs.isEmpty()) return;
+
+	scene()->update();
+
 	// TODO: replace scene()->items()
 	Q_FOREACH (QGraphicsItem * item, scene()->items()) {
 		// want all items, not just topLevel
 		auto * itemBase = dynamic_cast<ItemBase *>(item);
 		if (itemBase) {
 			if (viewLayerIDs.contains(itemBase->viewLayerID())) {
-				itemBase->setHidden(!visible);
-				//DebugDialog::debug(QString("setting visible %1").arg(viewLayer->visible()));
+				if (hidden) itemBase->setHidden(state);
+				else itemBase->setInactive(state);
 			}
 			continue;
 		}
 
 		auto * partLabel = dynamic_cast<PartLabel *>(item);
 		if (partLabel && (viewLayerIDs.contains(partLabel->viewLayerID()))) {
-			partLabel->setHidden(!visible);
+			if (hidden) partLabel->setHidden(state);
+			else partLabel->setInactive(state);
 		}
 	}
 }
@@ -4242,36 +4467,16 @@ void SketchWidget::setLayerActive(ViewLayer::ViewLayerID viewLayerID, bool activ
 
 void SketchWidget::setLayerActive(ViewLayer * viewLayer, bool active) {
 
-	LayerList viewLayerIDs;
-	viewLayerIDs.append(viewLayer->viewLayerID());
+	QSet<ViewLayer::ViewLayerID> viewLayerIDs;
+	viewLayerIDs.insert(viewLayer->viewLayerID());
 
 	viewLayer->setActive(active);
 	Q_FOREACH (ViewLayer * childLayer, viewLayer->childLayers()) {
 		childLayer->setActive(active);
-		viewLayerIDs.append(childLayer->viewLayerID());
+		viewLayerIDs.insert(childLayer->viewLayerID());
 	}
 
-	// TODO: replace scene()->items()
-	Q_FOREACH (QGraphicsItem * item, scene()->items()) {
-		// want all items, not just topLevel
-		auto * itemBase = dynamic_cast<ItemBase *>(item);
-		if (itemBase) {
-			//itemBase->debugInfo("setActive");
-			if (viewLayerIDs.contains(itemBase->viewLayerID())) {
-				itemBase->setInactive(!active);
-				//DebugDialog::debug(QString("setting visible %1").arg(viewLayer->visible()));
-			}
-			continue;
-		}
-
-		auto * partLabel = dynamic_cast<PartLabel *>(item);
-		if (partLabel) {
-			if (viewLayerIDs.contains(partLabel->viewLayerID())) {
-				partLabel->setInactive(!active);
-			}
-			continue;
-		}
-	}
+	setLayerItemsState(viewLayerIDs, false, !active);
 }
 
 void SketchWidget::sendToBack() {
@@ -4626,6 +4831,7 @@ void SketchWidget::rotateX(double degrees, bool rubberBandLegEnabled, ItemBase *
 		rotateWire(wire, rotation, center, true, parentCommand);
 	}
 
+	QList<RotateItemThing> rotateItemThings;
 	Q_FOREACH (ItemBase * itemBase, m_savedItems.values()) {
 		switch (itemBase->itemType()) {
 		case ModelPart::Via:
@@ -4651,14 +4857,24 @@ void SketchWidget::rotateX(double degrees, bool rubberBandLegEnabled, ItemBase *
 			itemBase->calcRotation(rotation, center, vg2);
 			ConnectorPairHash connectorHash;
 			disconnectFromFemale(itemBase, m_savedItems, connectorHash, true, rubberBandLegEnabled, parentCommand);
-			new MoveItemCommand(this, itemBase->id(), vg1, vg1, true, parentCommand);
-			new RotateItemCommand(this, itemBase->id(), degrees, parentCommand);
-			new MoveItemCommand(this, itemBase->id(), vg2, vg2, true, parentCommand);
+			RotateItemThing rotateItemThing;
+			rotateItemThing.id = itemBase->id();
+			rotateItemThing.oldGeometry = vg1;
+			rotateItemThing.newGeometry = vg2;
+			rotateItemThings.append(rotateItemThing);
 		}
 		break;
 		}
 	}
 
+	// one command for all the parts, after all the disconnections as when each part had its own
+	if (rotateItemThings.count() > 0) {
+		auto * rotateItemsCommand = new RotateItemsCommand(this, degrees, parentCommand);
+		Q_FOREACH (RotateItemThing rotateItemThing, rotateItemThings) {
+			rotateItemsCommand->addItem(rotateItemThing.id, rotateItemThing.oldGeometry, rotateItemThing.newGeometry);
+		}
+	}
+
 	Q_FOREACH (Wire * wire, wires) {
 		rotateWire(wire, rotation, center, false, parentCommand);
 	}
@@ -4805,8 +5021,12 @@ void SketchWidget::flipX(Qt::Orientations orientation, bool rubberBandLegEnabled
 			//TODO: apply transformation to stuck items
 		}
 		// TODO: if item has female connectors, then apply transform to connected items
+	}
 
-		new FlipItemCommand(this, item->id(), orientation, parentCommand);
+	// one command for all the parts, after all the disconnections as when each part had its own
+	auto * flipItemsCommand = new FlipItemsCommand(this, orientation, parentCommand);
+	Q_FOREACH (ItemBase * item, targets) {
+		flipItemsCommand->addItem(item->id());
 	}
 
 	// change legs after connections have been updated (redo direction)
@@ -5518,11 +5738,13 @@ ViewLayer::ViewLayerID SketchWidget::multiLayerGetViewLayerID(ModelPart * modelP
 ItemBase * SketchWidget::overSticky(ItemBase * itemBase) {
 	if (!itemBase->stickyEnabled()) return nullptr;
 
-	Q_FOREACH (QGraphicsItem * item, scene()->collidingItems(itemBase)) {
+	// the scene index finds what overlaps the bounds; only sticky bases get the shape test
+	Q_FOREACH (QGraphicsItem * item, scene()->items(itemBase->sceneBoundingRect(), Qt::IntersectsItemBoundingRect)) {
 		auto * s = dynamic_cast<ItemBase *>(item);
 		if (!s) continue;
 		if (s == itemBase) continue;
 		if (!s->isBaseSticky()) continue;
+		if (!itemBase->collidesWithItem(s)) continue;
 
 		return s->layerKinChief();
 	}
@@ -5530,6 +5752,32 @@ ItemBase * SketchWidget::overSticky(ItemBase * itemBase) {
 	return nullptr;
 }
 
+bool SketchWidget::stickyPlacementKept(ItemBase * itemBase, ItemBase * stickyOne) {
+	if (!stickyOne) return false;
+
+	auto it = m_stickyPlacements.constFind(itemBase->id());
+	if (it == m_stickyPlacements.constEnd() || it->stickyID != stickyOne->id()) return false;
+
+	QRectF stickyRect = stickyOne->sceneBoundingRect();
+	if (stickyRect.size() != it->stickySize) return false;
+
+	return itemBase->sceneBoundingRect().translated(-stickyRect.topLeft()) == it->relative;
+}
+
+void SketchWidget::rememberStickyPlacement(ItemBase * itemBase) {
+	ItemBase * stickyOne = itemBase->stickingTo();
+	if (!stickyOne) {
+		m_stickyPlacements.remove(itemBase->id());
+		return;
+	}
+
+	QRectF stickyRect = stickyOne->sceneBoundingRect();
+	StickyPlacement & placement = m_stickyPlacements[itemBase->id()];
+	placement.stickyID = stickyOne->id();
+	placement.relative = itemBase->sceneBoundingRect().translated(-stickyRect.topLeft());
+	placement.stickySize = stickyRect.size();
+}
+
 
 void SketchWidget::stickemForCommand(long stickTargetID, long stickSourceID, bool stick) {
 	ItemBase * stickTarget = findItem(stickTargetID);
@@ -5554,15 +5802,21 @@ void SketchWidget::stickyScoop(ItemBase * stickyOne, bool checkCurrent, CheckSti
 	QList<ItemBase *> added;
 	QList<ItemBase *> already;
 	QPolygonF poly = stickyOne->mapToScene(stickyOne->boundingRect());
-	Q_FOREACH (QGraphicsItem * item, scene()->items(poly)) {
+	QPainterPath polyPath;
+	polyPath.addPolygon(poly);
+	// bounds from the scene index first, so connectors and non-sticky items skip the shape test
+	Q_FOREACH (QGraphicsItem * item, scene()->items(poly, Qt::IntersectsItemBoundingRect)) {
 		auto * itemBase = dynamic_cast<ItemBase *>(item);
 		if (!itemBase) continue;
 
-		itemBase = itemBase->layerKinChief();
+		ItemBase * chief = itemBase->layerKinChief();
 
-		if (!itemBase->stickyEnabled()) continue;
-		if (added.contains(itemBase)) continue;
-		if (itemBase->isBaseSticky()) continue;
+		if (!chief->stickyEnabled()) continue;
+		if (added.contains(chief)) continue;
+		if (chief->isBaseSticky()) continue;
+		if (!itemBase->collidesWithPath(itemBase->mapFromScene(polyPath))) continue;
+
+		itemBase = chief;
 		if (stickyOne->alreadySticking(itemBase)) {
 			already.append(itemBase);
 			continue;
@@ -5949,7 +6203,7 @@ void SketchWidget::setInfoViewOnHover(bool infoViewOnHover) {
 void SketchWidget::updateInfoView() {
 	if (m_blockUI) return;
 
-	QTimer::singleShot(50, this,  SLOT(updateInfoViewSlot()));
+	m_updateInfoViewTimer.start();
 }
 
 void SketchWidget::updateInfoViewSlot() {
@@ -6721,6 +6975,7 @@ void SketchWidget::changeWireFlags(long wireId, ViewGeometry::WireFlags wireFlag
 	ItemBase *item = findItem(wireId);
 	if(Wire* wire = qobject_cast<Wire*>(item)) {
 		wire->setWireFlags(wireFlags);
+		m_routingNetsValid = false;		// a trace scores differently without any connection changing
 	}
 }
 
@@ -6760,9 +7015,25 @@ void SketchWidget::updateRoutingStatus(CleanUpWiresCommand* command, RoutingStat
 {
 	//DebugDialog::debug("update ratsnest status");
 
+	if (!manual && !m_current) {
+		// a view that isn't showing keeps its connection records and is scored when it's next shown, saved or exported
+		m_routingStatusDeferred = true;
+		if (m_ratsnestUpdateConnect.count() + m_ratsnestUpdateDisconnect.count() > DeferredRatsnestChanges) {
+			m_ratsnestUpdateConnect.clear();
+			m_ratsnestUpdateDisconnect.clear();
+			m_routingNetsValid = false;
+		}
+		routingStatus = m_routingStatus;
+		return;
+	}
 
+	m_routingStatusDeferred = false;
 	routingStatus.zero();
-	updateRoutingStatus(routingStatus, manual);
+	if (!collectRoutingStatus(routingStatus, manual, command == nullptr)) {
+		// there's no command to record it on; routingJobFinished() publishes it
+		routingStatus = m_routingStatus;
+		return;
+	}
 
 	if (routingStatus != m_routingStatus) {
 		if (command) {
@@ -6776,23 +7047,103 @@ void SketchWidget::updateRoutingStatus(CleanUpWiresCommand* command, RoutingStat
 	}
 }
 
+void SketchWidget::flushDeferredRoutingStatus()
+{
+	finishRoutingStatus();
+	if (!m_routingStatusDeferred) return;
+
+	m_routingStatusDeferred = false;
+	RoutingStatus routingStatus;
+	routingStatus.zero();
+	updateRoutingStatus(routingStatus, false);
+	if (routingStatus != m_routingStatus) {
+		Q_EMIT routingStatusSignal(this, routingStatus);
+		m_routingStatus = routingStatus;
+	}
+}
+
 void SketchWidget::updateRoutingStatus(RoutingStatus & routingStatus, bool manual)
 {
+	collectRoutingStatus(routingStatus, manual, false);
+}
+
+static RoutingJob scoreRoutingJob(RoutingJob job)
+{
+	job.statuses.resize(job.netGraphs.count());
+	for (int i = 0; i < job.netGraphs.count(); i++) {
+		job.statuses[i].zero();
+		GraphUtils::scoreNetGraph(job.netGraphs.at(i), job.statuses[i]);
+	}
+	for (int i = 0; i < job.ratsnestGraphs.count(); i++) {
+		GraphUtils::spanRatsnestGraph(job.ratsnestGraphs[i]);
+	}
+	return job;
+}
+
+bool SketchWidget::collectRoutingStatus(RoutingStatus & routingStatus, bool manual, bool inBackground)
+{
+	// returns false if the nets went to a worker: routingStatus isn't filled in, and the
+	// result is published by routingJobFinished() once scored
+	finishRoutingStatus();
+
+	InteractionProfiler::Scope profile(InteractionProfiler::Ratsnest);
+
 	//DebugDialog::debug(QString("update routing status %1 %2 %3")
 	//	.arg(m_viewID)
 	//	.arg(m_ratsnestUpdateConnect.count())
 	//	.arg(m_ratsnestUpdateDisconnect.count())
 	//	);
 
-	// TODO: think about ways to optimize this...
+	// each equal-potential set keeps its share of the status, so when only connections changed, just the
+	// nets holding a connector they touched are collected and scored again; anything else starts over
+
+	// the scene is only read here; scoring the nets and spanning their ratsnests works on the
+	// copies in the job, and the scores and ratsnest lines are put back by applyRoutingJob()
 
 	QList< QPointer<VirtualWire> > ratsToDelete;
 
-	QList< QList<ConnectorItem *> > ratnestsToUpdate;
-	QList<ConnectorItem *> visited;
-	Q_FOREACH (QGraphicsItem * item, scene()->items()) {
-		auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
-		if (!connectorItem) continue;
+	RoutingJob job;
+	QList<ConnectorItem *> seeds;
+	bool everything = manual || !m_routingNetsValid || m_deadRoutingNets > m_routingNets.count() / 2;
+	if (everything) {
+		m_routingNets.clear();
+		m_routingNetIndex.clear();
+		m_deadRoutingNets = 0;
+		Q_FOREACH (QGraphicsItem * item, scene()->items()) {
+			auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
+			if (connectorItem) seeds.append(connectorItem);
+		}
+		m_routingNetsValid = true;
+	}
+	else {
+		QSet<int> staleNets;
+		QList< QPointer<ConnectorItem> > changed = m_ratsnestUpdateConnect + m_ratsnestUpdateDisconnect;
+		Q_FOREACH (ConnectorItem * connectorItem, changed) {
+			if (connectorItem == nullptr) continue;
+			if (connectorItem->scene() != scene()) continue;
+
+			seeds.append(connectorItem);
+			int net = m_routingNetIndex.value(connectorItem, -1);
+			if (net >= 0) staleNets.insert(net);
+		}
+
+		// a net that lost a connection may have split, so all of its connectors are collected again
+		Q_FOREACH (int net, staleNets) {
+			RoutingNet & routingNet = m_routingNets[net];
+			Q_FOREACH (ConnectorItem * connectorItem, routingNet.connectorItems) {
+				if (connectorItem == nullptr) continue;
+
+				m_routingNetIndex.remove(connectorItem);
+				if (connectorItem->scene() == scene()) seeds.append(connectorItem);
+			}
+			routingNet.connectorItems.clear();
+			routingNet.alive = false;
+			m_deadRoutingNets++;
+		}
+	}
+
+	QSet<ConnectorItem *> visited;
+	Q_FOREACH (ConnectorItem * connectorItem, seeds) {
 		if (visited.contains(connectorItem)) continue;
 
 		//if (this->viewID() == ViewLayer::SchematicView) {
@@ -6812,80 +7163,33 @@ void SketchWidget::updateRoutingStatus(RoutingStatus & routingStatus, bool manua
 		QList<ConnectorItem *> connectorItems;
 		connectorItems.append(connectorItem);
 		ConnectorItem::collectEqualPotential(connectorItems, true, ViewGeometry::RatsnestFlag);
-		visited.append(connectorItems);
+		Q_FOREACH (ConnectorItem * ci, connectorItems) {
+			visited.insert(ci);
+		}
 
 		//if (this->viewID() == ViewLayer::SchematicView) {
 		//	DebugDialog::debug("________________________");
 		//	foreach (ConnectorItem * ci, connectorItems) ci->debugInfo("cep");
 		//}
 
-		bool doRatsnest = manual || checkUpdateRatsnest(connectorItems);
-		if (!doRatsnest && connectorItems.count() <= 1) continue;
-
-		QList<ConnectorItem *> partConnectorItems;
-		ConnectorItem::collectParts(connectorItems, partConnectorItems, includeSymbols(), ViewLayer::NewTopAndBottom);
-		if (partConnectorItems.count() < 1) continue;
-		if (!doRatsnest && partConnectorItems.count() <= 1) continue;
-
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//    DebugDialog::debug("________________________");
-		//    foreach (ConnectorItem * pci, partConnectorItems) {
-		//		pci->debugInfo("pc 1");
-		//	}
-		//}
-
-		for (int i = partConnectorItems.count() - 1; i >= 0; i--) {
-			ConnectorItem * ci = partConnectorItems[i];
-
-			if (!ci->attachedTo()->isEverVisible()) {
-				partConnectorItems.removeAt(i);
-			}
-		}
-
-		if (partConnectorItems.count() < 1) continue;
-
-		if (doRatsnest) {
-			ratnestsToUpdate.append(partConnectorItems);
-		}
-
-		if (partConnectorItems.count() <= 1) continue;
-
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//    DebugDialog::debug("________________________");
-		//    foreach (ConnectorItem * pci, partConnectorItems) {
-		//		pci->debugInfo("pc 2");
-		//	}
-		//}
-
-		GraphUtils::scoreOneNet(partConnectorItems, this->getTraceFlag(), routingStatus);
+		scoreRoutingNet(connectorItems, manual, job);
 	}
 
-	routingStatus.m_jumperItemCount /= 4;			// since we counted each connector twice on two layers (4 connectors per jumper item)
-
-	// can't do this in the above loop since VirtualWires and ConnectorItems are added and deleted
-	Q_FOREACH (QList<ConnectorItem *> partConnectorItems, ratnestsToUpdate) {
-		//partConnectorItems.at(0)->debugInfo("display ratsnest");
-		//if (this->viewID() == ViewLayer::SchematicView) {
-		//    DebugDialog::debug("________________________");
-		//    foreach (ConnectorItem * pci, partConnectorItems) {
-		//		pci->debugInfo("pc 3");
-		//	}
-		//}
+	m_pendingRatsToDelete = ratsToDelete;
+	m_ratsnestUpdateConnect.clear();
+	m_ratsnestUpdateDisconnect.clear();
 
-		partConnectorItems.at(0)->displayRatsnest(partConnectorItems, this->getTraceFlag());
+	int connectorCount = 0;
+	Q_FOREACH (const NetGraph & netGraph, job.netGraphs) {
+		connectorCount += netGraph.nodes;
 	}
-
-	Q_FOREACH(QPointer<VirtualWire> vw, ratsToDelete) {
-		if (vw) {
-			//vw->debugInfo("removing rat 2");
-			vw->scene()->removeItem(vw);
-			delete vw;
-		}
+	if (inBackground && everything && connectorCount >= BackgroundRoutingConnectors) {
+		m_routingJobPending = true;
+		m_routingWatcher.setFuture(QtConcurrent::run(&scoreRoutingJob, job));
+		return false;
 	}
 
-
-	m_ratsnestUpdateConnect.clear();
-	m_ratsnestUpdateDisconnect.clear();
+	applyRoutingJob(scoreRoutingJob(job), routingStatus);
 
 	/*
 	// uncomment for live drc
@@ -6893,6 +7197,8 @@ void SketchWidget::updateRoutingStatus(RoutingStatus & routingStatus, bool manua
 	QString message;
 	bool result = cmRouter.drc(message);
 	*/
+
+	return true;
 }
 
 
@@ -7247,6 +7553,9 @@ void SketchWidget::movePartLabelForCommand(long itemID, QPointF newPos, QPointF
 
 void SketchWidget::setCurrent(bool current) {
 	m_current = current;
+	if (current) {
+		flushDeferredRoutingStatus();
+	}
 }
 
 void SketchWidget::partLabelMoved(ItemBase * itemBase, QPointF oldPos, QPointF oldOffset, QPointF newPos, QPointF newOffset)
@@ -7380,6 +7689,9 @@ QString translateSVG(QString & svg, QPointF loc, double dpi, double printerScale
 
 QString SketchWidget::renderToSVG(RenderThing & renderThing, QList<QGraphicsItem *> & itemsAndLabels, bool applyViewFromBelow)
 {
+	static FTimingProbe probe("renderToSVG");
+	FTimingProbe::Scope timing(probe);
+
 	renderThing.empty = true;
 
 	double width = renderThing.itemsBoundingRect.width();
@@ -7404,115 +7716,317 @@ QString SketchWidget::renderToSVG(RenderThing & renderThing, QList<QGraphicsItem
 	// put them in z order
 	std::sort(itemsAndLabels.begin(), itemsAndLabels.end(), zLessThan);
 
-	QList<ItemBase *> gotLabel;
-	Q_FOREACH (QGraphicsItem * item, itemsAndLabels) {
-		auto * itemBase = dynamic_cast<ItemBase *>(item);
-		if (!itemBase) {
-			auto * partLabel = dynamic_cast<PartLabel *>(item);
-			if (!partLabel) continue;
+	// a kept fragment is only good for the same settings and board; shared parts are
+	// placed against each other, so they never come from the cache
+	RenderCache * cache = renderThing.shareParts || renderThing.offsetRect.isEmpty() ? nullptr : renderThing.cache;
+	if (cache != nullptr) {
+		QString settings = QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+			.arg(renderThing.dpi).arg(renderThing.printerScale).arg((int) renderThing.blackOnly).arg((int) renderThing.hideTerminalPoints).arg((int) renderThing.renderBlocker)
+			.arg(renderThing.offsetRect.x()).arg(renderThing.offsetRect.y()).arg(renderThing.offsetRect.width()).arg(renderThing.offsetRect.height());
+		if (cache->settings != settings) {
+			Q_FOREACH (const RenderCache::Entry & entry, cache->entries) {
+				cache->dirty[entry.viewLayerID] |= entry.sceneRect;
+			}
+			cache->entries.clear();
+			cache->settings = settings;
+		}
+	}
+
+	// everything that touches an item is read here on the gui thread; the svg clean-up
+	// that follows only works on those copies, so it runs on the thread pool, and the
+	// fragments are then merged back in z order
+	QVector<ItemSvgJob> jobs(itemsAndLabels.count());
+	QVector<ItemSvgJob *> unfinished;
+	for (int i = 0; i < itemsAndLabels.count(); i++) {
+		QGraphicsItem * item = itemsAndLabels.at(i);
+		ItemSvgJob & job = jobs[i];
+		job.item = item;
+		if (renderThing.fragments != nullptr && renderThing.fragments->contains(item)) {
+			job.fragment = renderThing.fragments->value(item);
+			continue;
+		}
 
-			QString labelSvg = partLabel->owner()->makePartLabelSvg(renderThing.blackOnly, renderThing.dpi, renderThing.printerScale);
-			if (labelSvg.isEmpty()) continue;
+		if (cache != nullptr) {
+			job.signature = renderSignature(item);
+			auto entry = cache->entries.constFind(item);
+			if (!job.signature.isEmpty() && entry != cache->entries.constEnd() && entry->signature == job.signature) {
+				job.fragment = entry->fragment;
+				job.signature.clear();
+				cache->reused++;
+				continue;
+			}
+		}
 
-			labelSvg = translateSVG(labelSvg, partLabel->owner()->partLabelScenePos() - offset, renderThing.dpi, renderThing.printerScale);
-			labelSvg = QString("<g partID='%1' id='partLabel'>%2</g>").arg(partLabel->owner()->id()).arg(labelSvg);
+		renderItemSnapshot(renderThing, item, offset, svgHash, job);
+		if (job.unfinished) unfinished.append(&job);
+	}
 
-			renderThing.empty = false;
-			outputSVG.append(labelSvg);
-			continue;
+	if (unfinished.count() > 1) {
+		QtConcurrent::blockingMap(unfinished, [&renderThing](ItemSvgJob * job) {
+			finishItemSvg(*job, renderThing.dpi, renderThing.printerScale);
+		});
+	}
+	else {
+		Q_FOREACH (ItemSvgJob * job, unfinished) {
+			finishItemSvg(*job, renderThing.dpi, renderThing.printerScale);
 		}
+	}
 
-		if (itemBase->itemType() != ModelPart::Wire) {
-			double factor;
-			QString itemSvg = itemBase->retrieveSvg(itemBase->viewLayerID(), svgHash, renderThing.blackOnly, renderThing.dpi, factor);
-			if (itemSvg.isEmpty()) continue;
-
-			TextUtils::fixMuch(itemSvg, false);
-
-			QString legSvg;
-			QDomDocument doc;
-			QString errorStr;
-			int errorLine;
-			int errorColumn;
-			if (doc.setContent(itemSvg, &errorStr, &errorLine, &errorColumn)) {
-				bool changed = false;
-				if (renderThing.renderBlocker) {
-					Pad * pad = qobject_cast<Pad *>(itemBase);
-					if (pad && pad->copperBlocker()) {
-						QDomNodeList nodeList = doc.documentElement().elementsByTagName("rect");
-						for (int n = 0; n < nodeList.count(); n++) {
-							QDomElement element = nodeList.at(n).toElement();
-							element.setAttribute("fill-opacity", 1);
-							changed = true;
-						}
-					}
-				}
+	if (renderThing.shareParts) {
+		QString defs;
+		shareItemSvgs(jobs, renderThing.dpi, renderThing.printerScale, defs);
+		if (!defs.isEmpty()) {
+			outputSVG.replace("<svg xmlns:svg=", "<svg xmlns:xlink='http://www.w3.org/1999/xlink' xmlns:svg=");
+			outputSVG.append("<defs>" + defs + "</defs>");
+		}
+	}
 
-				Q_FOREACH (ConnectorItem * ci, itemBase->cachedConnectorItems()) {
-					SvgIdLayer * svgIdLayer = ci->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
-					if (renderThing.hideTerminalPoints && !svgIdLayer->m_terminalId.isEmpty()) {
-						// these tend to be degenerate shapes and can cause trouble at gerber export time
-						if (hideTerminalID(doc, svgIdLayer->m_terminalId)) changed = true;
-					}
+	Q_FOREACH (const ItemSvgJob & job, jobs) {
+		if (renderThing.fragments != nullptr && !renderThing.fragments->contains(job.item)) {
+			renderThing.fragments->insert(job.item, job.fragment);
+		}
+		if (cache != nullptr && !job.signature.isEmpty()) {
+			// rendered afresh: where it was and where it is now have both changed
+			cache->rendered++;
+			RenderCache::Entry & entry = cache->entries[job.item];
+			auto * itemBase = dynamic_cast<ItemBase *>(job.item);
+			int viewLayerID = itemBase == nullptr ? 0 : itemBase->viewLayerID();
+			if (!entry.signature.isEmpty()) cache->dirty[entry.viewLayerID] |= entry.sceneRect;
+			entry.signature = job.signature;
+			entry.fragment = job.fragment;
+			entry.sceneRect = job.item->sceneBoundingRect();
+			entry.viewLayerID = viewLayerID;
+			cache->dirty[viewLayerID] |= entry.sceneRect;
+		}
+		if (job.fragment.isEmpty()) continue;
+
+		outputSVG.append(job.fragment);
+		renderThing.empty = false;
+	}
 
-					if (ensureStrokeWidth(doc, svgIdLayer->m_svgId, factor)) changed = true;
+	if(applyViewFromBelow && this->viewFromBelow()) {
+		outputSVG.append("</g>");
+	}
 
-					if (!ci->hasRubberBandLeg()) continue;
+	outputSVG += "</svg>";
 
-					// at the moment, the legs don't get a partID, but since there are no legs in PCB view, we don't care
-					legSvg.append(ci->makeLegSvg(offset, renderThing.dpi, renderThing.printerScale, renderThing.blackOnly));
-				}
+	return outputSVG;
+}
 
-				if (changed) {
-					itemSvg = doc.toString(0);
-				}
+RenderCache * SketchWidget::renderCache(const QString & name)
+{
+	// fragments kept between exports under the given name, for renders against a board
+	return &m_renderCaches[name];
+}
+
+QHash<int, QRectF> SketchWidget::takeRenderCacheDirt(const QString & name, int & reused, int & rendered)
+{
+	// the areas changed on each layer since the last take, by ViewLayer::ViewLayerID; items that
+	// have left the scene are dropped first, which also counts as a change where they were
+	RenderCache & cache = m_renderCaches[name];
+	if (!cache.entries.isEmpty()) {
+		QSet<QGraphicsItem *> live;
+		Q_FOREACH (QGraphicsItem * item, scene()->items()) {
+			live.insert(item);
+		}
+		for (auto it = cache.entries.begin(); it != cache.entries.end(); ) {
+			if (live.contains(it.key())) {
+				++it;
+				continue;
 			}
 
-			QTransform t = itemBase->transform();
-			itemSvg = TextUtils::svgTransform(itemSvg, t, false, QString());
-			itemSvg = translateSVG(itemSvg, itemBase->scenePos() - offset, renderThing.dpi, renderThing.printerScale);
-			itemSvg =  QString("<g partID='%1'>%2</g>").arg(itemBase->id()).arg(itemSvg);
-			outputSVG.append(itemSvg);
-			outputSVG.append(legSvg);
-			renderThing.empty = false;
+			cache.dirty[it->viewLayerID] |= it->sceneRect;
+			it = cache.entries.erase(it);
+		}
+	}
+
+	reused = cache.reused;
+	rendered = cache.rendered;
+	cache.reused = cache.rendered = 0;
+	QHash<int, QRectF> dirty = cache.dirty;
+	cache.dirty.clear();
+	return dirty;
+}
+
+QByteArray SketchWidget::renderSignature(QGraphicsItem * item)
+{
+	// what an item's fragment is made from: where it sits, its drawing, and for wires their shape;
+	// empty for items this can't speak for, which are always rendered again
+	auto * itemBase = dynamic_cast<ItemBase *>(item);
+	if (itemBase == nullptr) return QByteArray();           // part label text follows the owner's properties
 
-			/*
-			// TODO:  deal with rotations and flips
-			QString shifted = splitter->shift(loc.x(), loc.y(), xmlName);
-			outputSVG.append(shifted);
-			empty = false;
-			splitter->shift(-loc.x(), -loc.y(), xmlName);
-			*/
+	QByteArray signature;
+	QDataStream stream(&signature, QIODevice::WriteOnly);
+	stream << (qint64) itemBase->id() << (int) itemBase->viewLayerID() << (int) itemBase->viewLayerPlacement()
+	       << itemBase->sceneBoundingRect() << itemBase->sceneTransform() << itemBase->zValue();
+
+	if (itemBase->itemType() == ModelPart::Wire) {
+		Wire * wire = qobject_cast<Wire *>(itemBase);
+		if (wire == nullptr) return QByteArray();
+
+		stream << wire->getPaintLine() << wire->width() << wire->hexString() << wire->hasShadow() << wire->banded() << wire->isCurved();
+		if (wire->hasShadow()) stream << wire->shadowWidth() << wire->shadowHexString();
+		if (wire->isCurved()) {
+			const Bezier * curve = wire->curve();
+			stream << curve->endpoint0() << curve->endpoint1() << curve->cp0() << curve->cp1();
 		}
-		else {
-			Wire * wire = qobject_cast<Wire *>(itemBase);
-			if (!wire) continue;
+		return signature;
+	}
 
-			//if (wire->getTrace()) {
-			//	DebugDialog::debug(QString("trace %1 %2,%3 %4,%5")
-			//		.arg(wire->id())
-			//		.arg(wire->line().p1().x())
-			//		.arg(wire->line().p1().y())
-			//		.arg(wire->line().p2().x())
-			//		.arg(wire->line().p2().y())
-			//		);
-			//}
+	// a drawing changes with every load, so the serial covers property changes that regenerate the svg
+	FSvgRenderer * renderer = itemBase->fsvgRenderer();
+	if (renderer == nullptr) return QByteArray();
+
+	Q_FOREACH (ConnectorItem * ci, itemBase->cachedConnectorItems()) {
+		if (ci->hasRubberBandLeg()) return QByteArray();
+	}
+
+	stream << renderer->drawingSerial();
+	return signature;
+}
+
+void SketchWidget::renderItemSnapshot(RenderThing & renderThing, QGraphicsItem * item, QPointF offset, QHash<QString, QString> & svgHash, ItemSvgJob & job)
+{
+	// what one item or part label adds to a render, read off the item; a part's svg is left
+	// unfinished for finishItemSvg, labels and wires are finished here; empty when it adds nothing
+	auto * itemBase = dynamic_cast<ItemBase *>(item);
+	if (!itemBase) {
+		auto * partLabel = dynamic_cast<PartLabel *>(item);
+		if (!partLabel) return;
 
-			QString wireSvg = makeWireSVG(wire, offset, renderThing.dpi, renderThing.printerScale, renderThing.blackOnly);
-			wireSvg = QString("<g partID='%1'>%2</g>").arg(wire->id()).arg(wireSvg);
-			outputSVG.append(wireSvg);
-			renderThing.empty = false;
+		QString labelSvg = partLabel->owner()->makePartLabelSvg(renderThing.blackOnly, renderThing.dpi, renderThing.printerScale);
+		if (labelSvg.isEmpty()) return;
+
+		labelSvg = translateSVG(labelSvg, partLabel->owner()->partLabelScenePos() - offset, renderThing.dpi, renderThing.printerScale);
+		job.fragment = QString("<g partID='%1' id='partLabel'>%2</g>").arg(partLabel->owner()->id()).arg(labelSvg);
+		return;
+	}
+
+	if (itemBase->itemType() != ModelPart::Wire) {
+		job.fragment = itemBase->retrieveSvg(itemBase->viewLayerID(), svgHash, renderThing.blackOnly, renderThing.dpi, job.factor);
+		if (job.fragment.isEmpty()) return;
+
+		job.unfinished = true;
+		job.shared = renderThing.shareParts && renderThing.fragments == nullptr;
+		job.id = itemBase->id();
+		job.transform = itemBase->transform();
+		job.loc = itemBase->scenePos() - offset;
+		if (renderThing.renderBlocker) {
+			Pad * pad = qobject_cast<Pad *>(itemBase);
+			job.blocker = pad && pad->copperBlocker();
+		}
+
+		Q_FOREACH (ConnectorItem * ci, itemBase->cachedConnectorItems()) {
+			SvgIdLayer * svgIdLayer = ci->connector()->fullPinInfo(itemBase->viewID(), itemBase->viewLayerID());
+			if (renderThing.hideTerminalPoints && !svgIdLayer->m_terminalId.isEmpty()) {
+				// these tend to be degenerate shapes and can cause trouble at gerber export time
+				job.terminalIDs.append(svgIdLayer->m_terminalId);
+			}
+
+			job.connectorIDs.append(svgIdLayer->m_svgId);
+
+			if (!ci->hasRubberBandLeg()) continue;
+
+			// at the moment, the legs don't get a partID, but since there are no legs in PCB view, we don't care
+			job.legSvg.append(ci->makeLegSvg(offset, renderThing.dpi, renderThing.printerScale, renderThing.blackOnly));
 		}
-		extraRenderSvgStep(itemBase, offset, renderThing.dpi, renderThing.printerScale, outputSVG);
 	}
+	else {
+		Wire * wire = qobject_cast<Wire *>(itemBase);
+		if (!wire) return;
 
-	if(applyViewFromBelow && this->viewFromBelow()) {
-		outputSVG.append("</g>");
+		QString wireSvg = makeWireSVG(wire, offset, renderThing.dpi, renderThing.printerScale, renderThing.blackOnly);
+		job.fragment = QString("<g partID='%1'>%2</g>").arg(wire->id()).arg(wireSvg);
 	}
 
-	outputSVG += "</svg>";
+	extraRenderSvgStep(itemBase, offset, renderThing.dpi, renderThing.printerScale, job.extraSvg);
+	if (!job.unfinished) job.fragment.append(job.extraSvg);
+}
 
-	return outputSVG;
+void SketchWidget::finishItemSvg(ItemSvgJob & job, double dpi, double printerScale)
+{
+	// only works on the job, so jobs can be finished on any thread
+	QString itemSvg = job.fragment;
+	TextUtils::fixMuch(itemSvg, false);
+
+	QDomDocument doc;
+	QString errorStr;
+	int errorLine;
+	int errorColumn;
+	if (doc.setContent(itemSvg, &errorStr, &errorLine, &errorColumn)) {
+		bool changed = false;
+		if (job.blocker) {
+			QDomNodeList nodeList = doc.documentElement().elementsByTagName("rect");
+			for (int n = 0; n < nodeList.count(); n++) {
+				QDomElement element = nodeList.at(n).toElement();
+				element.setAttribute("fill-opacity", 1);
+				changed = true;
+			}
+		}
+
+		Q_FOREACH (QString terminalID, job.terminalIDs) {
+			if (hideTerminalID(doc, terminalID)) changed = true;
+		}
+
+		Q_FOREACH (QString connectorID, job.connectorIDs) {
+			if (ensureStrokeWidth(doc, connectorID, job.factor)) changed = true;
+		}
+
+		if (changed) {
+			itemSvg = doc.toString(0);
+		}
+	}
+	else {
+		// legs are only drawn for a part whose svg parses
+		job.legSvg.clear();
+	}
+
+	job.unfinished = false;
+	if (job.shared) {
+		job.body = itemSvg;
+		return;
+	}
+
+	job.fragment = placeItemSvg(job, itemSvg, dpi, printerScale);
+}
+
+QString SketchWidget::placeItemSvg(const ItemSvgJob & job, const QString & itemSvg, double dpi, double printerScale)
+{
+	QTransform transform = job.transform;
+	QString svg = TextUtils::svgTransform(itemSvg, transform, false, QString());
+	svg = translateSVG(svg, job.loc, dpi, printerScale);
+	QString fragment = QString("<g partID='%1'>%2</g>").arg(job.id).arg(svg);
+	fragment.append(job.legSvg);
+	fragment.append(job.extraSvg);
+	return fragment;
+}
+
+void SketchWidget::shareItemSvgs(QVector<ItemSvgJob> & jobs, double dpi, double printerScale, QString & defs)
+{
+	// an svg drawn by more than one part goes into defs once, and each of those parts places it with a use;
+	// on the gui thread, after the jobs are finished, so the ids follow z order
+	QHash<QString, int> counts;
+	for (const ItemSvgJob & job : jobs) {
+		if (job.shared) counts[job.body]++;
+	}
+
+	QHash<QString, QString> defIDs;
+	for (ItemSvgJob & job : jobs) {
+		if (!job.shared) continue;
+
+		if (counts.value(job.body) < 2) {
+			job.fragment = placeItemSvg(job, job.body, dpi, printerScale);
+			continue;
+		}
+
+		QString id = defIDs.value(job.body);
+		if (id.isEmpty()) {
+			id = QString("fzshared%1").arg(defIDs.count());
+			defIDs.insert(job.body, id);
+			defs += QString("<g id='%1'>%2</g>").arg(id, job.body);
+		}
+		job.fragment = placeItemSvg(job, QString("<use xlink:href='#%1' />").arg(id), dpi, printerScale);
+	}
 }
 
 void SketchWidget::extraRenderSvgStep(ItemBase * itemBase, QPointF offset, double dpi, double printerScale, QString & outputSvg)
@@ -7770,6 +8284,26 @@ void SketchWidget::setProp(long itemID, const QString & prop, const QString & va
 	}
 }
 
+bool SketchWidget::swapInPlace(long itemID, const QString & moduleID) {
+	// the model part is shared by all three views, so this swaps every view at once
+	ItemBase * itemBase = findItem(itemID);
+	if (itemBase == nullptr) return false;
+
+	ModelPart * modelPart = itemBase->modelPart();
+	ModelPart * newModelPart = referenceModel()->retrieveModelPart(moduleID);
+	if (!PaletteItem::canSwapInPlace(modelPart, newModelPart)) return false;
+
+	ModelPartShared * modelPartShared = modelPart->modelPartShared();
+	if (!PaletteItem::swapInPlace(modelPart, newModelPart->modelPartShared())) {
+		// some connector moved, so the wires would no longer line up
+		PaletteItem::swapInPlace(modelPart, modelPartShared);
+		return false;
+	}
+
+	updateInfoView();
+	return true;
+}
+
 // called from ResizeBoardCommand
 ItemBase * SketchWidget::resizeBoard(long itemID, double mmW, double mmH) {
 	ItemBase * itemBase = findItem(itemID);
@@ -8427,7 +8961,7 @@ void SketchWidget::paintEvent ( QPaintEvent * event ) {
 	if (scene()) {
 		((FGraphicsScene *) scene())->setDisplayHandles(true);
 	}
-	QGraphicsView::paintEvent(event);
+	InfoGraphicsView::paintEvent(event);
 }
 
 void SketchWidget::setNoteFocus(QGraphicsItem * item, bool inFocus) {
@@ -8563,6 +9097,64 @@ void SketchWidget::changeBoardLayers(int layers, bool doEmit) {
 	}
 }
 
+void SketchWidget::collectErcNets(QList<ErcNet> & nets)
+{
+	// the routing nets are the sketch's connectivity, kept up to date from one edit to the next,
+	// so they are brought up to date and swept rather than collecting every net again
+	finishRoutingStatus();
+	if (!m_routingNetsValid || !m_ratsnestUpdateConnect.isEmpty() || !m_ratsnestUpdateDisconnect.isEmpty()) {
+		m_routingStatusDeferred = true;
+	}
+	flushDeferredRoutingStatus();
+
+	Q_FOREACH (const RoutingNet & routingNet, m_routingNets) {
+		if (!routingNet.alive) continue;
+
+		// both layers of a pcb connector carry the same data
+		QSet<QString> seen;
+		QList<ConnectorItem *> ercConnectorItems;
+		int partConnectorCount = 0;
+		Q_FOREACH (ConnectorItem * connectorItem, routingNet.connectorItems) {
+			if (connectorItem == nullptr) continue;
+			if (connectorItem->attachedToItemType() == ModelPart::Wire) continue;
+
+			QString key = QString("%1 %2").arg(connectorItem->attachedTo()->layerKinChief()->id()).arg(connectorItem->connectorSharedID());
+			if (seen.contains(key)) continue;
+
+			seen.insert(key);
+			partConnectorCount++;
+			if (connectorItem->connectorSharedErcData() != nullptr) ercConnectorItems.append(connectorItem);
+		}
+
+		ErcNet net;
+		Q_FOREACH (ConnectorItem * connectorItem, ercConnectorItems) {
+			ErcData * ercData = connectorItem->connectorSharedErcData();
+			if (ercData->ignore() == ErcData::Always) continue;
+			if ((ercData->ignore() == ErcData::IfUnconnected) && (partConnectorCount == 1)) continue;
+
+			ItemBase * itemBase = connectorItem->attachedTo()->layerKinChief();
+			ErcPin pin;
+			pin.part = itemBase->instanceTitle();
+			pin.connector = connectorItem->connectorSharedName();
+			pin.eType = ercData->eType();
+			pin.currentFlow = ercData->currentFlow();
+			pin.voltage = ercData->voltage();
+			pin.voltageMin = ercData->voltageMin();
+			pin.voltageMax = ercData->voltageMax();
+			pin.current = ercData->current();
+			pin.currentMax = ercData->currentMax();
+
+			auto * symbol = qobject_cast<SymbolPaletteItem *>(itemBase);
+			if (symbol != nullptr && pin.eType == ErcData::VCC) {
+				pin.voltage.setValue(symbol->voltage());
+			}
+			net.pins.append(pin);
+		}
+
+		if (!net.pins.isEmpty()) nets.append(net);
+	}
+}
+
 void SketchWidget::collectAllNets(
 		QHash<ConnectorItem *, int> & indexer,
 		QList< QList<class ConnectorItem *>* > & allPartConnectorItems,
@@ -8581,12 +9173,15 @@ void SketchWidget::collectAllNets(
 		allConnectors.append(connectorItem);
 	}
 
-	// find all the nets and make a list of nodes (i.e. part ConnectorItems) for each net
-	while (allConnectors.count() > 0) {
+	// find all the nets and make a list of nodes (i.e. part ConnectorItems) for each net;
+	// a set of the connectors already in a net replaces removing each one from the list
+	QSet<ConnectorItem *> inNet;
+	Q_FOREACH (ConnectorItem * connectorItem, allConnectors) {
+		if (inNet.contains(connectorItem)) continue;
 
-		ConnectorItem * connectorItem = allConnectors.takeFirst();
 		QList<ConnectorItem *> connectorItems;
 		connectorItems.append(connectorItem);
+		inNet.insert(connectorItem);
 		ConnectorItem::collectEqualPotential(connectorItems, bothSides, skipFlags, skipBuses);
 		if (connectorItems.count() <= 0) {
 			continue;
@@ -8597,7 +9192,7 @@ void SketchWidget::collectAllNets(
 			//DebugDialog::debug("collect equal potential bug");
 			//}
 			//DebugDialog::debug(QString("from in equal potential %1 %2").arg(ci->connectorSharedName()).arg(ci->attachedToInstanceTitle()));
-			allConnectors.removeOne(ci);
+			inNet.insert(ci);
 		}
 
 		if (!includeSingletons && (connectorItems.count() <= 1)) {
@@ -9212,6 +9807,157 @@ void SketchWidget::renamePinsForCommand(long id, const QStringList & labels)
 	paletteItem->renamePins(labels);
 }
 
+void SketchWidget::scoreRoutingNet(QList<ConnectorItem *> & connectorItems, bool manual, RoutingJob & job)
+{
+	// records one equal-potential set, and adds its graphs to the job: one to score, and one for its ratsnest if it changed;
+	// a net this set has swallowed since the last update no longer counts
+	Q_FOREACH (ConnectorItem * connectorItem, connectorItems) {
+		int previous = m_routingNetIndex.value(connectorItem, -1);
+		if (previous < 0 || !m_routingNets.at(previous).alive) continue;
+
+		m_routingNets[previous].alive = false;
+		m_routingNets[previous].connectorItems.clear();
+		m_deadRoutingNets++;
+	}
+
+	int net = m_routingNets.count();
+	m_routingNets.append(RoutingNet());
+	RoutingNet & routingNet = m_routingNets.last();
+	routingNet.status.zero();
+	Q_FOREACH (ConnectorItem * connectorItem, connectorItems) {
+		routingNet.connectorItems.append(connectorItem);
+		m_routingNetIndex.insert(connectorItem, net);
+	}
+
+	bool doRatsnest = manual || checkUpdateRatsnest(connectorItems);
+	if (!doRatsnest && connectorItems.count() <= 1) return;
+
+	QList<ConnectorItem *> partConnectorItems;
+	ConnectorItem::collectParts(connectorItems, partConnectorItems, includeSymbols(), ViewLayer::NewTopAndBottom);
+	if (partConnectorItems.count() < 1) return;
+	if (!doRatsnest && partConnectorItems.count() <= 1) return;
+
+	//if (this->viewID() == ViewLayer::SchematicView) {
+	//    DebugDialog::debug("________________________");
+	//    foreach (ConnectorItem * pci, partConnectorItems) {
+	//		pci->debugInfo("pc 1");
+	//	}
+	//}
+
+	for (int i = partConnectorItems.count() - 1; i >= 0; i--) {
+		ConnectorItem * ci = partConnectorItems[i];
+
+		if (!ci->attachedTo()->isEverVisible()) {
+			partConnectorItems.removeAt(i);
+		}
+	}
+
+	if (partConnectorItems.count() < 1) return;
+
+	if (doRatsnest) {
+		PendingRatsnest pendingRatsnest;
+		RatsnestGraph ratsnestGraph;
+		QList<ConnectorItem *> nodes;
+		if (GraphUtils::collectRatsnestGraph(&partConnectorItems, ConnectorItem::ratsnestSkipFlags(this->getTraceFlag()), ratsnestGraph, nodes)) {
+			pendingRatsnest.graph = job.ratsnestGraphs.count();
+			job.ratsnestGraphs.append(ratsnestGraph);
+		}
+		Q_FOREACH (ConnectorItem * ci, partConnectorItems) pendingRatsnest.connectorItems.append(ci);
+		Q_FOREACH (ConnectorItem * ci, nodes) pendingRatsnest.nodes.append(ci);
+		m_pendingRatsnests.append(pendingRatsnest);
+	}
+
+	if (partConnectorItems.count() <= 1) return;
+
+	//if (this->viewID() == ViewLayer::SchematicView) {
+	//    DebugDialog::debug("________________________");
+	//    foreach (ConnectorItem * pci, partConnectorItems) {
+	//		pci->debugInfo("pc 2");
+	//	}
+	//}
+
+	NetGraph netGraph;
+	GraphUtils::collectNetGraph(partConnectorItems, this->getTraceFlag(), netGraph);
+	job.nets.append(net);
+	job.netGraphs.append(netGraph);
+}
+
+void SketchWidget::applyRoutingJob(const RoutingJob & job, RoutingStatus & routingStatus)
+{
+	for (int i = 0; i < job.nets.count(); i++) {
+		m_routingNets[job.nets.at(i)].status = job.statuses.at(i);
+	}
+
+	Q_FOREACH (const RoutingNet & routingNet, m_routingNets) {
+		if (routingNet.alive) routingStatus.add(routingNet.status);
+	}
+
+	routingStatus.m_jumperItemCount /= 4;			// since we counted each connector twice on two layers (4 connectors per jumper item)
+
+	// can't do this while collecting since VirtualWires and ConnectorItems are added and deleted
+	QList<PendingRatsnest> pendingRatsnests = m_pendingRatsnests;
+	m_pendingRatsnests.clear();
+	Q_FOREACH (const PendingRatsnest & pendingRatsnest, pendingRatsnests) {
+		QList<ConnectorItem *> partConnectorItems;
+		Q_FOREACH (ConnectorItem * ci, pendingRatsnest.connectorItems) {
+			if (ci) partConnectorItems.append(ci);
+		}
+		if (partConnectorItems.isEmpty()) continue;
+
+		QList<ConnectorItem *> nodes;
+		Q_FOREACH (ConnectorItem * ci, pendingRatsnest.nodes) {
+			if (ci) nodes.append(ci);
+		}
+		if (partConnectorItems.count() < pendingRatsnest.connectorItems.count() || nodes.count() < pendingRatsnest.nodes.count()) {
+			// something went away since the graph was built
+			partConnectorItems.at(0)->displayRatsnest(partConnectorItems, this->getTraceFlag());
+			continue;
+		}
+
+		ConnectorPairHash chosen;
+		if (pendingRatsnest.graph >= 0) {
+			typedef QPair<int, int> Edge;
+			Q_FOREACH (Edge edge, job.ratsnestGraphs.at(pendingRatsnest.graph).edges) {
+				chosen.insert(nodes.at(edge.first), nodes.at(edge.second));
+			}
+		}
+		partConnectorItems.at(0)->displayRatsnest(partConnectorItems, chosen);
+	}
+
+	QList< QPointer<VirtualWire> > ratsToDelete = m_pendingRatsToDelete;
+	m_pendingRatsToDelete.clear();
+	Q_FOREACH(QPointer<VirtualWire> vw, ratsToDelete) {
+		if (vw) {
+			//vw->debugInfo("removing rat 2");
+			vw->scene()->removeItem(vw);
+			delete vw;
+		}
+	}
+}
+
+void SketchWidget::routingJobFinished()
+{
+	if (!m_routingJobPending || !m_routingWatcher.isFinished()) return;
+
+	m_routingJobPending = false;
+	RoutingStatus routingStatus;
+	routingStatus.zero();
+	applyRoutingJob(m_routingWatcher.result(), routingStatus);
+	if (routingStatus != m_routingStatus) {
+		Q_EMIT routingStatusSignal(this, routingStatus);
+		m_routingStatus = routingStatus;
+	}
+}
+
+void SketchWidget::finishRoutingStatus()
+{
+	// anything that reads or changes the nets first waits for a rescore still on a worker
+	if (!m_routingJobPending) return;
+
+	m_routingWatcher.waitForFinished();
+	routingJobFinished();
+}
+
 bool SketchWidget::checkUpdateRatsnest(QList<ConnectorItem *> & connectorItems) {
 	Q_FOREACH (ConnectorItem * ci, m_ratsnestUpdateConnect) {
 		if (!ci) continue;
@@ -9466,7 +10212,14 @@ long SketchWidget::swapStart(SwapThing & swapThing, bool master) {
 }
 
 void SketchWidget::setPasting(bool pasting) {
+	// selection changes are reported once, after the whole paste
+	if (pasting == m_pasting) return;
+
 	m_pasting = pasting;
+	setIgnoreSelectionChangeEvents(pasting);
+	if (!pasting) {
+		selectionChangedSlot();
+	}
 }
 
 void SketchWidget::showUnrouted() {
@@ -9481,7 +10234,7 @@ void SketchWidget::showUnrouted() {
 	QSet<ConnectorItem *> toShow;
 	Q_FOREACH (QList<ConnectorItem *> * connectorItems, allPartConnectorItems) {
 		ConnectorPairHash result;
-		GraphUtils::chooseRatsnestGraph(connectorItems, (ViewGeometry::RatsnestFlag | ViewGeometry::NormalFlag | ViewGeometry::PCBTraceFlag | ViewGeometry::SchematicTraceFlag) ^ getTraceFlag(), result);
+		GraphUtils::chooseRatsnestGraph(connectorItems, ConnectorItem::ratsnestSkipFlags(getTraceFlag()), result);
 		Q_FOREACH (ConnectorItem * ck, result.uniqueKeys()) {
 			toShow.insert(ck);
 			Q_FOREACH (ConnectorItem * cv, result.values(ck)) {
@@ -9907,6 +10660,7 @@ void SketchWidget::alignItems(Qt::Alignment alignment) {
 		}
 
 		if (m_checkUnder.contains(itemBase)) {
+			InteractionProfiler::Scope profile(InteractionProfiler::FindConnectorsUnder);
 			findConnectorsUnder(itemBase);
 		}
 	}
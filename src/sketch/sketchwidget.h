@@ -31,6 +31,10 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QHash>
 #include <QMap>
 #include <QTimer>
+#include <QVector>
+#include <QScopedPointer>
+#include <QFutureWatcher>
+#include <QDomDocument>
 
 #include "../items/paletteitem.h"
 #include "../referencemodel/referencemodel.h"
@@ -75,6 +79,14 @@ struct SwapThing {
 	QMap<QString, QString> propsMap;
 };
 
+struct RoutingJob {
+	// the part of a routing status update that doesn't touch the scene, so it can run on a worker
+	QVector<int> nets;							// into SketchWidget::m_routingNets, one per net graph
+	QVector<NetGraph> netGraphs;
+	QVector<RoutingStatus> statuses;			// filled in by scoring, one per net graph
+	QVector<RatsnestGraph> ratsnestGraphs;		// spanned by scoring
+};
+
 class SizeItem : public QObject, public QGraphicsLineItem
 {
 	Q_OBJECT
@@ -107,8 +119,10 @@ public:
 	void updateWireForCommand(long id, const QString & connectorID, bool updateRatsnest);
 
 	void rotateItemForCommand(long id, double degrees);
+	void rotateItemsForCommand(const QList<struct RotateItemThing> &, double degrees, bool toNew);
 	void transformItemForCommand(long id, const QTransform &);
 	void flipItemForCommand(long id, Qt::Orientations orientation);
+	void flipItemsForCommand(const QList<long> & ids, Qt::Orientations orientation);
 	void selectItemForCommand(long id, bool state, bool updateInfoView, bool doEmit);
 	void selectItem(ItemBase * itemBase);
 	void selectItems(QList<ItemBase *>);
@@ -146,6 +160,7 @@ public:
 	void addViewLayer(ViewLayer *);
 	void setAllLayersVisible(bool visible);
 	void setLayerVisible(ViewLayer * viewLayer, bool visible, bool doChildLayers);
+	void setLayersVisible(const QList<ViewLayer *> &, bool visible, bool doChildLayers);
 	void setLayerVisible(ViewLayer::ViewLayerID viewLayerID, bool visible, bool doChildLayers);
 	void setLayerActive(ViewLayer * viewLayer, bool active);
 	void setLayerActive(ViewLayer::ViewLayerID viewLayerID, bool active);
@@ -199,6 +214,7 @@ public:
 	void restoreLayerVisibility();
 	void updateRoutingStatus(CleanUpWiresCommand*, RoutingStatus &, bool manual);
 	void updateRoutingStatus(RoutingStatus &, bool manual);
+	void flushDeferredRoutingStatus();
 	virtual bool hasAnyNets();
 	void ensureLayerVisible(ViewLayer::ViewLayerID);
 
@@ -224,6 +240,8 @@ public:
 	void resizeNoteForCommand(long itemID, const QSizeF & );
 	class SelectItemCommand* stackSelectionState(bool pushIt, QUndoCommand * parentCommand);
 	QString renderToSVG(RenderThing &, QGraphicsItem * board, const LayerList &, bool applyViewFromBelow = false);
+	RenderCache * renderCache(const QString & name);
+	QHash<int, QRectF> takeRenderCacheDirt(const QString & name, int & reused, int & rendered);
 	bool spaceBarIsPressed() noexcept;
 	virtual long setUpSwap(SwapThing &, bool master);
 	ConnectorItem * lastHoverEnterConnectorItem();
@@ -271,6 +289,7 @@ public:
 			bool bothSides,
 			ViewGeometry::WireFlags skipFlag = ViewGeometry::NoFlag,
 			bool skipBuses = false);
+	void collectErcNets(QList<struct ErcNet> &);
 	virtual bool routeBothSides();
 	virtual void changeLayerForCommand(long id, double z, ViewLayer::ViewLayerID viewLayerID);
 	void ratsnestConnect(ConnectorItem * connectorItem, bool connect);
@@ -312,6 +331,8 @@ public:
 	void setGroundFillSeedForCommand(long id, const QString & connectorID, bool seed);
 	void setWireExtrasForCommand(long id, QDomElement &);
 	void resolveTemporary(bool, ItemBase *);
+	void indexItem(ItemBase *, bool inScene);
+	class ConnectorGrid * connectorGrid();
 	virtual bool sameElectricalLayer2(ViewLayer::ViewLayerID, ViewLayer::ViewLayerID);
 	void deleteMiddle(QSet<ItemBase *> & deletedItems, QUndoCommand * parentCommand);
 	void setPasting(bool);
@@ -341,6 +362,7 @@ public:
 	void putItemByModuleID(const QString & moduleID);
 
 protected:
+	void setLayerItemsState(const QSet<ViewLayer::ViewLayerID> & viewLayerIDs, bool hidden, bool state);
 	void dragEnterEvent(QDragEnterEvent *);
 	bool dragEnterEventAux(QDragEnterEvent *);
 	bool setDroppingItemAndOffset(const QPoint & pos, const QPointF & offset, ModelPart * modelPart);
@@ -399,6 +421,8 @@ protected:
 	void killDroppingItem();
 	ViewLayer::ViewLayerID getViewLayerID(ModelPart *, ViewLayer::ViewID, ViewLayer::ViewLayerPlacement);
 	ItemBase * overSticky(ItemBase *);
+	bool stickyPlacementKept(ItemBase *, ItemBase * stickyOne);
+	void rememberStickyPlacement(ItemBase *);
 	virtual void setNewPartVisible(ItemBase *);
 	virtual bool collectFemaleConnectees(ItemBase *, QSet<ItemBase *> &);
 	virtual bool checkUnder();
@@ -414,6 +438,8 @@ protected:
 	void moveItems(QPoint globalPos, bool checkAutoScroll, bool rubberBandLegEnabled);
 	void moveItemsScene(QPointF scenePos, bool checkAutoScrollFlag, bool rubberBandLegEnabled);
 	void moveItemsAux(QPointF scenePos, QPoint globalPos, bool checkAutoScrollFlag, bool rubberBandLegEnabled);
+	void moveItemFollowUp(ItemBase *, QPointF scenePos);
+	void movedWiresFollowUp();
 	virtual ViewLayer::ViewLayerID multiLayerGetViewLayerID(ModelPart * modelPart, ViewLayer::ViewID, ViewLayer::ViewLayerPlacement, LayerList &);
 	virtual BaseCommand::CrossViewType wireSplitCrossView();
 	virtual bool canChainMultiple();
@@ -428,13 +454,13 @@ protected:
 	virtual void setWireVisible(Wire *);
 	bool matchesLayer(ModelPart * modelPart);
 
-	QByteArray removeOutsideConnections(const QByteArray & itemData, QList<long> & modelIndexes);
+	bool removeOutsideConnections(QDomDocument &, const QSet<long> & modelIndexes);
 	void addWireExtras(long newID, QDomElement & view, QUndoCommand * parentCommand);
 	virtual const QString & hoverEnterWireConnectorMessage(QGraphicsSceneHoverEvent * event, ConnectorItem * item);
 	virtual const QString & hoverEnterPartConnectorMessage(QGraphicsSceneHoverEvent * event, ConnectorItem * item);
 	void partLabelChangedAux(ItemBase * pitem,const QString & oldText, const QString &newText);
 	void drawBackground( QPainter * painter, const QRectF & rect );
-	void handleConnect(QDomElement & connect, ModelPart *, const QString & fromConnectorID, ViewLayer::ViewLayerID, QStringList & alreadyConnected,
+	void handleConnect(QDomElement & connect, ModelPart *, const QString & fromConnectorID, ViewLayer::ViewLayerID, QSet<QString> & alreadyConnected,
 	                   QHash<long, ItemBase *> & newItems, QUndoCommand * parentCommand, bool seekOutsideConnections);
 	void setUpSwapReconnect(SwapThing &, ItemBase * itemBase, long newID, bool master);
 	void setUpSwapRenamePins(SwapThing & swapThing, ItemBase * itemBase);
@@ -500,6 +526,10 @@ protected:
 	void moveLegBendpointsAux(ConnectorItem * connectorItem, bool undoOnly, QUndoCommand * parentCommand);
 	virtual void rotatePartLabels(double degrees, QTransform &, QPointF center, QUndoCommand * parentCommand);
 	bool checkUpdateRatsnest(QList<ConnectorItem *> & connectorItems);
+	bool collectRoutingStatus(RoutingStatus &, bool manual, bool inBackground);
+	void scoreRoutingNet(QList<ConnectorItem *> & connectorItems, bool manual, RoutingJob & job);
+	void applyRoutingJob(const RoutingJob & job, RoutingStatus &);
+	void finishRoutingStatus();
 	void makeRatsnestViewGeometry(ViewGeometry & viewGeometry, ConnectorItem * source, ConnectorItem * dest);
 	virtual double getTraceWidth();
 	virtual const QString & traceColor(ViewLayer::ViewLayerPlacement);
@@ -515,6 +545,11 @@ protected:
 	void rotateWire(Wire *, QTransform & rotation, QPointF center, bool undoOnly, QUndoCommand * parentCommand);
 	QList<QGraphicsItem *> getVisibleItemsAndLabels(RenderThing & renderThing, const LayerList & layers);
 	QString renderToSVG(RenderThing &, QList<QGraphicsItem *> & itemsAndLabels, bool applyViewFromBelow = false);
+	void renderItemSnapshot(RenderThing &, QGraphicsItem *, QPointF offset, QHash<QString, QString> & svgHash, ItemSvgJob &);
+	static void finishItemSvg(ItemSvgJob &, double dpi, double printerScale);
+	static QString placeItemSvg(const ItemSvgJob &, const QString & itemSvg, double dpi, double printerScale);
+	static void shareItemSvgs(QVector<ItemSvgJob> &, double dpi, double printerScale, QString & defs);
+	static QByteArray renderSignature(QGraphicsItem *);
 	QList<ItemBase *> collectSuperSubs(ItemBase *);
 	void squashShapes(QPointF scenePos);
 	void unsquashShapes();
@@ -578,6 +613,7 @@ Q_SIGNALS:
 	void packItemsSignal(int columns, const QList<long> & ids, QUndoCommand *parent, bool doEmit);
 
 protected Q_SLOTS:
+	void routingJobFinished();
 	void itemAddedSlot(ModelPart *, ItemBase *, ViewLayer::ViewLayerPlacement, const ViewGeometry &, long id, SketchWidget * dropOrigin);
 	void itemDeletedSlot(long id);
 	void clearSelectionSlot();
@@ -607,6 +643,7 @@ protected Q_SLOTS:
 	void deleteTracesSlot(QSet<ItemBase *> & deletedItems, QHash<ItemBase *, SketchWidget *> & otherDeletedItems, QList<long> & deletedIDs, bool isForeign, QUndoCommand * parentCommand);
 	void vScrollToZero();
 	void arrowTimerTimeout();
+	void flushMoveFollowUp();
 	void makeDeleteItemCommandPrepSlot(ItemBase * itemBase, bool foreign, QUndoCommand * parentCommand);
 	void makeDeleteItemCommandFinalSlot(ItemBase * itemBase, bool foreign, QUndoCommand * parentCommand);
 	void updatePartLabelInstanceTitleSlot(long itemID);
@@ -630,6 +667,7 @@ public Q_SLOTS:
 	void setResistance(long itemID, QString resistance, QString pinSpacing, bool doEmit);
 	void setResistance(QString resistance, QString pinSpacing);
 	void setProp(long itemID, const QString & prop, const QString & value, bool redraw, bool doEmit);
+	bool swapInPlace(long itemID, const QString & moduleID);
 	virtual void setProp(ItemBase *, const QString & propName, const QString & translatedPropName, const QString & oldValue, const QString & newValue, bool redraw);
 	void setHoleSize(ItemBase *, const QString & propName, const QString & translatedPropName, const QString & oldValue, const QString & newValue, QRectF & oldRect, QRectF & newRect, bool redraw);
 	virtual void showLabelFirstTimeForCommand(long itemID, bool show, bool doEmit);
@@ -693,6 +731,7 @@ protected:
 	bool m_infoViewOnHover;
 
 	QHash<long, ItemBase *> m_savedItems;
+	QMultiHash<long, QPointer<ItemBase> > m_itemIndex;		// id / ModelPart::indexMultiplier -> the chief and layerkin in the scene
 	QHash<Wire *, ConnectorItem *> m_savedWires;
 	QList<ItemBase *> m_additionalSavedItems;
 	int m_ignoreSelectionChangeEvents = 0;
@@ -742,14 +781,50 @@ protected:
 	QPointer<ItemBase> m_addedDefaultPart;
 	float m_z;
 	QTimer m_arrowTimer;
+	QTimer m_moveFollowUpTimer;
+	QTimer m_updateInfoViewTimer;
+	QPointF m_moveFollowUpScenePos;
+	bool m_moveFollowUpPending = false;
 	bool m_middleMouseIsPressed = false;
 	QMultiHash<ItemBase *, ConnectorItem *> m_stretchingLegs;
+	QScopedPointer<class ConnectorGrid> m_connectorGrid;		// connectors under the items being dragged
 	bool m_curvyWires = false;
 	bool m_rubberBandLegWasEnabled = false;
 	RoutingStatus m_routingStatus;
+
+	struct RoutingNet {
+		QList< QPointer<ConnectorItem> > connectorItems;		// one equal-potential set
+		RoutingStatus status;									// its share of the routing status
+		bool alive = true;
+	};
+
+	struct PendingRatsnest {
+		QList< QPointer<ConnectorItem> > connectorItems;		// one net's part connectors, as given to displayRatsnest
+		QList< QPointer<ConnectorItem> > nodes;					// the ones the ratsnest graph was built from
+		int graph = -1;											// into RoutingJob::ratsnestGraphs
+	};
+
+	QVector<RoutingNet> m_routingNets;
+	QHash<ConnectorItem *, int> m_routingNetIndex;				// connector -> index into m_routingNets
+	int m_deadRoutingNets = 0;
+	bool m_routingNetsValid = false;							// cleared by any change the connection records don't cover
+	bool m_routingStatusDeferred = false;						// changes made while this view wasn't current are still to be scored
+	QList<PendingRatsnest> m_pendingRatsnests;
+	QList< QPointer<class VirtualWire> > m_pendingRatsToDelete;
+	QFutureWatcher<RoutingJob> m_routingWatcher;				// a full rescore running on a worker
+	bool m_routingJobPending = false;
 	bool m_anyInRotation;
 	bool m_pasting = false;
 	QPointer<class ResizableBoard> m_resizingBoard;
+
+	struct StickyPlacement {
+		long stickyID = 0;
+		QRectF relative;										// the item's scene rect, from the top left of what it sticks to
+		QSizeF stickySize;
+	};
+
+	QHash<long, StickyPlacement> m_stickyPlacements;			// item id -> where it sat on its sticky base at the last check
+	QHash<QString, RenderCache> m_renderCaches;					// by exporter, see renderCache
 	QList< QPointer<ItemBase> > m_squashShapes;
 	QColor m_gridColor;
 	bool m_everZoomed = false;
@@ -760,8 +835,11 @@ public:
 	static ViewLayer::ViewLayerID defaultConnectorLayer(ViewLayer::ViewID viewId);
 	static constexpr int PropChangeDelay = 100;
 	static bool m_blockUI;
+	static bool clipboardDocument(const class QMimeData *, QDomDocument &);
 
 protected:
+	static QByteArray ClipboardToken;
+	static QDomDocument ClipboardDocument;
 	static constexpr int MoveAutoScrollThreshold = 5;
 	static constexpr int DragAutoScrollThreshold = 10;
 };
@@ -21,6 +21,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "welcomeview.h"
 #include "../debugdialog.h"
 #include "../help/tipsandtricks.h"
+#include "../utils/folderutils.h"
 
 #include <QTextEdit>
 #include <QGridLayout>
@@ -32,6 +33,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QSettings>
 #include <QFileInfo>
 #include <QNetworkAccessManager>
+#include <QNetworkDiskCache>
+#include <QPointer>
+#include <QSet>
 #include <QDesktopServices>
 #include <QDomDocument>
 #include <QDomNodeList>
@@ -52,10 +56,31 @@ constexpr auto IconRole = Qt::UserRole + 4;
 constexpr auto RefRole = Qt::UserRole + 5;
 constexpr auto ImageSpace = 65;
 constexpr auto TopSpace = 1;
+constexpr auto MaxImageRequests = 4;
+constexpr auto WelcomeCacheBytes = 20 * 1024 * 1024;
 
 QString WelcomeView::m_activeHeaderLabelColor = "#333";
 QString WelcomeView::m_inactiveHeaderLabelColor = "#b1b1b1";
 
+// shared by every welcome view in the process; a feed fetched once this session isn't fetched again for a new window
+static QHash<QString, QString> LatestFeeds;
+static QSet<QString> FeedsInFlight;
+static QHash<QString, QPixmap> ScaledImages;
+
+static QNetworkAccessManager * welcomeNetwork() {
+	// one manager, so the connections are reused, with a disk cache: the feeds are revalidated against their
+	// ETag or Last-Modified instead of downloaded in full at every launch, and the images come from disk
+	static QPointer<QNetworkAccessManager> manager;
+	if (manager.isNull()) {
+		manager = new QNetworkAccessManager(qApp);
+		auto * cache = new QNetworkDiskCache(manager);
+		cache->setCacheDirectory(FolderUtils::getTopLevelUserDataStorePath() + "/welcomecache");
+		cache->setMaximumCacheSize(WelcomeCacheBytes);
+		manager->setCache(cache);
+	}
+	return manager;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void zeroMargin(QLayout * layout) {
@@ -324,15 +349,8 @@ WelcomeView::WelcomeView(QWidget * parent) : QFrame(parent)
 	connect(this, SIGNAL(recentSketch(const QString &, const QString &)), this->window(), SLOT(openRecentOrExampleFile(const QString &, const QString &)));
 
 	QString protocol = QSslSocket::supportsSsl() ? "https" : "http";
-	// TODO: blog network calls should only happen once, not for each window?
-	auto * manager = new QNetworkAccessManager(this);
-	connect(manager, SIGNAL(finished(QNetworkReply *)), this, SLOT(gotBlogSnippet(QNetworkReply *)));
-	manager->get(QNetworkRequest(QUrl(QString("%1://blog.fritzing.org/recent-posts-app/").arg(protocol))));
-
-	manager = new QNetworkAccessManager(this);
-
-	connect(manager, SIGNAL(finished(QNetworkReply *)), this, SLOT(gotBlogSnippet(QNetworkReply *)));
-	manager->get(QNetworkRequest(QUrl(QString("%1://fritzing.org/projects/snippet/").arg(protocol))));
+	requestFeed(QUrl(QString("%1://blog.fritzing.org/recent-posts-app/").arg(protocol)));
+	requestFeed(QUrl(QString("%1://fritzing.org/projects/snippet/").arg(protocol)));
 
 	TipsAndTricks::initTipSets();
 	nextTip();
@@ -722,37 +740,80 @@ void WelcomeView::clickRecent(const QString & url) {
 	}
 }
 
-void WelcomeView::gotBlogSnippet(QNetworkReply * networkReply) {
-	bool blog = networkReply->url().toString().contains("recent");
-	QString prefix = networkReply->url().scheme() + "://" + networkReply->url().authority();
-	QNetworkAccessManager * manager = networkReply->manager();
-	int responseCode = networkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+void WelcomeView::requestFeed(const QUrl & url) {
+	// show what was last seen of the feed straight away, from this session or from the disk cache,
+	// then ask for it again in the background
+	bool blog = url.toString().contains("recent");
+	QString prefix = url.scheme() + "://" + url.authority();
+	QString data = LatestFeeds.value(url.toString());
+	if (data.isEmpty()) {
+		QIODevice * cached = welcomeNetwork()->cache()->data(url);
+		if (cached != nullptr) {
+			data = QString(cached->readAll());
+			delete cached;
+		}
+	}
+	if (!data.isEmpty() && showFeed(data, false, blog, prefix)) {
+		m_shownFeeds.insert(url.toString(), data);
+		getNextBlogImage(0, blog);
+	}
 
-	auto goodBlog = false;
+	// another view is fetching it, or already has; either way this one is given the result
+	if (LatestFeeds.contains(url.toString()) || FeedsInFlight.contains(url.toString())) return;
+
+	FeedsInFlight.insert(url.toString());
+	QNetworkReply * reply = welcomeNetwork()->get(QNetworkRequest(url));
+	connect(reply, &QNetworkReply::finished, this, [this, reply]() { gotBlogSnippet(reply); });
+	connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
+}
+
+bool WelcomeView::showFeed(const QString & data, bool doEmit, bool blog, const QString & prefix) {
 	QDomDocument doc;
 	QString errorStr;
 	auto errorLine = 0;
 	auto errorColumn = 0;
+	QString thing = "<thing>" + cleanData(data) + "</thing>";		// make it one tree for xml parsing
+	if (!doc.setContent(thing, &errorStr, &errorLine, &errorColumn)) return false;
+
+	readBlog(doc, doEmit, blog, prefix);
+	return true;
+}
+
+void WelcomeView::gotBlogSnippet(QNetworkReply * networkReply) {
+	QString url = networkReply->request().url().toString();
+	bool blog = url.contains("recent");
+	QString prefix = networkReply->url().scheme() + "://" + networkReply->url().authority();
+	int responseCode = networkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	FeedsInFlight.remove(url);
+
+	// a 304 from revalidation is handed on as the cached 200
+	auto goodBlog = false;
 	if (responseCode == 200) {
 		QString data(networkReply->readAll());
 		//DebugDialog::debug("response data " + data);
-		data = "<thing>" + cleanData(data) + "</thing>";		// make it one tree for xml parsing
-		if (doc.setContent(data, &errorStr, &errorLine, &errorColumn)) {
-			readBlog(doc, true, blog, prefix);
+		if (data == m_shownFeeds.value(url)) {
+			// unchanged since the cached copy went up
+			LatestFeeds.insert(url, data);
+			goodBlog = true;
+		}
+		else if (showFeed(data, true, blog, prefix)) {
+			LatestFeeds.insert(url, data);
+			m_shownFeeds.insert(url, data);
 			goodBlog = true;
 		}
 	}
 
-	if (!goodBlog) {
+	if (!goodBlog && !m_shownFeeds.contains(url)) {
 		QString message = (blog) ? tr("Unable to reach blog.fritzing.org") : tr("Unable to reach fritzing.org/projects") ;
 		QString placeHolder = QString("<li><a class='title' href='nop' title='%1'></a></li>").arg(message);
+		QDomDocument doc;
+		QString errorStr;
+		auto errorLine = 0;
+		auto errorColumn = 0;
 		if (doc.setContent(placeHolder, &errorStr, &errorLine, &errorColumn)) {
 			readBlog(doc, true, blog, "");
 		}
 	}
-
-	manager->deleteLater();
-	networkReply->deleteLater();
 }
 
 void WelcomeView::clickBlog(const QString & url) {
@@ -837,6 +898,9 @@ void WelcomeView::readBlog(const QDomDocument & doc, bool doEmit, bool blog, con
 	auto *listWidget = (blog) ? m_blogListWidget : m_projectListWidget;
 	listWidget->clear();
 	listWidget->imageRequestList().clear();
+	for (int i = m_imageQueue.count() - 1; i >= 0; i--) {
+		if (m_imageQueue.at(i).blog == blog) m_imageQueue.removeAt(i);
+	}
 
 	QDomNodeList nodeList = doc.elementsByTagName("li");
 	for (int i = 0; i < nodeList.count(); i++) {
@@ -915,20 +979,39 @@ void WelcomeView::getNextBlogImage(int ix, bool blog) {
 		QString image = listWidget->imageRequestList().at(i);
 		if (image.isEmpty()) continue;
 
-		auto * manager = new QNetworkAccessManager(this);
-		manager->setProperty("index", i);
-		manager->setProperty("blog", blog);
-		connect(manager, SIGNAL(finished(QNetworkReply *)), this, SLOT(gotBlogImage(QNetworkReply *)));
-		manager->get(QNetworkRequest(QUrl(image)));
+		if (ScaledImages.contains(image)) {
+			QPixmap scaled = ScaledImages.value(image);
+			setBlogItemImage(scaled, i, blog, image);
+			continue;
+		}
+
+		m_imageQueue.append({ i, blog, image });
+	}
+	requestBlogImages();
+}
+
+void WelcomeView::requestBlogImages() {
+	// a few at a time over the shared connections; the images don't change once posted, so the cache is taken as is
+	while (m_imageRequests < MaxImageRequests && !m_imageQueue.isEmpty()) {
+		ImageRequest imageRequest = m_imageQueue.takeFirst();
+		QNetworkRequest request((QUrl(imageRequest.url)));
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+		QNetworkReply * reply = welcomeNetwork()->get(request);
+		reply->setProperty("index", imageRequest.index);
+		reply->setProperty("blog", imageRequest.blog);
+		reply->setProperty("image", imageRequest.url);
+		m_imageRequests++;
+		connect(reply, &QNetworkReply::finished, this, [this, reply]() { gotBlogImage(reply); });
+		connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
 	}
 }
 
 void WelcomeView::gotBlogImage(QNetworkReply * networkReply) {
-	auto *manager = networkReply->manager();
-	if (!manager) return;
+	m_imageRequests--;
 
-	auto index = manager->property("index").toInt();
-	auto blog = manager->property("blog").toBool();
+	auto index = networkReply->property("index").toInt();
+	auto blog = networkReply->property("blog").toBool();
+	QString image = networkReply->property("image").toString();
 
 	auto responseCode = networkReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 	if (responseCode == 200) {
@@ -936,19 +1019,19 @@ void WelcomeView::gotBlogImage(QNetworkReply * networkReply) {
 		QPixmap pixmap;
 		if (pixmap.loadFromData(data)) {
 			QPixmap scaled = pixmap.scaled(QSize(ImageSpace, ImageSpace), Qt::KeepAspectRatio);
-			setBlogItemImage(scaled, index, blog);
+			ScaledImages.insert(image, scaled);
+			setBlogItemImage(scaled, index, blog, image);
 			Q_FOREACH (QWidget *widget, QApplication::topLevelWidgets()) {
 				auto *other = widget->findChild<WelcomeView *>();
 				if (!other) continue;
 				if (other == this) continue;
 
-				other->setBlogItemImage(scaled, index, blog);
+				other->setBlogItemImage(scaled, index, blog, image);
 			}
 		}
 	}
 
-	manager->deleteLater();
-	networkReply->deleteLater();
+	requestBlogImages();
 }
 
 QWidget * WelcomeView::initTip() {
@@ -1035,9 +1118,11 @@ void WelcomeView::blogItemClicked(QListWidgetItem * item) {
 	QDesktopServices::openUrl(url);
 }
 
-void WelcomeView::setBlogItemImage(QPixmap & pixmap, int index, bool blog) {
-	// TODO: this is not totally thread-safe if there are multiple sketch widgets opened within a very short time
+void WelcomeView::setBlogItemImage(QPixmap & pixmap, int index, bool blog, const QString & url) {
+	// the list may have been refilled since the image was asked for
 	auto *listWidget = (blog) ? m_blogListWidget : m_projectListWidget;
+	if (listWidget->imageRequestList().value(index) != url) return;
+
 	auto *item = listWidget->item(index);
 	if (item) {
 		item->setData(IconRole, pixmap);
@@ -28,6 +28,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QList>
 #include <QWidget>
 #include <QNetworkReply>
+#include <QHash>
+#include <QUrl>
 #include <QDomDocument>
 #include <QDragEnterEvent>
 #include <QListWidget>
@@ -124,7 +126,10 @@ protected:
 	void readBlog(const QDomDocument &, bool doEmit, bool blog, const QString & prefix);
 	QWidget * makeRecentItem(const QString & objectName, const QString & iconText, const QString & textText, QLabel * & icon, QLabel * & text);
 	void getNextBlogImage(int ix, bool blog);
-	void setBlogItemImage(QPixmap &, int index, bool blog) ;
+	void requestBlogImages();
+	void setBlogItemImage(QPixmap &, int index, bool blog, const QString & url);
+	void requestFeed(const QUrl &);
+	bool showFeed(const QString & data, bool doEmit, bool blog, const QString & prefix);
 	QWidget * createShopContentFrame(const QString & imagePath, const QString & headline, const QString & description,
 	                                 const QString & url, const QString & urlText, const QString & urlText2, const QString & logoPath, const QString & footerLabelColor);
 	BlogListWidget * createBlogContentFrame(const QString & url, const QString & urlText, const QString & logoPath, const QString & footerLabelColor);
@@ -161,6 +166,16 @@ protected:
 	QLabel * m_fabLabel = nullptr;
 	QLabel * m_shopLabel = nullptr;
 
+	struct ImageRequest {
+		int index;
+		bool blog;
+		QString url;
+	};
+
+	QList<ImageRequest> m_imageQueue;           // waiting for one of the MaxImageRequests slots
+	int m_imageRequests = 0;                    // in flight
+	QHash<QString, QString> m_shownFeeds;       // feed url -> the data now in the list
+
 	static QString m_activeHeaderLabelColor;
 	static QString m_inactiveHeaderLabelColor;
 
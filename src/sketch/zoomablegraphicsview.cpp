@@ -22,6 +22,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QScrollBar>
 #include <QSettings>
 #include <QGestureEvent>
+#include <QOpenGLContext>
+#include <QOpenGLWidget>
+#include <QSurfaceFormat>
 
 #include "zoomablegraphicsview.h"
 #include "../utils/zoomslider.h"
@@ -29,6 +32,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "debugdialog.h"
 
 const int ZoomableGraphicsView::MaxScaleValue = 3000;
+const int ZoomableGraphicsView::InteractionIdleMs = 300;
 
 
 ZoomableGraphicsView::WheelMapping ZoomableGraphicsView::m_wheelMapping =
@@ -38,6 +42,8 @@ ZoomableGraphicsView::WheelMapping ZoomableGraphicsView::m_wheelMapping =
     ScrollPrimary;
 #endif
 
+bool ZoomableGraphicsView::m_acceleratedViewport = false;
+
 bool FirstTime = true;
 
 ZoomableGraphicsView::ZoomableGraphicsView( QWidget * parent )
@@ -64,8 +70,32 @@ ZoomableGraphicsView::ZoomableGraphicsView( QWidget * parent )
 			m_wheelMapping = ZoomPrimary;
 #endif
 		}
+
+		if (settings.value("acceleratedViewport", false).toBool()) {
+			// without a working OpenGL context the viewport would stay blank, so stay with the raster engine
+			QOpenGLContext context;
+			m_acceleratedViewport = context.create();
+			if (!m_acceleratedViewport) {
+				DebugDialog::debug("no OpenGL context, views are drawn without the graphics card");
+			}
+		}
 	}
 	grabGesture(Qt::PinchGesture);
+
+	if (m_acceleratedViewport) {
+		// the part rasters drawn while panning and zooming are kept as textures and composited by the graphics card;
+		// a GL viewport redraws whole frames anyway, so partial updates only add bookkeeping
+		auto * viewport = new QOpenGLWidget();
+		QSurfaceFormat format = viewport->format();
+		format.setSamples(4);
+		viewport->setFormat(format);
+		setViewport(viewport);
+		setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+	}
+
+	m_interactionTimer.setSingleShot(true);
+	m_interactionTimer.setInterval(InteractionIdleMs);
+	connect(&m_interactionTimer, SIGNAL(timeout()), this, SLOT(interactionDone()));
 }
 
 bool ZoomableGraphicsView::event(QEvent *event) {
@@ -243,6 +273,7 @@ void ZoomableGraphicsView::relativeZoom(double step, bool centerOnCursor) {
 	else {
 		this->setTransformationAnchor(QGraphicsView::AnchorViewCenter);
 	}
+	startInteraction();
 	this->setTransform(transform);
 
 	Q_EMIT zoomChanged(m_scaleValue);
@@ -300,3 +331,27 @@ void ZoomableGraphicsView::pinchTriggered(QPinchGesture *gesture) {
 		DebugDialog::debug(result);
 	}
 }
+
+void ZoomableGraphicsView::scrollContentsBy(int dx, int dy) {
+	startInteraction();
+	QGraphicsView::scrollContentsBy(dx, dy);
+}
+
+void ZoomableGraphicsView::startInteraction() {
+	// parts paint from cached rasters until the view has been still for a moment
+	m_interacting = true;
+	m_interactionTimer.start();
+}
+
+void ZoomableGraphicsView::interactionDone() {
+	m_interacting = false;
+	viewport()->update();
+}
+
+bool ZoomableGraphicsView::interacting() const {
+	return m_interacting;
+}
+
+bool ZoomableGraphicsView::acceleratedViewport() {
+	return m_acceleratedViewport;
+}
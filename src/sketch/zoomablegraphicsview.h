@@ -26,6 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QHash>
 #include <QList>
 #include <QPinchGesture>
+#include <QTimer>
 
 
 class ZoomableGraphicsView : public QGraphicsView
@@ -42,8 +43,10 @@ public:
 	virtual void ensureFixedToBottomRightItems() {}
 	bool viewFromBelow();
 	virtual void setViewFromBelow(bool);
+	bool interacting() const;
 
 	static const int MaxScaleValue;
+	static const int InteractionIdleMs;
 
 public:
 	enum WheelMapping {
@@ -56,6 +59,7 @@ public:
 
 	static WheelMapping wheelMapping();
 	static void setWheelMapping(WheelMapping);
+	static bool acceleratedViewport();
 	bool event(QEvent *event);
 
 Q_SIGNALS:
@@ -66,6 +70,11 @@ protected:
 	virtual void wheelEvent(QWheelEvent* event);
 	bool gestureEvent(QGestureEvent *event);
 	void pinchTriggered(QPinchGesture *gesture);
+	void scrollContentsBy(int dx, int dy) override;
+	void startInteraction();
+
+protected Q_SLOTS:
+	void interactionDone();
 
 protected:
 	double m_scaleValue;
@@ -74,9 +83,12 @@ protected:
 	bool m_acceptWheelEvents;
 	qint64 m_guessTouchpadId;
 	bool m_viewFromBelow;
+	bool m_interacting = false;
+	QTimer m_interactionTimer;
 
 protected:
 	static WheelMapping m_wheelMapping;
+	static bool m_acceleratedViewport;
 };
 
 #endif
@@ -31,6 +31,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFileInfo>
 #include <QTextStream>
 #include <QObject>
+#include <QRegularExpression>
 #include <limits>
 #include <QDomDocument>
 #include <QDomElement>
@@ -43,9 +44,6 @@ GedaElement2Svg::GedaElement2Svg() : X2Svg() {
 
 QString GedaElement2Svg::convert(const QString & filename, bool allowPadsAndPins)
 {
-	m_nonConnectorNumber = 0;
-	initLimits();
-
 	QFile file(filename);
 	if (!file.open(QFile::ReadOnly)) {
 		throw QObject::tr("unable to open %1").arg(filename);
@@ -56,6 +54,63 @@ QString GedaElement2Svg::convert(const QString & filename, bool allowPadsAndPins
 	text = textStream.readAll();
 	file.close();
 
+	return convertText(text, filename, allowPadsAndPins);
+}
+
+bool GedaElement2Svg::readElement(QTextStream & stream, QString & element)
+{
+	// reads the next Element, with the comment lines in front of it, so a file holding many
+	// elements can be converted one element at a time; returns false when there are no more
+	static const QRegularExpression ElementStart("^\\s*Element\\s*[\\(\\[]", QRegularExpression::CaseInsensitiveOption);
+
+	element.clear();
+	QString comments;
+	int depth = 0;
+	int groups = 0;                 // the element's arguments, then its body
+	bool inString = false;
+	bool started = false;
+	while (true) {
+		QString line = stream.readLine();
+		if (line.isNull()) break;
+
+		if (!started) {
+			if (line.trimmed().startsWith('#')) {
+				comments += line + "\n";
+				continue;
+			}
+			if (!line.contains(ElementStart)) {
+				if (!line.trimmed().isEmpty()) comments.clear();
+				continue;
+			}
+			started = true;
+			element = comments;
+		}
+
+		element += line + "\n";
+		if (line.trimmed().startsWith('#')) continue;
+
+		for (int i = 0; i < line.length(); i++) {
+			QChar c = line.at(i);
+			if (inString) {
+				if (c == '\\') i++;
+				else if (c == '"') inString = false;
+			}
+			else if (c == '"') inString = true;
+			else if (c == '(' || c == '[') depth++;
+			else if ((c == ')' || c == ']') && --depth == 0) groups++;
+		}
+		if (groups >= 2) return true;
+	}
+
+	// an unterminated element is still handed back, so the parser can report it
+	return started;
+}
+
+QString GedaElement2Svg::convertText(const QString & text, const QString & filename, bool allowPadsAndPins)
+{
+	m_nonConnectorNumber = 0;
+	initLimits();
+
 	GedaElementLexer lexer(text);
 	GedaElementParser parser;
 
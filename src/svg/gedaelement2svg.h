@@ -23,6 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QString>
 #include <QStringList>
+#include <QTextStream>
 #include <QVariant>
 
 #include "x2svg.h"
@@ -33,6 +34,10 @@ class GedaElement2Svg : public X2Svg
 public:
 	GedaElement2Svg();
 	QString convert(const QString & filename, bool allowPadsAndPins);
+	QString convertText(const QString & text, const QString & filename, bool allowPadsAndPins);
+
+public:
+	static bool readElement(QTextStream & stream, QString & element);
 
 protected:
 	int countArgs(QVector<QVariant> & stack, int ix);
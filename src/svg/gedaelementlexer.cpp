@@ -25,13 +25,15 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 static QRegularExpression findWhitespace("[\\s]+");
 
+// compiled once and shared by every lexer, including the nested one in clean() and those on other threads
+static const QRegularExpression NonWhitespaceMatcher("[^\\s]");
+static const QRegularExpression CommentMatcher("(^\\s*\\#)");
+static const QRegularExpression ElementMatcher("Element\\s*([\\(\\[])");
+static const QRegularExpression StringMatcher("\"([^\"\\\\]*(\\\\.[^\"\\\\]*)*)\"");
+static const QRegularExpression IntegerMatcher("[-+]?\\d+");
+static const QRegularExpression HexMatcher("0[xX][0-9a-fA-F]+");
+
 GedaElementLexer::GedaElementLexer(const QString &source) :
-    m_nonWhitespaceMatcher("[^\\s]"),
-	m_commentMatcher("(^\\s*\\#)"),
-	m_elementMatcher("Element\\s*([\\(\\[])"),
-	m_stringMatcher("\"([^\"\\\\]*(\\\\.[^\"\\\\]*)*)\""),
-	m_integerMatcher("[-+]?\\d+"),
-	m_hexMatcher("0[xX][0-9a-fA-F]+"),
 	m_source(),
 	m_chars(nullptr),
 	m_size(0),
@@ -57,10 +59,10 @@ QString GedaElementLexer::clean(const QString & source) {
 	for (int i = s.length() - 1; i >= 0; i--) {
 		QString str = s[i];
 		QRegularExpressionMatch match;
-		if (str.indexOf(m_commentMatcher, 0, &match) == 0) {
+		if (str.indexOf(CommentMatcher, 0, &match) == 0) {
 			s.removeAt(i);
 			str = str.remove(0, match.capturedLength());
-			if (str.contains(m_nonWhitespaceMatcher)) {
+			if (str.contains(NonWhitespaceMatcher)) {
 				m_comments.push_front(str.trimmed());
 			}
 		}
@@ -68,7 +70,7 @@ QString GedaElementLexer::clean(const QString & source) {
 	QString s1 = s.join("\n");
 	QString s2 = s1.replace(findWhitespace, " ");
 	QRegularExpressionMatch match;
-	int ix = s2.indexOf(m_elementMatcher, 0, &match);
+	int ix = s2.indexOf(ElementMatcher, 0, &match);
 	if (ix < 0) {
 		return s2;
 	}
@@ -147,7 +149,7 @@ int GedaElementLexer::lex()
 {
 	while (true) {
 		QRegularExpressionMatch match;
-		if (m_source.indexOf(m_hexMatcher, m_pos - 1, &match) == m_pos - 1) {
+		if (matchAt(HexMatcher, match)) {
 			bool ok;
 			m_currentString = match.captured(0);
 			m_currentNumber = m_currentString.toLong(&ok, 16);
@@ -158,7 +160,7 @@ int GedaElementLexer::lex()
 			next();
 			return GedaElementGrammar::HEXNUMBER;
 		}
-		else if (m_source.indexOf(m_integerMatcher, m_pos - 1, &match) == m_pos - 1) {
+		else if (matchAt(IntegerMatcher, match)) {
 			m_currentString = match.captured(0);
 			m_currentNumber = m_currentString.toLong();
 			m_pos += match.capturedLength() - 1;
@@ -168,7 +170,7 @@ int GedaElementLexer::lex()
 			next();
 			return GedaElementGrammar::NUMBER;
 		}
-		else if (m_source.indexOf(m_stringMatcher, m_pos - 1, &match) == m_pos - 1) {
+		else if (matchAt(StringMatcher, match)) {
 			m_currentString = match.captured(0);
 			m_pos += match.capturedLength() - 1;
 			next();
@@ -197,43 +199,43 @@ int GedaElementLexer::lex()
 			next();
 			return GedaElementGrammar::RIGHTBRACKET;
 		}
-		else if (m_source.indexOf("elementline", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("elementline"))) {
 			m_currentCommand = "elementline";
 			m_pos += m_currentCommand.length() - 1;
 			next();
 			return GedaElementGrammar::ELEMENTLINE;
 		}
-		else if (m_source.indexOf("elementarc", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("elementarc"))) {
 			m_currentCommand = "elementarc";
 			m_pos += m_currentCommand.length() - 1;
 			next();
 			return GedaElementGrammar::ELEMENTARC;
 		}
-		else if (m_source.indexOf("attribute", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("attribute"))) {
 			m_currentCommand = "attribute";
 			m_pos += m_currentCommand.length() - 1;
 			next();
 			return GedaElementGrammar::ATTRIBUTE;
 		}
-		else if (m_source.indexOf("element", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("element"))) {
 			m_currentCommand = "element";
 			m_pos += m_currentCommand.length() - 1;
 			next();
 			return GedaElementGrammar::ELEMENT;
 		}
-		else if (m_source.indexOf("pad", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("pad"))) {
 			m_currentCommand = "pad";
 			m_pos += m_currentCommand.length() - 1;
 			next();
 			return GedaElementGrammar::PAD;
 		}
-		else if (m_source.indexOf("pin", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("pin"))) {
 			m_currentCommand = "pin";
 			m_pos += m_currentCommand.length() - 1;
 			next();
 			return GedaElementGrammar::PIN;
 		}
-		else if (m_source.indexOf("mark", m_pos - 1, Qt::CaseInsensitive) == m_pos - 1) {
+		else if (keywordAt(QLatin1String("mark"))) {
 			m_currentCommand = "mark";
 			m_pos += m_currentCommand.length() - 1;
 			next();
@@ -245,6 +247,19 @@ int GedaElementLexer::lex()
 	}
 }
 
+bool GedaElementLexer::matchAt(const QRegularExpression & matcher, QRegularExpressionMatch & match) const
+{
+	// anchored at the current character, so a failed match doesn't scan the rest of the source
+	match = matcher.match(m_source, m_pos - 1, QRegularExpression::NormalMatch,
+	                      QRegularExpression::AnchoredMatchOption | QRegularExpression::DontCheckSubjectStringMatchOption);
+	return match.hasMatch();
+}
+
+bool GedaElementLexer::keywordAt(QLatin1String keyword) const
+{
+	return QStringView(m_source).mid(m_pos - 1).startsWith(keyword, Qt::CaseInsensitive);
+}
+
 QChar GedaElementLexer::next()
 {
 	if (m_pos < m_size)
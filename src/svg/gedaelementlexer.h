@@ -40,14 +40,10 @@ public:
 protected:
 	QChar next();
 	QString clean(const QString & source);
+	bool matchAt(const QRegularExpression &, QRegularExpressionMatch &) const;
+	bool keywordAt(QLatin1String keyword) const;
 
 protected:
-	QRegularExpression m_nonWhitespaceMatcher;
-	QRegularExpression m_commentMatcher;
-	QRegularExpression m_elementMatcher;
-	QRegularExpression m_stringMatcher;
-	QRegularExpression m_integerMatcher;
-	QRegularExpression m_hexMatcher;
 	QString m_source;
 	const QChar *m_chars = nullptr;
 	int m_size = 0;
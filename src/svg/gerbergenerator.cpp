@@ -19,21 +19,37 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 ********************************************************************/
 
 #include <QBuffer>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
+#include <QMutex>
+#include <QSet>
 #include <QSvgRenderer>
+#include <QThread>
+#include <QtConcurrentRun>
 #include <qmath.h>
 
+#include <quazip.h>
+#include <quazipfile.h>
+
 #include "gerbergenerator.h"
 
+#include "../autoroute/checker.h"
+#include "../autoroute/drcgeometry.h"
+#include "../installedfonts.h"
 #include "../connectors/connectoritem.h"
 #include "../connectors/svgidlayer.h"
 #include "../debugdialog.h"
 #include "../fsvgrenderer.h"
+#include "../processeventblocker.h"
 #include "../sketch/pcbsketchwidget.h"
 #include "../utils/folderutils.h"
 #include "../utils/graphicsutils.h"
 #include "../utils/textutils.h"
+#include "../utils/tracer.h"
 #include "../version/version.h"
 #include "items/groundplane.h"
 #include "groundplanegenerator.h"
@@ -52,9 +68,13 @@ const QString GerberGenerator::DrillSuffix = "_drill.txt";
 const QString GerberGenerator::OutlineSuffix = "_contour.gm1";
 const QString GerberGenerator::PickAndPlaceSuffix = "_pnp.xy";
 const QString GerberGenerator::MagicBoardOutlineID = "boardoutline";
+const QString GerberGenerator::RenderCacheName = "gerber";
 
 const double GerberGenerator::MaskClearanceMils = 5;
 
+static QMutex PendingMessagesMutex;
+static QStringList PendingMessages;
+
 ////////////////////////////////////////////
 
 bool pixelsCollide(QImage * image1, QImage * image2, int x1, int y1, int x2, int y2) {
@@ -77,8 +97,98 @@ bool pixelsCollide(QImage * image1, QImage * image2, int x1, int y1, int x2, int
 
 ////////////////////////////////////////////
 
-void GerberGenerator::exportToGerber(const QString & prefix, const QString & exportDir, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes)
+GerberOutput::GerberOutput(const QString & exportDir) : m_exportDir(exportDir)
+{
+}
+
+GerberOutput::~GerberOutput()
+{
+	closeZip();
+}
+
+bool GerberOutput::openZip(const QString & zipPath)
+{
+	m_zipPath = zipPath;
+	m_zip.reset(new QuaZip(zipPath));
+	if (!m_zip->open(QuaZip::mdCreate)) {
+		DebugDialog::debug(QString("unable to create zip %1: %2").arg(zipPath).arg(m_zip->getZipError()));
+		m_zip.reset();
+		return false;
+	}
+	return true;
+}
+
+bool GerberOutput::closeZip()
+{
+	if (!m_zip) return true;
+
+	m_zip->close();
+	bool ok = m_zip->getZipError() == UNZ_OK;
+	m_zip.reset();
+	return ok;
+}
+
+bool GerberOutput::write(const QString & fileName, const std::function<bool (QIODevice &)> & writer, qint64 & bytes)
+{
+	// bytes is the uncompressed size
+	bytes = 0;
+	if (!m_zip) {
+		QFile out(m_exportDir + "/" + fileName);
+		if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+
+		bool written = writer(out);
+		out.close();
+		bytes = QFileInfo(out.fileName()).size();
+		return written && out.error() == QFileDevice::NoError;
+	}
+
+	QMutexLocker locker(&m_mutex);
+	QuaZipFile out(m_zip.get());
+	if (!out.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName))) return false;
+
+	bool written = writer(out);
+	bytes = out.pos();
+	out.close();
+	return written && out.getZipError() == UNZ_OK;
+}
+
+QString GerberOutput::location(const QString & fileName) const
+{
+	if (m_zip) return m_zipPath + ":" + fileName;
+
+	return m_exportDir + "/" + fileName;
+}
+
+////////////////////////////////////////////
+
+void GerberGenerator::exportToGerber(const QString & prefix, const QString & exportDir, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, GerberMetrics * metrics)
+{
+	GerberOutput output(exportDir);
+	exportToOutput(prefix, output, board, sketchWidget, displayMessageBoxes, metrics);
+}
+
+bool GerberGenerator::exportToGerberZip(const QString & prefix, const QString & zipPath, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, GerberMetrics * metrics)
+{
+	// every file goes straight into the zip as it is finished, with nothing written to the folder first
+	GerberOutput output;
+	if (!output.openZip(zipPath)) {
+		displayMessage(QObject::tr("Unable to save to '%1'").arg(zipPath), displayMessageBoxes);
+		return false;
+	}
+
+	exportToOutput(prefix, output, board, sketchWidget, displayMessageBoxes, metrics);
+	if (!output.closeZip()) {
+		displayMessage(QObject::tr("Unable to save to '%1'").arg(zipPath), displayMessageBoxes);
+		return false;
+	}
+	return true;
+}
+
+void GerberGenerator::exportToOutput(const QString & prefix, GerberOutput & output, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, GerberMetrics * metrics)
 {
+	// the layers are rendered here, on the GUI thread; clipping, conversion and saving then run concurrently,
+	// one task per layer, except that each silk layer follows the mask it is clipped by
+	InstalledFonts::registerFonts();
 	if (board == nullptr) {
 		int boardCount = 0;
 		board = sketchWidget->findSelectedBoard(boardCount);
@@ -92,61 +202,149 @@ void GerberGenerator::exportToGerber(const QString & prefix, const QString & exp
 		}
 	}
 
-	exportPickAndPlace(prefix, exportDir, board, sketchWidget, displayMessageBoxes);
+	Tracer::Scope tracing("gerber", prefix);
+	exportPickAndPlace(prefix, output, board, sketchWidget, displayMessageBoxes);
+
+	// copper items are rendered again for the masks and the drill file, so each is serialized once
+	RenderFragments fragments;
+	QList<GerberLayer *> layers;
+	QList< QList<GerberLayer *> > tasks;
+	auto addTask = [&](GerberLayer * first, GerberLayer * second) {
+		QList<GerberLayer *> task;
+		if (first != nullptr) task << first;
+		if (second != nullptr) {
+			second->clipToPrevious = (first != nullptr);
+			task << second;
+		}
+		if (!task.isEmpty()) tasks << task;
+		layers << task;
+	};
+	// each layer's render time runs from the end of the previous render
+	QElapsedTimer renderTimer;
+	auto rendered = [&](GerberLayer * layer) {
+		if (layer != nullptr) layer->renderNs = renderTimer.nsecsElapsed();
+		renderTimer.restart();
+		return layer;
+	};
+	QElapsedTimer exportTimer;
+	exportTimer.start();
+	renderTimer.start();
+	Tracer::begin("gerber.render");
 
 	LayerList viewLayerIDs = ViewLayer::copperLayers(ViewLayer::NewBottom);
-	int copperInvalidCount = doCopper(board, sketchWidget, viewLayerIDs, "Copper0", CopperBottomSuffix, prefix, exportDir, displayMessageBoxes);
-
+	addTask(rendered(doCopper(board, sketchWidget, viewLayerIDs, "Copper0", CopperBottomSuffix, displayMessageBoxes, fragments)), nullptr);
 	if (sketchWidget->boardLayers() == 2) {
 		viewLayerIDs = ViewLayer::copperLayers(ViewLayer::NewTop);
-		copperInvalidCount += doCopper(board, sketchWidget, viewLayerIDs, "Copper1", CopperTopSuffix, prefix, exportDir, displayMessageBoxes);
+		addTask(rendered(doCopper(board, sketchWidget, viewLayerIDs, "Copper1", CopperTopSuffix, displayMessageBoxes, fragments)), nullptr);
 	}
 
-	LayerList maskLayerIDs = ViewLayer::maskLayers(ViewLayer::NewBottom);
-	QString maskBottom, maskTop;
-	int maskInvalidCount = doMask(maskLayerIDs, "Mask0", MaskBottomSuffix, board, sketchWidget, prefix, exportDir, displayMessageBoxes, maskBottom);
-
+	GerberLayer * maskBottom = rendered(doMask(ViewLayer::maskLayers(ViewLayer::NewBottom), "Mask0", MaskBottomSuffix, board, sketchWidget, displayMessageBoxes, fragments));
+	GerberLayer * maskTop = nullptr;
 	if (sketchWidget->boardLayers() == 2) {
-		maskLayerIDs = ViewLayer::maskLayers(ViewLayer::NewTop);
-		maskInvalidCount += doMask(maskLayerIDs, "Mask1", MaskTopSuffix, board, sketchWidget, prefix, exportDir, displayMessageBoxes, maskTop);
+		maskTop = rendered(doMask(ViewLayer::maskLayers(ViewLayer::NewTop), "Mask1", MaskTopSuffix, board, sketchWidget, displayMessageBoxes, fragments));
 	}
 
-	maskLayerIDs = ViewLayer::maskLayers(ViewLayer::NewBottom);
-	int pasteMaskInvalidCount = doPasteMask(maskLayerIDs, "PasteMask0", PasteMaskBottomSuffix, board, sketchWidget, prefix, exportDir, displayMessageBoxes);
-
+	addTask(rendered(doPasteMask(ViewLayer::maskLayers(ViewLayer::NewBottom), "PasteMask0", PasteMaskBottomSuffix, board, sketchWidget, displayMessageBoxes, fragments)), nullptr);
 	if (sketchWidget->boardLayers() == 2) {
-		maskLayerIDs = ViewLayer::maskLayers(ViewLayer::NewTop);
-		pasteMaskInvalidCount += doPasteMask(maskLayerIDs, "PasteMask1", PasteMaskTopSuffix, board, sketchWidget, prefix, exportDir, displayMessageBoxes);
+		addTask(rendered(doPasteMask(ViewLayer::maskLayers(ViewLayer::NewTop), "PasteMask1", PasteMaskTopSuffix, board, sketchWidget, displayMessageBoxes, fragments)), nullptr);
 	}
 
-	LayerList silkLayerIDs = ViewLayer::silkLayers(ViewLayer::NewTop);
-	int silkInvalidCount = doSilk(silkLayerIDs, "Silk1", SilkTopSuffix, board, sketchWidget, prefix, exportDir, displayMessageBoxes, maskTop);
-	silkLayerIDs = ViewLayer::silkLayers(ViewLayer::NewBottom);
-	silkInvalidCount += doSilk(silkLayerIDs, "Silk0", SilkBottomSuffix, board, sketchWidget, prefix, exportDir, displayMessageBoxes, maskBottom);
+	addTask(maskTop, rendered(doSilk(ViewLayer::silkLayers(ViewLayer::NewTop), "Silk1", SilkTopSuffix, board, sketchWidget, displayMessageBoxes, fragments)));
+	addTask(maskBottom, rendered(doSilk(ViewLayer::silkLayers(ViewLayer::NewBottom), "Silk0", SilkBottomSuffix, board, sketchWidget, displayMessageBoxes, fragments)));
 
 	// now do it for the outline/contour
 	LayerList outlineLayerIDs = ViewLayer::outlineLayers();
 	bool empty;
-	QString svgOutline = renderTo(outlineLayerIDs, board, sketchWidget, empty);
-	if (empty || svgOutline.isEmpty()) {
+	QString svgOutline = renderTo(outlineLayerIDs, board, sketchWidget, empty, fragments);
+	bool outlineEmpty = empty || svgOutline.isEmpty();
+	if (outlineEmpty) {
 		displayMessage(QObject::tr("outline is empty"), displayMessageBoxes);
-		return;
+	}
+	else {
+		// at this point svgOutline must be a single element; a path element may contain cutouts
+		auto * outline = new GerberLayer(board, cleanOutline(svgOutline), "board", "contour", SVG2gerber::ForOutline, OutlineSuffix);
+		outline->sizeFromClipped = true;
+		addTask(rendered(outline), nullptr);
+
+		// the drill file was only written for a board with an outline
+		addTask(rendered(doDrill(board, sketchWidget, displayMessageBoxes, fragments)), nullptr);
 	}
 
-	svgOutline = cleanOutline(svgOutline);
-	// at this point svgOutline must be a single element; a path element may contain cutouts
-	QMultiHash<long, ConnectorItem *> treatAsCircle;
-	svgOutline = clipToBoard(svgOutline, board, "board", SVG2gerber::ForOutline, "", displayMessageBoxes, treatAsCircle);
-	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svgOutline);
+	Tracer::end();
+	qint64 renderNs = exportTimer.nsecsElapsed();
 
-	// create outline gerber from svg
-	SVG2gerber outlineGerber;
-	int outlineInvalidCount = outlineGerber.convert(svgOutline, sketchWidget->boardLayers() == 2, "contour", SVG2gerber::ForOutline, svgSize * GraphicsUtils::StandardFritzingDPI);
+	int reused = 0;
+	int fresh = 0;
+	QHash<int, QRectF> dirty = sketchWidget->takeRenderCacheDirt(RenderCacheName, reused, fresh);
+	QStringList dirtyLayers;
+	for (auto it = dirty.constBegin(); it != dirty.constEnd(); ++it) {
+		dirtyLayers << ViewLayer::viewLayerXmlNameFromID((ViewLayer::ViewLayerID) it.key());
+	}
+	DebugDialog::debug(QString("gerber render cache: %1 fragments kept, %2 rendered, changed on %3").arg(reused).arg(fresh).arg(dirtyLayers.join(" ")));
+
+	// the pre-export checks look at the fragments just rendered, alongside the conversions, instead of rendering again
+	QList<QPair<long, QString>> checkFragments;
+	for (auto it = fragments.constBegin(); it != fragments.constEnd(); ++it) {
+		auto * itemBase = dynamic_cast<ItemBase *>(it.key());
+		if (itemBase == nullptr || it.value().isEmpty()) continue;
+		checkFragments.append(qMakePair(itemBase->id(), it.value()));
+	}
+	QFuture<QList<long>> missingPaint = QtConcurrent::run(&Checker::missingPaint, checkFragments);
+	QList<ConnectorItem *> donuts = Checker::donuts(board, sketchWidget);
 
-	//DebugDialog::debug(QString("outline output: %1").arg(outlineGerber.getGerber()));
-	saveEnd("contour", exportDir, prefix, OutlineSuffix, displayMessageBoxes, outlineGerber);
+	int boardLayers = sketchWidget->boardLayers();
+	QList< QFuture<void> > futures;
+	Q_FOREACH (QList<GerberLayer *> task, tasks) {
+		futures << QtConcurrent::run(&GerberGenerator::convertLayers, task, prefix, &output, boardLayers, displayMessageBoxes);
+	}
+	Q_FOREACH (QFuture<void> future, futures) {
+		while (!future.isFinished()) {
+			ProcessEventBlocker::processEvents(200);
+		}
+	}
+	missingPaint.waitForFinished();
+	QList<long> missingPaintIDs = missingPaint.result();
+	std::sort(missingPaintIDs.begin(), missingPaintIDs.end());
+	QString checks = checksMessage(missingPaintIDs, donuts.count() / 2);
+	if (!checks.isEmpty()) {
+		QMutexLocker locker(&PendingMessagesMutex);
+		PendingMessages << checks;
+	}
+	showPendingMessages(displayMessageBoxes);
+
+	if (metrics != nullptr) {
+		metrics->renderNs = renderNs;
+		metrics->convertNs = exportTimer.nsecsElapsed() - renderNs;
+		Q_FOREACH (GerberLayer * layer, layers) {
+			GerberLayerMetrics layerMetrics;
+			layerMetrics.layerName = layer->layerName;
+			layerMetrics.fileName = prefix + layer->suffix;
+			layerMetrics.renderNs = layer->renderNs;
+			layerMetrics.convertNs = layer->convertNs;
+			layerMetrics.bytes = layer->bytes;
+			metrics->layers << layerMetrics;
+		}
+		metrics->missingPaintIDs = missingPaintIDs;
+		metrics->donuts = donuts.count() / 2;
+		QSet<long> donutIDs;
+		Q_FOREACH (ConnectorItem * connectorItem, donuts) {
+			donutIDs.insert(connectorItem->attachedToID());
+		}
+		metrics->donutIDs = donutIDs.values();
+		std::sort(metrics->donutIDs.begin(), metrics->donutIDs.end());
+	}
 
-	doDrill(board, sketchWidget, prefix, exportDir, displayMessageBoxes);
+	int outlineInvalidCount = 0, silkInvalidCount = 0, copperInvalidCount = 0, maskInvalidCount = 0, pasteMaskInvalidCount = 0;
+	Q_FOREACH (GerberLayer * layer, layers) {
+		if (layer->forWhy == SVG2gerber::ForOutline) outlineInvalidCount += layer->invalidCount;
+		else if (layer->forWhy == SVG2gerber::ForSilk) silkInvalidCount += layer->invalidCount;
+		else if (layer->forWhy == SVG2gerber::ForMask) maskInvalidCount += layer->invalidCount;
+		else if (layer->layerName.startsWith("PasteMask")) pasteMaskInvalidCount += layer->invalidCount;
+		else if (layer->forWhy == SVG2gerber::ForCopper) copperInvalidCount += layer->invalidCount;
+	}
+	qDeleteAll(layers);
+
+	if (outlineEmpty) return;
 
 	if (outlineInvalidCount > 0 || silkInvalidCount > 0 || copperInvalidCount > 0 || (maskInvalidCount != 0) || (pasteMaskInvalidCount != 0)) {
 		QString s;
@@ -161,16 +359,53 @@ void GerberGenerator::exportToGerber(const QString & prefix, const QString & exp
 
 }
 
-int GerberGenerator::doCopper(ItemBase * board, PCBSketchWidget * sketchWidget, LayerList & viewLayerIDs, const QString & copperName, const QString & copperSuffix, const QString & filename, const QString & exportDir, bool displayMessageBoxes)
+GerberGenerator::GerberLayer::GerberLayer(ItemBase * board, const QString & svg, const QString & clipName, const QString & layerName, SVG2gerber::ForWhy forWhy, const QString & suffix)
+	: svg(svg), clipName(clipName), layerName(layerName), forWhy(forWhy), suffix(suffix)
+{
+	boardRect = board->sceneBoundingRect();
+	boardRect.moveTo(0, 0);
+	svgSize = TextUtils::parseForWidthAndHeight(svg);
+}
+
+void GerberGenerator::convertLayers(QList<GerberLayer *> layers, const QString & prefix, GerberOutput * output, int boardLayers, bool displayMessageBoxes)
+{
+	// runs on the thread pool, so it reads nothing from the sketch but the connectors to treat as circles
+	QString previous;
+	Q_FOREACH (GerberLayer * layer, layers) {
+		Tracer::Scope tracing("gerber.layer", layer->layerName);
+		QElapsedTimer timer;
+		timer.start();
+		QString clipString = layer->clipToPrevious ? previous : layer->clipString;
+		QString svg = clipToBoard(layer->svg, layer->boardRect, layer->clipName, layer->forWhy, clipString, displayMessageBoxes, layer->treatAsCircle);
+		previous = svg;
+		if (svg.isEmpty()) {
+			if (!layer->failureMessage.isEmpty()) displayMessage(layer->failureMessage, displayMessageBoxes);
+			continue;
+		}
+
+		QSizeF svgSize = layer->sizeFromClipped ? TextUtils::parseForWidthAndHeight(svg) : layer->svgSize;
+		layer->invalidCount = doEnd(svg, boardLayers, layer->layerName, layer->forWhy, svgSize * GraphicsUtils::StandardFritzingDPI, *output, prefix, layer->suffix, displayMessageBoxes, layer->bytes);
+		layer->convertNs = timer.nsecsElapsed();
+	}
+}
+
+GerberGenerator::GerberLayer * GerberGenerator::doCopper(ItemBase * board, PCBSketchWidget * sketchWidget, LayerList & viewLayerIDs, const QString & copperName, const QString & copperSuffix, bool displayMessageBoxes, RenderFragments & fragments)
 {
 	bool empty;
-	QString svg = renderTo(viewLayerIDs, board, sketchWidget, empty);
+	QString svg = renderTo(viewLayerIDs, board, sketchWidget, empty, fragments);
 	if (empty || svg.isEmpty()) {
 		displayMessage(QObject::tr("%1 layer export is empty.").arg(copperName), displayMessageBoxes);
-		return 0;
+		return nullptr;
 	}
 
-	QMultiHash<long, ConnectorItem *> treatAsCircle;
+	auto * layer = new GerberLayer(board, svg, copperName, copperName, SVG2gerber::ForCopper, copperSuffix);
+	collectTreatAsCircle(board, sketchWidget, layer->treatAsCircle);
+	layer->failureMessage = QObject::tr("%1 layer export is empty (case 2).").arg(copperName);
+	return layer;
+}
+
+void GerberGenerator::collectTreatAsCircle(ItemBase * board, PCBSketchWidget * sketchWidget, QMultiHash<long, ConnectorItem *> & treatAsCircle)
+{
 	Q_FOREACH (QGraphicsItem * item, sketchWidget->scene()->collidingItems(board)) {
 		auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
 		if (connectorItem == nullptr) continue;
@@ -179,124 +414,71 @@ int GerberGenerator::doCopper(ItemBase * board, PCBSketchWidget * sketchWidget,
 
 		treatAsCircle.insert(connectorItem->attachedToID(), connectorItem);
 	}
-
-	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svg);
-
-	svg = clipToBoard(svg, board, copperName, SVG2gerber::ForCopper, "", displayMessageBoxes, treatAsCircle);
-	if (svg.isEmpty()) {
-		displayMessage(QObject::tr("%1 layer export is empty (case 2).").arg(copperName), displayMessageBoxes);
-		return 0;
-	}
-
-	return doEnd(svg, sketchWidget->boardLayers(), copperName, SVG2gerber::ForCopper, svgSize * GraphicsUtils::StandardFritzingDPI, exportDir, filename, copperSuffix, displayMessageBoxes);
 }
 
-
-int GerberGenerator::doSilk(LayerList silkLayerIDs, const QString & silkName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes, const QString & clipString)
+GerberGenerator::GerberLayer * GerberGenerator::doSilk(LayerList silkLayerIDs, const QString & silkName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments & fragments)
 {
 
 	bool empty;
-	QString svgSilk = renderTo(silkLayerIDs, board, sketchWidget, empty);
+	QString svgSilk = renderTo(silkLayerIDs, board, sketchWidget, empty, fragments);
 	if (empty || svgSilk.isEmpty()) {
 		if (silkLayerIDs.contains(ViewLayer::Silkscreen1)) {
 			displayMessage(QObject::tr("silk layer %1 export is empty").arg(silkName), displayMessageBoxes);
 		}
-		return 0;
-	}
-
-	//QFile f(silkName + "original.svg");
-	//f.open(QFile::WriteOnly);
-	//QTextStream fs(&f);
-	//fs << svgSilk;
-	//f.close();
-
-	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svgSilk);
-
-	QMultiHash<long, ConnectorItem *> treatAsCircle;
-	svgSilk = clipToBoard(svgSilk, board, silkName, SVG2gerber::ForSilk, clipString, displayMessageBoxes, treatAsCircle);
-	if (svgSilk.isEmpty()) {
-		displayMessage(QObject::tr("silk export failure"), displayMessageBoxes);
-		return 0;
+		return nullptr;
 	}
 
-	//QFile f2(silkName + "clipped.svg");
-	//f2.open(QFile::WriteOnly);
-	//QTextStream fs2(&f2);
-	//fs2 << svgSilk;
-	//f2.close();
-
-	return doEnd(svgSilk, sketchWidget->boardLayers(), silkName, SVG2gerber::ForSilk, svgSize * GraphicsUtils::StandardFritzingDPI, exportDir, filename, gerberSuffix, displayMessageBoxes);
+	auto * layer = new GerberLayer(board, svgSilk, silkName, silkName, SVG2gerber::ForSilk, gerberSuffix);
+	layer->failureMessage = QObject::tr("silk export failure");
+	return layer;
 }
 
 
-int GerberGenerator::doDrill(ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes)
+GerberGenerator::GerberLayer * GerberGenerator::doDrill(ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments & fragments)
 {
 	LayerList drillLayerIDs;
 	drillLayerIDs << ViewLayer::drillLayers();
 
 	bool empty;
-	QString svgDrill = renderTo(drillLayerIDs, board, sketchWidget, empty);
+	QString svgDrill = renderTo(drillLayerIDs, board, sketchWidget, empty, fragments);
 	if (empty || svgDrill.isEmpty()) {
 		displayMessage(QObject::tr("exported drill file is empty"), displayMessageBoxes);
-		return 0;
+		return nullptr;
 	}
 
-	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svgDrill);
-	QMultiHash<long, ConnectorItem *> treatAsCircle;
-	Q_FOREACH (QGraphicsItem * item, sketchWidget->scene()->collidingItems(board)) {
-		auto * connectorItem = dynamic_cast<ConnectorItem *>(item);
-		if (connectorItem == nullptr) continue;
-		if (!connectorItem->isPath()) continue;
-		if (connectorItem->radius() == 0) continue;
-
-		treatAsCircle.insert(connectorItem->attachedToID(), connectorItem);
-	}
-
-	svgDrill = clipToBoard(svgDrill, board, "Copper0", SVG2gerber::ForDrill, "", displayMessageBoxes, treatAsCircle);
-	if (svgDrill.isEmpty()) {
-		displayMessage(QObject::tr("drill export failure"), displayMessageBoxes);
-		return 0;
-	}
-
-	return doEnd(svgDrill, sketchWidget->boardLayers(), "drill", SVG2gerber::ForDrill, svgSize * GraphicsUtils::StandardFritzingDPI, exportDir, filename, DrillSuffix, displayMessageBoxes);
+	auto * layer = new GerberLayer(board, svgDrill, "Copper0", "drill", SVG2gerber::ForDrill, DrillSuffix);
+	collectTreatAsCircle(board, sketchWidget, layer->treatAsCircle);
+	layer->failureMessage = QObject::tr("drill export failure");
+	return layer;
 }
 
-int GerberGenerator::doMask(LayerList maskLayerIDs, const QString &maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes, QString & clipString)
+GerberGenerator::GerberLayer * GerberGenerator::doMask(LayerList maskLayerIDs, const QString &maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments & fragments)
 {
 	// don't want these in the mask laqyer
 	QList<ItemBase *> copperLogoItems;
 	sketchWidget->hideCopperLogoItems(copperLogoItems);
 
 	bool empty;
-	QString svgMask = renderTo(maskLayerIDs, board, sketchWidget, empty);
+	QString svgMask = renderTo(maskLayerIDs, board, sketchWidget, empty, fragments);
 	sketchWidget->restoreItemVisibility(copperLogoItems);
 
 	if (empty || svgMask.isEmpty()) {
 		displayMessage(QObject::tr("exported mask layer %1 is empty").arg(maskName), displayMessageBoxes);
-		return 0;
+		return nullptr;
 	}
 
 	svgMask = TextUtils::expandAndFill(svgMask, "black", MaskClearanceMils * 2);
 	if (svgMask.isEmpty()) {
 		displayMessage(QObject::tr("%1 mask export failure (2)").arg(maskName), displayMessageBoxes);
-		return 0;
-	}
-
-	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svgMask);
-	QMultiHash<long, ConnectorItem *> treatAsCircle;
-
-	svgMask = clipToBoard(svgMask, board, maskName, SVG2gerber::ForMask, "", displayMessageBoxes, treatAsCircle);
-	if (svgMask.isEmpty()) {
-		displayMessage(QObject::tr("mask export failure"), displayMessageBoxes);
-		return 0;
+		return nullptr;
 	}
 
-	clipString = svgMask;
-
-	return doEnd(svgMask, sketchWidget->boardLayers(), maskName, SVG2gerber::ForMask, svgSize * GraphicsUtils::StandardFritzingDPI, exportDir, filename, gerberSuffix, displayMessageBoxes);
+	auto * layer = new GerberLayer(board, svgMask, maskName, maskName, SVG2gerber::ForMask, gerberSuffix);
+	layer->failureMessage = QObject::tr("mask export failure");
+	return layer;
 }
 
-int GerberGenerator::doPasteMask(LayerList maskLayerIDs, const QString &maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes)
+GerberGenerator::GerberLayer * GerberGenerator::doPasteMask(LayerList maskLayerIDs, const QString &maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments & fragments)
 {
 	// don't want these in the mask laqyer
 	QList<ItemBase *> copperLogoItems;
@@ -305,62 +487,54 @@ int GerberGenerator::doPasteMask(LayerList maskLayerIDs, const QString &maskName
 	sketchWidget->hideHoles(holes);
 
 	bool empty;
-	QString svgMask = renderTo(maskLayerIDs, board, sketchWidget, empty);
+	QString svgMask = renderTo(maskLayerIDs, board, sketchWidget, empty, fragments);
 	sketchWidget->restoreItemVisibility(copperLogoItems);
 	sketchWidget->restoreItemVisibility(holes);
 
 	if (empty || svgMask.isEmpty()) {
 		displayMessage(QObject::tr("exported paste mask layer is empty"), displayMessageBoxes);
-		return 0;
+		return nullptr;
 	}
 
 	svgMask = sketchWidget->makePasteMask(svgMask, board, GraphicsUtils::StandardFritzingDPI, maskLayerIDs);
-	if (svgMask.isEmpty()) return 0;
-
-	QSizeF svgSize = TextUtils::parseForWidthAndHeight(svgMask);
-	QMultiHash<long, ConnectorItem *> treatAsCircle;
-	svgMask = clipToBoard(svgMask, board, maskName, SVG2gerber::ForCopper, "", displayMessageBoxes, treatAsCircle);
-	if (svgMask.isEmpty()) {
-		displayMessage(QObject::tr("mask export failure"), displayMessageBoxes);
-		return 0;
-	}
+	if (svgMask.isEmpty()) return nullptr;
 
-	return doEnd(svgMask, sketchWidget->boardLayers(), maskName, SVG2gerber::ForCopper, svgSize * GraphicsUtils::StandardFritzingDPI, exportDir, filename, gerberSuffix, displayMessageBoxes);
+	auto * layer = new GerberLayer(board, svgMask, maskName, maskName, SVG2gerber::ForCopper, gerberSuffix);
+	layer->failureMessage = QObject::tr("mask export failure");
+	return layer;
 }
 
 int GerberGenerator::doEnd(const QString & svg, int boardLayers, const QString & layerName, SVG2gerber::ForWhy forWhy, QSizeF svgSize,
-                           const QString & exportDir, const QString & prefix, const QString & suffix, bool displayMessageBoxes)
+                           GerberOutput & output, const QString & prefix, const QString & suffix, bool displayMessageBoxes, qint64 & bytes)
 {
-	// create mask gerber from svg
+	// create mask gerber from svg; a filled copper layer runs to tens of megabytes, so the body is spooled rather than built in memory
 	SVG2gerber gerber;
-	int invalidCount = gerber.convert(svg, boardLayers == 2, layerName, forWhy, svgSize);
+	int invalidCount = gerber.convert(svg, boardLayers == 2, layerName, forWhy, svgSize, true);
 
-	saveEnd(layerName, exportDir, prefix, suffix, displayMessageBoxes, gerber);
+	saveEnd(layerName, output, prefix, suffix, displayMessageBoxes, gerber, bytes);
 
 	return invalidCount;
 }
 
-bool GerberGenerator::saveEnd(const QString & layerName, const QString & exportDir, const QString & prefix, const QString & suffix, bool displayMessageBoxes, SVG2gerber & gerber)
+bool GerberGenerator::saveEnd(const QString & layerName, GerberOutput & output, const QString & prefix, const QString & suffix, bool displayMessageBoxes, SVG2gerber & gerber, qint64 & bytes)
 {
-
-	QString outname = exportDir + "/" +  prefix + suffix;
-	QFile out(outname);
-	if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		displayMessage(QObject::tr("%1 layer: unable to save to '%2'").arg(layerName, outname), displayMessageBoxes);
-		return false;
+	bool written = output.write(prefix + suffix, [&gerber](QIODevice & device) { return gerber.write(device); }, bytes);
+	if (!written) {
+		displayMessage(QObject::tr("%1 layer: unable to save to '%2'").arg(layerName, output.location(prefix + suffix)), displayMessageBoxes);
 	}
-
-	QTextStream stream(&out);
-	stream << gerber.getGerber();
-	stream.flush();
-	out.close();
-	return true;
-
+	return written;
 }
 
 void GerberGenerator::displayMessage(const QString & message, bool displayMessageBoxes) {
 	// don't use QMessageBox if running conversion as a service
 	if (displayMessageBoxes) {
+		if (QThread::currentThread() != QCoreApplication::instance()->thread()) {
+			// a message box needs the GUI thread; it is shown once the layers are done
+			QMutexLocker locker(&PendingMessagesMutex);
+			PendingMessages << message;
+			return;
+		}
+
 		QMessageBox::warning(nullptr, QObject::tr("Fritzing"), message);
 		return;
 	}
@@ -368,6 +542,18 @@ void GerberGenerator::displayMessage(const QString & message, bool displayMessag
 	DebugDialog::debug(message);
 }
 
+void GerberGenerator::showPendingMessages(bool displayMessageBoxes) {
+	QStringList messages;
+	{
+		QMutexLocker locker(&PendingMessagesMutex);
+		messages = PendingMessages;
+		PendingMessages.clear();
+	}
+	Q_FOREACH (QString message, messages) {
+		displayMessage(message, displayMessageBoxes);
+	}
+}
+
 QString GerberGenerator::clipToBoard(QString svgString, ItemBase * board, const QString & layerName, SVG2gerber::ForWhy forWhy, const QString & clipString, bool displayMessageBoxes, QMultiHash<long, ConnectorItem *> & treatAsCircle) {
 	QRectF source = board->sceneBoundingRect();
 	source.moveTo(0, 0);
@@ -532,6 +718,14 @@ QString GerberGenerator::clipToBoard(QString svgString, QRectF & boardRect, cons
 	QSvgRenderer renderer(&reader);
 	bool anyClipped = false;
 	if (forWhy != SVG2gerber::ForOutline) {
+		// straight-edged shapes crossing the board edge are clipped as outlines;
+		// silk is left to the raster, which also checks it against the mask
+		static const QStringList Clippable = { "path", "polygon", "polyline", "line", "rect" };
+		bool geometric = clipString.isEmpty() && forWhy != SVG2gerber::ForDrill;
+		QDomDocument shapeDocument;
+		CopperGeometry geometry;
+		QHash<QString, int> shapeIDs;
+		bool shapesAdded = false;
 		for (int i = 0; i < transformCount1; i++) {
 			QString n = QString::number(i);
 			QRectF bounds = renderer.boundsOnElement(n);
@@ -540,6 +734,38 @@ QString GerberGenerator::clipToBoard(QString svgString, QRectF & boardRect, cons
 			QRectF mBounds = m.mapRect(bounds);
 			const double unknownMargin = 0.1;
 			if (mBounds.left() < sourceRes.left() - unknownMargin || mBounds.top() < sourceRes.top() - unknownMargin || mBounds.right() > sourceRes.right() + unknownMargin || mBounds.bottom() > sourceRes.bottom() + unknownMargin) {
+				if (geometric && Clippable.contains(element.tagName())) {
+					if (!shapesAdded) {
+						// outlines come from a copy so the attributes marking them stay out of the gerber svg
+						shapesAdded = true;
+						shapeDocument = domDocument1.cloneNode(true).toDocument();
+						QDomElement shapeRoot = shapeDocument.documentElement();
+						geometry.addShapes(shapeRoot);
+						QDomNodeList elements = shapeDocument.elementsByTagName("*");
+						for (int e = 0; e < elements.count(); e++) {
+							QDomElement shapeElement = elements.at(e).toElement();
+							int shape = CopperGeometry::shapeIndex(shapeElement);
+							if (shape >= 0 && shapeElement.hasAttribute("id")) {
+								shapeIDs.insert(shapeElement.attribute("id"), shape);
+							}
+						}
+					}
+
+					// a nested svg's viewBox scaling is not in the outline
+					bool nested = false;
+					for (QDomNode parent = element.parentNode(); !parent.isNull() && parent != root1; parent = parent.parentNode()) {
+						if (parent.toElement().tagName() == "svg") {
+							nested = true;
+							break;
+						}
+					}
+
+					if (!nested && shapeIDs.contains(n) && clipElement(element, geometry.shapes().at(shapeIDs.value(n)).outline, sourceRes)) {
+						anyClipped = true;
+						continue;
+					}
+				}
+
 				if (element.tagName() == "circle") {
 					possibleHoles.append(element);
 				}
@@ -847,6 +1073,50 @@ void GerberGenerator::mergeOutlineElement(QImage & image, QRectF & target, doubl
 	}
 }
 
+bool GerberGenerator::clipElement(QDomElement & element, const QPainterPath & outline, const QRectF & clip) {
+	// replaces element with its outline clipped to clip, as filled polygons in root units;
+	// returns false, leaving element alone, when the pieces would need holes
+
+	QPainterPath clipPath;
+	clipPath.addRect(clip);
+	QList<QPolygonF> polygons = outline.intersected(clipPath).toSubpathPolygons();
+	for (int i = 0; i < polygons.count(); i++) {
+		QRectF bounds = polygons.at(i).boundingRect();
+		for (int j = i + 1; j < polygons.count(); j++) {
+			if (bounds.intersects(polygons.at(j).boundingRect())) {
+				// a hole, or pieces the gerber region might merge wrongly
+				return false;
+			}
+		}
+	}
+
+	QDomDocument document = element.ownerDocument();
+	QDomElement root = document.documentElement();
+	Q_FOREACH (QPolygonF polygon, polygons) {
+		int count = polygon.count();
+		if (count > 1 && polygon.first() == polygon.last()) count--;
+		if (count < 3) continue;
+
+		// one subpath per path element, since gerber can't take several
+		QString d;
+		for (int p = 0; p < count; p++) {
+			d += QString("%1%2,%3 ").arg(p == 0 ? "M" : "L").arg(polygon.at(p).x(), 0, 'f', 3).arg(polygon.at(p).y(), 0, 'f', 3);
+		}
+		d += "Z";
+
+		QDomElement path = document.createElement("path");
+		path.setAttribute("fill", "black");
+		path.setAttribute("stroke", "none");
+		path.setAttribute("stroke-width", 0);
+		path.setAttribute("d", d);
+		root.appendChild(path);
+	}
+
+	// the element keeps its tag name so its twin in the raster document is dropped
+	element.parentNode().removeChild(element);
+	return true;
+}
+
 QString GerberGenerator::makePath(QImage & image, double unit, const QString & colorString)
 {
 	double halfUnit = unit / 2;
@@ -998,7 +1268,7 @@ QString checkMountTechnology(const QString &package)
 	return "SMT";
 }
 
-void GerberGenerator::exportPickAndPlace(const QString & prefix, const QString & exportDir, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes)
+void GerberGenerator::exportPickAndPlace(const QString & prefix, GerberOutput & output, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes)
 {
 	QPointF bottomLeft = board->sceneBoundingRect().bottomLeft();
 	QSet<ItemBase *> itemBases;
@@ -1015,17 +1285,12 @@ void GerberGenerator::exportPickAndPlace(const QString & prefix, const QString &
 		itemBases.insert(itemBase->layerKinChief());
 	}
 
-	QString outname = exportDir + "/" + prefix + GerberGenerator::PickAndPlaceSuffix;
-	QFile out(outname);
-	if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
-		displayMessage(QObject::tr("Unable to save pick and place file: %2").arg(outname), displayMessageBoxes);
-		return;
-	}
-
 	QStringList valueKeys;
 	valueKeys << "resistance" << "capacitance" << "inductance" << "voltage"  << "current" << "power" << "mpn" << "mn";
 
-	QTextStream stream(&out);
+	// the list is small, so it is put together first and then saved in one go
+	QString text;
+	QTextStream stream(&text);
 	stream << "# Pick And Place List\n"
 		   << "# Company=\n"
 		   << "# Author=\n"
@@ -1089,10 +1354,15 @@ void GerberGenerator::exportPickAndPlace(const QString & prefix, const QString &
 					.arg(itemBase->viewLayerPlacement() == ViewLayer::NewTop ? "Top" : "Bottom")
 					.arg(mount);
 		stream << string;
-		stream.flush();
 	}
+	stream.flush();
 
-	out.close();
+	QString fileName = prefix + GerberGenerator::PickAndPlaceSuffix;
+	qint64 bytes;
+	QByteArray data = text.toUtf8();
+	if (!output.write(fileName, [&data](QIODevice & device) { return device.write(data) == data.size(); }, bytes)) {
+		displayMessage(QObject::tr("Unable to save pick and place file: %1").arg(output.location(fileName)), displayMessageBoxes);
+	}
 }
 
 void GerberGenerator::handleDonuts(QDomElement & root1, QMultiHash<long, ConnectorItem *> & treatAsCircle) {
@@ -1165,8 +1435,23 @@ void GerberGenerator::handleDonuts(QDomElement & root1, QMultiHash<long, Connect
 	}
 }
 
-QString GerberGenerator::renderTo(const LayerList & layers, ItemBase * board, PCBSketchWidget * sketchWidget, bool & empty) {
+QString GerberGenerator::checksMessage(const QList<long> & missingPaintIDs, int donuts) {
+	QStringList problems;
+	if (missingPaintIDs.count() > 0) {
+		problems << QObject::tr("%n part(s) with <path> elements missing stroke/fill/stroke-width attributes", "", missingPaintIDs.count());
+	}
+	if (donuts > 0) {
+		problems << QObject::tr("%n possible donut connector(s)", "", donuts);
+	}
+	if (problems.isEmpty()) return QString();
+
+	return QObject::tr("The export found %1; check these in the Gerber files.").arg(problems.join(QObject::tr(" and ")));
+}
+
+QString GerberGenerator::renderTo(const LayerList & layers, ItemBase * board, PCBSketchWidget * sketchWidget, bool & empty, RenderFragments & fragments) {
 	RenderThing renderThing;
+	renderThing.fragments = &fragments;
+	renderThing.cache = sketchWidget->renderCache(RenderCacheName);
 	renderThing.printerScale = GraphicsUtils::SVGDPI;
 	renderThing.blackOnly = true;
 	renderThing.dpi = GraphicsUtils::StandardFritzingDPI;
@@ -21,20 +21,72 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef GERBERGENERATOR_H
 #define GERBERGENERATOR_H
 
+#include <QIODevice>
+#include <QList>
+#include <QMultiHash>
+#include <QMutex>
+#include <QPainterPath>
+#include <QRectF>
+#include <QSizeF>
 #include <QString>
 
+#include <functional>
+#include <memory>
+
 #include "../viewlayer.h"
+#include "../sketch/renderthing.h"
 #include "svg2gerber.h"
 
+class QuaZip;
+
+struct GerberLayerMetrics {
+	QString layerName;
+	QString fileName;                               // prefix and suffix, in the export folder
+	qint64 renderNs = 0;                            // on the GUI thread
+	qint64 convertNs = 0;                           // clipping, conversion and saving, on the thread pool
+	qint64 bytes = 0;                               // of the saved file
+};
+
+struct GerberMetrics {
+	QList<GerberLayerMetrics> layers;             // the layers that were exported
+	qint64 renderNs = 0;
+	qint64 convertNs = 0;                           // wall time of the concurrent conversions
+	QList<long> missingPaintIDs;                    // items with a <path> lacking stroke, fill and stroke-width
+	QList<long> donutIDs;                           // parts with path connectors on both copper layers
+	int donuts = 0;
+};
+
+class GerberOutput
+{
+	// where an export's files go: a folder, or one zip that each file streams into as it is finished;
+	// files may be written from several threads, and zip entries are written one at a time
+
+public:
+	explicit GerberOutput(const QString & exportDir = QString());
+	~GerberOutput();
+
+	bool openZip(const QString & zipPath);
+	bool closeZip();
+	bool write(const QString & fileName, const std::function<bool (QIODevice &)> & writer, qint64 & bytes);
+	QString location(const QString & fileName) const;
+
+protected:
+	QString m_exportDir;
+	QString m_zipPath;
+	std::unique_ptr<QuaZip> m_zip;
+	QMutex m_mutex;
+};
+
 class GerberGenerator
 {
 
 public:
-	static void exportToGerber(const QString & prefix, const QString & exportDir, class ItemBase * board, class PCBSketchWidget *, bool displayMessageBoxes);
+	static void exportToGerber(const QString & prefix, const QString & exportDir, class ItemBase * board, class PCBSketchWidget *, bool displayMessageBoxes, GerberMetrics * = nullptr);
+	static bool exportToGerberZip(const QString & prefix, const QString & zipPath, class ItemBase * board, class PCBSketchWidget *, bool displayMessageBoxes, GerberMetrics * = nullptr);
 	static QString clipToBoard(QString svgString, QRectF & boardRect, const QString & layerName, SVG2gerber::ForWhy, const QString & clipString, bool displayMessageBoxes, QMultiHash<long, class ConnectorItem *> & treatAsCircle);
 	static QString clipToBoard(QString svgString, ItemBase * board, const QString & layerName, SVG2gerber::ForWhy, const QString & clipString, bool displayMessageBoxes, QMultiHash<long, class ConnectorItem *> & treatAsCircle);
 	static int doEnd(const QString & svg, int boardLayers, const QString & layerName, SVG2gerber::ForWhy forWhy, QSizeF svgSize,
-	                 const QString & exportDir, const QString & prefix, const QString & suffix, bool displayMessageBoxes);
+	                 GerberOutput &, const QString & prefix, const QString & suffix, bool displayMessageBoxes, qint64 & bytes);
 	static QString cleanOutline(const QString & svgOutline);
 
 public:
@@ -54,20 +106,50 @@ public:
 	static const double MaskClearanceMils;
 
 protected:
-	static int doSilk(LayerList silkLayerIDs, const QString & silkName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes, const QString & clipString);
-	static int doMask(LayerList maskLayerIDs, const QString & maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes, QString & clipString);
-	static int doPasteMask(LayerList maskLayerIDs, const QString & maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes);
-	static int doCopper(ItemBase * board, PCBSketchWidget * sketchWidget, LayerList & viewLayerIDs, const QString & copperName, const QString & copperSuffix, const QString & filename, const QString & exportDir, bool displayMessageBoxes);
-	static int doDrill(ItemBase * board, PCBSketchWidget * sketchWidget, const QString & filename, const QString & exportDir, bool displayMessageBoxes);
+	struct GerberLayer {
+		// a rendered layer waiting to be clipped, converted and saved off the GUI thread
+		GerberLayer(ItemBase * board, const QString & svg, const QString & clipName, const QString & layerName, SVG2gerber::ForWhy, const QString & suffix);
+
+		QString svg;
+		QString clipName;                               // the layer name clipToBoard gets
+		QString layerName;                              // the layer name doEnd gets
+		SVG2gerber::ForWhy forWhy;
+		QString suffix;
+		QString clipString;
+		QString failureMessage;                         // shown when clipping leaves nothing
+		QMultiHash<long, class ConnectorItem *> treatAsCircle;
+		QRectF boardRect;
+		QSizeF svgSize;
+		bool sizeFromClipped = false;                   // size the gerber from the clipped svg rather than the rendered one
+		bool clipToPrevious = false;                    // clip by the previous layer of the same task
+		int invalidCount = 0;
+		qint64 renderNs = 0;
+		qint64 convertNs = 0;
+		qint64 bytes = 0;
+	};
+
+	static GerberLayer * doSilk(LayerList silkLayerIDs, const QString & silkName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments &);
+	static GerberLayer * doMask(LayerList maskLayerIDs, const QString & maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments &);
+	static GerberLayer * doPasteMask(LayerList maskLayerIDs, const QString & maskName, const QString & gerberSuffix, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments &);
+	static GerberLayer * doCopper(ItemBase * board, PCBSketchWidget * sketchWidget, LayerList & viewLayerIDs, const QString & copperName, const QString & copperSuffix, bool displayMessageBoxes, RenderFragments &);
+	static GerberLayer * doDrill(ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes, RenderFragments &);
+	static void collectTreatAsCircle(ItemBase * board, PCBSketchWidget * sketchWidget, QMultiHash<long, ConnectorItem *> & treatAsCircle);
+	static void exportToOutput(const QString & prefix, GerberOutput &, ItemBase * board, PCBSketchWidget *, bool displayMessageBoxes, GerberMetrics *);
+	static void convertLayers(QList<GerberLayer *> layers, const QString & prefix, GerberOutput *, int boardLayers, bool displayMessageBoxes);
+	static void showPendingMessages(bool displayMessageBoxes);
 	static void displayMessage(const QString & message, bool displayMessageBoxes);
-	static bool saveEnd(const QString & layerName, const QString & exportDir, const QString & prefix, const QString & suffix, bool displayMessageBoxes, SVG2gerber & gerber);
+	static bool saveEnd(const QString & layerName, GerberOutput &, const QString & prefix, const QString & suffix, bool displayMessageBoxes, SVG2gerber & gerber, qint64 & bytes);
 	static void mergeOutlineElement(QImage & image, QRectF & target, double res, QDomDocument & document, QString & svgString, int ix, const QString & layerName);
 	static QString makePath(QImage & image, double unit, const QString & colorString);
+	static bool clipElement(QDomElement & element, const QPainterPath & outline, const QRectF & clip);
 	static bool dealWithMultipleContours(QDomElement & root, bool displayMessageBoxes);
-	static void exportPickAndPlace(const QString & prefix, const QString & exportDir, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes);
+	static void exportPickAndPlace(const QString & prefix, GerberOutput &, ItemBase * board, PCBSketchWidget * sketchWidget, bool displayMessageBoxes);
 	static void handleDonuts(QDomElement & root1, QMultiHash<long, ConnectorItem *> & treatAsCircle);
-	static QString renderTo(const LayerList &, ItemBase * board, PCBSketchWidget * sketchWidget, bool & empty);
+	static QString renderTo(const LayerList &, ItemBase * board, PCBSketchWidget * sketchWidget, bool & empty, RenderFragments &);
+	static QString checksMessage(const QList<long> & missingPaintIDs, int donuts);
 
+protected:
+	static const QString RenderCacheName;          // the sketch widget's RenderCache kept for gerber exports
 };
 
 #endif // GERBERGENERATOR_H
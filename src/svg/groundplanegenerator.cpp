@@ -20,17 +20,23 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "groundplanegenerator.h"
 #include "svgfilesplitter.h"
+#include "outlinetracer.h"
 #include "../fsvgrenderer.h"
 #include "../debugdialog.h"
 #include "../version/version.h"
 #include "../utils/folderutils.h"
 #include "../utils/graphicsutils.h"
 #include "../utils/textutils.h"
+#include "../utils/settingscache.h"
 #include "../items/wire.h"
 #include "../processeventblocker.h"
 #include "../autoroute/drc.h"
+#include "../autoroute/drcgeometry.h"
+#include "../autoroute/boardmaskcache.h"
 
 #include <QBitArray>
+#include <QMetaMethod>
+#include <QPainterPathStroker>
 #include <QPainter>
 #include <QSvgRenderer>
 #include <QDate>
@@ -41,7 +47,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <boost/math/special_functions/relative_difference.hpp>
 using boost::math::epsilon_difference;
 
+#include <algorithm>
 #include <limits>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
 // factor for epsion to compare floating point numbers
@@ -50,8 +58,15 @@ static constexpr double reldif = 5.0;
 
 static constexpr double BORDERINCHES = 0.04;
 
+static constexpr int TraceBandRows = 128;
+
 const QString GroundPlaneGenerator::KeepoutSettingName("GPG_Keepout");
 const double GroundPlaneGenerator::KeepoutDefaultMils = 10;
+const QString GroundPlaneGenerator::VectorSettingName("GPG_Vector");
+const QString GroundPlaneGenerator::PathOutputSettingName("GPG_PathOutput");
+
+// vector fill coordinates are tenths of a mil
+static constexpr double VectorUnitsPerInch = 10000;
 
 inline int OFFSET(int x, int y, QImage * image) {
 	return (y * image->width()) + x;
@@ -69,6 +84,9 @@ GroundPlaneGenerator::GroundPlaneGenerator()
 {
 	m_strokeWidthIncrement = 0;
 	m_minRiseSize = m_minRunSize = 1;
+
+	m_vector = SettingsCache::boolValue(VectorSettingName, true);
+	m_pathOutput = SettingsCache::boolValue(PathOutputSettingName, true);
 }
 
 GroundPlaneGenerator::~GroundPlaneGenerator() {
@@ -248,6 +266,17 @@ bool GroundPlaneGenerator::generateGroundPlaneUnit(const QString & boardSvg, QSi
 bool GroundPlaneGenerator::generateGroundPlane(const QString & boardSvg, QSizeF boardImageSize, const QString & svg, QSizeF copperImageSize,
 		QStringList & exceptions, QGraphicsItem * board, double res, const QString & color, double keepoutMils)
 {
+	QFuture<bool> future = startGroundPlane(boardSvg, boardImageSize, svg, copperImageSize, exceptions, board, res, color, keepoutMils);
+	while (!future.isFinished()) {
+		ProcessEventBlocker::processEvents(200);
+	}
+	return future.result();
+}
+
+QFuture<bool> GroundPlaneGenerator::startGroundPlane(const QString & boardSvg, QSizeF boardImageSize, const QString & svg, QSizeF copperImageSize,
+		QStringList & exceptions, QGraphicsItem * board, double res, const QString & color, double keepoutMils)
+{
+	// runs on the thread pool; the new svgs are ready once the future is finished
 	GPGParams params;
 	params.boardSvg = boardSvg;
 	params.keepoutMils = keepoutMils;
@@ -263,14 +292,21 @@ bool GroundPlaneGenerator::generateGroundPlane(const QString & boardSvg, QSizeF
 #else
 	QFuture<bool> future = QtConcurrent::run(&GroundPlaneGenerator::generateGroundPlaneFn, this, params);
 #endif
-	while (!future.isFinished()) {
-		ProcessEventBlocker::processEvents(200);
-	}
-	return future.result();
+	return future;
 }
 
 bool GroundPlaneGenerator::generateGroundPlaneFn(const GPGParams &constParams)
 {
+	if (!m_dirty.isNull()) {
+		// a refill only stitches vector fill into the old fill; on false the caller falls back to a full fill
+		return m_vector && refillVectorGroundPlane(constParams);
+	}
+
+	// ground fill seeds are bridged to the fill by looking at the images, so they keep the raster path
+	if (m_vector && !isSignalConnected(QMetaMethod::fromSignal(&GroundPlaneGenerator::postImageSignal))) {
+		if (generateVectorGroundPlane(constParams)) return true;
+	}
+
 	GPGParams params = constParams;
 	double bWidth, bHeight;
 	QList<QRectF> rects;
@@ -296,14 +332,223 @@ bool GroundPlaneGenerator::generateGroundPlaneFn(const GPGParams &constParams)
 	return true;
 }
 
-QImage * GroundPlaneGenerator::generateGroundPlaneAux(GPGParams & params, double & bWidth, double & bHeight, QList<QRectF> & rects)
+bool GroundPlaneGenerator::generateVectorGroundPlane(const GPGParams & params)
+{
+	// the board less its border, less the copper grown by keepout, with polygon booleans on the svgs' own outlines;
+	// false when either svg draws something with no outline here, like text or an image, so the caller rasterizes instead
+	QPainterPath fill;
+	if (!vectorFill(params, QRectF(), fill)) return false;
+
+	makeVectorPieces(params, fill);
+	DebugDialog::debug(QString("vector ground fill: %1 pieces").arg(m_newSVGs.count()));
+	return true;
+}
+
+bool GroundPlaneGenerator::refillVectorGroundPlane(const GPGParams & params)
 {
+	// new fill inside the dirty region, the old fill outside it; only the old pieces that reach the region are redone,
+	// the rest are left as they are. The fill is computed a little past the region so its edges match a full fill
+	double margin = params.keepoutMils + 1;
+	if (m_minRunSize > 1) margin += m_minRunSize * GraphicsUtils::StandardFritzingDPI / params.res;
+	QPainterPath fill;
+	if (!vectorFill(params, m_dirty.adjusted(-margin, -margin, margin, margin), fill)) return false;
+
+	QPainterPath dirty;
+	dirty.addRect(m_dirty);
+	QPainterPath touching;
+	touching.addRect(m_dirty.adjusted(-1, -1, 1, 1));           // old pieces which the new fill might join
+	QList<QPainterPath> paths;
+	for (int i = 0; i < m_oldSVGs.count() && i < m_oldOffsets.count(); i++) {
+		QPainterPath old = fillOutline(m_oldSVGs.at(i), m_oldOffsets.at(i));
+		if (old.isEmpty()) return false;
+		if (!old.intersects(touching)) continue;
+
+		m_replaced.append(i);
+		paths.append(old.subtracted(dirty));
+	}
+	paths.append(fill.intersected(dirty));
+
+	makeVectorPieces(params, uniteAll(paths));
+	DebugDialog::debug(QString("vector ground refill: %1 pieces replaced by %2").arg(m_replaced.count()).arg(m_newSVGs.count()));
+	return true;
+}
+
+bool GroundPlaneGenerator::vectorFill(const GPGParams & params, const QRectF & window, QPainterPath & fill)
+{
+	// in mils from the board's top left; with a window, only the fill inside it is computed
 	QByteArray boardByteArray;
 	QString tempColor("#ffffff");
-	if (!SvgFileSplitter::changeColors(params.boardSvg, tempColor, params.exceptions, boardByteArray)) {
-		return nullptr;
+	QStringList exceptions = params.exceptions;
+	if (!SvgFileSplitter::changeColors(params.boardSvg, tempColor, exceptions, boardByteArray)) {
+		return false;
+	}
+
+	QDomDocument boardDoc;
+	if (!boardDoc.setContent(boardByteArray)) return false;
+	QDomElement boardRoot = boardDoc.documentElement();
+	CopperGeometry boardGeometry;
+	boardGeometry.addShapes(boardRoot);
+	if (!boardGeometry.allVector()) return false;
+
+	// paint the board in document order, as the raster path does: white is board, anything else cuts it away
+	QPainterPath board;
+	board.setFillRule(Qt::WindingFill);
+	Q_FOREACH (CopperShape shape, boardGeometry.shapes()) {
+		board = (shape.color == tempColor) ? board.united(shape.outline) : board.subtracted(shape.outline);
 	}
+	if (board.isEmpty()) return false;
+
+	QPainterPathStroker stroker;
+	stroker.setCapStyle(Qt::RoundCap);
+	stroker.setJoinStyle(Qt::RoundJoin);
+	stroker.setWidth(2 * BORDERINCHES * GraphicsUtils::StandardFritzingDPI);
+	board = board.subtracted(stroker.createStroke(board));
+	if (!window.isNull()) {
+		QPainterPath windowPath;
+		windowPath.addRect(window);
+		board = board.intersected(windowPath);
+	}
+
+	// copper strokes widened by twice the keepout, as for the raster path
+	QDomDocument copperDoc;
+	if (!copperDoc.setContent(params.svg)) return false;
+	QDomElement copperRoot = copperDoc.documentElement();
+	SvgFileSplitter::forceStrokeWidth(copperRoot, 2 * params.keepoutMils, "#000000", true, false);
+	CopperGeometry copperGeometry;
+	copperGeometry.addShapes(copperRoot);
+	if (!copperGeometry.allVector()) return false;
 
+	QList<QPainterPath> outlines;
+	Q_FOREACH (CopperShape shape, copperGeometry.shapes()) {
+		if (!window.isNull() && !shape.bounds.intersects(window)) continue;
+
+		outlines.append(shape.outline);
+	}
+	fill = board.subtracted(uniteAll(outlines));
+
+	if (m_minRunSize > 1) {
+		// drop necks narrower than the raster path's shortest run: shrink by half of it, then grow back
+		double minWidth = m_minRunSize * GraphicsUtils::StandardFritzingDPI / params.res;
+		stroker.setWidth(minWidth);
+		QPainterPath shrunk = fill.subtracted(stroker.createStroke(fill));
+		fill = shrunk.united(stroker.createStroke(shrunk)).intersected(fill);
+	}
+
+	return true;
+}
+
+void GroundPlaneGenerator::makeVectorPieces(const GPGParams & params, const QPainterPath & fill)
+{
+	QRectF br = params.board->sceneBoundingRect();
+	double bWidth = params.res * br.width() / GraphicsUtils::SVGDPI;
+	double bHeight = params.res * br.height() / GraphicsUtils::SVGDPI;
+	double pixelFactor = VectorUnitsPerInch / params.res;
+	QList< QList<QPolygon> > pieces = vectorPieces(fill, VectorUnitsPerInch / GraphicsUtils::StandardFritzingDPI);
+	for (int i = 0; i < pieces.count(); i++) {
+		makePolySvg(pieces[i], params.res, bWidth, bHeight, pixelFactor, params.color, true, true, QSizeF(.05, .05), 1 / GraphicsUtils::SVGDPI, QPointF(0, 0));
+	}
+}
+
+QPainterPath GroundPlaneGenerator::fillOutline(const QString & svg, QPointF offset)
+{
+	// a fill piece's outline in mils from the board's top left; the offset is the piece's, in pixels
+	QDomDocument doc;
+	if (!doc.setContent(svg)) return QPainterPath();
+
+	QDomElement root = doc.documentElement();
+	QStringList viewBox = root.attribute("viewBox").split(" ", Qt::SkipEmptyParts);
+	if (viewBox.count() != 4 || viewBox.at(2).toDouble() <= 0) return QPainterPath();
+	double milsPerUnit = TextUtils::convertToInches(root.attribute("width")) * GraphicsUtils::StandardFritzingDPI / viewBox.at(2).toDouble();
+
+	CopperGeometry geometry;
+	geometry.addShapes(root);
+	QTransform transform;
+	transform.translate(offset.x() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI, offset.y() * GraphicsUtils::StandardFritzingDPI / GraphicsUtils::SVGDPI);
+	transform.scale(milsPerUnit, milsPerUnit);
+	return transform.map(geometry.area());
+}
+
+QPainterPath GroundPlaneGenerator::uniteAll(QList<QPainterPath> & paths)
+{
+	// pairwise, so each union works on paths of similar size rather than growing one path shape by shape
+	if (paths.isEmpty()) return QPainterPath();
+
+	while (paths.count() > 1) {
+		QList<QPainterPath> next;
+		for (int i = 0; i + 1 < paths.count(); i += 2) {
+			next.append(paths.at(i).united(paths.at(i + 1)));
+		}
+		if (paths.count() % 2 == 1) next.append(paths.last());
+		paths = next;
+	}
+	return paths.first();
+}
+
+QList< QList<QPolygon> > GroundPlaneGenerator::vectorPieces(const QPainterPath & fill, double unitsPerMil)
+{
+	// one polygon per connected piece of fill: its outer boundary, then each of its holes wound the other way
+	// and reached by a cut from the boundary, so it fills correctly as a single polygon, as in Gerber regions
+	QList<QPolygonF> loops = fill.toSubpathPolygons();
+	QVector<int> depths(loops.count(), 0);
+	QVector<double> areas(loops.count(), 0);
+	QVector<QRectF> bounds(loops.count());
+	for (int i = 0; i < loops.count(); i++) bounds[i] = loops.at(i).boundingRect();
+	for (int i = 0; i < loops.count(); i++) {
+		const QPolygonF & loop = loops.at(i);
+		for (int j = 0; j < loop.count(); j++) {
+			QPointF p0 = loop.at(j);
+			QPointF p1 = loop.at((j + 1) % loop.count());
+			areas[i] += (p0.x() * p1.y() - p1.x() * p0.y()) / 2;
+		}
+		if (loop.isEmpty()) continue;
+
+		for (int j = 0; j < loops.count(); j++) {
+			if (j == i || !bounds.at(j).contains(loop.first())) continue;
+			if (loops.at(j).containsPoint(loop.first(), Qt::OddEvenFill)) depths[i]++;
+		}
+	}
+
+	QList< QList<QPolygon> > pieces;
+	QHash<int, int> pieceIndexes;            // outer loop to piece
+	for (int i = 0; i < loops.count(); i++) {
+		if (depths.at(i) % 2 != 0 || loops.at(i).count() < 3) continue;
+
+		pieceIndexes.insert(i, pieces.count());
+		QPolygonF outer = loops.at(i);
+		if (areas.at(i) < 0) std::reverse(outer.begin(), outer.end());
+		QPolygon polygon;
+		Q_FOREACH (QPointF p, outer) polygon.append((p * unitsPerMil).toPoint());
+		if (polygon.first() != polygon.last()) polygon.append(polygon.first());
+		pieces.append(QList<QPolygon>() << polygon);
+	}
+
+	for (int i = 0; i < loops.count(); i++) {
+		if (depths.at(i) % 2 == 0 || loops.at(i).count() < 3) continue;
+
+		// the hole belongs to the innermost outer loop around it
+		int owner = -1;
+		Q_FOREACH (int o, pieceIndexes.keys()) {
+			if (depths.at(o) != depths.at(i) - 1) continue;
+			if (!loops.at(o).containsPoint(loops.at(i).first(), Qt::OddEvenFill)) continue;
+			owner = o;
+			break;
+		}
+		if (owner < 0) continue;
+
+		QPolygonF hole = loops.at(i);
+		if (areas.at(i) > 0) std::reverse(hole.begin(), hole.end());
+		QPolygon & polygon = pieces[pieceIndexes.value(owner)][0];
+		QPoint start = polygon.first();
+		Q_FOREACH (QPointF p, hole) polygon.append((p * unitsPerMil).toPoint());
+		polygon.append((hole.first() * unitsPerMil).toPoint());
+		polygon.append(start);
+	}
+
+	return pieces;
+}
+
+QImage * GroundPlaneGenerator::generateGroundPlaneAux(GPGParams & params, double & bWidth, double & bHeight, QList<QRectF> & rects)
+{
 
 	//QFile file0("testGroundFillBoard.svg");
 	//file0.open(QIODevice::WriteOnly);
@@ -342,24 +587,19 @@ QImage * GroundPlaneGenerator::generateGroundPlaneAux(GPGParams & params, double
 	bWidth = params.res * br.width() / GraphicsUtils::SVGDPI;
 	bHeight = params.res * br.height() / GraphicsUtils::SVGDPI;
 	auto * image = new QImage(qMax(svgWidth, bWidth), qMax(svgHeight, bHeight), QImage::Format_Mono); //
-	image->setDotsPerMeterX(params.res * GraphicsUtils::InchesPerMeter);
-	image->setDotsPerMeterY(params.res * GraphicsUtils::InchesPerMeter);
-	image->fill(0x0);
-
-	QSvgRenderer renderer(boardByteArray);
-	QPainter painter;
-	painter.begin(image);
-	painter.setRenderHint(QPainter::Antialiasing, false);
 	QRectF boardBounds(0, 0, params.res * params.boardImageSize.width() / GraphicsUtils::SVGDPI, params.res * params.boardImageSize.height() / GraphicsUtils::SVGDPI);
 	DebugDialog::debug("boardbounds", boardBounds);
-	renderer.render(&painter, boardBounds);
-	painter.end();
+	if (!BoardMaskCache::mask(params.boardSvg, params.exceptions, image->size(), boardBounds, BORDERINCHES * params.res, *image)) {
+		delete image;
+		return nullptr;
+	}
+	image->setDotsPerMeterX(params.res * GraphicsUtils::InchesPerMeter);
+	image->setDotsPerMeterY(params.res * GraphicsUtils::InchesPerMeter);
 
 #ifndef QT_NO_DEBUG
 	image->save(FolderUtils::getTopLevelUserDataStorePath() + "/testGroundFillBoard.png");
 #endif
 
-	DRC::extendBorder(BORDERINCHES * params.res, image);
 	GraphicsUtils::drawBorder(image, BORDERINCHES * params.res);
 
 	QImage boardImage = image->copy();
@@ -395,6 +635,7 @@ QImage * GroundPlaneGenerator::generateGroundPlaneAux(GPGParams & params, double
 #endif
 
 	QSvgRenderer renderer2(copperByteArray);
+	QPainter painter;
 	painter.begin(image);
 	painter.setRenderHint(QPainter::Antialiasing, false);
 	QRectF bounds(0, 0, params.res * params.copperImageSize.width() / GraphicsUtils::SVGDPI, params.res * params.copperImageSize.height() / GraphicsUtils::SVGDPI);
@@ -434,6 +675,60 @@ void GroundPlaneGenerator::scanImage(QImage & image, double bWidth, double bHeig
 }
 
 
+QFuture<void> GroundPlaneGenerator::startTrace(const QImage & image, double res, const QString & colorString, double simplifyTolerance)
+{
+	// traces a mono image in bands of rows on the thread pool; a polygon crossing a band boundary
+	// comes out as two which meet along the boundary. The future reports progress and can be
+	// canceled; once it is finished, finishTrace() makes the svg
+	m_traceImage = image;
+	m_traceRes = res;
+	m_traceColor = colorString;
+	m_traceBands.clear();
+	for (int top = 0; top < image.height(); top += TraceBandRows) {
+		TraceBand band;
+		band.top = top;
+		band.rows = qMin(TraceBandRows, image.height() - top);
+		m_traceBands.append(band);
+	}
+
+	return QtConcurrent::map(m_traceBands, [this, simplifyTolerance](TraceBand & band) {
+		traceBand(m_traceImage, band, simplifyTolerance);
+	});
+}
+
+void GroundPlaneGenerator::traceBand(const QImage & image, TraceBand & band, double simplifyTolerance)
+{
+	// runs on a worker thread
+	QImage bandImage = image.copy(0, band.top, image.width(), band.rows);
+	QList<QRect> rects;
+	scanLines(bandImage, bandImage.width(), bandImage.height(), rects);
+	QList< QList<int> * > pieces;
+	splitScanLines(rects, pieces);
+	Q_FOREACH (QList<int> * piece, pieces) {
+		QList<QRect> newRects;
+		Q_FOREACH (int i, *piece) {
+			QRect r = rects.at(i);
+			newRects.append(QRect(r.x(), r.y() + band.top, r.width() + 1, 2));    // + 1 is for off-by-one converting rects to polys
+		}
+		joinScanLines(newRects, band.polygons, simplifyTolerance);
+		delete piece;
+	}
+}
+
+void GroundPlaneGenerator::finishTrace()
+{
+	QList<QPolygon> polygons;
+	Q_FOREACH (TraceBand band, m_traceBands) {
+		polygons.append(band.polygons);
+	}
+	m_traceBands.clear();
+
+	if (!polygons.isEmpty()) {
+		makePolySvg(polygons, m_traceRes, m_traceImage.width(), m_traceImage.height(), 1, m_traceColor, false, false, QSizeF(0, 0), 0, QPointF(0, 0));
+	}
+	m_traceImage = QImage();
+}
+
 void GroundPlaneGenerator::scanLines(QImage & image, int bWidth, int bHeight, QList<QRect> & rects)
 {
 	Q_ASSERT(image.format() == QImage::Format_Mono);
@@ -630,7 +925,7 @@ void GroundPlaneGenerator::splitScanLines(QList<QRect> & rects, QList< QList<int
 	}
 }
 
-void GroundPlaneGenerator::joinScanLines(QList<QRect> & rects, QList<QPolygon> & polygons) {
+void GroundPlaneGenerator::joinScanLines(QList<QRect> & rects, QList<QPolygon> & polygons, double simplifyTolerance) {
 	QList< QList<int> * > pieces;
 	int ix = 0;
 	int prevFirst = -1;
@@ -738,6 +1033,7 @@ void GroundPlaneGenerator::joinScanLines(QList<QRect> & rects, QList<QPolygon> &
 			}
 			poly.append(QPoint(r.left(), r.bottom()));
 		}
+		int leftCount = poly.count();
 		// right side
 		for (int i = piece->length() - 1; i >= 0; i--) {
 			QRect r = rects.at(piece->at(i));
@@ -750,7 +1046,13 @@ void GroundPlaneGenerator::joinScanLines(QList<QRect> & rects, QList<QPolygon> &
 			poly.append(QPoint(r.right(), r.top()));
 		}
 
-
+		if (simplifyTolerance > 0) {
+			// other polygons only ever touch this one along its top and bottom edges, so
+			// simplifying each side between its corners opens no gaps
+			QPolygon right = OutlineTracer::simplifyPolyline(poly.mid(leftCount), simplifyTolerance);
+			poly = OutlineTracer::simplifyPolyline(poly.mid(0, leftCount), simplifyTolerance);
+			poly += right;
+		}
 
 		polygons.append(poly);
 		delete piece;
@@ -830,9 +1132,7 @@ QString GroundPlaneGenerator::makePolySvg(QList<QPolygon> & polygons, double res
 		makeConnector(polygons, res, pixelFactor, colorString, minX, minY, pSvg);
 	}
 	else {
-		Q_FOREACH (QPolygon poly, polygons) {
-			pSvg += makeOnePoly(poly, colorString, "", minX, minY);
-		}
+		pSvg += makePolys(polygons, colorString, "", minX, minY);
 	}
 
 	pSvg += "</g>\n</svg>\n";
@@ -895,9 +1195,7 @@ void GroundPlaneGenerator::makeConnector(QList<QPolygon> & polygons, double res,
 
 				if (!gotOne) continue;
 
-				Q_FOREACH (QPolygon poly, polygons) {
-					pSvg += makeOnePoly(poly, colorString, "", minX, minY);
-				}
+				pSvg += makePolys(polygons, colorString, "", minX, minY);
 
 				pSvg += QString("<g id='%1'><circle cx='%2' cy='%3' r='%4' fill='%5' stroke='none' stroke-width='0' /></g>\n")
 						.arg(ConnectorName)
@@ -937,11 +1235,20 @@ void GroundPlaneGenerator::makeConnector(QList<QPolygon> & polygons, double res,
 	}
 	if (useIndex < 0) {
 		pSvg += QString("<g id='%1'>\n").arg(ConnectorName);
-		Q_FOREACH (QPolygon poly, polygons) {
-			pSvg += makeOnePoly(poly, colorString, "", minX, minY);
-		}
+		pSvg += makePolys(polygons, colorString, "", minX, minY);
 		pSvg += "</g>";
 	}
+	else if (m_pathOutput) {
+		// has to appear inside a g element; the rest go in one path
+		pSvg += QString("<g id='%1'>\n").arg(ConnectorName);
+		pSvg += makePath(QList<QPolygon>() << polygons.at(useIndex), colorString, "", minX, minY);
+		pSvg += "</g>";
+		QList<QPolygon> others = polygons;
+		others.removeAt(useIndex);
+		if (others.count() > 0) {
+			pSvg += makePath(others, colorString, FSvgRenderer::NonConnectorName + "0", minX, minY);
+		}
+	}
 	else {
 		int ix = 0;
 		for (int i = 0; i < polygons.count(); i++) {
@@ -982,112 +1289,80 @@ QString GroundPlaneGenerator::makeOnePoly(const QPolygon & poly, const QString &
 	return polyString;
 }
 
-const QStringList & GroundPlaneGenerator::newSVGs() {
-	return m_newSVGs;
-}
-
-const QList<QPointF> & GroundPlaneGenerator::newOffsets() {
-	return m_newOffsets;
-}
-
-void removeRedundant(QList<QPoint> & points)
-{
-	QPoint current = points.last();
-	int ix = points.count() - 2;
-	int soFar = 1;
-	while (ix > 0) {
-		if (points.at(ix).x() != current.x()) {
-			current = points.at(ix--);
-			soFar = 1;
-			continue;
-		}
+QString GroundPlaneGenerator::makePolys(const QList<QPolygon> & polygons, const QString & colorString, const QString & id, int minX, int minY) {
+	if (m_pathOutput) return makePath(polygons, colorString, id, minX, minY);
 
-		if (++soFar > 2) {
-			points.removeAt(ix + 1);
-		}
-		ix--;
+	QString polys;
+	Q_FOREACH (QPolygon poly, polygons) {
+		polys += makeOnePoly(poly, colorString, id, minX, minY);
 	}
+	return polys;
 }
 
-bool GroundPlaneGenerator::collectBorderPoints(QImage & image, QList<QPoint> & points)
-{
-	// background is black
-
-	int currentX = 0, currentY = 0;
-	bool gotSomething = false;
+QString GroundPlaneGenerator::makePath(const QList<QPolygon> & polygons, const QString & colorString, const QString & id, int minX, int minY) {
+	// one path for all the polygons, in relative moves, which are mostly a few digits each;
+	// the polygons don't overlap, so the nonzero rule fills each of them whichever way it winds
+	int pointCount = 0;
+	Q_FOREACH (QPolygon poly, polygons) {
+		pointCount += poly.count();
+	}
 
-	for (int y = 0; y < image.height(); y++) {
-		for (int x = 0; x < image.width(); x++) {
-			QRgb current = image.pixel(x, y);
-			if (current != 0xffffffff) {
-				// another black pixel, keep moving
-				continue;
-			}
+	QString pathString;
+	pathString.reserve(128 + 8 * pointCount);
+	QTextStream stream(&pathString);
+	stream << "<path fill='" << colorString << "' stroke='none' stroke-width='0' ";
+	if (!id.isEmpty()) stream << "id='" << id << "' ";
+	stream << "d='";
 
-			currentX = x;
-			currentY = y;
-			//DebugDialog::debug(QString("first point %1 %2").arg(currentX).arg(currentY));
-			points.append(QPoint(currentX, currentY));
-			gotSomething = true;
-			break;
+	QPoint current(minX, minY);
+	bool first = true;
+	Q_FOREACH (QPolygon poly, polygons) {
+		int count = poly.count();
+		if (count > 1 && poly.first() == poly.last()) count--;         // z closes it
+		if (count < 2) continue;
+
+		QPoint start = poly.at(0);
+		stream << (first ? 'M' : 'm');
+		if (first) stream << start.x() - minX << ',' << start.y() - minY;
+		else stream << start.x() - current.x() << ',' << start.y() - current.y();
+		first = false;
+
+		current = start;
+		for (int i = 1; i < count; i++) {
+			QPoint p = poly.at(i);
+			if (p.y() == current.y()) stream << 'h' << p.x() - current.x();
+			else if (p.x() == current.x()) stream << 'v' << p.y() - current.y();
+			else stream << 'l' << p.x() - current.x() << ',' << p.y() - current.y();
+			current = p;
 		}
-		if (gotSomething) break;
-	}
-
-	if (!gotSomething) {
-		DebugDialog::debug("first border point not found");
-		return false;
+		stream << 'z';
+		current = start;
 	}
 
-	bool done = false;
-	long maxPoints = image.height() * image.width() / 2;
-	for (long inc = 0; inc < maxPoints; inc++) {
-		if (try8(currentX, currentY, image, points)) ;
-		else {
-			QPoint p = points.first();
-			if (qAbs(p.x() - currentX) < 4 && qAbs(p.y() - currentY) < 4) {
-				// we're near the beginning again
-				done = true;
-				break;
-			}
-
-			bool keepGoing = false;
-			for (int ix = points.count() - 2; ix >= 0; ix--) {
-				QPoint p = points.at(ix);
-				if (try8(p.x(), p.y(), image, points)) {
-					keepGoing = true;
-					break;
-				}
-			}
+	stream << "'/>\n";
+	stream.flush();
+	return pathString;
+}
 
-			if (!keepGoing) break;
-		}
+const QStringList & GroundPlaneGenerator::newSVGs() {
+	return m_newSVGs;
+}
 
-		QPoint p = points.last();
-		currentX = p.x();
-		currentY = p.y();
-		//DebugDialog::debug(QString("next point %1 %2").arg(currentX).arg(currentY));
-		//if (inc % 100 == 0) {
-		//DebugDialog::debug("\n");
-		//}
-	}
-	return done;
+const QList<QPointF> & GroundPlaneGenerator::newOffsets() {
+	return m_newOffsets;
 }
 
 void GroundPlaneGenerator::scanOutline(QImage & image, double bWidth, double bHeight, double pixelFactor, double res,
 									   const QString & colorString, bool makeConnectorFlag,
 									   bool makeOffset, QSizeF minAreaInches, double minDimensionInches)
 {
-	QList<QPoint> points;
-
-	bool result = collectBorderPoints(image, points);
-	if (points.count() == 0 || !result) {
+	// within half a pixel of the traced outline
+	QPolygon points = OutlineTracer::simplify(OutlineTracer::trace(image), 0.5);
+	if (points.count() < 3) {
 		DebugDialog::debug("no border points");
 		return;
 	}
 
-	removeRedundant(points);
-
 	QPolygon polygon;
 	Q_FOREACH(QPoint p, points) {
 		polygon.append(QPoint(p.x() * pixelFactor, p.y() * pixelFactor));
@@ -1107,105 +1382,6 @@ void GroundPlaneGenerator::scanOutline(QImage & image, double bWidth, double bHe
 }
 
 
-bool GroundPlaneGenerator::try8(int x, int y, QImage & image, QList<QPoint> & points) {
-	if (tryNextPoint(x, y + 1, image, points)) return true;
-	else if (tryNextPoint(x + 1, y, image, points)) return true;
-	else if (tryNextPoint(x, y - 1, image, points)) return true;
-	else if (tryNextPoint(x - 1, y, image, points)) return true;
-	else if (tryNextPoint(x + 1, y + 1, image, points)) return true;
-	else if (tryNextPoint(x - 1, y + 1, image, points)) return true;
-	else if (tryNextPoint(x + 1, y - 1, image, points)) return true;
-	else if (tryNextPoint(x - 1, y - 1, image, points)) return true;
-	return false;
-}
-
-bool GroundPlaneGenerator::tryNextPoint(int x, int y, QImage & image, QList<QPoint> & points)
-{
-	if (x < 0) return false;
-	if (y < 0) return false;
-	if (x >= image.width()) return false;
-	if (y >= image.height()) return false;
-
-	Q_FOREACH (QPoint p, points) {
-		if (p.x() == x && p.y() == y) {
-			// already visited
-			return false;
-		}
-
-		if (qAbs(p.x() - x) > 3 && qAbs(p.y() - y) > 3) {
-			// too far away from the start of the polygon
-			break;
-		}
-	}
-
-
-	for (int i = points.count() - 1; i >= 0; i--) {
-		QPoint p = points.at(i);
-		if (p.x() == x && p.y() == y) {
-			// already visited
-			return false;
-		}
-
-		if (qAbs(p.x() - x) > 3 && qAbs(p.y() - y) > 3) {
-			// too far away from from the current point
-			break;
-		}
-	}
-
-	QRgb pixel = image.pixel(x, y);
-	//DebugDialog::debug(QString("pixel %1,%2 %3").arg(x).arg(y).arg(pixel, 0, 16));
-	if (pixel != 0xffffffff) {
-		// empty pixel, not on the border
-		return false;
-	}
-
-	if (x + 1 == image.width()) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	pixel = image.pixel(x + 1, y);
-	if (pixel != 0xffffffff) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	if (y + 1 == image.height()) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	pixel = image.pixel(x, y + 1);
-	if (pixel != 0xffffffff) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	if (x - 1  < 0) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	pixel = image.pixel(x - 1, y);
-	if (pixel != 0xffffffff) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	if (y - 1  < 0) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	pixel = image.pixel(x, y - 1);
-	if (pixel != 0xffffffff) {
-		points.append(QPoint(x, y));
-		return true;
-	}
-
-	return false;
-}
-
 void GroundPlaneGenerator::setStrokeWidthIncrement(double swi) {
 	m_strokeWidthIncrement = swi;
 }
@@ -1223,6 +1399,17 @@ void GroundPlaneGenerator::setMinRunSize(int mrus, int mris) {
 	m_minRiseSize = mris;
 }
 
+void GroundPlaneGenerator::setRefill(const QStringList & oldSVGs, const QList<QPointF> & oldOffsets, const QRectF & dirtyMils) {
+	m_oldSVGs = oldSVGs;
+	m_oldOffsets = oldOffsets;
+	m_dirty = dirtyMils;
+	m_replaced.clear();
+}
+
+const QList<int> & GroundPlaneGenerator::replacedSVGs() {
+	return m_replaced;
+}
+
 QString GroundPlaneGenerator::mergeSVGs(const QString & initialSVG, const QString & layerName) {
 	QDomDocument doc;
 	if (!initialSVG.isEmpty()) {
@@ -28,8 +28,17 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QString>
 #include <QStringList>
 #include <QGraphicsItem>
+#include <QFuture>
+#include <QPainterPath>
+#include <QVector>
 
 
+struct TraceBand {
+	int top = 0;
+	int rows = 0;
+	QList<QPolygon> polygons;               // in image pixels
+};
+
 struct GPGParams {
 	QString boardSvg;
 	QSizeF boardImageSize;
@@ -51,6 +60,8 @@ public:
 
 	bool generateGroundPlane(const QString & boardSvg, QSizeF boardImageSize, const QString & svg, QSizeF copperImageSize, QStringList & exceptions,
 	                         QGraphicsItem * board, double res, const QString & color, double keepoutMils);
+	QFuture<bool> startGroundPlane(const QString & boardSvg, QSizeF boardImageSize, const QString & svg, QSizeF copperImageSize, QStringList & exceptions,
+	                               QGraphicsItem * board, double res, const QString & color, double keepoutMils);
 	bool generateGroundPlaneUnit(const QString & boardSvg, QSizeF boardImageSize, const QString & svg, QSizeF copperImageSize, QStringList & exceptions,
 	                             QGraphicsItem * board, double res, const QString & color, QPointF whereToStart, double keepoutMils);
 	void scanImage(QImage & image, double bWidth, double bHeight, double pixelFactor, double res,
@@ -67,6 +78,10 @@ public:
 	const QString & layerName();
 	void setMinRunSize(int minRunSize, int minRiseSize);
 	QString mergeSVGs(const QString & initialSVG, const QString & layerName);
+	void setRefill(const QStringList & oldSVGs, const QList<QPointF> & oldOffsets, const QRectF & dirtyMils);
+	const QList<int> & replacedSVGs();
+	QFuture<void> startTrace(const QImage & image, double res, const QString & colorString, double simplifyTolerance);
+	void finishTrace();
 
 public:
 	static QString ConnectorName;
@@ -76,7 +91,8 @@ Q_SIGNALS:
 
 protected:
 	void splitScanLines(QList<QRect> & rects, QList< QList<int> * > & pieces);
-	void joinScanLines(QList<QRect> & rects, QList<QPolygon> & polygons);
+	void joinScanLines(QList<QRect> & rects, QList<QPolygon> & polygons, double simplifyTolerance = 0);
+	void traceBand(const QImage & image, TraceBand &, double simplifyTolerance);
 	QString makePolySvg(QList<QPolygon> & polygons, double res, double bWidth, double bHeight, double pixelFactor, const QString & colorString,
 	                    bool makeConnectorFlag, QPointF * offset, QSizeF minAreaInches, double minDimensionInches, QPointF polygonOffset);
 	void makePolySvg(QList<QPolygon> & polygons, double res, double bWidth, double bHeight, double pixelFactor,
@@ -84,13 +100,20 @@ protected:
 	                 QSizeF minAreaInches, double minDimensionInches, QPointF polygonOffset);
 
 	QString makeOnePoly(const QPolygon & poly, const QString & colorString, const QString & id, int minX, int minY);
+	QString makePolys(const QList<QPolygon> & polygons, const QString & colorString, const QString & id, int minX, int minY);
+	QString makePath(const QList<QPolygon> & polygons, const QString & colorString, const QString & id, int minX, int minY);
 	double calcArea(QPolygon & poly);
 	QImage * generateGroundPlaneAux(GPGParams &, double & bWidth, double & bHeight, QList<QRectF> &);
 	void makeConnector(QList<QPolygon> & polygons, double res, double pixelFactor, const QString & colorString, int minX, int minY, QString & svg);
-	bool tryNextPoint(int x, int y, QImage & image, QList<QPoint> & points);
-	bool collectBorderPoints(QImage & image, QList<QPoint> & points);
-	bool try8(int x, int y, QImage & image, QList<QPoint> & points);
 	bool generateGroundPlaneFn(const GPGParams &);
+	bool generateVectorGroundPlane(const GPGParams &);
+	bool refillVectorGroundPlane(const GPGParams &);
+	bool vectorFill(const GPGParams &, const QRectF & window, QPainterPath & fill);
+	void makeVectorPieces(const GPGParams &, const QPainterPath & fill);
+	QPainterPath fillOutline(const QString & svg, QPointF offset);
+
+	static QPainterPath uniteAll(QList<QPainterPath> & paths);
+	static QList< QList<QPolygon> > vectorPieces(const QPainterPath & fill, double unitsPerMil);
 
 
 protected:
@@ -101,10 +124,22 @@ protected:
 	double m_strokeWidthIncrement;
 	int m_minRunSize;
 	int m_minRiseSize;
+	bool m_vector;
+	bool m_pathOutput;
+	QStringList m_oldSVGs;                  // the fill being refilled, with offsets in pixels from the board's top left
+	QList<QPointF> m_oldOffsets;
+	QRectF m_dirty;                         // in mils from the board's top left; null unless refilling
+	QList<int> m_replaced;                  // into m_oldSVGs
+	QVector<TraceBand> m_traceBands;
+	QImage m_traceImage;
+	double m_traceRes = 0;
+	QString m_traceColor;
 
 public:
 	static const QString KeepoutSettingName;
 	static const double KeepoutDefaultMils;
+	static const QString VectorSettingName;
+	static const QString PathOutputSettingName;
 
 };
 
@@ -87,18 +87,80 @@ QStringList KicadModule2Svg::listModules(const QString & filename) {
 	return modules;
 }
 
+QHash<QString, QString> KicadModule2Svg::splitModules(const QString & filename, QStringList & moduleNames) {
+	// reads a whole library once: the index, plus each module's text from its $MODULE line through $EndMODULE
+	QHash<QString, QString> modules;
+	moduleNames.clear();
+
+	QFile file(filename);
+	if (!file.open(QFile::ReadOnly)) return modules;
+
+	QTextStream textStream(&file);
+	bool inIndex = false;
+	bool gotIndex = false;
+	QString moduleName;
+	QString moduleText;
+	while (true) {
+		QString line = textStream.readLine();
+		if (line.isNull()) break;
+
+		if (!gotIndex) {
+			if (line.compare("$INDEX") == 0) {
+				inIndex = true;
+			}
+			else if (line.compare("$EndINDEX") == 0) {
+				inIndex = false;
+				gotIndex = true;
+			}
+			else if (inIndex) {
+				moduleNames.append(line);
+			}
+			continue;
+		}
+
+		if (moduleName.isEmpty()) {
+			if (line.startsWith("$MODULE")) {
+				moduleName = line.mid(7).trimmed();
+				moduleText = line + "\n";
+			}
+			continue;
+		}
+
+		moduleText += line + "\n";
+		if (line.startsWith("$EndMODULE")) {
+			modules.insert(moduleName, moduleText);
+			moduleName.clear();
+			moduleText.clear();
+		}
+	}
+
+	if (!gotIndex) moduleNames.clear();
+	return modules;
+}
+
 QString KicadModule2Svg::convert(const QString & filename, const QString & moduleName, bool allowPadsAndPins)
 {
-	m_nonConnectorNumber = 0;
-	initLimits();
-
 	QFile file(filename);
 	if (!file.open(QFile::ReadOnly)) {
 		throw QObject::tr("unable to open %1").arg(filename);
 	}
 
-	QString text;
 	QTextStream textStream(&file);
+	return convert(textStream, filename, moduleName, allowPadsAndPins);
+}
+
+QString KicadModule2Svg::convertText(const QString & filename, const QString & moduleName, const QString & moduleText, bool allowPadsAndPins)
+{
+	// moduleText is one module as returned by splitModules, so the library file is not read again
+	QString text(moduleText);
+	QTextStream textStream(&text, QIODevice::ReadOnly);
+	return convert(textStream, filename, moduleName, allowPadsAndPins);
+}
+
+QString KicadModule2Svg::convert(QTextStream & textStream, const QString & filename, const QString & moduleName, bool allowPadsAndPins)
+{
+	m_nonConnectorNumber = 0;
+	initLimits();
 
 	QString metadata = makeMetadata(filename, "module", moduleName);
 
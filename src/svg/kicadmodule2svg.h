@@ -21,6 +21,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef KICADMODULE2SVG_H
 #define KICADMODULE2SVG_H
 
+#include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QTextStream>
@@ -33,9 +34,11 @@ class KicadModule2Svg : public Kicad2Svg
 public:
 	KicadModule2Svg();
 	QString convert(const QString & filename, const QString & moduleName, bool allowPadsAndPins);
+	QString convertText(const QString & filename, const QString & moduleName, const QString & moduleText, bool allowPadsAndPins);
 
 public:
 	static QStringList listModules(const QString & filename);
+	static QHash<QString, QString> splitModules(const QString & filename, QStringList & moduleNames);
 
 public:
 	enum PadLayer {
@@ -45,6 +48,7 @@ public:
 	};
 
 protected:
+	QString convert(QTextStream & stream, const QString & filename, const QString & moduleName, bool allowPadsAndPins);
 	KicadModule2Svg::PadLayer convertPad(QTextStream & stream, QString & pad, QList<int> & numbers);
 	int drawDSegment(const QString & ds, QString & line);
 	int drawDArc(const QString & ds, QString & arc);
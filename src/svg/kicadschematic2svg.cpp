@@ -20,6 +20,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "kicadschematic2svg.h"
 #include "../utils/textutils.h"
+#include "../installedfonts.h"
 #include "../utils/graphicsutils.h"
 #include "../version/version.h"
 #include "../debugdialog.h"
@@ -252,6 +253,7 @@ QString KicadSchematic2Svg::convertField(const QString & xString, const QString
 		rotation = QString("transform='%1' _x='%2' _y='%3' _r='-90'").arg(TextUtils::svgMatrix(m)).arg(x).arg(y);
 	}
 
+	InstalledFonts::registerFonts();
 	QFont font;
 	font.setFamily(OCRAFontName);
 	font.setWeight(QFont::Normal);
@@ -0,0 +1,350 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "outlinetracer.h"
+
+#include <QLineF>
+#include <QPair>
+#include <QVector>
+
+// east, south, west, north; y grows downward, so turning right is the next direction
+static const int DX[4] = { 1, 0, -1, 0 };
+static const int DY[4] = { 0, 1, 0, -1 };
+
+// the pixels to the left and to the right of the edge leaving a corner in each direction, from the corner
+static const int LeftX[4] = { 0, 0, -1, -1 };
+static const int LeftY[4] = { -1, 0, 0, -1 };
+static const int RightX[4] = { 0, -1, -1, 0 };
+static const int RightY[4] = { 0, 0, -1, -1 };
+
+QPolygon OutlineTracer::trace(const QImage & image)
+{
+	// keeps white on the right while walking the cracks between pixels: at each corner turn left if the pixel
+	// ahead on the left is white, go straight if only the one ahead on the right is, otherwise turn right
+	int width = image.width();
+	int height = image.height();
+	if (width == 0 || height == 0) return QPolygon();
+
+	bool mono = image.format() == QImage::Format_Mono || image.format() == QImage::Format_MonoLSB;
+	bool lsb = image.format() == QImage::Format_MonoLSB;
+	bool oneIsWhite = image.colorCount() < 2 || image.color(1) == 0xffffffff;
+	bool zeroIsWhite = image.colorCount() >= 2 && image.color(0) == 0xffffffff;
+	auto white = [&](int x, int y) -> bool {
+		if (x < 0 || y < 0 || x >= width || y >= height) return false;
+		if (!mono) return image.pixel(x, y) == 0xffffffff;
+
+		const uchar * line = image.constScanLine(y);
+		int bit = lsb ? (line[x >> 3] >> (x & 7)) & 1 : (line[x >> 3] >> (7 - (x & 7))) & 1;
+		return bit ? oneIsWhite : zeroIsWhite;
+	};
+
+	QPoint start(-1, -1);
+	for (int y = 0; y < height && start.x() < 0; y++) {
+		for (int x = 0; x < width; x++) {
+			if (!white(x, y)) continue;
+
+			start = QPoint(x, y);
+			break;
+		}
+	}
+	if (start.x() < 0) return QPolygon();
+
+	// the top left corner of the first white pixel; the pixels above it and to its left are black
+	QPolygon polygon;
+	polygon.append(start);
+	QPoint corner = start;
+	int direction = 0;
+	qint64 maxSteps = 4 * qint64(width + 1) * (height + 1);
+	for (qint64 step = 0; step < maxSteps; step++) {
+		corner += QPoint(DX[direction], DY[direction]);
+		int next = (direction + 1) % 4;
+		if (white(corner.x() + LeftX[direction], corner.y() + LeftY[direction])) next = (direction + 3) % 4;
+		else if (white(corner.x() + RightX[direction], corner.y() + RightY[direction])) next = direction;
+
+		if (corner == start && next == 0) return polygon;
+		if (next != direction) polygon.append(corner);
+		direction = next;
+	}
+
+	return QPolygon();                       // not closed; can't happen
+}
+
+QPolygon OutlineTracer::simplify(const QPolygon & polygon, double tolerance)
+{
+	// the outline is closed: split it at its first point and the point farthest from that, then simplify each half
+	int count = polygon.count();
+	if (count < 4 || tolerance <= 0) return polygon;
+
+	int farthest = 0;
+	double farthestDistance = -1;
+	for (int i = 1; i < count; i++) {
+		double d = QLineF(polygon.at(0), polygon.at(i)).length();
+		if (d > farthestDistance) {
+			farthestDistance = d;
+			farthest = i;
+		}
+	}
+
+	QVector<bool> keep(count, false);
+	keep[0] = keep[farthest] = true;
+	QList< QPair<int, int> > spans;          // first and last point; count stands for point 0
+	spans << qMakePair(0, farthest) << qMakePair(farthest, count);
+	return simplifySpans(polygon, tolerance, keep, spans);
+}
+
+QPolygon OutlineTracer::simplifyPolyline(const QPolygon & polyline, double tolerance)
+{
+	// the ends stay where they are
+	int count = polyline.count();
+	if (count < 3 || tolerance <= 0) return polyline;
+
+	QVector<bool> keep(count, false);
+	keep[0] = keep[count - 1] = true;
+	QList< QPair<int, int> > spans;
+	spans << qMakePair(0, count - 1);
+	return simplifySpans(polyline, tolerance, keep, spans);
+}
+
+QPolygon OutlineTracer::simplifySpans(const QPolygon & polygon, double tolerance, QVector<bool> & keep, QList< QPair<int, int> > & spans)
+{
+	int count = polygon.count();
+	while (!spans.isEmpty()) {
+		QPair<int, int> span = spans.takeLast();
+		QPointF a = polygon.at(span.first);
+		QPointF b = polygon.at(span.second % count);
+		QPointF ab = b - a;
+		double length = QLineF(a, b).length();
+
+		int worst = -1;
+		double worstDistance = tolerance;
+		for (int i = span.first + 1; i < span.second; i++) {
+			QPointF ap = QPointF(polygon.at(i)) - a;
+			double d = (length == 0) ? QLineF(a, polygon.at(i)).length() : qAbs(ab.x() * ap.y() - ab.y() * ap.x()) / length;
+			if (d > worstDistance) {
+				worstDistance = d;
+				worst = i;
+			}
+		}
+		if (worst < 0) continue;
+
+		keep[worst] = true;
+		spans << qMakePair(span.first, worst) << qMakePair(worst, span.second);
+	}
+
+	QPolygon simplified;
+	for (int i = 0; i < count; i++) {
+		if (keep.at(i)) simplified.append(polygon.at(i));
+	}
+	return simplified;
+}
+
+QPolygon OutlineTracer::traceNeighbors(const QImage & image)
+{
+	QList<QPoint> points;
+	if (!collectBorderPoints(image, points) || points.count() == 0) return QPolygon();
+
+	removeRedundant(points);
+	QPolygon polygon;
+	Q_FOREACH (QPoint p, points) {
+		polygon.append(p);
+	}
+	return polygon;
+}
+
+void OutlineTracer::removeRedundant(QList<QPoint> & points)
+{
+	QPoint current = points.last();
+	int ix = points.count() - 2;
+	int soFar = 1;
+	while (ix > 0) {
+		if (points.at(ix).x() != current.x()) {
+			current = points.at(ix--);
+			soFar = 1;
+			continue;
+		}
+
+		if (++soFar > 2) {
+			points.removeAt(ix + 1);
+		}
+		ix--;
+	}
+}
+
+bool OutlineTracer::collectBorderPoints(const QImage & image, QList<QPoint> & points)
+{
+	// background is black
+
+	int currentX = 0, currentY = 0;
+	bool gotSomething = false;
+
+	for (int y = 0; y < image.height(); y++) {
+		for (int x = 0; x < image.width(); x++) {
+			QRgb current = image.pixel(x, y);
+			if (current != 0xffffffff) {
+				// another black pixel, keep moving
+				continue;
+			}
+
+			currentX = x;
+			currentY = y;
+			//DebugDialog::debug(QString("first point %1 %2").arg(currentX).arg(currentY));
+			points.append(QPoint(currentX, currentY));
+			gotSomething = true;
+			break;
+		}
+		if (gotSomething) break;
+	}
+
+	if (!gotSomething) return false;
+
+	bool done = false;
+	long maxPoints = image.height() * image.width() / 2;
+	for (long inc = 0; inc < maxPoints; inc++) {
+		if (try8(currentX, currentY, image, points)) ;
+		else {
+			QPoint p = points.first();
+			if (qAbs(p.x() - currentX) < 4 && qAbs(p.y() - currentY) < 4) {
+				// we're near the beginning again
+				done = true;
+				break;
+			}
+
+			bool keepGoing = false;
+			for (int ix = points.count() - 2; ix >= 0; ix--) {
+				QPoint p = points.at(ix);
+				if (try8(p.x(), p.y(), image, points)) {
+					keepGoing = true;
+					break;
+				}
+			}
+
+			if (!keepGoing) break;
+		}
+
+		QPoint p = points.last();
+		currentX = p.x();
+		currentY = p.y();
+		//DebugDialog::debug(QString("next point %1 %2").arg(currentX).arg(currentY));
+		//if (inc % 100 == 0) {
+		//DebugDialog::debug("\n");
+		//}
+	}
+	return done;
+}
+
+
+bool OutlineTracer::try8(int x, int y, const QImage & image, QList<QPoint> & points) {
+	if (tryNextPoint(x, y + 1, image, points)) return true;
+	else if (tryNextPoint(x + 1, y, image, points)) return true;
+	else if (tryNextPoint(x, y - 1, image, points)) return true;
+	else if (tryNextPoint(x - 1, y, image, points)) return true;
+	else if (tryNextPoint(x + 1, y + 1, image, points)) return true;
+	else if (tryNextPoint(x - 1, y + 1, image, points)) return true;
+	else if (tryNextPoint(x + 1, y - 1, image, points)) return true;
+	else if (tryNextPoint(x - 1, y - 1, image, points)) return true;
+	return false;
+}
+
+bool OutlineTracer::tryNextPoint(int x, int y, const QImage & image, QList<QPoint> & points)
+{
+	if (x < 0) return false;
+	if (y < 0) return false;
+	if (x >= image.width()) return false;
+	if (y >= image.height()) return false;
+
+	Q_FOREACH (QPoint p, points) {
+		if (p.x() == x && p.y() == y) {
+			// already visited
+			return false;
+		}
+
+		if (qAbs(p.x() - x) > 3 && qAbs(p.y() - y) > 3) {
+			// too far away from the start of the polygon
+			break;
+		}
+	}
+
+
+	for (int i = points.count() - 1; i >= 0; i--) {
+		QPoint p = points.at(i);
+		if (p.x() == x && p.y() == y) {
+			// already visited
+			return false;
+		}
+
+		if (qAbs(p.x() - x) > 3 && qAbs(p.y() - y) > 3) {
+			// too far away from from the current point
+			break;
+		}
+	}
+
+	QRgb pixel = image.pixel(x, y);
+	//DebugDialog::debug(QString("pixel %1,%2 %3").arg(x).arg(y).arg(pixel, 0, 16));
+	if (pixel != 0xffffffff) {
+		// empty pixel, not on the border
+		return false;
+	}
+
+	if (x + 1 == image.width()) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	pixel = image.pixel(x + 1, y);
+	if (pixel != 0xffffffff) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	if (y + 1 == image.height()) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	pixel = image.pixel(x, y + 1);
+	if (pixel != 0xffffffff) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	if (x - 1  < 0) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	pixel = image.pixel(x - 1, y);
+	if (pixel != 0xffffffff) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	if (y - 1  < 0) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	pixel = image.pixel(x, y - 1);
+	if (pixel != 0xffffffff) {
+		points.append(QPoint(x, y));
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef OUTLINETRACER_H
+#define OUTLINETRACER_H
+
+#include <QImage>
+#include <QList>
+#include <QPoint>
+#include <QPair>
+#include <QPolygon>
+#include <QVector>
+
+class OutlineTracer
+{
+	// the outline of the first white region of an image, white on black, found row by row from the top left
+
+public:
+	// follows the pixel edges around the region, diagonal neighbors included, reading the scanlines directly;
+	// the outline goes through pixel corners, and only its corners are kept
+	static QPolygon trace(const QImage &);
+
+	// drops points which are within tolerance of the line through their neighbors (Douglas-Peucker)
+	static QPolygon simplify(const QPolygon &, double tolerance);
+
+	// the same for an open polyline, keeping both ends
+	static QPolygon simplifyPolyline(const QPolygon &, double tolerance);
+
+	// the former tracer, probing the neighbors of each border pixel; for comparison
+	static QPolygon traceNeighbors(const QImage &);
+
+protected:
+	static bool collectBorderPoints(const QImage & image, QList<QPoint> & points);
+	static bool try8(int x, int y, const QImage & image, QList<QPoint> & points);
+	static bool tryNextPoint(int x, int y, const QImage & image, QList<QPoint> & points);
+	static void removeRedundant(QList<QPoint> & points);
+	static QPolygon simplifySpans(const QPolygon &, double tolerance, QVector<bool> & keep, QList< QPair<int, int> > & spans);
+};
+
+#endif
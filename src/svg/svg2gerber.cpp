@@ -21,13 +21,17 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "svg2gerber.h"
 #include "../debugdialog.h"
 #include "svgflattener.h"
+#include "../testing/FTimingProbe.h"
 #include <QTextStream>
+#include <QTemporaryFile>
 #include <QSettings>
-#include <QSet>
 #include <QtDebug>
 #include <QRegularExpression>
 #include <qmath.h>
 
+#include <algorithm>
+#include <cmath>
+
 constexpr double MaskClearance = 0.0;  // 5 mils clearance
 constexpr double milsPerInch = 1000;  // used to convert mils (standard fritzing resolution) to inches
 
@@ -47,9 +51,32 @@ bool hasStroke(QDomElement & element) {
 
 //TODO: currently only supports one board per sketch (i.e. multiple board outlines will mess you up)
 
-int SVG2gerber::convert(const QString & svgStr, bool doubleSided, const QString & mainLayerName, ForWhy forWhy, QSizeF boardSize)
+int SVG2gerber::convert(const QString & svgStr, bool doubleSided, const QString & mainLayerName, ForWhy forWhy, QSizeF boardSize, bool spool)
 {
+	static FTimingProbe probe("SVG2gerber.convert");
+	FTimingProbe::Scope timing(probe);
+
+	// with spool, the program body goes to a temporary file as it is generated rather than into memory;
+	// the header, which collects the apertures while the body is written, stays in memory
 	m_boardSize = boardSize;
+	m_gerber_paths.clear();
+	m_regionOpen = false;
+	m_regionBounds.clear();
+	m_spool.reset();
+	if (spool) {
+		m_spool.reset(new QTemporaryFile());
+		if (m_spool->open()) {
+			m_paths.setDevice(m_spool.get());
+		}
+		else {
+			DebugDialog::debug("gerber spool not opened; converting in memory");
+			m_spool.reset();
+		}
+	}
+	if (!m_spool) {
+		m_paths.setString(&m_gerber_paths);
+	}
+
 	m_SVGDom = QDomDocument("svg");
 	QString errorStr;
 	int errorLine;
@@ -72,10 +99,110 @@ int SVG2gerber::convert(const QString & svgStr, bool doubleSided, const QString
 	return renderGerber(doubleSided, mainLayerName, forWhy);
 }
 
+void SVG2gerber::writeDrillHits(QList<QPoint> hits, QPoint & head, bool optimize) {
+	// one tool's hits, each location once; when optimizing, they follow a short tour from where the head is
+	// and an axis that hasn't changed since the previous hit is left out
+	std::sort(hits.begin(), hits.end(), [](const QPoint & a, const QPoint & b) {
+		return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+	});
+	hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+	if (optimize) {
+		orderDrillHits(hits, head);
+	}
+
+	for (int i = 0; i < hits.count(); i++) {
+		QPoint hit = hits.at(i);
+		QString loc;
+		if (!optimize || i == 0 || hit.x() != hits.at(i - 1).x()) loc += QString("X%1").arg(hit.x(), 6, 10, QChar('0'));
+		if (!optimize || i == 0 || hit.y() != hits.at(i - 1).y()) loc += QString("Y%1").arg(hit.y(), 6, 10, QChar('0'));
+		paths() << loc + "\n";
+	}
+	if (!hits.isEmpty()) {
+		head = hits.last();
+	}
+}
+
+void SVG2gerber::orderDrillHits(QList<QPoint> & hits, const QPoint & start) {
+	// nearest-neighbour tour from start, left open at the far end, then shortened by 2-opt moves
+	int n = hits.count();
+	if (n < 2) return;
+
+	auto distance = [](const QPoint & a, const QPoint & b) {
+		return std::hypot(double(a.x() - b.x()), double(a.y() - b.y()));
+	};
+
+	QVector<QPoint> tour;
+	tour.reserve(n + 1);
+	tour.append(start);
+	QVector<bool> used(n, false);
+	for (int k = 0; k < n; k++) {
+		int nearest = -1;
+		double nearestDistance = 0;
+		for (int i = 0; i < n; i++) {
+			if (used.at(i)) continue;
+
+			double d = distance(tour.last(), hits.at(i));
+			if (nearest < 0 || d < nearestDistance) {
+				nearest = i;
+				nearestDistance = d;
+			}
+		}
+		used[nearest] = true;
+		tour.append(hits.at(nearest));
+	}
+
+	// tour[0] is the head's position and stays put
+	bool improved = n <= MaxTwoOptHits;
+	for (int pass = 0; improved && pass < MaxTwoOptPasses; pass++) {
+		improved = false;
+		for (int i = 1; i < n; i++) {
+			for (int j = i + 1; j <= n; j++) {
+				double before = distance(tour.at(i - 1), tour.at(i));
+				double after = distance(tour.at(i - 1), tour.at(j));
+				if (j < n) {
+					before += distance(tour.at(j), tour.at(j + 1));
+					after += distance(tour.at(i), tour.at(j + 1));
+				}
+				if (after < before - 1e-9) {
+					std::reverse(tour.begin() + i, tour.begin() + j + 1);
+					improved = true;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < n; i++) {
+		hits[i] = tour.at(i + 1);
+	}
+}
+
 QString SVG2gerber::getGerber() {
+	m_paths.flush();
+	if (m_spool) {
+		m_spool->seek(0);
+		return m_gerber_header + QString::fromUtf8(m_spool->readAll());
+	}
+
 	return m_gerber_header + m_gerber_paths;
 }
 
+bool SVG2gerber::write(QIODevice & device) {
+	// copies the body across in blocks, so a spooled program is never held in memory whole
+	m_paths.flush();
+	if (device.write(m_gerber_header.toUtf8()) < 0) return false;
+
+	if (!m_spool) {
+		return device.write(m_gerber_paths.toUtf8()) >= 0;
+	}
+
+	m_spool->seek(0);
+	while (!m_spool->atEnd()) {
+		QByteArray block = m_spool->read(SpoolBlockSize);
+		if (block.isEmpty() || device.write(block) < 0) return false;
+	}
+	return true;
+}
+
 int SVG2gerber::renderGerber(bool doubleSided, const QString & mainLayerName, ForWhy forWhy) {
 	bool gerberExportImprovementsEnabled = QSettings().value("gerberExportImprovementsEnabled").toBool();
 	if (forWhy != ForDrill) {
@@ -133,25 +260,21 @@ int SVG2gerber::renderGerber(bool doubleSided, const QString & mainLayerName, Fo
 		// set to english (inches) units, with trailing zeros
 		m_gerber_header += "INCH\n";
 
+		bool optimizeDrillOrder = QSettings().value("gerberDrillOrderOptimized").toBool();
+		QPoint head(0, 0);
 		int ix = initialHoleIndex;
 		Q_FOREACH (QString aperture, m_holeApertures.uniqueKeys()) {
 			m_gerber_header += QString("T%1%2\n").arg(ix).arg(aperture);
-			m_gerber_paths += QString("T%1\n").arg(ix);
-			auto values = m_holeApertures.values(aperture);
-			Q_FOREACH (QString loc, QSet<QString>(values.begin(), values.end())) {
-				m_gerber_paths += loc + "\n";
-			}
+			paths() << QString("T%1\n").arg(ix);
+			writeDrillHits(m_holeApertures.values(aperture), head, optimizeDrillOrder);
 			ix++;
 		}
 
 		ix = initialPlatedIndex;
 		Q_FOREACH (QString aperture, m_platedApertures.uniqueKeys()) {
 			m_gerber_header += QString("T%1%2\n").arg(ix).arg(aperture);
-			m_gerber_paths += QString("T%1\n").arg(ix);
-			auto values = m_platedApertures.values(aperture);
-			Q_FOREACH (QString loc, QSet<QString>(values.begin(), values.end())) {
-				m_gerber_paths += loc + "\n";
-			}
+			paths() << QString("T%1\n").arg(ix);
+			writeDrillHits(m_platedApertures.values(aperture), head, optimizeDrillOrder);
 			ix++;
 		}
 
@@ -161,8 +284,8 @@ int SVG2gerber::renderGerber(bool doubleSided, const QString & mainLayerName, Fo
 		//m_gerber_paths += m_drill_slots;   // from handleOblong, not up to date
 
 		// drill file unload tool and end of program
-		m_gerber_paths += "T00\n";
-		m_gerber_paths += "M30\n";
+		paths() << "T00\n";
+		paths() << "M30\n";
 
 	}
 	else {
@@ -187,10 +310,10 @@ int SVG2gerber::renderGerber(bool doubleSided, const QString & mainLayerName, Fo
 
 		// now write the footer
 		// comment to indicate end-of-sketch
-		m_gerber_paths += QString("G04 End of %1*\n").arg(mainLayerName);
+		paths() << QString("G04 End of %1*\n").arg(mainLayerName);
 
 		// write gerber end-of-program
-		m_gerber_paths += "M02*";
+		paths() << "M02*";
 	}
 
 	return invalidCount;
@@ -202,9 +325,9 @@ void SVG2gerber::normalizeSVG() {
 	//  convert to paths
 	convertShapes2paths(root);
 
-	//  get rid of transforms
+	//  get rid of transforms, a part's fragment per thread
 	SvgFlattener flattener;
-	flattener.flattenChildren(root, SvgAttributesMap());
+	flattener.flattenChildrenConcurrently(root, SvgAttributesMap());
 
 }
 
@@ -329,7 +452,7 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 		//DebugDialog::debug("drawing board outline");
 
 		// switch aperture to the only one used for contour: note this is the last one on the list: the aperture is added at the end of this function
-		m_gerber_paths += m_G54 + "D10*\n";
+		paths() << m_G54 + "D10*\n";
 	}
 
 	// circles
@@ -351,12 +474,10 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 		if (forWhy == ForDrill) {
 			if (noDrill) continue;
 
-			QString drill_cx = QString("%1").arg((int) (centerx * 10), 6, 10, QChar('0'));				// drill file is in inches 00.0000, converting mils to 10000ths
-			QString drill_cy = QString("%1").arg((int) (flipy(centery) * 10), 6, 10, QChar('0'));				// drill file is in inches 00.0000, converting mils to 10000ths
+			QPoint hit((int) (centerx * 10), (int) (flipy(centery) * 10));				// drill file is in inches 00.0000, converting mils to 10000ths
 			QString aperture = QString("C%1").arg(hole, 0, 'f');
-			QString loc = "X" + drill_cx + "Y" + drill_cy;
-			if (stroke_width == 0) m_holeApertures.insert(aperture, loc);
-			else m_platedApertures.insert(aperture, loc);
+			if (stroke_width == 0) m_holeApertures.insert(aperture, hit);
+			else m_platedApertures.insert(aperture, hit);
 			continue;
 		}
 
@@ -381,27 +502,22 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 
 
 		// add aperture to defs if we don't have it yet
-		if(!apertureMap.contains(aperture)) {
-			apertureMap[aperture] = QString::number(dcode_index);
-			m_gerber_header += "%ADD" + QString::number(dcode_index) + aperture + "*%\n";
-			dcode_index++;
-		}
+		QString dcode = defineAperture(aperture, apertureMap, dcode_index);
 
 		if (forWhy != ForOutline) {
-			QString dcode = apertureMap[aperture];
 			if(current_dcode != dcode) {
 				//switch to correct aperture
-				m_gerber_paths += m_G54 + "D" + dcode + "*\n";
+				paths() << m_G54 + "D" + dcode + "*\n";
 				current_dcode = dcode;
 			}
 			//flash
-			m_gerber_paths += "X" + cx + "Y" + cy + "D03*\n";
+			paths() << "X" + cx + "Y" + cy + "D03*\n";
 		}
 		else {
 			standardAperture(circle, apertureMap, current_dcode, dcode_index, 0);
 
 			// create circle outline
-			m_gerber_paths += QString(
+			paths() << QString(
 					"G01X%1Y%2D02*\n"
 					"G75*\n"
 					"G03X%1Y%2I%3J0D01*\n"
@@ -410,7 +526,7 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 					,f2gerber(flipy(centery))
 					,f2gerber(-r)
 				);
-			m_gerber_paths += "G01*\n";
+			paths() << "G01*\n";
 		}
 	}
 
@@ -464,36 +580,31 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 			}
 
 			// add aperture to defs if we don't have it yet
-			if(!apertureMap.contains(aperture)) {
-				apertureMap[aperture] = QString::number(dcode_index);
-				m_gerber_header += "%ADD" + QString::number(dcode_index) + aperture + "*%\n";
-				dcode_index++;
-			}
+			QString dcode = defineAperture(aperture, apertureMap, dcode_index);
 
 			bool doLines = false;
 			if (forWhy == ForOutline) doLines = true;
 			else if (forWhy == ForSilk && fill == "none") doLines = true;
 
 			if (!doLines) {
-				QString dcode = apertureMap[aperture];
 				if(current_dcode != dcode) {
 					//switch to correct aperture
-					m_gerber_paths += m_G54 + "D" + dcode + "*\n";
+					paths() << m_G54 + "D" + dcode + "*\n";
 					current_dcode = dcode;
 				}
 				//flash
-				m_gerber_paths += "X" + cx + "Y" + cy + "D03*\n";
+				paths() << "X" + cx + "Y" + cy + "D03*\n";
 			}
 			else {
 				// draw 4 lines
 
 				standardAperture(rect, apertureMap, current_dcode, dcode_index, 0);
-				m_gerber_paths += "X" + f2gerber(x) + "Y" + f2gerber(flipy(y)) + "D02*\n";
-				m_gerber_paths += "X" + f2gerber(x+width) + "Y" + f2gerber(flipy(y)) + "D01*\n";
-				m_gerber_paths += "X" + f2gerber(x+width) + "Y" + f2gerber(flipy(y+height)) + "D01*\n";
-				m_gerber_paths += "X" + f2gerber(x) + "Y" + f2gerber(flipy(y+height)) + "D01*\n";
-				m_gerber_paths += "X" + f2gerber(x) + "Y" + f2gerber(flipy(y)) + "D01*\n";
-				m_gerber_paths += "D02*\n";
+				paths() << "X" + f2gerber(x) + "Y" + f2gerber(flipy(y)) + "D02*\n";
+				paths() << "X" + f2gerber(x+width) + "Y" + f2gerber(flipy(y)) + "D01*\n";
+				paths() << "X" + f2gerber(x+width) + "Y" + f2gerber(flipy(y+height)) + "D01*\n";
+				paths() << "X" + f2gerber(x) + "Y" + f2gerber(flipy(y+height)) + "D01*\n";
+				paths() << "X" + f2gerber(x) + "Y" + f2gerber(flipy(y)) + "D01*\n";
+				paths() << "D02*\n";
 			}
 		}
 
@@ -513,15 +624,15 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 			// turn off light if we are not continuing along a path
 			if ((y1 != currenty) || (x1 != currentx)) {
 				if (light_on) {
-					m_gerber_paths += "D02*\n";
+					paths() << "D02*\n";
 					// Assignment of light_on to false was removed from this line because it is overwritten to true below.
 				}
 			}
 
 			//go to start - light off
-			m_gerber_paths += "X" + f2gerber(x1) + "Y" + f2gerber(flipy(y1)) + "D02*\n";
+			paths() << "X" + f2gerber(x1) + "Y" + f2gerber(flipy(y1)) + "D02*\n";
 			//go to end point - light on
-			m_gerber_paths += "X" + f2gerber(x2) + "Y" + f2gerber(flipy(y2)) + "D01*\n";
+			paths() << "X" + f2gerber(x2) + "Y" + f2gerber(flipy(y2)) + "D01*\n";
 			light_on = true;
 			currentx = x2;
 			currenty = y2;
@@ -549,18 +660,19 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 
 		QString data = path.attribute("d").trimmed();
 
-		const char * slot = SLOT(path2gerbCommandSlot(QChar, bool, QList<double> &, void *));
+		auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { path2gerbCommandSlot(command, relative, args, userData); };
 
 		PathUserData pathUserData;
 		pathUserData.x = 0;
 		pathUserData.y = 0;
 		pathUserData.pathStarting = true;
 		pathUserData.string = "";
+		m_pathBounds = QRectF();
 
 		SvgFlattener flattener;
 		bool invalid = false;
 		try {
-			flattener.parsePath(data, slot, pathUserData, this, true);
+			flattener.parsePath(data, slot, pathUserData, true);
 		}
 		catch (const QString & msg) {
 			DebugDialog::debug("flattener.parsePath failed " + msg);
@@ -587,16 +699,15 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 			// use a minimal aperture. gerbv seems to use the last used aperture for image size calculation
 			// the aperture should not matter for the fill, though
 			standardAperture(path, apertureMap, current_dcode, dcode_index,  0.1);
-			// start poly fill
-			m_gerber_paths += "G36*\n";
-			m_gerber_paths += pathUserData.string;
+			// poly fill
+			addRegion(pathUserData.string, m_pathBounds);
 			//DebugDialog::debug("path id: " + path.attribute("id"));
-			// stop poly fill
-			m_gerber_paths += "G37*\n";
 		}
 
 		// draw the outline, G36 only does the fill
+		bool stroked = false;
 		if (hasStroke(path) || (forWhy == ForMask) || (forWhy == ForOutline)) {
+			stroked = true;
 			double stroke_width = path.attribute("stroke-width").toDouble();
 			if (forWhy == ForMask) {
 				stroke_width += MaskClearance * 2 * milsPerInch;
@@ -608,16 +719,11 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 					QString aperture = QString("R,%1X%1").arg(stroke_width/milsPerInch, 0, 'f');
 
 					// add aperture to defs if we don't have it yet
-					if (!apertureMap.contains(aperture)) {
-						apertureMap[aperture] = QString::number(dcode_index);
-						m_gerber_header += "%ADD" + QString::number(dcode_index) + aperture + "*%\n";
-						dcode_index++;
-					}
+					QString dcode = defineAperture(aperture, apertureMap, dcode_index);
 
-					QString dcode = apertureMap[aperture];
 					if (current_dcode != dcode) {
 						//switch to correct aperture
-					m_gerber_paths += m_G54 + "D" + dcode + "*\n";
+					paths() << m_G54 + "D" + dcode + "*\n";
 						current_dcode = dcode;
 					}
 				}
@@ -626,14 +732,16 @@ int SVG2gerber::allPaths2gerber(ForWhy forWhy) {
 				standardAperture(path, apertureMap, current_dcode, dcode_index,  stroke_width);
 			}
 
-			m_gerber_paths += pathUserData.string;
+			paths() << pathUserData.string;
 		}
 
-		// light off
-		m_gerber_paths += "D02*\n";
+		// light off; a fill on its own leaves its region open for the next fill
+		if (stroked || !m_regionOpen) paths() << "D02*\n";
 	}
 
 
+	paths();      // closes the last region
+
 	if (forWhy == ForOutline) {
 		// add circular aperture with 0 width
 		m_gerber_header += "%ADD10C,0.008*%\n";
@@ -662,12 +770,17 @@ void SVG2gerber::doPoly(QDomElement & polygon, ForWhy forWhy, bool closedCurve,
 	double starty = pointList.at(1).toDouble();
 	// move to start - light off
 	pointString += "X" + f2gerber(startx) + "Y" + f2gerber(flipy(starty)) + "D02*\n";
+	QRectF bounds(startx, starty, 0, 0);
 
 	// iterate through all other points - light on
-	for(int pt = 2; pt < pointList.length(); pt +=2) {
+	for(int pt = 2; pt + 1 < pointList.length(); pt +=2) {
 		double ptx = pointList.at(pt).toDouble();
 		double pty = pointList.at(pt+1).toDouble();
 		pointString += "X" + f2gerber(ptx) + "Y" + f2gerber(flipy(pty)) + "D01*\n";
+		bounds.setLeft(qMin(bounds.left(), ptx));
+		bounds.setRight(qMax(bounds.right(), ptx));
+		bounds.setTop(qMin(bounds.top(), pty));
+		bounds.setBottom(qMax(bounds.bottom(), pty));
 	}
 
 	if (closedCurve) {
@@ -681,14 +794,13 @@ void SVG2gerber::doPoly(QDomElement & polygon, ForWhy forWhy, bool closedCurve,
 	if (hasFill(polygon) && (forWhy != ForOutline)) {
 		// use a minimal aperture. gerbv seems to use the last used aperture for image size calculation
 		standardAperture(polygon, apertureMap, current_dcode, dcode_index,  0.1);
-		// start poly fill
-		m_gerber_paths += "G36*\n";
-		m_gerber_paths += pointString;
-		// stop poly fill
-		m_gerber_paths += "G37*\n";
+		// poly fill
+		addRegion(pointString, bounds);
 	}
 
+	bool stroked = false;
 	if (hasStroke(polygon) || (forWhy == ForMask) || (forWhy == ForOutline)) {
+		stroked = true;
 		// Some elements are missing a stroke-width
 		// TinySVG 1.2 does not specify a default stroke-width, while SVG 2.0 specifies "1".
 		stroke_width = fmax(stroke_width, 0.005 * milsPerInch);
@@ -698,11 +810,81 @@ void SVG2gerber::doPoly(QDomElement & polygon, ForWhy forWhy, bool closedCurve,
 		}
 		// draw the outline, G36 only does the fill
 		standardAperture(polygon, apertureMap, current_dcode, dcode_index,  stroke_width);
-		m_gerber_paths += pointString;
+		paths() << pointString;
+	}
+
+	// light off; a fill on its own leaves its region open for the next fill
+	if (stroked || !m_regionOpen) paths() << "D02*\n";
+}
+
+QTextStream & SVG2gerber::paths() {
+	// anything else written to the body ends the region being coalesced
+	if (m_regionOpen) {
+		m_paths << "G37*\n";
+		m_regionOpen = false;
+		m_regionBounds.clear();
+	}
+	return m_paths;
+}
+
+void SVG2gerber::addRegion(const QString & contours, const QRectF & bounds) {
+	// consecutive fills share one G36/G37 region while their bounds stay apart,
+	// so the result never depends on how a plotter treats overlapping contours
+	QRectF padded = bounds.adjusted(-RegionMargin, -RegionMargin, RegionMargin, RegionMargin);
+	bool merge = m_regionOpen && m_regionBounds.count() < MaxRegionContours;
+	if (merge) {
+		Q_FOREACH (QRectF regionBounds, m_regionBounds) {
+			if (regionBounds.intersects(padded)) {
+				merge = false;
+				break;
+			}
+		}
+	}
+
+	if (!merge) {
+		// start poly fill
+		paths() << "G36*\n";
+		m_regionOpen = true;
+	}
+	m_paths << contours;
+	m_regionBounds << padded;
+}
+
+QString SVG2gerber::defineAperture(const QString & aperture, QHash<QString, QString> & apertureMap, int & dcode_index) {
+	// apertures that match once quantized share the D-code of the first one defined
+	QString key = apertureKey(aperture);
+	if (!apertureMap.contains(key)) {
+		apertureMap.insert(key, QString::number(dcode_index));
+		m_gerber_header += "%ADD" + QString::number(dcode_index) + aperture + "*%\n";
+		dcode_index++;
+	}
+
+	return apertureMap.value(key);
+}
+
+QString SVG2gerber::apertureKey(const QString & aperture) {
+	int comma = aperture.indexOf(',');
+	if (comma < 0) return aperture;
+
+	QStringList key;
+	Q_FOREACH (QString parameter, aperture.mid(comma + 1).split('X')) {
+		bool ok;
+		double value = parameter.toDouble(&ok);
+		key << (ok ? QString::number(qRound64(value / ApertureQuantum)) : parameter);
 	}
+	return aperture.left(comma + 1) + key.join('X');
+}
 
-	// light off
-	m_gerber_paths += "D02*\n";
+void SVG2gerber::extendPathBounds(double x, double y) {
+	if (m_pathBounds.isNull()) {
+		m_pathBounds = QRectF(x, y, 0, 0);
+		return;
+	}
+
+	m_pathBounds.setLeft(qMin(m_pathBounds.left(), x));
+	m_pathBounds.setRight(qMax(m_pathBounds.right(), x));
+	m_pathBounds.setTop(qMin(m_pathBounds.top(), y));
+	m_pathBounds.setBottom(qMax(m_pathBounds.bottom(), y));
 }
 
 QString SVG2gerber::standardAperture(QDomElement & element, QHash<QString, QString> & apertureMap, QString & current_dcode, int & dcode_index, double stroke_width) {
@@ -714,16 +896,11 @@ QString SVG2gerber::standardAperture(QDomElement & element, QHash<QString, QStri
 	QString aperture = QString("C,%1").arg(stroke_width/milsPerInch, 0, 'f');
 
 	// add aperture to defs if we don't have it yet
-	if (!apertureMap.contains(aperture)) {
-		apertureMap[aperture] = QString::number(dcode_index);
-		m_gerber_header += "%ADD" + QString::number(dcode_index) + aperture + "*%\n";
-		dcode_index++;
-	}
+	QString dcode = defineAperture(aperture, apertureMap, dcode_index);
 
-	QString dcode = apertureMap[aperture];
 	if (current_dcode != dcode) {
 		//switch to correct aperture
-		m_gerber_paths += m_G54 + "D" + dcode + "*\n";
+		paths() << m_G54 + "D" + dcode + "*\n";
 		current_dcode = dcode;
 	}
 
@@ -833,6 +1010,7 @@ void SVG2gerber::path2gerbCommandSlot(QChar command, bool relative, QList<double
 			}
 			pathUserData->pathStarting = false;
 			pathUserData->string.append(gerb_path);
+			extendPathBounds(x, y);
 			argIndex += 2;
 			break;
 		case 'v':
@@ -854,6 +1032,7 @@ void SVG2gerber::path2gerbCommandSlot(QChar command, bool relative, QList<double
 			}
 			gerb_path = "X" + f2gerber(pathUserData->x) + "Y" + f2gerber(flipy(pathUserData->y)) + "D01*\n";
 			pathUserData->string.append(gerb_path);
+			extendPathBounds(pathUserData->x, pathUserData->y);
 			argIndex += 2;
 			break;
 		default:
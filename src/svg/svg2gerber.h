@@ -26,6 +26,13 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QTransform>
 #include <QMultiHash>
+#include <QList>
+#include <QPoint>
+#include <QRectF>
+#include <QTemporaryFile>
+#include <QTextStream>
+
+#include <memory>
 
 class SVG2gerber : public QObject
 {
@@ -44,17 +51,26 @@ public:
 		ForPasteMask
 	};
 
-	int convert(const QString & svgStr, bool doubleSided, const QString & mainLayerName, ForWhy, QSizeF boardSize);
+	int convert(const QString & svgStr, bool doubleSided, const QString & mainLayerName, ForWhy, QSizeF boardSize, bool spool = false);
 	QString getGerber();
+	bool write(QIODevice &);
+
+public:
+	static void orderDrillHits(QList<QPoint> & hits, const QPoint & start);
 
 protected:
 	QDomDocument m_SVGDom;
 	QString m_gerber_header;
 	QString m_gerber_paths;
+	QTextStream m_paths;                        // into m_gerber_paths, or into m_spool when spooling
+	std::unique_ptr<QTemporaryFile> m_spool;
+	bool m_regionOpen = false;                  // a G36 region is waiting for more fills before its G37
+	QList<QRectF> m_regionBounds;
+	QRectF m_pathBounds;                        // of the path being converted, in mils
 	QString m_drill_slots;
 	QSizeF m_boardSize;
-	QMultiHash<QString, QString> m_platedApertures;
-	QMultiHash<QString, QString> m_holeApertures;
+	QMultiHash<QString, QPoint> m_platedApertures;               // drill hits by tool, in 10000ths of an inch
+	QMultiHash<QString, QPoint> m_holeApertures;
 
 	double m_pathstart_x = 0.0;
 	double m_pathstart_y = 0.0;
@@ -65,6 +81,13 @@ protected:
 	double m_f2g = 1.0;
 	QString m_G54 = "G54";
 
+	static const qint64 SpoolBlockSize = 1 << 16;
+	static constexpr double ApertureQuantum = 0.0001;     // inches
+	static constexpr double RegionMargin = 1;             // mils; covers rounding to the coordinate grid
+	static const int MaxRegionContours = 64;
+	static const int MaxTwoOptHits = 2000;                // per tool; above this the nearest-neighbour tour is kept
+	static const int MaxTwoOptPasses = 20;
+
 protected:
 
 	void normalizeSVG();
@@ -80,6 +103,12 @@ protected:
 	int allPaths2gerber(ForWhy);
 	QString path2gerber(QDomElement);
 	void handleOblongPath(QDomElement & path, int & dcode_index);
+	void writeDrillHits(QList<QPoint> hits, QPoint & head, bool optimize);
+	QTextStream & paths();
+	void addRegion(const QString & contours, const QRectF & bounds);
+	QString defineAperture(const QString & aperture, QHash<QString, QString> & apertureMap, int & dcode_index);
+	static QString apertureKey(const QString & aperture);
+	void extendPathBounds(double x, double y);
 	QString standardAperture(QDomElement & element, QHash<QString, QString> & apertureMap, QString & current_dcode, int & dcode_index, double stroke_width);
 	double flipy(double y);
 
@@ -23,9 +23,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../utils/misc.h"
 #include "../utils/textutils.h"
 #include "../debugdialog.h"
-#include "svgpathparser.h"
 #include "svgpathlexer.h"
-#include "svgpathrunner.h"
 
 #include <QDomDocument>
 #include <QFile>
@@ -197,10 +195,30 @@ bool SvgFileSplitter::normalize(double dpi, const QString & elementID, bool blac
 
 	factor = 1;
 
+	double sNewWidth, sNewHeight, vbWidth, vbHeight;
+	if (!normalizeRoot(dpi, sNewWidth, sNewHeight, vbWidth, vbHeight)) return false;
+
+	QDomElement mainElement = m_domDocument.documentElement();
+	if (!elementID.isEmpty()) {
+		mainElement = TextUtils::findElementWithAttribute(mainElement, "id", elementID);
+		if (mainElement.isNull()) return false;
+	}
+
+	normalizeChild(mainElement, sNewWidth, sNewHeight, vbWidth, vbHeight, blackOnly);
+
+	factor = sNewWidth / vbWidth;
+
+	return true;
+}
+
+bool SvgFileSplitter::normalizeRoot(double dpi, double & sNewWidth, double & sNewHeight, double & vbWidth, double & vbHeight)
+{
+	// sizes the root in inches with a viewBox at dpi; sNewWidth and sNewHeight are the new viewBox size
+
 	QDomElement root = m_domDocument.documentElement();
 	if (root.isNull()) return false;
 
-	double sWidth, sHeight, vbWidth, vbHeight;
+	double sWidth, sHeight;
 	if (!TextUtils::getSvgSizes(m_domDocument, sWidth, sHeight, vbWidth, vbHeight)) return false;
 
 	root.setAttribute("width", QString("%1in").arg(sWidth));
@@ -208,17 +226,213 @@ bool SvgFileSplitter::normalize(double dpi, const QString & elementID, bool blac
 
 	root.setAttribute("viewBox", QString("%1 %2 %3 %4").arg(0).arg(0).arg(sWidth * dpi).arg(sHeight * dpi) );
 
+	sNewWidth = sWidth * dpi;
+	sNewHeight = sHeight * dpi;
+	return true;
+}
+
+QString SvgFileSplitter::normalizeAndShift(double dpi, const QString & elementID, bool blackOnly, double x, double y, bool shiftTransforms, double & factor)
+{
+	// normalize followed by shift, in one traversal
+
+	factor = 1;
+
+	double sNewWidth, sNewHeight, vbWidth, vbHeight;
+	if (!normalizeRoot(dpi, sNewWidth, sNewHeight, vbWidth, vbHeight)) return "";
+
+	QTransform affine(sNewWidth / vbWidth, 0, 0, sNewHeight / vbHeight, x, y);
+	QString result = transformGeometry(elementID, affine, sNewWidth / vbWidth, blackOnly, shiftTransforms);
+	if (!result.isEmpty()) {
+		factor = sNewWidth / vbWidth;
+	}
+	return result;
+}
+
+QString SvgFileSplitter::transformGeometry(const QString & elementID, const QTransform & affine, double unitScale, bool blackOnly, bool shiftTransforms)
+{
+	// scales the element and everything under it the way normalize does, with stroke widths and font sizes
+	// scaled by unitScale, then translates what is under it the way shift does; each path is parsed once.
+	// Only scales and translations are handled, since rects, circles and text can't take a rotation or a skew
+
+	if (affine.type() > QTransform::TxScale) return "";
+
+	QDomElement root = m_domDocument.documentElement();
 	QDomElement mainElement = root;
 	if (!elementID.isEmpty()) {
 		mainElement = TextUtils::findElementWithAttribute(root, "id", elementID);
-		if (mainElement.isNull()) return false;
 	}
+	if (mainElement.isNull()) return "";
 
-	normalizeChild(mainElement, sWidth * dpi, sHeight * dpi, vbWidth, vbHeight, blackOnly);
+	transformChild(mainElement, affine, unitScale, blackOnly, shiftTransforms, false);
 
-	factor = sWidth * dpi / vbWidth;
+	QDomDocument document;
+	QDomNode node = document.importNode(mainElement, true);
+	document.appendChild(node);
 
-	return true;
+	return document.toString();
+}
+
+void SvgFileSplitter::transformChild(QDomElement & element, const QTransform & affine, double unitScale, bool blackOnly, bool shiftTransforms, bool translate)
+{
+	// normalizeChild then shiftChild; the element handed to transformGeometry is scaled but not translated
+
+	double sx = affine.m11();
+	double sy = affine.m22();
+	double dx = translate ? affine.dx() : 0;
+	double dy = translate ? affine.dy() : 0;
+
+	normalizeTranslation(element, sx, sy, 1, 1);
+	if (translate && shiftTransforms) {
+		shiftTranslation(element, dx, dy);
+	}
+
+	bool doChildren = false;
+	QString nodeName = element.nodeName();
+	if (nodeName.compare("g") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		normalizeFontSize(element, "font-size", unitScale, 1);
+		setStrokeOrFill(element, blackOnly, "black", false);
+		doChildren = true;
+	}
+	else if (nodeName.compare("circle") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		transformAttribute(element, "cx", sx, dx);
+		transformAttribute(element, "cy", sy, dy);
+		normalizeAttribute(element, "r", sx, 1);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		setStrokeOrFill(element, blackOnly, "black", false);
+	}
+	else if (nodeName.compare("line") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		transformAttribute(element, "x1", sx, dx);
+		transformAttribute(element, "y1", sy, dy);
+		transformAttribute(element, "x2", sx, dx);
+		transformAttribute(element, "y2", sy, dy);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		setStrokeOrFill(element, blackOnly, "black", false);
+	}
+	else if (nodeName.compare("rect") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		normalizeAttribute(element, "width", sx, 1);
+		normalizeAttribute(element, "height", sy, 1);
+		transformAttribute(element, "x", sx, dx);
+		transformAttribute(element, "y", sy, dy);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		normalizeArrayAttribute(element, "stroke-dasharray", unitScale, 1);
+
+		// rx, ry for rounded rects
+		if (!element.attribute("rx").isEmpty()) {
+			normalizeAttribute(element, "rx", sx, 1);
+		}
+		if (!element.attribute("ry").isEmpty()) {
+			normalizeAttribute(element, "ry", sy, 1);
+		}
+		setStrokeOrFill(element, blackOnly, "black", false);
+	}
+	else if (nodeName.compare("ellipse") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		transformAttribute(element, "cx", sx, dx);
+		transformAttribute(element, "cy", sy, dy);
+		normalizeAttribute(element, "rx", sx, 1);
+		normalizeAttribute(element, "ry", sy, 1);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		setStrokeOrFill(element, blackOnly, "black", false);
+	}
+	else if (nodeName.compare("polygon") == 0 || nodeName.compare("polyline") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		QString data = element.attribute("points");
+		if (!data.isEmpty()) {
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { transformCommandSlot(command, relative, args, userData); };
+			PathUserData pathUserData;
+			pathUserData.pathStarting = true;
+			pathUserData.transform = QTransform::fromScale(sx, sy);
+			pathUserData.x = dx;
+			pathUserData.y = dy;
+			if (parsePath(data, slot, pathUserData, false)) {
+				pathUserData.string.remove(0, 1);			// get rid of the "M"
+				element.setAttribute("points", pathUserData.string);
+			}
+		}
+		setStrokeOrFill(element, blackOnly, "black", false);
+	}
+	else if (nodeName.compare("path") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		setStrokeOrFill(element, blackOnly, "black", false);
+		QString data = element.attribute("d").trimmed();
+		if (!data.isEmpty()) {
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { transformCommandSlot(command, relative, args, userData); };
+			PathUserData pathUserData;
+			pathUserData.pathStarting = true;
+			pathUserData.transform = QTransform::fromScale(sx, sy);
+			pathUserData.x = dx;
+			pathUserData.y = dy;
+			if (parsePath(data, slot, pathUserData, true)) {
+				element.setAttribute("d", pathUserData.string);
+			}
+		}
+	}
+	else if (nodeName.compare("text") == 0) {
+		TextUtils::fixStyleAttribute(element);
+		transformAttribute(element, "x", sx, dx);
+		transformAttribute(element, "y", sy, dy);
+		normalizeAttribute(element, "stroke-width", unitScale, 1);
+		normalizeFontSize(element, "font-size", unitScale, 1);
+		setStrokeOrFill(element, blackOnly, "black", false);
+	}
+	else if (nodeName.compare("linearGradient") == 0 || nodeName.compare("radialGradient") == 0) {
+		// as in normalizeChild, gradient coordinates all go with the width
+		if (element.attribute("gradientUnits").compare("userSpaceOnUse") == 0) {
+			const char * names[] = { "x1", "y1", "x2", "y2", "cx", "cy", "fx", "fy", "r" };
+			for (const char * name : names) {
+				normalizeAttribute(element, name, sx, 1);
+			}
+		}
+		if (translate) {
+			QDomElement childElement = element.firstChildElement();
+			while (!childElement.isNull()) {
+				shiftChild(childElement, dx, dy, shiftTransforms);
+				childElement = childElement.nextSiblingElement();
+			}
+		}
+	}
+	else {
+		doChildren = true;
+	}
+
+	if (doChildren) {
+		QDomElement childElement = element.firstChildElement();
+		while (!childElement.isNull()) {
+			transformChild(childElement, affine, unitScale, blackOnly, shiftTransforms, true);
+			childElement = childElement.nextSiblingElement();
+		}
+	}
+}
+
+bool SvgFileSplitter::transformAttribute(QDomElement & element, const char * attributeName, double scale, double offset)
+{
+	// normalizeAttribute followed by shiftAttribute
+
+	QString attributeValue = element.attribute(attributeName);
+	double n = 0;
+	bool ok = true;
+	if (!attributeValue.isEmpty()) {
+		n = attributeValue.toDouble(&ok) * scale;
+		if (!ok) {
+			QString string;
+			QTextStream stream(&string);
+			element.save(stream, 0);
+			DebugDialog::debug("bad attribute " + string);
+		}
+	}
+	else if (offset == 0) {
+		return true;
+	}
+
+	element.setAttribute(attributeName, QString::number(n + offset));
+	return ok;
 }
 
 QPainterPath SvgFileSplitter::painterPath(double dpi, const QString & elementID)
@@ -295,11 +509,11 @@ void SvgFileSplitter::painterPathChild(QDomElement & element, QPainterPath & ppa
 	else if (element.nodeName().compare("polygon") == 0 || element.nodeName().compare("polyline") == 0) {
 		QString data = element.attribute("points");
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(painterPathCommandSlot(QChar, bool, QList<double> &, void *));
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { painterPathCommandSlot(command, relative, args, userData); };
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.painterPath = &ppath;
-			if (parsePath(data, slot, pathUserData, this, false)) {
+			if (parsePath(data, slot, pathUserData, false)) {
 			}
 		}
 	}
@@ -307,14 +521,14 @@ void SvgFileSplitter::painterPathChild(QDomElement & element, QPainterPath & ppa
 		/*
 		QString data = element.attribute("d").trimmed();
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(normalizeCommandSlot(QChar, bool, QList<double> &, void *));
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { normalizeCommandSlot(command, relative, args, userData); };
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.sNewHeight = sNewHeight;
 			pathUserData.sNewWidth = sNewWidth;
 			pathUserData.vbHeight = vbHeight;
 			pathUserData.vbWidth = vbWidth;
-		    if (parsePath(data, slot, pathUserData, this, true)) {
+		    if (parsePath(data, slot, pathUserData, true)) {
 				element.setAttribute("d", pathUserData.string);
 			}
 		}
@@ -413,14 +627,14 @@ void SvgFileSplitter::normalizeChild(QDomElement & element,
 		normalizeAttribute(element, "stroke-width", sNewWidth, vbWidth);
 		QString data = element.attribute("points");
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(normalizeCommandSlot(QChar, bool, QList<double> &, void *));
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { normalizeCommandSlot(command, relative, args, userData); };
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.sNewHeight = sNewHeight;
 			pathUserData.sNewWidth = sNewWidth;
 			pathUserData.vbHeight = vbHeight;
 			pathUserData.vbWidth = vbWidth;
-			if (parsePath(data, slot, pathUserData, this, false)) {
+			if (parsePath(data, slot, pathUserData, false)) {
 				pathUserData.string.remove(0, 1);			// get rid of the "M"
 				element.setAttribute("points", pathUserData.string);
 			}
@@ -433,14 +647,14 @@ void SvgFileSplitter::normalizeChild(QDomElement & element,
 		setStrokeOrFill(element, blackOnly, "black", false);
 		QString data = element.attribute("d").trimmed();
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(normalizeCommandSlot(QChar, bool, QList<double> &, void *));
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { normalizeCommandSlot(command, relative, args, userData); };
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.sNewHeight = sNewHeight;
 			pathUserData.sNewWidth = sNewWidth;
 			pathUserData.vbHeight = vbHeight;
 			pathUserData.vbWidth = vbWidth;
-			if (parsePath(data, slot, pathUserData, this, true)) {
+			if (parsePath(data, slot, pathUserData, true)) {
 				element.setAttribute("d", pathUserData.string);
 			}
 		}
@@ -658,12 +872,12 @@ void SvgFileSplitter::shiftChild(QDomElement & element, double x, double y, bool
 	else if (nodeName.compare("polygon") == 0 || nodeName.compare("polyline") == 0) {
 		QString data = element.attribute("points");
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(shiftCommandSlot(QChar, bool, QList<double> &, void *));
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { shiftCommandSlot(command, relative, args, userData); };
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.x = x;
 			pathUserData.y = y;
-			if (parsePath(data, slot, pathUserData, this, false)) {
+			if (parsePath(data, slot, pathUserData, false)) {
 				pathUserData.string.remove(0, 1);			// get rid of the "M"
 				element.setAttribute("points", pathUserData.string);
 			}
@@ -672,12 +886,12 @@ void SvgFileSplitter::shiftChild(QDomElement & element, double x, double y, bool
 	else if (nodeName.compare("path") == 0) {
 		QString data = element.attribute("d").trimmed();
 		if (!data.isEmpty()) {
-			const char * slot = SLOT(shiftCommandSlot(QChar, bool, QList<double> &, void *));
+			auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { shiftCommandSlot(command, relative, args, userData); };
 			PathUserData pathUserData;
 			pathUserData.pathStarting = true;
 			pathUserData.x = x;
 			pathUserData.y = y;
-			if (parsePath(data, slot, pathUserData, this, true)) {
+			if (parsePath(data, slot, pathUserData, true)) {
 				element.setAttribute("d", pathUserData.string);
 			}
 		}
@@ -859,6 +1073,86 @@ void SvgFileSplitter::shiftCommandSlot(QChar command, bool relative, QList<doubl
 	}
 }
 
+void SvgFileSplitter::transformCommandSlot(QChar command, bool relative, QList<double> & args, void * userData) {
+
+	// normalizeCommandSlot then shiftCommandSlot: every coordinate is scaled, absolute ones are then offset
+
+	auto * pathUserData = (PathUserData *) userData;
+	double sx = pathUserData->transform.m11();
+	double sy = pathUserData->transform.m22();
+
+	double d;
+	pathUserData->string.append(command);
+	switch(command.toLatin1()) {
+	case 'z':
+	case 'Z':
+		pathUserData->pathStarting = true;
+		break;
+	case 'a':
+	case 'A':
+		for (int i = 0; i < args.count(); i++) {
+			switch (i % 7) {
+			case 0:
+				d = args[i] * sx;
+				break;
+			case 1:
+				d = args[i] * sy;
+				break;
+			case 5:
+				d = args[i] * sx;
+				if (!relative) {
+					d += pathUserData->x;
+				}
+				break;
+			case 6:
+				d = args[i] * sy;
+				if (!relative) {
+					d += pathUserData->y;
+				}
+				break;
+			default:
+				d = args[i];
+				break;
+			}
+			pathUserData->string.append(QString::number(d));
+			if (i < args.count() - 1) {
+				pathUserData->string.append(',');
+			}
+		}
+		break;
+	case 'm':
+	case 'M':
+		transformArgs(relative, pathUserData->pathStarting, args, pathUserData);
+		pathUserData->pathStarting = false;
+		break;
+	default:
+		transformArgs(relative, false, args, pathUserData);
+		break;
+	}
+}
+
+void SvgFileSplitter::transformArgs(bool relative, bool starting, QList<double> & args, PathUserData * pathUserData) {
+	for (int i = 0; i < args.count(); i++) {
+		double d;
+		if (i % 2 == 0) {
+			d = args[i] * pathUserData->transform.m11();
+			if (!relative || (starting && i == 0)) {
+				d += pathUserData->x;
+			}
+		}
+		else {
+			d = args[i] * pathUserData->transform.m22();
+			if (!relative || (starting && i == 1)) {
+				d += pathUserData->y;
+			}
+		}
+		pathUserData->string.append(QString::number(d));
+		if (i < args.count() - 1) {
+			pathUserData->string.append(',');
+		}
+	}
+}
+
 void SvgFileSplitter::standardArgs(bool relative, bool starting, QList<double> & args, PathUserData * pathUserData) {
 	for (int i = 0; i < args.count(); i++) {
 		double d = args[i];
@@ -880,51 +1174,28 @@ void SvgFileSplitter::standardArgs(bool relative, bool starting, QList<double> &
 }
 
 QVector<QVariant> SvgFileSplitter::simpleParsePath(const QString & data) {
-	static QVector<QVariant> emptyStack;
-
-	QString dataCopy(data);
-
-	if (!dataCopy.startsWith('M', Qt::CaseInsensitive)) {
-		dataCopy.prepend('M');
-	}
-	while (dataCopy.at(dataCopy.length() - 1).isSpace()) {
-		dataCopy.remove(dataCopy.length() - 1, 1);
-	}
-	QChar last = dataCopy.at(dataCopy.length() - 1);
-	if (last != 'z' && last != 'Z' && last != SVGPathLexer::FakeClosePathChar) {
-		dataCopy.append(SVGPathLexer::FakeClosePathChar);
-	}
-
-	SVGPathLexer lexer(dataCopy);
-	SVGPathParser parser;
-	if (!parser.parse(lexer)) {
-		//DebugDialog::debug(QString("svg path parse failed %1").arg(dataCopy));
-		return emptyStack;
-	}
-
-	return parser.symStack();
+	// commands as QChar and their arguments as double, in order; empty when the path does not parse
+	QVector<QVariant> symStack;
+	bool ok = SVGPathScanner::scan(QStringView(data), [&symStack](QChar command, bool /* relative */, QList<double> & args) {
+		symStack.append(command);
+		Q_FOREACH (double arg, args) {
+			symStack.append(arg);
+		}
+	});
+	if (!ok) symStack.clear();
+	return symStack;
 }
 
+QString SvgFileSplitter::convertHVPath(const QString & data) {
+	// the same path with H and V turned into L; empty when it does not parse
+	HVConvertData hvData;
+	hvData.x = hvData.y = hvData.subX = hvData.subY = 0;
+	bool ok = SVGPathScanner::scan(QStringView(data), [this, &hvData](QChar command, bool relative, QList<double> & args) {
+		convertHVSlot(command, relative, args, &hvData);
+	});
+	if (!ok) return QString();
 
-bool SvgFileSplitter::parsePath(const QString & dataString, const char * slot, PathUserData & pathUserData, QObject * slotTarget, bool convertHV) {
-	QVector<QVariant> symStack = simpleParsePath(dataString);
-
-	if (convertHV && (dataString.contains("h", Qt::CaseInsensitive) || dataString.contains("v",  Qt::CaseInsensitive)))
-	{
-		SVGPathRunner svgPathRunner;
-		HVConvertData data;
-		data.x = data.y = data.subX = data.subY = 0;
-		data.path = "";
-		connect(&svgPathRunner, SIGNAL(commandSignal(QChar, bool, QList<double> &, void *)),
-		        this, SLOT(convertHVSlot(QChar, bool, QList<double> &, void *)),
-		        Qt::DirectConnection);
-		svgPathRunner.runPath(symStack, &data);
-		return parsePath(data.path, slot, pathUserData, slotTarget, false);
-	}
-
-	SVGPathRunner svgPathRunner;
-	connect(&svgPathRunner, SIGNAL(commandSignal(QChar, bool, QList<double> &, void *)), slotTarget, slot, Qt::DirectConnection);
-	return svgPathRunner.runPath(symStack, &pathUserData);
+	return hvData.path;
 }
 
 void SvgFileSplitter::convertHVSlot(QChar command, bool /* relative */, QList<double> & args, void * userData) {
@@ -30,6 +30,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QPainterPath>
 #include <QFile>
 
+#include "svgpathscanner.h"
+
 struct PathUserData {
 	QString string;
 	QTransform transform;
@@ -54,8 +56,10 @@ public:
 	const QDomDocument & domDocument() const noexcept { return m_domDocument; }
 	bool normalize(double dpi, const QString & elementID, bool blackOnly, double & factor);
 	QString shift(double x, double y, const QString & elementID, bool shiftTransforms);
+	QString normalizeAndShift(double dpi, const QString & elementID, bool blackOnly, double x, double y, bool shiftTransforms, double & factor);
+	QString transformGeometry(const QString & elementID, const QTransform & affine, double unitScale, bool blackOnly, bool shiftTransforms);
 	QString elementString(const QString & elementID);
-	virtual bool parsePath(const QString & data, const char * slot, PathUserData &, QObject * slotTarget, bool convertHV);
+	template<typename Visitor> bool parsePath(const QString & data, Visitor && visitor, PathUserData &, bool convertHV);
 	QVector<QVariant> simpleParsePath(const QString & data);
 	QPainterPath painterPath(double dpi, const QString & elementID);			// note: only partially implemented
 	void shiftChild(QDomElement & element, double x, double y, bool shiftTransforms);
@@ -86,6 +90,7 @@ protected:
 	void normalizeChild(QDomElement & childElement,
 	                    double sNewWidth, double sNewHeight,
 	                    double vbWidth, double vbHeight, bool blackOnly);
+	bool normalizeRoot(double dpi, double & sNewWidth, double & sNewHeight, double & vbWidth, double & vbHeight);
 	bool normalizeAttribute(QDomElement & element, const char * attributeName, double num, double denom);
 	bool normalizeArrayAttribute(QDomElement & element, const char * attributeName, double num, double denom);
 	bool normalizeFontSize(QDomElement & element, const char * attributeName, double num, double denom);
@@ -95,6 +100,10 @@ protected:
 	                          double vbWidth, double vbHeight);
 	bool shiftTranslation(QDomElement & element, double x, double y);
 	void standardArgs(bool relative, bool starting, QList<double> & args, PathUserData * pathUserData);
+	void transformChild(QDomElement & element, const QTransform & affine, double unitScale, bool blackOnly, bool shiftTransforms, bool translate);
+	bool transformAttribute(QDomElement & element, const char * attributeName, double scale, double offset);
+	void transformArgs(bool relative, bool starting, QList<double> & args, PathUserData * pathUserData);
+	QString convertHVPath(const QString & data);
 
 protected:
 	static bool shiftAttribute(QDomElement & element, const char * attributeName, double d);
@@ -105,6 +114,7 @@ protected:
 protected Q_SLOTS:
 	void normalizeCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
 	void shiftCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
+	void transformCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
 	virtual void rotateCommandSlot(QChar, bool, QList<double> &, void *) {}
 	void painterPathCommandSlot(QChar command, bool relative, QList<double> & args, void * userData);
 	void convertHVSlot(QChar command, bool relative, QList<double> & args, void * userData);
@@ -115,4 +125,21 @@ protected:
 
 };
 
+template<typename Visitor>
+bool SvgFileSplitter::parsePath(const QString & data, Visitor && visitor, PathUserData & pathUserData, bool convertHV)
+{
+	// the visitor is called as visitor(command, relative, args, &pathUserData) once per command;
+	// with convertHV, horizontal and vertical lines come through as line-tos
+	if (convertHV && (data.contains('h', Qt::CaseInsensitive) || data.contains('v', Qt::CaseInsensitive))) {
+		QString converted = convertHVPath(data);
+		if (converted.isEmpty()) return false;
+
+		return parsePath(converted, visitor, pathUserData, false);
+	}
+
+	return SVGPathScanner::scan(QStringView(data), [&visitor, &pathUserData](QChar command, bool relative, QList<double> & args) {
+		visitor(command, relative, args, &pathUserData);
+	});
+}
+
 #endif
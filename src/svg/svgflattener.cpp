@@ -25,6 +25,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../debugdialog.h"
 #include <QTransform>
 #include <QTextStream>
+#include <QVector>
+#include <QtConcurrentMap>
 #include <qmath.h>
 #include <stdexcept>
 
@@ -77,6 +79,64 @@ void SvgFlattener::flattenChildren(QDomElement &element, const SvgAttributesMap
 		flattenChildren(child, attributes);
 	}
 
+	flattenElement(element, attributes);
+}
+
+void SvgFlattener::flattenChildrenConcurrently(QDomElement & element, const SvgAttributesMap & inherited_attributes) {
+	// flattenChildren with the subtree under each child element, typically one part's fragment of an export,
+	// flattened on a thread of its own; QDom is reentrant but not thread safe, so each subtree is flattened
+	// in a document of its own and then swapped in for the original
+	const SvgAttributesMap attributes = mergeSvgAttributes(inherited_attributes, element);
+
+	QList<QDomElement> children;
+	for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+		children.append(child);
+	}
+
+	if (children.count() < 2) {
+		flattenChildren(element, inherited_attributes);
+		return;
+	}
+
+	struct Fragment {
+		QString svg;
+		QDomDocument doc;
+		bool flattened = false;
+	};
+
+	QVector<Fragment> fragments(children.count());
+	for (int i = 0; i < children.count(); i++) {
+		QTextStream stream(&fragments[i].svg);
+		children.at(i).save(stream, -1);
+	}
+
+	QtConcurrent::blockingMap(fragments, [&attributes](Fragment & fragment) {
+		if (!fragment.doc.setContent(fragment.svg)) return;
+
+		QDomElement root = fragment.doc.documentElement();
+		SvgFlattener flattener;
+		flattener.flattenChildren(root, attributes);
+		fragment.flattened = true;
+	});
+
+	QDomDocument ownerDocument = element.ownerDocument();
+	for (int i = 0; i < children.count(); i++) {
+		QDomElement child = children.at(i);
+		if (fragments.at(i).flattened) {
+			QDomNode flat = ownerDocument.importNode(fragments.at(i).doc.documentElement(), true);
+			element.replaceChild(flat, child);
+		}
+		else {
+			flattenChildren(child, attributes);
+		}
+	}
+
+	flattenElement(element, attributes);
+}
+
+void SvgFlattener::flattenElement(QDomElement & element, const SvgAttributesMap & attributes) {
+	// bakes the element's own transform into its already flattened children
+
 	bool didOtherTransform = false;
 	//do translate
 	if(hasTranslate(element)) {
@@ -125,10 +185,10 @@ void SvgFlattener::unRotateChild(QDomElement & element, QTransform transform, co
 		if(tag == "path") {
 			QString data = element.attribute("d").trimmed();
 			if (!data.isEmpty()) {
-				const char * slot = SLOT(rotateCommandSlot(QChar, bool, QList<double> &, void *));
+				auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { rotateCommandSlot(command, relative, args, userData); };
 				PathUserData pathUserData;
 				pathUserData.transform = transform;
-				if (parsePath(data, slot, pathUserData, this, true)) {
+				if (parsePath(data, slot, pathUserData, true)) {
 					element.setAttribute("d", pathUserData.string);
 				}
 			}
@@ -136,10 +196,10 @@ void SvgFlattener::unRotateChild(QDomElement & element, QTransform transform, co
 		else if ((tag == "polygon") || (tag == "polyline")) {
 			QString data = element.attribute("points");
 			if (!data.isEmpty()) {
-				const char * slot = SLOT(rotateCommandSlot(QChar, bool, QList<double> &, void *));
+				auto slot = [this](QChar command, bool relative, QList<double> & args, void * userData) { rotateCommandSlot(command, relative, args, userData); };
 				PathUserData pathUserData;
 				pathUserData.transform = transform;
-				if (parsePath(data, slot, pathUserData, this, false)) {
+				if (parsePath(data, slot, pathUserData, false)) {
 					pathUserData.string.remove(0, 1);			// get rid of the "M"
 					element.setAttribute("points", pathUserData.string);
 				}
@@ -34,6 +34,7 @@ public:
 	SvgFlattener();
 
 	void flattenChildren(QDomElement &element, const SvgAttributesMap &attributes);
+	void flattenChildrenConcurrently(QDomElement &element, const SvgAttributesMap &attributes);
 	void unRotateChild(QDomElement &element, QTransform transform, const SvgAttributesMap & attributes);
 	void applyAttributes(QDomElement &element, QTransform transform, const SvgAttributesMap & attributes);
 
@@ -43,6 +44,7 @@ public:
 
 
 protected:
+	void flattenElement(QDomElement & element, const SvgAttributesMap & attributes);
 	static QString flipSMDElement(QDomDocument & domDocument, QDomElement & element, const QString & att, QDomElement altAtt, const QString & altElementID, double printerScale, Qt::Orientations);
 	static bool hasOtherTransform(QDomElement & element);
 	static bool hasTranslate(QDomElement & element);
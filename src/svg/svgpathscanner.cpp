@@ -0,0 +1,179 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "svgpathscanner.h"
+
+#include <QLocale>
+
+int SVGPathScanner::argCount(QChar command)
+{
+	// -1 for a character that is not a path command
+	switch (command.toLatin1()) {
+	case 'M': case 'm':
+	case 'L': case 'l':
+	case 'T': case 't':
+		return 2;
+	case 'H': case 'h':
+	case 'V': case 'v':
+		return 1;
+	case 'C': case 'c':
+		return 6;
+	case 'S': case 's':
+	case 'Q': case 'q':
+		return 4;
+	case 'A': case 'a':
+		return 7;
+	case 'Z': case 'z':
+	case FakeClosePathChar:
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+bool SVGPathScanner::startsNumber(QChar c)
+{
+	return c.isDigit() || c == QLatin1Char('.') || c == QLatin1Char('-') || c == QLatin1Char('+');
+}
+
+void SVGPathScanner::skipSeparators(QStringView data, qsizetype & pos)
+{
+	// whitespace with at most one comma in it
+	bool comma = false;
+	while (pos < data.size()) {
+		QChar c = data.at(pos);
+		if (c.isSpace()) pos++;
+		else if (c == QLatin1Char(',') && !comma) {
+			comma = true;
+			pos++;
+		}
+		else break;
+	}
+}
+
+bool SVGPathScanner::readNumber(QStringView data, qsizetype & pos, double & number)
+{
+	// [-+]?[0-9]*\.?[0-9]*([eE][-+]?[0-9]+)? with at least one digit; a second point starts the next number
+	qsizetype start = pos;
+	qsizetype i = pos;
+	if (i < data.size() && (data.at(i) == QLatin1Char('-') || data.at(i) == QLatin1Char('+'))) i++;
+	int digits = 0;
+	while (i < data.size() && data.at(i).isDigit()) {
+		i++;
+		digits++;
+	}
+	if (i < data.size() && data.at(i) == QLatin1Char('.')) {
+		i++;
+		while (i < data.size() && data.at(i).isDigit()) {
+			i++;
+			digits++;
+		}
+	}
+	if (digits == 0) return false;
+
+	if (i < data.size() && (data.at(i) == QLatin1Char('e') || data.at(i) == QLatin1Char('E'))) {
+		qsizetype e = i + 1;
+		if (e < data.size() && (data.at(e) == QLatin1Char('-') || data.at(e) == QLatin1Char('+'))) e++;
+		if (e < data.size() && data.at(e).isDigit()) {
+			while (e < data.size() && data.at(e).isDigit()) e++;
+			i = e;
+		}
+	}
+
+	bool ok;
+	number = QLocale::c().toDouble(data.mid(start, i - start), &ok);
+	if (!ok) return false;
+
+	pos = i;
+	return true;
+}
+
+bool SVGPathScanner::readFlag(QStringView data, qsizetype & pos, double & number)
+{
+	// arc flags are a single 0 or 1 and need no separator after them
+	if (pos >= data.size()) return false;
+
+	QChar c = data.at(pos);
+	if (c != QLatin1Char('0') && c != QLatin1Char('1')) return false;
+
+	number = (c == QLatin1Char('1')) ? 1 : 0;
+	pos++;
+	return true;
+}
+
+bool SVGPathScanner::tokenize(QStringView data, QVector<Command> & commands, QVector<double> & numbers)
+{
+	// the path must start with a moveto, and every command but a close takes whole groups of arguments;
+	// data starting with a number, such as polygon points, gets a moveto in front, and the fake close
+	// ends a path without being handed on
+	qsizetype pos = 0;
+	while (pos < data.size() && data.at(pos).isSpace()) pos++;
+	if (pos >= data.size()) return false;
+
+	bool implicitMoveto = false;
+	QChar first = data.at(pos);
+	if (first != QLatin1Char('M') && first != QLatin1Char('m')) {
+		if (!startsNumber(first)) return false;
+		implicitMoveto = true;
+	}
+
+	while (true) {
+		while (pos < data.size() && data.at(pos).isSpace()) pos++;
+		if (pos >= data.size()) return true;
+
+		QChar c = QLatin1Char('M');
+		if (implicitMoveto) implicitMoveto = false;
+		else c = data.at(pos++);
+		int argCount = SVGPathScanner::argCount(c);
+		if (argCount < 0) return false;
+
+		if (argCount == 0) {
+			if (c != QLatin1Char(FakeClosePathChar)) {
+				Command command;
+				command.command = c;
+				command.first = numbers.count();
+				commands.append(command);
+			}
+			continue;
+		}
+
+		Command command;
+		command.command = c;
+		command.first = numbers.count();
+		bool arc = (argCount == 7);
+		while (true) {
+			skipSeparators(data, pos);
+			if (pos >= data.size()) break;
+
+			if (!startsNumber(data.at(pos))) break;
+
+			double number;
+			int index = command.count % argCount;
+			bool ok = (arc && (index == 3 || index == 4)) ? readFlag(data, pos, number) : readNumber(data, pos, number);
+			if (!ok) return false;
+
+			numbers.append(number);
+			command.count++;
+		}
+		if (command.count == 0 || command.count % argCount != 0) return false;
+
+		commands.append(command);
+	}
+}
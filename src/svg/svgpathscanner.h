@@ -0,0 +1,76 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef SVGPATHSCANNER_H
+#define SVGPATHSCANNER_H
+
+#include <QChar>
+#include <QList>
+#include <QStringView>
+#include <QVector>
+
+class SVGPathScanner
+{
+	// svg path data read in place into commands and their numbers, handed to a visitor called as
+	// visitor(QChar command, bool relative, QList<double> & args) with all the argument groups of a command;
+	// nothing is handed over unless the whole path parses; replaces SVGPathLexer, SVGPathParser and SVGPathRunner
+	// on the load and export paths, without copying the data or dispatching through the meta-object system
+
+public:
+	template<typename Visitor> static bool scan(QStringView data, Visitor && visitor);
+	static int argCount(QChar command);
+
+public:
+	static constexpr char FakeClosePathChar = 'x';
+
+protected:
+	struct Command {
+		QChar command;
+		int first = 0;                      // into the numbers
+		int count = 0;
+	};
+
+	static bool tokenize(QStringView data, QVector<Command> &, QVector<double> & numbers);
+	static bool readNumber(QStringView data, qsizetype & pos, double & number);
+	static bool readFlag(QStringView data, qsizetype & pos, double & number);
+	static void skipSeparators(QStringView data, qsizetype & pos);
+	static bool startsNumber(QChar);
+};
+
+template<typename Visitor>
+bool SVGPathScanner::scan(QStringView data, Visitor && visitor)
+{
+	QVector<Command> commands;
+	QVector<double> numbers;
+	if (!tokenize(data, commands, numbers)) return false;
+
+	QList<double> args;
+	args.reserve(numbers.count());
+	for (const Command & command : commands) {
+		args.clear();
+		for (int i = 0; i < command.count; i++) {
+			args.append(numbers.at(command.first + i));
+		}
+		visitor(command.command, command.command.isLower(), args);
+	}
+	return true;
+}
+
+#endif
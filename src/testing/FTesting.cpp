@@ -20,6 +20,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "FTesting.h"
 #include "FTestingServer.h"
+#include "FTimingProbe.h"
 
 #include "../utils/fmessagebox.h"
 #include "../utils/folderutils.h"
@@ -32,10 +33,8 @@ FTesting::FTesting() {
 }
 
 std::shared_ptr<FTesting> FTesting::getInstance() {
-    static std::shared_ptr<FTesting> instance;
-    if (!instance) {
-	    instance.reset(new FTesting);
-    }
+    // timing probes register from whichever thread first runs their hot path
+    static std::shared_ptr<FTesting> instance(new FTesting);
     return instance;
 }
 
@@ -44,17 +43,20 @@ FTesting::~FTesting() {
 
 void FTesting::init() {
     if(m_initialized) return;
+    new FTimingSummaryProbe();
     initServer();
     m_initialized = true;
 }
 
 void FTesting::addProbe(FProbe * probe)
 {
+    QMutexLocker locker(&m_probeMutex);
     m_probeMap[probe->name()] = probe;
 }
 
 stdx::optional<QVariant> FTesting::readProbe(std::string name)
 {
+    QMutexLocker locker(&m_probeMutex);
     if(m_probeMap.find(name) != m_probeMap.end()) {
 	return m_probeMap[name]->read();
     }
@@ -63,6 +65,7 @@ stdx::optional<QVariant> FTesting::readProbe(std::string name)
 
 void FTesting::writeProbe(std::string name, QVariant param)
 {
+    QMutexLocker locker(&m_probeMutex);
     if(m_probeMap.find(name) != m_probeMap.end()) {
 	m_probeMap[name]->write(param);
     }
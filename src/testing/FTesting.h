@@ -120,6 +120,7 @@ protected:
 private:
 	bool m_initialized = false;
 	std::map<std::string, FProbe *> m_probeMap;
+	QMutex m_probeMutex;
 };
 
 #endif
@@ -0,0 +1,129 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "FTimingProbe.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+
+static QMutex TimingProbesMutex;
+
+static QList<FTimingProbe *> & timingProbes()
+{
+	static QList<FTimingProbe *> probes;
+	return probes;
+}
+
+static QString milliseconds(qint64 ns)
+{
+	return QString::number(ns / 1.0e6, 'f', 3);
+}
+
+////////////////////////////////////////////////////
+
+FTimingProbe::Scope::Scope(FTimingProbe & probe) :
+	m_probe(probe)
+{
+	m_timer.start();
+}
+
+FTimingProbe::Scope::~Scope()
+{
+	m_probe.record(m_timer.nsecsElapsed());
+}
+
+////////////////////////////////////////////////////
+
+FTimingProbe::FTimingProbe(const std::string & name) :
+	FProbe("Timing." + name)
+{
+	QMutexLocker locker(&TimingProbesMutex);
+	timingProbes().append(this);
+}
+
+void FTimingProbe::record(qint64 ns)
+{
+	// scopes may close on worker threads
+	QMutexLocker locker(&m_mutex);
+	if (m_calls == 0 || ns < m_minNs) m_minNs = ns;
+	if (ns > m_maxNs) m_maxNs = ns;
+	m_lastNs = ns;
+	m_totalNs += ns;
+	m_calls++;
+}
+
+void FTimingProbe::reset()
+{
+	QMutexLocker locker(&m_mutex);
+	m_calls = m_totalNs = m_minNs = m_maxNs = m_lastNs = 0;
+}
+
+QVariant FTimingProbe::read()
+{
+	QMutexLocker locker(&m_mutex);
+	qint64 mean = m_calls == 0 ? 0 : m_totalNs / m_calls;
+	return QString("%1 %2 %3 %4 %5 %6")
+		.arg(m_calls)
+		.arg(milliseconds(m_totalNs))
+		.arg(milliseconds(mean))
+		.arg(milliseconds(m_minNs))
+		.arg(milliseconds(m_maxNs))
+		.arg(milliseconds(m_lastNs));
+}
+
+void FTimingProbe::write(QVariant)
+{
+	reset();
+}
+
+QList<FTimingProbe *> FTimingProbe::all()
+{
+	QMutexLocker locker(&TimingProbesMutex);
+	return timingProbes();
+}
+
+void FTimingProbe::resetAll()
+{
+	Q_FOREACH (FTimingProbe * probe, all()) {
+		probe->reset();
+	}
+}
+
+////////////////////////////////////////////////////
+
+FTimingSummaryProbe::FTimingSummaryProbe() :
+	FProbe("Timings")
+{
+}
+
+QVariant FTimingSummaryProbe::read()
+{
+	// probes only exist once their hot path has run, so an idle probe is simply missing
+	QStringList lines;
+	Q_FOREACH (FTimingProbe * probe, FTimingProbe::all()) {
+		lines << QString("%1 %2").arg(QString::fromStdString(probe->name()), probe->read().toString());
+	}
+	return lines.join("\n");
+}
+
+void FTimingSummaryProbe::write(QVariant)
+{
+	FTimingProbe::resetAll();
+}
@@ -0,0 +1,81 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef FTIMINGPROBE_H
+#define FTIMINGPROBE_H
+
+#include "FProbe.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+
+class FTimingProbe : public FProbe {
+	// accumulates the time spent in a hot path, for automated perf tests;
+	// read answers "calls total_ms mean_ms min_ms max_ms last_ms", any write resets it.
+	// Place one as a function static with a Scope next to it:
+	//	static FTimingProbe probe("renderToSVG");
+	//	FTimingProbe::Scope timing(probe);
+
+public:
+	class Scope {
+	public:
+		explicit Scope(FTimingProbe &);
+		~Scope();
+
+	protected:
+		FTimingProbe & m_probe;
+		QElapsedTimer m_timer;
+	};
+
+public:
+	FTimingProbe(const std::string & name);
+	~FTimingProbe() {};
+
+	QVariant read();
+	void write(QVariant);
+	void reset();
+	void record(qint64 ns);
+
+public:
+	static QList<FTimingProbe *> all();
+	static void resetAll();
+
+protected:
+	QMutex m_mutex;
+	qint64 m_calls = 0;
+	qint64 m_totalNs = 0;
+	qint64 m_minNs = 0;
+	qint64 m_maxNs = 0;
+	qint64 m_lastNs = 0;
+};
+
+class FTimingSummaryProbe : public FProbe {
+	// "Timings": read lists every timing probe, one per line; any write resets them all
+
+public:
+	FTimingSummaryProbe();
+	~FTimingSummaryProbe() {};
+
+	QVariant read();
+	void write(QVariant);
+};
+
+#endif
@@ -22,8 +22,12 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "graphicsutils.h"
 #include "../debugdialog.h"
 #include <qmath.h>
+#include <algorithm>
 #include <limits>
 
+static constexpr int ArcLengthSegments = 32;
+static constexpr int ArcLengthOrder = 8;
+
 /////////////////////////////////////////////
 
 // borrowed liberally from the following sources:
@@ -134,7 +138,8 @@ Bezier::Bezier(const Bezier& other) :
 		m_cp0(other.m_cp0),
 		m_cp1(other.m_cp1),
 		m_isEmpty(other.m_isEmpty),
-		m_drag_cp0(other.m_drag_cp0)
+		m_drag_cp0(other.m_drag_cp0),
+		m_arcLengths(other.m_arcLengths)
 {
 
 }
@@ -152,22 +157,27 @@ Bezier::Bezier(QPointF endpoint0, QPointF endpoint1, QPointF cp0, QPointF cp1) n
 void Bezier::clear()
 {
 	m_isEmpty = true;
+	invalidateArcLengths();
 }
 
 void Bezier::set_cp0(QPointF cp0)
 {
+	if (cp0 != m_cp0) invalidateArcLengths();
 	m_cp0 = cp0;
 	m_isEmpty = false;
 }
 
 void Bezier::set_cp1(QPointF cp1)
 {
+	if (cp1 != m_cp1) invalidateArcLengths();
 	m_cp1 = cp1;
 	m_isEmpty = false;
 }
 
 void Bezier::set_endpoints(QPointF ep0, QPointF ep1)
 {
+	// legs set their endpoints before every measurement, mostly to the same values
+	if (ep0 != m_endpoint0 || ep1 != m_endpoint1) invalidateArcLengths();
 	m_endpoint0 = ep0;
 	m_endpoint1 = ep1;
 }
@@ -256,11 +266,13 @@ void Bezier::recalc(QPointF p)
 							);
 	*/
 
+	invalidateArcLengths();
 	m_isEmpty = false;
 }
 
 void Bezier::initToEnds(QPointF cp0, QPointF cp1)
 {
+	invalidateArcLengths();
 	m_endpoint0 = cp0;
 	m_cp0 = cp0;
 	m_endpoint1 = cp1;
@@ -315,6 +327,8 @@ void Bezier::split(double t, Bezier & left, Bezier & right) const noexcept
 	right.m_endpoint1 = m_endpoint1;
 	left.m_isEmpty = false;
 	right.m_isEmpty = false;
+	left.invalidateArcLengths();
+	right.invalidateArcLengths();
 }
 Bezier::SplitBezier Bezier::split(double t) const noexcept
 {
@@ -338,8 +352,8 @@ Bezier::SplitBezier Bezier::split(double t) const noexcept
 void Bezier::initControlIndex(QPointF p, double width)
 {
 	double t = findSplit(p, width);
-	double totalLen = computeCubicCurveLength(1, 24);
-	double len = computeCubicCurveLength(t, 24);
+	double totalLen = length();
+	double len = lengthAt(t);
 	//double d0 = GraphicsUtils::distanceSqd(p, m_cp0);
 	//double d1 = GraphicsUtils::distanceSqd(p, m_cp1);
 	m_drag_cp0 = (len <= totalLen / 2);
@@ -361,6 +375,74 @@ double Bezier::computeCubicCurveLength(double z, int n) const noexcept
 	return z2 * sum;
 }
 
+double Bezier::gaussLength(double t0, double t1, int n) const noexcept
+{
+	double half = (t1 - t0) / 2.0;
+	double sum = 0;
+	for (int i = 0; i < n; i++) {
+		sum += Cvalues[n][i] * cubicF(half * Tvalues[n][i] + half + t0);
+	}
+	return half * sum;
+}
+
+void Bezier::ensureArcLengths() const
+{
+	// each segment is short and smooth, so a low order quadrature per segment matches
+	// computeCubicCurveLength(t, 24) to well under a thousandth of a pixel
+	if (!m_arcLengths.isEmpty()) return;
+
+	m_arcLengths.resize(ArcLengthSegments + 1);
+	m_arcLengths[0] = 0;
+	for (int i = 1; i <= ArcLengthSegments; i++) {
+		m_arcLengths[i] = m_arcLengths[i - 1] + gaussLength((i - 1) / (double) ArcLengthSegments, i / (double) ArcLengthSegments, ArcLengthOrder);
+	}
+}
+
+void Bezier::invalidateArcLengths() noexcept
+{
+	m_arcLengths.clear();
+}
+
+double Bezier::length() const
+{
+	ensureArcLengths();
+	return m_arcLengths.last();
+}
+
+double Bezier::lengthAt(double t) const
+{
+	ensureArcLengths();
+	t = qBound(0.0, t, 1.0);
+	int i = qMin((int) (t * ArcLengthSegments), ArcLengthSegments - 1);
+	double ti = i / (double) ArcLengthSegments;
+	return m_arcLengths.at(i) + gaussLength(ti, t, ArcLengthOrder);
+}
+
+double Bezier::tAtLength(double length) const
+{
+	// finds the segment in the table, then refines t by Newton's method, the derivative being the speed
+	ensureArcLengths();
+	if (length <= 0) return 0;
+	if (length >= m_arcLengths.last()) return 1;
+
+	int i = std::upper_bound(m_arcLengths.constBegin(), m_arcLengths.constEnd(), length) - m_arcLengths.constBegin() - 1;
+	i = qBound(0, i, ArcLengthSegments - 1);
+	double t0 = i / (double) ArcLengthSegments;
+	double t1 = (i + 1) / (double) ArcLengthSegments;
+	double segment = m_arcLengths.at(i + 1) - m_arcLengths.at(i);
+	double t = (segment <= 0) ? t0 : t0 + (t1 - t0) * (length - m_arcLengths.at(i)) / segment;
+	for (int step = 0; step < 4; step++) {
+		double error = m_arcLengths.at(i) + gaussLength(t0, t, ArcLengthOrder) - length;
+		if (qAbs(error) < .0001) break;
+
+		double speed = cubicF(t);
+		if (speed <= 0) break;
+
+		t = qBound(t0, t - error / speed, t1);
+	}
+	return t;
+}
+
 double Bezier::cubicF(double t) const noexcept
 {
 	double xbase = base3(t, m_endpoint0.x(), m_cp0.x(), m_cp1.x(), m_endpoint1.x());
@@ -382,13 +464,14 @@ void Bezier::copy(const Bezier * other)
 	m_endpoint1 = other->m_endpoint1;
 	m_isEmpty = other->m_isEmpty;
 	m_drag_cp0 = other->m_drag_cp0;
+	m_arcLengths = other->m_arcLengths;
 }
 
 double Bezier::findSplit(QPointF p, double minDistance) const noexcept
 {
 	double bestT = 0;
 	double lastDistance = std::numeric_limits<int>::max();
-	double blen = computeCubicCurveLength(1.0, 24);
+	double blen = length();
 	double increment = 1.0 / blen;
 	double minDSqd = minDistance * minDistance;
 	for (double t = 0; t <= 1; t += increment) {
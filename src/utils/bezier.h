@@ -22,6 +22,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #define BEZIER_H
 
 #include <QPointF>
+#include <QVector>
 #include <QDomElement>
 #include <QXmlStreamWriter>
 #include <tuple>
@@ -57,6 +58,9 @@ public:
 	SplitBezier split(double t) const noexcept;
 	void initControlIndex(QPointF fromPoint, double width);
 	double computeCubicCurveLength(double z, int n) const noexcept;
+	double length() const;
+	double lengthAt(double t) const;
+	double tAtLength(double length) const;
 	void copy(const Bezier *);
 	double findSplit(QPointF p, double minDistance) const noexcept;
 	void translateToZero();
@@ -67,6 +71,9 @@ public:
 
 protected:
 	double cubicF(double t) const noexcept;
+	double gaussLength(double t0, double t1, int n) const noexcept;
+	void ensureArcLengths() const;
+	void invalidateArcLengths() noexcept;
 
 private:
 	// This is not used so far, and had misguiding parameter names.
@@ -83,6 +90,7 @@ protected:
 	QPointF m_cp1;
 	bool m_isEmpty;
 	bool m_drag_cp0 = false;
+	mutable QVector<double> m_arcLengths;   // length from t = 0 to t = i / ArcLengthSegments; empty until needed
 };
 
 #endif
@@ -0,0 +1,70 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "cachecounters.h"
+
+CacheCounters::CacheCounters(const char * name) : m_name(name)
+{
+	// instances are file statics, so they register during static initialization, before any thread starts
+	registry().append(this);
+}
+
+void CacheCounters::hit()
+{
+	m_hits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CacheCounters::miss()
+{
+	m_misses.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CacheCounters::count(bool hit)
+{
+	if (hit) this->hit();
+	else miss();
+}
+
+const char * CacheCounters::name() const
+{
+	return m_name;
+}
+
+quint64 CacheCounters::hits() const
+{
+	return m_hits.load(std::memory_order_relaxed);
+}
+
+quint64 CacheCounters::misses() const
+{
+	return m_misses.load(std::memory_order_relaxed);
+}
+
+QList<const CacheCounters *> CacheCounters::all()
+{
+	return registry();
+}
+
+QList<const CacheCounters *> & CacheCounters::registry()
+{
+	// a function static, so that it exists whichever file's counters are initialized first
+	static QList<const CacheCounters *> Registry;
+	return Registry;
+}
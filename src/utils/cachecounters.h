@@ -0,0 +1,55 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef CACHECOUNTERS_H
+#define CACHECOUNTERS_H
+
+#include <QList>
+
+#include <atomic>
+
+class CacheCounters
+{
+	// hits and misses of one of the process-wide caches, counted from any thread;
+	// every instance is listed by all(), so the -port server's /metrics can report them without knowing the caches
+
+public:
+	explicit CacheCounters(const char * name);
+
+	void hit();
+	void miss();
+	void count(bool hit);
+	const char * name() const;
+	quint64 hits() const;
+	quint64 misses() const;
+
+public:
+	static QList<const CacheCounters *> all();
+
+protected:
+	static QList<const CacheCounters *> & registry();
+
+protected:
+	const char * m_name;
+	std::atomic<quint64> m_hits { 0 };
+	std::atomic<quint64> m_misses { 0 };
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "euclideanmst.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+int findRoot(QVector<int> & parents, int node)
+{
+	while (parents.at(node) != node) {
+		parents[node] = parents.at(parents.at(node));
+		node = parents.at(node);
+	}
+	return node;
+}
+
+double distance2(const QPointF & p1, const QPointF & p2)
+{
+	double dx = p1.x() - p2.x();
+	double dy = p1.y() - p2.y();
+	return (dx * dx) + (dy * dy);
+}
+
+quint64 edgeKey(int i, int j)
+{
+	if (i > j) std::swap(i, j);
+	return (((quint64) (quint32) i) << 32) | (quint32) j;
+}
+
+}
+
+QVector<QPair<int, int>> EuclideanMST::spanningTree(const QVector<QPointF> & points, const QVector<int> & groups)
+{
+	// points with the same group are already joined, so the tree only joins groups to each other;
+	// for any split of the points the shortest edge across it is a Delaunay edge, so Kruskal over
+	// the triangulation gives the same tree as over all pairs
+	QVector<QPair<int, int>> tree;
+	int count = points.count();
+	if (count < 2) return tree;
+
+	int groupCount = 0;
+	Q_FOREACH (int group, groups) {
+		groupCount = qMax(groupCount, group + 1);
+	}
+	QVector<int> parents(groupCount);
+	std::iota(parents.begin(), parents.end(), 0);
+	int components = groupCount;
+
+	QVector<QPair<int, int>> candidates = delaunayEdges(points);
+	QVector<double> lengths;
+	lengths.reserve(candidates.count());
+	for (const auto & edge : candidates) {
+		lengths.append(distance2(points.at(edge.first), points.at(edge.second)));
+	}
+
+	QVector<int> order(candidates.count());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&lengths](int i, int j) { return lengths.at(i) < lengths.at(j); });
+
+	for (int index : order) {
+		if (components <= 1) break;
+
+		const QPair<int, int> & edge = candidates.at(index);
+		int root1 = findRoot(parents, groups.at(edge.first));
+		int root2 = findRoot(parents, groups.at(edge.second));
+		if (root1 == root2) continue;
+
+		parents[root2] = root1;
+		components--;
+		tree.append(edge);
+	}
+
+	if (components > 1) {
+		// a degenerate triangulation (nearly collinear points, say) can miss edges; join what is left directly
+		QVector<QPair<int, int>> rest;
+		QVector<double> restLengths;
+		for (int i = 0; i < count; i++) {
+			for (int j = i + 1; j < count; j++) {
+				if (findRoot(parents, groups.at(i)) == findRoot(parents, groups.at(j))) continue;
+
+				rest.append(qMakePair(i, j));
+				restLengths.append(distance2(points.at(i), points.at(j)));
+			}
+		}
+		order.resize(rest.count());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&restLengths](int i, int j) { return restLengths.at(i) < restLengths.at(j); });
+		for (int index : order) {
+			const QPair<int, int> & edge = rest.at(index);
+			int root1 = findRoot(parents, groups.at(edge.first));
+			int root2 = findRoot(parents, groups.at(edge.second));
+			if (root1 == root2) continue;
+
+			parents[root2] = root1;
+			tree.append(edge);
+		}
+	}
+
+	return tree;
+}
+
+QVector<QPair<int, int>> EuclideanMST::delaunayEdges(const QVector<QPointF> & points)
+{
+	// Bowyer-Watson, inserting points from left to right so that a triangle whose circumcircle
+	// lies wholly to the left of the sweep is final; coincident points get no edges of their own
+	QVector<QPair<int, int>> edges;
+	int count = points.count();
+	if (count < 2) return edges;
+
+	QVector<int> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&points](int i, int j) {
+		if (points.at(i).x() != points.at(j).x()) return points.at(i).x() < points.at(j).x();
+		return points.at(i).y() < points.at(j).y();
+	});
+
+	double left = points.at(order.first()).x();
+	double right = points.at(order.last()).x();
+	double top = points.at(0).y();
+	double bottom = top;
+	Q_FOREACH (QPointF point, points) {
+		top = qMin(top, point.y());
+		bottom = qMax(bottom, point.y());
+	}
+	double size = qMax(qMax(right - left, bottom - top), 1.0) * 20;
+	QPointF middle((left + right) / 2, (top + bottom) / 2);
+
+	// a triangle around everything, whose corners are dropped at the end
+	QVector<QPointF> vertices(points);
+	vertices << QPointF(middle.x() - size, middle.y() - size)
+			 << QPointF(middle.x() + size, middle.y() - size)
+			 << QPointF(middle.x(), middle.y() + size);
+
+	QVector<Triangle> open;
+	QVector<Triangle> closed;
+	open.append(makeTriangle(vertices, count, count + 1, count + 2));
+
+	QHash<quint64, int> boundary;
+	QVector<QPair<int, int>> boundaryEdges;
+	int previous = -1;
+	for (int point : order) {
+		const QPointF & p = vertices.at(point);
+		if (previous >= 0 && vertices.at(previous).x() == p.x() && vertices.at(previous).y() == p.y()) continue;
+		previous = point;
+
+		boundary.clear();
+		boundaryEdges.clear();
+		for (int i = open.count() - 1; i >= 0; i--) {
+			const Triangle & triangle = open.at(i);
+			double dx = p.x() - triangle.center.x();
+			if (dx > 0 && dx * dx > triangle.radius2) {
+				closed.append(triangle);
+				open.remove(i);
+				continue;
+			}
+			if (distance2(p, triangle.center) > triangle.radius2) continue;
+
+			// edges shared by two removed triangles are interior to the hole
+			int corners[3] = { triangle.a, triangle.b, triangle.c };
+			for (int e = 0; e < 3; e++) {
+				int from = corners[e];
+				int to = corners[(e + 1) % 3];
+				boundary[edgeKey(from, to)]++;
+				boundaryEdges.append(qMakePair(from, to));
+			}
+			open.remove(i);
+		}
+
+		for (const auto & edge : boundaryEdges) {
+			if (boundary.value(edgeKey(edge.first, edge.second)) != 1) continue;
+
+			open.append(makeTriangle(vertices, edge.first, edge.second, point));
+		}
+	}
+
+	closed << open;
+	QHash<quint64, bool> seen;
+	for (const Triangle & triangle : closed) {
+		int corners[3] = { triangle.a, triangle.b, triangle.c };
+		for (int e = 0; e < 3; e++) {
+			int from = corners[e];
+			int to = corners[(e + 1) % 3];
+			if (from >= count || to >= count) continue;
+
+			quint64 key = edgeKey(from, to);
+			if (seen.contains(key)) continue;
+
+			seen.insert(key, true);
+			edges.append(qMakePair(qMin(from, to), qMax(from, to)));
+		}
+	}
+
+	return edges;
+}
+
+EuclideanMST::Triangle EuclideanMST::makeTriangle(const QVector<QPointF> & points, int a, int b, int c)
+{
+	Triangle triangle;
+	triangle.a = a;
+	triangle.b = b;
+	triangle.c = c;
+
+	const QPointF & pa = points.at(a);
+	const QPointF & pb = points.at(b);
+	const QPointF & pc = points.at(c);
+	double d = 2 * ((pa.x() * (pb.y() - pc.y())) + (pb.x() * (pc.y() - pa.y())) + (pc.x() * (pa.y() - pb.y())));
+	if (qAbs(d) < 1e-12) {
+		// collinear: treat the circumcircle as everything, so the next point breaks the triangle up
+		triangle.center = pa;
+		triangle.radius2 = std::numeric_limits<double>::max();
+		return triangle;
+	}
+
+	double a2 = (pa.x() * pa.x()) + (pa.y() * pa.y());
+	double b2 = (pb.x() * pb.x()) + (pb.y() * pb.y());
+	double c2 = (pc.x() * pc.x()) + (pc.y() * pc.y());
+	triangle.center = QPointF(((a2 * (pb.y() - pc.y())) + (b2 * (pc.y() - pa.y())) + (c2 * (pa.y() - pb.y()))) / d,
+							  ((a2 * (pc.x() - pb.x())) + (b2 * (pa.x() - pc.x())) + (c2 * (pb.x() - pa.x()))) / d);
+	triangle.radius2 = distance2(triangle.center, pa);
+	return triangle;
+}
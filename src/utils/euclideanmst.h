@@ -0,0 +1,47 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef EUCLIDEANMST_H
+#define EUCLIDEANMST_H
+
+#include <QPair>
+#include <QPointF>
+#include <QVector>
+
+class EuclideanMST
+{
+	// minimum spanning tree over points in the plane, taken from the edges of a Delaunay triangulation
+
+public:
+	static QVector<QPair<int, int>> spanningTree(const QVector<QPointF> & points, const QVector<int> & groups);
+	static QVector<QPair<int, int>> delaunayEdges(const QVector<QPointF> & points);
+
+protected:
+	struct Triangle {
+		int a;
+		int b;
+		int c;
+		QPointF center;
+		double radius2;
+	};
+
+	static Triangle makeTriangle(const QVector<QPointF> & points, int a, int b, int c);
+};
+
+#endif
@@ -0,0 +1,254 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "exportmanifest.h"
+
+#include "folderutils.h"
+#include "textutils.h"
+#include "../debugdialog.h"
+#include "../items/partfactory.h"
+#include "../model/modelpart.h"
+#include "../referencemodel/referencemodel.h"
+#include "../version/version.h"
+
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+const QString ExportManifest::GerberOutput = "gerber";
+const QString ExportManifest::BomOutput = "bom";
+const QString ExportManifest::IpcOutput = "ipc";
+const QString ExportManifest::ManifestSuffix = "_export.json";
+
+namespace {
+
+void addString(QCryptographicHash & hash, const QString & string)
+{
+	hash.addData(string.toUtf8());
+	hash.addData(QByteArray(1, '\0'));
+}
+
+void addElement(QCryptographicHash & hash, const QDomElement & element, const QStringList & skipElements)
+{
+	// attributes are sorted, since their order in a QDomDocument is not fixed
+	addString(hash, element.tagName());
+	QDomNamedNodeMap attributes = element.attributes();
+	QStringList names;
+	for (int i = 0; i < attributes.count(); i++) {
+		names << attributes.item(i).nodeName();
+	}
+	names.sort();
+	Q_FOREACH (QString name, names) {
+		if (name == "path") continue;               // where the author's copy of the fzp was
+
+		addString(hash, name);
+		addString(hash, element.attribute(name));
+	}
+
+	for (QDomNode node = element.firstChild(); !node.isNull(); node = node.nextSibling()) {
+		if (node.isElement()) {
+			if (skipElements.contains(node.toElement().tagName())) continue;
+
+			addElement(hash, node.toElement(), skipElements);
+		}
+		else if (node.isText()) {
+			addString(hash, node.nodeValue());
+		}
+	}
+	addString(hash, "/");
+}
+
+}
+
+QString ExportManifest::manifestPath(const QString & fzzPath)
+{
+	QFileInfo info(fzzPath);
+	return info.dir().absoluteFilePath(info.completeBaseName() + ManifestSuffix);
+}
+
+bool ExportManifest::hashInputs(const QString & fzzPath, ReferenceModel * referenceModel)
+{
+	// gerber: the board and everything in pcb view; ipc: that and the connections from every view,
+	// where the nets come from; bom: every part and its properties. All three take the parts' files
+	// and the Fritzing version, since a different build may export differently.
+	m_referenceModel = referenceModel;
+	m_inputs.clear();
+
+	QTemporaryDir unzipDir;
+	QString error;
+	if (!unzipDir.isValid() || !FolderUtils::unzipTo(fzzPath, unzipDir.path(), error)) {
+		DebugDialog::debug(QString("export manifest: unable to unzip %1 %2").arg(fzzPath, error));
+		return false;
+	}
+
+	QDir dir(unzipDir.path());
+	QDomDocument document;
+	QCryptographicHash bundle(QCryptographicHash::Md5);
+	addString(bundle, Version::versionString());
+	Q_FOREACH (QFileInfo info, dir.entryInfoList(QDir::Files, QDir::Name)) {
+		QString suffix = info.suffix().toLower();
+		if (suffix == "fz") {
+			QFile file(info.absoluteFilePath());
+			if (!file.open(QFile::ReadOnly) || !document.setContent(&file)) {
+				return false;
+			}
+		}
+		else if (suffix == "fzp" || suffix == "svg") {
+			// parts that travel with the sketch
+			QFile file(info.absoluteFilePath());
+			if (!file.open(QFile::ReadOnly)) return false;
+
+			addString(bundle, info.fileName());
+			bundle.addData(&file);
+		}
+	}
+
+	QDomElement root = document.documentElement();
+	if (root.isNull()) return false;
+
+	QCryptographicHash gerber(QCryptographicHash::Md5);
+	QCryptographicHash ipc(QCryptographicHash::Md5);
+	QCryptographicHash bom(QCryptographicHash::Md5);
+	QByteArray bundleHash = bundle.result();
+	gerber.addData(bundleHash);
+	ipc.addData(bundleHash);
+	bom.addData(bundleHash);
+
+	addElement(gerber, root.firstChildElement("boards"), QStringList());
+	for (QDomElement view = root.firstChildElement("views").firstChildElement("view"); !view.isNull(); view = view.nextSiblingElement("view")) {
+		if (view.attribute("name") == "pcbView") {
+			addElement(gerber, view, QStringList());
+		}
+	}
+
+	QStringList noViews("views");
+	for (QDomElement instance = root.firstChildElement("instances").firstChildElement("instance"); !instance.isNull(); instance = instance.nextSiblingElement("instance")) {
+		QString moduleID = instance.attribute("moduleIdRef");
+		QDomElement pcbView = instance.firstChildElement("views").firstChildElement("pcbView");
+		if (!pcbView.isNull()) {
+			addElement(gerber, instance, noViews);
+			addElement(gerber, pcbView, QStringList());
+			gerber.addData(partHash(moduleID, true));
+		}
+
+		addElement(ipc, instance, QStringList());
+		ipc.addData(partHash(moduleID, true));
+
+		addElement(bom, instance, noViews);
+		bom.addData(partHash(moduleID, false));
+	}
+
+	m_inputs.insert(GerberOutput, gerber.result());
+	m_inputs.insert(IpcOutput, ipc.result());
+	m_inputs.insert(BomOutput, bom.result());
+	return true;
+}
+
+QByteArray ExportManifest::partHash(const QString & moduleID, bool pcb)
+{
+	// the part's fzp, and its pcb image when pcb is set; bundled parts are hashed with the bundle
+	QString key = pcb ? moduleID + "/pcb" : moduleID;
+	if (m_partHashes.contains(key)) return m_partHashes.value(key);
+
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	addString(hash, moduleID);
+	ModelPart * modelPart = (m_referenceModel == nullptr) ? nullptr : m_referenceModel->retrieveModelPart(moduleID);
+	if (modelPart != nullptr) {
+		QFile fzp(modelPart->path());
+		if (fzp.open(QFile::ReadOnly)) {
+			hash.addData(&fzp);
+		}
+		if (pcb) {
+			QString imageFileName = modelPart->imageFileName(ViewLayer::PCBView);
+			QString filename = imageFileName.isEmpty() ? QString() : PartFactory::getSvgFilename(modelPart, imageFileName, false, false);
+			QFile svg(filename);
+			if (!filename.isEmpty() && svg.open(QFile::ReadOnly)) {
+				hash.addData(&svg);
+			}
+		}
+	}
+
+	QByteArray result = hash.result();
+	m_partHashes.insert(key, result);
+	return result;
+}
+
+bool ExportManifest::load(const QString & manifestPath)
+{
+	m_exported.clear();
+	m_files.clear();
+
+	QFile file(manifestPath);
+	if (!file.open(QFile::ReadOnly)) return false;
+
+	QJsonObject outputs = QJsonDocument::fromJson(file.readAll()).object().value("outputs").toObject();
+	Q_FOREACH (QString output, outputs.keys()) {
+		QJsonObject entry = outputs.value(output).toObject();
+		m_exported.insert(output, QByteArray::fromHex(entry.value("hash").toString().toLatin1()));
+		QStringList files;
+		Q_FOREACH (QJsonValue value, entry.value("files").toArray()) {
+			files << value.toString();
+		}
+		m_files.insert(output, files);
+	}
+	return true;
+}
+
+bool ExportManifest::save(const QString & manifestPath) const
+{
+	QJsonObject outputs;
+	Q_FOREACH (QString output, m_exported.keys()) {
+		QJsonObject entry;
+		entry.insert("hash", QString::fromLatin1(m_exported.value(output).toHex()));
+		entry.insert("files", QJsonArray::fromStringList(m_files.value(output)));
+		outputs.insert(output, entry);
+	}
+
+	QJsonObject manifest;
+	manifest.insert("fritzingVersion", Version::versionString());
+	manifest.insert("outputs", outputs);
+	return TextUtils::writeUtf8(manifestPath, QJsonDocument(manifest).toJson());
+}
+
+bool ExportManifest::isCurrent(const QString & output, const QDir & dir) const
+{
+	// exported from the same inputs, and its files are all still there
+	if (!m_inputs.contains(output) || m_inputs.value(output) != m_exported.value(output)) return false;
+
+	QStringList files = m_files.value(output);
+	if (files.isEmpty()) return false;
+
+	Q_FOREACH (QString file, files) {
+		if (!QFileInfo::exists(dir.absoluteFilePath(file))) return false;
+	}
+	return true;
+}
+
+void ExportManifest::setExported(const QString & output, const QStringList & files)
+{
+	if (!m_inputs.contains(output)) return;
+
+	m_exported.insert(output, m_inputs.value(output));
+	m_files.insert(output, files);
+}
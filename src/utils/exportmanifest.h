@@ -0,0 +1,64 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef EXPORTMANIFEST_H
+#define EXPORTMANIFEST_H
+
+#include <QByteArray>
+#include <QDir>
+#include <QDomElement>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class ExportManifest
+{
+	// content hashes of what each export of a sketch depends on, read straight from the .fzz,
+	// so an output whose inputs haven't changed since the last export can be skipped without loading the sketch
+
+public:
+	ExportManifest() = default;
+
+	bool hashInputs(const QString & fzzPath, class ReferenceModel *);
+	bool load(const QString & manifestPath);
+	bool save(const QString & manifestPath) const;
+	bool isCurrent(const QString & output, const QDir & dir) const;
+	void setExported(const QString & output, const QStringList & files);
+
+public:
+	static QString manifestPath(const QString & fzzPath);
+
+public:
+	static const QString GerberOutput;
+	static const QString BomOutput;
+	static const QString IpcOutput;
+	static const QString ManifestSuffix;
+
+protected:
+	QByteArray partHash(const QString & moduleID, bool pcb);
+
+protected:
+	class ReferenceModel * m_referenceModel = nullptr;
+	QHash<QString, QByteArray> m_partHashes;        // by module id, then "pcb" for the pcb image as well
+	QHash<QString, QByteArray> m_inputs;            // by output, for the sketch as it is now
+	QHash<QString, QByteArray> m_exported;          // by output, for the sketch as it was last exported
+	QHash<QString, QStringList> m_files;            // by output, relative to the sketch's folder
+};
+
+#endif
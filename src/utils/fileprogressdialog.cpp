@@ -204,6 +204,13 @@ void FileProgressDialog::setIncValueMod(int mod) {
 	m_incValueMod = mod;
 }
 
+void FileProgressDialog::addCancelButton() {
+	auto * buttonBox = new QDialogButtonBox(QDialogButtonBox::Cancel);
+	buttonBox->button(QDialogButtonBox::Cancel)->setText(tr("Cancel"));
+	connect(buttonBox, SIGNAL(rejected()), this, SLOT(sendCancel()));
+	layout()->addWidget(buttonBox);
+}
+
 void FileProgressDialog::setIndeterminate() {
 	m_progressBar->setRange(0, 0);
 	m_timer.setSingleShot(false);
@@ -42,6 +42,7 @@ public:
 	void setBinLoadingChunk(int);
 	void setIncValueMod(int);
 	void setIndeterminate();
+	void addCancelButton();
 
 protected:
 	void closeEvent(QCloseEvent *);
@@ -47,7 +47,8 @@ FolderUtils::FolderUtils() {
 	m_userFolders
 	        << "partfactory"
 	        << "backup"
-	        << "fzz";
+	        << "fzz"
+	        << "svgcache";
 	m_documentFolders
 	        << "bins"
 	        << "parts/user" << "parts/contrib"
@@ -457,7 +458,6 @@ bool FolderUtils::createZipAndSaveTo(const QDir &dirToCompress, const QString &f
 	QFileInfoList files=dirToCompress.entryInfoList();
 	QFile inFile;
 	QuaZipFile outFile(&zip);
-	char c;
 
 	QString currFolderBU = QDir::currentPath();
 	QDir::setCurrent(dirToCompress.path());
@@ -488,10 +488,11 @@ bool FolderUtils::createZipAndSaveTo(const QDir &dirToCompress, const QString &f
 			return false;
 		}
 
-		while(inFile.getChar(&c)&&outFile.putChar(c)) {}
+		QByteArray block;
+		while (!(block = inFile.read(64 * 1024)).isEmpty() && outFile.write(block) == block.size()) {}
 
 		if(outFile.getZipError()!=UNZ_OK) {
-			qWarning("outFile.putChar(): %d", outFile.getZipError());
+			qWarning("outFile.write(): %d", outFile.getZipError());
 			return false;
 		}
 		outFile.close();
@@ -538,7 +539,6 @@ bool FolderUtils::unzipTo(const QString &filepath, const QString &dirToDecompres
 	QuaZipFile file(&zip);
 	QFile out;
 	QString name;
-	char c;
 	for(bool more=zip.goToFirstFile(); more; more=zip.goToNextFile()) {
 		if(!zip.getCurrentFileInfo(&info)) {
 			error = QString("getCurrentFileInfo(): %d\n").arg(zip.getZipError());
@@ -580,23 +580,10 @@ bool FolderUtils::unzipTo(const QString &filepath, const QString &dirToDecompres
 			}
 		}
 
-		// Slow like hell (on GNU/Linux at least), but it is not my fault.
-		// Not ZIP/UNZIP package's fault either.
-		// The slowest thing here is out.putChar(c).
-		// TODO: now that out.putChar has been replaced with a buffered write, is it still slow under Linux?
-
-#define BUFFERSIZE 1024
-		char buffer[BUFFERSIZE];
-		int ix = 0;
-		while(file.getChar(&c)) {
-			buffer[ix++] = c;
-			if (ix == BUFFERSIZE) {
-				out.write(buffer, ix);
-				ix = 0;
-			}
-		}
-		if (ix > 0) {
-			out.write(buffer, ix);
+		// copied a block at a time; reading the entry a char at a time was the slow part
+		QByteArray block;
+		while (!(block = file.read(64 * 1024)).isEmpty()) {
+			out.write(block);
 		}
 
 		out.close();
@@ -627,6 +614,46 @@ bool FolderUtils::unzipTo(const QString &filepath, const QString &dirToDecompres
 }
 
 
+bool FolderUtils::unzipToMemory(const QString &filepath, QList<QPair<QString, QByteArray>> & entries, QString & error) {
+	// the entries of a small archive such as an fzpz, read without going through a temp folder
+	QuaZip zip(filepath);
+	if(!zip.open(QuaZip::mdUnzip)) {
+		error = QString("zip.open(): %1").arg(zip.getZipError());
+		DebugDialog::debug(error);
+		return false;
+	}
+
+	zip.setFileNameCodec("IBM866");
+	QuaZipFile file(&zip);
+	for(bool more=zip.goToFirstFile(); more; more=zip.goToNextFile()) {
+		if(!file.open(QIODevice::ReadOnly)) {
+			error = QString("file.open(): %1").arg(file.getZipError());
+			DebugDialog::debug(error);
+			return false;
+		}
+
+		QString name = file.getActualFileName();
+		QByteArray data = file.readAll();
+		bool ok = (file.getZipError() == UNZ_OK) && file.atEnd();
+		file.close();
+		if(!ok || file.getZipError() != UNZ_OK) {
+			error = QString("reading %1 from %2 failed").arg(name, filepath);
+			DebugDialog::debug(error);
+			return false;
+		}
+
+		entries.append(qMakePair(name, data));
+	}
+	zip.close();
+	if(zip.getZipError()!=UNZ_OK) {
+		error = QString("zip.close(): %1").arg(zip.getZipError());
+		DebugDialog::debug(error);
+		return false;
+	}
+	return true;
+}
+
+
 void FolderUtils::collectFiles(const QDir & parent, QStringList & filters, QStringList & files, bool recursive)
 {
 	QFileInfoList fileInfoList = parent.entryInfoList(filters, QDir::Files | QDir::Hidden | QDir::NoSymLinks);
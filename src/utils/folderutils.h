@@ -56,6 +56,7 @@ public:
 	static bool createZipAndSaveTo(const QDir &dirToCompress, const QString &filename, const QStringList & skipSuffixes);
 	static bool createFZAndSaveTo(const QDir &dirToCompress, const QString &filename, const QStringList & skipSuffixes);
 	static bool unzipTo(const QString &filepath, const QString &dirToDecompress, QString & error);
+	static bool unzipToMemory(const QString &filepath, QList<QPair<QString, QByteArray>> & entries, QString & error);
 	static void replicateDir(QDir srcDir, QDir targDir);
 	static void cleanup();
 	static void collectFiles(const QDir & parent, QStringList & filters, QStringList & files, bool recursive);
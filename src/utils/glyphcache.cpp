@@ -0,0 +1,147 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "glyphcache.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRawFont>
+#include <QSharedPointer>
+#include <QVector>
+
+const double GlyphCache::ReferencePixelSize = 100;
+
+struct Glyph {
+	double advance = 0;                 // at ReferencePixelSize
+	QPainterPath path;                  // at ReferencePixelSize, origin on the baseline
+};
+
+struct Face {
+	QRawFont rawFont;
+	QHash<quint32, Glyph> glyphs;
+};
+
+static QHash<QString, QSharedPointer<Face>> Faces;
+static QMutex FacesMutex;
+
+static QSharedPointer<Face> findFace(const QFont & font)
+{
+	// callers hold FacesMutex; a face that can't be loaded is kept too, so it is only tried once
+	QString key = QString("%1 %2 %3").arg(font.family()).arg(font.weight()).arg(font.style());
+	QSharedPointer<Face> face = Faces.value(key);
+	if (face.isNull()) {
+		face.reset(new Face);
+		QFont reference(font);
+		reference.setPixelSize(qRound(GlyphCache::ReferencePixelSize));
+		face->rawFont = QRawFont::fromFont(reference);
+		Faces.insert(key, face);
+	}
+	return face;
+}
+
+static bool findGlyphs(Face & face, const QString & text, QVector<const Glyph *> & glyphs)
+{
+	// callers hold FacesMutex
+	if (!face.rawFont.isValid()) return false;
+
+	QVector<quint32> indexes = face.rawFont.glyphIndexesForString(text);
+	Q_FOREACH (quint32 index, indexes) {
+		if (face.glyphs.contains(index)) continue;
+
+		Glyph glyph;
+		QVector<QPointF> advances = face.rawFont.advancesForGlyphIndexes(QVector<quint32>(1, index), QRawFont::UseDesignMetrics);
+		glyph.advance = advances.isEmpty() ? 0 : advances.first().x();
+		glyph.path = face.rawFont.pathForGlyph(index);
+		face.glyphs.insert(index, glyph);
+	}
+
+	// only once nothing more is inserted, since inserting can move the glyphs
+	glyphs.clear();
+	Q_FOREACH (quint32 index, indexes) {
+		glyphs.append(&face.glyphs.find(index).value());
+	}
+	return true;
+}
+
+bool GlyphCache::advance(const QFont & font, double pixelSize, const QString & text, double & width)
+{
+	// unkerned width of one line of text, in the units of pixelSize; false when the font isn't available as a raw font
+	QMutexLocker locker(&FacesMutex);
+	QSharedPointer<Face> face = findFace(font);
+	QVector<const Glyph *> glyphs;
+	if (!findGlyphs(*face, text, glyphs)) return false;
+
+	double total = 0;
+	Q_FOREACH (const Glyph * glyph, glyphs) {
+		total += glyph->advance;
+	}
+	width = total * pixelSize / ReferencePixelSize;
+	return true;
+}
+
+bool GlyphCache::outline(const QFont & font, double pixelSize, const QString & text, QPainterPath & path)
+{
+	// one line of text as filled outlines, starting at the origin with the baseline at y = 0
+	QMutexLocker locker(&FacesMutex);
+	QSharedPointer<Face> face = findFace(font);
+	QVector<const Glyph *> glyphs;
+	if (!findGlyphs(*face, text, glyphs)) return false;
+
+	double scale = pixelSize / ReferencePixelSize;
+	double x = 0;
+	path = QPainterPath();
+	Q_FOREACH (const Glyph * glyph, glyphs) {
+		if (!glyph->path.isEmpty()) {
+			path.addPath(QTransform(scale, 0, 0, scale, x, 0).map(glyph->path));
+		}
+		x += glyph->advance * scale;
+	}
+	return true;
+}
+
+QString GlyphCache::svgPathData(const QPainterPath & path)
+{
+	// absolute M, L and C commands; QPainterPath has no quadratic elements
+	QString d;
+	for (int i = 0; i < path.elementCount(); i++) {
+		QPainterPath::Element element = path.elementAt(i);
+		switch (element.type) {
+		case QPainterPath::MoveToElement:
+			d += QString("M%1 %2").arg(element.x, 0, 'f', 2).arg(element.y, 0, 'f', 2);
+			break;
+		case QPainterPath::LineToElement:
+			d += QString("L%1 %2").arg(element.x, 0, 'f', 2).arg(element.y, 0, 'f', 2);
+			break;
+		case QPainterPath::CurveToElement:
+			d += QString("C%1 %2").arg(element.x, 0, 'f', 2).arg(element.y, 0, 'f', 2);
+			break;
+		case QPainterPath::CurveToDataElement:
+			d += QString(" %1 %2").arg(element.x, 0, 'f', 2).arg(element.y, 0, 'f', 2);
+			break;
+		}
+	}
+	return d;
+}
+
+void GlyphCache::clear()
+{
+	QMutexLocker locker(&FacesMutex);
+	Faces.clear();
+}
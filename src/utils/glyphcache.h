@@ -0,0 +1,42 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef GLYPHCACHE_H
+#define GLYPHCACHE_H
+
+#include <QFont>
+#include <QPainterPath>
+#include <QString>
+
+class GlyphCache
+{
+	// glyph advances and outlines per font face, taken once at ReferencePixelSize and scaled from there,
+	// so measuring or outlining text in a registered font at any size is a lookup once its glyphs have been seen
+
+public:
+	static bool advance(const QFont &, double pixelSize, const QString & text, double & width);
+	static bool outline(const QFont &, double pixelSize, const QString & text, QPainterPath & path);
+	static QString svgPathData(const QPainterPath &);
+	static void clear();
+
+public:
+	static const double ReferencePixelSize;
+};
+
+#endif
@@ -27,8 +27,6 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 
 #include <boost/config.hpp>
-#include <boost/graph/transitive_closure.hpp>
-#include <boost/graph/prim_minimum_spanning_tree.hpp>
 // #include <boost/graph/kolmogorov_max_flow.hpp>  // kolmogorov_max_flow is probably more efficient, but it doesn't compile
 #include <boost/graph/edmonds_karp_max_flow.hpp>
 #include <boost/graph/adjacency_list.hpp>
@@ -39,6 +37,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #endif
 
 #include "graphutils.h"
+#include "euclideanmst.h"
 #include "../fsvgrenderer.h"
 #include "../items/wire.h"
 #include "../items/jumperitem.h"
@@ -321,11 +320,38 @@ void GraphUtils::minCut(QList<ConnectorItem *> & connectorItems, QList<SketchWid
 }
 
 
+static int findRoot(QVector<int> & parents, int node)
+{
+	while (parents.at(node) != node) {
+		parents[node] = parents.at(parents.at(node));
+		node = parents.at(node);
+	}
+	return node;
+}
+
+static void join(QVector<int> & parents, int node1, int node2)
+{
+	parents[findRoot(parents, node2)] = findRoot(parents, node1);
+}
+
 bool GraphUtils::chooseRatsnestGraph(const QList<ConnectorItem *> * partConnectorItems, ViewGeometry::WireFlags flags, ConnectorPairHash & result) {
-	using namespace boost;
-	typedef adjacency_list < vecS, vecS, undirectedS, property<vertex_distance_t, double>, property < edge_weight_t, double > > Graph;
-	typedef std::pair < int, int >E;
+	RatsnestGraph graph;
+	QList<ConnectorItem *> nodes;
+	if (!collectRatsnestGraph(partConnectorItems, flags, graph, nodes)) return false;
+
+	spanRatsnestGraph(graph);
+	typedef QPair<int, int> Edge;
+	Q_FOREACH (Edge edge, graph.edges) {
+		result.insert(nodes[edge.first], nodes[edge.second]);
+	}
+
+	return true;
+}
 
+bool GraphUtils::collectRatsnestGraph(const QList<ConnectorItem *> * partConnectorItems, ViewGeometry::WireFlags flags, RatsnestGraph & graph, QList<ConnectorItem *> & nodes) {
+	// connectors already joined (same bus on one part, wired together, or on top of each other) are grouped
+	// first, then the groups are spanned by a Euclidean minimum spanning tree over the Delaunay edges,
+	// rather than by Prim over every pair of connectors
 	if (partConnectorItems->count() < 2) return false;
 
 	QList <ConnectorItem *> temp(*partConnectorItems);
@@ -344,132 +370,82 @@ bool GraphUtils::chooseRatsnestGraph(const QList<ConnectorItem *> * partConnecto
 		}
 	}
 
-	QList<QPointF> locs;
-	Q_FOREACH (ConnectorItem * connectorItem, temp) {
-		locs << connectorItem->sceneAdjustedTerminalPoint(nullptr);
+	int num_nodes = temp.count();
+	QVector<QPointF> & locs = graph.locations;
+	QHash<ConnectorItem *, int> indexes;
+	for (int i = 0; i < num_nodes; i++) {
+		locs << temp.at(i)->sceneAdjustedTerminalPoint(nullptr);
+		indexes.insert(temp.at(i), i);
 	}
 
-	QList < QList<ConnectorItem *> > wiredTo;
+	QVector<int> parents(num_nodes);
+	for (int i = 0; i < num_nodes; i++) parents[i] = i;
 
-	int num_nodes = temp.count();
-	int num_edges = num_nodes * (num_nodes - 1) / 2;
-	E * edges = new E[num_edges];
-	auto * weights = new double[num_edges];
-	int ix = 0;
-	QVector< QVector<double> > reverseWeights(num_nodes, QVector<double>(num_nodes, 0));
+	QHash<QPair<ItemBase *, Bus *>, int> buses;
+	QHash<QPair<double, double>, int> places;
+	QVector<bool> wiredChecked(num_nodes, false);
 	for (int i = 0; i < num_nodes; i++) {
 		ConnectorItem * c1 = temp.at(i);
-		//c1->debugInfo("c1");
-		for (int j = i + 1; j < num_nodes; j++) {
-			edges[ix].first = i;
-			edges[ix].second = j;
-			ConnectorItem * c2 = temp.at(j);
-			if ((c1->attachedTo() == c2->attachedTo()) && ((c1->bus()) != nullptr) && (c1->bus() == c2->bus())) {
-				weights[ix++] = 0;
-				continue;
-			}
-
-			bool already = false;
-			bool checkWiredTo = true;
-			Q_FOREACH (QList<ConnectorItem *> list, wiredTo) {
-				if (list.contains(c1)) {
-					checkWiredTo = false;
-					if (list.contains(c2)) {
-						weights[ix++] = 0;
-						already = true;
-					}
-					break;
-				}
-			}
-			if (already) continue;
-
-			//c2->debugInfo("\tc2");
-
-			if (checkWiredTo) {
-				QList<ConnectorItem *> cwConnectorItems;
-				cwConnectorItems.append(c1);
-				ConnectorItem::collectEqualPotential(cwConnectorItems, true, flags);
-				wiredTo.append(cwConnectorItems);
-				//foreach (ConnectorItem * cx, cwConnectorItems) {
-				//cx->debugInfo("\t\tcx");
-				//}
-				if (cwConnectorItems.contains(c2)) {
-					weights[ix++] = 0;
-					continue;
-				}
-			}
-
-			//DebugDialog::debug("c2 not eliminated");
-			double dx = locs[i].x() - locs[j].x();
-			double dy = locs[i].y() - locs[j].y();
-			weights[ix++] = reverseWeights[i][j] = reverseWeights[j][i] = (dx * dx) + (dy * dy);
+		if (c1->bus() != nullptr) {
+			QPair<ItemBase *, Bus *> key(c1->attachedTo(), c1->bus());
+			if (buses.contains(key)) join(parents, buses.value(key), i);
+			else buses.insert(key, i);
 		}
-	}
-
-	bool retval = false;
-	try {
-		Graph g(edges, edges + num_edges, weights, num_nodes);
-		// Warning: weightmap not used?
-//		property_map<Graph, edge_weight_t>::type weightmap = get(edge_weight, g);
 
-		std::vector < graph_traits < Graph >::vertex_descriptor > p(num_vertices(g));
+		QPair<double, double> place(locs.at(i).x(), locs.at(i).y());
+		if (places.contains(place)) join(parents, places.value(place), i);
+		else places.insert(place, i);
 
-		prim_minimum_spanning_tree(g, &p[0]);
+		if (wiredChecked.at(i)) continue;
 
-		for (std::size_t i = 0; i != p.size(); ++i) {
-			if (i == p[i]) continue;
-			if (reverseWeights[(int) i][(int) p[i]] == 0) continue;
+		QList<ConnectorItem *> cwConnectorItems;
+		cwConnectorItems.append(c1);
+		ConnectorItem::collectEqualPotential(cwConnectorItems, true, flags);
+		Q_FOREACH (ConnectorItem * cx, cwConnectorItems) {
+			int j = indexes.value(cx, -1);
+			if (j < 0) continue;
 
-			result.insert(temp[(int) i], temp[(int) p[i]]);
+			wiredChecked[j] = true;
+			join(parents, i, j);
 		}
-		retval = true;
-	}
-	catch ( const std::exception& e ) {
-		// catch an error in boost 1.54
-		DebugDialog::debug(QString("boost spanning tree failure: %1").arg(e.what()));
-	}
-	catch(...) {
-		DebugDialog::debug("boost spanning tree failure");
 	}
 
+	graph.groups.resize(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		graph.groups[i] = findRoot(parents, i);
+	}
 
-	delete [] edges;
-	delete [] weights;
-
-	return retval;
+	nodes = temp;
+	return true;
 }
 
-#define add_edge_d(i, j, g) \
-	add_edge(verts[i], verts[j], g); \
-    //partConnectorItems[i]->debugInfo(QString("edge from %1").arg(i));
-//partConnectorItems[j]->debugInfo(QString("\tto %1").arg(j));
+void GraphUtils::spanRatsnestGraph(RatsnestGraph & graph) {
+	graph.edges = EuclideanMST::spanningTree(graph.locations, graph.groups);
+}
 
 bool GraphUtils::scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags myTrace, RoutingStatus & routingStatus) {
-	using namespace boost;
+	NetGraph graph;
+	collectNetGraph(partConnectorItems, myTrace, graph);
+	return scoreNetGraph(graph, routingStatus);
+}
 
+void GraphUtils::collectNetGraph(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags myTrace, NetGraph & graph) {
+	// only reads the scene; the edges found are between indexes into partConnectorItems
 	int num_nodes = partConnectorItems.count();
+	graph.nodes = num_nodes;
 
-	typedef property < vertex_index_t, std::size_t > Index;
-	typedef adjacency_list < listS, listS, directedS, Index > graph_t;
-	typedef graph_traits < graph_t >::vertex_descriptor vertex_t;
-
-	graph_t G;
-	std::vector < vertex_t > verts(num_nodes);
-	for (int i = 0; i < num_nodes; ++i) {
-		verts[i] = add_vertex(Index(i), G);
+	QHash<ConnectorItem *, int> indexes;
+	for (int i = 0; i < num_nodes; i++) {
+		indexes.insert(partConnectorItems.at(i), i);
 	}
 
-	//std::pair<int, int> pair;
-	bool gotUserConnection = false;
 	for (int i = 0; i < num_nodes; i++) {
-		add_edge_d(i, i, G);
 		ConnectorItem * from = partConnectorItems[i];
 		for (int j = i + 1; j < num_nodes; j++) {
 			ConnectorItem * to = partConnectorItems[j];
 
 			if (from->isCrossLayerConnectorItem(to)) {
-				add_edge_d(i, j, G);
-				add_edge_d(j, i, G);
+				graph.edges.append(qMakePair(i, j));
 				continue;
 			}
 
@@ -479,39 +455,33 @@ bool GraphUtils::scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGe
 			        to->attachedTo()->isEverVisible())
 			{
 				// equipotential symbols are treated as if they were connected by wires
-				add_edge_d(i, j, G);
-				add_edge_d(j, i, G);
-				gotUserConnection = true;
+				graph.edges.append(qMakePair(i, j));
+				graph.userConnection = true;
 				continue;
 			}
 
 			if (to->attachedTo() != from->attachedTo()) {
-				gotUserConnection = true;
+				graph.userConnection = true;
 				continue;
 			}
 
 			if (((to->bus()) != nullptr) && (to->bus() == from->bus())) {
-				add_edge_d(i, j, G);
-				add_edge_d(j, i, G);
+				graph.edges.append(qMakePair(i, j));
 				continue;
 			}
 
-			gotUserConnection = true;
+			graph.userConnection = true;
 		}
 	}
 
-	if (!gotUserConnection) {
-		return false;
+	if (!graph.userConnection) {
+		return;
 	}
 
-
-
-	routingStatus.m_netCount++;
-
 	for (int i = 0; i < num_nodes; i++) {
 		ConnectorItem * fromConnectorItem = partConnectorItems[i];
 		if (fromConnectorItem->attachedToItemType() == ModelPart::Jumper) {
-			routingStatus.m_jumperItemCount++;
+			graph.jumpers++;
 		}
 		Q_FOREACH (ConnectorItem * toConnectorItem, fromConnectorItem->connectedToItems()) {
 			switch (toConnectorItem->attachedToItemType()) {
@@ -520,10 +490,9 @@ bool GraphUtils::scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGe
 			case ModelPart::Part:
 				//Only the breadboard view allows part to part connections
 				if (toConnectorItem->attachedTo()->isEverVisible() && ((myTrace & ViewGeometry::NormalFlag) != 0u)) {
-					int j = partConnectorItems.indexOf(toConnectorItem);
+					int j = indexes.value(toConnectorItem, -1);
 					if (j >= 0) {
-						add_edge_d(i, j, G);
-						add_edge_d(j, i, G);
+						graph.edges.append(qMakePair(i, j));
 					}
 				}
 				continue;
@@ -534,10 +503,9 @@ bool GraphUtils::scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGe
 					Q_FOREACH (ConnectorItem * end, ends) {
 						if (end == fromConnectorItem) continue;
 
-						int j = partConnectorItems.indexOf(end);
+						int j = indexes.value(end, -1);
 						if (j >= 0) {
-							add_edge_d(i, j, G);
-							add_edge_d(j, i, G);
+							graph.edges.append(qMakePair(i, j));
 						}
 					}
 				}
@@ -558,48 +526,43 @@ bool GraphUtils::scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGe
 			Q_FOREACH (ConnectorItem * end, ends) {
 				if (end == fromConnectorItem) continue;
 
-				int j = partConnectorItems.indexOf(end);
+				int j = indexes.value(end, -1);
 				if (j >= 0) {
-					add_edge_d(i, j, G);
-					add_edge_d(j, i, G);
+					graph.edges.append(qMakePair(i, j));
 				}
 			}
 		}
 	}
+}
 
-	adjacency_list <> TC;
-	transitive_closure(G, TC);
-
-	QVector<bool> check(num_nodes, true);
-	bool anyMissing = false;
-	for (int i = 0; i < num_nodes - 1; i++) {
-		if (!check[i]) continue;
+bool GraphUtils::scoreNetGraph(const NetGraph & graph, RoutingStatus & routingStatus) {
+	// touches nothing but the graph, so may run on any thread
+	if (!graph.userConnection) {
+		return false;
+	}
 
-		check[i] = false;
-		bool missingOne = false;
-		for (int j = i + 1; j < num_nodes; j++) {
-			if (!check[j]) continue;
+	routingStatus.m_netCount++;
+	routingStatus.m_jumperItemCount += graph.jumpers;
 
-			if (edge(i, j, TC).second) {
-				check[j] = false;
-			}
-			else {
-				// we can minimally span the set with n-1 wires, so even if multiple connections are missing from a given connector, count it as one
-				anyMissing = missingOne = true;
+	QVector<int> parents(graph.nodes);
+	for (int i = 0; i < graph.nodes; i++) parents[i] = i;
 
-				//ConnectorItem * ci = partConnectorItems.at(i);
-				//ConnectorItem * cj = partConnectorItems.at(j);
-				//ci->debugInfo("missing one ci");
-				//cj->debugInfo("\t\tcj");
+	typedef QPair<int, int> Edge;
+	Q_FOREACH (Edge edge, graph.edges) {
+		join(parents, edge.first, edge.second);
+	}
 
-			}
-		}
-		if (missingOne) {
-			routingStatus.m_connectorsLeftToRoute++;
-		}
+	int components = 0;
+	for (int i = 0; i < graph.nodes; i++) {
+		if (parents.at(i) == i) components++;
 	}
 
-	if (!anyMissing) {
+	// we can minimally span the set with n-1 wires, so however many connections are missing
+	// between two separate groups, count them as one
+	if (components > 1) {
+		routingStatus.m_connectorsLeftToRoute += components - 1;
+	}
+	else {
 		routingStatus.m_netRoutedCount++;
 	}
 
@@ -24,6 +24,9 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include "../connectors/connectoritem.h"
 #include "../routingstatus.h"
 
+#include <QPointF>
+#include <QVector>
+
 struct ConnectorEdge {
 	int head;
 	int tail;
@@ -36,12 +39,31 @@ struct ConnectorEdge {
 	void setHeadTail(int head, int tail);
 };
 
+struct NetGraph {
+	// one net's connections copied out of the scene, so it can be scored off the gui thread
+	int nodes = 0;
+	QVector< QPair<int, int> > edges;
+	int jumpers = 0;
+	bool userConnection = false;
+};
+
+struct RatsnestGraph {
+	// connector locations, and which connectors are already joined, ready to be spanned off the gui thread
+	QVector<QPointF> locations;
+	QVector<int> groups;
+	QVector< QPair<int, int> > edges;
+};
+
 class GraphUtils
 {
 
 public:
 	static bool chooseRatsnestGraph(const QList<ConnectorItem *> * equipotentials, ViewGeometry::WireFlags, ConnectorPairHash & result);
+	static bool collectRatsnestGraph(const QList<ConnectorItem *> * equipotentials, ViewGeometry::WireFlags, RatsnestGraph &, QList<ConnectorItem *> & nodes);
+	static void spanRatsnestGraph(RatsnestGraph &);
 	static bool scoreOneNet(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags, RoutingStatus & routingStatus);
+	static void collectNetGraph(QList<ConnectorItem *> & partConnectorItems, ViewGeometry::WireFlags, NetGraph &);
+	static bool scoreNetGraph(const NetGraph &, RoutingStatus & routingStatus);
 	static void minCut(QList<ConnectorItem *> & connectorItems, QList<class SketchWidget *> & foreighSketchWidgets, ConnectorItem * source, ConnectorItem * sink, QList<ConnectorEdge *> & cutSet);
 
 protected:
@@ -0,0 +1,151 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "interactionprofiler.h"
+#include "textutils.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+static const int MaxEvents = 100000;	// about the last minute of dragging
+
+bool InteractionProfiler::Enabled = false;
+QElapsedTimer InteractionProfiler::Timer;
+InteractionProfiler::Frame InteractionProfiler::Current;
+InteractionProfiler::Frame InteractionProfiler::Last;
+QVector<InteractionProfiler::Event> InteractionProfiler::Events;
+int InteractionProfiler::NextEvent = 0;
+
+InteractionProfiler::Scope::Scope(Span span) : m_span(span) {
+	if (Enabled) m_startNs = Timer.nsecsElapsed();
+}
+
+InteractionProfiler::Scope::~Scope() {
+	if (m_startNs < 0 || !Enabled) return;
+
+	record(m_span, m_startNs, Timer.nsecsElapsed() - m_startNs);
+}
+
+void InteractionProfiler::setEnabled(bool enabled) {
+	// turning it on starts a fresh trace
+	if (enabled == Enabled) return;
+
+	Enabled = enabled;
+	if (enabled) {
+		Timer.start();
+		Current = Frame();
+		Last = Frame();
+		Events.clear();
+		Events.reserve(MaxEvents);
+		NextEvent = 0;
+	}
+}
+
+bool InteractionProfiler::enabled() {
+	return Enabled;
+}
+
+void InteractionProfiler::itemPainted() {
+	if (Enabled) Current.itemsPainted++;
+}
+
+void InteractionProfiler::record(Span span, qint64 startNs, qint64 ns) {
+	if (span < SpanCount) {
+		Current.ns[span] += ns;
+		Current.calls[span]++;
+	}
+
+	Event event;
+	event.startNs = startNs;
+	event.ns = ns;
+	event.span = span;
+	if (Events.count() < MaxEvents) {
+		Events.append(event);
+	}
+	else {
+		Events[NextEvent] = event;
+		NextEvent = (NextEvent + 1) % MaxEvents;
+	}
+}
+
+void InteractionProfiler::frameDone() {
+	if (!Enabled) return;
+
+	record(SpanCount, Timer.nsecsElapsed(), Current.itemsPainted);
+	Last = Current;
+	Current = Frame();
+}
+
+const InteractionProfiler::Frame & InteractionProfiler::lastFrame() {
+	return Last;
+}
+
+QVariantMap InteractionProfiler::lastFrameMap() {
+	QVariantMap map;
+	map.insert("enabled", Enabled);
+	map.insert("itemsPainted", Last.itemsPainted);
+	for (int i = 0; i < SpanCount; i++) {
+		map.insert(spanName((Span) i) + "Ms", Last.ns[i] / 1.0e6);
+	}
+	return map;
+}
+
+QString InteractionProfiler::spanName(Span span) {
+	switch (span) {
+	case Paint: return "paint";
+	case MouseMove: return "mouseMove";
+	case PrepMove: return "prepMove";
+	case MoveItems: return "moveItemsAux";
+	case FindConnectorsUnder: return "findConnectorsUnder";
+	case Ratsnest: return "ratsnest";
+	case CommandPush: return "commandPush";
+	default: return "frame";
+	}
+}
+
+bool InteractionProfiler::writeTrace(const QString & path) {
+	// in the Trace Event Format, which chrome://tracing and Perfetto read; frames are counter events
+	QJsonArray traceEvents;
+	for (int i = 0; i < Events.count(); i++) {
+		const Event & event = Events.at((NextEvent + i) % Events.count());
+		QJsonObject object;
+		object.insert("name", spanName((Span) event.span));
+		object.insert("pid", 1);
+		object.insert("tid", 1);
+		object.insert("ts", event.startNs / 1000.0);
+		if (event.span == SpanCount) {
+			object.insert("ph", QString("C"));
+			QJsonObject args;
+			args.insert("itemsPainted", (double) event.ns);
+			object.insert("args", args);
+		}
+		else {
+			object.insert("ph", QString("X"));
+			object.insert("dur", event.ns / 1000.0);
+		}
+		traceEvents.append(object);
+	}
+
+	QJsonObject trace;
+	trace.insert("traceEvents", traceEvents);
+	trace.insert("displayTimeUnit", QString("ms"));
+	return TextUtils::writeUtf8(path, QJsonDocument(trace).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,91 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef INTERACTIONPROFILER_H
+#define INTERACTIONPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+class InteractionProfiler
+{
+	// paint times and time spent in the interactive handlers, for the performance overlay and for a trace file;
+	// while it's off, a scope costs one untaken branch
+
+public:
+	enum Span {
+		Paint,
+		MouseMove,
+		PrepMove,
+		MoveItems,
+		FindConnectorsUnder,
+		Ratsnest,
+		CommandPush,
+		SpanCount
+	};
+
+	class Scope {
+		// times the enclosing scope as the given span
+	public:
+		explicit Scope(Span);
+		~Scope();
+
+	protected:
+		Span m_span;
+		qint64 m_startNs = -1;
+	};
+
+	struct Frame {
+		qint64 ns[SpanCount] = {};		// time in each span since the frame before
+		int calls[SpanCount] = {};
+		int itemsPainted = 0;
+	};
+
+public:
+	static void setEnabled(bool);
+	static bool enabled();
+	static void itemPainted();
+	static void frameDone();
+	static const Frame & lastFrame();
+	static QVariantMap lastFrameMap();
+	static QString spanName(Span);
+	static bool writeTrace(const QString & path);
+
+protected:
+	static void record(Span, qint64 startNs, qint64 ns);
+
+protected:
+	struct Event {
+		qint64 startNs = 0;
+		qint64 ns = 0;
+		int span = 0;					// SpanCount marks a frame boundary, with ns holding the items painted
+	};
+
+	static bool Enabled;
+	static QElapsedTimer Timer;
+	static Frame Current;
+	static Frame Last;
+	static QVector<Event> Events;		// a ring once it is full
+	static int NextEvent;
+};
+
+#endif
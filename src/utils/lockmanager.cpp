@@ -28,15 +28,28 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMutex>
 #include <QMutexLocker>
 #include <QDateTime>
+#include <QDir>
+#include <QFuture>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <atomic>
 
 const QString LockManager::LockedFileName = "___lockfile___.txt";
+const QString LockManager::HeartbeatPrefix = "___heartbeat___";
 const long LockManager::FastTime =  2000;
 const long LockManager::SlowTime = 240000;
 
+// one heartbeat file per process, in the top-level user data folder, stands in for all of its lock files;
+// it is touched off the gui thread, as often as the most demanding lock still held needs
 static LockManager TheLockManager;
-static QHash<long, QPointer<QTimer> > TheTimers;
+static QPointer<QTimer> TheTimer;
 static QMultiHash<long, LockedFile *> TheLockedFiles;
 static QMutex TheMutex;
+static QString TheHeartbeatName;
+static QString TheHeartbeatPath;
+static QFuture<void> TheTouch;
+static std::atomic<bool> TouchPending(false);
 
 LockedFile::LockedFile(const QString & filename, long freq) {
 	file.setFileName(filename);
@@ -45,7 +58,7 @@ LockedFile::LockedFile(const QString & filename, long freq) {
 
 bool LockedFile::touch() {
 	if (file.open(QFile::WriteOnly)) {
-		file.write("a");
+		file.write(QString("heartbeat %1 %2\n").arg(TheHeartbeatName).arg(frequency).toUtf8());
 		file.close();
 		return true;
 	}
@@ -61,30 +74,96 @@ LockManager::LockManager() : QObject()
 
 LockManager::~LockManager()
 {
-	Q_FOREACH (QTimer * timer, TheTimers) {
-		if (timer != nullptr) timer->stop();
-	}
-	TheTimers.clear();
+	if (TheTimer != nullptr) TheTimer->stop();
 }
 
 void LockManager::cleanup() {
-	Q_FOREACH (QTimer * timer, TheTimers) {
-		if (timer != nullptr) {
-			timer->stop();
-			delete timer;
-		}
+	if (TheTimer != nullptr) {
+		TheTimer->stop();
+		delete TheTimer;
+	}
+	TheTouch.waitForFinished();
+	if (!TheHeartbeatPath.isEmpty()) {
+		QFile::remove(TheHeartbeatPath);
 	}
-	TheTimers.clear();
 }
 
 void LockManager::touchFiles() {
-	auto * timer = qobject_cast<QTimer *>(sender());
-	if (timer == nullptr) return;
+	// a touch still waiting on a slow file system is as good as this one
+	if (TouchPending.exchange(true)) return;
 
-	QMutexLocker locker(&TheMutex);
-	Q_FOREACH (LockedFile * lockedFile, TheLockedFiles.values(timer->interval())) {
-		lockedFile->touch();
+	TheTouch = QtConcurrent::run(&LockManager::touchHeartbeat, TheHeartbeatPath);
+}
+
+void LockManager::touchHeartbeat(const QString & path) {
+	QFile file(path);
+	if (file.open(QFile::WriteOnly)) {
+		file.write("a");
+		file.close();
 	}
+	TouchPending = false;
+}
+
+void LockManager::startHeartbeat() {
+	if (!TheHeartbeatPath.isEmpty()) return;
+
+	QDir dir(FolderUtils::getTopLevelUserDataStorePath());
+	TheHeartbeatName = HeartbeatPrefix + TextUtils::getRandText() + ".txt";
+	TheHeartbeatPath = dir.absoluteFilePath(TheHeartbeatName);
+	touchHeartbeat(TheHeartbeatPath);
+
+	// heartbeats left by processes that didn't exit cleanly; a live one is touched at least every SlowTime
+	QDateTime stale = QDateTime::currentDateTime().addMSecs(-2 * SlowTime);
+	Q_FOREACH (QFileInfo info, dir.entryInfoList(QStringList(HeartbeatPrefix + "*"), QDir::Files | QDir::Hidden | QDir::NoSymLinks)) {
+		if (info.lastModified() < stale) QFile::remove(info.absoluteFilePath());
+	}
+
+	TheTimer = new QTimer();
+	TheTimer->setSingleShot(false);
+	QObject::connect(TheTimer, SIGNAL(timeout()), &TheLockManager, SLOT(touchFiles()));
+}
+
+void LockManager::updateHeartbeatInterval() {
+	// as often as the shortest frequency among the locks still held, and not at all when there are none
+	if (TheTimer == nullptr) return;
+
+	TheMutex.lock();
+	QList<long> frequencies = TheLockedFiles.uniqueKeys();
+	TheMutex.unlock();
+
+	if (frequencies.isEmpty()) {
+		TheTimer->stop();
+		return;
+	}
+
+	long interval = *std::min_element(frequencies.begin(), frequencies.end());
+	if (TheTimer->isActive() && TheTimer->interval() == interval) return;
+
+	TheTimer->start(interval);
+}
+
+bool LockManager::isLockHeld(const QDir & dir, long touchFrequency) {
+	// true if the process named in the folder's lock file, this one included, still has a fresh heartbeat;
+	// lock files from older versions were touched themselves, so for those the lock file's own time counts
+	QFileInfo lockInfo(dir.absoluteFilePath(LockedFileName));
+	if (!lockInfo.exists()) return false;
+
+	QFileInfo aliveInfo = lockInfo;
+	QFile lockFile(lockInfo.absoluteFilePath());
+	if (lockFile.open(QFile::ReadOnly)) {
+		QStringList fields = QString::fromUtf8(lockFile.readAll()).simplified().split(' ');
+		lockFile.close();
+		if (fields.count() == 3 && fields.at(0) == "heartbeat" && fields.at(1).startsWith(HeartbeatPrefix)) {
+			if (fields.at(1) == TheHeartbeatName) return true;
+
+			aliveInfo = QFileInfo(QDir(FolderUtils::getTopLevelUserDataStorePath()).absoluteFilePath(fields.at(1)));
+			if (!aliveInfo.exists()) return false;
+
+			touchFrequency = fields.at(2).toLong();
+		}
+	}
+
+	return aliveInfo.lastModified() >= QDateTime::currentDateTime().addMSecs(-2000 - touchFrequency);
 }
 
 void LockManager::initLockedFiles(const QString & prefix, QString & folder, QHash<QString, LockedFile *> & lockedFiles, long touchFrequency) {
@@ -101,20 +180,13 @@ void LockManager::initLockedFiles(const QString & prefix, QString & folder, QHas
 }
 
 LockedFile * LockManager::makeLockedFile(const QString & path, long touchFrequency) {
+	startHeartbeat();
 	auto * lockedFile = new LockedFile(path, touchFrequency);
 	lockedFile->touch();
 	TheMutex.lock();
 	TheLockedFiles.insert(touchFrequency, lockedFile);
 	TheMutex.unlock();
-	QTimer * timer = TheTimers.value(touchFrequency, nullptr);
-	if (timer == nullptr) {
-		timer = new QTimer();
-		timer->setInterval(touchFrequency);
-		timer->setSingleShot(false);
-		QObject::connect(timer, SIGNAL(timeout()), &TheLockManager, SLOT(touchFiles()));
-		timer->start();
-		TheTimers.insert(touchFrequency, timer);
-	}
+	updateHeartbeatInterval();
 	return lockedFile;
 }
 
@@ -144,6 +216,7 @@ void LockManager::releaseLockedFiles(const QString & folder, QHash<QString, Lock
 		delete lockedFile;
 	}
 	lockedFiles.clear();
+	updateHeartbeatInterval();
 }
 
 void LockManager::checkLockedFiles(const QString & prefix, QFileInfoList & backupList, QHash<QString, LockedFile *> & lockedFiles, bool recurse, long touchFrequency)
@@ -177,13 +250,9 @@ void LockManager::checkLockedFiles(const QString & prefix, QFileInfoList & backu
 			continue;
 		}
 
-		QFileInfo lockInfo(dir.absoluteFilePath(LockedFileName));
-		if (lockInfo.exists()) {
-			QDateTime lastModified = lockInfo.lastModified();
-			if (lastModified >= QDateTime::currentDateTime().addMSecs(-2000 - touchFrequency)) {
-				// somebody else owns the file
-				continue;
-			}
+		if (isLockHeld(dir, touchFrequency)) {
+			// somebody else owns the file
+			continue;
 		}
 
 		// we own the file
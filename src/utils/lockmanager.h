@@ -27,6 +27,8 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 
 struct LockedFile {
+	// a folder's lock file names the heartbeat of the process that owns the folder; it is written once,
+	// when the folder is locked, and the owner is alive for as long as its heartbeat keeps being touched
 	QFile file;
 	long frequency;
 
@@ -49,6 +51,7 @@ public:
 
 public:
 	static const QString LockedFileName;
+	static const QString HeartbeatPrefix;
 	static const long FastTime;
 	static const long SlowTime;
 
@@ -59,6 +62,10 @@ protected:
 	static bool checkLockedFilesAux(const QDir & parent, QStringList & filters);
 	static void releaseLockedFiles(const QString & folder, QHash<QString, LockedFile *> & lockedFiles, bool remove);
 	static LockedFile * makeLockedFile(const QString & folder, long touchFrequency);
+	static bool isLockHeld(const QDir & dir, long touchFrequency);
+	static void startHeartbeat();
+	static void updateHeartbeatInterval();
+	static void touchHeartbeat(const QString & path);
 
 };
 
@@ -0,0 +1,190 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "memoryreport.h"
+#include "../connectors/connectoritem.h"
+#include "../fsvgrenderer.h"
+#include "../items/itembase.h"
+#include "../items/paletteitem.h"
+#include "../items/wire.h"
+#include "../model/modelpart.h"
+#include "../model/modelpartshared.h"
+#include "../sketch/sketchwidget.h"
+#include "../waitpushundostack.h"
+
+#include <QGraphicsScene>
+#include <QJsonArray>
+#include <QSet>
+#include <QStringList>
+#include <QtMath>
+
+// QGraphicsItemPrivate and friends, which sizeof doesn't see
+static const qint64 GraphicsItemOverhead = 400;
+static const qint64 SceneIndexNodeBytes = 48;
+
+static qint64 sceneIndexBytes(QGraphicsScene * scene, int itemCount)
+{
+	// the bsp tree's nodes plus a pointer per item per leaf it falls in; QGraphicsScene picks the depth
+	// from the item count when it isn't set
+	if (scene->itemIndexMethod() == QGraphicsScene::NoIndex || itemCount == 0) return 0;
+
+	int depth = scene->bspTreeDepth();
+	if (depth <= 0) depth = qMax(int(qLn(qreal(itemCount)) / qLn(qreal(2))), 5);
+	qint64 nodes = (qint64(1) << (qMin(depth, 24) + 1)) - 1;
+	return (nodes * SceneIndexNodeBytes) + (itemCount * 2 * (qint64) sizeof(void *));
+}
+
+static QString megabytes(qint64 bytes)
+{
+	return QString::number(bytes / (1024.0 * 1024.0), 'f', 1);
+}
+
+QJsonObject MemoryReport::sketch(const QList<SketchWidget *> & views, const WaitPushUndoStack * undoStack)
+{
+	QSet<FSvgRenderer *> renderers;
+	QSet<ModelPartShared *> modelPartShareds;
+	qint64 total = 0;
+
+	QJsonArray viewReports;
+	Q_FOREACH (SketchWidget * sketchWidget, views) {
+		if (sketchWidget == nullptr) continue;
+
+		int parts = 0, wires = 0, connectors = 0, others = 0;
+		QList<QGraphicsItem *> items = sketchWidget->scene()->items();
+		Q_FOREACH (QGraphicsItem * item, items) {
+			if (dynamic_cast<ConnectorItem *>(item) != nullptr) {
+				connectors++;
+				continue;
+			}
+
+			auto * itemBase = dynamic_cast<ItemBase *>(item);
+			if (itemBase == nullptr) {
+				others++;
+				continue;
+			}
+
+			if (qobject_cast<Wire *>(itemBase) != nullptr) wires++;
+			else parts++;
+			if (itemBase->fsvgRenderer() != nullptr) renderers.insert(itemBase->fsvgRenderer());
+			if (itemBase->modelPart() != nullptr && itemBase->modelPart()->modelPartShared() != nullptr) {
+				modelPartShareds.insert(itemBase->modelPart()->modelPartShared());
+			}
+		}
+
+		qint64 itemBytes = (parts * (qint64) (sizeof(PaletteItem) + GraphicsItemOverhead)) +
+		                   (wires * (qint64) (sizeof(Wire) + GraphicsItemOverhead)) +
+		                   (others * GraphicsItemOverhead);
+		qint64 connectorBytes = connectors * (qint64) (sizeof(ConnectorItem) + GraphicsItemOverhead);
+		qint64 indexBytes = sceneIndexBytes(sketchWidget->scene(), items.count());
+
+		QJsonObject viewReport;
+		viewReport.insert("view", ViewLayer::viewIDName(sketchWidget->viewID()));
+		viewReport.insert("parts", parts);
+		viewReport.insert("wires", wires);
+		viewReport.insert("connectors", connectors);
+		viewReport.insert("otherItems", others);
+		viewReport.insert("itemBytes", itemBytes);
+		viewReport.insert("connectorBytes", connectorBytes);
+		viewReport.insert("sceneIndexBytes", indexBytes);
+		viewReports.append(viewReport);
+		total += itemBytes + connectorBytes + indexBytes;
+	}
+
+	// a renderer shared by many items is counted once
+	qint64 rendererBytes = 0;
+	Q_FOREACH (FSvgRenderer * renderer, renderers) {
+		rendererBytes += renderer->loadedBytes();
+	}
+	FSvgRenderer::Memory svgMemory = FSvgRenderer::memory();
+	QJsonObject rendererReport;
+	rendererReport.insert("sketchRenderers", renderers.count());
+	rendererReport.insert("sketchSvgBytes", rendererBytes);
+	rendererReport.insert("allRenderers", svgMemory.renderers);
+	rendererReport.insert("allSvgBytes", svgMemory.loadedBytes);
+	rendererReport.insert("sharedRenderers", svgMemory.sharedRenderers);
+	rendererReport.insert("svgCacheBytes", svgMemory.svgCacheBytes);
+	rendererReport.insert("rasterCacheBytes", svgMemory.rasterCacheBytes);
+	rendererReport.insert("pathFits", svgMemory.pathFits);
+	total += rendererBytes;
+
+	QJsonObject undoReport;
+	if (undoStack != nullptr) {
+		undoReport.insert("commands", undoStack->count());
+		undoReport.insert("bytes", undoStack->memoryCost());
+		undoReport.insert("limitBytes", undoStack->memoryLimit());
+		total += undoStack->memoryCost();
+	}
+
+	qint64 modelPartBytes = 0;
+	Q_FOREACH (ModelPartShared * modelPartShared, modelPartShareds) {
+		modelPartBytes += modelPartShared->memoryCost();
+	}
+	QJsonObject modelPartReport;
+	modelPartReport.insert("count", modelPartShareds.count());
+	modelPartReport.insert("bytes", modelPartBytes);
+	total += modelPartBytes;
+
+	QJsonObject report;
+	report.insert("views", viewReports);
+	report.insert("renderers", rendererReport);
+	report.insert("undo", undoReport);
+	report.insert("modelPartShared", modelPartReport);
+	report.insert("totalBytes", total);
+	return report;
+}
+
+QString MemoryReport::summary(const QJsonObject & report)
+{
+	QStringList lines;
+	Q_FOREACH (QJsonValue value, report.value("views").toArray()) {
+		QJsonObject view = value.toObject();
+		lines << QString("%1: %2 parts, %3 wires, %4 connectors: items %5 MB, connectors %6 MB, scene index %7 MB")
+			.arg(view.value("view").toString())
+			.arg(view.value("parts").toInt())
+			.arg(view.value("wires").toInt())
+			.arg(view.value("connectors").toInt())
+			.arg(megabytes(view.value("itemBytes").toDouble()))
+			.arg(megabytes(view.value("connectorBytes").toDouble()))
+			.arg(megabytes(view.value("sceneIndexBytes").toDouble()));
+	}
+
+	QJsonObject renderers = report.value("renderers").toObject();
+	lines << QString("svg renderers: %1 for this sketch, %2 MB of svg; %3 in all, %4 MB")
+		.arg(renderers.value("sketchRenderers").toInt())
+		.arg(megabytes(renderers.value("sketchSvgBytes").toDouble()))
+		.arg(renderers.value("allRenderers").toInt())
+		.arg(megabytes(renderers.value("allSvgBytes").toDouble()));
+	lines << QString("svg caches: cooked %1 MB, raster %2 MB")
+		.arg(megabytes(renderers.value("svgCacheBytes").toDouble()))
+		.arg(megabytes(renderers.value("rasterCacheBytes").toDouble()));
+
+	QJsonObject undo = report.value("undo").toObject();
+	lines << QString("undo stack: %1 commands, %2 MB")
+		.arg(undo.value("commands").toInt())
+		.arg(megabytes(undo.value("bytes").toDouble()));
+
+	QJsonObject modelParts = report.value("modelPartShared").toObject();
+	lines << QString("part definitions: %1, %2 MB")
+		.arg(modelParts.value("count").toInt())
+		.arg(megabytes(modelParts.value("bytes").toDouble()));
+
+	lines << QString("total: about %1 MB").arg(megabytes(report.value("totalBytes").toDouble()));
+	return lines.join("\n");
+}
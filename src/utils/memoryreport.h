@@ -0,0 +1,40 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+class MemoryReport
+{
+	// approximate memory held by an open sketch, by subsystem: the items and connectors of each view and
+	// the scene index over them, the svg renderers, the undo stack and the parts' shared model data.
+	// Object sizes are sizeof plus a fixed allowance for what Qt keeps privately, so the byte figures are
+	// for comparing subsystems and sketches, not for adding up to the process size
+
+public:
+	static QJsonObject sketch(const QList<class SketchWidget *> & views, const class WaitPushUndoStack *);
+	static QString summary(const QJsonObject & report);
+};
+
+#endif
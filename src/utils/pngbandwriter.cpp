@@ -0,0 +1,195 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "pngbandwriter.h"
+
+#include <QtEndian>
+
+#include <zlib.h>
+
+static QByteArray bigEndian(quint32 value) {
+	QByteArray bytes(4, 0);
+	qToBigEndian(value, bytes.data());
+	return bytes;
+}
+
+PngBandWriter::~PngBandWriter() {
+	if (m_stream) {
+		deflateEnd(m_stream);
+		delete m_stream;
+	}
+}
+
+/**
+ * Creates the file and writes everything that comes before the pixels.
+ * @param[in] compression zlib level 0 to 9, or -1 for zlib's default
+ */
+bool PngBandWriter::open(const QString & fileName, const QSize & size, bool alpha, int dotsPerMeter, const QString & description, int compression) {
+	if (size.isEmpty()) {
+		fail("empty image");
+		return false;
+	}
+
+	m_file.setFileName(fileName);
+	if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		fail(m_file.errorString());
+		return false;
+	}
+
+	m_size = size;
+	m_alpha = alpha;
+	m_rowsWritten = 0;
+
+	static const char Signature[] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n' };
+	if (m_file.write(Signature, sizeof(Signature)) != sizeof(Signature)) {
+		fail(m_file.errorString());
+		return false;
+	}
+
+	QByteArray header = bigEndian(size.width()) + bigEndian(size.height());
+	header.append(char(8));							// bits per channel
+	header.append(char(alpha ? 6 : 2));				// RGBA or RGB
+	header.append(3, char(0));						// deflate, adaptive filtering, not interlaced
+	if (!writeChunk("IHDR", header)) return false;
+
+	if (dotsPerMeter > 0) {
+		QByteArray physical = bigEndian(dotsPerMeter) + bigEndian(dotsPerMeter);
+		physical.append(char(1));					// per meter
+		if (!writeChunk("pHYs", physical)) return false;
+	}
+
+	if (!description.isEmpty()) {
+		if (!writeChunk("tEXt", QByteArray("Description") + '\0' + description.toLatin1())) return false;
+	}
+
+	m_stream = new z_stream;
+	m_stream->zalloc = Z_NULL;
+	m_stream->zfree = Z_NULL;
+	m_stream->opaque = Z_NULL;
+	if (deflateInit(m_stream, qBound(-1, compression, 9)) != Z_OK) {
+		delete m_stream;
+		m_stream = nullptr;
+		fail("unable to start compressing");
+		return false;
+	}
+	m_output.resize(OutputSize);
+	m_stream->next_out = reinterpret_cast<Bytef *>(m_output.data());
+	m_stream->avail_out = OutputSize;
+	return true;
+}
+
+bool PngBandWriter::writeBand(const QImage & band) {
+	if (!m_stream) {
+		fail("not open");
+		return false;
+	}
+	if (band.width() != m_size.width() || m_rowsWritten + band.height() > m_size.height()) {
+		fail("band does not fit the image");
+		return false;
+	}
+
+	// both are byte ordered the way PNG wants them
+	QImage bytes = band.convertToFormat(m_alpha ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+	int rowLength = m_size.width() * (m_alpha ? 4 : 3);
+	static const uchar NoFilter = 0;
+	for (int y = 0; y < bytes.height(); y++) {
+		if (!deflateData(&NoFilter, 1, false)) return false;
+		if (!deflateData(bytes.constScanLine(y), rowLength, false)) return false;
+	}
+	m_rowsWritten += bytes.height();
+	return true;
+}
+
+/**
+ * Finishes the file; fails unless every row has been written.
+ */
+bool PngBandWriter::close() {
+	if (!m_stream) {
+		fail("not open");
+		return false;
+	}
+
+	bool result = true;
+	if (m_rowsWritten != m_size.height()) {
+		fail(QString("%1 of %2 rows written").arg(m_rowsWritten).arg(m_size.height()));
+		result = false;
+	}
+	else {
+		result = deflateData(nullptr, 0, true) && writeChunk("IEND", QByteArray());
+	}
+
+	deflateEnd(m_stream);
+	delete m_stream;
+	m_stream = nullptr;
+	m_file.close();
+	if (!result) {
+		m_file.remove();
+	}
+	return result;
+}
+
+int PngBandWriter::rowsWritten() const {
+	return m_rowsWritten;
+}
+
+const QString & PngBandWriter::errorString() const {
+	return m_error;
+}
+
+bool PngBandWriter::deflateData(const uchar * data, int length, bool finish) {
+	m_stream->next_in = const_cast<Bytef *>(data);
+	m_stream->avail_in = length;
+	while (true) {
+		int status = deflate(m_stream, finish ? Z_FINISH : Z_NO_FLUSH);
+		if (status == Z_STREAM_ERROR) {
+			fail("compression failed");
+			return false;
+		}
+
+		bool full = m_stream->avail_out == 0;
+		bool done = finish ? status == Z_STREAM_END : m_stream->avail_in == 0;
+		if (full || (done && finish)) {
+			int used = OutputSize - m_stream->avail_out;
+			if (used > 0 && !writeChunk("IDAT", QByteArray::fromRawData(m_output.constData(), used))) return false;
+
+			m_stream->next_out = reinterpret_cast<Bytef *>(m_output.data());
+			m_stream->avail_out = OutputSize;
+		}
+		if (done) return true;
+	}
+}
+
+bool PngBandWriter::writeChunk(const char * type, const QByteArray & data) {
+	QByteArray chunk = bigEndian(data.size());
+	chunk.append(type, 4);
+	chunk.append(data);
+	uLong crc = crc32(0L, Z_NULL, 0);
+	crc = crc32(crc, reinterpret_cast<const Bytef *>(chunk.constData() + 4), chunk.size() - 4);
+	chunk.append(bigEndian(crc));
+	if (m_file.write(chunk) != chunk.size()) {
+		fail(m_file.errorString());
+		return false;
+	}
+	return true;
+}
+
+void PngBandWriter::fail(const QString & error) {
+	if (m_error.isEmpty()) m_error = error;
+}
@@ -0,0 +1,62 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef PNGBANDWRITER_H
+#define PNGBANDWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+class PngBandWriter
+{
+	// writes a PNG one band of rows at a time, deflating as it goes, so that an image
+	// larger than memory allows never has to be held whole; rows are not filtered
+
+public:
+	PngBandWriter() = default;
+	~PngBandWriter();
+
+	bool open(const QString & fileName, const QSize &, bool alpha, int dotsPerMeter, const QString & description, int compression = -1);
+	bool writeBand(const QImage &);			// the next rows, top to bottom, as wide as the image
+	bool close();
+	int rowsWritten() const;
+	const QString & errorString() const;
+
+protected:
+	bool deflateData(const uchar * data, int length, bool finish);
+	bool writeChunk(const char * type, const QByteArray & data);
+	void fail(const QString & error);
+
+protected:
+	static const int OutputSize = 256 * 1024;	// bytes per IDAT chunk
+
+	QFile m_file;
+	QSize m_size;
+	bool m_alpha = false;
+	int m_rowsWritten = 0;
+	struct z_stream_s * m_stream = nullptr;
+	QByteArray m_output;
+	QString m_error;
+};
+
+#endif
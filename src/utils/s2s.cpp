@@ -220,6 +220,12 @@ S2S::S2S(bool fzpzStyle) : QObject(),
 {
 }
 
+S2S::~S2S()
+{
+	qDeleteAll(m_connectorLocations);
+	delete m_image;
+}
+
 void S2S::message(const QString & msg) {
 	// QTextStream cout(stdout);
 	//  cout << msg;
@@ -254,6 +260,8 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 	m_rights.clear();
 	m_tops.clear();
 	m_bottoms.clear();
+	qDeleteAll(m_connectorLocations);
+	m_connectorLocations.clear();
 
 	QFile file(fzpFilePath);
 	file.open(QIODevice::ReadOnly);
@@ -310,13 +318,17 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 	qDebug() << schematicFilePath;
 
 	QSvgRenderer renderer;
-	bool loaded = renderer.load(schematicFilePath);
+	// in a dry run the terminal points ensureTerminalPoints() added are only in m_outputs
+	bool loaded = m_outputs.contains(schematicFilePath)
+	              ? renderer.load(m_outputs.value(schematicFilePath).toUtf8())
+	              : renderer.load(schematicFilePath);
 	if (!loaded) {
 		message(tr("Unable to load schematic '%1' for '%2'").arg(schematicFilePath, fzpFilePath));
 		return false;
 	}
 
 	QList<ConnectorLocation *> connectorLocations = initConnectors(root, renderer, fzpFilePath, schematicFilePath);
+	m_connectorLocations = connectorLocations;
 
 	QRectF viewBox = renderer.viewBoxF();
 	if (viewBox.isEmpty()) {
@@ -511,7 +523,7 @@ bool S2S::onefzp(QString & fzpFilePath, QString & schematicFilePath) {
 	svg +="</g>\n";
 	svg +="</svg>\n";
 
-	TextUtils::writeUtf8(newSchematicFilePath, svg);
+	writeOutput(newSchematicFilePath, svg);
 	qDebug() << newSchematicFilePath;
 	qDebug() << "";
 	return true;
@@ -843,10 +855,10 @@ bool S2S::ensureTerminalPoints(const QString & fzpFilePath, const QString & svgF
 	}
 
 	if (svgChanged) {
-		TextUtils::writeUtf8(svgFilePath, TextUtils::removeXMLEntities(dom.toString(4)));
+		writeOutput(svgFilePath, TextUtils::removeXMLEntities(dom.toString(4)));
 	}
 	if (fzpChanged) {
-		TextUtils::writeUtf8(fzpFilePath, TextUtils::removeXMLEntities(fzpRoot.ownerDocument().toString(4)));
+		writeOutput(fzpFilePath, TextUtils::removeXMLEntities(fzpRoot.ownerDocument().toString(4)));
 	}
 
 	return true;
@@ -895,3 +907,20 @@ void S2S::setSvgDirs(QDir & oldDir, QDir & newDir) {
 	m_oldSvgDir = oldDir;
 	m_newSvgDir = newDir;
 }
+
+void S2S::setDryRun(bool dryRun) {
+	m_dryRun = dryRun;
+}
+
+const QMap<QString, QString> & S2S::outputs() const {
+	return m_outputs;
+}
+
+void S2S::writeOutput(const QString & path, const QString & content) {
+	if (m_dryRun) {
+		m_outputs.insert(path, content);
+		return;
+	}
+
+	TextUtils::writeUtf8(path, content);
+}
@@ -6,6 +6,7 @@
 #include <QString>
 #include <QRectF>
 #include <QDomElement>
+#include <QMap>
 #include <QSvgRenderer>
 
 
@@ -33,9 +34,12 @@ class S2S : public QObject
 	Q_OBJECT
 public:
 	S2S(bool fzpzStyle);
+	~S2S();
 
 	bool onefzp(QString & fzpFilePath, QString & schematicFilePath);
 	void setSvgDirs(QDir & oldDir, QDir & newDir);
+	void setDryRun(bool);
+	const QMap<QString, QString> & outputs() const;
 
 
 Q_SIGNALS:
@@ -50,6 +54,7 @@ protected:
 	void setHidden(QList<ConnectorLocation *> &);
 	bool ensureTerminalPoints(const QString & fzpFilename, const QString & svgFilename, QDomElement & fzpRoot);
 	double spaceTitle(QStringList & titles, int openUnits);
+	void writeOutput(const QString & path, const QString & content);
 
 
 protected:
@@ -67,6 +72,9 @@ protected:
 	QDir m_oldSvgDir;
 	QDir m_newSvgDir;
 	QImage * m_image;
+	QList<ConnectorLocation *> m_connectorLocations;
+	bool m_dryRun = false;
+	QMap<QString, QString> m_outputs;           // path -> content of what a dry run would have written
 };
 
 
@@ -0,0 +1,174 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "settingscache.h"
+
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QSettings>
+#include <QStringList>
+#include <QtConcurrentRun>
+
+struct Cache {
+	QReadWriteLock lock;
+	bool loaded = false;
+	QHash<QString, QVariant> values;
+	QList<QPair<QString, QVariant>> pending;            // in the order written; an invalid value removes the key
+	bool writing = false;
+	QFuture<void> writer;
+};
+
+static Cache & cache()
+{
+	static Cache TheCache;
+	return TheCache;
+}
+
+static void load(Cache & c)
+{
+	// callers hold the write lock
+	QSettings settings;
+	Q_FOREACH (QString key, settings.allKeys()) {
+		c.values.insert(key, settings.value(key));
+	}
+	c.loaded = true;
+}
+
+static void writePending()
+{
+	// runs until nothing is left, so one writer at a time stores the changes in order
+	Cache & c = cache();
+	QSettings settings;
+	while (true) {
+		QList<QPair<QString, QVariant>> batch;
+		{
+			QWriteLocker locker(&c.lock);
+			if (c.pending.isEmpty()) {
+				c.writing = false;
+				return;
+			}
+			batch.swap(c.pending);
+		}
+
+		for (const auto & change : batch) {
+			if (change.second.isValid()) {
+				settings.setValue(change.first, change.second);
+			}
+			else {
+				settings.remove(change.first);
+			}
+		}
+		settings.sync();
+	}
+}
+
+static void change(const QString & key, const QVariant & value)
+{
+	Cache & c = cache();
+	QWriteLocker locker(&c.lock);
+	if (!c.loaded) load(c);
+
+	if (value.isValid()) {
+		c.values.insert(key, value);
+	}
+	else {
+		c.values.remove(key);
+	}
+	c.pending.append(qMakePair(key, value));
+	if (!c.writing) {
+		c.writing = true;
+		c.writer = QtConcurrent::run(&writePending);
+	}
+}
+
+QVariant SettingsCache::value(const QString & key, const QVariant & defaultValue)
+{
+	Cache & c = cache();
+	{
+		QReadLocker locker(&c.lock);
+		if (c.loaded) return c.values.value(key, defaultValue);
+	}
+
+	QWriteLocker locker(&c.lock);
+	if (!c.loaded) load(c);
+	return c.values.value(key, defaultValue);
+}
+
+QString SettingsCache::stringValue(const QString & key, const QString & defaultValue)
+{
+	return value(key, defaultValue).toString();
+}
+
+bool SettingsCache::boolValue(const QString & key, bool defaultValue)
+{
+	return value(key, defaultValue).toBool();
+}
+
+int SettingsCache::intValue(const QString & key, int defaultValue)
+{
+	return value(key, defaultValue).toInt();
+}
+
+bool SettingsCache::contains(const QString & key)
+{
+	return value(key).isValid();
+}
+
+void SettingsCache::setValue(const QString & key, const QVariant & value)
+{
+	change(key, value);
+}
+
+void SettingsCache::remove(const QString & key)
+{
+	change(key, QVariant());
+}
+
+void SettingsCache::sync()
+{
+	// waits for the changes made so far to be stored; called before the application object goes away
+	QFuture<void> writer;
+	{
+		QReadLocker locker(&cache().lock);
+		writer = cache().writer;
+	}
+	writer.waitForFinished();
+}
+
+void SettingsCache::reload()
+{
+	// for after QSettings was changed behind the cache's back
+	sync();
+	QWriteLocker locker(&cache().lock);
+	cache().values.clear();
+	cache().loaded = false;
+}
+
+void SettingsCache::clear()
+{
+	sync();
+	{
+		QSettings settings;
+		settings.clear();
+	}
+	reload();
+}
@@ -0,0 +1,45 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef SETTINGSCACHE_H
+#define SETTINGSCACHE_H
+
+#include <QString>
+#include <QVariant>
+
+class SettingsCache
+{
+	// QSettings read once into memory, for values looked up over and over (keepouts, via and trace sizes,
+	// autorouter and DRC options); writes made here are seen at once and stored on the thread pool in order.
+	// A key read here should only be written here, since changes made with a plain QSettings aren't seen.
+
+public:
+	static QVariant value(const QString & key, const QVariant & defaultValue = QVariant());
+	static QString stringValue(const QString & key, const QString & defaultValue = QString());
+	static bool boolValue(const QString & key, bool defaultValue = false);
+	static int intValue(const QString & key, int defaultValue = 0);
+	static bool contains(const QString & key);
+	static void setValue(const QString & key, const QVariant & value);
+	static void remove(const QString & key);
+	static void sync();
+	static void reload();
+	static void clear();
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "startupprofiler.h"
+#include "textutils.h"
+#include "../debugdialog.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// counting only happens while profiling, so otherwise the replaced operators cost one untaken branch;
+// libraries with their own allocator (e.g. Qt dlls on Windows) aren't counted
+static std::atomic<bool> Counting(false);
+static std::atomic<quint64> Allocations(0);
+
+static void * countedAlloc(std::size_t size) {
+	if (Counting.load(std::memory_order_relaxed)) {
+		Allocations.fetch_add(1, std::memory_order_relaxed);
+	}
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void * operator new(std::size_t size) {
+	void * p = countedAlloc(size);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void * operator new[](std::size_t size) {
+	void * p = countedAlloc(size);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return countedAlloc(size);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return countedAlloc(size);
+}
+
+void operator delete(void * p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void * p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void * p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void * p, const std::nothrow_t &) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void * p, const std::nothrow_t &) noexcept {
+	std::free(p);
+}
+
+///////////////////////////////////////////////////
+
+bool StartupProfiler::Enabled = false;
+QString StartupProfiler::ReportPath;
+QElapsedTimer StartupProfiler::Timer;
+QVector<StartupProfiler::Record> StartupProfiler::Records;
+QVector<int> StartupProfiler::Open;
+
+StartupProfiler::Phase::Phase(const QString & name) {
+	StartupProfiler::begin(name);
+}
+
+StartupProfiler::Phase::~Phase() {
+	StartupProfiler::end();
+}
+
+void StartupProfiler::enable(const QString & reportPath) {
+	Enabled = true;
+	ReportPath = reportPath;
+	Timer.start();
+	Counting.store(true);
+}
+
+bool StartupProfiler::enabled() {
+	return Enabled;
+}
+
+quint64 StartupProfiler::allocations() {
+	return Allocations.load(std::memory_order_relaxed);
+}
+
+void StartupProfiler::begin(const QString & name) {
+	if (!Enabled) return;
+
+	Record record;
+	record.name = name;
+	record.depth = Open.count();
+	record.startNs = Timer.nsecsElapsed();
+	record.allocations = allocations();
+	Open.append(Records.count());
+	Records.append(record);
+}
+
+void StartupProfiler::end() {
+	if (!Enabled || Open.isEmpty()) return;
+
+	Record & record = Records[Open.takeLast()];
+	record.ns = Timer.nsecsElapsed() - record.startNs;
+	record.allocations = allocations() - record.allocations;
+}
+
+void StartupProfiler::finish() {
+	// closes whatever is still open, reports, and stops profiling; later phases are ignored
+	if (!Enabled) return;
+
+	while (!Open.isEmpty()) end();
+	qint64 totalNs = Timer.nsecsElapsed();
+	quint64 totalAllocations = allocations();
+	Enabled = false;
+	Counting.store(false);
+
+	QJsonArray phases;
+	DebugDialog::debug(QString("startup profile: %1 ms, %2 allocations").arg(totalNs / 1.0e6, 0, 'f', 1).arg(totalAllocations));
+	Q_FOREACH (const Record & record, Records) {
+		DebugDialog::debug(QString("startup profile: %1%2 %3 ms %4 allocations")
+		                   .arg(QString(record.depth * 2, ' '))
+		                   .arg(record.name, -32 + (record.depth * 2))
+		                   .arg(record.ns / 1.0e6, 9, 'f', 1)
+		                   .arg(record.allocations, 10));
+		QJsonObject phase;
+		phase.insert("name", record.name);
+		phase.insert("depth", record.depth);
+		phase.insert("startMs", record.startNs / 1.0e6);
+		phase.insert("ms", record.ns / 1.0e6);
+		phase.insert("allocations", (double) record.allocations);
+		phases.append(phase);
+	}
+
+	if (!ReportPath.isEmpty()) {
+		QJsonObject report;
+		report.insert("totalMs", totalNs / 1.0e6);
+		report.insert("allocations", (double) totalAllocations);
+		report.insert("phases", phases);
+		TextUtils::writeUtf8(ReportPath, QJsonDocument(report).toJson());
+	}
+
+	Records.clear();
+}
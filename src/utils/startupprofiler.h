@@ -0,0 +1,64 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+class StartupProfiler
+{
+	// wall time and heap allocations per startup phase, turned on by -profile-startup;
+	// phases nest, and the breakdown goes to the debug log and, given a path, to a JSON file
+
+public:
+	class Phase {
+		// times the enclosing scope
+	public:
+		explicit Phase(const QString & name);
+		~Phase();
+	};
+
+public:
+	static void enable(const QString & reportPath);
+	static bool enabled();
+	static void begin(const QString & name);
+	static void end();
+	static void finish();
+	static quint64 allocations();
+
+protected:
+	struct Record {
+		QString name;
+		int depth = 0;
+		qint64 startNs = 0;
+		qint64 ns = 0;
+		quint64 allocations = 0;
+	};
+
+	static bool Enabled;
+	static QString ReportPath;
+	static QElapsedTimer Timer;
+	static QVector<Record> Records;
+	static QVector<int> Open;           // indices into Records
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "stringpool.h"
+
+#include <QMutexLocker>
+
+QMutex StringPool::Mutex;
+QSet<QString> StringPool::Strings;
+
+QString StringPool::intern(const QString & string)
+{
+	// parts are also loaded off the gui thread when regenerating the database
+	if (string.isEmpty()) return string;
+
+	QMutexLocker locker(&Mutex);
+	return *Strings.insert(string);
+}
+
+int StringPool::count()
+{
+	QMutexLocker locker(&Mutex);
+	return Strings.count();
+}
+
+void StringPool::clear()
+{
+	// strings already handed out keep their data; only the pool's references go
+	QMutexLocker locker(&Mutex);
+	Strings.clear();
+}
@@ -0,0 +1,42 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+class StringPool
+{
+	// one shared copy of each short string that repeats across thousands of parts: property names and values,
+	// tags, connector ids, names and svg ids; an interned string is an implicitly shared copy of the pooled one
+
+public:
+	static QString intern(const QString &);
+	static int count();
+	static void clear();
+
+protected:
+	static QMutex Mutex;
+	static QSet<QString> Strings;
+};
+
+#endif
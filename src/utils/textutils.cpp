@@ -38,6 +38,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QUuid>
 #include <QCryptographicHash>
 #include <QDebug>
+#include <QLocale>
 
 #include <array>
 #include <qmath.h>
@@ -70,8 +71,55 @@ const QString TextUtils::MicroSymbol = QString::fromUtf16(&MicroSymbolCode, 1);
 
 const QString TextUtils::AdobeIllustratorIdentifier = "Generator: Adobe Illustrator";
 
-QList<QString> PowerPrefixes;
-QList<double> PowerPrefixValues;
+// lowest first, as convertToPowerPrefix picks the first that keeps the mantissa under 100; 0 is no prefix
+struct PowerPrefix {
+	char16_t symbol;
+	double value;
+};
+
+static constexpr PowerPrefix PowerPrefixes[] = {
+	{ u'p', 0.000000000001 },
+	{ u'n', 0.000000001 },
+	{ u'\u00b5', 0.000001 },
+	{ u'u', 0.000001 },
+	{ u'm', 0.001 },
+	{ 0, 1 },
+	{ u'k', 1000 },
+	{ u'M', 1000000 },
+	{ u'G', 1000000000. },
+	{ u'T', 1000000000000. },
+};
+
+// length suffixes convertToInches understands, as divisors from inches; px depends on who made the svg
+struct Unit {
+	const char * name;
+	double divisor;
+	double illustratorDivisor;
+};
+
+static constexpr Unit Units[] = {
+	{ "cm", 2.54, 0 },
+	{ "mm", 25.4, 0 },
+	{ "in", 1.0, 0 },
+	{ "px", 90.0, 72.0 },
+	{ "mil", 1000.0, 0 },
+	{ "pt", 72.0, 0 },
+	{ "pc", 6.0, 0 },
+};
+
+static bool viewToDouble(QStringView string, double & result)
+{
+	// what QString::toDouble does, without the string
+	static const QLocale CNumbers = [] {
+		QLocale locale = QLocale::c();
+		locale.setNumberOptions(QLocale::RejectGroupSeparator);
+		return locale;
+	}();
+
+	bool ok;
+	result = CNumbers.toDouble(string, &ok);
+	return ok;
+}
 const QString TextUtils::PowerPrefixesString = QString("pnmkMGTu\\x%1").arg(MicroSymbolCode, 4, 16, QChar('0'));
 
 typedef QHash<QString /*brokenFont*/, QString /*replacementFont*/> FixedFontsHash;
@@ -225,41 +273,26 @@ double TextUtils::convertToInches(const QString & string, bool * ok, bool isIllu
 }
 
 std::optional<double> TextUtils::convertToInches(const QString & s, bool isIllustrator) {
-	QString string = s;
-	double divisor = 1.0;
-	int chop = 2;
-	if (string.endsWith("cm", Qt::CaseInsensitive)) {
-		divisor = 2.54;
-	}
-	else if (string.endsWith("mm", Qt::CaseInsensitive)) {
-		divisor = 25.4;
-	}
-	else if (string.endsWith("in", Qt::CaseInsensitive)) {
-		divisor = 1.0;
-	}
-	else if (string.endsWith("px", Qt::CaseInsensitive)) {
-		divisor = isIllustrator? 72.0: 90.0;
-	}
-	else if (string.endsWith("mil", Qt::CaseInsensitive)) {
-		divisor = 1000.0;
-		chop = 3;
-	}
-	else if (string.endsWith("pt", Qt::CaseInsensitive)) {
-		divisor = 72.0;
-	}
-	else if (string.endsWith("pc", Qt::CaseInsensitive)) {
-		divisor = 6.0;
+	// called for every length attribute while loading, so it works on a view of the string rather than a copy
+	QStringView string(s);
+	double divisor = 90.0;			// default to Qt's standard internal units if all else fails
+	bool gotUnit = false;
+	for (const Unit & unit : Units) {
+		if (string.endsWith(QLatin1String(unit.name), Qt::CaseInsensitive)) {
+			divisor = (isIllustrator && unit.illustratorDivisor != 0) ? unit.illustratorDivisor : unit.divisor;
+			string.chop(qstrlen(unit.name));
+			gotUnit = true;
+			break;
+		}
 	}
-	else {
+
+	if (!gotUnit) {
 		chopNotDigits(string);
-		divisor = 90.0;			// default to Qt's standard internal units if all else fails
-		chop = 0;
 	}
 
-	if (chop) string.chop(chop);
-
-	if (auto result = optToDouble(string)) {
-		return *result / divisor;
+	double result;
+	if (viewToDouble(string, result)) {
+		return result / divisor;
 	}
 	return std::nullopt;
 }
@@ -274,6 +307,16 @@ void TextUtils::chopNotDigits(QString & string) {
 	}
 }
 
+void TextUtils::chopNotDigits(QStringView & string) {
+	while (!string.isEmpty()) {
+		QChar ch = string.back();
+		if (ch.isDigit()) return;
+		if (ch == '.') return;
+
+		string.chop(1);
+	}
+}
+
 // This is more of a MathUtil, not a TextUtil. But many of the unit converion
 // inch and mm conversion and number representation methods are grouped in TextUtils
 template <>
@@ -854,14 +897,14 @@ bool TextUtils::addCopper1(const QString & filename, QDomDocument & domDocument,
 }
 
 QString TextUtils::convertToPowerPrefix(double q, char format, int precision) {
-	initPowerPrefixes();
-
 	if (q == 0) return QString::number(q, format, precision);
 
-	for (int i = 0; i < PowerPrefixes.count(); i++) {
-		if (abs(q) < 100 * PowerPrefixValues[i]) {
-			q /= PowerPrefixValues[i];
-			return QString::number(q, format, precision) + PowerPrefixes[i];
+	for (const PowerPrefix & prefix : PowerPrefixes) {
+		if (abs(q) < 100 * prefix.value) {
+			q /= prefix.value;
+			if (prefix.symbol == 0) return QString::number(q, format, precision);
+
+			return QString::number(q, format, precision) + QChar(prefix.symbol);
 		}
 	}
 
@@ -870,38 +913,33 @@ QString TextUtils::convertToPowerPrefix(double q, char format, int precision) {
 
 double TextUtils::convertFromPowerPrefixU(QString & val, const QString & symbol)
 {
-	val.replace('u', MicroSymbol);
+	if (val.contains('u')) val.replace('u', MicroSymbol);
 	return convertFromPowerPrefix(val, symbol);
 }
 
 double TextUtils::convertFromPowerPrefix(const QString & val, const QString & symbol)
 {
-	initPowerPrefixes();
-
+	// property values go through here while loading and netlisting, so no temporary strings
 	double multiplier = 1;
-	QString temp = val;
+	QStringView temp(val);
 	if (temp.endsWith(symbol)) {
 		temp.chop(symbol.length());
 	}
 
-	for (int i = 0; i < PowerPrefixes.count(); i++) {
-		if (PowerPrefixes[i].isEmpty()) continue;
+	if (!temp.isEmpty()) {
+		char16_t last = temp.back().unicode();
+		for (const PowerPrefix & prefix : PowerPrefixes) {
+			if (prefix.symbol == 0 || prefix.symbol != last) continue;
 
-		if (temp.endsWith(PowerPrefixes[i], Qt::CaseSensitive)) {
-			multiplier = PowerPrefixValues[i];
-			temp.chop(PowerPrefixes[i].length());
+			multiplier = prefix.value;
+			temp.chop(1);
 			break;
 		}
 	}
-	temp = temp.trimmed();
-	return temp.toDouble() * multiplier;
-}
+	double result;
+	if (!viewToDouble(temp, result)) return 0;
 
-void TextUtils::initPowerPrefixes() {
-	if (PowerPrefixes.count() == 0) {
-		PowerPrefixes << "p" << "n" << MicroSymbol  << "u" << "m" << "" << "k" << "M" << "G" << "T";
-		PowerPrefixValues << 0.000000000001 << 0.000000001 << 0.000001 << 0.000001 << 0.001 << 1 << 1000 << 1000000 << 1000000000. << 1000000000000.;
-	}
+	return result * multiplier;
 }
 
 void TextUtils::collectLeaves(QDomElement & element, int & index, QVector<QDomElement> & leaves) {
@@ -1064,51 +1102,197 @@ bool TextUtils::fixInternalUnits(QString & svg)
 	return result;
 }
 
-bool TextUtils::fixMuch(QString &svg, bool fixStrokeWidthFlag)
+static bool isUnitValue(QStringView value)
 {
-	bool result = cleanSodipodi(svg);
-	result |= fixInternalUnits(svg);
+	// a whole value like "12.5px", the way fixInternalUnits finds them between quotes
+	static const QStringList Units = { "px", "mm", "cm", "in", "pt", "pc" };
 
-	QDomDocument svgDom;
-	QString errorMsg;
-	int errorLine;
-	int errorCol;
-	if(!svgDom.setContent(svg, true, &errorMsg, &errorLine, &errorCol)) {
-		return result;
-	}
+	if (value.length() < 3) return false;
+	if (!Units.contains(value.right(2).toString())) return false;
 
-	QDomElement root = svgDom.documentElement();
-	result |= fixViewBox(root);
+	for (int i = 0; i < value.length() - 2; i++) {
+		QChar c = value.at(i);
+		if (!c.isDigit() && c != ',' && c != '.') return false;
+	}
+	return true;
+}
 
-	QStringList strings;
-	strings << "pattern" << "marker" << "clipPath";
-	for (const QString & string: std::as_const(strings)) {
-		if (svg.contains("<" + string)) {
-			result |= noPatternAux(svgDom, string);
+static bool hasUnitStrokeWidth(QStringView text)
+{
+	static const QString StrokeWidthColon("stroke-width:");
+
+	int ix = text.indexOf(StrokeWidthColon);
+	while (ix >= 0) {
+		int jx = ix + StrokeWidthColon.length();
+		int start = jx;
+		while (jx < text.length() && (text.at(jx).isDigit() || text.at(jx) == ',' || text.at(jx) == '.')) {
+			jx++;
 		}
-	}
+		if (jx > start && isUnitValue(text.mid(start, jx + 2 - start))) return true;
 
-	if (svg.contains("<use")) {
-		result |= noUseAux(svgDom);
+		ix = text.indexOf(StrokeWidthColon, jx);
 	}
+	return false;
+}
+
+static bool hasSodipodiPrefix(QStringView text)
+{
+	return text.startsWith(QLatin1String("sodipodi:")) || text.startsWith(QLatin1String("inkscape:"));
+}
+
+int TextUtils::detectSvgFixes(const QString & svg, int fixes, bool & isIllustrator)
+{
+	// one streaming pass marking the fixes that might change the svg; an unmarked fix is known
+	// to leave it alone.  When the svg doesn't stream cleanly every requested fix is marked
+
+	static const QStringList StructureTags = { "pattern", "marker", "clipPath", "use", "tspan" };
+
+	isIllustrator = false;
+	int found = NoSvgFix;
+	bool seenRoot = false;
+	bool rootInScope = false;           // fixInternalUnits searches from the end of the first "<svg" tag
+	bool rootPx = false;
+
+	auto scanText = [&](QStringView text) {
+		if (text.contains(AdobeIllustratorIdentifier, Qt::CaseInsensitive)) isIllustrator = true;
+		if (text.contains(QLatin1String("sodipodi:")) || text.contains(QLatin1String("inkscape:"))) found |= FixSodipodi;
+		if (text.contains('"') || text.contains('\'') || hasUnitStrokeWidth(text)) found |= FixInternalUnits;
+		if (text.contains(QLatin1String("font-family"))) found |= FixFontQuotes;
+		if (!seenRoot && text.contains(QLatin1String("<svg"))) rootInScope = true;
+	};
 
-	if (svg.contains("<tspan")) {
-		result |= tspanRemoveAux(svgDom);
+	QXmlStreamReader reader(svg);
+	while (!reader.atEnd()) {
+		switch (reader.readNext()) {
+		case QXmlStreamReader::StartElement: {
+			QStringView name = reader.qualifiedName();
+			QXmlStreamAttributes attributes = reader.attributes();
+			bool isRoot = !seenRoot;
+			seenRoot = true;
+			if (isRoot) {
+				if (name != QLatin1String("svg")) rootInScope = true;
+				for (const QXmlStreamAttribute & attribute : std::as_const(attributes)) {
+					if (attribute.value().contains('>')) rootInScope = true;
+				}
+			}
+
+			if (hasSodipodiPrefix(name)) found |= FixSodipodi;
+			if (StructureTags.contains(name.toString())) found |= FixStructure;
+
+			for (const QXmlStreamAttribute & attribute : std::as_const(attributes)) {
+				QStringView attributeName = attribute.qualifiedName();
+				QStringView value = attribute.value();
+				if (hasSodipodiPrefix(attributeName)) found |= FixSodipodi;
+				scanText(value);
+				if ((!isRoot || rootInScope) && isUnitValue(value)) found |= FixInternalUnits;
+				if (attributeName == QLatin1String("transform") && !value.isEmpty()) found |= FixStructure;
+				if (attributeName == QLatin1String("font-family") && value.startsWith('\'')) found |= FixFontQuotes;
+			}
+
+			QStringView stroke = attributes.value("stroke");
+			if (stroke.isEmpty()) {
+				if (attributes.value("style").contains(QLatin1String("stroke"))) found |= FixStrokeWidth;
+			}
+			else if (stroke != QLatin1String("none") && attributes.value("stroke-width").isEmpty()) {
+				found |= FixStrokeWidth;
+			}
+
+			if (isRoot && name == QLatin1String("svg")) {
+				rootPx = attributes.value("width").endsWith(QLatin1String("px")) || attributes.value("height").endsWith(QLatin1String("px"));
+				QString viewBox = attributes.value("viewBox").toString();
+				QStringList coords = viewBox.split(QRegularExpression(" |,"));
+				if (!viewBox.isEmpty() && coords.length() == 4 && !(coords[0] == "0" && coords[1] == "0")) {
+					found |= FixStructure;
+				}
+			}
+			break;
+		}
+		case QXmlStreamReader::Characters:
+			if (!reader.isWhitespace()) scanText(reader.text());
+			break;
+		case QXmlStreamReader::Comment:
+		case QXmlStreamReader::DTD:
+		case QXmlStreamReader::EntityReference:
+			scanText(reader.text());
+			break;
+		case QXmlStreamReader::ProcessingInstruction:
+			scanText(reader.processingInstructionData());
+			break;
+		default:
+			break;
+		}
 	}
 
-	if (fixStrokeWidthFlag) {
-		result |= fixStrokeWidth(svgDom);
+	if (reader.hasError()) {
+		isIllustrator = isIllustratorFile(svg);
+		return fixes;
 	}
 
-	result |= elevateTransform(root);
+	if (rootPx && isIllustrator) found |= FixPixelDimensions;
+	return found & fixes;
+}
+
+int TextUtils::fixSvg(QString & svg, int fixes)
+{
+	// runs the requested fixes in the order fixMuch, fixPixelDimensionsIn and fixFonts apply them,
+	// skipping those the svg doesn't need and parsing the dom at most once; returns the fixes applied
+
+	bool isIllustrator;
+	int found = detectSvgFixes(svg, fixes, isIllustrator);
+	if (found == NoSvgFix) return NoSvgFix;
+
+	int result = NoSvgFix;
+	if ((found & FixSodipodi) && cleanSodipodi(svg)) result |= FixSodipodi;
+	if ((found & FixInternalUnits) && fixInternalUnits(svg)) result |= FixInternalUnits;
+
+	if (result != NoSvgFix || (found & (FixStructure | FixStrokeWidth | FixPixelDimensions))) {
+		QDomDocument svgDom;
+		QString errorMsg;
+		int errorLine;
+		int errorCol;
+		if (svgDom.setContent(svg, true, &errorMsg, &errorLine, &errorCol)) {
+			bool changed = result != NoSvgFix;
+			QDomElement root = svgDom.documentElement();
+			if (found & FixStructure) {
+				bool structure = fixViewBox(root);
+				QStringList strings;
+				strings << "pattern" << "marker" << "clipPath";
+				for (const QString & string: std::as_const(strings)) {
+					structure |= noPatternAux(svgDom, string);
+				}
+				structure |= noUseAux(svgDom);
+				structure |= tspanRemoveAux(svgDom);
+				if (structure) result |= FixStructure;
+			}
+
+			// fixStrokeWidth moves style stroke values into attributes even when it reports no change
+			if ((fixes & FixStrokeWidth) && fixStrokeWidth(svgDom)) result |= FixStrokeWidth;
+
+			if ((found & FixStructure) && elevateTransform(root)) result |= FixStructure;
+
+			if ((found & FixPixelDimensions) && isIllustrator) {
+				QDomElement elem = svgDom.firstChildElement("svg");
+				bool px = pxToInches(elem, "width", isIllustrator);
+				px |= pxToInches(elem, "height", isIllustrator);
+				if (px) result |= FixPixelDimensions;
+			}
 
-	if (result) {
-		svg = removeXMLEntities(svgDom.toString());
+			if (changed || (result & (FixStructure | FixStrokeWidth | FixPixelDimensions))) {
+				svg = removeXMLEntities(svgDom.toString());
+			}
+		}
 	}
 
+	if ((found & FixFontQuotes) && removeFontFamilySingleQuotes(svg)) result |= FixFontQuotes;
+
 	return result;
 }
 
+bool TextUtils::fixMuch(QString &svg, bool fixStrokeWidthFlag)
+{
+	return fixSvg(svg, FixMuch | (fixStrokeWidthFlag ? FixStrokeWidth : NoSvgFix)) != NoSvgFix;
+}
+
 bool TextUtils::fixViewBox(QDomElement & root) {
 	QString viewBox = root.attribute("viewBox");
 	if (viewBox.isEmpty()) return false;
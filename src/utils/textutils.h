@@ -34,6 +34,18 @@ typedef QString (*MultiplyPinFunction)(int pin, double increment, double value);
 class TextUtils
 {
 
+public:
+	enum SvgFix {
+		NoSvgFix = 0,
+		FixSodipodi = 1,
+		FixInternalUnits = 2,
+		FixStructure = 4,                   // viewBox origin, pattern/marker/clipPath, use, tspan, transforms
+		FixStrokeWidth = 8,
+		FixPixelDimensions = 16,            // Illustrator px width and height
+		FixFontQuotes = 32,
+		FixMuch = FixSodipodi | FixInternalUnits | FixStructure
+	};
+
 public:
 	static QSet<QString> getRegexpCaptures(const QString &pattern, const QString &textToSearchIn);
 	static QDomElement findElementWithAttribute(QDomElement element, const QString & attributeName, const QString & attributeValue);
@@ -112,6 +124,7 @@ public:
 	static void gornTree(QDomDocument &);
 	static bool elevateTransform(QDomElement &);
 	static bool fixMuch(QString &svg, bool fixStrokeWidth);
+	static int fixSvg(QString & svg, int fixes);
 	static bool fixInternalUnits(QString & svg);
 	static bool fixFonts(QString & svg, const QString & destFont, bool & reallyFixed);
 	static void fixStyleAttribute(QDomElement & element);
@@ -152,7 +165,6 @@ public:
 protected:
 	static bool pxToInches(QDomElement &elem, const QString &attrName, bool isIllustrator);
 	static void squashNotElement(QDomElement & element, const QString & elementName, const QString & attName, const QRegularExpression & matchContent, bool & result);
-	static void initPowerPrefixes();
 	static QDomElement copyText(QDomDocument & svgDom, QDomElement & parent, QDomElement & text, const QString & defaultX, const QString & defaultY, bool copyAttributes);
 	static void gornTreeAux(QDomElement &);
 	static bool noPatternAux(QDomDocument & svgDom, const QString & tag);
@@ -162,7 +174,9 @@ protected:
 	static bool fixStrokeWidth(QDomDocument & svgDoc);
 	static bool fixViewBox(QDomElement & root);
 	static void chopNotDigits(QString &);
+	static void chopNotDigits(QStringView &);
 	static void collectTransforms(QDomElement & root, QList<QDomElement> & transforms);
+	static int detectSvgFixes(const QString & svg, int fixes, bool & isIllustrator);
 private:
 	static bool removeFontFamilySingleQuotes(QString &fileContent);
 };
@@ -0,0 +1,169 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+#include <atomic>
+
+static const int FlushBytes = 64 * 1024;
+
+static std::atomic<bool> Enabled(false);
+static std::atomic<int> NextThreadID(1);
+static QMutex Mutex;
+static QFile File;
+static QByteArray Buffer;
+static QElapsedTimer Timer;
+static qint64 ProcessID = 0;
+static bool First = true;
+
+static thread_local int ThreadID = 0;
+
+static void append(const QJsonObject & event) {
+	// called with the mutex held
+	Buffer += First ? "\n" : ",\n";
+	Buffer += QJsonDocument(event).toJson(QJsonDocument::Compact);
+	First = false;
+}
+
+Tracer::Scope::Scope(const char * name) {
+	if (!Enabled.load(std::memory_order_relaxed)) return;
+
+	m_active = true;
+	write("B", name, QString());
+}
+
+Tracer::Scope::Scope(const char * name, const QString & detail) {
+	if (!Enabled.load(std::memory_order_relaxed)) return;
+
+	m_active = true;
+	write("B", name, detail);
+}
+
+Tracer::Scope::~Scope() {
+	if (m_active) end();
+}
+
+bool Tracer::start(const QString & path) {
+	QMutexLocker locker(&Mutex);
+	if (Enabled.load()) return true;
+
+	File.setFileName(path);
+	if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	// the array format: viewers accept it without the closing bracket
+	Buffer = "[";
+	First = true;
+	ProcessID = QCoreApplication::applicationPid();
+	Timer.start();
+	Enabled.store(true);
+	return true;
+}
+
+bool Tracer::enabled() {
+	return Enabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::begin(const char * name) {
+	if (!Enabled.load(std::memory_order_relaxed)) return;
+
+	write("B", name, QString());
+}
+
+void Tracer::begin(const char * name, const QString & detail) {
+	if (!Enabled.load(std::memory_order_relaxed)) return;
+
+	write("B", name, detail);
+}
+
+void Tracer::end() {
+	if (!Enabled.load(std::memory_order_relaxed)) return;
+
+	write("E", nullptr, QString());
+}
+
+void Tracer::finish() {
+	// scopes still open are left unterminated, which the viewers show as running to the end
+	QMutexLocker locker(&Mutex);
+	if (!Enabled.load()) return;
+
+	Enabled.store(false);
+	Buffer += "\n]\n";
+	File.write(Buffer);
+	Buffer.clear();
+	File.close();
+}
+
+void Tracer::write(const char * phase, const char * name, const QString & detail) {
+	QJsonObject event;
+	if (name != nullptr) {
+		QString qname = QString::fromLatin1(name);
+		event.insert("name", qname);
+		event.insert("cat", qname.section('.', 0, 0));
+	}
+	if (!detail.isEmpty()) {
+		QJsonObject args;
+		args.insert("detail", detail);
+		event.insert("args", args);
+	}
+	event.insert("ph", QString::fromLatin1(phase));
+
+	QMutexLocker locker(&Mutex);
+	if (!Enabled.load()) return;
+
+	if (ThreadID == 0) {
+		// the first event from a thread names its track
+		ThreadID = NextThreadID++;
+		QThread * thread = QThread::currentThread();
+		QString threadName = thread->objectName();
+		if (QCoreApplication::instance() != nullptr && thread == QCoreApplication::instance()->thread()) {
+			threadName = "GUI";
+		}
+		else if (threadName.isEmpty()) {
+			threadName = QString("thread %1").arg(ThreadID);
+		}
+		QJsonObject args;
+		args.insert("name", threadName);
+		QJsonObject metadata;
+		metadata.insert("name", QString("thread_name"));
+		metadata.insert("ph", QString("M"));
+		metadata.insert("pid", ProcessID);
+		metadata.insert("tid", ThreadID);
+		metadata.insert("args", args);
+		append(metadata);
+	}
+
+	event.insert("pid", ProcessID);
+	event.insert("tid", ThreadID);
+	event.insert("ts", Timer.nsecsElapsed() / 1000.0);
+	append(event);
+	if (Buffer.size() >= FlushBytes) {
+		File.write(Buffer);
+		Buffer.clear();
+	}
+}
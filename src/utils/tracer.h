@@ -0,0 +1,56 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+
+class Tracer
+{
+	// begin/end events from any thread in the Chrome trace event format, for chrome://tracing and Perfetto;
+	// turned on by -trace FILE.json. Events go to the file in 64 KB chunks rather than piling up in memory,
+	// and a trace cut short still loads. While it's off, a scope costs one untaken branch
+
+public:
+	class Scope {
+		// traces the enclosing scope
+	public:
+		explicit Scope(const char * name);
+		Scope(const char * name, const QString & detail);
+		~Scope();
+
+	protected:
+		bool m_active = false;
+	};
+
+public:
+	static bool start(const QString & path);
+	static bool enabled();
+	static void begin(const char * name);
+	static void begin(const char * name, const QString & detail);
+	static void end();
+	static void finish();
+
+protected:
+	static void write(const char * phase, const char * name, const QString & detail);
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#include "zipwriter.h"
+#include "textutils.h"
+#include "../debugdialog.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+static const qint64 BlockSize = 64 * 1024;
+
+ZipWriter::ZipWriter(const QString & path) : m_path(path)
+{
+}
+
+ZipWriter::~ZipWriter()
+{
+	// not committed: drop the partial archive
+	if (m_zip) {
+		m_zip->close();
+		m_zip.reset();
+	}
+	if (!m_tempPath.isEmpty()) {
+		QFile::remove(m_tempPath);
+	}
+}
+
+bool ZipWriter::open()
+{
+	m_tempPath = m_path + "." + TextUtils::getRandText() + ".saving";
+	m_zip.reset(new QuaZip(m_tempPath));
+	if (!m_zip->open(QuaZip::mdCreate)) {
+		return failed(QString("zip.open(): %1").arg(m_zip->getZipError()));
+	}
+
+	DebugDialog::debug("zipping into " + m_path);
+	return true;
+}
+
+bool ZipWriter::addEntry(const QString & name, const QByteArray & contents)
+{
+	if (!m_zip) return false;
+
+	QuaZipFile out(m_zip.data());
+	if (!out.open(QIODevice::WriteOnly, QuaZipNewInfo(name))) {
+		return failed(QString("outFile.open(): %1").arg(out.getZipError()));
+	}
+
+	out.write(contents);
+	out.close();
+	if (out.getZipError() != UNZ_OK) {
+		return failed(QString("outFile.close(): %1").arg(out.getZipError()));
+	}
+
+	m_names.insert(name);
+	return true;
+}
+
+bool ZipWriter::addFile(const QString & name, const QString & path)
+{
+	if (!m_zip) return false;
+
+	QFile in(path);
+	if (!in.open(QIODevice::ReadOnly)) {
+		return failed(QString("inFile.open(): %1").arg(in.errorString()));
+	}
+
+	QuaZipFile out(m_zip.data());
+	if (!out.open(QIODevice::WriteOnly, QuaZipNewInfo(name, path))) {
+		return failed(QString("outFile.open(): %1").arg(out.getZipError()));
+	}
+
+	QByteArray block;
+	while (!(block = in.read(BlockSize)).isEmpty()) {
+		if (out.write(block) != block.size()) break;
+	}
+	out.close();
+	if (out.getZipError() != UNZ_OK) {
+		return failed(QString("outFile.close(): %1").arg(out.getZipError()));
+	}
+
+	m_names.insert(name);
+	return true;
+}
+
+bool ZipWriter::contains(const QString & name) const
+{
+	return m_names.contains(name);
+}
+
+bool ZipWriter::commit()
+{
+	if (!m_zip) return false;
+
+	m_zip->close();
+	int zipError = m_zip->getZipError();
+	m_zip.reset();
+	if (zipError != UNZ_OK) {
+		return failed(QString("zip.close(): %1").arg(zipError));
+	}
+
+	// if we're here the user has already accepted to overwrite
+	if (QFileInfo(m_path).exists() && !QFile::remove(m_path)) {
+		return failed(QString("unable to replace %1").arg(m_path));
+	}
+	if (!QFile::rename(m_tempPath, m_path)) {
+		return failed(QString("unable to rename %1 to %2").arg(m_tempPath, m_path));
+	}
+
+	m_tempPath.clear();
+	return true;
+}
+
+const QString & ZipWriter::errorString() const
+{
+	return m_error;
+}
+
+bool ZipWriter::failed(const QString & error)
+{
+	m_error = error;
+	DebugDialog::debug(error);
+	return false;
+}
@@ -0,0 +1,56 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+#ifndef ZIPWRITER_H
+#define ZIPWRITER_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QSet>
+#include <QString>
+
+class ZipWriter
+{
+	// writes a zip entry by entry as each one is produced, from memory or from a file, into a
+	// temporary file beside the destination; commit renames it over the destination, so a failed
+	// save leaves the previous file in place and nothing is staged in a folder or copied afterwards
+
+public:
+	explicit ZipWriter(const QString & path);
+	~ZipWriter();
+
+	bool open();
+	bool addEntry(const QString & name, const QByteArray & contents);
+	bool addFile(const QString & name, const QString & path);
+	bool contains(const QString & name) const;
+	bool commit();
+	const QString & errorString() const;
+
+protected:
+	bool failed(const QString & error);
+
+protected:
+	QString m_path;
+	QString m_tempPath;
+	QScopedPointer<class QuaZip> m_zip;
+	QSet<QString> m_names;
+	QString m_error;
+};
+
+#endif
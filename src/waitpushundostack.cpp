@@ -20,9 +20,13 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "waitpushundostack.h"
 #include "utils/folderutils.h"
+#include "utils/interactionprofiler.h"
+#include "utils/tracer.h"
 #include "commands.h"
+#include "debugdialog.h"
 
 #include <QCoreApplication>
+#include <QSettings>
 #include <QTextStream>
 
 CommandTimer::CommandTimer(QUndoCommand * command, int delayMS, WaitPushUndoStack * undoStack) : QTimer()
@@ -45,10 +49,14 @@ void CommandTimer::timedout() {
 
 /////////////////////////////////
 
+static const qint64 DefaultMemoryLimitMB = 1024;
+
 WaitPushUndoStack::WaitPushUndoStack(QObject * parent) :
 	QUndoStack(parent)
 {
 	m_temporary = nullptr;
+	QSettings settings;
+	setMemoryLimit(settings.value("undoMemoryLimitMB", DefaultMemoryLimitMB).toLongLong() * 1024 * 1024);
 #ifndef QT_NO_DEBUG
 	QString path = FolderUtils::getTopLevelUserDataStorePath();
 	path += "/undostack.txt";
@@ -65,15 +73,112 @@ WaitPushUndoStack::~WaitPushUndoStack() {
 
 void WaitPushUndoStack::push(QUndoCommand * cmd)
 {
+	InteractionProfiler::Scope profile(InteractionProfiler::CommandPush);
+	Tracer::Scope tracing("command.push", cmd->text());
+
 #ifndef QT_NO_DEBUG
 	writeUndo(cmd, 0, nullptr);
 #endif
+	Q_EMIT aboutToPush();
 	if (m_temporary == cmd) {
 		m_temporary->redo();
 		return;
 	}
 
+	compact(cmd);
+	m_costs.remove(cmd);                // in case a released command's address has been reused
 	QUndoStack::push(cmd);
+	enforceMemoryLimit();
+}
+
+void WaitPushUndoStack::setMemoryLimit(qint64 bytes) {
+	m_memoryLimit = qMax((qint64) 0, bytes);
+}
+
+qint64 WaitPushUndoStack::memoryLimit() const {
+	return m_memoryLimit;
+}
+
+qint64 WaitPushUndoStack::memoryCost() const {
+	// what the commands that can still be undone or redone are estimated to hold
+	qint64 total = 0;
+	for (int i = 0; i < count(); i++) {
+		const QUndoCommand * cmd = command(i);
+		if (cmd->isObsolete()) continue;
+
+		total += m_costs.contains(cmd) ? m_costs.value(cmd) : commandCost(cmd);
+	}
+	return total;
+}
+
+qint64 WaitPushUndoStack::commandCost(const QUndoCommand * cmd) {
+	const auto * bcmd = dynamic_cast<const BaseCommand *>(cmd);
+	qint64 cost = (bcmd == nullptr) ? 128 + (cmd->text().size() * (qint64) sizeof(QChar)) : bcmd->memoryCost();
+	for (int i = 0; i < cmd->childCount(); i++) {
+		cost += commandCost(cmd->child(i));
+	}
+	return cost;
+}
+
+void WaitPushUndoStack::compact(QUndoCommand * cmd) {
+	auto * bcmd = dynamic_cast<BaseCommand *>(cmd);
+	if (bcmd != nullptr) {
+		bcmd->compact();
+	}
+	for (int i = 0; i < cmd->childCount(); i++) {
+		// QUndoCommand only hands out const children, but they are ours until pushed
+		compact(const_cast<QUndoCommand *>(cmd->child(i)));
+	}
+}
+
+void WaitPushUndoStack::release(QUndoCommand * cmd) {
+	auto * bcmd = dynamic_cast<BaseCommand *>(cmd);
+	if (bcmd != nullptr) {
+		bcmd->releaseSubCommands();
+	}
+	for (int i = 0; i < cmd->childCount(); i++) {
+		release(const_cast<QUndoCommand *>(cmd->child(i)));
+	}
+}
+
+void WaitPushUndoStack::enforceMemoryLimit() {
+	// the oldest commands beyond the limit are made obsolete: QUndoStack skips their undo and redo
+	// and deletes them once the index reaches them, and their sub-commands are freed right away.
+	// Every index below the last released command then stands for the same sketch state
+	QHash<const QUndoCommand *, qint64> costs;
+	qint64 total = 0;
+	for (int i = 0; i < count(); i++) {
+		const QUndoCommand * cmd = command(i);
+		qint64 cost = m_costs.contains(cmd) ? m_costs.value(cmd) : commandCost(cmd);
+		costs.insert(cmd, cost);
+		if (!cmd->isObsolete()) total += cost;
+	}
+	m_costs.swap(costs);
+
+	if (m_memoryLimit <= 0 || total <= m_memoryLimit) return;
+
+	int lastReleased = -1;
+	int released = 0;
+	for (int i = 0; i < index() - 1 && total > m_memoryLimit * 3 / 4; i++) {
+		auto * cmd = const_cast<QUndoCommand *>(command(i));
+		if (cmd->isObsolete()) continue;
+
+		release(cmd);
+		cmd->setObsolete(true);
+		cmd->setText(tr("%1 (no longer undoable)").arg(cmd->text()));
+		total -= m_costs.value(cmd);
+		m_costs.insert(cmd, commandCost(cmd));
+		lastReleased = i;
+		released++;
+	}
+
+	if (lastReleased >= 0) {
+		DebugDialog::debug(QString("undo stack over %1 bytes; released %2 commands").arg(m_memoryLimit).arg(released));
+		if (cleanIndex() >= 0 && cleanIndex() <= lastReleased) {
+			// the saved state can no longer be reached by undoing
+			resetClean();
+		}
+	}
 }
 
 
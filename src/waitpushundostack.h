@@ -26,6 +26,7 @@ along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMutex>
 #include <QFile>
 #include <QPointer>
+#include <QHash>
 
 class WaitPushUndoStack : public QUndoStack
 {
@@ -42,6 +43,15 @@ public:
 	void addTimer(QTimer *);
 	void push(QUndoCommand *);
 	bool hasTimers();
+	void setMemoryLimit(qint64 bytes);
+	qint64 memoryLimit() const;
+	qint64 memoryCost() const;
+
+public:
+	static qint64 commandCost(const QUndoCommand *);
+
+Q_SIGNALS:
+	void aboutToPush();                 // before the command's first redo
 
 #ifndef QT_NO_DEBUG
 public:
@@ -55,12 +65,17 @@ protected:
 	void clearDeadTimers();
 	void clearLiveTimers();
 	void clearTimers(QList<QTimer *> &);
+	void compact(QUndoCommand *);
+	void release(QUndoCommand *);
+	void enforceMemoryLimit();
 
 protected:
 	QList<QTimer *> m_deadTimers;
 	QList<QTimer *> m_liveTimers;
 	QMutex m_mutex;
 	QUndoCommand * m_temporary;
+	qint64 m_memoryLimit = 0;                           // 0 for no limit
+	QHash<const QUndoCommand *, qint64> m_costs;        // for the top-level commands on the stack
 };
 
 
@@ -0,0 +1,120 @@
+#define BOOST_TEST_MODULE Binary Sketch Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "model/binarysketch.h"
+
+#include <QBuffer>
+#include <QDomDocument>
+#include <QTextStream>
+
+static const char * Sketch = R"(<?xml version="1.0" encoding="UTF-8"?>
+<module fritzingVersion="1.0.0" xmlns:fz="http://fritzing.org/">
+    <!-- a comment -->
+    <title>Blink &amp; fade</title>
+    <instances>
+        <instance moduleIdRef="ResistorModuleID" modelIndex="5" path=":/resources/parts/core/resistor.fzp">
+            <property name="resistance" value="220"/>
+            <views>
+                <breadboardView layer="breadboard">
+                    <geometry z="2.5" x="10" y="20"/>
+                </breadboardView>
+                <pcbView layer="copper0">
+                    <geometry z="2.5" x="10" y="20"/>
+                </pcbView>
+            </views>
+        </instance>
+        <instance moduleIdRef="ResistorModuleID" modelIndex="6" path=":/resources/parts/core/resistor.fzp">
+            <text><![CDATA[<b>bold</b>]]></text>
+            <views fz:note="&lt;x&gt;"/>
+        </instance>
+    </instances>
+</module>
+)";
+
+static QString canonical(const QDomDocument & document)
+{
+	// the root element only, since the xml declaration is not part of the encoding
+	QString string;
+	QTextStream stream(&string);
+	document.documentElement().save(stream, 1);
+	return string;
+}
+
+static QString canonical(const QByteArray & xml)
+{
+	QDomDocument document;
+	document.setContent(xml);
+	return canonical(document);
+}
+
+BOOST_AUTO_TEST_CASE( binarysketch_roundtrip )
+{
+	QByteArray xml(Sketch);
+	QByteArray binary = BinarySketch::encode(xml);
+	BOOST_REQUIRE(!binary.isEmpty());
+	BOOST_CHECK(BinarySketch::isBinary(binary));
+	BOOST_CHECK(!BinarySketch::isBinary(xml));
+	BOOST_CHECK(binary.size() < xml.size());
+
+	QByteArray decoded = BinarySketch::decode(binary);
+	BOOST_REQUIRE(!decoded.isEmpty());
+	BOOST_CHECK_EQUAL(canonical(decoded).toStdString(), canonical(xml).toStdString());
+
+	// whitespace between elements is kept too, so a second pass is byte for byte the same
+	BOOST_CHECK(BinarySketch::encode(decoded) == binary);
+	BOOST_CHECK(BinarySketch::decode(BinarySketch::encode(decoded)) == decoded);
+}
+
+BOOST_AUTO_TEST_CASE( binarysketch_to_document )
+{
+	QByteArray xml(Sketch);
+	QDomDocument document;
+	QString errorString;
+	BOOST_REQUIRE(BinarySketch::toDocument(BinarySketch::encode(xml), document, &errorString));
+	BOOST_CHECK_EQUAL(canonical(document).toStdString(), canonical(xml).toStdString());
+
+	QDomElement text = document.documentElement().firstChildElement("instances").lastChildElement("instance").firstChildElement("text");
+	BOOST_CHECK(text.firstChild().isCDATASection());
+	BOOST_CHECK_EQUAL(text.text().toStdString(), "<b>bold</b>");
+}
+
+BOOST_AUTO_TEST_CASE( binarysketch_from_document )
+{
+	QDomDocument document;
+	BOOST_REQUIRE(document.setContent(QByteArray(Sketch)));
+	QByteArray binary = BinarySketch::encode(document);
+	BOOST_REQUIRE(BinarySketch::isBinary(binary));
+
+	QDomDocument decoded;
+	BOOST_REQUIRE(BinarySketch::toDocument(binary, decoded));
+	BOOST_CHECK_EQUAL(canonical(decoded).toStdString(), canonical(document).toStdString());
+
+	QDomElement text = decoded.documentElement().firstChildElement("instances").lastChildElement("instance").firstChildElement("text");
+	BOOST_CHECK(text.firstChild().isCDATASection());
+}
+
+BOOST_AUTO_TEST_CASE( binarysketch_device )
+{
+	QByteArray binary = BinarySketch::encode(QByteArray(Sketch));
+	QBuffer buffer(&binary);
+	buffer.open(QIODevice::ReadOnly);
+	BOOST_CHECK(BinarySketch::isBinary(buffer));
+	BOOST_CHECK_EQUAL(buffer.pos(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( binarysketch_corrupt )
+{
+	QString errorString;
+	BOOST_CHECK(BinarySketch::encode(QByteArray("<module><instances></module>"), &errorString).isEmpty());
+	BOOST_CHECK(!errorString.isEmpty());
+
+	QByteArray binary = BinarySketch::encode(QByteArray(Sketch));
+	for (int size = 0; size < binary.size(); size += 7) {
+		errorString.clear();
+		BOOST_CHECK(BinarySketch::decode(binary.left(size), &errorString).isEmpty());
+		BOOST_CHECK(!errorString.isEmpty());
+		QDomDocument document;
+		BOOST_CHECK(!BinarySketch::toDocument(binary.left(size), document));
+		BOOST_CHECK(document.documentElement().isNull());
+	}
+}
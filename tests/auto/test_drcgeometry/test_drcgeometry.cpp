@@ -0,0 +1,126 @@
+#define BOOST_TEST_MODULE DRC Geometry Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "autoroute/drcgeometry.h"
+
+#include <QDomDocument>
+
+#include <algorithm>
+
+static QDomDocument makeDoc(const QString & body)
+{
+	QDomDocument doc;
+	doc.setContent(QString("<svg xmlns='http://www.w3.org/2000/svg' viewBox='0 0 1000 1000'>%1</svg>").arg(body));
+	return doc;
+}
+
+BOOST_AUTO_TEST_CASE( rtree_intersecting )
+{
+	QVector<QRectF> rects;
+	for (int y = 0; y < 20; y++) {
+		for (int x = 0; x < 20; x++) {
+			rects << QRectF(x * 10, y * 10, 5, 5);
+		}
+	}
+	rects << QRectF(52, 52, 0, 0);          // a point
+
+	RTree tree;
+	tree.build(rects);
+	BOOST_REQUIRE(!tree.isEmpty());
+
+	QVector<int> result;
+	tree.intersecting(QRectF(43, 43, 14, 14), result);
+	std::sort(result.begin(), result.end());
+	QVector<int> expected;
+	expected << 4 * 20 + 4 << 4 * 20 + 5 << 5 * 20 + 4 << 5 * 20 + 5 << 400;
+	BOOST_CHECK(result == expected);
+
+	tree.intersecting(QRectF(500, 500, 10, 10), result);
+	BOOST_CHECK(result.isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( copper_shapes )
+{
+	QDomDocument doc = makeDoc(
+		"<g transform='translate(10,0)'>"
+		"<rect x='0' y='0' width='10' height='10' fill='black'/>"
+		"<circle cx='50' cy='5' r='5' style='fill:black'/>"
+		"<path d='M100,0 h10 v10 h-10 z' fill='black'/>"
+		"<line x1='0' y1='100' x2='100' y2='100' stroke='black' stroke-width='4'/>"
+		"</g>"
+		"<text x='0' y='0'>ignored</text>");
+	QDomElement root = doc.documentElement();
+
+	CopperGeometry geometry;
+	BOOST_REQUIRE_EQUAL(geometry.addShapes(root), 4);
+
+	const QVector<CopperShape> & shapes = geometry.shapes();
+	BOOST_CHECK_CLOSE(shapes.at(0).bounds.left(), 10.0, 0.001);
+	BOOST_CHECK_CLOSE(shapes.at(2).bounds.right(), 120.0, 0.001);
+	BOOST_CHECK_CLOSE(shapes.at(3).bounds.height(), 4.0, 0.001);
+
+	BOOST_CHECK_EQUAL(shapes.at(0).color.toStdString(), "black");
+	BOOST_CHECK_EQUAL(shapes.at(3).color.toStdString(), "black");
+
+	QDomElement rect = root.firstChildElement("g").firstChildElement("rect");
+	BOOST_CHECK_EQUAL(CopperGeometry::shapeIndex(rect), 0);
+	BOOST_CHECK_EQUAL(CopperGeometry::shapeIndex(root), -1);
+
+	// the text has no outline here
+	BOOST_CHECK(!geometry.allVector());
+
+	QDomDocument vectorDoc = makeDoc("<rect x='0' y='0' width='10' height='10' fill='#FFFFFF'/>");
+	QDomElement vectorRoot = vectorDoc.documentElement();
+	CopperGeometry vectorGeometry;
+	vectorGeometry.addShapes(vectorRoot);
+	BOOST_CHECK(vectorGeometry.allVector());
+	BOOST_CHECK_EQUAL(vectorGeometry.shapes().at(0).color.toStdString(), "#ffffff");
+}
+
+BOOST_AUTO_TEST_CASE( copper_violations )
+{
+	// two pads 8 apart, a third pad 30 away, and a trace touching the first pad
+	QDomDocument doc = makeDoc(
+		"<rect x='0' y='0' width='10' height='10' fill='black'/>"
+		"<rect x='18' y='0' width='10' height='10' fill='black'/>"
+		"<rect x='58' y='0' width='10' height='10' fill='black'/>"
+		"<line x1='5' y1='5' x2='5' y2='50' stroke='black' stroke-width='2'/>");
+	QDomElement root = doc.documentElement();
+
+	CopperGeometry geometry;
+	BOOST_REQUIRE_EQUAL(geometry.addShapes(root), 4);
+	geometry.setNet(0, 0);
+	geometry.setNet(1, 1);
+	geometry.setNet(2, 2);
+	geometry.setNet(3, 0);
+	geometry.buildIndex();
+
+	QList<CopperViolation> violations = geometry.violations(10);
+	BOOST_REQUIRE_EQUAL(violations.count(), 1);
+	BOOST_CHECK_EQUAL(violations.at(0).shape1, 0);
+	BOOST_CHECK_EQUAL(violations.at(0).shape2, 1);
+	BOOST_CHECK(violations.at(0).at.x() >= 18 && violations.at(0).at.x() <= 20);
+
+	BOOST_CHECK(geometry.violations(5).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( copper_outside )
+{
+	QDomDocument doc = makeDoc(
+		"<rect x='50' y='50' width='10' height='10' fill='black'/>"
+		"<rect x='92' y='50' width='10' height='10' fill='black'/>");
+	QDomElement root = doc.documentElement();
+
+	CopperGeometry geometry;
+	geometry.addShapes(root);
+
+	QPainterPath board;
+	board.addRect(0, 0, 100, 100);
+	QList<CopperViolation> outside = geometry.outside(board, 5);
+	BOOST_REQUIRE_EQUAL(outside.count(), 1);
+	BOOST_CHECK_EQUAL(outside.at(0).shape1, 1);
+
+	board = QPainterPath();
+	board.addRect(0, 0, 200, 200);
+	BOOST_CHECK(geometry.outside(board, 5).isEmpty());
+}
@@ -0,0 +1,145 @@
+#define BOOST_TEST_MODULE ERC Engine Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "connectors/ercengine.h"
+
+#include <algorithm>
+
+static ErcPin supply(const QString & part, double voltage, double currentMax = 0)
+{
+	ErcPin pin;
+	pin.part = part;
+	pin.connector = "V+";
+	pin.eType = ErcData::VCC;
+	pin.currentFlow = ErcData::Source;
+	pin.voltage.setValue(voltage);
+	pin.currentMax.setValue(currentMax);
+	return pin;
+}
+
+static ErcPin input(const QString & part, double voltageMin, double voltageMax, double current)
+{
+	ErcPin pin;
+	pin.part = part;
+	pin.connector = "VCC";
+	pin.eType = ErcData::VCC;
+	pin.currentFlow = ErcData::Sink;
+	pin.voltageMin.setValue(voltageMin);
+	pin.voltageMax.setValue(voltageMax);
+	pin.current.setValue(current);
+	return pin;
+}
+
+static ErcPin ground(const QString & part)
+{
+	ErcPin pin;
+	pin.part = part;
+	pin.connector = "GND";
+	pin.eType = ErcData::Ground;
+	pin.currentFlow = ErcData::Sink;
+	return pin;
+}
+
+static ErcNet net(const QList<ErcPin> & pins)
+{
+	ErcNet result;
+	result.pins = pins;
+	return result;
+}
+
+static QList<ErcViolation::Kind> kinds(const QList<ErcViolation> & violations)
+{
+	QList<ErcViolation::Kind> result;
+	Q_FOREACH (ErcViolation violation, violations) result << violation.kind;
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( clean_net )
+{
+	QList<ErcPin> pins;
+	pins << supply("VCC1", 5, 1) << input("U1", 4.5, 5.5, 0.2) << input("U2", 3, 5.5, 0.3);
+	BOOST_CHECK(ErcEngine::checkNet(net(pins)).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( supply_conflict )
+{
+	QList<ErcPin> pins;
+	pins << supply("VCC1", 5) << supply("VCC2", 3.3) << supply("VCC3", 5.0000001);
+	QList<ErcViolation> violations = ErcEngine::checkNet(net(pins));
+	BOOST_CHECK_EQUAL(violations.count(), 1);
+	BOOST_CHECK(violations.first().kind == ErcViolation::SupplyConflict);
+	BOOST_CHECK_EQUAL(violations.first().parts.count(), 3);
+}
+
+BOOST_AUTO_TEST_CASE( supply_short )
+{
+	QList<ErcPin> pins;
+	pins << supply("VCC1", 5) << ground("GND1");
+	BOOST_CHECK(kinds(ErcEngine::checkNet(net(pins))) == QList<ErcViolation::Kind>() << ErcViolation::SupplyShort);
+
+	// a 0V supply on ground is fine
+	pins.clear();
+	pins << supply("VCC1", 0) << ground("GND1");
+	BOOST_CHECK(ErcEngine::checkNet(net(pins)).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( voltage_range )
+{
+	QList<ErcPin> pins;
+	pins << supply("VCC1", 5) << input("U1", 1.8, 3.6, 0) << input("U2", 4.5, 5.5, 0);
+	QList<ErcViolation> violations = ErcEngine::checkNet(net(pins));
+	BOOST_CHECK_EQUAL(violations.count(), 1);
+	BOOST_CHECK(violations.first().kind == ErcViolation::VoltageRange);
+	BOOST_CHECK(violations.first().parts.contains("U1"));
+}
+
+BOOST_AUTO_TEST_CASE( over_current )
+{
+	QList<ErcPin> pins;
+	pins << supply("VCC1", 5, 0.5) << input("U1", 4.5, 5.5, 0.3) << input("U2", 4.5, 5.5, 0.3);
+	BOOST_CHECK(kinds(ErcEngine::checkNet(net(pins))) == QList<ErcViolation::Kind>() << ErcViolation::OverCurrent);
+
+	// a supply without a rating can't be overloaded
+	pins.replace(0, supply("VCC1", 5, 0));
+	BOOST_CHECK(ErcEngine::checkNet(net(pins)).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( unpowered )
+{
+	QList<ErcPin> pins;
+	pins << input("U1", 4.5, 5.5, 0.1) << input("U2", 4.5, 5.5, 0.1);
+	QList<ErcViolation> violations = ErcEngine::checkNet(net(pins));
+	BOOST_CHECK_EQUAL(violations.count(), 2);
+	BOOST_CHECK(violations.first().kind == ErcViolation::Unpowered);
+}
+
+BOOST_AUTO_TEST_CASE( incremental )
+{
+	QList<ErcNet> nets;
+	nets << net(QList<ErcPin>() << supply("VCC1", 5) << ground("GND1"));
+	nets << net(QList<ErcPin>() << input("U1", 4.5, 5.5, 0.1));
+	nets << net(QList<ErcPin>() << supply("VCC2", 5) << input("U2", 4.5, 5.5, 0.1));
+
+	ErcEngine engine;
+	QList<ErcViolation> violations = engine.check(nets);
+	BOOST_CHECK_EQUAL(engine.evaluated(), 3);
+	BOOST_CHECK_EQUAL(violations.count(), 2);
+	BOOST_CHECK_EQUAL(violations.at(0).net, 0);
+	BOOST_CHECK_EQUAL(violations.at(1).net, 1);
+
+	// the same nets, collected in another order, come from the cache
+	nets.swapItemsAt(0, 2);
+	std::reverse(nets[2].pins.begin(), nets[2].pins.end());
+	violations = engine.check(nets);
+	BOOST_CHECK_EQUAL(engine.evaluated(), 0);
+	BOOST_CHECK_EQUAL(violations.count(), 2);
+	BOOST_CHECK_EQUAL(violations.at(0).net, 1);
+	BOOST_CHECK_EQUAL(violations.at(1).net, 2);
+
+	// powering U1 only evaluates its net again
+	nets[1].pins << supply("VCC3", 5);
+	violations = engine.check(nets);
+	BOOST_CHECK_EQUAL(engine.evaluated(), 1);
+	BOOST_CHECK_EQUAL(violations.count(), 1);
+	BOOST_CHECK(violations.first().kind == ErcViolation::SupplyShort);
+}
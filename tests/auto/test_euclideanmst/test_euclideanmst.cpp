@@ -0,0 +1,153 @@
+#define BOOST_TEST_MODULE Euclidean MST Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "utils/euclideanmst.h"
+
+#include <QtMath>
+
+#include <algorithm>
+#include <random>
+
+typedef QPair<int, int> Edge;
+
+static double treeLength(const QVector<QPointF> & points, const QVector<Edge> & tree)
+{
+	double length = 0;
+	for (const Edge & edge : tree) {
+		QPointF d = points.at(edge.first) - points.at(edge.second);
+		length += qSqrt((d.x() * d.x()) + (d.y() * d.y()));
+	}
+	return length;
+}
+
+static int groupRoot(QVector<int> & parents, int node)
+{
+	while (parents.at(node) != node) node = parents.at(node);
+	return node;
+}
+
+static bool spansGroups(const QVector<int> & groups, const QVector<Edge> & tree)
+{
+	int groupCount = *std::max_element(groups.begin(), groups.end()) + 1;
+	QVector<int> parents(groupCount);
+	for (int i = 0; i < groupCount; i++) parents[i] = i;
+	for (const Edge & edge : tree) {
+		int root1 = groupRoot(parents, groups.at(edge.first));
+		int root2 = groupRoot(parents, groups.at(edge.second));
+		if (root1 == root2) return false;               // a wasted edge
+		parents[root2] = root1;
+	}
+	int root = groupRoot(parents, groups.first());
+	Q_FOREACH (int group, groups) {
+		if (groupRoot(parents, group) != root) return false;
+	}
+	return true;
+}
+
+static double bruteForceLength(const QVector<QPointF> & points, const QVector<int> & groups)
+{
+	// Kruskal over all pairs
+	QVector<Edge> edges;
+	for (int i = 0; i < points.count(); i++) {
+		for (int j = i + 1; j < points.count(); j++) edges << qMakePair(i, j);
+	}
+	auto length = [&points](const Edge & edge) {
+		QPointF d = points.at(edge.first) - points.at(edge.second);
+		return (d.x() * d.x()) + (d.y() * d.y());
+	};
+	std::sort(edges.begin(), edges.end(), [&length](const Edge & e1, const Edge & e2) { return length(e1) < length(e2); });
+
+	int groupCount = *std::max_element(groups.begin(), groups.end()) + 1;
+	QVector<int> parents(groupCount);
+	for (int i = 0; i < groupCount; i++) parents[i] = i;
+	QVector<Edge> tree;
+	for (const Edge & edge : edges) {
+		int root1 = groupRoot(parents, groups.at(edge.first));
+		int root2 = groupRoot(parents, groups.at(edge.second));
+		if (root1 == root2) continue;
+		parents[root2] = root1;
+		tree << edge;
+	}
+	return treeLength(points, tree);
+}
+
+static QVector<int> separateGroups(int count)
+{
+	QVector<int> groups(count);
+	for (int i = 0; i < count; i++) groups[i] = i;
+	return groups;
+}
+
+BOOST_AUTO_TEST_CASE( delaunay_square )
+{
+	QVector<QPointF> points;
+	points << QPointF(0, 0) << QPointF(10, 0) << QPointF(10, 10) << QPointF(0, 10) << QPointF(5, 4);
+
+	QVector<Edge> edges = EuclideanMST::delaunayEdges(points);
+	BOOST_CHECK_EQUAL(edges.count(), 8);               // the four sides and a spoke to each corner
+	BOOST_CHECK(edges.contains(qMakePair(0, 1)));
+	BOOST_CHECK(edges.contains(qMakePair(1, 4)));
+	BOOST_CHECK(!edges.contains(qMakePair(0, 2)));
+}
+
+BOOST_AUTO_TEST_CASE( spanning_tree_random )
+{
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> coordinate(0, 1000);
+	for (int trial = 0; trial < 50; trial++) {
+		QVector<QPointF> points;
+		int count = 2 + trial * 5;
+		for (int i = 0; i < count; i++) points << QPointF(coordinate(generator), coordinate(generator));
+
+		QVector<int> groups = separateGroups(count);
+		QVector<Edge> tree = EuclideanMST::spanningTree(points, groups);
+		BOOST_CHECK_EQUAL(tree.count(), count - 1);
+		BOOST_CHECK(spansGroups(groups, tree));
+		BOOST_CHECK_CLOSE(treeLength(points, tree), bruteForceLength(points, groups), 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( spanning_tree_groups )
+{
+	// a header's pins on one bus, plus parts on a grid with some of them coincident
+	QVector<QPointF> points;
+	QVector<int> groups;
+	for (int i = 0; i < 40; i++) {
+		points << QPointF(i * 100, 0);
+		groups << 0;
+	}
+	for (int i = 0; i < 60; i++) {
+		points << QPointF((i % 7) * 300, 500 + (i % 11) * 100);
+		groups << 1 + (i % 30);
+	}
+	for (int i = 0; i < points.count(); i++) {
+		for (int j = 0; j < i; j++) {
+			if (points.at(i) != points.at(j)) continue;
+
+			int from = groups.at(i);
+			for (int & group : groups) {
+				if (group == from) group = groups.at(j);
+			}
+			break;
+		}
+	}
+	QVector<int> used = groups;
+	std::sort(used.begin(), used.end());
+	used.erase(std::unique(used.begin(), used.end()), used.end());
+	for (int & group : groups) group = used.indexOf(group);
+
+	QVector<Edge> tree = EuclideanMST::spanningTree(points, groups);
+	BOOST_CHECK_EQUAL(tree.count(), used.count() - 1);
+	BOOST_CHECK(spansGroups(groups, tree));
+	BOOST_CHECK_CLOSE(treeLength(points, tree), bruteForceLength(points, groups), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE( spanning_tree_collinear )
+{
+	QVector<QPointF> points;
+	for (int i = 0; i < 30; i++) points << QPointF(0, i * 2.54);
+
+	QVector<Edge> tree = EuclideanMST::spanningTree(points, separateGroups(points.count()));
+	BOOST_CHECK_EQUAL(tree.count(), 29);
+	BOOST_CHECK_CLOSE(treeLength(points, tree), 29 * 2.54, 1e-6);
+}
@@ -14,6 +14,7 @@ specifcation strings, and segments
 #include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <QBuffer>
 #include <QFile>
 #include <QTextStream>
 
@@ -43,3 +44,93 @@ BOOST_AUTO_TEST_CASE( test_svg2gerber )
 	gerber3.convert(header + svgs[0], 2, "Silk1", SVG2gerber::ForSilk, QSizeF(3333.33, 2222.22));
 	BOOST_CHECK_EQUAL(gerber3.getGerber().toStdString(), gerbers[2].toStdString());
 }
+
+BOOST_AUTO_TEST_CASE( test_svg2gerber_spool )
+{
+	// a spooled program written to a device matches the one built in memory
+	const QString svg = "<g transform='translate(825.367,394.456)'> <path stroke='black' stroke-width='11.1082' id='0' fill='black' d='M166.622,5.55409L1277.44,5.55409L1277.44,1394.08Z'/> <circle id='1' fill='black' cx='65.5293' cy='65.5293' r='43.3071' stroke-width='0' stroke='black'/> </g> </svg>";
+	QString header = TextUtils::makeSVGHeader(1000, 1000, 3333.33, 2222.22);
+
+	const QList<SVG2gerber::ForWhy> forWhys = { SVG2gerber::ForCopper, SVG2gerber::ForSilk, SVG2gerber::ForMask, SVG2gerber::ForDrill };
+	Q_FOREACH (SVG2gerber::ForWhy forWhy, forWhys) {
+		SVG2gerber inMemory;
+		int invalidCount = inMemory.convert(header + svg, true, "Copper0", forWhy, QSizeF(3333.33, 2222.22));
+
+		SVG2gerber spooled;
+		BOOST_CHECK_EQUAL(spooled.convert(header + svg, true, "Copper0", forWhy, QSizeF(3333.33, 2222.22), true), invalidCount);
+
+		QBuffer buffer;
+		buffer.open(QIODevice::WriteOnly);
+		BOOST_CHECK(spooled.write(buffer));
+		BOOST_CHECK_EQUAL(QString::fromUtf8(buffer.data()).toStdString(), inMemory.getGerber().toStdString());
+		BOOST_CHECK_EQUAL(spooled.getGerber().toStdString(), inMemory.getGerber().toStdString());
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_svg2gerber_coalesce )
+{
+	// fills that stay apart share a region; near-identical pads share an aperture
+	const QString apart = "<polygon fill='black' points='100,100 200,100 200,200 100,200'/> <polygon fill='black' points='300,100 400,100 400,200 300,200'/> </svg>";
+	const QString overlapping = "<polygon fill='black' points='100,100 200,100 200,200 100,200'/> <polygon fill='black' points='150,150 250,150 250,250 150,250'/> </svg>";
+	const QString pads = "<circle fill='black' cx='100' cy='100' r='30' stroke-width='0'/> <circle fill='black' cx='300' cy='100' r='30.02' stroke-width='0'/> <circle fill='black' cx='500' cy='100' r='40' stroke-width='0'/> </svg>";
+	QString header = TextUtils::makeSVGHeader(1000, 1000, 3333.33, 2222.22);
+
+	SVG2gerber gerber;
+	gerber.convert(header + apart, true, "Copper0", SVG2gerber::ForCopper, QSizeF(3333.33, 2222.22));
+	BOOST_CHECK_EQUAL(gerber.getGerber().count("G36*"), 1);
+	BOOST_CHECK_EQUAL(gerber.getGerber().count("G37*"), 1);
+
+	SVG2gerber gerber2;
+	gerber2.convert(header + overlapping, true, "Copper0", SVG2gerber::ForCopper, QSizeF(3333.33, 2222.22));
+	BOOST_CHECK_EQUAL(gerber2.getGerber().count("G36*"), 2);
+	BOOST_CHECK_EQUAL(gerber2.getGerber().count("G37*"), 2);
+
+	SVG2gerber gerber3;
+	gerber3.convert(header + pads, true, "Copper0", SVG2gerber::ForCopper, QSizeF(3333.33, 2222.22));
+	BOOST_CHECK_EQUAL(gerber3.getGerber().count("%ADD"), 2);
+	BOOST_CHECK_EQUAL(gerber3.getGerber().count("D03*"), 3);
+}
+
+static double drillTravel(const QPoint & start, const QList<QPoint> & hits)
+{
+	double travel = 0;
+	QPoint head = start;
+	Q_FOREACH (QPoint hit, hits) {
+		travel += std::hypot(double(hit.x() - head.x()), double(hit.y() - head.y()));
+		head = hit;
+	}
+	return travel;
+}
+
+BOOST_AUTO_TEST_CASE( test_svg2gerber_drill_order )
+{
+	QList<QPoint> line = { QPoint(100, 0), QPoint(200, 0), QPoint(50, 0) };
+	SVG2gerber::orderDrillHits(line, QPoint(0, 0));
+	BOOST_CHECK(line == QList<QPoint>({ QPoint(50, 0), QPoint(100, 0), QPoint(200, 0) }));
+
+	// a 20 x 20 grid of holes in scrambled order
+	QList<QPoint> grid;
+	for (int x = 0; x < 20; x++) {
+		for (int y = 0; y < 20; y++) {
+			grid << QPoint(x * 1000, y * 1000);
+		}
+	}
+	unsigned int seed = 12345;
+	for (int i = grid.count() - 1; i > 0; i--) {
+		seed = seed * 1103515245 + 12345;
+		grid.swapItemsAt(i, (seed >> 16) % (i + 1));
+	}
+
+	QList<QPoint> ordered = grid;
+	SVG2gerber::orderDrillHits(ordered, QPoint(0, 0));
+	QList<QPoint> sortedGrid = grid;
+	QList<QPoint> sortedOrdered = ordered;
+	auto lessThan = [](const QPoint & a, const QPoint & b) { return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y()); };
+	std::sort(sortedGrid.begin(), sortedGrid.end(), lessThan);
+	std::sort(sortedOrdered.begin(), sortedOrdered.end(), lessThan);
+	BOOST_CHECK(sortedGrid == sortedOrdered);
+
+	// the shortest open tour is 399 steps of 1000; allow a little over it
+	BOOST_CHECK_LT(drillTravel(QPoint(0, 0), ordered), 399 * 1000 * 1.1);
+	BOOST_CHECK_LT(drillTravel(QPoint(0, 0), ordered), drillTravel(QPoint(0, 0), grid));
+}
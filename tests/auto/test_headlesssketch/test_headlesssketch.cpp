@@ -0,0 +1,174 @@
+#define BOOST_TEST_MODULE Headless Sketch Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "model/headlesssketch.h"
+#include "model/binarysketch.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+
+static const char * Part = R"(<?xml version="1.0" encoding="UTF-8"?>
+<module moduleId="TestPart" fritzingVersion="1.0.0">
+    <title>Test Part</title>
+    <connectors>
+        <connector id="connector0" name="pin 1" type="male"/>
+        <connector id="connector1" name="pin 2" type="male"/>
+        <connector id="connector2" name="pin 3" type="male"/>
+    </connectors>
+    <buses>
+        <bus id="internal">
+            <nodeMember connectorId="connector1"/>
+            <nodeMember connectorId="connector2"/>
+        </bus>
+    </buses>
+</module>
+)";
+
+// P1.pin 1 is wired to P2.pin 2, and P1.pin 3 reaches P2.pin 1 through two VCC net labels
+static const char * Sketch = R"(<?xml version="1.0" encoding="UTF-8"?>
+<module fritzingVersion="1.0.0">
+    <instances>
+        <instance moduleIdRef="TestPart" modelIndex="1" path="test.fzp">
+            <title>P1</title>
+            <views>
+                <schematicView layer="schematic">
+                    <connectors>
+                        <connector connectorId="connector0" layer="schematic">
+                            <connects>
+                                <connect connectorId="connector0" modelIndex="3" layer="schematicTrace"/>
+                            </connects>
+                        </connector>
+                        <connector connectorId="connector2" layer="schematic">
+                            <connects>
+                                <connect connectorId="connector0" modelIndex="4" layer="schematic"/>
+                            </connects>
+                        </connector>
+                    </connectors>
+                </schematicView>
+            </views>
+        </instance>
+        <instance moduleIdRef="TestPart" modelIndex="2" path="test.fzp">
+            <title>P2</title>
+            <views>
+                <schematicView layer="schematic">
+                    <connectors>
+                        <connector connectorId="connector0" layer="schematic">
+                            <connects>
+                                <connect connectorId="connector0" modelIndex="5" layer="schematic"/>
+                            </connects>
+                        </connector>
+                        <connector connectorId="connector1" layer="schematic">
+                            <connects>
+                                <connect connectorId="connector1" modelIndex="3" layer="schematicTrace"/>
+                            </connects>
+                        </connector>
+                    </connectors>
+                </schematicView>
+            </views>
+        </instance>
+        <instance moduleIdRef="WireModuleID" modelIndex="3" path=":/resources/parts/core/wire.fzp">
+            <title>Wire3</title>
+            <views>
+                <schematicView layer="schematicTrace"/>
+            </views>
+        </instance>
+        <instance moduleIdRef="NetLabelModuleID" modelIndex="4" path=":/resources/parts/core/netlabel.fzp">
+            <property name="label" value="VCC"/>
+            <title>VCC1</title>
+            <views>
+                <schematicView layer="schematic"/>
+            </views>
+        </instance>
+        <instance moduleIdRef="NetLabelModuleID" modelIndex="5" path=":/resources/parts/core/netlabel.fzp">
+            <property name="label" value="VCC"/>
+            <title>VCC2</title>
+            <views>
+                <schematicView layer="schematic"/>
+            </views>
+        </instance>
+        <instance moduleIdRef="NetLabelModuleID" modelIndex="6" path=":/resources/parts/core/netlabel.fzp">
+            <property name="label" value="GND"/>
+            <title>GND1</title>
+            <views>
+                <schematicView layer="schematic"/>
+            </views>
+        </instance>
+    </instances>
+</module>
+)";
+
+static bool contains(const QList<HeadlessSketch::PartConnector> & net, long modelIndex, const QString & connectorID)
+{
+	Q_FOREACH (const HeadlessSketch::PartConnector & partConnector, net) {
+		if (partConnector.modelIndex == modelIndex && partConnector.connectorID == connectorID) return true;
+	}
+	return false;
+}
+
+BOOST_AUTO_TEST_CASE( headlesssketch_instances )
+{
+	HeadlessSketch sketch;
+	BOOST_REQUIRE(sketch.load(QByteArray(Sketch)));
+	BOOST_REQUIRE_EQUAL(sketch.instances().count(), 6);
+	BOOST_CHECK(sketch.instances().at(0).title == "P1");
+	BOOST_CHECK(sketch.instances().at(3).properties.value("label") == "VCC");
+	BOOST_CHECK(sketch.instances().at(2).views.contains("schematicView"));
+}
+
+BOOST_AUTO_TEST_CASE( headlesssketch_nets )
+{
+	HeadlessSketch sketch;
+	BOOST_REQUIRE(sketch.addPart(QByteArray(Part)));
+	BOOST_REQUIRE(sketch.load(QByteArray(Sketch)));
+
+	QList< QList<HeadlessSketch::PartConnector> > nets = sketch.nets("schematicView");
+	BOOST_REQUIRE_EQUAL(nets.count(), 2);
+
+	// the wire joins P1.pin 1 to P2.pin 2, and the bus brings in P2.pin 3
+	BOOST_CHECK_EQUAL(nets.at(0).count(), 3);
+	BOOST_CHECK(contains(nets.at(0), 1, "connector0"));
+	BOOST_CHECK(contains(nets.at(0), 2, "connector1"));
+	BOOST_CHECK(contains(nets.at(0), 2, "connector2"));
+
+	// the two VCC labels join across the schematic; the wire itself is left out
+	BOOST_CHECK_EQUAL(nets.at(1).count(), 5);
+	BOOST_CHECK(contains(nets.at(1), 1, "connector1"));
+	BOOST_CHECK(contains(nets.at(1), 1, "connector2"));
+	BOOST_CHECK(contains(nets.at(1), 2, "connector0"));
+	BOOST_CHECK(contains(nets.at(1), 4, "connector0"));
+	BOOST_CHECK(contains(nets.at(1), 5, "connector0"));
+
+	BOOST_CHECK(sketch.nets("breadboardView").isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( headlesssketch_unknown_part )
+{
+	// without the fzp only the connected connectors are known, and there is no bus
+	HeadlessSketch sketch;
+	BOOST_REQUIRE(sketch.load(QByteArray(Sketch)));
+
+	QList< QList<HeadlessSketch::PartConnector> > nets = sketch.nets("schematicView");
+	BOOST_REQUIRE_EQUAL(nets.count(), 2);
+	BOOST_CHECK_EQUAL(nets.at(0).count(), 2);
+	BOOST_CHECK_EQUAL(nets.at(1).count(), 4);
+}
+
+BOOST_AUTO_TEST_CASE( headlesssketch_bundle )
+{
+	QList<QPair<QString, QByteArray> > entries;
+	entries.append(qMakePair(QString("part.TestPart.fzp"), QByteArray(Part)));
+	HeadlessSketch sketch;
+	BOOST_CHECK(!sketch.loadBundle(entries));
+
+	entries.append(qMakePair(QString("test.fz"), BinarySketch::encode(QByteArray(Sketch))));
+	BOOST_REQUIRE(sketch.loadBundle(entries));
+	BOOST_CHECK_EQUAL(sketch.nets("schematicView").count(), 2);
+
+	QString netlist = sketch.netlist("test.fzz", "schematicView");
+	BOOST_CHECK(netlist.contains("<netlist sketch=\"test.fzz\""));
+	BOOST_CHECK(netlist.contains("<connector id=\"connector0\" name=\"pin 1\">"));
+	BOOST_CHECK(netlist.contains("<part id=\"10\" label=\"P1\" title=\"Test Part\"/>"));
+	BOOST_CHECK(!netlist.contains("Wire3"));
+	BOOST_CHECK_EQUAL(netlist.count("<net>"), 2);
+}
@@ -0,0 +1,140 @@
+#define BOOST_TEST_MODULE Orthogonal Router Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "autoroute/schematicrouter/orthogonalrouter.h"
+
+#include <QtGlobal>
+
+static bool orthogonal(const QList<QPointF> & path)
+{
+	for (int i = 1; i < path.count(); i++) {
+		if (path.at(i - 1).x() != path.at(i).x() && path.at(i - 1).y() != path.at(i).y()) return false;
+	}
+	return true;
+}
+
+static bool crossesInterior(const QList<QPointF> & path, const QRectF & rect)
+{
+	// samples each segment, since the paths only ever touch an obstacle along its edges
+	for (int i = 1; i < path.count(); i++) {
+		for (int step = 0; step <= 100; step++) {
+			double t = step / 100.0;
+			QPointF p(path.at(i - 1).x() + ((path.at(i).x() - path.at(i - 1).x()) * t),
+			          path.at(i - 1).y() + ((path.at(i).y() - path.at(i - 1).y()) * t));
+			if (p.x() > rect.left() && p.x() < rect.right() && p.y() > rect.top() && p.y() < rect.bottom()) return true;
+		}
+	}
+	return false;
+}
+
+static double pathLength(const QList<QPointF> & path)
+{
+	double length = 0;
+	for (int i = 1; i < path.count(); i++) {
+		length += qAbs(path.at(i).x() - path.at(i - 1).x()) + qAbs(path.at(i).y() - path.at(i - 1).y());
+	}
+	return length;
+}
+
+BOOST_AUTO_TEST_CASE( straight_and_one_bend )
+{
+	OrthogonalRouter router(QRectF(0, 0, 1000, 1000), 10, 50);
+
+	QList<QPointF> path = router.route(QPointF(100, 100), QPointF(800, 100), 0);
+	BOOST_REQUIRE_EQUAL(path.count(), 2);
+	BOOST_CHECK(path.first() == QPointF(100, 100));
+	BOOST_CHECK(path.last() == QPointF(800, 100));
+
+	// with nothing in the way a diagonal takes a single bend, not a staircase
+	path = router.route(QPointF(100, 100), QPointF(800, 600), 0);
+	BOOST_REQUIRE_EQUAL(path.count(), 3);
+	BOOST_CHECK(orthogonal(path));
+	BOOST_CHECK_CLOSE(pathLength(path), 1200.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE( around_a_part )
+{
+	OrthogonalRouter router(QRectF(0, 0, 1000, 1000), 10, 50);
+	QRectF part(300, 200, 200, 300);
+	router.addBlock(part, -1);
+
+	QList<QPointF> path = router.route(QPointF(100, 300), QPointF(800, 300), 0);
+	BOOST_REQUIRE(path.count() >= 2);
+	BOOST_CHECK(orthogonal(path));
+	BOOST_CHECK(!crossesInterior(path, part.adjusted(-10, -10, 10, 10)));
+	// over the top, at the keepout from the part
+	BOOST_CHECK_CLOSE(pathLength(path), 700.0 + 2 * 110.0, 1e-9);
+	BOOST_CHECK_EQUAL(path.count(), 4);                // up at the start, down at the end
+}
+
+BOOST_AUTO_TEST_CASE( own_net_is_ignored )
+{
+	OrthogonalRouter router(QRectF(0, 0, 1000, 1000), 10, 50);
+	router.addBlock(QRectF(300, 200, 200, 300), 4);
+
+	QList<QPointF> path = router.route(QPointF(100, 300), QPointF(800, 300), 4);
+	BOOST_CHECK_EQUAL(path.count(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( enclosed )
+{
+	OrthogonalRouter router(QRectF(0, 0, 1000, 1000), 10, 50);
+	router.addBlock(QRectF(200, 200, 600, 20), -1);
+	router.addBlock(QRectF(200, 780, 600, 20), -1);
+	router.addBlock(QRectF(200, 200, 20, 600), -1);
+	router.addBlock(QRectF(780, 200, 20, 600), -1);
+
+	BOOST_CHECK(router.route(QPointF(500, 500), QPointF(900, 900), 0).isEmpty());
+	BOOST_CHECK(!router.route(QPointF(400, 400), QPointF(600, 600), 0).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE( wires_are_crossed_not_followed )
+{
+	OrthogonalRouter router(QRectF(0, 0, 1000, 1000), 10, 50);
+	QList<QPointF> wire;
+	wire << QPointF(100, 500) << QPointF(900, 500);
+	router.addPath(wire, 1);
+
+	// straight across at a right angle
+	QList<QPointF> path = router.route(QPointF(500, 100), QPointF(500, 900), 2);
+	BOOST_CHECK_EQUAL(path.count(), 2);
+
+	// but not through the ends, where wires join
+	path = router.route(QPointF(100, 100), QPointF(100, 900), 2);
+	BOOST_REQUIRE(path.count() > 2);
+	BOOST_CHECK(!crossesInterior(path, QRectF(90, 490, 20, 20)));
+
+	// and never along it, or with a bend on it
+	path = router.route(QPointF(300, 500), QPointF(700, 500), 2);
+	BOOST_REQUIRE(path.count() > 2);
+	BOOST_CHECK(path.at(1).x() == 300);
+	path = router.route(QPointF(300, 300), QPointF(700, 700), 2);
+	BOOST_REQUIRE(path.count() >= 2);
+	BOOST_CHECK(orthogonal(path));
+	for (int i = 1; i < path.count() - 1; i++) {
+		BOOST_CHECK(qAbs(path.at(i).y() - 500) >= 10);
+	}
+
+	// the wire's own net goes where it likes
+	path = router.route(QPointF(300, 500), QPointF(700, 500), 1);
+	BOOST_CHECK_EQUAL(path.count(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( bus_of_parallel_wires )
+{
+	// each net in turn between two rows of pins; later nets keep the keepout from earlier ones
+	OrthogonalRouter router(QRectF(0, 0, 1000, 1000), 9, 20);
+	router.addBlock(QRectF(100, 100, 100, 400), -1);
+	router.addBlock(QRectF(700, 300, 100, 400), -1);
+
+	for (int net = 0; net < 8; net++) {
+		QPointF from(219, 150 + (net * 36));
+		QPointF to(681, 350 + (net * 36));
+		QList<QPointF> path = router.route(from, to, net);
+		BOOST_REQUIRE(path.count() >= 2);
+		BOOST_CHECK(orthogonal(path));
+		BOOST_CHECK(path.first() == from);
+		BOOST_CHECK(path.last() == to);
+		router.addPath(path, net);
+	}
+}
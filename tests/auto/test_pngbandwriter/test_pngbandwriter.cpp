@@ -0,0 +1,68 @@
+#define BOOST_TEST_MODULE PNG Band Writer Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "utils/pngbandwriter.h"
+
+#include <QTemporaryDir>
+
+static QImage pattern(int width, int height)
+{
+	QImage image(width, height, QImage::Format_ARGB32);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			image.setPixel(x, y, qRgba((x * 7) & 255, (y * 13) & 255, (x ^ y) & 255, (x + y) & 255));
+		}
+	}
+	return image;
+}
+
+static bool writeInBands(const QString & fileName, const QImage & image, bool alpha, int bandHeight)
+{
+	PngBandWriter writer;
+	if (!writer.open(fileName, image.size(), alpha, 3937, "test")) return false;
+	for (int y = 0; y < image.height(); y += bandHeight) {
+		if (!writer.writeBand(image.copy(0, y, image.width(), qMin(bandHeight, image.height() - y)))) return false;
+	}
+	return writer.close();
+}
+
+BOOST_AUTO_TEST_CASE( bands_make_the_whole_image )
+{
+	QTemporaryDir dir;
+	QString fileName = dir.filePath("bands.png");
+	QImage image = pattern(301, 97);
+	BOOST_REQUIRE(writeInBands(fileName, image, true, 10));
+
+	QImage read(fileName);
+	BOOST_REQUIRE(!read.isNull());
+	BOOST_CHECK(read.convertToFormat(QImage::Format_ARGB32) == image);
+	BOOST_CHECK_EQUAL(read.dotsPerMeterX(), 3937);
+}
+
+BOOST_AUTO_TEST_CASE( opaque_image )
+{
+	QTemporaryDir dir;
+	QString fileName = dir.filePath("opaque.png");
+	QImage image = pattern(64, 1000).convertToFormat(QImage::Format_RGB32);
+	BOOST_REQUIRE(writeInBands(fileName, image, false, 333));
+
+	QImage read(fileName);
+	BOOST_REQUIRE(!read.isNull());
+	BOOST_CHECK(!read.hasAlphaChannel());
+	BOOST_CHECK(read.convertToFormat(QImage::Format_RGB32) == image);
+}
+
+BOOST_AUTO_TEST_CASE( missing_rows_fail )
+{
+	QTemporaryDir dir;
+	QString fileName = dir.filePath("short.png");
+	QImage image = pattern(20, 20);
+
+	PngBandWriter writer;
+	BOOST_REQUIRE(writer.open(fileName, image.size(), true, 0, QString()));
+	BOOST_CHECK(writer.writeBand(image.copy(0, 0, 20, 10)));
+	BOOST_CHECK(!writer.writeBand(image.copy(0, 0, 19, 5)));		// wrong width
+	BOOST_CHECK_EQUAL(writer.rowsWritten(), 10);
+	BOOST_CHECK(!writer.close());
+	BOOST_CHECK(!QFile::exists(fileName));
+}
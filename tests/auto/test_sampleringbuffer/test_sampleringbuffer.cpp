@@ -0,0 +1,67 @@
+#define BOOST_TEST_MODULE Sample Ring Buffer Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "simulation/sampleringbuffer.h"
+
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( capacity_rounds_up )
+{
+	SampleRingBuffer ring(100);
+	BOOST_CHECK_EQUAL(ring.capacity(), 128);
+	BOOST_CHECK_EQUAL(ring.available(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( full_ring_drops )
+{
+	SampleRingBuffer ring(4);
+	for (int i = 0; i < 4; i++) BOOST_CHECK(ring.push(i));
+	BOOST_CHECK(!ring.push(4));
+	BOOST_CHECK_EQUAL(ring.dropped(), 1);
+
+	std::vector<double> samples;
+	BOOST_CHECK_EQUAL(ring.read(samples), 4);
+	BOOST_CHECK(samples == std::vector<double>({ 0, 1, 2, 3 }));
+
+	// the space is free again, and wraps around
+	BOOST_CHECK(ring.push(5));
+	samples.clear();
+	ring.read(samples);
+	BOOST_CHECK(samples == std::vector<double>({ 5 }));
+}
+
+BOOST_AUTO_TEST_CASE( decimation_carries_over )
+{
+	SampleRingBuffer ring(16);
+	std::vector<double> samples;
+	for (int i = 0; i < 5; i++) ring.push(i);
+	BOOST_CHECK_EQUAL(ring.read(samples, 3), 5);
+	for (int i = 5; i < 10; i++) ring.push(i);
+	BOOST_CHECK_EQUAL(ring.read(samples, 3, 2), 2);
+	BOOST_CHECK_EQUAL(ring.available(), 3);
+	ring.read(samples, 3);
+	BOOST_CHECK(samples == std::vector<double>({ 0, 3, 6, 9 }));
+}
+
+BOOST_AUTO_TEST_CASE( producer_and_consumer_threads )
+{
+	const int count = 200000;
+	SampleRingBuffer ring(256);
+	std::thread producer([&ring]() {
+		for (int i = 0; i < count; i++) {
+			while (!ring.push(i)) std::this_thread::yield();
+		}
+	});
+
+	std::vector<double> samples;
+	while (samples.size() < count) {
+		if (ring.read(samples) == 0) std::this_thread::yield();
+	}
+	producer.join();
+
+	bool inOrder = true;
+	for (int i = 0; i < count; i++) {
+		if (samples[i] != i) inOrder = false;
+	}
+	BOOST_CHECK(inOrder);
+}
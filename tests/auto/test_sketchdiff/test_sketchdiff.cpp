@@ -0,0 +1,122 @@
+#define BOOST_TEST_MODULE Sketch Diff Tests
+#include <boost/test/included/unit_test.hpp>
+
+#include "model/headlesssketch.h"
+#include "model/sketchdiff.h"
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QString>
+
+static const char * Part = R"(<?xml version="1.0" encoding="UTF-8"?>
+<module moduleId="TestPart" fritzingVersion="1.0.0">
+    <title>Test Part</title>
+    <connectors>
+        <connector id="connector0" name="pin 1" type="male"/>
+        <connector id="connector1" name="pin 2" type="male"/>
+    </connectors>
+</module>
+)";
+
+static QString instance(long modelIndex, const QString & moduleID, const QString & title, double x, const QString & connectors)
+{
+	return QString(R"(
+        <instance moduleIdRef="%1" modelIndex="%2">
+            <title>%3</title>
+            <views>
+                <schematicView layer="schematic">
+                    <geometry z="2.5" x="%4" y="0"/>
+                    <connectors>%5</connectors>
+                </schematicView>
+            </views>
+        </instance>)").arg(moduleID).arg(modelIndex).arg(title).arg(x).arg(connectors);
+}
+
+static QString connector(const QString & connectorID, long toIndex, const QString & toConnectorID)
+{
+	return QString(R"(<connector connectorId="%1" layer="schematic"><connects><connect connectorId="%3" modelIndex="%2" layer="schematicTrace"/></connects></connector>)")
+		.arg(connectorID).arg(toIndex).arg(toConnectorID);
+}
+
+static QByteArray sketch(const QString & instances)
+{
+	return QString(R"(<?xml version="1.0" encoding="UTF-8"?><module fritzingVersion="1.0.0"><instances>%1</instances></module>)").arg(instances).toUtf8();
+}
+
+// P1.pin 1 is wired to P2.pin 1, and P4 is on its own
+static QByteArray before()
+{
+	return sketch(instance(1, "TestPart", "P1", 0, connector("connector0", 3, "connector0")) +
+	              instance(2, "TestPart", "P2", 100, connector("connector0", 3, "connector1")) +
+	              instance(3, "WireModuleID", "Wire3", 10, "") +
+	              instance(4, "TestPart", "P4", 200, ""));
+}
+
+// P1 has moved, the wire now ends on P2.pin 2, P4 is gone and P5 is new
+static QByteArray after(const QString & p2ModuleID)
+{
+	return sketch(instance(1, "TestPart", "P1", 20, connector("connector0", 3, "connector0")) +
+	              instance(2, p2ModuleID, "P2", 100, connector("connector1", 3, "connector1")) +
+	              instance(3, "WireModuleID", "Wire3", 30, "") +
+	              instance(5, "TestPart", "P5", 300, ""));
+}
+
+BOOST_AUTO_TEST_CASE( sketchdiff_identical )
+{
+	HeadlessSketch a;
+	HeadlessSketch b;
+	BOOST_REQUIRE(a.load(before()));
+	BOOST_REQUIRE(b.load(before()));
+
+	SketchDiff diff;
+	diff.compare(a, b);
+	BOOST_CHECK(diff.isEmpty());
+	BOOST_CHECK(diff.toJson().value("identical").toBool());
+}
+
+BOOST_AUTO_TEST_CASE( sketchdiff_changes )
+{
+	HeadlessSketch a;
+	HeadlessSketch b;
+	BOOST_REQUIRE(a.addPart(QByteArray(Part)));
+	BOOST_REQUIRE(b.addPart(QByteArray(Part)));
+	BOOST_REQUIRE(a.load(before()));
+	BOOST_REQUIRE(b.load(after("TestPart")));
+
+	SketchDiff diff;
+	diff.compare(a, b);
+	BOOST_CHECK(!diff.isEmpty());
+
+	BOOST_REQUIRE_EQUAL(diff.added().count(), 1);
+	BOOST_CHECK_EQUAL(diff.added().first().modelIndex, 5);
+	BOOST_REQUIRE_EQUAL(diff.removed().count(), 1);
+	BOOST_CHECK_EQUAL(diff.removed().first().modelIndex, 4);
+	BOOST_CHECK(diff.swapped().isEmpty());
+
+	// the wire moved too, but wires are only seen through the nets
+	BOOST_REQUIRE_EQUAL(diff.moved().count(), 1);
+	BOOST_CHECK(diff.moved().first().part.title == "P1");
+	BOOST_CHECK(diff.moved().first().viewName == "schematicView");
+	BOOST_CHECK_EQUAL(diff.moved().first().to.x(), 20);
+
+	BOOST_REQUIRE_EQUAL(diff.removedNets().count(), 1);
+	BOOST_CHECK(diff.removedNets().first().labels.contains("P2.pin 1"));
+	BOOST_REQUIRE_EQUAL(diff.addedNets().count(), 1);
+	BOOST_CHECK(diff.addedNets().first().labels.contains("P1.pin 1"));
+	BOOST_CHECK(diff.addedNets().first().labels.contains("P2.pin 2"));
+}
+
+BOOST_AUTO_TEST_CASE( sketchdiff_swapped )
+{
+	HeadlessSketch a;
+	HeadlessSketch b;
+	BOOST_REQUIRE(a.load(before()));
+	BOOST_REQUIRE(b.load(after("OtherPart")));
+
+	SketchDiff diff;
+	diff.compare(a, b);
+	BOOST_REQUIRE_EQUAL(diff.swapped().count(), 1);
+	BOOST_CHECK(diff.swapped().first().moduleIdRef == "OtherPart");
+	BOOST_CHECK(diff.swapped().first().previousModuleIdRef == "TestPart");
+	BOOST_CHECK(diff.toJson().value("swapped").toArray().count() == 1);
+}
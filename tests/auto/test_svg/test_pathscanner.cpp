@@ -0,0 +1,101 @@
+#include "svg/svgpathscanner.h"
+#include "svg/svgpathparser.h"
+#include "svg/svgpathlexer.h"
+
+/*
+Testing that SVGPathScanner::scan hands on the same commands and numbers as
+the generated SVGPathParser, and what else it accepts and rejects
+*/
+
+#include <boost/test/unit_test.hpp>
+
+static QList<QVariant> scanned(const QString & data, bool & ok)
+{
+	QList<QVariant> result;
+	ok = SVGPathScanner::scan(QStringView(data), [&result](QChar command, bool relative, QList<double> & args) {
+		BOOST_CHECK_EQUAL(relative, command.isLower());
+		result.append(command);
+		Q_FOREACH (double arg, args) result.append(arg);
+	});
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE( pathscanner_matches_parser )
+{
+	const QStringList inputs = {
+		"m0,0x",
+		"m5,9.9x",
+		"m-5,-9.9x",
+		"m-4 -9.8x",
+		"m-3-9.7x",
+		"m0,0z",
+		"m1,-2a2.6,3.5,0,0,1,-5.2,0x",
+		"m2 -2a2.6 3.5 0 0 1 -5.2 0x",
+		"m3-2a2.6 3.5 0 0 1-5.2 0x",
+		"m4-2a2.6-3.5 0 0 1-5.2 0x",
+		"m-2+9.7x",
+		"M10 10 L20 20 30 10 H5 V0 Zx",
+		"M0,0 C1,2 3,4 5,6 S7,8 9,10 Q1,1 2,2 T3,3 4,4 zm1 1 l2 2x",
+		"M1.5.5 .25-1e2 l3e2,2x",
+	};
+
+	Q_FOREACH (QString input, inputs) {
+		SVGPathLexer lexer(input);
+		SVGPathParser parser;
+		BOOST_REQUIRE_MESSAGE(parser.parse(lexer), "parser rejects " << input.toStdString());
+		QVector<QVariant> expected = parser.symStack();
+
+		bool ok;
+		QList<QVariant> result = scanned(input, ok);
+		BOOST_CHECK_MESSAGE(ok, "scanner rejects " << input.toStdString());
+		BOOST_REQUIRE_EQUAL(result.count(), expected.count());
+		for (int i = 0; i < result.count(); i++) {
+			BOOST_CHECK_EQUAL(result.at(i).type(), expected.at(i).type());
+			if (result.at(i).type() == QVariant::Char) {
+				BOOST_CHECK(result.at(i).toChar() == expected.at(i).toChar());
+			}
+			else {
+				BOOST_CHECK_CLOSE(result.at(i).toDouble(), expected.at(i).toDouble(), 1e-9);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( pathscanner_extras )
+{
+	bool ok;
+
+	// polygon points get a moveto in front, which takes all the pairs
+	QList<QVariant> points = scanned("1,2 3,4 5,6", ok);
+	BOOST_CHECK(ok);
+	BOOST_REQUIRE_EQUAL(points.count(), 7);
+	BOOST_CHECK(points.at(0).toChar() == QChar('M'));
+	BOOST_CHECK_EQUAL(points.at(6).toDouble(), 6);
+
+	// compact arc flags
+	QList<QVariant> arc = scanned("M0 0a1 1 0 115 5", ok);
+	BOOST_CHECK(ok);
+	BOOST_REQUIRE_EQUAL(arc.count(), 11);
+	BOOST_CHECK_EQUAL(arc.at(7).toDouble(), 1);
+	BOOST_CHECK_EQUAL(arc.at(8).toDouble(), 1);
+	BOOST_CHECK_EQUAL(arc.at(9).toDouble(), 5);
+
+	// a path handed on only in full
+	const QStringList badInputs = {
+		"",
+		"L1 2",
+		"M1",
+		"M1 2 L3",
+		"M1 2 L",
+		"M1 2 Y3 4",
+		"M1 2 z 3 4",
+		"M1 2 a1 1 0 2 1 5 5",
+		"M1,,2",
+	};
+	Q_FOREACH (QString input, badInputs) {
+		int calls = 0;
+		bool result = SVGPathScanner::scan(QStringView(input), [&calls](QChar, bool, QList<double> &) { calls++; });
+		BOOST_CHECK_MESSAGE(!result, "scanner accepts " << input.toStdString());
+		BOOST_CHECK_EQUAL(calls, 0);
+	}
+}
@@ -50,3 +50,26 @@ BOOST_AUTO_TEST_CASE( svg2gerber_parse )
 	}
 	BOOST_CHECK_EQUAL(pathUserData1.string.toStdString(), pathUserData2.string.toStdString());
 }
+
+BOOST_AUTO_TEST_CASE( flatten_concurrently )
+{
+	// flattening part fragments on their own threads gives the same document as flattening serially
+	QString svg = "<svg width='1in' height='1in' viewBox='0 0 1000 1000' stroke-width='3'>"
+	              "<g partID='1' transform='translate(100,50)'><rect x='0' y='0' width='10' height='20'/><circle cx='5' cy='5' r='2' stroke-width='1'/></g>"
+	              "<g partID='2' transform='rotate(90)'><path d='M0,0L10,0L10,10z'/><line x1='0' y1='0' x2='5' y2='5'/></g>"
+	              "<g partID='3'><g transform='matrix(1,0,0,1,7,8)'><polygon points='0,0 10,0 10,10'/></g></g>"
+	              "</svg>";
+
+	QDomDocument serial;
+	BOOST_REQUIRE(serial.setContent(svg));
+	QDomElement serialRoot = serial.documentElement();
+	SvgFlattener flattener;
+	flattener.flattenChildren(serialRoot, SvgAttributesMap());
+
+	QDomDocument concurrent;
+	BOOST_REQUIRE(concurrent.setContent(svg));
+	QDomElement concurrentRoot = concurrent.documentElement();
+	flattener.flattenChildrenConcurrently(concurrentRoot, SvgAttributesMap());
+
+	BOOST_CHECK_EQUAL(concurrent.toString().toStdString(), serial.toString().toStdString());
+}
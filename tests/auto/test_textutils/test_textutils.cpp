@@ -2,6 +2,7 @@
 #include <boost/test/included/unit_test.hpp>
 
 //#include <QStringList>
+#include <cmath>
 
 #define private public
 #include "textutils.h"
@@ -94,4 +95,101 @@ BOOST_AUTO_TEST_CASE( test_convertToInches )
 	BOOST_REQUIRE(epsilonCheck(*fromCm, 10.0/2.54));
 
 	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("90.0", false), 1.0));
+
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("25.4mm", false), 1.0));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("25.4MM", false), 1.0));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("2in", false), 2.0));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("90px", false), 1.0));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("72px", true), 1.0));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("500mil", false), 0.5));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("36pt", false), 0.5));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("3pc", false), 0.5));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches(" 1e1cm", false), 10.0/2.54));
+
+	// no known unit: trailing non-digits are dropped and the number is in 90 dpi units
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("45%", false), 0.5));
+	BOOST_REQUIRE(epsilonCheck(*TextUtils::convertToInches("45.", false), 0.5));
+	BOOST_REQUIRE(!TextUtils::convertToInches("1,000mm", false));
+	BOOST_REQUIRE(!TextUtils::convertToInches("mm", false));
+
+	bool ok = true;
+	BOOST_CHECK_EQUAL(TextUtils::convertToInches(QString("cm"), &ok, false), 0.0);
+	BOOST_REQUIRE(!ok);
+}
+
+BOOST_AUTO_TEST_CASE( test_convertFromPowerPrefix )
+{
+	constexpr double epsilon = 0.000000001;
+	auto relativeCheck {
+		[epsilon](double value, double expected) {
+			return std::abs(value - expected) <= epsilon * std::abs(expected);
+		}
+	};
+
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("4.7k", "\u03a9"), 4700));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("4.7k\u03a9", "\u03a9"), 4700));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix(" 220 ", "\u03a9"), 220));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("100nF", "F"), 0.0000001));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("10pF", "F"), 0.00000000001));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("3.3mA", "A"), 0.0033));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("2M", ""), 2000000));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("1.5G", ""), 1500000000.));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("2T", ""), 2000000000000.));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("10u", "F"), 0.00001));
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefix("10" + TextUtils::MicroSymbol + "F", "F"), 0.00001));
+	BOOST_CHECK_EQUAL(TextUtils::convertFromPowerPrefix("abc", "F"), 0.0);
+	BOOST_CHECK_EQUAL(TextUtils::convertFromPowerPrefix("", "F"), 0.0);
+
+	QString value("47uF");
+	BOOST_REQUIRE(relativeCheck(TextUtils::convertFromPowerPrefixU(value, "F"), 0.000047));
+	BOOST_CHECK(value == "47" + TextUtils::MicroSymbol + "F");
+}
+
+BOOST_AUTO_TEST_CASE( test_convertToPowerPrefix )
+{
+	BOOST_CHECK_EQUAL(TextUtils::convertToPowerPrefix(0).toStdString(), "0");
+	BOOST_CHECK_EQUAL(TextUtils::convertToPowerPrefix(4700).toStdString(), "4.7k");
+	BOOST_CHECK_EQUAL(TextUtils::convertToPowerPrefix(47).toStdString(), "47");
+	BOOST_CHECK_EQUAL(TextUtils::convertToPowerPrefix(0.0033).toStdString(), "3.3m");
+	BOOST_CHECK(TextUtils::convertToPowerPrefix(0.000047) == "47" + TextUtils::MicroSymbol);
+	BOOST_CHECK_EQUAL(TextUtils::convertToPowerPrefix(-2000000).toStdString(), "-2M");
+}
+
+BOOST_AUTO_TEST_CASE( test_fixSvg )
+{
+	QString clean = R"(<?xml version='1.0' encoding='UTF-8'?>
+<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='1in' viewBox='0 0 100 100'><rect x='10' y='10' width='80' height='80' fill='red' stroke='black' stroke-width='2'/></svg>)";
+	QString svg = clean;
+	BOOST_CHECK_EQUAL(TextUtils::fixSvg(svg, TextUtils::FixMuch | TextUtils::FixStrokeWidth | TextUtils::FixPixelDimensions | TextUtils::FixFontQuotes), (int) TextUtils::NoSvgFix);
+	BOOST_CHECK(svg == clean);
+
+	svg = R"(<svg xmlns='http://www.w3.org/2000/svg' xmlns:sodipodi='http://sodipodi.sourceforge.net/DTD/sodipodi-0.dtd' width='1in' height='1in' viewBox='0 0 100 100'><sodipodi:namedview id='base'/><rect sodipodi:nodetypes="cccc" width='10' height='10'/></svg>)";
+	int result = TextUtils::fixSvg(svg, TextUtils::FixMuch);
+	BOOST_CHECK(result & TextUtils::FixSodipodi);
+	BOOST_CHECK(!svg.contains("sodipodi:"));
+
+	svg = R"(<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='1in' viewBox='0 0 100 100'><rect transform='rotate(45)' width='10' height='10'/></svg>)";
+	result = TextUtils::fixSvg(svg, TextUtils::FixMuch);
+	BOOST_CHECK_EQUAL(result, (int) TextUtils::FixStructure);
+	BOOST_CHECK(svg.contains("<g transform=\"rotate(45)\""));
+
+	svg = R"(<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='1in' viewBox='0 0 100 100'><rect stroke='black' width='10' height='10'/></svg>)";
+	QString copy = svg;
+	BOOST_CHECK_EQUAL(TextUtils::fixSvg(copy, TextUtils::FixMuch), (int) TextUtils::NoSvgFix);
+	result = TextUtils::fixSvg(svg, TextUtils::FixMuch | TextUtils::FixStrokeWidth);
+	BOOST_CHECK_EQUAL(result, (int) TextUtils::FixStrokeWidth);
+	BOOST_CHECK(svg.contains("stroke-width=\"1\""));
+
+	svg = R"(<?xml version='1.0' encoding='UTF-8'?>
+<!-- Generator: Adobe Illustrator 16.0.0, SVG Export Plug-In -->
+<svg xmlns='http://www.w3.org/2000/svg' width='72px' height='144px' viewBox='0 0 72 144'><rect width='10' height='10'/></svg>)";
+	result = TextUtils::fixSvg(svg, TextUtils::FixMuch | TextUtils::FixPixelDimensions);
+	BOOST_CHECK_EQUAL(result, (int) TextUtils::FixPixelDimensions);
+	BOOST_CHECK(svg.contains("width=\"1in\""));
+	BOOST_CHECK(svg.contains("height=\"2in\""));
+
+	svg = R"x(<svg xmlns='http://www.w3.org/2000/svg' width='1in' height='1in' viewBox='0 0 100 100'><text font-family="'DroidSans'" font-size="3.5">echo</text></svg>)x";
+	result = TextUtils::fixSvg(svg, TextUtils::FixMuch | TextUtils::FixFontQuotes);
+	BOOST_CHECK_EQUAL(result, (int) TextUtils::FixFontQuotes);
+	BOOST_CHECK(svg.contains("font-family=\"DroidSans\""));
 }
@@ -0,0 +1,203 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+/*
+Autorouter benchmark: runs "Fritzing -autoroute" once per sketch of a fixed corpus, each in its own
+process so peak memory is per sketch, and prints wall time, peak memory, routed/unrouted and via counts and expansion throughput.
+
+	bench_autorouter FRITZING [-cycles N] [-runs N] [-corpus FOLDER] [-set NAME=VALUE]... [-o REPORT.json]
+
+The maze router has no random component, so a fixed corpus and a fixed number of cycles give
+repeatable routes; only the timings vary from run to run.
+*/
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+
+// PCB sketches from sketches/core with exactly one board
+static const char * DefaultCorpus[] = {
+	"Arduino-no-FTDI.fzz",
+	"Shift_Register_2x.fzz",
+	"VoltageRegulator_7800series.fzz",
+	"VoltageRegulator_with_switch.fzz",
+};
+
+static const int DefaultCycles = 10;
+
+static QJsonObject routeOne(const QString & fritzing, const QString & sketchPath, const QStringList & settings, QTextStream & err)
+{
+	QJsonObject result;
+	QTemporaryDir dir;
+	if (!dir.isValid()) {
+		result.insert("error", QString("no temporary folder"));
+		return result;
+	}
+
+	QString copy = QDir(dir.path()).absoluteFilePath(QFileInfo(sketchPath).fileName());
+	if (!QFile::copy(sketchPath, copy)) {
+		result.insert("error", QString("unable to copy %1").arg(sketchPath));
+		return result;
+	}
+
+	QStringList args;
+	args << "-autoroute" << dir.path();
+	Q_FOREACH (QString setting, settings) {
+		args << "-autorouteset" << setting;
+	}
+
+	QProcess process;
+	process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+	QElapsedTimer timer;
+	timer.start();
+	process.start(fritzing, args);
+	if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit) {
+		result.insert("error", QString("fritzing did not finish: %1").arg(process.errorString()));
+		return result;
+	}
+	qint64 processMs = timer.elapsed();
+
+	QFile reportFile(QDir(dir.path()).absoluteFilePath("autoroute.json"));
+	if (!reportFile.open(QIODevice::ReadOnly)) {
+		result.insert("error", QString("no report"));
+		return result;
+	}
+
+	QJsonArray sketches = QJsonDocument::fromJson(reportFile.readAll()).object().value("sketches").toArray();
+	if (sketches.count() != 1) {
+		result.insert("error", QString("unexpected report"));
+		return result;
+	}
+
+	result = sketches.at(0).toObject();
+	result.insert("processMs", processMs);
+	if (result.contains("error")) {
+		err << QFileInfo(sketchPath).fileName() << ": " << result.value("error").toString() << Qt::endl;
+	}
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	QStringList arguments = app.arguments();
+	if (arguments.count() < 2) {
+		err << "usage: bench_autorouter FRITZING [-cycles N] [-runs N] [-corpus FOLDER] [-set NAME=VALUE]... [-o REPORT.json]" << Qt::endl;
+		return 2;
+	}
+
+	QString fritzing = arguments.at(1);
+	int cycles = DefaultCycles;
+	int runs = 1;
+	QString corpusFolder = BENCH_SKETCH_FOLDER;
+	bool defaultCorpus = true;
+	QStringList settings;
+	QString reportPath;
+	for (int i = 2; i + 1 < arguments.count(); i += 2) {
+		if (arguments.at(i) == "-cycles") cycles = qMax(1, arguments.at(i + 1).toInt());
+		else if (arguments.at(i) == "-runs") runs = qMax(1, arguments.at(i + 1).toInt());
+		else if (arguments.at(i) == "-corpus") {
+			corpusFolder = arguments.at(i + 1);
+			defaultCorpus = false;
+		}
+		else if (arguments.at(i) == "-set") settings << arguments.at(i + 1);
+		else if (arguments.at(i) == "-o") reportPath = arguments.at(i + 1);
+		else {
+			err << "unknown option " << arguments.at(i) << Qt::endl;
+			return 2;
+		}
+	}
+	settings.prepend(QString("maxcycles=%1").arg(cycles));
+
+	QDir corpus(corpusFolder);
+	QStringList sketches;
+	if (defaultCorpus) {
+		for (const char * name : DefaultCorpus) sketches << corpus.absoluteFilePath(name);
+	}
+	else {
+		Q_FOREACH (QString name, corpus.entryList(QStringList("*.fzz"), QDir::Files, QDir::Name)) {
+			sketches << corpus.absoluteFilePath(name);
+		}
+	}
+
+	out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+		.arg("sketch", -36).arg("wall ms", 10).arg("route ms", 10).arg("peak MB", 9)
+		.arg("routed", 8).arg("unrouted", 9).arg("vias", 6).arg("kcells/s", 9) << Qt::endl;
+
+	QJsonArray results;
+	bool failed = false;
+	Q_FOREACH (QString sketch, sketches) {
+		// keep the fastest run's timings; the routes themselves are identical
+		QJsonObject best;
+		for (int run = 0; run < runs; run++) {
+			QJsonObject result = routeOne(fritzing, sketch, settings, err);
+			if (result.contains("error")) {
+				best = result;
+				break;
+			}
+			if (best.isEmpty() || result.value("totalMs").toDouble() < best.value("totalMs").toDouble()) {
+				best = result;
+			}
+		}
+		best.insert("sketch", QFileInfo(sketch).fileName());
+		results.append(best);
+		if (best.contains("error")) {
+			failed = true;
+			continue;
+		}
+
+		out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+			.arg(QFileInfo(sketch).fileName(), -36)
+			.arg(best.value("totalMs").toDouble(), 10, 'f', 0)
+			.arg(best.value("phasesMs").toObject().value("route").toDouble(), 10, 'f', 0)
+			.arg(best.value("peakResidentBytes").toDouble() / (1024 * 1024), 9, 'f', 1)
+			.arg(best.value("routed").toInt(), 8)
+			.arg(best.value("unrouted").toInt(), 9)
+			.arg(best.value("vias").toInt(), 6)
+			.arg(best.value("cellsPerSecond").toDouble() / 1000, 9, 'f', 0) << Qt::endl;
+	}
+
+	if (!reportPath.isEmpty()) {
+		QJsonObject report;
+		report.insert("cycles", cycles);
+		report.insert("runs", runs);
+		report.insert("settings", QJsonArray::fromStringList(settings));
+		report.insert("sketches", results);
+		QFile file(reportPath);
+		if (file.open(QIODevice::WriteOnly)) {
+			file.write(QJsonDocument(report).toJson());
+		}
+	}
+
+	return failed ? 1 : 0;
+}
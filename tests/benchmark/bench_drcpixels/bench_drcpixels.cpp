@@ -0,0 +1,152 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+/*
+DRC pixel intersection benchmark: times the word-at-a-time DRCPixels::pixelsCollide against the
+pixel-at-a-time reference on synthetic mono masters, and checks that both find the same pixels.
+
+	bench_drcpixels [-size PIXELS] [-runs N]
+
+Each case draws random black rectangles ("copper") into a plus and a minus image; the density
+sets how much of the board is copper and so how many words the kernel can skip.
+*/
+
+#include "autoroute/drcpixels.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+
+struct Case {
+	const char * name;
+	int rects;                          // per 1000 x 1000 pixels
+	int maxSide;
+};
+
+static const Case Cases[] = {
+	{ "clear", 0, 0 },
+	{ "sparse", 20, 40 },
+	{ "board", 200, 120 },
+	{ "dense", 2000, 200 },
+};
+
+static const int DefaultSize = 4000;    // a 4 inch board at the DRC's 1000 dpi
+
+static void fillBlack(QImage & image, int x1, int y1, int x2, int y2)
+{
+	for (int y = y1; y < y2; y++) {
+		uchar * row = image.scanLine(y);
+		for (int x = x1; x < x2; x++) {
+			row[x >> 3] &= ~(0x80 >> (x & 7));
+		}
+	}
+}
+
+static void makeMaster(QImage & image, const Case & c, QRandomGenerator & random)
+{
+	image.fill(0xffffffff);
+	int count = (qint64) c.rects * image.width() * image.height() / 1000000;
+	for (int i = 0; i < count; i++) {
+		int x = random.bounded(image.width());
+		int y = random.bounded(image.height());
+		int w = 1 + random.bounded(c.maxSide);
+		int h = 1 + random.bounded(c.maxSide);
+		fillBlack(image, x, y, qMin(x + w, image.width()), qMin(y + h, image.height()));
+	}
+}
+
+typedef bool (*Kernel)(const QImage *, const QImage *, QImage *, int, int, int, int, uint, QList<QPointF> &);
+
+static qint64 timeKernel(Kernel kernel, const QImage & plus, const QImage & minus, QImage & hits, QList<QPointF> & points, int runs)
+{
+	// fastest of the runs, in microseconds
+	qint64 best = -1;
+	for (int run = 0; run < runs; run++) {
+		hits.fill(0);
+		points.clear();
+		QElapsedTimer timer;
+		timer.start();
+		kernel(&plus, &minus, &hits, 0, 0, plus.width(), plus.height(), 1, points);
+		qint64 elapsed = timer.nsecsElapsed() / 1000;
+		if (best < 0 || elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	int size = DefaultSize;
+	int runs = 5;
+	QStringList arguments = app.arguments();
+	for (int i = 1; i + 1 < arguments.count(); i += 2) {
+		if (arguments.at(i) == "-size") size = qMax(8, arguments.at(i + 1).toInt());
+		else if (arguments.at(i) == "-runs") runs = qMax(1, arguments.at(i + 1).toInt());
+		else {
+			err << "usage: bench_drcpixels [-size PIXELS] [-runs N]" << Qt::endl;
+			return 2;
+		}
+	}
+
+	// odd width so the row tails are exercised
+	QImage plus(size + 5, size, QImage::Format_Mono);
+	QImage minus(size + 5, size, QImage::Format_Mono);
+	QImage wordHits(plus.size(), QImage::Format_Mono);
+	QImage byteHits(plus.size(), QImage::Format_Mono);
+
+	out << QString("%1 %2 %3 %4 %5").arg("case", -8).arg("hits", 10).arg("byte us", 12).arg("word us", 12).arg("speedup", 8) << Qt::endl;
+
+	bool failed = false;
+	QRandomGenerator random(20260214);
+	for (const Case & c : Cases) {
+		makeMaster(plus, c, random);
+		makeMaster(minus, c, random);
+
+		QList<QPointF> wordPoints;
+		QList<QPointF> bytePoints;
+		qint64 byteUs = timeKernel(DRCPixels::pixelsCollideBytes, plus, minus, byteHits, bytePoints, runs);
+		qint64 wordUs = timeKernel(DRCPixels::pixelsCollide, plus, minus, wordHits, wordPoints, runs);
+
+		if (wordHits != byteHits || wordPoints != bytePoints) {
+			err << c.name << ": word and byte kernels disagree" << Qt::endl;
+			failed = true;
+		}
+
+		int hitCount = 0;
+		for (int y = 0; y < wordHits.height(); y++) {
+			for (int x = 0; x < wordHits.width(); x++) {
+				if (wordHits.pixelIndex(x, y) != 0) hitCount++;
+			}
+		}
+
+		out << QString("%1 %2 %3 %4 %5")
+			.arg(c.name, -8)
+			.arg(hitCount, 10)
+			.arg(byteUs, 12)
+			.arg(wordUs, 12)
+			.arg(wordUs > 0 ? (double) byteUs / wordUs : 0.0, 8, 'f', 1) << Qt::endl;
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,275 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+/*
+Gerber export benchmark: runs "Fritzing -gerber" once per case of a fixed corpus, each in its own
+process, and prints per-layer render and conversion times and output sizes.
+
+	bench_gerber FRITZING [-runs N] [-corpus FOLDER] [-fill] [-baseline BASELINE.json] [-tolerance PERCENT] [-o REPORT.json]
+
+With a baseline, a layer that got slower by more than the tolerance (default 20%), or whose output
+changed size, is reported and the exit code is 1. A report written with -o on the reference machine
+is a baseline for later runs; keep it as baseline.json next to this file.
+*/
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+struct BenchCase {
+	const char * name;
+	const char * sketch;
+	bool fill;
+};
+
+// PCB sketches from sketches/core with exactly one board; the corpus has no panel,
+// so panels come in through -corpus
+static const BenchCase DefaultCorpus[] = {
+	{ "large board, copper fill", "Arduino-no-FTDI.fzz", true },
+	{ "dense board", "Shift_Register_2x.fzz", false },
+	{ "small board", "VoltageRegulator_with_switch.fzz", false },
+};
+
+static const double DefaultTolerance = 20;
+
+static QJsonObject exportOne(const QString & fritzing, const QString & sketchPath, bool fill, QTextStream & err)
+{
+	QJsonObject result;
+	QTemporaryDir dir;
+	if (!dir.isValid()) {
+		result.insert("error", QString("no temporary folder"));
+		return result;
+	}
+
+	QString copy = QDir(dir.path()).absoluteFilePath(QFileInfo(sketchPath).fileName());
+	if (!QFile::copy(sketchPath, copy)) {
+		result.insert("error", QString("unable to copy %1").arg(sketchPath));
+		return result;
+	}
+
+	QStringList args;
+	args << "-gerber" << dir.path();
+	if (fill) args << "-gerberfill";
+
+	QProcess process;
+	process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+	QElapsedTimer timer;
+	timer.start();
+	process.start(fritzing, args);
+	if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit) {
+		result.insert("error", QString("fritzing did not finish: %1").arg(process.errorString()));
+		return result;
+	}
+	qint64 processMs = timer.elapsed();
+
+	QFile reportFile(QDir(dir.path()).absoluteFilePath("gerber.json"));
+	if (!reportFile.open(QIODevice::ReadOnly)) {
+		result.insert("error", QString("no report"));
+		return result;
+	}
+
+	QJsonArray sketches = QJsonDocument::fromJson(reportFile.readAll()).object().value("sketches").toArray();
+	if (sketches.count() != 1) {
+		result.insert("error", QString("unexpected report"));
+		err << QFileInfo(sketchPath).fileName() << ": no export" << Qt::endl;
+		return result;
+	}
+
+	result = sketches.at(0).toObject();
+	result.insert("processMs", processMs);
+	return result;
+}
+
+static QJsonObject findLayer(const QJsonObject & result, const QString & layerName)
+{
+	Q_FOREACH (QJsonValue value, result.value("layers").toArray()) {
+		if (value.toObject().value("layer").toString() == layerName) return value.toObject();
+	}
+	return QJsonObject();
+}
+
+static int compare(const QJsonObject & result, const QJsonObject & baseline, double tolerance, QTextStream & out)
+{
+	// regressions of one case against its baseline
+	int regressions = 0;
+	QString sketch = result.value("sketch").toString();
+	Q_FOREACH (QJsonValue value, result.value("layers").toArray()) {
+		QJsonObject layer = value.toObject();
+		QString layerName = layer.value("layer").toString();
+		QJsonObject before = findLayer(baseline, layerName);
+		if (before.isEmpty()) {
+			out << sketch << " " << layerName << ": not in the baseline" << Qt::endl;
+			continue;
+		}
+
+		double ms = layer.value("renderMs").toDouble() + layer.value("convertMs").toDouble();
+		double baselineMs = before.value("renderMs").toDouble() + before.value("convertMs").toDouble();
+		if (ms > baselineMs * (1 + tolerance / 100)) {
+			out << QString("%1 %2: %3 ms, was %4 ms").arg(sketch, layerName).arg(ms, 0, 'f', 1).arg(baselineMs, 0, 'f', 1) << Qt::endl;
+			regressions++;
+		}
+
+		qint64 bytes = qint64(layer.value("bytes").toDouble());
+		qint64 baselineBytes = qint64(before.value("bytes").toDouble());
+		if (bytes != baselineBytes) {
+			out << QString("%1 %2: %3 bytes, was %4").arg(sketch, layerName).arg(bytes).arg(baselineBytes) << Qt::endl;
+			if (bytes > baselineBytes) regressions++;
+		}
+	}
+	return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	QStringList arguments = app.arguments();
+	if (arguments.count() < 2) {
+		err << "usage: bench_gerber FRITZING [-runs N] [-corpus FOLDER] [-fill] [-baseline BASELINE.json] [-tolerance PERCENT] [-o REPORT.json]" << Qt::endl;
+		return 2;
+	}
+
+	QString fritzing = arguments.at(1);
+	int runs = 1;
+	QString corpusFolder = BENCH_SKETCH_FOLDER;
+	bool defaultCorpus = true;
+	bool fillCorpus = false;
+	QString baselinePath = BENCH_BASELINE;
+	double tolerance = DefaultTolerance;
+	QString reportPath;
+	for (int i = 2; i < arguments.count(); i++) {
+		if (arguments.at(i) == "-fill") {
+			fillCorpus = true;
+			continue;
+		}
+		if (i + 1 >= arguments.count()) {
+			err << "missing value for " << arguments.at(i) << Qt::endl;
+			return 2;
+		}
+
+		QString value = arguments.at(++i);
+		if (arguments.at(i - 1) == "-runs") runs = qMax(1, value.toInt());
+		else if (arguments.at(i - 1) == "-corpus") {
+			corpusFolder = value;
+			defaultCorpus = false;
+		}
+		else if (arguments.at(i - 1) == "-baseline") baselinePath = value;
+		else if (arguments.at(i - 1) == "-tolerance") tolerance = value.toDouble();
+		else if (arguments.at(i - 1) == "-o") reportPath = value;
+		else {
+			err << "unknown option " << arguments.at(i - 1) << Qt::endl;
+			return 2;
+		}
+	}
+
+	QDir corpus(corpusFolder);
+	QList<QPair<QString, bool> > cases;
+	if (defaultCorpus) {
+		for (const BenchCase & benchCase : DefaultCorpus) cases << qMakePair(corpus.absoluteFilePath(benchCase.sketch), benchCase.fill);
+	}
+	else {
+		Q_FOREACH (QString name, corpus.entryList(QStringList("*.fzz"), QDir::Files, QDir::Name)) {
+			cases << qMakePair(corpus.absoluteFilePath(name), fillCorpus);
+		}
+	}
+
+	QHash<QString, QJsonObject> baselines;
+	QFile baselineFile(baselinePath);
+	if (baselineFile.open(QIODevice::ReadOnly)) {
+		Q_FOREACH (QJsonValue value, QJsonDocument::fromJson(baselineFile.readAll()).object().value("sketches").toArray()) {
+			baselines.insert(value.toObject().value("sketch").toString(), value.toObject());
+		}
+	}
+	else {
+		err << "no baseline at " << baselinePath << "; write one with -o" << Qt::endl;
+	}
+
+	QJsonArray results;
+	bool failed = false;
+	int regressions = 0;
+	typedef QPair<QString, bool> Case;
+	Q_FOREACH (Case benchCase, cases) {
+		// keep the fastest run's timings; the files themselves are identical
+		QJsonObject best;
+		for (int run = 0; run < runs; run++) {
+			QJsonObject result = exportOne(fritzing, benchCase.first, benchCase.second, err);
+			if (result.contains("error")) {
+				best = result;
+				break;
+			}
+			if (best.isEmpty() || result.value("totalMs").toDouble() < best.value("totalMs").toDouble()) {
+				best = result;
+			}
+		}
+		QString sketch = QFileInfo(benchCase.first).fileName();
+		best.insert("sketch", sketch);
+		best.insert("fill", benchCase.second);
+		results.append(best);
+		if (best.contains("error")) {
+			err << sketch << ": " << best.value("error").toString() << Qt::endl;
+			failed = true;
+			continue;
+		}
+
+		out << QString("%1%2: %3 ms export, %4 ms render, %5 ms convert, %6 KB, peak %7 MB")
+			.arg(sketch, benchCase.second ? " (filled)" : "")
+			.arg(best.value("totalMs").toDouble(), 0, 'f', 0)
+			.arg(best.value("renderMs").toDouble(), 0, 'f', 0)
+			.arg(best.value("convertMs").toDouble(), 0, 'f', 0)
+			.arg(best.value("bytes").toDouble() / 1024, 0, 'f', 0)
+			.arg(best.value("peakResidentBytes").toDouble() / (1024 * 1024), 0, 'f', 1) << Qt::endl;
+		out << QString("  %1 %2 %3 %4").arg("layer", -12).arg("render ms", 10).arg("convert ms", 11).arg("KB", 9) << Qt::endl;
+		Q_FOREACH (QJsonValue value, best.value("layers").toArray()) {
+			QJsonObject layer = value.toObject();
+			out << QString("  %1 %2 %3 %4")
+				.arg(layer.value("layer").toString(), -12)
+				.arg(layer.value("renderMs").toDouble(), 10, 'f', 1)
+				.arg(layer.value("convertMs").toDouble(), 11, 'f', 1)
+				.arg(layer.value("bytes").toDouble() / 1024, 9, 'f', 1) << Qt::endl;
+		}
+
+		if (baselines.contains(sketch)) {
+			regressions += compare(best, baselines.value(sketch), tolerance, out);
+		}
+	}
+
+	if (!reportPath.isEmpty()) {
+		QJsonObject report;
+		report.insert("runs", runs);
+		report.insert("sketches", results);
+		QFile file(reportPath);
+		if (file.open(QIODevice::WriteOnly)) {
+			file.write(QJsonDocument(report).toJson());
+		}
+	}
+
+	if (regressions > 0) out << regressions << " regression(s) against " << baselinePath << Qt::endl;
+	return (failed || regressions > 0) ? 1 : 0;
+}
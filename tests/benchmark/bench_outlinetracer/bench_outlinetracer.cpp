@@ -0,0 +1,203 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+/*
+Board outline tracing benchmark: times OutlineTracer::trace, which walks the pixel edges, against the
+former neighbor-probing tracer on synthetic board masks, and checks that the traced outline encloses
+exactly the pixels of the region.
+
+	bench_outlinetracer [-size PIXELS] [-runs N]
+
+The masks are white on black, as GerberGenerator hands them to GroundPlaneGenerator::scanOutline;
+"logo" is a rectangle with bites taken out of its edges, the slow case for the former tracer.
+*/
+
+#include "svg/outlinetracer.h"
+
+#include <QBitArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QPainterPath>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QtMath>
+
+static const int DefaultSize = 1000;    // a 1 inch board at 1000 dpi
+
+static QPainterPath casePath(const QString & name, int size)
+{
+	QPainterPath path;
+	double c = size / 2.0;
+	if (name == "rectangle") {
+		path.addRect(size * 0.05, size * 0.2, size * 0.9, size * 0.6);
+	}
+	else if (name == "round") {
+		path.addEllipse(QPointF(c, c), size * 0.45, size * 0.45);
+	}
+	else if (name == "gear") {
+		QPolygonF gear;
+		int teeth = 120;
+		for (int i = 0; i < teeth * 4; i++) {
+			double r = size * ((i % 4) < 2 ? 0.45 : 0.40);
+			double a = 2 * M_PI * i / (teeth * 4);
+			gear << QPointF(c + r * qCos(a), c + r * qSin(a));
+		}
+		path.addPolygon(gear);
+		path.closeSubpath();
+	}
+	else {
+		// bites centered on the edges, small enough that they cut nothing off
+		QRectF board(size * 0.05, size * 0.05, size * 0.9, size * 0.9);
+		path.addRect(board);
+		QRandomGenerator random(20260301);
+		QPainterPath bites;
+		for (int i = 0; i < 400; i++) {
+			double t = 0.1 + 0.8 * random.generateDouble();
+			double r = size * (0.005 + 0.02 * random.generateDouble());
+			QPointF p;
+			switch (i % 4) {
+				case 0: p = QPointF(board.left() + t * board.width(), board.top()); break;
+				case 1: p = QPointF(board.right(), board.top() + t * board.height()); break;
+				case 2: p = QPointF(board.left() + t * board.width(), board.bottom()); break;
+				default: p = QPointF(board.left(), board.top() + t * board.height()); break;
+			}
+			bites.addEllipse(p, r, r);
+		}
+		path = path.subtracted(bites);
+	}
+	return path;
+}
+
+static QImage makeMask(const QPainterPath & path, int size)
+{
+	QImage image(size, size, QImage::Format_ARGB32);
+	image.fill(0xff000000);
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing, false);
+	painter.fillPath(path, Qt::white);
+	painter.end();
+	return image.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
+}
+
+static qint64 regionPixels(const QImage & image, QPoint start)
+{
+	// the white pixels 8-connected to start
+	QBitArray seen(image.width() * image.height());
+	QList<QPoint> stack;
+	stack << start;
+	qint64 count = 0;
+	while (!stack.isEmpty()) {
+		QPoint p = stack.takeLast();
+		if (p.x() < 0 || p.y() < 0 || p.x() >= image.width() || p.y() >= image.height()) continue;
+		int ix = p.y() * image.width() + p.x();
+		if (seen.testBit(ix) || image.pixel(p) != 0xffffffff) continue;
+
+		seen.setBit(ix);
+		count++;
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (dx != 0 || dy != 0) stack << p + QPoint(dx, dy);
+			}
+		}
+	}
+	return count;
+}
+
+static double area(const QPolygon & polygon)
+{
+	double total = 0;
+	for (int i = 0; i < polygon.count(); i++) {
+		QPoint p0 = polygon.at(i);
+		QPoint p1 = polygon.at((i + 1) % polygon.count());
+		total += double(p0.x()) * p1.y() - double(p1.x()) * p0.y();
+	}
+	return qAbs(total / 2);
+}
+
+typedef QPolygon (*Tracer)(const QImage &);
+
+static qint64 timeTracer(Tracer tracer, const QImage & image, QPolygon & polygon, int runs)
+{
+	// fastest of the runs, in microseconds
+	qint64 best = -1;
+	for (int run = 0; run < runs; run++) {
+		QElapsedTimer timer;
+		timer.start();
+		polygon = tracer(image);
+		qint64 elapsed = timer.nsecsElapsed() / 1000;
+		if (best < 0 || elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	int size = DefaultSize;
+	int runs = 3;
+	QStringList arguments = app.arguments();
+	for (int i = 1; i + 1 < arguments.count(); i += 2) {
+		if (arguments.at(i) == "-size") size = qMax(16, arguments.at(i + 1).toInt());
+		else if (arguments.at(i) == "-runs") runs = qMax(1, arguments.at(i + 1).toInt());
+		else {
+			err << "usage: bench_outlinetracer [-size PIXELS] [-runs N]" << Qt::endl;
+			return 2;
+		}
+	}
+
+	out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+		.arg("case", -10).arg("old us", 12).arg("new us", 10).arg("speedup", 8)
+		.arg("old pts", 8).arg("new pts", 8).arg("simple", 7).arg("old area %", 10) << Qt::endl;
+
+	bool failed = false;
+	QStringList cases;
+	cases << "rectangle" << "round" << "gear" << "logo";
+	Q_FOREACH (QString name, cases) {
+		QImage image = makeMask(casePath(name, size), size);
+
+		QPolygon oldPolygon, newPolygon;
+		qint64 oldUs = timeTracer(OutlineTracer::traceNeighbors, image, oldPolygon, runs);
+		qint64 newUs = timeTracer(OutlineTracer::trace, image, newPolygon, runs);
+		QPolygon simplified = OutlineTracer::simplify(newPolygon, 0.5);
+
+		// the outline goes through pixel corners, so it encloses exactly the region's pixels
+		qint64 pixels = newPolygon.isEmpty() ? 0 : regionPixels(image, newPolygon.first());
+		if (newPolygon.count() < 3 || qRound64(area(newPolygon)) != pixels) {
+			err << name << ": outline does not enclose the region" << Qt::endl;
+			failed = true;
+		}
+
+		out << QString("%1 %2 %3 %4 %5 %6 %7 %8")
+			.arg(name, -10)
+			.arg(oldUs, 12)
+			.arg(newUs, 10)
+			.arg(newUs > 0 ? (double) oldUs / newUs : 0.0, 8, 'f', 1)
+			.arg(oldPolygon.count(), 8)
+			.arg(newPolygon.count(), 8)
+			.arg(simplified.count(), 7)
+			.arg(pixels > 0 ? 100.0 * area(oldPolygon) / pixels : 0.0, 10, 'f', 2) << Qt::endl;
+	}
+
+	return failed ? 1 : 0;
+}
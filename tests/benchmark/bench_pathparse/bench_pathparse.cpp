@@ -0,0 +1,154 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+/*
+Path parsing benchmark: times SVGPathScanner against the generated SVGPathLexer/SVGPathParser with
+SVGPathRunner's slot-by-name dispatch, on the path strings from tests/auto/test_svg and on long
+synthetic paths, and checks that both hand on the same commands and numbers.
+
+	bench_pathparse [-runs N]
+*/
+
+#include "bench_pathparse.h"
+#include "svg/svgpathlexer.h"
+#include "svg/svgpathparser.h"
+#include "svg/svgpathrunner.h"
+#include "svg/svgpathscanner.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+
+static const int DefaultRuns = 200;
+
+// from test_pathparse, with the fake close the old parser needs
+static const char * TestPaths[] = {
+	"m0,0x",
+	"m5,9.9x",
+	"m-5,-9.9x",
+	"m-4 -9.8x",
+	"m-3-9.7x",
+	"m0,0z",
+	"m1,-2a2.6,3.5,0,0,1,-5.2,0x",
+	"m2 -2a2.6 3.5 0 0 1 -5.2 0x",
+	"m3-2a2.6 3.5 0 0 1-5.2 0x",
+	"m4-2a2.6-3.5 0 0 1-5.2 0x",
+	"m-2+9.7x",
+};
+
+static QString synthetic(const QString & name)
+{
+	// about the size of a traced copper fill or a detailed silkscreen logo
+	QRandomGenerator random(20260501);
+	auto coordinate = [&random]() { return QString::number(random.bounded(100000) / 1000.0 - 50, 'f', 3); };
+	QString path = "M" + coordinate() + "," + coordinate();
+	for (int i = 0; i < 5000; i++) {
+		if (name == "lines") path += "L" + coordinate() + "," + coordinate();
+		else if (name == "curves") path += "c" + coordinate() + "," + coordinate() + " " + coordinate() + "," + coordinate() + " " + coordinate() + "," + coordinate();
+		else path += "a2.5,2.5 0 0,1 " + coordinate() + "," + coordinate();
+		if (i % 100 == 99) path += "z";
+	}
+	return path + "x";
+}
+
+static bool runOld(const QString & path, CommandCounter & counter)
+{
+	SVGPathLexer lexer(path);
+	SVGPathParser parser;
+	if (!parser.parse(lexer)) return false;
+
+	SVGPathRunner runner;
+	QObject::connect(&runner, SIGNAL(commandSignal(QChar, bool, QList<double> &, void *)),
+					 &counter, SLOT(commandSlot(QChar, bool, QList<double> &, void *)), Qt::DirectConnection);
+	return runner.runPath(parser.symStack(), nullptr);
+}
+
+static bool runNew(const QString & path, double & sum, int & commands)
+{
+	return SVGPathScanner::scan(QStringView(path), [&sum, &commands](QChar, bool, QList<double> & args) {
+		commands++;
+		for (double arg : args) sum += arg;
+	});
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	int runs = DefaultRuns;
+	QStringList arguments = app.arguments();
+	for (int i = 1; i + 1 < arguments.count(); i += 2) {
+		if (arguments.at(i) == "-runs") runs = qMax(1, arguments.at(i + 1).toInt());
+		else {
+			err << "usage: bench_pathparse [-runs N]" << Qt::endl;
+			return 2;
+		}
+	}
+
+	QList<QPair<QString, QStringList>> cases;
+	QStringList testPaths;
+	for (const char * path : TestPaths) testPaths << path;
+	cases.append(qMakePair(QString("test_svg"), testPaths));
+	Q_FOREACH (QString name, QStringList() << "lines" << "curves" << "arcs") {
+		cases.append(qMakePair(name, QStringList(synthetic(name))));
+	}
+
+	out << QString("%1 %2 %3 %4 %5").arg("case", -10).arg("chars", 9).arg("old ms", 10).arg("new ms", 10).arg("speedup", 8) << Qt::endl;
+
+	bool failed = false;
+	for (const auto & c : cases) {
+		int chars = 0;
+		Q_FOREACH (QString path, c.second) chars += path.length();
+
+		CommandCounter counter;
+		QElapsedTimer timer;
+		timer.start();
+		for (int run = 0; run < runs; run++) {
+			Q_FOREACH (QString path, c.second) {
+				if (!runOld(path, counter)) failed = true;
+			}
+		}
+		double oldMs = timer.nsecsElapsed() / 1e6;
+
+		double sum = 0;
+		int commands = 0;
+		timer.restart();
+		for (int run = 0; run < runs; run++) {
+			Q_FOREACH (QString path, c.second) {
+				if (!runNew(path, sum, commands)) failed = true;
+			}
+		}
+		double newMs = timer.nsecsElapsed() / 1e6;
+
+		if (commands != counter.commands || qAbs(sum - counter.sum) > 1e-6 * qMax(1.0, qAbs(sum))) {
+			err << c.first << ": scanner and parser disagree (" << commands << " vs " << counter.commands << " commands)" << Qt::endl;
+			failed = true;
+		}
+
+		out << QString("%1 %2 %3 %4 %5").arg(c.first, -10).arg(chars, 9)
+			.arg(oldMs, 10, 'f', 1).arg(newMs, 10, 'f', 1).arg(newMs > 0 ? oldMs / newMs : 0, 8, 'f', 1) << Qt::endl;
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,44 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+#ifndef BENCH_PATHPARSE_H
+#define BENCH_PATHPARSE_H
+
+#include <QList>
+#include <QObject>
+
+class CommandCounter : public QObject
+{
+	// receives SVGPathRunner's signal through a slot connected by name, as SvgFileSplitter::parsePath used to
+
+	Q_OBJECT
+
+public:
+	double sum = 0;
+	int commands = 0;
+
+public Q_SLOTS:
+	void commandSlot(QChar, bool, QList<double> & args, void *) {
+		commands++;
+		for (double arg : args) sum += arg;
+	}
+};
+
+#endif
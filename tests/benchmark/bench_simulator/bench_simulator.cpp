@@ -0,0 +1,251 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+
+/*
+Simulator benchmark: runs "Fritzing -simulate" once per sketch of the simulator examples, plus a stress
+circuit, each in its own process, and prints the time spent in each simulation phase.
+
+	bench_simulator FRITZING [-runs N] [-corpus FOLDER] [-baseline BASELINE.json] [-tolerance PERCENT] [-o REPORT.json]
+
+stress_300.fzz, next to this file, is simple_led.fzz with 300 more 1M resistors in parallel with R1.
+With a baseline, a sketch whose net voltages or smoking parts differ, or whose simulation got slower
+by more than the tolerance (default 20%), counts as a regression and the exit code is 1. A report
+written with -o is a baseline for later runs.
+*/
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <cmath>
+
+static const char * Phases[] = { "netlist", "load", "run", "fetch", "update" };
+
+static QJsonObject simulateOne(const QString & fritzing, const QString & sketchPath, QTextStream & err)
+{
+	QJsonObject result;
+	QTemporaryDir dir;
+	if (!dir.isValid()) {
+		result.insert("error", QString("no temporary folder"));
+		return result;
+	}
+
+	QString copy = QDir(dir.path()).absoluteFilePath(QFileInfo(sketchPath).fileName());
+	if (!QFile::copy(sketchPath, copy)) {
+		result.insert("error", QString("unable to copy %1").arg(sketchPath));
+		return result;
+	}
+
+	QProcess process;
+	process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+	QElapsedTimer timer;
+	timer.start();
+	process.start(fritzing, QStringList() << "-simulate" << dir.path());
+	if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit) {
+		result.insert("error", QString("fritzing did not finish: %1").arg(process.errorString()));
+		return result;
+	}
+	qint64 processMs = timer.elapsed();
+
+	QFile reportFile(QDir(dir.path()).absoluteFilePath("simulate.json"));
+	if (!reportFile.open(QIODevice::ReadOnly)) {
+		result.insert("error", QString("no report"));
+		return result;
+	}
+
+	QJsonArray sketches = QJsonDocument::fromJson(reportFile.readAll()).object().value("sketches").toArray();
+	if (sketches.count() != 1) {
+		result.insert("error", QString("unexpected report"));
+		return result;
+	}
+
+	result = sketches.at(0).toObject();
+	result.insert("processMs", processMs);
+	if (result.contains("error")) {
+		err << QFileInfo(sketchPath).fileName() << ": " << result.value("error").toString() << Qt::endl;
+	}
+	return result;
+}
+
+static double simulationMs(const QJsonObject & result)
+{
+	double ms = 0;
+	QJsonObject phases = result.value("phasesMs").toObject();
+	for (const char * phase : Phases) ms += phases.value(phase).toDouble();
+	return ms;
+}
+
+static int compare(const QJsonObject & result, const QJsonObject & baseline, double tolerance, QTextStream & out)
+{
+	// regressions of one sketch against its baseline
+	QString sketch = result.value("sketch").toString();
+	int regressions = 0;
+
+	QJsonArray nets = result.value("nets").toArray();
+	QJsonArray baselineNets = baseline.value("nets").toArray();
+	if (nets.count() != baselineNets.count()) {
+		out << QString("%1: %2 nets, was %3").arg(sketch).arg(nets.count()).arg(baselineNets.count()) << Qt::endl;
+		regressions++;
+	}
+	else {
+		for (int i = 0; i < nets.count(); i++) {
+			double voltage = nets.at(i).toObject().value("voltage").toDouble();
+			double baselineVoltage = baselineNets.at(i).toObject().value("voltage").toDouble();
+			if (std::fabs(voltage - baselineVoltage) > 1e-6 * qMax(1.0, std::fabs(baselineVoltage))) {
+				out << QString("%1 net %2: %3 V, was %4 V").arg(sketch).arg(nets.at(i).toObject().value("net").toInt())
+					.arg(voltage).arg(baselineVoltage) << Qt::endl;
+				regressions++;
+			}
+		}
+	}
+
+	if (result.value("smoke").toArray() != baseline.value("smoke").toArray()) {
+		out << sketch << ": smoking parts differ from the baseline" << Qt::endl;
+		regressions++;
+	}
+
+	double ms = simulationMs(result);
+	double baselineMs = simulationMs(baseline);
+	if (ms > baselineMs * (1 + tolerance / 100)) {
+		out << QString("%1: %2 ms, was %3 ms").arg(sketch).arg(ms, 0, 'f', 1).arg(baselineMs, 0, 'f', 1) << Qt::endl;
+		regressions++;
+	}
+	return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	QStringList arguments = app.arguments();
+	if (arguments.count() < 2) {
+		err << "usage: bench_simulator FRITZING [-runs N] [-corpus FOLDER] [-baseline BASELINE.json] [-tolerance PERCENT] [-o REPORT.json]" << Qt::endl;
+		return 2;
+	}
+
+	QString fritzing = arguments.at(1);
+	int runs = 1;
+	QString corpusFolder = BENCH_SKETCH_FOLDER;
+	bool defaultCorpus = true;
+	QString baselinePath;
+	double tolerance = 20;
+	QString reportPath;
+	for (int i = 2; i + 1 < arguments.count(); i += 2) {
+		if (arguments.at(i) == "-runs") runs = qMax(1, arguments.at(i + 1).toInt());
+		else if (arguments.at(i) == "-corpus") {
+			corpusFolder = arguments.at(i + 1);
+			defaultCorpus = false;
+		}
+		else if (arguments.at(i) == "-baseline") baselinePath = arguments.at(i + 1);
+		else if (arguments.at(i) == "-tolerance") tolerance = arguments.at(i + 1).toDouble();
+		else if (arguments.at(i) == "-o") reportPath = arguments.at(i + 1);
+		else {
+			err << "unknown option " << arguments.at(i) << Qt::endl;
+			return 2;
+		}
+	}
+
+	QDir corpus(corpusFolder);
+	QStringList sketches;
+	Q_FOREACH (QString name, corpus.entryList(QStringList("*.fzz"), QDir::Files, QDir::Name)) {
+		sketches << corpus.absoluteFilePath(name);
+	}
+	if (defaultCorpus) sketches << BENCH_STRESS_SKETCH;
+
+	QHash<QString, QJsonObject> baselines;
+	if (!baselinePath.isEmpty()) {
+		QFile baselineFile(baselinePath);
+		if (!baselineFile.open(QIODevice::ReadOnly)) {
+			err << "no baseline at " << baselinePath << Qt::endl;
+			return 2;
+		}
+		Q_FOREACH (QJsonValue value, QJsonDocument::fromJson(baselineFile.readAll()).object().value("sketches").toArray()) {
+			baselines.insert(value.toObject().value("sketch").toString(), value.toObject());
+		}
+	}
+
+	out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+		.arg("sketch", -40).arg("parts", 6).arg("netlist", 9).arg("load", 9).arg("run", 9)
+		.arg("fetch", 9).arg("update", 9).arg("total ms", 9).arg("smoke", 6) << Qt::endl;
+
+	QJsonArray results;
+	bool failed = false;
+	int regressions = 0;
+	Q_FOREACH (QString sketch, sketches) {
+		// keep the fastest run; the results themselves are identical
+		QJsonObject best;
+		for (int run = 0; run < runs; run++) {
+			QJsonObject result = simulateOne(fritzing, sketch, err);
+			if (result.contains("error")) {
+				best = result;
+				break;
+			}
+			if (best.isEmpty() || simulationMs(result) < simulationMs(best)) {
+				best = result;
+			}
+		}
+		best.insert("sketch", QFileInfo(sketch).fileName());
+		results.append(best);
+		if (best.contains("error")) {
+			failed = true;
+			continue;
+		}
+
+		QJsonObject phases = best.value("phasesMs").toObject();
+		out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+			.arg(QFileInfo(sketch).fileName(), -40)
+			.arg(best.value("parts").toInt(), 6)
+			.arg(phases.value("netlist").toDouble(), 9, 'f', 1)
+			.arg(phases.value("load").toDouble(), 9, 'f', 1)
+			.arg(phases.value("run").toDouble(), 9, 'f', 1)
+			.arg(phases.value("fetch").toDouble(), 9, 'f', 1)
+			.arg(phases.value("update").toDouble(), 9, 'f', 1)
+			.arg(best.value("totalMs").toDouble(), 9, 'f', 0)
+			.arg(best.value("smoke").toArray().count(), 6) << Qt::endl;
+
+		if (baselines.contains(best.value("sketch").toString())) {
+			regressions += compare(best, baselines.value(best.value("sketch").toString()), tolerance, out);
+		}
+	}
+
+	if (!reportPath.isEmpty()) {
+		QJsonObject report;
+		report.insert("runs", runs);
+		report.insert("sketches", results);
+		QFile file(reportPath);
+		if (file.open(QIODevice::WriteOnly)) {
+			file.write(QJsonDocument(report).toJson());
+		}
+	}
+
+	if (regressions > 0) out << regressions << " regression(s) against " << baselinePath << Qt::endl;
+	if (failed) return 2;
+	return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+# /*******************************************************************
+# Part of the Fritzing project - http://fritzing.org
+# Copyright (c) 2026 Fritzing
+# Fritzing is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# Fritzing is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+# You should have received a copy of the GNU General Public License
+# along with Fritzing. If not, see <http://www.gnu.org/licenses/>.
+# ********************************************************************/
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+QT += core
+QT -= gui
+
+SOURCES += $$files(*.cpp)
+
+# the simulator examples live in the source tree, the stress circuit next to this file
+DEFINES += BENCH_SKETCH_FOLDER=\\\"$$absolute_path(../../../sketches/core/Simulator/EN)\\\"
+DEFINES += BENCH_STRESS_SKETCH=\\\"$$absolute_path(stress_300.fzz)\\\"
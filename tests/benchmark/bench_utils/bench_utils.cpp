@@ -0,0 +1,278 @@
+/*******************************************************************
+
+Part of the Fritzing project - http://fritzing.org
+Copyright (c) 2026 Fritzing
+
+Fritzing is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Fritzing is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Fritzing.  If not, see <http://www.gnu.org/licenses/>.
+
+********************************************************************/
+/*
+Utility micro-benchmark: times the small helpers that sit under part loading, export and
+routing (TextUtils unit and svg fixups, the svg path lexer/parser and scanner, SvgFileSplitter's
+normalize and shift, EuclideanMST and GuillotineBinPack) on fixed inputs, and prints the best
+time per call over the runs.
+
+	bench_utils [-runs N] [-o REPORT.json]
+
+Inputs are generated from fixed seeds and every case does a fixed number of calls per run, so
+reports from different commits on the same machine can be compared case by case.
+*/
+
+#include "autoroute/binpacking/GuillotineBinPack.h"
+#include "svg/svgfilesplitter.h"
+#include "svg/svgpathlexer.h"
+#include "svg/svgpathparser.h"
+#include "svg/svgpathscanner.h"
+#include "utils/euclideanmst.h"
+#include "utils/textutils.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSize>
+#include <QStringList>
+#include <QSysInfo>
+#include <QTextStream>
+
+#include <algorithm>
+#include <functional>
+
+static const int DefaultRuns = 5;
+
+// keeps the compiler from dropping calls whose results are otherwise unused
+static volatile double Sink = 0;
+
+struct BenchCase {
+	QString name;
+	int calls;                              // per run
+	std::function<void()> body;
+};
+
+static QString coordinate(QRandomGenerator & random)
+{
+	return QString::number(random.bounded(100000) / 1000.0, 'f', 3);
+}
+
+static QString syntheticPath(int commands)
+{
+	QRandomGenerator random(20260601);
+	QString path = "M" + coordinate(random) + "," + coordinate(random);
+	for (int i = 0; i < commands; i++) {
+		switch (i % 3) {
+		case 0:
+			path += "L" + coordinate(random) + "," + coordinate(random);
+			break;
+		case 1:
+			path += "c" + coordinate(random) + "," + coordinate(random) + " " + coordinate(random) + "," + coordinate(random) + " " + coordinate(random) + "," + coordinate(random);
+			break;
+		default:
+			path += "a2.5,2.5 0 0,1 " + coordinate(random) + "," + coordinate(random);
+			break;
+		}
+		if (i % 50 == 49) path += "z";
+	}
+	return path;
+}
+
+static QString syntheticSvg()
+{
+	// shaped like a through-hole footprint from the core parts: a copper group of pads, some
+	// traced paths and a silkscreen outline, in inches with a viewBox in thousandths
+	QRandomGenerator random(20260602);
+	QString svg = "<?xml version='1.0' encoding='UTF-8'?>\n"
+		"<svg xmlns='http://www.w3.org/2000/svg' width='1.2in' height='0.8in' viewBox='0 0 1200 800'>\n"
+		"<g id='copper0' transform='translate(10,20)'>\n";
+	for (int i = 0; i < 40; i++) {
+		svg += QString("<circle id='connector%1pin' cx='%2' cy='%3' r='32' fill='none' stroke='#F7BD13' stroke-width='16'/>\n")
+			.arg(i).arg(coordinate(random)).arg(coordinate(random));
+		svg += QString("<rect x='%1' y='%2' width='60' height='40' fill='#F7BD13' stroke-width='0'/>\n")
+			.arg(coordinate(random)).arg(coordinate(random));
+	}
+	for (int i = 0; i < 10; i++) {
+		svg += QString("<path d='%1' fill='#F7BD13' stroke='none' stroke-width='0'/>\n").arg(syntheticPath(30));
+	}
+	svg += "</g>\n<g id='silkscreen'>\n";
+	svg += "<polygon points='0,0 1200,0 1200,800 0,800' fill='none' stroke='#000000' stroke-width='8'/>\n";
+	svg += "<text x='100' y='100' font-size='60' fill='#000000'>U1</text>\n";
+	svg += "</g>\n</svg>\n";
+	return svg;
+}
+
+static QList<BenchCase> makeCases()
+{
+	QList<BenchCase> cases;
+
+	static const QStringList Sizes = { "0.1in", "2.54mm", "100mil", "12px", "7.5pt", "1.25pc", "3cm", "42" };
+	cases.append({ "TextUtils::convertToInches", 100000, []() {
+		static int i = 0;
+		Sink = Sink + TextUtils::convertToInches(Sizes.at(i++ % Sizes.count()));
+	}});
+
+	static const QStringList Values = { "4.7k", "100n", "2.2u", "10M", "330", "47p", "1.5m", "22" };
+	cases.append({ "TextUtils::convertFromPowerPrefix", 100000, []() {
+		static int i = 0;
+		Sink = Sink + TextUtils::convertFromPowerPrefix(Values.at(i++ % Values.count()), "F");
+	}});
+
+	static const QString Svg = syntheticSvg();
+	cases.append({ "TextUtils::fixMuch", 200, []() {
+		QString svg = Svg;
+		Sink = Sink + TextUtils::fixMuch(svg, true) + svg.length();
+	}});
+
+	cases.append({ "TextUtils::parseForWidthAndHeight", 2000, []() {
+		QSizeF size = TextUtils::parseForWidthAndHeight(Svg);
+		Sink = Sink + size.width();
+	}});
+
+	static const QString Path = syntheticPath(1000);
+	static const QString ClosedPath = Path + "x";         // with the fake close the generated parser needs
+	cases.append({ "SVGPathParser::parse", 200, []() {
+		SVGPathLexer lexer(ClosedPath);
+		SVGPathParser parser;
+		Sink = Sink + parser.parse(lexer) + parser.symStack().count();
+	}});
+
+	cases.append({ "SVGPathScanner::scan", 200, []() {
+		double sum = 0;
+		SVGPathScanner::scan(QStringView(Path), [&sum](QChar, bool, QList<double> & args) {
+			for (double arg : args) sum += arg;
+		});
+		Sink = Sink + sum;
+	}});
+
+	cases.append({ "SvgFileSplitter::splitString", 200, []() {
+		QString svg = Svg;
+		SvgFileSplitter splitter;
+		Sink = Sink + splitter.splitString(svg, "copper0");
+	}});
+
+	// normalize and shift work on the split document, so both include a splitString
+	cases.append({ "SvgFileSplitter::normalize", 200, []() {
+		QString svg = Svg;
+		SvgFileSplitter splitter;
+		double factor = 1;
+		if (splitter.splitString(svg, "copper0")) splitter.normalize(1000, "copper0", false, factor);
+		Sink = Sink + factor;
+	}});
+
+	cases.append({ "SvgFileSplitter::shift", 200, []() {
+		QString svg = Svg;
+		SvgFileSplitter splitter;
+		if (splitter.splitString(svg, "copper0")) Sink = Sink + splitter.shift(25, -40, "copper0", true).length();
+	}});
+
+	// the connector layout chooseRatsnestGraph hands on for a large net: a few parts, each
+	// with a row of connectors already connected among themselves
+	static QVector<QPointF> points;
+	static QVector<int> groups;
+	{
+		QRandomGenerator random(20260603);
+		for (int part = 0; part < 100; part++) {
+			QPointF origin(random.bounded(5000), random.bounded(5000));
+			for (int pin = 0; pin < 4; pin++) {
+				points.append(origin + QPointF(pin * 100, 0));
+				groups.append(part);
+			}
+		}
+	}
+	cases.append({ "EuclideanMST::spanningTree", 200, []() {
+		Sink = Sink + EuclideanMST::spanningTree(points, groups).count();
+	}});
+
+	static std::vector<QSize> rects;
+	{
+		QRandomGenerator random(20260604);
+		for (int i = 0; i < 200; i++) rects.push_back(QSize(20 + random.bounded(180), 20 + random.bounded(180)));
+	}
+	cases.append({ "GuillotineBinPack::Insert", 200, []() {
+		rbp::GuillotineBinPack binPack(3000, 3000);
+		int placed = 0;
+		for (const QSize & size : rects) {
+			rbp::Rect rect = binPack.Insert(size.width(), size.height(), true, rbp::GuillotineBinPack::RectBestAreaFit, rbp::GuillotineBinPack::SplitMinimizeArea);
+			if (rect.height > 0) placed++;
+		}
+		Sink = Sink + placed;
+	}});
+
+	return cases;
+}
+
+int main(int argc, char *argv[])
+{
+	// SvgFileSplitter and TextUtils reach into QtGui, so use a full application without a display
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+	QTextStream out(stdout);
+	QTextStream err(stderr);
+
+	int runs = DefaultRuns;
+	QString reportPath;
+	QStringList arguments = app.arguments();
+	for (int i = 1; i + 1 < arguments.count(); i += 2) {
+		if (arguments.at(i) == "-runs") runs = qMax(1, arguments.at(i + 1).toInt());
+		else if (arguments.at(i) == "-o") reportPath = arguments.at(i + 1);
+		else {
+			err << "usage: bench_utils [-runs N] [-o REPORT.json]" << Qt::endl;
+			return 2;
+		}
+	}
+
+	out << QString("%1 %2 %3 %4").arg("case", -36).arg("calls", 8).arg("best us", 12).arg("median us", 12) << Qt::endl;
+
+	QJsonArray results;
+	Q_FOREACH (BenchCase c, makeCases()) {
+		// one untimed call so first-use allocations and static inputs are out of the way
+		c.body();
+
+		QList<double> perCall;
+		for (int run = 0; run < runs; run++) {
+			QElapsedTimer timer;
+			timer.start();
+			for (int call = 0; call < c.calls; call++) c.body();
+			perCall.append(timer.nsecsElapsed() / 1000.0 / c.calls);
+		}
+		std::sort(perCall.begin(), perCall.end());
+		double best = perCall.first();
+		double median = perCall.at(perCall.count() / 2);
+
+		out << QString("%1 %2 %3 %4").arg(c.name, -36).arg(c.calls, 8)
+			.arg(best, 12, 'f', 3).arg(median, 12, 'f', 3) << Qt::endl;
+
+		QJsonObject result;
+		result.insert("name", c.name);
+		result.insert("calls", c.calls);
+		result.insert("bestUs", best);
+		result.insert("medianUs", median);
+		results.append(result);
+	}
+
+	if (!reportPath.isEmpty()) {
+		QJsonObject report;
+		report.insert("runs", runs);
+		report.insert("qt", QString(qVersion()));
+		report.insert("cpu", QSysInfo::currentCpuArchitecture());
+		report.insert("cases", results);
+		QFile file(reportPath);
+		if (file.open(QIODevice::WriteOnly)) {
+			file.write(QJsonDocument(report).toJson());
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+SUBDIRS = bench_autorouter \
+	bench_drcpixels \
+	bench_gerber \
+	bench_outlinetracer \
+	bench_pathparse \
+	bench_simulator \
+	bench_utils